@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""Runs the cross-language benchmark suite and reports the results.
+
+Every workload of the workload file is run by the runner of every client
+available, against a fresh loopback emulator or a given server. The results
+are compared in a single Markdown table, optionally written as CSV as well.
+See README.md for the workload and runner specification.
+"""
+
+import csv
+import math
+import os
+import shlex
+import subprocess
+import sys
+from argparse import ArgumentParser, Namespace
+from dataclasses import dataclass, field
+from pathlib import Path
+
+
+ROOT = Path(__file__).resolve().parent.parent
+
+EMULATOR = ROOT / "cpp/libtstorageclient++/bench/bin/bench-emulator"
+
+# The runners of the clients, as built by the instructions of README.md. A
+# runner is available if its first existing path is there.
+CLIENTS: dict[str, list[str]] = {
+    "c": [str(ROOT / "c/build/bench/tstorage-bench-runner")],
+    "cpp": [str(ROOT / "cpp/libtstorageclient++/bench/bin/bench-runner")],
+    "python": [sys.executable, str(ROOT / "python/bench/runner.py")],
+    "java": ["java", "-jar", str(ROOT / "java/bench/target/ts_driver_java_bench-1.0.0-jar-with-dependencies.jar")],
+    "csharp": [str(ROOT / "csharp/BenchRunner/bin/Release/net8.0/BenchRunner")],
+}
+
+# The size of a serialized key, counted into the throughput.
+KEY_SIZE = 32
+
+# The time a single runner may take.
+RUNNER_TIMEOUT_S = 600
+
+
+@dataclass
+class Workload:
+    name: str
+    op: str
+    records: int
+    payload: int
+    cids: int
+    layout: str
+    repetitions: int
+
+    def args(self) -> list[str]:
+        return [self.op, str(self.records), str(self.payload), str(self.cids), self.layout, str(self.repetitions)]
+
+
+@dataclass
+class Result:
+    workload: Workload
+    client: str
+    latencies_us: list[float] = field(default_factory=list)
+    error: str = ""
+
+    def percentile(self, p: float) -> float:
+        values = sorted(self.latencies_us)
+        return values[max(math.ceil(p * len(values)), 1) - 1]
+
+    def records_per_s(self) -> float:
+        return self.workload.records / (self.percentile(0.5) / 1e6)
+
+    def mib_per_s(self) -> float:
+        return self.records_per_s() * (KEY_SIZE + self.workload.payload) / 1024**2
+
+
+def parse_args() -> Namespace:
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("--workloads", type=Path, default=Path(__file__).resolve().parent / "workloads.txt",
+                        help="the workload file")
+    parser.add_argument("--only", default="", help="comma separated names of the workloads to run")
+    parser.add_argument("--clients", default="", help="comma separated names of the clients to run")
+    parser.add_argument("--client", action="append", default=[], metavar="NAME=COMMAND",
+                        help="adds or overrides the runner command of a client")
+    parser.add_argument("--server", metavar="HOST:PORT",
+                        help="runs against a server instead of the loopback emulator")
+    parser.add_argument("--emulator", type=Path, default=EMULATOR, help="the loopback emulator")
+    parser.add_argument("--baseline", default="c", help="the client the others are compared to")
+    parser.add_argument("--csv", type=Path, help="writes the results to a CSV file as well")
+    return parser.parse_args()
+
+
+def load_workloads(path: Path, only: set[str]) -> list[Workload]:
+    workloads = []
+    for line in path.read_text().splitlines():
+        line = line.split("#", 1)[0].strip()
+        if not line:
+            continue
+        name, op, records, payload, cids, layout, repetitions = line.split()
+        if only and name not in only:
+            continue
+        workloads.append(Workload(name, op, int(records), int(payload), int(cids), layout, int(repetitions)))
+    return workloads
+
+
+def select_clients(args: Namespace) -> dict[str, list[str]]:
+    clients = dict(CLIENTS)
+    for spec in args.client:
+        name, _, command = spec.partition("=")
+        clients[name] = shlex.split(command)
+    if args.clients:
+        wanted = args.clients.split(",")
+        clients = {name: clients[name] for name in wanted if name in clients}
+    available = {}
+    for name, command in clients.items():
+        paths = [part for part in command if os.sep in part]
+        if paths and not Path(paths[0]).exists():
+            print(f"skipping {name}: {paths[0]} not built", file=sys.stderr)
+            continue
+        available[name] = command
+    return available
+
+
+def run_client(command: list[str], host: str, port: int, workload: Workload, client: str, check: bool) -> Result:
+    result = Result(workload, client)
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join(filter(None, [str(ROOT / "python/src"),
+                                                                    os.environ.get("PYTHONPATH")])))
+    try:
+        proc = subprocess.run(command + [host, str(port)] + workload.args(), capture_output=True, text=True,
+                              timeout=RUNNER_TIMEOUT_S, env=env)
+    except (OSError, subprocess.TimeoutExpired) as error:
+        result.error = str(error)
+        return result
+    if proc.returncode != 0:
+        result.error = proc.stderr.strip().splitlines()[-1] if proc.stderr.strip() else f"exit {proc.returncode}"
+        return result
+    for line in proc.stdout.splitlines():
+        latency, records = line.split()
+        if check and int(records) != workload.records:
+            result.error = f"{records} records instead of {workload.records}"
+            return result
+        result.latencies_us.append(float(latency))
+    if len(result.latencies_us) != workload.repetitions:
+        result.error = f"{len(result.latencies_us)} samples instead of {workload.repetitions}"
+    return result
+
+
+def run_workload(args: Namespace, workload: Workload, clients: dict[str, list[str]]) -> list[Result]:
+    if args.server:
+        host, _, port = args.server.rpartition(":")
+        return [run_client(command, host, int(port), workload, name, False) for name, command in clients.items()]
+
+    get_records, get_payload = (workload.records, workload.payload) if workload.op == "get" else (0, 0)
+    emulator = subprocess.Popen([str(args.emulator), str(get_records), str(get_payload)],
+                                stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+    try:
+        port = int(emulator.stdout.readline())
+        return [run_client(command, "127.0.0.1", port, workload, name, True) for name, command in clients.items()]
+    finally:
+        emulator.stdin.close()
+        emulator.wait()
+
+
+def report(results: list[Result], baseline: str) -> None:
+    print("| workload | client | p50 [ms] | p99 [ms] | records/s | MiB/s | p50 vs " + baseline + " |")
+    print("|---|---|---:|---:|---:|---:|---:|")
+    for result in results:
+        if result.error:
+            print(f"| {result.workload.name} | {result.client} | failed: {result.error} | | | | |")
+            continue
+        reference = next((r for r in results if r.workload is result.workload and r.client == baseline
+                          and not r.error), None)
+        ratio = f"{result.percentile(0.5) / reference.percentile(0.5):.2f}x" if reference else "-"
+        print(f"| {result.workload.name} | {result.client} | {result.percentile(0.5) / 1e3:.3f} "
+              f"| {result.percentile(0.99) / 1e3:.3f} | {result.records_per_s():.0f} "
+              f"| {result.mib_per_s():.1f} | {ratio} |")
+
+
+def write_csv(path: Path, results: list[Result]) -> None:
+    with path.open("w", newline="") as file:
+        writer = csv.writer(file)
+        writer.writerow(["workload", "op", "records", "payload", "cids", "layout", "client",
+                         "p50_us", "p99_us", "records_per_s", "mib_per_s", "error"])
+        for r in results:
+            w = r.workload
+            stats = ([f"{r.percentile(0.5):.1f}", f"{r.percentile(0.99):.1f}", f"{r.records_per_s():.0f}",
+                      f"{r.mib_per_s():.1f}"] if not r.error else ["", "", "", ""])
+            writer.writerow([w.name, w.op, w.records, w.payload, w.cids, w.layout, r.client] + stats + [r.error])
+
+
+def main() -> int:
+    args = parse_args()
+    workloads = load_workloads(args.workloads, set(filter(None, args.only.split(","))))
+    clients = select_clients(args)
+    if not clients:
+        print("no client runner available", file=sys.stderr)
+        return 1
+    if not args.server and not args.emulator.exists():
+        print(f"{args.emulator} not built", file=sys.stderr)
+        return 1
+
+    results = []
+    for workload in workloads:
+        print(f"running {workload.name}", file=sys.stderr)
+        results += run_workload(args, workload, clients)
+    report(results, args.baseline)
+    if args.csv:
+        write_csv(args.csv, results)
+    return 1 if any(r.error for r in results) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2025 Atende Industries sp. z o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+/** @file tstorage-bench-runner.c
+ *
+ * The runner of the C client for the cross-language benchmark suite. Its
+ * arguments, workloads and output are specified in bench/README.md at the top
+ * of the repository.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "tstorage-client/client.h"
+
+enum {
+	NUM_ARGS = 9, /* Number of command line arguments, program name included */
+	MEMORY_LIMIT = 64 * 1024 * 1024 /* Memory limit of the channel */
+};
+
+/******************
+ * Definition of the payload type.
+ *
+ * The payload is a byte string of any size, allocated by fromBytes.
+ */
+
+struct BenchPayload
+{
+	size_t size;
+	char* data;
+};
+
+struct BenchRecord
+{
+	TSCLIENT_Record base;
+	struct BenchPayload value;
+};
+
+static size_t toBytesBench(const void* restrict val, void* restrict buffer, size_t size)
+{
+	const struct BenchPayload* payload = val;
+	if (size >= payload->size) {
+		memcpy(buffer, payload->data, payload->size);
+	}
+	return payload->size;
+}
+
+static int fromBytesBench(void* restrict val, const void* restrict buffer, size_t size)
+{
+	struct BenchPayload* payload = val;
+	payload->data = malloc(size != 0 ? size : 1);
+	if (payload->data == NULL) {
+		return 1;
+	}
+	memcpy(payload->data, buffer, size);
+	payload->size = size;
+	return 0;
+}
+
+static TSCLIENT_PayloadType BenchPayloadType = {
+	.size = sizeof(struct BenchRecord),
+	.offset = offsetof(struct BenchRecord, value),
+	.toBytes = &toBytesBench,
+	.fromBytes = &fromBytesBench};
+
+/**
+ * @brief Frees the payloads of the records returned by a GET.
+ */
+static void destroyGetRecords(TSCLIENT_RecordsSet* records)
+{
+	struct BenchRecord* recs = TSCLIENT_RecordsSet_elements(records);
+	for (size_t i = 0; i < TSCLIENT_RecordsSet_size(records); ++i) {
+		free(recs[i].value.data);
+	}
+	TSCLIENT_RecordsSet_destroy(records);
+}
+
+/**
+ * @brief Returns the records of a PUT/A workload, all sharing 'payload'.
+ *
+ * @return The records, or NULL if out of memory.
+ */
+static TSCLIENT_RecordsSet* makeRecords(
+	size_t count, size_t cids, int runs, const struct BenchPayload* payload)
+{
+	TSCLIENT_RecordsSet* records = TSCLIENT_RecordsSet_new(&BenchPayloadType);
+	if (records == NULL) {
+		return NULL;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		TSCLIENT_Key key = {
+			.cid = (int32_t)(runs ? i * cids / count : i % cids),
+			.moid = 0,
+			.mid = (int64_t)i,
+			.cap = (int64_t)i,
+			.acq = (int64_t)i};
+		struct BenchPayload value = *payload;
+		if (TSCLIENT_RecordsSet_append(records, &key, &value)) {
+			TSCLIENT_RecordsSet_destroy(records);
+			return NULL;
+		}
+	}
+	return records;
+}
+
+static double nowUs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != NUM_ARGS) {
+		fprintf(stderr, "Usage: %s HOST PORT put|puta|get RECORDS PAYLOAD CIDS runs|mixed REPETITIONS\n",
+			argv[0]);
+		return 2;
+	}
+	const char* host = argv[1];
+	const int port = atoi(argv[2]);
+	const char* op = argv[3];
+	const size_t count = strtoul(argv[4], NULL, 10);
+	const size_t payloadSize = strtoul(argv[5], NULL, 10);
+	const size_t cids = strtoul(argv[6], NULL, 10);
+	const int runs = strcmp(argv[7], "runs") == 0;
+	const unsigned long repetitions = strtoul(argv[8], NULL, 10);
+	const int isGet = strcmp(op, "get") == 0;
+	const int isPuta = strcmp(op, "puta") == 0;
+	if ((!isGet && !isPuta && strcmp(op, "put") != 0) || (!runs && strcmp(argv[7], "mixed") != 0)
+		|| cids == 0 || repetitions == 0) {
+		fprintf(stderr, "%s: error: invalid arguments\n", argv[0]);
+		return 2;
+	}
+
+	TSCLIENT_Channel* chan = TSCLIENT_Channel_new(host, port, &BenchPayloadType);
+	if (chan == NULL) {
+		fprintf(stderr, "%s: error: cannot create the channel\n", argv[0]);
+		return 1;
+	}
+	struct timeval timeout = {
+		.tv_sec = 30};
+	TSCLIENT_Channel_setTimeout(chan, &timeout);
+	TSCLIENT_Channel_setMemoryLimit(chan, MEMORY_LIMIT);
+	TSCLIENT_ResponseStatus tsRes = TSCLIENT_Channel_connect(chan);
+	if (tsRes != TSCLIENT_RES_OK) {
+		fprintf(stderr, "%s: error: connect failed with status %d\n", argv[0], (int)tsRes);
+		TSCLIENT_Channel_destroy(chan);
+		return 1;
+	}
+
+	struct BenchPayload payload = {
+		.size = payloadSize,
+		.data = malloc(payloadSize != 0 ? payloadSize : 1)};
+	TSCLIENT_RecordsSet* records = NULL;
+	if (payload.data != NULL) {
+		memset(payload.data, 'x', payloadSize);
+		records = isGet ? NULL : makeRecords(count, cids, runs, &payload);
+	}
+	if (payload.data == NULL || (!isGet && records == NULL)) {
+		fprintf(stderr, "%s: error: out of memory\n", argv[0]);
+		free(payload.data);
+		TSCLIENT_Channel_destroy(chan);
+		return 1;
+	}
+
+	const TSCLIENT_Key keyMin = {
+		.cid = TSCLIENT_CID_MIN,
+		.moid = TSCLIENT_MOID_MIN,
+		.mid = TSCLIENT_MID_MIN,
+		.cap = TSCLIENT_CAP_MIN,
+		.acq = TSCLIENT_ACQ_MIN};
+	const TSCLIENT_Key keyMax = {
+		.cid = TSCLIENT_CID_MAX,
+		.moid = TSCLIENT_MOID_MAX,
+		.mid = TSCLIENT_MID_MAX,
+		.cap = TSCLIENT_CAP_MAX,
+		.acq = TSCLIENT_ACQ_MAX};
+
+	/* The first request warms the channel up and is not reported. */
+	int res = 0;
+	for (unsigned long i = 0; i <= repetitions; ++i) {
+		size_t received = count;
+		const double start = nowUs();
+		if (isGet) {
+			int64_t acq;
+			TSCLIENT_RecordsSet* data = NULL;
+			tsRes = TSCLIENT_Channel_get(chan, &keyMin, &keyMax, &acq, &data);
+			if (data != NULL) {
+				received = TSCLIENT_RecordsSet_size(data);
+				destroyGetRecords(data);
+			}
+		} else {
+			tsRes = isPuta ? TSCLIENT_Channel_puta(chan, records) : TSCLIENT_Channel_put(chan, records);
+		}
+		const double stop = nowUs();
+		if (tsRes != TSCLIENT_RES_OK) {
+			fprintf(stderr, "%s: error: %s failed with status %d\n", argv[0], op, (int)tsRes);
+			res = 1;
+			break;
+		}
+		if (i != 0) {
+			printf("%.1f %zu\n", stop - start, received);
+		}
+	}
+
+	if (records != NULL) {
+		TSCLIENT_RecordsSet_destroy(records);
+	}
+	free(payload.data);
+	TSCLIENT_Channel_close(chan);
+	TSCLIENT_Channel_destroy(chan);
+	return res;
+}
@@ -0,0 +1,99 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "BatchSerializer.h"
+#include "BenchCommon.h"
+#include "Buffer.h"
+#include "Serializer.h"
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+using impl::BatchSerializer;
+using impl::Buffer;
+using impl::Serializer;
+
+/** @brief The default memory limit of a `Channel`. */
+constexpr std::size_t cDefaultBufferSize = 64UL * 1024;
+/** @brief The size of a serialized key inside a PUT record. */
+constexpr std::size_t cPutKeySize = Serializer::cAbbrevKeySizeWithoutAcq;
+/** @brief The size of a serialized key inside a PUTA record. */
+constexpr std::size_t cPutAKeySize = Serializer::cAbbrevKeySize;
+
+/**
+ * Serializes records the way `ChannelImpl` does during a PUT/A request: the
+ * payload is copied right behind the space reserved for the record header,
+ * then `putRecord()` fills the header in. The buffer is discarded instead of
+ * being sent whenever it fills up.
+ *
+ * Arguments: the payload size and the CID run length, i.e. the amount of
+ * consecutive records sharing a CID (and thus a batch).
+ */
+template<BatchSerializer::ProtoT Proto>
+void BM_BatchSerializerPutRecord(benchmark::State& state)
+{
+	const std::size_t payloadSize = static_cast<std::size_t>(state.range(0));
+	const std::int64_t cidRun = state.range(1);
+	const std::size_t keySize = Proto == BatchSerializer::PUT ? cPutKeySize : cPutAKeySize;
+	const std::size_t recordSize = sizeof(std::int32_t) + keySize + payloadSize;
+
+	Buffer buffer(std::max(cDefaultBufferSize, BatchSerializer::cBatchHeaderSize + recordSize));
+	BatchSerializer batch(buffer);
+	const std::vector<char> payload(payloadSize, 'x');
+
+	Key key(0, 2, 3, 4, 5);
+	std::int64_t recordIndex = 0;
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		key.cid = static_cast<Key::CidT>(recordIndex++ / cidRun);
+		std::size_t offset = batch.getNextRecordOffset(key.cid) + sizeof(std::int32_t) + keySize;
+		if (offset + payloadSize > buffer.bytesOfFreeSpace()) {
+			batch.endBatch();
+			buffer.reset();
+			batch = BatchSerializer(buffer);
+			offset = batch.getNextRecordOffset(key.cid) + sizeof(std::int32_t) + keySize;
+		}
+		std::memcpy(buffer.writeData(offset), payload.data(), payloadSize);
+		batch.template putRecord<Proto>(key, payloadSize);
+		benchmark::ClobberMemory();
+	}
+	setProcessed(state,
+		state.iterations(),
+		static_cast<std::int64_t>(recordSize),
+		counters);
+}
+
+void payloadSizesAndCidRuns(benchmark::internal::Benchmark* bench)
+{
+	bench->ArgNames({"payload", "cidRun"});
+	for (const std::int64_t size : payloadSizeList()) {
+		for (const std::int64_t cidRun : {1, 16, 1024}) {
+			bench->Args({size, cidRun});
+		}
+	}
+}
+
+} /*namespace*/
+
+BENCHMARK_TEMPLATE(BM_BatchSerializerPutRecord, BatchSerializer::PUT)
+	->Apply(payloadSizesAndCidRuns);
+BENCHMARK_TEMPLATE(BM_BatchSerializerPutRecord, BatchSerializer::PUTA)
+	->Apply(payloadSizesAndCidRuns);
+
+} /*namespace bench*/
+} /*namespace tstorage*/
@@ -0,0 +1,35 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstring>
+
+#include <benchmark/benchmark.h>
+
+#include "PerfCounters.h"
+
+int main(int argc, char** argv)
+{
+	using tstorage::bench::PerfCounters;
+
+	// `--perf_counters` reports the hardware counters of each benchmark, see
+	// `setProcessed()`; the other flags are those of Google Benchmark.
+	int kept = 1;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--perf_counters") == 0) {
+			PerfCounters::enableGlobally(true);
+		} else {
+			argv[kept++] = argv[i];
+		}
+	}
+	argc = kept;
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_BENCHCOMMON_BENCH_PH
+#define D_TSTORAGE_BENCHCOMMON_BENCH_PH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "PerfCounters.h"
+
+namespace tstorage {
+namespace bench {
+
+/** @brief The smallest payload size covered by the benchmarks. */
+constexpr std::int64_t cPayloadSizeMin = 4;
+/** @brief The largest payload size covered by the benchmarks (the protocol
+ * limit). */
+constexpr std::int64_t cPayloadSizeMax = 32L * 1024 * 1024;
+/** @brief The step between consecutive payload sizes. */
+constexpr int cPayloadSizeMultiplier = 8;
+
+/** @brief Returns the common payload sizes, from the smallest to the largest
+ * one inclusive. */
+inline std::vector<std::int64_t> payloadSizeList()
+{
+	std::vector<std::int64_t> sizes;
+	for (std::int64_t size = cPayloadSizeMin; size < cPayloadSizeMax;
+		 size *= cPayloadSizeMultiplier) {
+		sizes.push_back(size);
+	}
+	sizes.push_back(cPayloadSizeMax);
+	return sizes;
+}
+
+/** @brief Applies the common payload sizes to a benchmark. */
+inline void payloadSizes(benchmark::internal::Benchmark* bench)
+{
+	bench->ArgName("payload");
+	for (const std::int64_t size : payloadSizeList()) {
+		bench->Arg(size);
+	}
+}
+
+/** @brief Reports `records` processed records of `recordBytes` bytes each. */
+inline void setProcessed(
+	benchmark::State& state, const std::int64_t records, const std::int64_t recordBytes)
+{
+	state.SetItemsProcessed(records);
+	state.SetBytesProcessed(records * recordBytes);
+}
+
+/**
+ * @brief Reports `records` processed records of `recordBytes` bytes each,
+ * along with the events `counters` counted since `PerfCounters::start()`,
+ * per record and per byte.
+ */
+inline void setProcessed(benchmark::State& state,
+	const std::int64_t records,
+	const std::int64_t recordBytes,
+	PerfCounters& counters)
+{
+	counters.stop();
+	setProcessed(state, records, recordBytes);
+	if (!counters.enabled() || records == 0) {
+		return;
+	}
+	for (std::size_t i = 0; i < cPerfEvents; ++i) {
+		const PerfEvent event = static_cast<PerfEvent>(i);
+		if (!counters.available(event)) {
+			continue;
+		}
+		const std::string name = PerfCounters::name(event);
+		state.counters[name + "/rec"] = counters.value(event) / records;
+		if (recordBytes != 0) {
+			state.counters[name + "/B"] = counters.value(event) / (records * recordBytes);
+		}
+	}
+}
+
+} /*namespace bench*/
+} /*namespace tstorage*/
+
+#endif
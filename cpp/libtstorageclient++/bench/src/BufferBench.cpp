@@ -0,0 +1,82 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchCommon.h"
+#include "Buffer.h"
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+using impl::Buffer;
+
+/**
+ * Measures the compaction done by `Buffer::reserve()` when `chunk` unread
+ * bytes sit at the end of the buffer, as it happens between consecutive
+ * records of a GET response.
+ */
+void BM_BufferReserveCompact(benchmark::State& state)
+{
+	const std::size_t chunk = static_cast<std::size_t>(state.range(0));
+	Buffer buffer(2 * chunk);
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		buffer.reset();
+		buffer.writeAdvance(2 * chunk);
+		buffer.readAdvance(chunk);
+		const bool reserved = buffer.reserve(chunk);
+		benchmark::DoNotOptimize(reserved);
+		benchmark::ClobberMemory();
+	}
+	setProcessed(state, state.iterations(), static_cast<std::int64_t>(chunk), counters);
+}
+
+/** Measures the same compaction with the `MIRRORED` layout, which moves the
+ * window over the mapping instead of the unread bytes. */
+void BM_BufferReserveMirrored(benchmark::State& state)
+{
+	const std::size_t chunk = static_cast<std::size_t>(state.range(0));
+	Buffer buffer(2 * chunk, Buffer::MIRRORED);
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		buffer.reset();
+		buffer.writeAdvance(2 * chunk);
+		buffer.readAdvance(chunk);
+		const bool reserved = buffer.reserve(chunk);
+		benchmark::DoNotOptimize(reserved);
+		benchmark::ClobberMemory();
+	}
+	setProcessed(state, state.iterations(), static_cast<std::int64_t>(chunk), counters);
+}
+
+/** Measures `Buffer::reserve()` when there is enough free space already. */
+void BM_BufferReserveNoop(benchmark::State& state)
+{
+	Buffer buffer(64UL * 1024);
+	buffer.writeAdvance(1024);
+	buffer.readAdvance(512);
+	for (auto _ : state) {
+		const bool reserved = buffer.reserve(1024);
+		benchmark::DoNotOptimize(reserved);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+} /*namespace*/
+
+BENCHMARK(BM_BufferReserveCompact)->Apply(payloadSizes);
+BENCHMARK(BM_BufferReserveMirrored)->Apply(payloadSizes);
+BENCHMARK(BM_BufferReserveNoop);
+
+} /*namespace bench*/
+} /*namespace tstorage*/
@@ -0,0 +1,44 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_BYTESPAYLOAD_BENCH_PH
+#define D_TSTORAGE_BYTESPAYLOAD_BENCH_PH
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include <tstorageclient++/PayloadType.h>
+
+namespace tstorage {
+namespace bench {
+
+/** @brief Treats payloads as raw byte strings. */
+class BytesPayload : public PayloadType<std::string>
+{
+public:
+	std::size_t toBytes(
+		const std::string& val, void* outputBuffer, const std::size_t bufferSize) override
+	{
+		if (bufferSize >= val.size()) {
+			std::memcpy(outputBuffer, val.data(), val.size());
+		}
+		return val.size();
+	}
+
+	bool fromBytes(std::string& oVar,
+		const void* payloadBuffer,
+		const std::size_t payloadSize) override
+	{
+		oVar.assign(static_cast<const char*>(payloadBuffer), payloadSize);
+		return true;
+	}
+};
+
+} /*namespace bench*/
+} /*namespace tstorage*/
+
+#endif
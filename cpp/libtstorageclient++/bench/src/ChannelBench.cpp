@@ -0,0 +1,179 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/RecordsSet.h>
+#include <tstorageclient++/Response.h>
+#include <tstorageclient++/ResponseAcq.h>
+#include <tstorageclient++/ResponseGet.h>
+
+#include "BenchCommon.h"
+#include "BytesPayload.h"
+#include "LoopbackServer.h"
+#include "Serializer.h"
+
+using namespace std::chrono_literals;
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+using impl::Serializer;
+
+/** @brief The approximate amount of record data in a single GET response. */
+constexpr std::size_t cResponseDataSize = 8UL * 1024 * 1024;
+/** @brief Extra room in the channel's buffer for headers and terminators. */
+constexpr std::size_t cBufferSlack = 1024;
+
+/** @brief Amount of records of a given payload size in a single response. */
+std::size_t recordsPerResponse(const std::size_t payloadSize)
+{
+	return std::max<std::size_t>(
+		1, cResponseDataSize / (sizeof(std::int32_t) + Serializer::cKeySize + payloadSize));
+}
+
+/**
+ * Streams GET responses from the loopback server through `getView()`, which
+ * leaves `ChannelImpl::readNextRecordData()` and the socket as the only work
+ * done per record.
+ */
+void BM_ChannelGetView(benchmark::State& state)
+{
+	const std::size_t payloadSize = static_cast<std::size_t>(state.range(0));
+	const std::size_t records = recordsPerResponse(payloadSize);
+	LoopbackServer server(records, payloadSize);
+	if (!server.valid()) {
+		state.SkipWithError("Cannot start the loopback server");
+		return;
+	}
+
+	Channel<std::string> channel("127.0.0.1", server.port(), std::make_unique<BytesPayload>());
+	channel.setTimeout(10000ms);
+	channel.setMemoryLimit(
+		std::max<std::size_t>(64UL * 1024, Serializer::cKeySize + payloadSize + cBufferSlack));
+	if (channel.connect().error()) {
+		state.SkipWithError("Cannot connect to the loopback server");
+		return;
+	}
+
+	std::size_t visited = 0;
+	const auto visitor = [&visited](const Key&, const void* payload, std::size_t size) {
+		benchmark::DoNotOptimize(payload);
+		visited += size;
+	};
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		const ResponseAcq res = channel.getView(cKeyMin, cKeyMax, visitor);
+		if (res.error()) {
+			state.SkipWithError("GET failed");
+			break;
+		}
+	}
+	benchmark::DoNotOptimize(visited);
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * records),
+		static_cast<std::int64_t>(Serializer::cKeySize + payloadSize),
+		counters);
+}
+
+/** Like `BM_ChannelGetView`, but deserializes the records with `get()`. */
+void BM_ChannelGet(benchmark::State& state)
+{
+	const std::size_t payloadSize = static_cast<std::size_t>(state.range(0));
+	const std::size_t records = recordsPerResponse(payloadSize);
+	LoopbackServer server(records, payloadSize);
+	if (!server.valid()) {
+		state.SkipWithError("Cannot start the loopback server");
+		return;
+	}
+
+	Channel<std::string> channel("127.0.0.1", server.port(), std::make_unique<BytesPayload>());
+	channel.setTimeout(10000ms);
+	channel.setMemoryLimit(server.getResponseSize() + cBufferSlack);
+	if (channel.connect().error()) {
+		state.SkipWithError("Cannot connect to the loopback server");
+		return;
+	}
+
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		const ResponseGet<std::string> res = channel.get(cKeyMin, cKeyMax);
+		if (res.error()) {
+			state.SkipWithError("GET failed");
+			break;
+		}
+		benchmark::DoNotOptimize(res.records().size());
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * records),
+		static_cast<std::int64_t>(Serializer::cKeySize + payloadSize),
+		counters);
+}
+
+/**
+ * Sends PUT requests of the same amount of records to the loopback server,
+ * which discards them, leaving `ChannelImpl::writeNextPutRecord()` and the
+ * serialization of the records as the work done per record.
+ */
+void BM_ChannelPut(benchmark::State& state)
+{
+	const std::size_t payloadSize = static_cast<std::size_t>(state.range(0));
+	const std::size_t records = recordsPerResponse(payloadSize);
+	LoopbackServer server(1, 0);
+	if (!server.valid()) {
+		state.SkipWithError("Cannot start the loopback server");
+		return;
+	}
+
+	RecordsSet<std::string> set;
+	const std::string payload(payloadSize, 'x');
+	for (std::size_t i = 0; i < records; ++i) {
+		set.append(Key(1, 2, 3, static_cast<Key::CapT>(i), 0), payload);
+	}
+
+	Channel<std::string> channel("127.0.0.1", server.port(), std::make_unique<BytesPayload>());
+	channel.setTimeout(10000ms);
+	channel.setMemoryLimit(
+		std::max<std::size_t>(64UL * 1024, Serializer::cKeySize + payloadSize + cBufferSlack));
+	if (channel.connect().error()) {
+		state.SkipWithError("Cannot connect to the loopback server");
+		return;
+	}
+
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		if (channel.put(set).error()) {
+			state.SkipWithError("PUT failed");
+			break;
+		}
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * records),
+		static_cast<std::int64_t>(Serializer::cKeySize + payloadSize),
+		counters);
+}
+
+} /*namespace*/
+
+BENCHMARK(BM_ChannelGetView)->Apply(payloadSizes)->UseRealTime();
+BENCHMARK(BM_ChannelGet)->Apply(payloadSizes)->UseRealTime();
+BENCHMARK(BM_ChannelPut)->Apply(payloadSizes)->UseRealTime();
+
+} /*namespace bench*/
+} /*namespace tstorage*/
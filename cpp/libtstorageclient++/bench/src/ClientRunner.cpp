@@ -0,0 +1,140 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <ratio>
+#include <string>
+
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/RecordsSet.h>
+#include <tstorageclient++/Response.h>
+#include <tstorageclient++/ResponseGet.h>
+
+#include "BytesPayload.h"
+
+using namespace std::chrono_literals;
+
+/*
+ * The runner of the C++ client for the cross-language benchmark suite. Its
+ * arguments, workloads and output are specified in bench/README.md at the top
+ * of the repository.
+ */
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/** @brief The memory limit of the channel. */
+constexpr std::size_t cMemoryLimit = 64UL * 1024 * 1024;
+
+/** @brief A single workload, as passed on the command line. */
+struct Workload
+{
+	std::string host;
+	std::uint16_t port = 0;
+	std::string op;
+	std::size_t records = 0;
+	std::size_t payloadSize = 0;
+	std::size_t cids = 0;
+	std::string layout;
+	unsigned int repetitions = 0;
+};
+
+bool parseArgs(const int argc, char** const argv, Workload& oWorkload)
+{
+	if (argc != 9) {
+		return false;
+	}
+	oWorkload.host = argv[1];
+	oWorkload.port = static_cast<std::uint16_t>(std::strtoul(argv[2], nullptr, 10));
+	oWorkload.op = argv[3];
+	oWorkload.records = std::strtoul(argv[4], nullptr, 10);
+	oWorkload.payloadSize = std::strtoul(argv[5], nullptr, 10);
+	oWorkload.cids = std::strtoul(argv[6], nullptr, 10);
+	oWorkload.layout = argv[7];
+	oWorkload.repetitions = static_cast<unsigned int>(std::strtoul(argv[8], nullptr, 10));
+	return (oWorkload.op == "put" || oWorkload.op == "puta" || oWorkload.op == "get")
+		&& (oWorkload.layout == "runs" || oWorkload.layout == "mixed") && oWorkload.cids != 0
+		&& oWorkload.repetitions != 0;
+}
+
+/** @brief Returns the records of a PUT/A workload. */
+RecordsSet<std::string> makeRecords(const Workload& workload)
+{
+	RecordsSet<std::string> records;
+	records.reserve(workload.records);
+	const std::string payload(workload.payloadSize, 'x');
+	for (std::size_t i = 0; i < workload.records; ++i) {
+		const std::size_t cid = workload.layout == "runs" ? i * workload.cids / workload.records
+														  : i % workload.cids;
+		const std::int64_t n = static_cast<std::int64_t>(i);
+		records.append(Key(static_cast<Key::CidT>(cid), n, 0, n, n), payload);
+	}
+	return records;
+}
+
+} /*namespace*/
+} /*namespace bench*/
+} /*namespace tstorage*/
+
+int main(int argc, char** argv)
+{
+	using namespace tstorage;
+	using namespace tstorage::bench;
+
+	Workload workload;
+	if (!parseArgs(argc, argv, workload)) {
+		std::cerr << "Usage: " << argv[0]
+				  << " HOST PORT put|puta|get RECORDS PAYLOAD CIDS runs|mixed REPETITIONS\n";
+		return 2;
+	}
+
+	Channel<std::string> channel(
+		workload.host, workload.port, std::make_unique<BytesPayload>(), cMemoryLimit);
+	channel.setTimeout(30000ms);
+	const Response resConnect = channel.connect();
+	if (resConnect.error()) {
+		std::cerr << "connect failed with status " << static_cast<int>(resConnect.status()) << "\n";
+		return 1;
+	}
+
+	const RecordsSet<std::string> records =
+		workload.op == "get" ? RecordsSet<std::string>() : makeRecords(workload);
+	// The first request warms the channel up and is not reported.
+	for (unsigned int i = 0; i <= workload.repetitions; ++i) {
+		std::size_t count = records.size();
+		const Clock::time_point start = Clock::now();
+		result_t res = result_t::OK;
+		if (workload.op == "put") {
+			res = channel.put(records).status();
+		} else if (workload.op == "puta") {
+			res = channel.puta(records).status();
+		} else {
+			const ResponseGet<std::string> get = channel.get(cKeyMin, cKeyMax);
+			res = get.status();
+			count = get.records().size();
+		}
+		const Clock::time_point stop = Clock::now();
+		if (res != result_t::OK) {
+			std::cerr << workload.op << " failed with status " << static_cast<int>(res) << "\n";
+			return 1;
+		}
+		if (i != 0) {
+			std::cout << std::chrono::duration<double, std::micro>(stop - start).count() << " "
+					  << count << "\n";
+		}
+	}
+	return 0;
+}
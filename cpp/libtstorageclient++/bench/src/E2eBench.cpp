@@ -0,0 +1,472 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <ratio>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/CountingAllocator.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/RecordsSet.h>
+#include <tstorageclient++/Response.h>
+#include <tstorageclient++/ResponseAcq.h>
+#include <tstorageclient++/ResponseGet.h>
+
+#include "BytesPayload.h"
+#include "LoopbackServer.h"
+#include "PerfCounters.h"
+#include "Serializer.h"
+
+using namespace std::chrono_literals;
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+using impl::Serializer;
+using Clock = std::chrono::steady_clock;
+
+/** @brief The largest amount of record data moved by a single request. */
+constexpr std::size_t cMaxRequestDataSize = 256UL * 1024 * 1024;
+/** @brief The overhead of a PUTA record and its batch inside the buffer. */
+constexpr std::size_t cPutOverhead = 56;
+
+/** @brief The benchmark matrix and the run settings. */
+struct Options
+{
+	std::vector<std::size_t> payloadSizes{4, 256, 16UL * 1024, 1024UL * 1024};
+	std::vector<std::size_t> recordCounts{1, 100, 10000};
+	std::vector<std::size_t> memoryLimits{64UL * 1024, 1024UL * 1024, 16UL * 1024 * 1024};
+	unsigned int repetitions = 20;
+	/** @brief The most allocations a request may make once warmed up,
+	 * negative for no bound. */
+	double maxAllocs = -1;
+};
+
+/** @brief Latency samples of a single cell of the matrix. */
+struct Samples
+{
+	std::vector<double> latenciesUs;
+	std::size_t records = 0;
+	std::size_t recordSize = 0;
+	result_t error = result_t::OK;
+	/** @brief The buffer and records allocations per request, the first one
+	 * excluded. */
+	double allocsPerRequest = 0;
+	/** @brief The send and receive syscalls per MiB sent or received. */
+	double callsPerMiB = 0;
+	/** @brief The events counted over the requests, the first one excluded,
+	 * with `--perf`. */
+	std::array<double, cPerfEvents> events{};
+	/** @brief Whether each of `events` was counted. */
+	std::array<bool, cPerfEvents> eventsAvailable{};
+	/** @brief The amount of requests `events` were counted over. */
+	unsigned int countedRequests = 0;
+};
+
+/** @brief Returns the `p`-th percentile of sorted `values`. */
+double percentile(const std::vector<double>& values, const double p)
+{
+	const std::size_t rank = static_cast<std::size_t>(std::ceil(p * values.size()));
+	return values[std::max<std::size_t>(rank, 1) - 1];
+}
+
+/** @brief Parses a comma separated list of sizes, accepting K and M
+ * suffixes. */
+bool parseSizes(const char* list, std::vector<std::size_t>& oSizes)
+{
+	std::vector<std::size_t> sizes;
+	while (*list != '\0') {
+		char* end = nullptr;
+		std::size_t value = std::strtoul(list, &end, 10);
+		if (end == list) {
+			return false;
+		}
+		if (*end == 'K') {
+			value *= 1024;
+			++end;
+		} else if (*end == 'M') {
+			value *= 1024 * 1024;
+			++end;
+		}
+		sizes.push_back(value);
+		if (*end == ',') {
+			++end;
+		} else if (*end != '\0') {
+			return false;
+		}
+		list = end;
+	}
+	oSizes = sizes;
+	return !oSizes.empty();
+}
+
+bool parseOptions(const int argc, char** const argv, Options& oOptions)
+{
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--perf") {
+			PerfCounters::enableGlobally(true);
+			continue;
+		}
+		const std::size_t eq = arg.find('=');
+		if (eq == std::string::npos) {
+			return false;
+		}
+		const std::string name = arg.substr(0, eq);
+		const char* value = argv[i] + eq + 1;
+		if (name == "--payloads") {
+			if (!parseSizes(value, oOptions.payloadSizes)) {
+				return false;
+			}
+		} else if (name == "--records") {
+			if (!parseSizes(value, oOptions.recordCounts)) {
+				return false;
+			}
+		} else if (name == "--limits") {
+			if (!parseSizes(value, oOptions.memoryLimits)) {
+				return false;
+			}
+		} else if (name == "--reps") {
+			oOptions.repetitions = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+			if (oOptions.repetitions == 0) {
+				return false;
+			}
+		} else if (name == "--max-allocs") {
+			char* end = nullptr;
+			oOptions.maxAllocs = std::strtod(value, &end);
+			if (end == value || *end != '\0' || oOptions.maxAllocs < 0) {
+				return false;
+			}
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+void printUsage(const char* name)
+{
+	std::cerr << "Usage: " << name << " [--payloads=LIST] [--records=LIST] [--limits=LIST]"
+			  << " [--reps=N] [--max-allocs=N] [--perf]\n"
+			  << "  LIST is a comma separated list of sizes, e.g. 4,1K,2M.\n"
+			  << "  --max-allocs fails the run if a request allocates more than N times on\n"
+			  << "  average once warmed up.\n"
+			  << "  --perf adds the hardware counters and the context switches of the client\n"
+			  << "  thread per record, and the hardware counters per byte.\n";
+}
+
+void printHeader()
+{
+	std::cout << std::left << std::setw(10) << "op" << std::right << std::setw(10) << "payload"
+			  << std::setw(9) << "records" << std::setw(10) << "limit" << std::setw(11)
+			  << "p50[us]" << std::setw(11) << "p90[us]" << std::setw(11) << "p99[us]"
+			  << std::setw(11) << "max[us]" << std::setw(14) << "records/s" << std::setw(11)
+			  << "MiB/s" << std::setw(12) << "allocs/req" << std::setw(11) << "calls/MiB";
+	if (PerfCounters::enabledGlobally()) {
+		for (std::size_t i = 0; i < cPerfEvents; ++i) {
+			const char* name = PerfCounters::name(static_cast<PerfEvent>(i));
+			std::cout << std::setw(13) << (std::string(name) + "/rec");
+		}
+		for (std::size_t i = 0; i < cPerfEvents; ++i) {
+			const PerfEvent event = static_cast<PerfEvent>(i);
+			if (event != PerfEvent::CONTEXT_SWITCHES) {
+				std::cout << std::setw(11) << (std::string(PerfCounters::name(event)) + "/B");
+			}
+		}
+	}
+	std::cout << "\n";
+}
+
+/** @brief Prints the events counted per request of `samples`, per record and
+ * per byte. */
+void printEvents(const Samples& samples)
+{
+	const double records = static_cast<double>(samples.records) * samples.countedRequests;
+	const double bytes = records * samples.recordSize;
+	for (std::size_t i = 0; i < cPerfEvents; ++i) {
+		// Context switches are rare per record, unlike the hardware events.
+		const bool rare = static_cast<PerfEvent>(i) == PerfEvent::CONTEXT_SWITCHES;
+		std::cout << std::setprecision(rare ? 3 : 1) << std::setw(13);
+		if (samples.eventsAvailable[i] && records > 0) {
+			std::cout << samples.events[i] / records;
+		} else {
+			std::cout << "n/a";
+		}
+	}
+	std::cout << std::setprecision(3);
+	for (std::size_t i = 0; i < cPerfEvents; ++i) {
+		if (static_cast<PerfEvent>(i) == PerfEvent::CONTEXT_SWITCHES) {
+			continue;
+		}
+		std::cout << std::setw(11);
+		if (samples.eventsAvailable[i] && bytes > 0) {
+			std::cout << samples.events[i] / bytes;
+		} else {
+			std::cout << "n/a";
+		}
+	}
+}
+
+/** @brief Prints a row of the results, returning `false` if the requests
+ * allocated more than `maxAllocs` times. */
+bool printRow(const char* op,
+	const std::size_t payloadSize,
+	const std::size_t records,
+	const std::size_t memoryLimit,
+	const double maxAllocs,
+	Samples& samples)
+{
+	std::cout << std::left << std::setw(10) << op << std::right << std::setw(10) << payloadSize
+			  << std::setw(9) << records << std::setw(10) << memoryLimit;
+	if (samples.error != result_t::OK) {
+		std::cout << "  failed with status " << static_cast<int>(samples.error) << "\n";
+		return true;
+	}
+	std::vector<double>& latencies = samples.latenciesUs;
+	std::sort(latencies.begin(), latencies.end());
+	double totalUs = 0;
+	for (const double latency : latencies) {
+		totalUs += latency;
+	}
+	const double meanS = totalUs / latencies.size() / 1e6;
+	const double recordsPerS = samples.records / meanS;
+	const double mibPerS = samples.records * samples.recordSize / meanS / (1024 * 1024);
+	std::cout << std::fixed << std::setprecision(1) << std::setw(11) << percentile(latencies, 0.5)
+			  << std::setw(11) << percentile(latencies, 0.9) << std::setw(11)
+			  << percentile(latencies, 0.99) << std::setw(11) << latencies.back()
+			  << std::setprecision(0) << std::setw(14) << recordsPerS << std::setprecision(1)
+			  << std::setw(11) << mibPerS << std::setprecision(2) << std::setw(12)
+			  << samples.allocsPerRequest << std::setprecision(1) << std::setw(11)
+			  << samples.callsPerMiB;
+	if (PerfCounters::enabledGlobally()) {
+		printEvents(samples);
+	}
+	const bool withinBound = maxAllocs < 0 || samples.allocsPerRequest <= maxAllocs;
+	std::cout << (withinBound ? "" : "  over the allocation bound") << "\n";
+	return withinBound;
+}
+
+/** @brief Returns the allocations of the buffers of `channel` and of the
+ * records counted by `counter`. */
+std::uint64_t allocations(const Channel<std::string>& channel, const AllocationCounter& counter)
+{
+	return channel.stats().bufferAllocations + counter.allocations();
+}
+
+/**
+ * @brief Times `repetitions` calls of `request`, which returns the status
+ * code of the request, and counts their allocations and syscalls.
+ *
+ * The first call warms the buffers up, so its allocations, and with `--perf`
+ * its events, are left out.
+ */
+Samples measure(const unsigned int repetitions,
+	const Channel<std::string>& channel,
+	const AllocationCounter& counter,
+	const std::function<result_t()>& request)
+{
+	Samples samples;
+	const ChannelStats before = channel.stats();
+	std::uint64_t warmAllocations = 0;
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	const unsigned int firstCounted = repetitions > 1 ? 1 : 0;
+	for (unsigned int i = 0; i < repetitions; ++i) {
+		if (i == firstCounted) {
+			counters.start();
+		}
+		const Clock::time_point start = Clock::now();
+		const result_t res = request();
+		const Clock::time_point stop = Clock::now();
+		if (res != result_t::OK) {
+			samples.error = res;
+			break;
+		}
+		samples.latenciesUs.push_back(
+			std::chrono::duration<double, std::micro>(stop - start).count());
+		if (i == 0) {
+			warmAllocations = allocations(channel, counter);
+		}
+	}
+	if (samples.error != result_t::OK) {
+		return samples;
+	}
+	counters.stop();
+	samples.countedRequests = repetitions - firstCounted;
+	for (std::size_t i = 0; i < cPerfEvents; ++i) {
+		samples.events[i] = counters.value(static_cast<PerfEvent>(i));
+		samples.eventsAvailable[i] = counters.available(static_cast<PerfEvent>(i));
+	}
+	const ChannelStats after = channel.stats();
+	if (repetitions > 1) {
+		samples.allocsPerRequest =
+			static_cast<double>(allocations(channel, counter) - warmAllocations) / (repetitions - 1);
+	}
+	const double mib = static_cast<double>(after.bytesSent + after.bytesReceived
+							 - before.bytesSent - before.bytesReceived)
+		/ (1024 * 1024);
+	const double calls = static_cast<double>(
+		after.sendCalls + after.recvCalls - before.sendCalls - before.recvCalls);
+	samples.callsPerMiB = mib > 0 ? calls / mib : 0;
+	return samples;
+}
+
+/**
+ * @brief Benchmarks all requests for a single payload size and record
+ * count, across memory limits.
+ *
+ * @param[out] oWithinBound Set to `false` if a request allocated more than
+ * `Options::maxAllocs` times.
+ * @return `false` if the benchmark could not be run.
+ */
+bool runCell(const Options& options,
+	const std::size_t payloadSize,
+	const std::size_t count,
+	bool& oWithinBound)
+{
+	LoopbackServer server(count, payloadSize);
+	if (!server.valid()) {
+		std::cerr << "Cannot start the loopback server\n";
+		return false;
+	}
+
+	RecordsSet<std::string> records;
+	records.reserve(count);
+	const std::string payload(payloadSize, 'x');
+	for (std::size_t i = 0; i < count; ++i) {
+		records.append(Key(1, 2, 3, static_cast<Key::CapT>(i), static_cast<Key::AcqT>(i)), payload);
+	}
+	const std::size_t recordSize = Serializer::cKeySize + payloadSize;
+
+	for (const std::size_t memoryLimit : options.memoryLimits) {
+		if (payloadSize + cPutOverhead > memoryLimit) {
+			continue;
+		}
+		Channel<std::string> channel(
+			"127.0.0.1", server.port(), std::make_unique<BytesPayload>(), memoryLimit);
+		channel.setTimeout(30000ms);
+		// Counts the allocations of the records containers of GET responses.
+		const CountingAllocator<Record<std::string>> alloc =
+			makeCountingAllocator<Record<std::string>>();
+		const AllocationCounter& counter = *alloc.counter();
+		const Response resConnect = channel.connect();
+		if (resConnect.error()) {
+			std::cerr << "Cannot connect to the loopback server: "
+					  << static_cast<int>(resConnect.status()) << "\n";
+			return false;
+		}
+
+		Samples put = measure(options.repetitions, channel, counter, [&]() {
+			return channel.put(records).status();
+		});
+		put.records = count;
+		put.recordSize = recordSize;
+		oWithinBound &= printRow("put", payloadSize, count, memoryLimit, options.maxAllocs, put);
+		if (!channel.connected() && channel.connect().error()) {
+			return false;
+		}
+
+		Samples puta = measure(options.repetitions, channel, counter, [&]() {
+			return channel.puta(records).status();
+		});
+		puta.records = count;
+		puta.recordSize = recordSize;
+		oWithinBound &=
+			printRow("puta", payloadSize, count, memoryLimit, options.maxAllocs, puta);
+		if (!channel.connected() && channel.connect().error()) {
+			return false;
+		}
+
+		// A whole `get()` response has to fit within the memory limit.
+		if (server.getResponseSize() <= memoryLimit) {
+			Samples get = measure(options.repetitions, channel, counter, [&]() {
+				return channel.get(cKeyMin, cKeyMax, alloc).status();
+			});
+			get.records = count;
+			get.recordSize = recordSize;
+			oWithinBound &=
+				printRow("get", payloadSize, count, memoryLimit, options.maxAllocs, get);
+			if (!channel.connected() && channel.connect().error()) {
+				return false;
+			}
+		}
+
+		std::size_t streamed = 0;
+		Samples stream = measure(options.repetitions, channel, counter, [&]() {
+			return channel
+				.getStream(cKeyMin,
+					cKeyMax,
+					alloc,
+					[&streamed](CountingRecordsSet<std::string>& batch) {
+						streamed += batch.size();
+					})
+				.status();
+		});
+		stream.records = count;
+		stream.recordSize = recordSize;
+		oWithinBound &= printRow(
+			"getStream", payloadSize, count, memoryLimit, options.maxAllocs, stream);
+		if (!channel.connected() && channel.connect().error()) {
+			return false;
+		}
+
+		Samples acq = measure(options.repetitions, channel, counter, [&]() {
+			return channel.getAcq(cKeyMin, cKeyMax).status();
+		});
+		acq.records = 1;
+		acq.recordSize = sizeof(Key::AcqT);
+		oWithinBound &=
+			printRow("getAcq", payloadSize, count, memoryLimit, options.maxAllocs, acq);
+	}
+	return true;
+}
+
+} /*namespace*/
+} /*namespace bench*/
+} /*namespace tstorage*/
+
+int main(int argc, char** argv)
+{
+	using namespace tstorage::bench;
+
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printUsage(argv[0]);
+		return 2;
+	}
+
+	printHeader();
+	bool withinBound = true;
+	for (const std::size_t payloadSize : options.payloadSizes) {
+		for (const std::size_t count : options.recordCounts) {
+			if (payloadSize * count > cMaxRequestDataSize) {
+				continue;
+			}
+			if (!runCell(options, payloadSize, count, withinBound)) {
+				return 1;
+			}
+		}
+	}
+	if (!withinBound) {
+		std::cerr << "Requests allocated more than " << options.maxAllocs
+				  << " times on average\n";
+		return 1;
+	}
+	return 0;
+}
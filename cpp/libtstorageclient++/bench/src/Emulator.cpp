@@ -0,0 +1,42 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "LoopbackServer.h"
+
+/*
+ * A standalone loopback emulator, shared by the benchmark runners of all the
+ * client libraries (see bench/README.md at the top of the repository).
+ *
+ * Prints the port it listens on as the first line of the standard output and
+ * serves until its standard input is closed.
+ */
+int main(int argc, char** argv)
+{
+	if (argc != 3) {
+		std::cerr << "Usage: " << argv[0] << " GET_RECORDS GET_PAYLOAD\n";
+		return 2;
+	}
+	const std::size_t getRecords = std::strtoul(argv[1], nullptr, 10);
+	const std::size_t getPayloadSize = std::strtoul(argv[2], nullptr, 10);
+
+	tstorage::bench::LoopbackServer server(getRecords, getPayloadSize);
+	if (!server.valid()) {
+		std::cerr << "Cannot start the loopback server\n";
+		return 1;
+	}
+	std::cout << server.port() << std::endl;
+
+	char byte{};
+	while (::read(STDIN_FILENO, &byte, sizeof(byte)) > 0) {
+	}
+	return 0;
+}
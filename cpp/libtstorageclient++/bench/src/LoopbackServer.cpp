@@ -0,0 +1,282 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "LoopbackServer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Buffer.h"
+#include "Headers.h"
+#include "Serializer.h"
+
+namespace tstorage {
+namespace bench {
+
+using impl::Buffer;
+using impl::CommandType;
+using impl::Header;
+using impl::Serializer;
+
+namespace {
+
+/** @brief The size of the receive buffer of a connection. */
+constexpr std::size_t cRecvBufferSize = 1024UL * 1024;
+/** @brief The size of the key pair of a GET/GETACQ request. */
+constexpr std::uint64_t cKeyRangeSize = 2 * Serializer::cKeySize;
+
+/** @brief Serializes a complete GET response the way TStorage sends it. */
+std::vector<char> makeGetResponse(const std::size_t records, const std::size_t payloadSize)
+{
+	const std::size_t recordSize = sizeof(std::int32_t) + Serializer::cKeySize + payloadSize;
+	const std::size_t responseSize = 2 * Serializer::cHeaderSize + records * recordSize
+		+ sizeof(std::int32_t) + sizeof(Key::AcqT);
+	Buffer buffer(responseSize);
+	Serializer serializer(buffer);
+
+	serializer.putHeader(Header{});
+	for (std::size_t i = 0; i < records; ++i) {
+		serializer.putInt32(static_cast<std::int32_t>(Serializer::cKeySize + payloadSize));
+		serializer.putKey(Key(1, 2, 3, static_cast<Key::CapT>(i), static_cast<Key::AcqT>(i)));
+		std::memset(buffer.writeData(), 'x', payloadSize);
+		serializer.confirmPayloadBuffer(payloadSize);
+	}
+	serializer.putInt32(0);
+	Header acqHeader{};
+	acqHeader.dataSize = sizeof(Key::AcqT);
+	serializer.putHeader(acqHeader);
+	serializer.putInt64(static_cast<std::int64_t>(records));
+
+	const char* data = static_cast<const char*>(buffer.readData());
+	return std::vector<char>(data, data + buffer.bytesAvailableToRead());
+}
+
+} /*namespace*/
+
+/** @brief A connected socket with a receive buffer. */
+class LoopbackServer::Connection
+{
+public:
+	explicit Connection(const int fd) : mFd(fd), mBuffer(cRecvBufferSize), mBegin(0), mEnd(0) {}
+
+	/** @brief Receives exactly `size` bytes into `dest`. */
+	bool recv(void* const dest, const std::size_t size)
+	{
+		char* out = static_cast<char*>(dest);
+		std::size_t left = size;
+		while (left > 0) {
+			if (mBegin == mEnd && !fill()) {
+				return false;
+			}
+			const std::size_t chunk = std::min(left, mEnd - mBegin);
+			std::memcpy(out, mBuffer.data() + mBegin, chunk);
+			mBegin += chunk;
+			out += chunk;
+			left -= chunk;
+		}
+		return true;
+	}
+
+	/** @brief Receives and discards exactly `size` bytes. */
+	bool skip(std::uint64_t size)
+	{
+		while (size > 0) {
+			if (mBegin == mEnd && !fill()) {
+				return false;
+			}
+			const std::size_t chunk =
+				static_cast<std::size_t>(std::min<std::uint64_t>(size, mEnd - mBegin));
+			mBegin += chunk;
+			size -= chunk;
+		}
+		return true;
+	}
+
+	/** @brief Receives a little-endian integer. */
+	template<typename T>
+	bool recvInt(T& oValue)
+	{
+		char bytes[sizeof(T)];
+		if (!recv(bytes, sizeof(T))) {
+			return false;
+		}
+		Serializer::get<T>(oValue, bytes);
+		return true;
+	}
+
+	/** @brief Sends exactly `size` bytes from `src`. */
+	bool send(const void* const src, const std::size_t size)
+	{
+		const char* in = static_cast<const char*>(src);
+		std::size_t left = size;
+		while (left > 0) {
+			const ssize_t res = ::send(mFd, in, left, MSG_NOSIGNAL);
+			if (res <= 0) {
+				return false;
+			}
+			in += res;
+			left -= static_cast<std::size_t>(res);
+		}
+		return true;
+	}
+
+	/** @brief Sends a standard response header followed by `acqs`. */
+	bool sendAcqs(const std::int64_t* const acqs, const std::size_t count)
+	{
+		Buffer buffer(Serializer::cHeaderSize + count * sizeof(std::int64_t));
+		Serializer serializer(buffer);
+		Header header{};
+		header.dataSize = count * sizeof(std::int64_t);
+		serializer.putHeader(header);
+		for (std::size_t i = 0; i < count; ++i) {
+			serializer.putInt64(acqs[i]);
+		}
+		return send(buffer.readData(), buffer.bytesAvailableToRead());
+	}
+
+private:
+	/** @brief Refills the empty receive buffer. */
+	bool fill()
+	{
+		const ssize_t res = ::recv(mFd, mBuffer.data(), mBuffer.size(), 0);
+		if (res <= 0) {
+			return false;
+		}
+		mBegin = 0;
+		mEnd = static_cast<std::size_t>(res);
+		return true;
+	}
+
+	int mFd;
+	std::vector<char> mBuffer;
+	std::size_t mBegin;
+	std::size_t mEnd;
+};
+
+LoopbackServer::LoopbackServer(const std::size_t getRecords, const std::size_t getPayloadSize)
+	: mGetResponse(makeGetResponse(getRecords, getPayloadSize))
+	, mListenFd(-1)
+	, mConnFd(-1)
+	, mPort(0)
+	, mAcq(0)
+{
+	const int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (fd < 0) {
+		return;
+	}
+	struct sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	socklen_t addrLen = sizeof(addr);
+	if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0
+		|| ::listen(fd, 1) < 0
+		|| ::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &addrLen) < 0) {
+		::close(fd);
+		return;
+	}
+	mListenFd = fd;
+	mPort = ntohs(addr.sin_port);
+	mThread = std::thread(&LoopbackServer::serve, this);
+}
+
+LoopbackServer::~LoopbackServer()
+{
+	if (mListenFd < 0) {
+		return;
+	}
+	// Wakes the serving thread up from `accept()` or `recv()`.
+	::shutdown(mListenFd, SHUT_RDWR);
+	const int connFd = mConnFd;
+	if (connFd >= 0) {
+		::shutdown(connFd, SHUT_RDWR);
+	}
+	mThread.join();
+	::close(mListenFd);
+}
+
+void LoopbackServer::serve()
+{
+	while (true) {
+		const int connFd = ::accept(mListenFd, nullptr, nullptr);
+		if (connFd < 0) {
+			return;
+		}
+		mConnFd = connFd;
+		Connection conn(connFd);
+		serveConnection(conn);
+		mConnFd = -1;
+		::close(connFd);
+	}
+}
+
+void LoopbackServer::serveConnection(Connection& conn)
+{
+	while (true) {
+		std::int32_t command{};
+		std::uint64_t dataSize{};
+		if (!conn.recvInt(command) || !conn.recvInt(dataSize)) {
+			return;
+		}
+
+		switch (command) {
+			case CommandType::GET:
+			case CommandType::GETACQ: {
+				if (dataSize != cKeyRangeSize || !conn.skip(dataSize)) {
+					return;
+				}
+				++mAcq;
+				const bool sent = command == CommandType::GET
+					? conn.send(mGetResponse.data(), mGetResponse.size())
+					: conn.sendAcqs(&mAcq, 1);
+				if (!sent) {
+					return;
+				}
+				break;
+			}
+			case CommandType::PUT:
+			case CommandType::PUTA: {
+				if (!conn.skip(dataSize)) {
+					return;
+				}
+				std::int32_t cid{};
+				if (!conn.recvInt(cid)) {
+					return;
+				}
+				while (cid >= 0) {
+					std::int32_t batchSize{};
+					if (!conn.recvInt(batchSize) || batchSize < 0
+						|| !conn.skip(static_cast<std::uint64_t>(batchSize))
+						|| !conn.recvInt(cid)) {
+						return;
+					}
+				}
+				++mAcq;
+				const std::int64_t acqs[2] = {mAcq, mAcq};
+				if (!conn.sendAcqs(acqs, 2)) {
+					return;
+				}
+				break;
+			}
+			default:
+				return;
+		}
+	}
+}
+
+} /*namespace bench*/
+} /*namespace tstorage*/
@@ -0,0 +1,80 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_LOOPBACKSERVER_BENCH_PH
+#define D_TSTORAGE_LOOPBACKSERVER_BENCH_PH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace tstorage {
+namespace bench {
+
+/**
+ * @brief A minimal in-process TStorage emulator with zero-cost storage.
+ *
+ * Listens on an ephemeral port of the loopback interface and speaks the
+ * TStorage wire protocol, serving one connection at a time:
+ *  - PUT/PUTA requests are parsed batch by batch up to the end marker, their
+ *    records are discarded and a success response is sent back;
+ *  - GET requests are answered with the same canned set of synthetic
+ *    records, regardless of the key-interval;
+ *  - GETACQ requests are answered with a monotonically increasing timestamp.
+ *
+ * Used to measure the client without the overhead of a real database.
+ */
+class LoopbackServer
+{
+public:
+	/**
+	 * @brief Starts the server.
+	 * @param getRecords The amount of records in each GET response.
+	 * @param getPayloadSize The payload size of each of these records.
+	 */
+	LoopbackServer(std::size_t getRecords, std::size_t getPayloadSize);
+	/** @brief Stops the server, closing the current connection. */
+	~LoopbackServer();
+
+	LoopbackServer(const LoopbackServer&) = delete;
+	LoopbackServer& operator=(const LoopbackServer&) = delete;
+
+	/** @brief Returns `true` if the server is listening. */
+	bool valid() const { return mListenFd >= 0; }
+	/** @brief Returns the port the server listens on. */
+	std::uint16_t port() const { return mPort; }
+	/** @brief Returns the size of a single GET response in bytes. */
+	std::size_t getResponseSize() const { return mGetResponse.size(); }
+
+private:
+	class Connection;
+
+	/** @brief The body of the serving thread. */
+	void serve();
+	/** @brief Answers requests on `conn` until the peer disconnects or
+	 * violates the protocol. */
+	void serveConnection(Connection& conn);
+
+	/** @brief The canned GET response. */
+	std::vector<char> mGetResponse;
+	/** @brief The listening socket. */
+	int mListenFd;
+	/** @brief The currently served connection, or `-1`. */
+	std::atomic<int> mConnFd;
+	/** @brief The port the server listens on. */
+	std::uint16_t mPort;
+	/** @brief The last ACQ timestamp sent. */
+	std::int64_t mAcq;
+	/** @brief The serving thread. */
+	std::thread mThread;
+};
+
+} /*namespace bench*/
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <tstorageclient++/NumericPayloadTypes.h>
+#include <tstorageclient++/PayloadType.h>
+
+#include "BenchCommon.h"
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+/** @brief The amount of scalar values encoded or decoded per iteration. */
+constexpr std::size_t cScalarValues = 4096;
+/** @brief The largest scalar payload of the benchmarked types. */
+constexpr std::size_t cMaxScalarSize = 10;
+
+/** @brief Returns scalar values of small magnitude, half of them negative for
+ * signed types. */
+template<typename T>
+std::vector<T> scalarValues()
+{
+	std::vector<T> values(cScalarValues);
+	for (std::size_t i = 0; i < cScalarValues; ++i) {
+		values[i] = static_cast<T>(static_cast<std::int64_t>((i * 2654435761U) % 1000) - 500);
+	}
+	return values;
+}
+
+/** @brief Returns a slowly changing series of `count` values with repeats,
+ * as sensors report. */
+template<typename F>
+std::vector<F> seriesValues(const std::size_t count)
+{
+	std::vector<F> values(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		values[i] = static_cast<F>(20.0 + 0.25 * static_cast<double>((i / 3) % 16));
+	}
+	return values;
+}
+
+/**
+ * Serializes scalars through the `PayloadType<T>` interface, as the channel
+ * does for each record of a PUT.
+ */
+template<typename Type, typename T>
+void BM_PayloadTypeEncode(benchmark::State& state)
+{
+	Type concrete;
+	PayloadType<T>& type = concrete;
+	const std::vector<T> values = scalarValues<T>();
+	std::vector<unsigned char> output(cScalarValues * cMaxScalarSize);
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		unsigned char* out = output.data();
+		for (const T& value : values) {
+			out += type.toBytes(value, out, cMaxScalarSize);
+		}
+		benchmark::DoNotOptimize(out);
+		benchmark::ClobberMemory();
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * cScalarValues),
+		sizeof(T),
+		counters);
+}
+
+/** Like `BM_PayloadTypeEncode`, but deserializes the scalars. */
+template<typename Type, typename T>
+void BM_PayloadTypeDecode(benchmark::State& state)
+{
+	Type concrete;
+	PayloadType<T>& type = concrete;
+	const std::vector<T> values = scalarValues<T>();
+	std::vector<unsigned char> input(cScalarValues * cMaxScalarSize);
+	std::vector<std::size_t> sizes;
+	unsigned char* in = input.data();
+	for (const T& value : values) {
+		sizes.push_back(type.toBytes(value, in, cMaxScalarSize));
+		in += sizes.back();
+	}
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		const unsigned char* next = input.data();
+		T sum = 0;
+		for (const std::size_t size : sizes) {
+			T value{};
+			if (!type.fromBytes(value, next, size)) {
+				state.SkipWithError("Decoding failed");
+				break;
+			}
+			sum += value;
+			next += size;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * cScalarValues),
+		sizeof(T),
+		counters);
+}
+
+/** Encodes an array of `state.range(0)` values with `GorillaPayloadType`. */
+template<typename F>
+void BM_GorillaEncode(benchmark::State& state)
+{
+	GorillaPayloadType<F> type;
+	const std::size_t count = static_cast<std::size_t>(state.range(0));
+	const std::vector<F> values = seriesValues<F>(count);
+	std::vector<unsigned char> output(16 + count * (sizeof(F) + 2));
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		const std::size_t size = type.toBytes(values, output.data(), output.size());
+		benchmark::DoNotOptimize(size);
+		benchmark::ClobberMemory();
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * count),
+		sizeof(F),
+		counters);
+}
+
+/** Like `BM_GorillaEncode`, but decodes the array. */
+template<typename F>
+void BM_GorillaDecode(benchmark::State& state)
+{
+	GorillaPayloadType<F> type;
+	const std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::vector<unsigned char> input(16 + count * (sizeof(F) + 2));
+	input.resize(type.toBytes(seriesValues<F>(count), input.data(), input.size()));
+	std::vector<F> values;
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		if (!type.fromBytes(values, input.data(), input.size())) {
+			state.SkipWithError("Decoding failed");
+			break;
+		}
+		benchmark::DoNotOptimize(values.data());
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * count),
+		sizeof(F),
+		counters);
+}
+
+} /*namespace*/
+
+BENCHMARK_TEMPLATE(BM_PayloadTypeEncode, LittleEndianPayloadType<double>, double);
+BENCHMARK_TEMPLATE(BM_PayloadTypeDecode, LittleEndianPayloadType<double>, double);
+BENCHMARK_TEMPLATE(BM_PayloadTypeEncode, ByteSwappedPayloadType<double>, double);
+BENCHMARK_TEMPLATE(BM_PayloadTypeDecode, ByteSwappedPayloadType<double>, double);
+BENCHMARK_TEMPLATE(BM_PayloadTypeEncode, VarintPayloadType<std::int64_t>, std::int64_t);
+BENCHMARK_TEMPLATE(BM_PayloadTypeDecode, VarintPayloadType<std::int64_t>, std::int64_t);
+BENCHMARK_TEMPLATE(BM_PayloadTypeEncode, VarintPayloadType<std::uint32_t>, std::uint32_t);
+BENCHMARK_TEMPLATE(BM_PayloadTypeDecode, VarintPayloadType<std::uint32_t>, std::uint32_t);
+BENCHMARK_TEMPLATE(BM_GorillaEncode, float)->ArgName("values")->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_GorillaDecode, float)->ArgName("values")->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_GorillaEncode, double)->ArgName("values")->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_GorillaDecode, double)->ArgName("values")->Arg(16)->Arg(256)->Arg(4096);
+
+} /*namespace bench*/
+} /*namespace tstorage*/
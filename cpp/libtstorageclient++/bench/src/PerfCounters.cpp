@@ -0,0 +1,172 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "PerfCounters.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+/** @brief Whether the benchmarks count the events. */
+bool gEnabled = false;
+
+/** @brief The `perf_event_attr::config` of the hardware events, in the order
+ * of `PerfEvent`. */
+constexpr std::uint64_t cHardwareConfigs[] = {
+	PERF_COUNT_HW_CPU_CYCLES,
+	PERF_COUNT_HW_INSTRUCTIONS,
+	PERF_COUNT_HW_CACHE_MISSES,
+	PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+/** @brief The layout of a counter read with the enabled and running times. */
+struct Reading
+{
+	std::uint64_t value;
+	std::uint64_t timeEnabled;
+	std::uint64_t timeRunning;
+};
+
+/** @brief Opens a disabled hardware counter of the calling thread, with the
+ * kernel side counted if allowed. */
+int openCounter(const std::uint64_t config)
+{
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = config;
+	attr.disabled = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	for (const int excludeKernel : {0, 1}) {
+		attr.exclude_kernel = excludeKernel;
+		const long fd = ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+		if (fd >= 0) {
+			return static_cast<int>(fd);
+		}
+	}
+	return -1;
+}
+
+} /*namespace*/
+
+PerfCounters::PerfCounters(const bool enabled)
+	: mEnabled(enabled)
+	, mFds()
+	, mValues()
+	, mSwitchesAtStart(0)
+{
+	mFds.fill(-1);
+	mValues.fill(0);
+	if (!mEnabled) {
+		return;
+	}
+	for (std::size_t i = 0; i < sizeof(cHardwareConfigs) / sizeof(cHardwareConfigs[0]); ++i) {
+		mFds[i] = openCounter(cHardwareConfigs[i]);
+	}
+}
+
+PerfCounters::~PerfCounters()
+{
+	for (const int fd : mFds) {
+		if (fd >= 0) {
+			::close(fd);
+		}
+	}
+}
+
+void PerfCounters::start()
+{
+	if (!mEnabled) {
+		return;
+	}
+	mValues.fill(0);
+	mSwitchesAtStart = contextSwitches();
+	for (const int fd : mFds) {
+		if (fd >= 0) {
+			::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+}
+
+void PerfCounters::stop()
+{
+	if (!mEnabled) {
+		return;
+	}
+	for (std::size_t i = 0; i < cPerfEvents; ++i) {
+		const int fd = mFds[i];
+		if (fd < 0) {
+			continue;
+		}
+		::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		Reading reading{};
+		if (::read(fd, &reading, sizeof(reading)) != static_cast<ssize_t>(sizeof(reading))) {
+			continue;
+		}
+		// Scales the count up to the whole time if the counter was multiplexed.
+		mValues[i] = reading.timeRunning == 0
+			? 0
+			: static_cast<double>(reading.value) * reading.timeEnabled / reading.timeRunning;
+	}
+	mValues[index(PerfEvent::CONTEXT_SWITCHES)] =
+		static_cast<double>(contextSwitches() - mSwitchesAtStart);
+}
+
+bool PerfCounters::available(const PerfEvent event) const
+{
+	return mEnabled && (event == PerfEvent::CONTEXT_SWITCHES || mFds[index(event)] >= 0);
+}
+
+const char* PerfCounters::name(const PerfEvent event)
+{
+	switch (event) {
+	case PerfEvent::CYCLES:
+		return "cycles";
+	case PerfEvent::INSTRUCTIONS:
+		return "instrs";
+	case PerfEvent::CACHE_MISSES:
+		return "cmisses";
+	case PerfEvent::BRANCH_MISSES:
+		return "bmisses";
+	case PerfEvent::CONTEXT_SWITCHES:
+		return "ctxsw";
+	}
+	return "";
+}
+
+void PerfCounters::enableGlobally(const bool enabled)
+{
+	gEnabled = enabled;
+}
+
+bool PerfCounters::enabledGlobally()
+{
+	return gEnabled;
+}
+
+std::uint64_t PerfCounters::contextSwitches()
+{
+	rusage usage{};
+	if (::getrusage(RUSAGE_THREAD, &usage) != 0) {
+		return 0;
+	}
+	return static_cast<std::uint64_t>(usage.ru_nvcsw) + static_cast<std::uint64_t>(usage.ru_nivcsw);
+}
+
+} /*namespace bench*/
+} /*namespace tstorage*/
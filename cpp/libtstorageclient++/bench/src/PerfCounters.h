@@ -0,0 +1,92 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_PERFCOUNTERS_BENCH_PH
+#define D_TSTORAGE_PERFCOUNTERS_BENCH_PH
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tstorage {
+namespace bench {
+
+/** @brief The events counted by `PerfCounters`. */
+enum class PerfEvent
+{
+	CYCLES,
+	INSTRUCTIONS,
+	CACHE_MISSES,
+	BRANCH_MISSES,
+	CONTEXT_SWITCHES
+};
+
+/** @brief The amount of `PerfEvent` values. */
+constexpr std::size_t cPerfEvents = 5;
+
+/**
+ * @brief Counts hardware events of the calling thread with
+ * `perf_event_open(2)`, and its context switches.
+ *
+ * Only the thread creating the counters is counted, so the loopback server
+ * threads of the benchmarks are left out. The hardware events include the
+ * kernel side of the syscalls where `perf_event_paranoid` allows it, and only
+ * the user side otherwise. They are scaled up if the kernel multiplexed them.
+ * An event the host does not provide, e.g. in most virtual machines, is
+ * reported as unavailable. The context switches are those of
+ * `getrusage(RUSAGE_THREAD)`, voluntary ones (a receive waiting for data)
+ * and involuntary ones alike, and are always available.
+ */
+class PerfCounters
+{
+public:
+	/** @brief Opens the counters of the calling thread if `enabled`. */
+	explicit PerfCounters(bool enabled);
+	~PerfCounters();
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	/** @brief Resets the counters and starts counting. */
+	void start();
+	/** @brief Stops counting and reads the counters. */
+	void stop();
+
+	/** @brief Returns `true` if the counters were enabled. */
+	bool enabled() const { return mEnabled; }
+	/** @brief Returns `true` if `event` was counted. */
+	bool available(PerfEvent event) const;
+	/** @brief Returns the count of `event` between `start()` and `stop()`. */
+	double value(PerfEvent event) const { return mValues[index(event)]; }
+	/** @brief Returns a short name of `event`, for column headers. */
+	static const char* name(PerfEvent event);
+
+	/** @brief Enables the counters of the benchmarks, e.g. from a command
+	 * line flag. */
+	static void enableGlobally(bool enabled);
+	/** @brief Returns `true` if the counters of the benchmarks are enabled. */
+	static bool enabledGlobally();
+
+private:
+	/** @brief Returns the index of `event` in the arrays. */
+	static std::size_t index(const PerfEvent event) { return static_cast<std::size_t>(event); }
+	/** @brief Returns the context switches of the calling thread so far. */
+	static std::uint64_t contextSwitches();
+
+	/** @brief `true` if the counters were enabled. */
+	bool mEnabled;
+	/** @brief The descriptors of the hardware counters, `-1` if not open. */
+	std::array<int, cPerfEvents> mFds;
+	/** @brief The counts read by `stop()`. */
+	std::array<double, cPerfEvents> mValues;
+	/** @brief The context switches at `start()`. */
+	std::uint64_t mSwitchesAtStart;
+};
+
+} /*namespace bench*/
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * TStorage: Client library benchmarks (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "BenchCommon.h"
+#include "Buffer.h"
+#include "Serializer.h"
+
+namespace tstorage {
+namespace bench {
+namespace {
+
+using impl::Buffer;
+using impl::Serializer;
+
+constexpr std::size_t cBufferSize = 64UL * 1024;
+
+template<typename T>
+void BM_SerializerPut(benchmark::State& state)
+{
+	Buffer buffer(cBufferSize);
+	const std::size_t count = cBufferSize / sizeof(T);
+	T value = 0;
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		buffer.reset();
+		for (std::size_t i = 0; i < count; ++i) {
+			Serializer::put<T>(value++, buffer.writeData());
+			buffer.writeAdvance(sizeof(T));
+		}
+		benchmark::DoNotOptimize(buffer.readData());
+		benchmark::ClobberMemory();
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * count),
+		sizeof(T),
+		counters);
+}
+
+template<typename T>
+void BM_SerializerGet(benchmark::State& state)
+{
+	Buffer buffer(cBufferSize);
+	const std::size_t count = cBufferSize / sizeof(T);
+	for (std::size_t i = 0; i < count; ++i) {
+		Serializer::put<T>(static_cast<T>(i), buffer.writeData());
+		buffer.writeAdvance(sizeof(T));
+	}
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		T sum = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			T value{};
+			Serializer::get<T>(value, buffer.readData(i * sizeof(T)));
+			sum += value;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * count),
+		sizeof(T),
+		counters);
+}
+
+void BM_SerializerPutKey(benchmark::State& state)
+{
+	Buffer buffer(cBufferSize);
+	const std::size_t count = cBufferSize / Serializer::cKeySize;
+	Key key(1, 2, 3, 4, 5);
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		buffer.reset();
+		Serializer serializer(buffer);
+		for (std::size_t i = 0; i < count; ++i) {
+			serializer.putKey(key);
+			++key.cap;
+		}
+		benchmark::DoNotOptimize(buffer.readData());
+		benchmark::ClobberMemory();
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * count),
+		static_cast<std::int64_t>(Serializer::cKeySize),
+		counters);
+}
+
+void BM_SerializerGetKey(benchmark::State& state)
+{
+	Buffer buffer(cBufferSize);
+	const std::size_t count = cBufferSize / Serializer::cKeySize;
+	Serializer writer(buffer);
+	for (std::size_t i = 0; i < count; ++i) {
+		writer.putKey(Key(1, 2, 3, static_cast<Key::CapT>(i), 5));
+	}
+	PerfCounters counters(PerfCounters::enabledGlobally());
+	counters.start();
+	for (auto _ : state) {
+		// Rewind over the keys written above.
+		buffer.reset();
+		buffer.writeAdvance(count * Serializer::cKeySize);
+		Serializer serializer(buffer);
+		Key::CapT sum = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			sum += serializer.getKey().cap;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	setProcessed(state,
+		static_cast<std::int64_t>(state.iterations() * count),
+		static_cast<std::int64_t>(Serializer::cKeySize),
+		counters);
+}
+
+} /*namespace*/
+
+BENCHMARK_TEMPLATE(BM_SerializerPut, std::int32_t);
+BENCHMARK_TEMPLATE(BM_SerializerPut, std::int64_t);
+BENCHMARK_TEMPLATE(BM_SerializerGet, std::int32_t);
+BENCHMARK_TEMPLATE(BM_SerializerGet, std::int64_t);
+BENCHMARK(BM_SerializerPutKey);
+BENCHMARK(BM_SerializerGetKey);
+
+} /*namespace bench*/
+} /*namespace tstorage*/
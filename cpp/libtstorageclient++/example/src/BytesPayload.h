@@ -0,0 +1,48 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_EXAMPLECSV_BYTESPAYLOAD_H
+#define D_TSTORAGE_EXAMPLECSV_BYTESPAYLOAD_H
+
+#include <cstddef>
+#include <cstring>
+
+#include <tstorageclient++/PayloadType.h>
+
+#include "Utils.h"
+
+namespace tstorage {
+namespace exampleCSV {
+
+class BytesPayload : public PayloadType<Bytes64>
+{
+public:
+	std::size_t toBytes(const Bytes64& val,
+		void* const outputBuffer,
+		const std::size_t bufferSize) override
+	{
+		if (bufferSize >= val.max_size()) {
+			std::memcpy(outputBuffer, val.data(), val.max_size());
+		}
+		return val.max_size();
+	}
+
+	bool fromBytes(Bytes64& oVar,
+		const void* const payloadBuffer,
+		const std::size_t payloadSize) override
+	{
+		if (payloadSize != oVar.max_size()) {
+			return false;
+		}
+		std::memcpy(oVar.data(), payloadBuffer, oVar.max_size());
+		return true;
+	}
+};
+
+} /*namespace exampleCSV */
+} /*namespace tstorage*/
+
+#endif
@@ -6,20 +6,64 @@
 
 #include "CommandLineOptions.h"
 
+#include <cstddef>
+#include <cstring>
 #include <string>
+#include <thread>
 
 #include "Log.h"
+#include "Utils.h"
 
 namespace tstorage {
 namespace exampleCSV {
 
-bool CommandLineOptions::parse(const int argc, const char* const* const argv)
+constexpr int CommandLineOptions::cnMandatoryArgs;
+
+std::size_t CommandLineOptions::defaultJobs()
+{
+	const unsigned nCpus = std::thread::hardware_concurrency();
+	return nCpus > 0 ? nCpus : 1;
+}
+
+int CommandLineOptions::parseFlags(const int argc, const char* const* const argv)
+{
+	Log log = mLogInit;
+	int i = 1;
+	while (i + 1 < argc) {
+		std::int64_t value = 0;
+		if (std::strcmp(argv[i], "-j") == 0) {
+			if (!parseInt64(argv[i + 1], value) || value < 1) {
+				log.error() << "Invalid number of jobs (got " << argv[i + 1] << ")";
+				return 0;
+			}
+			mJobs = static_cast<std::size_t>(value);
+		} else if (std::strcmp(argv[i], "-c") == 0) {
+			if (!parseInt64(argv[i + 1], value) || value < 1 || value > 4096) {
+				log.error() << "Invalid chunk size (got " << argv[i + 1] << ")";
+				return 0;
+			}
+			mChunkSize = static_cast<std::size_t>(value) * 1024 * 1024;
+		} else {
+			break;
+		}
+		i += 2;
+	}
+	return i;
+}
+
+bool CommandLineOptions::parse(const int argc, const char* const* argv)
 {
 	Log log = mLogInit;
-	if (argc != cnMandatoryArgs + 1) {
+	const int first = parseFlags(argc, argv);
+	if (first == 0) {
+		return false;
+	}
+	// The positional arguments are indexed as if there were no options.
+	argv += first - 1;
+	if (argc - first != cnMandatoryArgs) {
 		if (argc > 1) {
 			log.error() << "Invalid number of arguments of arguments given (got "
-						<< argc - 1 << ", expected " << cnMandatoryArgs << ")";
+						<< argc - first << ", expected " << cnMandatoryArgs << ")";
 		}
 		return false;
 	}
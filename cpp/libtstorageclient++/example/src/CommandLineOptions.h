@@ -7,6 +7,7 @@
 #ifndef D_TSTORAGE_EXAMPLECSV_COMMANDLINEOPTIONS_H
 #define D_TSTORAGE_EXAMPLECSV_COMMANDLINEOPTIONS_H
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
@@ -24,6 +25,7 @@ class CommandLineOptions
 	static constexpr int cnMandatoryArgs = 13;
 	static constexpr const char* const cDefaultAddr = "localhost";
 	static constexpr std::uint16_t cDefaultPort = 2025;
+	static constexpr std::size_t cDefaultChunkSizeMiB = 16;
 
 public:
 	CommandLineOptions(Log log = Log{})
@@ -31,6 +33,8 @@ public:
 		, mPort(cDefaultPort)
 		, mKeyMin(cKeyMin)
 		, mKeyMax(cKeyMax)
+		, mJobs(defaultJobs())
+		, mChunkSize(cDefaultChunkSizeMiB * 1024 * 1024)
 		, mLogInit(std::move(log))
 	{
 	}
@@ -42,8 +46,15 @@ public:
 	std::uint16_t getPort() const { return mPort; }
 	Key getKeyMin() const { return mKeyMin; }
 	Key getKeyMax() const { return mKeyMax; }
+	std::size_t getJobs() const { return mJobs; }
+	std::size_t getChunkSize() const { return mChunkSize; }
 
 private:
+	static std::size_t defaultJobs();
+	/* Consumes the leading "-j <jobs>" and "-c <MiB>" options, returning the
+	 * index of the first positional argument, or 0 on error. */
+	int parseFlags(int argc, const char* const* argv);
+
 	void parseFile(const std::string& filename) { mCsvFile = filename; }
 	void parseAddr(const std::string& addr) { mAddr = addr; }
 	bool parsePort(const std::string& port) { return parseUInt16(port, mPort); }
@@ -70,6 +81,8 @@ private:
 	std::string mCsvFile;
 	Key mKeyMin;
 	Key mKeyMax;
+	std::size_t mJobs;
+	std::size_t mChunkSize;
 	Log mLogInit;
 };
 
@@ -0,0 +1,235 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "CsvChunkParser.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "CsvRecord.h"
+#include "CsvToRecordParser.h"
+#include "Utils.h"
+
+namespace tstorage {
+namespace exampleCSV {
+
+namespace {
+
+bool isSpace(const char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+unsigned digitValue(const char c)
+{
+	if (c >= '0' && c <= '9') {
+		return static_cast<unsigned>(c - '0');
+	}
+	if (c >= 'a' && c <= 'f') {
+		return static_cast<unsigned>(c - 'a' + 10);
+	}
+	if (c >= 'A' && c <= 'F') {
+		return static_cast<unsigned>(c - 'A' + 10);
+	}
+	return 16;
+}
+
+/* Accepts what parseInt32() and parseInt64() do, barring exotic input. */
+template<typename T>
+bool parseInteger(const char* pos, const char* const end, T& oVal)
+{
+	while (pos < end && isSpace(*pos)) {
+		++pos;
+	}
+	bool negative = false;
+	if (pos < end && (*pos == '-' || *pos == '+')) {
+		negative = *pos == '-';
+		++pos;
+	}
+	unsigned base = 10;
+	if (end - pos >= 2 && pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X')) {
+		base = 16;
+		pos += 2;
+	} else if (pos < end && *pos == '0') {
+		base = 8;
+	}
+
+	const std::uint64_t limit =
+		static_cast<std::uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+	const char* const digits = pos;
+	std::uint64_t value = 0;
+	for (; pos < end; ++pos) {
+		const unsigned digit = digitValue(*pos);
+		if (digit >= base) {
+			break;
+		}
+		if (value > (limit - digit) / base) {
+			return false;
+		}
+		value = value * base + digit;
+	}
+	if (pos == digits) {
+		return false;
+	}
+	while (pos < end && isSpace(*pos)) {
+		++pos;
+	}
+	if (pos != end) {
+		return false;
+	}
+	oVal = negative ? static_cast<T>(-static_cast<std::int64_t>(value - 1) - 1)
+					: static_cast<T>(value);
+	return true;
+}
+
+/* Accepts what parseBytes() does, barring exotic input. */
+bool parsePayload(const char* pos, const char* const end, Bytes64& oVal)
+{
+	while (pos < end && isSpace(*pos)) {
+		++pos;
+	}
+	const char* tokenEnd = pos;
+	while (tokenEnd < end && !isSpace(*tokenEnd)) {
+		++tokenEnd;
+	}
+	for (const char* rest = tokenEnd; rest < end; ++rest) {
+		if (!isSpace(*rest)) {
+			return false;
+		}
+	}
+	if (pos == tokenEnd || (tokenEnd - pos) % 2 != 0) {
+		return false;
+	}
+	if (pos[0] == '0' && pos[1] == 'x') {
+		pos += 2;
+	}
+	const std::size_t bytesAmt = static_cast<std::size_t>(tokenEnd - pos) / 2;
+	if (bytesAmt > oVal.max_size()) {
+		return false;
+	}
+	oVal.fill(0);
+	std::uint8_t* out = oVal.data() + oVal.max_size() - bytesAmt;
+	for (; pos < tokenEnd; pos += 2) {
+		const unsigned high = digitValue(pos[0]);
+		const unsigned low = digitValue(pos[1]);
+		if ((high | low) >= 16) {
+			return false;
+		}
+		*out++ = static_cast<std::uint8_t>(high << 4 | low);
+	}
+	return true;
+}
+
+}  // namespace
+
+std::vector<CsvChunk> splitAtNewlines(
+	const char* const data, const std::size_t size, const std::size_t chunkSize)
+{
+	std::vector<CsvChunk> chunks;
+	const char* const end = data + size;
+	const char* begin = data;
+	while (begin < end) {
+		const char* split = begin + std::min<std::size_t>(std::max<std::size_t>(chunkSize, 1),
+										static_cast<std::size_t>(end - begin));
+		if (split < end) {
+			const void* const newline = std::memchr(split - 1, '\n', end - split + 1);
+			split = newline == nullptr ? end : static_cast<const char*>(newline) + 1;
+		}
+		chunks.push_back(CsvChunk{begin, split});
+		begin = split;
+	}
+	return chunks;
+}
+
+const char* findDelimiter(const char* pos, const char* const end)
+{
+#ifdef __SSE2__
+	const __m128i comma = _mm_set1_epi8(',');
+	const __m128i newline = _mm_set1_epi8('\n');
+	for (; end - pos >= 16; pos += 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+		const int mask = _mm_movemask_epi8(
+			_mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, newline)));
+		if (mask != 0) {
+			return pos + __builtin_ctz(static_cast<unsigned>(mask));
+		}
+	}
+#endif
+	for (; pos < end; ++pos) {
+		if (*pos == ',' || *pos == '\n') {
+			return pos;
+		}
+	}
+	return end;
+}
+
+bool CsvChunkParser::next(Record<Bytes64>& oRecord)
+{
+	if (!hasMore()) {
+		return false;
+	}
+
+	const char* lineEnd = parseInPlace(oRecord);
+	if (lineEnd == nullptr) {
+		const void* const newline = std::memchr(mPos, '\n', mEnd - mPos);
+		lineEnd = newline == nullptr ? mEnd : static_cast<const char*>(newline);
+		std::string error;
+		if (!parseCsvLine(std::string(mPos, lineEnd), oRecord, error)) {
+			std::ostringstream ss;
+			ss << "@ " << std::count(mFileBegin, mPos, '\n') + 1 << " > " << error;
+			mError = ss.str();
+			mOk = false;
+			return false;
+		}
+	}
+	mPos = lineEnd < mEnd ? lineEnd + 1 : mEnd;
+	return true;
+}
+
+const char* CsvChunkParser::parseInPlace(Record<Bytes64>& oRecord) const
+{
+	const char* fieldEnds[CsvRecord::cNumberOfFields];
+	const char* pos = mPos;
+	for (int i = 0; i < CsvRecord::cNumberOfFields; ++i) {
+		const char* const delimiter = findDelimiter(pos, mEnd);
+		const bool last = i == CsvRecord::cNumberOfFields - 1;
+		const bool lineEnds = delimiter == mEnd || *delimiter == '\n';
+		if (last != lineEnds) {
+			return nullptr;
+		}
+		fieldEnds[i] = delimiter;
+		pos = delimiter + 1;
+	}
+
+	const char* const cid = mPos;
+	const char* const mid = fieldEnds[0] + 1;
+	const char* const moid = fieldEnds[1] + 1;
+	const char* const cap = fieldEnds[2] + 1;
+	const char* const payload = fieldEnds[3] + 1;
+	if (!parseInteger(cid, fieldEnds[0], oRecord.key.cid)
+		|| !parseInteger(mid, fieldEnds[1], oRecord.key.mid)
+		|| !parseInteger(moid, fieldEnds[2], oRecord.key.moid)
+		|| !parseInteger(cap, fieldEnds[3], oRecord.key.cap)
+		|| !parsePayload(payload, fieldEnds[4], oRecord.value)) {
+		return nullptr;
+	}
+	return fieldEnds[4];
+}
+
+} /*namespace exampleCSV */
+} /*namespace tstorage*/
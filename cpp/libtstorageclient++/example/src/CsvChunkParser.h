@@ -0,0 +1,72 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_EXAMPLECSV_CSVCHUNKPARSER_H
+#define D_TSTORAGE_EXAMPLECSV_CSVCHUNKPARSER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Utils.h"
+
+namespace tstorage {
+namespace exampleCSV {
+
+struct CsvChunk
+{
+	const char* begin;
+	const char* end;
+};
+
+/* Splits [data, data + size) into chunks of roughly chunkSize bytes, each
+ * ending right after a line break, or at the end of the data. */
+std::vector<CsvChunk> splitAtNewlines(const char* data, std::size_t size, std::size_t chunkSize);
+
+/* Returns the first ',' or '\n' in [pos, end), or end if there is none. Scans
+ * 16 bytes at a time with SSE2 where available. */
+const char* findDelimiter(const char* pos, const char* end);
+
+/* Parses the lines of a chunk of a memory-mapped CSV file, accepting the same
+ * syntax as CsvToRecordsParser. Well-formed lines are parsed in place; the
+ * others go through parseCsvLine(), which also describes what is wrong. */
+class CsvChunkParser
+{
+public:
+	/* fileBegin is the start of the file, for the line numbers in errors. */
+	CsvChunkParser(const char* fileBegin, const CsvChunk& chunk)
+		: mFileBegin(fileBegin), mPos(chunk.begin), mEnd(chunk.end), mOk(true)
+	{
+	}
+
+	/* Returns false at the end of the chunk, and on error. */
+	bool next(Record<Bytes64>& oRecord);
+
+	bool hasMore() const { return mOk && mPos < mEnd; }
+	bool ok() const { return mOk; }
+	operator bool() const { return hasMore(); }
+
+	/* Describes the failure as "@ <line> > <problem>". */
+	const std::string& error() const { return mError; }
+
+private:
+	/* Parses the line at mPos, returning its end, or nullptr if it has to be
+	 * parsed by parseCsvLine(). */
+	const char* parseInPlace(Record<Bytes64>& oRecord) const;
+
+	const char* mFileBegin;
+	const char* mPos;
+	const char* mEnd;
+	bool mOk;
+	std::string mError;
+};
+
+} /*namespace exampleCSV */
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "CsvLoader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/Response.h>
+
+#include "BytesPayload.h"
+#include "CsvChunkParser.h"
+#include "Log.h"
+#include "MappedFile.h"
+#include "Utils.h"
+
+namespace tstorage {
+namespace exampleCSV {
+
+constexpr std::size_t CsvLoader::cDefaultChunkSize;
+constexpr std::size_t CsvLoader::cChannelBufferSize;
+
+bool CsvLoader::load(const MappedFile& file, LoadStats& oStats)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const std::vector<CsvChunk> chunks = splitAtNewlines(file.data(), file.size(), mChunkSize);
+	std::atomic<std::size_t> nextChunk(0);
+	std::atomic<bool> failed(false);
+	std::atomic<std::uint64_t> rows(0);
+	std::atomic<std::uint64_t> bytes(0);
+
+	auto work = [&]() {
+		Channel<Bytes64> channel(
+			mAddr, mPort, std::make_unique<BytesPayload>(), cChannelBufferSize);
+		const Response resConnect = channel.connect();
+		if (resConnect.error()) {
+			std::lock_guard<std::mutex> lock(mLogMutex);
+			mLog.error() << "Connect failed with error code " << (int)resConnect.status();
+			failed = true;
+			return;
+		}
+		for (std::size_t i = nextChunk++; i < chunks.size() && !failed; i = nextChunk++) {
+			CsvChunkParser parser(file.data(), chunks[i]);
+			std::uint64_t parsedRows = 0;
+			const Response resPut =
+				channel.putFrom([&parser, &parsedRows](Record<Bytes64>& oRecord) {
+					if (!parser.next(oRecord)) {
+						return false;
+					}
+					++parsedRows;
+					return true;
+				});
+			if (!parser.ok() || resPut.error()) {
+				std::lock_guard<std::mutex> lock(mLogMutex);
+				if (!parser.ok()) {
+					mLog.error() << parser.error();
+				} else {
+					mLog.error() << "PUT failed with error code " << (int)resPut.status();
+				}
+				failed = true;
+				break;
+			}
+			rows += parsedRows;
+			bytes += static_cast<std::uint64_t>(chunks[i].end - chunks[i].begin);
+		}
+		(void)channel.close();
+	};
+
+	const std::size_t nThreads = std::max<std::size_t>(std::min(mJobs, chunks.size()), 1);
+	std::vector<std::thread> threads;
+	for (std::size_t i = 1; i < nThreads; ++i) {
+		threads.emplace_back(work);
+	}
+	work();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	oStats.rows = rows;
+	oStats.bytes = bytes;
+	oStats.seconds =
+		std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return !failed;
+}
+
+} /*namespace exampleCSV */
+} /*namespace tstorage*/
@@ -0,0 +1,69 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_EXAMPLECSV_CSVLOADER_H
+#define D_TSTORAGE_EXAMPLECSV_CSVLOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "CsvChunkParser.h"
+#include "Log.h"
+#include "MappedFile.h"
+
+namespace tstorage {
+namespace exampleCSV {
+
+struct LoadStats
+{
+	std::uint64_t rows{};
+	std::uint64_t bytes{};
+	double seconds{};
+};
+
+/* Stores the records of a CSV file in parallel: the file is split into chunks
+ * at line breaks, and each of the worker threads parses the chunks it takes
+ * and streams their records with putFrom() over a channel of its own, so the
+ * memory used is bounded by the channel buffers. */
+class CsvLoader
+{
+public:
+	static constexpr std::size_t cDefaultChunkSize = 16UL * 1024 * 1024;  // 16 MiB
+	static constexpr std::size_t cChannelBufferSize = 1024UL * 1024;  // 1 MiB
+
+	CsvLoader(std::string addr,
+		std::uint16_t port,
+		std::size_t jobs,
+		std::size_t chunkSize = cDefaultChunkSize,
+		Log log = Log{})
+		: mAddr(std::move(addr))
+		, mPort(port)
+		, mJobs(jobs)
+		, mChunkSize(chunkSize)
+		, mLog(std::move(log))
+	{
+	}
+
+	/* Stops at the first malformed line or failed PUT, after the records
+	 * preceding it in its chunk have been stored. */
+	bool load(const MappedFile& file, LoadStats& oStats);
+
+private:
+	std::string mAddr;
+	std::uint16_t mPort;
+	std::size_t mJobs;
+	std::size_t mChunkSize;
+	Log mLog;
+	std::mutex mLogMutex;
+};
+
+} /*namespace exampleCSV */
+} /*namespace tstorage*/
+
+#endif
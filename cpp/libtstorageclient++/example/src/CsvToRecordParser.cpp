@@ -8,6 +8,7 @@
 
 #include <cerrno>
 #include <cstring>
+#include <sstream>
 #include <string>
 
 #include <tstorageclient++/DataTypes.h>
@@ -21,66 +22,58 @@ namespace exampleCSV {
 
 using diff_t = std::string::difference_type;
 
-bool CsvToRecordsParser::next(Record<Bytes64>& oRecord)
+bool parseCsvLine(const std::string& line, Record<Bytes64>& oRecord, std::string& oError)
 {
-	if (!hasMore()) {
-		return ok();
-	}
-
-	CsvRecord record = CsvRecord(mFile->readLine());
-
-	if (!ok()) {
-		fail() << "file IO error occurred (" << strerror(errno) << ")";
-		return false;
-	}
+	const CsvRecord record(line);
+	std::ostringstream error;
 
 	const int nFields = record.countFields();
 	if (nFields > CsvRecord::cNumberOfFields) {
-		fail() << "the record has too many fields" << " (" << nFields << ", expected "
-			   << CsvRecord::cNumberOfFields << ")";
-		return false;
-	}
-
-	if (nFields < CsvRecord::cNumberOfFields) {
-		fail() << "the record has not enough fields" << " (" << nFields << ", expected "
-			   << CsvRecord::cNumberOfFields << ")";
-		return false;
-	}
-
-	if (!record.getCid(oRecord.key.cid)) {
-		fail()
-			<< "couldn't parse CID: '" << record.getCidStr()
-			<< "' (expected a decimal, hexadecimal or octal integer of length 32 bits)";
-		return false;
+		error << "the record has too many fields" << " (" << nFields << ", expected "
+			  << CsvRecord::cNumberOfFields << ")";
+	} else if (nFields < CsvRecord::cNumberOfFields) {
+		error << "the record has not enough fields" << " (" << nFields << ", expected "
+			  << CsvRecord::cNumberOfFields << ")";
+	} else if (!record.getCid(oRecord.key.cid)) {
+		error << "couldn't parse CID: '" << record.getCidStr()
+			  << "' (expected a decimal, hexadecimal or octal integer of length 32 bits)";
+	} else if (!record.getMid(oRecord.key.mid)) {
+		error << "couldn't parse MID: '" << record.getMidStr()
+			  << "' (expected a decimal, hexadecimal or octal integer of length 64 bits)";
+	} else if (!record.getMoid(oRecord.key.moid)) {
+		error << "couldn't parse MOID: '" << record.getMoidStr()
+			  << "' (expected a decimal, hexadecimal or octal integer of length 32 bits)";
+	} else if (!record.getCap(oRecord.key.cap)) {
+		error << "couldn't parse CAP: '" << record.getCapStr()
+			  << "' (expected a decimal, hexadecimal or octal integer of length 64 bits)";
+	} else if (!record.getPayload(oRecord.value)) {
+		error << "couldn't parse payload: '" << record.getPayloadStr()
+			  << "' (expected a hexadecimal number of length at most 64 bytes)";
+	} else {
+		return true;
 	}
+	oError = error.str();
+	return false;
+}
 
-	if (!record.getMid(oRecord.key.mid)) {
-		fail()
-			<< "couldn't parse MID: '" << record.getMidStr()
-			<< "' (expected a decimal, hexadecimal or octal integer of length 64 bits)";
-		return false;
+bool CsvToRecordsParser::next(Record<Bytes64>& oRecord)
+{
+	if (!hasMore()) {
+		return ok();
 	}
 
-	if (!record.getMoid(oRecord.key.moid)) {
-		fail()
-			<< "couldn't parse MOID: '" << record.getMoidStr()
-			<< "' (expected a decimal, hexadecimal or octal integer of length 32 bits)";
-		return false;
-	}
+	const std::string line = mFile->readLine();
 
-	if (!record.getCap(oRecord.key.cap)) {
-		fail()
-			<< "couldn't parse CAP: '" << record.getCapStr()
-			<< "' (expected a decimal, hexadecimal or octal integer of length 64 bits)";
+	if (!ok()) {
+		fail() << "file IO error occurred (" << strerror(errno) << ")";
 		return false;
 	}
 
-	if (!record.getPayload(oRecord.value)) {
-		fail() << "couldn't parse payload: '" << record.getPayloadStr()
-			   << "' (expected a hexadecimal number of length at most 64 bytes)";
+	std::string error;
+	if (!parseCsvLine(line, oRecord, error)) {
+		fail() << error;
 		return false;
 	}
-
 	return true;
 }
 
@@ -7,6 +7,7 @@
 #ifndef D_TSTORAGE_EXAMPLECSV_CSVTORECORDPARSER_H
 #define D_TSTORAGE_EXAMPLECSV_CSVTORECORDPARSER_H
 
+#include <string>
 #include <utility>
 
 #include <tstorageclient++/DataTypes.h>
@@ -18,6 +19,10 @@
 namespace tstorage {
 namespace exampleCSV {
 
+/* Parses a single CSV line, without the line break, into oRecord. On failure,
+ * oError describes the problem. */
+bool parseCsvLine(const std::string& line, Record<Bytes64>& oRecord, std::string& oError);
+
 class CsvToRecordsParser
 {
 public:
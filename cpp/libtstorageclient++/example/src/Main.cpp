@@ -4,7 +4,6 @@
  * Copyright 2025 Atende Industries
  */
 
-#include <cstddef>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -12,16 +11,16 @@
 
 #include <tstorageclient++/Channel.h>
 #include <tstorageclient++/DataTypes.h>
-#include <tstorageclient++/PayloadType.h>
 #include <tstorageclient++/RecordsSet.h>
 #include <tstorageclient++/Response.h>
 #include <tstorageclient++/ResponseAcq.h>
 #include <tstorageclient++/Timestamp.h>
 
+#include "BytesPayload.h"
 #include "CommandLineOptions.h"
-#include "CsvToRecordParser.h"
-#include "File.h"
+#include "CsvLoader.h"
 #include "Log.h"
+#include "MappedFile.h"
 #include "Utils.h"
 
 using namespace tstorage;
@@ -32,8 +31,8 @@ void printHelp()
 	using std::cout;
 	using std::endl;
 
-	cout << "Usage: tstorageclient-upload-csv <addr> <port> <cidMin>\n"
-			"<midMin> <moidMin> <capMin> <acqMin> <cidMax> <midMax>\n"
+	cout << "Usage: tstorageclient-upload-csv [-j <jobs>] [-c <chunkMiB>] <addr> <port>\n"
+			"<cidMin> <midMin> <moidMin> <capMin> <acqMin> <cidMax> <midMax>\n"
 			"<moidMax> <capMax> <acqMax> <csvFile>\n"
 		 << endl;
 
@@ -41,34 +40,13 @@ void printHelp()
 			"instance at <addr>:<port>, then performs a GET operation to obtain all\n"
 			"records in the right-open key-interval [ <*Min>, <*Max> ) and display\n"
 			"them on the standard output in the CSV format.\n"
+			"\n"
+			"The file is split into chunks of <chunkMiB> MiB (default: 16), which\n"
+			"<jobs> threads (default: one per CPU) parse and send in parallel, each\n"
+			"over a connection of its own.\n"
 		 << endl;
 }
 
-class BytesPayload : public PayloadType<Bytes64>
-{
-public:
-	std::size_t toBytes(const Bytes64& val,
-		void* const outputBuffer,
-		const std::size_t bufferSize) override
-	{
-		if (bufferSize >= val.max_size()) {
-			std::memcpy(outputBuffer, val.data(), val.max_size());
-		}
-		return val.max_size();
-	}
-
-	bool fromBytes(Bytes64& oVar,
-		const void* const payloadBuffer,
-		const std::size_t payloadSize) override
-	{
-		if (payloadSize != oVar.max_size()) {
-			return false;
-		}
-		std::memcpy(oVar.data(), payloadBuffer, oVar.max_size());
-		return true;
-	}
-};
-
 int main(int argc, char* argv[])
 {
 	Log loggerOpts("while parsing command line options:");
@@ -79,22 +57,29 @@ int main(int argc, char* argv[])
 		return -1;
 	}
 
-	File file(opts.getRecordFilePath());
+	MappedFile file(opts.getRecordFilePath());
 	if (file.error()) {
-		Log{}.error() << "file '" << file.name() << "' does not exist";
+		Log{}.error() << "cannot read file '" << file.name() << "' ("
+					  << std::strerror(file.errorCode()) << ")";
 		return -1;
 	}
 
-	RecordsSet<Bytes64> recordsSet{};
-	Record<Bytes64> record{};
-	CsvToRecordsParser parser(file, Log(std::string("in '" + file.name() + "':")));
-	while (parser) {
-		if (!parser.next(record)) {
-			return -1;
-		}
-		recordsSet.append(record);
-	}
+	LoadStats stats;
+	CsvLoader loader(opts.getAddr(),
+		opts.getPort(),
+		opts.getJobs(),
+		opts.getChunkSize(),
+		Log(std::string("in '" + file.name() + "':")));
+	const bool loaded = loader.load(file, stats);
 	file.close();
+	if (!loaded) {
+		return -1;
+	}
+	const double megabytes = static_cast<double>(stats.bytes) / 1e6;
+	const double seconds = stats.seconds > 0 ? stats.seconds : 1e-9;
+	Log{} << "loaded " << stats.rows << " rows (" << megabytes << " MB) in " << stats.seconds
+		  << " s: " << static_cast<double>(stats.rows) / seconds << " rows/s, "
+		  << megabytes / seconds << " MB/s";
 
 	Channel<Bytes64> channel(
 		opts.getAddr(), opts.getPort(), std::make_unique<BytesPayload>());
@@ -104,11 +89,6 @@ int main(int argc, char* argv[])
 		Log{}.error() << "Connect failed with error code " << (int)resConnect.status();
 		return -1;
 	}
-	Response resPut = channel.put(recordsSet);
-	if (resConnect.error()) {
-		Log{}.error() << "PUT failed with error code " << (int)resPut.status();
-		return -1;
-	}
 
 	ResponseAcq resGet = channel.getStream(
 		opts.getKeyMin(), opts.getKeyMax(), [](const RecordsSet<Bytes64>& batch) {
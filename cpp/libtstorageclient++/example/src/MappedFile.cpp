@@ -0,0 +1,66 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tstorage {
+namespace exampleCSV {
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+	mFileName = path;
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		mError = errno;
+		return false;
+	}
+	struct stat st{};
+	if (::fstat(fd, &st) != 0) {
+		mError = errno;
+		(void)::close(fd);
+		return false;
+	}
+	mSize = static_cast<std::size_t>(st.st_size);
+	if (mSize > 0) {
+		void* const data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED) {
+			mError = errno;
+			mSize = 0;
+			(void)::close(fd);
+			return false;
+		}
+		// The chunks are read front to back, hence an aggressive readahead.
+		(void)::madvise(data, mSize, MADV_SEQUENTIAL);
+		mData = static_cast<const char*>(data);
+	}
+	// The mapping outlives the descriptor.
+	(void)::close(fd);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData != nullptr) {
+		(void)::munmap(const_cast<char*>(mData), mSize);
+	}
+	mData = nullptr;
+	mSize = 0;
+	mError = 0;
+	mFileName = "";
+}
+
+} /*namespace exampleCSV */
+} /*namespace tstorage*/
@@ -0,0 +1,51 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_EXAMPLECSV_MAPPEDFILE_H
+#define D_TSTORAGE_EXAMPLECSV_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace tstorage {
+namespace exampleCSV {
+
+/* A read-only memory mapping of a whole file, so that its parts can be parsed
+ * in parallel without copying them out of the page cache. */
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string& path) : MappedFile() { open(path); }
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile(MappedFile&&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile& operator=(MappedFile&&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	const char* data() const { return mData; }
+	std::size_t size() const { return mSize; }
+	std::string name() const { return mFileName; }
+
+	bool error() const { return mError != 0; }
+	/* The errno value of the failed open(). */
+	int errorCode() const { return mError; }
+
+private:
+	const char* mData{};
+	std::size_t mSize{};
+	std::string mFileName;
+	int mError{};
+};
+
+} /*namespace exampleCSV */
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * TStorage: example client (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "../CsvChunkParser.h"
+#include "../CsvToRecordParser.h"
+#include "../Utils.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tstorage;
+using namespace tstorage::exampleCSV;
+
+namespace {
+
+std::vector<Record<Bytes64>> parseAll(const std::string& csv, std::string& oError)
+{
+	std::vector<Record<Bytes64>> records;
+	const CsvChunk chunk{csv.data(), csv.data() + csv.size()};
+	CsvChunkParser parser(csv.data(), chunk);
+	Record<Bytes64> record{};
+	while (parser.next(record)) {
+		records.push_back(record);
+	}
+	oError = parser.error();
+	return records;
+}
+
+} /*namespace*/
+
+TEST_CASE("CsvChunkParser: split at newlines", "[parser]")
+{
+	const std::string csv = "1,2,3,4,aa\n10,20,30,40,bb\n100,200,300,400,cc";
+	for (std::size_t chunkSize = 1; chunkSize <= csv.size() + 1; ++chunkSize) {
+		const std::vector<CsvChunk> chunks =
+			splitAtNewlines(csv.data(), csv.size(), chunkSize);
+		REQUIRE(!chunks.empty());
+		REQUIRE(chunks.front().begin == csv.data());
+		REQUIRE(chunks.back().end == csv.data() + csv.size());
+		for (std::size_t i = 0; i + 1 < chunks.size(); ++i) {
+			REQUIRE(chunks[i].end == chunks[i + 1].begin);
+			REQUIRE(chunks[i].end[-1] == '\n');
+		}
+	}
+	REQUIRE(splitAtNewlines(csv.data(), 0, 16).empty());
+	REQUIRE(splitAtNewlines(csv.data(), csv.size(), 1).size() == 3);
+}
+
+TEST_CASE("CsvChunkParser: find delimiter", "[parser]")
+{
+	for (std::size_t length = 0; length < 40; ++length) {
+		for (std::size_t at = 0; at <= length; ++at) {
+			std::string str(length, 'x');
+			if (at < length) {
+				str[at] = (at % 2 == 0) ? ',' : '\n';
+			}
+			REQUIRE(findDelimiter(str.data(), str.data() + str.size()) == str.data() + at);
+		}
+	}
+}
+
+TEST_CASE("CsvChunkParser: same records as parseCsvLine", "[parser]")
+{
+	const std::vector<std::string> lines{
+		"0,1,2,3,00",
+		"-2147483648,-9223372036854775808,2147483647,9223372036854775807,ff",
+		"0x10,010,-0x7f, +5 ,0x0102",
+		" 7\t, 8 ,9\t,10,  abcdef  \r",
+		"1,2,3,4," + std::string(128, 'e'),
+		"1,2,3,4,0x",
+		"1,2,3,4,AbCd",
+	};
+	std::string csv;
+	for (const std::string& line : lines) {
+		csv += line + "\n";
+	}
+
+	std::string error;
+	const std::vector<Record<Bytes64>> records = parseAll(csv, error);
+	INFO("Msg: \"" << error << "\"");
+	REQUIRE(error.empty());
+	REQUIRE(records.size() == lines.size());
+	for (std::size_t i = 0; i < lines.size(); ++i) {
+		Record<Bytes64> expected{};
+		std::string lineError;
+		INFO("Line: " << lines[i]);
+		REQUIRE(parseCsvLine(lines[i], expected, lineError));
+		REQUIRE(records[i].key == expected.key);
+		REQUIRE(records[i].value == expected.value);
+	}
+
+	// The last line need not end with a line break.
+	csv.pop_back();
+	REQUIRE(parseAll(csv, error).size() == lines.size());
+}
+
+TEST_CASE("CsvChunkParser: invalid CSV", "[parser]")
+{
+	const std::vector<std::string> invalid{
+		"",
+		"0,1,2,3",
+		"0,1,2,3,4,5",
+		"2147483648,1,2,3,00",
+		"0,1,2,3 5,00",
+		"0,1,2,08,00",
+		"0,1,2,3,abc",
+		"0,1,2,3,zz",
+		"0,1,2,3," + std::string(130, 'e'),
+	};
+	for (const std::string& line : invalid) {
+		const std::string csv = "1,2,3,4,aa\n5,6,7,8,bb\n" + line + "\n9,10,11,12,cc\n";
+		std::string error;
+		INFO("Line: " << line);
+		REQUIRE(parseAll(csv, error).size() == 2);
+		INFO("Msg: \"" << error << "\"");
+		REQUIRE(error.find("@ 3 > ") == 0);
+	}
+}
@@ -0,0 +1,299 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * Arena.h
+ *   A monotonic arena and an allocator drawing memory from it.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_ARENA_H
+#define D_TSTORAGE_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "DataTypes.h"
+#include "RecordsSet.h"
+
+/** @file
+ * @brief Defines `MonotonicArena` and the `ArenaAllocator<U>` drawing memory
+ * from it. */
+
+namespace tstorage {
+
+/**
+ * @brief A region of memory handed out like a stack and released all at once.
+ *
+ * Allocations bump a pointer inside large blocks obtained from the global
+ * `operator new`, and deallocations do nothing: the blocks are freed when the
+ * arena is destroyed, or rewound for reuse by `reset()`. That makes allocating
+ * the many small objects of a GET response, e.g. the records of a
+ * `RecordsSet` and their string payloads, a matter of a few instructions, and
+ * releasing them a matter of freeing a couple of blocks.
+ *
+ * The arena is not thread-safe. It is used through `ArenaAllocator<U>`, which
+ * shares the ownership of the arena, so that it lives as long as any container
+ * or value allocated from it.
+ */
+class MonotonicArena final
+{
+public:
+	/** @brief The default size of the first block. */
+	static constexpr std::size_t cDefaultBlockSize = 64 * 1024;
+	/** @brief The size the blocks stop growing at. */
+	static constexpr std::size_t cMaxBlockSize = 4 * 1024 * 1024;
+
+	/**
+	 * @brief A constructor. No memory is allocated until the first request.
+	 *
+	 * @param blockSize The size of the first block. Each next one is twice as
+	 * large, up to `cMaxBlockSize`.
+	 */
+	explicit MonotonicArena(std::size_t blockSize = cDefaultBlockSize)
+		: mNextBlockSize(std::max<std::size_t>(blockSize, 64))
+		, mBlock(0)
+		, mOffset(0)
+	{
+	}
+	/** @brief Frees all blocks. */
+	~MonotonicArena()
+	{
+		for (const Block& block : mBlocks) {
+			::operator delete(block.data);
+		}
+	}
+
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena(MonotonicArena&&) = delete;
+	MonotonicArena& operator=(const MonotonicArena&) = delete;
+	MonotonicArena& operator=(MonotonicArena&&) = delete;
+
+	/**
+	 * @brief Allocates `size` bytes aligned to `alignment`.
+	 *
+	 * @param size The amount of bytes.
+	 * @param alignment A power of two.
+	 * @return The allocated memory. Throws `std::bad_alloc` if the system is out
+	 * of memory, like `operator new`.
+	 */
+	void* allocate(std::size_t size, std::size_t alignment)
+	{
+		while (mBlock < mBlocks.size()) {
+			const Block& block = mBlocks[mBlock];
+			const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data);
+			const std::size_t begin
+				= ((base + mOffset + alignment - 1) & ~(alignment - 1)) - base;
+			if (begin <= block.size && size <= block.size - begin) {
+				mOffset = begin + size;
+				return block.data + begin;
+			}
+			++mBlock;
+			mOffset = 0;
+		}
+		const std::size_t blockSize = std::max(mNextBlockSize, size + alignment);
+		mNextBlockSize
+			= mNextBlockSize < cMaxBlockSize / 2 ? mNextBlockSize * 2 : cMaxBlockSize;
+		mBlocks.push_back(Block{static_cast<char*>(::operator new(blockSize)), blockSize});
+		mBlock = mBlocks.size() - 1;
+		return allocate(size, alignment);
+	}
+	/**
+	 * @brief Rewinds the arena, so that the memory of its blocks is handed out
+	 * again. Nothing allocated from the arena may be used afterwards.
+	 */
+	void reset()
+	{
+		mBlock = 0;
+		mOffset = 0;
+	}
+	/** @brief Returns the total size of the blocks held by the arena. */
+	std::size_t capacity() const
+	{
+		std::size_t total = 0;
+		for (const Block& block : mBlocks) {
+			total += block.size;
+		}
+		return total;
+	}
+
+private:
+	/** @brief A block of memory obtained from `operator new`. */
+	struct Block
+	{
+		/** @brief The first byte of the block. */
+		char* data;
+		/** @brief The size of the block. */
+		std::size_t size;
+	};
+
+	/** @brief The blocks in the order of allocation. */
+	std::vector<Block> mBlocks;
+	/** @brief The size of the next block to allocate. */
+	std::size_t mNextBlockSize;
+	/** @brief The index of the block allocations are made from. */
+	std::size_t mBlock;
+	/** @brief The offset of the free memory inside `mBlocks[mBlock]`. */
+	std::size_t mOffset;
+};
+
+/**
+ * @brief Selects the arena of default-constructed `ArenaAllocator`s in the
+ * current thread for the lifetime of the object.
+ *
+ * The channel opens a scope with the arena of the target `RecordsSet` while
+ * deserializing a GET response, so that payload values which allocate with an
+ * `ArenaAllocator` of their own, like `ArenaString`, draw from the same arena
+ * as the records holding them (see `Channel<T>::get()`). Scopes nest; an empty
+ * scope selects the global heap.
+ */
+class ArenaScope final
+{
+public:
+	/** @brief Selects `arena` until the scope is closed. */
+	explicit ArenaScope(std::shared_ptr<MonotonicArena> arena)
+		: mPrevious(std::move(current()))
+	{
+		current() = std::move(arena);
+	}
+	/** @brief Restores the previously selected arena. */
+	~ArenaScope() { current() = std::move(mPrevious); }
+
+	ArenaScope(const ArenaScope&) = delete;
+	ArenaScope& operator=(const ArenaScope&) = delete;
+
+	/** @brief Returns the arena selected in the current thread, if any. */
+	static std::shared_ptr<MonotonicArena>& current()
+	{
+		thread_local std::shared_ptr<MonotonicArena> arena;
+		return arena;
+	}
+
+private:
+	/** @brief The arena selected by the enclosing scope. */
+	std::shared_ptr<MonotonicArena> mPrevious;
+};
+
+/**
+ * @brief A standard allocator drawing memory from a shared `MonotonicArena`.
+ *
+ * Every copy of the allocator, including those kept by the containers and
+ * values using it, owns a share of the arena, so the arena is freed together
+ * with the last of them. For instance, the arena of a
+ * `ResponseGet<T, ArenaAllocator<Record<T>>>` lives exactly as long as the
+ * response and the records moved out of it.
+ *
+ * A default-constructed allocator uses the arena selected by the innermost
+ * `ArenaScope` of the current thread, or the global heap if there is none.
+ *
+ * @tparam U The type of allocated objects.
+ */
+template<typename U>
+class ArenaAllocator
+{
+public:
+	/** @brief The type of allocated objects. */
+	using value_type = U;
+	/** @brief Copy-assigned containers adopt the source's arena. */
+	using propagate_on_container_copy_assignment = std::true_type;
+	/** @brief Move-assigned containers adopt the source's arena. */
+	using propagate_on_container_move_assignment = std::true_type;
+	/** @brief Swapped containers exchange their arenas. */
+	using propagate_on_container_swap = std::true_type;
+
+	/** @brief A constructor using the arena of the current `ArenaScope`. */
+	ArenaAllocator() noexcept
+		: mArena(ArenaScope::current())
+	{
+	}
+	/** @brief A constructor using `arena`, or the global heap if empty. */
+	explicit ArenaAllocator(std::shared_ptr<MonotonicArena> arena) noexcept
+		: mArena(std::move(arena))
+	{
+	}
+	/** @brief A converting constructor sharing the arena of `other`. */
+	template<typename V>
+	ArenaAllocator(const ArenaAllocator<V>& other) noexcept
+		: mArena(other.arena())
+	{
+	}
+
+	/** @brief Allocates memory for `count` objects. */
+	U* allocate(std::size_t count)
+	{
+		if (!mArena) {
+			return static_cast<U*>(::operator new(count * sizeof(U)));
+		}
+		return static_cast<U*>(mArena->allocate(count * sizeof(U), alignof(U)));
+	}
+	/** @brief Deallocates the memory of `allocate()`, a no-op for an arena. */
+	void deallocate(U* const pointer, std::size_t /*count*/) noexcept
+	{
+		if (!mArena) {
+			::operator delete(pointer);
+		}
+	}
+
+	/** @brief Returns the arena, empty for the global heap. */
+	const std::shared_ptr<MonotonicArena>& arena() const noexcept { return mArena; }
+
+private:
+	/** @brief The arena the memory is drawn from. */
+	std::shared_ptr<MonotonicArena> mArena;
+};
+
+/** @brief Allocators are equal if they draw memory from the same arena. */
+template<typename U, typename V>
+bool operator==(const ArenaAllocator<U>& lhs, const ArenaAllocator<V>& rhs) noexcept
+{
+	return lhs.arena() == rhs.arena();
+}
+
+/** @brief Allocators are equal if they draw memory from the same arena. */
+template<typename U, typename V>
+bool operator!=(const ArenaAllocator<U>& lhs, const ArenaAllocator<V>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+/** @brief A `RecordsSet<T>` drawing its memory from an arena. */
+template<typename T>
+using ArenaRecordsSet = RecordsSet<T, ArenaAllocator<Record<T>>>;
+
+/** @brief A string payload drawing its memory from an arena. */
+using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+/**
+ * @brief Returns an allocator drawing from a new arena.
+ *
+ * @tparam U The type of allocated objects.
+ * @param blockSize The size of the arena's first block.
+ */
+template<typename U>
+ArenaAllocator<U> makeArenaAllocator(std::size_t blockSize = MonotonicArena::cDefaultBlockSize)
+{
+	return ArenaAllocator<U>(std::make_shared<MonotonicArena>(blockSize));
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ArrowRecordBatch.h
+ *   Conversion of records sets to Apache Arrow record batches.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_ARROWRECORDBATCH_H
+#define D_TSTORAGE_ARROWRECORDBATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <arrow/api.h>
+
+#include "ArrowRecordsSet.h"
+#include "Channel.h"
+#include "DataTypes.h"
+#include "ResponseAcq.h"
+
+/** @file
+ * @brief Defines the conversion of `ArrowRecordsSet` into Apache Arrow record
+ * batches.
+ *
+ * The only header of the library which depends on Apache Arrow. It is
+ * header-only, so the library itself is built without Arrow, and programs
+ * including it link against `libarrow` on their own. */
+
+namespace tstorage {
+
+/**
+ * @brief Returns the schema of the record batches made by `toRecordBatch()`.
+ *
+ * The non-nullable columns are `cid` (`int32`), `mid` (`int64`), `moid`
+ * (`int32`), `cap` (`int64`), `acq` (`int64`) and `payload`, which is
+ * `large_binary` or `fixed_size_binary`. The timestamps are TStorage
+ * timestamps (see `Timestamp.h`).
+ *
+ * @param fixedPayloadSize The size of all payloads, 0 for any size.
+ */
+inline std::shared_ptr<arrow::Schema> arrowSchema(const std::size_t fixedPayloadSize = 0)
+{
+	return arrow::schema({
+		arrow::field("cid", arrow::int32(), false),
+		arrow::field("mid", arrow::int64(), false),
+		arrow::field("moid", arrow::int32(), false),
+		arrow::field("cap", arrow::int64(), false),
+		arrow::field("acq", arrow::int64(), false),
+		arrow::field("payload",
+			fixedPayloadSize == 0
+				? arrow::large_binary()
+				: arrow::fixed_size_binary(static_cast<std::int32_t>(fixedPayloadSize)),
+			false),
+	});
+}
+
+/**
+ * @brief Moves the records of a set into an Arrow record batch.
+ *
+ * The columns of `records` become the buffers of the arrays as they are,
+ * without a copy. `records` is left empty, and allocates its columns anew
+ * as it is refilled.
+ *
+ * @param[in, out] records The records to move.
+ * @param schema The schema of the batch, as returned by `arrowSchema()` for
+ * the fixed payload size of `records`, or null to make one.
+ * @return The record batch.
+ */
+inline std::shared_ptr<arrow::RecordBatch> toRecordBatch(
+	ArrowRecordsSet& records, std::shared_ptr<arrow::Schema> schema = nullptr)
+{
+	if (!schema) {
+		schema = arrowSchema(records.fixedPayloadSize());
+	}
+	const std::int64_t length = static_cast<std::int64_t>(records.size());
+	const auto column = [&schema, length](
+							const int i, std::shared_ptr<arrow::Buffer> values) {
+		return arrow::MakeArray(arrow::ArrayData::Make(
+			schema->field(i)->type(), length, {nullptr, std::move(values)}, 0));
+	};
+
+	std::shared_ptr<arrow::Array> payloads;
+	if (records.fixedPayloadSize() == 0) {
+		payloads = arrow::MakeArray(arrow::ArrayData::Make(schema->field(5)->type(),
+			length,
+			{nullptr,
+				arrow::Buffer::FromVector(std::move(records.offsets())),
+				arrow::Buffer::FromVector(std::move(records.data()))},
+			0));
+	} else {
+		payloads = column(5, arrow::Buffer::FromVector(std::move(records.data())));
+	}
+	std::shared_ptr<arrow::RecordBatch> batch = arrow::RecordBatch::Make(schema,
+		length,
+		{
+			column(0, arrow::Buffer::FromVector(std::move(records.cids()))),
+			column(1, arrow::Buffer::FromVector(std::move(records.mids()))),
+			column(2, arrow::Buffer::FromVector(std::move(records.moids()))),
+			column(3, arrow::Buffer::FromVector(std::move(records.caps()))),
+			column(4, arrow::Buffer::FromVector(std::move(records.acqs()))),
+			std::move(payloads),
+		});
+	records.clear();
+	return batch;
+}
+
+/**
+ * @brief Batch-streams a set of records from a TStorage instance through
+ * a callback function, as Arrow record batches.
+ *
+ * Acts exactly like `Channel<T>::getStreamArrow()`, except each non-empty
+ * batch is moved into an `arrow::RecordBatch` with the schema returned by
+ * `arrowSchema()`, ready for Arrow compute functions or a Parquet writer.
+ *
+ * @see Channel<T>::getStreamArrow()
+ *
+ * @param channel A connected channel.
+ * @param keyMin The lower vertex of the right-open key-interval containing
+ * the desired data.
+ * @param keyMax The upper vertex of the right-open key-interval containing
+ * the desired data.
+ * @param callback A callable that will be called on each record batch
+ * forming the response.
+ * @param fixedPayloadSize The size of all payloads, 0 for any size.
+ * @return The response of `Channel<T>::getStreamArrow()`.
+ */
+template<typename T>
+ResponseAcq getStreamRecordBatches(Channel<T>& channel,
+	const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(const std::shared_ptr<arrow::RecordBatch>&)>& callback,
+	const std::size_t fixedPayloadSize = 0)
+{
+	const std::shared_ptr<arrow::Schema> schema = arrowSchema(fixedPayloadSize);
+	return channel.getStreamArrow(
+		keyMin,
+		keyMax,
+		[&callback, &schema](ArrowRecordsSet& records) {
+			if (records.size() != 0) {
+				callback(toRecordBatch(records, schema));
+			}
+		},
+		fixedPayloadSize);
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ArrowRecordsSet.h
+ *   A container of records laid out as Apache Arrow columns.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_ARROWRECORDSSET_H
+#define D_TSTORAGE_ARROWRECORDSSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines a records container with the memory layout of Apache Arrow
+ * arrays. */
+
+namespace tstorage {
+
+/**
+ * @brief A container for inbound records with raw payloads, kept in the
+ * memory layout of Apache Arrow arrays.
+ *
+ * Like `ColumnarRecordsSet<T>`, the set keeps each key field in a contiguous
+ * column, which already is the layout of an Arrow `int32` or `int64` array.
+ * The raw payloads are laid out as an Arrow `large_binary` array, i.e. copied
+ * back-to-back into a data column with a column of `size() + 1` offsets, or,
+ * when the set is constructed with a fixed payload size, as a
+ * `fixed_size_binary` array without offsets. No column has nulls.
+ *
+ * The set itself does not depend on Arrow. `<tstorageclient++/ArrowRecordBatch.h>`
+ * turns it into an `arrow::RecordBatch` by moving the columns into Arrow
+ * buffers, without copying them.
+ *
+ * A copyable and moveable container. It can be filled directly by
+ * `Channel<T>::getStreamArrow()`, which never calls
+ * `PayloadType<T>::fromBytes()`.
+ */
+class ArrowRecordsSet final
+{
+public:
+	/**
+	 * @brief Constructs an empty set.
+	 * @param fixedPayloadSize The size all payloads are required to have, or
+	 * 0 for payloads of any size.
+	 */
+	explicit ArrowRecordsSet(const std::size_t fixedPayloadSize = 0)
+		: mFixedPayloadSize(fixedPayloadSize)
+	{
+		mOffsets.push_back(0);
+	}
+
+	/**
+	 * @brief Appends a record to the end of the container, copying its
+	 * payload into the data column.
+	 *
+	 * @param key Key of the new record.
+	 * @param payload The payload bytes.
+	 * @param size The size of the payload.
+	 * @return `false` if the set has a fixed payload size other than `size`,
+	 * in which case the record is not appended, `true` otherwise.
+	 */
+	bool append(const Key& key, const void* const payload, const std::size_t size)
+	{
+		if (mFixedPayloadSize != 0 && size != mFixedPayloadSize) {
+			return false;
+		}
+		const unsigned char* const bytes = static_cast<const unsigned char*>(payload);
+		mCids.push_back(key.cid);
+		mMids.push_back(key.mid);
+		mMoids.push_back(key.moid);
+		mCaps.push_back(key.cap);
+		mAcqs.push_back(key.acq);
+		mData.insert(mData.end(), bytes, bytes + size);
+		if (mFixedPayloadSize == 0) {
+			mOffsets.push_back(static_cast<std::int64_t>(mData.size()));
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Returns the number of records currently stored in the container.
+	 */
+	std::size_t size() const { return mCids.size(); }
+
+	/**
+	 * @brief Reserves space in all columns for at least `count` records, and
+	 * in the data column for `count` payloads of the fixed size, if any.
+	 * @param count The number of records to make room for.
+	 */
+	void reserve(const std::size_t count)
+	{
+		mCids.reserve(count);
+		mMids.reserve(count);
+		mMoids.reserve(count);
+		mCaps.reserve(count);
+		mAcqs.reserve(count);
+		if (mFixedPayloadSize == 0) {
+			mOffsets.reserve(count + 1);
+		} else {
+			mData.reserve(count * mFixedPayloadSize);
+		}
+	}
+
+	/**
+	 * @brief Removes all records from the container. The allocated memory is
+	 * retained for reuse, unless the columns have been moved out.
+	 */
+	void clear()
+	{
+		mCids.clear();
+		mMids.clear();
+		mMoids.clear();
+		mCaps.clear();
+		mAcqs.clear();
+		mOffsets.assign(1, 0);
+		mData.clear();
+	}
+
+	/**
+	 * @brief Returns the size all payloads are required to have, 0 if
+	 * they may have any size.
+	 */
+	std::size_t fixedPayloadSize() const { return mFixedPayloadSize; }
+
+	/** @brief Returns the column of CIDs. */
+	const std::vector<Key::CidT>& cids() const { return mCids; }
+	/** @brief Returns the column of MIDs. */
+	const std::vector<Key::MidT>& mids() const { return mMids; }
+	/** @brief Returns the column of MOIDs. */
+	const std::vector<Key::MoidT>& moids() const { return mMoids; }
+	/** @brief Returns the column of CAP timestamps. */
+	const std::vector<Key::CapT>& caps() const { return mCaps; }
+	/** @brief Returns the column of ACQ timestamps. */
+	const std::vector<Key::AcqT>& acqs() const { return mAcqs; }
+	/**
+	 * @brief Returns the column of payload offsets: the payload of the `i`-th
+	 * record spans `[ offsets()[i], offsets()[i + 1] )` of `data()`. Holds
+	 * just the leading 0 for a fixed payload size.
+	 */
+	const std::vector<std::int64_t>& offsets() const { return mOffsets; }
+	/** @brief Returns the column of payload bytes. */
+	const std::vector<std::uint8_t>& data() const { return mData; }
+
+	/** @brief Returns the mutable column of CIDs. */
+	std::vector<Key::CidT>& cids() { return mCids; }
+	/** @brief Returns the mutable column of MIDs. */
+	std::vector<Key::MidT>& mids() { return mMids; }
+	/** @brief Returns the mutable column of MOIDs. */
+	std::vector<Key::MoidT>& moids() { return mMoids; }
+	/** @brief Returns the mutable column of CAP timestamps. */
+	std::vector<Key::CapT>& caps() { return mCaps; }
+	/** @brief Returns the mutable column of ACQ timestamps. */
+	std::vector<Key::AcqT>& acqs() { return mAcqs; }
+	/** @brief Returns the mutable column of payload offsets. */
+	std::vector<std::int64_t>& offsets() { return mOffsets; }
+	/** @brief Returns the mutable column of payload bytes. */
+	std::vector<std::uint8_t>& data() { return mData; }
+
+private:
+	/** @brief The size of all payloads, 0 for any size. */
+	std::size_t mFixedPayloadSize;
+	/** @brief The column of CIDs. */
+	std::vector<Key::CidT> mCids;
+	/** @brief The column of MIDs. */
+	std::vector<Key::MidT> mMids;
+	/** @brief The column of MOIDs. */
+	std::vector<Key::MoidT> mMoids;
+	/** @brief The column of CAP timestamps. */
+	std::vector<Key::CapT> mCaps;
+	/** @brief The column of ACQ timestamps. */
+	std::vector<Key::AcqT> mAcqs;
+	/** @brief The column of payload offsets. */
+	std::vector<std::int64_t> mOffsets;
+	/** @brief The column of payload bytes. */
+	std::vector<std::uint8_t> mData;
+};
+
+} /*namespace tstorage*/
+
+#endif
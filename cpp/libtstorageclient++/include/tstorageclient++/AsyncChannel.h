@@ -0,0 +1,358 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * AsyncChannel.h
+ *   A non-blocking implementation of the TStorage communication protocol.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_ASYNCCHANNEL_H
+#define D_TSTORAGE_ASYNCCHANNEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <ratio>
+#include <string>
+#include <type_traits>
+
+#include "AsyncChannelBase.h"
+#include "DataTypes.h"
+#include "EventLoop.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Defines the `AsyncChannel<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A non-blocking TCP communication channel and client for TStorage.
+ *
+ * An asynchronous counterpart of `Channel<T>`, supporting the same commands.
+ * Instead of blocking the calling thread until a request completes, each
+ * method queues the request on the channel and returns immediately. The
+ * outcome is delivered either to a completion callback or through a
+ * `std::future`, depending on the overload used.
+ *
+ * The I/O is performed by the `EventLoop` the channel is attached to, which
+ * can serve any number of channels with a single thread. Requests submitted to
+ * the same channel are sent in submission order, back-to-back, without waiting
+ * for the responses to the previous ones, and complete in the same order.
+ *
+ * Serialization of PUT/A payloads happens on the calling thread: the whole
+ * request is built in memory, in buffers of the memory limit in size, before
+ * it is queued. Deserialization of GET payloads happens on the loop's thread,
+ * so the `PayloadType<T>` must tolerate being used by both threads at once.
+ *
+ * Callbacks are invoked on the loop's thread, also for requests rejected
+ * right away (e.g. due to an empty key range), so they should return quickly.
+ * They may submit further requests, but must not wait for their futures, nor
+ * destroy the channel. The futures must not be waited for on the loop's
+ * thread either.
+ *
+ * A request the server rejects completes with `result_t::ERROR`, and the
+ * requests queued behind it proceed on the same connection. On any other
+ * failure, the connection is closed, as it is with `Channel<T>`. The failed
+ * request receives the error code, and the requests queued behind it are
+ * completed with `result_t::NOT_CONNECTED` unless they suffer the same
+ * connection-level error (`result_t::CONNCLOSED`, `result_t::CONNERROR`,
+ * `result_t::CONNRESET` or `result_t::CONNTIMEOUT`).
+ *
+ * Copying and moving objects of this class is explicitly disallowed.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class AsyncChannel final : protected impl::AsyncChannelBase
+{
+	static_assert(std::is_default_constructible<T>::value,
+		"The `AsyncChannel` parameter type is not default-constructible");
+
+	static_assert(std::is_move_constructible<T>::value,
+		"The `AsyncChannel` parameter type is not move-constructible");
+
+public:
+	/** @brief A callback receiving the outcome of `connect()`, `put()` and
+	 * `puta()`. */
+	using ResponseCallback = std::function<void(const Response&)>;
+	/** @brief A callback receiving the outcome of `get()`. The records may be
+	 * moved out of the response. */
+	using GetCallback = std::function<void(ResponseGet<T>&)>;
+	/** @brief A callback receiving the outcome of `getAcq()` and
+	 * `getStream()`. */
+	using AcqCallback = std::function<void(const ResponseAcq&)>;
+	/** @brief A callback receiving consecutive portions of records streamed by
+	 * `getStream()`. */
+	using RecordsCallback = std::function<void(RecordsSet<T>&)>;
+
+	/**
+	 * @brief Constructs a channel attached to an event loop.
+	 *
+	 * @param loop The event loop performing the channel's I/O. It must outlive
+	 * the channel.
+	 * @param hostname Hostname of the target TStorage server, or
+	 * `unix:<path>` as with `Channel<T>`.
+	 * @param port Port under which the TStorage server accepts connections.
+	 * @param payloadType A unique_ptr to a PayloadType instance. The ownership
+	 * of the underlying object is transferred to the channel. It's role is to
+	 * de-/serialize records' payloads.
+	 */
+	AsyncChannel(EventLoop& loop,
+		const std::string& hostname,
+		std::uint16_t port,
+		std::unique_ptr<PayloadType<T>> payloadType);
+
+	/**
+	 * @brief Closes the channel if still open and frees all allocated resources.
+	 *
+	 * Pending requests are completed with `result_t::NOT_CONNECTED`. Must not be
+	 * called from within a callback of the channel.
+	 */
+	~AsyncChannel();
+
+	AsyncChannel(const AsyncChannel&) = delete;
+	AsyncChannel(AsyncChannel&&) = delete;
+	AsyncChannel& operator=(const AsyncChannel&) = delete;
+	AsyncChannel& operator=(AsyncChannel&&) = delete;
+
+	/**
+	 * @brief Establishes connection to the server.
+	 *
+	 * The hostname is resolved on the calling thread; connecting proceeds on the
+	 * loop's thread. If the connection is already established, the callback
+	 * receives a success code. Requests submitted while connecting are sent once
+	 * the connection is established.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_ADDRESS`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNREFUSED`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::NOT_CONNECTED` (the channel was closed meanwhile)
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *  - `result_t::SOCKET_ERROR`
+	 *
+	 * @param callback The completion callback.
+	 */
+	void connect(ResponseCallback callback);
+	/**
+	 * @brief Establishes connection to the server.
+	 * @see `connect(ResponseCallback)`
+	 * @return A future of the operation's `Response`.
+	 */
+	std::future<Response> connect();
+	/**
+	 * @brief Closes the current connection, waiting for the event loop to
+	 * release it.
+	 *
+	 * Pending requests are completed with `result_t::NOT_CONNECTED`.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::NOT_CONNECTED`
+	 *
+	 * @return A `Response` instance with the status code of the operation.
+	 */
+	Response close();
+	/**
+	 * @brief Checks whether the channel is connected.
+	 * @return `true` if the connection is established, `false` otherwise.
+	 */
+	bool connected() const;
+	/**
+	 * @brief Sets the timeout of connecting and of request progress.
+	 *
+	 * A request times out (with `result_t::CONNTIMEOUT`) if no data is sent or
+	 * received for the given period while it is pending.
+	 *
+	 * @param timeout Timeout in milliseconds.
+	 */
+	void setTimeout(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the size of the request and receive buffers.
+	 *
+	 * PUT/A requests are built in buffers of this size, and a single record of a
+	 * GET response has to fit into the receive buffer as a whole, otherwise the
+	 * request fails with `result_t::MEMORY_LIMIT_EXCEEDED`. The receive buffer is
+	 * resized upon the next connect. By default, the buffers are 64KiB long.
+	 *
+	 * @param memoryLimitBytes The size of each buffer in bytes.
+	 */
+	void setMemoryLimit(std::size_t memoryLimitBytes);
+
+	/**
+	 * @brief Stores a set of records in the database.
+	 *
+	 * If the records set contains a record with an invalid key or too large of a
+	 * payload, the records preceding it are stored and the callback receives
+	 * `result_t::INVALID_KEY` or `result_t::PAYLOAD_TOO_LARGE`, respectively,
+	 * unless the request fails otherwise.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_RESPONSE`
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNRESET`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::ERROR`
+	 *  - `result_t::INVALID_KEY`
+	 *  - `result_t::MEMORY_LIMIT_EXCEEDED`
+	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *  - `result_t::PAYLOAD_TOO_LARGE`
+	 *
+	 * @param data The records to store.
+	 * @param callback The completion callback.
+	 * @see `Channel::put()`
+	 */
+	void put(const RecordsSet<T>& data, ResponseCallback callback);
+	/**
+	 * @brief Stores a set of records in the database.
+	 * @see `put(const RecordsSet<T>&, ResponseCallback)`
+	 * @return A future of the operation's `Response`.
+	 */
+	std::future<Response> put(const RecordsSet<T>& data);
+	/**
+	 * @brief Stores a set of records with prescribed ACQ timestamps in the
+	 * database.
+	 * @see `put(const RecordsSet<T>&, ResponseCallback)`
+	 * @see `Channel::puta()`
+	 */
+	void puta(const RecordsSet<T>& data, ResponseCallback callback);
+	/**
+	 * @brief Stores a set of records with prescribed ACQ timestamps in the
+	 * database.
+	 * @see `puta(const RecordsSet<T>&, ResponseCallback)`
+	 * @return A future of the operation's `Response`.
+	 */
+	std::future<Response> puta(const RecordsSet<T>& data);
+
+	/**
+	 * @brief Fetches all records with keys inside the key-interval `[keyMin,
+	 * keyMax)`.
+	 *
+	 * On failure, the response contains the records received before the error
+	 * occurred.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_RESPONSE`
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNRESET`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::DESERIALIZATION_ERROR`
+	 *  - `result_t::EMPTY_KEY_RANGE`
+	 *  - `result_t::ERROR`
+	 *  - `result_t::INVALID_KEY`
+	 *  - `result_t::MEMORY_LIMIT_EXCEEDED`
+	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @param callback The completion callback.
+	 * @see `Channel::get()`
+	 */
+	void get(const Key& keyMin, const Key& keyMax, GetCallback callback);
+	/**
+	 * @brief Fetches all records with keys inside the key-interval `[keyMin,
+	 * keyMax)`.
+	 * @see `get(const Key&, const Key&, GetCallback)`
+	 * @return A future of the operation's `ResponseGet<T>`.
+	 */
+	std::future<ResponseGet<T>> get(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Fetches all records with keys inside the key-interval `[keyMin,
+	 * keyMax)`, portion by portion.
+	 *
+	 * `onRecords` is invoked on the loop's thread with the records deserialized
+	 * from each portion of data received from the server, and `onDone` once the
+	 * request completes. The possible error codes are those of `get()`. The
+	 * same set of records, cleared in between, is passed to every `onRecords`
+	 * call, so that its memory is reused; the callback may move records out of
+	 * it.
+	 *
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @param onRecords The record portion callback.
+	 * @param onDone The completion callback.
+	 * @see `Channel::getStream()`
+	 */
+	void getStream(
+		const Key& keyMin, const Key& keyMax, RecordsCallback onRecords, AcqCallback onDone);
+	/**
+	 * @brief Fetches the ACQ timestamp of the last fully-committed record inside
+	 * the key-interval `[keyMin, keyMax)`.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_RESPONSE`
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNRESET`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::EMPTY_KEY_RANGE`
+	 *  - `result_t::ERROR`
+	 *  - `result_t::INVALID_KEY`
+	 *  - `result_t::MEMORY_LIMIT_EXCEEDED`
+	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @param callback The completion callback.
+	 * @see `Channel::getAcq()`
+	 */
+	void getAcq(const Key& keyMin, const Key& keyMax, AcqCallback callback);
+	/**
+	 * @brief Fetches the ACQ timestamp of the last fully-committed record inside
+	 * the key-interval `[keyMin, keyMax)`.
+	 * @see `getAcq(const Key&, const Key&, AcqCallback)`
+	 * @return A future of the operation's `ResponseAcq`.
+	 */
+	std::future<ResponseAcq> getAcq(const Key& keyMin, const Key& keyMax);
+
+private:
+	/**
+	 * @brief A common implementation of `put()` and `puta()`.
+	 * @tparam PutProtocol A protocol tag.
+	 */
+	template<ProtoT PutProtocol>
+	void putImpl(const RecordsSet<T>& data, ResponseCallback callback);
+	/**
+	 * @brief Serializes a record into a PUT/A request.
+	 * @param request The request.
+	 * @param record The record.
+	 * @return The status code.
+	 */
+	result_t serializeRecord(impl::AsyncRequest& request, const Record<T>& record);
+
+	/** @brief The payload de-/serializer, shared with the callbacks running on
+	 * the loop's thread. */
+	std::shared_ptr<PayloadType<T>> mPayloadType;
+};
+
+} /*namespace tstorage*/
+
+#include "AsyncChannel.tpp"
+
+#endif
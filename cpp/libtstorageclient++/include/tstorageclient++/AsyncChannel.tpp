@@ -0,0 +1,309 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * AsyncChannel.tpp
+ *   A non-blocking implementation of the TStorage communication protocol.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_ASYNCCHANNEL_TPP
+#define D_TSTORAGE_ASYNCCHANNEL_TPP
+
+#ifndef D_TSTORAGE_ASYNCCHANNEL_H
+#error __FILE__ was included from outside of "AsyncChannel.h"
+#include "AsyncChannel.h"  // clangd integration
+#endif
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <ratio>
+#include <string>
+#include <utility>
+
+#include "AsyncChannelBase.h"
+#include "DataTypes.h"
+#include "EventLoop.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+namespace tstorage {
+
+/**************
+ * Setup
+ */
+
+template<typename T>
+AsyncChannel<T>::AsyncChannel(EventLoop& loop,
+	const std::string& hostname,
+	const std::uint16_t port,
+	std::unique_ptr<PayloadType<T>> payloadType)
+	: AsyncChannelBase(loop), mPayloadType(std::move(payloadType))
+{
+	setHost(hostname, port);
+}
+
+template<typename T>
+AsyncChannel<T>::~AsyncChannel() = default;
+
+template<typename T>
+void AsyncChannel<T>::connect(ResponseCallback callback)
+{
+	connectImpl([callback](const result_t status, Key::AcqT /*acq*/) {
+		callback(Response(status));
+	});
+}
+
+template<typename T>
+std::future<Response> AsyncChannel<T>::connect()
+{
+	const std::shared_ptr<std::promise<Response>> promise =
+		std::make_shared<std::promise<Response>>();
+	std::future<Response> future = promise->get_future();
+	connect([promise](const Response& response) { promise->set_value(response); });
+	return future;
+}
+
+template<typename T>
+Response AsyncChannel<T>::close()
+{
+	return Response(closeImpl());
+}
+
+template<typename T>
+bool AsyncChannel<T>::connected() const
+{
+	return connectedImpl();
+}
+
+template<typename T>
+void AsyncChannel<T>::setTimeout(const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	setTimeoutImpl(timeout);
+}
+
+template<typename T>
+void AsyncChannel<T>::setMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	setMemoryLimitImpl(memoryLimitBytes);
+}
+
+/**************
+ * PUT/A
+ */
+
+template<typename T>
+template<typename AsyncChannel<T>::ProtoT PutProtocol>
+void AsyncChannel<T>::putImpl(const RecordsSet<T>& data, ResponseCallback callback)
+{
+	const CompletionCallback done = [callback](const result_t status, Key::AcqT /*acq*/) {
+		callback(Response(status));
+	};
+
+	RequestPtr request;
+	result_t res = newPutRequest(PutProtocol, request);
+	if (res != result_t::OK) {
+		postCompletion(done, res);
+		return;
+	}
+
+	typename RecordsSet<T>::const_iterator recordIter = data.begin();
+	typename RecordsSet<T>::const_iterator endIter = data.end();
+	while (res == result_t::OK && recordIter != endIter) {
+		res = serializeRecord(*request, *recordIter);
+		if (res == result_t::OK) {
+			++recordIter;
+		}
+	}
+
+	if (res == result_t::PAYLOAD_TOO_LARGE || res == result_t::INVALID_KEY) {
+		// As with `Channel<T>`, the records preceding the invalid one are stored.
+		submitPut(std::move(request), [callback, res](const result_t status, Key::AcqT /*acq*/) {
+			callback(Response(status == result_t::OK ? res : status));
+		});
+		return;
+	}
+	if (res != result_t::OK) {
+		postCompletion(done, res);
+		return;
+	}
+	submitPut(std::move(request), done);
+}
+
+template<typename T>
+result_t AsyncChannel<T>::serializeRecord(impl::AsyncRequest& request, const Record<T>& record)
+{
+	const void* view{};
+	std::size_t viewSize{};
+	if (mPayloadType->toView(record.value, view, viewSize)) {
+		return writeNextRecordView(request, record.key, view, viewSize);
+	}
+
+	void* buffer{};
+	std::size_t bufferSize{};
+	std::size_t payloadSize{};
+
+	result_t res = mPayloadType->sizeHint(record.value, payloadSize)
+		? reservePayloadBuffer(request, buffer, bufferSize, payloadSize, record.key)
+		: obtainPayloadBuffer(request, buffer, bufferSize, record.key);
+	if (res != result_t::OK) {
+		return res;
+	}
+	payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
+	if (bufferSize < payloadSize) {
+		res = reservePayloadBuffer(request, buffer, bufferSize, payloadSize, record.key);
+		if (res != result_t::OK) {
+			return res;
+		}
+		payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
+	}
+	return writeNextRecord(request, record.key, payloadSize);
+}
+
+template<typename T>
+void AsyncChannel<T>::put(const RecordsSet<T>& data, ResponseCallback callback)
+{
+	putImpl<ProtoT::PUT>(data, std::move(callback));
+}
+
+template<typename T>
+std::future<Response> AsyncChannel<T>::put(const RecordsSet<T>& data)
+{
+	const std::shared_ptr<std::promise<Response>> promise =
+		std::make_shared<std::promise<Response>>();
+	std::future<Response> future = promise->get_future();
+	put(data, [promise](const Response& response) { promise->set_value(response); });
+	return future;
+}
+
+template<typename T>
+void AsyncChannel<T>::puta(const RecordsSet<T>& data, ResponseCallback callback)
+{
+	putImpl<ProtoT::PUTA>(data, std::move(callback));
+}
+
+template<typename T>
+std::future<Response> AsyncChannel<T>::puta(const RecordsSet<T>& data)
+{
+	const std::shared_ptr<std::promise<Response>> promise =
+		std::make_shared<std::promise<Response>>();
+	std::future<Response> future = promise->get_future();
+	puta(data, [promise](const Response& response) { promise->set_value(response); });
+	return future;
+}
+
+/**************
+ * GET/GETACQ
+ */
+
+template<typename T>
+void AsyncChannel<T>::get(const Key& keyMin, const Key& keyMax, GetCallback callback)
+{
+	const std::shared_ptr<PayloadType<T>> payloadType = mPayloadType;
+	const std::shared_ptr<RecordsSet<T>> records = std::make_shared<RecordsSet<T>>();
+	submitGet(
+		keyMin,
+		keyMax,
+		[payloadType, records](const Key& key, const void* payload, std::size_t payloadSize) {
+			Record<T> record{};
+			record.key = key;
+			if (!payloadType->fromBytes(record.value, payload, payloadSize)) {
+				return false;
+			}
+			records->append(std::move(record));
+			return true;
+		},
+		ChunkCallback{},
+		[callback, records](const result_t status, const Key::AcqT acq) {
+			ResponseGet<T> response(
+				status, std::move(*records), status == result_t::OK ? acq : 0);
+			callback(response);
+		});
+}
+
+template<typename T>
+std::future<ResponseGet<T>> AsyncChannel<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	const std::shared_ptr<std::promise<ResponseGet<T>>> promise =
+		std::make_shared<std::promise<ResponseGet<T>>>();
+	std::future<ResponseGet<T>> future = promise->get_future();
+	get(keyMin, keyMax,
+		[promise](ResponseGet<T>& response) { promise->set_value(std::move(response)); });
+	return future;
+}
+
+template<typename T>
+void AsyncChannel<T>::getStream(
+	const Key& keyMin, const Key& keyMax, RecordsCallback onRecords, AcqCallback onDone)
+{
+	const std::shared_ptr<PayloadType<T>> payloadType = mPayloadType;
+	const std::shared_ptr<RecordsSet<T>> records = std::make_shared<RecordsSet<T>>();
+	const ChunkCallback flush = [onRecords, records]() {
+		const std::size_t batchSize = records->size();
+		if (batchSize == 0) {
+			return;
+		}
+		onRecords(*records);
+		records->clear();
+		records->reserve(batchSize);
+	};
+	submitGet(
+		keyMin,
+		keyMax,
+		[payloadType, records](const Key& key, const void* payload, std::size_t payloadSize) {
+			Record<T> record{};
+			record.key = key;
+			if (!payloadType->fromBytes(record.value, payload, payloadSize)) {
+				return false;
+			}
+			records->append(std::move(record));
+			return true;
+		},
+		flush,
+		[flush, onDone](const result_t status, const Key::AcqT acq) {
+			// Deliver the records received before an error, as `Channel<T>` does.
+			flush();
+			onDone(status == result_t::OK ? ResponseAcq(status, acq) : ResponseAcq(status));
+		});
+}
+
+template<typename T>
+void AsyncChannel<T>::getAcq(const Key& keyMin, const Key& keyMax, AcqCallback callback)
+{
+	submitGetAcq(keyMin, keyMax, [callback](const result_t status, const Key::AcqT acq) {
+		callback(status == result_t::OK ? ResponseAcq(status, acq) : ResponseAcq(status));
+	});
+}
+
+template<typename T>
+std::future<ResponseAcq> AsyncChannel<T>::getAcq(const Key& keyMin, const Key& keyMax)
+{
+	const std::shared_ptr<std::promise<ResponseAcq>> promise =
+		std::make_shared<std::promise<ResponseAcq>>();
+	std::future<ResponseAcq> future = promise->get_future();
+	getAcq(keyMin, keyMax,
+		[promise](const ResponseAcq& response) { promise->set_value(response); });
+	return future;
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * AsyncChannelBase.h
+ *   A base class of `AsyncChannel<T>` providing the API to the library.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_ASYNCCHANNELBASE_H
+#define D_TSTORAGE_ASYNCCHANNELBASE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ratio>
+#include <string>
+
+#include "DataTypes.h"
+#include "EventLoop.h"
+
+/** @file
+ * @brief Defines the base class of each `AsyncChannel<T>`. */
+
+namespace tstorage {
+namespace impl {
+
+class AsyncChannelImpl;
+class AsyncRequest;
+
+/** @brief Destroys `AsyncRequest` objects, which are opaque outside of the
+ * library. */
+struct AsyncRequestDeleter
+{
+	/** @brief Destroys the request. */
+	void operator()(AsyncRequest* request) const;
+};
+
+/**
+ * @brief A base class of each AsyncChannel<T>.
+ *
+ * Analogously to `ChannelBase`, this class defines the ABI between the
+ * templated `AsyncChannel<T>` and the library, and hides the implementation
+ * behind a PIMPL pointer.
+ *
+ * Contrary to `ChannelBase`, the channel has no serialization state of its
+ * own. A PUT/A request is built in a standalone `AsyncRequest` object, one
+ * record at a time, with the payload serialized by the caller directly into
+ * the request's buffers, and then handed over to the channel as a whole. GET
+ * responses are parsed on the event loop's thread, which passes each record's
+ * raw payload to a visitor supplied by the caller. All methods are safe to
+ * call from any thread.
+ *
+ * The completion callbacks receive the status code of the request and, for
+ * GET and GETACQ, the returned ACQ (undefined on error). They are always
+ * invoked on the event loop's thread, even for requests rejected right away.
+ */
+class AsyncChannelBase
+{
+public:
+	/**
+	 * @brief A constructor.
+	 * @param loop The event loop to attach the channel to.
+	 */
+	explicit AsyncChannelBase(EventLoop& loop);
+	/** @brief A destructor. Closes the connection. */
+	~AsyncChannelBase();
+
+	AsyncChannelBase(const AsyncChannelBase&) = delete;
+	AsyncChannelBase(AsyncChannelBase&&) = delete;
+	AsyncChannelBase& operator=(const AsyncChannelBase&) = delete;
+	AsyncChannelBase& operator=(AsyncChannelBase&&) = delete;
+
+protected:
+	/** @brief A PUT protocol version. */
+	enum ProtoT {
+		PUT,
+		PUTA,
+	};
+
+	/** @brief An owning pointer to a request. */
+	using RequestPtr = std::unique_ptr<AsyncRequest, AsyncRequestDeleter>;
+	/** @brief A request completion callback. */
+	using CompletionCallback = std::function<void(result_t status, Key::AcqT acq)>;
+	/** @brief A GET record visitor. Returns `false` if the payload can't be
+	 * deserialized. */
+	using RecordVisitor =
+		std::function<bool(const Key& key, const void* payload, std::size_t payloadSize)>;
+	/** @brief Called after each portion of records received in response to
+	 * GET. */
+	using ChunkCallback = std::function<void()>;
+
+	/**
+	 * @brief Connects the channel asynchronously.
+	 *
+	 * The hostname is resolved synchronously on the calling thread.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_ADDRESS`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNREFUSED`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *  - `result_t::SOCKET_ERROR`
+	 *
+	 * @param callback The completion callback.
+	 */
+	void connectImpl(CompletionCallback callback);
+	/**
+	 * @brief Closes the connection, waiting for the event loop to release it.
+	 *
+	 * Requests that have not completed yet are completed with
+	 * `result_t::NOT_CONNECTED`.
+	 *
+	 * @return `result_t::NOT_CONNECTED` if the channel was not connected,
+	 * `result_t::OK` otherwise.
+	 */
+	result_t closeImpl();
+	/** @brief Returns `true` if the connection is established. */
+	bool connectedImpl() const;
+
+	/**
+	 * @brief Creates an empty PUT/A request.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *
+	 * @param proto The protocol version.
+	 * @param[out] oRequest The new request.
+	 * @return The status code.
+	 */
+	result_t newPutRequest(ProtoT proto, RequestPtr& oRequest);
+	/**
+	 * @brief Retrieves a writable memory block of the request's buffer for
+	 * payload serialization, sized after the largest payload so far.
+	 * @see ChannelBase::obtainPutPayloadBuffer()
+	 */
+	static result_t obtainPayloadBuffer(
+		AsyncRequest& request, void*& oPayloadBuffer, std::size_t& oBufferSize, const Key& key);
+	/**
+	 * @brief Reserves a writable memory block of at least `payloadSize` bytes of
+	 * the request's buffer for payload serialization.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::MEMORY_LIMIT_EXCEEDED`
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *
+	 * @see ChannelBase::reservePutPayloadBuffer()
+	 */
+	static result_t reservePayloadBuffer(AsyncRequest& request,
+		void*& oPayloadBuffer,
+		std::size_t& oBufferSize,
+		std::size_t payloadSize,
+		const Key& key);
+	/**
+	 * @brief Appends the metadata of a record the payload of which was
+	 * serialized into the reserved memory block.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::INVALID_KEY`
+	 *  - `result_t::PAYLOAD_TOO_LARGE`
+	 */
+	static result_t writeNextRecord(AsyncRequest& request, const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Appends a record the payload of which is given as a read-only
+	 * memory block. The payload is copied.
+	 *
+	 * The possible error codes are those of `reservePayloadBuffer()` and
+	 * `writeNextRecord()`.
+	 */
+	static result_t writeNextRecordView(AsyncRequest& request,
+		const Key& key,
+		const void* payload,
+		std::size_t payloadSize);
+	/**
+	 * @brief Finalizes a PUT/A request and queues it for sending.
+	 * @param request The request.
+	 * @param callback The completion callback.
+	 */
+	void submitPut(RequestPtr request, CompletionCallback callback);
+	/**
+	 * @brief Queues a GET request for sending.
+	 *
+	 * Both `visitor` and `onChunk` are invoked on the event loop's thread.
+	 *
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @param visitor The record visitor.
+	 * @param onChunk The record portion callback (might be empty).
+	 * @param callback The completion callback.
+	 */
+	void submitGet(const Key& keyMin,
+		const Key& keyMax,
+		RecordVisitor visitor,
+		ChunkCallback onChunk,
+		CompletionCallback callback);
+	/**
+	 * @brief Queues a GETACQ request for sending.
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @param callback The completion callback.
+	 */
+	void submitGetAcq(const Key& keyMin, const Key& keyMax, CompletionCallback callback);
+	/**
+	 * @brief Invokes a completion callback on the event loop's thread with the
+	 * given status code. Used for requests rejected before submission.
+	 * @param callback The completion callback.
+	 * @param status The status code.
+	 */
+	void postCompletion(CompletionCallback callback, result_t status);
+
+	/** @brief Sets the timeout for connecting and request progress. */
+	void setTimeoutImpl(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/** @brief Sets the size limit of request and receive buffers. */
+	void setMemoryLimitImpl(std::size_t memoryLimitBytes);
+	/** @brief Sets the address of the target TStorage server. */
+	void setHost(const std::string& addr, std::uint16_t port);
+
+private:
+	/** @brief A pointer to the implementation, shared with the tasks queued on
+	 * the event loop. */
+	std::shared_ptr<AsyncChannelImpl> mImpl;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
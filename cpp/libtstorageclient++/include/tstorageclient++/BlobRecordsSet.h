@@ -0,0 +1,163 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * BlobRecordsSet.h
+ *   A container of records with raw payloads kept in a single byte heap.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_BLOBRECORDSSET_H
+#define D_TSTORAGE_BLOBRECORDSSET_H
+
+#include <cstddef>
+#include <vector>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines a container of records with raw payloads. */
+
+namespace tstorage {
+
+/**
+ * @brief A container for inbound records with raw, variable-size payloads.
+ *
+ * Instead of deserializing each payload into an object of its own, like
+ * `RecordsSet<std::string>` does with a heap allocation per record, the set
+ * copies the payloads back-to-back into a single growing byte heap. Each
+ * record is then just its key and the position of its payload in the heap
+ * (see `Entry`). This cuts the memory taken by many small string or blob
+ * payloads, and makes iterating over them cache-friendly.
+ *
+ * A default-constructible, copyable and moveable container. It can be filled
+ * directly by `Channel<T>::getBlob()` and `Channel<T>::getStreamBlob()`,
+ * which never call `PayloadType<T>::fromBytes()`. The payload views returned
+ * by `payload()` are invalidated by `append()` and `clear()`.
+ *
+ * Payloads are packed without padding by default. Zero-copy formats read in
+ * place, e.g. FlatBuffers, may need aligned buffers; a set constructed with
+ * a payload alignment starts each payload at an address aligned to it (see
+ * `ViewRecordsSet<Schema>`).
+ */
+class BlobRecordsSet final
+{
+public:
+	/**
+	 * @brief Constructs an empty set.
+	 * @param payloadAlignment The alignment of the payloads in memory, a power
+	 * of two, at most `alignof(std::max_align_t)`.
+	 */
+	explicit BlobRecordsSet(const std::size_t payloadAlignment = 1)
+		: mAlignment(payloadAlignment)
+	{
+	}
+
+	/** @brief A record of the set. */
+	struct Entry
+	{
+		/** @brief The key of the record. */
+		Key key;
+		/** @brief The offset of the payload in the heap. */
+		std::size_t offset;
+		/** @brief The size of the payload in bytes. */
+		std::size_t size;
+	};
+
+	/**
+	 * @brief Appends a record to the end of the container, copying its
+	 * payload into the heap.
+	 *
+	 * @param key Key of the new record.
+	 * @param payload The payload bytes.
+	 * @param size The size of the payload.
+	 */
+	void append(const Key& key, const void* const payload, const std::size_t size)
+	{
+		const unsigned char* const bytes = static_cast<const unsigned char*>(payload);
+		// The heap is allocated by operator new, aligned to max_align_t, so
+		// aligned offsets make aligned addresses.
+		const std::size_t offset = (mHeap.size() + mAlignment - 1) & ~(mAlignment - 1);
+		mHeap.resize(offset);
+		mEntries.push_back(Entry{key, offset, size});
+		mHeap.insert(mHeap.end(), bytes, bytes + size);
+	}
+
+	/**
+	 * @brief Returns the number of records currently stored in the container.
+	 */
+	std::size_t size() const { return mEntries.size(); }
+
+	/**
+	 * @brief Reserves space for at least `count` records, so that appending
+	 * them does not reallocate the table of entries.
+	 * @param count The number of records to make room for.
+	 */
+	void reserve(const std::size_t count) { mEntries.reserve(count); }
+
+	/**
+	 * @brief Reserves space for at least `bytes` bytes of payloads.
+	 * @param bytes The total payload size to make room for.
+	 */
+	void reserveBytes(const std::size_t bytes) { mHeap.reserve(bytes); }
+
+	/**
+	 * @brief Removes all records from the container. The allocated memory is
+	 * retained for reuse.
+	 */
+	void clear()
+	{
+		mEntries.clear();
+		mHeap.clear();
+	}
+
+	/**
+	 * @brief Returns the key of the `i`-th record.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	const Key& key(const std::size_t i) const { return mEntries[i].key; }
+	/**
+	 * @brief Returns the payload of the `i`-th record.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	const unsigned char* payload(const std::size_t i) const
+	{
+		return mHeap.data() + mEntries[i].offset;
+	}
+	/**
+	 * @brief Returns the payload size of the `i`-th record.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	std::size_t payloadSize(const std::size_t i) const { return mEntries[i].size; }
+
+	/** @brief Returns the records, in the order of appending. */
+	const std::vector<Entry>& entries() const { return mEntries; }
+	/** @brief Returns the heap holding the payloads of all records. */
+	const std::vector<unsigned char>& heap() const { return mHeap; }
+	/** @brief Returns the alignment of the payloads in memory. */
+	std::size_t payloadAlignment() const { return mAlignment; }
+
+private:
+	/** @brief The alignment of the payloads in memory. */
+	std::size_t mAlignment;
+	/** @brief The records. */
+	std::vector<Entry> mEntries;
+	/** @brief The payloads of the records. */
+	std::vector<unsigned char> mHeap;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,84 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * BrokerChannel.h
+ *   A channel to the local connection broker, `tstorage-broker`.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_BROKERCHANNEL_H
+#define D_TSTORAGE_BROKERCHANNEL_H
+
+#include <string>
+
+#include "Channel.h"
+
+/** @file
+ * @brief Defines `BrokerChannel<T>`, a channel to the local connection
+ * broker. */
+
+namespace tstorage {
+
+/** @brief The socket the broker listens on by default. */
+constexpr const char* const cDefaultBrokerSocket = "/tmp/tstorage-broker.sock";
+
+/**
+ * @brief A channel to `tstorage-broker`, the connection broker of the host.
+ *
+ * Many short-lived or lightly loaded processes storing records each pay for
+ * a connection and for requests of a few records. The broker, a daemon of
+ * the `tools/` directory, accepts the connections of the local processes on
+ * a Unix domain socket and speaks the TStorage protocol to them. It gathers
+ * the PUT and PUTA requests of all of them into large batches grouped by CID,
+ * sent over a few persistent connections to the server, and merges identical
+ * concurrent GET and GETACQ requests.
+ *
+ * As the broker speaks the protocol of the server, a broker channel is a
+ * plain `Channel<T>`, with the whole API of one, connected to the address
+ * returned by `brokerAddress()`:
+ *
+ * @code
+ * BrokerChannel<double> channel(brokerAddress(), 0, std::make_unique<TrivialPayloadType<double>>());
+ * channel.connect();
+ * channel.put(records);
+ * @endcode
+ *
+ * A PUT or PUTA request returns once its records have been stored by the
+ * server as a part of a batch, so a later GET sees them. It waits for the
+ * batch to fill or to linger for the time the broker is configured with, and
+ * fails if the batch does. The responses to PUT requests carry no ACQ
+ * timestamps, which no channel reads anyway.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+using BrokerChannel = Channel<T>;
+
+/**
+ * @brief Returns the address of a channel to the broker listening on
+ * `socketPath`, to be passed as the hostname of a `BrokerChannel<T>`.
+ *
+ * @param socketPath The path of the socket of the broker, or `@<name>` for an
+ * abstract one.
+ */
+inline std::string brokerAddress(const std::string& socketPath = cDefaultBrokerSocket)
+{
+	return "unix:" + socketPath;
+}
+
+} /*namespace tstorage*/
+
+#endif
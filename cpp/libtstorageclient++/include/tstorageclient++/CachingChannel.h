@@ -0,0 +1,203 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * CachingChannel.h
+ *   A client-side cache of GET responses, invalidated by ACQ timestamps.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_CACHINGCHANNEL_H
+#define D_TSTORAGE_CACHINGCHANNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "NegativeCache.h"
+#include "RecordsSet.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Defines the `CachingChannel<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A GET front end of a channel, caching the immutable part of the
+ * responses.
+ *
+ * A successful GET response carries the full-commit ACQ of its key-interval,
+ * below which the records of the key-interval never change (see
+ * `Channel<T>::getAcq()`). The cache keeps the records of each completed
+ * `get()` up to that ACQ, keyed by the key-interval less its ACQ bounds. A
+ * later `get()` of the same key-interval fetches only the records from the
+ * cached ACQ on, i.e. the range `[max(keyMin.acq, cachedAcq), keyMax.acq)`,
+ * and merges them with the cached ones; for a historical key-interval, whose
+ * `keyMax.acq` lies below the cached ACQ, no request is sent at all.
+ *
+ * A response served from the cache carries the most recent full-commit ACQ
+ * seen for the key-interval, which may be older than the server's current
+ * one, but gives the same consistency guarantee.
+ *
+ * With a negative cache (see `setNegativeCache()`), the key-intervals of empty
+ * responses are kept apart, and a later `get()` of any key-interval inside
+ * them is answered without a request, or fetches only the ACQ range above
+ * them. This suits fan-out queries of many series, most of them empty.
+ *
+ * The memory taken by the cached records is bounded; the least recently used
+ * key-intervals are evicted first. It is estimated as `sizeof(Record<T>)` per
+ * record, not counting the memory the payloads may own.
+ *
+ * Like the channel, the cache is not thread-safe. The channel must be
+ * connected beforehand and must outlive the cache.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class CachingChannel final
+{
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param channel The channel fetching the records.
+	 * @param capacityBytes The memory bound of the cached records.
+	 */
+	CachingChannel(Channel<T>& channel, std::size_t capacityBytes);
+
+	CachingChannel(const CachingChannel&) = delete;
+	CachingChannel(CachingChannel&&) = delete;
+	CachingChannel& operator=(const CachingChannel&) = delete;
+	CachingChannel& operator=(CachingChannel&&) = delete;
+
+	/**
+	 * @brief Retrieves a set of records like `Channel<T>::get()`, fetching
+	 * only those not in the cache.
+	 *
+	 * The failed requests are not cached. The possible error codes are those
+	 * of `Channel<T>::get()`.
+	 *
+	 * @see Channel<T>::get()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @return The response as in `Channel<T>::get()`.
+	 */
+	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+
+	/**
+	 * @brief Sets the negative cache, which keeps the key-intervals of empty
+	 * responses.
+	 *
+	 * The negative cache may be shared by the caches of the same server used
+	 * from a single thread, e.g. those of different payload types. By
+	 * default, a cache has none.
+	 *
+	 * @see NegativeCache
+	 *
+	 * @param negativeCache The negative cache, or `nullptr` for none.
+	 */
+	void setNegativeCache(std::shared_ptr<NegativeCache> negativeCache);
+
+	/** @brief Drops all cached records, but not the key-intervals of the
+	 * negative cache. */
+	void clear();
+
+	/** @brief Returns the estimated memory taken by the cached records. */
+	std::size_t cachedBytes() const { return mCachedBytes; }
+	/** @brief Returns the amount of `get()` calls served from the cache, at
+	 * least in part. */
+	std::uint64_t hits() const { return mHits; }
+	/** @brief Returns the amount of `get()` calls fetched as a whole. */
+	std::uint64_t misses() const { return mMisses; }
+	/** @brief Returns the amount of `get()` calls answered by the negative
+	 * cache without a request. */
+	std::uint64_t emptyHits() const { return mEmptyHits; }
+
+private:
+	/** @brief A key-interval less its ACQ bounds. */
+	using RangeId = std::tuple<Key::CidT,
+		Key::MidT,
+		Key::MoidT,
+		Key::CapT,
+		Key::CidT,
+		Key::MidT,
+		Key::MoidT,
+		Key::CapT>;
+
+	/** @brief The cached records of a key-interval. */
+	struct Entry
+	{
+		/** @brief The cached key-interval. */
+		RangeId range;
+		/** @brief The lower ACQ bound of the cached records. */
+		Key::AcqT minAcq;
+		/** @brief The upper ACQ bound of the cached records. */
+		Key::AcqT maxAcq;
+		/** @brief The most recent full-commit ACQ of the key-interval. */
+		Key::AcqT acq;
+		/** @brief The records with ACQs in `[minAcq, maxAcq)`. */
+		RecordsSet<T> records;
+	};
+
+	/** @brief Returns the cache key of a key-interval. */
+	static RangeId rangeOf(const Key& keyMin, const Key& keyMax);
+	/** @brief Returns the estimated memory taken by the records of `entry`. */
+	static std::size_t bytesOf(const Entry& entry);
+	/** @brief Fetches a key-interval as a whole and caches the response. */
+	ResponseGet<T> fetch(const Key& keyMin, const Key& keyMax);
+	/** @brief Fetches the records of a key-interval from `acq` on, the
+	 * negative cache knowing it empty below, and records an empty response in
+	 * the negative cache. */
+	ResponseGet<T> fetchAbove(const Key& keyMin, const Key& keyMax, Key::AcqT acq);
+	/** @brief Evicts the least recently used entries until the cache fits in
+	 * its memory bound. */
+	void evict();
+
+	/** @brief The channel fetching the records. */
+	Channel<T>& mChannel;
+	/** @brief The memory bound of the cached records. */
+	std::size_t mCapacityBytes;
+	/** @brief The estimated memory taken by the cached records. */
+	std::size_t mCachedBytes;
+	/** @brief The entries, the most recently used first. */
+	std::list<Entry> mEntries;
+	/** @brief The entries by their key-intervals. */
+	std::map<RangeId, typename std::list<Entry>::iterator> mIndex;
+	/** @brief The amount of calls served from the cache. */
+	std::uint64_t mHits;
+	/** @brief The amount of calls fetched as a whole. */
+	std::uint64_t mMisses;
+	/** @brief The negative cache, if any. */
+	std::shared_ptr<NegativeCache> mNegativeCache;
+	/** @brief The amount of calls answered by the negative cache. */
+	std::uint64_t mEmptyHits;
+};
+
+} /*namespace tstorage*/
+
+#include "CachingChannel.tpp"
+
+#endif
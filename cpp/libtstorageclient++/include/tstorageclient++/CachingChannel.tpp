@@ -0,0 +1,208 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * CachingChannel.tpp
+ *   An implementation of the `CachingChannel<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_CACHINGCHANNEL_TPP
+#define D_TSTORAGE_CACHINGCHANNEL_TPP
+
+#ifndef D_TSTORAGE_CACHINGCHANNEL_H
+#error __FILE__ was included from outside of "CachingChannel.h"
+#include "CachingChannel.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "NegativeCache.h"
+#include "RecordsSet.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Contains the implementation of `CachingChannel<T>`. */
+
+namespace tstorage {
+
+template<typename T>
+CachingChannel<T>::CachingChannel(Channel<T>& channel, const std::size_t capacityBytes)
+	: mChannel(channel)
+	, mCapacityBytes(capacityBytes)
+	, mCachedBytes(0)
+	, mHits(0)
+	, mMisses(0)
+	, mNegativeCache()
+	, mEmptyHits(0)
+{
+}
+
+template<typename T>
+ResponseGet<T> CachingChannel<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	if (keyMin.acq >= keyMax.acq) {
+		// Let the channel report the empty key-interval.
+		return mChannel.get(keyMin, keyMax);
+	}
+	Key::AcqT emptyUntil = keyMin.acq;
+	Key::AcqT emptyAcq = keyMin.acq;
+	if (mNegativeCache && mNegativeCache->lookup(keyMin, keyMax, emptyUntil, emptyAcq)) {
+		if (emptyUntil >= keyMax.acq) {
+			++mEmptyHits;
+			return ResponseGet<T>(result_t::OK, RecordsSet<T>{}, emptyAcq);
+		}
+		++mHits;
+		return fetchAbove(keyMin, keyMax, emptyUntil);
+	}
+	const auto found = mIndex.find(rangeOf(keyMin, keyMax));
+	if (found == mIndex.end() || keyMin.acq < found->second->minAcq
+		|| keyMin.acq > found->second->maxAcq) {
+		++mMisses;
+		return fetch(keyMin, keyMax);
+	}
+	++mHits;
+	mEntries.splice(mEntries.begin(), mEntries, found->second);
+	Entry& entry = *found->second;
+
+	const Key::AcqT cachedMax = std::min(keyMax.acq, entry.maxAcq);
+	RecordsSet<T> records{};
+	for (const Record<T>& record : entry.records) {
+		if (record.key.acq >= keyMin.acq && record.key.acq < cachedMax) {
+			records.append(record);
+		}
+	}
+	if (keyMax.acq <= entry.maxAcq) {
+		return ResponseGet<T>(result_t::OK, std::move(records), entry.acq);
+	}
+
+	Key deltaMin = keyMin;
+	deltaMin.acq = entry.maxAcq;
+	ResponseGet<T> delta = mChannel.get(deltaMin, keyMax);
+	if (delta.error()) {
+		return delta;
+	}
+	mCachedBytes -= bytesOf(entry);
+	const Key::AcqT maxAcq = std::max(entry.maxAcq, std::min(keyMax.acq, delta.acq()));
+	for (const Record<T>& record : delta.records()) {
+		records.append(record);
+		if (record.key.acq < maxAcq) {
+			entry.records.append(record);
+		}
+	}
+	entry.maxAcq = maxAcq;
+	entry.acq = std::max(entry.acq, delta.acq());
+	mCachedBytes += bytesOf(entry);
+	evict();
+	return ResponseGet<T>(delta.status(), std::move(records), delta.acq());
+}
+
+template<typename T>
+void CachingChannel<T>::setNegativeCache(std::shared_ptr<NegativeCache> negativeCache)
+{
+	mNegativeCache = std::move(negativeCache);
+}
+
+template<typename T>
+void CachingChannel<T>::clear()
+{
+	mIndex.clear();
+	mEntries.clear();
+	mCachedBytes = 0;
+}
+
+template<typename T>
+typename CachingChannel<T>::RangeId CachingChannel<T>::rangeOf(
+	const Key& keyMin, const Key& keyMax)
+{
+	return RangeId(keyMin.cid,
+		keyMin.mid,
+		keyMin.moid,
+		keyMin.cap,
+		keyMax.cid,
+		keyMax.mid,
+		keyMax.moid,
+		keyMax.cap);
+}
+
+template<typename T>
+std::size_t CachingChannel<T>::bytesOf(const Entry& entry)
+{
+	return sizeof(Entry) + entry.records.size() * sizeof(Record<T>);
+}
+
+template<typename T>
+ResponseGet<T> CachingChannel<T>::fetch(const Key& keyMin, const Key& keyMax)
+{
+	ResponseGet<T> response = mChannel.get(keyMin, keyMax);
+	if (response.error()) {
+		return response;
+	}
+
+	const RangeId range = rangeOf(keyMin, keyMax);
+	const auto found = mIndex.find(range);
+	if (found != mIndex.end()) {
+		mCachedBytes -= bytesOf(*found->second);
+		mEntries.erase(found->second);
+		mIndex.erase(found);
+	}
+	if (mNegativeCache && response.records().size() == 0) {
+		mNegativeCache->insert(keyMin, keyMax, response.acq());
+		return response;
+	}
+	mEntries.push_front(Entry{range,
+		keyMin.acq,
+		std::min(keyMax.acq, response.acq()),
+		response.acq(),
+		response.records()});
+	mIndex.emplace(range, mEntries.begin());
+	mCachedBytes += bytesOf(mEntries.front());
+	evict();
+	return response;
+}
+
+template<typename T>
+ResponseGet<T> CachingChannel<T>::fetchAbove(
+	const Key& keyMin, const Key& keyMax, const Key::AcqT acq)
+{
+	Key aboveMin = keyMin;
+	aboveMin.acq = acq;
+	ResponseGet<T> response = mChannel.get(aboveMin, keyMax);
+	if (!response.error() && response.records().size() == 0) {
+		mNegativeCache->insert(aboveMin, keyMax, response.acq());
+	}
+	return response;
+}
+
+template<typename T>
+void CachingChannel<T>::evict()
+{
+	while (mCachedBytes > mCapacityBytes && !mEntries.empty()) {
+		const Entry& entry = mEntries.back();
+		mCachedBytes -= bytesOf(entry);
+		mIndex.erase(entry.range);
+		mEntries.pop_back();
+	}
+}
+
+} /*namespace tstorage*/
+
+#endif
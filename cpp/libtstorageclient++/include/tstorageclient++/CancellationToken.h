@@ -0,0 +1,59 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * CancellationToken.h
+ *   A flag cancelling a stream from any thread.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_CANCELLATIONTOKEN_H
+#define D_TSTORAGE_CANCELLATIONTOKEN_H
+
+#include <atomic>
+#include <memory>
+
+/** @file
+ * @brief Defines the `CancellationToken` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A shared flag requesting a stream to stop early.
+ *
+ * Copies of a token share the same flag, so that a copy passed to
+ * `Channel::getStreamUntil()` observes `cancel()` called on another copy,
+ * e.g. by a watchdog or a UI thread. The flag is never cleared; a token
+ * cancels every stream it is passed to afterwards.
+ */
+class CancellationToken
+{
+public:
+	/** @brief Constructs a token which is not cancelled. */
+	CancellationToken() : mCancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+	/** @brief Requests the streams observing the token to stop. Thread-safe. */
+	void cancel() { mCancelled->store(true, std::memory_order_release); }
+	/** @brief Returns `true` once `cancel()` has been called on any copy. */
+	bool cancelled() const { return mCancelled->load(std::memory_order_acquire); }
+
+private:
+	/** @brief The flag shared by the copies. */
+	std::shared_ptr<std::atomic<bool>> mCancelled;
+};
+
+} /*namespace tstorage*/
+
+#endif
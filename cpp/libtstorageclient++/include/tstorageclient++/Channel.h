@@ -23,20 +23,40 @@
 #define D_TSTORAGE_CHANNEL_H
 
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <ratio>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
+#include "Arena.h"
+#include "ArrowRecordsSet.h"
+#include "BlobRecordsSet.h"
+#include "CancellationToken.h"
+#include "ColumnarRecordsSet.h"
 #include "DataTypes.h"
+#include "LazyRecordsSet.h"
+#include "MemoryBudget.h"
+#include "MixedRecordsSet.h"
 #include "PayloadType.h"
+#include "PutDedupFilter.h"
+#include "PutStream.h"
 #include "RecordsSet.h"
 #include "Response.h"
 #include "ResponseAcq.h"
 #include "ResponseGet.h"
+#include "SeriesSet.h"
+#include "SpilledRecordsSet.h"
+#include "Tracer.h"
+#include "TrivialPayloadType.h"
 
 #include "ChannelBase.h"
 
@@ -47,6 +67,51 @@ namespace tstorage {
 
 using impl::ChannelBase;
 
+template<typename T>
+class Channel;
+
+/**
+ * @brief Copies the records of a key-interval from one TStorage instance to
+ * another, as they are, preserving their ACQ timestamps.
+ *
+ * Sends a GET request over `source` and a PUTA request over `destination`,
+ * and forwards each record of the GET response to the PUTA request as it is
+ * received: the raw payload is copied from the buffer of `source` straight
+ * into that of `destination`, so that no payload is ever deserialized or
+ * serialized and no `Record` is constructed. The payload types of the
+ * channels are not used, and need not match.
+ *
+ * The records are received and sent on the calling thread, while the
+ * kernel's socket buffers keep both connections busy. With a put pipeline
+ * on `destination` (see `Channel::setPutPipelineDepth()`), its buffers are
+ * sent on a background thread, so that receiving the response overlaps with
+ * sending the request as well and a migration runs at the speed of the
+ * slower connection. As with `Channel::getView()`, the size of the
+ * key-interval is not bounded by the memory limit of `source`, but each
+ * record has to fit its buffer.
+ *
+ * On error, the PUTA request is handled as in `Channel::puta()` and the GET
+ * request as in `Channel::get()`, except that a failure of either request
+ * aborts the connection of the other one too, unless it has already
+ * completed. The records stored before the failure are kept.
+ *
+ * The possible error codes are those of `Channel::getView()` and
+ * `Channel::puta()`.
+ *
+ * @param source The channel to read the records from.
+ * @param destination The channel to store the records with.
+ * @param keyMin The lower vertex of the right-open key-interval
+ * containing the records to copy.
+ * @param keyMax The upper vertex of the right-open key-interval
+ * containing the records to copy.
+ * @return `ResponseAcq(result_t::OK, acq)` with the ACQ timestamp of the GET
+ * response if all records have been copied, `ResponseAcq(err)` with an
+ * error code `err` otherwise.
+ */
+template<typename S, typename D>
+ResponseAcq replicate(
+	Channel<S>& source, Channel<D>& destination, const Key& keyMin, const Key& keyMax);
+
 /**
  * @brief A TCP communication channel and client for TStorage.
  *
@@ -83,16 +148,159 @@ class Channel final : public ChannelBase
 		"The `Channel` parameter type is not move-constructible");
 
 public:
+	/**
+	 * @brief The response to a GET request, read one record at a time.
+	 *
+	 * Returned by `openStream()`. Each call to `next()`, or each step of an
+	 * iterator, receives and deserializes a single record into a value kept
+	 * by the stream, so the caller drives the transfer: no record is received
+	 * before it's asked for, and no set of records is built. Once the records
+	 * run out, `response()` holds the status code and ACQ of the response.
+	 *
+	 * The channel must not be used for anything else while a stream is
+	 * pending, and must not be moved. Destroying a pending stream closes the
+	 * connection, since the rest of the response can't be skipped without
+	 * receiving it; call `drain()` to keep the connection instead.
+	 *
+	 * A moveable, non-copyable handle.
+	 */
+	class Stream
+	{
+	public:
+		/**
+		 * @brief An input iterator over the records of a stream.
+		 *
+		 * Incrementing it receives the next record, invalidating the one it
+		 * referred to. All iterators of a stream share its position.
+		 */
+		class iterator
+		{
+		public:
+			/** @brief The iterator category. */
+			using iterator_category = std::input_iterator_tag;
+			/** @brief The value type. */
+			using value_type = Record<T>;
+			/** @brief The difference type. */
+			using difference_type = std::ptrdiff_t;
+			/** @brief The pointer type. */
+			using pointer = const Record<T>*;
+			/** @brief The reference type. */
+			using reference = const Record<T>&;
+
+			/** @brief Constructs an end iterator. */
+			iterator() : mStream(nullptr) {}
+
+			/** @brief Accesses the current record. */
+			reference operator*() const { return mStream->record(); }
+			/** @brief Accesses the current record. */
+			pointer operator->() const { return &mStream->record(); }
+			/** @brief Receives the next record, turning into an end iterator
+			 * if there is none. */
+			iterator& operator++()
+			{
+				if (!mStream->next()) {
+					mStream = nullptr;
+				}
+				return *this;
+			}
+			/** @brief Returns `true` if both iterators are at the same
+			 * position. */
+			bool operator==(const iterator& other) const { return mStream == other.mStream; }
+			/** @brief Returns `true` if the iterators are at different
+			 * positions. */
+			bool operator!=(const iterator& other) const { return mStream != other.mStream; }
+
+		private:
+			friend class Stream;
+			/** @brief Constructs an iterator at the current record of
+			 * `stream`. */
+			explicit iterator(Stream* stream) : mStream(stream) {}
+
+			/** @brief The stream, `nullptr` past its end. */
+			Stream* mStream;
+		};
+
+		/** @brief A move constructor. Leaves `other` finished. */
+		Stream(Stream&& other) noexcept;
+		/** @brief Closes the connection if the stream is pending. */
+		~Stream();
+
+		Stream(const Stream&) = delete;
+		Stream& operator=(const Stream&) = delete;
+		Stream& operator=(Stream&&) = delete;
+
+		/**
+		 * @brief Receives the next record.
+		 * @return `true` if a record was received, `false` if the records
+		 * have run out or the stream has failed.
+		 */
+		bool next();
+		/** @brief Returns the record received last by `next()`. */
+		const Record<T>& record() const { return mRecord; }
+		/** @brief Moves the record received last by `next()` out of the
+		 * stream. */
+		Record<T> take() { return std::move(mRecord); }
+
+		/**
+		 * @brief Receives the first record and returns an iterator at it.
+		 * Meant to be called once, e.g. by a range-based for loop.
+		 */
+		iterator begin() { return next() ? iterator(this) : iterator(); }
+		/** @brief Returns the end iterator. */
+		iterator end() { return iterator(); }
+
+		/** @brief Returns `true` once the records have run out or the stream
+		 * has failed. */
+		bool finished() const { return mChannel == nullptr; }
+		/**
+		 * @brief Returns the status code and the ACQ timestamp of the response
+		 * once the stream is finished, `result_t::OK` with no valid ACQ while
+		 * it is pending.
+		 *
+		 * The possible error codes are those of `get()`.
+		 */
+		ResponseAcq response() const { return mResponse; }
+		/**
+		 * @brief Receives and discards the remaining records, keeping the
+		 * connection open.
+		 * @return The response, as returned by `response()`.
+		 */
+		ResponseAcq drain();
+
+	private:
+		friend class Channel<T>;
+		/** @brief Constructs a pending stream of the response `channel` has
+		 * just started to receive. */
+		explicit Stream(Channel<T>* channel);
+		/** @brief Constructs a stream that failed with `status`. */
+		explicit Stream(result_t status);
+		/** @brief Finishes the stream with `status`, closing the connection
+		 * on failure. */
+		void finish(result_t status, Key::AcqT acq = 0);
+
+		/** @brief The channel, `nullptr` once the stream is finished. */
+		Channel<T>* mChannel;
+		/** @brief The record received last. */
+		Record<T> mRecord;
+		/** @brief The response. */
+		ResponseAcq mResponse;
+	};
+
 	/**
 	 * @brief Constructs a communication channel with a TStorage server under
 	 * a given address.
 	 *
-	 * @param hostname Hostname of the target TStorage server.
+	 * @param hostname Hostname of the target TStorage server, or
+	 * `unix:<path>` for a server on the same host listening on a Unix domain
+	 * socket bound to `<path>` (`unix:@<name>` for an abstract one). Such a
+	 * connection bypasses the TCP/IP stack.
 	 * @param port Port under which the TStorage server accepts connections.
+	 * Ignored for a Unix domain socket.
 	 *
 	 * @param payloadType A unique_ptr to a PayloadType instance. The ownership
 	 * of the underlying object is transferred to Channel. It's role is to
-	 * de-/serialize records' payloads.
+	 * de-/serialize records' payloads. A `TrivialPayloadType<T>` is handled
+	 * inline, without calls through the `PayloadType` interface.
 	 */
 	Channel(const std::string& hostname,
 		std::uint16_t port,
@@ -136,17 +344,23 @@ public:
 	 * @brief Establishes connection to the server.
 	 *
 	 * Attempts to connect to the TStorage server under the `hostname:port` pair
-	 * passed to the constructor of the channel and allocates all necessary
-	 * resources to support communications. If the connection is already
+	 * passed to the constructor of the channel and allocates the resources
+	 * to support communications, but for the internal buffers, which are
+	 * allocated by the first request using them (see `setMemoryLimit()`), so
+	 * that a failed allocation is reported by that request as
+	 * `result_t::OUT_OF_MEMORY`. If the connection is already
 	 * established, the call is silently ignored and a success code is
 	 * returned. On failure, returns an error code.
 	 *
+	 * Both IPv4 and IPv6 addresses of the server are tried, with staggered
+	 * parallel attempts (see `setAddressCacheTtl()`), all within the timeout
+	 * set with `setConnectTimeout()`.
+	 *
 	 * The possible error codes are:
 	 *  - `result_t::BAD_ADDRESS`
 	 *  - `result_t::CONNERROR`
 	 *  - `result_t::CONNREFUSED`
 	 *  - `result_t::CONNTIMEOUT`
-	 *  - `result_t::OUT_OF_MEMORY`
 	 *  - `result_t::SETOPT_ERROR`
 	 *  - `result_t::SIGNAL`
 	 *  - `result_t::SOCKET_ERROR`
@@ -173,26 +387,409 @@ public:
 	 * @return A `Response` instance with the status code of the executed operation.
 	 */
 	Response close();
+	/**
+	 * @brief Checks whether the channel is connected.
+	 *
+	 * A channel becomes connected after a successful `connect()` call, and
+	 * stays connected until it is closed, either explicitly with `close()` or
+	 * implicitly, when a request fails with an error.
+	 *
+	 * @return `true` if the connection is established, `false` otherwise.
+	 */
+	bool connected() const;
 	/**
 	 * @brief Sets the timeout for channel send/receive operations.
 	 *
 	 * @param timeout Timeout in milliseconds.
 	 */
 	void setTimeout(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the timeout for establishing a connection in `connect()`.
+	 *
+	 * Unlike the one of `setTimeout()`, this timeout applies to connecting
+	 * only, hence a short one may be used to fail over to another server
+	 * quickly without limiting the duration of large transfers.
+	 *
+	 * Defaults to 20 seconds.
+	 *
+	 * @param timeout Timeout in milliseconds, or `0` for none.
+	 */
+	void setConnectTimeout(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the time the resolved addresses of the server are reused
+	 * for by subsequent `connect()` calls.
+	 *
+	 * `connect()` resolves both the IPv4 and IPv6 addresses of the server and
+	 * races connection attempts to them, starting a new one every 250 ms, or
+	 * as soon as the previous one fails, so that an unreachable address
+	 * delays the connection by a fraction of a second rather than by the
+	 * whole timeout. The resolved addresses are then reused for `ttl`, which
+	 * saves the name resolution on reconnects. A `connect()` failing to reach
+	 * any of them, as well as `setHost()`, drops the cached addresses.
+	 *
+	 * Defaults to 30 seconds.
+	 *
+	 * @param ttl The time in milliseconds, or `0` to resolve the addresses on
+	 * each `connect()`.
+	 */
+	void setAddressCacheTtl(std::chrono::duration<std::int64_t, std::milli> ttl);
+	/**
+	 * @brief Sets the policy of retrying the requests which fail due to a
+	 * broken connection.
+	 *
+	 * A request failing with `result_t::CONNERROR`, `result_t::CONNRESET`,
+	 * `result_t::CONNCLOSED`, `result_t::CONNTIMEOUT` or
+	 * `result_t::NOT_CONNECTED` is reissued after the channel reconnects, with
+	 * exponential backoff between the attempts (see `RetryPolicy`). Only the
+	 * commands that are safe to repeat are retried:
+	 *  - `get()` and `getAcq()`,
+	 *  - `getStream()` and `getStreamColumnar()`, as long as no records have
+	 *    been passed to the callback yet (the records of a response come in no
+	 *    particular order, hence a stream cannot resume past them),
+	 *  - `put()` and `puta()` of a `RecordsSet<T>`, if `RetryPolicy::retryPuts`
+	 *    is set.
+	 *
+	 * Retries happen only on a channel opened with `connect()` and not closed
+	 * with `close()` since. The response of the last attempt is returned.
+	 *
+	 * Defaults to no retries.
+	 *
+	 * @param policy The new policy.
+	 */
+	void setRetryPolicy(const RetryPolicy& policy);
+	/**
+	 * @brief Sets the time a blocking receive busy polls the network device
+	 * before sleeping.
+	 *
+	 * Enables `SO_BUSY_POLL` on the channel's socket, which lowers the latency
+	 * of the responses at the cost of CPU time spent spinning while waiting
+	 * for them. Meant for latency-critical channels only.
+	 *
+	 * The change takes effect immediately if connected, and with each
+	 * following `connect()`. Raising the busy polling time above the
+	 * system-wide `net.core.busy_read` default requires the `CAP_NET_ADMIN`
+	 * capability; without it, `connect()` fails with
+	 * `result_t::SETOPT_ERROR`.
+	 *
+	 * Disabled by default.
+	 *
+	 * @param busyPoll Busy polling time in microseconds, or `0` to disable
+	 * busy polling.
+	 */
+	void setBusyPoll(std::chrono::duration<std::int64_t, std::micro> busyPoll);
+	/**
+	 * @brief Lets the channel wait for the bytes it is missing in a single
+	 * receive syscall.
+	 *
+	 * By default, each time the records already received run out, the channel
+	 * makes a receive syscall which returns as soon as any data arrives, which
+	 * for a response arriving slower than it is read means a syscall per few
+	 * segments. With a nonzero `limitBytes`, the channel raises the receive
+	 * low watermark (`SO_RCVLOWAT`) of its socket to the amount of bytes the
+	 * record being read is still missing, up to `limitBytes`, so that the
+	 * syscall returns only once all of them arrived. The watermark is never
+	 * larger than the amount of bytes missing, hence it does not delay the
+	 * responses, but changing it takes extra syscalls, which pay off for
+	 * records of a few KiB and more only.
+	 *
+	 * Use `receiveStats()` to compare the syscall counts of both strategies.
+	 *
+	 * Disabled by default.
+	 *
+	 * @param limitBytes The largest low watermark in bytes, or `0` to disable
+	 * it.
+	 */
+	void setReceiveLowWatermark(std::size_t limitBytes);
+	/**
+	 * @brief Enables or disables the io_uring I/O backend.
+	 *
+	 * With the backend on, the channel transfers data with io_uring
+	 * operations instead of the `send`/`recv` syscall family. The responses
+	 * of GET requests are received directly into the internal buffer, which
+	 * is registered with the kernel to spare mapping its pages on each
+	 * receive. Sends, receives and their timeouts report the same status
+	 * codes as without the backend.
+	 *
+	 * The backend is available only if the library is built with it (`make
+	 * IO_URING=1`), in which case it is enabled by default. The channel falls
+	 * back to plain syscalls if the backend is not built in, or the kernel
+	 * does not support io_uring. Registering the internal buffer may be
+	 * limited by `RLIMIT_MEMLOCK`, in which case the responses are received
+	 * without the registration.
+	 *
+	 * The change takes effect with the next `connect()`.
+	 *
+	 * @param enabled `true` to use io_uring if available, `false` otherwise.
+	 */
+	void setIoUring(bool enabled);
+	/**
+	 * @brief Enables or disables restarting the socket syscalls interrupted
+	 * by signals.
+	 *
+	 * A blocking send or receive interrupted by a signal handler fails even
+	 * if the handler is installed with `SA_RESTART`, since the socket has a
+	 * timeout. By default, the request then fails with `result_t::SIGNAL` and
+	 * the connection is dropped, so that e.g. attaching a sampling profiler,
+	 * which delivers `SIGPROF` many times a second, breaks connections at
+	 * random. With restarts enabled, an interrupted syscall is made again
+	 * instead, as long as the timeout (see `setTimeout()`), counted from the
+	 * start of the transfer, or the deadline of the request has not passed,
+	 * so that a steady stream of signals cannot keep a request from timing
+	 * out. Connects are restarted within the connect timeout; TLS handshakes
+	 * are not.
+	 *
+	 * Disabled by default, so that a signal can still be used to interrupt a
+	 * request blocked on the connection.
+	 *
+	 * The change takes effect instantaneously.
+	 *
+	 * @param enabled `true` to restart interrupted syscalls, `false` to fail
+	 * the requests with `result_t::SIGNAL`.
+	 */
+	void setSignalRestart(bool enabled);
+	/**
+	 * @brief Sets the TCP options of the connections established from now on.
+	 *
+	 * The options tune the channel's socket to the link and the traffic, e.g.
+	 * larger kernel buffers for large GETs over links with high latency, see
+	 * `SocketOptions`. A `connect()` whose options cannot be set fails with
+	 * `result_t::SETOPT_ERROR`.
+	 *
+	 * Defaults to `SocketOptions{}`.
+	 *
+	 * @param options The options.
+	 */
+	void setSocketOptions(const SocketOptions& options);
+	/**
+	 * @brief Sets the TLS options of the connections established from now on.
+	 *
+	 * With `options.enabled`, `connect()` performs a TLS handshake after
+	 * connecting and verifies the server's certificate, see `TlsOptions`.
+	 * Where the kernel supports it, the record layer is then handed over to
+	 * the kernel (kTLS), so that the requests are encrypted in place by the
+	 * send syscalls, vectored and io_uring ones included, with no copy into a
+	 * userspace TLS buffer. A failed handshake fails `connect()` with
+	 * `result_t::TLS_ERROR`, as does a library built without TLS.
+	 *
+	 * Defaults to `TlsOptions{}`, i.e. no TLS.
+	 *
+	 * @param options The options.
+	 */
+	void setTlsOptions(const TlsOptions& options);
+	/**
+	 * @brief Returns the receive syscall counters of the last request.
+	 *
+	 * The counters are zeroed whenever the channel sends a request, hence
+	 * after a `get()`, `getStream()` or `getAcq()` call they describe the
+	 * receipt of its response. For pipelined requests, they cover all of the
+	 * responses read since the requests were flushed.
+	 *
+	 * @return The receive counters.
+	 */
+	ReceiveStats receiveStats() const;
+	/**
+	 * @brief Returns the counters of the work done by the channel since its
+	 * construction.
+	 *
+	 * The counters cover the traffic of the channel's socket, the packing of
+	 * PUT/A records into batches and buffers, the buffers allocated, and the
+	 * latencies, syscalls and allocations of the requests by command, see
+	 * `ChannelStats`. They are kept at the cost of a few plain increments per
+	 * syscall and request, and unlike the rest of the channel, this method may
+	 * be called from any thread, e.g. by a monitoring one, while the channel is
+	 * in use. A snapshot taken then may miss some of the counts of the request
+	 * in progress.
+	 *
+	 * The allocations of the records containers are counted by passing a
+	 * `CountingAllocator` to `get()` or `getStream()`.
+	 *
+	 * The counters are never reset; subtract two snapshots to measure an
+	 * interval.
+	 *
+	 * @return A snapshot of the counters.
+	 */
+	ChannelStats stats() const;
+	/**
+	 * @brief Sets the tracer receiving the timings of the channel's connects
+	 * and requests.
+	 *
+	 * Each completed request is reported to the tracer with the times of its
+	 * protocol phases: sending the request, waiting for the response, reading
+	 * the records and reading the result, see `RequestTrace`. This tells the
+	 * network, the server and the deserialization of the payloads apart in the
+	 * latency of a slow request. Without a tracer, the channel takes no
+	 * timings at all, and a library built with `make NO_TRACING=1` does not
+	 * even check for one.
+	 *
+	 * Disabled by default.
+	 *
+	 * @param tracer The tracer, or `nullptr` to disable tracing.
+	 */
+	void setTracer(std::shared_ptr<Tracer> tracer);
+	/**
+	 * @brief Sets the amount of threads deserializing the records of GET
+	 * responses.
+	 *
+	 * For costly payload codecs (e.g. JSON or protobuf), deserializing the
+	 * records on the thread reading them from the socket leaves the network
+	 * idle. With decoding threads, the reading thread only frames the records,
+	 * copying their keys and raw payloads into chunks of up to
+	 * `cDecodeChunkRecords` records, and hands the chunks over to a
+	 * work-stealing pool of `threads` threads calling
+	 * `PayloadType::fromBytes()`. Once the response has been read, the reading
+	 * thread joins the pool in decoding the remaining chunks, and the records
+	 * are appended to the set in the order of the response.
+	 *
+	 * Applies to `get()`, `getStream()` and their columnar variants, but not
+	 * to the records sets placed in arenas nor to `TrivialPayloadType<T>`,
+	 * whose payloads are cheaper to decode than to copy. The payload type's
+	 * `fromBytes()` has to be safe to call from several threads at once.
+	 *
+	 * Disabled (`0`) by default.
+	 *
+	 * @param threads The amount of decoding threads, `0` to decode the records
+	 * on the thread reading them.
+	 */
+	void setDecodeThreads(std::size_t threads);
+	/** @brief Returns the amount of decoding threads, `0` if disabled. */
+	std::size_t decodeThreads() const;
+	/**
+	 * @brief Sets the amount of threads serializing the records of PUT/A
+	 * requests.
+	 *
+	 * For costly payload codecs, serializing the records one by one on the
+	 * calling thread bounds the ingest by a single core. With encoding
+	 * threads, `put()` and `puta()` of a `RecordsSet<T>` larger than
+	 * `cEncodeSliceRecords` split it into contiguous slices of that many
+	 * records, each serialized by a work-stealing pool of `threads` threads
+	 * into a chunk of its own, batch headers included. The calling thread
+	 * helps serializing and then sends the chunks in the order of the records
+	 * with vectored writes. The records are processed in rounds of up to
+	 * `cEncodeSlicesPerThread` slices per thread, which bounds the memory held
+	 * by the chunks. A single record is still bound by the memory limit.
+	 *
+	 * Does not apply to `TrivialPayloadType<T>`, to the iterator-based and
+	 * generator-based variants of `put()`, nor to `putStream()`. Batch
+	 * coalescing (see `setPutBatchCoalescing()`) doesn't merge batches across
+	 * chunks. The payload type's `sizeHint()`, `toBytes()` and `toView()` have
+	 * to be safe to call from several threads at once.
+	 *
+	 * Disabled (`0`) by default.
+	 *
+	 * @param threads The amount of encoding threads, `0` to serialize the
+	 * records on the calling thread.
+	 */
+	void setEncodeThreads(std::size_t threads);
+	/** @brief Returns the amount of encoding threads, `0` if disabled. */
+	std::size_t encodeThreads() const;
+	/**
+	 * @brief Sets the amount of batches `getStream()` receives ahead of the
+	 * callback.
+	 *
+	 * By default, receiving a batch and passing it to the callback alternate,
+	 * so that nothing drains the socket while the callback runs: the TCP
+	 * window closes and the server stalls. With prefetching, a reader thread
+	 * receives and deserializes the batches into a queue of up to `batches`
+	 * sets while the calling thread passes them to the callback, and the
+	 * throughput of the stream becomes that of the slower of the two rather
+	 * than the sum of their times. The sets are recycled once the callback
+	 * returns.
+	 *
+	 * Each batch holds the records of at most one buffer of the size set by
+	 * `setMemoryLimit()`, so the records waiting in the queue take roughly up
+	 * to `batches` times the memory limit, plus their deserialization
+	 * overhead.
+	 *
+	 * Applies to `getStream()`, `getStreamColumnar()`, `getStreamBlob()` and
+	 * `getStreamArrow()`, but not to the streams into arena sets, which recycle a single arena.
+	 * The callback runs on the calling thread and must not use the channel.
+	 * The payload type is used by the reader thread only.
+	 *
+	 * Disabled (`0`) by default.
+	 *
+	 * @param batches The maximal amount of batches received ahead, `0` to
+	 * receive each batch once the callback has returned.
+	 */
+	void setStreamPrefetch(std::size_t batches);
+	/**
+	 * @brief Sets when `getStream()` passes a batch to the callback, other
+	 * than once the receive buffer is full or the response ends.
+	 *
+	 * Interactive consumers set `StreamBatching::maxDelayMs` to see the
+	 * records soon after they arrive, however slowly the server sends them,
+	 * or `StreamBatching::maxRecords` to bound the work per callback. Bulk
+	 * consumers keep the default, which makes the batches as large as the
+	 * memory limit allows, or set `StreamBatching::minRecords` along with the
+	 * delay. The delay is measured on the channel's side, so a batch may also
+	 * be cut short by a pause of the server, and is waited for only while no
+	 * complete record is buffered.
+	 *
+	 * Applies to the same streams as `setStreamPrefetch()`, and to the
+	 * streams into arena sets. With prefetching, the callback may see a batch
+	 * later than the policy delivers it, once the batches ahead of it have
+	 * been passed on.
+	 *
+	 * @param batching The policy. The default one delivers the batches only
+	 * once the buffer is full or the response ends.
+	 */
+	void setStreamBatching(const StreamBatching& batching);
+	/**
+	 * @brief Sets a handler of the GET records which don't fit in the receive
+	 * buffer, making the channel skip them instead of failing the query.
+	 *
+	 * By default, a record larger than the receive buffer can grow to (see
+	 * `setReceiveMemoryLimit()` and `setReceiveBufferGrowth()`) fails the query
+	 * with `result_t::MEMORY_LIMIT_EXCEEDED`, and the connection is closed, so
+	 * that the rest of the response is lost along with it. With a handler set,
+	 * the payload of such a record is discarded as it arrives instead, the
+	 * handler is passed its key and payload size, and the query goes on with
+	 * the next record. The response succeeds without the skipped records; the
+	 * caller can fetch them later, e.g. through a channel with a larger limit.
+	 *
+	 * Applies to all GET methods, `getStream()` and `replicate()`. The records
+	 * of payload types deserialized in chunks (see `PayloadType::chunked()`)
+	 * are never skipped by the methods returning typed records, which read
+	 * them in chunks. The handler runs on the thread reading the response and
+	 * must not use the channel.
+	 *
+	 * @param handler The handler, or an empty function to fail the queries
+	 * again.
+	 */
+	void setOversizedRecordHandler(
+		const std::function<void(const Key& key, std::size_t payloadSize)>& handler);
+	/**
+	 * @brief Sets whether `get()` counts the records of a key-interval with
+	 * `countRange()` before fetching them, when no earlier response of its
+	 * width is known.
+	 *
+	 * The count transfers the keys of the records only, and lets `get()`
+	 * reserve their container exactly, instead of growing it as they arrive,
+	 * which moves the records received so far each time. It costs a round
+	 * trip, paid off by large responses of large payload types, and is made
+	 * once per width of key-interval, whose later responses are predicted
+	 * from the history. A failed count leaves the container unreserved. By
+	 * default, no count is made.
+	 *
+	 * @param enabled `true` to count the records of unknown key-intervals.
+	 */
+	void setCountBeforeGet(bool enabled);
 	/**
 	 * @brief Sets the maximal memory usage of the channel.
 	 *
 	 * Use this setting to limit memory usage of a given Channel<T> instance.
-	 * Each Channel<T> object uses a heap-allocated internal buffer for data
-	 * de-/serialization, the maximal size of which is controlled by the
-	 * `memoryLimitBytes` parameter. By default, the buffer's size is 64KiB.
+	 * Each Channel<T> object uses two heap-allocated internal buffers, one for
+	 * serializing requests and one for receiving responses, the maximal size
+	 * of each of which is set to `memoryLimitBytes` by this method. By
+	 * default, each buffer's size is 64KiB. The sizes can be set apart with
+	 * `setSendMemoryLimit()` and `setReceiveMemoryLimit()`.
 	 *
 	 * - For `get()` requests: a response exceeding the maximal internal buffer's
 	 * capacity in size is cut short and the connection is broken to save
 	 * bandwidth.
 	 *
 	 * - For `getStream()` requests: a response is split into chunks of size not
-	 * exceeding the maximal capacity of the Channel's internal buffer.
+	 * exceeding the maximal capacity of the Channel's internal buffer, or
+	 * smaller ones (see `setStreamBatching()`).
 	 *
 	 * This setting also limits the size of internal buffers used by `put()` and
 	 * `puta()` operations. This does not limit the amount of records sent during
@@ -215,6 +812,334 @@ public:
 	 * @param memoryLimitBytes New memory limit in bytes.
 	 */
 	void setMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the size of the internal buffer requests are serialized
+	 * into, leaving that of the receive buffer.
+	 *
+	 * It bounds the size of a single PUT/A record, and the size of the
+	 * chunks a PUT/A request is sent in (see `setMemoryLimit()`). A
+	 * PUT-heavy channel sends large batches in fewer syscalls with a large
+	 * send buffer, while a channel sending only GET and GETACQ requests,
+	 * which take under 100 bytes each, does with the minimal one.
+	 *
+	 * The buffer is allocated by the first request after `connect()`, not by
+	 * `connect()` itself, and released by `close()`.
+	 *
+	 * @see setMemoryLimit()
+	 *
+	 * @param memoryLimitBytes The size of the send buffer in bytes.
+	 */
+	void setSendMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the size of the internal buffer responses are received
+	 * into, leaving that of the send buffer.
+	 *
+	 * It bounds the size of a `get()` response and of the batches of
+	 * `getStream()` (see `setMemoryLimit()`). A channel sending mostly PUT/A
+	 * requests or `getAcq()` queries, whose responses take a few dozen bytes,
+	 * does with the minimal one.
+	 *
+	 * The buffer is allocated by the first response after `connect()`, not by
+	 * `connect()` itself, and released by `close()`. Since the two buffers are
+	 * separate, responses received ahead are kept while requests are sent.
+	 *
+	 * @see setMemoryLimit()
+	 * @see setReceiveBufferGrowth()
+	 *
+	 * @param memoryLimitBytes The size of the receive buffer in bytes.
+	 */
+	void setReceiveMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Lets the internal buffer grow beyond the memory limit while
+	 * receiving records too large for it.
+	 *
+	 * By default, a received record larger than the internal buffer fails the
+	 * request with `result_t::MEMORY_LIMIT_EXCEEDED`, so the memory limit has
+	 * to accommodate the largest payload expected, even if most are small.
+	 * With growth enabled, a record larger than the memory limit makes the
+	 * channel double the capacity of the buffer until the record fits, but not
+	 * beyond `maxMemoryLimitBytes`, and move the records already deserialized
+	 * out of the way. Once the response is read, and at the latest when the
+	 * next request is started, the buffer is shrunk back to the memory limit.
+	 *
+	 * Records not larger than the memory limit are received as before: a
+	 * `get()` response of such records exceeding the memory limit still fails,
+	 * and `getStream()` batches end once they fill the buffer, which, while
+	 * grown, lets them be larger. PUT/A requests are not affected.
+	 *
+	 * Disabled by default. Values of `maxMemoryLimitBytes` not greater than the
+	 * memory limit disable the growth.
+	 *
+	 * @see setMemoryLimit()
+	 *
+	 * @param maxMemoryLimitBytes The largest capacity of the internal buffer, or
+	 * `0` to disable the growth.
+	 */
+	void setReceiveBufferGrowth(std::size_t maxMemoryLimitBytes);
+	/**
+	 * @brief Lets the channel size its buffers to the bandwidth-delay product
+	 * of its connection, as measured on the fly.
+	 *
+	 * A memory limit fit for a LAN starves a link with high latency, where a
+	 * buffer's worth of data takes a round trip to acknowledge, while one fit
+	 * for such a link wastes memory on a LAN. With the tuning enabled, the
+	 * channel times each transfer, from the first request it sends while idle
+	 * until it is idle again, keeps the peak rate, decayed over the following
+	 * transfers, as the bandwidth, and reads the round-trip time smoothed by
+	 * the kernel (`TCP_INFO`). Once idle, it sizes the send and receive
+	 * buffers to twice their product, rounded up to a power of two, so that a
+	 * transfer limited by the buffers still shows there is room to grow.
+	 *
+	 * The sizes are capped by `tuning.maxBytes`, and never fall below the
+	 * memory limits (see `setMemoryLimit()`), which thus become the smallest
+	 * sizes. The buffers grow right away, but shrink only once the product
+	 * falls to a quarter of their size. Since the receive buffer bounds a
+	 * `get()` response and the batches of `getStream()`, tuned buffers let
+	 * them grow as well. With `tuning.socketBuffers`, the kernel buffers of
+	 * the connection (`SO_SNDBUF` and `SO_RCVBUF`) are sized alike, within
+	 * the system limits, which disables the kernel's own autotuning of them.
+	 *
+	 * Transfers of less than 16 KiB are not sampled, and connections over
+	 * Unix domain sockets are not tuned. Disabled by default; disabling it
+	 * sizes the buffers back to the memory limits, while the kernel buffers
+	 * stay tuned until the next connection. The current estimate is reported
+	 * by `stats()`.
+	 *
+	 * @see setMemoryLimit()
+	 * @see setSocketOptions()
+	 *
+	 * @param tuning The bounds of the tuning.
+	 */
+	void setBufferAutoTuning(const BufferAutoTuning& tuning);
+	/**
+	 * @brief Lets the channel slow PUT/A requests down as soon as the server
+	 * falls behind, rather than once they time out.
+	 *
+	 * Two signals tell that the server falls behind: a flush of the send
+	 * buffer blocking for longer than `options.sendBlockMs`, as the socket
+	 * buffers are full, and the result of a command taking longer than
+	 * `options.ackLatencyMs` to arrive. Both default to fractions of the
+	 * timeout (see `setTimeout()`). On either signal, the channel halves the
+	 * rate it sends the buffers at, starting from the rate it achieved so
+	 * far, and the amount of buffers a command may take. While no signal
+	 * comes, the rate grows by `options.minRateBytes` every 100 ms and each
+	 * timely result lets commands take one buffer more, until either is four
+	 * times its value after the last back-off and no longer bounded.
+	 *
+	 * A `put()` or `puta()` which would take more buffers than a command may
+	 * is split into several commands, each ended and acknowledged before the
+	 * next starts. Should one of them fail, the records of those acknowledged
+	 * before it are stored, and a retry (see `setRetryPolicy()`) sends them
+	 * anew. Records encoded on the encoding threads (see
+	 * `setEncodeThreads()`) or sent by `putFromFile()` go out in a single
+	 * send, which is neither paced nor split, though the result of its
+	 * command still counts.
+	 *
+	 * Disabled by default. The current rate, the bound of the command size
+	 * and the count of back-offs are reported by `stats()`.
+	 *
+	 * @see setMemoryLimit()
+	 *
+	 * @param options The settings of the flow control.
+	 */
+	void setPutFlowControl(const PutFlowControl& options);
+	/**
+	 * @brief Makes `puta()` skip the records whose earlier PUTA has been
+	 * acknowledged by the server, so that a replay after a partial failure
+	 * sends only the records not stored yet.
+	 *
+	 * A PUTA stores its records anew every time it is sent, so that a job
+	 * re-sending a whole range after a failure duplicates the part stored
+	 * before it. With a filter, each record is fingerprinted from its key,
+	 * ACQ included, and serialized payload as it is written; a record whose
+	 * fingerprint the filter holds is skipped, and the fingerprints of the
+	 * records of a command are added to the filter once the server
+	 * acknowledges it. Retries (see `setRetryPolicy()`) and commands split by
+	 * the flow control (see `setPutFlowControl()`) thus resend only the
+	 * records of the commands not acknowledged. A record sent twice within
+	 * one command is not filtered.
+	 *
+	 * The filter may be shared by the channels of a job and saved with its
+	 * state (see `PutDedupFilter::save()`). Records encoded on the encoding
+	 * threads (see `setEncodeThreads()`) or sent by `putaFromFile()` are not
+	 * filtered, and neither is `put()`, the records of which get the ACQ of
+	 * their arrival, so that a replayed record is a newer version of itself
+	 * rather than a duplicate. The amount of records skipped is reported by
+	 * `stats()`. By default, a channel has no filter.
+	 *
+	 * @see PutDedupFilter
+	 *
+	 * @param filter The filter, or `nullptr` for none.
+	 */
+	void setPutDedupFilter(std::shared_ptr<PutDedupFilter> filter);
+	/**
+	 * @brief Lets the channel give its buffers up while it is idle, keeping
+	 * the connection open.
+	 *
+	 * By default, the send and the receive buffer, once allocated, are held
+	 * until `close()`, so a process with many mostly idle channels holds the
+	 * full memory limit of each. With the release enabled, the buffers go to
+	 * a pool shared by the channels of the process once a command has been
+	 * read to its end and no other request is in flight, and the next request
+	 * takes buffers of the same sizes from the pool, allocating them only if
+	 * it has none. The resident memory then follows the requests in flight,
+	 * plus what the pool keeps (see `setBufferPoolLimit()`).
+	 *
+	 * With an `idle` of `0`, the buffers are released right after each
+	 * command. With a positive `idle`, they are released by a background
+	 * thread once the channel has made no request for that long, so that a
+	 * busy channel keeps reusing its own. Negative values disable the release.
+	 *
+	 * The extra send buffers of a pipelined `put()` (see
+	 * `setPutPipelineDepth()`) are kept until `close()` regardless.
+	 *
+	 * @param idle The time a channel stays idle for before its buffers are
+	 * released, `0` to release them after each command, or negative to keep
+	 * them until `close()`.
+	 */
+	void setBufferRelease(std::chrono::duration<std::int64_t, std::milli> idle);
+	/**
+	 * @brief Sets the amount of memory the buffer pool shared by all channels
+	 * of the process keeps for reuse.
+	 *
+	 * Buffers released by channels (see `setBufferRelease()`) past the limit
+	 * are freed. 256 MiB by default.
+	 *
+	 * @param limitBytes The limit in bytes, `0` to free every released buffer.
+	 */
+	static void setBufferPoolLimit(std::size_t limitBytes);
+	/**
+	 * @brief Sets the huge pages and the NUMA node of the send and receive
+	 * buffers.
+	 *
+	 * Large buffers backed with huge pages take a fraction of the TLB entries
+	 * of regular ones. Binding them to `BufferAllocation::cThreadNode` keeps
+	 * them on the NUMA node of the thread using the channel, also after they
+	 * have gone through the buffer pool (see `setBufferRelease()`), which
+	 * sorts the buffers by node. The buffers allocated already are released,
+	 * and allocated anew by the next request which uses them.
+	 *
+	 * The placement is a request: huge pages or nodes the system cannot
+	 * provide make the buffers fall back to regular pages placed by the
+	 * system.
+	 *
+	 * @param allocation The allocation of the buffers.
+	 */
+	void setBufferAllocation(const BufferAllocation& allocation);
+	/**
+	 * @brief Makes the internal buffers draw their memory from a budget
+	 * shared with other channels.
+	 *
+	 * Each buffer draws quota for its capacity before it is allocated, and
+	 * gives it back when the channel lets it go, on `close()`, on a change of
+	 * its size, or once a command is done if the buffer release is enabled
+	 * (see `setBufferRelease()`). A request finding the budget spent waits
+	 * for quota, up to the timeout (see `setTimeout()`), and fails with
+	 * `result_t::OUT_OF_MEMORY` after that. While the budget is under
+	 * pressure, the receive buffer does not grow for records larger than
+	 * the memory limit (see `setReceiveBufferGrowth()`), and `put()` flushes
+	 * its buffers synchronously, giving the quota of the spare pipeline
+	 * buffers back (see `setPutPipelineDepth()`).
+	 *
+	 * The buffers held are released, giving their quota back to the former
+	 * budget. By default, a channel has no budget.
+	 *
+	 * @see MemoryBudget
+	 *
+	 * @param budget The budget, or `nullptr` for none.
+	 */
+	void setMemoryBudget(std::shared_ptr<MemoryBudget> budget);
+	/**
+	 * @brief Sets the amount of internal send buffers used by `put()` and
+	 * `puta()`.
+	 *
+	 * By default (`depth == 1`), whenever the internal buffer fills up during a
+	 * PUT/A request, the channel stops serializing records until the whole
+	 * buffer is written to the socket. With `depth >= 2`, the full buffer is
+	 * handed over to a background thread instead, and serialization continues
+	 * into one of the remaining `depth - 1` buffers, overlapping the CPU work
+	 * with network transfers. This is most beneficial for large requests
+	 * spanning many buffer flushes.
+	 *
+	 * The batching and memory limit semantics of `put()` and `puta()` stay
+	 * the same: each buffer has the size set by `setMemoryLimit()` and every
+	 * record must fit in one of them. Note, however, that the channel's total
+	 * memory usage during a PUT/A request may grow up to `depth` times the
+	 * memory limit. The buffers other than the primary one, as well as the
+	 * background thread, are released on `close()`.
+	 *
+	 * In pipelined mode, a send error might be reported by `put()` some time
+	 * after the failed write, though it is always reported by the request
+	 * during which it occurred.
+	 *
+	 * @param depth The total amount of send buffers. Values lower than `1` are
+	 * treated as `1`.
+	 */
+	void setPutPipelineDepth(std::size_t depth);
+	/**
+	 * @brief Enables or disables grouping of records by CID in `put()` and
+	 * `puta()` called with a `RecordsSet<T>`.
+	 *
+	 * The PUT/A protocol sends records in batches of consecutive records
+	 * sharing the same CID, each batch preceded by its own header. If the
+	 * records of a set interleave many CIDs, almost every record ends up in a
+	 * batch of its own. With grouping enabled, the records are sent ordered by
+	 * their CIDs instead, so that each buffer holds at most one batch per CID.
+	 * Records sharing a CID keep their relative order. The reordering sorts
+	 * pointers to the records, the records themselves are not copied; the
+	 * pointer array is kept for reuse by later requests.
+	 *
+	 * Note that with grouping enabled, the records preceding an invalid one
+	 * (see `put()`) are the ones preceding it in the CID order.
+	 *
+	 * Disabled by default. Has no effect on other PUT/A methods.
+	 *
+	 * @param enabled `true` to group the records by CID, `false` to send them
+	 * in their original order.
+	 */
+	void setPutCidGrouping(bool enabled);
+	/** @brief Returns `true` if `put()` and `puta()` group the records by
+	 * CID. */
+	bool putCidGrouping() const;
+	/**
+	 * @brief Enables or disables validating all keys of a `RecordsSet<T>` in
+	 * bulk before `put()` and `puta()` send it.
+	 *
+	 * By default, the key of each record is checked right before the record
+	 * is serialized (see `put()`). With bulk validation enabled, the keys of
+	 * the whole set are checked up front in a single tight loop, which the
+	 * compiler can vectorize, and the records are then serialized without
+	 * per-record key checks. This pays off for small payloads, where the
+	 * checks are a noticeable share of the per-record cost. If any key is
+	 * invalid, the set is sent with per-record checks as usual, so that the
+	 * outcome of the request doesn't depend on this setting.
+	 *
+	 * Disabled by default. Has no effect on other PUT/A methods.
+	 *
+	 * @param enabled `true` to validate the keys in bulk, `false` to validate
+	 * them record by record.
+	 */
+	void setPutBulkKeyValidation(bool enabled);
+	/**
+	 * @brief Enables or disables merging of batches sharing a CID inside each
+	 * send buffer of a PUT/A request.
+	 *
+	 * Records are written to the send buffer in the order they come, starting
+	 * a new batch, with its own header, whenever the CID changes. With
+	 * coalescing enabled, right before a buffer is sent, the batches it holds
+	 * are rearranged into a single batch per CID, records with the same CID
+	 * keeping their relative order. Interleaved records thus need as few batch
+	 * headers per buffer as records ordered by CID, without reordering them
+	 * up front (compare `setPutCidGrouping()`). It costs a copy of each
+	 * buffer holding interleaved CIDs, into a second buffer of the same size
+	 * that is kept until `close()`.
+	 *
+	 * Applies to all PUT/A methods, including `PutStream<T>`. Disabled by
+	 * default.
+	 *
+	 * @param enabled `true` to merge the batches, `false` otherwise.
+	 */
+	void setPutBatchCoalescing(bool enabled);
 
 	/**
 	 * @brief Stores a given set of records in a TStorage instance.
@@ -249,6 +1174,13 @@ public:
 	 * with the `result_t::MEMORY_LIMIT_EXCEEDED` error code is returned. See
 	 * `setMemoryLimit()` for details.
 	 *
+	 * If the `PayloadType` exposes the serialized payload through
+	 * `PayloadType::toView()`, large payloads are sent directly from the
+	 * user's memory, without being copied to the internal buffer, and are
+	 * not bound by its capacity. Payloads of chunked payload types (see
+	 * `PayloadType::chunked()`) which don't fit in the buffer are sent
+	 * through it in pieces, serialized by `PayloadType::toChunk()`.
+	 *
 	 * The connection to TStorage must be established (see `connect()`) for the
 	 * `put()` request to succeed. Otherwise, the method will return an error
 	 * response with `result_t::NOT_CONNECTED`.
@@ -277,6 +1209,19 @@ public:
 	 * @return A `Response` instance with the status code of the executed operation.
 	 */
 	Response put(const RecordsSet<T>& data);
+	/**
+	 * @brief Stores a given set of records like `put()`, within a deadline.
+	 *
+	 * The deadline bounds the request as a whole, see `get(const Key&, const
+	 * Key&, std::chrono::steady_clock::time_point)`.
+	 *
+	 * The possible error codes are those of `put()`.
+	 *
+	 * @param data A set of valid records to store in the TStorage instance.
+	 * @param deadline The point in time by which the request has to complete.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	Response put(const RecordsSet<T>& data, std::chrono::steady_clock::time_point deadline);
 	/**
 	 * @brief Stores a given set of records in a TStorage instance with
 	 * user-supplied acquisition times (ACQ).
@@ -317,7 +1262,8 @@ public:
 	 * On the event when the method attempts to serialize a record with size
 	 * exceeding the buffer's capacity, the operation is aborted and a `Response`
 	 * with the `result_t::MEMORY_LIMIT_EXCEEDED` error code is returned. See
-	 * `setMemoryLimit()` for details.
+	 * `setMemoryLimit()` for details. Payloads exposed through
+	 * `PayloadType::toView()` are treated in the same way as in `put()`.
 	 *
 	 * The connection to TStorage must be established (see `connect()`) for the
 	 * `put()` request to succeed. Otherwise, the method will return an error
@@ -347,6 +1293,179 @@ public:
 	 * @return A `Response` instance with the status code of the executed operation.
 	 */
 	Response puta(const RecordsSet<T>& data);
+	/**
+	 * @brief Stores a given set of records like `puta()`, within a deadline.
+	 *
+	 * The deadline bounds the request as a whole, see `get(const Key&, const
+	 * Key&, std::chrono::steady_clock::time_point)`.
+	 *
+	 * The possible error codes are those of `puta()`.
+	 *
+	 * @param data A set of valid records to store in the TStorage instance.
+	 * @param deadline The point in time by which the request has to complete.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	Response puta(const RecordsSet<T>& data, std::chrono::steady_clock::time_point deadline);
+	/**
+	 * @brief Stores a range of records in a TStorage instance.
+	 *
+	 * Behaves as `put()` called with a `RecordsSet<T>` holding the records
+	 * of the range `[first, last)`, but serializes each record straight from
+	 * the range, so the records don't have to be gathered in a container
+	 * first.
+	 *
+	 * @tparam InputIt An input iterator type dereferencing to `Record<T>`.
+	 * @param first The beginning of the range of records to store.
+	 * @param last The end of the range of records to store.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	template<typename InputIt>
+	Response put(InputIt first, InputIt last);
+	/**
+	 * @brief Stores a range of records in a TStorage instance with
+	 * user-supplied acquisition times (ACQ).
+	 *
+	 * The `puta()` counterpart of `put(InputIt, InputIt)`.
+	 *
+	 * @tparam InputIt An input iterator type dereferencing to `Record<T>`.
+	 * @param first The beginning of the range of records to store.
+	 * @param last The end of the range of records to store.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	template<typename InputIt>
+	Response puta(InputIt first, InputIt last);
+	/**
+	 * @brief Stores records produced on the fly in a TStorage instance.
+	 *
+	 * Behaves as `put()`, except that the records are obtained by calling
+	 * `generator` repeatedly until it returns `false`. Each record is
+	 * serialized as soon as it is produced, hence the memory used by the
+	 * operation doesn't depend on the amount of records sent. This suits
+	 * sources like files or message queues, which would otherwise have to be
+	 * copied to a `RecordsSet<T>` in full before sending.
+	 *
+	 * The generator is handed the same `Record<T>` object on each call and
+	 * should overwrite it with the next record, so that e.g. the capacity of
+	 * a string payload can be reused. The object is not used by the channel
+	 * once the next call to `generator` begins. On error, `generator` is not
+	 * called anymore and the remaining records are not sent.
+	 *
+	 * @param generator A function storing the next record in its argument and
+	 * returning `true`, or returning `false` once there are no more records.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	Response putFrom(const std::function<bool(Record<T>&)>& generator);
+	/**
+	 * @brief Stores records produced on the fly in a TStorage instance with
+	 * user-supplied acquisition times (ACQ).
+	 *
+	 * The `puta()` counterpart of `putFrom()`.
+	 *
+	 * @param generator A function storing the next record in its argument and
+	 * returning `true`, or returning `false` once there are no more records.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	Response putaFrom(const std::function<bool(Record<T>&)>& generator);
+	/**
+	 * @brief Stores records with already serialized payloads in a TStorage
+	 * instance.
+	 *
+	 * Behaves as `put(InputIt, InputIt)`, except that the payloads are sent as
+	 * given, bypassing `PayloadType` altogether. This suits producers already
+	 * holding the encoded payloads, e.g. as received from a message queue,
+	 * which would otherwise have to decode them into `T` values only for
+	 * `PayloadType::toBytes()` to encode them again.
+	 *
+	 * The payloads are handled as those exposed by `PayloadType::toView()`:
+	 * small ones are copied to the internal buffer once, large ones are sent
+	 * directly from the user's memory.
+	 *
+	 * @tparam InputIt An input iterator type dereferencing to `RawRecord`,
+	 * e.g. a `const RawRecord*`.
+	 * @param first The beginning of the range of records to store.
+	 * @param last The end of the range of records to store.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	template<typename InputIt>
+	Response putRaw(InputIt first, InputIt last);
+	/**
+	 * @brief Stores records with already serialized payloads in a TStorage
+	 * instance with user-supplied acquisition times (ACQ).
+	 *
+	 * The `puta()` counterpart of `putRaw()`.
+	 *
+	 * @tparam InputIt An input iterator type dereferencing to `RawRecord`.
+	 * @param first The beginning of the range of records to store.
+	 * @param last The end of the range of records to store.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	template<typename InputIt>
+	Response putaRaw(InputIt first, InputIt last);
+	/**
+	 * @brief Stores records already serialized in a file, e.g. a dump of
+	 * earlier requests, in a TStorage instance.
+	 *
+	 * The file holds the body of a PUT request, i.e. a sequence of batches as
+	 * sent by `put()`: each batch is the CID of its records and the size of
+	 * the rest of the batch (both 4-byte), followed by the records, each of
+	 * which is its size (4 bytes, excluding itself), the MID, MOID and CAP,
+	 * and the payload, all in the host's byte order. The channel sends the
+	 * request header, then the `length` bytes at `offset` with `sendfile()`,
+	 * straight from the page cache to the socket without a userspace copy,
+	 * and finishes the request with the end-of-stream marker.
+	 *
+	 * The batches are sent as they are, unvalidated: malformed ones are
+	 * rejected by the server, failing the request with `result_t::ERROR`.
+	 * The file offset of `fd` is left unchanged. If the file cannot be read,
+	 * or ends before `length` bytes, the request fails with
+	 * `result_t::FILE_ERROR` and the connection is dropped, as the server has
+	 * received a part of the request.
+	 *
+	 * @param fd A file open for reading, e.g. a regular file.
+	 * @param offset The offset of the first batch in the file.
+	 * @param length The size of the batches in bytes.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	Response putFromFile(int fd, std::uint64_t offset, std::uint64_t length);
+	/**
+	 * @brief Stores records already serialized in a file in a TStorage
+	 * instance with user-supplied acquisition times (ACQ).
+	 *
+	 * The `puta()` counterpart of `putFromFile()`: the key of each record
+	 * holds the ACQ as well, following the CAP.
+	 *
+	 * @param fd A file open for reading, e.g. a regular file.
+	 * @param offset The offset of the first batch in the file.
+	 * @param length The size of the batches in bytes.
+	 * @return A `Response` instance with the status code of the executed operation.
+	 */
+	Response putaFromFile(int fd, std::uint64_t offset, std::uint64_t length);
+	/**
+	 * @brief Starts a PUT request which stays open across many appends.
+	 *
+	 * Sends the header of a PUT command and returns a `PutStream<T>` handle
+	 * appending records to it, see `PutStream<T>` for details. Records are
+	 * treated as in `put()`. Until the stream is finished, the channel must not
+	 * be used for other commands.
+	 *
+	 * If the command cannot be started, e.g. with `result_t::NOT_CONNECTED`,
+	 * the returned stream is closed and its calls report the error code.
+	 *
+	 * @param linger The longest time a record is buffered before being sent.
+	 * @return A handle to the open PUT request.
+	 */
+	PutStream<T> putStream(
+		std::chrono::duration<std::int64_t, std::milli> linger = std::chrono::milliseconds(5));
+	/**
+	 * @brief Starts a PUTA request which stays open across many appends.
+	 *
+	 * The `puta()` counterpart of `putStream()`.
+	 *
+	 * @param linger The longest time a record is buffered before being sent.
+	 * @return A handle to the open PUTA request.
+	 */
+	PutStream<T> putaStream(
+		std::chrono::duration<std::int64_t, std::milli> linger = std::chrono::milliseconds(5));
 	/**
 	 * @brief Retrieves a set of records from a TStorage instance.
 	 *
@@ -374,7 +1493,11 @@ public:
 	 * exceeds the memory limit set by the call to
 	 * `Channel<T>::setMemoryLimit()`. This event is treated as an error. In this
 	 * case, the GET operation is aborted and, the corresponding error code
-	 * returned in `ResponseGet<T>` is `result_t::MEMORY_LIMIT_EXCEEDED`.
+	 * returned in `ResponseGet<T>` is `result_t::MEMORY_LIMIT_EXCEEDED`. Single
+	 * records larger than the memory limit can be let through with
+	 * `Channel<T>::setReceiveBufferGrowth()`, or, with a payload type which
+	 * deserializes in chunks (see `PayloadType::chunked()`), through the
+	 * buffer in chunks.
 	 *
 	 * This method assumes that all records within the specified key-interval
 	 * have payloads with the same data type, meaning that they are deserialized
@@ -405,6 +1528,14 @@ public:
 	 * `put()` request to succeed. Otherwise, the method will return an error
 	 * response with `result_t::NOT_CONNECTED`
 	 *
+	 * The records container is reserved up front for as many records as the
+	 * earlier responses of key-intervals of the same width, the ACQ left out,
+	 * held on average, so that it is not reallocated as the records arrive.
+	 * The first query of a width may be preceded by a keys-only count (see
+	 * `setCountBeforeGet()`), or the caller may pass the amount expected
+	 * itself (see `getExpecting()`). Up to 64 MiB of records are reserved;
+	 * a larger response grows the container beyond it as they arrive.
+	 *
 	 * The possible error codes are:
 	 *  - `result_t::BAD_RESPONSE`
 	 *  - `result_t::CONNCLOSED`
@@ -433,6 +1564,93 @@ public:
 	 * `ResponseGet<T>(status, partialFetchResult)` otherwise.
 	 */
 	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Fetches a set of records like `get()`, reserving the records
+	 * container for an expected amount of them.
+	 *
+	 * Suits callers knowing the size of a response beforehand, e.g. from
+	 * `countRange()` or from the sampling period of a series. The amount is
+	 * a hint: a larger response grows the container as `get()` does, and a
+	 * smaller one leaves the rest of the reserved memory unused. As in
+	 * `get()`, at most 64 MiB of records are reserved up front.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param expectedRecords The amount of records to reserve room for.
+	 *
+	 * @return The response as in `get()`.
+	 */
+	ResponseGet<T> getExpecting(
+		const Key& keyMin, const Key& keyMax, std::size_t expectedRecords);
+	/**
+	 * @brief Fetches a set of records like `get()`, within a deadline.
+	 *
+	 * The timeout set with `setTimeout()` bounds each send and receive on
+	 * its own: a response trickling in may take far longer, while a single
+	 * stall fails an otherwise healthy transfer. The deadline bounds the
+	 * request as a whole instead. Each transfer waits for the connection for
+	 * no longer than the time left, and the request fails with
+	 * `result_t::CONNTIMEOUT` once the deadline passes, however long the
+	 * single waits were. Reconnects and retry backoffs (see
+	 * `setRetryPolicy()`) are bounded by it as well; no retry is made which
+	 * could not complete in time.
+	 *
+	 * A request whose deadline has passed before it starts fails at once,
+	 * leaving the connection as it is. A request interrupted by its deadline
+	 * closes the connection, like other transfer errors.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param deadline The point in time by which the request has to complete.
+	 *
+	 * @return The response as in `get()`.
+	 */
+	ResponseGet<T> get(
+		const Key& keyMin, const Key& keyMax, std::chrono::steady_clock::time_point deadline);
+	/**
+	 * @brief Fetches a set of records like `get()`, keeping them in memory
+	 * taken from a given allocator.
+	 *
+	 * With an `ArenaAllocator`, the records are placed in the allocator's
+	 * arena, and so are the payload values allocating with an `ArenaAllocator`
+	 * of their own, like `ArenaString`: these are deserialized inside an
+	 * `ArenaScope` of the same arena. The arena is freed together with the
+	 * response and the records moved out of it, at once instead of record by
+	 * record:
+	 * @code
+	 * auto response = channel.get(keyMin, keyMax, makeArenaAllocator<Record<T>>());
+	 * @endcode
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @see get()
+	 *
+	 * @tparam Alloc A standard allocator of `Record<T>`.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param alloc The allocator of the records container.
+	 *
+	 * @return The response as in `get()`.
+	 */
+	template<typename Alloc>
+	ResponseGet<T, Alloc> get(const Key& keyMin, const Key& keyMax, const Alloc& alloc);
 	/**
 	 * @brief Queries the TStorage instance for the last full-commit acquisition
 	 * time (ACQ) timestamp for the given key-interval.
@@ -475,6 +1693,22 @@ public:
 	 * `ResponseAcq``(err)` with an error code `err` otherwise.
 	 */
 	ResponseAcq getAcq(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Queries the TStorage instance for the ACQ timestamp like
+	 * `getAcq()`, within a deadline.
+	 *
+	 * The deadline bounds the request as a whole, see `get(const Key&, const
+	 * Key&, std::chrono::steady_clock::time_point)`.
+	 *
+	 * The possible error codes are those of `getAcq()`.
+	 *
+	 * @param keyMin The lower vertex of the right-open reference key-interval.
+	 * @param keyMax The upper vertex of the right-open reference key-interval.
+	 * @param deadline The point in time by which the request has to complete.
+	 * @return The response as in `getAcq()`.
+	 */
+	ResponseAcq getAcq(
+		const Key& keyMin, const Key& keyMax, std::chrono::steady_clock::time_point deadline);
 	/**
 	 * @brief Batch-streams a set of records from a TStorage instance through
 	 * a callback function.
@@ -486,6 +1720,10 @@ public:
 	 * memory overhead inherent in processing entire responses at once.
 	 * Especially useful if the expected size of the response is very large.
 	 *
+	 * The same set of records is passed to every `callback` call, cleared
+	 * before each batch, so that its memory is reused throughout the stream.
+	 * The callback is free to move the records out of it.
+	 *
 	 * In contrast to `get()`, this method does not place any limit on size of
 	 * GET responses. Instead, the memory limit set by `setMemoryLimit()` governs
 	 * the size of a single record batch that is processed before fetching
@@ -497,7 +1735,10 @@ public:
 	 * might occur if, for instance, the client receives a record with payload
 	 * size 32MB and the memory limit is set to 4MB. To mitigate this error, set
 	 * a higher memory limit, preferably a bit higher than the maximum payload
-	 * size of 32MB (see `setMemoryLimit()`).
+	 * size of 32MB (see `setMemoryLimit()`), let the buffer grow for such
+	 * records only (see `setReceiveBufferGrowth()`), or use a payload type
+	 * which deserializes such records in chunks of the buffer (see
+	 * `PayloadType::chunked()`).
 	 *
 	 * The method acts otherwise in the same way as its standard `get()`
 	 * counterpart. Please refer to the `get()` documentation for more info.
@@ -534,6 +1775,757 @@ public:
 	ResponseAcq getStream(const Key& keyMin,
 		const Key& keyMax,
 		const std::function<void(RecordsSet<T>&)>& callback);
+	/**
+	 * @brief Batch-streams a set of records like `getStream()`, keeping the
+	 * batches in memory taken from a given allocator.
+	 *
+	 * The batches passed to `callback` are `RecordsSet<T, Alloc>` objects
+	 * using copies of `alloc`. With an `ArenaAllocator`, the records and
+	 * arena-aware payload values of a batch are placed in its arena (see the
+	 * allocator-taking `get()`), and the arena is rewound before each next
+	 * batch, so that a stream of any length reuses the same few blocks of
+	 * memory. Should the callback keep any values of a batch allocated from the
+	 * arena, e.g. move an `ArenaString` out of it, or a copy of the allocator,
+	 * the next batches use a new arena instead, which keeps the kept values
+	 * valid.
+	 *
+	 * The possible error codes are those of `getStream()`.
+	 *
+	 * @see getStream()
+	 *
+	 * @tparam Alloc A standard allocator of `Record<T>`.
+	 * @tparam Callback A callable taking a `RecordsSet<T, Alloc>&`.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param alloc The allocator of the batches.
+	 *
+	 * @param callback A callable that will be called on each batch of records
+	 * forming the response.
+	 *
+	 * @return The response as in `getStream()`.
+	 */
+	template<typename Alloc, typename Callback>
+	ResponseAcq getStream(
+		const Key& keyMin, const Key& keyMax, const Alloc& alloc, Callback callback);
+	/**
+	 * @brief Batch-streams a set of records like `getStream()`, stopping as
+	 * soon as the callback or a token asks to.
+	 *
+	 * The callback returns `true` to receive the next batch and `false` to
+	 * stop, e.g. once it has found a match or collected the top-N records.
+	 * The token is checked before the request is sent and after each batch,
+	 * so `cancel()` called on another thread stops the stream at the next
+	 * batch boundary.
+	 *
+	 * Stopping before the end of the response closes the connection rather
+	 * than receiving and discarding the rest of it, which costs a reconnect
+	 * instead of the transfer of what may be gigabytes of records. The
+	 * channel has to be connected again before the next request; a
+	 * `ChannelPool` does so in the background once the lease is released.
+	 * Stopping on the last batch keeps the connection and completes the
+	 * request as usual.
+	 *
+	 * The possible error codes are those of `getStream()`, as well as:
+	 *  - `result_t::CANCELLED` if the stream was stopped early.
+	 *
+	 * @see getStream()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param callback A callable that will be called on each batch of records
+	 * forming the response, returning `false` to stop the stream.
+	 *
+	 * @param token A token stopping the stream once cancelled.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getStreamUntil(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<bool(RecordsSet<T>&)>& callback,
+		const CancellationToken& token = CancellationToken());
+	/**
+	 * @brief Streams raw records from a TStorage instance through a visitor,
+	 * without deserializing them.
+	 *
+	 * Acts like `getStream()`, except no `Record<T>` objects are constructed
+	 * and `PayloadType::fromBytes()` is never called. Instead, the `visitor`
+	 * is called on each received record with its key and a read-only view of
+	 * its raw payload bytes, which points directly into the channel's internal
+	 * buffer. The view is valid only for the duration of the call; the
+	 * visitor has to copy whatever it needs to retain. This avoids all per-record
+	 * copies and allocations on the client side, which makes it a good fit for
+	 * checksumming, forwarding or aggregating payloads.
+	 * `StreamOperators.h` provides filters and bucketed reducers to aggregate
+	 * the records with.
+	 *
+	 * As with `getStream()`, the total size of the response is not limited by
+	 * `setMemoryLimit()`, but each single record must fit inside the internal
+	 * buffer. Otherwise, `result_t::MEMORY_LIMIT_EXCEEDED` is returned.
+	 *
+	 * @see getStream()
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_RESPONSE`
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNRESET`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::EMPTY_KEY_RANGE`
+	 *  - `result_t::ERROR`
+	 *  - `result_t::INVALID_KEY`
+	 *  - `result_t::MEMORY_LIMIT_EXCEEDED`
+	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::SIGNAL`
+	 *  - `result_t::OUT_OF_MEMORY`
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param visitor A callable that will be called on each received record
+	 * with its key, the address of its raw payload and the payload size.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getView(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<void(const Key&, const void*, std::size_t)>& visitor);
+	/**
+	 * @brief Retrieves a set of records from a TStorage instance, deserializing
+	 * each payload in place into storage of the caller.
+	 *
+	 * Acts like `get()`, except that no `RecordsSet<T>` is built: for each
+	 * received record, `sink` is called with its key and returns the value to
+	 * deserialize the payload into, e.g. the next slot of a preallocated
+	 * vector or of a ring buffer. This saves the temporary record, its move
+	 * into the set and the copy out of it. Like with `getView()`, the records
+	 * are passed on as they arrive, so the response is not subject to the
+	 * memory limit as a whole.
+	 *
+	 * The value is passed to `PayloadType<T>::fromBytes()` as it is, rather
+	 * than default-constructed; a payload type relying on the latter needs
+	 * fresh values. If a payload fails to deserialize, `sink` isn't called
+	 * anymore, and the call returns `result_t::DESERIALIZATION_ERROR` once the
+	 * response is received in full. The channel stays open in this case.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @see get()
+	 *
+	 * @tparam Sink A callable with signature compatible with
+	 * `T&(const Key&)`.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param sink A callable returning the value to deserialize the payload
+	 * of a record with a given key into.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	template<typename Sink>
+	ResponseAcq getInto(const Key& keyMin, const Key& keyMax, Sink sink);
+	/**
+	 * @brief Retrieves a set of records from a TStorage instance into two
+	 * output iterators, one for the keys and one for the values.
+	 *
+	 * Acts like `getInto()` with a sink writing each key to `*keys++` and
+	 * deserializing the payload in place into `*values++`, which hence has to
+	 * be an lvalue of type `T`, e.g. with `values` iterating over a
+	 * preallocated vector. Like `std::copy()`, the call doesn't check that
+	 * there's room for all records.
+	 *
+	 * The possible error codes are those of `getInto()`.
+	 *
+	 * @see getInto()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keys An output iterator of `Key`.
+	 *
+	 * @param values An output iterator over values of type `T`.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	template<typename KeyIt, typename ValueIt>
+	ResponseAcq getInto(const Key& keyMin, const Key& keyMax, KeyIt keys, ValueIt values);
+	/**
+	 * @brief Counts the records of a key-interval stored in a TStorage
+	 * instance.
+	 *
+	 * Sends a GET request like `get()`, but reads only the size and the key of
+	 * each record of the response: the payloads are dropped as they arrive,
+	 * never deserialized nor buffered whole, so the response is subject to
+	 * neither the memory limit nor `PayloadType<T>`. Meant to plan the reads
+	 * of a key-interval, e.g. its split into parallel requests or the memory
+	 * limit of a channel, at a fraction of the cost of reading it. The server
+	 * still sends the records in full.
+	 *
+	 * The possible error codes are those of `getView()` but
+	 * `result_t::MEMORY_LIMIT_EXCEEDED`.
+	 *
+	 * @see sizeRange()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the records to count.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the records to count.
+	 *
+	 * @param[out] oRecords The amount of records, set on success only.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq countRange(const Key& keyMin, const Key& keyMax, std::uint64_t& oRecords);
+	/**
+	 * @brief Counts the records of a key-interval stored in a TStorage
+	 * instance, in total and per CID.
+	 *
+	 * Acts like `countRange()` above.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the records to count.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the records to count.
+	 *
+	 * @param[out] oRecords The amount of records, set on success only.
+	 *
+	 * @param[out] oCids The amount of records of each CID present, replaced
+	 * on success only.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq countRange(const Key& keyMin,
+		const Key& keyMax,
+		std::uint64_t& oRecords,
+		std::map<Key::CidT, std::uint64_t>& oCids);
+	/**
+	 * @brief Measures the records of a key-interval stored in a TStorage
+	 * instance, in total and per CID.
+	 *
+	 * Acts like `countRange()`, also summing up the sizes of the keys and raw
+	 * payloads of the records.
+	 *
+	 * @see countRange()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the records to measure.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the records to measure.
+	 *
+	 * @param[out] oSizes The sizes of the key-interval, replaced on success
+	 * only.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq sizeRange(const Key& keyMin, const Key& keyMax, RangeSizes& oSizes);
+	/**
+	 * @brief Sends a GET request and returns its response as a stream of
+	 * records, to be read one at a time.
+	 *
+	 * Unlike the callbacks of `getStream()`, a stream is pulled by the caller,
+	 * e.g. with a range-based for loop:
+	 *
+	 *     Channel<T>::Stream stream = channel.openStream(keyMin, keyMax);
+	 *     for (const Record<T>& record : stream) { ... }
+	 *     if (stream.response().error()) { ... }
+	 *
+	 * Records are received as they are asked for, each deserialized into the
+	 * same value, so the response is not subject to the memory limit as a
+	 * whole, and the pace of the caller applies backpressure to the server.
+	 * A failed request returns a finished stream holding the error code.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @see Stream
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @return The stream.
+	 */
+	Stream openStream(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Retrieves a set of records from a TStorage instance into a
+	 * column-oriented container.
+	 *
+	 * Acts exactly like `get()`, except the fetched records are appended to
+	 * `oRecords`, with each key field and the payloads stored in separate
+	 * contiguous columns (see `ColumnarRecordsSet<T>`). Passing the same
+	 * container to consecutive calls, after a `clear()`, reuses its memory.
+	 *
+	 * On error, `oRecords` contains the records received before the failure.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @see get()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param[out] oRecords The container to append the fetched records to.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getColumnar(
+		const Key& keyMin, const Key& keyMax, ColumnarRecordsSet<T>& oRecords);
+	/**
+	 * @brief Batch-streams a set of records from a TStorage instance through
+	 * a callback function, in a column-oriented container.
+	 *
+	 * Acts exactly like `getStream()`, except each batch of records is passed
+	 * to `callback` as a `ColumnarRecordsSet<T>`.
+	 *
+	 * The possible error codes are those of `getStream()`.
+	 *
+	 * @see getStream()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param callback A callable that will be called on each batch of records
+	 * forming the response.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getStreamColumnar(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<void(ColumnarRecordsSet<T>&)>& callback);
+	/**
+	 * @brief Retrieves a set of records from a TStorage instance into a
+	 * series-oriented container.
+	 *
+	 * Acts exactly like `get()`, except the fetched records are appended to
+	 * `oRecords`, with the CAPs, ACQs and payloads of each series in
+	 * contiguous arrays of their own (see `SeriesSet<T>`). Passing the same
+	 * container to consecutive calls, after a `clear()`, reuses its memory.
+	 *
+	 * On error, `oRecords` contains the records received before the failure.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @see get()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param[out] oRecords The container to append the fetched records to.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getSeries(const Key& keyMin, const Key& keyMax, SeriesSet<T>& oRecords);
+	/**
+	 * @brief Batch-streams a set of records from a TStorage instance through
+	 * a callback function, in a series-oriented container.
+	 *
+	 * Acts exactly like `getStream()`, except each batch of records is passed
+	 * to `callback` as a `SeriesSet<T>`. A series may span several batches.
+	 *
+	 * The possible error codes are those of `getStream()`.
+	 *
+	 * @see getStream()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param callback A callable that will be called on each batch of records
+	 * forming the response.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getStreamSeries(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<void(SeriesSet<T>&)>& callback);
+	/**
+	 * @brief Retrieves a set of records from a TStorage instance, keeping
+	 * their raw payloads in a single byte heap.
+	 *
+	 * Acts exactly like `get()`, except the fetched records are appended to
+	 * `oRecords`, with their payloads copied as received into the set's heap
+	 * (see `BlobRecordsSet`) instead of being deserialized with
+	 * `PayloadType<T>::fromBytes()`. Passing the same container to
+	 * consecutive calls, after a `clear()`, reuses its memory.
+	 *
+	 * On error, `oRecords` contains the records received before the failure.
+	 *
+	 * The possible error codes are those of `get()`, except for
+	 * `result_t::DESERIALIZATION_ERROR`.
+	 *
+	 * @see get()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param[out] oRecords The container to append the fetched records to.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getBlob(const Key& keyMin, const Key& keyMax, BlobRecordsSet& oRecords);
+	/**
+	 * @brief Batch-streams a set of records from a TStorage instance through
+	 * a callback function, keeping the raw payloads of each batch in a single
+	 * byte heap.
+	 *
+	 * Acts exactly like `getStream()`, except each batch is a
+	 * `BlobRecordsSet` filled as by `getBlob()`.
+	 *
+	 * The possible error codes are those of `getStream()`, except for
+	 * `result_t::DESERIALIZATION_ERROR`.
+	 *
+	 * @see getStream()
+	 * @see getBlob()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param callback A callable that will be called on each batch of records
+	 * forming the response.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getStreamBlob(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<void(BlobRecordsSet&)>& callback);
+	/**
+	 * @brief Retrieves a set of records whose payload types depend on their
+	 * CIDs.
+	 *
+	 * Acts exactly like `get()`, except each fetched record is deserialized
+	 * with the payload type its CID is routed to by `oRecords` (see
+	 * `MixedRecordsSet<Ts...>`) instead of `PayloadType<T>`, so that a range
+	 * mixing e.g. numeric, string and blob series takes a single query.
+	 *
+	 * A record with a CID routed to no type, or a payload which fails to
+	 * deserialize, is skipped, and the call returns
+	 * `result_t::DESERIALIZATION_ERROR` once the response is received in full.
+	 * The channel stays open in this case.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @see get()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param[out] oRecords The container to append the fetched records to.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	template<typename... Ts>
+	ResponseAcq getMixed(const Key& keyMin, const Key& keyMax, MixedRecordsSet<Ts...>& oRecords);
+	/**
+	 * @brief Retrieves a set of records from a TStorage instance, deferring
+	 * the deserialization of each payload to its first access.
+	 *
+	 * Acts exactly like `getBlob()`, filling the raw records of `oRecords`,
+	 * which deserializes them on demand (see `LazyRecordsSet<T>`). Unless
+	 * `oRecords` has a payload type of its own, it deserializes with the
+	 * `PayloadType<T>` of this channel. Since nothing is deserialized during
+	 * the call, a payload which fails to deserialize is reported by
+	 * `LazyRecordsSet::value()` rather than by the response.
+	 *
+	 * The possible error codes are those of `getBlob()`.
+	 *
+	 * @see getBlob()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param[out] oRecords The container to append the fetched records to.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getLazy(const Key& keyMin, const Key& keyMax, LazyRecordsSet<T>& oRecords);
+	/**
+	 * @brief Batch-streams a set of records from a TStorage instance through
+	 * a callback function, in containers laid out as Apache Arrow arrays.
+	 *
+	 * Acts exactly like `getStreamBlob()`, except each batch is an
+	 * `ArrowRecordsSet`, with the key fields and the raw payloads copied
+	 * straight from the receive buffer into the columns of Arrow arrays. With
+	 * `<tstorageclient++/ArrowRecordBatch.h>`, the callback can move each
+	 * batch into an `arrow::RecordBatch` at no further cost (see also
+	 * `getStreamRecordBatches()` there). Each batch holds the records of at
+	 * most one buffer of the size set by `setMemoryLimit()`.
+	 *
+	 * The possible error codes are those of `getStreamBlob()`, as well as:
+	 *  - `result_t::DESERIALIZATION_ERROR` if `fixedPayloadSize` is not 0
+	 * and a payload of another size was received.
+	 *
+	 * @see getStreamBlob()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param callback A callable that will be called on each batch of records
+	 * forming the response. It may move the columns out of the batch.
+	 *
+	 * @param fixedPayloadSize The size of all payloads, laid out as a
+	 * `fixed_size_binary` array, or 0 for a `large_binary` array of payloads
+	 * of any size.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getStreamArrow(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<void(ArrowRecordsSet&)>& callback,
+		std::size_t fixedPayloadSize = 0);
+	/**
+	 * @brief Retrieves a set of records from a TStorage instance into a
+	 * temporary file, for responses larger than the memory.
+	 *
+	 * Acts like `getBlob()`, except the records are appended to the file of
+	 * `oRecords` as they are received (see `SpilledRecordsSet`), which is
+	 * sealed afterwards. The size of the response is hence bounded by the
+	 * disk rather than by `setMemoryLimit()`, which only bounds the size of a
+	 * single record, as with `getStream()`. The response is received at the
+	 * speed of the slower of the network and the disk.
+	 *
+	 * On error, `oRecords` contains the records received before the failure,
+	 * sealed if possible.
+	 *
+	 * The possible error codes are those of `getView()`, as well as:
+	 *  - `result_t::SPILL_ERROR`
+	 *
+	 * @see getView()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param[out] oRecords The container to append the fetched records to.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with a valid ACQ timestamp on a
+	 * successfully completed database fetch, `ResponseAcq(err)` with an error
+	 * code `err` otherwise.
+	 */
+	ResponseAcq getSpilled(const Key& keyMin, const Key& keyMax, SpilledRecordsSet& oRecords);
+	/**
+	 * @brief Batch-streams a set of records from a TStorage instance through
+	 * a callback function, resuming after connection failures.
+	 *
+	 * Acts like `getStream()`, except the response survives the connection
+	 * breaking down. The key-interval is first pinned to a consistent state:
+	 * `keyMax.acq` is brought down to `getAcq(keyMin, keyMax).acq()`, below
+	 * which the records of the key-interval never change. The pinned
+	 * key-interval is then split into up to `subRanges` sub-intervals, by CID
+	 * and then, if it spans fewer CIDs, by CAP, and these are streamed one
+	 * after another. A sub-interval failing with a connection error is
+	 * reissued after reconnecting, as allowed by the retry policy (see
+	 * `setRetryPolicy()`), while the completed ones are not fetched again.
+	 *
+	 * The records of an interrupted sub-interval are streamed anew from its
+	 * start, hence the callback may see some of them twice. More sub-intervals
+	 * bound the amount of such records at the cost of more requests.
+	 *
+	 * With the default retry policy, no attempt is retried.
+	 *
+	 * The possible error codes are those of `getStream()`.
+	 *
+	 * @see getStream()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param subRanges The amount of sub-intervals to split the key-interval
+	 * into, at least `1`.
+	 *
+	 * @param callback A callable that will be called on each batch of records
+	 * forming the response.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with the ACQ timestamp the
+	 * key-interval was pinned to on a successfully completed database fetch,
+	 * `ResponseAcq(err)` with an error code `err` otherwise.
+	 */
+	ResponseAcq getStreamResumable(const Key& keyMin,
+		const Key& keyMax,
+		std::size_t subRanges,
+		const std::function<void(RecordsSet<T>&)>& callback);
+	/**
+	 * @brief Follows a key-interval, streaming the records committed to it
+	 * since the previous poll.
+	 *
+	 * Polls the key-interval once per `interval` with `getStream()`. Each poll
+	 * starts at the full-commit ACQ returned by the previous one (at
+	 * `keyMin.acq` for the first one), so that `callback` receives each record
+	 * of the key-interval exactly once. The ACQ comes with the GET response
+	 * itself, hence a poll costs a single round trip, without a `getAcq()`.
+	 *
+	 * The callback is called on each batch of records of a poll, at least
+	 * once per poll, even if no records are new. Returning `false` stops
+	 * following once the current poll completes. Following also stops when
+	 * the full-commit ACQ reaches `keyMax.acq`, or on the first failed poll.
+	 *
+	 * The possible error codes are those of `getStream()`.
+	 *
+	 * @see getStream()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param callback A callable that will be called on each batch of new
+	 * records, returning `false` to stop following.
+	 *
+	 * @param interval The time between the starts of consecutive polls. A poll
+	 * taking longer is followed by the next one right away.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with the full-commit ACQ the
+	 * next poll would start at, i.e. where to resume following, when stopped,
+	 * `ResponseAcq(err)` with an error code `err` of the failed poll otherwise.
+	 */
+	ResponseAcq tail(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<bool(RecordsSet<T>&)>& callback,
+		std::chrono::duration<std::int64_t, std::milli> interval);
+	/**
+	 * @brief Fetches the records of several key-intervals, pipelining the
+	 * requests.
+	 *
+	 * Acts like a sequence of `get()` calls, one per key-interval, except that
+	 * all GET requests are written to the connection back-to-back before any of
+	 * the responses is read, so that the whole batch costs a single round trip
+	 * instead of one per key-interval. The responses are returned in the order
+	 * of `ranges`, each subject to the same memory limit as a `get()` response.
+	 *
+	 * An invalid key-interval is not sent; its response carries the
+	 * `result_t::INVALID_KEY` or `result_t::EMPTY_KEY_RANGE` error code and the
+	 * channel is kept open. Any other error closes the connection, as with
+	 * `get()`: the request it concerns receives the error code, and the requests
+	 * that follow receive `result_t::NOT_CONNECTED`.
+	 *
+	 * The possible error codes are those of `get()`.
+	 *
+	 * @param ranges The target key-intervals.
+	 * @return The responses, one per key-interval.
+	 */
+	std::vector<ResponseGet<T>> getBatch(const std::vector<KeyRange>& ranges);
+	/**
+	 * @brief Fetches the ACQ timestamps of several key-intervals, pipelining
+	 * the requests.
+	 *
+	 * Acts like a sequence of `getAcq()` calls, with the same guarantees and
+	 * error handling as `getBatch()`.
+	 *
+	 * The possible error codes are those of `getAcq()`.
+	 *
+	 * @param ranges The target key-intervals.
+	 * @return The responses, one per key-interval.
+	 */
+	std::vector<ResponseAcq> getAcqBatch(const std::vector<KeyRange>& ranges);
+	/**
+	 * @brief Fetches the records of several key-intervals, merging those that
+	 * overlap or touch into fewer GET requests.
+	 *
+	 * The key-intervals are merged with `coalesceKeyRanges()` and the merged
+	 * ones are fetched with `getBatch()`, so that overlapping key-intervals
+	 * cost a single transfer of their shared records, and the whole batch a
+	 * single round trip. The records of each merged response are then sorted
+	 * back into the responses of the key-intervals it covers, which all carry
+	 * its status code and ACQ. The ACQ of a merged key-interval is that of a
+	 * key-interval containing the requested one, and may hence be smaller
+	 * than what `get()` would return for the latter alone.
+	 *
+	 * The responses are returned in the order of `ranges`. Since a merged
+	 * response is subject to the memory limit as a whole, a batch which would
+	 * pass as separate `get()` calls may fail with
+	 * `result_t::MEMORY_LIMIT_EXCEEDED`.
+	 *
+	 * The possible error codes are those of `getBatch()`.
+	 *
+	 * @param ranges The target key-intervals.
+	 * @return The responses, one per key-interval.
+	 */
+	std::vector<ResponseGet<T>> getCoalesced(const std::vector<KeyRange>& ranges);
 
 private:
 
@@ -541,73 +2533,573 @@ private:
 	 * Implementation details
 	 */
 
-	/** @brief A dispatch table containing function pointers to several library
-	 * functions appropriate for a specific PUT protocol. */
-	struct PutMethods;
-	/** @brief A PUT protocol tag. */
-	enum ProtoT {
-		PUT,
-		PUTA,
-	};
-
 	/**
-	 * @brief Returns a `PutMethods` dispatch table for a specific protocol.
-	 * @param tag Protocol tag.
-	 * @return A preset dispatch table.
+	 * @brief The PUT protocol policy.
+	 *
+	 * A protocol policy maps the steps of a PUT/A request to the functions of
+	 * its protocol, so that the common implementation of the requests calls
+	 * them directly, the protocol being resolved at compile time.
 	 */
-	static constexpr PutMethods putMethods(ProtoT tag);
+	struct PutProto;
+	/** @brief The PUTA protocol policy. @see PutProto */
+	struct PutAProto;
 
 	/**
 	 * @brief A common implementation of a PUT/A request.
 	 *
 	 * Currently, the only difference between the implementations of `put()` and
 	 * `puta()` lies in the names of some library functions called at some
-	 * crucial places in the code. We use the template parameter to disambiguate
-	 * between the two sets of functions by referring to the results of a
-	 * `putMethods()` static method call.
+	 * crucial places in the code, which the protocol policy provides.
 	 *
-	 * @tparam Tag A protocol tag.
-	 * @param recordSet The set of records to store in the database.
+	 * @tparam Proto The protocol policy, `PutProto` or `PutAProto`.
+	 * @tparam Writer A callable type returning `result_t`.
+	 * @param writeRecords Serializes and writes the records to store in the
+	 * database, returning the first non-OK status code, if any.
 	 * @return The status code to pass to the user inside the `Response` of
 	 * `put()`/`puta()`.
 	 */
-	template<ProtoT Tag>
-	result_t putImpl(const RecordsSet<T>& recordSet);
+	template<typename Proto, typename Writer>
+	result_t putImpl(Writer writeRecords);
+	/**
+	 * @brief Serializes and writes a range of records.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @tparam InputIt An input iterator type dereferencing to `Record<T>`.
+	 * @return An internal status code.
+	 */
+	template<typename Proto, typename InputIt>
+	result_t writeRecordRange(InputIt first, InputIt last);
+	/**
+	 * @brief Serializes and writes records produced by a generator.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @return An internal status code.
+	 */
+	template<typename Proto>
+	result_t writeGeneratedRecords(const std::function<bool(Record<T>&)>& generator);
+	/**
+	 * @brief Writes a range of records with already serialized payloads.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @tparam InputIt An input iterator type dereferencing to `RawRecord`.
+	 * @return An internal status code.
+	 */
+	template<typename Proto, typename InputIt>
+	result_t writeRawRecordRange(InputIt first, InputIt last);
+	/**
+	 * @brief A common implementation of `put()` and `puta()` called with a
+	 * `RecordsSet<T>`, grouping the records by CID if enabled.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @param recordSet The set of records to store in the database.
+	 * @return An internal status code.
+	 */
+	template<typename Proto>
+	result_t putRecordsSet(const RecordsSet<T>& recordSet);
+	/**
+	 * @brief Returns `true` if all records of a set can be stored with a
+	 * given protocol, checking their keys in one pass.
+	 *
+	 * @tparam Proto The protocol policy.
+	 */
+	template<typename Proto>
+	static bool allKeysStorable(const RecordsSet<T>& recordSet);
+	/**
+	 * @brief Serializes and writes the records pointed to by
+	 * `mGroupedRecords`.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @return An internal status code.
+	 */
+	template<typename Proto>
+	result_t writeGroupedRecords();
 	/**
 	 * @brief Serialize and write a single record.
 	 *
-	 * @tparam Tag A protocol tag.
+	 * @tparam Proto The protocol policy.
 	 * @param record A record to send.
 	 * @return An internal status code.
 	 */
-	template<ProtoT Tag>
+	template<typename Proto>
 	result_t serializeAndWriteRecord(const Record<T>& record);
+	/**
+	 * @brief Returns `true` if `count` records are to be serialized on the
+	 * encoding threads (see `setEncodeThreads()`).
+	 */
+	bool encodesInParallel(std::size_t count) const;
+	/**
+	 * @brief The parallel variant of `writeRecordRange()`, serializing slices
+	 * of the range into chunks on the encoding threads.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @tparam RandomIt A random access iterator dereferencing to `Record<T>`
+	 * or to a pointer to it.
+	 * @return An internal status code.
+	 */
+	template<typename Proto, typename RandomIt>
+	result_t writeRecordRangeInParallel(RandomIt first, RandomIt last);
+	/**
+	 * @brief Serializes a slice of records into the `chunk`-th chunk. Called
+	 * on the encoding threads.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @tparam RandomIt See `writeRecordRangeInParallel()`.
+	 * @return An internal status code.
+	 */
+	template<typename Proto, typename RandomIt>
+	result_t serializeSliceToChunk(std::size_t chunk, RandomIt first, RandomIt last);
+	/**
+	 * @brief Serialize a single record into the `chunk`-th chunk.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @param chunk The index of the chunk.
+	 * @param record A record to send.
+	 * @return An internal status code.
+	 */
+	template<typename Proto>
+	result_t serializeRecordToChunk(std::size_t chunk, const Record<T>& record);
+	/** @brief Returns `record`. */
+	static const Record<T>& recordOf(const Record<T>& record) { return record; }
+	/** @brief Returns the record pointed to by `record`. */
+	static const Record<T>& recordOf(const Record<T>* record) { return *record; }
 	/**
 	 * @brief Write an end-of-stream marker and receive the command status code
 	 * from the server.
 	 *
-	 * @tparam Tag A protocol tag.
+	 * @tparam Proto The protocol policy.
 	 * @return An internal status code.
 	 */
-	template<ProtoT Tag>
+	template<typename Proto>
 	result_t putFinalize();
+	/**
+	 * @brief Ends a PUT/A request after a record failed to be written.
+	 *
+	 * On an invalid record, finishes the request, storing the records preceding
+	 * it, and closes the channel. Aborts the connection on any other error.
+	 *
+	 * @tparam Proto The protocol policy.
+	 * @param res The error code of the failed write.
+	 * @return `res`.
+	 */
+	template<typename Proto>
+	result_t endPutOnError(result_t res);
+
+	friend class PutStream<T>;
+	template<typename S, typename D>
+	friend ResponseAcq replicate(
+		Channel<S>& source, Channel<D>& destination, const Key& keyMin, const Key& keyMax);
+	/** @brief Writes a record of an open `PutStream<T>`. */
+	result_t putStreamAppend(bool puta, const Record<T>& record);
+	/** @brief Sends the buffered records of an open `PutStream<T>`. */
+	result_t putStreamFlush();
+	/** @brief Finishes the request of an open `PutStream<T>`. */
+	result_t putStreamFinish(bool puta);
+
+	/**
+	 * @brief Calls `request` until its response is successful or the retry
+	 * policy rules out another attempt (see `setRetryPolicy()`).
+	 *
+	 * @tparam Request A callable returning a `Response` or a subclass of it.
+	 * @param put `true` for PUT/A requests.
+	 * @param request Makes a single attempt of the request.
+	 * @return The response of the last attempt.
+	 */
+	template<typename Request>
+	auto withRetries(bool put, Request request) -> decltype(request());
+	/** @brief A single attempt of `get()`. */
+	template<typename Alloc>
+	ResponseGet<T, Alloc> getOnce(const Key& keyMin,
+		const Key& keyMax,
+		const Alloc& alloc,
+		std::size_t expectedRecords);
+	/** @brief Returns the amount of records to reserve for a GET response,
+	 * predicted or counted. @see `setCountBeforeGet()` */
+	std::size_t expectedGetRecords(const Key& keyMin, const Key& keyMax);
+	/** @brief A single attempt of `getAcq()`. */
+	ResponseAcq getAcqOnce(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Receives the response to a GET request sent earlier. Closes the
+	 * connection on failure.
+	 * @return The response to pass to the user.
+	 */
+	ResponseGet<T> readGetResponse();
+	/**
+	 * @brief Receives the records of a GET response sent earlier and appends
+	 * them to a given set. Closes the connection on failure.
+	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
+	 * @param[in, out] recordSet The set of records to append the results to.
+	 * @return The status code and the ACQ timestamp of the response.
+	 */
+	template<typename Set>
+	ResponseAcq readGetResponseTo(Set& recordSet);
+	/**
+	 * @brief A common implementation of `getStream()` and
+	 * `getStreamColumnar()`.
+	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @param callback A callable that will be called on each batch of records,
+	 * returning `false` to stop the stream.
+	 * @param recordSet The empty set to deliver the batches in.
+	 * @return The response to pass to the user.
+	 */
+	template<typename Set>
+	ResponseAcq getStreamImpl(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<bool(Set&)>& callback,
+		Set recordSet);
+	/**
+	 * @brief A single attempt of `getStreamImpl()`. Aborts the connection if
+	 * the callback stops the stream before its end.
+	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @param callback A callable that will be called on each batch of records,
+	 * returning `false` to stop the stream.
+	 * @param[in, out] ioRecordSet The set to deliver the batches in, reused
+	 * between attempts.
+	 * @param[out] oDelivered Set if any records have been passed to `callback`.
+	 * @return The response to pass to the user.
+	 */
+	template<typename Set>
+	ResponseAcq getStreamOnce(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<bool(Set&)>& callback,
+		Set& ioRecordSet,
+		bool& oDelivered);
+	/**
+	 * @brief Empties a set for the next batch of `getStreamOnce()`, reserving
+	 * room for `count` records.
+	 *
+	 * @param[in, out] ioRecordSet The set to empty.
+	 * @param count The amount of records to reserve room for.
+	 * @param[in, out] ioArenaShares The use count of the set's arena, as
+	 * returned by `arenaOf()`, when no values of the last batch are kept.
+	 */
+	template<typename Set>
+	static void prepareBatch(Set& ioRecordSet, std::size_t count, long& ioArenaShares);
+	/**
+	 * @brief Empties an arena set for the next batch of `getStreamOnce()`,
+	 * rewinding its arena unless the last batch's values are still in use,
+	 * and switching to a new arena otherwise.
+	 */
+	static void prepareBatch(
+		ArenaRecordsSet<T>& ioRecordSet, std::size_t count, long& ioArenaShares);
+	/**
+	 * @brief The state of a prefetching stream, shared by the reader thread
+	 * and the calling thread. Stops and joins the reader on destruction.
+	 *
+	 * @tparam Set The type of the batches.
+	 */
+	template<typename Set>
+	struct StreamPrefetch
+	{
+		~StreamPrefetch();
+
+		/** @brief Guards the fields below. */
+		std::mutex mutex;
+		/** @brief Signals a change of the fields below. */
+		std::condition_variable changed;
+		/** @brief The received batches, in the order of the response. */
+		std::deque<Set*> ready;
+		/** @brief The sets free to receive a batch into. */
+		std::deque<Set*> free;
+		/** @brief `true` once the reader has received its last batch. */
+		bool done = false;
+		/** @brief `true` if the reader is to stop before the next batch. */
+		bool stop = false;
+		/** @brief The status of the last batch received. */
+		result_t status = result_t::OK;
+		/** @brief The reader thread. */
+		std::thread reader;
+	};
+	/**
+	 * @brief Passes the batches of a GET response to `callback` while a
+	 * reader thread receives the next ones (see `setStreamPrefetch()`).
+	 *
+	 * @tparam Set `RecordsSet<T>`, `ColumnarRecordsSet<T>`, `BlobRecordsSet`
+	 * or `ArrowRecordsSet`.
+	 * @param callback A callable that will be called on each batch of records,
+	 * returning `false` to stop the stream.
+	 * @param[in, out] ioRecordSet A set the sets of the batches are copied
+	 * from.
+	 * @param[out] oDelivered Set if any records have been passed to `callback`.
+	 * @return The status code of the last batch, `result_t::END_OF_STREAM` if
+	 * the response was received in full, `result_t::CANCELLED` if the callback
+	 * stopped the stream before.
+	 */
+	template<typename Set>
+	result_t streamPrefetchedBatches(
+		const std::function<bool(Set&)>& callback, Set& ioRecordSet, bool& oDelivered);
+	/** @brief Wraps a callback of `getStream()` into one which never stops
+	 * the stream. `callback` has to outlive the result. */
+	template<typename Set>
+	static std::function<bool(Set&)> continuing(const std::function<void(Set&)>& callback);
+	/** @brief Returns the arena of a set, empty if it uses none. */
+	template<typename Set>
+	static std::shared_ptr<MonotonicArena> arenaOf(const Set& recordSet);
+	/** @brief Returns the arena of an arena set. */
+	static std::shared_ptr<MonotonicArena> arenaOf(const ArenaRecordsSet<T>& recordSet);
+	/**
+	 * @brief Receives the response to a GETACQ request sent earlier. Closes the
+	 * connection on failure.
+	 * @return The response to pass to the user.
+	 */
+	ResponseAcq readGetAcqResponse();
+	/**
+	 * @brief A common implementation of `getBatch()` and `getAcqBatch()`.
+	 *
+	 * @tparam R The response type.
+	 * @param ranges The target key-intervals.
+	 * @param queueRequest Appends a request to the output buffer.
+	 * @param readResult Receives a response.
+	 * @return The responses, one per key-interval.
+	 */
+	template<typename R>
+	std::vector<R> batchImpl(const std::vector<KeyRange>& ranges,
+		result_t (Channel<T>::*queueRequest)(const Key&, const Key&),
+		R (Channel<T>::*readResult)());
 
 	/**
 	 * @brief Prepare the next batch of records from a GET response for
 	 * processing inside a `getStream()` callback.
 	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
 	 * @param[in, out] recordSet The set of records to append the results to.
 	 * @return An internal status code.
 	 */
-	result_t recvAndDeserializeRecordTo(RecordsSet<T>& recordSet);
+	template<typename Set>
+	result_t recvAndDeserializeRecordTo(Set& recordSet);
+	/**
+	 * @brief Appends the next record from a GET response to a given set,
+	 * deserializing its payload in chunks (see `PayloadType::chunked()`).
+	 *
+	 * Used for a record which doesn't fit in the receive buffer.
+	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
+	 * @param[in, out] recordSet The set of records to append the record to.
+	 * @return An internal status code.
+	 */
+	template<typename Set>
+	result_t recvChunkedRecordTo(Set& recordSet);
+	/** @brief Returns `true` if the next record is to be deserialized by
+	 * `recvChunkedRecordTo()`, after `readNextRecordData()` has returned
+	 * `result_t::MEMORY_LIMIT_EXCEEDED`. */
+	bool chunkedRecordNext() const
+	{
+		return !mTrivialPayload && mPayloadType->chunked() && nextRecordOversized();
+	}
+	/**
+	 * @brief Supplies the next record of a GET response like
+	 * `readNextRecordData()`, first skipping the records which don't fit in
+	 * the receive buffer if an oversized record handler is set.
+	 *
+	 * @see `setOversizedRecordHandler()`
+	 */
+	result_t readNextFittingRecordData(
+		Key& oKey, const void*& oPayloadPtr, std::size_t& oPayloadSize);
+	/**
+	 * @brief Supplies the next record of a GET response like
+	 * `readNextFittingRecordData()`, retrying once if the record did not fit
+	 * until the records already consumed were discarded from the buffer.
+	 *
+	 * Meant for readers which consume each record before asking for the next
+	 * one, rather than keep its payload in the buffer.
+	 */
+	result_t readNextRecordDataCompacting(
+		Key& oKey, const void*& oPayloadPtr, std::size_t& oPayloadSize);
+	/**
+	 * @brief Appends the next record from a GET response to a given
+	 * `BlobRecordsSet`, copying its raw payload.
+	 *
+	 * @param[in, out] recordSet The set of records to append the record to.
+	 * @return An internal status code.
+	 */
+	result_t recvAndDeserializeRecordTo(BlobRecordsSet& recordSet);
+	/**
+	 * @brief Appends the next record from a GET response to a given
+	 * `ArrowRecordsSet`, copying its raw payload.
+	 *
+	 * @param[in, out] recordSet The set of records to append the record to.
+	 * @return An internal status code, `result_t::DESERIALIZATION_ERROR` if
+	 * the payload does not have the fixed size of the set.
+	 */
+	result_t recvAndDeserializeRecordTo(ArrowRecordsSet& recordSet);
 	/**
 	 * @brief Append the next record from a GET response to a given
 	 * `RecordsSet<T>`.
 	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
 	 * @param[in, out] recordSet The set of records to append the record to.
 	 * @return An internal status code.
 	 */
-	result_t recvAndDeserializeBatchTo(RecordsSet<T>& recordSet);
+	template<typename Set>
+	result_t recvAndDeserializeBatchTo(Set& recordSet);
+	/**
+	 * @brief Append records from a GET response to a given set until
+	 * `readNextRecordData()` stops returning them, deserializing them on the
+	 * decoding threads if enabled (see `setDecodeThreads()`).
+	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
+	 * @param[in, out] recordSet The set of records to append the records to.
+	 * @param batched Whether the records form a batch of a stream, which
+	 * `batchComplete()` may end early with `result_t::OK`.
+	 * @return The status code of the call to `readNextRecordData()` which
+	 * returned no record, or `result_t::DESERIALIZATION_ERROR`.
+	 */
+	template<typename Set>
+	result_t recvAndDeserializeRecordsTo(Set& recordSet, bool batched);
+	/**
+	 * @brief Append records from a GET response to a given `BlobRecordsSet`
+	 * until `readNextRecordData()` stops returning them.
+	 *
+	 * @param[in, out] recordSet The set of records to append the records to.
+	 * @param batched Whether the records form a batch of a stream, which
+	 * `batchComplete()` may end early with `result_t::OK`.
+	 * @return The status code of the call to `readNextRecordData()` which
+	 * returned no record.
+	 */
+	result_t recvAndDeserializeRecordsTo(BlobRecordsSet& recordSet, bool batched);
+	/**
+	 * @brief Append records from a GET response to a given `ArrowRecordsSet`
+	 * until `readNextRecordData()` stops returning them.
+	 *
+	 * @param[in, out] recordSet The set of records to append the records to.
+	 * @param batched Whether the records form a batch of a stream, which
+	 * `batchComplete()` may end early with `result_t::OK`.
+	 * @return The status code of the call to `readNextRecordData()` which
+	 * returned no record, or `result_t::DESERIALIZATION_ERROR`.
+	 */
+	result_t recvAndDeserializeRecordsTo(ArrowRecordsSet& recordSet, bool batched);
+	/**
+	 * @brief The parallel variant of `recvAndDeserializeRecordsTo()`, framing
+	 * the records into chunks deserialized by the decoding threads.
+	 *
+	 * @tparam Set `RecordsSet<T>` or `ColumnarRecordsSet<T>`.
+	 * @param[in, out] recordSet The set of records to append the records to.
+	 * @param batched Whether the records form a batch of a stream, which
+	 * `batchComplete()` may end early with `result_t::OK`.
+	 * @return The status code of the call to `readNextRecordData()` which
+	 * returned no record, or `result_t::DESERIALIZATION_ERROR`.
+	 */
+	template<typename Set>
+	result_t recvAndDecodeInParallelTo(Set& recordSet, bool batched);
+	/**
+	 * @brief Decides whether a batch of a stream is passed to the callback
+	 * before the next record is received, following `mStreamBatching`.
+	 *
+	 * May wait for the next record up to the remaining delay of the batch.
+	 *
+	 * @param records The amount of records of the batch.
+	 * @param[in, out] ioFirstRecord The time the first record of the batch
+	 * was seen, set by the call which sees it. Default-constructed for a new
+	 * batch.
+	 * @return `true` if the batch is complete.
+	 */
+	bool batchComplete(
+		std::size_t records, std::chrono::steady_clock::time_point& ioFirstRecord);
+
+	/** @brief A chunk of framed records awaiting deserialization. */
+	struct DecodeChunk
+	{
+		/** @brief The keys of the records. */
+		std::vector<Key> keys;
+		/** @brief The end offsets of the records' payloads in `bytes`. */
+		std::vector<std::size_t> ends;
+		/** @brief The raw payloads of the records, back to back. */
+		std::vector<char> bytes;
+		/** @brief The deserialized records. */
+		std::vector<Record<T>> records;
+		/** @brief `false` if a payload failed to deserialize. */
+		bool ok = true;
+	};
+	/** @brief Deserializes the records of a chunk. Called on the decoding
+	 * threads. */
+	void decodeChunk(DecodeChunk& chunk);
+	/**
+	 * @brief Pass every remaining record of a GET response to `visitor` as a
+	 * raw payload view, up to and including the end-of-stream marker.
+	 *
+	 * @tparam Visitor A callable with signature compatible with
+	 * `void(const Key&, const void*, std::size_t)`.
+	 * @param visitor The callable to invoke on each record.
+	 * @return `result_t::END_OF_STREAM` on success, an internal status code
+	 * otherwise.
+	 */
+	template<typename Visitor>
+	result_t recvAndVisitRecords(Visitor& visitor);
+	/**
+	 * @brief A common implementation of `getView()` and `getInto()`: sends a
+	 * GET request and passes the records of the response to `visitor`.
+	 *
+	 * @tparam Visitor A callable with signature compatible with
+	 * `void(const Key&, const void*, std::size_t)`.
+	 * @return The status code and the ACQ timestamp of the response.
+	 */
+	template<typename Visitor>
+	ResponseAcq getVisitImpl(const Key& keyMin, const Key& keyMax, Visitor& visitor);
+	/**
+	 * @brief A common implementation of `countRange()` and `sizeRange()`:
+	 * sends a GET request and passes the key and the payload size of each
+	 * record of the response to `visitor`, dropping the payloads.
+	 *
+	 * @tparam Visitor A callable with signature compatible with
+	 * `void(const Key&, std::size_t)`.
+	 * @return The status code and the ACQ timestamp of the response.
+	 */
+	template<typename Visitor>
+	ResponseAcq getKeysImpl(const Key& keyMin, const Key& keyMax, Visitor& visitor);
+	/**
+	 * @brief Appends every remaining record of a GET response to a spilled
+	 * set, stopping at the first failed append.
+	 *
+	 * @param recordSet The set to append the records to.
+	 * @return `result_t::END_OF_STREAM` on success, an internal status code
+	 * otherwise.
+	 */
+	result_t recvAndSpillRecords(SpilledRecordsSet& recordSet);
+
+	/** @brief The size of a key serialized in a response. */
+	static constexpr std::size_t cSerializedKeySize = 32;
+	/** @brief The maximal amount of records in a chunk handed over to the
+	 * decoding threads. */
+	static constexpr std::size_t cDecodeChunkRecords = 256;
+	/** @brief The payload size above which a chunk is handed over to the
+	 * decoding threads early. */
+	static constexpr std::size_t cDecodeChunkBytes = 256 * 1024;
+	/** @brief The amount of records in a slice serialized by an encoding
+	 * thread. */
+	static constexpr std::size_t cEncodeSliceRecords = 1024;
+	/** @brief The amount of slices per encoding thread serialized before the
+	 * chunks are sent. */
+	static constexpr std::size_t cEncodeSlicesPerThread = 4;
+	/** @brief The largest memory reserved up front for the records of a GET
+	 * response, however many are expected. */
+	static constexpr std::size_t cMaxReservedGetBytes = 64UL * 1024 * 1024;
+
+	/** @brief `std::true_type` if `T` can be used with `TrivialPayloadType`. */
+	using IsTrivialT = std::integral_constant<bool, std::is_trivially_copyable<T>::value>;
+	/**
+	 * @brief Checks whether a payload type is a `TrivialPayloadType<T>`.
+	 * @param payloadType The payload type to check, possibly `nullptr`.
+	 * @return `true` if the payload type is a `TrivialPayloadType<T>`.
+	 */
+	static bool isTrivialPayload(PayloadType<T>* payloadType, std::true_type);
+	/** @brief Always returns `false`, `T` is not trivially copyable. */
+	static bool isTrivialPayload(PayloadType<T>* payloadType, std::false_type);
+	/**
+	 * @brief Deserializes a payload with `TrivialPayloadType<T>::fromBytes()`
+	 * called directly, allowing it to be inlined.
+	 * @return `true` if deserialization was successful, `false` otherwise.
+	 */
+	bool fromTrivialBytes(
+		T& oVar, const void* payloadBuffer, std::size_t payloadSize, std::true_type);
+	/** @brief Never called, `T` is not trivially copyable. */
+	bool fromTrivialBytes(
+		T& oVar, const void* payloadBuffer, std::size_t payloadSize, std::false_type);
 
 
 	/****************
@@ -619,6 +3111,34 @@ private:
 	 * and deserialization of record payloads from and to objects of type `T`.
 	 */
 	std::unique_ptr<PayloadType<T>> mPayloadType;
+	/**
+	 * @brief Whether `mPayloadType` is a `TrivialPayloadType<T>`. Payloads of
+	 * such channels are serialized as views of their in-memory bytes and
+	 * deserialized without virtual calls.
+	 */
+	bool mTrivialPayload;
+	/** @brief Whether `put()` and `puta()` group the records by CID. */
+	bool mGroupByCid;
+	/** @brief Whether `put()` and `puta()` validate the keys of the set in
+	 * bulk. @see `setPutBulkKeyValidation()` */
+	bool mBulkKeyValidation;
+	/**
+	 * @brief Pointers to the records of the current PUT/A request ordered by
+	 * CID. Only used with CID grouping enabled, empty between requests.
+	 */
+	std::vector<const Record<T>*> mGroupedRecords;
+	/** @brief The amount of batches received ahead by `getStream()`.
+	 * @see `setStreamPrefetch()` */
+	std::size_t mStreamPrefetch;
+	/** @brief When `getStream()` cuts the batches.
+	 * @see `setStreamBatching()` */
+	StreamBatching mStreamBatching;
+	/** @brief The handler of the skipped GET records, empty if they fail the
+	 * query. @see `setOversizedRecordHandler()` */
+	std::function<void(const Key&, std::size_t)> mOversizedRecordHandler;
+	/** @brief Whether `get()` counts the records of unknown key-intervals
+	 * first. @see `setCountBeforeGet()` */
+	bool mCountBeforeGet;
 };
 
 } /*namespace tstorage*/
@@ -27,32 +27,70 @@
 #include "Channel.h"  // clangd integration
 #endif
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <ratio>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "Arena.h"
+#include "ArrowRecordsSet.h"
+#include "BlobRecordsSet.h"
 #include "ChannelBase.h"
+#include "ColumnarRecordsSet.h"
 #include "DataTypes.h"
+#include "LazyRecordsSet.h"
+#include "MixedRecordsSet.h"
 #include "PayloadType.h"
+#include "PutStream.h"
 #include "RecordsSet.h"
 #include "Response.h"
 #include "ResponseAcq.h"
 #include "ResponseGet.h"
+#include "SeriesSet.h"
+#include "TrivialPayloadType.h"
 
 /** @file
  * @brief Contains the high-level implementation of `Channel<T>`. */
 
 namespace tstorage {
 
+template<typename T>
+constexpr std::size_t Channel<T>::cDecodeChunkRecords;
+template<typename T>
+constexpr std::size_t Channel<T>::cDecodeChunkBytes;
+template<typename T>
+constexpr std::size_t Channel<T>::cEncodeSliceRecords;
+template<typename T>
+constexpr std::size_t Channel<T>::cEncodeSlicesPerThread;
+template<typename T>
+constexpr std::size_t Channel<T>::cMaxReservedGetBytes;
+
 template<typename T>
 Channel<T>::Channel(const std::string& hostname,
 	const std::uint16_t port,
 	std::unique_ptr<PayloadType<T>> payloadType)
-	: ChannelBase(), mPayloadType(std::move(payloadType))
+	: ChannelBase(),
+	  mPayloadType(std::move(payloadType)),
+	  mTrivialPayload(isTrivialPayload(mPayloadType.get(), IsTrivialT{})),
+	  mGroupByCid(false),
+	  mBulkKeyValidation(false),
+	  mStreamPrefetch(0),
+	  mStreamBatching(),
+	  mOversizedRecordHandler(),
+	  mCountBeforeGet(false)
 {
 	setHost(hostname, port);
 }
@@ -62,7 +100,7 @@ Channel<T>::Channel(const std::string& hostname,
 	const std::uint16_t port,
 	std::unique_ptr<PayloadType<T>> payloadType,
 	std::size_t memoryLimitBytes)
-	: Channel<T>(hostname, port, payloadType)
+	: Channel<T>(hostname, port, std::move(payloadType))
 {
 	setMemoryLimit(memoryLimitBytes);
 }
@@ -80,287 +118,2201 @@ Response Channel<T>::connect()
 }
 
 template<typename T>
-Response Channel<T>::close()
+Response Channel<T>::close()
+{
+	return Response(closeImpl());
+}
+
+template<typename T>
+bool Channel<T>::connected() const
+{
+	return connectedImpl();
+}
+
+template<typename T>
+void Channel<T>::setTimeout(const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	setTimeoutImpl(timeout);
+}
+
+template<typename T>
+void Channel<T>::setConnectTimeout(const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	setConnectTimeoutImpl(timeout);
+}
+
+template<typename T>
+void Channel<T>::setAddressCacheTtl(const std::chrono::duration<std::int64_t, std::milli> ttl)
+{
+	setAddressCacheTtlImpl(ttl);
+}
+
+template<typename T>
+void Channel<T>::setRetryPolicy(const RetryPolicy& policy)
+{
+	setRetryPolicyImpl(policy);
+}
+
+template<typename T>
+template<typename Request>
+auto Channel<T>::withRetries(const bool put, Request request) -> decltype(request())
+{
+	auto response = request();
+	std::uint32_t attempt = 1;
+	while (response.error() && retryImpl(response.status(), attempt, put)) {
+		response = request();
+	}
+	return response;
+}
+
+template<typename T>
+void Channel<T>::setBusyPoll(const std::chrono::duration<std::int64_t, std::micro> busyPoll)
+{
+	setBusyPollImpl(busyPoll);
+}
+
+template<typename T>
+void Channel<T>::setReceiveLowWatermark(const std::size_t limitBytes)
+{
+	setReceiveLowWatermarkImpl(limitBytes);
+}
+
+template<typename T>
+void Channel<T>::setIoUring(const bool enabled)
+{
+	setIoUringImpl(enabled);
+}
+
+template<typename T>
+void Channel<T>::setSignalRestart(const bool enabled)
+{
+	setSignalRestartImpl(enabled);
+}
+
+template<typename T>
+void Channel<T>::setSocketOptions(const SocketOptions& options)
+{
+	setSocketOptionsImpl(options);
+}
+
+template<typename T>
+void Channel<T>::setTlsOptions(const TlsOptions& options)
+{
+	setTlsOptionsImpl(options);
+}
+
+template<typename T>
+ReceiveStats Channel<T>::receiveStats() const
+{
+	return receiveStatsImpl();
+}
+
+template<typename T>
+ChannelStats Channel<T>::stats() const
+{
+	return statsImpl();
+}
+
+template<typename T>
+void Channel<T>::setTracer(std::shared_ptr<Tracer> tracer)
+{
+	setTracerImpl(std::move(tracer));
+}
+
+template<typename T>
+void Channel<T>::setDecodeThreads(const std::size_t threads)
+{
+	setDecodeThreadsImpl(threads);
+}
+
+template<typename T>
+std::size_t Channel<T>::decodeThreads() const
+{
+	return decodeThreadsImpl();
+}
+
+template<typename T>
+void Channel<T>::setEncodeThreads(const std::size_t threads)
+{
+	setEncodeThreadsImpl(threads);
+}
+
+template<typename T>
+std::size_t Channel<T>::encodeThreads() const
+{
+	return encodeThreadsImpl();
+}
+
+template<typename T>
+void Channel<T>::setStreamPrefetch(const std::size_t batches)
+{
+	mStreamPrefetch = batches;
+}
+
+template<typename T>
+void Channel<T>::setStreamBatching(const StreamBatching& batching)
+{
+	mStreamBatching = batching;
+}
+
+template<typename T>
+void Channel<T>::setOversizedRecordHandler(
+	const std::function<void(const Key& key, std::size_t payloadSize)>& handler)
+{
+	mOversizedRecordHandler = handler;
+}
+
+template<typename T>
+void Channel<T>::setCountBeforeGet(const bool enabled)
+{
+	mCountBeforeGet = enabled;
+}
+
+template<typename T>
+void Channel<T>::setMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	setMemoryLimitImpl(memoryLimitBytes);
+}
+
+template<typename T>
+void Channel<T>::setSendMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	setSendMemoryLimitImpl(memoryLimitBytes);
+}
+
+template<typename T>
+void Channel<T>::setReceiveMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	setReceiveMemoryLimitImpl(memoryLimitBytes);
+}
+
+template<typename T>
+void Channel<T>::setReceiveBufferGrowth(const std::size_t maxMemoryLimitBytes)
+{
+	setReceiveBufferGrowthImpl(maxMemoryLimitBytes);
+}
+
+template<typename T>
+void Channel<T>::setBufferAutoTuning(const BufferAutoTuning& tuning)
+{
+	setBufferAutoTuningImpl(tuning);
+}
+
+template<typename T>
+void Channel<T>::setPutFlowControl(const PutFlowControl& options)
+{
+	setPutFlowControlImpl(options);
+}
+
+template<typename T>
+void Channel<T>::setPutDedupFilter(std::shared_ptr<PutDedupFilter> filter)
+{
+	setPutDedupFilterImpl(std::move(filter));
+}
+
+template<typename T>
+void Channel<T>::setBufferRelease(const std::chrono::duration<std::int64_t, std::milli> idle)
+{
+	setBufferReleaseImpl(idle);
+}
+
+template<typename T>
+void Channel<T>::setBufferPoolLimit(const std::size_t limitBytes)
+{
+	setBufferPoolLimitImpl(limitBytes);
+}
+
+template<typename T>
+void Channel<T>::setBufferAllocation(const BufferAllocation& allocation)
+{
+	setBufferAllocationImpl(allocation);
+}
+
+template<typename T>
+void Channel<T>::setMemoryBudget(std::shared_ptr<MemoryBudget> budget)
+{
+	setMemoryBudgetImpl(std::move(budget));
+}
+
+template<typename T>
+void Channel<T>::setPutPipelineDepth(const std::size_t depth)
+{
+	setPutPipelineDepthImpl(depth);
+}
+
+template<typename T>
+void Channel<T>::setPutCidGrouping(const bool enabled)
+{
+	mGroupByCid = enabled;
+}
+
+template<typename T>
+bool Channel<T>::putCidGrouping() const
+{
+	return mGroupByCid;
+}
+
+template<typename T>
+void Channel<T>::setPutBulkKeyValidation(const bool enabled)
+{
+	mBulkKeyValidation = enabled;
+}
+
+template<typename T>
+void Channel<T>::setPutBatchCoalescing(const bool enabled)
+{
+	setPutBatchCoalescingImpl(enabled);
+}
+
+/**************
+ * Put
+ */
+
+template<typename T>
+struct Channel<T>::PutProto
+{
+	/** @brief `false`, the ACQs of the records are stamped by the server. */
+	static constexpr bool cWithAcq = false;
+
+	static result_t writeHeader(Channel<T>& channel) { return channel.writePutHeader(); }
+	static result_t obtainPayloadBuffer(
+		Channel<T>& channel, void*& oBuffer, std::size_t& oBufferSize, const Key& key)
+	{
+		return channel.obtainPutPayloadBuffer(oBuffer, oBufferSize, key);
+	}
+	static result_t reservePayloadBuffer(Channel<T>& channel,
+		void*& oBuffer,
+		std::size_t& oBufferSize,
+		const std::size_t payloadSize,
+		const Key& key)
+	{
+		return channel.reservePutPayloadBuffer(oBuffer, oBufferSize, payloadSize, key);
+	}
+	static result_t writeNextRecord(
+		Channel<T>& channel, const Key& key, const std::size_t payloadSize)
+	{
+		return channel.writeNextPutRecord(key, payloadSize);
+	}
+	static result_t writeNextRecordView(Channel<T>& channel,
+		const Key& key,
+		const void* payload,
+		const std::size_t payloadSize)
+	{
+		return channel.writeNextPutRecordView(key, payload, payloadSize);
+	}
+	static result_t writeNextRecordPieces(Channel<T>& channel,
+		const Key& key,
+		const std::size_t payloadSize,
+		const std::function<void(void*, std::size_t, std::size_t)>& fillPayload)
+	{
+		return channel.writeNextPutRecordPieces(key, payloadSize, fillPayload);
+	}
+	static result_t reserveChunkPayloadBuffer(Channel<T>& channel,
+		const std::size_t chunk,
+		void*& oBuffer,
+		std::size_t& oBufferSize,
+		const std::size_t payloadSize,
+		const Key& key)
+	{
+		return channel.reservePutChunkPayloadBuffer(chunk, oBuffer, oBufferSize, payloadSize, key);
+	}
+	static result_t writeNextChunkRecord(Channel<T>& channel,
+		const std::size_t chunk,
+		const Key& key,
+		const std::size_t payloadSize)
+	{
+		return channel.writeNextPutChunkRecord(chunk, key, payloadSize);
+	}
+	static result_t readResult(Channel<T>& channel) { return channel.readPutResult(); }
+};
+
+template<typename T>
+struct Channel<T>::PutAProto
+{
+	/** @brief `true`, the ACQs are supplied with the records. */
+	static constexpr bool cWithAcq = true;
+
+	static result_t writeHeader(Channel<T>& channel) { return channel.writePutAHeader(); }
+	static result_t obtainPayloadBuffer(
+		Channel<T>& channel, void*& oBuffer, std::size_t& oBufferSize, const Key& key)
+	{
+		return channel.obtainPutAPayloadBuffer(oBuffer, oBufferSize, key);
+	}
+	static result_t reservePayloadBuffer(Channel<T>& channel,
+		void*& oBuffer,
+		std::size_t& oBufferSize,
+		const std::size_t payloadSize,
+		const Key& key)
+	{
+		return channel.reservePutAPayloadBuffer(oBuffer, oBufferSize, payloadSize, key);
+	}
+	static result_t writeNextRecord(
+		Channel<T>& channel, const Key& key, const std::size_t payloadSize)
+	{
+		return channel.writeNextPutARecord(key, payloadSize);
+	}
+	static result_t writeNextRecordView(Channel<T>& channel,
+		const Key& key,
+		const void* payload,
+		const std::size_t payloadSize)
+	{
+		return channel.writeNextPutARecordView(key, payload, payloadSize);
+	}
+	static result_t writeNextRecordPieces(Channel<T>& channel,
+		const Key& key,
+		const std::size_t payloadSize,
+		const std::function<void(void*, std::size_t, std::size_t)>& fillPayload)
+	{
+		return channel.writeNextPutARecordPieces(key, payloadSize, fillPayload);
+	}
+	static result_t reserveChunkPayloadBuffer(Channel<T>& channel,
+		const std::size_t chunk,
+		void*& oBuffer,
+		std::size_t& oBufferSize,
+		const std::size_t payloadSize,
+		const Key& key)
+	{
+		return channel.reservePutAChunkPayloadBuffer(chunk, oBuffer, oBufferSize, payloadSize, key);
+	}
+	static result_t writeNextChunkRecord(Channel<T>& channel,
+		const std::size_t chunk,
+		const Key& key,
+		const std::size_t payloadSize)
+	{
+		return channel.writeNextPutAChunkRecord(chunk, key, payloadSize);
+	}
+	static result_t readResult(Channel<T>& channel) { return channel.readPutAResult(); }
+};
+
+template<typename T>
+template<typename Proto, typename Writer>
+result_t Channel<T>::putImpl(Writer writeRecords)
+{
+	result_t res = Proto::writeHeader(*this);
+	if (res != result_t::OK) {
+		abort();
+		return res;
+	}
+
+	res = writeRecords();
+	if (res != result_t::OK) {
+		return endPutOnError<Proto>(res);
+	}
+	return putFinalize<Proto>();
+}
+
+template<typename T>
+template<typename Proto>
+result_t Channel<T>::endPutOnError(const result_t res)
+{
+	if (res == result_t::PAYLOAD_TOO_LARGE || res == result_t::INVALID_KEY) {
+		if (putFinalize<Proto>() == result_t::OK) {
+			(void)close();
+		} else {
+			abort();
+		}
+		return res;
+	}
+	abort();
+	return res;
+}
+
+template<typename T>
+template<typename Proto, typename InputIt>
+result_t Channel<T>::writeRecordRange(InputIt first, const InputIt last)
+{
+	for (; first != last; ++first) {
+		const result_t res = serializeAndWriteRecord<Proto>(*first);
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+template<typename Proto>
+result_t Channel<T>::writeGeneratedRecords(const std::function<bool(Record<T>&)>& generator)
+{
+	Record<T> record{};
+	while (generator(record)) {
+		const result_t res = serializeAndWriteRecord<Proto>(record);
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+template<typename Proto, typename InputIt>
+result_t Channel<T>::writeRawRecordRange(InputIt first, const InputIt last)
+{
+	for (; first != last; ++first) {
+		const RawRecord& record = *first;
+		const result_t res =
+			Proto::writeNextRecordView(*this, record.key, record.payload, record.size);
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+template<typename Proto>
+result_t Channel<T>::serializeAndWriteRecord(const Record<T>& record)
+{
+	const void* view{};
+	std::size_t viewSize{};
+	if (mTrivialPayload) {
+		return Proto::writeNextRecordView(*this, record.key, &record.value, sizeof(T));
+	}
+	if (mPayloadType->toView(record.value, view, viewSize)) {
+		return Proto::writeNextRecordView(*this, record.key, view, viewSize);
+	}
+
+	void* buffer{};
+	std::size_t bufferSize{};
+	std::size_t payloadSize{};
+
+	// A payload which doesn't fit in the send buffer goes in pieces, if the
+	// payload type can serialize them.
+	const auto writePieces = [this, &record](const std::size_t size) {
+		return Proto::writeNextRecordPieces(*this, record.key, size,
+			[this, &record](void* piece, std::size_t offset, std::size_t pieceSize) {
+				mPayloadType->toChunk(record.value, offset, piece, pieceSize);
+			});
+	};
+
+	const bool hinted = mPayloadType->sizeHint(record.value, payloadSize);
+	result_t res = hinted
+		? Proto::reservePayloadBuffer(*this, buffer, bufferSize, payloadSize, record.key)
+		: Proto::obtainPayloadBuffer(*this, buffer, bufferSize, record.key);
+	if (res == result_t::MEMORY_LIMIT_EXCEEDED && hinted && mPayloadType->chunked()) {
+		return writePieces(payloadSize);
+	}
+	if (res != result_t::OK) {
+		return res;
+	}
+	payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
+	if (bufferSize < payloadSize) {
+		res = Proto::reservePayloadBuffer(*this, buffer, bufferSize, payloadSize, record.key);
+		if (res == result_t::MEMORY_LIMIT_EXCEEDED && mPayloadType->chunked()) {
+			return writePieces(payloadSize);
+		}
+		if (res != result_t::OK) {
+			return res;
+		}
+		payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
+	}
+	return Proto::writeNextRecord(*this, record.key, payloadSize);
+}
+
+template<typename T>
+bool Channel<T>::encodesInParallel(const std::size_t count) const
+{
+	return encodeThreadsImpl() != 0 && !mTrivialPayload && count > cEncodeSliceRecords;
+}
+
+template<typename T>
+template<typename Proto, typename RandomIt>
+result_t Channel<T>::writeRecordRangeInParallel(const RandomIt first, const RandomIt last)
+{
+	using Diff = typename std::iterator_traits<RandomIt>::difference_type;
+	const std::size_t records = static_cast<std::size_t>(last - first);
+	const std::size_t slicesPerRound = cEncodeSlicesPerThread * (encodeThreadsImpl() + 1);
+	std::vector<result_t> results;
+
+	std::size_t done = 0;
+	while (done < records) {
+		const std::size_t slices = std::min(
+			slicesPerRound, (records - done + cEncodeSliceRecords - 1) / cEncodeSliceRecords);
+		preparePutChunks(slices);
+		results.assign(slices, result_t::OK);
+		for (std::size_t i = 0; i < slices; ++i) {
+			const RandomIt sliceFirst = first + static_cast<Diff>(done + i * cEncodeSliceRecords);
+			const RandomIt sliceLast =
+				first + static_cast<Diff>(std::min(records, done + (i + 1) * cEncodeSliceRecords));
+			submitEncodeTaskImpl([this, i, sliceFirst, sliceLast, &results]() {
+				results[i] = serializeSliceToChunk<Proto>(i, sliceFirst, sliceLast);
+			});
+		}
+		waitEncodeTasksImpl();
+
+		// The chunk of a failed slice holds the records preceding the failure,
+		// which are sent like the records written before an error serially.
+		std::size_t sent = 0;
+		result_t res = result_t::OK;
+		while (sent < slices && res == result_t::OK) {
+			res = results[sent++];
+		}
+		const result_t resWrite = writePutChunks(sent);
+		if (resWrite != result_t::OK) {
+			return resWrite;
+		}
+		if (res != result_t::OK) {
+			return res;
+		}
+		done = std::min(records, done + slices * cEncodeSliceRecords);
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+template<typename Proto, typename RandomIt>
+result_t Channel<T>::serializeSliceToChunk(const std::size_t chunk, RandomIt first, const RandomIt last)
+{
+	for (; first != last; ++first) {
+		const result_t res = serializeRecordToChunk<Proto>(chunk, recordOf(*first));
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+template<typename Proto>
+result_t Channel<T>::serializeRecordToChunk(const std::size_t chunk, const Record<T>& record)
+{
+	void* buffer{};
+	std::size_t bufferSize{};
+	const void* view{};
+	std::size_t viewSize{};
+	if (mPayloadType->toView(record.value, view, viewSize)) {
+		const result_t res = Proto::reserveChunkPayloadBuffer(
+			*this, chunk, buffer, bufferSize, viewSize, record.key);
+		if (res != result_t::OK) {
+			return res;
+		}
+		std::memcpy(buffer, view, viewSize);
+		return Proto::writeNextChunkRecord(*this, chunk, record.key, viewSize);
+	}
+
+	std::size_t payloadSize{};
+	if (!mPayloadType->sizeHint(record.value, payloadSize)) {
+		payloadSize = 0;
+	}
+	result_t res = Proto::reserveChunkPayloadBuffer(
+		*this, chunk, buffer, bufferSize, payloadSize, record.key);
+	if (res != result_t::OK) {
+		return res;
+	}
+	payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
+	if (bufferSize < payloadSize) {
+		res = Proto::reserveChunkPayloadBuffer(
+			*this, chunk, buffer, bufferSize, payloadSize, record.key);
+		if (res != result_t::OK) {
+			return res;
+		}
+		payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
+	}
+	return Proto::writeNextChunkRecord(*this, chunk, record.key, payloadSize);
+}
+
+template<typename T>
+template<typename Proto>
+result_t Channel<T>::putFinalize()
+{
+	result_t res = writeFin();
+	if (res != result_t::OK) {
+		abort();
+		return res;
+	}
+
+	res = Proto::readResult(*this);
+	if (res != result_t::OK) {
+		abort();
+		return res;
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+Response Channel<T>::put(const RecordsSet<T>& data)
+{
+	return withRetries(
+		true, [this, &data]() { return Response(putRecordsSet<PutProto>(data)); });
+}
+
+template<typename T>
+Response Channel<T>::puta(const RecordsSet<T>& data)
+{
+	return withRetries(
+		true, [this, &data]() { return Response(putRecordsSet<PutAProto>(data)); });
+}
+
+template<typename T>
+Response Channel<T>::put(
+	const RecordsSet<T>& data, const std::chrono::steady_clock::time_point deadline)
+{
+	if (std::chrono::steady_clock::now() >= deadline) {
+		return Response(result_t::CONNTIMEOUT);
+	}
+	const DeadlineScope scope(*this, deadline);
+	return put(data);
+}
+
+template<typename T>
+Response Channel<T>::puta(
+	const RecordsSet<T>& data, const std::chrono::steady_clock::time_point deadline)
+{
+	if (std::chrono::steady_clock::now() >= deadline) {
+		return Response(result_t::CONNTIMEOUT);
+	}
+	const DeadlineScope scope(*this, deadline);
+	return puta(data);
+}
+
+template<typename T>
+template<typename Proto>
+result_t Channel<T>::putRecordsSet(const RecordsSet<T>& recordSet)
+{
+	const auto cidLess = [](const Record<T>& a, const Record<T>& b) {
+		return a.key.cid < b.key.cid;
+	};
+	setPutKeysValidated(mBulkKeyValidation && allKeysStorable<Proto>(recordSet));
+	result_t res{};
+	if (!mGroupByCid || std::is_sorted(recordSet.begin(), recordSet.end(), cidLess)) {
+		res = putImpl<Proto>([this, &recordSet]() {
+			return encodesInParallel(recordSet.size())
+				? writeRecordRangeInParallel<Proto>(recordSet.begin(), recordSet.end())
+				: writeRecordRange<Proto>(recordSet.begin(), recordSet.end());
+		});
+	} else {
+		mGroupedRecords.clear();
+		mGroupedRecords.reserve(recordSet.size());
+		for (const Record<T>& record : recordSet) {
+			mGroupedRecords.push_back(&record);
+		}
+		std::stable_sort(mGroupedRecords.begin(),
+			mGroupedRecords.end(),
+			[&cidLess](const Record<T>* a, const Record<T>* b) { return cidLess(*a, *b); });
+		res = putImpl<Proto>([this]() { return writeGroupedRecords<Proto>(); });
+		mGroupedRecords.clear();
+	}
+	setPutKeysValidated(false);
+	return res;
+}
+
+template<typename T>
+template<typename Proto>
+bool Channel<T>::allKeysStorable(const RecordsSet<T>& recordSet)
+{
+	// No early exit, so that the loop vectorizes; invalid keys are rare.
+	bool storable = true;
+	for (const Record<T>& record : recordSet) {
+		storable &= record.key.isStorable(Proto::cWithAcq);
+	}
+	return storable;
+}
+
+template<typename T>
+template<typename Proto>
+result_t Channel<T>::writeGroupedRecords()
+{
+	if (encodesInParallel(mGroupedRecords.size())) {
+		return writeRecordRangeInParallel<Proto>(
+			mGroupedRecords.cbegin(), mGroupedRecords.cend());
+	}
+	for (const Record<T>* record : mGroupedRecords) {
+		const result_t res = serializeAndWriteRecord<Proto>(*record);
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+template<typename InputIt>
+Response Channel<T>::put(const InputIt first, const InputIt last)
+{
+	return Response(putImpl<PutProto>(
+		[this, first, last]() { return writeRecordRange<PutProto>(first, last); }));
+}
+
+template<typename T>
+template<typename InputIt>
+Response Channel<T>::puta(const InputIt first, const InputIt last)
+{
+	return Response(putImpl<PutAProto>(
+		[this, first, last]() { return writeRecordRange<PutAProto>(first, last); }));
+}
+
+template<typename T>
+Response Channel<T>::putFrom(const std::function<bool(Record<T>&)>& generator)
+{
+	return Response(putImpl<PutProto>(
+		[this, &generator]() { return writeGeneratedRecords<PutProto>(generator); }));
+}
+
+template<typename T>
+Response Channel<T>::putaFrom(const std::function<bool(Record<T>&)>& generator)
+{
+	return Response(putImpl<PutAProto>(
+		[this, &generator]() { return writeGeneratedRecords<PutAProto>(generator); }));
+}
+
+template<typename T>
+template<typename InputIt>
+Response Channel<T>::putRaw(const InputIt first, const InputIt last)
+{
+	return Response(putImpl<PutProto>(
+		[this, first, last]() { return writeRawRecordRange<PutProto>(first, last); }));
+}
+
+template<typename T>
+template<typename InputIt>
+Response Channel<T>::putaRaw(const InputIt first, const InputIt last)
+{
+	return Response(putImpl<PutAProto>(
+		[this, first, last]() { return writeRawRecordRange<PutAProto>(first, last); }));
+}
+
+template<typename T>
+Response Channel<T>::putFromFile(const int fd, const std::uint64_t offset, const std::uint64_t length)
+{
+	return Response(putImpl<PutProto>(
+		[this, fd, offset, length]() { return writeFileBatches(fd, offset, length); }));
+}
+
+template<typename T>
+Response Channel<T>::putaFromFile(const int fd, const std::uint64_t offset, const std::uint64_t length)
+{
+	return Response(putImpl<PutAProto>(
+		[this, fd, offset, length]() { return writeFileBatches(fd, offset, length); }));
+}
+
+template<typename T>
+PutStream<T> Channel<T>::putStream(const std::chrono::duration<std::int64_t, std::milli> linger)
+{
+	const result_t res = writePutHeader();
+	if (res != result_t::OK) {
+		abort();
+	}
+	return PutStream<T>(*this, false, linger, res);
+}
+
+template<typename T>
+PutStream<T> Channel<T>::putaStream(const std::chrono::duration<std::int64_t, std::milli> linger)
+{
+	const result_t res = writePutAHeader();
+	if (res != result_t::OK) {
+		abort();
+	}
+	return PutStream<T>(*this, true, linger, res);
+}
+
+template<typename T>
+result_t Channel<T>::putStreamAppend(const bool puta, const Record<T>& record)
+{
+	if (puta) {
+		const result_t res = serializeAndWriteRecord<PutAProto>(record);
+		return res == result_t::OK ? res : endPutOnError<PutAProto>(res);
+	}
+	const result_t res = serializeAndWriteRecord<PutProto>(record);
+	return res == result_t::OK ? res : endPutOnError<PutProto>(res);
+}
+
+template<typename T>
+result_t Channel<T>::putStreamFlush()
+{
+	const result_t res = flushPut();
+	if (res != result_t::OK) {
+		abort();
+	}
+	return res;
+}
+
+template<typename T>
+result_t Channel<T>::putStreamFinish(const bool puta)
+{
+	return puta ? putFinalize<PutAProto>() : putFinalize<PutProto>();
+}
+
+/**************
+ * Get
+ */
+
+template<typename T>
+ResponseAcq Channel<T>::getAcq(const Key& keyMin, const Key& keyMax)
+{
+	return withRetries(
+		false, [this, &keyMin, &keyMax]() { return getAcqOnce(keyMin, keyMax); });
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getAcq(const Key& keyMin,
+	const Key& keyMax,
+	const std::chrono::steady_clock::time_point deadline)
+{
+	if (std::chrono::steady_clock::now() >= deadline) {
+		return ResponseAcq(result_t::CONNTIMEOUT);
+	}
+	const DeadlineScope scope(*this, deadline);
+	return getAcq(keyMin, keyMax);
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getAcqOnce(const Key& keyMin, const Key& keyMax)
+{
+	const result_t res = writeGetAcqRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	return readGetAcqResponse();
+}
+
+template<typename T>
+ResponseAcq Channel<T>::readGetAcqResponse()
+{
+	Key::AcqT acq{};
+	const result_t res = readAcq(acq);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	return ResponseAcq(res, acq);
+}
+
+template<typename T>
+ResponseGet<T> Channel<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	return get(keyMin, keyMax, std::allocator<Record<T>>());
+}
+
+template<typename T>
+ResponseGet<T> Channel<T>::get(const Key& keyMin,
+	const Key& keyMax,
+	const std::chrono::steady_clock::time_point deadline)
+{
+	if (std::chrono::steady_clock::now() >= deadline) {
+		return ResponseGet<T>(result_t::CONNTIMEOUT);
+	}
+	const DeadlineScope scope(*this, deadline);
+	return get(keyMin, keyMax);
+}
+
+template<typename T>
+template<typename Alloc>
+ResponseGet<T, Alloc> Channel<T>::get(const Key& keyMin, const Key& keyMax, const Alloc& alloc)
+{
+	const std::size_t expectedRecords = expectedGetRecords(keyMin, keyMax);
+	return withRetries(false, [this, &keyMin, &keyMax, &alloc, expectedRecords]() {
+		return getOnce(keyMin, keyMax, alloc, expectedRecords);
+	});
+}
+
+template<typename T>
+ResponseGet<T> Channel<T>::getExpecting(
+	const Key& keyMin, const Key& keyMax, const std::size_t expectedRecords)
+{
+	return withRetries(false, [this, &keyMin, &keyMax, expectedRecords]() {
+		return getOnce(keyMin, keyMax, std::allocator<Record<T>>(), expectedRecords);
+	});
+}
+
+template<typename T>
+std::size_t Channel<T>::expectedGetRecords(const Key& keyMin, const Key& keyMax)
+{
+	std::size_t records = 0;
+	if (predictGetRecords(keyMin, keyMax, records) || !mCountBeforeGet) {
+		return records;
+	}
+	std::uint64_t counted = 0;
+	if (!countRange(keyMin, keyMax, counted).error()) {
+		records = static_cast<std::size_t>(counted);
+	}
+	return records;
+}
+
+template<typename T>
+template<typename Alloc>
+ResponseGet<T, Alloc> Channel<T>::getOnce(const Key& keyMin,
+	const Key& keyMax,
+	const Alloc& alloc,
+	const std::size_t expectedRecords)
+{
+	const result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseGet<T, Alloc>(res);
+	}
+
+	// A count of a huge key-interval must not allocate it all before a single
+	// record is received.
+	RecordsSet<T, Alloc> recordSet(alloc);
+	recordSet.reserve(std::min(expectedRecords, cMaxReservedGetBytes / sizeof(Record<T>)));
+	const ResponseAcq response = readGetResponseTo(recordSet);
+	if (!response.error()) {
+		countGetRecords(keyMin, keyMax, recordSet.size());
+	}
+	return ResponseGet<T, Alloc>(
+		response.status(), std::move(recordSet), response.error() ? 0 : response.acq());
+}
+
+template<typename T>
+ResponseGet<T> Channel<T>::readGetResponse()
+{
+	RecordsSet<T> recordSet{};
+	const ResponseAcq res = readGetResponseTo(recordSet);
+	return ResponseGet<T>(res.status(), std::move(recordSet), res.error() ? 0 : res.acq());
+}
+
+template<typename T>
+template<typename Set>
+ResponseAcq Channel<T>::readGetResponseTo(Set& recordSet)
+{
+	result_t res = readResponse();
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	{
+		const ArenaScope scope(arenaOf(recordSet));
+		res = recvAndDeserializeRecordsTo(recordSet, false);
+		if (res != result_t::END_OF_STREAM) {
+			abort();
+			return ResponseAcq(res);
+		}
+	}
+
+	Key::AcqT acq{};
+	res = readGetResult(acq);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+	return ResponseAcq(res, acq);
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getColumnar(
+	const Key& keyMin, const Key& keyMax, ColumnarRecordsSet<T>& oRecords)
+{
+	const result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	return readGetResponseTo(oRecords);
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getStream(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(RecordsSet<T>&)>& callback)
+{
+	return getStreamImpl(keyMin, keyMax, continuing(callback), RecordsSet<T>());
+}
+
+template<typename T>
+template<typename Alloc, typename Callback>
+ResponseAcq Channel<T>::getStream(
+	const Key& keyMin, const Key& keyMax, const Alloc& alloc, Callback callback)
+{
+	const std::function<void(RecordsSet<T, Alloc>&)> function(std::move(callback));
+	return getStreamImpl(keyMin, keyMax, continuing(function), RecordsSet<T, Alloc>(alloc));
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getStreamUntil(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<bool(RecordsSet<T>&)>& callback,
+	const CancellationToken& token)
+{
+	if (token.cancelled()) {
+		return ResponseAcq(result_t::CANCELLED);
+	}
+	const std::function<bool(RecordsSet<T>&)> proceed
+		= [&callback, &token](RecordsSet<T>& batch) {
+			  return callback(batch) && !token.cancelled();
+		  };
+	return getStreamImpl(keyMin, keyMax, proceed, RecordsSet<T>());
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getStreamColumnar(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(ColumnarRecordsSet<T>&)>& callback)
+{
+	return getStreamImpl(keyMin, keyMax, continuing(callback), ColumnarRecordsSet<T>());
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getSeries(const Key& keyMin, const Key& keyMax, SeriesSet<T>& oRecords)
+{
+	const result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	return readGetResponseTo(oRecords);
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getStreamSeries(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(SeriesSet<T>&)>& callback)
+{
+	return getStreamImpl(keyMin, keyMax, continuing(callback), SeriesSet<T>());
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getBlob(const Key& keyMin, const Key& keyMax, BlobRecordsSet& oRecords)
+{
+	const result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	return readGetResponseTo(oRecords);
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getStreamBlob(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(BlobRecordsSet&)>& callback)
+{
+	return getStreamImpl(keyMin, keyMax, continuing(callback), BlobRecordsSet());
+}
+
+template<typename T>
+template<typename... Ts>
+ResponseAcq Channel<T>::getMixed(
+	const Key& keyMin, const Key& keyMax, MixedRecordsSet<Ts...>& oRecords)
+{
+	bool decoded = true;
+	const ResponseAcq response = getView(keyMin,
+		keyMax,
+		[&oRecords, &decoded](const Key& key, const void* payload, const std::size_t size) {
+			decoded = oRecords.append(key, payload, size) && decoded;
+		});
+	if (response.success() && !decoded) {
+		return ResponseAcq(result_t::DESERIALIZATION_ERROR);
+	}
+	return response;
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getLazy(const Key& keyMin, const Key& keyMax, LazyRecordsSet<T>& oRecords)
+{
+	if (!oRecords.mOwnPayloadType) {
+		oRecords.mPayloadType = mPayloadType.get();
+	}
+	return getBlob(keyMin, keyMax, oRecords.mRaw);
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getStreamArrow(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(ArrowRecordsSet&)>& callback,
+	const std::size_t fixedPayloadSize)
+{
+	return getStreamImpl(
+		keyMin, keyMax, continuing(callback), ArrowRecordsSet(fixedPayloadSize));
+}
+
+template<typename T>
+template<typename Set>
+ResponseAcq Channel<T>::getStreamImpl(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<bool(Set&)>& callback,
+	Set recordSet)
+{
+	bool delivered = false;
+	ResponseAcq response = getStreamOnce(keyMin, keyMax, callback, recordSet, delivered);
+	std::uint32_t attempt = 1;
+	while (response.error() && !delivered
+		   && retryImpl(response.status(), attempt, false)) {
+		response = getStreamOnce(keyMin, keyMax, callback, recordSet, delivered);
+	}
+	return response;
+}
+
+template<typename T>
+template<typename Set>
+ResponseAcq Channel<T>::getStreamOnce(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<bool(Set&)>& callback,
+	Set& ioRecordSet,
+	bool& oDelivered)
+{
+	result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	res = readResponse();
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	// A single set is reused for all batches so that its memory survives
+	// between them. The callback may move the records out of it, hence the
+	// explicit reservation based on the previous batch.
+	std::size_t lastBatchSize = 0;
+	long arenaShares = arenaOf(ioRecordSet).use_count();
+	if (mStreamPrefetch != 0 && !arenaOf(ioRecordSet)) {
+		res = streamPrefetchedBatches(callback, ioRecordSet, oDelivered);
+	}
+	while (res == result_t::OK) {
+		prepareBatch(ioRecordSet, lastBatchSize, arenaShares);
+		{
+			const ArenaScope scope(arenaOf(ioRecordSet));
+			res = recvAndDeserializeBatchTo(ioRecordSet);
+		}
+		lastBatchSize = ioRecordSet.size();
+		oDelivered = oDelivered || lastBatchSize != 0;
+		// Dropping the connection is cheaper than draining the rest of the
+		// response, which may be arbitrarily long.
+		if (!callback(ioRecordSet) && res == result_t::OK) {
+			res = result_t::CANCELLED;
+		}
+	}
+	if (res != result_t::END_OF_STREAM) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	Key::AcqT acq{};
+	res = readGetResult(acq);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+	return ResponseAcq(res, acq);
+}
+
+template<typename T>
+template<typename Set>
+void Channel<T>::prepareBatch(
+	Set& ioRecordSet, const std::size_t count, long& /*ioArenaShares*/)
+{
+	ioRecordSet.clear();
+	ioRecordSet.reserve(count);
+}
+
+template<typename T>
+void Channel<T>::prepareBatch(
+	ArenaRecordsSet<T>& ioRecordSet, const std::size_t count, long& ioArenaShares)
+{
+	std::shared_ptr<MonotonicArena> arena = arenaOf(ioRecordSet);
+	// Replacing the set drops the records of the last batch. Any shares of the
+	// arena in excess of those held at the start are then values kept by the
+	// callback, which must not be overwritten.
+	ioRecordSet = ArenaRecordsSet<T>(ArenaAllocator<Record<T>>(arena));
+	if (arena && arena.use_count() == ioArenaShares) {
+		arena->reset();
+	} else if (arena) {
+		arena = std::make_shared<MonotonicArena>();
+		ioRecordSet = ArenaRecordsSet<T>(ArenaAllocator<Record<T>>(arena));
+		ioArenaShares = arena.use_count();
+	}
+	ioRecordSet.reserve(count);
+}
+
+template<typename T>
+template<typename Set>
+Channel<T>::StreamPrefetch<Set>::~StreamPrefetch()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stop = true;
+	}
+	changed.notify_all();
+	if (reader.joinable()) {
+		reader.join();
+	}
+}
+
+template<typename T>
+template<typename Set>
+result_t Channel<T>::streamPrefetchedBatches(
+	const std::function<bool(Set&)>& callback, Set& ioRecordSet, bool& oDelivered)
+{
+	// One more set than the queue holds is being passed to the callback.
+	ioRecordSet.clear();
+	std::vector<Set> sets(mStreamPrefetch + 1, ioRecordSet);
+	StreamPrefetch<Set> prefetch;
+	for (Set& set : sets) {
+		prefetch.free.push_back(&set);
+	}
+
+	prefetch.reader = std::thread([this, &prefetch]() {
+		std::size_t lastBatchSize = 0;
+		long arenaShares = 0;
+		result_t res = result_t::OK;
+		while (res == result_t::OK) {
+			Set* set{};
+			{
+				std::unique_lock<std::mutex> lock(prefetch.mutex);
+				prefetch.changed.wait(
+					lock, [&prefetch]() { return !prefetch.free.empty() || prefetch.stop; });
+				if (prefetch.stop) {
+					break;
+				}
+				set = prefetch.free.front();
+				prefetch.free.pop_front();
+			}
+			prepareBatch(*set, lastBatchSize, arenaShares);
+			res = recvAndDeserializeBatchTo(*set);
+			lastBatchSize = set->size();
+			{
+				std::lock_guard<std::mutex> lock(prefetch.mutex);
+				prefetch.ready.push_back(set);
+				prefetch.status = res;
+			}
+			prefetch.changed.notify_all();
+		}
+		{
+			std::lock_guard<std::mutex> lock(prefetch.mutex);
+			prefetch.done = true;
+		}
+		prefetch.changed.notify_all();
+	});
+
+	while (true) {
+		Set* set{};
+		{
+			std::unique_lock<std::mutex> lock(prefetch.mutex);
+			prefetch.changed.wait(
+				lock, [&prefetch]() { return !prefetch.ready.empty() || prefetch.done; });
+			if (prefetch.ready.empty()) {
+				break;
+			}
+			set = prefetch.ready.front();
+			prefetch.ready.pop_front();
+		}
+		oDelivered = oDelivered || set->size() != 0;
+		const bool proceed = callback(*set);
+		bool stopped = false;
+		{
+			std::lock_guard<std::mutex> lock(prefetch.mutex);
+			prefetch.free.push_back(set);
+			// Past the last batch, the response has been received in full.
+			stopped = !proceed
+				&& (!prefetch.ready.empty() || prefetch.status == result_t::OK);
+			prefetch.stop = stopped;
+		}
+		prefetch.changed.notify_all();
+		if (stopped) {
+			// The reader may be blocked receiving the next batch.
+			interrupt();
+			prefetch.reader.join();
+			return result_t::CANCELLED;
+		}
+	}
+	prefetch.reader.join();
+	return prefetch.status;
+}
+
+template<typename T>
+template<typename Set>
+std::function<bool(Set&)> Channel<T>::continuing(const std::function<void(Set&)>& callback)
+{
+	return [&callback](Set& batch) {
+		callback(batch);
+		return true;
+	};
+}
+
+template<typename T>
+template<typename Set>
+std::shared_ptr<MonotonicArena> Channel<T>::arenaOf(const Set& /*recordSet*/)
+{
+	return std::shared_ptr<MonotonicArena>();
+}
+
+template<typename T>
+std::shared_ptr<MonotonicArena> Channel<T>::arenaOf(const ArenaRecordsSet<T>& recordSet)
+{
+	return recordSet.get_allocator().arena();
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getStreamResumable(const Key& keyMin,
+	const Key& keyMax,
+	const std::size_t subRanges,
+	const std::function<void(RecordsSet<T>&)>& callback)
+{
+	const ResponseAcq pin = getAcq(keyMin, keyMax);
+	if (pin.error()) {
+		return pin;
+	}
+	Key pinnedMax = keyMax;
+	pinnedMax.acq = std::min(keyMax.acq, pin.acq());
+	if (pinnedMax.acq <= keyMin.acq) {
+		return pin;
+	}
+
+	RecordsSet<T> recordSet{};
+	const std::function<bool(RecordsSet<T>&)> deliver = continuing(callback);
+	for (const KeyRange& range : splitKeyRange(KeyRange{keyMin, pinnedMax}, subRanges)) {
+		bool delivered = false;
+		ResponseAcq response
+			= getStreamOnce(range.keyMin, range.keyMax, deliver, recordSet, delivered);
+		std::uint32_t attempt = 1;
+		while (response.error() && retryImpl(response.status(), attempt, false)) {
+			response = getStreamOnce(range.keyMin, range.keyMax, deliver, recordSet, delivered);
+		}
+		if (response.error()) {
+			return response;
+		}
+	}
+	return pin;
+}
+
+template<typename T>
+ResponseAcq Channel<T>::tail(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<bool(RecordsSet<T>&)>& callback,
+	const std::chrono::duration<std::int64_t, std::milli> interval)
+{
+	Key pollMin = keyMin;
+	bool follow = true;
+	const std::function<bool(RecordsSet<T>&)> deliver = [&callback, &follow](RecordsSet<T>& batch) {
+		follow = callback(batch) && follow;
+		return true;
+	};
+	while (true) {
+		const std::chrono::steady_clock::time_point pollStart = std::chrono::steady_clock::now();
+		const ResponseAcq response = getStreamImpl(pollMin, keyMax, deliver, RecordsSet<T>());
+		if (response.error()) {
+			return response;
+		}
+		pollMin.acq = std::max(pollMin.acq, response.acq());
+		if (!follow || pollMin.acq >= keyMax.acq) {
+			return ResponseAcq(response.status(), pollMin.acq);
+		}
+		std::this_thread::sleep_until(pollStart + interval);
+	}
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getView(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(const Key&, const void*, std::size_t)>& visitor)
+{
+	return getVisitImpl(keyMin, keyMax, visitor);
+}
+
+template<typename T>
+template<typename Sink>
+ResponseAcq Channel<T>::getInto(const Key& keyMin, const Key& keyMax, Sink sink)
+{
+	bool deserialized = true;
+	const auto visitor = [this, &sink, &deserialized](
+							 const Key& key, const void* payload, const std::size_t size) {
+		if (!deserialized) {
+			return;
+		}
+		T& value = sink(key);
+		deserialized = mTrivialPayload ? fromTrivialBytes(value, payload, size, IsTrivialT{})
+									   : mPayloadType->fromBytes(value, payload, size);
+	};
+	const ResponseAcq response = getVisitImpl(keyMin, keyMax, visitor);
+	if (response.success() && !deserialized) {
+		return ResponseAcq(result_t::DESERIALIZATION_ERROR);
+	}
+	return response;
+}
+
+template<typename T>
+template<typename KeyIt, typename ValueIt>
+ResponseAcq Channel<T>::getInto(
+	const Key& keyMin, const Key& keyMax, KeyIt keys, ValueIt values)
+{
+	return getInto(keyMin, keyMax, [&keys, &values](const Key& key) -> T& {
+		*keys = key;
+		++keys;
+		return *values++;
+	});
+}
+
+template<typename T>
+ResponseAcq Channel<T>::countRange(
+	const Key& keyMin, const Key& keyMax, std::uint64_t& oRecords)
+{
+	std::uint64_t records = 0;
+	const auto visitor = [&records](const Key&, std::size_t) { ++records; };
+	const ResponseAcq response = getKeysImpl(keyMin, keyMax, visitor);
+	if (response.success()) {
+		oRecords = records;
+	}
+	return response;
+}
+
+template<typename T>
+ResponseAcq Channel<T>::countRange(const Key& keyMin,
+	const Key& keyMax,
+	std::uint64_t& oRecords,
+	std::map<Key::CidT, std::uint64_t>& oCids)
+{
+	std::uint64_t records = 0;
+	std::map<Key::CidT, std::uint64_t> cids;
+	// Records come sorted by CID, so the CID of the last one is looked up once.
+	std::uint64_t* cidRecords = nullptr;
+	Key::CidT lastCid{};
+	const auto visitor = [&](const Key& key, std::size_t) {
+		if (cidRecords == nullptr || key.cid != lastCid) {
+			cidRecords = &cids[key.cid];
+			lastCid = key.cid;
+		}
+		++*cidRecords;
+		++records;
+	};
+	const ResponseAcq response = getKeysImpl(keyMin, keyMax, visitor);
+	if (response.success()) {
+		oRecords = records;
+		oCids = std::move(cids);
+	}
+	return response;
+}
+
+template<typename T>
+ResponseAcq Channel<T>::sizeRange(const Key& keyMin, const Key& keyMax, RangeSizes& oSizes)
+{
+	RangeSizes sizes;
+	RangeSize* cidSize = nullptr;
+	Key::CidT lastCid{};
+	const auto visitor = [&](const Key& key, const std::size_t payloadSize) {
+		if (cidSize == nullptr || key.cid != lastCid) {
+			cidSize = &sizes.cids[key.cid];
+			lastCid = key.cid;
+		}
+		const std::uint64_t bytes = cSerializedKeySize + payloadSize;
+		++cidSize->records;
+		cidSize->bytes += bytes;
+		++sizes.total.records;
+		sizes.total.bytes += bytes;
+	};
+	const ResponseAcq response = getKeysImpl(keyMin, keyMax, visitor);
+	if (response.success()) {
+		oSizes = std::move(sizes);
+	}
+	return response;
+}
+
+template<typename T>
+Channel<T>::Stream::Stream(Channel<T>* const channel)
+	: mChannel(channel), mRecord{}, mResponse(result_t::OK)
+{
+}
+
+template<typename T>
+Channel<T>::Stream::Stream(const result_t status)
+	: mChannel(nullptr), mRecord{}, mResponse(status)
+{
+}
+
+template<typename T>
+Channel<T>::Stream::Stream(Stream&& other) noexcept
+	: mChannel(other.mChannel), mRecord(std::move(other.mRecord)), mResponse(other.mResponse)
+{
+	other.mChannel = nullptr;
+}
+
+template<typename T>
+Channel<T>::Stream::~Stream()
+{
+	if (mChannel != nullptr) {
+		mChannel->abort();
+	}
+}
+
+template<typename T>
+bool Channel<T>::Stream::next()
+{
+	if (mChannel == nullptr) {
+		return false;
+	}
+	const void* payloadBuffer{};
+	std::size_t payloadSize{};
+	const result_t res =
+		mChannel->readNextRecordDataCompacting(mRecord.key, payloadBuffer, payloadSize);
+	if (res == result_t::OK) {
+		mRecord.value = T{};
+		const bool deserialized = mChannel->mTrivialPayload
+			? mChannel->fromTrivialBytes(mRecord.value, payloadBuffer, payloadSize, IsTrivialT{})
+			: mChannel->mPayloadType->fromBytes(mRecord.value, payloadBuffer, payloadSize);
+		if (deserialized) {
+			return true;
+		}
+		finish(result_t::DESERIALIZATION_ERROR);
+		return false;
+	}
+	if (res != result_t::END_OF_STREAM) {
+		finish(res);
+		return false;
+	}
+	Key::AcqT acq{};
+	finish(mChannel->readGetResult(acq), acq);
+	return false;
+}
+
+template<typename T>
+ResponseAcq Channel<T>::Stream::drain()
+{
+	Key key{};
+	const void* payloadBuffer{};
+	std::size_t payloadSize{};
+	while (mChannel != nullptr) {
+		const result_t res =
+			mChannel->readNextRecordDataCompacting(key, payloadBuffer, payloadSize);
+		if (res == result_t::END_OF_STREAM) {
+			Key::AcqT acq{};
+			finish(mChannel->readGetResult(acq), acq);
+		} else if (res != result_t::OK) {
+			finish(res);
+		}
+	}
+	return mResponse;
+}
+
+template<typename T>
+void Channel<T>::Stream::finish(const result_t status, const Key::AcqT acq)
+{
+	if (status != result_t::OK) {
+		mChannel->abort();
+		mResponse = ResponseAcq(status);
+	} else {
+		mResponse = ResponseAcq(status, acq);
+	}
+	mChannel = nullptr;
+}
+
+template<typename T>
+typename Channel<T>::Stream Channel<T>::openStream(const Key& keyMin, const Key& keyMax)
+{
+	result_t res = writeGetRequest(keyMin, keyMax);
+	if (res == result_t::OK) {
+		res = readResponse();
+	}
+	if (res != result_t::OK) {
+		abort();
+		return Stream(res);
+	}
+	return Stream(this);
+}
+
+template<typename T>
+template<typename Visitor>
+ResponseAcq Channel<T>::getVisitImpl(const Key& keyMin, const Key& keyMax, Visitor& visitor)
+{
+	result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	res = readResponse();
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	res = recvAndVisitRecords(visitor);
+	if (res != result_t::END_OF_STREAM) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	Key::AcqT acq{};
+	res = readGetResult(acq);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+	return ResponseAcq(res, acq);
+}
+
+template<typename T>
+template<typename Visitor>
+ResponseAcq Channel<T>::getKeysImpl(const Key& keyMin, const Key& keyMax, Visitor& visitor)
+{
+	result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	res = readResponse();
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	Key key{};
+	std::size_t payloadSize{};
+	while ((res = readNextRecordKey(key, payloadSize)) == result_t::OK) {
+		visitor(static_cast<const Key&>(key), payloadSize);
+	}
+	if (res != result_t::END_OF_STREAM) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	Key::AcqT acq{};
+	res = readGetResult(acq);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+	return ResponseAcq(res, acq);
+}
+
+template<typename T>
+ResponseAcq Channel<T>::getSpilled(
+	const Key& keyMin, const Key& keyMax, SpilledRecordsSet& oRecords)
+{
+	result_t res = writeGetRequest(keyMin, keyMax);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	res = readResponse();
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	res = recvAndSpillRecords(oRecords);
+	const result_t sealed = oRecords.seal();
+	if (res == result_t::END_OF_STREAM && sealed != result_t::OK) {
+		res = sealed;
+	}
+	if (res != result_t::END_OF_STREAM) {
+		abort();
+		return ResponseAcq(res);
+	}
+
+	Key::AcqT acq{};
+	res = readGetResult(acq);
+	if (res != result_t::OK) {
+		abort();
+		return ResponseAcq(res);
+	}
+	return ResponseAcq(res, acq);
+}
+
+template<typename T>
+std::vector<ResponseGet<T>> Channel<T>::getBatch(const std::vector<KeyRange>& ranges)
 {
-	return Response(closeImpl());
+	return batchImpl<ResponseGet<T>>(
+		ranges, &Channel<T>::queueGetRequest, &Channel<T>::readGetResponse);
 }
 
 template<typename T>
-void Channel<T>::setTimeout(const std::chrono::duration<std::int64_t, std::milli> timeout)
+std::vector<ResponseAcq> Channel<T>::getAcqBatch(const std::vector<KeyRange>& ranges)
 {
-	setTimeoutImpl(timeout);
+	return batchImpl<ResponseAcq>(
+		ranges, &Channel<T>::queueGetAcqRequest, &Channel<T>::readGetAcqResponse);
 }
 
 template<typename T>
-void Channel<T>::setMemoryLimit(const std::size_t memoryLimitBytes)
+std::vector<ResponseGet<T>> Channel<T>::getCoalesced(const std::vector<KeyRange>& ranges)
 {
-	setMemoryLimitImpl(memoryLimitBytes);
-}
+	std::vector<std::size_t> covering;
+	const std::vector<KeyRange> merged = coalesceKeyRanges(ranges, covering);
+	std::vector<ResponseGet<T>> mergedResponses = getBatch(merged);
 
-/**************
- * Put
- */
+	std::vector<std::size_t> shares(merged.size(), 0);
+	for (const std::size_t index : covering) {
+		++shares[index];
+	}
+
+	std::vector<ResponseGet<T>> responses;
+	responses.reserve(ranges.size());
+	for (std::size_t i = 0; i < ranges.size(); ++i) {
+		ResponseGet<T>& source = mergedResponses[covering[i]];
+		if (shares[covering[i]] == 1) {
+			// Not merged with any other key-interval.
+			responses.push_back(std::move(source));
+			continue;
+		}
+		const Key& keyMin = ranges[i].keyMin;
+		const Key keyLast = ranges[i].keyMax - 1;
+		RecordsSet<T> records{};
+		for (const Record<T>& record : source.records()) {
+			if (keyMin <= record.key && record.key <= keyLast) {
+				records.append(record.key, record.value);
+			}
+		}
+		responses.emplace_back(source.status(), std::move(records), source.acq());
+	}
+	return responses;
+}
 
 template<typename T>
-template<typename Channel<T>::ProtoT PutProtocol>
-result_t Channel<T>::putImpl(const RecordsSet<T>& recordSet)
+template<typename R>
+std::vector<R> Channel<T>::batchImpl(const std::vector<KeyRange>& ranges,
+	result_t (Channel<T>::*queueRequest)(const Key&, const Key&),
+	R (Channel<T>::*readResult)())
 {
-	constexpr PutMethods impl = putMethods(PutProtocol);
-	result_t res = (this->*impl.writeHeader)();
-	if (res != result_t::OK) {
-		abort();
-		return res;
+	const auto rejected = [](const result_t status) {
+		return status == result_t::EMPTY_KEY_RANGE || status == result_t::INVALID_KEY;
+	};
+
+	std::vector<result_t> statuses(ranges.size(), result_t::OK);
+	result_t res = result_t::OK;
+	for (std::size_t i = 0; i < ranges.size() && res == result_t::OK; ++i) {
+		statuses[i] = (this->*queueRequest)(ranges[i].keyMin, ranges[i].keyMax);
+		if (statuses[i] != result_t::OK && !rejected(statuses[i])) {
+			res = statuses[i];
+		}
+	}
+	if (res == result_t::OK) {
+		res = flushRequests();
 	}
 
-	typename RecordsSet<T>::const_iterator recordIter = recordSet.begin();
-	typename RecordsSet<T>::const_iterator endIter = recordSet.end();
-	while (res == result_t::OK && recordIter != endIter) {
-		res = serializeAndWriteRecord<PutProtocol>(*recordIter);
-		if (res == result_t::OK) {
-			++recordIter;
+	std::vector<R> responses;
+	responses.reserve(ranges.size());
+	if (res != result_t::OK) {
+		abort();
+		for (const result_t status : statuses) {
+			responses.emplace_back(rejected(status) ? status : res);
 		}
+		return responses;
 	}
 
-	if (res == result_t::PAYLOAD_TOO_LARGE || res == result_t::INVALID_KEY) {
-		if (putFinalize<PutProtocol>() == result_t::OK) {
-			(void)close();
+	for (const result_t status : statuses) {
+		if (status != result_t::OK) {
+			responses.emplace_back(status);
+		} else if (res != result_t::OK) {
+			responses.emplace_back(result_t::NOT_CONNECTED);
 		} else {
-			abort();
+			responses.push_back((this->*readResult)());
+			res = responses.back().status();
 		}
-		return res;
-	}
-	if (res != result_t::OK) {
-		abort();
-		return res;
 	}
-	return putFinalize<PutProtocol>();
+	return responses;
 }
 
 template<typename T>
-template<typename Channel<T>::ProtoT PutProtocol>
-result_t Channel<T>::serializeAndWriteRecord(const Record<T>& record)
+template<typename Visitor>
+result_t Channel<T>::recvAndVisitRecords(Visitor& visitor)
 {
-	constexpr PutMethods impl = putMethods(PutProtocol);
-	void* buffer{};
-	std::size_t bufferSize{};
+	Key key{};
+	const void* payloadBuffer{};
 	std::size_t payloadSize{};
-
-	result_t res = (this->*impl.obtainPayloadBuffer)(buffer, bufferSize, record.key);
-	if (res != result_t::OK) {
-		return res;
-	}
-	payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
-	if (bufferSize < payloadSize) {
-		res = (this->*impl.reservePayloadBuffer)(
-			buffer, bufferSize, payloadSize, record.key);
+	while (true) {
+		const result_t res = readNextRecordDataCompacting(key, payloadBuffer, payloadSize);
 		if (res != result_t::OK) {
 			return res;
 		}
-		payloadSize = mPayloadType->toBytes(record.value, buffer, bufferSize);
+		visitor(static_cast<const Key&>(key), payloadBuffer, payloadSize);
 	}
-	return (this->*impl.writeNextRecord)(record.key, payloadSize);
 }
 
 template<typename T>
-template<typename Channel<T>::ProtoT PutProtocol>
-result_t Channel<T>::putFinalize()
+result_t Channel<T>::recvAndSpillRecords(SpilledRecordsSet& recordSet)
 {
-	constexpr PutMethods impl = putMethods(PutProtocol);
-	result_t res = writeFin();
-	if (res != result_t::OK) {
-		abort();
-		return res;
+	Key key{};
+	const void* payloadBuffer{};
+	std::size_t payloadSize{};
+	while (true) {
+		result_t res = readNextRecordDataCompacting(key, payloadBuffer, payloadSize);
+		if (res != result_t::OK) {
+			return res;
+		}
+		res = recordSet.append(key, payloadBuffer, payloadSize);
+		if (res != result_t::OK) {
+			return res;
+		}
 	}
+}
 
-	res = (this->*impl.readResult)();
-	if (res != result_t::OK) {
-		abort();
-		return res;
+template<typename T>
+template<typename Set>
+result_t Channel<T>::recvAndDeserializeBatchTo(Set& recordSet)
+{
+	const result_t res = recvAndDeserializeRecordsTo(recordSet, true);
+	if (res == result_t::MEMORY_LIMIT_EXCEEDED) {
+		if (recordSet.size() == 0) {
+			return result_t::MEMORY_LIMIT_EXCEEDED;
+		}
+		return result_t::OK;
 	}
-	return result_t::OK;
+	return res;
 }
 
 template<typename T>
-struct Channel<T>::PutMethods
+template<typename Set>
+result_t Channel<T>::recvAndDeserializeRecordsTo(Set& recordSet, const bool batched)
 {
-	result_t (Channel<T>::*writeHeader)();
-	result_t (Channel<T>::*obtainPayloadBuffer)(
-		void*& oBuffer, std::size_t& oBufferSize, const Key& key);
-	result_t (Channel<T>::*reservePayloadBuffer)(void*& oBuffer,
-		std::size_t& oBufferSize,
-		std::size_t payloadSize,
-		const Key& key);
-	result_t (Channel<T>::*writeNextRecord)(const Key& key, std::size_t payloadSize);
-	result_t (Channel<T>::*readResult)();
-};
+	if (decodeThreadsImpl() != 0 && !mTrivialPayload && !arenaOf(recordSet)) {
+		result_t res = recvAndDecodeInParallelTo(recordSet, batched);
+		while (res == result_t::MEMORY_LIMIT_EXCEEDED && chunkedRecordNext()) {
+			res = recvChunkedRecordTo(recordSet);
+			if (res == result_t::OK) {
+				res = recvAndDecodeInParallelTo(recordSet, batched);
+			}
+		}
+		return res;
+	}
+	std::chrono::steady_clock::time_point firstRecord{};
+	result_t res = result_t::OK;
+	while (res == result_t::OK) {
+		if (batched && batchComplete(recordSet.size(), firstRecord)) {
+			break;
+		}
+		res = recvAndDeserializeRecordTo(recordSet);
+	}
+	return res;
+}
 
 template<typename T>
-constexpr typename Channel<T>::PutMethods Channel<T>::putMethods(
-	const Channel<T>::ProtoT tag)
+result_t Channel<T>::recvAndDeserializeRecordsTo(BlobRecordsSet& recordSet, const bool batched)
 {
-	switch (tag) {
-		case PUT:
-			return PutMethods{
-				&Channel<T>::writePutHeader,
-				&Channel<T>::obtainPutPayloadBuffer,
-				&Channel<T>::reservePutPayloadBuffer,
-				&Channel<T>::writeNextPutRecord,
-				&Channel<T>::readPutResult,
-			};
-		case PUTA:
-			return PutMethods{
-				&Channel<T>::writePutAHeader,
-				&Channel<T>::obtainPutAPayloadBuffer,
-				&Channel<T>::reservePutAPayloadBuffer,
-				&Channel<T>::writeNextPutARecord,
-				&Channel<T>::readPutAResult,
-			};
+	std::chrono::steady_clock::time_point firstRecord{};
+	result_t res = result_t::OK;
+	while (res == result_t::OK) {
+		if (batched && batchComplete(recordSet.size(), firstRecord)) {
+			break;
+		}
+		res = recvAndDeserializeRecordTo(recordSet);
 	}
+	return res;
 }
 
 template<typename T>
-Response Channel<T>::put(const RecordsSet<T>& data)
+result_t Channel<T>::recvAndDeserializeRecordsTo(ArrowRecordsSet& recordSet, const bool batched)
 {
-	return Response(putImpl<ProtoT::PUT>(data));
+	std::chrono::steady_clock::time_point firstRecord{};
+	result_t res = result_t::OK;
+	while (res == result_t::OK) {
+		if (batched && batchComplete(recordSet.size(), firstRecord)) {
+			break;
+		}
+		res = recvAndDeserializeRecordTo(recordSet);
+	}
+	return res;
 }
 
 template<typename T>
-Response Channel<T>::puta(const RecordsSet<T>& data)
+bool Channel<T>::batchComplete(
+	const std::size_t records, std::chrono::steady_clock::time_point& ioFirstRecord)
 {
-	return Response(putImpl<ProtoT::PUTA>(data));
+	if (records == 0) {
+		return false;
+	}
+	if (mStreamBatching.maxRecords != 0 && records >= mStreamBatching.maxRecords) {
+		return true;
+	}
+	if (mStreamBatching.maxDelayMs == 0) {
+		return false;
+	}
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (ioFirstRecord == std::chrono::steady_clock::time_point{}) {
+		ioFirstRecord = now;
+	}
+	if (records < mStreamBatching.minRecords) {
+		return false;
+	}
+	const std::chrono::steady_clock::time_point deadline =
+		ioFirstRecord + std::chrono::milliseconds(mStreamBatching.maxDelayMs);
+	if (now >= deadline) {
+		return true;
+	}
+	// Round up, so that the wait does not end before the deadline.
+	const auto remainingMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+		deadline - now + std::chrono::milliseconds(1) - std::chrono::steady_clock::duration(1));
+	return !waitNextRecordData(static_cast<std::uint32_t>(remainingMs.count()));
 }
 
-/**************
- * Get
- */
-
 template<typename T>
-ResponseAcq Channel<T>::getAcq(const Key& keyMin, const Key& keyMax)
+template<typename Set>
+result_t Channel<T>::recvAndDecodeInParallelTo(Set& recordSet, const bool batched)
 {
-	result_t res = writeGetAcqRequest(keyMin, keyMax);
-	if (res != result_t::OK) {
-		abort();
-		return ResponseAcq(res);
+	// A deque keeps the chunks in place while the decoding threads use them.
+	std::deque<DecodeChunk> chunks;
+	const auto submit = [this](DecodeChunk& chunk) {
+		submitDecodeTaskImpl([this, &chunk]() { decodeChunk(chunk); });
+	};
+
+	Key key{};
+	const void* payloadBuffer{};
+	std::size_t payloadSize{};
+	std::size_t records = recordSet.size();
+	std::chrono::steady_clock::time_point firstRecord{};
+	result_t res = result_t::OK;
+	while (true) {
+		if (batched && batchComplete(records, firstRecord)) {
+			break;
+		}
+		res = readNextFittingRecordData(key, payloadBuffer, payloadSize);
+		if (res != result_t::OK) {
+			break;
+		}
+		++records;
+		if (chunks.empty() || chunks.back().keys.size() == cDecodeChunkRecords
+			|| chunks.back().bytes.size() >= cDecodeChunkBytes) {
+			if (!chunks.empty()) {
+				submit(chunks.back());
+			}
+			chunks.emplace_back();
+			chunks.back().keys.reserve(cDecodeChunkRecords);
+			chunks.back().ends.reserve(cDecodeChunkRecords);
+		}
+		DecodeChunk& chunk = chunks.back();
+		const char* const payload = static_cast<const char*>(payloadBuffer);
+		chunk.keys.push_back(key);
+		chunk.bytes.insert(chunk.bytes.end(), payload, payload + payloadSize);
+		chunk.ends.push_back(chunk.bytes.size());
+	}
+	if (!chunks.empty()) {
+		submit(chunks.back());
 	}
+	waitDecodeTasksImpl();
 
-	Key::AcqT acq{};
-	res = readAcq(acq);
-	if (res != result_t::OK) {
-		abort();
-		return ResponseAcq(res);
+	for (DecodeChunk& chunk : chunks) {
+		if (!chunk.ok) {
+			return result_t::DESERIALIZATION_ERROR;
+		}
+		for (Record<T>& record : chunk.records) {
+			recordSet.append(std::move(record));
+		}
 	}
+	return res;
+}
 
-	return ResponseAcq(res, acq);
+template<typename T>
+void Channel<T>::decodeChunk(DecodeChunk& chunk)
+{
+	chunk.records.reserve(chunk.keys.size());
+	std::size_t begin = 0;
+	for (std::size_t i = 0; i < chunk.keys.size(); ++i) {
+		Record<T> record{};
+		record.key = chunk.keys[i];
+		const std::size_t size = chunk.ends[i] - begin;
+		if (!mPayloadType->fromBytes(record.value, chunk.bytes.data() + begin, size)) {
+			chunk.ok = false;
+			return;
+		}
+		chunk.records.push_back(std::move(record));
+		begin = chunk.ends[i];
+	}
 }
 
 template<typename T>
-ResponseGet<T> Channel<T>::get(const Key& keyMin, const Key& keyMax)
+template<typename Set>
+result_t Channel<T>::recvAndDeserializeRecordTo(Set& recordSet)
 {
-	result_t res = writeGetRequest(keyMin, keyMax);
+	Record<T> record{};
+	const void* payloadBuffer{};
+	std::size_t payloadSize{};
+
+	result_t res = readNextFittingRecordData(record.key, payloadBuffer, payloadSize);
+	if (res == result_t::MEMORY_LIMIT_EXCEEDED && chunkedRecordNext()) {
+		return recvChunkedRecordTo(recordSet);
+	}
 	if (res != result_t::OK) {
-		abort();
-		return ResponseGet<T>(res);
+		return res;
 	}
 
-	res = readResponse();
-	if (res != result_t::OK) {
-		abort();
-		return ResponseGet<T>(res);
+	const bool deserialized = mTrivialPayload
+		? fromTrivialBytes(record.value, payloadBuffer, payloadSize, IsTrivialT{})
+		: mPayloadType->fromBytes(record.value, payloadBuffer, payloadSize);
+	if (!deserialized) {
+		return result_t::DESERIALIZATION_ERROR;
 	}
 
-	RecordsSet<T> recordSet{};
-	while (true) {
-		res = recvAndDeserializeRecordTo(recordSet);
-		if (res == result_t::END_OF_STREAM) {
-			break;
-		}
+	recordSet.append(std::move(record));
+	return res;
+}
+
+template<typename T>
+result_t Channel<T>::readNextFittingRecordData(
+	Key& oKey, const void*& oPayloadPtr, std::size_t& oPayloadSize)
+{
+	result_t res = readNextRecordData(oKey, oPayloadPtr, oPayloadSize);
+	while (res == result_t::MEMORY_LIMIT_EXCEEDED && mOversizedRecordHandler
+		&& nextRecordOversized() && (mTrivialPayload || !mPayloadType->chunked())) {
+		std::size_t skippedSize{};
+		res = readNextRecordKey(oKey, skippedSize);
 		if (res != result_t::OK) {
-			abort();
-			return ResponseGet<T>(res, std::move(recordSet), 0);
+			return res;
+		}
+		mOversizedRecordHandler(static_cast<const Key&>(oKey), skippedSize);
+		res = readNextRecordData(oKey, oPayloadPtr, oPayloadSize);
+		if (res == result_t::MEMORY_LIMIT_EXCEEDED && !nextRecordOversized()) {
+			// The buffer was left full by the skipped record and has been
+			// compacted to make room; retry once.
+			res = readNextRecordData(oKey, oPayloadPtr, oPayloadSize);
 		}
 	}
+	return res;
+}
 
-	Key::AcqT acq{};
-	res = readGetResult(acq);
-	if (res != result_t::OK) {
-		abort();
-		return ResponseGet<T>(res, std::move(recordSet), 0);
+template<typename T>
+result_t Channel<T>::readNextRecordDataCompacting(
+	Key& oKey, const void*& oPayloadPtr, std::size_t& oPayloadSize)
+{
+	result_t res = readNextFittingRecordData(oKey, oPayloadPtr, oPayloadSize);
+	if (res == result_t::MEMORY_LIMIT_EXCEEDED) {
+		// The consumed records were discarded to make room; retry once.
+		res = readNextFittingRecordData(oKey, oPayloadPtr, oPayloadSize);
 	}
-	return ResponseGet<T>(res, std::move(recordSet), acq);
+	return res;
 }
 
 template<typename T>
-ResponseAcq Channel<T>::getStream(const Key& keyMin,
-	const Key& keyMax,
-	const std::function<void(RecordsSet<T>&)>& callback)
+template<typename Set>
+result_t Channel<T>::recvChunkedRecordTo(Set& recordSet)
 {
-	result_t res = writeGetRequest(keyMin, keyMax);
+	Record<T> record{};
+	std::size_t payloadSize{};
+	const result_t res = readNextRecordHead(record.key, payloadSize);
 	if (res != result_t::OK) {
-		abort();
-		return ResponseAcq(res);
+		return res;
 	}
 
-	res = readResponse();
-	if (res != result_t::OK) {
-		abort();
-		return ResponseAcq(res);
+	if (!mPayloadType->beginChunked(record.value, payloadSize)) {
+		return result_t::DESERIALIZATION_ERROR;
 	}
-
-	while (res == result_t::OK) {
-		RecordsSet<T> recordSet{};
-		res = recvAndDeserializeBatchTo(recordSet);
-		callback(recordSet);
+	while (payloadSize != 0) {
+		const void* chunk{};
+		std::size_t chunkSize{};
+		const result_t resChunk = readPayloadChunk(payloadSize, chunk, chunkSize);
+		if (resChunk != result_t::OK) {
+			return resChunk;
+		}
+		if (!mPayloadType->appendChunk(record.value, chunk, chunkSize)) {
+			return result_t::DESERIALIZATION_ERROR;
+		}
+		payloadSize -= chunkSize;
 	}
-	if (res != result_t::END_OF_STREAM) {
-		abort();
-		return ResponseAcq(res);
+	if (!mPayloadType->finishChunked(record.value)) {
+		return result_t::DESERIALIZATION_ERROR;
 	}
 
-	Key::AcqT acq{};
-	res = readGetResult(acq);
-	if (res != result_t::OK) {
-		abort();
-		return ResponseAcq(res);
-	}
-	return ResponseAcq(res, acq);
+	recordSet.append(std::move(record));
+	return res;
 }
 
 template<typename T>
-result_t Channel<T>::recvAndDeserializeBatchTo(RecordsSet<T>& recordSet)
+result_t Channel<T>::recvAndDeserializeRecordTo(BlobRecordsSet& recordSet)
 {
-	result_t res = result_t::OK;
-	while (res == result_t::OK) {
-		res = recvAndDeserializeRecordTo(recordSet);
-	}
-	if (res == result_t::MEMORY_LIMIT_EXCEEDED) {
-		if (recordSet.size() == 0) {
-			return result_t::MEMORY_LIMIT_EXCEEDED;
-		}
-		return result_t::OK;
+	Key key{};
+	const void* payloadBuffer{};
+	std::size_t payloadSize{};
+
+	const result_t res = readNextFittingRecordData(key, payloadBuffer, payloadSize);
+	if (res != result_t::OK) {
+		return res;
 	}
+
+	recordSet.append(key, payloadBuffer, payloadSize);
 	return res;
 }
 
 template<typename T>
-result_t Channel<T>::recvAndDeserializeRecordTo(RecordsSet<T>& recordSet)
+result_t Channel<T>::recvAndDeserializeRecordTo(ArrowRecordsSet& recordSet)
 {
-	Record<T> record{};
+	Key key{};
 	const void* payloadBuffer{};
 	std::size_t payloadSize{};
 
-	result_t res = readNextRecordData(record.key, payloadBuffer, payloadSize);
+	const result_t res = readNextFittingRecordData(key, payloadBuffer, payloadSize);
 	if (res != result_t::OK) {
 		return res;
 	}
 
-	if (!mPayloadType->fromBytes(record.value, payloadBuffer, payloadSize)) {
+	if (!recordSet.append(key, payloadBuffer, payloadSize)) {
 		return result_t::DESERIALIZATION_ERROR;
 	}
-
-	recordSet.append(std::move(record));
 	return res;
 }
 
+template<typename T>
+bool Channel<T>::isTrivialPayload(PayloadType<T>* const payloadType, std::true_type)
+{
+	return dynamic_cast<TrivialPayloadType<T>*>(payloadType) != nullptr;
+}
+
+template<typename T>
+bool Channel<T>::isTrivialPayload(PayloadType<T>* const /*payloadType*/, std::false_type)
+{
+	return false;
+}
+
+template<typename T>
+bool Channel<T>::fromTrivialBytes(
+	T& oVar, const void* const payloadBuffer, const std::size_t payloadSize, std::true_type)
+{
+	return static_cast<TrivialPayloadType<T>&>(*mPayloadType).fromBytes(
+		oVar, payloadBuffer, payloadSize);
+}
+
+template<typename T>
+bool Channel<T>::fromTrivialBytes(T& /*oVar*/,
+	const void* const /*payloadBuffer*/,
+	const std::size_t /*payloadSize*/,
+	std::false_type)
+{
+	return false;
+}
+
+/**************
+ * Replication
+ */
+
+template<typename S, typename D>
+ResponseAcq replicate(
+	Channel<S>& source, Channel<D>& destination, const Key& keyMin, const Key& keyMax)
+{
+	result_t got = source.writeGetRequest(keyMin, keyMax);
+	if (got == result_t::OK) {
+		got = source.readResponse();
+	}
+	if (got != result_t::OK) {
+		source.abort();
+		return ResponseAcq(got);
+	}
+
+	const result_t put = destination.template putImpl<typename Channel<D>::PutAProto>([&]() {
+		Key key{};
+		const void* payload{};
+		std::size_t payloadSize{};
+		while (true) {
+			got = source.readNextRecordDataCompacting(key, payload, payloadSize);
+			if (got != result_t::OK) {
+				return got == result_t::END_OF_STREAM ? result_t::OK : got;
+			}
+			const result_t res = destination.writeNextPutARecordView(key, payload, payloadSize);
+			if (res != result_t::OK) {
+				return res;
+			}
+		}
+	});
+	if (put != result_t::OK || got != result_t::END_OF_STREAM) {
+		// The rest of the GET response is left unread.
+		source.abort();
+		return ResponseAcq(got != result_t::END_OF_STREAM && got != result_t::OK ? got : put);
+	}
+
+	Key::AcqT acq{};
+	got = source.readGetResult(acq);
+	if (got != result_t::OK) {
+		source.abort();
+		return ResponseAcq(got);
+	}
+	return ResponseAcq(got, acq);
+}
+
 } /*namespace tstorage*/
 
 #endif
@@ -25,11 +25,16 @@
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <ratio>
 #include <string>
+#include <vector>
 
 #include "DataTypes.h"
+#include "MemoryBudget.h"
+#include "PutDedupFilter.h"
+#include "Tracer.h"
 
 /** @file
  * @brief Defines the base class of each `Channel<T>` and a major part of the
@@ -123,6 +128,52 @@ protected:
 	 * @brief Forcefully closes the connection.
 	 */
 	void abort();
+	/**
+	 * @brief Shuts the connection down, unblocking a receive in progress on
+	 * another thread. Follow with `abort()` once it has returned.
+	 */
+	void interrupt();
+	/**
+	 * @brief Sets the policy of retrying failed requests.
+	 *
+	 * @see `Channel::setRetryPolicy()`
+	 *
+	 * @param policy The new policy.
+	 */
+	void setRetryPolicyImpl(const RetryPolicy& policy);
+	/**
+	 * @brief Decides whether a failed request is to be retried and if so,
+	 * reconnects the channel.
+	 *
+	 * @param status The status code of the failed attempt.
+	 * @param[in, out] ioAttempt The amount of attempts made so far.
+	 * @param put `true` for PUT/A requests.
+	 * @return `true` if the request is to be retried, `false` otherwise.
+	 */
+	bool retryImpl(result_t status, std::uint32_t& ioAttempt, bool put);
+	/**
+	 * @brief Splits a nonempty key-interval into up to `count` disjoint
+	 * sub-intervals covering it, by CID and then by CAP.
+	 *
+	 * The CID range is split into `count` parts of equal length, at most one
+	 * CID each. If there are fewer parts than `count`, the CAP range of each
+	 * one is split further, into `count` divided by the amount of CID parts.
+	 *
+	 * @see `Channel::getStreamResumable()`
+	 *
+	 * @param range The key-interval to split.
+	 * @param count The target amount of sub-intervals, at least `1`.
+	 * @return The sub-intervals, in the order of CID and CAP.
+	 */
+	static std::vector<KeyRange> splitKeyRange(const KeyRange& range, std::size_t count);
+	/**
+	 * @brief Checks whether the connection is currently established.
+	 *
+	 * @see `Channel::connected()`
+	 *
+	 * @return `true` if connected, `false` otherwise.
+	 */
+	bool connectedImpl() const;
 
 	/**
 	 * @brief Initiates the GET request for all records with keys lying in the
@@ -140,6 +191,30 @@ protected:
 	 * @return Status code.
 	 */
 	result_t writeGetAcqRequest(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Appends a GET request for the `[keyMin, keyMax)` key-interval to
+	 * the channel's output buffer. Requests are sent once the buffer fills up
+	 * or `flushRequests()` is called.
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @return Status code.
+	 */
+	result_t queueGetRequest(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Appends a GETACQ request for the `[keyMin, keyMax)` key-interval
+	 * to the channel's output buffer.
+	 * @see `queueGetRequest()`
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @return Status code.
+	 */
+	result_t queueGetAcqRequest(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Sends the requests queued by `queueGetRequest()` and
+	 * `queueGetAcqRequest()`.
+	 * @return Status code.
+	 */
+	result_t flushRequests();
 
 	/**
 	 * @brief Initiates the PUT request through an open channel.
@@ -231,11 +306,172 @@ protected:
 	 * @return Status code.
 	 */
 	result_t writeNextPutARecord(const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Writes a record with an already serialized payload through the
+	 * `Channel`. Used with PUT protocol.
+	 *
+	 * Used instead of the `obtainPutPayloadBuffer()`/`writeNextPutRecord()`
+	 * sequence for payloads exposed by `PayloadType::toView()`. Large
+	 * payloads are sent directly from the given memory block, bypassing the
+	 * internal buffer.
+	 *
+	 * @param key The key associated to the record.
+	 * @param payload The memory block containing the serialized payload.
+	 * @param payloadSize The size of the record's payload.
+	 * @return Status code.
+	 */
+	result_t writeNextPutRecordView(
+		const Key& key, const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief Writes a record with an already serialized payload through the
+	 * `Channel`. Used with PUTA protocol.
+	 *
+	 * @see `writeNextPutRecordView()`
+	 *
+	 * @param key The key associated to the record.
+	 * @param payload The memory block containing the serialized payload.
+	 * @param payloadSize The size of the record's payload.
+	 * @return Status code.
+	 */
+	result_t writeNextPutARecordView(
+		const Key& key, const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief Writes a record the payload of which is serialized piece by piece
+	 * through the `Channel`. Used with PUT protocol.
+	 *
+	 * Used instead of the `obtainPutPayloadBuffer()`/`writeNextPutRecord()`
+	 * sequence for payloads which don't fit in the internal buffer, for
+	 * payload types supporting `PayloadType::toChunk()`. The record's key is
+	 * sent, then `fillPayload` is called with the emptied internal buffer,
+	 * the offset of the next piece of the payload and its size, which is
+	 * sent in turn.
+	 *
+	 * @param key The key associated to the record.
+	 * @param payloadSize The size of the record's payload.
+	 * @param fillPayload Serializes the given piece of the payload to the
+	 * given memory block.
+	 * @return Status code.
+	 */
+	result_t writeNextPutRecordPieces(const Key& key,
+		std::size_t payloadSize,
+		const std::function<void(void*, std::size_t, std::size_t)>& fillPayload);
+	/**
+	 * @brief Writes a record the payload of which is serialized piece by piece
+	 * through the `Channel`. Used with PUTA protocol.
+	 *
+	 * @see `writeNextPutRecordPieces()`
+	 *
+	 * @param key The key associated to the record.
+	 * @param payloadSize The size of the record's payload.
+	 * @param fillPayload Serializes the given piece of the payload to the
+	 * given memory block.
+	 * @return Status code.
+	 */
+	result_t writeNextPutARecordPieces(const Key& key,
+		std::size_t payloadSize,
+		const std::function<void(void*, std::size_t, std::size_t)>& fillPayload);
 	/**
 	 * @brief Finalizes the PUT/A request.
 	 * @return Status code.
 	 */
 	result_t writeFin();
+	/**
+	 * @brief Sends the records of the PUT/A request written so far, keeping
+	 * the request open.
+	 * @return Status code.
+	 */
+	result_t flushPut();
+	/**
+	 * @brief Sends the records of the PUT/A request from a file holding them
+	 * already serialized as batches.
+	 * @see `Channel::putFromFile()`
+	 * @param fd The file.
+	 * @param offset The offset of the first batch in the file.
+	 * @param length The size of the batches in bytes.
+	 * @return Status code.
+	 */
+	result_t writeFileBatches(int fd, std::uint64_t offset, std::uint64_t length);
+	/**
+	 * @brief Provides `count` empty chunks for records of the current PUT/A
+	 * request serialized apart from the channel's buffer, on the encoding
+	 * threads.
+	 *
+	 * The chunks are indexed from `0`. Preparing them again discards their
+	 * contents.
+	 *
+	 * @param count The amount of chunks.
+	 */
+	void preparePutChunks(std::size_t count);
+	/**
+	 * @brief Supplies the client with a writable buffer to serialize the next
+	 * record of a chunk into, like `reservePutPayloadBuffer()`. Used with PUT
+	 * requests.
+	 *
+	 * May be called for distinct chunks from several threads at once.
+	 *
+	 * @param chunk The index of the chunk.
+	 * @param[out] oPayloadBuffer A writable memory chunk for data serialization.
+	 * @param[out] oBufferSize The size of the memory chunk.
+	 * @param[in] payloadSize The total size of serialized data, `0` if not
+	 * known.
+	 * @param[in] key The key of the next record to serialize.
+	 * @return Status code.
+	 */
+	result_t reservePutChunkPayloadBuffer(std::size_t chunk,
+		void*& oPayloadBuffer,
+		std::size_t& oBufferSize,
+		std::size_t payloadSize,
+		const Key& key);
+	/**
+	 * @brief Supplies the client with a writable buffer to serialize the next
+	 * record of a chunk into. Used with PUTA requests.
+	 *
+	 * @see `reservePutChunkPayloadBuffer()`
+	 *
+	 * @param chunk The index of the chunk.
+	 * @param[out] oPayloadBuffer A writable memory chunk for data serialization.
+	 * @param[out] oBufferSize The size of the memory chunk.
+	 * @param[in] payloadSize The total size of serialized data, `0` if not
+	 * known.
+	 * @param[in] key The key of the next record to serialize.
+	 * @return Status code.
+	 */
+	result_t reservePutAChunkPayloadBuffer(std::size_t chunk,
+		void*& oPayloadBuffer,
+		std::size_t& oBufferSize,
+		std::size_t payloadSize,
+		const Key& key);
+	/**
+	 * @brief Appends the previously serialized record to a chunk. Used with
+	 * PUT requests.
+	 *
+	 * May be called for distinct chunks from several threads at once.
+	 *
+	 * @param chunk The index of the chunk.
+	 * @param key The key associated to the serialized record.
+	 * @param payloadSize The size of the serialized record's payload.
+	 * @return Status code.
+	 */
+	result_t writeNextPutChunkRecord(std::size_t chunk, const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Appends the previously serialized record to a chunk. Used with
+	 * PUTA requests.
+	 *
+	 * @see `writeNextPutChunkRecord()`
+	 *
+	 * @param chunk The index of the chunk.
+	 * @param key The key associated to the serialized record.
+	 * @param payloadSize The size of the serialized record's payload.
+	 * @return Status code.
+	 */
+	result_t writeNextPutAChunkRecord(std::size_t chunk, const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Sends the records of the PUT/A request written so far followed
+	 * by the first `count` chunks in order, keeping the request open.
+	 * @param count The amount of chunks to send.
+	 * @return Status code.
+	 */
+	result_t writePutChunks(std::size_t count);
 
 	/**
 	 * @brief Reads the header of the server's response to GET requests.
@@ -280,6 +516,65 @@ protected:
 	 */
 	result_t readNextRecordData(
 		Key& oKey, const void*& oPayloadPtr, std::size_t& oPayloadSize);
+	/**
+	 * @brief Deserializes the key and reads the payload size of the next
+	 * received record, discarding its payload.
+	 *
+	 * Used like `readNextRecordData()` by queries which don't need the
+	 * payloads.
+	 *
+	 * @param[out] oKey The key of the record.
+	 * @param[out] oPayloadSize The size of the discarded payload.
+	 *
+	 * @return Status code.
+	 */
+	result_t readNextRecordKey(Key& oKey, std::size_t& oPayloadSize);
+	/**
+	 * @brief Returns `true` if the next record cannot fit in the receive
+	 * buffer, even once compacted and grown.
+	 *
+	 * Used after `readNextRecordData()` returns
+	 * `result_t::MEMORY_LIMIT_EXCEEDED`, to tell such a record from one which
+	 * fits once the buffer is compacted. Such a record can only be read in
+	 * chunks, with `readNextRecordHead()` and `readPayloadChunk()`.
+	 */
+	bool nextRecordOversized() const;
+	/**
+	 * @brief Deserializes the key and reads the payload size of the next
+	 * received record, leaving its payload to `readPayloadChunk()`.
+	 *
+	 * @param[out] oKey The key of the record.
+	 * @param[out] oPayloadSize The size of the payload.
+	 *
+	 * @return Status code.
+	 */
+	result_t readNextRecordHead(Key& oKey, std::size_t& oPayloadSize);
+	/**
+	 * @brief Supplies a read-only buffer to the next chunk of the payload of
+	 * the record whose head was read by `readNextRecordHead()`.
+	 *
+	 * The chunk is whatever part of the payload the receive buffer holds, and
+	 * is valid until the next call.
+	 *
+	 * @param amountBytes The size of the rest of the payload, at least `1`.
+	 * @param[out] oChunkPtr A pointer to the chunk.
+	 * @param[out] oChunkSize The size of the chunk, at most `amountBytes`.
+	 *
+	 * @return Status code.
+	 */
+	result_t readPayloadChunk(
+		std::size_t amountBytes, const void*& oChunkPtr, std::size_t& oChunkSize);
+	/**
+	 * @brief Waits until the next record, or the end of the records, is
+	 * received in full, or more data arrives, whichever comes first.
+	 *
+	 * Used between calls to `readNextRecordData()` to tell whether the next
+	 * one would wait for the network.
+	 *
+	 * @param timeoutMs The longest wait in milliseconds.
+	 * @return `false` if the wait has timed out, `true` otherwise.
+	 */
+	bool waitNextRecordData(std::uint32_t timeoutMs);
 	/**
 	 * @brief Reads the result of the previous GET command as reported by the
 	 * server.
@@ -313,6 +608,212 @@ protected:
 	 * @param timeout The timeout in milliseconds.
 	 */
 	void setTimeoutImpl(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the timeout of establishing a connection to the target
+	 * server.
+	 *
+	 * @see `Channel::setConnectTimeout()`
+	 *
+	 * @param timeout The timeout in milliseconds, `0` for none.
+	 */
+	void setConnectTimeoutImpl(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the deadline of the requests made from now on.
+	 *
+	 * @see `Channel::get()` and the other overloads taking a deadline
+	 *
+	 * @param deadline The deadline, `time_point::max()` to remove it.
+	 */
+	void setDeadlineImpl(std::chrono::steady_clock::time_point deadline);
+	/** @brief Sets the deadline of the requests made while the scope is
+	 * open. */
+	class DeadlineScope final
+	{
+	public:
+		/** @brief Sets `deadline` on `channel` until the scope is closed. */
+		DeadlineScope(ChannelBase& channel, const std::chrono::steady_clock::time_point deadline)
+			: mChannel(channel)
+		{
+			mChannel.setDeadlineImpl(deadline);
+		}
+		/** @brief Removes the deadline. */
+		~DeadlineScope() { mChannel.setDeadlineImpl(std::chrono::steady_clock::time_point::max()); }
+
+		DeadlineScope(const DeadlineScope&) = delete;
+		DeadlineScope& operator=(const DeadlineScope&) = delete;
+
+	private:
+		/** @brief The channel. */
+		ChannelBase& mChannel;
+	};
+	/**
+	 * @brief Sets the time the resolved addresses of the target server are
+	 * reused for.
+	 *
+	 * @see `Channel::setAddressCacheTtl()`
+	 *
+	 * @param ttl The time, or `0` to resolve the addresses on each connect.
+	 */
+	void setAddressCacheTtlImpl(std::chrono::duration<std::int64_t, std::milli> ttl);
+	/**
+	 * @brief Sets the busy polling time of the underlying TCP socket.
+	 *
+	 * The change takes effect instantaneously.
+	 *
+	 * @see `Channel::setBusyPoll()`
+	 *
+	 * @param busyPoll The busy polling time, or `0` to disable busy polling.
+	 */
+	void setBusyPollImpl(std::chrono::duration<std::int64_t, std::micro> busyPoll);
+	/**
+	 * @brief Sets the largest receive low watermark of the underlying TCP
+	 * socket.
+	 *
+	 * @see `Channel::setReceiveLowWatermark()`
+	 *
+	 * @param limitBytes The largest low watermark, or `0` to disable it.
+	 */
+	void setReceiveLowWatermarkImpl(std::size_t limitBytes);
+	/**
+	 * @brief Enables or disables the io_uring backend of the underlying TCP
+	 * socket.
+	 *
+	 * The change takes effect with the next connection established.
+	 *
+	 * @see `Channel::setIoUring()`
+	 *
+	 * @param enabled `true` to use io_uring, `false` otherwise.
+	 */
+	void setIoUringImpl(bool enabled);
+	/**
+	 * @brief Enables or disables restarting the syscalls of the underlying
+	 * TCP socket interrupted by signals.
+	 *
+	 * @see `Channel::setSignalRestart()`
+	 *
+	 * @param enabled `true` to restart interrupted syscalls, `false` otherwise.
+	 */
+	void setSignalRestartImpl(bool enabled);
+	/**
+	 * @brief Sets the TCP options of the channel's connections.
+	 *
+	 * @see `Channel::setSocketOptions()`
+	 *
+	 * @param options The options.
+	 */
+	void setSocketOptionsImpl(const SocketOptions& options);
+	/**
+	 * @brief Sets the TLS options of the channel's connections.
+	 *
+	 * @see `Channel::setTlsOptions()`
+	 *
+	 * @param options The options.
+	 */
+	void setTlsOptionsImpl(const TlsOptions& options);
+	/**
+	 * @brief Returns the receive counters of the last request.
+	 *
+	 * @see `Channel::receiveStats()`
+	 *
+	 * @return The receive counters.
+	 */
+	ReceiveStats receiveStatsImpl() const;
+	/**
+	 * @brief Returns the counters of the work done by the channel.
+	 *
+	 * @see `Channel::stats()`
+	 *
+	 * @return The counters.
+	 */
+	ChannelStats statsImpl() const;
+	/**
+	 * @brief Sets the tracer receiving the timings of the channel's connects
+	 * and requests.
+	 *
+	 * @see `Channel::setTracer()`
+	 *
+	 * @param tracer The tracer, or `nullptr` to disable tracing.
+	 */
+	void setTracerImpl(std::shared_ptr<Tracer> tracer);
+	/**
+	 * @brief Sets the amount of threads deserializing the records of GET
+	 * responses.
+	 *
+	 * @see `Channel::setDecodeThreads()`
+	 *
+	 * @param threads The amount of threads, `0` to deserialize the records on
+	 * the calling thread.
+	 */
+	void setDecodeThreadsImpl(std::size_t threads);
+	/**
+	 * @brief Returns the amount of threads deserializing the records of GET
+	 * responses, `0` if they're deserialized on the calling thread.
+	 */
+	std::size_t decodeThreadsImpl() const;
+	/**
+	 * @brief Predicts the amount of records of a GET response of a
+	 * key-interval from the earlier responses of key-intervals of the same
+	 * width, the ACQ left out.
+	 *
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @param[out] oRecords The predicted amount, set only if known.
+	 * @return `true` if a response of the same width has been counted.
+	 */
+	bool predictGetRecords(const Key& keyMin, const Key& keyMax, std::size_t& oRecords) const;
+	/**
+	 * @brief Counts the records of a GET response for `predictGetRecords()`.
+	 *
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @param records The amount of records of the response.
+	 */
+	void countGetRecords(const Key& keyMin, const Key& keyMax, std::size_t records);
+	/**
+	 * @brief Queues a task for the decoding threads.
+	 *
+	 * Valid only if `decodeThreadsImpl()` is not `0`. The task runs on one of
+	 * the decoding threads, or on the calling thread inside
+	 * `waitDecodeTasksImpl()`.
+	 *
+	 * @param task The task, which must not throw.
+	 */
+	void submitDecodeTaskImpl(std::function<void()> task);
+	/**
+	 * @brief Runs the queued decoding tasks on the calling thread alongside
+	 * the decoding threads until all of them have finished.
+	 */
+	void waitDecodeTasksImpl();
+	/**
+	 * @brief Sets the amount of threads serializing the records of PUT/A
+	 * requests.
+	 *
+	 * @see `Channel::setEncodeThreads()`
+	 *
+	 * @param threads The amount of threads, `0` to serialize the records on
+	 * the calling thread.
+	 */
+	void setEncodeThreadsImpl(std::size_t threads);
+	/**
+	 * @brief Returns the amount of threads serializing the records of PUT/A
+	 * requests, `0` if they're serialized on the calling thread.
+	 */
+	std::size_t encodeThreadsImpl() const;
+	/**
+	 * @brief Queues a task for the encoding threads.
+	 *
+	 * Valid only if `encodeThreadsImpl()` is not `0`. The task runs on one of
+	 * the encoding threads, or on the calling thread inside
+	 * `waitEncodeTasksImpl()`.
+	 *
+	 * @param task The task, which must not throw.
+	 */
+	void submitEncodeTaskImpl(std::function<void()> task);
+	/**
+	 * @brief Runs the queued encoding tasks on the calling thread alongside
+	 * the encoding threads until all of them have finished.
+	 */
+	void waitEncodeTasksImpl();
 	/**
 	 * @brief Sets the memory limit for GET requests.
 	 *
@@ -323,6 +824,119 @@ protected:
 	 * @param memoryLimitBytes The new memory limit in bytes.
 	 */
 	void setMemoryLimitImpl(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the size of the send buffer.
+	 *
+	 * @see `Channel::setSendMemoryLimit()`
+	 *
+	 * @param memoryLimitBytes The new size in bytes.
+	 */
+	void setSendMemoryLimitImpl(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the size of the receive buffer.
+	 *
+	 * @see `Channel::setReceiveMemoryLimit()`
+	 *
+	 * @param memoryLimitBytes The new size in bytes.
+	 */
+	void setReceiveMemoryLimitImpl(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the amount of send buffers used to pipeline PUT/A requests.
+	 *
+	 * The change takes effect with the next buffer flush.
+	 *
+	 * @see `Channel::setPutPipelineDepth()`
+	 *
+	 * @param depth The total amount of send buffers.
+	 */
+	void setPutPipelineDepthImpl(std::size_t depth);
+	/**
+	 * @brief Enables or disables merging of PUT/A batches sharing a CID.
+	 *
+	 * @see `Channel::setPutBatchCoalescing()`
+	 *
+	 * @param enabled `true` to merge the batches, `false` otherwise.
+	 */
+	void setPutBatchCoalescingImpl(bool enabled);
+	/**
+	 * @brief Marks the keys of the records written next as validated up
+	 * front, so that they aren't checked record by record.
+	 *
+	 * @see `Channel::setPutBulkKeyValidation()`
+	 *
+	 * @param validated `true` if the keys have been validated, `false` to
+	 * check them again.
+	 */
+	void setPutKeysValidated(bool validated);
+	/**
+	 * @brief Sets the capacity the internal buffer may grow to while
+	 * receiving a record too large for it.
+	 *
+	 * @see `Channel::setReceiveBufferGrowth()`
+	 *
+	 * @param maxMemoryLimitBytes The largest capacity, or `0` to disable the
+	 * growth.
+	 */
+	void setReceiveBufferGrowthImpl(std::size_t maxMemoryLimitBytes);
+	/**
+	 * @brief Sets the bounds of the buffer sizes derived from the measured
+	 * bandwidth-delay product.
+	 *
+	 * @see `Channel::setBufferAutoTuning()`
+	 *
+	 * @param tuning The bounds.
+	 */
+	void setBufferAutoTuningImpl(const BufferAutoTuning& tuning);
+	/**
+	 * @brief Sets the flow control of PUT/A requests.
+	 *
+	 * @see `Channel::setPutFlowControl()`
+	 *
+	 * @param options The settings.
+	 */
+	void setPutFlowControlImpl(const PutFlowControl& options);
+	/**
+	 * @brief Sets the filter of the PUTA records acknowledged already.
+	 *
+	 * @see `Channel::setPutDedupFilter()`
+	 *
+	 * @param filter The filter, or `nullptr` for none.
+	 */
+	void setPutDedupFilterImpl(std::shared_ptr<PutDedupFilter> filter);
+	/**
+	 * @brief Sets when the buffers of an idle channel are handed to the
+	 * process-wide buffer pool.
+	 *
+	 * @see `Channel::setBufferRelease()`
+	 *
+	 * @param idle The idle time, `0` for right after each command, or
+	 * negative to keep the buffers until `close()`.
+	 */
+	void setBufferReleaseImpl(std::chrono::duration<std::int64_t, std::milli> idle);
+	/**
+	 * @brief Sets the amount of bytes kept by the process-wide buffer pool.
+	 *
+	 * @see `Channel::setBufferPoolLimit()`
+	 *
+	 * @param limitBytes The limit in bytes.
+	 */
+	static void setBufferPoolLimitImpl(std::size_t limitBytes);
+	/**
+	 * @brief Sets the huge pages and the NUMA node of the internal buffers.
+	 *
+	 * @see `Channel::setBufferAllocation()`
+	 *
+	 * @param allocation The allocation of the buffers.
+	 */
+	void setBufferAllocationImpl(const BufferAllocation& allocation);
+	/**
+	 * @brief Sets the memory budget the internal buffers draw from.
+	 *
+	 * @see `Channel::setMemoryBudget()`
+	 *
+	 * @param budget The budget, or `nullptr` for none.
+	 */
+	void setMemoryBudgetImpl(std::shared_ptr<MemoryBudget> budget);
 	/**
 	 * @brief Sets the address/port pair of the target server.
 	 *
@@ -0,0 +1,590 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ChannelPool.h
+ *   A pool of pre-connected channels leased to concurrent users.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_CHANNELPOOL_H
+#define D_TSTORAGE_CHANNELPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "MemoryBudget.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+#include "Tracer.h"
+
+/** @file
+ * @brief Defines the `ChannelPool<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A fixed-size pool of channels connected to the same TStorage
+ * instance, shared by multiple threads.
+ *
+ * A `Channel<T>` is not thread-safe, and creating a channel per thread (or
+ * worse, per request) means paying for the TCP handshake and the buffer
+ * allocation over and over again. A `ChannelPool<T>` pre-connects a bounded
+ * amount of channels and leases them to threads for the duration of one or
+ * more requests. A leased channel is used exclusively by the lessee, just like
+ * a regular `Channel<T>`, and is returned to the pool when its `Lease` goes
+ * out of scope.
+ *
+ * Idle channels are kept on a lock-free free-list, so leasing and returning a
+ * channel costs a couple of atomic operations as long as an idle channel is
+ * available. Threads only block when all channels are leased out.
+ *
+ * A channel that's returned in a closed state (e.g. because one of its
+ * requests failed) is not put back on the free-list. Instead, it is handed
+ * over to a background thread which reconnects it, retrying periodically (see
+ * `setReconnectInterval()`) until it succeeds.
+ *
+ * The channels may be split into two lanes (see `setControlLane()`), so that
+ * small, latency-critical requests such as `getAcq()` are not stuck behind
+ * bulk transfers holding all channels. Control requests lease a channel of
+ * the control lane, or an idle bulk channel if the control lane is busy; bulk
+ * requests never take control channels.
+ *
+ * All channels share a single `PayloadType<T>` instance, which hence has to
+ * be safe to use concurrently (see `SharedPayloadType<T>`).
+ *
+ * Programs using this class have to be linked with `-pthread`.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class ChannelPool final
+{
+public:
+	/** @brief The lanes the channels of a pool are split into. */
+	enum class Lane
+	{
+		BULK,  ///< Channels for any requests, e.g. large GETs and PUTs. The default.
+		CONTROL  ///< Channels reserved for small, latency-critical requests.
+	};
+
+	/** @brief The default memory limit of the channels of the control lane. */
+	static constexpr std::size_t cDefaultControlMemoryLimit = 64UL * 1024;  // 64 KiB
+
+	/**
+	 * @brief An exclusive, movable handle to a channel leased from the pool.
+	 *
+	 * An empty lease (e.g. one returned by a timed out `acquire()`) doesn't
+	 * refer to any channel and evaluates to `false`.
+	 */
+	class Lease
+	{
+	public:
+		/** @brief Constructs an empty lease. */
+		Lease() : mPool(nullptr), mIndex(0) {}
+		/** @brief Returns the channel to the pool. */
+		~Lease() { release(); }
+
+		Lease(const Lease&) = delete;
+		Lease& operator=(const Lease&) = delete;
+		/** @brief A move constructor. Leaves `other` empty. */
+		Lease(Lease&& other) noexcept : mPool(other.mPool), mIndex(other.mIndex)
+		{
+			other.mPool = nullptr;
+		}
+		/** @brief A move-assignment operator. Returns the currently leased channel
+		 * to the pool first and leaves `other` empty. */
+		Lease& operator=(Lease&& other) noexcept;
+
+		/** @brief Returns `true` if the lease refers to a channel. */
+		explicit operator bool() const { return mPool != nullptr; }
+		/** @brief Accesses the leased channel. */
+		Channel<T>& operator*() const { return *mPool->mChannels[mIndex]; }
+		/** @brief Accesses the leased channel. */
+		Channel<T>* operator->() const { return mPool->mChannels[mIndex].get(); }
+
+		/** @brief Returns the channel to the pool early, leaving the lease empty. */
+		void release();
+
+	private:
+		friend class ChannelPool<T>;
+		/** @brief Constructs a lease of the `index`-th channel of `pool`. */
+		Lease(ChannelPool<T>* pool, std::uint32_t index) : mPool(pool), mIndex(index) {}
+
+		/** @brief The pool the channel was leased from. */
+		ChannelPool<T>* mPool;
+		/** @brief The index of the leased channel. */
+		std::uint32_t mIndex;
+	};
+
+	/**
+	 * @brief Constructs a pool of `poolSize` channels to a TStorage server
+	 * under a given address.
+	 *
+	 * No connections are established until `connect()` is called.
+	 *
+	 * @param hostname Hostname of the target TStorage server.
+	 * @param port Port under which the TStorage server accepts connections.
+	 * @param payloadType A `PayloadType` instance shared by all channels.
+	 * @param poolSize The amount of channels in the pool.
+	 */
+	ChannelPool(const std::string& hostname,
+		std::uint16_t port,
+		std::shared_ptr<PayloadType<T>> payloadType,
+		std::size_t poolSize);
+	/**
+	 * @brief Closes the pool.
+	 * @see close()
+	 */
+	~ChannelPool();
+
+	ChannelPool(const ChannelPool&) = delete;
+	ChannelPool(ChannelPool&&) = delete;
+	ChannelPool& operator=(const ChannelPool&) = delete;
+	ChannelPool& operator=(ChannelPool&&) = delete;
+
+	/**
+	 * @brief Connects all channels and starts the background reconnection
+	 * thread.
+	 *
+	 * Channels which fail to connect are passed to the reconnection thread
+	 * right away. If the pool is already connected, the call is silently
+	 * ignored and a success code is returned.
+	 *
+	 * @see Channel::connect()
+	 *
+	 * @return A `Response` with the status code of the first failed connection
+	 * attempt, or a success code if all channels are connected.
+	 */
+	Response connect();
+	/**
+	 * @brief Stops the reconnection thread and closes all channels.
+	 *
+	 * All leases must be released beforehand.
+	 */
+	void close();
+
+	/**
+	 * @brief Reserves the last `channels` channels of the pool for control
+	 * requests.
+	 *
+	 * The control channels get a memory limit of `memoryLimitBytes` and
+	 * socket options tuned for small requests (`TCP_NODELAY` and
+	 * `TCP_QUICKACK`). At least one channel is left in the bulk lane. Must be
+	 * called before `connect()`.
+	 *
+	 * @param channels The amount of control channels, `0` for none.
+	 * @param memoryLimitBytes The memory limit of the control channels.
+	 */
+	void setControlLane(
+		std::size_t channels, std::size_t memoryLimitBytes = cDefaultControlMemoryLimit);
+
+	/**
+	 * @brief Leases an idle channel, blocking until one becomes available.
+	 * @param lane The lane of the request.
+	 * @return A non-empty lease.
+	 */
+	Lease acquire(Lane lane = Lane::BULK);
+	/**
+	 * @brief Leases an idle channel, blocking for at most `timeout` until one
+	 * becomes available.
+	 * @param timeout The maximal waiting time.
+	 * @param lane The lane of the request.
+	 * @return A lease, empty if the timeout has expired.
+	 */
+	Lease acquire(std::chrono::duration<std::int64_t, std::milli> timeout, Lane lane = Lane::BULK);
+	/**
+	 * @brief Leases an idle channel if one is available right away.
+	 * @param lane The lane of the request.
+	 * @return A lease, empty if no channel is idle.
+	 */
+	Lease tryAcquire(Lane lane = Lane::BULK);
+
+	/**
+	 * @brief Returns the current ACQ of a key-interval, queried over the
+	 * control lane.
+	 * @see Channel::getAcq()
+	 */
+	ResponseAcq getAcq(const Key& keyMin, const Key& keyMax);
+
+	/**
+	 * @brief Retrieves records from a key-interval with several concurrent GET
+	 * queries.
+	 *
+	 * The key-interval `[keyMin, keyMax)` is split into up to `shards` disjoint
+	 * sub-intervals of roughly equal width, by CID if the interval spans enough
+	 * CIDs, or by CAP otherwise, each of them taken by one of as many worker
+	 * threads (one of them being the calling thread). A worker fetches its
+	 * sub-interval with `Channel::get()` in a few consecutive CAP slices, each
+	 * over a channel leased for the slice. With more shards than channels in
+	 * the pool, the excess sub-queries wait for a channel to be returned.
+	 *
+	 * Equal widths don't make for equal work when the records are skewed, e.g.
+	 * a few CIDs holding most of them. A worker done with its sub-interval
+	 * therefore takes over half of the largest CAP span not fetched yet by the
+	 * others: the span of a sub-interval above the slice being fetched is split
+	 * at its middle CAP, the upper half becoming a sub-interval of the idle
+	 * worker. A span is only split while it holds at least two slices of its
+	 * owner, so the workers stay busy until little remains to fetch.
+	 *
+	 * The sub-responses are merged into a single `ResponseGet<T>`, the ACQ of
+	 * which is the smallest of the sub-responses' ACQs. Records acquired after
+	 * that ACQ are dropped from the merged set, so the result is consistent in
+	 * the sense documented on `Channel::get()` and `Channel::getAcq()`, i.e.
+	 * exactly as if the whole interval was queried up to the merged ACQ. The
+	 * order of the records is not specified.
+	 *
+	 * If any of the sub-queries fails, no further ones are sent, and the
+	 * status code of the first one to fail is returned together with all the
+	 * records obtained by the sub-queries.
+	 *
+	 * The calling thread must not hold all of the pool's leases, as at least
+	 * one channel has to become available for the query to make progress.
+	 *
+	 * @see Channel::get()
+	 *
+	 * @param keyMin The lower bound of the key-interval.
+	 * @param keyMax The upper bound of the key-interval.
+	 * @param shards The maximal amount of concurrent sub-queries.
+	 * @return A merged response.
+	 */
+	ResponseGet<T> getParallel(const Key& keyMin, const Key& keyMax, std::size_t shards);
+
+	/**
+	 * @brief Stores a set of records with several concurrent PUT requests.
+	 *
+	 * A single `Channel::put()` is bounded by one TCP stream and by the rate
+	 * at which the server ingests a single connection. The records are split
+	 * instead into up to `connections` partitions of whole CIDs, balanced by
+	 * their amounts of records, each of which is sent with `Channel::put()`
+	 * over a separately leased channel, on its own thread (one of them being
+	 * the calling thread). With more partitions than channels in the pool, the
+	 * excess requests wait for a channel to be returned.
+	 *
+	 * A partition sends its records CID by CID, in the order of the set within
+	 * a CID, so that they make long batches whatever the order of the set. The
+	 * records are not copied. A set of a single CID is sent with a single
+	 * request.
+	 *
+	 * The requests are independent: if one of them fails, the records of the
+	 * other partitions may still be stored. The partitions tell which ones.
+	 *
+	 * @see Channel::put()
+	 *
+	 * @param data The records to store.
+	 * @param connections The maximal amount of concurrent requests.
+	 * @param[out] oPartitions The outcome of each request, replaced.
+	 * @return A `Response` with the status code of the first failed
+	 * partition, or a success code.
+	 */
+	Response putParallel(const RecordsSet<T>& data,
+		std::size_t connections,
+		std::vector<PutPartition>& oPartitions);
+	/**
+	 * @brief Stores a set of records with several concurrent PUT requests,
+	 * without reporting the partitions.
+	 * @see putParallel()
+	 */
+	Response putParallel(const RecordsSet<T>& data, std::size_t connections);
+	/**
+	 * @brief Stores a set of records with user-supplied acquisition times
+	 * (ACQ) with several concurrent PUTA requests.
+	 *
+	 * The `Channel::puta()` counterpart of `putParallel()`.
+	 *
+	 * @param data The records to store.
+	 * @param connections The maximal amount of concurrent requests.
+	 * @param[out] oPartitions The outcome of each request, replaced.
+	 * @return A `Response` with the status code of the first failed
+	 * partition, or a success code.
+	 */
+	Response putaParallel(const RecordsSet<T>& data,
+		std::size_t connections,
+		std::vector<PutPartition>& oPartitions);
+	/**
+	 * @brief Stores a set of records with user-supplied acquisition times
+	 * (ACQ) with several concurrent PUTA requests, without reporting the
+	 * partitions.
+	 * @see putaParallel()
+	 */
+	Response putaParallel(const RecordsSet<T>& data, std::size_t connections);
+
+	/** @brief Returns the amount of channels in the pool. */
+	std::size_t size() const { return mChannels.size(); }
+	/** @brief Returns the amount of channels in a lane. */
+	std::size_t size(Lane lane) const
+	{
+		return lane == Lane::BULK ? mBulkSize : mChannels.size() - mBulkSize;
+	}
+
+	/**
+	 * @brief Sets the timeout for send/receive operations of all channels.
+	 *
+	 * Not safe to call while any channels are leased.
+	 *
+	 * @see Channel::setTimeout()
+	 *
+	 * @param timeout Timeout in milliseconds.
+	 */
+	void setTimeout(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the memory limit of the channels of the bulk lane, i.e. of
+	 * all channels unless there is a control lane.
+	 *
+	 * Not safe to call while any channels are leased.
+	 *
+	 * @see Channel::setMemoryLimit()
+	 *
+	 * @param memoryLimitBytes New memory limit in bytes.
+	 */
+	void setMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the buffer auto-tuning of the channels of the bulk lane.
+	 *
+	 * Each channel measures its own connection. Not safe to call while any
+	 * channels are leased.
+	 *
+	 * @see Channel::setBufferAutoTuning()
+	 *
+	 * @param tuning The bounds of the tuning.
+	 */
+	void setBufferAutoTuning(const BufferAutoTuning& tuning);
+	/**
+	 * @brief Sets the flow control of PUT/A requests of the channels of the
+	 * bulk lane.
+	 *
+	 * Each channel paces its own connection. Not safe to call while any
+	 * channels are leased.
+	 *
+	 * @see Channel::setPutFlowControl()
+	 *
+	 * @param options The settings of the flow control.
+	 */
+	void setPutFlowControl(const PutFlowControl& options);
+	/**
+	 * @brief Makes the channels of the bulk lane share a filter of the PUTA
+	 * records acknowledged already.
+	 *
+	 * Not safe to call while any channels are leased.
+	 *
+	 * @see Channel::setPutDedupFilter()
+	 *
+	 * @param filter The filter, or `nullptr` for none.
+	 */
+	void setPutDedupFilter(const std::shared_ptr<PutDedupFilter>& filter);
+	/**
+	 * @brief Makes all channels draw their buffers from a memory budget,
+	 * which may be shared with other pools and channels.
+	 *
+	 * Not safe to call while any channels are leased.
+	 *
+	 * @see Channel::setMemoryBudget()
+	 *
+	 * @param budget The budget, or `nullptr` for none.
+	 */
+	void setMemoryBudget(const std::shared_ptr<MemoryBudget>& budget);
+	/**
+	 * @brief Sets the tracer of all channels.
+	 *
+	 * The tracer is shared by the channels and may hence be called by several
+	 * threads at once. Not safe to call while any channels are leased.
+	 *
+	 * @see Channel::setTracer()
+	 *
+	 * @param tracer The tracer, or `nullptr` to disable tracing.
+	 */
+	void setTracer(std::shared_ptr<Tracer> tracer);
+	/**
+	 * @brief Sets the delay between two consecutive reconnection attempts of a
+	 * closed channel. By default, it's 1 second.
+	 * @param interval The delay in milliseconds.
+	 */
+	void setReconnectInterval(std::chrono::duration<std::int64_t, std::milli> interval);
+
+private:
+	/** @brief The default delay between reconnection attempts. */
+	static constexpr std::int64_t cDefaultReconnectIntervalMs = 1000;
+	/** @brief The free-list terminator. */
+	static constexpr std::uint32_t cNil = UINT32_MAX;
+	/** @brief The amount of lanes. */
+	static constexpr std::size_t cLanes = 2;
+
+	/** @brief Returns a leased channel to the free-list, or to the reconnection
+	 * thread if it's closed. */
+	void release(std::uint32_t index);
+	/** @brief Puts a connected channel on the free-list of its lane and wakes
+	 * up the threads waiting for it, if any. */
+	void makeAvailable(std::uint32_t index);
+	/** @brief Returns the lane of the `index`-th channel. */
+	Lane laneOf(std::uint32_t index) const { return index < mBulkSize ? Lane::BULK : Lane::CONTROL; }
+	/** @brief Pops an index for a request of `lane`: from the free-list of
+	 * the lane, or of the bulk lane for control requests. Returns `false` if
+	 * there is none. */
+	bool takeFree(Lane lane, std::uint32_t& oIndex);
+	/** @brief Returns `true` if `takeFree()` may succeed for `lane`. */
+	bool canTake(Lane lane) const;
+	/** @brief Pops an index from the free-list of `lane`. Returns `false` if
+	 * empty. */
+	bool popFree(Lane lane, std::uint32_t& oIndex);
+	/** @brief Pushes an index to the free-list of its lane. */
+	void pushFree(std::uint32_t index);
+	/** @brief Returns `true` if the free-list of `lane` is not empty. */
+	bool hasFree(Lane lane) const;
+	/** @brief The main loop of the reconnection thread. */
+	void reconnectLoop();
+
+	/** @brief The amount of CAP slices a sub-interval of `getParallel()` is
+	 * fetched in. */
+	static constexpr std::uint64_t cParallelSlices = 4;
+
+	/** @brief A sub-interval of `getParallel()`. */
+	struct ParallelRange
+	{
+		/** @brief The lower vertex of the sub-interval. */
+		Key keyMin;
+		/** @brief The upper vertex of the sub-interval, lowered in CAP when
+		 * the sub-interval is split. */
+		Key keyMax;
+		/** @brief The lower CAP bound of the span not fetched yet. */
+		Key::CapT next;
+		/** @brief The CAP width of a slice. */
+		std::uint64_t slice;
+		/** @brief `true` once a worker has taken the sub-interval. */
+		bool taken;
+	};
+	/** @brief The state of a `getParallel()` shared by its workers. */
+	struct ParallelGet
+	{
+		/** @brief The sub-intervals, split ones included. */
+		std::vector<ParallelRange> ranges;
+		/** @brief The responses of the slices fetched so far. */
+		std::vector<ResponseGet<T>> responses;
+		/** @brief The status code of the first failed slice. */
+		result_t status = result_t::OK;
+		/** @brief Guards the members above. */
+		std::mutex mutex;
+	};
+	/** @brief Makes a sub-interval of `getParallel()` out of
+	 * `[keyMin, keyMax)`. */
+	static ParallelRange makeParallelRange(const Key& keyMin, const Key& keyMax);
+	/** @brief Takes a sub-interval for an idle worker: one not taken yet, or
+	 * the upper half of the largest span left to fetch. Returns `false` if
+	 * there is none. Called with the mutex held. */
+	static bool takeParallelRange(ParallelGet& state, std::size_t& oIndex);
+	/** @brief The loop of a worker of `getParallel()`. */
+	void runParallelWorker(ParallelGet& state);
+
+	/** @brief An input iterator over records, through an iterator over
+	 * pointers to them. */
+	class RecordPtrIt
+	{
+	public:
+		/** @brief Wraps an iterator over pointers to records. */
+		explicit RecordPtrIt(typename std::vector<const Record<T>*>::const_iterator it)
+			: mIt(it)
+		{
+		}
+		/** @brief Returns the record pointed to. */
+		const Record<T>& operator*() const { return **mIt; }
+		/** @brief Advances to the next record. */
+		RecordPtrIt& operator++()
+		{
+			++mIt;
+			return *this;
+		}
+		/** @brief Returns `true` if the iterators point to different records. */
+		bool operator!=(const RecordPtrIt& other) const { return mIt != other.mIt; }
+
+	private:
+		/** @brief The iterator over pointers to records. */
+		typename std::vector<const Record<T>*>::const_iterator mIt;
+	};
+	/** @brief The common implementation of `putParallel()` and
+	 * `putaParallel()`. */
+	Response putParallelImpl(const RecordsSet<T>& data,
+		std::size_t connections,
+		bool puta,
+		std::vector<PutPartition>& oPartitions);
+
+	/** @brief Splits `[keyMin, keyMax)` into at most `shards` disjoint
+	 * sub-intervals, returning a single interval if it can't be split. */
+	static std::vector<std::pair<Key, Key>> splitKeyRange(
+		const Key& keyMin, const Key& keyMax, std::size_t shards);
+	/** @brief Returns the `index`-th of `parts` boundaries evenly dividing
+	 * `[lo, hi)`, with `lo` and `hi` being the 0-th and `parts`-th one. */
+	template<typename U>
+	static U splitPoint(U lo, U hi, std::size_t parts, std::size_t index);
+
+	/** @brief The pooled channels. */
+	std::vector<std::unique_ptr<Channel<T>>> mChannels;
+
+	/** @brief The amount of channels of the bulk lane, which come first. */
+	std::size_t mBulkSize;
+
+	/**
+	 * @brief The heads of the free-lists, indexed by lane.
+	 *
+	 * The lower 32 bits hold the index of the top channel (or `cNil`), the upper
+	 * 32 bits hold a modification counter protecting against ABA races.
+	 */
+	std::atomic<std::uint64_t> mFreeHead[cLanes];
+	/** @brief The free-list links, indexed by channel. */
+	std::unique_ptr<std::atomic<std::uint32_t>[]> mFreeNext;
+
+	/** @brief The amount of threads blocked inside `acquire()`, indexed by
+	 * the lane of their requests. */
+	std::atomic<std::uint32_t> mWaiters[cLanes];
+	/** @brief Guards waiting for idle channels. */
+	std::mutex mWaitMutex;
+	/** @brief Signals that a channel was returned to a free-list a request of
+	 * the lane may take from, indexed by the lane of the requests. */
+	std::condition_variable mAvailable[cLanes];
+
+	/** @brief Closed channels awaiting reconnection. */
+	std::vector<std::uint32_t> mBroken;
+	/** @brief `true` when the reconnection thread is requested to exit. */
+	bool mStop;
+	/** @brief `true` between `connect()` and `close()`. */
+	bool mStarted;
+	/** @brief The delay between reconnection attempts. */
+	std::chrono::duration<std::int64_t, std::milli> mReconnectInterval;
+	/** @brief Guards `mBroken`, `mStop` and `mReconnectInterval`. */
+	std::mutex mReconnectMutex;
+	/** @brief Wakes up the reconnection thread. */
+	std::condition_variable mReconnectCondition;
+	/** @brief The reconnection thread. */
+	std::thread mReconnectThread;
+};
+
+} /*namespace tstorage*/
+
+#include "ChannelPool.tpp"
+
+#endif
@@ -0,0 +1,743 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ChannelPool.tpp
+ *   An implementation of the `ChannelPool<T>` interface.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_CHANNELPOOL_TPP
+#define D_TSTORAGE_CHANNELPOOL_TPP
+
+#ifndef D_TSTORAGE_CHANNELPOOL_H
+#error __FILE__ was included from outside of "ChannelPool.h"
+#include "ChannelPool.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+#include "SharedPayloadType.h"
+#include "Tracer.h"
+
+/** @file
+ * @brief Contains the implementation of `ChannelPool<T>`. */
+
+namespace tstorage {
+
+template<typename T>
+constexpr std::int64_t ChannelPool<T>::cDefaultReconnectIntervalMs;
+template<typename T>
+constexpr std::uint32_t ChannelPool<T>::cNil;
+template<typename T>
+constexpr std::size_t ChannelPool<T>::cLanes;
+template<typename T>
+constexpr std::size_t ChannelPool<T>::cDefaultControlMemoryLimit;
+
+/**************
+ * Lease
+ */
+
+template<typename T>
+typename ChannelPool<T>::Lease& ChannelPool<T>::Lease::operator=(Lease&& other) noexcept
+{
+	if (this != &other) {
+		release();
+		mPool = other.mPool;
+		mIndex = other.mIndex;
+		other.mPool = nullptr;
+	}
+	return *this;
+}
+
+template<typename T>
+void ChannelPool<T>::Lease::release()
+{
+	if (mPool != nullptr) {
+		mPool->release(mIndex);
+		mPool = nullptr;
+	}
+}
+
+/**************
+ * Setup
+ */
+
+template<typename T>
+ChannelPool<T>::ChannelPool(const std::string& hostname,
+	const std::uint16_t port,
+	std::shared_ptr<PayloadType<T>> payloadType,
+	const std::size_t poolSize)
+	: mBulkSize(poolSize)
+	, mFreeNext(std::make_unique<std::atomic<std::uint32_t>[]>(poolSize))
+	, mStop(false)
+	, mStarted(false)
+	, mReconnectInterval(cDefaultReconnectIntervalMs)
+{
+	for (std::size_t lane = 0; lane < cLanes; ++lane) {
+		mFreeHead[lane].store(cNil);
+		mWaiters[lane].store(0);
+	}
+	mChannels.reserve(poolSize);
+	for (std::size_t i = 0; i < poolSize; ++i) {
+		mChannels.push_back(std::make_unique<Channel<T>>(
+			hostname, port, std::make_unique<SharedPayloadType<T>>(payloadType)));
+	}
+}
+
+template<typename T>
+ChannelPool<T>::~ChannelPool()
+{
+	close();
+}
+
+template<typename T>
+Response ChannelPool<T>::connect()
+{
+	if (mStarted) {
+		return Response(result_t::OK);
+	}
+	mStarted = true;
+	mStop = false;
+
+	result_t firstError = result_t::OK;
+	std::vector<std::uint32_t> broken;
+	for (std::uint32_t i = 0; i < mChannels.size(); ++i) {
+		const Response res = mChannels[i]->connect();
+		if (res.success()) {
+			makeAvailable(i);
+			continue;
+		}
+		if (firstError == result_t::OK) {
+			firstError = res.status();
+		}
+		broken.push_back(i);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mReconnectMutex);
+		mBroken = std::move(broken);
+	}
+	mReconnectThread = std::thread(&ChannelPool<T>::reconnectLoop, this);
+	return Response(firstError);
+}
+
+template<typename T>
+void ChannelPool<T>::close()
+{
+	if (!mStarted) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mReconnectMutex);
+		mStop = true;
+	}
+	mReconnectCondition.notify_all();
+	mReconnectThread.join();
+
+	std::uint32_t index{};
+	while (popFree(Lane::BULK, index) || popFree(Lane::CONTROL, index)) {
+		(void)mChannels[index]->close();
+	}
+	mBroken.clear();
+	mStarted = false;
+}
+
+template<typename T>
+void ChannelPool<T>::setTimeout(const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	for (std::unique_ptr<Channel<T>>& channel : mChannels) {
+		channel->setTimeout(timeout);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	for (std::size_t i = 0; i < mBulkSize; ++i) {
+		mChannels[i]->setMemoryLimit(memoryLimitBytes);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setBufferAutoTuning(const BufferAutoTuning& tuning)
+{
+	for (std::size_t i = 0; i < mBulkSize; ++i) {
+		mChannels[i]->setBufferAutoTuning(tuning);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setPutFlowControl(const PutFlowControl& options)
+{
+	for (std::size_t i = 0; i < mBulkSize; ++i) {
+		mChannels[i]->setPutFlowControl(options);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setPutDedupFilter(const std::shared_ptr<PutDedupFilter>& filter)
+{
+	for (std::size_t i = 0; i < mBulkSize; ++i) {
+		mChannels[i]->setPutDedupFilter(filter);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setControlLane(const std::size_t channels, const std::size_t memoryLimitBytes)
+{
+	const std::size_t size = mChannels.size();
+	mBulkSize = size - std::min(channels, size > 0 ? size - 1 : 0);
+
+	SocketOptions options{};
+	options.noDelay = true;
+	options.quickAck = true;
+	for (std::size_t i = mBulkSize; i < size; ++i) {
+		mChannels[i]->setMemoryLimit(memoryLimitBytes);
+		mChannels[i]->setSocketOptions(options);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setMemoryBudget(const std::shared_ptr<MemoryBudget>& budget)
+{
+	for (std::unique_ptr<Channel<T>>& channel : mChannels) {
+		channel->setMemoryBudget(budget);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setTracer(std::shared_ptr<Tracer> tracer)
+{
+	for (std::unique_ptr<Channel<T>>& channel : mChannels) {
+		channel->setTracer(tracer);
+	}
+}
+
+template<typename T>
+void ChannelPool<T>::setReconnectInterval(
+	const std::chrono::duration<std::int64_t, std::milli> interval)
+{
+	std::lock_guard<std::mutex> lock(mReconnectMutex);
+	mReconnectInterval = interval;
+}
+
+/**************
+ * Leasing
+ */
+
+template<typename T>
+typename ChannelPool<T>::Lease ChannelPool<T>::acquire(const Lane lane)
+{
+	const std::size_t l = static_cast<std::size_t>(lane);
+	std::uint32_t index{};
+	while (!takeFree(lane, index)) {
+		std::unique_lock<std::mutex> lock(mWaitMutex);
+		++mWaiters[l];
+		mAvailable[l].wait(lock, [this, lane]() { return canTake(lane); });
+		--mWaiters[l];
+	}
+	return Lease(this, index);
+}
+
+template<typename T>
+typename ChannelPool<T>::Lease ChannelPool<T>::acquire(
+	const std::chrono::duration<std::int64_t, std::milli> timeout, const Lane lane)
+{
+	const std::size_t l = static_cast<std::size_t>(lane);
+	const std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + timeout;
+	std::uint32_t index{};
+	while (!takeFree(lane, index)) {
+		std::unique_lock<std::mutex> lock(mWaitMutex);
+		++mWaiters[l];
+		const bool available =
+			mAvailable[l].wait_until(lock, deadline, [this, lane]() { return canTake(lane); });
+		--mWaiters[l];
+		if (!available) {
+			return Lease{};
+		}
+	}
+	return Lease(this, index);
+}
+
+template<typename T>
+typename ChannelPool<T>::Lease ChannelPool<T>::tryAcquire(const Lane lane)
+{
+	std::uint32_t index{};
+	if (!takeFree(lane, index)) {
+		return Lease{};
+	}
+	return Lease(this, index);
+}
+
+template<typename T>
+ResponseAcq ChannelPool<T>::getAcq(const Key& keyMin, const Key& keyMax)
+{
+	return acquire(Lane::CONTROL)->getAcq(keyMin, keyMax);
+}
+
+template<typename T>
+void ChannelPool<T>::release(const std::uint32_t index)
+{
+	if (mChannels[index]->connected()) {
+		makeAvailable(index);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mReconnectMutex);
+		mBroken.push_back(index);
+	}
+	mReconnectCondition.notify_one();
+}
+
+template<typename T>
+void ChannelPool<T>::makeAvailable(const std::uint32_t index)
+{
+	const Lane lane = laneOf(index);
+	pushFree(index);
+	const std::size_t bulk = static_cast<std::size_t>(Lane::BULK);
+	const std::size_t control = static_cast<std::size_t>(Lane::CONTROL);
+	// The push and this load, like the waiter's increment and its check of the
+	// free-list, are sequentially consistent: either the waiter sees the
+	// channel, or it is seen waiting here.
+	const bool wakeControl = mWaiters[control].load() > 0;
+	const bool wakeBulk = lane == Lane::BULK && mWaiters[bulk].load() > 0;
+	if (wakeControl || wakeBulk) {
+		// Taking the lock orders the push against a waiter's predicate check.
+		std::lock_guard<std::mutex> lock(mWaitMutex);
+		// A bulk channel may go to either lane: both are woken up, so that
+		// it isn't lost if the control waiter takes a control channel instead.
+		if (wakeControl) {
+			mAvailable[control].notify_one();
+		}
+		if (wakeBulk) {
+			mAvailable[bulk].notify_one();
+		}
+	}
+}
+
+/**************
+ * Parallel queries
+ */
+
+template<typename T>
+ResponseGet<T> ChannelPool<T>::getParallel(
+	const Key& keyMin, const Key& keyMax, const std::size_t shards)
+{
+	const std::vector<std::pair<Key, Key>> ranges = splitKeyRange(keyMin, keyMax, shards);
+	if (ranges.size() == 1) {
+		return acquire()->get(keyMin, keyMax);
+	}
+
+	ParallelGet state;
+	state.ranges.reserve(ranges.size());
+	for (const std::pair<Key, Key>& range : ranges) {
+		state.ranges.push_back(makeParallelRange(range.first, range.second));
+	}
+	std::vector<std::thread> threads;
+	threads.reserve(ranges.size() - 1);
+	for (std::size_t i = 1; i < ranges.size(); ++i) {
+		threads.emplace_back(&ChannelPool<T>::runParallelWorker, this, std::ref(state));
+	}
+	runParallelWorker(state);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	const result_t status = state.status;
+	Key::AcqT acq = Key::cAcqMax;
+	for (const ResponseGet<T>& response : state.responses) {
+		if (response.success()) {
+			acq = std::min(acq, response.acq());
+		}
+	}
+
+	RecordsSet<T> records{};
+	for (const ResponseGet<T>& response : state.responses) {
+		for (const Record<T>& record : response.records()) {
+			if (status != result_t::OK || record.key.acq <= acq) {
+				records.append(record.key, record.value);
+			}
+		}
+	}
+	if (status != result_t::OK) {
+		return ResponseGet<T>(status, std::move(records), 0);
+	}
+	return ResponseGet<T>(status, std::move(records), acq);
+}
+
+template<typename T>
+Response ChannelPool<T>::putParallel(const RecordsSet<T>& data,
+	const std::size_t connections,
+	std::vector<PutPartition>& oPartitions)
+{
+	return putParallelImpl(data, connections, false, oPartitions);
+}
+
+template<typename T>
+Response ChannelPool<T>::putParallel(const RecordsSet<T>& data, const std::size_t connections)
+{
+	std::vector<PutPartition> partitions;
+	return putParallelImpl(data, connections, false, partitions);
+}
+
+template<typename T>
+Response ChannelPool<T>::putaParallel(const RecordsSet<T>& data,
+	const std::size_t connections,
+	std::vector<PutPartition>& oPartitions)
+{
+	return putParallelImpl(data, connections, true, oPartitions);
+}
+
+template<typename T>
+Response ChannelPool<T>::putaParallel(const RecordsSet<T>& data, const std::size_t connections)
+{
+	std::vector<PutPartition> partitions;
+	return putParallelImpl(data, connections, true, partitions);
+}
+
+template<typename T>
+Response ChannelPool<T>::putParallelImpl(const RecordsSet<T>& data,
+	const std::size_t connections,
+	const bool puta,
+	std::vector<PutPartition>& oPartitions)
+{
+	std::unordered_map<Key::CidT, std::size_t> slots;
+	for (const Record<T>& record : data) {
+		++slots[record.key.cid];
+	}
+	std::vector<std::pair<Key::CidT, std::size_t>> cids(slots.begin(), slots.end());
+
+	oPartitions.clear();
+	if (connections <= 1 || cids.size() <= 1) {
+		oPartitions.emplace_back();
+		PutPartition& partition = oPartitions.back();
+		for (const std::pair<Key::CidT, std::size_t>& cid : cids) {
+			partition.cids.push_back(cid.first);
+		}
+		std::sort(partition.cids.begin(), partition.cids.end());
+		partition.records = data.size();
+		Lease lease = acquire();
+		partition.status = (puta ? lease->puta(data) : lease->put(data)).status();
+		return Response(partition.status);
+	}
+
+	// Hands out the CIDs from the largest one, each to the least loaded
+	// partition.
+	using CidRecords = std::pair<Key::CidT, std::size_t>;
+	std::sort(cids.begin(), cids.end(), [](const CidRecords& a, const CidRecords& b) {
+		return a.second != b.second ? a.second > b.second : a.first < b.first;
+	});
+	oPartitions.resize(std::min(connections, cids.size()));
+	for (const std::pair<Key::CidT, std::size_t>& cid : cids) {
+		PutPartition& partition = *std::min_element(oPartitions.begin(),
+			oPartitions.end(),
+			[](const PutPartition& a, const PutPartition& b) { return a.records < b.records; });
+		partition.cids.push_back(cid.first);
+		partition.records += cid.second;
+	}
+
+	// Lays the records out partition by partition, then CID by CID, turning
+	// the amounts of records of the CIDs into the slots of their next records.
+	std::vector<std::size_t> begins;
+	begins.reserve(oPartitions.size() + 1);
+	std::size_t slot = 0;
+	for (PutPartition& partition : oPartitions) {
+		begins.push_back(slot);
+		std::sort(partition.cids.begin(), partition.cids.end());
+		for (const Key::CidT cid : partition.cids) {
+			const std::size_t records = slots[cid];
+			slots[cid] = slot;
+			slot += records;
+		}
+	}
+	begins.push_back(slot);
+	std::vector<const Record<T>*> order(data.size());
+	for (const Record<T>& record : data) {
+		order[slots[record.key.cid]++] = &record;
+	}
+
+	const auto runPartition = [this, puta, &order, &begins, &oPartitions](const std::size_t i) {
+		const RecordPtrIt first(order.cbegin() + begins[i]);
+		const RecordPtrIt last(order.cbegin() + begins[i + 1]);
+		Lease lease = acquire();
+		const Response response = puta ? lease->puta(first, last) : lease->put(first, last);
+		oPartitions[i].status = response.status();
+	};
+	std::vector<std::thread> threads;
+	threads.reserve(oPartitions.size() - 1);
+	for (std::size_t i = 1; i < oPartitions.size(); ++i) {
+		threads.emplace_back(runPartition, i);
+	}
+	runPartition(0);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	for (const PutPartition& partition : oPartitions) {
+		if (partition.status != result_t::OK) {
+			return Response(partition.status);
+		}
+	}
+	return Response(result_t::OK);
+}
+
+template<typename T>
+typename ChannelPool<T>::ParallelRange ChannelPool<T>::makeParallelRange(
+	const Key& keyMin, const Key& keyMax)
+{
+	const std::uint64_t capSpan = static_cast<std::uint64_t>(keyMax.cap)
+		- static_cast<std::uint64_t>(keyMin.cap);
+	ParallelRange range{};
+	range.keyMin = keyMin;
+	range.keyMax = keyMax;
+	range.next = keyMin.cap;
+	range.slice = std::max<std::uint64_t>(capSpan / cParallelSlices, 1);
+	range.taken = false;
+	return range;
+}
+
+template<typename T>
+bool ChannelPool<T>::takeParallelRange(ParallelGet& state, std::size_t& oIndex)
+{
+	for (std::size_t i = 0; i < state.ranges.size(); ++i) {
+		if (!state.ranges[i].taken) {
+			state.ranges[i].taken = true;
+			oIndex = i;
+			return true;
+		}
+	}
+
+	std::size_t victim = state.ranges.size();
+	std::uint64_t largest = 0;
+	for (std::size_t i = 0; i < state.ranges.size(); ++i) {
+		const ParallelRange& range = state.ranges[i];
+		const std::uint64_t left = static_cast<std::uint64_t>(range.keyMax.cap)
+			- static_cast<std::uint64_t>(range.next);
+		if (left / 2 >= range.slice && left > largest) {
+			victim = i;
+			largest = left;
+		}
+	}
+	if (victim == state.ranges.size()) {
+		return false;
+	}
+
+	ParallelRange& range = state.ranges[victim];
+	Key keyMin = range.keyMin;
+	keyMin.cap = static_cast<Key::CapT>(static_cast<std::uint64_t>(range.next) + largest / 2);
+	const Key keyMax = range.keyMax;
+	range.keyMax.cap = keyMin.cap;
+	state.ranges.push_back(makeParallelRange(keyMin, keyMax));
+	state.ranges.back().taken = true;
+	oIndex = state.ranges.size() - 1;
+	return true;
+}
+
+template<typename T>
+void ChannelPool<T>::runParallelWorker(ParallelGet& state)
+{
+	std::unique_lock<std::mutex> lock(state.mutex);
+	std::size_t index = 0;
+	while (state.status == result_t::OK && takeParallelRange(state, index)) {
+		while (state.status == result_t::OK) {
+			// The range may be moved by a split, and its upper bound lowered.
+			ParallelRange& range = state.ranges[index];
+			const std::uint64_t left = static_cast<std::uint64_t>(range.keyMax.cap)
+				- static_cast<std::uint64_t>(range.next);
+			if (left == 0) {
+				break;
+			}
+			Key sliceMin = range.keyMin;
+			Key sliceMax = range.keyMax;
+			sliceMin.cap = range.next;
+			sliceMax.cap = static_cast<Key::CapT>(
+				static_cast<std::uint64_t>(range.next) + std::min(left, range.slice));
+			range.next = sliceMax.cap;
+
+			lock.unlock();
+			ResponseGet<T> response = acquire()->get(sliceMin, sliceMax);
+			lock.lock();
+			if (response.error() && state.status == result_t::OK) {
+				state.status = response.status();
+			}
+			state.responses.push_back(std::move(response));
+		}
+	}
+}
+
+template<typename T>
+std::vector<std::pair<Key, Key>> ChannelPool<T>::splitKeyRange(
+	const Key& keyMin, const Key& keyMax, const std::size_t shards)
+{
+	std::vector<std::pair<Key, Key>> ranges;
+	if (shards <= 1 || !keyMin.isValid() || !keyMax.isValid() || !(keyMin <= keyMax - 1)) {
+		// Let `Channel::get()` validate the keys and report errors.
+		ranges.emplace_back(keyMin, keyMax);
+		return ranges;
+	}
+
+	const std::uint64_t cidSpan = static_cast<std::uint64_t>(keyMax.cid)
+		- static_cast<std::uint64_t>(keyMin.cid);
+	const std::uint64_t capSpan = static_cast<std::uint64_t>(keyMax.cap)
+		- static_cast<std::uint64_t>(keyMin.cap);
+	const bool byCid = cidSpan >= shards;
+	const std::size_t parts =
+		static_cast<std::size_t>(std::min<std::uint64_t>(byCid ? cidSpan : capSpan, shards));
+
+	Key lo = keyMin;
+	for (std::size_t i = 1; i <= parts; ++i) {
+		Key hi = keyMax;
+		if (byCid) {
+			hi.cid = splitPoint(keyMin.cid, keyMax.cid, parts, i);
+		} else {
+			hi.cap = splitPoint(keyMin.cap, keyMax.cap, parts, i);
+		}
+		ranges.emplace_back(lo, hi);
+		if (byCid) {
+			lo.cid = hi.cid;
+		} else {
+			lo.cap = hi.cap;
+		}
+	}
+	return ranges;
+}
+
+template<typename T>
+template<typename U>
+U ChannelPool<T>::splitPoint(
+	const U lo, const U hi, const std::size_t parts, const std::size_t index)
+{
+	const std::uint64_t span = static_cast<std::uint64_t>(hi) - static_cast<std::uint64_t>(lo);
+	const std::uint64_t offset = span / parts * index + std::min<std::uint64_t>(index, span % parts);
+	return static_cast<U>(static_cast<std::uint64_t>(lo) + offset);
+}
+
+/**************
+ * Free-list
+ */
+
+template<typename T>
+bool ChannelPool<T>::takeFree(const Lane lane, std::uint32_t& oIndex)
+{
+	if (lane == Lane::CONTROL && popFree(Lane::CONTROL, oIndex)) {
+		return true;
+	}
+	return popFree(Lane::BULK, oIndex);
+}
+
+template<typename T>
+bool ChannelPool<T>::canTake(const Lane lane) const
+{
+	return (lane == Lane::CONTROL && hasFree(Lane::CONTROL)) || hasFree(Lane::BULK);
+}
+
+template<typename T>
+bool ChannelPool<T>::popFree(const Lane lane, std::uint32_t& oIndex)
+{
+	std::atomic<std::uint64_t>& freeHead = mFreeHead[static_cast<std::size_t>(lane)];
+	std::uint64_t head = freeHead.load(std::memory_order_acquire);
+	while (static_cast<std::uint32_t>(head) != cNil) {
+		const std::uint32_t index = static_cast<std::uint32_t>(head);
+		const std::uint32_t next = mFreeNext[index].load(std::memory_order_relaxed);
+		const std::uint64_t newHead = ((head >> 32U) + 1) << 32U | next;
+		if (freeHead.compare_exchange_weak(
+				head, newHead, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			oIndex = index;
+			return true;
+		}
+	}
+	return false;
+}
+
+template<typename T>
+void ChannelPool<T>::pushFree(const std::uint32_t index)
+{
+	std::atomic<std::uint64_t>& freeHead = mFreeHead[static_cast<std::size_t>(laneOf(index))];
+	std::uint64_t head = freeHead.load(std::memory_order_relaxed);
+	std::uint64_t newHead{};
+	do {
+		mFreeNext[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+		newHead = ((head >> 32U) + 1) << 32U | index;
+	} while (!freeHead.compare_exchange_weak(
+		head, newHead, std::memory_order_seq_cst, std::memory_order_relaxed));
+}
+
+template<typename T>
+bool ChannelPool<T>::hasFree(const Lane lane) const
+{
+	const std::size_t l = static_cast<std::size_t>(lane);
+	return static_cast<std::uint32_t>(mFreeHead[l].load(std::memory_order_seq_cst)) != cNil;
+}
+
+/**************
+ * Reconnection
+ */
+
+template<typename T>
+void ChannelPool<T>::reconnectLoop()
+{
+	std::unique_lock<std::mutex> lock(mReconnectMutex);
+	while (!mStop) {
+		if (mBroken.empty()) {
+			mReconnectCondition.wait(lock, [this]() { return mStop || !mBroken.empty(); });
+			continue;
+		}
+
+		std::vector<std::uint32_t> pending;
+		pending.swap(mBroken);
+		lock.unlock();
+
+		std::vector<std::uint32_t> failed;
+		for (const std::uint32_t index : pending) {
+			if (mChannels[index]->connect().success()) {
+				makeAvailable(index);
+			} else {
+				failed.push_back(index);
+			}
+		}
+
+		lock.lock();
+		mBroken.insert(mBroken.end(), failed.begin(), failed.end());
+		if (!failed.empty()) {
+			mReconnectCondition.wait_for(lock, mReconnectInterval, [this]() { return mStop; });
+		}
+	}
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,245 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ClusterChannel.h
+ *   A client of several TStorage instances sharded by CID.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_CLUSTERCHANNEL_H
+#define D_TSTORAGE_CLUSTERCHANNEL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ratio>
+#include <utility>
+#include <vector>
+
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Defines the `ClusterChannel<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A client of a fleet of TStorage instances, each storing the records
+ * of a disjoint set of CIDs.
+ *
+ * CIDs are assigned to the nodes by consistent hashing: every node is placed
+ * on a hash ring at `cVirtualNodes` points derived from its endpoint, and a
+ * CID belongs to the node owning the first point at or after the hash of the
+ * CID. Adding a node to the list thus moves only the CIDs it takes over,
+ * roughly `1/n` of them, and leaves the rest in place. The assignment depends
+ * on the endpoints only, not on their order; the same endpoint listed more
+ * than once makes distinct nodes.
+ *
+ * Each node is served by a `ChannelPool<T>`. `put()` and `puta()` split the
+ * records by owning node and send the parts concurrently, one thread per node
+ * involved. `get()` and `getAcq()` query only the nodes owning a CID of the
+ * key-interval, concurrently as well, and merge the responses.
+ *
+ * Being built on channel pools, a cluster channel may be used by several
+ * threads at once. All nodes share a single `PayloadType<T>` instance, which
+ * hence has to be safe to use concurrently (see `SharedPayloadType<T>`).
+ *
+ * Programs using this class have to be linked with `-pthread`.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class ClusterChannel final
+{
+public:
+	/** @brief The amount of points each node takes on the hash ring. */
+	static constexpr std::size_t cVirtualNodes = 64;
+	/** @brief The widest CID span of a query which is routed to the owners of
+	 * its CIDs; queries spanning more CIDs are sent to all nodes. */
+	static constexpr std::uint64_t cMaxRoutedCids = 4096;
+
+	/**
+	 * @brief Constructs a client of the TStorage instances under the given
+	 * addresses.
+	 *
+	 * No connections are established until `connect()` is called.
+	 *
+	 * @param nodes The addresses of the nodes. Must not be empty.
+	 * @param payloadType A `PayloadType` instance shared by all channels.
+	 * @param channelsPerNode The amount of channels in the pool of each node.
+	 */
+	ClusterChannel(const std::vector<Endpoint>& nodes,
+		std::shared_ptr<PayloadType<T>> payloadType,
+		std::size_t channelsPerNode);
+
+	ClusterChannel(const ClusterChannel&) = delete;
+	ClusterChannel(ClusterChannel&&) = delete;
+	ClusterChannel& operator=(const ClusterChannel&) = delete;
+	ClusterChannel& operator=(ClusterChannel&&) = delete;
+
+	/**
+	 * @brief Connects the channel pools of all nodes.
+	 *
+	 * @see ChannelPool::connect()
+	 *
+	 * @return A `Response` with the status code of the first node which failed
+	 * to connect, or a success code if all nodes are connected.
+	 */
+	Response connect();
+	/**
+	 * @brief Closes the channel pools of all nodes.
+	 *
+	 * No requests may be in progress.
+	 */
+	void close();
+
+	/**
+	 * @brief Sends records to their owning nodes with concurrent PUT requests.
+	 *
+	 * The records are copied into one `RecordsSet<T>` per node involved, which
+	 * is then sent with `Channel::put()` over a channel leased from the node's
+	 * pool. The requests are independent: if one of them fails, the records
+	 * sent to the other nodes may still be stored.
+	 *
+	 * @see Channel::put()
+	 *
+	 * @param data The records to send.
+	 * @return A `Response` with the status code of the first failed request in
+	 * the order of nodes, or a success code.
+	 */
+	Response put(const RecordsSet<T>& data);
+	/**
+	 * @brief Sends records with their ACQs to their owning nodes with
+	 * concurrent PUTA requests.
+	 *
+	 * @see put()
+	 * @see Channel::puta()
+	 *
+	 * @param data The records to send.
+	 * @return A `Response` with the status code of the first failed request in
+	 * the order of nodes, or a success code.
+	 */
+	Response puta(const RecordsSet<T>& data);
+
+	/**
+	 * @brief Retrieves records from a key-interval of all nodes owning one of
+	 * its CIDs.
+	 *
+	 * The nodes are queried concurrently with `Channel::get()`, each for the
+	 * whole key-interval. The responses are merged as in
+	 * `ChannelPool::getParallel()`: the merged ACQ is the smallest of the
+	 * nodes' ACQs and later records are dropped. The order of the records is
+	 * not specified. If any of the queries fails, the status code of the first
+	 * failed one in the order of nodes is returned together with all records
+	 * obtained.
+	 *
+	 * @see Channel::get()
+	 *
+	 * @param keyMin The lower bound of the key-interval.
+	 * @param keyMax The upper bound of the key-interval.
+	 * @return A merged response.
+	 */
+	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Retrieves the full-commit ACQ of a key-interval, i.e. the smallest
+	 * of the ACQs returned by the nodes owning one of its CIDs.
+	 *
+	 * The nodes are queried over the control lanes of their pools (see
+	 * `setControlLane()`).
+	 *
+	 * @see Channel::getAcq()
+	 *
+	 * @param keyMin The lower bound of the key-interval.
+	 * @param keyMax The upper bound of the key-interval.
+	 * @return A response with the smallest ACQ, or the status code of the
+	 * first failed query in the order of nodes.
+	 */
+	ResponseAcq getAcq(const Key& keyMin, const Key& keyMax);
+
+	/** @brief Returns the index of the node owning `cid`. */
+	std::size_t nodeOf(Key::CidT cid) const;
+	/** @brief Returns the amount of nodes. */
+	std::size_t size() const { return mNodes.size(); }
+	/** @brief Accesses the channel pool of the `index`-th node. */
+	ChannelPool<T>& node(std::size_t index) { return *mNodes[index]; }
+
+	/**
+	 * @brief Sets the timeout for send/receive operations of all channels.
+	 * @see ChannelPool::setTimeout()
+	 * @param timeout Timeout in milliseconds.
+	 */
+	void setTimeout(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the memory limit of all channels.
+	 * @see ChannelPool::setMemoryLimit()
+	 * @param memoryLimitBytes New memory limit in bytes.
+	 */
+	void setMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Reserves channels of every pool for control requests. Must be
+	 * called before `connect()`.
+	 * @see ChannelPool::setControlLane()
+	 * @param channels The amount of control channels per pool.
+	 * @param memoryLimitBytes The memory limit of the control channels.
+	 */
+	void setControlLane(std::size_t channels,
+		std::size_t memoryLimitBytes = ChannelPool<T>::cDefaultControlMemoryLimit);
+	/**
+	 * @brief Sets the delay between reconnection attempts of all pools.
+	 * @see ChannelPool::setReconnectInterval()
+	 * @param interval The delay in milliseconds.
+	 */
+	void setReconnectInterval(std::chrono::duration<std::int64_t, std::milli> interval);
+
+private:
+	/** @brief Sends each node its share of `data` with `put()` or `puta()`. */
+	Response putImpl(const RecordsSet<T>& data, bool puta);
+	/** @brief Returns the indices of the nodes owning a CID of
+	 * `[keyMin, keyMax)` in ascending order, or just the first node if the
+	 * interval is invalid or empty, to let the channel report it. */
+	std::vector<std::size_t> ownersOf(const Key& keyMin, const Key& keyMax) const;
+	/** @brief Calls `query(i, node)` for every `i`-th of `nodes` concurrently,
+	 * running the first one on the calling thread. */
+	template<typename Query>
+	static void fanOut(const std::vector<std::size_t>& nodes, const Query& query);
+
+	/** @brief Mixes the bits of a CID into a point on the hash ring. */
+	static std::uint64_t hashCid(Key::CidT cid);
+	/** @brief Returns the `point`-th point on the hash ring of the
+	 * `occurrence`-th node listed under `endpoint`. */
+	static std::uint64_t hashNode(
+		const Endpoint& endpoint, std::size_t occurrence, std::size_t point);
+	/** @brief Spreads the bits of `hash` evenly over the hash ring. */
+	static std::uint64_t mix(std::uint64_t hash);
+
+	/** @brief The channel pools, one per node. */
+	std::vector<std::unique_ptr<ChannelPool<T>>> mNodes;
+	/** @brief The hash ring, sorted points paired with their node indices. */
+	std::vector<std::pair<std::uint64_t, std::size_t>> mRing;
+};
+
+} /*namespace tstorage*/
+
+#include "ClusterChannel.tpp"
+
+#endif
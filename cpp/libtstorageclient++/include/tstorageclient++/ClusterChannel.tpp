@@ -0,0 +1,343 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ClusterChannel.tpp
+ *   An implementation of the `ClusterChannel<T>` interface.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_CLUSTERCHANNEL_TPP
+#define D_TSTORAGE_CLUSTERCHANNEL_TPP
+
+#ifndef D_TSTORAGE_CLUSTERCHANNEL_H
+#error __FILE__ was included from outside of "ClusterChannel.h"
+#include "ClusterChannel.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Contains the implementation of `ClusterChannel<T>`. */
+
+namespace tstorage {
+
+template<typename T>
+constexpr std::size_t ClusterChannel<T>::cVirtualNodes;
+template<typename T>
+constexpr std::uint64_t ClusterChannel<T>::cMaxRoutedCids;
+
+/**************
+ * Setup
+ */
+
+template<typename T>
+ClusterChannel<T>::ClusterChannel(const std::vector<Endpoint>& nodes,
+	std::shared_ptr<PayloadType<T>> payloadType,
+	const std::size_t channelsPerNode)
+{
+	mNodes.reserve(nodes.size());
+	mRing.reserve(nodes.size() * cVirtualNodes);
+	for (std::size_t i = 0; i < nodes.size(); ++i) {
+		mNodes.push_back(std::make_unique<ChannelPool<T>>(
+			nodes[i].hostname, nodes[i].port, payloadType, channelsPerNode));
+
+		const std::size_t occurrence = static_cast<std::size_t>(
+			std::count_if(nodes.begin(), nodes.begin() + i, [&nodes, i](const Endpoint& other) {
+				return other.hostname == nodes[i].hostname && other.port == nodes[i].port;
+			}));
+		for (std::size_t point = 0; point < cVirtualNodes; ++point) {
+			mRing.emplace_back(hashNode(nodes[i], occurrence, point), i);
+		}
+	}
+	std::sort(mRing.begin(), mRing.end());
+}
+
+template<typename T>
+Response ClusterChannel<T>::connect()
+{
+	result_t firstError = result_t::OK;
+	for (std::unique_ptr<ChannelPool<T>>& node : mNodes) {
+		const Response res = node->connect();
+		if (res.error() && firstError == result_t::OK) {
+			firstError = res.status();
+		}
+	}
+	return Response(firstError);
+}
+
+template<typename T>
+void ClusterChannel<T>::close()
+{
+	for (std::unique_ptr<ChannelPool<T>>& node : mNodes) {
+		node->close();
+	}
+}
+
+template<typename T>
+void ClusterChannel<T>::setTimeout(const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	for (std::unique_ptr<ChannelPool<T>>& node : mNodes) {
+		node->setTimeout(timeout);
+	}
+}
+
+template<typename T>
+void ClusterChannel<T>::setMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	for (std::unique_ptr<ChannelPool<T>>& node : mNodes) {
+		node->setMemoryLimit(memoryLimitBytes);
+	}
+}
+
+template<typename T>
+void ClusterChannel<T>::setControlLane(const std::size_t channels, const std::size_t memoryLimitBytes)
+{
+	for (std::unique_ptr<ChannelPool<T>>& node : mNodes) {
+		node->setControlLane(channels, memoryLimitBytes);
+	}
+}
+
+template<typename T>
+void ClusterChannel<T>::setReconnectInterval(
+	const std::chrono::duration<std::int64_t, std::milli> interval)
+{
+	for (std::unique_ptr<ChannelPool<T>>& node : mNodes) {
+		node->setReconnectInterval(interval);
+	}
+}
+
+/**************
+ * Requests
+ */
+
+template<typename T>
+Response ClusterChannel<T>::put(const RecordsSet<T>& data)
+{
+	return putImpl(data, false);
+}
+
+template<typename T>
+Response ClusterChannel<T>::puta(const RecordsSet<T>& data)
+{
+	return putImpl(data, true);
+}
+
+template<typename T>
+Response ClusterChannel<T>::putImpl(const RecordsSet<T>& data, const bool puta)
+{
+	if (mNodes.size() == 1) {
+		ChannelPool<T>& node = *mNodes[0];
+		return puta ? node.acquire()->puta(data) : node.acquire()->put(data);
+	}
+
+	std::vector<RecordsSet<T>> parts(mNodes.size());
+	for (const Record<T>& record : data) {
+		parts[nodeOf(record.key.cid)].append(record);
+	}
+	std::vector<std::size_t> nodes;
+	for (std::size_t i = 0; i < parts.size(); ++i) {
+		if (parts[i].size() > 0) {
+			nodes.push_back(i);
+		}
+	}
+	if (nodes.empty()) {
+		// Let an empty request go through, as a plain channel does.
+		nodes.push_back(0);
+	}
+
+	std::vector<Response> responses(nodes.size(), Response(result_t::OK));
+	fanOut(nodes, [this, puta, &parts, &responses](const std::size_t i, const std::size_t node) {
+		typename ChannelPool<T>::Lease lease = mNodes[node]->acquire();
+		responses[i] = puta ? lease->puta(parts[node]) : lease->put(parts[node]);
+	});
+
+	for (const Response& response : responses) {
+		if (response.error()) {
+			return response;
+		}
+	}
+	return Response(result_t::OK);
+}
+
+template<typename T>
+ResponseGet<T> ClusterChannel<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	const std::vector<std::size_t> nodes = ownersOf(keyMin, keyMax);
+	if (nodes.size() == 1) {
+		return mNodes[nodes[0]]->acquire()->get(keyMin, keyMax);
+	}
+
+	std::vector<ResponseGet<T>> responses(nodes.size(), ResponseGet<T>(result_t::OK));
+	fanOut(nodes, [this, &keyMin, &keyMax, &responses](const std::size_t i, const std::size_t node) {
+		responses[i] = mNodes[node]->acquire()->get(keyMin, keyMax);
+	});
+
+	result_t status = result_t::OK;
+	Key::AcqT acq = Key::cAcqMax;
+	for (const ResponseGet<T>& response : responses) {
+		if (response.error()) {
+			status = response.status();
+			break;
+		}
+		acq = std::min(acq, response.acq());
+	}
+
+	RecordsSet<T> records{};
+	for (const ResponseGet<T>& response : responses) {
+		for (const Record<T>& record : response.records()) {
+			if (status != result_t::OK || record.key.acq <= acq) {
+				records.append(record.key, record.value);
+			}
+		}
+	}
+	if (status != result_t::OK) {
+		return ResponseGet<T>(status, std::move(records), 0);
+	}
+	return ResponseGet<T>(status, std::move(records), acq);
+}
+
+template<typename T>
+ResponseAcq ClusterChannel<T>::getAcq(const Key& keyMin, const Key& keyMax)
+{
+	const std::vector<std::size_t> nodes = ownersOf(keyMin, keyMax);
+	if (nodes.size() == 1) {
+		return mNodes[nodes[0]]->getAcq(keyMin, keyMax);
+	}
+
+	std::vector<ResponseAcq> responses(nodes.size(), ResponseAcq(result_t::OK));
+	fanOut(nodes, [this, &keyMin, &keyMax, &responses](const std::size_t i, const std::size_t node) {
+		responses[i] = mNodes[node]->getAcq(keyMin, keyMax);
+	});
+
+	Key::AcqT acq = Key::cAcqMax;
+	for (const ResponseAcq& response : responses) {
+		if (response.error()) {
+			return response;
+		}
+		acq = std::min(acq, response.acq());
+	}
+	return ResponseAcq(result_t::OK, acq);
+}
+
+template<typename T>
+template<typename Query>
+void ClusterChannel<T>::fanOut(const std::vector<std::size_t>& nodes, const Query& query)
+{
+	std::vector<std::thread> threads;
+	threads.reserve(nodes.size() - 1);
+	for (std::size_t i = 1; i < nodes.size(); ++i) {
+		threads.emplace_back(query, i, nodes[i]);
+	}
+	query(0, nodes[0]);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+/**************
+ * Routing
+ */
+
+template<typename T>
+std::size_t ClusterChannel<T>::nodeOf(const Key::CidT cid) const
+{
+	const std::uint64_t hash = hashCid(cid);
+	auto point = std::lower_bound(mRing.begin(), mRing.end(),
+		std::make_pair(hash, static_cast<std::size_t>(0)));
+	if (point == mRing.end()) {
+		point = mRing.begin();
+	}
+	return point->second;
+}
+
+template<typename T>
+std::vector<std::size_t> ClusterChannel<T>::ownersOf(const Key& keyMin, const Key& keyMax) const
+{
+	if (!keyMin.isValid() || !keyMax.isValid() || keyMin.cid >= keyMax.cid) {
+		return {0};
+	}
+
+	std::vector<std::size_t> nodes;
+	const std::uint64_t cidSpan = static_cast<std::uint64_t>(keyMax.cid)
+		- static_cast<std::uint64_t>(keyMin.cid);
+	if (cidSpan > cMaxRoutedCids) {
+		for (std::size_t i = 0; i < mNodes.size(); ++i) {
+			nodes.push_back(i);
+		}
+		return nodes;
+	}
+
+	std::vector<bool> owners(mNodes.size(), false);
+	for (Key::CidT cid = keyMin.cid; cid < keyMax.cid; ++cid) {
+		owners[nodeOf(cid)] = true;
+	}
+	for (std::size_t i = 0; i < owners.size(); ++i) {
+		if (owners[i]) {
+			nodes.push_back(i);
+		}
+	}
+	return nodes;
+}
+
+template<typename T>
+std::uint64_t ClusterChannel<T>::hashCid(const Key::CidT cid)
+{
+	return mix(static_cast<std::uint64_t>(static_cast<std::uint32_t>(cid)));
+}
+
+template<typename T>
+std::uint64_t ClusterChannel<T>::hashNode(
+	const Endpoint& endpoint, const std::size_t occurrence, const std::size_t point)
+{
+	// FNV-1a of "hostname:port#occurrence/point".
+	const std::string name = endpoint.hostname + ":" + std::to_string(endpoint.port) + "#"
+		+ std::to_string(occurrence) + "/" + std::to_string(point);
+	std::uint64_t hash = 0xCBF29CE484222325ULL;
+	for (const char c : name) {
+		hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+	}
+	return mix(hash);
+}
+
+template<typename T>
+std::uint64_t ClusterChannel<T>::mix(std::uint64_t hash)
+{
+	// The finalizer of SplitMix64.
+	hash = (hash ^ (hash >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27U)) * 0x94D049BB133111EBULL;
+	return hash ^ (hash >> 31U);
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,181 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * CoalescingPool.h
+ *   Single-flight coalescing of identical concurrent queries over a pool.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_COALESCINGPOOL_H
+#define D_TSTORAGE_COALESCINGPOOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Defines the `CoalescingPool<T>` class. */
+
+namespace tstorage {
+
+/** @brief The options of a `CoalescingPool<T>`. */
+struct CoalescingOptions
+{
+	/** @brief How long a successful `getAcq()` response is served to later
+	 * calls on the same key-interval, `0` not to cache them at all. */
+	std::chrono::microseconds acqTtl{0};
+	/** @brief The bound of the amount of cached `getAcq()` responses. */
+	std::size_t maxCachedAcqs = 4096;
+};
+
+/**
+ * @brief A thread-safe front end of a channel pool, merging identical
+ * concurrent queries into a single request.
+ *
+ * Request handlers often ask for the ACQ, or the records, of the same
+ * key-interval at about the same time, each paying for its own round trip
+ * and its own channel. The first call on a key-interval sends the request;
+ * calls with the same bounds arriving while it is in flight wait for it and
+ * return a copy of its response instead of sending their own. A call
+ * arriving after the response starts a new request, so that no response is
+ * older than the call that returns it.
+ *
+ * With `CoalescingOptions::acqTtl` set, the successful `getAcq()` responses
+ * are also kept for that long, and returned by later calls on the same
+ * key-interval without a request. The ACQ so returned may lag the one of the
+ * server by up to the TTL; a full-commit ACQ never decreases, so it remains a
+ * valid, if conservative, bound.
+ *
+ * Failed responses are shared by the calls that joined them, but are not
+ * cached. `getAcq()` and `get()` calls do not join each other.
+ *
+ * The pool must be connected beforehand and must outlive this object.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class CoalescingPool final
+{
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param pool The pool sending the requests.
+	 * @param options The options of the coalescing.
+	 */
+	CoalescingPool(ChannelPool<T>& pool, const CoalescingOptions& options);
+	/** @brief Constructs a front end with the default options, i.e. without
+	 * a cache. */
+	explicit CoalescingPool(ChannelPool<T>& pool) : CoalescingPool(pool, CoalescingOptions{}) {}
+
+	CoalescingPool(const CoalescingPool&) = delete;
+	CoalescingPool(CoalescingPool&&) = delete;
+	CoalescingPool& operator=(const CoalescingPool&) = delete;
+	CoalescingPool& operator=(CoalescingPool&&) = delete;
+
+	/**
+	 * @brief Returns the current ACQ of a key-interval like
+	 * `ChannelPool<T>::getAcq()`, sharing the request of an identical call in
+	 * flight, or the cached response of a recent one.
+	 *
+	 * @see ChannelPool<T>::getAcq()
+	 */
+	ResponseAcq getAcq(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Retrieves a set of records like `Channel<T>::get()` over a bulk
+	 * channel of the pool, sharing the request of an identical call in
+	 * flight.
+	 *
+	 * @see Channel<T>::get()
+	 */
+	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+
+	/** @brief Drops the cached `getAcq()` responses. */
+	void clear();
+
+	/** @brief Returns the amount of requests sent. */
+	std::uint64_t fetches() const;
+	/** @brief Returns the amount of calls which joined a request in flight. */
+	std::uint64_t joins() const;
+	/** @brief Returns the amount of `getAcq()` calls served from the cache. */
+	std::uint64_t hits() const;
+
+private:
+	/** @brief A key-interval, as an ordered tuple. */
+	using RangeId = std::tuple<Key::CidT,
+		Key::MidT,
+		Key::MoidT,
+		Key::CapT,
+		Key::AcqT,
+		Key::CidT,
+		Key::MidT,
+		Key::MoidT,
+		Key::CapT,
+		Key::AcqT>;
+	/** @brief A cached `getAcq()` response. */
+	struct CachedAcq
+	{
+		/** @brief The response. */
+		ResponseAcq response;
+		/** @brief The time the response stops being served at. */
+		std::chrono::steady_clock::time_point expiry;
+	};
+
+	/** @brief Returns the identifier of a key-interval. */
+	static RangeId rangeOf(const Key& keyMin, const Key& keyMax);
+	/** @brief Returns the response of the request in flight for `id` in
+	 * `flights` if there is one, otherwise sends it with `fetch()` and shares
+	 * its response with the calls arriving meanwhile. */
+	template<typename R, typename Fetch>
+	R coalesce(std::map<RangeId, std::shared_future<R>>& flights, const RangeId& id, Fetch fetch);
+	/** @brief Caches a successful `getAcq()` response. Called with the mutex
+	 * held. */
+	void cacheAcq(const RangeId& id, const ResponseAcq& response);
+
+	/** @brief The pool sending the requests. */
+	ChannelPool<T>& mPool;
+	/** @brief The options. */
+	CoalescingOptions mOptions;
+	/** @brief Guards the members below. */
+	mutable std::mutex mMutex;
+	/** @brief The `getAcq()` requests in flight. */
+	std::map<RangeId, std::shared_future<ResponseAcq>> mAcqFlights;
+	/** @brief The `get()` requests in flight. */
+	std::map<RangeId, std::shared_future<ResponseGet<T>>> mGetFlights;
+	/** @brief The cached `getAcq()` responses. */
+	std::map<RangeId, CachedAcq> mAcqCache;
+	/** @brief The amount of requests sent. */
+	std::uint64_t mFetches;
+	/** @brief The amount of calls which joined a request in flight. */
+	std::uint64_t mJoins;
+	/** @brief The amount of `getAcq()` calls served from the cache. */
+	std::uint64_t mHits;
+};
+
+} /*namespace tstorage*/
+
+#include "CoalescingPool.tpp"
+
+#endif
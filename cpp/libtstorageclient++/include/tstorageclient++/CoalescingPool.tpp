@@ -0,0 +1,189 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * CoalescingPool.tpp
+ *   An implementation of the `CoalescingPool<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_COALESCINGPOOL_TPP
+#define D_TSTORAGE_COALESCINGPOOL_TPP
+
+#ifndef D_TSTORAGE_COALESCINGPOOL_H
+#error __FILE__ was included from outside of "CoalescingPool.h"
+#include "CoalescingPool.h"  // clangd integration
+#endif
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Implements the `CoalescingPool<T>` class. */
+
+namespace tstorage {
+
+template<typename T>
+CoalescingPool<T>::CoalescingPool(ChannelPool<T>& pool, const CoalescingOptions& options)
+	: mPool(pool)
+	, mOptions(options)
+	, mFetches(0)
+	, mJoins(0)
+	, mHits(0)
+{
+}
+
+template<typename T>
+ResponseAcq CoalescingPool<T>::getAcq(const Key& keyMin, const Key& keyMax)
+{
+	const RangeId id = rangeOf(keyMin, keyMax);
+	if (mOptions.acqTtl.count() > 0) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		const auto found = mAcqCache.find(id);
+		if (found != mAcqCache.end()) {
+			if (std::chrono::steady_clock::now() < found->second.expiry) {
+				++mHits;
+				return found->second.response;
+			}
+			mAcqCache.erase(found);
+		}
+	}
+	return coalesce(mAcqFlights, id, [this, &id, &keyMin, &keyMax]() {
+		const ResponseAcq response = mPool.getAcq(keyMin, keyMax);
+		if (!response.error() && mOptions.acqTtl.count() > 0) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			cacheAcq(id, response);
+		}
+		return response;
+	});
+}
+
+template<typename T>
+ResponseGet<T> CoalescingPool<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	return coalesce(mGetFlights, rangeOf(keyMin, keyMax), [this, &keyMin, &keyMax]() {
+		return mPool.acquire()->get(keyMin, keyMax);
+	});
+}
+
+template<typename T>
+void CoalescingPool<T>::clear()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mAcqCache.clear();
+}
+
+template<typename T>
+std::uint64_t CoalescingPool<T>::fetches() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mFetches;
+}
+
+template<typename T>
+std::uint64_t CoalescingPool<T>::joins() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mJoins;
+}
+
+template<typename T>
+std::uint64_t CoalescingPool<T>::hits() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mHits;
+}
+
+template<typename T>
+typename CoalescingPool<T>::RangeId CoalescingPool<T>::rangeOf(
+	const Key& keyMin, const Key& keyMax)
+{
+	return RangeId(keyMin.cid,
+		keyMin.mid,
+		keyMin.moid,
+		keyMin.cap,
+		keyMin.acq,
+		keyMax.cid,
+		keyMax.mid,
+		keyMax.moid,
+		keyMax.cap,
+		keyMax.acq);
+}
+
+template<typename T>
+template<typename R, typename Fetch>
+R CoalescingPool<T>::coalesce(
+	std::map<RangeId, std::shared_future<R>>& flights, const RangeId& id, Fetch fetch)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	const auto found = flights.find(id);
+	if (found != flights.end()) {
+		std::shared_future<R> flight = found->second;
+		++mJoins;
+		lock.unlock();
+		return flight.get();
+	}
+	std::promise<R> promise;
+	flights.emplace(id, promise.get_future().share());
+	++mFetches;
+	lock.unlock();
+
+	// The flight is removed before its response is published, so that the
+	// calls arriving afterwards send a request of their own.
+	try {
+		R response = fetch();
+		lock.lock();
+		flights.erase(id);
+		lock.unlock();
+		promise.set_value(response);
+		return response;
+	} catch (...) {
+		lock.lock();
+		flights.erase(id);
+		lock.unlock();
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+}
+
+template<typename T>
+void CoalescingPool<T>::cacheAcq(const RangeId& id, const ResponseAcq& response)
+{
+	const auto now = std::chrono::steady_clock::now();
+	if (mAcqCache.size() >= mOptions.maxCachedAcqs) {
+		for (auto it = mAcqCache.begin(); it != mAcqCache.end();) {
+			it = now < it->second.expiry ? std::next(it) : mAcqCache.erase(it);
+		}
+		if (mAcqCache.size() >= mOptions.maxCachedAcqs) {
+			return;
+		}
+	}
+	mAcqCache.erase(id);
+	mAcqCache.emplace(id, CachedAcq{response, now + mOptions.acqTtl});
+}
+
+} /*namespace tstorage*/
+
+#endif
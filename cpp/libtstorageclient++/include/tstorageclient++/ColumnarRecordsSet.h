@@ -0,0 +1,165 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ColumnarRecordsSet.h
+ *   A definition of a column-oriented record container used with `Channel<T>`.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_COLUMNARRECORDSSET_H
+#define D_TSTORAGE_COLUMNARRECORDSSET_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines a column-oriented records container. */
+
+namespace tstorage {
+
+/**
+ * @brief A column-oriented container for inbound records.
+ *
+ * Stores the same data as `RecordsSet<T>`, but instead of keeping an array of
+ * `Record<T>` structures, it keeps each key field and the payloads in separate
+ * contiguous arrays (columns). The `i`-th record of the set consists of the
+ * `i`-th elements of all columns. This layout lets scans over a single field,
+ * e.g. CAP timestamps or payload values, touch only the memory of that
+ * field, which makes it a good fit for vectorized processing and for export
+ * to other column-oriented formats.
+ *
+ * A default-constructible, copyable and moveable container. It can be filled
+ * directly by `Channel<T>::getColumnar()` and `Channel<T>::getStreamColumnar()`.
+ *
+ * Note: as with any `std::vector`, the payload column is not a contiguous
+ * array of values for `T = bool`.
+ *
+ * @tparam T Payload type of stored records.
+ */
+template<typename T>
+class ColumnarRecordsSet final
+{
+public:
+	/**
+	 * @brief Appends a record to the end of the container. The payload is
+	 * constructed in-place using the forwarded arguments.
+	 *
+	 * @param key Key of the new record.
+	 * @param args Arguments to the constructor of the new record's payload.
+	 * @tparam U A template parameter pack with types of the arguments passed to
+	 * the constructor of the payload.
+	 */
+	template<typename... U>
+	void append(const Key& key, U&&... args)
+	{
+		mCids.push_back(key.cid);
+		mMids.push_back(key.mid);
+		mMoids.push_back(key.moid);
+		mCaps.push_back(key.cap);
+		mAcqs.push_back(key.acq);
+		mValues.emplace_back(std::forward<U>(args)...);
+	}
+
+	/**
+	 * @brief Appends a record to the end of the container, moving its payload.
+	 * @param record The record to append.
+	 */
+	void append(Record<T>&& record) { append(record.key, std::move(record.value)); }
+
+	/**
+	 * @brief Appends a copy of a record to the end of the container.
+	 * @param record The record to append.
+	 */
+	void append(const Record<T>& record) { append(record.key, record.value); }
+
+	/**
+	 * @brief Returns the number of records currently stored in the container.
+	 */
+	std::size_t size() const { return mValues.size(); }
+
+	/**
+	 * @brief Reserves space in all columns for at least `count` records.
+	 * @param count The number of records to make room for.
+	 */
+	void reserve(const std::size_t count)
+	{
+		mCids.reserve(count);
+		mMids.reserve(count);
+		mMoids.reserve(count);
+		mCaps.reserve(count);
+		mAcqs.reserve(count);
+		mValues.reserve(count);
+	}
+
+	/**
+	 * @brief Removes all records from the container. The allocated memory is
+	 * retained for reuse.
+	 */
+	void clear()
+	{
+		mCids.clear();
+		mMids.clear();
+		mMoids.clear();
+		mCaps.clear();
+		mAcqs.clear();
+		mValues.clear();
+	}
+
+	/**
+	 * @brief Reassembles the key of the `i`-th record.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	Key key(const std::size_t i) const
+	{
+		return Key(mCids[i], mMids[i], mMoids[i], mCaps[i], mAcqs[i]);
+	}
+
+	/** @brief Returns the column of CIDs. */
+	const std::vector<Key::CidT>& cids() const { return mCids; }
+	/** @brief Returns the column of MIDs. */
+	const std::vector<Key::MidT>& mids() const { return mMids; }
+	/** @brief Returns the column of MOIDs. */
+	const std::vector<Key::MoidT>& moids() const { return mMoids; }
+	/** @brief Returns the column of CAP timestamps. */
+	const std::vector<Key::CapT>& caps() const { return mCaps; }
+	/** @brief Returns the column of ACQ timestamps. */
+	const std::vector<Key::AcqT>& acqs() const { return mAcqs; }
+	/** @brief Returns the column of payloads. */
+	const std::vector<T>& values() const { return mValues; }
+	/** @brief Returns the mutable column of payloads. */
+	std::vector<T>& values() { return mValues; }
+
+private:
+	/** @brief The column of CIDs. */
+	std::vector<Key::CidT> mCids;
+	/** @brief The column of MIDs. */
+	std::vector<Key::MidT> mMids;
+	/** @brief The column of MOIDs. */
+	std::vector<Key::MoidT> mMoids;
+	/** @brief The column of CAP timestamps. */
+	std::vector<Key::CapT> mCaps;
+	/** @brief The column of ACQ timestamps. */
+	std::vector<Key::AcqT> mAcqs;
+	/** @brief The column of payloads. */
+	std::vector<T> mValues;
+};
+
+} /*namespace tstorage*/
+
+#endif
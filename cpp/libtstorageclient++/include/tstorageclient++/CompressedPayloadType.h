@@ -0,0 +1,188 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * CompressedPayloadType.h
+ *   A payload type adapter compressing the payloads of another one.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_COMPRESSEDPAYLOADTYPE_H
+#define D_TSTORAGE_COMPRESSEDPAYLOADTYPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "PayloadCodec.h"
+#include "PayloadType.h"
+
+/** @file
+ * @brief Defines the `CompressedPayloadType<T>` adapter. */
+
+namespace tstorage {
+
+/**
+ * @brief A payload type compressing the payloads serialized by another one.
+ *
+ * Wraps a `PayloadType<T>` and a `PayloadCodec`: each payload is serialized
+ * by the wrapped type, compressed by the codec and stored in a frame of its
+ * own, which makes PUT and GET traffic, and the stored data, smaller by the
+ * compression ratio. A frame is a method byte, `1` for compressed and `0` for
+ * stored as is, followed for `1` by the size of the serialized payload as a
+ * LEB128 varint, and by the payload or its compressed block. Payloads the
+ * codec cannot shrink are stored as is, at the cost of a single byte.
+ *
+ * All clients reading the payloads need the same adapter configuration, with
+ * the same codec dictionary if any. The adapter keeps scratch buffers and, as
+ * any payload type, is used by a single channel at a time.
+ *
+ * @tparam T Payload data type.
+ */
+template<typename T>
+class CompressedPayloadType final : public PayloadType<T>
+{
+public:
+	/** @brief The largest serialized payload accepted by `fromBytes()`. */
+	static constexpr std::size_t cMaxPayloadSize = std::size_t(1) << 31;
+
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param payloadType The payload type serializing the values.
+	 * @param codec The codec compressing the serialized values.
+	 */
+	CompressedPayloadType(
+		std::unique_ptr<PayloadType<T>> payloadType, std::unique_ptr<PayloadCodec> codec)
+		: mPayloadType(std::move(payloadType))
+		, mCodec(std::move(codec))
+	{
+	}
+
+	/**
+	 * @brief Serializes and compresses `val`.
+	 *
+	 * A value which does not fit in the buffer is compressed again on the
+	 * retry: nothing is kept between the calls, since the channel may not
+	 * retry, and another value may take the address of this one.
+	 */
+	std::size_t toBytes(const T& val, void* outputBuffer, std::size_t bufferSize) override
+	{
+		frame(val);
+		if (mFrame.size() > bufferSize) {
+			return mFrame.size();
+		}
+		std::memcpy(outputBuffer, mFrame.data(), mFrame.size());
+		return mFrame.size();
+	}
+
+	/** @brief Decompresses and deserializes a frame made by `toBytes()`. */
+	bool fromBytes(T& oVar, const void* payloadBuffer, std::size_t payloadSize) override
+	{
+		const unsigned char* in = static_cast<const unsigned char*>(payloadBuffer);
+		const unsigned char* const inEnd = in + payloadSize;
+		if (in == inEnd) {
+			return false;
+		}
+		const unsigned char method = *in++;
+		if (method == cStored) {
+			return mPayloadType->fromBytes(oVar, in, static_cast<std::size_t>(inEnd - in));
+		}
+		if (method != cCompressed) {
+			return false;
+		}
+		std::size_t size = 0;
+		for (int shift = 0;; shift += 7) {
+			if (in == inEnd || shift > 28) {
+				return false;
+			}
+			const unsigned char byte = *in++;
+			size |= static_cast<std::size_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) {
+				break;
+			}
+		}
+		// The size is untrusted: a short frame must not make the scratch
+		// buffer grow beyond what its block can decompress to.
+		const std::size_t blockSize = static_cast<std::size_t>(inEnd - in);
+		if (size > cMaxPayloadSize || size > mCodec->maxDecompressedSize(blockSize)) {
+			return false;
+		}
+		mScratch.resize(size);
+		if (!mCodec->decompress(in, blockSize, mScratch.data(), size)) {
+			return false;
+		}
+		return mPayloadType->fromBytes(oVar, mScratch.data(), size);
+	}
+
+private:
+	/** @brief The method byte of an uncompressed frame. */
+	static constexpr unsigned char cStored = 0;
+	/** @brief The method byte of a compressed frame. */
+	static constexpr unsigned char cCompressed = 1;
+
+	/** @brief Makes the frame of `val` in `mFrame`. */
+	void frame(const T& val)
+	{
+		std::size_t size = mPayloadType->toBytes(val, mScratch.data(), mScratch.size());
+		if (size > mScratch.size()) {
+			mScratch.resize(size);
+			size = mPayloadType->toBytes(val, mScratch.data(), mScratch.size());
+		}
+
+		unsigned char header[1 + 5];
+		std::size_t headerSize = 0;
+		header[headerSize++] = cCompressed;
+		for (std::size_t rest = size;; rest >>= 7) {
+			const unsigned char more = rest > 0x7f ? 0x80 : 0;
+			header[headerSize++] = static_cast<unsigned char>((rest & 0x7f) | more);
+			if (more == 0) {
+				break;
+			}
+		}
+		// Only a frame smaller than the stored one is worth compressing.
+		const std::size_t storedSize = 1 + size;
+		const std::size_t blockCapacity
+			= storedSize > headerSize + 1 ? storedSize - headerSize - 1 : 0;
+		mFrame.resize(storedSize);
+		const std::size_t blockSize = blockCapacity == 0
+			? 0
+			: mCodec->compress(
+				mScratch.data(), size, mFrame.data() + headerSize, blockCapacity);
+		if (blockSize != 0) {
+			std::memcpy(mFrame.data(), header, headerSize);
+			mFrame.resize(headerSize + blockSize);
+			return;
+		}
+		mFrame[0] = cStored;
+		std::memcpy(mFrame.data() + 1, mScratch.data(), size);
+	}
+
+	/** @brief The payload type serializing the values. */
+	std::unique_ptr<PayloadType<T>> mPayloadType;
+	/** @brief The codec compressing the serialized values. */
+	std::unique_ptr<PayloadCodec> mCodec;
+	/** @brief The serialized value. */
+	std::vector<unsigned char> mScratch;
+	/** @brief The frame of the last value. */
+	std::vector<unsigned char> mFrame;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,195 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * CountingAllocator.h
+ *   A standard allocator counting the allocations of the containers using it.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_COUNTINGALLOCATOR_H
+#define D_TSTORAGE_COUNTINGALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include "DataTypes.h"
+#include "RecordsSet.h"
+
+/** @file
+ * @brief Defines `AllocationCounter` and the `CountingAllocator<U>` reporting
+ * to it. */
+
+namespace tstorage {
+
+/**
+ * @brief Counts the allocations made through `CountingAllocator`s.
+ *
+ * Meant for verifying that the steady state of a workload does not allocate,
+ * e.g. that the `RecordsSet<T>` receiving a GET response is reused rather
+ * than regrown. The buffers of a channel are counted by the channel itself,
+ * see `ChannelStats`. The counters are atomic, so the allocators of one
+ * counter may be used from several threads.
+ */
+class AllocationCounter final
+{
+public:
+	/** @brief Constructs zero counters. */
+	AllocationCounter()
+		: mAllocations(0)
+		, mDeallocations(0)
+		, mBytesAllocated(0)
+	{
+	}
+
+	AllocationCounter(const AllocationCounter&) = delete;
+	AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+	/** @brief Counts an allocation of `bytes` bytes. */
+	void allocated(const std::size_t bytes)
+	{
+		mAllocations.fetch_add(1, std::memory_order_relaxed);
+		mBytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+	}
+	/** @brief Counts a deallocation. */
+	void deallocated() { mDeallocations.fetch_add(1, std::memory_order_relaxed); }
+
+	/** @brief Returns the number of allocations. */
+	std::uint64_t allocations() const { return mAllocations.load(std::memory_order_relaxed); }
+	/** @brief Returns the number of deallocations. */
+	std::uint64_t deallocations() const
+	{
+		return mDeallocations.load(std::memory_order_relaxed);
+	}
+	/** @brief Returns the total amount of bytes allocated. */
+	std::uint64_t bytesAllocated() const
+	{
+		return mBytesAllocated.load(std::memory_order_relaxed);
+	}
+
+private:
+	/** @brief The number of allocations. */
+	std::atomic<std::uint64_t> mAllocations;
+	/** @brief The number of deallocations. */
+	std::atomic<std::uint64_t> mDeallocations;
+	/** @brief The total amount of bytes allocated. */
+	std::atomic<std::uint64_t> mBytesAllocated;
+};
+
+/**
+ * @brief A standard allocator drawing memory from the global heap and
+ * counting its allocations in a shared `AllocationCounter`.
+ *
+ * Every copy of the allocator, including those kept by the containers using
+ * it, shares the counter. For instance, the batches of
+ * `Channel<T>::getStream(keyMin, keyMax, alloc, callback)` with a
+ * `CountingAllocator` count the allocations of all batches in the counter of
+ * `alloc`. A default-constructed allocator counts nothing.
+ *
+ * @tparam U The type of allocated objects.
+ */
+template<typename U>
+class CountingAllocator
+{
+public:
+	/** @brief The type of allocated objects. */
+	using value_type = U;
+	/** @brief Copy-assigned containers adopt the source's counter. */
+	using propagate_on_container_copy_assignment = std::true_type;
+	/** @brief Move-assigned containers adopt the source's counter. */
+	using propagate_on_container_move_assignment = std::true_type;
+	/** @brief Swapped containers exchange their counters. */
+	using propagate_on_container_swap = std::true_type;
+
+	/** @brief A constructor counting nothing. */
+	CountingAllocator() noexcept = default;
+	/** @brief A constructor counting in `counter`, or nothing if empty. */
+	explicit CountingAllocator(std::shared_ptr<AllocationCounter> counter) noexcept
+		: mCounter(std::move(counter))
+	{
+	}
+	/** @brief A converting constructor sharing the counter of `other`. */
+	template<typename V>
+	CountingAllocator(const CountingAllocator<V>& other) noexcept
+		: mCounter(other.counter())
+	{
+	}
+
+	/** @brief Allocates memory for `count` objects. */
+	U* allocate(const std::size_t count)
+	{
+		U* const pointer = static_cast<U*>(::operator new(count * sizeof(U)));
+		if (mCounter) {
+			mCounter->allocated(count * sizeof(U));
+		}
+		return pointer;
+	}
+	/** @brief Deallocates the memory of `allocate()`. */
+	void deallocate(U* const pointer, std::size_t /*count*/) noexcept
+	{
+		if (mCounter) {
+			mCounter->deallocated();
+		}
+		::operator delete(pointer);
+	}
+
+	/** @brief Returns the counter, empty if none. */
+	const std::shared_ptr<AllocationCounter>& counter() const noexcept { return mCounter; }
+
+private:
+	/** @brief The counter of the allocations. */
+	std::shared_ptr<AllocationCounter> mCounter;
+};
+
+/** @brief Allocators are equal as they draw memory from the same heap. */
+template<typename U, typename V>
+bool operator==(const CountingAllocator<U>& /*lhs*/, const CountingAllocator<V>& /*rhs*/) noexcept
+{
+	return true;
+}
+
+/** @brief Allocators are equal as they draw memory from the same heap. */
+template<typename U, typename V>
+bool operator!=(const CountingAllocator<U>& lhs, const CountingAllocator<V>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+/** @brief A `RecordsSet<T>` counting its allocations. */
+template<typename T>
+using CountingRecordsSet = RecordsSet<T, CountingAllocator<Record<T>>>;
+
+/** @brief A string payload counting its allocations. */
+using CountingString = std::basic_string<char, std::char_traits<char>, CountingAllocator<char>>;
+
+/**
+ * @brief Returns an allocator counting in a new counter.
+ *
+ * @tparam U The type of allocated objects.
+ */
+template<typename U>
+CountingAllocator<U> makeCountingAllocator()
+{
+	return CountingAllocator<U>(std::make_shared<AllocationCounter>());
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -22,9 +22,14 @@
 #ifndef D_TSTORAGE_DATATYPES_H
 #define D_TSTORAGE_DATATYPES_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <map>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <tstorageclient++/Timestamp.h>
 
@@ -87,6 +92,19 @@ enum class result_t : std::int32_t {
 	SOCKET_ERROR = -525,
 	/** @brief Failed to set socket options. */
 	SETOPT_ERROR = -526,
+	/** @brief Failed to write or map the temporary file of a
+	 * `SpilledRecordsSet`. */
+	SPILL_ERROR = -527,
+	/** @brief Failed to create, write or map a segment of a `SpoolLog`, or a
+	 * segment is corrupt. */
+	SPOOL_ERROR = -528,
+	/** @brief The TLS handshake failed, the certificate of the server was
+	 * rejected, or TLS was requested from a library built without it. */
+	TLS_ERROR = -529,
+	/** @brief Failed to read the file of a PUT/A request sent from a file, or
+	 * the file ended before the given length, or failed to save or load a
+	 * `PutDedupFilter`. */
+	FILE_ERROR = -530,
 
 	/** @brief Internal status code, signals the end of the GET response. */
 	END_OF_STREAM = 512,
@@ -99,6 +117,8 @@ enum class result_t : std::int32_t {
 	CONNTIMEOUT = 522,
 	/** @brief Operation interrupted by a UNIX signal/system interrupt. */
 	SIGNAL = 523,
+	/** @brief Stream stopped early by the user, connection closed. */
+	CANCELLED = 524,
 };
 
 /** @brief A maximal error code of client fatal errors. */
@@ -161,8 +181,11 @@ struct Key
 	 * @brief A constructor.
 	 *
 	 * Requires passing at least CID, MID and MOID. The default CAP is the
-	 * current time (TStorage internal format). The default ACQ is `Key::cAcqMax`
-	 * to guard against sending incorrectly initialized data using PUTA command.
+	 * current time (TStorage internal format), read from the system clock on
+	 * each construction; pass `Timestamp::coarseNow()`, or a timestamp read
+	 * once per batch, to build many keys cheaply. The default ACQ is
+	 * `Key::cAcqMax` to guard against sending incorrectly initialized data
+	 * using PUTA command.
 	 *
 	 * @param pCid Initial client ID value.
 	 * @param pMid Initial measurement device ID value.
@@ -195,6 +218,23 @@ struct Key
 	 * @return `true` if the key is a valid key, `false` otherwise.
 	 */
 	bool isValid() const { return cid >= 0; }
+	/**
+	 * @brief Checks if a record with the key can be stored or received.
+	 *
+	 * Equivalent to `isValid() && *this <= cKeyMax - 1`, but inlined and
+	 * free of branches, so that loops checking many keys vectorize.
+	 *
+	 * @param withAcq `false` to leave the ACQ unchecked, as with PUT, where
+	 * the server stamps the records with its own ACQ.
+	 * @return `true` if no field of the key attains its maximal value and the
+	 * CID is non-negative, `false` otherwise.
+	 */
+	bool isStorable(const bool withAcq = true) const
+	{
+		// Bitwise on purpose: all the fields are compared, without branching.
+		return (cid >= 0) & (cid != cCidMax) & (mid != cMidMax) & (moid != cMoidMax)
+			& (cap != cCapMax) & (!withAcq | (acq != cAcqMax));
+	}
 
 	/** @brief An invalid CID value. */
 	static constexpr CidT cCidInvalid = std::numeric_limits<CidT>::min();
@@ -301,6 +341,516 @@ static const Key cKeyMin =
 static const Key cKeyMax =
 	Key(Key::cCidMax, Key::cMidMax, Key::cMoidMax, Key::cCapMax, Key::cAcqMax);
 
+/**
+ * @brief A key-interval `[keyMin, keyMax)`, the target of a GET or GETACQ
+ * query.
+ */
+struct KeyRange
+{
+	/** @brief The lower vertex of the key-interval. */
+	Key keyMin;
+	/** @brief The upper vertex of the key-interval. */
+	Key keyMax;
+};
+
+/**
+ * @brief Merges key-intervals into fewer key-intervals covering exactly their
+ * union.
+ *
+ * Two key-intervals are merged if one contains the other, or if they span the
+ * same values in all fields but one, in which they overlap or touch, e.g.
+ * adjacent CAP windows of the same CID, MID and MOID. Merged key-intervals are
+ * merged further until no pair is left to merge. Key-intervals which are
+ * invalid or empty are passed on as they are. The merge is quadratic in the
+ * amount of key-intervals.
+ *
+ * @see `Channel::getCoalesced()`
+ *
+ * @param ranges The key-intervals to merge.
+ * @param oCovering Set to the index of the merged key-interval covering each
+ * of `ranges`, in the order of `ranges`.
+ * @return The merged key-intervals, ordered by the first of `ranges` each
+ * covers.
+ */
+std::vector<KeyRange> coalesceKeyRanges(
+	const std::vector<KeyRange>& ranges, std::vector<std::size_t>& oCovering);
+
+/**
+ * @brief A record with an already serialized payload.
+ *
+ * The payload is not owned by the record and must stay valid while the
+ * record is being stored.
+ *
+ * @see `Channel::putRaw()`
+ */
+struct RawRecord
+{
+	/** @brief Key of the record. */
+	Key key;
+	/** @brief The serialized payload. */
+	const void* payload;
+	/** @brief The size of the payload in bytes. */
+	std::size_t size;
+};
+
+/**
+ * @brief The address of a TStorage server.
+ *
+ * @see `ClusterChannel<T>`
+ */
+struct Endpoint
+{
+	/** @brief Hostname of the server. */
+	std::string hostname;
+	/** @brief Port under which the server accepts connections. */
+	std::uint16_t port;
+};
+
+/**
+ * @brief Counters of the receive syscalls made by a channel.
+ *
+ * Used to tune the receive strategy of a channel against the latency of its
+ * requests.
+ *
+ * @see `Channel::receiveStats()`
+ */
+struct ReceiveStats
+{
+	/** @brief The number of receive syscalls. */
+	std::uint64_t recvCalls;
+	/** @brief The number of socket option changes made to steer the receive
+	 * syscalls, e.g. of the receive low watermark. */
+	std::uint64_t sockOptCalls;
+	/** @brief The total amount of bytes received. */
+	std::uint64_t bytesReceived;
+};
+
+/**
+ * @brief A histogram of request latencies with a bounded relative error.
+ *
+ * The latencies are counted in microseconds, in the manner of HDR histograms:
+ * the values below `cSubBuckets` have a bucket each, while each larger power
+ * of two is split into `cSubBuckets` buckets of equal width, hence a bucket is
+ * never wider than 1/8 of its lower bound. Latencies beyond the last bucket,
+ * about 4.7 hours, are counted in it.
+ *
+ * @see `ChannelStats`
+ */
+struct LatencyHistogram
+{
+	/** @brief The amount of buckets per power of two. */
+	static constexpr std::size_t cSubBuckets = 8;
+	/** @brief The amount of buckets. */
+	static constexpr std::size_t cBuckets = 256;
+
+	/** @brief The amount of latencies counted in each bucket. */
+	std::array<std::uint64_t, cBuckets> counts;
+	/** @brief The amount of latencies counted. */
+	std::uint64_t count;
+	/** @brief The sum of the latencies counted, in microseconds. */
+	std::uint64_t totalUs;
+	/** @brief The largest latency counted, in microseconds. */
+	std::uint64_t maxUs;
+
+	/** @brief Returns the bucket counting `latencyUs`. */
+	static std::size_t bucketOf(std::uint64_t latencyUs);
+	/** @brief Returns the smallest latency counted by `bucket`, in
+	 * microseconds. */
+	static std::uint64_t bucketLowerBoundUs(std::size_t bucket);
+	/**
+	 * @brief Returns an upper bound of the latency below which lie the
+	 * `quantile` of the counted latencies, e.g. `0.99` for the 99th
+	 * percentile.
+	 *
+	 * @param quantile The quantile, between `0` and `1`.
+	 * @return The upper bound of the bucket holding the quantile, at most
+	 * `maxUs`, in microseconds; `0` if no latency is counted.
+	 */
+	std::uint64_t percentileUs(double quantile) const;
+	/** @brief Returns the mean latency in microseconds, `0` if none is
+	 * counted. */
+	double meanUs() const { return count == 0 ? 0.0 : static_cast<double>(totalUs) / count; }
+};
+
+/**
+ * @brief The syscalls and buffer allocations made for a kind of requests.
+ *
+ * @see `ChannelStats`
+ */
+struct CommandCosts
+{
+	/** @brief The number of send syscalls. */
+	std::uint64_t sendCalls;
+	/** @brief The number of receive syscalls. */
+	std::uint64_t recvCalls;
+	/** @brief The number of buffers allocated. */
+	std::uint64_t bufferAllocations;
+	/** @brief The total size of the buffers allocated. */
+	std::uint64_t bufferBytesAllocated;
+};
+
+/**
+ * @brief Counters of the work done by a channel since its construction.
+ *
+ * Tells apart the time spent on the network, in the serialization of the
+ * records and in the server: the traffic counters show how the data is split
+ * into syscalls, the PUT/A counters how the records are packed into batches
+ * and buffers, and the latency histograms how long each kind of request takes
+ * from sending its header to reading its result.
+ *
+ * The buffer counters show whether the steady state of a workload allocates:
+ * once the buffers are sized and pooled, the requests should reuse them. The
+ * costs of a command split the syscalls and allocations by the kind of
+ * requests they were made for. Each request is charged with what the channel
+ * did since the previous one completed, so pipelined requests are charged to
+ * the one completing first, and the work of requests aborted by errors of the
+ * connection is dropped at the next connect.
+ *
+ * Only the requests whose result was read are timed; those aborted by errors
+ * of the connection are not.
+ *
+ * @see `Channel::stats()`
+ */
+struct ChannelStats
+{
+	/** @brief The total amount of bytes sent. */
+	std::uint64_t bytesSent;
+	/** @brief The number of send syscalls. */
+	std::uint64_t sendCalls;
+	/** @brief The total amount of bytes received. */
+	std::uint64_t bytesReceived;
+	/** @brief The number of receive syscalls. */
+	std::uint64_t recvCalls;
+	/** @brief The number of PUT/A batches started, i.e. of the CID changes of
+	 * the records put, before any merging of the batches. */
+	std::uint64_t putBatches;
+	/** @brief The number of times the internal buffer filled up and was sent
+	 * in the middle of a PUT/A request. */
+	std::uint64_t putBufferFlushes;
+	/** @brief The amount of unread bytes moved to the start of the internal
+	 * buffer to make room for incoming data. */
+	std::uint64_t bufferBytesMoved;
+	/** @brief The bandwidth-delay product of the connection estimated by
+	 * the buffer auto-tuning, `0` if none is estimated. */
+	std::uint64_t bdpBytes;
+	/** @brief The rate PUT/A buffers are paced at by the flow control in
+	 * bytes per second, `0` if unpaced. */
+	std::uint64_t putPacingRate;
+	/** @brief The amount of send buffers a PUT/A command may take under the
+	 * flow control, `0` if unbounded. */
+	std::uint64_t putCommandBuffers;
+	/** @brief The number of times the flow control backed off. */
+	std::uint64_t putBackoffs;
+	/** @brief The number of PUTA records skipped as acknowledged already by
+	 * the duplicate filter. */
+	std::uint64_t putRecordsSkipped;
+	/** @brief The number of buffers allocated, i.e. obtained from neither
+	 * the channel's parking nor the pool, resized, or allocated for the PUT/A
+	 * pipeline and the coalescing of batches. */
+	std::uint64_t bufferAllocations;
+	/** @brief The total size of the buffers allocated. */
+	std::uint64_t bufferBytesAllocated;
+	/** @brief The latencies of GET requests. */
+	LatencyHistogram get;
+	/** @brief The latencies of GETACQ requests. */
+	LatencyHistogram getAcq;
+	/** @brief The latencies of PUT requests. */
+	LatencyHistogram put;
+	/** @brief The latencies of PUTA requests. */
+	LatencyHistogram putA;
+	/** @brief The costs of GET requests. */
+	CommandCosts getCosts;
+	/** @brief The costs of GETACQ requests. */
+	CommandCosts getAcqCosts;
+	/** @brief The costs of PUT requests. */
+	CommandCosts putCosts;
+	/** @brief The costs of PUTA requests. */
+	CommandCosts putACosts;
+};
+
+/**
+ * @brief The amount of records in a key-interval and of bytes they take.
+ *
+ * The bytes are those of the records as serialized in a GET response, i.e.
+ * of the keys and the raw payloads, without the framing.
+ *
+ * @see `Channel::sizeRange()`
+ */
+struct RangeSize
+{
+	/** @brief The amount of records. */
+	std::uint64_t records = 0;
+	/** @brief The total size of the keys and payloads of the records. */
+	std::uint64_t bytes = 0;
+};
+
+/**
+ * @brief The sizes of a key-interval, in total and per CID.
+ *
+ * @see `Channel::sizeRange()`
+ */
+struct RangeSizes
+{
+	/** @brief The size of the whole key-interval. */
+	RangeSize total;
+	/** @brief The sizes of the records of each CID present, by CID. */
+	std::map<Key::CidT, RangeSize> cids;
+};
+
+/**
+ * @brief The outcome of one of the concurrent requests of a parallel PUT/A.
+ *
+ * @see `ChannelPool::putParallel()`
+ */
+struct PutPartition
+{
+	/** @brief The CIDs of the records sent by the request, in ascending
+	 * order. */
+	std::vector<Key::CidT> cids;
+	/** @brief The amount of records sent by the request. */
+	std::size_t records = 0;
+	/** @brief The status code of the request. */
+	result_t status = result_t::OK;
+};
+
+/**
+ * @brief The read latencies and the health of a replica.
+ *
+ * The latency of a GET or GETACQ request is the time from sending its header
+ * to the arrival of the first bytes of the response, so that it doesn't
+ * depend on the amount of records returned.
+ *
+ * @see `ReplicaChannel::stats()`
+ */
+struct ReplicaStats
+{
+	/** @brief The exponentially weighted moving average of the latencies in
+	 * microseconds, `0` if none is measured yet. */
+	double ewmaUs;
+	/** @brief The 95th percentile of the recent latencies in microseconds. */
+	std::uint64_t p95Us;
+	/** @brief The amount of latencies measured. */
+	std::uint64_t samples;
+	/** @brief `false` while the replica is avoided after a failure. */
+	bool healthy;
+};
+
+/**
+ * @brief Options of the TCP sockets of a channel.
+ *
+ * The defaults suit latency-sensitive request/response traffic: Nagle's
+ * algorithm is disabled, while the remaining options are left to the system.
+ * Over a Unix domain socket only the buffer sizes and the priority apply.
+ *
+ * @see `Channel::setSocketOptions()`
+ */
+struct SocketOptions
+{
+	/** @brief Disables Nagle's algorithm (`TCP_NODELAY`), so that small
+	 * requests are sent right away. */
+	bool noDelay = true;
+	/** @brief The kernel send buffer size in bytes (`SO_SNDBUF`), `0` for the
+	 * system default. Setting it disables the kernel's buffer autotuning. */
+	std::uint32_t sendBufferBytes = 0;
+	/** @brief The kernel receive buffer size in bytes (`SO_RCVBUF`), `0` for
+	 * the system default. Large buffers let large responses use the whole
+	 * bandwidth of links with high latency. Setting it disables the kernel's
+	 * buffer autotuning. */
+	std::uint32_t recvBufferBytes = 0;
+	/** @brief Acknowledges received data immediately (`TCP_QUICKACK`),
+	 * instead of the delayed ACKs. Since the system drops this mode on its
+	 * own, it is restored after each receive, at the cost of a syscall. */
+	bool quickAck = false;
+	/** @brief Enables TCP keepalive probes on idle connections
+	 * (`SO_KEEPALIVE`). */
+	bool keepAlive = false;
+	/** @brief The idle time before the first keepalive probe in seconds
+	 * (`TCP_KEEPIDLE`), `0` for the system default. */
+	std::uint32_t keepAliveIdleS = 0;
+	/** @brief The time between keepalive probes in seconds
+	 * (`TCP_KEEPINTVL`), `0` for the system default. */
+	std::uint32_t keepAliveIntervalS = 0;
+	/** @brief The amount of unanswered keepalive probes after which the
+	 * connection is dropped (`TCP_KEEPCNT`), `0` for the system default. */
+	std::uint32_t keepAliveCount = 0;
+	/** @brief The priority of the sent packets (`SO_PRIORITY`), `-1` for the
+	 * system default. */
+	std::int32_t priority = -1;
+	/** @brief The DSCP of the sent packets, `0` to `63` (`IP_TOS`, or
+	 * `IPV6_TCLASS`), `-1` for the system default. */
+	std::int32_t dscp = -1;
+};
+
+/**
+ * @brief The bounds of the buffer sizes a channel derives from the measured
+ * bandwidth-delay product of its connection.
+ *
+ * @see `Channel::setBufferAutoTuning()`
+ */
+struct BufferAutoTuning
+{
+	/** @brief Enables the tuning. */
+	bool enabled = false;
+	/** @brief The largest size of the send and receive buffers in bytes. The
+	 * memory limits of the channel are the smallest. */
+	std::size_t maxBytes = 32L * 1024 * 1024;  // 32 MiB
+	/** @brief Also sizes the kernel buffers (`SO_SNDBUF` and `SO_RCVBUF`) of
+	 * the connection, overriding those of `SocketOptions` and the kernel's
+	 * own autotuning. */
+	bool socketBuffers = false;
+};
+
+/**
+ * @brief The settings of the flow control of PUT/A requests.
+ *
+ * @see `Channel::setPutFlowControl()`
+ */
+struct PutFlowControl
+{
+	/** @brief Enables the flow control. */
+	bool enabled = false;
+	/** @brief The time a flush of the send buffer may block for before the
+	 * channel backs off, in milliseconds, `0` for an eighth of the timeout. */
+	std::uint32_t sendBlockMs = 0;
+	/** @brief The time the result of a command may take before the channel
+	 * backs off, in milliseconds, `0` for a quarter of the timeout. */
+	std::uint32_t ackLatencyMs = 0;
+	/** @brief The smallest pacing rate in bytes per second, also the rate it
+	 * grows by every 100 ms without congestion. */
+	std::uint64_t minRateBytes = 256L * 1024;  // 256 KiB/s
+};
+
+/**
+ * @brief The placement of the memory of the send and receive buffers of a
+ * channel.
+ *
+ * By default, a buffer is aligned to the cache line, or to the page if it
+ * spans one, and its pages are placed by the system, i.e. on the NUMA node
+ * of the thread that first writes to them. A buffer of a few dozen MiB then
+ * takes thousands of TLB entries, and, once it has gone through the buffer
+ * pool (see `Channel::setBufferRelease()`), may be used from another node.
+ *
+ * Huge pages back buffers of at least 2 MiB only; smaller ones would waste
+ * most of a page. NUMA binding makes the node the preferred one, so that the
+ * system falls back to other nodes once it runs out of memory.
+ *
+ * @see `Channel::setBufferAllocation()`
+ */
+struct BufferAllocation
+{
+	/** @brief The pages a buffer is backed with. */
+	enum class HugePages
+	{
+		NONE,  ///< Regular pages.
+		TRANSPARENT,  ///< Transparent huge pages, asked for with `madvise()`.
+		RESERVED  ///< Huge pages reserved with the `vm.nr_hugepages` sysctl
+				  ///< (`MAP_HUGETLB`), or transparent ones if none are left.
+	};
+
+	/** @brief The `numaNode` leaving the placement to the system. */
+	static constexpr std::int32_t cNoNode = -1;
+	/** @brief The `numaNode` standing for the node of the thread allocating
+	 * the buffer, which is the first one to send a request after the buffer
+	 * is released. */
+	static constexpr std::int32_t cThreadNode = -2;
+
+	/** @brief The pages the buffers of at least 2 MiB are backed with. */
+	HugePages hugePages = HugePages::NONE;
+	/** @brief The NUMA node the buffers are placed on, `cNoNode` or
+	 * `cThreadNode`. */
+	std::int32_t numaNode = cNoNode;
+};
+
+/**
+ * @brief Options of the TLS sessions of a channel.
+ *
+ * TLS is available only if the library is built with it (`make TLS=1`),
+ * otherwise connecting with `enabled` set fails with `result_t::TLS_ERROR`.
+ * The paths are of PEM files; empty ones are not loaded.
+ *
+ * @see `Channel::setTlsOptions()`
+ */
+struct TlsOptions
+{
+	/** @brief Encrypts the connections established from now on. */
+	bool enabled = false;
+	/** @brief The CA certificates to verify the server against. If empty, the
+	 * system's default trust store is used. */
+	std::string caFile;
+	/** @brief The certificate chain of the client, for servers requiring
+	 * client authentication. */
+	std::string certFile;
+	/** @brief The private key of `certFile`. */
+	std::string keyFile;
+	/** @brief The name the certificate of the server is verified against and
+	 * sent in the SNI extension. If empty, the hostname of the channel is
+	 * used; an IP address is verified against the addresses of the
+	 * certificate instead, and for a Unix domain socket nothing is checked
+	 * beyond the certificate chain. */
+	std::string serverName;
+	/** @brief Verifies the certificate of the server. Disable only for
+	 * testing. */
+	bool verifyPeer = true;
+	/** @brief Hands the record layer over to the kernel (kTLS) once the
+	 * handshake is done, where the kernel and the cipher suite support it.
+	 * Sends then take the plain, vectored or io_uring path of unencrypted
+	 * connections, with no copy into a userspace TLS buffer. */
+	bool kernelOffload = true;
+};
+
+/**
+ * @brief A policy of retrying the requests that fail due to a broken
+ * connection.
+ *
+ * A failed attempt is followed by a reconnect after a backoff, which starts
+ * at `initialBackoffMs` and doubles after each further failure, up to
+ * `maxBackoffMs`. Every backoff is shortened by a random amount of up to a
+ * half, so that clients disconnected at once don't reconnect in lockstep.
+ *
+ * @see `Channel::setRetryPolicy()`
+ */
+struct RetryPolicy
+{
+	/** @brief The maximal amount of attempts of a request, including the
+	 * first one and the failed reconnects. `1` disables retries. */
+	std::uint32_t maxAttempts;
+	/** @brief The backoff before the first retry in milliseconds. */
+	std::uint32_t initialBackoffMs;
+	/** @brief The maximal backoff in milliseconds. */
+	std::uint32_t maxBackoffMs;
+	/** @brief Whether PUT/A requests are retried as well. A PUT/A request is
+	 * not idempotent: the records of a request that failed while waiting for
+	 * the result may have been stored, and are then stored twice. */
+	bool retryPuts;
+};
+
+/**
+ * @brief A policy of cutting the responses of `getStream()` into batches.
+ *
+ * By default, a batch is passed to the callback once the receive buffer is
+ * full (see `Channel::setMemoryLimit()`) or the response ends, which suits
+ * bulk consumers. A record trickling in may then wait long before the
+ * callback sees it; `maxRecords` and `maxDelayMs` deliver the batches
+ * earlier, and `minRecords` keeps the delay from making them too small.
+ *
+ * @see `Channel::setStreamBatching()`
+ */
+struct StreamBatching
+{
+	/** @brief The maximal amount of records of a batch, `0` for no limit
+	 * other than the receive buffer. */
+	std::size_t maxRecords = 0;
+	/** @brief The maximal time in milliseconds between the receipt of the
+	 * first record of a batch and the call of the callback on it, `0` to
+	 * wait for the buffer to fill. Once it elapses, the batch is passed on
+	 * with the records received so far. */
+	std::uint32_t maxDelayMs = 0;
+	/** @brief The amount of records a batch has to hold before `maxDelayMs`
+	 * applies. Smaller batches are delivered only once the buffer is full or
+	 * the response ends. */
+	std::size_t minRecords = 0;
+};
+
 /**
  * @brief A record type, containing a key and a payload of type T.
  *
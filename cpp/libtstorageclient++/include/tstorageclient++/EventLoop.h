@@ -0,0 +1,105 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * EventLoop.h
+ *   An I/O event loop driving asynchronous channels.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_EVENTLOOP_H
+#define D_TSTORAGE_EVENTLOOP_H
+
+#include <memory>
+
+#include "Response.h"
+
+/** @file
+ * @brief Defines the `EventLoop` class. */
+
+namespace tstorage {
+
+namespace impl {
+
+class AsyncChannelBase;
+class EventLoopImpl;
+
+} /*namespace impl*/
+
+/**
+ * @brief A single-threaded I/O event loop shared by `AsyncChannel<T>`
+ * instances.
+ *
+ * The loop owns a background thread which waits for readiness of the sockets
+ * of all attached channels (using `epoll` on Linux) and advances their
+ * requests without ever blocking on I/O. This way, a single thread serves any
+ * number of concurrent TStorage sessions.
+ *
+ * All completion callbacks of the attached channels are invoked on the loop's
+ * thread, hence they should return quickly; a long-running callback delays
+ * all other channels.
+ *
+ * The loop must outlive all channels attached to it. Programs using this
+ * class have to be linked with `-pthread`.
+ */
+class EventLoop final
+{
+public:
+	/** @brief Constructs a stopped event loop. */
+	EventLoop();
+	/** @brief Stops the loop. */
+	~EventLoop();
+
+	EventLoop(const EventLoop&) = delete;
+	EventLoop(EventLoop&&) = delete;
+	EventLoop& operator=(const EventLoop&) = delete;
+	EventLoop& operator=(EventLoop&&) = delete;
+
+	/**
+	 * @brief Starts the loop's thread.
+	 *
+	 * Operations submitted to the attached channels before the loop is started
+	 * are queued and processed once it starts. If the loop is already running,
+	 * the call is silently ignored and a success code is returned.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::SOCKET_ERROR`
+	 *
+	 * @return A `Response` instance with the status code of the operation.
+	 */
+	Response start();
+	/**
+	 * @brief Stops the loop's thread and waits for it to exit.
+	 *
+	 * Requests in progress are not cancelled; they are resumed if the loop is
+	 * started again. To abandon them, close the channels instead.
+	 */
+	void stop();
+	/**
+	 * @brief Checks whether the loop's thread is running.
+	 * @return `true` between a successful `start()` and `stop()`.
+	 */
+	bool running() const;
+
+private:
+	friend class impl::AsyncChannelBase;
+
+	/** @brief A pointer to the implementation. */
+	std::unique_ptr<impl::EventLoopImpl> mImpl;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * InternedPayloadType.h
+ *   A payload type sharing one copy of each distinct string or blob value.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_INTERNEDPAYLOADTYPE_H
+#define D_TSTORAGE_INTERNEDPAYLOADTYPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "PayloadType.h"
+
+/** @file
+ * @brief Defines the `InternedPayloadType` class. */
+
+namespace tstorage {
+
+/** @brief An interned string or blob value, shared by all records holding
+ * the same bytes. */
+using InternedBytes = std::shared_ptr<const std::string>;
+
+/**
+ * @brief A payload type of string or blob values, keeping a single copy of
+ * each distinct value received.
+ *
+ * Series of labels, states and other enum-like values hold a handful of
+ * distinct payloads over millions of records, yet a `RecordsSet<std::string>`
+ * allocates a copy per record. The payload type hashes each payload it
+ * deserializes and looks it up in a table of the values seen so far: a
+ * payload already there is returned as a handle of the existing copy, a new
+ * one is copied once and added. The records of a GET response then share
+ * their values, so that a low-cardinality series takes a few pointers per
+ * record, and two values of the same table are equal if and only if their
+ * handles are.
+ *
+ * Only payloads of at most `maxValueSize` bytes are interned, and no more than
+ * `maxValues` distinct ones; the others get a copy of their own. The table
+ * holds its values until `clear()`, so a high-cardinality series should use a
+ * plain payload type. Values are serialized as their bytes, a null handle as
+ * an empty payload.
+ *
+ * The table is guarded by a mutex, so that one instance can be shared by the
+ * channels of a pool with `SharedPayloadType<InternedBytes>`.
+ */
+class InternedPayloadType final : public PayloadType<InternedBytes>
+{
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param maxValues The bound of the amount of interned values.
+	 * @param maxValueSize The size of the largest payload to intern.
+	 */
+	explicit InternedPayloadType(
+		std::size_t maxValues = 65536, std::size_t maxValueSize = 256)
+		: mMaxValues(maxValues)
+		, mMaxValueSize(maxValueSize)
+	{
+	}
+
+	/** @brief Copies the bytes of `val`. */
+	std::size_t toBytes(
+		const InternedBytes& val, void* outputBuffer, std::size_t bufferSize) override
+	{
+		const std::size_t size = val ? val->size() : 0;
+		if (size <= bufferSize && size > 0) {
+			std::memcpy(outputBuffer, val->data(), size);
+		}
+		return size;
+	}
+
+	/** @brief Returns the interned copy of the payload, adding it to the table
+	 * if need be. */
+	bool fromBytes(
+		InternedBytes& oVar, const void* payloadBuffer, std::size_t payloadSize) override
+	{
+		const char* const bytes = static_cast<const char*>(payloadBuffer);
+		if (payloadSize > mMaxValueSize) {
+			oVar = std::make_shared<const std::string>(bytes, payloadSize);
+			return true;
+		}
+		const std::uint64_t hash = hashOf(bytes, payloadSize);
+		std::lock_guard<std::mutex> lock(mMutex);
+		const auto range = mValues.equal_range(hash);
+		for (auto it = range.first; it != range.second; ++it) {
+			const std::string& value = *it->second;
+			if (value.size() == payloadSize
+				&& std::memcmp(value.data(), bytes, payloadSize) == 0) {
+				oVar = it->second;
+				return true;
+			}
+		}
+		oVar = std::make_shared<const std::string>(bytes, payloadSize);
+		if (mValues.size() < mMaxValues) {
+			mValues.emplace(hash, oVar);
+		}
+		return true;
+	}
+
+	/** @brief Exposes the bytes of `val`. */
+	bool toView(const InternedBytes& val, const void*& oData, std::size_t& oSize) override
+	{
+		if (!val) {
+			return false;
+		}
+		oData = val->data();
+		oSize = val->size();
+		return true;
+	}
+
+	/** @brief Returns the size of `val`. */
+	bool sizeHint(const InternedBytes& val, std::size_t& oSize) override
+	{
+		oSize = val ? val->size() : 0;
+		return true;
+	}
+
+	/** @brief Returns the amount of interned values. */
+	std::size_t size() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mValues.size();
+	}
+
+	/** @brief Drops the table. The values remain valid as long as records
+	 * hold them, but are no longer shared with those received later. */
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mValues.clear();
+	}
+
+private:
+	/** @brief Returns the FNV-1a hash of `size` bytes. */
+	static std::uint64_t hashOf(const char* bytes, std::size_t size)
+	{
+		std::uint64_t hash = 0xcbf29ce484222325ULL;
+		for (std::size_t i = 0; i < size; ++i) {
+			hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 0x100000001b3ULL;
+		}
+		return hash;
+	}
+
+	/** @brief The bound of the amount of interned values. */
+	std::size_t mMaxValues;
+	/** @brief The size of the largest payload to intern. */
+	std::size_t mMaxValueSize;
+	/** @brief Guards the table. */
+	mutable std::mutex mMutex;
+	/** @brief The interned values by the hashes of their bytes. */
+	std::unordered_multimap<std::uint64_t, InternedBytes> mValues;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,179 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * LazyRecordsSet.h
+ *   A container of records deserialized on first access.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_LAZYRECORDSSET_H
+#define D_TSTORAGE_LAZYRECORDSSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BlobRecordsSet.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+
+/** @file
+ * @brief Defines a container of records deserialized on first access. */
+
+namespace tstorage {
+
+template<typename T>
+class Channel;
+
+/**
+ * @brief A container for inbound records which keeps their raw payloads and
+ * deserializes them only when accessed.
+ *
+ * The records are received into a `BlobRecordsSet`, a key and a payload span
+ * each, without calling `PayloadType<T>::fromBytes()`. The keys are available
+ * right away; a payload is deserialized by `value()` the first time it is
+ * accessed and, if caching is enabled, kept for later accesses. Showing the
+ * first page or only the keys of a large result hence costs the
+ * deserialization of that page only.
+ *
+ * The payloads are deserialized with the `PayloadType<T>` the set is
+ * constructed with or, if none, with that of the channel which filled it (see
+ * `Channel<T>::getLazy()`). In the latter case the set must not outlive the
+ * channel, and must not be accessed while the channel runs a request.
+ *
+ * A moveable container. Accessing values is not thread-safe.
+ *
+ * @tparam T Payload type of stored records.
+ */
+template<typename T>
+class LazyRecordsSet final
+{
+public:
+	/**
+	 * @brief Constructs an empty set.
+	 * @param payloadType The payload type to deserialize with, `nullptr` for
+	 * that of the channel filling the set.
+	 * @param cache `true` to keep deserialized values for later accesses.
+	 */
+	explicit LazyRecordsSet(
+		std::shared_ptr<PayloadType<T>> payloadType = nullptr, const bool cache = true)
+		: mOwnPayloadType(std::move(payloadType))
+		, mPayloadType(mOwnPayloadType.get())
+		, mCache(cache)
+	{
+	}
+
+	LazyRecordsSet(const LazyRecordsSet&) = delete;
+	LazyRecordsSet& operator=(const LazyRecordsSet&) = delete;
+	/** @brief A default move constructor. */
+	LazyRecordsSet(LazyRecordsSet&&) = default;
+	/** @brief A default move-assignment operator. */
+	LazyRecordsSet& operator=(LazyRecordsSet&&) = default;
+	/** @brief A default destructor. */
+	~LazyRecordsSet() = default;
+
+	/** @brief Returns the number of records currently stored in the container. */
+	std::size_t size() const { return mRaw.size(); }
+
+	/**
+	 * @brief Removes all records from the container. The allocated memory is
+	 * retained for reuse.
+	 */
+	void clear()
+	{
+		mRaw.clear();
+		mValues.clear();
+		mStates.clear();
+	}
+
+	/**
+	 * @brief Returns the key of the `i`-th record, without deserializing it.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	const Key& key(const std::size_t i) const { return mRaw.key(i); }
+
+	/**
+	 * @brief Returns the value of the `i`-th record, deserializing its payload
+	 * unless it's cached.
+	 * @param i Index of the record, less than `size()`.
+	 * @return The value, `nullptr` if the payload fails to deserialize. Valid
+	 * until the next call to `value()` if caching is disabled, or until
+	 * `clear()` otherwise.
+	 */
+	const T* value(const std::size_t i)
+	{
+		if (!mCache) {
+			mScratch = T{};
+			return decode(i, mScratch) ? &mScratch : nullptr;
+		}
+		if (mStates.size() < mRaw.size()) {
+			mValues.resize(mRaw.size());
+			mStates.resize(mRaw.size(), cPending);
+		}
+		if (mStates[i] == cPending) {
+			mStates[i] = decode(i, mValues[i]) ? cDecoded : cFailed;
+		}
+		return mStates[i] == cDecoded ? &mValues[i] : nullptr;
+	}
+
+	/**
+	 * @brief Deserializes the payload of the `i`-th record, bypassing the
+	 * cache.
+	 * @param i Index of the record, less than `size()`.
+	 * @param[out] oValue A default-constructed value to deserialize into.
+	 * @return `true` on success, `false` if the payload fails to deserialize
+	 * or the set has no payload type.
+	 */
+	bool decode(const std::size_t i, T& oValue) const
+	{
+		return mPayloadType != nullptr
+			   && mPayloadType->fromBytes(oValue, mRaw.payload(i), mRaw.payloadSize(i));
+	}
+
+	/** @brief Returns the raw records. */
+	const BlobRecordsSet& raw() const { return mRaw; }
+
+private:
+	friend class Channel<T>;
+
+	/** @brief The state of a cached value. */
+	enum : std::uint8_t {
+		cPending,  ///< Not deserialized yet.
+		cDecoded,  ///< Deserialized.
+		cFailed  ///< Failed to deserialize.
+	};
+
+	/** @brief The raw records. */
+	BlobRecordsSet mRaw;
+	/** @brief The payload type the set was constructed with, if any. */
+	std::shared_ptr<PayloadType<T>> mOwnPayloadType;
+	/** @brief The payload type to deserialize with. */
+	PayloadType<T>* mPayloadType;
+	/** @brief `true` if deserialized values are cached. */
+	bool mCache;
+	/** @brief The cached values, indexed by record. */
+	std::vector<T> mValues;
+	/** @brief The states of `mValues`. */
+	std::vector<std::uint8_t> mStates;
+	/** @brief The value returned last when caching is disabled. */
+	T mScratch{};
+};
+
+} /*namespace tstorage*/
+
+#endif
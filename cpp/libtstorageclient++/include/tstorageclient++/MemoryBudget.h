@@ -0,0 +1,167 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * MemoryBudget.h
+ *   A bound on the buffer memory of a group of channels.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_MEMORYBUDGET_H
+#define D_TSTORAGE_MEMORYBUDGET_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+/** @file
+ * @brief Defines the `MemoryBudget` class. */
+
+namespace tstorage {
+
+/**
+ * @brief An amount of memory shared by the buffers of the channels it is set
+ * on.
+ *
+ * A channel with a budget (see `Channel::setMemoryBudget()`) draws quota for
+ * each of its buffers before allocating it, and gives it back once it lets
+ * the buffer go. A request which finds the budget spent waits for quota to
+ * be given back, up to the timeout of its channel, and fails with
+ * `result_t::OUT_OF_MEMORY` after that, so that the requests of a process
+ * queue up instead of taking the memory they would together exceed.
+ *
+ * Above `cPressurePercent` of the limit, the budget is under pressure: the
+ * channels give up the spare send buffers of pipelined PUT/A requests, and
+ * receive buffers no longer grow for large records (see
+ * `Channel::setReceiveBufferGrowth()`). Paired with `Channel::setBufferRelease()`,
+ * which gives the quota back once a command is done, the budget bounds the
+ * memory of a fleet of channels by the requests in flight.
+ *
+ * The memory of record sets and of the buffer pool is not counted. Shared
+ * by the channels through a `std::shared_ptr`; all methods are thread-safe.
+ */
+class MemoryBudget final
+{
+public:
+	/** @brief The percentage of the limit above which the budget is under
+	 * pressure. */
+	static constexpr std::size_t cPressurePercent = 75;
+
+	/**
+	 * @brief Constructs a budget with nothing drawn from it.
+	 * @param limitBytes The amount of memory the buffers may take together.
+	 */
+	explicit MemoryBudget(const std::size_t limitBytes) : mLimit(limitBytes), mUsed(0) {}
+
+	MemoryBudget(const MemoryBudget&) = delete;
+	MemoryBudget(MemoryBudget&&) = delete;
+	MemoryBudget& operator=(const MemoryBudget&) = delete;
+	MemoryBudget& operator=(MemoryBudget&&) = delete;
+
+	/**
+	 * @brief Draws `bytes` of quota if that much is left.
+	 * @return `true` if the quota was drawn, `false` otherwise.
+	 */
+	bool tryAcquire(const std::size_t bytes)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return take(bytes);
+	}
+	/**
+	 * @brief Draws `bytes` of quota, waiting for it to be given back if
+	 * needed.
+	 * @param bytes The amount of quota.
+	 * @param timeout The longest time to wait for.
+	 * @return `true` if the quota was drawn, `false` if the time ran out or
+	 * `bytes` exceeds the limit.
+	 */
+	bool acquire(const std::size_t bytes, const std::chrono::duration<std::int64_t, std::milli> timeout)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		bool taken = false;
+		(void)mReleased.wait_for(lock, timeout, [this, bytes, &taken]() {
+			taken = take(bytes);
+			return taken || bytes > mLimit;
+		});
+		return taken;
+	}
+	/** @brief Gives `bytes` of quota back, waking the requests waiting for
+	 * it. */
+	void release(const std::size_t bytes)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mUsed -= bytes < mUsed ? bytes : mUsed;
+		}
+		mReleased.notify_all();
+	}
+
+	/** @brief Changes the limit. Quota drawn past a lowered limit stays
+	 * drawn until given back. */
+	void setLimit(const std::size_t limitBytes)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mLimit = limitBytes;
+		}
+		mReleased.notify_all();
+	}
+	/** @brief Returns the limit. */
+	std::size_t limit() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mLimit;
+	}
+	/** @brief Returns the quota drawn. */
+	std::size_t used() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mUsed;
+	}
+	/** @brief Returns `true` if more than `cPressurePercent` of the limit is
+	 * drawn. */
+	bool underPressure() const
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mUsed > mLimit / 100 * cPressurePercent;
+	}
+
+private:
+	/** @brief Draws `bytes` if that much is left. Requires `mMutex` to be
+	 * held. */
+	bool take(const std::size_t bytes)
+	{
+		if (bytes > mLimit || mUsed > mLimit - bytes) {
+			return false;
+		}
+		mUsed += bytes;
+		return true;
+	}
+
+	/** @brief Guards the other members. */
+	mutable std::mutex mMutex;
+	/** @brief Signalled when quota is given back or the limit changes. */
+	std::condition_variable mReleased;
+	/** @brief The limit. */
+	std::size_t mLimit;
+	/** @brief The quota drawn. */
+	std::size_t mUsed;
+};
+
+} /*namespace tstorage*/
+
+#endif
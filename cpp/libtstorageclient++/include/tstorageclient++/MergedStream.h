@@ -0,0 +1,234 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * MergedStream.h
+ *   An ordered merge of several streams of records.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_MERGEDSTREAM_H
+#define D_TSTORAGE_MERGEDSTREAM_H
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "ResponseAcq.h"
+
+/** @file
+ * @brief Defines the `MergedStream<T>` class. */
+
+namespace tstorage {
+
+/** @brief The order of the records of a `MergedStream<T>`. */
+enum class MergeOrder
+{
+	/** @brief By CID, MID, MOID, then CAP, the order of a GET response. */
+	KEY,
+	/** @brief By CAP, then CID, MID and MOID, i.e. the records of several
+	 * series interleaved in time. */
+	CAP
+};
+
+/**
+ * @brief A stream of the records of several streams, merged in key or CAP
+ * order.
+ *
+ * The responses of sharded or parallel GETs are each ordered, but not as a
+ * whole. Rather than gathering and sorting them, a `MergedStream<T>` pulls
+ * the records of several `Channel<T>::Stream`s, opened on different
+ * channels, and passes them on one at a time in a global order. A loser tree
+ * picks the next record among the current ones of the streams in
+ * `log2(streams)` comparisons, so the merge holds a single record per stream
+ * on top of the receive buffers of their channels, and runs at the pace of
+ * the streams.
+ *
+ * Each stream has to be ordered itself: a GET response is in the order of
+ * `MergeOrder::KEY`, and in the order of `MergeOrder::CAP` if it holds a
+ * single series. Records which compare equal are passed on in the order of
+ * their streams.
+ *
+ * @code
+ * std::vector<Channel<float>::Stream> streams;
+ * for (std::size_t i = 0; i < shards.size(); ++i) {
+ *     streams.push_back(channels[i].openStream(shards[i].first, shards[i].second));
+ * }
+ * MergedStream<float> merged(std::move(streams));
+ * for (const Record<float>& record : merged) { ... }
+ * @endcode
+ *
+ * The merge ends when all streams have run out, or as soon as one of them
+ * fails. The streams are pulled by the merge only, and are closed as
+ * documented on `Channel<T>::Stream` when it is destroyed.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class MergedStream final
+{
+public:
+	/** @brief The type of the merged streams. */
+	using Stream = typename Channel<T>::Stream;
+
+	/**
+	 * @brief An input iterator over the records of a merged stream.
+	 *
+	 * Incrementing it receives the next record, invalidating the one it
+	 * referred to. All iterators of a stream share its position.
+	 */
+	class iterator
+	{
+	public:
+		/** @brief The iterator category. */
+		using iterator_category = std::input_iterator_tag;
+		/** @brief The value type. */
+		using value_type = Record<T>;
+		/** @brief The difference type. */
+		using difference_type = std::ptrdiff_t;
+		/** @brief The pointer type. */
+		using pointer = const Record<T>*;
+		/** @brief The reference type. */
+		using reference = const Record<T>&;
+
+		/** @brief Constructs an end iterator. */
+		iterator() : mStream(nullptr) {}
+
+		/** @brief Accesses the current record. */
+		reference operator*() const { return mStream->record(); }
+		/** @brief Accesses the current record. */
+		pointer operator->() const { return &mStream->record(); }
+		/** @brief Receives the next record, turning into an end iterator
+		 * if there is none. */
+		iterator& operator++()
+		{
+			if (!mStream->next()) {
+				mStream = nullptr;
+			}
+			return *this;
+		}
+		/** @brief Returns `true` if both iterators are at the same
+		 * position. */
+		bool operator==(const iterator& other) const { return mStream == other.mStream; }
+		/** @brief Returns `true` if the iterators are at different
+		 * positions. */
+		bool operator!=(const iterator& other) const { return mStream != other.mStream; }
+
+	private:
+		friend class MergedStream;
+		/** @brief Constructs an iterator at the current record of
+		 * `stream`. */
+		explicit iterator(MergedStream* stream) : mStream(stream) {}
+
+		/** @brief The stream, `nullptr` past its end. */
+		MergedStream* mStream;
+	};
+
+	/**
+	 * @brief A constructor.
+	 *
+	 * No record is received until the first call to `next()`.
+	 *
+	 * @param streams The streams to merge, each in `order`.
+	 * @param order The order of the records.
+	 */
+	explicit MergedStream(std::vector<Stream>&& streams, MergeOrder order = MergeOrder::KEY);
+
+	MergedStream(const MergedStream&) = delete;
+	MergedStream(MergedStream&&) = delete;
+	MergedStream& operator=(const MergedStream&) = delete;
+	MergedStream& operator=(MergedStream&&) = delete;
+
+	/**
+	 * @brief Receives the next record in the order of the merge.
+	 * @return `true` if a record was received, `false` if the records of all
+	 * streams have run out or one of the streams has failed.
+	 */
+	bool next();
+	/** @brief Returns the record received last by `next()`. */
+	const Record<T>& record() const { return mStreams[mTree[0]].record(); }
+	/** @brief Moves the record received last by `next()` out of the stream. */
+	Record<T> take() { return mStreams[mTree[0]].take(); }
+	/** @brief Returns the index of the stream the record received last by
+	 * `next()` comes from. */
+	std::size_t source() const { return mTree[0]; }
+
+	/**
+	 * @brief Receives the first record and returns an iterator at it.
+	 * Meant to be called once, e.g. by a range-based for loop.
+	 */
+	iterator begin() { return next() ? iterator(this) : iterator(); }
+	/** @brief Returns the end iterator. */
+	iterator end() { return iterator(); }
+
+	/** @brief Returns `true` once the records have run out or one of the
+	 * streams has failed. */
+	bool finished() const { return mFinished; }
+	/**
+	 * @brief Returns the status code and the ACQ timestamp of the merge once
+	 * it is finished, `result_t::OK` with no valid ACQ while it is pending.
+	 *
+	 * The status code is the one of the first failed stream, in the order of
+	 * the streams. The ACQ is the smallest of the streams' ACQs. Records
+	 * acquired after it have been passed on nevertheless, as the ACQs are
+	 * only known at the ends of the streams.
+	 */
+	ResponseAcq response() const { return mResponse; }
+	/**
+	 * @brief Receives and discards the remaining records of all streams,
+	 * keeping their connections open.
+	 * @return The response, as returned by `response()`.
+	 */
+	ResponseAcq drain();
+
+	/** @brief Returns the merged streams. */
+	const std::vector<Stream>& streams() const { return mStreams; }
+
+private:
+	/** @brief Returns `true` if the current record of the `a`-th stream comes
+	 * before the one of the `b`-th stream, the index of the amount of streams
+	 * standing for a record before all others. */
+	bool before(std::size_t a, std::size_t b) const;
+	/** @brief Replays the matches of the `leaf`-th stream up to the root of
+	 * the tree, after its current record has changed. */
+	void replay(std::size_t leaf);
+	/** @brief Finishes the merge, with the first failure of the streams if
+	 * any. */
+	void finish();
+
+	/** @brief The merged streams. */
+	std::vector<Stream> mStreams;
+	/** @brief The order of the records. */
+	MergeOrder mOrder;
+	/** @brief The loser tree: the index of the stream of the next record at
+	 * the root, followed by the losers of the matches of the inner nodes. */
+	std::vector<std::size_t> mTree;
+	/** @brief `true` for each stream whose current record is valid. */
+	std::vector<bool> mPending;
+	/** @brief `true` once the first records have been received. */
+	bool mStarted;
+	/** @brief `true` once the merge is finished. */
+	bool mFinished;
+	/** @brief The response. */
+	ResponseAcq mResponse;
+};
+
+} /*namespace tstorage*/
+
+#include "MergedStream.tpp"
+
+#endif
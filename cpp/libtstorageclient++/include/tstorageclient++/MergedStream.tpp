@@ -0,0 +1,167 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * MergedStream.tpp
+ *   An implementation of the `MergedStream<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_MERGEDSTREAM_TPP
+#define D_TSTORAGE_MERGEDSTREAM_TPP
+
+#ifndef D_TSTORAGE_MERGEDSTREAM_H
+#error __FILE__ was included from outside of "MergedStream.h"
+#include "MergedStream.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "ResponseAcq.h"
+
+/** @file
+ * @brief Implements the `MergedStream<T>` class. */
+
+namespace tstorage {
+
+template<typename T>
+MergedStream<T>::MergedStream(std::vector<Stream>&& streams, const MergeOrder order)
+	: mStreams(std::move(streams))
+	, mOrder(order)
+	, mTree(mStreams.size(), mStreams.size())
+	, mPending(mStreams.size(), false)
+	, mStarted(false)
+	, mFinished(false)
+	, mResponse(result_t::OK)
+{
+}
+
+template<typename T>
+bool MergedStream<T>::next()
+{
+	if (mFinished) {
+		return false;
+	}
+	if (mStreams.empty()) {
+		finish();
+		return false;
+	}
+
+	if (!mStarted) {
+		mStarted = true;
+		for (std::size_t i = 0; i < mStreams.size(); ++i) {
+			mPending[i] = mStreams[i].next();
+			if (!mPending[i] && mStreams[i].response().error()) {
+				finish();
+				return false;
+			}
+		}
+		// Every leaf meets the stand-in for the first record on its way up,
+		// until all inner nodes hold a loser.
+		for (std::size_t i = mStreams.size(); i-- > 0;) {
+			replay(i);
+		}
+	} else {
+		const std::size_t leaf = mTree[0];
+		mPending[leaf] = mStreams[leaf].next();
+		if (!mPending[leaf] && mStreams[leaf].response().error()) {
+			finish();
+			return false;
+		}
+		replay(leaf);
+	}
+
+	if (!mPending[mTree[0]]) {
+		finish();
+		return false;
+	}
+	return true;
+}
+
+template<typename T>
+ResponseAcq MergedStream<T>::drain()
+{
+	for (std::size_t i = 0; i < mStreams.size(); ++i) {
+		mStreams[i].drain();
+		mPending[i] = false;
+	}
+	finish();
+	return mResponse;
+}
+
+template<typename T>
+bool MergedStream<T>::before(const std::size_t a, const std::size_t b) const
+{
+	if (a == mStreams.size()) {
+		return true;
+	}
+	if (b == mStreams.size()) {
+		return false;
+	}
+	// A stream which has run out comes after all records.
+	if (!mPending[a] || !mPending[b]) {
+		return mPending[a] || (!mPending[b] && a < b);
+	}
+
+	const Key& keyA = mStreams[a].record().key;
+	const Key& keyB = mStreams[b].record().key;
+	if (mOrder == MergeOrder::CAP && keyA.cap != keyB.cap) {
+		return keyA.cap < keyB.cap;
+	}
+	const auto rankA = std::tie(keyA.cid, keyA.mid, keyA.moid, keyA.cap);
+	const auto rankB = std::tie(keyB.cid, keyB.mid, keyB.moid, keyB.cap);
+	if (rankA != rankB) {
+		return rankA < rankB;
+	}
+	return a < b;
+}
+
+template<typename T>
+void MergedStream<T>::replay(const std::size_t leaf)
+{
+	std::size_t winner = leaf;
+	for (std::size_t node = (leaf + mStreams.size()) / 2; node > 0; node /= 2) {
+		if (before(mTree[node], winner)) {
+			std::swap(winner, mTree[node]);
+		}
+	}
+	mTree[0] = winner;
+}
+
+template<typename T>
+void MergedStream<T>::finish()
+{
+	mFinished = true;
+	Key::AcqT acq = Key::cAcqMax;
+	for (const Stream& stream : mStreams) {
+		const ResponseAcq response = stream.response();
+		if (response.error()) {
+			mResponse = response;
+			return;
+		}
+		acq = std::min(acq, response.acq());
+	}
+	mResponse = ResponseAcq(result_t::OK, acq);
+}
+
+} /*namespace tstorage*/
+
+#endif
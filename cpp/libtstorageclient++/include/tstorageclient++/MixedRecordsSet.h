@@ -0,0 +1,295 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * MixedRecordsSet.h
+ *   A container of records with payloads of several types, picked by CID.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_MIXEDRECORDSSET_H
+#define D_TSTORAGE_MIXEDRECORDSSET_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+
+/** @file
+ * @brief Defines the `PayloadRoutes<Ts...>` and `MixedRecordsSet<Ts...>`
+ * classes. */
+
+namespace tstorage {
+
+/**
+ * @brief A table assigning CID ranges to payload types.
+ *
+ * The ranges are kept sorted in a flat vector, so that finding the type of a
+ * CID is a binary search over a few contiguous entries.
+ *
+ * @tparam Ts The payload data types.
+ */
+template<typename... Ts>
+class PayloadRoutes final
+{
+public:
+	/** @brief The index returned by `typeOf()` for CIDs of no range. */
+	static constexpr std::size_t cNoType = sizeof...(Ts);
+
+	/** @brief The `I`-th payload data type. */
+	template<std::size_t I>
+	using Type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+	/**
+	 * @brief Constructs a table with no ranges.
+	 * @param payloadTypes The `PayloadType` of each of `Ts`.
+	 */
+	explicit PayloadRoutes(std::shared_ptr<PayloadType<Ts>>... payloadTypes)
+		: mPayloadTypes(std::move(payloadTypes)...)
+	{
+	}
+
+	/**
+	 * @brief Assigns the CIDs of `[cidMin, cidMax)` to the `I`-th payload type,
+	 * replacing the assignments of any of them made before.
+	 * @param cidMin The lower bound of the CID range.
+	 * @param cidMax The upper bound of the CID range.
+	 */
+	template<std::size_t I>
+	void route(Key::CidT cidMin, Key::CidT cidMax)
+	{
+		static_assert(I < sizeof...(Ts), "No such payload type");
+		if (cidMin >= cidMax) {
+			return;
+		}
+		std::vector<Range> ranges;
+		ranges.reserve(mRanges.size() + 2);
+		for (const Range& range : mRanges) {
+			if (range.cidMax <= cidMin || range.cidMin >= cidMax) {
+				ranges.push_back(range);
+				continue;
+			}
+			// Keep the parts of an overlapped range on either side.
+			if (range.cidMin < cidMin) {
+				ranges.push_back(Range{range.cidMin, cidMin, range.type});
+			}
+			if (range.cidMax > cidMax) {
+				ranges.push_back(Range{cidMax, range.cidMax, range.type});
+			}
+		}
+		ranges.push_back(Range{cidMin, cidMax, I});
+		std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+			return a.cidMin < b.cidMin;
+		});
+		mRanges = std::move(ranges);
+	}
+
+	/**
+	 * @brief Returns the index in `Ts` of the payload type of a CID.
+	 * @param cid The CID.
+	 * @return The index, `cNoType` if the CID is in no range.
+	 */
+	std::size_t typeOf(const Key::CidT cid) const
+	{
+		const auto it = std::upper_bound(mRanges.begin(),
+			mRanges.end(),
+			cid,
+			[](const Key::CidT value, const Range& range) { return value < range.cidMin; });
+		if (it == mRanges.begin() || cid >= std::prev(it)->cidMax) {
+			return cNoType;
+		}
+		return std::prev(it)->type;
+	}
+
+	/** @brief Returns the `PayloadType` of the `I`-th payload type. */
+	template<std::size_t I>
+	PayloadType<Type<I>>& payloadType() const
+	{
+		return *std::get<I>(mPayloadTypes);
+	}
+
+private:
+	/** @brief A CID range `[cidMin, cidMax)` and the index of its type. */
+	struct Range
+	{
+		Key::CidT cidMin;
+		Key::CidT cidMax;
+		std::size_t type;
+	};
+
+	/** @brief The payload types. */
+	std::tuple<std::shared_ptr<PayloadType<Ts>>...> mPayloadTypes;
+	/** @brief The disjoint CID ranges, sorted. */
+	std::vector<Range> mRanges;
+};
+
+template<typename... Ts>
+constexpr std::size_t PayloadRoutes<Ts...>::cNoType;
+
+/**
+ * @brief A container for inbound records whose payload type depends on their
+ * CID.
+ *
+ * Each appended record is deserialized with the `PayloadType` its CID is
+ * routed to (see `PayloadRoutes<Ts...>`), and kept in the `RecordsSet` of its
+ * type. The set also remembers the order of appending, as an entry per
+ * record. It can be filled by `Channel<T>::getMixed()`, so that a key-interval
+ * spanning series of different types is fetched by a single GET.
+ *
+ * A copyable and moveable container; copies share the routes.
+ *
+ * @tparam Ts The payload data types.
+ */
+template<typename... Ts>
+class MixedRecordsSet final
+{
+public:
+	/** @brief The `I`-th payload data type. */
+	template<std::size_t I>
+	using Type = typename PayloadRoutes<Ts...>::template Type<I>;
+
+	/** @brief A record of the set. */
+	struct Entry
+	{
+		/** @brief The index in `Ts` of the payload type. */
+		std::size_t type;
+		/** @brief The position of the record in the `RecordsSet` of its type. */
+		std::size_t position;
+	};
+
+	/**
+	 * @brief Constructs an empty set.
+	 * @param routes The routes of the CIDs to the payload types.
+	 */
+	explicit MixedRecordsSet(std::shared_ptr<PayloadRoutes<Ts...>> routes)
+		: mRoutes(std::move(routes))
+	{
+	}
+
+	/**
+	 * @brief Deserializes a payload with the payload type of its CID and
+	 * appends the record to the container.
+	 *
+	 * @param key Key of the new record.
+	 * @param payload The payload bytes.
+	 * @param size The size of the payload.
+	 * @return `true` on success, `false` if the CID isn't routed or the
+	 * payload fails to deserialize, in which case nothing is appended.
+	 */
+	bool append(const Key& key, const void* const payload, const std::size_t size)
+	{
+		const std::size_t type = mRoutes->typeOf(key.cid);
+		if (type == PayloadRoutes<Ts...>::cNoType) {
+			return false;
+		}
+		return (this->*appenders(std::index_sequence_for<Ts...>())[type])(key, payload, size);
+	}
+
+	/** @brief Returns the number of records currently stored in the container. */
+	std::size_t size() const { return mEntries.size(); }
+
+	/** @brief Removes all records from the container. */
+	void clear()
+	{
+		mEntries.clear();
+		clearSets(std::index_sequence_for<Ts...>());
+	}
+
+	/** @brief Returns the records, in the order of appending. */
+	const std::vector<Entry>& entries() const { return mEntries; }
+	/** @brief Returns the records of the `I`-th payload type, in the order of
+	 * appending. */
+	template<std::size_t I>
+	const RecordsSet<Type<I>>& records() const
+	{
+		return std::get<I>(mSets);
+	}
+
+	/**
+	 * @brief Calls `visitor` with the `i`-th record, as a `Record<U>` of its
+	 * payload type `U`.
+	 *
+	 * @param i Index of the record, less than `size()`.
+	 * @param visitor A callable accepting a `Record<U>` of each of `Ts`, e.g.
+	 * a generic lambda.
+	 */
+	template<typename Visitor>
+	void visit(const std::size_t i, Visitor&& visitor) const
+	{
+		visitAt(mEntries[i], visitor, std::index_sequence_for<Ts...>());
+	}
+
+private:
+	/** @brief A member appending a record of a given payload type. */
+	using Appender = bool (MixedRecordsSet::*)(const Key&, const void*, std::size_t);
+
+	/** @brief Returns the appenders of the payload types, indexed as `Ts`. */
+	template<std::size_t... Is>
+	static const std::array<Appender, sizeof...(Ts)>& appenders(std::index_sequence<Is...> /*types*/)
+	{
+		static const std::array<Appender, sizeof...(Ts)> table{{&MixedRecordsSet::appendAs<Is>...}};
+		return table;
+	}
+
+	/** @brief Appends a record of the `I`-th payload type. */
+	template<std::size_t I>
+	bool appendAs(const Key& key, const void* const payload, const std::size_t size)
+	{
+		Type<I> value{};
+		if (!mRoutes->template payloadType<I>().fromBytes(value, payload, size)) {
+			return false;
+		}
+		RecordsSet<Type<I>>& set = std::get<I>(mSets);
+		mEntries.push_back(Entry{I, set.size()});
+		set.append(key, std::move(value));
+		return true;
+	}
+
+	/** @brief Clears the set of each payload type. */
+	template<std::size_t... Is>
+	void clearSets(std::index_sequence<Is...> /*types*/)
+	{
+		(void)std::initializer_list<int>{(std::get<Is>(mSets).clear(), 0)...};
+	}
+
+	/** @brief Calls `visitor` with the record of `entry`. */
+	template<typename Visitor, std::size_t... Is>
+	void visitAt(const Entry& entry, Visitor& visitor, std::index_sequence<Is...> /*types*/) const
+	{
+		(void)std::initializer_list<int>{
+			(entry.type == Is ? (visitor(std::get<Is>(mSets)[entry.position]), 0) : 0)...};
+	}
+
+	/** @brief The routes of the CIDs to the payload types. */
+	std::shared_ptr<PayloadRoutes<Ts...>> mRoutes;
+	/** @brief The records of each payload type. */
+	std::tuple<RecordsSet<Ts>...> mSets;
+	/** @brief The records, in the order of appending. */
+	std::vector<Entry> mEntries;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * NegativeCache.h
+ *   A definition of a cache of key-intervals known to hold no records.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_NEGATIVECACHE_H
+#define D_TSTORAGE_NEGATIVECACHE_H
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines the `NegativeCache` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A bounded set of key-intervals proven empty by GET responses, which
+ * lets later GETs inside them be answered without a request.
+ *
+ * Below the full-commit ACQ of a key-interval its records never change (see
+ * `Channel<T>::getAcq()`), so a GET response holding no records proves its
+ * key-interval empty up to `min(keyMax.acq, acq)`, for good. The cache keeps
+ * such key-intervals and finds one containing a later key-interval in CID,
+ * MID, MOID and CAP, and covering its lower ACQ bound; `lookup()` returns how
+ * far up the ACQ axis the later key-interval is known to be empty.
+ *
+ * The key-intervals of a single series, i.e. spanning a single CID and MID as
+ * fan-out queries do, are indexed by their series: a lookup finds the series
+ * in logarithmic time, then scans its key-intervals linearly, as they may
+ * overlap in MOID, CAP and ACQ. The wider ones are all scanned linearly. The
+ * answers are exact: unlike a Bloom filter, the cache never reports a
+ * key-interval empty that was not proven so. A repeated key-interval extends
+ * the ACQ range of its entry instead of adding one. Once it holds
+ * `capacity()` key-intervals, the least recently used are forgotten. Each
+ * takes some 100 bytes of memory.
+ *
+ * The cache is not thread-safe.
+ */
+class NegativeCache final
+{
+public:
+	/** @brief The default amount of key-intervals held. */
+	static constexpr std::size_t cDefaultCapacity = 64UL * 1024;
+
+	/**
+	 * @brief Constructs an empty cache.
+	 * @param capacity The amount of key-intervals held, at least 1.
+	 */
+	explicit NegativeCache(std::size_t capacity = cDefaultCapacity);
+
+	NegativeCache(const NegativeCache&) = delete;
+	NegativeCache(NegativeCache&&) = delete;
+	NegativeCache& operator=(const NegativeCache&) = delete;
+	NegativeCache& operator=(NegativeCache&&) = delete;
+
+	/**
+	 * @brief Records a key-interval holding no records below its full-commit
+	 * ACQ.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval.
+	 * @param keyMax The upper vertex of the right-open key-interval.
+	 * @param acq The full-commit ACQ of the key-interval, e.g. that of the
+	 * empty GET response.
+	 */
+	void insert(const Key& keyMin, const Key& keyMax, Key::AcqT acq);
+
+	/**
+	 * @brief Finds how far up the ACQ axis a key-interval is known to be
+	 * empty.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval.
+	 * @param keyMax The upper vertex of the right-open key-interval.
+	 * @param[out] oEmptyUntil The ACQ below which the key-interval holds no
+	 * records, above `keyMin.acq`; not set if none is known.
+	 * @param[out] oAcq The most recent full-commit ACQ recorded for the
+	 * key-interval; not set if none is known.
+	 * @return `true` if the key-interval is known to be empty from
+	 * `keyMin.acq` up to `oEmptyUntil`.
+	 */
+	bool lookup(const Key& keyMin, const Key& keyMax, Key::AcqT& oEmptyUntil, Key::AcqT& oAcq);
+
+	/** @brief Forgets all key-intervals. */
+	void clear();
+
+	/** @brief Returns the amount of key-intervals held. */
+	std::size_t size() const { return mEntries.size(); }
+	/** @brief Returns the amount of key-intervals the cache may hold. */
+	std::size_t capacity() const { return mCapacity; }
+
+private:
+	/** @brief A series, i.e. a CID and a MID. */
+	using SeriesId = std::pair<Key::CidT, Key::MidT>;
+
+	/** @brief A key-interval known to be empty. */
+	struct Entry
+	{
+		/** @brief The lower vertex, with the lower ACQ bound. */
+		Key keyMin;
+		/** @brief The upper vertex, with the ACQ below which the key-interval
+		 * is empty. */
+		Key keyMax;
+		/** @brief The most recent full-commit ACQ of the key-interval. */
+		Key::AcqT acq;
+	};
+
+	using EntryIt = std::list<Entry>::iterator;
+
+	/** @brief Returns `true` and sets `oSeries` if the key-interval spans a
+	 * single series. */
+	static bool seriesOf(const Key& keyMin, const Key& keyMax, SeriesId& oSeries);
+	/** @brief Returns `true` if `entry` contains the key-interval in all but
+	 * the ACQ. */
+	static bool contains(const Entry& entry, const Key& keyMin, const Key& keyMax);
+	/** @brief Returns `true` if `entry` has the same bounds as the key-interval
+	 * in all but the ACQ. */
+	static bool sameBounds(const Entry& entry, const Key& keyMin, const Key& keyMax);
+	/** @brief Returns the entries the key-interval may lie in: those of its
+	 * series and the wide ones. */
+	std::vector<EntryIt> candidates(const Key& keyMin, const Key& keyMax);
+	/** @brief Forgets `entry`. */
+	void erase(EntryIt entry);
+
+	/** @brief The amount of key-intervals held at most. */
+	const std::size_t mCapacity;
+	/** @brief The key-intervals, the least recently used first. */
+	std::list<Entry> mEntries;
+	/** @brief The key-intervals spanning a single series, by their series. */
+	std::map<SeriesId, std::vector<EntryIt>> mSeries;
+	/** @brief The key-intervals spanning more than one series. */
+	std::vector<EntryIt> mWide;
+};
+
+} /*namespace tstorage*/
+
+#endif
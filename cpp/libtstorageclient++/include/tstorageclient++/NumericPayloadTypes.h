@@ -0,0 +1,535 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * NumericPayloadTypes.h
+ *   Ready-made payload types for numbers and arrays of numbers.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_NUMERICPAYLOADTYPES_H
+#define D_TSTORAGE_NUMERICPAYLOADTYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "PayloadType.h"
+#include "TrivialPayloadType.h"
+
+/** @file
+ * @brief Defines payload types for integers, floating-point numbers and
+ * floating-point arrays. */
+
+namespace tstorage {
+namespace impl {
+
+/** @brief `true` if the host stores numbers in little-endian byte order. */
+constexpr bool cLittleEndianHost = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+/** @brief An unsigned integer type of `Size` bytes. */
+template<std::size_t Size>
+struct UnsignedOfSize;
+/** @brief A 1-byte unsigned integer type. */
+template<>
+struct UnsignedOfSize<1>
+{
+	using type = std::uint8_t;
+};
+/** @brief A 2-byte unsigned integer type. */
+template<>
+struct UnsignedOfSize<2>
+{
+	using type = std::uint16_t;
+};
+/** @brief A 4-byte unsigned integer type. */
+template<>
+struct UnsignedOfSize<4>
+{
+	using type = std::uint32_t;
+};
+/** @brief An 8-byte unsigned integer type. */
+template<>
+struct UnsignedOfSize<8>
+{
+	using type = std::uint64_t;
+};
+
+/** @brief Reverses the byte order of an unsigned integer. */
+template<typename U>
+U byteSwap(U value)
+{
+	U swapped = 0;
+	for (std::size_t i = 0; i < sizeof(U); ++i) {
+		swapped = static_cast<U>(swapped << 8 | (value & 0xff));
+		value = static_cast<U>(value >> 8);
+	}
+	return swapped;
+}
+
+/** @brief Writes a number as a little-endian LEB128 varint.
+ * @return The amount of bytes written, at most 10. */
+inline std::size_t writeVarint(std::uint64_t value, unsigned char* const output)
+{
+	std::size_t size = 0;
+	while (value > 0x7f) {
+		output[size++] = static_cast<unsigned char>((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	output[size++] = static_cast<unsigned char>(value);
+	return size;
+}
+
+/** @brief Returns the size of a varint written by `writeVarint()`. */
+inline std::size_t varintSize(std::uint64_t value)
+{
+	std::size_t size = 1;
+	while (value > 0x7f) {
+		value >>= 7;
+		++size;
+	}
+	return size;
+}
+
+/** @brief Reads a varint written by `writeVarint()`.
+ * @return `false` if the input ends prematurely or the varint is too long. */
+inline bool readVarint(std::uint64_t& oValue,
+	const unsigned char*& ioInput,
+	const unsigned char* const inputEnd)
+{
+	oValue = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (ioInput == inputEnd) {
+			return false;
+		}
+		const unsigned char byte = *ioInput++;
+		oValue |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** @brief Appends bit fields to a byte vector, most significant bit first. */
+class BitWriter
+{
+public:
+	/** @brief Starts writing at the end of `output`. */
+	explicit BitWriter(std::vector<unsigned char>& output)
+		: mOutput(output)
+		, mFree(0)
+	{
+	}
+
+	/** @brief Writes the `count` lowest bits of `bits`, `count <= 64`. */
+	void write(const std::uint64_t bits, int count)
+	{
+		while (count > 0) {
+			if (mFree == 0) {
+				mOutput.push_back(0);
+				mFree = 8;
+			}
+			const int chunk = count < mFree ? count : mFree;
+			const unsigned mask = (1U << chunk) - 1;
+			const unsigned value = static_cast<unsigned>(bits >> (count - chunk)) & mask;
+			mOutput.back() = static_cast<unsigned char>(mOutput.back() | value << (mFree - chunk));
+			mFree -= chunk;
+			count -= chunk;
+		}
+	}
+
+private:
+	/** @brief The output. */
+	std::vector<unsigned char>& mOutput;
+	/** @brief The amount of unused low bits of the last byte. */
+	int mFree;
+};
+
+/** @brief Reads bit fields written by `BitWriter`. */
+class BitReader
+{
+public:
+	/** @brief Starts reading at `input`. */
+	BitReader(const unsigned char* const input, const unsigned char* const inputEnd)
+		: mInput(input)
+		, mInputEnd(inputEnd)
+		, mLeft(8)
+	{
+	}
+
+	/** @brief Reads `count` bits into the low bits of `oBits`, `count <= 64`.
+	 * @return `false` if the input ends prematurely. */
+	bool read(std::uint64_t& oBits, int count)
+	{
+		oBits = 0;
+		while (count > 0) {
+			if (mInput == mInputEnd) {
+				return false;
+			}
+			const int chunk = count < mLeft ? count : mLeft;
+			const unsigned mask = (1U << chunk) - 1;
+			oBits = oBits << chunk | ((*mInput >> (mLeft - chunk)) & mask);
+			mLeft -= chunk;
+			count -= chunk;
+			if (mLeft == 0) {
+				++mInput;
+				mLeft = 8;
+			}
+		}
+		return true;
+	}
+
+private:
+	/** @brief The next input byte. */
+	const unsigned char* mInput;
+	/** @brief The end of the input. */
+	const unsigned char* mInputEnd;
+	/** @brief The amount of unread low bits of `*mInput`. */
+	int mLeft;
+};
+
+/** @brief Returns the amount of leading zero bits of a nonzero `value`. */
+inline int leadingZeros(const std::uint64_t value)
+{
+	return __builtin_clzll(value);
+}
+
+/** @brief Returns the amount of trailing zero bits of a nonzero `value`. */
+inline int trailingZeros(const std::uint64_t value)
+{
+	return __builtin_ctzll(value);
+}
+
+} /*namespace impl*/
+
+/**
+ * @brief A `PayloadType<T>` storing numbers as their bytes in little-endian
+ * order, i.e. in a host-independent format.
+ *
+ * Each payload is exactly `sizeof(T)` bytes long; payloads of any other size
+ * are rejected on deserialization. Suitable for integers and IEEE 754
+ * floating-point numbers alike.
+ *
+ * @tparam T An arithmetic payload data type.
+ */
+template<typename T>
+class ByteSwappedPayloadType final : public PayloadType<T>
+{
+	static_assert(std::is_arithmetic<T>::value,
+		"ByteSwappedPayloadType<T> requires an arithmetic T");
+
+	/** @brief The unsigned integer type of the bytes of `T`. */
+	using BitsT = typename impl::UnsignedOfSize<sizeof(T)>::type;
+
+public:
+	/** @brief Writes the bytes of `val` if the buffer can hold `sizeof(T)`. */
+	std::size_t toBytes(const T& val, void* outputBuffer, std::size_t bufferSize) override
+	{
+		if (bufferSize >= sizeof(T)) {
+			BitsT bits;
+			std::memcpy(&bits, &val, sizeof(T));
+			bits = impl::byteSwap(bits);
+			std::memcpy(outputBuffer, &bits, sizeof(T));
+		}
+		return sizeof(T);
+	}
+	/** @brief Reads `sizeof(T)` bytes to `oVar`, failing on any other size. */
+	bool fromBytes(T& oVar, const void* payloadBuffer, std::size_t payloadSize) override
+	{
+		if (payloadSize != sizeof(T)) {
+			return false;
+		}
+		BitsT bits;
+		std::memcpy(&bits, payloadBuffer, sizeof(T));
+		bits = impl::byteSwap(bits);
+		std::memcpy(&oVar, &bits, sizeof(T));
+		return true;
+	}
+	/** @brief Reports the constant payload size. */
+	bool sizeHint(const T& /*val*/, std::size_t& oSize) override
+	{
+		oSize = sizeof(T);
+		return true;
+	}
+};
+
+/**
+ * @brief A payload type storing numbers in little-endian byte order.
+ *
+ * On little-endian hosts, this is `TrivialPayloadType<T>`, which the channel
+ * serializes inline; on big-endian hosts, `ByteSwappedPayloadType<T>`.
+ *
+ * @tparam T An arithmetic payload data type.
+ */
+template<typename T>
+using LittleEndianPayloadType = typename std::conditional<impl::cLittleEndianHost,
+	TrivialPayloadType<T>,
+	ByteSwappedPayloadType<T>>::type;
+
+/**
+ * @brief A `PayloadType<T>` storing integers as LEB128 varints, taking fewer
+ * bytes for values of small magnitude.
+ *
+ * Unsigned values take a byte per 7 significant bits, i.e. a single byte below
+ * 128. Signed values are zigzag-encoded first, mapping `0, -1, 1, -2, ...` to
+ * `0, 1, 2, 3, ...`, so that small negative values are short as well.
+ *
+ * @tparam T An integral payload data type.
+ */
+template<typename T>
+class VarintPayloadType final : public PayloadType<T>
+{
+	static_assert(std::is_integral<T>::value, "VarintPayloadType<T> requires an integral T");
+
+public:
+	/** @brief Writes the varint of `val` if it fits in the buffer. */
+	std::size_t toBytes(const T& val, void* outputBuffer, std::size_t bufferSize) override
+	{
+		const std::uint64_t encoded = encode(val);
+		const std::size_t size = impl::varintSize(encoded);
+		if (bufferSize >= size) {
+			impl::writeVarint(encoded, static_cast<unsigned char*>(outputBuffer));
+		}
+		return size;
+	}
+	/** @brief Reads a varint, failing on trailing bytes or values out of the
+	 * range of `T`. */
+	bool fromBytes(T& oVar, const void* payloadBuffer, std::size_t payloadSize) override
+	{
+		const unsigned char* input = static_cast<const unsigned char*>(payloadBuffer);
+		const unsigned char* const inputEnd = input + payloadSize;
+		std::uint64_t encoded = 0;
+		if (!impl::readVarint(encoded, input, inputEnd) || input != inputEnd) {
+			return false;
+		}
+		if (encoded > static_cast<std::uint64_t>(static_cast<UnsignedT>(~UnsignedT(0)))) {
+			return false;
+		}
+		oVar = decode(encoded);
+		return true;
+	}
+	/** @brief Reports the varint size of `val`. */
+	bool sizeHint(const T& val, std::size_t& oSize) override
+	{
+		oSize = impl::varintSize(encode(val));
+		return true;
+	}
+
+private:
+	/** @brief The unsigned counterpart of `T`. */
+	using UnsignedT = typename std::make_unsigned<T>::type;
+
+	/** @brief Zigzag-encodes a signed value. */
+	static std::uint64_t encode(const T val)
+	{
+		const UnsignedT bits = static_cast<UnsignedT>(val);
+		if (!std::is_signed<T>::value) {
+			return bits;
+		}
+		const UnsignedT sign = val < 0 ? static_cast<UnsignedT>(~UnsignedT(0)) : 0;
+		return static_cast<UnsignedT>(static_cast<UnsignedT>(bits << 1) ^ sign);
+	}
+	/** @brief Reverses `encode()`. */
+	static T decode(const std::uint64_t encoded)
+	{
+		const UnsignedT bits = static_cast<UnsignedT>(encoded);
+		if (!std::is_signed<T>::value) {
+			return static_cast<T>(bits);
+		}
+		const UnsignedT sign = (bits & 1) != 0 ? static_cast<UnsignedT>(~UnsignedT(0)) : 0;
+		return static_cast<T>(static_cast<UnsignedT>(bits >> 1) ^ sign);
+	}
+};
+
+/**
+ * @brief A `PayloadType<std::vector<F>>` storing arrays of floating-point
+ * numbers with the XOR compression of Facebook's Gorilla.
+ *
+ * Consecutive values of a slowly changing series share their sign, exponent
+ * and leading mantissa bits. Each value is stored as its XOR with the previous
+ * one: a single `0` bit if they are equal, or just the bits between the
+ * leading and trailing zeros of the XOR otherwise, which for typical telemetry
+ * takes a fraction of `sizeof(F)` bytes per value. The payload starts with the
+ * amount of values as a varint, followed by the first value in full.
+ *
+ * The encoding is inherently sequential, hence not vectorized.
+ *
+ * @tparam F `float` or `double`.
+ */
+template<typename F>
+class GorillaPayloadType final : public PayloadType<std::vector<F>>
+{
+	static_assert(std::is_floating_point<F>::value && (sizeof(F) == 4 || sizeof(F) == 8),
+		"GorillaPayloadType<F> requires a 32- or 64-bit floating-point F");
+
+public:
+	/**
+	 * @brief Encodes `val`.
+	 *
+	 * A value which does not fit in the buffer is encoded again on the retry:
+	 * nothing is kept between the calls, since the channel may not retry, and
+	 * another value may take the address of this one.
+	 */
+	std::size_t toBytes(
+		const std::vector<F>& val, void* outputBuffer, std::size_t bufferSize) override
+	{
+		encode(val);
+		if (mEncoded.size() > bufferSize) {
+			return mEncoded.size();
+		}
+		std::memcpy(outputBuffer, mEncoded.data(), mEncoded.size());
+		return mEncoded.size();
+	}
+	/** @brief Decodes an array encoded by `toBytes()`. */
+	bool fromBytes(
+		std::vector<F>& oVar, const void* payloadBuffer, std::size_t payloadSize) override;
+
+private:
+	/** @brief The unsigned integer type of the bits of `F`. */
+	using BitsT = typename impl::UnsignedOfSize<sizeof(F)>::type;
+	/** @brief The amount of bits of `F`. */
+	static constexpr int cBits = 8 * sizeof(F);
+	/** @brief The width of the leading zeros field, capped at `31`. */
+	static constexpr int cLeadingBits = 5;
+	/** @brief The width of the meaningful bits length field, less one. */
+	static constexpr int cLengthBits = sizeof(F) == 4 ? 5 : 6;
+
+	/** @brief Encodes `values` into `mEncoded`. */
+	void encode(const std::vector<F>& values);
+
+	/** @brief The encoding of the last value. */
+	std::vector<unsigned char> mEncoded;
+};
+
+template<typename F>
+void GorillaPayloadType<F>::encode(const std::vector<F>& values)
+{
+	mEncoded.resize(10);
+	mEncoded.resize(impl::writeVarint(values.size(), mEncoded.data()));
+	if (values.empty()) {
+		return;
+	}
+	impl::BitWriter writer(mEncoded);
+	BitsT previous;
+	std::memcpy(&previous, &values[0], sizeof(F));
+	writer.write(previous, cBits);
+	// The meaningful bits window of the last stored XOR, `leading = cBits`
+	// for none.
+	int leading = cBits;
+	int trailing = 0;
+	for (std::size_t i = 1; i < values.size(); ++i) {
+		BitsT current;
+		std::memcpy(&current, &values[i], sizeof(F));
+		const BitsT xored = static_cast<BitsT>(current ^ previous);
+		previous = current;
+		if (xored == 0) {
+			writer.write(0, 1);
+			continue;
+		}
+		int xorLeading = impl::leadingZeros(xored) - (64 - cBits);
+		const int xorTrailing = impl::trailingZeros(xored);
+		if (xorLeading > 31) {
+			xorLeading = 31;
+		}
+		if (leading != cBits && xorLeading >= leading && xorTrailing >= trailing) {
+			// Within the previous window.
+			writer.write(0b10, 2);
+			writer.write(xored >> trailing, cBits - leading - trailing);
+			continue;
+		}
+		const int length = cBits - xorLeading - xorTrailing;
+		writer.write(0b11, 2);
+		writer.write(static_cast<std::uint64_t>(xorLeading), cLeadingBits);
+		writer.write(static_cast<std::uint64_t>(length - 1), cLengthBits);
+		writer.write(xored >> xorTrailing, length);
+		leading = xorLeading;
+		trailing = xorTrailing;
+	}
+}
+
+template<typename F>
+bool GorillaPayloadType<F>::fromBytes(
+	std::vector<F>& oVar, const void* const payloadBuffer, const std::size_t payloadSize)
+{
+	const unsigned char* input = static_cast<const unsigned char*>(payloadBuffer);
+	const unsigned char* const inputEnd = input + payloadSize;
+	std::uint64_t count = 0;
+	if (!impl::readVarint(count, input, inputEnd)) {
+		return false;
+	}
+	oVar.clear();
+	if (count == 0) {
+		return input == inputEnd;
+	}
+	// Each value takes at least a bit, which bounds the allocation.
+	if (count - 1 > 8 * static_cast<std::uint64_t>(inputEnd - input)) {
+		return false;
+	}
+	oVar.reserve(count);
+
+	impl::BitReader reader(input, inputEnd);
+	std::uint64_t bits = 0;
+	if (!reader.read(bits, cBits)) {
+		return false;
+	}
+	BitsT previous = static_cast<BitsT>(bits);
+	int leading = cBits;
+	int trailing = 0;
+	for (std::uint64_t i = 0; i < count; ++i) {
+		if (i != 0) {
+			if (!reader.read(bits, 1)) {
+				return false;
+			}
+			if (bits != 0) {
+				std::uint64_t control = 0;
+				if (!reader.read(control, 1)) {
+					return false;
+				}
+				if (control != 0) {
+					std::uint64_t field = 0;
+					if (!reader.read(field, cLeadingBits)) {
+						return false;
+					}
+					leading = static_cast<int>(field);
+					if (!reader.read(field, cLengthBits)) {
+						return false;
+					}
+					const int length = static_cast<int>(field) + 1;
+					if (leading + length > cBits) {
+						return false;
+					}
+					trailing = cBits - leading - length;
+				} else if (leading == cBits) {
+					return false;
+				}
+				if (!reader.read(bits, cBits - leading - trailing)) {
+					return false;
+				}
+				previous = static_cast<BitsT>(previous ^ static_cast<BitsT>(bits << trailing));
+			}
+		}
+		F value;
+		std::memcpy(&value, &previous, sizeof(F));
+		oVar.push_back(value);
+	}
+	return true;
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,177 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PackedKey.h
+ *   A compact, order-preserving encoding of keys.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PACKEDKEY_H
+#define D_TSTORAGE_PACKEDKEY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines the `PackedKey` type and a radix sort over it. */
+
+namespace tstorage {
+
+/**
+ * @brief A key encoded as four 64-bit words ordered like the keys.
+ *
+ * A `Key` takes 40 bytes in memory due to the padding after its 32-bit
+ * fields, and its `operator<` compares the fields one by one. A packed key
+ * takes 32 bytes: the fields are laid out from CID to ACQ, most significant
+ * bits first, with their sign bits flipped, so that comparing the words
+ * lexicographically as unsigned integers orders the packed keys exactly as
+ * `operator<` orders the keys. The same holds for the 32 bytes returned by
+ * `byte()`, which makes packed keys suitable for radix sorting (see
+ * `radixSort()`), as well as for cheap binary search and hashing.
+ */
+struct PackedKey
+{
+	/** @brief Zero-initializes the words. Not the encoding of any `Key()`. */
+	PackedKey() noexcept : words{} {}
+	/** @brief Encodes a key. */
+	explicit PackedKey(const Key& key) noexcept
+	{
+		const std::uint64_t cid =
+			static_cast<std::uint32_t>(key.cid) ^ (std::uint32_t{1} << 31U);
+		const std::uint64_t mid = static_cast<std::uint64_t>(key.mid) ^ cSignBit;
+		const std::uint64_t moid =
+			static_cast<std::uint32_t>(key.moid) ^ (std::uint32_t{1} << 31U);
+		words[0] = (cid << 32U) | (mid >> 32U);
+		words[1] = (mid << 32U) | moid;
+		words[2] = static_cast<std::uint64_t>(key.cap) ^ cSignBit;
+		words[3] = static_cast<std::uint64_t>(key.acq) ^ cSignBit;
+	}
+
+	/** @brief Decodes the key. */
+	Key unpack() const noexcept
+	{
+		const std::uint64_t mid = (words[0] << 32U) | (words[1] >> 32U);
+		return Key(static_cast<Key::CidT>(static_cast<std::uint32_t>(words[0] >> 32U)
+					   ^ (std::uint32_t{1} << 31U)),
+			static_cast<Key::MidT>(mid ^ cSignBit),
+			static_cast<Key::MoidT>(
+				static_cast<std::uint32_t>(words[1]) ^ (std::uint32_t{1} << 31U)),
+			static_cast<Key::CapT>(words[2] ^ cSignBit),
+			static_cast<Key::AcqT>(words[3] ^ cSignBit));
+	}
+
+	/**
+	 * @brief Returns the `i`-th byte of the encoding, the most significant
+	 * one first.
+	 *
+	 * @param i The index of the byte, less than `32`.
+	 */
+	std::uint8_t byte(const std::size_t i) const noexcept
+	{
+		return static_cast<std::uint8_t>(words[i / 8] >> (56U - 8U * (i % 8)));
+	}
+
+	/** @brief Orders the packed keys as the keys they encode. */
+	bool operator<(const PackedKey& other) const noexcept { return words < other.words; }
+	/** @brief Compares the packed keys word by word. */
+	bool operator==(const PackedKey& other) const noexcept { return words == other.words; }
+	/** @brief Compares the packed keys word by word. */
+	bool operator!=(const PackedKey& other) const noexcept { return words != other.words; }
+
+	/** @brief The encoding, the most significant word first. */
+	std::array<std::uint64_t, 4> words;
+
+private:
+	/** @brief The sign bit of a 64-bit field. */
+	static constexpr std::uint64_t cSignBit = std::uint64_t{1} << 63U;
+};
+
+static_assert(sizeof(PackedKey) == 32, "PackedKey is expected to take 32 bytes");
+
+/**
+ * @brief Sorts pairs of packed keys and values by the keys, with a stable
+ * least-significant-digit radix sort.
+ *
+ * Makes one counting pass per byte of the keys, skipping the bytes that are
+ * equal in all keys, e.g. the CID bytes of records of a single client. The
+ * cost is thus linear in the amount of pairs, with no key comparisons.
+ *
+ * @tparam V The type of the values, e.g. the indices of records.
+ * @param ioEntries The pairs to sort.
+ */
+template<typename V>
+void radixSort(std::vector<std::pair<PackedKey, V>>& ioEntries)
+{
+	constexpr std::size_t cBytes = sizeof(PackedKey);
+	constexpr std::size_t cDigits = 256;
+	if (ioEntries.size() < 2) {
+		return;
+	}
+
+	std::vector<std::pair<PackedKey, V>> scratch(ioEntries.size());
+	std::array<std::size_t, cDigits> offsets{};
+	for (std::size_t i = cBytes; i-- > 0;) {
+		offsets.fill(0);
+		for (const std::pair<PackedKey, V>& entry : ioEntries) {
+			++offsets[entry.first.byte(i)];
+		}
+		if (offsets[ioEntries.front().first.byte(i)] == ioEntries.size()) {
+			continue;
+		}
+		std::size_t offset = 0;
+		for (std::size_t& count : offsets) {
+			offset += count;
+			count = offset - count;
+		}
+		for (std::pair<PackedKey, V>& entry : ioEntries) {
+			scratch[offsets[entry.first.byte(i)]++] = std::move(entry);
+		}
+		ioEntries.swap(scratch);
+	}
+}
+
+} /*namespace tstorage*/
+
+namespace std {
+
+/** @brief Hashes a packed key by mixing its words. */
+template<>
+struct hash<tstorage::PackedKey>
+{
+	/** @brief Returns the hash of `key`. */
+	std::size_t operator()(const tstorage::PackedKey& key) const noexcept
+	{
+		std::uint64_t hash = 0;
+		for (const std::uint64_t word : key.words) {
+			// The finalizer of MurmurHash3, applied to the running hash.
+			hash ^= word;
+			hash ^= hash >> 33U;
+			hash *= 0xFF51AFD7ED558CCDULL;
+			hash ^= hash >> 33U;
+		}
+		return static_cast<std::size_t>(hash);
+	}
+};
+
+} /*namespace std*/
+
+#endif
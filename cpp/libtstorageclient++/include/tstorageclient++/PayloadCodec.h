@@ -0,0 +1,400 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PayloadCodec.h
+ *   Compression codecs for payloads.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PAYLOADCODEC_H
+#define D_TSTORAGE_PAYLOADCODEC_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+/** @file
+ * @brief Defines the `PayloadCodec` interface and the `LzPayloadCodec`. */
+
+namespace tstorage {
+
+/**
+ * @brief Abstract base class for payload compression codecs.
+ *
+ * A codec compresses a single serialized payload into a self-contained block,
+ * which it can decompress without any other payload: the records of a GET
+ * response come in no particular order, and possibly to other clients. A
+ * codec is used by `CompressedPayloadType<T>`, which keeps the size of the
+ * uncompressed payload, so the codec does not need to.
+ *
+ * Codecs may keep scratch state and need not be thread-safe.
+ */
+class PayloadCodec
+{
+public:
+	/** @brief A default constructor. */
+	PayloadCodec() = default;
+	/** @brief An empty virtual destructor. */
+	virtual ~PayloadCodec() = default;
+
+	/** @brief A default copy constructor. */
+	PayloadCodec(const PayloadCodec&) = default;
+	/** @brief A default move constructor. */
+	PayloadCodec(PayloadCodec&&) = default;
+	/** @brief A default copy-assignment operator. */
+	PayloadCodec& operator=(const PayloadCodec&) = default;
+	/** @brief A default move-assignment operator. */
+	PayloadCodec& operator=(PayloadCodec&&) = default;
+
+	/**
+	 * @brief Compresses a payload.
+	 *
+	 * @param input The payload to compress.
+	 * @param inputSize The size of the payload.
+	 * @param[out] output The buffer for the compressed block.
+	 * @param outputCapacity The size of `output`.
+	 * @return The size of the compressed block, `0` if it does not fit in
+	 * `outputCapacity` bytes.
+	 */
+	virtual std::size_t compress(const void* input,
+		std::size_t inputSize,
+		void* output,
+		std::size_t outputCapacity)
+		= 0;
+
+	/**
+	 * @brief Decompresses a block made by `compress()`.
+	 *
+	 * @param input The compressed block.
+	 * @param inputSize The size of the block.
+	 * @param[out] output The buffer for the payload.
+	 * @param outputSize The exact size of the payload.
+	 * @return `true` on success, `false` if the block is malformed.
+	 */
+	virtual bool decompress(const void* input,
+		std::size_t inputSize,
+		void* output,
+		std::size_t outputSize)
+		= 0;
+
+	/**
+	 * @brief Returns the largest payload a block may decompress to.
+	 *
+	 * Bounds the memory a malformed block, claiming a huge payload size, makes
+	 * the reader allocate. The default allows a compression ratio of
+	 * `cDefaultMaxRatio`; codecs reaching higher ones override it.
+	 *
+	 * @param inputSize The size of the block.
+	 * @return The largest size of the payload.
+	 */
+	virtual std::size_t maxDecompressedSize(std::size_t inputSize) const
+	{
+		return inputSize * cDefaultMaxRatio;
+	}
+
+	/** @brief The compression ratio allowed by `maxDecompressedSize()` by
+	 * default. */
+	static constexpr std::size_t cDefaultMaxRatio = 1024;
+};
+
+/**
+ * @brief A byte-oriented LZ77 codec, optionally primed with a dictionary.
+ *
+ * A fast codec with no external dependencies, in the vein of LZ4: a block is
+ * a sequence of literal runs and back-references of up to 64 KiB, found with
+ * a hash table of 4-byte sequences. It pays off for payloads with repetitive
+ * content, e.g. text, JSON or arrays of similar values.
+ *
+ * Payloads are usually too small to contain much repetition on their own. A
+ * dictionary, i.e. a sample of typical payload content, lets back-references
+ * point into it as if it preceded each payload. The same dictionary must be
+ * used to compress and to decompress; only its last 64 KiB are referenced.
+ */
+class LzPayloadCodec final : public PayloadCodec
+{
+public:
+	/**
+	 * @brief A constructor.
+	 * @param dictionary The dictionary priming each block, empty for none.
+	 */
+	explicit LzPayloadCodec(std::vector<unsigned char> dictionary = {})
+		: mDictionary(std::move(dictionary))
+		, mDictTable(cTableSize, -1)
+		, mTable(cTableSize, 0)
+		, mEpochs(cTableSize, 0)
+		, mEpoch(0)
+	{
+		const std::size_t dictStart
+			= mDictionary.size() > cMaxOffset ? mDictionary.size() - cMaxOffset : 0;
+		for (std::size_t i = dictStart; i + cMinMatch <= mDictionary.size(); ++i) {
+			mDictTable[hash(mDictionary.data() + i)] = static_cast<std::int32_t>(i);
+		}
+	}
+
+	std::size_t compress(const void* input,
+		std::size_t inputSize,
+		void* output,
+		std::size_t outputCapacity) override;
+
+	bool decompress(const void* input,
+		std::size_t inputSize,
+		void* output,
+		std::size_t outputSize) override;
+
+	/** @brief Returns the largest payload a block may decompress to: each
+	 * input byte yields at most `255` bytes, extending a length. */
+	std::size_t maxDecompressedSize(std::size_t inputSize) const override
+	{
+		return inputSize * 255;
+	}
+
+private:
+	/** @brief The shortest back-reference. */
+	static constexpr std::size_t cMinMatch = 4;
+	/** @brief The longest back-reference distance. */
+	static constexpr std::size_t cMaxOffset = 65535;
+	/** @brief The amount of bits of a hash. */
+	static constexpr int cHashBits = 12;
+	/** @brief The amount of hash table entries. */
+	static constexpr std::size_t cTableSize = std::size_t(1) << cHashBits;
+
+	/** @brief Hashes the 4-byte sequence at `bytes`. */
+	static std::size_t hash(const unsigned char* const bytes)
+	{
+		std::uint32_t sequence;
+		std::memcpy(&sequence, bytes, sizeof(sequence));
+		return (sequence * 2654435761U) >> (32 - cHashBits);
+	}
+
+	/**
+	 * @brief Writes a length in the 4-bit field of a token and, for lengths of
+	 * `15` and more, in the bytes that follow.
+	 * @return `false` if the output does not fit.
+	 */
+	static bool writeLength(std::size_t length,
+		unsigned char*& ioOutput,
+		const unsigned char* outputEnd);
+	/**
+	 * @brief Reads a length continued after a token field of `15`.
+	 * @return `false` if the input ends prematurely.
+	 */
+	static bool readLength(std::size_t& ioLength,
+		const unsigned char*& ioInput,
+		const unsigned char* inputEnd);
+	/**
+	 * @brief Writes a sequence of literals followed by a back-reference, or
+	 * by nothing if `matchLength` is `0`.
+	 * @return `false` if the output does not fit.
+	 */
+	static bool writeSequence(const unsigned char* literals,
+		std::size_t literalLength,
+		std::size_t offset,
+		std::size_t matchLength,
+		unsigned char*& ioOutput,
+		const unsigned char* outputEnd);
+
+	/** @brief The dictionary. */
+	std::vector<unsigned char> mDictionary;
+	/** @brief The last dictionary position of each hash, `-1` if none. */
+	std::vector<std::int32_t> mDictTable;
+	/** @brief The last input position of each hash in the current block. */
+	std::vector<std::uint32_t> mTable;
+	/** @brief The block each entry of `mTable` was set in. */
+	std::vector<std::uint32_t> mEpochs;
+	/** @brief The number of the current block, so that `mTable` need not be
+	 * cleared between blocks. */
+	std::uint32_t mEpoch;
+};
+
+inline bool LzPayloadCodec::writeLength(
+	std::size_t length, unsigned char*& ioOutput, const unsigned char* const outputEnd)
+{
+	if (length < 15) {
+		return true;
+	}
+	length -= 15;
+	while (true) {
+		if (ioOutput == outputEnd) {
+			return false;
+		}
+		if (length < 255) {
+			*ioOutput++ = static_cast<unsigned char>(length);
+			return true;
+		}
+		*ioOutput++ = 255;
+		length -= 255;
+	}
+}
+
+inline bool LzPayloadCodec::readLength(std::size_t& ioLength,
+	const unsigned char*& ioInput,
+	const unsigned char* const inputEnd)
+{
+	if (ioLength < 15) {
+		return true;
+	}
+	while (true) {
+		if (ioInput == inputEnd) {
+			return false;
+		}
+		const unsigned char byte = *ioInput++;
+		ioLength += byte;
+		if (byte != 255) {
+			return true;
+		}
+	}
+}
+
+inline bool LzPayloadCodec::writeSequence(const unsigned char* const literals,
+	const std::size_t literalLength,
+	const std::size_t offset,
+	const std::size_t matchLength,
+	unsigned char*& ioOutput,
+	const unsigned char* const outputEnd)
+{
+	if (ioOutput == outputEnd) {
+		return false;
+	}
+	const std::size_t matchField = matchLength == 0 ? 0 : matchLength - cMinMatch;
+	unsigned char* const token = ioOutput++;
+	*token = static_cast<unsigned char>(
+		(literalLength < 15 ? literalLength : 15) << 4 | (matchField < 15 ? matchField : 15));
+	if (!writeLength(literalLength, ioOutput, outputEnd)
+		|| static_cast<std::size_t>(outputEnd - ioOutput) < literalLength) {
+		return false;
+	}
+	std::memcpy(ioOutput, literals, literalLength);
+	ioOutput += literalLength;
+	if (matchLength == 0) {
+		return true;
+	}
+	if (outputEnd - ioOutput < 2) {
+		return false;
+	}
+	*ioOutput++ = static_cast<unsigned char>(offset);
+	*ioOutput++ = static_cast<unsigned char>(offset >> 8);
+	return writeLength(matchField, ioOutput, outputEnd);
+}
+
+inline std::size_t LzPayloadCodec::compress(const void* const input,
+	const std::size_t inputSize,
+	void* const output,
+	const std::size_t outputCapacity)
+{
+	if (++mEpoch == 0) {
+		std::fill(mEpochs.begin(), mEpochs.end(), 0);
+		mEpoch = 1;
+	}
+	const unsigned char* const in = static_cast<const unsigned char*>(input);
+	unsigned char* out = static_cast<unsigned char*>(output);
+	const unsigned char* const outEnd = out + outputCapacity;
+	const std::size_t dictSize = mDictionary.size();
+
+	std::size_t anchor = 0;
+	std::size_t pos = 0;
+	while (pos + cMinMatch <= inputSize) {
+		const std::size_t h = hash(in + pos);
+		std::size_t offset = 0;
+		std::size_t length = 0;
+		if (mEpochs[h] == mEpoch) {
+			const std::size_t candidate = mTable[h];
+			if (pos - candidate <= cMaxOffset) {
+				while (pos + length < inputSize && in[candidate + length] == in[pos + length]) {
+					++length;
+				}
+				offset = pos - candidate;
+			}
+		} else if (mDictTable[h] >= 0) {
+			const std::size_t candidate = static_cast<std::size_t>(mDictTable[h]);
+			if (pos + dictSize - candidate <= cMaxOffset) {
+				while (candidate + length < dictSize && pos + length < inputSize
+					   && mDictionary[candidate + length] == in[pos + length]) {
+					++length;
+				}
+				offset = pos + dictSize - candidate;
+			}
+		}
+		mTable[h] = static_cast<std::uint32_t>(pos);
+		mEpochs[h] = mEpoch;
+		if (length < cMinMatch) {
+			++pos;
+			continue;
+		}
+		if (!writeSequence(in + anchor, pos - anchor, offset, length, out, outEnd)) {
+			return 0;
+		}
+		pos += length;
+		anchor = pos;
+	}
+	if (!writeSequence(in + anchor, inputSize - anchor, 0, 0, out, outEnd)) {
+		return 0;
+	}
+	return static_cast<std::size_t>(out - static_cast<unsigned char*>(output));
+}
+
+inline bool LzPayloadCodec::decompress(const void* const input,
+	const std::size_t inputSize,
+	void* const output,
+	const std::size_t outputSize)
+{
+	const unsigned char* in = static_cast<const unsigned char*>(input);
+	const unsigned char* const inEnd = in + inputSize;
+	unsigned char* const out = static_cast<unsigned char*>(output);
+	std::size_t pos = 0;
+	const std::size_t dictSize = mDictionary.size();
+
+	while (in != inEnd) {
+		const unsigned char token = *in++;
+		std::size_t literalLength = token >> 4;
+		if (!readLength(literalLength, in, inEnd)
+			|| static_cast<std::size_t>(inEnd - in) < literalLength
+			|| outputSize - pos < literalLength) {
+			return false;
+		}
+		std::memcpy(out + pos, in, literalLength);
+		in += literalLength;
+		pos += literalLength;
+		if (in == inEnd) {
+			break;
+		}
+
+		if (inEnd - in < 2) {
+			return false;
+		}
+		const std::size_t offset = in[0] | static_cast<std::size_t>(in[1]) << 8;
+		in += 2;
+		std::size_t matchLength = token & 0x0f;
+		if (!readLength(matchLength, in, inEnd)) {
+			return false;
+		}
+		matchLength += cMinMatch;
+		if (offset == 0 || offset > pos + dictSize || outputSize - pos < matchLength) {
+			return false;
+		}
+		// Byte by byte, since a back-reference may overlap its own output.
+		for (std::size_t i = 0; i < matchLength; ++i, ++pos) {
+			out[pos] = offset > pos ? mDictionary[dictSize - (offset - pos)] : out[pos - offset];
+		}
+	}
+	return pos == outputSize;
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -110,7 +110,8 @@ public:
 	 * buffer size (as returned by the first call), potentially doubling the
 	 * serialization cost in some edge cases if implemented naively. Some caching
 	 * mechanism, guided by the extensionality assumption above and the
-	 * no-payload-reuse guarantee, might prove helpful in mitigating that.
+	 * no-payload-reuse guarantee, might prove helpful in mitigating that, as
+	 * might `sizeHint()` for types whose payload size is cheap to compute.
 	 *
 	 * @param[in] val Payload to serialize. Each value of type T is treated as a
 	 * valid payload and is expected to undergo serialization without errors
@@ -148,6 +149,166 @@ public:
 	 */
 	virtual bool fromBytes(
 		T& oVar, const void* payloadBuffer, std::size_t payloadSize) = 0;
+
+	/**
+	 * @brief Optional zero-copy serialization method.
+	 *
+	 * Payload types whose values already hold their serialized bytestream in a
+	 * single contiguous block of memory (e.g. strings or binary blobs) can
+	 * override this method to expose that block directly. On success, the
+	 * method should set `oData` and `oSize` to the address and length of the
+	 * bytestream `toBytes()` would produce for `val`, and return `true`. The
+	 * default implementation returns `false`, meaning that the payload has to
+	 * be serialized by `toBytes()`.
+	 *
+	 * When a view is available, `Channel::put()` and `Channel::puta()` send
+	 * sufficiently large payloads straight from the memory block pointed to by
+	 * `oData` to the socket, without copying them to the channel's internal
+	 * buffer, and without the payload size being bound by the channel's memory
+	 * limit. Smaller payloads are copied from the view to the internal buffer.
+	 * The memory block must remain valid and unchanged until the PUT/A call
+	 * returns.
+	 *
+	 * @param[in] val Payload to serialize.
+	 * @param[out] oData Address of the serialized bytestream of `val`.
+	 * @param[out] oSize Length of the serialized bytestream of `val`.
+	 * @return `true` if the view is available, `false` otherwise.
+	 */
+	virtual bool toView(const T& val, const void*& oData, std::size_t& oSize)
+	{
+		(void)val;
+		(void)oData;
+		(void)oSize;
+		return false;
+	}
+
+	/**
+	 * @brief Optional payload size estimation method.
+	 *
+	 * Payload types that can tell the size of the bytestream of `val` more
+	 * cheaply than by serializing it can override this method to do so. On
+	 * success, the method should set `oSize` to the expected payload size and
+	 * return `true`. The default implementation returns `false`, in which case
+	 * the channel predicts the size from the sizes of previously serialized
+	 * payloads.
+	 *
+	 * The hint sizes the memory block passed to the first `toBytes()` call of
+	 * `val`. An exact hint guarantees a single call to `toBytes()` per payload,
+	 * while keeping the channel's buffer densely packed. A hint need not be
+	 * exact: a smaller one causes a second `toBytes()` call with a large
+	 * enough buffer, and a larger one might make the channel send its buffer
+	 * earlier than necessary.
+	 *
+	 * @param[in] val Payload to serialize.
+	 * @param[out] oSize Expected length of the serialized bytestream of `val`.
+	 * @return `true` if the hint is available, `false` otherwise.
+	 */
+	virtual bool sizeHint(const T& val, std::size_t& oSize)
+	{
+		(void)val;
+		(void)oSize;
+		return false;
+	}
+
+	/**
+	 * @brief Optional capability of chunked serialization and
+	 * deserialization.
+	 *
+	 * Payload types which can deserialize a payload piece by piece, e.g. by
+	 * appending to a container or writing to a file, and serialize any piece
+	 * of it, can override this method to return `true`, along with
+	 * `beginChunked()`, `appendChunk()`, `finishChunked()` and `toChunk()`.
+	 * The default implementation returns `false`.
+	 *
+	 * A record which doesn't fit in the receive buffer of a channel makes
+	 * `Channel::get()` and `Channel::getStream()` fail with
+	 * `result_t::MEMORY_LIMIT_EXCEEDED`. With a chunked payload type, its
+	 * payload is passed on in chunks of the buffer instead, so that payloads
+	 * of up to 32 MiB don't need a buffer as large. Records which fit are
+	 * still deserialized by `fromBytes()`.
+	 *
+	 * Likewise, `Channel::put()` and `Channel::puta()` send a payload which
+	 * doesn't fit in the send buffer in chunks serialized by `toChunk()`,
+	 * provided `sizeHint()` or `toBytes()` tells its size. Records which fit
+	 * are still serialized by `toBytes()`.
+	 *
+	 * @return `true` if the chunked serialization and deserialization are
+	 * available, `false` otherwise.
+	 */
+	virtual bool chunked() const { return false; }
+
+	/**
+	 * @brief Starts the chunked deserialization of a payload.
+	 *
+	 * Followed by calls to `appendChunk()` with consecutive chunks of the
+	 * payload, then by a call to `finishChunked()`, unless one of them fails.
+	 * The initial value of `oVar` is a default-constructed instance of type
+	 * `T`, as in `fromBytes()`.
+	 *
+	 * @param[out] oVar A reference to the variable the payload is
+	 * deserialized into.
+	 * @param[in] payloadSize The size of the whole payload.
+	 * @return `true` on success, `false` otherwise.
+	 */
+	virtual bool beginChunked(T& oVar, std::size_t payloadSize)
+	{
+		(void)oVar;
+		(void)payloadSize;
+		return false;
+	}
+
+	/**
+	 * @brief Deserializes the next chunk of a payload.
+	 *
+	 * @param[in,out] oVar The variable passed to `beginChunked()`.
+	 * @param[in] chunk A buffer containing the chunk, valid only for the
+	 * duration of the call.
+	 * @param[in] chunkSize The length of the chunk, never `0`.
+	 * @return `true` on success, `false` otherwise.
+	 */
+	virtual bool appendChunk(T& oVar, const void* chunk, std::size_t chunkSize)
+	{
+		(void)oVar;
+		(void)chunk;
+		(void)chunkSize;
+		return false;
+	}
+
+	/**
+	 * @brief Completes the chunked deserialization of a payload, once all of
+	 * its chunks have been passed to `appendChunk()`.
+	 *
+	 * @param[in,out] oVar The variable passed to `beginChunked()`.
+	 * @return `true` on success, `false` otherwise.
+	 */
+	virtual bool finishChunked(T& oVar)
+	{
+		(void)oVar;
+		return true;
+	}
+
+	/**
+	 * @brief Serializes a chunk of a payload.
+	 *
+	 * Called with consecutive chunks of the bytestream `toBytes()` would
+	 * produce for `val`, whose size is known beforehand. As with `toBytes()`,
+	 * each value of type T is expected to undergo serialization without
+	 * errors. The default implementation serializes nothing.
+	 *
+	 * @param[in] val Payload to serialize.
+	 * @param[in] offset The offset of the chunk in the bytestream.
+	 * @param[out] outputBuffer Address of the output buffer of size
+	 * `chunkSize`.
+	 * @param[in] chunkSize The length of the chunk, never `0`.
+	 */
+	virtual void toChunk(
+		const T& val, std::size_t offset, void* outputBuffer, std::size_t chunkSize)
+	{
+		(void)val;
+		(void)offset;
+		(void)outputBuffer;
+		(void)chunkSize;
+	}
 };
 
 } /*namespace tstorage*/
@@ -0,0 +1,195 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutAggregator.h
+ *   A lock-free front end merging the records of many threads into PUTs.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTAGGREGATOR_H
+#define D_TSTORAGE_PUTAGGREGATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <thread>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "RecordsSet.h"
+#include "Response.h"
+
+/** @file
+ * @brief Defines the `PutAggregator<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A front end collecting records from many threads and storing them
+ * with large PUT requests over a single channel.
+ *
+ * Threads producing small bursts of records would otherwise need a channel
+ * each, and would send a PUT command per burst. Instead, they `append()` the
+ * records to the aggregator's queue, a bounded lock-free ring buffer, at the
+ * cost of a single atomic compare-and-swap per record. A sender thread of the
+ * aggregator drains the queue once per linger time, or right away on
+ * `flush()`, and stores the drained records with one `Channel<T>::put()`,
+ * grouped by CID (see `Channel<T>::setPutCidGrouping()`). Producers never
+ * wait for the network: if the queue is full, `append()` fails instead.
+ *
+ * The channel must be connected beforehand, must outlive the aggregator and
+ * must not be used by other threads until the aggregator is closed. The
+ * aggregator enables CID grouping on the channel while it is open, and
+ * `close()` restores the channel's previous setting. A failed PUT drops its
+ * records; the status of the first failure is kept and reported by
+ * `close()`. Reconnecting after failures can be enabled with the
+ * channel's retry policy (see `Channel<T>::setRetryPolicy()`).
+ *
+ * Programs using this class have to be linked with `-pthread`.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class PutAggregator final
+{
+public:
+	/**
+	 * @brief Starts the sender thread of a connected channel.
+	 *
+	 * @param channel The channel storing the records.
+	 * @param capacity The amount of records the queue holds, rounded up to a
+	 * power of two.
+	 * @param linger The longest time a record waits in the queue.
+	 */
+	PutAggregator(Channel<T>& channel,
+		std::size_t capacity,
+		std::chrono::duration<std::int64_t, std::milli> linger = std::chrono::milliseconds(5));
+	/**
+	 * @brief Closes the aggregator.
+	 * @see close()
+	 */
+	~PutAggregator() { (void)close(); }
+
+	PutAggregator(const PutAggregator&) = delete;
+	PutAggregator(PutAggregator&&) = delete;
+	PutAggregator& operator=(const PutAggregator&) = delete;
+	PutAggregator& operator=(PutAggregator&&) = delete;
+
+	/**
+	 * @brief Queues a record for storing. Safe to call from many threads at
+	 * once.
+	 *
+	 * @param record A valid record to store in the TStorage instance.
+	 * @return `true` if the record has been queued, `false` if the queue is
+	 * full or the aggregator is closed.
+	 */
+	bool append(const Record<T>& record);
+	/** @brief Wakes up the sender thread to store the queued records right
+	 * away. */
+	void flush();
+	/**
+	 * @brief Stores the queued records, stops the sender thread and restores
+	 * the CID grouping setting of the channel.
+	 *
+	 * May be called concurrently with `append()`: the records it accepts are
+	 * stored, as `close()` waits for the calls in progress before draining the
+	 * queue for the last time. Subsequent calls return the same status.
+	 *
+	 * @return A `Response` with the status code of the first failed PUT, or a
+	 * success code if all records have been stored.
+	 */
+	Response close();
+
+	/** @brief Returns the amount of records stored so far. */
+	std::uint64_t stored() const { return mStored.load(std::memory_order_relaxed); }
+	/** @brief Returns the amount of records dropped by failed PUTs so far. */
+	std::uint64_t dropped() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+	/**
+	 * @brief A slot of the queue.
+	 *
+	 * The sequence number tells the state of the slot at queue position `pos`:
+	 * `pos` if the slot is free for the producer of `pos`, `pos + 1` if it
+	 * holds the record for the consumer.
+	 */
+	struct Slot
+	{
+		/** @brief The sequence number of the slot. */
+		std::atomic<std::size_t> sequence;
+		/** @brief The queued record. */
+		Record<T> record;
+	};
+
+	/** @brief Claims a slot of the queue and commits `record` to it.
+	 * @return `false` if the queue is full. */
+	bool enqueue(const Record<T>& record);
+	/** @brief Moves the queued records to `mBatch`. Called by the sender
+	 * thread only. */
+	void drain();
+	/** @brief The main loop of the sender thread. */
+	void sendLoop();
+
+	/** @brief The channel storing the records. */
+	Channel<T>& mChannel;
+	/** @brief The CID grouping setting of the channel, restored on close. */
+	bool mChannelGrouping;
+	/** @brief The queue slots. */
+	std::unique_ptr<Slot[]> mSlots;
+	/** @brief The queue capacity less one, a mask of slot indices. */
+	std::size_t mMask;
+	/** @brief The queue position of the next appended record. */
+	std::atomic<std::size_t> mEnqueuePos;
+	/** @brief The queue position of the next drained record. */
+	std::size_t mDequeuePos;
+	/** @brief The records of the next PUT, used by the sender thread. */
+	RecordsSet<T> mBatch;
+	/** @brief The longest time a record waits in the queue. */
+	std::chrono::duration<std::int64_t, std::milli> mLinger;
+
+	/** @brief The amount of records stored. */
+	std::atomic<std::uint64_t> mStored;
+	/** @brief The amount of records dropped. */
+	std::atomic<std::uint64_t> mDropped;
+	/** @brief The status of the first failed PUT. */
+	result_t mStatus;
+
+	/** @brief The amount of `append()` calls in progress. */
+	std::atomic<std::size_t> mAppenders;
+	/** @brief `true` once no more records are accepted. */
+	std::atomic<bool> mClosed;
+	/** @brief `true` when the sender thread is requested to send right away. */
+	bool mFlush;
+	/** @brief `true` when the sender thread is requested to exit. */
+	bool mStop;
+	/** @brief Guards `mFlush`, `mStop` and `mStatus`. */
+	std::mutex mMutex;
+	/** @brief Wakes up the sender thread. */
+	std::condition_variable mWakeUp;
+	/** @brief The sender thread. */
+	std::thread mSender;
+};
+
+} /*namespace tstorage*/
+
+#include "PutAggregator.tpp"
+
+#endif
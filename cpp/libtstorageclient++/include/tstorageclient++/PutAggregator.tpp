@@ -0,0 +1,196 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutAggregator.tpp
+ *   An implementation of the `PutAggregator<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTAGGREGATOR_TPP
+#define D_TSTORAGE_PUTAGGREGATOR_TPP
+
+#ifndef D_TSTORAGE_PUTAGGREGATOR_H
+#error __FILE__ was included from outside of "PutAggregator.h"
+#include "PutAggregator.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <thread>
+#include <utility>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "RecordsSet.h"
+#include "Response.h"
+
+/** @file
+ * @brief Contains the implementation of `PutAggregator<T>`. */
+
+namespace tstorage {
+
+template<typename T>
+PutAggregator<T>::PutAggregator(Channel<T>& channel,
+	const std::size_t capacity,
+	const std::chrono::duration<std::int64_t, std::milli> linger)
+	: mChannel(channel)
+	, mChannelGrouping(channel.putCidGrouping())
+	, mMask(1)
+	, mEnqueuePos(0)
+	, mDequeuePos(0)
+	, mLinger(linger)
+	, mStored(0)
+	, mDropped(0)
+	, mStatus(result_t::OK)
+	, mAppenders(0)
+	, mClosed(false)
+	, mFlush(false)
+	, mStop(false)
+{
+	while (mMask + 1 < capacity) {
+		mMask = mMask * 2 + 1;
+	}
+	mSlots = std::make_unique<Slot[]>(mMask + 1);
+	for (std::size_t i = 0; i <= mMask; ++i) {
+		mSlots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	mChannel.setPutCidGrouping(true);
+	mSender = std::thread([this]() { sendLoop(); });
+}
+
+template<typename T>
+bool PutAggregator<T>::append(const Record<T>& record)
+{
+	// Announced before checking `mClosed`, and `close()` stores `mClosed`
+	// before waiting for the announced appenders: one of the two sequentially
+	// consistent accesses sees the other, so that an accepted record is
+	// committed before the queue is drained for the last time.
+	mAppenders.fetch_add(1, std::memory_order_seq_cst);
+	const bool queued = !mClosed.load(std::memory_order_seq_cst) && enqueue(record);
+	mAppenders.fetch_sub(1, std::memory_order_release);
+	return queued;
+}
+
+template<typename T>
+bool PutAggregator<T>::enqueue(const Record<T>& record)
+{
+	std::size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+	Slot* slot = nullptr;
+	while (true) {
+		slot = &mSlots[pos & mMask];
+		const std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(
+			slot->sequence.load(std::memory_order_acquire) - pos);
+		if (lag == 0) {
+			if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (lag < 0) {
+			// The slot still holds the record from the previous lap.
+			return false;
+		} else {
+			pos = mEnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+	slot->record = record;
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T>
+void PutAggregator<T>::flush()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFlush = true;
+	}
+	mWakeUp.notify_one();
+}
+
+template<typename T>
+Response PutAggregator<T>::close()
+{
+	mClosed.store(true, std::memory_order_seq_cst);
+	while (mAppenders.load(std::memory_order_acquire) != 0) {
+		std::this_thread::yield();
+	}
+	if (mSender.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+		mWakeUp.notify_one();
+		mSender.join();
+		mChannel.setPutCidGrouping(mChannelGrouping);
+	}
+	std::lock_guard<std::mutex> lock(mMutex);
+	return Response(mStatus);
+}
+
+template<typename T>
+void PutAggregator<T>::drain()
+{
+	while (true) {
+		Slot& slot = mSlots[mDequeuePos & mMask];
+		if (slot.sequence.load(std::memory_order_acquire) != mDequeuePos + 1) {
+			return;
+		}
+		mBatch.append(std::move(slot.record));
+		slot.sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+		++mDequeuePos;
+	}
+}
+
+template<typename T>
+void PutAggregator<T>::sendLoop()
+{
+	bool stop = false;
+	while (true) {
+		drain();
+		if (mBatch.size() != 0) {
+			const Response res = mChannel.put(mBatch);
+			if (res.success()) {
+				mStored.fetch_add(mBatch.size(), std::memory_order_relaxed);
+			} else {
+				mDropped.fetch_add(mBatch.size(), std::memory_order_relaxed);
+				std::lock_guard<std::mutex> lock(mMutex);
+				if (mStatus == result_t::OK) {
+					mStatus = res.status();
+				}
+			}
+			mBatch.clear();
+			continue;
+		}
+		// The queue is empty; exit only once it has been drained after the
+		// stop request, so that no record appended before `close()` is lost.
+		if (stop) {
+			return;
+		}
+		std::unique_lock<std::mutex> lock(mMutex);
+		mWakeUp.wait_for(lock, mLinger, [this]() { return mFlush || mStop; });
+		mFlush = false;
+		stop = mStop;
+	}
+}
+
+} /*namespace tstorage*/
+
+#endif
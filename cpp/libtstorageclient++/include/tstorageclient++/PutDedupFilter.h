@@ -0,0 +1,142 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutDedupFilter.h
+ *   A definition of a filter of PUTA records already acknowledged.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTDEDUPFILTER_H
+#define D_TSTORAGE_PUTDEDUPFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines the `PutDedupFilter` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A bounded set of the PUTA records acknowledged by the server, which
+ * lets replays of a `puta()` skip them.
+ *
+ * A record is identified by a 64-bit fingerprint of its key, ACQ included,
+ * and serialized payload. A channel with a filter (see
+ * `Channel::setPutDedupFilter()`) skips the records of a PUTA whose
+ * fingerprints the filter holds, and adds the fingerprints of the records it
+ * sent once their command has been acknowledged.
+ *
+ * The set is exact up to fingerprint collisions, which are unlikely below
+ * billions of records: a record is skipped only if one with the same
+ * fingerprint has been stored. Once it holds `capacity()` fingerprints, the
+ * oldest are forgotten, so that a record acknowledged long ago may be sent
+ * again, which is the failure a missing filter would cause anyway. Each
+ * fingerprint takes some 40 bytes of memory.
+ *
+ * The fingerprints may be saved to a file and loaded back, e.g. next to the
+ * state of a backfill job, so that a job restarted after a crash skips what
+ * it has stored. Shared by the channels through a `std::shared_ptr`; all
+ * methods are thread-safe.
+ */
+class PutDedupFilter final
+{
+public:
+	/** @brief The default amount of fingerprints held. */
+	static constexpr std::size_t cDefaultCapacity = 1024UL * 1024;
+
+	/**
+	 * @brief Constructs an empty filter.
+	 * @param capacity The amount of fingerprints held, at least 1.
+	 */
+	explicit PutDedupFilter(std::size_t capacity = cDefaultCapacity);
+
+	PutDedupFilter(const PutDedupFilter&) = delete;
+	PutDedupFilter(PutDedupFilter&&) = delete;
+	PutDedupFilter& operator=(const PutDedupFilter&) = delete;
+	PutDedupFilter& operator=(PutDedupFilter&&) = delete;
+
+	/**
+	 * @brief Returns the fingerprint of a record.
+	 * @param key The key of the record.
+	 * @param payload The serialized payload.
+	 * @param size The size of the payload in bytes.
+	 */
+	static std::uint64_t fingerprint(const Key& key, const void* payload, std::size_t size);
+
+	/** @brief Returns `true` if the filter holds `fingerprint`. */
+	bool contains(std::uint64_t fingerprint) const;
+	/**
+	 * @brief Adds fingerprints, forgetting the oldest ones beyond the
+	 * capacity. Fingerprints held already are not added again.
+	 * @param fingerprints The fingerprints to add.
+	 */
+	void insert(const std::vector<std::uint64_t>& fingerprints);
+	/** @brief Forgets all fingerprints. */
+	void clear();
+
+	/** @brief Returns the amount of fingerprints held. */
+	std::size_t size() const;
+	/** @brief Returns the amount of fingerprints the filter may hold. */
+	std::size_t capacity() const { return mCapacity; }
+
+	/**
+	 * @brief Writes the fingerprints to a file, replacing it atomically.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::FILE_ERROR` if the file cannot be written.
+	 *
+	 * @param path The path of the file.
+	 * @return Status code.
+	 */
+	result_t save(const std::string& path) const;
+	/**
+	 * @brief Adds the fingerprints of a file written by `save()`. A missing
+	 * file adds none.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::FILE_ERROR` if the file cannot be read or is not one of a
+	 *    filter.
+	 *
+	 * @param path The path of the file.
+	 * @return Status code.
+	 */
+	result_t load(const std::string& path);
+
+private:
+	/** @brief Adds `fingerprint`. Called with `mMutex` held. */
+	void insertLocked(std::uint64_t fingerprint);
+
+	/** @brief The amount of fingerprints held at most. */
+	const std::size_t mCapacity;
+	/** @brief The fingerprints held. */
+	std::unordered_set<std::uint64_t> mSet;
+	/** @brief The fingerprints held, oldest first. */
+	std::deque<std::uint64_t> mOrder;
+	/** @brief Guards `mSet` and `mOrder`. */
+	mutable std::mutex mMutex;
+};
+
+} /*namespace tstorage*/
+
+#endif
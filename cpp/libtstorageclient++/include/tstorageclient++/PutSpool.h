@@ -0,0 +1,218 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutSpool.h
+ *   A definition of a PUT front end spooling records to disk during outages.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTSPOOL_H
+#define D_TSTORAGE_PUTSPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "SpoolLog.h"
+
+/** @file
+ * @brief Defines the `PutSpool<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A PUT front end which keeps accepting records while the TStorage
+ * instance is unreachable, storing them in a write-ahead log on disk until
+ * it is back.
+ *
+ * `put()` stores the records over a channel of its own, like
+ * `Channel<T>::put()`. When the request fails because the server cannot be
+ * reached or the connection breaks (`result_t::CONNERROR`,
+ * `result_t::CONNREFUSED`, `result_t::BAD_ADDRESS`,
+ * `result_t::NOT_CONNECTED`, `result_t::SOCKET_ERROR`,
+ * `result_t::CONNRESET`, `result_t::CONNCLOSED` or
+ * `result_t::CONNTIMEOUT`), the spool switches to spooling: the records of
+ * the failed request and of all subsequent ones are serialized and appended
+ * to a `SpoolLog`, a sequential copy into a memory-mapped file, and `put()`
+ * succeeds without touching the network. A replay thread reconnects a
+ * second channel once per replay interval (see `setReplayInterval()`) and
+ * stores the log a segment at a time, oldest first, with
+ * `Channel<T>::putRaw()`, removing each segment once stored. When the log
+ * is drained, `put()` goes back to storing the records directly.
+ *
+ * The delivery is at-least-once: the records of a failed request which the
+ * server had stored before the failure, and those of a segment whose
+ * replay failed midway, are stored again. Segments left in the directory by
+ * a previous spool, e.g. one of a crashed process, are replayed by `open()`.
+ *
+ * `put()` must be called from one thread at a time. All channels share a
+ * single `PayloadType<T>` instance, used by `put()` only.
+ *
+ * Programs using this class have to be linked with `-pthread`.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class PutSpool final
+{
+public:
+	/**
+	 * @brief Constructs a spool, connecting nothing yet.
+	 *
+	 * @param hostname Hostname of the target TStorage server.
+	 * @param port Port under which the TStorage server accepts connections.
+	 * @param payloadType The payload type of the records.
+	 * @param directory An existing directory to keep the log in, used by no
+	 * other spool.
+	 * @param segmentSize The size of a segment of the log, and thus the
+	 * amount of records replayed with one PUT.
+	 */
+	PutSpool(const std::string& hostname,
+		std::uint16_t port,
+		std::shared_ptr<PayloadType<T>> payloadType,
+		const std::string& directory,
+		std::size_t segmentSize = SpoolLog::cDefaultSegmentSize);
+	/**
+	 * @brief Closes the spool.
+	 * @see close()
+	 */
+	~PutSpool() { close(); }
+
+	PutSpool(const PutSpool&) = delete;
+	PutSpool(PutSpool&&) = delete;
+	PutSpool& operator=(const PutSpool&) = delete;
+	PutSpool& operator=(PutSpool&&) = delete;
+
+	/**
+	 * @brief Opens the log, starting to replay the records found in it, and
+	 * starts the replay thread. Opening an open spool does nothing.
+	 *
+	 * The server need not be reachable.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::SPOOL_ERROR` if the log cannot be opened.
+	 *
+	 * @return A `Response` with a status code.
+	 */
+	Response open();
+	/**
+	 * @brief Stops the replay thread and closes the channels. The records
+	 * not replayed yet stay in the log, to be replayed by the next `open()`.
+	 */
+	void close();
+
+	/**
+	 * @brief Stores the records, or appends them to the log if the server
+	 * is unreachable or the log is being replayed.
+	 *
+	 * The records are validated as by `Channel<T>::put()`, also when
+	 * spooled, so that the log only holds records the server accepts.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::NOT_CONNECTED` if the spool is not open,
+	 *  - `result_t::INVALID_KEY`, `result_t::PAYLOAD_TOO_LARGE`, in which case
+	 *    the records preceding the invalid one have been stored or spooled,
+	 *  - `result_t::SPOOL_ERROR` if the log cannot be appended to,
+	 *  - the errors of `Channel<T>::put()` not caused by an outage.
+	 *
+	 * @param data The records to store.
+	 * @return A `Response` with a status code.
+	 */
+	Response put(const RecordsSet<T>& data);
+
+	/**
+	 * @brief Sets the delay between the attempts to replay the log while
+	 * the server is unreachable. Defaults to 1000 ms.
+	 */
+	void setReplayInterval(std::chrono::duration<std::int64_t, std::milli> interval);
+
+	/** @brief Returns `true` while the records are being spooled. */
+	bool spooling() const { return mSpooling.load(std::memory_order_acquire); }
+	/** @brief Returns the size of the records in the log, in bytes. */
+	std::uint64_t spooledBytes() const { return mLog.bytes(); }
+
+private:
+	/** @brief The default delay between the attempts to replay the log. */
+	static constexpr std::int64_t cDefaultReplayIntervalMs = 1000;
+	/** @brief The largest payload the server accepts. */
+	static constexpr std::size_t cMaxPayloadSize = 32UL * 1024 * 1024;  // 32 MiB
+	/** @brief The initial size of the buffer of serialized payloads. */
+	static constexpr std::size_t cInitialPayloadSize = 4096;
+
+	/** @brief Returns `true` if `status` tells that the server is
+	 * unreachable. */
+	static bool isOutage(result_t status);
+	/** @brief Validates the records and appends them to the log. Called
+	 * with `mMutex` held. */
+	result_t spool(const RecordsSet<T>& data);
+	/**
+	 * @brief Stores the oldest segment of the log.
+	 * @return `true` if the segment has been stored or dropped, `false` if
+	 * the server is unreachable.
+	 */
+	bool replayFront();
+	/** @brief The main loop of the replay thread. */
+	void replayLoop();
+
+	/** @brief The payload type, used by `put()`. */
+	std::shared_ptr<PayloadType<T>> mPayloadType;
+	/** @brief The channel of `put()`. */
+	Channel<T> mChannel;
+	/** @brief The channel of the replay thread. */
+	Channel<T> mReplayChannel;
+	/** @brief The log of spooled records. */
+	SpoolLog mLog;
+	/** @brief The serialized payload of the record being spooled. */
+	std::vector<unsigned char> mPayload;
+	/** @brief The records of the segment being replayed. */
+	std::vector<RawRecord> mReplayed;
+	/** @brief The delay between the attempts to replay the log. */
+	std::chrono::duration<std::int64_t, std::milli> mReplayInterval;
+
+	/** @brief `true` while the records are being spooled. Written with
+	 * `mMutex` held. */
+	std::atomic<bool> mSpooling;
+	/** @brief `true` when the replay thread is requested to exit. */
+	bool mStop;
+	/** @brief `true` between `open()` and `close()`. */
+	bool mOpen;
+	/** @brief Guards `mSpooling`, `mStop` and the transition between
+	 * storing and spooling. */
+	std::mutex mMutex;
+	/** @brief Wakes up the replay thread. */
+	std::condition_variable mWakeUp;
+	/** @brief The replay thread. */
+	std::thread mReplayer;
+};
+
+} /*namespace tstorage*/
+
+#include "PutSpool.tpp"
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutSpool.tpp
+ *   An implementation of the `PutSpool<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTSPOOL_TPP
+#define D_TSTORAGE_PUTSPOOL_TPP
+
+#ifndef D_TSTORAGE_PUTSPOOL_H
+#error __FILE__ was included from outside of "PutSpool.h"
+#include "PutSpool.h"  // clangd integration
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "SharedPayloadType.h"
+#include "SpoolLog.h"
+
+/** @file
+ * @brief Contains the implementation of `PutSpool<T>`. */
+
+namespace tstorage {
+
+template<typename T>
+constexpr std::int64_t PutSpool<T>::cDefaultReplayIntervalMs;
+template<typename T>
+constexpr std::size_t PutSpool<T>::cMaxPayloadSize;
+template<typename T>
+constexpr std::size_t PutSpool<T>::cInitialPayloadSize;
+
+template<typename T>
+PutSpool<T>::PutSpool(const std::string& hostname,
+	const std::uint16_t port,
+	std::shared_ptr<PayloadType<T>> payloadType,
+	const std::string& directory,
+	const std::size_t segmentSize)
+	: mPayloadType(payloadType)
+	, mChannel(hostname, port, std::make_unique<SharedPayloadType<T>>(payloadType))
+	, mReplayChannel(hostname, port, std::make_unique<SharedPayloadType<T>>(payloadType))
+	, mLog(directory, segmentSize)
+	, mPayload(cInitialPayloadSize)
+	, mReplayInterval(cDefaultReplayIntervalMs)
+	, mSpooling(false)
+	, mStop(false)
+	, mOpen(false)
+{
+}
+
+template<typename T>
+Response PutSpool<T>::open()
+{
+	if (mOpen) {
+		return Response(result_t::OK);
+	}
+	const result_t res = mLog.open();
+	if (res != result_t::OK) {
+		return Response(res);
+	}
+	mStop = false;
+	mSpooling.store(!mLog.empty(), std::memory_order_release);
+	mReplayer = std::thread([this]() { replayLoop(); });
+	mOpen = true;
+	return Response(result_t::OK);
+}
+
+template<typename T>
+void PutSpool<T>::close()
+{
+	if (!mOpen) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWakeUp.notify_one();
+	mReplayer.join();
+	(void)mChannel.close();
+	(void)mReplayChannel.close();
+	mOpen = false;
+}
+
+template<typename T>
+Response PutSpool<T>::put(const RecordsSet<T>& data)
+{
+	if (!mOpen) {
+		return Response(result_t::NOT_CONNECTED);
+	}
+	// Only the replay thread turns spooling off, hence the records are
+	// stored directly only if no spooled records precede them.
+	if (!mSpooling.load(std::memory_order_acquire)) {
+		Response res = mChannel.connected() ? Response(result_t::OK) : mChannel.connect();
+		if (res.success()) {
+			res = mChannel.put(data);
+		}
+		if (!isOutage(res.status())) {
+			return res;
+		}
+		(void)mChannel.close();
+	}
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	const result_t res = spool(data);
+	if (!mSpooling.load(std::memory_order_relaxed) && !mLog.empty()) {
+		mSpooling.store(true, std::memory_order_release);
+		mWakeUp.notify_one();
+	}
+	return Response(res);
+}
+
+template<typename T>
+void PutSpool<T>::setReplayInterval(const std::chrono::duration<std::int64_t, std::milli> interval)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mReplayInterval = interval;
+}
+
+template<typename T>
+bool PutSpool<T>::isOutage(const result_t status)
+{
+	switch (status) {
+		case result_t::CONNERROR:
+		case result_t::CONNREFUSED:
+		case result_t::BAD_ADDRESS:
+		case result_t::NOT_CONNECTED:
+		case result_t::SOCKET_ERROR:
+		case result_t::CONNRESET:
+		case result_t::CONNCLOSED:
+		case result_t::CONNTIMEOUT:
+			return true;
+		default:
+			return false;
+	}
+}
+
+template<typename T>
+result_t PutSpool<T>::spool(const RecordsSet<T>& data)
+{
+	for (const Record<T>& record : data) {
+		// Checked here, as a record rejected on replay would be dropped
+		// along with the rest of its segment.
+		if (!record.key.isStorable(false)) {
+			return result_t::INVALID_KEY;
+		}
+		const void* payload = nullptr;
+		std::size_t size = 0;
+		if (!mPayloadType->toView(record.value, payload, size)) {
+			size = mPayloadType->toBytes(record.value, mPayload.data(), mPayload.size());
+			if (size > mPayload.size()) {
+				mPayload.resize(size);
+				size = mPayloadType->toBytes(record.value, mPayload.data(), mPayload.size());
+			}
+			payload = mPayload.data();
+		}
+		if (size > cMaxPayloadSize) {
+			return result_t::PAYLOAD_TOO_LARGE;
+		}
+		const result_t res = mLog.append(record.key, payload, size);
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	return result_t::OK;
+}
+
+template<typename T>
+bool PutSpool<T>::replayFront()
+{
+	if (!mReplayChannel.connected() && !mReplayChannel.connect().success()) {
+		return false;
+	}
+	if (mLog.front(mReplayed) != result_t::OK) {
+		// A corrupt segment would stop the replay for good.
+		mLog.popFront();
+		return true;
+	}
+	if (mReplayed.empty()) {
+		return true;
+	}
+	const Response res = mReplayChannel.putRaw(mReplayed.cbegin(), mReplayed.cend());
+	if (isOutage(res.status())) {
+		(void)mReplayChannel.close();
+		return false;
+	}
+	// Stored, or rejected by the server, in which case retrying would stop
+	// the replay for good as well.
+	mLog.popFront();
+	return true;
+}
+
+template<typename T>
+void PutSpool<T>::replayLoop()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mStop) {
+		if (!mSpooling.load(std::memory_order_relaxed)) {
+			mWakeUp.wait(
+				lock, [this]() { return mStop || mSpooling.load(std::memory_order_relaxed); });
+			continue;
+		}
+		lock.unlock();
+		const bool replayed = replayFront();
+		lock.lock();
+		// Checked with `mMutex` held, so that no record is spooled in the
+		// meantime and left behind.
+		if (mLog.empty()) {
+			mSpooling.store(false, std::memory_order_release);
+		} else if (!replayed) {
+			mWakeUp.wait_for(lock, mReplayInterval, [this]() { return mStop; });
+		}
+	}
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutStream.h
+ *   A definition of a long-lived PUT/A request handle of `Channel<T>`.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTSTREAM_H
+#define D_TSTORAGE_PUTSTREAM_H
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+#include "DataTypes.h"
+#include "Response.h"
+
+/** @file
+ * @brief Defines the `PutStream<T>` class. */
+
+namespace tstorage {
+
+template<typename T>
+class Channel;
+
+/**
+ * @brief A PUT/A request kept open across many `append()` calls.
+ *
+ * Created by `Channel<T>::putStream()` or `Channel<T>::putaStream()`. Unlike
+ * `Channel<T>::put()`, which sends a complete PUT/A command per call, the
+ * stream sends the command header once and then appends records to the same
+ * command until `finish()` is called. The records are buffered by the channel
+ * and sent to the server whenever the channel's buffer fills up (see
+ * `Channel<T>::setMemoryLimit()`), whenever `flush()` is called, or once the
+ * oldest buffered record has waited for the linger time. The linger time
+ * bounds the latency of a continuous feed of records, while larger values let
+ * more records share a single send.
+ *
+ * The stream has no thread of its own: the linger time is checked by
+ * `append()` and `poll()`. Feeds with long pauses between records should call
+ * `poll()` periodically, or `flush()` after each burst of records.
+ *
+ * The server confirms the stored records and reports the command status only
+ * once `finish()` is called. The destructor calls `finish()` if the stream is
+ * still open, ignoring the result.
+ *
+ * While the stream is open, the channel must not be used for other commands
+ * and must outlive the stream. On error, the stream is closed and the error
+ * code is returned by the failed call and all later calls, while calls made
+ * after a successful `finish()` return `result_t::NOT_CONNECTED`. Errors are
+ * handled as in `Channel<T>::put()`: an invalid record ends the command, with
+ * the records preceding it stored, and closes the channel; any other error
+ * aborts the connection.
+ *
+ * Copying objects of this class is explicitly disallowed.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class PutStream final
+{
+public:
+	/** @brief Finishes the stream if still open. */
+	~PutStream();
+
+	PutStream(const PutStream&) = delete;
+	/** @brief A move constructor, moves the open request to the new instance. */
+	PutStream(PutStream&& other) noexcept;
+	PutStream& operator=(const PutStream&) = delete;
+	/** @brief A move-assignment operator, finishes the request of this
+	 * instance and takes over the open request of the other one. */
+	PutStream& operator=(PutStream&& other) noexcept;
+
+	/**
+	 * @brief Appends a record to the request.
+	 *
+	 * Serializes the record into the channel's buffer, sending the buffer
+	 * first if the record doesn't fit, and flushes the buffered records if the
+	 * linger time has passed. The record itself is not used after the call
+	 * returns.
+	 *
+	 * @param record A valid record to store in the TStorage instance.
+	 * @return A `Response` instance with the status code of the operation.
+	 */
+	Response append(const Record<T>& record);
+	/**
+	 * @brief Sends the buffered records to the server right away.
+	 * @return A `Response` instance with the status code of the operation.
+	 */
+	Response flush();
+	/**
+	 * @brief Sends the buffered records if the oldest of them has waited for
+	 * the linger time.
+	 * @return A `Response` instance with the status code of the operation.
+	 */
+	Response poll();
+	/**
+	 * @brief Ends the request and receives its status from the server.
+	 *
+	 * Closes the stream. The channel can be used for other commands again.
+	 *
+	 * @return A `Response` instance with the status code of the PUT/A command.
+	 */
+	Response finish();
+
+	/** @brief Returns `true` if the request is open, `false` otherwise. */
+	bool open() const { return mChannel != nullptr; }
+
+private:
+	friend class Channel<T>;
+
+	/** @brief A type of the clock measuring the linger time. */
+	using Clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Constructs an open stream on a channel whose PUT/A request header
+	 * has been written, or a closed one if `status` is an error code.
+	 */
+	PutStream(Channel<T>& channel,
+		bool puta,
+		std::chrono::duration<std::int64_t, std::milli> linger,
+		result_t status);
+
+	/** @brief Closes the stream on error, making `res` its sticky status. */
+	Response close(result_t res);
+
+	/** @brief The channel of the request, `nullptr` once closed. */
+	Channel<T>* mChannel;
+	/** @brief `true` for a PUTA request, `false` for a PUT one. */
+	bool mPuta;
+	/** @brief The longest time a record is buffered before being sent. */
+	Clock::duration mLinger;
+	/** @brief The time the oldest buffered record was appended. */
+	Clock::time_point mOldest;
+	/** @brief `true` if some appended records have not been flushed yet. */
+	bool mPending;
+	/** @brief The status returned by calls once the stream is closed. */
+	result_t mStatus;
+};
+
+} /*namespace tstorage*/
+
+#include "PutStream.tpp"
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutStream.tpp
+ *   A long-lived PUT/A request handle of `Channel<T>`.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTSTREAM_TPP
+#define D_TSTORAGE_PUTSTREAM_TPP
+
+#ifndef D_TSTORAGE_PUTSTREAM_H
+#error __FILE__ was included from outside of "PutStream.h"
+#include "PutStream.h"  // clangd integration
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+#include "DataTypes.h"
+#include "Response.h"
+
+namespace tstorage {
+
+template<typename T>
+PutStream<T>::PutStream(Channel<T>& channel,
+	const bool puta,
+	const std::chrono::duration<std::int64_t, std::milli> linger,
+	const result_t status)
+	: mChannel(status == result_t::OK ? &channel : nullptr),
+	  mPuta(puta),
+	  mLinger(std::chrono::duration_cast<Clock::duration>(linger)),
+	  mOldest(),
+	  mPending(false),
+	  mStatus(status)
+{
+}
+
+template<typename T>
+PutStream<T>::~PutStream()
+{
+	if (open()) {
+		(void)finish();
+	}
+}
+
+template<typename T>
+PutStream<T>::PutStream(PutStream&& other) noexcept
+	: mChannel(other.mChannel),
+	  mPuta(other.mPuta),
+	  mLinger(other.mLinger),
+	  mOldest(other.mOldest),
+	  mPending(other.mPending),
+	  mStatus(other.mStatus)
+{
+	other.mChannel = nullptr;
+	other.mStatus = result_t::NOT_CONNECTED;
+}
+
+template<typename T>
+PutStream<T>& PutStream<T>::operator=(PutStream&& other) noexcept
+{
+	if (this != &other) {
+		if (open()) {
+			(void)finish();
+		}
+		mChannel = other.mChannel;
+		mPuta = other.mPuta;
+		mLinger = other.mLinger;
+		mOldest = other.mOldest;
+		mPending = other.mPending;
+		mStatus = other.mStatus;
+		other.mChannel = nullptr;
+		other.mStatus = result_t::NOT_CONNECTED;
+	}
+	return *this;
+}
+
+template<typename T>
+Response PutStream<T>::append(const Record<T>& record)
+{
+	if (!open()) {
+		return Response(mStatus);
+	}
+	const result_t res = mChannel->putStreamAppend(mPuta, record);
+	if (res != result_t::OK) {
+		return close(res);
+	}
+	if (!mPending) {
+		mPending = true;
+		mOldest = Clock::now();
+	}
+	return poll();
+}
+
+template<typename T>
+Response PutStream<T>::flush()
+{
+	if (!open()) {
+		return Response(mStatus);
+	}
+	mPending = false;
+	const result_t res = mChannel->putStreamFlush();
+	if (res != result_t::OK) {
+		return close(res);
+	}
+	return Response(result_t::OK);
+}
+
+template<typename T>
+Response PutStream<T>::poll()
+{
+	if (!open()) {
+		return Response(mStatus);
+	}
+	if (mPending && Clock::now() - mOldest >= mLinger) {
+		return flush();
+	}
+	return Response(result_t::OK);
+}
+
+template<typename T>
+Response PutStream<T>::finish()
+{
+	if (!open()) {
+		return Response(mStatus);
+	}
+	const result_t res = mChannel->putStreamFinish(mPuta);
+	(void)close(res == result_t::OK ? result_t::NOT_CONNECTED : res);
+	return Response(res);
+}
+
+template<typename T>
+Response PutStream<T>::close(const result_t res)
+{
+	mChannel = nullptr;
+	mPending = false;
+	mStatus = res;
+	return Response(res);
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,326 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * RecordsIndex.h
+ *   Secondary indexes over the records of a records set.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_RECORDSINDEX_H
+#define D_TSTORAGE_RECORDSINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DataTypes.h"
+#include "RecordsSet.h"
+
+/** @file
+ * @brief Defines the `RecordsIndex<T>` class. */
+
+namespace tstorage {
+
+/** @brief The identity of a series of records: the key fields but the
+ * timestamps. */
+struct SeriesKey
+{
+	/** @brief The CID of the records. */
+	Key::CidT cid;
+	/** @brief The MID of the records. */
+	Key::MidT mid;
+	/** @brief The MOID of the records. */
+	Key::MoidT moid;
+
+	/** @brief Compares the series field by field. */
+	bool operator==(const SeriesKey& other) const
+	{
+		return cid == other.cid && mid == other.mid && moid == other.moid;
+	}
+	/** @brief Hashes the series. */
+	std::size_t hash() const
+	{
+		std::uint64_t hash = static_cast<std::uint64_t>(mid);
+		hash ^= (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cid)) << 32U)
+			| static_cast<std::uint32_t>(moid);
+		// The finalizer of MurmurHash3.
+		hash ^= hash >> 33U;
+		hash *= 0xFF51AFD7ED558CCDULL;
+		hash ^= hash >> 33U;
+		return static_cast<std::size_t>(hash);
+	}
+};
+
+/**
+ * @brief Indexes the records of a `RecordsSet<T>` by series and CAP.
+ *
+ * The records of each series, i.e. of each `(cid, mid, moid)`, are found in
+ * a hash map in constant time, and a series' records within a CAP window by
+ * a binary search over their positions sorted by CAP. The index refers to
+ * the records by their positions in the set, so it stays valid as long as
+ * the records already indexed are neither removed nor reordered; records
+ * appended to the set later, e.g. by each batch of `Channel::getStream()`,
+ * are indexed by `update()`:
+ *
+ * @code
+ * RecordsSet<float> all;
+ * RecordsIndex<float> index(all);
+ * channel.getStream(keyMin, keyMax, [&](RecordsSet<float>& batch) {
+ *     for (const Record<float>& record : batch) { all.append(record); }
+ *     index.update();
+ * });
+ * for (const std::size_t position : index.window({cid, mid, moid}, capMin, capMax)) { ... }
+ * @endcode
+ *
+ * The index is split into shards by the hash of the series. A set returned
+ * by `get()` is indexed on several threads at once by passing the amount of
+ * shards to the constructor, each thread filling its own shard.
+ *
+ * @tparam T Payload type of the indexed records.
+ * @tparam Alloc The allocator type of the indexed set.
+ */
+template<typename T, typename Alloc = std::allocator<Record<T>>>
+class RecordsIndex
+{
+public:
+	/** @brief An entry of the CAP index of a series. */
+	struct Entry
+	{
+		/** @brief The CAP of the record. */
+		Key::CapT cap;
+		/** @brief The position of the record in the set. */
+		std::size_t position;
+	};
+
+	/**
+	 * @brief The positions of some records of a series, in the order of their
+	 * CAPs. Iterating over it yields the positions.
+	 */
+	class Positions
+	{
+	public:
+		/** @brief Iterates over the positions of the records. */
+		class const_iterator
+		{
+		public:
+			/** @brief Constructs an iterator pointing at an entry. */
+			explicit const_iterator(const Entry* entry) : mEntry(entry) {}
+			/** @brief Returns the position of the record. */
+			std::size_t operator*() const { return mEntry->position; }
+			/** @brief Advances to the next record. */
+			const_iterator& operator++()
+			{
+				++mEntry;
+				return *this;
+			}
+			/** @brief Compares the iterators. */
+			bool operator!=(const const_iterator& other) const { return mEntry != other.mEntry; }
+			/** @brief Compares the iterators. */
+			bool operator==(const const_iterator& other) const { return mEntry == other.mEntry; }
+
+		private:
+			/** @brief The current entry. */
+			const Entry* mEntry;
+		};
+
+		/** @brief Constructs a range of entries. */
+		Positions(const Entry* first, const Entry* last) : mFirst(first), mLast(last) {}
+		/** @brief Returns an iterator pointing at the first position. */
+		const_iterator begin() const { return const_iterator(mFirst); }
+		/** @brief Returns an iterator pointing past the last position. */
+		const_iterator end() const { return const_iterator(mLast); }
+		/** @brief Returns the amount of records. */
+		std::size_t size() const { return static_cast<std::size_t>(mLast - mFirst); }
+		/** @brief Returns `true` if there are no records. */
+		bool empty() const { return mFirst == mLast; }
+
+	private:
+		/** @brief The first entry. */
+		const Entry* mFirst;
+		/** @brief The entry past the last one. */
+		const Entry* mLast;
+	};
+
+	/**
+	 * @brief Indexes the records of a set.
+	 *
+	 * @param records The set to index. Must outlive the index.
+	 * @param shards The amount of shards of the index, each filled on a
+	 * thread of its own. `0` is treated as `1`.
+	 */
+	explicit RecordsIndex(const RecordsSet<T, Alloc>& records, const std::size_t shards = 1)
+		: mRecords(&records), mShards(std::max<std::size_t>(shards, 1)), mIndexed(0)
+	{
+		build();
+	}
+
+	/**
+	 * @brief Indexes the records appended to the set since the index was
+	 * constructed or last updated.
+	 */
+	void update()
+	{
+		const std::size_t first = mIndexed;
+		mIndexed = mRecords->size();
+		// The CAP indexes appended to, with their sizes before.
+		std::vector<std::pair<std::vector<Entry>*, std::size_t>> appended;
+		for (std::size_t i = first; i < mIndexed; ++i) {
+			const Key& key = (*mRecords)[i].key;
+			const SeriesKey series{key.cid, key.mid, key.moid};
+			std::vector<Entry>& entries = mShards[shardOf(series)][series];
+			if (entries.empty() || entries.back().position < first) {
+				appended.emplace_back(&entries, entries.size());
+			}
+			entries.push_back(Entry{key.cap, i});
+		}
+		for (const std::pair<std::vector<Entry>*, std::size_t>& entries : appended) {
+			sortEntries(*entries.first, entries.second);
+		}
+	}
+
+	/**
+	 * @brief Returns the positions of the records of a series, in the order
+	 * of their CAPs, in constant time.
+	 *
+	 * The result is valid until the next `update()`.
+	 */
+	Positions series(const SeriesKey& series) const
+	{
+		const std::vector<Entry>* const entries = find(series);
+		if (entries == nullptr) {
+			return Positions(nullptr, nullptr);
+		}
+		return Positions(entries->data(), entries->data() + entries->size());
+	}
+	/**
+	 * @brief Returns the positions of the records of a series with CAPs in
+	 * `[capMin, capMax)`, in the order of their CAPs, in logarithmic time.
+	 *
+	 * The result is valid until the next `update()`.
+	 */
+	Positions window(const SeriesKey& series, const Key::CapT capMin, const Key::CapT capMax) const
+	{
+		const std::vector<Entry>* const entries = find(series);
+		if (entries == nullptr || !(capMin < capMax)) {
+			return Positions(nullptr, nullptr);
+		}
+		const auto capLess = [](const Entry& entry, const Key::CapT cap) {
+			return entry.cap < cap;
+		};
+		const Entry* const first =
+			std::lower_bound(entries->data(), entries->data() + entries->size(), capMin, capLess);
+		const Entry* const last =
+			std::lower_bound(first, entries->data() + entries->size(), capMax, capLess);
+		return Positions(first, last);
+	}
+
+	/** @brief Returns the amount of distinct series indexed. */
+	std::size_t seriesCount() const
+	{
+		std::size_t count = 0;
+		for (const Shard& shard : mShards) {
+			count += shard.size();
+		}
+		return count;
+	}
+	/** @brief Returns the amount of records indexed. */
+	std::size_t size() const { return mIndexed; }
+
+private:
+	/** @brief Hashes a series for `std::unordered_map`. */
+	struct SeriesHash
+	{
+		/** @brief Returns the hash of `series`. */
+		std::size_t operator()(const SeriesKey& series) const { return series.hash(); }
+	};
+	/** @brief A shard of the index, mapping series to their CAP indexes. */
+	using Shard = std::unordered_map<SeriesKey, std::vector<Entry>, SeriesHash>;
+
+	/** @brief Returns the shard a series belongs to. */
+	std::size_t shardOf(const SeriesKey& series) const
+	{
+		// The high bits, as the low ones pick the buckets inside a shard.
+		return static_cast<std::size_t>((series.hash() >> 32U) % mShards.size());
+	}
+	/** @brief Returns the CAP index of a series, `nullptr` if none. */
+	const std::vector<Entry>* find(const SeriesKey& series) const
+	{
+		const Shard& shard = mShards[shardOf(series)];
+		const typename Shard::const_iterator it = shard.find(series);
+		return it != shard.end() ? &it->second : nullptr;
+	}
+	/**
+	 * @brief Sorts a CAP index by CAP unless the entries from `sorted - 1`
+	 * on are in order already, as with GET responses, which come ordered by
+	 * key.
+	 *
+	 * @param entries The CAP index.
+	 * @param sorted The amount of leading entries known to be sorted.
+	 */
+	static void sortEntries(std::vector<Entry>& entries, const std::size_t sorted)
+	{
+		const auto capLess = [](const Entry& a, const Entry& b) { return a.cap < b.cap; };
+		const std::size_t from = sorted > 0 ? sorted - 1 : 0;
+		if (!std::is_sorted(entries.begin() + from, entries.end(), capLess)) {
+			std::stable_sort(entries.begin(), entries.end(), capLess);
+		}
+	}
+	/** @brief Fills each shard on a thread of its own. */
+	void build()
+	{
+		mIndexed = mRecords->size();
+		const auto fill = [this](const std::size_t shardIndex) {
+			Shard& shard = mShards[shardIndex];
+			for (std::size_t i = 0; i < mIndexed; ++i) {
+				const Key& key = (*mRecords)[i].key;
+				const SeriesKey series{key.cid, key.mid, key.moid};
+				if (shardOf(series) == shardIndex) {
+					shard[series].push_back(Entry{key.cap, i});
+				}
+			}
+			for (typename Shard::value_type& series : shard) {
+				sortEntries(series.second, 0);
+			}
+		};
+		std::vector<std::thread> threads;
+		threads.reserve(mShards.size() - 1);
+		for (std::size_t i = 1; i < mShards.size(); ++i) {
+			threads.emplace_back(fill, i);
+		}
+		fill(0);
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+
+	/** @brief The indexed set. */
+	const RecordsSet<T, Alloc>* mRecords;
+	/** @brief The shards of the index. */
+	std::vector<Shard> mShards;
+	/** @brief The amount of records indexed, i.e. the position of the first
+	 * record appended to the set since. */
+	std::size_t mIndexed;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -22,10 +22,14 @@
 #ifndef D_TSTORAGE_RECORDSSET_H
 #define D_TSTORAGE_RECORDSSET_H
 
+#include <algorithm>
 #include <cstddef>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "DataTypes.h"
+#include "PackedKey.h"
 
 /** @file
  * @brief Defines a generic records container. */
@@ -36,13 +40,19 @@ namespace tstorage {
  * @brief A simple container for inbound and outbound records.
  *
  * A default-constructible, copyable and moveable container for records with
- * payload of type T. It supports appending and iterating over records only.
+ * payload of type T. It supports appending and iterating over records, and
+ * clearing the container for reuse.
  * Use it to pass records to TStorage over an open `Channel`. It is also
  * returned as a part of the response to a GET query.
  *
+ * The records are kept in memory obtained from an allocator, the standard
+ * one by default. An `ArenaAllocator` places them in an arena instead, along
+ * with arena-aware payload values (see `ArenaRecordsSet<T>`).
+ *
  * @tparam T Payload type of stored records.
+ * @tparam Alloc A standard allocator of `Record<T>`.
  */
-template<typename T>
+template<typename T, typename Alloc = std::allocator<Record<T>>>
 class RecordsSet final
 {
 private:
@@ -50,7 +60,7 @@ private:
 	 * @brief Internal container implementation. It may be subject to change in
 	 * the future, consider it an implementation detail.
 	 */
-	using Container = std::vector<Record<T>>;
+	using Container = std::vector<Record<T>, Alloc>;
 
 public:
 	/**
@@ -67,6 +77,19 @@ public:
 	 * reference for the Iterator library).
 	 */
 	using const_iterator = typename Container::const_iterator;
+	/** @brief The allocator type. */
+	using allocator_type = Alloc;
+
+	/** @brief Creates an empty set using a default-constructed allocator. */
+	RecordsSet() = default;
+	/** @brief Creates an empty set using a copy of `alloc`. */
+	explicit RecordsSet(const Alloc& alloc)
+		: mRecords(alloc)
+	{
+	}
+
+	/** @brief Returns a copy of the allocator of the set. */
+	Alloc get_allocator() const { return mRecords.get_allocator(); }
 
 	/**
 	 * @brief Returns an iterator pointing at the first record of the set.
@@ -136,6 +159,72 @@ public:
 	 * @brief Returns the number of records currently stored in the container.
 	 */
 	std::size_t size() const { return mRecords.size(); }
+	/**
+	 * @brief Returns the record at a given position, counting from `0` in
+	 * the order of appending.
+	 *
+	 * @param position The position of the record, less than `size()`.
+	 */
+	const Record<T>& operator[](const std::size_t position) const { return mRecords[position]; }
+
+	/**
+	 * @brief Reserves space for at least `count` records, so that appending
+	 * them does not reallocate the container.
+	 *
+	 * @param count The number of records to make room for.
+	 */
+	void reserve(std::size_t count) { mRecords.reserve(count); }
+
+	/**
+	 * @brief Removes all records from the container. The allocated memory is
+	 * retained for reuse.
+	 */
+	void clear() { mRecords.clear(); }
+
+	/**
+	 * @brief Sorts the records by their keys, as ordered by `operator<`.
+	 *
+	 * Records with equal keys keep their relative order. The keys are packed
+	 * (see `PackedKey`) and radix-sorted along with the positions of the
+	 * records, which are then moved to their places once. This takes two
+	 * 40-byte entries per record and a second container of the records of
+	 * temporary memory.
+	 */
+	void sortByKey()
+	{
+		std::vector<std::pair<PackedKey, std::size_t>> entries;
+		entries.reserve(mRecords.size());
+		for (std::size_t i = 0; i < mRecords.size(); ++i) {
+			entries.emplace_back(PackedKey(mRecords[i].key), i);
+		}
+		radixSort(entries);
+
+		Container sorted(mRecords.get_allocator());
+		sorted.reserve(mRecords.size());
+		for (const std::pair<PackedKey, std::size_t>& entry : entries) {
+			sorted.push_back(std::move(mRecords[entry.second]));
+		}
+		mRecords.swap(sorted);
+	}
+	/**
+	 * @brief Returns an iterator pointing at the first record with a key not
+	 * less than `key`, or `end()` if there is none.
+	 *
+	 * The records must be sorted by their keys, e.g. with `sortByKey()`.
+	 * The keys are compared in their packed form.
+	 *
+	 * @param key The key to search for.
+	 */
+	const_iterator lowerBound(const Key& key) const
+	{
+		const PackedKey packed(key);
+		return std::lower_bound(mRecords.cbegin(),
+			mRecords.cend(),
+			packed,
+			[](const Record<T>& record, const PackedKey& bound) {
+				return PackedKey(record.key) < bound;
+			});
+	}
 
 private:
 	/** @brief The actual container. */
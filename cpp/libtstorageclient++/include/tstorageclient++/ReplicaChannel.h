@@ -0,0 +1,312 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ReplicaChannel.h
+ *   A client of replicated TStorage instances routing reads by latency.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_REPLICACHANNEL_H
+#define D_TSTORAGE_REPLICACHANNEL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <vector>
+
+#include "Channel.h"
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+#include "Tracer.h"
+
+/** @file
+ * @brief Defines the `ReplicaChannel<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A client of several TStorage instances holding the same records,
+ * sending each read to the fastest healthy one.
+ *
+ * Each replica is served by a `ChannelPool<T>`, whose channels report the
+ * timings of their requests to a `Tracer` kept per replica (see
+ * `ChannelPool::setTracer()`). From these, the latency of every GET and GETACQ
+ * request is taken as the time until the first bytes of its response, and
+ * folded into an exponentially weighted moving average and a decaying
+ * histogram of the replica. `get()` and `getAcq()` go to the healthy replica
+ * with the lowest average; replicas not measured yet come first. Every
+ * `cProbePeriod`-th read goes to the runner-up instead, so that the averages
+ * of the other replicas follow their recovery.
+ *
+ * A replica whose channel got closed by a failed request, or failed to
+ * connect, is unhealthy for the reconnect interval of the pools (see
+ * `setReconnectInterval()`) and only read from if no replica is healthy.
+ *
+ * With hedging enabled (see `setHedging()`), a read which hasn't got a
+ * response within the 95th percentile of its replica's latency is sent to the
+ * runner-up as well, and the first successful response is returned. The other
+ * request runs to completion in the background, its response dropped.
+ *
+ * `put()` and `puta()` go to the first replica, the primary; copying the
+ * records to the other replicas is left to the servers.
+ *
+ * Like the pools, a replica channel may be used by several threads at once.
+ * All replicas share a single `PayloadType<T>` instance, which hence has to be
+ * safe to use concurrently (see `SharedPayloadType<T>`). A library built with
+ * `make NO_TRACING=1` reports no timings, so reads then go to the first
+ * healthy replica and are never hedged.
+ *
+ * Programs using this class have to be linked with `-pthread`.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class ReplicaChannel final
+{
+public:
+	/** @brief The weight of a new latency in the moving average. */
+	static constexpr double cEwmaWeight = 0.2;
+	/** @brief Every how many reads go to the runner-up replica. */
+	static constexpr std::uint64_t cProbePeriod = 64;
+	/** @brief The amount of latencies of a replica measured before its reads
+	 * are hedged. */
+	static constexpr std::uint64_t cMinHedgeSamples = 16;
+	/** @brief The amount of latencies after which the histogram of a replica
+	 * is halved, so that its percentiles follow recent reads. */
+	static constexpr std::uint64_t cDecayPeriod = 1024;
+
+	/**
+	 * @brief Constructs a client of the TStorage replicas under the given
+	 * addresses.
+	 *
+	 * No connections are established until `connect()` is called.
+	 *
+	 * @param replicas The addresses of the replicas, the primary first. Must
+	 * not be empty.
+	 * @param payloadType A `PayloadType` instance shared by all channels.
+	 * @param channelsPerReplica The amount of channels in the pool of each
+	 * replica. Hedged reads take a channel of two replicas at once.
+	 */
+	ReplicaChannel(const std::vector<Endpoint>& replicas,
+		std::shared_ptr<PayloadType<T>> payloadType,
+		std::size_t channelsPerReplica);
+	/**
+	 * @brief Closes the channel.
+	 * @see close()
+	 */
+	~ReplicaChannel();
+
+	ReplicaChannel(const ReplicaChannel&) = delete;
+	ReplicaChannel(ReplicaChannel&&) = delete;
+	ReplicaChannel& operator=(const ReplicaChannel&) = delete;
+	ReplicaChannel& operator=(ReplicaChannel&&) = delete;
+
+	/**
+	 * @brief Connects the channel pools of all replicas.
+	 *
+	 * @see ChannelPool::connect()
+	 *
+	 * @return A `Response` with the status code of the first replica which
+	 * failed to connect, or a success code if all replicas are connected.
+	 */
+	Response connect();
+	/**
+	 * @brief Waits for the hedged reads still running in the background and
+	 * closes the channel pools of all replicas.
+	 *
+	 * No requests may be in progress.
+	 */
+	void close();
+
+	/**
+	 * @brief Sends records to the primary replica with a PUT request.
+	 * @see Channel::put()
+	 * @param data The records to send.
+	 * @return A `Response` with the status code of the request.
+	 */
+	Response put(const RecordsSet<T>& data);
+	/**
+	 * @brief Sends records with their ACQs to the primary replica with a PUTA
+	 * request.
+	 * @see Channel::puta()
+	 * @param data The records to send.
+	 * @return A `Response` with the status code of the request.
+	 */
+	Response puta(const RecordsSet<T>& data);
+
+	/**
+	 * @brief Retrieves records from a key-interval of the fastest healthy
+	 * replica.
+	 *
+	 * @see Channel::get()
+	 *
+	 * @param keyMin The lower bound of the key-interval.
+	 * @param keyMax The upper bound of the key-interval.
+	 * @return The response of the replica which answered first, or of the
+	 * last one to fail.
+	 */
+	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Retrieves the full-commit ACQ of a key-interval from the fastest
+	 * healthy replica.
+	 *
+	 * @see Channel::getAcq()
+	 *
+	 * @param keyMin The lower bound of the key-interval.
+	 * @param keyMax The upper bound of the key-interval.
+	 * @return The response of the replica which answered first, or of the
+	 * last one to fail.
+	 */
+	ResponseAcq getAcq(const Key& keyMin, const Key& keyMax);
+
+	/**
+	 * @brief Enables or disables hedged reads.
+	 *
+	 * A hedged read runs on a helper thread, so that the calling thread can
+	 * time it and send the duplicate request.
+	 *
+	 * Disabled by default.
+	 *
+	 * @param enabled `true` to hedge reads.
+	 */
+	void setHedging(bool enabled) { mHedging = enabled; }
+	/** @brief Returns the amount of duplicate requests sent by hedged reads. */
+	std::uint64_t hedges() const { return mHedges.load(); }
+
+	/** @brief Returns the read latencies and the health of the `index`-th
+	 * replica. */
+	ReplicaStats stats(std::size_t index) const;
+	/** @brief Returns the amount of replicas. */
+	std::size_t size() const { return mPools.size(); }
+	/** @brief Accesses the channel pool of the `index`-th replica. */
+	ChannelPool<T>& replica(std::size_t index) { return *mPools[index]; }
+
+	/**
+	 * @brief Sets the timeout for send/receive operations of all channels.
+	 * @see ChannelPool::setTimeout()
+	 * @param timeout Timeout in milliseconds.
+	 */
+	void setTimeout(std::chrono::duration<std::int64_t, std::milli> timeout);
+	/**
+	 * @brief Sets the memory limit of all channels.
+	 * @see ChannelPool::setMemoryLimit()
+	 * @param memoryLimitBytes New memory limit in bytes.
+	 */
+	void setMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the delay between reconnection attempts of all pools, which
+	 * is also how long a failed replica stays unhealthy. By default, it's 1
+	 * second.
+	 * @see ChannelPool::setReconnectInterval()
+	 * @param interval The delay in milliseconds.
+	 */
+	void setReconnectInterval(std::chrono::duration<std::int64_t, std::milli> interval);
+
+private:
+	/** @brief The latencies and the health of a replica, fed as the tracer of
+	 * its channels. */
+	class Replica final : public Tracer
+	{
+	public:
+		/** @brief Counts a failed connect against the replica's health. */
+		void onConnect(const ConnectTrace& trace) override;
+		/** @brief Measures the latency of a GET or GETACQ request. */
+		void onRequest(const RequestTrace& trace) override;
+
+		/** @brief Makes the replica unhealthy for `downtimeMs`. */
+		void markDown();
+		/** @brief Returns a snapshot of the latencies and the health. */
+		ReplicaStats stats() const;
+
+		/** @brief How long the replica stays unhealthy after a failure. */
+		std::atomic<std::int64_t> downtimeMs{1000};
+
+	private:
+		/** @brief Guards the fields below, updated by the pool's threads. */
+		mutable std::mutex mMutex;
+		/** @brief The moving average of the latencies in microseconds. */
+		double mEwmaUs = 0.0;
+		/** @brief The amount of latencies measured. */
+		std::uint64_t mSamples = 0;
+		/** @brief The recent latencies. */
+		LatencyHistogram mHistogram{};
+		/** @brief The time the replica is unhealthy until. */
+		std::chrono::steady_clock::time_point mDownUntil{};
+	};
+
+	/** @brief The state of a hedged read, shared by its requests. */
+	template<typename R>
+	struct Race
+	{
+		/** @brief Guards the fields below. */
+		std::mutex mutex;
+		/** @brief Signals that `result` is set. */
+		std::condition_variable done;
+		/** @brief The response returned by the read, once known. */
+		std::unique_ptr<R> result;
+		/** @brief The amount of requests still running. */
+		std::size_t pending = 0;
+	};
+
+	/** @brief Sends a read to the best replica, hedging it if enabled. */
+	template<typename R, typename Query>
+	R route(const Query& query);
+	/** @brief Runs `query` over a channel of the `index`-th replica, marking the
+	 * replica unhealthy if the channel gets closed. */
+	template<typename R, typename Query>
+	R runOn(std::size_t index, const Query& query);
+	/** @brief Runs `query` on the `index`-th replica on a background thread,
+	 * reporting to `race`. */
+	template<typename R, typename Query>
+	void launch(const std::shared_ptr<Race<R>>& race, std::size_t index, const Query& query);
+	/** @brief Chooses the replica of a read and the runner-up. Returns `false`
+	 * if there's no healthy runner-up. */
+	bool pick(std::size_t& oFirst, std::size_t& oSecond);
+
+	/** @brief The channel pools of the replicas, the primary first. */
+	std::vector<std::unique_ptr<ChannelPool<T>>> mPools;
+	/** @brief The latencies of the replicas, indexed like `mPools`. */
+	std::vector<std::shared_ptr<Replica>> mReplicas;
+	/** @brief Whether reads are hedged. */
+	std::atomic<bool> mHedging;
+	/** @brief The amount of reads routed so far. */
+	std::atomic<std::uint64_t> mReads;
+	/** @brief The amount of duplicate requests sent. */
+	std::atomic<std::uint64_t> mHedges;
+
+	/** @brief The amount of hedged requests running in the background. */
+	std::size_t mBackground;
+	/** @brief Guards `mBackground`. */
+	std::mutex mBackgroundMutex;
+	/** @brief Signals that a background request finished. */
+	std::condition_variable mBackgroundDone;
+};
+
+} /*namespace tstorage*/
+
+#include "ReplicaChannel.tpp"
+
+#endif
@@ -0,0 +1,337 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ReplicaChannel.tpp
+ *   An implementation of the `ReplicaChannel<T>` interface.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_REPLICACHANNEL_TPP
+#define D_TSTORAGE_REPLICACHANNEL_TPP
+
+#ifndef D_TSTORAGE_REPLICACHANNEL_H
+#error __FILE__ was included from outside of "ReplicaChannel.h"
+#include "ReplicaChannel.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ratio>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Channel.h"
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "PayloadType.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+#include "Tracer.h"
+
+/** @file
+ * @brief Contains the implementation of `ReplicaChannel<T>`. */
+
+namespace tstorage {
+
+template<typename T>
+constexpr double ReplicaChannel<T>::cEwmaWeight;
+template<typename T>
+constexpr std::uint64_t ReplicaChannel<T>::cProbePeriod;
+template<typename T>
+constexpr std::uint64_t ReplicaChannel<T>::cMinHedgeSamples;
+template<typename T>
+constexpr std::uint64_t ReplicaChannel<T>::cDecayPeriod;
+
+/**************
+ * Replica
+ */
+
+template<typename T>
+void ReplicaChannel<T>::Replica::onConnect(const ConnectTrace& trace)
+{
+	if (trace.status != result_t::OK) {
+		markDown();
+	}
+}
+
+template<typename T>
+void ReplicaChannel<T>::Replica::onRequest(const RequestTrace& trace)
+{
+	if (trace.command != TraceCommand::GET && trace.command != TraceCommand::GETACQ) {
+		return;
+	}
+	const std::uint64_t latencyUs = static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::microseconds>(trace.firstByte - trace.start)
+			.count());
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEwmaUs = mSamples == 0
+		? static_cast<double>(latencyUs)
+		: mEwmaUs + cEwmaWeight * (static_cast<double>(latencyUs) - mEwmaUs);
+	++mSamples;
+
+	if (mHistogram.count == cDecayPeriod) {
+		mHistogram.count = 0;
+		for (std::uint64_t& count : mHistogram.counts) {
+			count /= 2;
+			mHistogram.count += count;
+		}
+		mHistogram.totalUs /= 2;
+	}
+	++mHistogram.counts[LatencyHistogram::bucketOf(latencyUs)];
+	++mHistogram.count;
+	mHistogram.totalUs += latencyUs;
+	mHistogram.maxUs = std::max(mHistogram.maxUs, latencyUs);
+}
+
+template<typename T>
+void ReplicaChannel<T>::Replica::markDown()
+{
+	const std::chrono::steady_clock::time_point until = std::chrono::steady_clock::now()
+		+ std::chrono::milliseconds(downtimeMs.load());
+	std::lock_guard<std::mutex> lock(mMutex);
+	mDownUntil = std::max(mDownUntil, until);
+}
+
+template<typename T>
+ReplicaStats ReplicaChannel<T>::Replica::stats() const
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock(mMutex);
+	return ReplicaStats{mEwmaUs, mHistogram.percentileUs(0.95), mSamples, now >= mDownUntil};
+}
+
+/**************
+ * Setup
+ */
+
+template<typename T>
+ReplicaChannel<T>::ReplicaChannel(const std::vector<Endpoint>& replicas,
+	std::shared_ptr<PayloadType<T>> payloadType,
+	const std::size_t channelsPerReplica)
+	: mHedging(false)
+	, mReads(0)
+	, mHedges(0)
+	, mBackground(0)
+{
+	mPools.reserve(replicas.size());
+	mReplicas.reserve(replicas.size());
+	for (const Endpoint& endpoint : replicas) {
+		mPools.push_back(std::make_unique<ChannelPool<T>>(
+			endpoint.hostname, endpoint.port, payloadType, channelsPerReplica));
+		mReplicas.push_back(std::make_shared<Replica>());
+		mPools.back()->setTracer(mReplicas.back());
+	}
+}
+
+template<typename T>
+ReplicaChannel<T>::~ReplicaChannel()
+{
+	close();
+}
+
+template<typename T>
+Response ReplicaChannel<T>::connect()
+{
+	result_t firstError = result_t::OK;
+	for (std::unique_ptr<ChannelPool<T>>& pool : mPools) {
+		const Response res = pool->connect();
+		if (res.error() && firstError == result_t::OK) {
+			firstError = res.status();
+		}
+	}
+	return Response(firstError);
+}
+
+template<typename T>
+void ReplicaChannel<T>::close()
+{
+	{
+		std::unique_lock<std::mutex> lock(mBackgroundMutex);
+		mBackgroundDone.wait(lock, [this]() { return mBackground == 0; });
+	}
+	for (std::unique_ptr<ChannelPool<T>>& pool : mPools) {
+		pool->close();
+	}
+}
+
+template<typename T>
+void ReplicaChannel<T>::setTimeout(const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	for (std::unique_ptr<ChannelPool<T>>& pool : mPools) {
+		pool->setTimeout(timeout);
+	}
+}
+
+template<typename T>
+void ReplicaChannel<T>::setMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	for (std::unique_ptr<ChannelPool<T>>& pool : mPools) {
+		pool->setMemoryLimit(memoryLimitBytes);
+	}
+}
+
+template<typename T>
+void ReplicaChannel<T>::setReconnectInterval(
+	const std::chrono::duration<std::int64_t, std::milli> interval)
+{
+	for (std::size_t i = 0; i < mPools.size(); ++i) {
+		mPools[i]->setReconnectInterval(interval);
+		mReplicas[i]->downtimeMs = interval.count();
+	}
+}
+
+template<typename T>
+ReplicaStats ReplicaChannel<T>::stats(const std::size_t index) const
+{
+	return mReplicas[index]->stats();
+}
+
+/**************
+ * Requests
+ */
+
+template<typename T>
+Response ReplicaChannel<T>::put(const RecordsSet<T>& data)
+{
+	return mPools[0]->acquire()->put(data);
+}
+
+template<typename T>
+Response ReplicaChannel<T>::puta(const RecordsSet<T>& data)
+{
+	return mPools[0]->acquire()->puta(data);
+}
+
+template<typename T>
+ResponseGet<T> ReplicaChannel<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	return route<ResponseGet<T>>(
+		[keyMin, keyMax](Channel<T>& channel) { return channel.get(keyMin, keyMax); });
+}
+
+template<typename T>
+ResponseAcq ReplicaChannel<T>::getAcq(const Key& keyMin, const Key& keyMax)
+{
+	return route<ResponseAcq>(
+		[keyMin, keyMax](Channel<T>& channel) { return channel.getAcq(keyMin, keyMax); });
+}
+
+template<typename T>
+template<typename R, typename Query>
+R ReplicaChannel<T>::route(const Query& query)
+{
+	std::size_t first = 0;
+	std::size_t second = 0;
+	const bool hedgeable = pick(first, second) && mHedging.load();
+	const ReplicaStats firstStats = mReplicas[first]->stats();
+	if (!hedgeable || firstStats.samples < cMinHedgeSamples) {
+		return runOn<R>(first, query);
+	}
+
+	std::shared_ptr<Race<R>> race = std::make_shared<Race<R>>();
+	race->pending = 1;
+	launch(race, first, query);
+
+	const auto finished = [&race]() { return race->result != nullptr; };
+	std::unique_lock<std::mutex> lock(race->mutex);
+	if (!race->done.wait_for(lock, std::chrono::microseconds(firstStats.p95Us), finished)) {
+		++race->pending;
+		++mHedges;
+		launch(race, second, query);
+		race->done.wait(lock, finished);
+	}
+	return std::move(*race->result);
+}
+
+template<typename T>
+template<typename R, typename Query>
+R ReplicaChannel<T>::runOn(const std::size_t index, const Query& query)
+{
+	typename ChannelPool<T>::Lease lease = mPools[index]->acquire();
+	R response = query(*lease);
+	if (response.error() && !lease->connected()) {
+		mReplicas[index]->markDown();
+	}
+	return response;
+}
+
+template<typename T>
+template<typename R, typename Query>
+void ReplicaChannel<T>::launch(
+	const std::shared_ptr<Race<R>>& race, const std::size_t index, const Query& query)
+{
+	{
+		std::lock_guard<std::mutex> lock(mBackgroundMutex);
+		++mBackground;
+	}
+	std::thread([this, race, index, query]() {
+		R response = runOn<R>(index, query);
+		{
+			std::lock_guard<std::mutex> lock(race->mutex);
+			--race->pending;
+			// A failure is returned only once no request can succeed anymore.
+			if (race->result == nullptr && (!response.error() || race->pending == 0)) {
+				race->result = std::make_unique<R>(std::move(response));
+				race->done.notify_all();
+			}
+		}
+		std::lock_guard<std::mutex> lock(mBackgroundMutex);
+		--mBackground;
+		mBackgroundDone.notify_all();
+	}).detach();
+}
+
+template<typename T>
+bool ReplicaChannel<T>::pick(std::size_t& oFirst, std::size_t& oSecond)
+{
+	std::vector<std::pair<ReplicaStats, std::size_t>> ranking;
+	ranking.reserve(mReplicas.size());
+	for (std::size_t i = 0; i < mReplicas.size(); ++i) {
+		ranking.emplace_back(mReplicas[i]->stats(), i);
+	}
+	// Healthy replicas first, then by the average latency, then by order.
+	std::stable_sort(ranking.begin(), ranking.end(),
+		[](const std::pair<ReplicaStats, std::size_t>& a,
+			const std::pair<ReplicaStats, std::size_t>& b) {
+			if (a.first.healthy != b.first.healthy) {
+				return a.first.healthy;
+			}
+			return a.first.ewmaUs < b.first.ewmaUs;
+		});
+
+	oFirst = ranking[0].second;
+	if (ranking.size() < 2 || !ranking[1].first.healthy) {
+		return false;
+	}
+	oSecond = ranking[1].second;
+	if (++mReads % cProbePeriod == 0) {
+		std::swap(oFirst, oSecond);
+	}
+	return true;
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -23,6 +23,8 @@
 #ifndef D_TSTORAGE_RESPONSEGET_H
 #define D_TSTORAGE_RESPONSEGET_H
 
+#include <memory>
+
 #include "DataTypes.h"
 #include "RecordsSet.h"
 #include "ResponseAcq.h"
@@ -54,8 +56,9 @@ namespace tstorage {
  *  @see `Channel::getStream()`
  *
  *  @tparam T Payload type of received records.
+ *  @tparam Alloc The allocator of the records container.
  */
-template<typename T>
+template<typename T, typename Alloc = std::allocator<Record<T>>>
 class ResponseGet : public ResponseAcq
 {
 public:
@@ -77,7 +80,7 @@ public:
 	 * @param records The initial records set.
 	 * @param acq The returned ACQ timestamp.
 	 */
-	ResponseGet(result_t statusCode, const RecordsSet<T>& records, Key::AcqT acq)
+	ResponseGet(result_t statusCode, const RecordsSet<T, Alloc>& records, Key::AcqT acq)
 		: ResponseAcq(statusCode, acq), mResponse(records) {}
 
 	/**
@@ -89,23 +92,23 @@ public:
 	 * @param records The initial records set.
 	 * @param acq The returned ACQ timestamp.
 	 */
-	ResponseGet(result_t statusCode, RecordsSet<T>&& records, Key::AcqT acq)
+	ResponseGet(result_t statusCode, RecordsSet<T, Alloc>&& records, Key::AcqT acq)
 		: ResponseAcq(statusCode, acq), mResponse(std::move(records)) {}
 
 	/**
 	 * @brief Accesses the underlying records container.
 	 * @return A reference to the underlying `RecordsSet<T>`.
 	 */
-	RecordsSet<T>& records() { return mResponse; }
+	RecordsSet<T, Alloc>& records() { return mResponse; }
 	/**
 	 * @brief Accesses the underlying records container (read-only).
 	 * @return A const reference to the underlying `RecordsSet<T>`.
 	 */
-	const RecordsSet<T>& records() const { return mResponse; }
+	const RecordsSet<T, Alloc>& records() const { return mResponse; }
 
 private:
 	/** @brief The set of records received in response to the GET query. */
-	RecordsSet<T> mResponse;
+	RecordsSet<T, Alloc> mResponse;
 };
 
 } /*namespace tstorage*/
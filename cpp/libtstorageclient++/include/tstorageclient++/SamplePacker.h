@@ -0,0 +1,322 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SamplePacker.h
+ *   Packing of consecutive numeric samples of a series into single records.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SAMPLEPACKER_H
+#define D_TSTORAGE_SAMPLEPACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "BlobRecordsSet.h"
+#include "Channel.h"
+#include "DataTypes.h"
+#include "RecordsIndex.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Defines the `SamplePacker<T>` and `PackedSamplesReader<T>`
+ * classes. */
+
+namespace tstorage {
+
+/** @brief The options of a `SamplePacker<T>`. */
+struct SamplePackingOptions
+{
+	/** @brief The largest amount of samples packed into a record. */
+	std::size_t maxSamples = 64;
+	/** @brief The largest CAP distance between the first and the last sample
+	 * of a record, 60 seconds by default. Bounds how far back `get()` has to
+	 * look for the records holding the samples of a key-interval. */
+	Key::CapT maxSpan = 60LL * 1000 * 1000 * 1000;
+};
+
+/**
+ * @brief Reads the samples packed into a record by a `SamplePacker<T>`.
+ *
+ * A packed payload holds the value of the first sample, whose key is the one
+ * of the record, followed by a CAP delta and a value for each further sample.
+ * The deltas from the previous sample are LEB128 varints, the values are
+ * `sizeof(T)` bytes in little-endian order, as written by
+ * `LittleEndianPayloadType<T>`. A record of a single sample stored without
+ * packing is thus read as a packed record of one sample.
+ *
+ * @code
+ * PackedSamplesReader<float> reader(blobs.key(i), blobs.payload(i), blobs.payloadSize(i));
+ * Record<float> sample;
+ * while (reader.next(sample)) {
+ *     ...
+ * }
+ * if (reader.failed()) {
+ *     // malformed payload
+ * }
+ * @endcode
+ *
+ * @tparam T Internal data type of the samples, an arithmetic type.
+ */
+template<typename T>
+class PackedSamplesReader final
+{
+	static_assert(std::is_arithmetic<T>::value, "Only numeric samples can be packed");
+
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param key The key of the packed record.
+	 * @param payload The payload of the record, which must outlive the
+	 * reader.
+	 * @param payloadSize The size of the payload.
+	 */
+	PackedSamplesReader(const Key& key, const void* payload, std::size_t payloadSize);
+
+	/**
+	 * @brief Reads the next sample.
+	 *
+	 * @param[out] oSample The sample, keyed by the record's key with the
+	 * sample's CAP.
+	 * @return `true` on success, `false` at the end of the payload or if it
+	 * is malformed.
+	 */
+	bool next(Record<T>& oSample);
+	/** @brief Returns `true` if `next()` has stopped at a malformed part of
+	 * the payload. */
+	bool failed() const { return mFailed; }
+
+private:
+	/** @brief The key of the last read sample. */
+	Key mKey;
+	/** @brief The unread part of the payload. */
+	const unsigned char* mInput;
+	/** @brief The end of the payload. */
+	const unsigned char* mInputEnd;
+	/** @brief `true` until the first sample is read. */
+	bool mFirst;
+	/** @brief `true` if the payload is malformed. */
+	bool mFailed;
+};
+
+/**
+ * @brief A front end of a channel packing runs of consecutive samples of
+ * numeric series into single records, and unpacking them on GET.
+ *
+ * Each record of a numeric series carries a key several times the size of
+ * its value on the wire, and is indexed by the server on its own. The packer
+ * keeps an open record per series, i.e. per `(cid, mid, moid)`, and appends
+ * the samples of the series to it (see `PackedSamplesReader<T>` for the
+ * format), a float taking 5 bytes or so instead of 28. A record is closed
+ * and stored once it holds `SamplePackingOptions::maxSamples` samples, or
+ * once the next sample does not fit into it: its CAP is not greater than the
+ * last one, or is further than `SamplePackingOptions::maxSpan` from the first
+ * one, or, for `puta()`, its ACQ differs from the first one.
+ *
+ * The open records are stored by a later call once full, or by `flush()`,
+ * which the caller should invoke before closing the channel and whenever the
+ * samples should become readable. A failed request loses its records, but the
+ * packer counts them as stored.
+ *
+ * The packed records are stored with `Channel<T>::putRaw()` and read with
+ * `Channel<T>::getBlob()`, so the payload type of the channel is not used.
+ * `get()` and `getStream()` expand the packed records back into samples. The
+ * records of a series should be either all packed, or stored as
+ * `LittleEndianPayloadType<T>` values, which are read as packed records of a
+ * single sample.
+ *
+ * Like the channel, the packer is not thread-safe. The channel must be
+ * connected beforehand and must outlive the packer.
+ *
+ * @tparam T Internal data type of the samples, an arithmetic type.
+ */
+template<typename T>
+class SamplePacker final
+{
+	static_assert(std::is_arithmetic<T>::value, "Only numeric samples can be packed");
+
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param channel The channel storing and fetching the records.
+	 * @param options The packing options.
+	 */
+	SamplePacker(Channel<T>& channel, const SamplePackingOptions& options);
+
+	SamplePacker(const SamplePacker&) = delete;
+	SamplePacker(SamplePacker&&) = delete;
+	SamplePacker& operator=(const SamplePacker&) = delete;
+	SamplePacker& operator=(SamplePacker&&) = delete;
+
+	/**
+	 * @brief Packs the samples of `data` and stores the records they close
+	 * with `Channel<T>::putRaw()`.
+	 *
+	 * @return The response of `Channel<T>::putRaw()`, or a success code if no
+	 * record was closed.
+	 */
+	Response put(const RecordsSet<T>& data);
+	/**
+	 * @brief Packs the samples of `data` and stores the records they close
+	 * with `Channel<T>::putaRaw()`, keeping the ACQs of the samples.
+	 *
+	 * @return The response of `Channel<T>::putaRaw()`, or a success code if
+	 * no record was closed.
+	 */
+	Response puta(const RecordsSet<T>& data);
+	/**
+	 * @brief Closes and stores the open records, with the protocol of the
+	 * last `put()` or `puta()` call.
+	 *
+	 * @return The response of the request, or a success code if no record was
+	 * open.
+	 */
+	Response flush();
+	/** @brief Drops the open records. */
+	void reset() { mSeries.clear(); }
+
+	/**
+	 * @brief Retrieves the samples of a key-interval, expanding the packed
+	 * records.
+	 *
+	 * Fetches the records from `SamplePackingOptions::maxSpan` before
+	 * `keyMin.cap` on, to find those starting before the key-interval, and
+	 * leaves out the samples outside of it. The possible error codes are
+	 * those of `Channel<T>::getBlob()`, and `result_t::DESERIALIZATION_ERROR`
+	 * if a payload is malformed.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired samples.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired samples.
+	 *
+	 * @return The samples, in the order of the records.
+	 */
+	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Batch-streams the samples of a key-interval through a callback
+	 * function, expanding the packed records like `get()`.
+	 *
+	 * Acts like `Channel<T>::getStreamBlob()`, passing on the samples of each
+	 * batch. Once a payload turns out malformed, the rest of the response is
+	 * received but not passed on.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired samples.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired samples.
+	 *
+	 * @param callback A callable that will be called on the samples of each
+	 * batch of records.
+	 *
+	 * @return The response as in `get()`.
+	 */
+	ResponseAcq getStream(const Key& keyMin,
+		const Key& keyMax,
+		const std::function<void(RecordsSet<T>&)>& callback);
+
+	/** @brief Returns the amount of samples passed to the packer. */
+	std::uint64_t received() const { return mReceived; }
+	/** @brief Returns the amount of records passed on to the channel. */
+	std::uint64_t stored() const { return mStored; }
+
+private:
+	/** @brief The open record of a series. */
+	struct State
+	{
+		/** @brief The key of the first sample. */
+		Key first;
+		/** @brief The CAP of the last sample. */
+		Key::CapT lastCap;
+		/** @brief The amount of samples, `0` if no record is open. */
+		std::size_t samples;
+		/** @brief The payload. */
+		std::vector<unsigned char> payload;
+	};
+	/** @brief Hashes a series for `std::unordered_map`. */
+	struct SeriesHash
+	{
+		/** @brief Returns the hash of `series`. */
+		std::size_t operator()(const SeriesKey& series) const { return series.hash(); }
+	};
+	/** @brief A closed record waiting to be stored. */
+	struct Closed
+	{
+		/** @brief The key of the record. */
+		Key key;
+		/** @brief The offset of the payload in `mHeap`. */
+		std::size_t offset;
+		/** @brief The size of the payload. */
+		std::size_t size;
+	};
+
+	/** @brief Packs `data` and stores the closed records with PUT or PUTA. */
+	Response store(const RecordsSet<T>& data, bool withAcq);
+	/** @brief Sends the closed records with PUT or PUTA, then drops them. */
+	Response send(bool withAcq);
+	/** @brief Appends a sample to the open record of its series. */
+	void pack(const Record<T>& sample, bool withAcq);
+	/** @brief Closes the open record of a series. */
+	void close(State& state);
+	/** @brief Appends the little-endian bytes of a value to a payload. */
+	static void appendValue(std::vector<unsigned char>& payload, T value);
+	/** @brief Appends the samples of the records of `blobs` within a
+	 * key-interval to `oSamples`.
+	 * @return `false` if a payload is malformed. */
+	static bool unpack(const BlobRecordsSet& blobs,
+		const Key& keyMin,
+		const Key& keyMax,
+		RecordsSet<T>& oSamples);
+	/** @brief Returns the lower vertex of the key-interval holding the
+	 * records which may pack the samples from `keyMin` on. */
+	Key widened(const Key& keyMin) const;
+
+	/** @brief The channel storing and fetching the records. */
+	Channel<T>& mChannel;
+	/** @brief The packing options. */
+	SamplePackingOptions mOptions;
+	/** @brief The open records of the series. */
+	std::unordered_map<SeriesKey, State, SeriesHash> mSeries;
+	/** @brief The closed records to store. */
+	std::vector<Closed> mClosed;
+	/** @brief The payloads of the closed records. */
+	std::vector<unsigned char> mHeap;
+	/** @brief The closed records as passed to the channel. */
+	std::vector<RawRecord> mRaw;
+	/** @brief `true` if the last call stored its records with PUTA. */
+	bool mWithAcq;
+	/** @brief The amount of samples passed to the packer. */
+	std::uint64_t mReceived;
+	/** @brief The amount of records passed on to the channel. */
+	std::uint64_t mStored;
+};
+
+} /*namespace tstorage*/
+
+#include "SamplePacker.tpp"
+
+#endif
@@ -0,0 +1,287 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SamplePacker.tpp
+ *   An implementation of the `SamplePacker<T>` and `PackedSamplesReader<T>`
+ *   classes.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SAMPLEPACKER_TPP
+#define D_TSTORAGE_SAMPLEPACKER_TPP
+
+#ifndef D_TSTORAGE_SAMPLEPACKER_H
+#error __FILE__ was included from outside of "SamplePacker.h"
+#include "SamplePacker.h"  // clangd integration
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "BlobRecordsSet.h"
+#include "Channel.h"
+#include "DataTypes.h"
+#include "NumericPayloadTypes.h"
+#include "RecordsIndex.h"
+#include "RecordsSet.h"
+#include "Response.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Implements the `SamplePacker<T>` and `PackedSamplesReader<T>`
+ * classes. */
+
+namespace tstorage {
+
+template<typename T>
+PackedSamplesReader<T>::PackedSamplesReader(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+	: mKey(key)
+	, mInput(static_cast<const unsigned char*>(payload))
+	, mInputEnd(static_cast<const unsigned char*>(payload) + payloadSize)
+	, mFirst(true)
+	, mFailed(payloadSize == 0)
+{
+}
+
+template<typename T>
+bool PackedSamplesReader<T>::next(Record<T>& oSample)
+{
+	using BitsT = typename impl::UnsignedOfSize<sizeof(T)>::type;
+
+	if (mFailed || mInput == mInputEnd) {
+		return false;
+	}
+	if (!mFirst) {
+		std::uint64_t delta = 0;
+		if (!impl::readVarint(delta, mInput, mInputEnd) || delta == 0
+			|| delta > static_cast<std::uint64_t>(Key::cCapMax - mKey.cap)) {
+			mFailed = true;
+			return false;
+		}
+		mKey.cap += static_cast<Key::CapT>(delta);
+	}
+	if (static_cast<std::size_t>(mInputEnd - mInput) < sizeof(T)) {
+		mFailed = true;
+		return false;
+	}
+	BitsT bits;
+	std::memcpy(&bits, mInput, sizeof(T));
+	if (!impl::cLittleEndianHost) {
+		bits = impl::byteSwap(bits);
+	}
+	std::memcpy(&oSample.value, &bits, sizeof(T));
+	oSample.key = mKey;
+	mInput += sizeof(T);
+	mFirst = false;
+	return true;
+}
+
+template<typename T>
+SamplePacker<T>::SamplePacker(Channel<T>& channel, const SamplePackingOptions& options)
+	: mChannel(channel)
+	, mOptions(options)
+	, mWithAcq(false)
+	, mReceived(0)
+	, mStored(0)
+{
+}
+
+template<typename T>
+Response SamplePacker<T>::put(const RecordsSet<T>& data)
+{
+	return store(data, false);
+}
+
+template<typename T>
+Response SamplePacker<T>::puta(const RecordsSet<T>& data)
+{
+	return store(data, true);
+}
+
+template<typename T>
+Response SamplePacker<T>::flush()
+{
+	for (auto& series : mSeries) {
+		State& state = series.second;
+		if (state.samples != 0) {
+			close(state);
+		}
+	}
+	return send(mWithAcq);
+}
+
+template<typename T>
+ResponseGet<T> SamplePacker<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	BlobRecordsSet blobs;
+	const ResponseAcq response = mChannel.getBlob(widened(keyMin), keyMax, blobs);
+	if (response.error()) {
+		return ResponseGet<T>(response.status());
+	}
+	RecordsSet<T> samples;
+	if (!unpack(blobs, keyMin, keyMax, samples)) {
+		return ResponseGet<T>(result_t::DESERIALIZATION_ERROR);
+	}
+	return ResponseGet<T>(result_t::OK, std::move(samples), response.acq());
+}
+
+template<typename T>
+ResponseAcq SamplePacker<T>::getStream(const Key& keyMin,
+	const Key& keyMax,
+	const std::function<void(RecordsSet<T>&)>& callback)
+{
+	bool malformed = false;
+	RecordsSet<T> samples;
+	const ResponseAcq response = mChannel.getStreamBlob(widened(keyMin), keyMax,
+		[&keyMin, &keyMax, &callback, &malformed, &samples](BlobRecordsSet& batch) {
+			if (malformed) {
+				return;
+			}
+			samples.clear();
+			if (!unpack(batch, keyMin, keyMax, samples)) {
+				malformed = true;
+				return;
+			}
+			if (samples.size() != 0) {
+				callback(samples);
+			}
+		});
+	if (response.success() && malformed) {
+		return ResponseAcq(result_t::DESERIALIZATION_ERROR);
+	}
+	return response;
+}
+
+template<typename T>
+Response SamplePacker<T>::store(const RecordsSet<T>& data, const bool withAcq)
+{
+	mWithAcq = withAcq;
+	mReceived += data.size();
+	for (const Record<T>& sample : data) {
+		pack(sample, withAcq);
+	}
+	return send(withAcq);
+}
+
+template<typename T>
+Response SamplePacker<T>::send(const bool withAcq)
+{
+	if (mClosed.empty()) {
+		return Response(result_t::OK);
+	}
+	mRaw.clear();
+	for (const Closed& closed : mClosed) {
+		mRaw.push_back(RawRecord{closed.key, mHeap.data() + closed.offset, closed.size});
+	}
+	mStored += mClosed.size();
+	const RawRecord* const first = mRaw.data();
+	const RawRecord* const last = mRaw.data() + mRaw.size();
+	const Response res =
+		withAcq ? mChannel.putaRaw(first, last) : mChannel.putRaw(first, last);
+	mClosed.clear();
+	mHeap.clear();
+	return res;
+}
+
+template<typename T>
+void SamplePacker<T>::pack(const Record<T>& sample, const bool withAcq)
+{
+	State& state = mSeries[SeriesKey{sample.key.cid, sample.key.mid, sample.key.moid}];
+	if (state.samples != 0
+		&& (sample.key.cap <= state.lastCap
+			|| static_cast<std::uint64_t>(sample.key.cap)
+					- static_cast<std::uint64_t>(state.first.cap)
+				> static_cast<std::uint64_t>(mOptions.maxSpan)
+			|| (withAcq && sample.key.acq != state.first.acq))) {
+		close(state);
+	}
+
+	if (state.samples == 0) {
+		state.first = sample.key;
+	} else {
+		unsigned char delta[10];
+		const std::size_t deltaSize = impl::writeVarint(
+			static_cast<std::uint64_t>(sample.key.cap) - static_cast<std::uint64_t>(state.lastCap),
+			delta);
+		state.payload.insert(state.payload.end(), delta, delta + deltaSize);
+	}
+	appendValue(state.payload, sample.value);
+	state.lastCap = sample.key.cap;
+	if (++state.samples >= mOptions.maxSamples) {
+		close(state);
+	}
+}
+
+template<typename T>
+void SamplePacker<T>::close(State& state)
+{
+	mClosed.push_back(Closed{state.first, mHeap.size(), state.payload.size()});
+	mHeap.insert(mHeap.end(), state.payload.begin(), state.payload.end());
+	state.payload.clear();
+	state.samples = 0;
+}
+
+template<typename T>
+void SamplePacker<T>::appendValue(std::vector<unsigned char>& payload, const T value)
+{
+	using BitsT = typename impl::UnsignedOfSize<sizeof(T)>::type;
+
+	BitsT bits;
+	std::memcpy(&bits, &value, sizeof(T));
+	if (!impl::cLittleEndianHost) {
+		bits = impl::byteSwap(bits);
+	}
+	const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(&bits);
+	payload.insert(payload.end(), bytes, bytes + sizeof(T));
+}
+
+template<typename T>
+bool SamplePacker<T>::unpack(const BlobRecordsSet& blobs,
+	const Key& keyMin,
+	const Key& keyMax,
+	RecordsSet<T>& oSamples)
+{
+	Record<T> sample{};
+	for (std::size_t i = 0; i < blobs.size(); ++i) {
+		PackedSamplesReader<T> reader(blobs.key(i), blobs.payload(i), blobs.payloadSize(i));
+		while (reader.next(sample)) {
+			if (sample.key.cap >= keyMin.cap && sample.key.cap < keyMax.cap) {
+				oSamples.append(sample);
+			}
+		}
+		if (reader.failed()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template<typename T>
+Key SamplePacker<T>::widened(const Key& keyMin) const
+{
+	Key key = keyMin;
+	key.cap = keyMin.cap > Key::cCapMin + mOptions.maxSpan ? keyMin.cap - mOptions.maxSpan
+															: Key::cCapMin;
+	return key;
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SeriesCompressor.h
+ *   Deadband and swinging-door compression of numeric series before PUT.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SERIESCOMPRESSOR_H
+#define D_TSTORAGE_SERIESCOMPRESSOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "RecordsIndex.h"
+#include "RecordsSet.h"
+#include "Response.h"
+
+/** @file
+ * @brief Defines the `SeriesCompressor<T>` class. */
+
+namespace tstorage {
+
+/** @brief The compression method of a `SeriesCompressor<T>`. */
+enum class SeriesCompression
+{
+	/** @brief Stores a record if its value differs from the one of the last
+	 * stored record by more than the tolerance. */
+	DEADBAND,
+	/** @brief Stores the records a piecewise linear interpolation of the
+	 * series within the tolerance needs (the swinging-door algorithm). */
+	SWINGING_DOOR
+};
+
+/** @brief The options of a `SeriesCompressor<T>`. */
+struct SeriesCompressionOptions
+{
+	/** @brief The compression method. */
+	SeriesCompression method = SeriesCompression::SWINGING_DOOR;
+	/** @brief The largest deviation of a dropped value, in the units of the
+	 * values. */
+	double tolerance = 0.0;
+	/** @brief The largest CAP distance between two stored records of a
+	 * series, `0` for none. */
+	Key::CapT maxGap = 0;
+};
+
+/**
+ * @brief A front end of a channel dropping the records of numeric series that
+ * a tolerance allows to leave out, before they are stored with PUT or PUTA.
+ *
+ * Sensors sampling at a fixed rate mostly report values which differ from
+ * the previous ones by less than their accuracy. The compressor keeps the
+ * state of each series, i.e. of each `(cid, mid, moid)`, and passes on to
+ * the channel only the records needed to reconstruct the series within
+ * `SeriesCompressionOptions::tolerance`:
+ *  - with `SeriesCompression::DEADBAND`, the records whose values leave the
+ *    band of the tolerance around the last stored value;
+ *  - with `SeriesCompression::SWINGING_DOOR`, the vertices of a piecewise
+ *    linear interpolation of the series: a record is held back as long as
+ *    the line from the last stored record to it passes within the tolerance
+ *    of all records in between, and is stored once the line to the next
+ *    record does not. Every dropped value thus lies within the tolerance of
+ *    the line between the stored records around it.
+ *
+ * The first record of each series is always stored, as is a record whose
+ * CAP is further than `SeriesCompressionOptions::maxGap` from the last stored
+ * one, so that readers can tell a flat series from a silent one. The records
+ * of a series have to come in increasing CAP order; a record which does not
+ * is stored as is and restarts the compression of its series.
+ *
+ * The records held back by the swinging door are stored by a later call, or
+ * by `flush()`, which the caller should invoke before closing the channel.
+ * A failed request loses its records, but the compressor counts them as
+ * stored; `reset()` restarts all series afterwards.
+ *
+ * Like the channel, the compressor is not thread-safe. The channel must be
+ * connected beforehand and must outlive the compressor.
+ *
+ * @tparam T Internal data type of the payload, an arithmetic type.
+ */
+template<typename T>
+class SeriesCompressor final
+{
+	static_assert(std::is_arithmetic<T>::value, "Only numeric series can be compressed");
+
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param channel The channel storing the records.
+	 * @param options The compression options.
+	 */
+	SeriesCompressor(Channel<T>& channel, const SeriesCompressionOptions& options);
+
+	SeriesCompressor(const SeriesCompressor&) = delete;
+	SeriesCompressor(SeriesCompressor&&) = delete;
+	SeriesCompressor& operator=(const SeriesCompressor&) = delete;
+	SeriesCompressor& operator=(SeriesCompressor&&) = delete;
+
+	/**
+	 * @brief Stores the records of `data` the compression keeps, along with
+	 * the held-back records they release, with `Channel<T>::put()`.
+	 *
+	 * @return The response of `Channel<T>::put()`, or a success code if no
+	 * record was to be stored.
+	 */
+	Response put(const RecordsSet<T>& data);
+	/**
+	 * @brief Stores the records of `data` the compression keeps, along with
+	 * the held-back records they release, with `Channel<T>::puta()`.
+	 *
+	 * @return The response of `Channel<T>::puta()`, or a success code if no
+	 * record was to be stored.
+	 */
+	Response puta(const RecordsSet<T>& data);
+	/**
+	 * @brief Stores the records held back by the swinging door, with the
+	 * protocol of the last `put()` or `puta()` call.
+	 *
+	 * @return The response of the request, or a success code if no record
+	 * was held back.
+	 */
+	Response flush();
+	/** @brief Drops the state of all series, records held back included. */
+	void reset() { mSeries.clear(); }
+
+	/** @brief Returns the amount of records passed to the compressor. */
+	std::uint64_t received() const { return mReceived; }
+	/** @brief Returns the amount of records passed on to the channel. */
+	std::uint64_t stored() const { return mStored; }
+
+private:
+	/** @brief The state of a series. */
+	struct State
+	{
+		/** @brief The last stored record. */
+		Record<T> archived;
+		/** @brief The record held back by the swinging door. */
+		Record<T> held;
+		/** @brief `true` while `held` is valid. */
+		bool holding;
+		/** @brief The slope of the upper door, the smallest one from
+		 * `archived` to the upper edges of the tolerance since. */
+		double upperSlope;
+		/** @brief The slope of the lower door, the largest one from
+		 * `archived` to the lower edges of the tolerance since. */
+		double lowerSlope;
+	};
+	/** @brief Hashes a series for `std::unordered_map`. */
+	struct SeriesHash
+	{
+		/** @brief Returns the hash of `series`. */
+		std::size_t operator()(const SeriesKey& series) const { return series.hash(); }
+	};
+
+	/** @brief Compresses `data` and stores the kept records with PUT or
+	 * PUTA. */
+	Response store(const RecordsSet<T>& data, bool withAcq);
+	/** @brief Sends `mBatch` with PUT or PUTA, then clears it. */
+	Response send(bool withAcq);
+	/** @brief Passes a record through the compression of its series. */
+	void compress(const Record<T>& record);
+	/** @brief Stores `record` as the last one of a series. */
+	void archive(State& state, const Record<T>& record);
+	/** @brief Opens the doors of the swinging door at `record`. */
+	void open(State& state, const Record<T>& record);
+
+	/** @brief The channel storing the records. */
+	Channel<T>& mChannel;
+	/** @brief The compression options. */
+	SeriesCompressionOptions mOptions;
+	/** @brief The states of the series. */
+	std::unordered_map<SeriesKey, State, SeriesHash> mSeries;
+	/** @brief The records to store. */
+	RecordsSet<T> mBatch;
+	/** @brief `true` if the last call stored its records with PUTA. */
+	bool mWithAcq;
+	/** @brief The amount of records passed to the compressor. */
+	std::uint64_t mReceived;
+	/** @brief The amount of records passed on to the channel. */
+	std::uint64_t mStored;
+};
+
+} /*namespace tstorage*/
+
+#include "SeriesCompressor.tpp"
+
+#endif
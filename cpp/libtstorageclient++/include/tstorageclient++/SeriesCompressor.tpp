@@ -0,0 +1,182 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SeriesCompressor.tpp
+ *   An implementation of the `SeriesCompressor<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SERIESCOMPRESSOR_TPP
+#define D_TSTORAGE_SERIESCOMPRESSOR_TPP
+
+#ifndef D_TSTORAGE_SERIESCOMPRESSOR_H
+#error __FILE__ was included from outside of "SeriesCompressor.h"
+#include "SeriesCompressor.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "RecordsIndex.h"
+#include "RecordsSet.h"
+#include "Response.h"
+
+/** @file
+ * @brief Implements the `SeriesCompressor<T>` class. */
+
+namespace tstorage {
+
+template<typename T>
+SeriesCompressor<T>::SeriesCompressor(
+	Channel<T>& channel, const SeriesCompressionOptions& options)
+	: mChannel(channel)
+	, mOptions(options)
+	, mWithAcq(false)
+	, mReceived(0)
+	, mStored(0)
+{
+}
+
+template<typename T>
+Response SeriesCompressor<T>::put(const RecordsSet<T>& data)
+{
+	return store(data, false);
+}
+
+template<typename T>
+Response SeriesCompressor<T>::puta(const RecordsSet<T>& data)
+{
+	return store(data, true);
+}
+
+template<typename T>
+Response SeriesCompressor<T>::flush()
+{
+	for (auto& series : mSeries) {
+		State& state = series.second;
+		if (state.holding) {
+			archive(state, state.held);
+		}
+	}
+	return send(mWithAcq);
+}
+
+template<typename T>
+Response SeriesCompressor<T>::store(const RecordsSet<T>& data, const bool withAcq)
+{
+	mWithAcq = withAcq;
+	mReceived += data.size();
+	for (const Record<T>& record : data) {
+		compress(record);
+	}
+	return send(withAcq);
+}
+
+template<typename T>
+Response SeriesCompressor<T>::send(const bool withAcq)
+{
+	if (mBatch.size() == 0) {
+		return Response(result_t::OK);
+	}
+	mStored += mBatch.size();
+	const Response res = withAcq ? mChannel.puta(mBatch) : mChannel.put(mBatch);
+	mBatch.clear();
+	return res;
+}
+
+template<typename T>
+void SeriesCompressor<T>::compress(const Record<T>& record)
+{
+	const SeriesKey series{record.key.cid, record.key.mid, record.key.moid};
+	const auto found = mSeries.find(series);
+	if (found == mSeries.end()) {
+		State& state = mSeries[series];
+		archive(state, record);
+		return;
+	}
+	State& state = found->second;
+	if (record.key.cap <= state.archived.key.cap
+		|| (state.holding && record.key.cap <= state.held.key.cap)) {
+		// Out of order: store what is held and restart from the record.
+		if (state.holding) {
+			archive(state, state.held);
+		}
+		archive(state, record);
+		return;
+	}
+	if (mOptions.maxGap > 0 && record.key.cap - state.archived.key.cap > mOptions.maxGap) {
+		if (state.holding) {
+			archive(state, state.held);
+		}
+		if (record.key.cap - state.archived.key.cap > mOptions.maxGap) {
+			archive(state, record);
+			return;
+		}
+	}
+
+	const double value = static_cast<double>(record.value);
+	const double archived = static_cast<double>(state.archived.value);
+	if (mOptions.method == SeriesCompression::DEADBAND) {
+		if (std::fabs(value - archived) > mOptions.tolerance) {
+			archive(state, record);
+		}
+		return;
+	}
+
+	if (!state.holding) {
+		open(state, record);
+		return;
+	}
+	const double dt = static_cast<double>(record.key.cap - state.archived.key.cap);
+	const double slope = (value - archived) / dt;
+	if (slope > state.upperSlope || slope < state.lowerSlope) {
+		// The line to the record leaves the doors, i.e. the tolerance of a
+		// record since the archived one, so the held one is a vertex.
+		archive(state, state.held);
+		open(state, record);
+		return;
+	}
+	state.upperSlope = std::min(state.upperSlope, (value + mOptions.tolerance - archived) / dt);
+	state.lowerSlope = std::max(state.lowerSlope, (value - mOptions.tolerance - archived) / dt);
+	state.held = record;
+}
+
+template<typename T>
+void SeriesCompressor<T>::archive(State& state, const Record<T>& record)
+{
+	mBatch.append(record);
+	state.archived = record;
+	state.holding = false;
+}
+
+template<typename T>
+void SeriesCompressor<T>::open(State& state, const Record<T>& record)
+{
+	const double dt = static_cast<double>(record.key.cap - state.archived.key.cap);
+	const double value = static_cast<double>(record.value);
+	const double archived = static_cast<double>(state.archived.value);
+	state.upperSlope = (value + mOptions.tolerance - archived) / dt;
+	state.lowerSlope = (value - mOptions.tolerance - archived) / dt;
+	state.held = record;
+	state.holding = true;
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SeriesSet.h
+ *   A series-oriented container for records.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SERIESSET_H
+#define D_TSTORAGE_SERIESSET_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DataTypes.h"
+#include "RecordsIndex.h"
+
+/** @file
+ * @brief Defines a series-oriented container for records. */
+
+namespace tstorage {
+
+/**
+ * @brief A container for inbound records grouped by series, with contiguous
+ * CAP, ACQ and value arrays per series.
+ *
+ * Plotting, interpolation and most other per-series processing want the
+ * `(cap, value)` arrays of each `(cid, mid, moid)` series, rather than the
+ * records of all series interleaved. The set appends each record to the
+ * arrays of its series as it is received, so no regrouping pass over a
+ * `RecordsSet<T>` is needed. A GET response comes ordered by series, so the
+ * series of a record is found by comparing it with that of the previous one,
+ * and only the first record of each series goes through the hash table of
+ * series. Within a series, the records keep the order they were received in,
+ * i.e. increasing CAP for a GET response.
+ *
+ * A default-constructible, copyable and moveable container. It can be filled
+ * directly by `Channel<T>::getSeries()` and `Channel<T>::getStreamSeries()`.
+ * `clear()` keeps the arrays of the series for reuse, so that the batches of
+ * a stream over the same series do not reallocate them.
+ *
+ * Note: as with any `std::vector`, the value array is not a contiguous array
+ * of values for `T = bool`.
+ *
+ * @tparam T Payload type of stored records.
+ */
+template<typename T>
+class SeriesSet final
+{
+public:
+	/** @brief The records of a series. */
+	struct Series
+	{
+		/** @brief The identity of the series. */
+		SeriesKey id;
+		/** @brief The CAP timestamps of the records. */
+		std::vector<Key::CapT> caps;
+		/** @brief The ACQ timestamps of the records. */
+		std::vector<Key::AcqT> acqs;
+		/** @brief The payloads of the records. */
+		std::vector<T> values;
+	};
+
+	/**
+	 * @brief Appends a record to the arrays of its series. The payload is
+	 * constructed in-place using the forwarded arguments.
+	 *
+	 * @param key Key of the new record.
+	 * @param args Arguments to the constructor of the new record's payload.
+	 * @tparam U A template parameter pack with types of the arguments passed to
+	 * the constructor of the payload.
+	 */
+	template<typename... U>
+	void append(const Key& key, U&&... args)
+	{
+		Series& series = seriesOf(key);
+		series.caps.push_back(key.cap);
+		series.acqs.push_back(key.acq);
+		series.values.emplace_back(std::forward<U>(args)...);
+		++mSize;
+	}
+
+	/**
+	 * @brief Appends a record to the arrays of its series, moving its payload.
+	 * @param record The record to append.
+	 */
+	void append(Record<T>&& record) { append(record.key, std::move(record.value)); }
+
+	/**
+	 * @brief Appends a copy of a record to the arrays of its series.
+	 * @param record The record to append.
+	 */
+	void append(const Record<T>& record) { append(record.key, record.value); }
+
+	/** @brief Returns the number of records currently stored in the container. */
+	std::size_t size() const { return mSize; }
+	/** @brief Returns the number of series currently stored in the container. */
+	std::size_t seriesCount() const { return mCount; }
+
+	/**
+	 * @brief Does nothing, as the split of `count` records into series is not
+	 * known in advance. The arrays of the series grow amortized, and those
+	 * kept by `clear()` are reused.
+	 */
+	void reserve(const std::size_t /*count*/) {}
+
+	/**
+	 * @brief Removes all records from the container. The arrays of the series
+	 * are retained for reuse.
+	 */
+	void clear()
+	{
+		for (std::size_t i = 0; i < mCount; ++i) {
+			mSeries[i].caps.clear();
+			mSeries[i].acqs.clear();
+			mSeries[i].values.clear();
+		}
+		mIndex.clear();
+		mCount = 0;
+		mSize = 0;
+		mLast = 0;
+	}
+
+	/**
+	 * @brief Returns the `i`-th series, in the order of their first records.
+	 * @param i Index of the series, less than `seriesCount()`.
+	 */
+	const Series& series(const std::size_t i) const { return mSeries[i]; }
+	/**
+	 * @brief Returns the series of the given identity, `nullptr` if the set
+	 * holds no records of it.
+	 */
+	const Series* find(const Key::CidT cid, const Key::MidT mid, const Key::MoidT moid) const
+	{
+		const auto it = mIndex.find(SeriesKey{cid, mid, moid});
+		return it != mIndex.end() ? &mSeries[it->second] : nullptr;
+	}
+
+	/** @brief Returns an iterator to the first series. */
+	typename std::vector<Series>::const_iterator begin() const { return mSeries.begin(); }
+	/** @brief Returns an iterator past the last series. */
+	typename std::vector<Series>::const_iterator end() const
+	{
+		return mSeries.begin() + static_cast<std::ptrdiff_t>(mCount);
+	}
+
+private:
+	/** @brief Hashes a series for `std::unordered_map`. */
+	struct SeriesHash
+	{
+		/** @brief Returns the hash of `series`. */
+		std::size_t operator()(const SeriesKey& series) const { return series.hash(); }
+	};
+
+	/** @brief Returns the series of `key`, adding it if need be. */
+	Series& seriesOf(const Key& key)
+	{
+		const SeriesKey id{key.cid, key.mid, key.moid};
+		if (mLast < mCount && mSeries[mLast].id == id) {
+			return mSeries[mLast];
+		}
+		const auto inserted = mIndex.emplace(id, mCount);
+		mLast = inserted.first->second;
+		if (inserted.second) {
+			if (mCount == mSeries.size()) {
+				mSeries.emplace_back();
+			}
+			mSeries[mCount].id = id;
+			++mCount;
+		}
+		return mSeries[mLast];
+	}
+
+	/** @brief The series, the first `mCount` ones in use, the others kept
+	 * for reuse. */
+	std::vector<Series> mSeries;
+	/** @brief The indexes of the series in use by their identities. */
+	std::unordered_map<SeriesKey, std::size_t, SeriesHash> mIndex;
+	/** @brief The amount of series in use. */
+	std::size_t mCount = 0;
+	/** @brief The amount of records. */
+	std::size_t mSize = 0;
+	/** @brief The index of the series of the last record. */
+	std::size_t mLast = 0;
+};
+
+} /*namespace tstorage*/
+
+#endif
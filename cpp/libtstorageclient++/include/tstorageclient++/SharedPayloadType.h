@@ -0,0 +1,84 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SharedPayloadType.h
+ *   A PayloadType adapter sharing one serializer between several channels.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SHAREDPAYLOADTYPE_H
+#define D_TSTORAGE_SHAREDPAYLOADTYPE_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "PayloadType.h"
+
+/** @file
+ * @brief Defines the `SharedPayloadType<T>` adapter. */
+
+namespace tstorage {
+
+/**
+ * @brief A `PayloadType<T>` forwarding all calls to a shared instance.
+ *
+ * Each `Channel<T>` owns its `PayloadType<T>` object. This adapter allows
+ * several channels (e.g. the ones managed by a `ChannelPool<T>`) to use one
+ * and the same serializer instead. Since the channels might be used by
+ * different threads at the same time, the shared instance must be safe to
+ * call concurrently, which is trivially the case for stateless payload
+ * types.
+ *
+ * @tparam T Payload data type.
+ */
+template<typename T>
+class SharedPayloadType final : public PayloadType<T>
+{
+public:
+	/**
+	 * @brief A constructor.
+	 * @param payloadType The shared instance to forward the calls to.
+	 */
+	explicit SharedPayloadType(std::shared_ptr<PayloadType<T>> payloadType)
+		: mPayloadType(std::move(payloadType))
+	{
+	}
+
+	/** @brief Forwards to `PayloadType::toBytes()` of the shared instance. */
+	std::size_t toBytes(const T& val, void* outputBuffer, std::size_t bufferSize) override
+	{
+		return mPayloadType->toBytes(val, outputBuffer, bufferSize);
+	}
+	/** @brief Forwards to `PayloadType::fromBytes()` of the shared instance. */
+	bool fromBytes(T& oVar, const void* payloadBuffer, std::size_t payloadSize) override
+	{
+		return mPayloadType->fromBytes(oVar, payloadBuffer, payloadSize);
+	}
+	/** @brief Forwards to `PayloadType::toView()` of the shared instance. */
+	bool toView(const T& val, const void*& oData, std::size_t& oSize) override
+	{
+		return mPayloadType->toView(val, oData, oSize);
+	}
+
+private:
+	/** @brief The shared instance. */
+	std::shared_ptr<PayloadType<T>> mPayloadType;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,202 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * Snapshot.h
+ *   Consistent reads of several key-intervals pinned to one ACQ.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SNAPSHOT_H
+#define D_TSTORAGE_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "RecordsSet.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Defines the `Snapshot<T>` class. */
+
+namespace tstorage {
+
+/**
+ * @brief A GET front end of a channel reading several key-intervals as of a
+ * single full-commit ACQ.
+ *
+ * The records of a key-interval with ACQs below its full-commit ACQ never
+ * change (see `Channel<T>::getAcq()`). Reads of several key-intervals, e.g.
+ * the panels of a dashboard, are consistent with each other if they all
+ * leave out the records from one such ACQ on. `pin()` fetches the
+ * full-commit ACQs of the key-intervals to be read, pipelined in a single
+ * round trip, and pins the snapshot to the smallest of them, which is a
+ * full-commit ACQ of all of them. `get()` and `getBatch()` then clamp the
+ * `keyMax.acq` of each query to the pinned ACQ, so the queries return the
+ * records of the same point in time, however many records are stored in
+ * the meantime.
+ *
+ * As the records below the pinned ACQ are immutable, the responses are
+ * cached for as long as the snapshot stays pinned to the same ACQ, and a
+ * repeated query is served without a request. The memory taken by the
+ * cached records is bounded; the responses which do not fit are not cached.
+ * It is estimated as `sizeof(Record<T>)` per record, not counting the memory
+ * the payloads may own.
+ *
+ * The consistency holds for the key-intervals within those passed to
+ * `pin()`; outside of them, the pinned ACQ need not be a full-commit one.
+ * To read with several channels in parallel, pin one snapshot and pin those
+ * of the other channels with `pinAt()` to its `acq()`.
+ *
+ * Like the channel, the snapshot is not thread-safe. The channel must be
+ * connected beforehand and must outlive the snapshot.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class Snapshot final
+{
+public:
+	/**
+	 * @brief A constructor of a snapshot not pinned yet.
+	 *
+	 * @param channel The channel fetching the records.
+	 * @param capacityBytes The memory bound of the cached records.
+	 */
+	Snapshot(Channel<T>& channel, std::size_t capacityBytes);
+
+	Snapshot(const Snapshot&) = delete;
+	Snapshot(Snapshot&&) = delete;
+	Snapshot& operator=(const Snapshot&) = delete;
+	Snapshot& operator=(Snapshot&&) = delete;
+
+	/**
+	 * @brief Pins the snapshot to the full-commit ACQ of a key-interval.
+	 *
+	 * The possible error codes are those of `Channel<T>::getAcq()`. A failed
+	 * call leaves the snapshot unpinned.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with the pinned ACQ on
+	 * success, `ResponseAcq(err)` with an error code `err` otherwise.
+	 */
+	ResponseAcq pin(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Pins the snapshot to the smallest of the full-commit ACQs of
+	 * several key-intervals, fetched with `Channel<T>::getAcqBatch()`.
+	 *
+	 * The possible error codes are those of `Channel<T>::getAcqBatch()`, and
+	 * `result_t::EMPTY_KEY_RANGE` if `ranges` is empty. A failed call leaves
+	 * the snapshot unpinned.
+	 *
+	 * @return `ResponseAcq(result_t::OK, acq)` with the pinned ACQ on
+	 * success, the first failed response otherwise.
+	 */
+	ResponseAcq pin(const std::vector<KeyRange>& ranges);
+	/**
+	 * @brief Pins the snapshot to a given ACQ, e.g. the `acq()` of another
+	 * snapshot, without a request.
+	 */
+	void pinAt(Key::AcqT acq);
+	/** @brief Unpins the snapshot and drops the cached responses. */
+	void unpin();
+
+	/** @brief Returns `true` if the snapshot is pinned. */
+	bool pinned() const { return mPinned; }
+	/** @brief Returns the pinned ACQ, valid if `pinned()`. */
+	Key::AcqT acq() const { return mAcq; }
+
+	/**
+	 * @brief Retrieves the records of a key-interval like
+	 * `Channel<T>::get()`, leaving out those with ACQs from the pinned one
+	 * on.
+	 *
+	 * A key-interval whose ACQs all lie at or above the pinned one gets an
+	 * empty response. The response carries the pinned ACQ. The possible
+	 * error codes are those of `Channel<T>::get()`, and
+	 * `result_t::NOT_CONNECTED` if the snapshot is not pinned.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @param keyMax The upper vertex of the right-open key-interval
+	 * containing the desired data.
+	 *
+	 * @return The response as in `Channel<T>::get()`.
+	 */
+	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Retrieves the records of several key-intervals like `get()`,
+	 * pipelining the requests of those not cached with
+	 * `Channel<T>::getBatch()`, in a single round trip.
+	 *
+	 * The possible error codes are those of `Channel<T>::getBatch()`, and
+	 * `result_t::NOT_CONNECTED` if the snapshot is not pinned.
+	 *
+	 * @param ranges The target key-intervals.
+	 * @return The responses, one per key-interval.
+	 */
+	std::vector<ResponseGet<T>> getBatch(const std::vector<KeyRange>& ranges);
+
+	/** @brief Returns the estimated memory taken by the cached records. */
+	std::size_t cachedBytes() const { return mCachedBytes; }
+	/** @brief Returns the amount of queries served from the cache. */
+	std::uint64_t hits() const { return mHits; }
+	/** @brief Returns the amount of queries sent to the server. */
+	std::uint64_t misses() const { return mMisses; }
+
+private:
+	/** @brief A key-interval with its upper ACQ clamped to the pinned one. */
+	using RangeId = std::pair<Key, Key>;
+
+	/** @brief Returns the key-interval to fetch for a query. */
+	RangeId clamp(const Key& keyMin, const Key& keyMax) const;
+	/** @brief Returns `true` if the clamped query is empty while the
+	 * original one is not, i.e. it asks only for records after the pinned
+	 * ACQ. */
+	static bool clampedAway(const Key& keyMin, const Key& keyMax, const RangeId& range);
+	/** @brief Returns the cached response to a query, `nullptr` if none. */
+	const RecordsSet<T>* cached(const RangeId& range);
+	/** @brief Caches a successful response if it fits. */
+	void cache(const RangeId& range, const ResponseGet<T>& response);
+
+	/** @brief The channel fetching the records. */
+	Channel<T>& mChannel;
+	/** @brief The memory bound of the cached records. */
+	std::size_t mCapacityBytes;
+	/** @brief The estimated memory taken by the cached records. */
+	std::size_t mCachedBytes;
+	/** @brief `true` if the snapshot is pinned. */
+	bool mPinned;
+	/** @brief The pinned ACQ. */
+	Key::AcqT mAcq;
+	/** @brief The cached responses by their clamped key-intervals. */
+	std::map<RangeId, RecordsSet<T>> mCache;
+	/** @brief The amount of queries served from the cache. */
+	std::uint64_t mHits;
+	/** @brief The amount of queries sent to the server. */
+	std::uint64_t mMisses;
+};
+
+} /*namespace tstorage*/
+
+#include "Snapshot.tpp"
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * Snapshot.tpp
+ *   An implementation of the `Snapshot<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SNAPSHOT_TPP
+#define D_TSTORAGE_SNAPSHOT_TPP
+
+#ifndef D_TSTORAGE_SNAPSHOT_H
+#error __FILE__ was included from outside of "Snapshot.h"
+#include "Snapshot.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Channel.h"
+#include "DataTypes.h"
+#include "RecordsSet.h"
+#include "ResponseAcq.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Contains the implementation of `Snapshot<T>`. */
+
+namespace tstorage {
+
+template<typename T>
+Snapshot<T>::Snapshot(Channel<T>& channel, const std::size_t capacityBytes)
+	: mChannel(channel)
+	, mCapacityBytes(capacityBytes)
+	, mCachedBytes(0)
+	, mPinned(false)
+	, mAcq(0)
+	, mHits(0)
+	, mMisses(0)
+{
+}
+
+template<typename T>
+ResponseAcq Snapshot<T>::pin(const Key& keyMin, const Key& keyMax)
+{
+	unpin();
+	const ResponseAcq response = mChannel.getAcq(keyMin, keyMax);
+	if (response.success()) {
+		pinAt(response.acq());
+	}
+	return response;
+}
+
+template<typename T>
+ResponseAcq Snapshot<T>::pin(const std::vector<KeyRange>& ranges)
+{
+	unpin();
+	if (ranges.empty()) {
+		return ResponseAcq(result_t::EMPTY_KEY_RANGE);
+	}
+	const std::vector<ResponseAcq> responses = mChannel.getAcqBatch(ranges);
+	Key::AcqT acq = responses.front().acq();
+	for (const ResponseAcq& response : responses) {
+		if (response.error()) {
+			return response;
+		}
+		acq = std::min(acq, response.acq());
+	}
+	pinAt(acq);
+	return ResponseAcq(result_t::OK, acq);
+}
+
+template<typename T>
+void Snapshot<T>::pinAt(const Key::AcqT acq)
+{
+	if (!mPinned || acq != mAcq) {
+		unpin();
+	}
+	mPinned = true;
+	mAcq = acq;
+}
+
+template<typename T>
+void Snapshot<T>::unpin()
+{
+	mPinned = false;
+	mCache.clear();
+	mCachedBytes = 0;
+}
+
+template<typename T>
+ResponseGet<T> Snapshot<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	if (!mPinned) {
+		return ResponseGet<T>(result_t::NOT_CONNECTED);
+	}
+	const RangeId range = clamp(keyMin, keyMax);
+	if (clampedAway(keyMin, keyMax, range)) {
+		return ResponseGet<T>(result_t::OK, RecordsSet<T>{}, mAcq);
+	}
+	if (const RecordsSet<T>* records = cached(range)) {
+		return ResponseGet<T>(result_t::OK, *records, mAcq);
+	}
+	++mMisses;
+	ResponseGet<T> response = mChannel.get(range.first, range.second);
+	if (response.error()) {
+		return response;
+	}
+	cache(range, response);
+	return ResponseGet<T>(result_t::OK, std::move(response.records()), mAcq);
+}
+
+template<typename T>
+std::vector<ResponseGet<T>> Snapshot<T>::getBatch(const std::vector<KeyRange>& ranges)
+{
+	std::vector<ResponseGet<T>> responses;
+	responses.reserve(ranges.size());
+	if (!mPinned) {
+		responses.assign(ranges.size(), ResponseGet<T>(result_t::NOT_CONNECTED));
+		return responses;
+	}
+
+	std::vector<KeyRange> fetched;
+	std::vector<std::size_t> fetchedIndexes;
+	for (std::size_t i = 0; i < ranges.size(); ++i) {
+		const RangeId range = clamp(ranges[i].keyMin, ranges[i].keyMax);
+		const RecordsSet<T>* records = nullptr;
+		if (clampedAway(ranges[i].keyMin, ranges[i].keyMax, range)) {
+			responses.emplace_back(result_t::OK, RecordsSet<T>{}, mAcq);
+		} else if ((records = cached(range)) != nullptr) {
+			responses.emplace_back(result_t::OK, *records, mAcq);
+		} else {
+			++mMisses;
+			responses.emplace_back(result_t::OK);
+			fetched.push_back(KeyRange{range.first, range.second});
+			fetchedIndexes.push_back(i);
+		}
+	}
+	if (fetched.empty()) {
+		return responses;
+	}
+
+	std::vector<ResponseGet<T>> fetchedResponses = mChannel.getBatch(fetched);
+	for (std::size_t j = 0; j < fetched.size(); ++j) {
+		ResponseGet<T>& response = fetchedResponses[j];
+		ResponseGet<T>& target = responses[fetchedIndexes[j]];
+		if (response.error()) {
+			target = std::move(response);
+			continue;
+		}
+		cache(RangeId(fetched[j].keyMin, fetched[j].keyMax), response);
+		target = ResponseGet<T>(result_t::OK, std::move(response.records()), mAcq);
+	}
+	return responses;
+}
+
+template<typename T>
+typename Snapshot<T>::RangeId Snapshot<T>::clamp(const Key& keyMin, const Key& keyMax) const
+{
+	RangeId range(keyMin, keyMax);
+	range.second.acq = std::min(keyMax.acq, mAcq);
+	return range;
+}
+
+template<typename T>
+bool Snapshot<T>::clampedAway(const Key& keyMin, const Key& keyMax, const RangeId& range)
+{
+	return keyMin.acq < keyMax.acq && range.first.acq >= range.second.acq;
+}
+
+template<typename T>
+const RecordsSet<T>* Snapshot<T>::cached(const RangeId& range)
+{
+	const auto found = mCache.find(range);
+	if (found == mCache.end()) {
+		return nullptr;
+	}
+	++mHits;
+	return &found->second;
+}
+
+template<typename T>
+void Snapshot<T>::cache(const RangeId& range, const ResponseGet<T>& response)
+{
+	const std::size_t bytes = response.records().size() * sizeof(Record<T>);
+	if (mCachedBytes + bytes > mCapacityBytes) {
+		return;
+	}
+	mCache.emplace(range, response.records());
+	mCachedBytes += bytes;
+}
+
+} /*namespace tstorage*/
+
+#endif
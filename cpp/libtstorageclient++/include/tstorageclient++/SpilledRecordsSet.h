@@ -0,0 +1,154 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpilledRecordsSet.h
+ *   A container of records kept in a memory-mapped temporary file.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SPILLEDRECORDSSET_H
+#define D_TSTORAGE_SPILLEDRECORDSSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "DataTypes.h"
+#include "PayloadType.h"
+
+/** @file
+ * @brief Defines a container of records spilled to disk. */
+
+namespace tstorage {
+
+namespace impl {
+
+class SpillFile;
+
+} /*namespace impl*/
+
+/**
+ * @brief A container for inbound records with raw payloads, kept in a
+ * temporary file rather than in memory.
+ *
+ * The records are appended to an unlinked temporary file in a compact binary
+ * form, the key followed by the length-prefixed payload, through a small
+ * write buffer, and their offsets to a second one. Once the set is sealed,
+ * both files are memory-mapped for random access, so that the records are
+ * paged in from disk on demand and the payloads are decoded only when asked
+ * for (see `decode()`). The memory taken by the set is thus that of the page
+ * cache, which the kernel reclaims under pressure, and a response of any size
+ * fits as long as the disk does.
+ *
+ * Filled by `Channel<T>::getSpilled()`. A moveable, non-copyable container.
+ * The files are removed by the system when the set is destroyed, even if the
+ * process crashes. The keys, payloads and views are only accessible once the
+ * set is sealed, and are invalidated by `clear()`.
+ */
+class SpilledRecordsSet final
+{
+public:
+	/**
+	 * @brief Constructs an empty set.
+	 * @param directory The directory to create the temporary files in, the
+	 * one named by `TMPDIR` or `/tmp` if empty.
+	 */
+	explicit SpilledRecordsSet(const std::string& directory = std::string());
+	/** @brief Unmaps and removes the temporary files. */
+	~SpilledRecordsSet();
+
+	SpilledRecordsSet(const SpilledRecordsSet&) = delete;
+	SpilledRecordsSet& operator=(const SpilledRecordsSet&) = delete;
+	/** @brief A move constructor. Leaves `other` empty. */
+	SpilledRecordsSet(SpilledRecordsSet&& other) noexcept;
+	/** @brief A move-assignment operator. Leaves `other` empty. */
+	SpilledRecordsSet& operator=(SpilledRecordsSet&& other) noexcept;
+
+	/**
+	 * @brief Appends a record to the end of the temporary file, creating the
+	 * file first if necessary.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::SPILL_ERROR` if the set is sealed, or the file cannot be
+	 *    created or written to, e.g. because the disk is full.
+	 *
+	 * @param key Key of the new record.
+	 * @param payload The payload bytes.
+	 * @param size The size of the payload.
+	 * @return Status code.
+	 */
+	result_t append(const Key& key, const void* payload, std::size_t size);
+	/**
+	 * @brief Flushes the records to the file and maps it into memory, making
+	 * them accessible. Sealing a sealed set does nothing.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::SPILL_ERROR` if the file cannot be written to or mapped.
+	 *
+	 * @return Status code.
+	 */
+	result_t seal();
+	/** @brief Removes all records, truncating the files for reuse. */
+	void clear();
+
+	/** @brief Returns `true` once the records are accessible. */
+	bool sealed() const;
+	/** @brief Returns the number of records in the container. */
+	std::size_t size() const;
+	/** @brief Returns the size of the records in the file, in bytes. */
+	std::uint64_t bytes() const;
+
+	/**
+	 * @brief Returns the key of the `i`-th record.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	Key key(std::size_t i) const;
+	/**
+	 * @brief Returns the payload of the `i`-th record, a view of the mapped
+	 * file.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	const unsigned char* payload(std::size_t i) const;
+	/**
+	 * @brief Returns the payload size of the `i`-th record.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	std::size_t payloadSize(std::size_t i) const;
+	/**
+	 * @brief Deserializes the payload of the `i`-th record.
+	 *
+	 * @param i Index of the record, less than `size()`.
+	 * @param payloadType The payload type the record was stored with.
+	 * @param[out] oValue The deserialized payload.
+	 * @return `true` if deserialization was successful, `false` otherwise.
+	 */
+	template<typename T>
+	bool decode(const std::size_t i, PayloadType<T>& payloadType, T& oValue) const
+	{
+		return payloadType.fromBytes(oValue, payload(i), payloadSize(i));
+	}
+
+private:
+	/** @brief The directory of the temporary files. */
+	std::string mDirectory;
+	/** @brief The temporary files, created on the first `append()`. */
+	std::unique_ptr<impl::SpillFile> mFile;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpoolLog.h
+ *   A persistent, segmented log of serialized records.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SPOOLLOG_H
+#define D_TSTORAGE_SPOOLLOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines a persistent log of records with raw payloads. */
+
+namespace tstorage {
+
+namespace impl {
+
+class SpoolLogImpl;
+
+} /*namespace impl*/
+
+/**
+ * @brief An append-only log of records with serialized payloads, kept in a
+ * directory as a sequence of memory-mapped segment files.
+ *
+ * Records are appended to the newest segment, `spool-<sequence>.seg`, which
+ * is preallocated to the segment size and mapped into memory, so that an
+ * append is a copy and no system call. The segment's header holds the
+ * length of its complete records, updated after each record is copied, so
+ * that the records survive a crash of the process up to the last complete
+ * one. Once full, a segment is sealed and a new one begun.
+ *
+ * The records are consumed a whole segment at a time, the oldest first:
+ * `front()` returns views of its records, and `popFront()` removes it once
+ * they have been handled. Segments left in the directory, e.g. by a crashed
+ * process, are picked up by `open()`.
+ *
+ * Appending and consuming are safe to do from two threads at once; only one
+ * thread may consume. Used by `PutSpool<T>`.
+ */
+class SpoolLog final
+{
+public:
+	/** @brief The default size of a segment. */
+	static constexpr std::size_t cDefaultSegmentSize = 64UL * 1024 * 1024;  // 64 MiB
+
+	/**
+	 * @brief Constructs a log, touching no files yet.
+	 * @param directory An existing directory to keep the segments in, used by
+	 * no other log.
+	 * @param segmentSize The size of a segment. A larger record takes a
+	 * segment of its own.
+	 */
+	explicit SpoolLog(const std::string& directory,
+		std::size_t segmentSize = cDefaultSegmentSize);
+	/** @brief Unmaps and closes the segments, removing an empty newest one.
+	 * The records not popped stay on disk. */
+	~SpoolLog();
+
+	SpoolLog(const SpoolLog&) = delete;
+	SpoolLog(SpoolLog&&) = delete;
+	SpoolLog& operator=(const SpoolLog&) = delete;
+	SpoolLog& operator=(SpoolLog&&) = delete;
+
+	/**
+	 * @brief Maps the segments found in the directory, oldest first, and
+	 * makes the log ready for appending. Segments not recognized as such
+	 * are left alone.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::SPOOL_ERROR` if the directory cannot be read, or a segment
+	 *    cannot be opened or mapped.
+	 *
+	 * @return Status code.
+	 */
+	result_t open();
+	/**
+	 * @brief Appends a record to the newest segment, beginning a new one if
+	 * the record does not fit.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::SPOOL_ERROR` if the log is not open, or a segment cannot
+	 *    be created or mapped, e.g. because the disk is full.
+	 *
+	 * @param key Key of the record.
+	 * @param payload The serialized payload.
+	 * @param size The size of the payload, at most `UINT32_MAX`.
+	 * @return Status code.
+	 */
+	result_t append(const Key& key, const void* payload, std::size_t size);
+	/**
+	 * @brief Returns views of the records of the oldest segment, sealing the
+	 * newest one if it is the only one. The views stay valid until
+	 * `popFront()`.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::SPOOL_ERROR` if the segment is corrupt. It should be
+	 *    popped, losing its records.
+	 *
+	 * @param[out] oRecords The records, none if the log is empty.
+	 * @return Status code.
+	 */
+	result_t front(std::vector<RawRecord>& oRecords);
+	/** @brief Removes the oldest segment, as returned by `front()`, from the
+	 * log and the disk. */
+	void popFront();
+
+	/** @brief Returns `true` if the log holds no records. */
+	bool empty() const;
+	/** @brief Returns the size of the records in the log, in bytes. */
+	std::uint64_t bytes() const;
+	/** @brief Returns the number of segments holding records. */
+	std::size_t segments() const;
+
+private:
+	/** @brief The segments. */
+	std::unique_ptr<impl::SpoolLogImpl> mImpl;
+};
+
+} /*namespace tstorage*/
+
+#endif
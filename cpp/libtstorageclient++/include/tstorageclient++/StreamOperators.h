@@ -0,0 +1,308 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * StreamOperators.h
+ *   Filters, projections and bucketed reducers for raw record streams.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_STREAMOPERATORS_H
+#define D_TSTORAGE_STREAMOPERATORS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "DataTypes.h"
+#include "PayloadType.h"
+
+/** @file
+ * @brief Defines operators aggregating the raw records of a GET response
+ * while they are received.
+ *
+ * The operators are record visitors, as taken by `Channel::getView()`, and
+ * compose by wrapping one another: a filter passes the records it accepts on
+ * to the next visitor, and a reducer projects the payloads of the records it
+ * receives to numbers folded into per-bucket aggregates. No `Record<T>` is
+ * ever constructed, so that the memory of a downsampling query is bounded by
+ * the amount of buckets rather than of records:
+ *
+ * @code
+ * // One-minute CAP buckets per MID; the timestamps are in nanoseconds.
+ * BucketReducer reducer(projectTrivial<float>(), 60'000'000'000);
+ * channel.getView(keyMin, keyMax,
+ *     filterKeys([](const Key& key) { return key.moid == 7; }, std::ref(reducer)));
+ * for (const auto& bucket : reducer.buckets()) { ... }
+ * @endcode
+ */
+
+namespace tstorage {
+
+/** @brief A visitor of the raw records of a GET response.
+ * @see `Channel::getView()` */
+using RecordVisitor = std::function<void(const Key&, const void*, std::size_t)>;
+
+/**
+ * @brief Maps the raw payload of a record to a number.
+ *
+ * Returns `false` to leave the record out of the aggregates, e.g. if its
+ * payload is malformed.
+ */
+using Projection = std::function<bool(double& oValue, const void* payload, std::size_t size)>;
+
+/** @brief The count, minimum, maximum and sum of a series of numbers. */
+struct Aggregate
+{
+	/** @brief The amount of numbers. */
+	std::uint64_t count = 0;
+	/** @brief The smallest number, `+inf` if none. */
+	double min = std::numeric_limits<double>::infinity();
+	/** @brief The largest number, `-inf` if none. */
+	double max = -std::numeric_limits<double>::infinity();
+	/** @brief The sum of the numbers. */
+	double sum = 0.0;
+
+	/** @brief Adds a number to the series. */
+	void add(const double value)
+	{
+		++count;
+		min = value < min ? value : min;
+		max = value > max ? value : max;
+		sum += value;
+	}
+	/** @brief Adds the numbers of another series. */
+	void merge(const Aggregate& other)
+	{
+		count += other.count;
+		min = other.min < min ? other.min : min;
+		max = other.max > max ? other.max : max;
+		sum += other.sum;
+	}
+	/** @brief Returns the arithmetic mean, NaN if the series is empty. */
+	double mean() const
+	{
+		return count != 0 ? sum / static_cast<double>(count)
+						  : std::numeric_limits<double>::quiet_NaN();
+	}
+};
+
+/**
+ * @brief Returns a visitor passing the records whose keys satisfy
+ * `predicate` on to `next`.
+ *
+ * @param predicate A callable taking a `const Key&` and returning `true` to
+ * keep the record.
+ * @param next The visitor of the kept records, e.g. a `std::ref()` to a
+ * `BucketReducer`.
+ */
+template<typename Predicate>
+RecordVisitor filterKeys(Predicate predicate, RecordVisitor next)
+{
+	return [predicate, next](const Key& key, const void* payload, const std::size_t size) {
+		if (predicate(key)) {
+			next(key, payload, size);
+		}
+	};
+}
+
+/**
+ * @brief Returns a projection reading payloads stored by
+ * `TrivialPayloadType<V>`, i.e. as the in-memory bytes of a `V`.
+ *
+ * Payloads of a size other than `sizeof(V)` are left out.
+ *
+ * @tparam V An arithmetic type.
+ */
+template<typename V>
+Projection projectTrivial()
+{
+	static_assert(std::is_arithmetic<V>::value, "projectTrivial<V>() requires an arithmetic V");
+	return [](double& oValue, const void* const payload, const std::size_t size) {
+		if (size != sizeof(V)) {
+			return false;
+		}
+		V value{};
+		std::memcpy(&value, payload, sizeof(V));
+		oValue = static_cast<double>(value);
+		return true;
+	};
+}
+
+/**
+ * @brief Returns a projection deserializing payloads with a payload type and
+ * mapping the values to numbers.
+ *
+ * The values are deserialized into a single `T` reused for all records.
+ * Payloads `payloadType` fails to deserialize are left out.
+ *
+ * @param payloadType The payload type of the records.
+ * @param toNumber A callable taking a `const T&` and returning a number.
+ */
+template<typename T, typename ToNumber>
+Projection projectPayload(std::shared_ptr<PayloadType<T>> payloadType, ToNumber toNumber)
+{
+	std::shared_ptr<T> scratch = std::make_shared<T>();
+	return [payloadType, toNumber, scratch](
+			   double& oValue, const void* const payload, const std::size_t size) {
+		if (!payloadType->fromBytes(*scratch, payload, size)) {
+			return false;
+		}
+		oValue = static_cast<double>(toNumber(*scratch));
+		return true;
+	};
+}
+
+/** @brief The key fields a `BucketReducer` groups records by, besides the
+ * CAP bucket. Combined with `|`. */
+enum GroupBy : unsigned {
+	GROUP_BY_NONE = 0,
+	GROUP_BY_CID = 1U << 0,
+	GROUP_BY_MID = 1U << 1,
+	GROUP_BY_MOID = 1U << 2,
+};
+
+/**
+ * @brief The identity of a bucket of a `BucketReducer`.
+ *
+ * The fields the records are not grouped by are `0`. `cap` is the start of
+ * the CAP bucket, `0` if CAP is not bucketed.
+ */
+struct BucketKey
+{
+	/** @brief The CID of the records. */
+	Key::CidT cid;
+	/** @brief The MID of the records. */
+	Key::MidT mid;
+	/** @brief The MOID of the records. */
+	Key::MoidT moid;
+	/** @brief The start of the CAP bucket of the records. */
+	Key::CapT cap;
+
+	/** @brief Orders the buckets by CID, MID, MOID and CAP. */
+	bool operator<(const BucketKey& other) const
+	{
+		return std::tie(cid, mid, moid, cap)
+			< std::tie(other.cid, other.mid, other.moid, other.cap);
+	}
+	/** @brief Compares the buckets field by field. */
+	bool operator==(const BucketKey& other) const
+	{
+		return cid == other.cid && mid == other.mid && moid == other.moid && cap == other.cap;
+	}
+};
+
+/**
+ * @brief A record visitor folding the projected payloads of the records into
+ * one `Aggregate` per bucket.
+ *
+ * A bucket groups the records with the same values of the key fields chosen
+ * by `groupBy` and with CAP timestamps in the same right-open interval of
+ * `capWidth`, aligned to multiples of `capWidth`. E.g. a `capWidth` of one
+ * minute and `GROUP_BY_MID` yields the per-minute series of each device.
+ *
+ * The reducer is used by a single stream at a time; pass it to
+ * `Channel::getView()` with `std::ref()` to keep the buckets in it. The
+ * buckets of several reducers, e.g. of the sub-ranges of a key-interval
+ * fetched in parallel, combine with `merge()`.
+ */
+class BucketReducer
+{
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param projection The projection of the payloads to numbers.
+	 * @param capWidth The width of the CAP buckets in TStorage time units,
+	 * `0` to not bucket by CAP.
+	 * @param groupBy The key fields to group by, a combination of `GroupBy`.
+	 */
+	explicit BucketReducer(
+		Projection projection, const Key::CapT capWidth = 0, const unsigned groupBy = GROUP_BY_MID)
+		: mProjection(std::move(projection))
+		, mCapWidth(capWidth)
+		, mGroupBy(groupBy)
+		, mSkipped(0)
+	{
+	}
+
+	/** @brief Folds a record into its bucket. */
+	void operator()(const Key& key, const void* const payload, const std::size_t size)
+	{
+		double value{};
+		if (!mProjection(value, payload, size)) {
+			++mSkipped;
+			return;
+		}
+		mBuckets[bucketOf(key)].add(value);
+	}
+
+	/** @brief Returns the bucket a key falls into. */
+	BucketKey bucketOf(const Key& key) const
+	{
+		BucketKey bucket{};
+		bucket.cid = (mGroupBy & GROUP_BY_CID) != 0 ? key.cid : 0;
+		bucket.mid = (mGroupBy & GROUP_BY_MID) != 0 ? key.mid : 0;
+		bucket.moid = (mGroupBy & GROUP_BY_MOID) != 0 ? key.moid : 0;
+		if (mCapWidth > 0) {
+			// Floored, so that the buckets of negative timestamps are aligned too.
+			const Key::CapT rest = key.cap % mCapWidth;
+			bucket.cap = key.cap - (rest < 0 ? rest + mCapWidth : rest);
+		}
+		return bucket;
+	}
+	/** @brief Adds the buckets of another reducer to those of this one. */
+	void merge(const BucketReducer& other)
+	{
+		for (const std::pair<const BucketKey, Aggregate>& bucket : other.mBuckets) {
+			mBuckets[bucket.first].merge(bucket.second);
+		}
+		mSkipped += other.mSkipped;
+	}
+	/** @brief Drops the buckets, e.g. before a retry of the stream. */
+	void clear()
+	{
+		mBuckets.clear();
+		mSkipped = 0;
+	}
+
+	/** @brief Returns the buckets, ordered by `BucketKey`. */
+	const std::map<BucketKey, Aggregate>& buckets() const { return mBuckets; }
+	/** @brief Returns the amount of records the projection has left out. */
+	std::uint64_t skipped() const { return mSkipped; }
+
+private:
+	/** @brief The projection of the payloads to numbers. */
+	Projection mProjection;
+	/** @brief The width of the CAP buckets, `0` if CAP is not bucketed. */
+	Key::CapT mCapWidth;
+	/** @brief The key fields to group by. */
+	unsigned mGroupBy;
+	/** @brief The aggregates of the buckets. */
+	std::map<BucketKey, Aggregate> mBuckets;
+	/** @brief The amount of records the projection has left out. */
+	std::uint64_t mSkipped;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -23,6 +23,7 @@
 #define D_TSTORAGE_TIMESTAMP_H
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 
 /** @file
@@ -86,6 +87,44 @@ TimeT fromUnix(UnixTime<UnitT> unixTimestamp)
 		   - cNanosFrom1970To2001;
 }
 
+/**
+ * @brief Converts an array of TStorage internal timestamps to UNIX timestamps
+ * in nanoseconds.
+ *
+ * Equivalent to calling `toUnix<std::chrono::nanoseconds>()` on each
+ * timestamp, but written as a plain loop the compiler vectorizes. The
+ * arrays may be the same one.
+ *
+ * @param tstorageTimestamps The TStorage internal timestamps to convert.
+ * @param count The amount of timestamps.
+ * @param oUnixNanos The array receiving the UNIX timestamps.
+ */
+inline void toUnixNanos(
+	const TimeT* tstorageTimestamps, const std::size_t count, std::int64_t* oUnixNanos)
+{
+	for (std::size_t i = 0; i < count; ++i) {
+		oUnixNanos[i] = tstorageTimestamps[i] + cNanosFrom1970To2001;
+	}
+}
+
+/**
+ * @brief Converts an array of UNIX timestamps in nanoseconds to TStorage
+ * internal timestamps.
+ *
+ * The inverse of `toUnixNanos()`. The arrays may be the same one.
+ *
+ * @param unixNanos The UNIX timestamps to convert.
+ * @param count The amount of timestamps.
+ * @param oTstorageTimestamps The array receiving the TStorage timestamps.
+ */
+inline void fromUnixNanos(
+	const std::int64_t* unixNanos, const std::size_t count, TimeT* oTstorageTimestamps)
+{
+	for (std::size_t i = 0; i < count; ++i) {
+		oTstorageTimestamps[i] = unixNanos[i] - cNanosFrom1970To2001;
+	}
+}
+
 /**
  * @brief Returns the UNIX timestamp corresponding to a given date.
  *
@@ -118,6 +157,20 @@ UnixTime<std::chrono::seconds> fromDateTime(int year = 2001,
  */
 TimeT now();
 
+/**
+ * @brief Returns the current time according to a coarse system clock as a
+ * TStorage internal timestamp.
+ *
+ * Reads `CLOCK_REALTIME_COARSE` where available, which costs a fraction of
+ * `now()` at the resolution of the kernel tick, typically 1 to 4 ms. Meant
+ * for producers stamping many records in a tight loop, e.g. as the CAP of
+ * the keys they build, where such a resolution is enough. Falls back to
+ * `now()` on systems without a coarse clock.
+ *
+ * @return TStorage internal timestamp corresponding to the current time.
+ */
+TimeT coarseNow();
+
 }; /*namespace Timestamp*/
 
 } /*namespace tstorage*/
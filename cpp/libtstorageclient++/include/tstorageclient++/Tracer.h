@@ -0,0 +1,141 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * Tracer.h
+ *   An interface receiving the timings of a channel's requests.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_TRACER_H
+#define D_TSTORAGE_TRACER_H
+
+#include <chrono>
+#include <cstdint>
+
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines the `Tracer` interface and the traces it receives. */
+
+namespace tstorage {
+
+/** @brief The command of a traced request. */
+enum class TraceCommand : std::int32_t {
+	GET = 1,  ///< `Channel::get()` and `Channel::getStream()`.
+	PUT = 5,  ///< `Channel::put()`.
+	PUTA = 6,  ///< `Channel::puta()`.
+	GETACQ = 7,  ///< `Channel::getAcq()`.
+};
+
+/** @brief The timing of an attempt to connect a channel. */
+struct ConnectTrace
+{
+	/** @brief The wall-clock time of `start`, for exporting the trace. */
+	std::chrono::system_clock::time_point wallStart;
+	/** @brief The time the attempt started at. */
+	std::chrono::steady_clock::time_point start;
+	/** @brief The time the attempt finished at. */
+	std::chrono::steady_clock::time_point end;
+	/** @brief The status code of the attempt. */
+	result_t status;
+};
+
+/**
+ * @brief The timing of a request, split at the boundaries of its protocol
+ * phases.
+ *
+ * The phases follow one another, each starting where the previous one ends:
+ *  - sending, from `start` to `sent`: writing the request header and, for
+ *    PUT/A, serializing and sending the records;
+ *  - waiting, from `sent` to `firstByte`: the network round trip and the
+ *    server's processing until the response starts to arrive;
+ *  - records, from `firstByte` to `recordsDone`: receiving the records of a
+ *    GET response and deserializing their payloads, empty for the other
+ *    commands; `recordsRecvWait` of it was spent blocked on the socket, the
+ *    rest mostly in `PayloadType::fromBytes()`;
+ *  - result, from `recordsDone` to `end`: reading the final status and ACQ.
+ */
+struct RequestTrace
+{
+	/** @brief The command of the request. */
+	TraceCommand command;
+	/** @brief `result_t::OK`, or `result_t::ERROR` if TStorage reported an
+	 * error. */
+	result_t status;
+	/** @brief The wall-clock time of `start`, for exporting the trace. */
+	std::chrono::system_clock::time_point wallStart;
+	/** @brief The time the request header was written at. */
+	std::chrono::steady_clock::time_point start;
+	/** @brief The time the whole request was sent at. */
+	std::chrono::steady_clock::time_point sent;
+	/** @brief The time the first bytes of the response arrived at. */
+	std::chrono::steady_clock::time_point firstByte;
+	/** @brief The time the last record was read at. */
+	std::chrono::steady_clock::time_point recordsDone;
+	/** @brief The time the result of the request was read at. */
+	std::chrono::steady_clock::time_point end;
+	/** @brief The time spent waiting for the socket in the records phase. */
+	std::chrono::nanoseconds recordsRecvWait;
+	/** @brief The amount of records received. */
+	std::uint64_t records;
+	/** @brief The amount of bytes sent. */
+	std::uint64_t bytesSent;
+	/** @brief The amount of bytes received. */
+	std::uint64_t bytesReceived;
+};
+
+/**
+ * @brief An interface receiving the timings of a channel's connects and
+ * requests, e.g. to export them as spans of distributed traces.
+ *
+ * The traces map onto OpenTelemetry spans directly: a `RequestTrace` makes a
+ * span from `start` to `end` with a child span per phase, and a `ConnectTrace`
+ * a span of its own. The steady-clock times are offsets from the time the
+ * trace was started at, whose wall-clock time the traces carry as well.
+ *
+ * A trace is reported once its request completes, i.e. once the result is
+ * read or TStorage reports an error; requests failed by the connection, and
+ * pipelined ones, are not traced. The methods are called on the thread using
+ * the channel, in the middle of its calls, and should return quickly.
+ *
+ * @see `Channel::setTracer()`
+ */
+class Tracer
+{
+public:
+	/** @brief A default constructor. */
+	Tracer() = default;
+	/** @brief An empty virtual destructor. */
+	virtual ~Tracer() = default;
+
+	/** @brief A default copy constructor. */
+	Tracer(const Tracer&) = default;
+	/** @brief A default move constructor. */
+	Tracer(Tracer&&) = default;
+	/** @brief A default copy-assignment operator. */
+	Tracer& operator=(const Tracer&) = default;
+	/** @brief A default move-assignment operator. */
+	Tracer& operator=(Tracer&&) = default;
+
+	/** @brief Receives the timing of an attempt to connect. */
+	virtual void onConnect(const ConnectTrace& trace) = 0;
+	/** @brief Receives the timing of a completed request. */
+	virtual void onRequest(const RequestTrace& trace) = 0;
+};
+
+} /*namespace tstorage*/
+
+#endif
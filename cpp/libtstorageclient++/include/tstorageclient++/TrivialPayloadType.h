@@ -0,0 +1,86 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * TrivialPayloadType.h
+ *   A definition of the payload type for trivially copyable values.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_TRIVIALPAYLOADTYPE_H
+#define D_TSTORAGE_TRIVIALPAYLOADTYPE_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "PayloadType.h"
+
+/** @file
+ * @brief Defines the `TrivialPayloadType<T>` serializer. */
+
+namespace tstorage {
+
+/**
+ * @brief A `PayloadType<T>` storing values as their in-memory bytes.
+ *
+ * Suitable for fixed-size, trivially copyable payloads such as `float`,
+ * `double` or `std::array<std::uint8_t, N>`. Each payload is exactly
+ * `sizeof(T)` bytes long and is stored in the host's native byte order;
+ * payloads of any other size are rejected on deserialization.
+ *
+ * `Channel<T>` recognizes this payload type and serializes records with it
+ * inline, without virtual calls and without the two-phase buffer size
+ * negotiation of `PayloadType::toBytes()`. With other channel types it
+ * behaves as a regular `PayloadType<T>`.
+ *
+ * @tparam T Payload data type. Required to be trivially copyable.
+ */
+template<typename T>
+class TrivialPayloadType final : public PayloadType<T>
+{
+	static_assert(std::is_trivially_copyable<T>::value,
+		"TrivialPayloadType<T> requires a trivially copyable T");
+
+public:
+	/** @brief Copies the bytes of `val` if the buffer can hold `sizeof(T)`. */
+	std::size_t toBytes(const T& val, void* outputBuffer, std::size_t bufferSize) override
+	{
+		if (bufferSize >= sizeof(T)) {
+			std::memcpy(outputBuffer, &val, sizeof(T));
+		}
+		return sizeof(T);
+	}
+	/** @brief Copies `sizeof(T)` bytes to `oVar`, failing on any other size. */
+	bool fromBytes(T& oVar, const void* payloadBuffer, std::size_t payloadSize) override
+	{
+		if (payloadSize != sizeof(T)) {
+			return false;
+		}
+		std::memcpy(&oVar, payloadBuffer, sizeof(T));
+		return true;
+	}
+	/** @brief Exposes the memory of `val` itself. */
+	bool toView(const T& val, const void*& oData, std::size_t& oSize) override
+	{
+		oData = &val;
+		oSize = sizeof(T);
+		return true;
+	}
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * ViewRecordsSet.h
+ *   A container of records with verified, zero-copy views of their payloads.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_VIEWRECORDSSET_H
+#define D_TSTORAGE_VIEWRECORDSSET_H
+
+#include <cstddef>
+#include <vector>
+
+#include "BlobRecordsSet.h"
+#include "DataTypes.h"
+
+/** @file
+ * @brief Defines a container of records read in place through a schema. */
+
+namespace tstorage {
+
+/**
+ * @brief A container for inbound records of a zero-copy format, handing out
+ * typed views of their payloads without deserializing them.
+ *
+ * Formats like FlatBuffers or Cap'n Proto are read in place: once a buffer
+ * is verified, its fields are accessed straight from its bytes. Deserializing
+ * such payloads with `PayloadType<T>::fromBytes()` would copy them for
+ * nothing, since the payload spans of a channel only last until the next
+ * record is read. Instead, the set keeps the payloads in the heap of a
+ * `BlobRecordsSet`, filled with `Channel<T>::getBlob()` or
+ * `Channel<T>::getStreamBlob()`, aligned as the format needs. `verify()` then
+ * checks each payload once, and `view()` returns a view of a verified one.
+ *
+ * The format is described by `Schema`, a class with:
+ *  - `using View = ...;`, the type of a view, e.g. a pointer to the root
+ *    table of a FlatBuffers schema;
+ *  - `static constexpr std::size_t cAlignment`, the payload alignment;
+ *  - `static bool verify(const void* data, std::size_t size)`, returning
+ *    `true` if the payload is well-formed;
+ *  - `static View view(const void* data, std::size_t size)`, making a view
+ *    of a verified payload.
+ *
+ * @code
+ * struct SensorSchema
+ * {
+ *     using View = const Sensor*;
+ *     static constexpr std::size_t cAlignment = 8;
+ *     static bool verify(const void* data, std::size_t size)
+ *     {
+ *         flatbuffers::Verifier verifier(static_cast<const std::uint8_t*>(data), size);
+ *         return VerifySensorBuffer(verifier);
+ *     }
+ *     static View view(const void* data, std::size_t) { return GetSensor(data); }
+ * };
+ *
+ * ViewRecordsSet<SensorSchema> records;
+ * channel.getBlob(keyMin, keyMax, records.raw());
+ * records.verify();
+ * for (std::size_t i = 0; i < records.size(); ++i) {
+ *     if (records.valid(i)) { use(records.key(i), records.view(i)->temperature()); }
+ * }
+ * @endcode
+ *
+ * The views point into the heap of the set, so they are invalidated by
+ * appending records, unless the heap has been reserved for them (see
+ * `BlobRecordsSet::reserveBytes()`), and by `clear()`.
+ *
+ * A default-constructible, copyable and moveable container.
+ *
+ * @tparam Schema The description of the format.
+ */
+template<typename Schema>
+class ViewRecordsSet final
+{
+public:
+	/** @brief The type of a view of a payload. */
+	using View = typename Schema::View;
+
+	/** @brief Constructs an empty set. */
+	ViewRecordsSet() : mRaw(Schema::cAlignment) {}
+
+	/** @brief Returns the number of records currently stored in the container. */
+	std::size_t size() const { return mRaw.size(); }
+
+	/**
+	 * @brief Removes all records from the container. The allocated memory is
+	 * retained for reuse.
+	 */
+	void clear()
+	{
+		mRaw.clear();
+		mValid.clear();
+		mInvalid = 0;
+	}
+
+	/**
+	 * @brief Verifies the payloads of the records appended since the last
+	 * call.
+	 * @return The amount of records whose payloads are malformed, over the
+	 * whole set.
+	 */
+	std::size_t verify()
+	{
+		for (std::size_t i = mValid.size(); i < mRaw.size(); ++i) {
+			const bool valid = Schema::verify(mRaw.payload(i), mRaw.payloadSize(i));
+			mValid.push_back(valid ? 1 : 0);
+			mInvalid += valid ? 0 : 1;
+		}
+		return mInvalid;
+	}
+
+	/**
+	 * @brief Returns the key of the `i`-th record.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	const Key& key(const std::size_t i) const { return mRaw.key(i); }
+	/**
+	 * @brief Returns `true` if the payload of the `i`-th record has been
+	 * verified and is well-formed.
+	 * @param i Index of the record, less than `size()`.
+	 */
+	bool valid(const std::size_t i) const { return i < mValid.size() && mValid[i] != 0; }
+	/**
+	 * @brief Returns a view of the payload of the `i`-th record.
+	 * @param i Index of a record for which `valid()` returns `true`.
+	 */
+	View view(const std::size_t i) const
+	{
+		return Schema::view(mRaw.payload(i), mRaw.payloadSize(i));
+	}
+
+	/** @brief Returns the raw records, to be filled by
+	 * `Channel<T>::getBlob()`. */
+	BlobRecordsSet& raw() { return mRaw; }
+	/** @brief Returns the raw records. */
+	const BlobRecordsSet& raw() const { return mRaw; }
+
+private:
+	/** @brief The raw records. */
+	BlobRecordsSet mRaw;
+	/** @brief For each verified record, `1` if its payload is well-formed. */
+	std::vector<unsigned char> mValid;
+	/** @brief The amount of malformed payloads verified. */
+	std::size_t mInvalid = 0;
+};
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,226 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * WindowScanner.h
+ *   A sequential scan of CAP windows with read-ahead over pooled channels.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_WINDOWSCANNER_H
+#define D_TSTORAGE_WINDOWSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Defines the `WindowScanner<T>` class. */
+
+namespace tstorage {
+
+/** @brief The read-ahead of a `WindowScanner<T>`. */
+struct ScanReadAhead
+{
+	/** @brief The amount of windows fetched ahead of the current one, `0` to
+	 * fetch each window on demand only. */
+	std::size_t windows = 2;
+	/** @brief The bound of the bytes received for windows fetched ahead and
+	 * not consumed yet, windows in flight included. */
+	std::size_t maxBufferedBytes = 64UL * 1024 * 1024;  // 64 MiB
+};
+
+/**
+ * @brief A GET front end of a channel pool, fetching consecutive CAP windows
+ * of a key-interval ahead of their consumer.
+ *
+ * A scan walking a CAP range in fixed windows, i.e. `[t, t + w)`, then
+ * `[t + w, t + 2w)` and so on, pays for a full round trip per window when
+ * each is fetched only once the previous one has been consumed. The scanner
+ * fetches the next windows ahead, each with its own `Channel<T>::get()` over
+ * a spare channel of the pool, while the caller processes the current one, so
+ * that a scan runs at the throughput of the connections.
+ *
+ * The windows are either planned up front with `plan()` and consumed with
+ * `next()`, or requested one by one with `get()`: once a request follows the
+ * previous one, i.e. starts at its upper CAP bound, spans the same CAP width
+ * and has the same bounds otherwise, the scanner takes the requests as
+ * sequential and fetches the windows following the request ahead. A request
+ * that is not the next window drops the windows fetched ahead.
+ *
+ * Windows are fetched ahead only over channels idle in the bulk lane of the
+ * pool (see `ChannelPool<T>::tryAcquire()`), and only while the bytes
+ * received for the windows ahead, counting each one in flight as the size of
+ * the last window, stay within `ScanReadAhead::maxBufferedBytes`. A window
+ * not fetched ahead is fetched on demand, waiting for a channel if need be.
+ *
+ * Each response is that of `Channel<T>::get()` on its window, so the ACQs of
+ * the windows may differ. A failed window ends the read-ahead; the following
+ * ones are fetched on demand.
+ *
+ * The scanner itself is not thread-safe. The pool must be connected
+ * beforehand and must outlive the scanner, whose destruction waits for the
+ * windows in flight.
+ *
+ * @tparam T Internal data type of the payload.
+ */
+template<typename T>
+class WindowScanner final
+{
+public:
+	/**
+	 * @brief A constructor.
+	 *
+	 * @param pool The pool providing the channels.
+	 * @param readAhead The read-ahead of the scan.
+	 */
+	WindowScanner(ChannelPool<T>& pool, const ScanReadAhead& readAhead);
+	/** @brief Constructs a scanner with the default read-ahead. */
+	explicit WindowScanner(ChannelPool<T>& pool) : WindowScanner(pool, ScanReadAhead{}) {}
+	/** @brief Waits for the windows in flight and drops them. */
+	~WindowScanner();
+
+	WindowScanner(const WindowScanner&) = delete;
+	WindowScanner(WindowScanner&&) = delete;
+	WindowScanner& operator=(const WindowScanner&) = delete;
+	WindowScanner& operator=(WindowScanner&&) = delete;
+
+	/**
+	 * @brief Plans a scan of `[keyMin, keyMax)` in windows of `window` CAP
+	 * units, and starts fetching the first windows ahead.
+	 *
+	 * The `i`-th window has the bounds of the key-interval but for the CAPs,
+	 * which are `[keyMin.cap + i * window, keyMin.cap + (i + 1) * window)`,
+	 * the last one ending at `keyMax.cap`. A previous plan is dropped.
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval.
+	 * @param keyMax The upper vertex of the right-open key-interval.
+	 * @param window The CAP width of a window, at least `1`.
+	 */
+	void plan(const Key& keyMin, const Key& keyMax, Key::CapT window);
+	/**
+	 * @brief Returns the next window of the plan.
+	 *
+	 * @param oResponse The response of `Channel<T>::get()` on the window,
+	 * whose bounds `windowMin()` and `windowMax()` return afterwards.
+	 * @return `false` without setting `oResponse` if the plan is complete or
+	 * has been ended by a failed window, `true` otherwise.
+	 */
+	bool next(ResponseGet<T>& oResponse);
+
+	/**
+	 * @brief Retrieves a set of records like `Channel<T>::get()`, taking it
+	 * from the windows fetched ahead if it is the next one.
+	 *
+	 * A previous plan is dropped, unless the request is its next window.
+	 *
+	 * @see Channel<T>::get()
+	 *
+	 * @param keyMin The lower vertex of the right-open key-interval.
+	 * @param keyMax The upper vertex of the right-open key-interval.
+	 * @return The response as in `Channel<T>::get()`.
+	 */
+	ResponseGet<T> get(const Key& keyMin, const Key& keyMax);
+
+	/** @brief Returns the lower vertex of the last window returned. */
+	const Key& windowMin() const { return mLastMin; }
+	/** @brief Returns the upper vertex of the last window returned. */
+	const Key& windowMax() const { return mLastMax; }
+	/** @brief Returns the amount of windows taken from those fetched ahead. */
+	std::uint64_t hits() const { return mHits; }
+	/** @brief Returns the amount of windows fetched on demand. */
+	std::uint64_t misses() const { return mMisses; }
+
+private:
+	/** @brief A window fetched ahead. */
+	struct Slot
+	{
+		/** @brief The lower vertex of the window. */
+		Key keyMin;
+		/** @brief The upper vertex of the window. */
+		Key keyMax;
+		/** @brief The response, once the thread has been joined. */
+		ResponseGet<T> response{result_t::OK};
+		/** @brief The bytes received for the window, once `done`. */
+		std::size_t bytes = 0;
+		/** @brief `true` once the response has arrived. */
+		bool done = false;
+		/** @brief The thread fetching the window. */
+		std::thread thread;
+	};
+
+	/** @brief Returns `true` if `[keyMin, keyMax)` is the window following
+	 * `[prevMin, prevMax)`. */
+	static bool follows(
+		const Key& prevMin, const Key& prevMax, const Key& keyMin, const Key& keyMax);
+	/** @brief Sets the CAP bounds of the window of the sequence starting at
+	 * `cap`. */
+	void windowAt(Key::CapT cap, Key& oKeyMin, Key& oKeyMax) const;
+	/** @brief Returns the window `[keyMin, keyMax)`, from those fetched ahead
+	 * if it is the first of them, on demand otherwise. */
+	ResponseGet<T> fetch(const Key& keyMin, const Key& keyMax);
+	/** @brief Starts fetching windows ahead as far as the read-ahead allows. */
+	void refill();
+	/** @brief Waits for the windows fetched ahead and drops them. */
+	void drain();
+
+	/** @brief The pool providing the channels. */
+	ChannelPool<T>& mPool;
+	/** @brief The read-ahead. */
+	ScanReadAhead mReadAhead;
+	/** @brief `true` while the windows follow a sequence. */
+	bool mSequential;
+	/** @brief `true` while a plan is followed by `next()`. */
+	bool mPlanned;
+	/** @brief The bounds of the windows of the sequence, but for the CAPs. */
+	Key mBaseMin;
+	/** @brief The bounds of the windows of the sequence, but for the CAPs. */
+	Key mBaseMax;
+	/** @brief The CAP width of the windows of the sequence. */
+	Key::CapT mWidth;
+	/** @brief The upper CAP bound of the sequence. */
+	Key::CapT mEndCap;
+	/** @brief The lower CAP bound of the next window to be returned. */
+	Key::CapT mNextCap;
+	/** @brief The lower CAP bound of the next window to be fetched ahead. */
+	Key::CapT mAheadCap;
+	/** @brief The bytes received for the last window. */
+	std::size_t mWindowBytes;
+	/** @brief The lower vertex of the last window returned. */
+	Key mLastMin;
+	/** @brief The upper vertex of the last window returned. */
+	Key mLastMax;
+	/** @brief The windows fetched ahead, in order. */
+	std::deque<std::unique_ptr<Slot>> mAhead;
+	/** @brief Guards the `bytes` and `done` of the slots. */
+	std::mutex mMutex;
+	/** @brief The amount of windows taken from those fetched ahead. */
+	std::uint64_t mHits;
+	/** @brief The amount of windows fetched on demand. */
+	std::uint64_t mMisses;
+};
+
+} /*namespace tstorage*/
+
+#include "WindowScanner.tpp"
+
+#endif
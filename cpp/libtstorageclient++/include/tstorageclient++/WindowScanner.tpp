@@ -0,0 +1,236 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * WindowScanner.tpp
+ *   An implementation of the `WindowScanner<T>` class.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_WINDOWSCANNER_TPP
+#define D_TSTORAGE_WINDOWSCANNER_TPP
+
+#ifndef D_TSTORAGE_WINDOWSCANNER_H
+#error __FILE__ was included from outside of "WindowScanner.h"
+#include "WindowScanner.h"  // clangd integration
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "ChannelPool.h"
+#include "DataTypes.h"
+#include "ResponseGet.h"
+
+/** @file
+ * @brief Implements the `WindowScanner<T>` class. */
+
+namespace tstorage {
+
+template<typename T>
+WindowScanner<T>::WindowScanner(ChannelPool<T>& pool, const ScanReadAhead& readAhead)
+	: mPool(pool)
+	, mReadAhead(readAhead)
+	, mSequential(false)
+	, mPlanned(false)
+	, mBaseMin(cKeyMin)
+	, mBaseMax(cKeyMax)
+	, mWidth(0)
+	, mEndCap(0)
+	, mNextCap(0)
+	, mAheadCap(0)
+	, mWindowBytes(0)
+	, mLastMin(cKeyMin)
+	, mLastMax(cKeyMin)
+	, mHits(0)
+	, mMisses(0)
+{
+}
+
+template<typename T>
+WindowScanner<T>::~WindowScanner()
+{
+	drain();
+}
+
+template<typename T>
+void WindowScanner<T>::plan(const Key& keyMin, const Key& keyMax, const Key::CapT window)
+{
+	drain();
+	mSequential = true;
+	mPlanned = true;
+	mBaseMin = keyMin;
+	mBaseMax = keyMax;
+	mWidth = std::max<Key::CapT>(window, 1);
+	mEndCap = keyMax.cap;
+	mNextCap = keyMin.cap;
+	refill();
+}
+
+template<typename T>
+bool WindowScanner<T>::next(ResponseGet<T>& oResponse)
+{
+	if (!mPlanned || mNextCap >= mEndCap) {
+		return false;
+	}
+	Key keyMin = mBaseMin;
+	Key keyMax = mBaseMax;
+	windowAt(mNextCap, keyMin, keyMax);
+	oResponse = get(keyMin, keyMax);
+	return true;
+}
+
+template<typename T>
+ResponseGet<T> WindowScanner<T>::get(const Key& keyMin, const Key& keyMax)
+{
+	bool expected = false;
+	if (mSequential && mNextCap < mEndCap) {
+		Key nextMin = mBaseMin;
+		Key nextMax = mBaseMax;
+		windowAt(mNextCap, nextMin, nextMax);
+		expected = keyMin == nextMin && keyMax == nextMax;
+	}
+	if (!expected) {
+		mPlanned = false;
+		mSequential = follows(mLastMin, mLastMax, keyMin, keyMax);
+		if (mSequential) {
+			mBaseMin = keyMin;
+			mBaseMax = keyMax;
+			mWidth = keyMax.cap - keyMin.cap;
+			mEndCap = Key::cCapMax;
+		}
+	}
+
+	ResponseGet<T> response = fetch(keyMin, keyMax);
+	mNextCap = keyMax.cap;
+	if (response.error()) {
+		mSequential = false;
+		mPlanned = false;
+		drain();
+	} else {
+		refill();
+	}
+	return response;
+}
+
+template<typename T>
+bool WindowScanner<T>::follows(
+	const Key& prevMin, const Key& prevMax, const Key& keyMin, const Key& keyMax)
+{
+	const auto width = [](const Key& lo, const Key& hi) {
+		return static_cast<std::uint64_t>(hi.cap) - static_cast<std::uint64_t>(lo.cap);
+	};
+	return prevMin.cap < prevMax.cap && keyMin.cap < keyMax.cap && keyMin.cap == prevMax.cap
+		&& width(keyMin, keyMax) == width(prevMin, prevMax) && keyMin.cid == prevMin.cid
+		&& keyMin.mid == prevMin.mid && keyMin.moid == prevMin.moid && keyMin.acq == prevMin.acq
+		&& keyMax.cid == prevMax.cid && keyMax.mid == prevMax.mid && keyMax.moid == prevMax.moid
+		&& keyMax.acq == prevMax.acq;
+}
+
+template<typename T>
+void WindowScanner<T>::windowAt(const Key::CapT cap, Key& oKeyMin, Key& oKeyMax) const
+{
+	oKeyMin.cap = cap;
+	const std::uint64_t left =
+		static_cast<std::uint64_t>(mEndCap) - static_cast<std::uint64_t>(cap);
+	oKeyMax.cap = left <= static_cast<std::uint64_t>(mWidth) ? mEndCap : cap + mWidth;
+}
+
+template<typename T>
+ResponseGet<T> WindowScanner<T>::fetch(const Key& keyMin, const Key& keyMax)
+{
+	mLastMin = keyMin;
+	mLastMax = keyMax;
+	if (!mAhead.empty() && mAhead.front()->keyMin == keyMin && mAhead.front()->keyMax == keyMax) {
+		std::unique_ptr<Slot> slot = std::move(mAhead.front());
+		mAhead.pop_front();
+		slot->thread.join();
+		mWindowBytes = slot->bytes;
+		++mHits;
+		return std::move(slot->response);
+	}
+
+	drain();
+	++mMisses;
+	typename ChannelPool<T>::Lease lease = mPool.acquire();
+	const std::uint64_t before = lease->stats().bytesReceived;
+	ResponseGet<T> response = lease->get(keyMin, keyMax);
+	mWindowBytes = static_cast<std::size_t>(lease->stats().bytesReceived - before);
+	return response;
+}
+
+template<typename T>
+void WindowScanner<T>::refill()
+{
+	if (!mSequential) {
+		return;
+	}
+	if (mAhead.empty()) {
+		mAheadCap = mNextCap;
+	}
+	while (mAhead.size() < mReadAhead.windows && mAheadCap < mEndCap) {
+		std::size_t buffered = mWindowBytes;
+		{
+			const std::lock_guard<std::mutex> lock(mMutex);
+			for (const std::unique_ptr<Slot>& slot : mAhead) {
+				buffered += slot->done ? slot->bytes : mWindowBytes;
+			}
+		}
+		if (buffered > mReadAhead.maxBufferedBytes) {
+			return;
+		}
+		typename ChannelPool<T>::Lease lease = mPool.tryAcquire();
+		if (!lease) {
+			return;
+		}
+
+		std::unique_ptr<Slot> slot = std::make_unique<Slot>();
+		slot->keyMin = mBaseMin;
+		slot->keyMax = mBaseMax;
+		windowAt(mAheadCap, slot->keyMin, slot->keyMax);
+		mAheadCap = slot->keyMax.cap;
+		Slot* const target = slot.get();
+		target->thread = std::thread(
+			[this, target](typename ChannelPool<T>::Lease channel) {
+				const std::uint64_t before = channel->stats().bytesReceived;
+				target->response = channel->get(target->keyMin, target->keyMax);
+				const std::uint64_t received = channel->stats().bytesReceived - before;
+				channel.release();
+				const std::lock_guard<std::mutex> lock(mMutex);
+				target->bytes = static_cast<std::size_t>(received);
+				target->done = true;
+			},
+			std::move(lease));
+		mAhead.push_back(std::move(slot));
+	}
+}
+
+template<typename T>
+void WindowScanner<T>::drain()
+{
+	for (const std::unique_ptr<Slot>& slot : mAhead) {
+		slot->thread.join();
+	}
+	mAhead.clear();
+}
+
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,190 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * AsyncChannelBase.cpp
+ *   A base class of `AsyncChannel<T>` providing the API to the library.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tstorageclient++/AsyncChannelBase.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <ratio>
+#include <string>
+#include <utility>
+
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/EventLoop.h>
+
+#include "AsyncChannelImpl.h"
+#include "BatchSerializer.h"
+#include "ChannelImpl.h"
+#include "Defines.h"
+
+namespace tstorage {
+namespace impl {
+
+TSTORAGE_EXPORT void AsyncRequestDeleter::operator()(AsyncRequest* const request) const
+{
+	delete request;
+}
+
+TSTORAGE_EXPORT AsyncChannelBase::AsyncChannelBase(EventLoop& loop)
+	: mImpl(std::make_shared<AsyncChannelImpl>(*loop.mImpl))
+{
+}
+
+TSTORAGE_EXPORT AsyncChannelBase::~AsyncChannelBase()
+{
+	mImpl->detach();
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::connectImpl(CompletionCallback callback)
+{
+	mImpl->connect(std::move(callback));
+}
+
+TSTORAGE_EXPORT result_t AsyncChannelBase::closeImpl()
+{
+	return mImpl->close();
+}
+
+TSTORAGE_EXPORT bool AsyncChannelBase::connectedImpl() const
+{
+	return mImpl->connected();
+}
+
+TSTORAGE_EXPORT result_t AsyncChannelBase::newPutRequest(const ProtoT proto, RequestPtr& oRequest)
+{
+	const BatchSerializer::ProtoT batchProto =
+		proto == PUT ? BatchSerializer::ProtoT::PUT : BatchSerializer::ProtoT::PUTA;
+	oRequest.reset(new (std::nothrow) AsyncRequest(batchProto, mImpl->memoryLimit()));
+	if (!oRequest || !oRequest->valid()) {
+		oRequest.reset();
+		return result_t::OUT_OF_MEMORY;
+	}
+	return result_t::OK;
+}
+
+TSTORAGE_EXPORT result_t AsyncChannelBase::obtainPayloadBuffer(
+	AsyncRequest& request, void*& oPayloadBuffer, std::size_t& oBufferSize, const Key& key)
+{
+	return request.obtainPayloadBuffer(oPayloadBuffer, oBufferSize, key);
+}
+
+TSTORAGE_EXPORT result_t AsyncChannelBase::reservePayloadBuffer(AsyncRequest& request,
+	void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	const std::size_t payloadSize,
+	const Key& key)
+{
+	return request.reservePayloadBuffer(oPayloadBuffer, oBufferSize, payloadSize, key);
+}
+
+TSTORAGE_EXPORT result_t AsyncChannelBase::writeNextRecord(
+	AsyncRequest& request, const Key& key, const std::size_t payloadSize)
+{
+	return request.writeNextRecord(key, payloadSize);
+}
+
+TSTORAGE_EXPORT result_t AsyncChannelBase::writeNextRecordView(AsyncRequest& request,
+	const Key& key,
+	const void* const payload,
+	const std::size_t payloadSize)
+{
+	return request.writeNextRecordView(key, payload, payloadSize);
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::submitPut(RequestPtr request, CompletionCallback callback)
+{
+	const result_t res = request->finish();
+	if (res != result_t::OK) {
+		mImpl->postCompletion(std::move(callback), res);
+		return;
+	}
+	request->onComplete = std::move(callback);
+	mImpl->submit(std::shared_ptr<AsyncRequest>(std::move(request)));
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::submitGet(const Key& keyMin,
+	const Key& keyMax,
+	RecordVisitor visitor,
+	ChunkCallback onChunk,
+	CompletionCallback callback)
+{
+	const result_t resCheck = ChannelImpl::checkKeyRange(keyMin, keyMax);
+	if (resCheck != result_t::OK) {
+		mImpl->postCompletion(std::move(callback), resCheck);
+		return;
+	}
+	const std::shared_ptr<AsyncRequest> request =
+		std::make_shared<AsyncRequest>(AsyncRequest::GET, keyMin, keyMax);
+	if (!request->valid()) {
+		mImpl->postCompletion(std::move(callback), result_t::OUT_OF_MEMORY);
+		return;
+	}
+	request->visitor = std::move(visitor);
+	request->onChunk = std::move(onChunk);
+	request->onComplete = std::move(callback);
+	mImpl->submit(request);
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::submitGetAcq(
+	const Key& keyMin, const Key& keyMax, CompletionCallback callback)
+{
+	const result_t resCheck = ChannelImpl::checkKeyRange(keyMin, keyMax);
+	if (resCheck != result_t::OK) {
+		mImpl->postCompletion(std::move(callback), resCheck);
+		return;
+	}
+	const std::shared_ptr<AsyncRequest> request =
+		std::make_shared<AsyncRequest>(AsyncRequest::GETACQ, keyMin, keyMax);
+	if (!request->valid()) {
+		mImpl->postCompletion(std::move(callback), result_t::OUT_OF_MEMORY);
+		return;
+	}
+	request->onComplete = std::move(callback);
+	mImpl->submit(request);
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::postCompletion(
+	CompletionCallback callback, const result_t status)
+{
+	mImpl->postCompletion(std::move(callback), status);
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::setTimeoutImpl(
+	const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	mImpl->setTimeoutMs(timeout.count());
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::setMemoryLimitImpl(const std::size_t memoryLimitBytes)
+{
+	mImpl->setMemoryLimit(memoryLimitBytes);
+}
+
+TSTORAGE_EXPORT void AsyncChannelBase::setHost(const std::string& addr, const std::uint16_t port)
+{
+	mImpl->setHost(addr, port);
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,777 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * AsyncChannelImpl.cpp
+ *   A non-blocking implementation of the TStorage protocol.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AsyncChannelImpl.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "BatchSerializer.h"
+#include "Buffer.h"
+#include "ChannelImpl.h"
+#include "EventLoopImpl.h"
+#include "Headers.h"
+#include "HostResolver.h"
+#include "Serializer.h"
+#include "Socket.h"
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::size_t AsyncChannelImpl::cInitialBufferSize;
+constexpr std::size_t AsyncChannelImpl::cMinBufferSize;
+constexpr std::int64_t AsyncChannelImpl::cDefaultTimeoutMs;
+
+/**************
+ * AsyncRequest
+ */
+
+AsyncRequest::AsyncRequest(const BatchSerializer::ProtoT proto, const std::size_t chunkSize)
+	: phase(HEADER)
+	, acq(0)
+	, chunkDirty(false)
+	, mKind(PUT)
+	, mProto(proto)
+	, mChunkSize(chunkSize)
+	, mCurrent(chunkSize)
+	, mBatch(mCurrent)
+{
+	if (!mCurrent) {
+		return;
+	}
+	const CommandType cmdId =
+		proto == BatchSerializer::ProtoT::PUT ? CommandType::PUT : CommandType::PUTA;
+	const Header header{cmdId, 0};
+	Serializer(mCurrent).putHeader(header);
+	mBatch.endBatch();
+}
+
+AsyncRequest::AsyncRequest(const Kind kind, const Key& keyMin, const Key& keyMax)
+	: phase(kind == GETACQ ? ACQ : HEADER)
+	, acq(0)
+	, chunkDirty(false)
+	, mKind(kind)
+	, mProto(BatchSerializer::ProtoT::PUT)
+	, mChunkSize(Serializer::cHeaderSize + 2 * Serializer::cKeySize)
+	, mCurrent(mChunkSize)
+	, mBatch(mCurrent)
+{
+	if (!mCurrent) {
+		return;
+	}
+	const CommandType cmdId = kind == GETACQ ? CommandType::GETACQ : CommandType::GET;
+	const HeaderKeyRange header{cmdId, 2 * Serializer::cKeySize, keyMin, keyMax};
+	Serializer(mCurrent).putHeaderKeyRange(header);
+	mChunks.push_back(std::move(mCurrent));
+}
+
+result_t AsyncRequest::obtainPayloadBuffer(
+	void*& oPayloadBuffer, std::size_t& oBufferSize, const Key& key)
+{
+	return reservePayloadBuffer(oPayloadBuffer, oBufferSize, mPayloadSizes.predict(), key);
+}
+
+result_t AsyncRequest::reservePayloadBuffer(void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	const std::size_t payloadSize,
+	const Key& key)
+{
+	oPayloadBuffer = nullptr;
+	oBufferSize = 0;
+
+	const std::size_t keySize = mProto == BatchSerializer::ProtoT::PUT
+		? Serializer::cAbbrevKeySizeWithoutAcq
+		: Serializer::cAbbrevKeySize;
+	std::size_t recordOffset = mBatch.getNextRecordOffset(key.cid);
+	const std::size_t payloadOffset = keySize + sizeof(std::int32_t);
+
+	if (recordOffset + payloadOffset + payloadSize > mCurrent.bytesOfFreeSpace()) {
+		if (mCurrent.writeOffset() == 0) {
+			return result_t::MEMORY_LIMIT_EXCEEDED;
+		}
+
+		const result_t resSeal = sealChunk();
+		if (resSeal != result_t::OK) {
+			return resSeal;
+		}
+		recordOffset = mBatch.getNextRecordOffset(key.cid);
+		if (recordOffset + payloadOffset + payloadSize > mCurrent.bytesOfFreeSpace()) {
+			return result_t::MEMORY_LIMIT_EXCEEDED;
+		}
+	}
+
+	const std::size_t totalOffset = recordOffset + payloadOffset;
+	oPayloadBuffer = mCurrent.writeData(totalOffset);
+	oBufferSize = mCurrent.bytesOfFreeSpace() - totalOffset;
+	return result_t::OK;
+}
+
+result_t AsyncRequest::writeNextRecord(const Key& key, const std::size_t payloadSize)
+{
+	if (mProto == BatchSerializer::ProtoT::PUT) {
+		const result_t res =
+			ChannelImpl::checkPutRecord<BatchSerializer::ProtoT::PUT>(key, payloadSize);
+		if (res != result_t::OK) {
+			return res;
+		}
+		mBatch.putRecord<BatchSerializer::ProtoT::PUT>(key, payloadSize);
+	} else {
+		const result_t res =
+			ChannelImpl::checkPutRecord<BatchSerializer::ProtoT::PUTA>(key, payloadSize);
+		if (res != result_t::OK) {
+			return res;
+		}
+		mBatch.putRecord<BatchSerializer::ProtoT::PUTA>(key, payloadSize);
+	}
+	mPayloadSizes.record(payloadSize);
+	return result_t::OK;
+}
+
+result_t AsyncRequest::writeNextRecordView(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+{
+	const result_t resCheck = mProto == BatchSerializer::ProtoT::PUT
+		? ChannelImpl::checkPutRecord<BatchSerializer::ProtoT::PUT>(key, payloadSize)
+		: ChannelImpl::checkPutRecord<BatchSerializer::ProtoT::PUTA>(key, payloadSize);
+	if (resCheck != result_t::OK) {
+		return resCheck;
+	}
+
+	void* buffer{};
+	std::size_t bufferSize{};
+	const result_t resReserve = reservePayloadBuffer(buffer, bufferSize, payloadSize, key);
+	if (resReserve != result_t::OK) {
+		return resReserve;
+	}
+	std::memcpy(buffer, payload, payloadSize);
+	return writeNextRecord(key, payloadSize);
+}
+
+result_t AsyncRequest::finish()
+{
+	if (!mBatch.empty()) {
+		mBatch.endBatch();
+	}
+	if (mCurrent.bytesOfFreeSpace() < sizeof(std::int32_t)) {
+		const result_t resSeal = sealChunk();
+		if (resSeal != result_t::OK) {
+			return resSeal;
+		}
+	}
+	Serializer(mCurrent).putInt32(-1);
+	mChunks.push_back(std::move(mCurrent));
+	return result_t::OK;
+}
+
+result_t AsyncRequest::sealChunk()
+{
+	if (!mBatch.empty()) {
+		mBatch.endBatch();
+	}
+	mChunks.push_back(std::move(mCurrent));
+	mCurrent = Buffer(mChunkSize);
+	if (!mCurrent) {
+		return result_t::OUT_OF_MEMORY;
+	}
+	mBatch = BatchSerializer(mCurrent);
+	return result_t::OK;
+}
+
+/**************
+ * Setup
+ */
+
+AsyncChannelImpl::AsyncChannelImpl(EventLoopImpl& loop)
+	: mLoop(&loop)
+	, mPort(0)
+	, mTimeoutMs(cDefaultTimeoutMs)
+	, mMemoryLimit(cInitialBufferSize)
+	, mConnected(false)
+	, mDetached(false)
+	, mState(DISCONNECTED)
+	, mFd(-1)
+	, mHandlerId(0)
+	, mEvents(0)
+	, mNextAddress(0)
+	, mConnectError(result_t::OK)
+	, mSendCursor(0)
+	, mSkip(0)
+{
+}
+
+void AsyncChannelImpl::setHost(const std::string& addr, const std::uint16_t port)
+{
+	std::lock_guard<std::mutex> lock(mHostMutex);
+	mAddr = addr;
+	mPort = port;
+}
+
+void AsyncChannelImpl::setMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	mMemoryLimit = std::max(memoryLimitBytes, cMinBufferSize);
+}
+
+void AsyncChannelImpl::connect(AsyncCompletionCallback callback)
+{
+	std::string addr;
+	std::uint16_t port{};
+	{
+		std::lock_guard<std::mutex> lock(mHostMutex);
+		addr = mAddr;
+		port = mPort;
+	}
+
+	// clang-format off
+	struct addrinfo hints{};
+	// clang-format on
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+	hints.ai_flags = 0;
+
+	std::vector<Address> addresses;
+	struct addrinfo* ai = nullptr;
+	const std::string portStr = std::to_string(port);
+	if (HostResolver::isLocal(addr)) {
+		HostResolver::Address local{};
+		if (HostResolver::resolveLocal(addr, local) == result_t::OK) {
+			addresses.push_back(Address{local.addr, local.length});
+		}
+	} else if (::getaddrinfo(addr.c_str(), portStr.c_str(), &hints, &ai) == 0) {
+		for (struct addrinfo* aiNext = ai; aiNext != nullptr; aiNext = aiNext->ai_next) {
+			if (aiNext->ai_addrlen > sizeof(Address::addr)) {
+				continue;
+			}
+			Address address{};
+			std::memcpy(&address.addr, aiNext->ai_addr, aiNext->ai_addrlen);
+			address.length = aiNext->ai_addrlen;
+			addresses.push_back(address);
+		}
+		::freeaddrinfo(ai);
+	}
+
+	const std::shared_ptr<AsyncChannelImpl> self = shared_from_this();
+	mLoop->post([self, addresses, callback]() {
+		if (self->mDetached) {
+			callback(result_t::NOT_CONNECTED, 0);
+			return;
+		}
+		if (self->mState == CONNECTED) {
+			callback(result_t::OK, 0);
+			return;
+		}
+		self->mConnectCallbacks.push_back(callback);
+		if (self->mState == CONNECTING) {
+			return;
+		}
+		if (addresses.empty()) {
+			self->abortWith(result_t::BAD_ADDRESS, result_t::NOT_CONNECTED);
+			return;
+		}
+		self->mAddresses = addresses;
+		self->mNextAddress = 0;
+		self->mConnectError = result_t::OK;
+		self->mState = CONNECTING;
+		self->touch();
+		self->connectNext();
+	});
+}
+
+result_t AsyncChannelImpl::close()
+{
+	result_t res = result_t::OK;
+	mLoop->runSync([this, &res]() {
+		res = mState == DISCONNECTED ? result_t::NOT_CONNECTED : result_t::OK;
+		abortWith(result_t::NOT_CONNECTED, result_t::NOT_CONNECTED);
+	});
+	return res;
+}
+
+void AsyncChannelImpl::detach()
+{
+	mLoop->runSync([this]() {
+		mDetached = true;
+		abortWith(result_t::NOT_CONNECTED, result_t::NOT_CONNECTED);
+	});
+}
+
+void AsyncChannelImpl::submit(std::shared_ptr<AsyncRequest> request)
+{
+	const std::shared_ptr<AsyncChannelImpl> self = shared_from_this();
+	mLoop->post([self, request]() {
+		if (self->mDetached || self->mState == DISCONNECTED) {
+			request->onComplete(result_t::NOT_CONNECTED, 0);
+			return;
+		}
+		if (self->mRequests.empty()) {
+			self->touch();
+		}
+		self->mRequests.push_back(request);
+		if (self->mState == CONNECTED) {
+			self->flushOutput();
+		}
+	});
+}
+
+void AsyncChannelImpl::postCompletion(AsyncCompletionCallback callback, const result_t status)
+{
+	mLoop->post([callback, status]() { callback(status, 0); });
+}
+
+/**************
+ * Events
+ */
+
+void AsyncChannelImpl::onEvents(const std::uint32_t events)
+{
+	if (mState == CONNECTING) {
+		int error = 0;
+		socklen_t errorLength = sizeof(error);
+		if (::getsockopt(mFd, SOL_SOCKET, SO_ERROR, &error, &errorLength) == -1) {
+			error = errno;
+		}
+		onConnectResult(error);
+		return;
+	}
+	if (mState != CONNECTED) {
+		return;
+	}
+	if ((events & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0) {
+		readInput();
+		if (mState != CONNECTED) {
+			return;
+		}
+	}
+	if ((events & EPOLLOUT) != 0) {
+		flushOutput();
+	}
+}
+
+AsyncChannelImpl::Clock::time_point AsyncChannelImpl::deadline() const
+{
+	if (mState == CONNECTING || (mState == CONNECTED && !mRequests.empty())) {
+		return mLastProgress + std::chrono::milliseconds(mTimeoutMs.load());
+	}
+	return Clock::time_point::max();
+}
+
+void AsyncChannelImpl::onDeadline()
+{
+	abortWith(result_t::CONNTIMEOUT, result_t::CONNTIMEOUT);
+}
+
+/**************
+ * Connecting
+ */
+
+void AsyncChannelImpl::connectNext()
+{
+	while (mNextAddress < mAddresses.size()) {
+		const Address& address = mAddresses[mNextAddress++];
+		const int family = address.addr.ss_family;
+		mFd = ::socket(family,
+			SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+			family == AF_UNIX ? 0 : IPPROTO_TCP);
+		if (mFd == -1) {
+			abortWith(result_t::SOCKET_ERROR, result_t::NOT_CONNECTED);
+			return;
+		}
+
+		const int resConnect = ::connect(
+			mFd, reinterpret_cast<const struct sockaddr*>(&address.addr), address.length);
+		const int error = resConnect == 0 ? 0 : errno;
+		if (resConnect == 0 || error == EINPROGRESS) {
+			mEvents = EPOLLOUT;
+			if (mLoop->addHandler(mFd, mEvents, this, mHandlerId) != result_t::OK) {
+				::close(mFd);
+				mFd = -1;
+				abortWith(result_t::SOCKET_ERROR, result_t::NOT_CONNECTED);
+				return;
+			}
+			if (resConnect == 0) {
+				onConnectResult(0);
+			}
+			return;
+		}
+
+		recordConnectError(error);
+		::close(mFd);
+		mFd = -1;
+	}
+
+	const result_t res =
+		mConnectError == result_t::OK ? result_t::BAD_ADDRESS : mConnectError;
+	abortWith(res, result_t::NOT_CONNECTED);
+}
+
+void AsyncChannelImpl::onConnectResult(const int error)
+{
+	if (error != 0) {
+		closeSocket();
+		recordConnectError(error);
+		connectNext();
+		return;
+	}
+
+	mRecv = Buffer(mMemoryLimit.load());
+	if (!mRecv) {
+		abortWith(result_t::OUT_OF_MEMORY, result_t::NOT_CONNECTED);
+		return;
+	}
+	mSkip = 0;
+	mSendCursor = 0;
+	mAddresses.clear();
+	mState = CONNECTED;
+	mConnected = true;
+	touch();
+
+	std::vector<AsyncCompletionCallback> callbacks;
+	callbacks.swap(mConnectCallbacks);
+	for (const AsyncCompletionCallback& callback : callbacks) {
+		callback(result_t::OK, 0);
+	}
+	if (mState == CONNECTED) {
+		flushOutput();
+	}
+}
+
+void AsyncChannelImpl::recordConnectError(const int error)
+{
+	// The same priorities as `Socket::connect()`.
+	const auto priority = [](const result_t res) {
+		switch (res) {
+			case result_t::CONNREFUSED:
+				return 1;
+			case result_t::CONNERROR:
+				return 2;
+			case result_t::CONNTIMEOUT:
+				return 3;
+			default:
+				return 0;
+		}
+	};
+	result_t res = result_t::CONNERROR;
+	if (error == ETIMEDOUT) {
+		res = result_t::CONNTIMEOUT;
+	} else if (error == ECONNREFUSED) {
+		res = result_t::CONNREFUSED;
+	}
+	if (priority(res) > priority(mConnectError)) {
+		mConnectError = res;
+	}
+}
+
+/**************
+ * Sending
+ */
+
+void AsyncChannelImpl::flushOutput()
+{
+	while (mSendCursor < mRequests.size()) {
+		std::deque<Buffer>& chunks = mRequests[mSendCursor]->chunks();
+		while (!chunks.empty()) {
+			Buffer& chunk = chunks.front();
+			const ssize_t sent = ::send(mFd, chunk.readData(), chunk.bytesAvailableToRead(),
+				MSG_NOSIGNAL | MSG_DONTWAIT);
+			if (sent < 0) {
+				const int error = errno;
+				if (error == EINTR) {
+					continue;
+				}
+				if (error == EAGAIN || error == EWOULDBLOCK) {
+					updateEvents();
+					return;
+				}
+				const result_t res = Socket::sendErrorToResult(error);
+				abortWith(res, res);
+				return;
+			}
+			touch();
+			chunk.readAdvance(static_cast<std::size_t>(sent));
+			if (chunk.bytesAvailableToRead() == 0) {
+				chunks.pop_front();
+			}
+		}
+		++mSendCursor;
+	}
+	updateEvents();
+}
+
+void AsyncChannelImpl::updateEvents()
+{
+	if (mState != CONNECTED) {
+		return;
+	}
+	std::uint32_t events = EPOLLIN;
+	if (mSendCursor < mRequests.size()) {
+		events |= EPOLLOUT;
+	}
+	if (events == mEvents) {
+		return;
+	}
+	if (mLoop->modifyHandler(mFd, events, mHandlerId) != result_t::OK) {
+		abortWith(result_t::SOCKET_ERROR, result_t::SOCKET_ERROR);
+		return;
+	}
+	mEvents = events;
+}
+
+/**************
+ * Receiving
+ */
+
+void AsyncChannelImpl::readInput()
+{
+	if (mRecv.bytesOfFreeSpace() == 0 && !mRecv.reserve(1)) {
+		abortWith(result_t::MEMORY_LIMIT_EXCEEDED, result_t::NOT_CONNECTED);
+		return;
+	}
+
+	const ssize_t received =
+		::recv(mFd, mRecv.writeData(), mRecv.bytesOfFreeSpace(), MSG_DONTWAIT);
+	if (received < 0) {
+		const int error = errno;
+		if (error == EINTR || error == EAGAIN || error == EWOULDBLOCK) {
+			return;
+		}
+		const result_t res = error == ECONNRESET ? result_t::CONNRESET : result_t::CONNERROR;
+		abortWith(res, res);
+		return;
+	}
+	if (received == 0) {
+		abortWith(result_t::CONNCLOSED, result_t::CONNCLOSED);
+		return;
+	}
+
+	touch();
+	mRecv.writeAdvance(static_cast<std::size_t>(received));
+	parseResponses();
+}
+
+void AsyncChannelImpl::parseResponses()
+{
+	while (mState == CONNECTED && skipPending()) {
+		if (mRequests.empty()) {
+			if (mRecv.bytesAvailableToRead() > 0) {
+				abortWith(result_t::BAD_RESPONSE, result_t::BAD_RESPONSE);
+			}
+			break;
+		}
+		// Keeps the request alive in case a callback closes the channel.
+		const std::shared_ptr<AsyncRequest> request = mRequests.front();
+		if (!parseNext(*request)) {
+			break;
+		}
+	}
+	if (mState == CONNECTED && mRecv.bytesAvailableToRead() == 0) {
+		mRecv.reset();
+	}
+}
+
+bool AsyncChannelImpl::parseNext(AsyncRequest& request)
+{
+	Serializer serializer(mRecv);
+	switch (request.phase) {
+		case AsyncRequest::HEADER: {
+			if (!need(Serializer::cHeaderSize)) {
+				return false;
+			}
+			const Header response = serializer.getHeader();
+			mSkip = response.dataSize;
+			// A PUT is done with its header, and so is a request the server
+			// rejected; the requests pipelined behind them go on.
+			if (response.id != 0 || request.kind() == AsyncRequest::PUT) {
+				completeFront(response.id != 0 ? result_t::ERROR : result_t::OK);
+			} else {
+				request.phase = AsyncRequest::RECORDS;
+			}
+			return true;
+		}
+
+		case AsyncRequest::RECORDS: {
+			if (!need(sizeof(std::int32_t))) {
+				flushChunk(request);
+				return false;
+			}
+			const std::int32_t recordSize = serializer.peekInt32();
+			if (recordSize == 0) {
+				serializer.confirmInt32();
+				flushChunk(request);
+				request.phase = AsyncRequest::ACQ;
+				return true;
+			}
+
+			const std::size_t payloadSize =
+				static_cast<std::size_t>(recordSize) - Serializer::cKeySize;
+			if (recordSize < static_cast<std::int32_t>(Serializer::cKeySize)
+				|| payloadSize > ChannelImpl::cMaxPayloadSize) {
+				abortWith(result_t::BAD_RESPONSE, result_t::NOT_CONNECTED);
+				return false;
+			}
+			if (!need(sizeof(std::int32_t) + recordSize)) {
+				flushChunk(request);
+				return false;
+			}
+
+			serializer.confirmInt32();
+			const Key key = serializer.getKey();
+			if (!key.isStorable()) {
+				abortWith(result_t::BAD_RESPONSE, result_t::NOT_CONNECTED);
+				return false;
+			}
+			const void* const payload = serializer.getDataBuffer(payloadSize);
+			if (!request.visitor(key, payload, payloadSize)) {
+				abortWith(result_t::DESERIALIZATION_ERROR, result_t::NOT_CONNECTED);
+				return false;
+			}
+			request.chunkDirty = true;
+			return true;
+		}
+
+		case AsyncRequest::ACQ: {
+			// An error comes with a plain header instead of the ACQ.
+			if (!need(Serializer::cHeaderSize)) {
+				return false;
+			}
+			if (serializer.peekInt32() != 0) {
+				const Header response = serializer.getHeader();
+				mSkip = response.dataSize;
+				completeFront(result_t::ERROR);
+				return true;
+			}
+			if (!need(Serializer::cHeaderSize + sizeof(Key::AcqT))) {
+				return false;
+			}
+			const HeaderAcq response = serializer.getHeaderAcq();
+			if (response.dataSize < 8) {
+				abortWith(result_t::BAD_RESPONSE, result_t::NOT_CONNECTED);
+				return false;
+			}
+			mSkip = response.dataSize - 8;
+			request.acq = response.acq;
+			completeFront(result_t::OK);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool AsyncChannelImpl::need(const std::size_t amountBytes)
+{
+	const std::size_t bytesAvailable = mRecv.bytesAvailableToRead();
+	if (bytesAvailable >= amountBytes) {
+		return true;
+	}
+	if (amountBytes > mRecv.capacity()) {
+		abortWith(result_t::MEMORY_LIMIT_EXCEEDED, result_t::NOT_CONNECTED);
+		return false;
+	}
+	(void)mRecv.reserve(amountBytes - bytesAvailable);
+	return false;
+}
+
+bool AsyncChannelImpl::skipPending()
+{
+	const std::size_t amount =
+		static_cast<std::size_t>(std::min<std::uint64_t>(mSkip, mRecv.bytesAvailableToRead()));
+	mRecv.readAdvance(amount);
+	mSkip -= amount;
+	return mSkip == 0;
+}
+
+void AsyncChannelImpl::flushChunk(AsyncRequest& request)
+{
+	if (mState == CONNECTED && request.chunkDirty && request.onChunk) {
+		request.chunkDirty = false;
+		request.onChunk();
+	}
+}
+
+void AsyncChannelImpl::completeFront(const result_t status)
+{
+	if (mSendCursor == 0) {
+		// The server responded to a request it hasn't fully received.
+		abortWith(result_t::BAD_RESPONSE, result_t::NOT_CONNECTED);
+		return;
+	}
+	const std::shared_ptr<AsyncRequest> request = mRequests.front();
+	mRequests.pop_front();
+	--mSendCursor;
+	touch();
+	request->onComplete(status, status == result_t::OK ? request->acq : 0);
+}
+
+void AsyncChannelImpl::abortWith(const result_t status, const result_t restStatus)
+{
+	closeSocket();
+	mState = DISCONNECTED;
+	mConnected = false;
+	mRecv = Buffer{};
+	mSkip = 0;
+	mSendCursor = 0;
+	mAddresses.clear();
+
+	// Detach the pending work first, since the callbacks may reuse the channel.
+	std::vector<AsyncCompletionCallback> callbacks;
+	callbacks.swap(mConnectCallbacks);
+	std::deque<std::shared_ptr<AsyncRequest>> requests;
+	requests.swap(mRequests);
+
+	for (const AsyncCompletionCallback& callback : callbacks) {
+		callback(status, 0);
+	}
+	bool failed = callbacks.empty();
+	for (const std::shared_ptr<AsyncRequest>& request : requests) {
+		request->onComplete(failed ? status : restStatus, 0);
+		failed = false;
+	}
+}
+
+void AsyncChannelImpl::closeSocket()
+{
+	if (mFd != -1) {
+		mLoop->removeHandler(mFd, mHandlerId);
+		::close(mFd);
+		mFd = -1;
+	}
+	mEvents = 0;
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
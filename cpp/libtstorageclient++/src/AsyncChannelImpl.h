@@ -0,0 +1,370 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * AsyncChannelImpl.h
+ *   A non-blocking implementation of the TStorage protocol.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_ASYNCCHANNELIMPL_PH
+#define D_TSTORAGE_ASYNCCHANNELIMPL_PH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "BatchSerializer.h"
+#include "Buffer.h"
+#include "EventLoopImpl.h"
+#include "Headers.h"
+#include "PayloadSizePredictor.h"
+
+/** @file
+ * @brief Provides the implementation of `AsyncChannel<T>`. */
+
+namespace tstorage {
+namespace impl {
+
+/** @brief A request completion callback (see `AsyncChannelBase`). */
+using AsyncCompletionCallback = std::function<void(result_t status, Key::AcqT acq)>;
+/** @brief A GET record visitor (see `AsyncChannelBase`). */
+using AsyncRecordVisitor =
+	std::function<bool(const Key& key, const void* payload, std::size_t payloadSize)>;
+/** @brief A GET record portion callback (see `AsyncChannelBase`). */
+using AsyncChunkCallback = std::function<void()>;
+
+/**
+ * @brief A single serialized TStorage request together with the state of
+ * processing its response.
+ *
+ * The request's bytes are kept in a list of buffers ("chunks") of the
+ * channel's memory limit in size. A PUT/A request is built incrementally in
+ * the same way `ChannelImpl` builds it, except that a full buffer is appended
+ * to the list instead of being sent, so the request is complete in memory
+ * before it's handed over to the event loop.
+ */
+class AsyncRequest final
+{
+public:
+	/** @brief The request type. */
+	enum Kind {
+		GET,
+		GETACQ,
+		PUT,
+	};
+
+	/** @brief The part of the response expected next. */
+	enum Phase {
+		/** @brief The response header of GET and PUT/A. */
+		HEADER,
+		/** @brief The records of a GET response. */
+		RECORDS,
+		/** @brief The ACQ header of GET and GETACQ. */
+		ACQ,
+	};
+
+	/**
+	 * @brief Constructs a PUT/A request and writes its header.
+	 * @param proto The protocol version.
+	 * @param chunkSize The capacity of each buffer.
+	 */
+	AsyncRequest(BatchSerializer::ProtoT proto, std::size_t chunkSize);
+	/**
+	 * @brief Constructs a complete GET or GETACQ request.
+	 * @param kind `GET` or `GETACQ`.
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 */
+	AsyncRequest(Kind kind, const Key& keyMin, const Key& keyMax);
+
+	AsyncRequest(const AsyncRequest&) = delete;
+	AsyncRequest(AsyncRequest&&) = delete;
+	AsyncRequest& operator=(const AsyncRequest&) = delete;
+	AsyncRequest& operator=(AsyncRequest&&) = delete;
+
+	/** @brief Returns `false` if the initial buffer allocation failed. */
+	bool valid() const { return !mChunks.empty() || mCurrent.valid(); }
+	/** @brief Returns the request type. */
+	Kind kind() const { return mKind; }
+
+	/** @brief Reserves a payload block sized after the largest payload so far.
+	 * @see `AsyncChannelBase::obtainPayloadBuffer()` */
+	result_t obtainPayloadBuffer(void*& oPayloadBuffer, std::size_t& oBufferSize, const Key& key);
+	/** @brief Reserves a payload block of at least `payloadSize` bytes.
+	 * @see `AsyncChannelBase::reservePayloadBuffer()` */
+	result_t reservePayloadBuffer(void*& oPayloadBuffer,
+		std::size_t& oBufferSize,
+		std::size_t payloadSize,
+		const Key& key);
+	/** @brief Appends the metadata of the record serialized last.
+	 * @see `AsyncChannelBase::writeNextRecord()` */
+	result_t writeNextRecord(const Key& key, std::size_t payloadSize);
+	/** @brief Appends a record with a copy of the given payload.
+	 * @see `AsyncChannelBase::writeNextRecordView()` */
+	result_t writeNextRecordView(const Key& key, const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief Ends the last batch and appends the end-of-stream marker of a
+	 * PUT/A request.
+	 * @return `result_t::OUT_OF_MEMORY` on allocation failure, `result_t::OK`
+	 * otherwise.
+	 */
+	result_t finish();
+
+	/** @brief Returns the list of buffers left to send. */
+	std::deque<Buffer>& chunks() { return mChunks; }
+
+	/** @brief The record visitor of a GET request. */
+	AsyncRecordVisitor visitor;
+	/** @brief The record portion callback of a GET request (might be empty). */
+	AsyncChunkCallback onChunk;
+	/** @brief The completion callback. */
+	AsyncCompletionCallback onComplete;
+	/** @brief The part of the response expected next. */
+	Phase phase;
+	/** @brief The ACQ returned by the server. */
+	Key::AcqT acq;
+	/** @brief `true` if records were visited since the last `onChunk()`. */
+	bool chunkDirty;
+
+private:
+	/** @brief Moves the current buffer to the list and starts a new one. */
+	result_t sealChunk();
+
+	/** @brief The request type. */
+	Kind mKind;
+	/** @brief The protocol version of a PUT/A request. */
+	BatchSerializer::ProtoT mProto;
+	/** @brief The capacity of each buffer. */
+	std::size_t mChunkSize;
+	/** @brief The size hint of `obtainPayloadBuffer()`. */
+	PayloadSizePredictor mPayloadSizes;
+	/** @brief Completed buffers. */
+	std::deque<Buffer> mChunks;
+	/** @brief The buffer the request is written to. */
+	Buffer mCurrent;
+	/** @brief The batch state of `mCurrent`. */
+	BatchSerializer mBatch;
+};
+
+/**
+ * @brief A non-blocking TStorage connection driven by an `EventLoopImpl`.
+ *
+ * Submitted requests are queued in submission order. The connection writes
+ * them out back-to-back as the socket becomes writable and parses the
+ * responses, which the server sends in the same order, as the socket becomes
+ * readable. In other words, requests are pipelined: a request may be sent
+ * before the responses to the previous ones are received.
+ *
+ * Responses are parsed incrementally from a receive buffer of the memory
+ * limit in size. A GET response record which doesn't fit into the buffer as a
+ * whole fails the request with `result_t::MEMORY_LIMIT_EXCEEDED`.
+ *
+ * Any error encountered while processing a request breaks the connection, as
+ * it does with `ChannelImpl`. The failed request is completed with the error
+ * code, and all requests queued behind it with `result_t::NOT_CONNECTED`,
+ * unless the error concerns the connection as a whole (e.g. a timeout), in
+ * which case they all share it.
+ *
+ * A timeout is signalled if the connection makes no progress (no bytes are
+ * sent or received) for the timeout period while connecting or while any
+ * requests are pending.
+ *
+ * Apart from the configuration setters, `connected()`, and the methods that
+ * post tasks to the loop (`connect()`, `submit()`, `postCompletion()`,
+ * `close()` and `detach()`), all methods are called on the loop's thread.
+ */
+class AsyncChannelImpl final
+	: public EventHandler
+	, public std::enable_shared_from_this<AsyncChannelImpl>
+{
+private:
+	/** @brief The default size of the request and receive buffers. */
+	static constexpr std::size_t cInitialBufferSize = 64L * 1024;  // 64 KiB
+	/** @brief The minimal size of the request and receive buffers. */
+	static constexpr std::size_t cMinBufferSize = 128;  // 128B
+	/** @brief The default timeout. */
+	static constexpr std::int64_t cDefaultTimeoutMs = 20'000;
+
+public:
+	/**
+	 * @brief A constructor.
+	 * @param loop The event loop driving the connection.
+	 */
+	explicit AsyncChannelImpl(EventLoopImpl& loop);
+	/** @brief A destructor. The connection must be closed beforehand. */
+	~AsyncChannelImpl() override = default;
+
+	AsyncChannelImpl(const AsyncChannelImpl&) = delete;
+	AsyncChannelImpl(AsyncChannelImpl&&) = delete;
+	AsyncChannelImpl& operator=(const AsyncChannelImpl&) = delete;
+	AsyncChannelImpl& operator=(AsyncChannelImpl&&) = delete;
+
+	/** @brief Sets the address of the TStorage server. */
+	void setHost(const std::string& addr, std::uint16_t port);
+	/** @brief Sets the timeout in milliseconds. */
+	void setTimeoutMs(std::int64_t timeoutMs) { mTimeoutMs = timeoutMs; }
+	/** @brief Sets the size of the request and receive buffers. */
+	void setMemoryLimit(std::size_t memoryLimitBytes);
+	/** @brief Returns the size of the request and receive buffers. */
+	std::size_t memoryLimit() const { return mMemoryLimit.load(); }
+	/** @brief Returns `true` if the connection is established. */
+	bool connected() const { return mConnected.load(); }
+
+	/**
+	 * @brief Resolves the server's address and starts connecting on the loop's
+	 * thread.
+	 * @param callback The completion callback.
+	 */
+	void connect(AsyncCompletionCallback callback);
+	/**
+	 * @brief Closes the connection on the loop's thread and waits for it.
+	 * @return `result_t::NOT_CONNECTED` if the channel was not connected,
+	 * `result_t::OK` otherwise.
+	 */
+	result_t close();
+	/**
+	 * @brief Closes the connection for good. Tasks still queued on the loop
+	 * are completed with `result_t::NOT_CONNECTED`.
+	 */
+	void detach();
+	/**
+	 * @brief Queues a request for sending.
+	 * @param request The request.
+	 */
+	void submit(std::shared_ptr<AsyncRequest> request);
+	/**
+	 * @brief Invokes a completion callback on the loop's thread.
+	 * @param callback The callback.
+	 * @param status The status code passed to the callback.
+	 */
+	void postCompletion(AsyncCompletionCallback callback, result_t status);
+
+	void onEvents(std::uint32_t events) override;
+	Clock::time_point deadline() const override;
+	void onDeadline() override;
+
+private:
+	/** @brief The connection state. */
+	enum State {
+		DISCONNECTED,
+		CONNECTING,
+		CONNECTED,
+	};
+
+	/** @brief A resolved address of the server. */
+	struct Address
+	{
+		/** @brief The socket address. */
+		struct sockaddr_storage addr;
+		/** @brief The length of `addr`. */
+		socklen_t length;
+	};
+
+	/** @brief Starts connecting to the next resolved address. */
+	void connectNext();
+	/** @brief Handles the outcome of a connection attempt. */
+	void onConnectResult(int error);
+	/** @brief Updates `mConnectError` with the `errno` of a failed connection
+	 * attempt. */
+	void recordConnectError(int error);
+	/** @brief Writes queued requests until the socket would block. */
+	void flushOutput();
+	/** @brief Receives data and parses responses. */
+	void readInput();
+	/** @brief Parses the received responses as far as possible. */
+	void parseResponses();
+	/** @brief Parses a part of the response to the front request. Returns
+	 * `false` if more data is needed or the connection was closed. */
+	bool parseNext(AsyncRequest& request);
+	/** @brief Checks if `amountBytes` are available in the receive buffer,
+	 * making room for them if not. Fails the front request if they can't fit. */
+	bool need(std::size_t amountBytes);
+	/** @brief Consumes the bytes to skip. Returns `true` if none are left. */
+	bool skipPending();
+	/** @brief Invokes the record portion callback of a GET request. */
+	void flushChunk(AsyncRequest& request);
+	/** @brief Completes the front request with `status`. */
+	void completeFront(result_t status);
+	/** @brief Breaks the connection, failing the front request with `status`
+	 * and the rest with `restStatus`. */
+	void abortWith(result_t status, result_t restStatus);
+	/** @brief Releases the socket. */
+	void closeSocket();
+	/** @brief Updates the mask of events to wait for. */
+	void updateEvents();
+	/** @brief Records progress, postponing the deadline. */
+	void touch() { mLastProgress = Clock::now(); }
+
+	/** @brief The event loop. */
+	EventLoopImpl* mLoop;
+	/** @brief The hostname of the server. */
+	std::string mAddr;
+	/** @brief The port of the server. */
+	std::uint16_t mPort;
+	/** @brief Guards `mAddr` and `mPort`. */
+	std::mutex mHostMutex;
+	/** @brief The timeout in milliseconds. */
+	std::atomic<std::int64_t> mTimeoutMs;
+	/** @brief The size of the request and receive buffers. */
+	std::atomic<std::size_t> mMemoryLimit;
+	/** @brief `true` while the connection is established. */
+	std::atomic<bool> mConnected;
+	/** @brief `true` once the channel is closed for good. */
+	bool mDetached;
+
+	/** @brief The connection state. */
+	State mState;
+	/** @brief The socket, or `-1`. */
+	int mFd;
+	/** @brief The registration ID of the socket. */
+	std::uint64_t mHandlerId;
+	/** @brief The mask of events the socket is registered for. */
+	std::uint32_t mEvents;
+	/** @brief Resolved addresses of the server. */
+	std::vector<Address> mAddresses;
+	/** @brief The index of the next address to connect to. */
+	std::size_t mNextAddress;
+	/** @brief The most severe error of failed connection attempts. */
+	result_t mConnectError;
+	/** @brief Callbacks awaiting the end of connecting. */
+	std::vector<AsyncCompletionCallback> mConnectCallbacks;
+	/** @brief The time of the last progress. */
+	Clock::time_point mLastProgress;
+
+	/** @brief Requests awaiting responses, in submission order. */
+	std::deque<std::shared_ptr<AsyncRequest>> mRequests;
+	/** @brief The amount of front requests sent completely. */
+	std::size_t mSendCursor;
+	/** @brief The receive buffer. */
+	Buffer mRecv;
+	/** @brief The amount of received bytes to discard. */
+	std::uint64_t mSkip;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * BandwidthEstimator.cpp
+ *   An estimate of the bandwidth-delay product of a connection.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BandwidthEstimator.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::uint64_t BandwidthEstimator::cMinSampleBytes;
+constexpr unsigned int BandwidthEstimator::cDecayShift;
+
+BandwidthEstimator::BandwidthEstimator()
+	: mActive(false), mStart{}, mStartBytes(0), mBandwidth(0), mRttUs(0)
+{
+}
+
+void BandwidthEstimator::finish(const std::chrono::steady_clock::time_point now,
+	const std::uint64_t bytes,
+	const std::uint32_t rttUs)
+{
+	if (!mActive) {
+		return;
+	}
+	mActive = false;
+	mRttUs = rttUs;
+
+	const std::uint64_t amount = bytes - mStartBytes;
+	const auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - mStart).count();
+	if (amount < cMinSampleBytes || elapsedUs <= 0) {
+		return;
+	}
+	const std::uint64_t rate = amount * 1'000'000 / static_cast<std::uint64_t>(elapsedUs);
+	mBandwidth -= mBandwidth >> cDecayShift;
+	if (rate > mBandwidth) {
+		mBandwidth = rate;
+	}
+}
+
+void BandwidthEstimator::reset()
+{
+	mActive = false;
+	mBandwidth = 0;
+	mRttUs = 0;
+}
+
+std::size_t BandwidthEstimator::bdpBytes() const
+{
+	return static_cast<std::size_t>(mBandwidth / 1000 * mRttUs / 1000);
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
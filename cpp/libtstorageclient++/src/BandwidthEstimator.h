@@ -0,0 +1,110 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * BandwidthEstimator.h
+ *   An estimate of the bandwidth-delay product of a connection.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_BANDWIDTHESTIMATOR_PH
+#define D_TSTORAGE_BANDWIDTHESTIMATOR_PH
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/** @file
+ * @brief Defines the estimator of the bandwidth-delay product behind buffer
+ * auto-tuning. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief Estimates the bandwidth-delay product of a connection from the
+ * transfers made over it.
+ *
+ * A transfer lasts from the first request sent by an idle channel until the
+ * channel is idle again; its rate is the amount of bytes sent and received
+ * meanwhile over its duration. Small transfers are latency-bound and would
+ * only drag the estimate down, so the bandwidth is the maximum of the recent
+ * rates, decayed by `1 / 2^cDecayShift` with every transfer so that it
+ * follows a path which gets slower. The round-trip time is the one smoothed by
+ * the kernel, taken at the end of each transfer.
+ */
+class BandwidthEstimator
+{
+public:
+	/** @brief The amount of bytes below which a transfer is not sampled. */
+	static constexpr std::uint64_t cMinSampleBytes = 16 * 1024;
+	/** @brief The decay of the bandwidth per transfer, as a shift. */
+	static constexpr unsigned int cDecayShift = 3;
+
+	/** @brief Constructs an estimator without samples. */
+	BandwidthEstimator();
+
+	/**
+	 * @brief Starts a transfer, unless one is in progress.
+	 * @param now The current time.
+	 * @param bytes The amount of bytes transferred over the connection so
+	 * far.
+	 */
+	void start(std::chrono::steady_clock::time_point now, std::uint64_t bytes)
+	{
+		if (!mActive) {
+			mActive = true;
+			mStart = now;
+			mStartBytes = bytes;
+		}
+	}
+	/**
+	 * @brief Ends the transfer in progress, if any, and samples its rate.
+	 * @param now The current time.
+	 * @param bytes The amount of bytes transferred over the connection so
+	 * far.
+	 * @param rttUs The smoothed round-trip time of the connection in
+	 * microseconds.
+	 */
+	void finish(std::chrono::steady_clock::time_point now, std::uint64_t bytes, std::uint32_t rttUs);
+	/** @brief Drops the samples. */
+	void reset();
+
+	/** @brief Returns the bandwidth in bytes per second, `0` if unknown. */
+	std::uint64_t bandwidth() const { return mBandwidth; }
+	/** @brief Returns the round-trip time in microseconds, `0` if unknown. */
+	std::uint32_t rttUs() const { return mRttUs; }
+	/** @brief Returns the bandwidth-delay product in bytes, `0` if
+	 * unknown. */
+	std::size_t bdpBytes() const;
+
+private:
+	/** @brief `true` while a transfer is in progress. */
+	bool mActive;
+	/** @brief The start time of the transfer in progress. */
+	std::chrono::steady_clock::time_point mStart;
+	/** @brief The amount of bytes transferred before the transfer in
+	 * progress. */
+	std::uint64_t mStartBytes;
+	/** @brief The decayed maximum rate in bytes per second. */
+	std::uint64_t mBandwidth;
+	/** @brief The last round-trip time in microseconds. */
+	std::uint32_t mRttUs;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
@@ -21,12 +21,15 @@
 
 #include "BatchSerializer.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include <tstorageclient++/DataTypes.h>
 
+#include "Probes.h"
 #include "Serializer.h"
 
 namespace tstorage {
@@ -34,6 +37,13 @@ namespace impl {
 
 template<BatchSerializer::ProtoT PutProtocol>
 void BatchSerializer::putRecord(const Key& key, const std::size_t payloadSize)
+{
+	putRecordHeader<PutProtocol>(key, payloadSize);
+	Serializer(*mBuffer).confirmPayloadBuffer(payloadSize);
+}
+
+template<BatchSerializer::ProtoT PutProtocol>
+void BatchSerializer::putRecordHeader(const Key& key, const std::size_t payloadSize)
 {
 	if (key.cid != mCid && mCid >= 0) {
 		endBatch();
@@ -56,12 +66,12 @@ void BatchSerializer::putRecord(const Key& key, const std::size_t payloadSize)
 		serializer.putInt32(recordSize);
 		serializer.putAbbrevKey(key);
 	}
-	serializer.confirmPayloadBuffer(payloadSize);
 	mBatchSize += static_cast<std::int32_t>(sizeof(std::int32_t) + recordSize);
 }
 
 void BatchSerializer::endBatch()
 {
+	TSTORAGE_PROBE2(put__batch, mCid, mBatchSize);
 	Serializer::put<std::int32_t>(mBatchSize, mBatchSizeField);
 	mBatchSize = 0;
 	mBatchSizeField = mBuffer->writeData(cBatchSizeOffset);
@@ -72,6 +82,51 @@ std::size_t BatchSerializer::getNextRecordOffset(Key::CidT cid) const
 	return (empty() || cid != mCid) ? cBatchHeaderSize : 0;
 }
 
+bool BatchSerializer::coalesce(const Buffer& source,
+	const std::size_t batchesOffset,
+	Buffer& oTarget,
+	std::vector<BatchSpan>& oSpans)
+{
+	oSpans.clear();
+	const std::size_t end = source.bytesAvailableToRead();
+	std::size_t offset = batchesOffset;
+	while (offset < end) {
+		BatchSpan span{};
+		Serializer::get(span.cid, source.readData(offset));
+		Serializer::get(span.size, source.readData(offset + cBatchSizeOffset));
+		span.offset = offset + cBatchHeaderSize;
+		oSpans.push_back(span);
+		offset = span.offset + span.size;
+	}
+
+	const auto cidLess = [](const BatchSpan& a, const BatchSpan& b) { return a.cid < b.cid; };
+	const auto cidEqual = [](const BatchSpan& a, const BatchSpan& b) { return a.cid == b.cid; };
+	std::stable_sort(oSpans.begin(), oSpans.end(), cidLess);
+	if (std::adjacent_find(oSpans.begin(), oSpans.end(), cidEqual) == oSpans.end()) {
+		return false;
+	}
+
+	oTarget.reset();
+	std::memcpy(oTarget.writeData(), source.readData(), batchesOffset);
+	oTarget.writeAdvance(batchesOffset);
+	std::vector<BatchSpan>::const_iterator first = oSpans.begin();
+	while (first != oSpans.end()) {
+		std::vector<BatchSpan>::const_iterator last = first;
+		std::int32_t batchSize = 0;
+		for (; last != oSpans.end() && last->cid == first->cid; ++last) {
+			batchSize += last->size;
+		}
+		Serializer::put<std::int32_t>(first->cid, oTarget.writeData());
+		Serializer::put<std::int32_t>(batchSize, oTarget.writeData(cBatchSizeOffset));
+		oTarget.writeAdvance(cBatchHeaderSize);
+		for (; first != last; ++first) {
+			std::memcpy(oTarget.writeData(), source.readData(first->offset), first->size);
+			oTarget.writeAdvance(first->size);
+		}
+	}
+	return true;
+}
+
 /***************
  * Explicit template instantiations
  */
@@ -80,6 +135,10 @@ template void BatchSerializer::putRecord<BatchSerializer::ProtoT::PUT>(
 	const Key& key, std::size_t payloadSize);
 template void BatchSerializer::putRecord<BatchSerializer::ProtoT::PUTA>(
 	const Key& key, std::size_t payloadSize);
+template void BatchSerializer::putRecordHeader<BatchSerializer::ProtoT::PUT>(
+	const Key& key, std::size_t payloadSize);
+template void BatchSerializer::putRecordHeader<BatchSerializer::ProtoT::PUTA>(
+	const Key& key, std::size_t payloadSize);
 
 } /*namespace impl*/
 } /*namespace tstorage*/
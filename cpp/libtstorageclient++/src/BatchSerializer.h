@@ -24,6 +24,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include <tstorageclient++/DataTypes.h>
 
@@ -67,6 +68,10 @@ namespace impl {
  * append it to the current batch. The offset of the record itself inside the
  * buffer, which can be nonzero, is essential for payload serialization. It can
  * be queried by `getNextRecordOffset()`.
+ *
+ * Since only one batch is open at a time, a record stream interleaving CIDs
+ * produces a batch per record. Once all batches of a buffer are ended,
+ * `coalesce()` can merge the batches sharing a CID before the buffer is sent.
  */
 class BatchSerializer
 {
@@ -83,6 +88,17 @@ public:
 	/** @brief The offset of the size field from the beginning of the batch. */
 	static constexpr std::size_t cBatchSizeOffset = sizeof(Key::CidT);
 
+	/** @brief The location of the records of a batch inside a buffer. */
+	struct BatchSpan
+	{
+		/** @brief CID of the batch. */
+		Key::CidT cid;
+		/** @brief The size of the records of the batch in bytes. */
+		std::int32_t size;
+		/** @brief The offset of the records from the buffer's read location. */
+		std::size_t offset;
+	};
+
 	/**
 	 * @brief A constructor. Sets up the initial state of the serializer.
 	 * @param buf A buffer to serialize batches into.
@@ -106,6 +122,22 @@ public:
 	 */
 	template<ProtoT PutProtocol>
 	void putRecord(const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Appends the next record's size field and key to the current batch,
+	 * ending it and starting a new one if necessary, but does not account for
+	 * the payload inside the buffer.
+	 *
+	 * The payload size is still included in the record and batch size fields.
+	 * Used for records the payload of which is sent directly from user memory;
+	 * the batch has to be ended and the buffer flushed before the payload is
+	 * sent.
+	 *
+	 * @tparam PutProtocol A protocol tag, see `putRecord()`.
+	 * @param key The record's key.
+	 * @param payloadSize The size of the record's payload.
+	 */
+	template<ProtoT PutProtocol>
+	void putRecordHeader(const Key& key, std::size_t payloadSize);
 	/** @brief Ends the current batch. */
 	void endBatch();
 
@@ -116,6 +148,30 @@ public:
 	/** @brief Returns `true` if the batch has no records, `false` otherwise. */
 	bool empty() const { return mBatchSize == 0; }
 
+	/**
+	 * @brief Merges the batches of a buffer sharing a CID into single batches.
+	 *
+	 * Reads the batches stored in `source` from `batchesOffset` onward, all of
+	 * which need to be ended. If several of them share a CID, writes the first
+	 * `batchesOffset` bytes of `source` to `oTarget` as they are, followed by
+	 * a single batch per CID, holding the records of all batches with that CID
+	 * in their original order. The result is never larger than the source, so
+	 * `oTarget` must have at least as much capacity as `source` holds data.
+	 *
+	 * @param source The buffer holding the batches, read-only.
+	 * @param batchesOffset The offset of the first batch from the read location
+	 * of `source`.
+	 * @param[out] oTarget The buffer to write the merged batches to. Reset
+	 * first.
+	 * @param[out] oSpans A scratch array reused between calls.
+	 * @return `true` if the merged batches were written to `oTarget`, `false`
+	 * if each CID has a single batch already and `oTarget` is left untouched.
+	 */
+	static bool coalesce(const Buffer& source,
+		std::size_t batchesOffset,
+		Buffer& oTarget,
+		std::vector<BatchSpan>& oSpans);
+
 private:
 	/** @brief A pointer to the underlying `Buffer`. */
 	Buffer* mBuffer;
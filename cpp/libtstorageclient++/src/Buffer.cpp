@@ -21,35 +21,267 @@
 
 #include "Buffer.h"
 
+#include <array>
+#include <climits>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
-#include <new>
 #include <utility>
 
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Probes.h"
+
 namespace tstorage {
 namespace impl {
 
-Buffer::Buffer() : mBuffer(nullptr), mBufferSize(0), mWriteOffset(0), mReadOffset(0)
+namespace {
+
+/** @brief The alignment of heap-allocated blocks smaller than a page. */
+constexpr std::size_t cCacheLineSize = 64;
+/** @brief The size of a huge page, and the least size of a buffer backed
+ * with huge pages. */
+constexpr std::size_t cHugePageSize = 2L * 1024 * 1024;  // 2 MiB
+/** @brief The amount of NUMA nodes a buffer can be bound to. */
+constexpr std::size_t cMaxNumaNodes = 1024;
+
+std::size_t pageSize()
 {
+	static const std::size_t size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+	return size;
 }
 
-Buffer::Buffer(const std::size_t initialBufferSize)
-	: mBuffer(new(std::nothrow) uint8_t[initialBufferSize])
+std::size_t roundUp(const std::size_t size, const std::size_t alignment)
+{
+	return (size + alignment - 1) / alignment * alignment;
+}
+
+/** @brief Allocates `size` bytes on the heap, aligned to the page if they
+ * span one, or to the cache line otherwise. Returns `nullptr` on failure. */
+uint8_t* allocateAligned(const std::size_t size)
+{
+	void* block = nullptr;
+	const std::size_t alignment = size >= pageSize() ? pageSize() : cCacheLineSize;
+	if (posix_memalign(&block, alignment, size != 0 ? size : 1) != 0) {
+		return nullptr;
+	}
+	return static_cast<uint8_t*>(block);
+}
+
+/** @brief Maps `size` bytes, a multiple of the page size, at an address
+ * aligned to `alignment`, a multiple of the page size. Returns `nullptr` on
+ * failure. */
+uint8_t* mapAligned(const std::size_t size, const std::size_t alignment, const int protection)
+{
+	const std::size_t slack = alignment - pageSize();
+	void* const mapping =
+		mmap(nullptr, size + slack, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED) {
+		return nullptr;
+	}
+	uint8_t* const start = static_cast<uint8_t*>(mapping);
+	uint8_t* const block = start + (roundUp(reinterpret_cast<std::uintptr_t>(start), alignment)
+										- reinterpret_cast<std::uintptr_t>(start));
+	if (block != start) {
+		munmap(start, static_cast<std::size_t>(block - start));
+	}
+	const std::size_t tail = slack - static_cast<std::size_t>(block - start);
+	if (tail != 0) {
+		munmap(block + size, tail);
+	}
+	return block;
+}
+
+/** @brief Applies the huge pages and the NUMA node of `allocation` to the
+ * untouched pages of a mapping. Failures leave the placement to the system. */
+void placePages(uint8_t* const block,
+	const std::size_t size,
+	const BufferAllocation& allocation,
+	const bool hugetlb)
+{
+	if (!hugetlb && allocation.hugePages != BufferAllocation::HugePages::NONE) {
+		(void)madvise(block, size, MADV_HUGEPAGE);
+	}
+	if (allocation.numaNode >= 0 && static_cast<std::size_t>(allocation.numaNode) < cMaxNumaNodes) {
+		constexpr std::size_t cBitsPerWord = sizeof(unsigned long) * CHAR_BIT;
+		std::array<unsigned long, cMaxNumaNodes / cBitsPerWord> nodeMask{};
+		const std::size_t node = static_cast<std::size_t>(allocation.numaNode);
+		nodeMask[node / cBitsPerWord] |= 1UL << (node % cBitsPerWord);
+		(void)syscall(SYS_mbind, block, size, MPOL_PREFERRED, nodeMask.data(), cMaxNumaNodes, 0);
+	}
+}
+
+/** @brief Maps a `LINEAR` block of at least `size` bytes placed as
+ * `allocation` says, setting `oMappingSize` to the size of the mapping.
+ * Returns `nullptr` on failure. */
+uint8_t* mapLinear(
+	const std::size_t size, const BufferAllocation& allocation, std::size_t& oMappingSize)
+{
+	const bool huge =
+		allocation.hugePages != BufferAllocation::HugePages::NONE && size >= cHugePageSize;
+	if (huge && allocation.hugePages == BufferAllocation::HugePages::RESERVED) {
+		oMappingSize = roundUp(size, cHugePageSize);
+		void* const mapping = mmap(nullptr,
+			oMappingSize,
+			PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+			-1,
+			0);
+		if (mapping != MAP_FAILED) {
+			placePages(static_cast<uint8_t*>(mapping), oMappingSize, allocation, true);
+			return static_cast<uint8_t*>(mapping);
+		}
+	}
+	oMappingSize = roundUp(size, pageSize());
+	uint8_t* const block =
+		mapAligned(oMappingSize, huge ? cHugePageSize : pageSize(), PROT_READ | PROT_WRITE);
+	if (block != nullptr) {
+		BufferAllocation regular = allocation;
+		if (!huge) {
+			regular.hugePages = BufferAllocation::HugePages::NONE;
+		}
+		placePages(block, oMappingSize, regular, false);
+	}
+	return block;
+}
+
+/** @brief Maps a memory block of `ringSize` bytes, a multiple of the page
+ * size, or of the huge page size for `hugetlb`, twice in a row. Returns
+ * `nullptr` on failure. */
+uint8_t* mapMirrored(
+	const std::size_t ringSize, const BufferAllocation& allocation, const bool hugetlb)
+{
+	const int fd = memfd_create("tstorage-buffer", MFD_CLOEXEC | (hugetlb ? MFD_HUGETLB : 0));
+	if (fd < 0) {
+		return nullptr;
+	}
+	const bool huge = allocation.hugePages != BufferAllocation::HugePages::NONE
+		&& ringSize >= cHugePageSize;
+	uint8_t* block = nullptr;
+	if (ftruncate(fd, static_cast<off_t>(ringSize)) == 0) {
+		block = mapAligned(2 * ringSize, huge ? cHugePageSize : pageSize(), PROT_NONE);
+	}
+	if (block != nullptr) {
+		const bool mapped =
+			mmap(block, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)
+				!= MAP_FAILED
+			&& mmap(block + ringSize,
+				   ringSize,
+				   PROT_READ | PROT_WRITE,
+				   MAP_SHARED | MAP_FIXED,
+				   fd,
+				   0)
+				!= MAP_FAILED;
+		if (mapped) {
+			// Both copies share the pages, placed by the policy of the first.
+			BufferAllocation regular = allocation;
+			if (!huge) {
+				regular.hugePages = BufferAllocation::HugePages::NONE;
+			}
+			placePages(block, ringSize, regular, hugetlb);
+		} else {
+			munmap(block, 2 * ringSize);
+			block = nullptr;
+		}
+	}
+	close(fd);
+	return block;
+}
+
+} /*namespace*/
+
+BufferAllocation resolveNode(const BufferAllocation& allocation)
+{
+	BufferAllocation resolved = allocation;
+	if (allocation.numaNode == BufferAllocation::cThreadNode) {
+		unsigned int cpu = 0;
+		unsigned int node = 0;
+		resolved.numaNode = syscall(SYS_getcpu, &cpu, &node, nullptr) == 0
+			? static_cast<std::int32_t>(node)
+			: BufferAllocation::cNoNode;
+	}
+	return resolved;
+}
+
+void BufferDeleter::operator()(uint8_t* const block) const
+{
+	if (mappingSize != 0) {
+		munmap(block, mappingSize);
+	} else {
+		free(block);
+	}
+}
+
+Buffer::Buffer()
+	: mBuffer(nullptr)
+	, mWindow(nullptr)
+	, mBufferSize(0)
+	, mWriteOffset(0)
+	, mReadOffset(0)
+	, mAllocation{}
+{
+}
+
+Buffer::Buffer(
+	const std::size_t initialBufferSize, const Layout layout, const BufferAllocation& allocation)
+	: mBuffer(nullptr)
+	, mWindow(nullptr)
 	, mBufferSize(initialBufferSize)
 	, mWriteOffset(0)
 	, mReadOffset(0)
+	, mAllocation(resolveNode(allocation))
 {
+	const bool placed = mAllocation.hugePages != BufferAllocation::HugePages::NONE
+		|| mAllocation.numaNode != BufferAllocation::cNoNode;
+	if (layout == MIRRORED && initialBufferSize > 0) {
+		uint8_t* block = nullptr;
+		std::size_t ringSize = 0;
+		if (mAllocation.hugePages == BufferAllocation::HugePages::RESERVED
+			&& initialBufferSize >= cHugePageSize) {
+			ringSize = roundUp(initialBufferSize, cHugePageSize);
+			block = mapMirrored(ringSize, mAllocation, true);
+		}
+		if (block == nullptr) {
+			ringSize = roundUp(initialBufferSize, pageSize());
+			block = mapMirrored(ringSize, mAllocation, false);
+		}
+		if (block != nullptr) {
+			mBuffer = std::unique_ptr<uint8_t[], BufferDeleter>(
+				block, BufferDeleter(2 * ringSize, true));
+			mWindow = block;
+			return;
+		}
+	}
+	if (placed && initialBufferSize > 0) {
+		std::size_t mappingSize = 0;
+		uint8_t* const block = mapLinear(initialBufferSize, mAllocation, mappingSize);
+		if (block != nullptr) {
+			mBuffer = std::unique_ptr<uint8_t[], BufferDeleter>(
+				block, BufferDeleter(mappingSize, false));
+			mWindow = block;
+			return;
+		}
+	}
+	mBuffer.reset(allocateAligned(initialBufferSize));
+	mWindow = mBuffer.get();
 }
 
 Buffer::Buffer(const Buffer& buf)
-	: mBuffer(buf ? new(std::nothrow) uint8_t[buf.mBufferSize] : nullptr)
+	: mBuffer(buf ? allocateAligned(buf.mBufferSize) : nullptr)
+	, mWindow(mBuffer.get())
 	, mBufferSize(0)
 	, mWriteOffset(0)
 	, mReadOffset(0)
+	, mAllocation{}
 {
 	if (mBuffer) {
-		memcpy(mBuffer.get(), buf.mBuffer.get(), buf.capacity());
+		memcpy(mWindow, buf.mWindow, buf.capacity());
 		mBufferSize = buf.capacity();
 		mWriteOffset = buf.writeOffset();
 		mReadOffset = buf.readOffset();
@@ -58,10 +290,13 @@ Buffer::Buffer(const Buffer& buf)
 
 Buffer::Buffer(Buffer&& buf) noexcept
 	: mBuffer(std::move(buf.mBuffer))
+	, mWindow(buf.mWindow)
 	, mBufferSize(std::move(buf.mBufferSize))
 	, mWriteOffset(std::move(buf.mWriteOffset))
 	, mReadOffset(std::move(buf.mReadOffset))
+	, mAllocation(buf.mAllocation)
 {
+	buf.mWindow = nullptr;
 	buf.mBufferSize = 0;
 	buf.mWriteOffset = 0;
 	buf.mReadOffset = 0;
@@ -70,19 +305,7 @@ Buffer::Buffer(Buffer&& buf) noexcept
 Buffer& Buffer::operator=(const Buffer& buf)
 {
 	if (this != &buf) {
-		if (mBufferSize != buf.mBufferSize) {
-			mBuffer.reset(buf ? new (std::nothrow) uint8_t[buf.mBufferSize] : nullptr);
-			if (mBuffer == nullptr) {
-				mBufferSize = 0;
-				mWriteOffset = 0;
-				mReadOffset = 0;
-			} else {
-				mBufferSize = buf.mBufferSize;
-				mWriteOffset = buf.mWriteOffset;
-				mReadOffset = buf.mReadOffset;
-			}
-		}
-		memcpy(mBuffer.get(), buf.mBuffer.get(), capacity());
+		*this = Buffer(buf);
 	}
 	return *this;
 }
@@ -91,9 +314,12 @@ Buffer& Buffer::operator=(Buffer&& buf) noexcept
 {
 	if (this != &buf) {
 		mBuffer = std::move(buf.mBuffer);
+		mWindow = buf.mWindow;
 		mBufferSize = buf.mBufferSize;
 		mWriteOffset = buf.mWriteOffset;
 		mReadOffset = buf.mReadOffset;
+		mAllocation = buf.mAllocation;
+		buf.mWindow = nullptr;
 		buf.mBufferSize = 0;
 		buf.mWriteOffset = 0;
 		buf.mReadOffset = 0;
@@ -101,21 +327,53 @@ Buffer& Buffer::operator=(Buffer&& buf) noexcept
 	return *this;
 }
 
-bool Buffer::reserve(std::size_t targetSize)
+bool Buffer::reserve(std::size_t targetSize, std::size_t& oBytesMoved)
 {
 	const std::size_t bytesAvailable = bytesAvailableToRead();
 	const std::size_t bytesFree = bytesOfFreeSpace();
+	oBytesMoved = 0;
 
 	if (bytesAvailable + targetSize > mBufferSize) {
 		return false;
 	}
 	if (targetSize > bytesFree) {
-		memmove(mBuffer.get(), readData(), bytesAvailable);
+		TSTORAGE_PROBE2(buffer__compact, bytesAvailable, mirrored());
+		if (mirrored()) {
+			// Any window starting within the first copy of the pages lies
+			// inside the mapping.
+			const std::size_t ringSize = mBuffer.get_deleter().mappingSize / 2;
+			std::size_t windowOffset = mWindow - mBuffer.get() + mReadOffset;
+			if (windowOffset >= ringSize) {
+				windowOffset -= ringSize;
+			}
+			mWindow = mBuffer.get() + windowOffset;
+		} else {
+			memmove(mWindow, readData(), bytesAvailable);
+			oBytesMoved = bytesAvailable;
+		}
 		mWriteOffset = bytesAvailable;
 		mReadOffset = 0;
 	}
 	return true;
 }
 
+bool Buffer::resize(const std::size_t newCapacity)
+{
+	const std::size_t bytesAvailable = bytesAvailableToRead();
+	if (bytesAvailable > newCapacity) {
+		return false;
+	}
+	Buffer resized(newCapacity, mirrored() ? MIRRORED : LINEAR, mAllocation);
+	if (!resized) {
+		return false;
+	}
+	if (bytesAvailable > 0) {
+		memcpy(resized.mWindow, readData(), bytesAvailable);
+	}
+	resized.mWriteOffset = bytesAvailable;
+	*this = std::move(resized);
+	return true;
+}
+
 } /*namespace impl*/
 } /*namespace tstorage*/
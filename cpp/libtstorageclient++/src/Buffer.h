@@ -26,12 +26,41 @@
 #include <cstdint>
 #include <memory>
 
+#include <tstorageclient++/DataTypes.h>
+
 /** @file
  * @brief Defines a static buffer with read/write position tracking. */
 
 namespace tstorage {
 namespace impl {
 
+/** @brief Frees the memory block of a `Buffer` of either layout. */
+struct BufferDeleter
+{
+	/** @brief Constructs a deleter of a heap-allocated block. */
+	BufferDeleter() : mappingSize(0), mirrored(false) {}
+	/** @brief Constructs a deleter of a mapped block. */
+	BufferDeleter(const std::size_t mappingSize, const bool mirrored)
+		: mappingSize(mappingSize)
+		, mirrored(mirrored)
+	{
+	}
+
+	/** @brief Frees `block`. */
+	void operator()(uint8_t* block) const;
+
+	/** @brief The size of the mapping, which for a `MIRRORED` buffer is a
+	 * double one, `0` for a heap-allocated block. */
+	std::size_t mappingSize;
+	/** @brief Whether the block belongs to a `MIRRORED` buffer. */
+	bool mirrored;
+};
+
+/** @brief Returns `allocation` with `BufferAllocation::cThreadNode` replaced
+ * by the NUMA node of the calling thread, or by `BufferAllocation::cNoNode`
+ * if it cannot be told. */
+BufferAllocation resolveNode(const BufferAllocation& allocation);
+
 /**
  * @brief A static buffer that keeps track of its last read/write locations.
  *
@@ -54,22 +83,46 @@ namespace impl {
  * up in an invalid state. In this state no memory is allocated by the `Buffer`
  * object, and any future memory access will yield undefined results. To check
  * whether a buffer is valid or not, use the `valid()` method.
+ *
+ * A buffer with the `MIRRORED` layout maps the same physical pages twice, one
+ * copy right after the other, and the capacity of the buffer is a window
+ * sliding over this mapping. Moving the unread content to the start of the
+ * window in `reserve()` then amounts to moving the window itself, without
+ * copying any data, while the memory between the read and the write offset
+ * stays contiguous. The layout is otherwise indistinguishable from the
+ * default, `LINEAR` one.
+ *
+ * The memory block is aligned to the cache line, or to the page if it spans
+ * one. A `BufferAllocation` other than the default one maps the block, so as
+ * to back it with huge pages or to bind it to a NUMA node, which a
+ * `MIRRORED` buffer applies to its pages as well.
  */
 class Buffer
 {
 public:
+	/** @brief A memory layout of the buffer. */
+	enum Layout {
+		LINEAR,  ///< A single block of memory.
+		MIRRORED  ///< Pages mapped twice, with `reserve()` never copying data.
+	};
+
 	/** @brief A default constructor, initializing the buffer in an invalid state.
 	 * Does not allocate memory.*/
 	Buffer();
 	/** @brief An allocating constructor. The resulting buffer has capacity
 	 * `initialBufferSize`. If the allocation fails due to insufficient memory,
-	 * the buffer object ends up in an invalid state. */
-	Buffer(std::size_t initialBufferSize);
+	 * the buffer object ends up in an invalid state. A `MIRRORED` buffer that
+	 * cannot be mapped falls back to the `LINEAR` layout, and huge pages
+	 * which cannot be had fall back to regular ones. */
+	Buffer(std::size_t initialBufferSize,
+		Layout layout = LINEAR,
+		const BufferAllocation& allocation = BufferAllocation{});
 	/** @brief The default destructor. Frees memory allocated by the buffer. */
 	~Buffer() = default;
 
 	/** @brief A copy constructor that initializes the object as an exact copy of
-	 * `buf`. On memory allocation failure the object becomes invalid. */
+	 * `buf`, in the `LINEAR` layout. On memory allocation failure the object
+	 * becomes invalid. */
 	Buffer(const Buffer& buf);
 	/** @brief A copy assignment operator that copies the state of `buf` over to
 	 * the caller. On memory allocation failure the object becomes invalid. */
@@ -87,9 +140,22 @@ public:
 	operator bool() const { return valid(); }
 	/** @brief Returns true if the buffer is in invalid state and false otherwise. */
 	bool operator!() const { return !valid(); }
+	/** @brief Returns true if the buffer has the `MIRRORED` layout. */
+	bool mirrored() const { return mBuffer.get_deleter().mirrored; }
+	/** @brief Returns the allocation the buffer was constructed with, its NUMA
+	 * node resolved. */
+	const BufferAllocation& allocation() const { return mAllocation; }
+	/** @brief Returns the start of the owned memory block. */
+	void* memory() { return mBuffer.get(); }
+	/** @brief Returns the size of the owned memory block, which for a
+	 * `MIRRORED` buffer spans both copies of it. */
+	std::size_t memorySize() const
+	{
+		return mirrored() ? mBuffer.get_deleter().mappingSize : mBufferSize;
+	}
 
 	/** @brief Returns the pointer to the current read location in the buffer. */
-	const void* readData(std::size_t offset = 0) const { return mBuffer.get() + mReadOffset + offset; }
+	const void* readData(std::size_t offset = 0) const { return mWindow + mReadOffset + offset; }
 	/** @brief Returns the offset of the current read location from the start of
 	 * the buffer. */
 	std::size_t readOffset() const { return mReadOffset; }
@@ -97,7 +163,7 @@ public:
 	void readAdvance(const std::size_t amount) { mReadOffset += amount; }
 
 	/** @brief Returns the pointer to the next write location in the buffer. */
-	void* writeData(std::size_t offset = 0) { return mBuffer.get() + mWriteOffset + offset; }
+	void* writeData(std::size_t offset = 0) { return mWindow + mWriteOffset + offset; }
 	/** @brief Returns the offset of the next write location from the start of
 	 * the buffer. */
 	std::size_t writeOffset() const { return mWriteOffset; }
@@ -120,25 +186,52 @@ public:
 	 *
 	 * If necessary to accomodate `targetSize` amount of bytes in the
 	 * buffer, moves its unread content to the start of the buffer, then checks
-	 * whether the requested amount of memory is available.
+	 * whether the requested amount of memory is available. A `MIRRORED` buffer
+	 * moves its window instead of the content.
 	 *
 	 * @param targetSize Amount of bytes to reserve.
+	 * @param[out] oBytesMoved The amount of bytes copied to move the content,
+	 * always `0` for `MIRRORED` buffers.
 	 * @return `true` if the specified amount of bytes is available to write, and
 	 * `false` otherwise.
 	 */
-	bool reserve(std::size_t targetSize);
+	bool reserve(std::size_t targetSize, std::size_t& oBytesMoved);
+	/** @brief Attempts to reserve a specified amount of bytes inside the
+	 * buffer, see `reserve(std::size_t, std::size_t&)`. */
+	bool reserve(const std::size_t targetSize)
+	{
+		std::size_t bytesMoved{};
+		return reserve(targetSize, bytesMoved);
+	}
+	/**
+	 * @brief Attempts to change the capacity of the buffer.
+	 *
+	 * Allocates a memory block of `newCapacity` bytes with the same layout and
+	 * allocation, and moves the unread content of the buffer to its start. On
+	 * allocation failure, or if the unread content doesn't fit in
+	 * `newCapacity` bytes, the buffer is left unchanged.
+	 *
+	 * @param newCapacity The new capacity of the buffer.
+	 * @return `true` if the buffer was resized, and `false` otherwise.
+	 */
+	bool resize(std::size_t newCapacity);
 	/** @brief Discards the contents of the buffer by zeroing the R/W offsets. */
 	void reset() { mWriteOffset = mReadOffset = 0; }
 
 private:
 	/** @brief An owning pointer to the allocated memory block. */
-	std::unique_ptr<uint8_t[]> mBuffer;
+	std::unique_ptr<uint8_t[], BufferDeleter> mBuffer;
+	/** @brief The start of the buffer inside the memory block. Always equal
+	 * to `mBuffer.get()` for `LINEAR` buffers. */
+	uint8_t* mWindow;
 	/** @brief The size of the owned memory block. Is `0` for invalid buffers. */
 	std::size_t mBufferSize;
 	/** @brief The offset to the location of the next legal write. */
 	std::size_t mWriteOffset;
 	/** @brief The offset to the location of the current byte to read. */
 	std::size_t mReadOffset;
+	/** @brief The allocation of the memory block. */
+	BufferAllocation mAllocation;
 };
 
 } /*namespace impl*/
@@ -0,0 +1,237 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * BufferPool.cpp
+ *   A process-wide pool of idle channel buffers.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BufferPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Buffer.h"
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::size_t BufferPool::cDefaultLimit;
+
+namespace {
+
+/** @brief The state behind `BufferPool::shared()`. */
+struct SharedPool
+{
+	std::mutex mutex;
+	std::weak_ptr<BufferPool> pool;
+	std::size_t limit = BufferPool::cDefaultLimit;
+};
+
+SharedPool& sharedPool()
+{
+	static SharedPool shared;
+	return shared;
+}
+
+} /*namespace*/
+
+BufferPool::BufferPool()
+	: mPooledBytes(0)
+	, mLimit(cDefaultLimit)
+	, mNextReap(std::chrono::steady_clock::time_point::max())
+	, mStop(false)
+{
+}
+
+BufferPool::~BufferPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mChanged.notify_all();
+	if (mReaper.joinable()) {
+		mReaper.join();
+	}
+}
+
+std::shared_ptr<BufferPool> BufferPool::shared()
+{
+	SharedPool& shared = sharedPool();
+	std::lock_guard<std::mutex> lock(shared.mutex);
+	std::shared_ptr<BufferPool> pool = shared.pool.lock();
+	if (!pool) {
+		pool = std::make_shared<BufferPool>();
+		pool->setLimit(shared.limit);
+		shared.pool = pool;
+	}
+	return pool;
+}
+
+void BufferPool::setSharedLimit(const std::size_t limitBytes)
+{
+	SharedPool& shared = sharedPool();
+	std::lock_guard<std::mutex> lock(shared.mutex);
+	shared.limit = limitBytes;
+	if (std::shared_ptr<BufferPool> pool = shared.pool.lock()) {
+		pool->setLimit(limitBytes);
+	}
+}
+
+Buffer BufferPool::acquire(const std::size_t capacity,
+	const Buffer::Layout layout,
+	const BufferAllocation& allocation,
+	bool& oAllocated)
+{
+	oAllocated = false;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		const auto it = mFree.find(classOf(capacity, layout == Buffer::MIRRORED, allocation));
+		if (it != mFree.end() && !it->second.empty()) {
+			Buffer buffer = std::move(it->second.back());
+			it->second.pop_back();
+			mPooledBytes -= capacity;
+			return buffer;
+		}
+	}
+	oAllocated = true;
+	return Buffer(capacity, layout, allocation);
+}
+
+void BufferPool::release(Buffer&& buffer)
+{
+	std::vector<Buffer> dropped;
+	std::lock_guard<std::mutex> lock(mMutex);
+	keep(std::move(buffer), dropped);
+}
+
+void BufferPool::setLimit(const std::size_t limitBytes)
+{
+	std::vector<Buffer> dropped;
+	std::lock_guard<std::mutex> lock(mMutex);
+	mLimit = limitBytes;
+	// Larger buffers go first, being the likeliest to sit unused.
+	for (auto it = mFree.rbegin(); it != mFree.rend() && mPooledBytes > mLimit; ++it) {
+		while (!it->second.empty() && mPooledBytes > mLimit) {
+			mPooledBytes -= std::get<0>(it->first);
+			dropped.push_back(std::move(it->second.back()));
+			it->second.pop_back();
+		}
+	}
+}
+
+std::size_t BufferPool::pooledBytes() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mPooledBytes;
+}
+
+void BufferPool::watch(const std::shared_ptr<Parking>& parking)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	mWatched.erase(std::remove_if(mWatched.begin(),
+					   mWatched.end(),
+					   [](const std::weak_ptr<Parking>& watched) { return watched.expired(); }),
+		mWatched.end());
+	mWatched.push_back(parking);
+	if (!mReaper.joinable()) {
+		mReaper = std::thread(&BufferPool::reap, this);
+	}
+}
+
+void BufferPool::notifyParked(const std::chrono::steady_clock::time_point deadline)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (deadline >= mNextReap) {
+			return;
+		}
+		mNextReap = deadline;
+	}
+	mChanged.notify_all();
+}
+
+void BufferPool::keep(Buffer&& buffer, std::vector<Buffer>& oDropped)
+{
+	if (!buffer) {
+		return;
+	}
+	const std::size_t capacity = buffer.capacity();
+	if (mPooledBytes + capacity > mLimit) {
+		oDropped.push_back(std::move(buffer));
+		return;
+	}
+	buffer.reset();
+	mFree[classOf(capacity, buffer.mirrored(), buffer.allocation())].push_back(std::move(buffer));
+	mPooledBytes += capacity;
+}
+
+void BufferPool::reap()
+{
+	std::vector<Buffer> dropped;
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (!mStop) {
+		const auto now = std::chrono::steady_clock::now();
+		auto nextReap = std::chrono::steady_clock::time_point::max();
+		for (auto it = mWatched.begin(); it != mWatched.end();) {
+			const std::shared_ptr<Parking> parking = it->lock();
+			if (!parking) {
+				it = mWatched.erase(it);
+				continue;
+			}
+			++it;
+			// A channel holding its parking is taking the buffers back, or
+			// parking them and about to notify.
+			std::unique_lock<std::mutex> parked(parking->mutex, std::try_to_lock);
+			if (!parked.owns_lock() || (!parking->send && !parking->recv)) {
+				continue;
+			}
+			const auto deadline = parking->since + parking->delay;
+			if (deadline > now) {
+				nextReap = std::min(nextReap, deadline);
+				continue;
+			}
+			keep(std::move(parking->send), dropped);
+			keep(std::move(parking->recv), dropped);
+		}
+		mNextReap = nextReap;
+
+		if (!dropped.empty()) {
+			lock.unlock();
+			dropped.clear();
+			lock.lock();
+			continue;
+		}
+		if (mNextReap == std::chrono::steady_clock::time_point::max()) {
+			mChanged.wait(lock);
+		} else {
+			mChanged.wait_until(lock, mNextReap);
+		}
+	}
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,176 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * BufferPool.h
+ *   A process-wide pool of idle channel buffers.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_BUFFERPOOL_PH
+#define D_TSTORAGE_BUFFERPOOL_PH
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Buffer.h"
+
+/** @file
+ * @brief Defines the pool the channels return their idle buffers to. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief A pool of free buffers shared by the channels of a process, sorted
+ * into classes by capacity, layout and allocation.
+ *
+ * A channel set to release its buffers hands them to the pool once it is done
+ * with a command, and takes a buffer of its class back for the next one, so
+ * that the memory held by a fleet of mostly idle channels is bounded by what
+ * is in flight plus the pool's limit. Buffers which would take the pool past
+ * the limit are freed.
+ *
+ * A channel may also park its buffers instead, so that they go to the pool
+ * only once the channel has stayed idle for a given time. The parked buffers
+ * are collected by a background thread, started with the first channel
+ * registered with `watch()`.
+ *
+ * All methods are thread-safe.
+ */
+class BufferPool
+{
+public:
+	/** @brief The amount of bytes kept by default. */
+	static constexpr std::size_t cDefaultLimit = 256L * 1024 * 1024;  // 256 MiB
+
+	/** @brief The buffers of a channel, parked while it is idle. */
+	struct Parking
+	{
+		/** @brief Guards the other members. */
+		std::mutex mutex;
+		/** @brief The parked send buffer, if any. */
+		Buffer send;
+		/** @brief The parked receive buffer, if any. */
+		Buffer recv;
+		/** @brief The time the buffers were parked at. */
+		std::chrono::steady_clock::time_point since;
+		/** @brief The time after which the buffers go to the pool. */
+		std::chrono::milliseconds delay{};
+	};
+
+	/** @brief A constructor. No thread is started until `watch()`. */
+	BufferPool();
+	/** @brief A destructor. Stops the background thread and frees the pooled
+	 * buffers. */
+	~BufferPool();
+
+	BufferPool(const BufferPool&) = delete;
+	BufferPool(BufferPool&&) = delete;
+	BufferPool& operator=(const BufferPool&) = delete;
+	BufferPool& operator=(BufferPool&&) = delete;
+
+	/** @brief Returns the pool of the process. Channels hold on to it, so
+	 * that it outlives the last of them. */
+	static std::shared_ptr<BufferPool> shared();
+	/** @brief Sets the limit of the pool of the process, current and
+	 * future. */
+	static void setSharedLimit(std::size_t limitBytes);
+
+	/**
+	 * @brief Takes a pooled buffer of the given class, or allocates one.
+	 * @param capacity The capacity of the buffer.
+	 * @param layout The layout of the buffer.
+	 * @param allocation The allocation of the buffer, its NUMA node resolved
+	 * (see `resolveNode()`).
+	 * @param[out] oAllocated Set to `true` if the buffer was allocated rather
+	 * than taken from the pool.
+	 * @return The buffer, invalid if the allocation fails.
+	 */
+	Buffer acquire(std::size_t capacity,
+		Buffer::Layout layout,
+		const BufferAllocation& allocation,
+		bool& oAllocated);
+	/** @brief Returns a buffer to the pool, or frees it if the pool is full.
+	 * Invalid buffers are ignored. */
+	void release(Buffer&& buffer);
+	/** @brief Sets the amount of bytes the pool keeps, freeing the buffers
+	 * past it. */
+	void setLimit(std::size_t limitBytes);
+	/** @brief Returns the amount of bytes held by the pooled buffers. */
+	std::size_t pooledBytes() const;
+
+	/** @brief Registers the parking of a channel with the background thread,
+	 * starting the thread if needed. The pool keeps a weak reference. */
+	void watch(const std::shared_ptr<Parking>& parking);
+	/** @brief Tells the background thread that buffers were parked, to go
+	 * to the pool at `deadline`. */
+	void notifyParked(std::chrono::steady_clock::time_point deadline);
+
+private:
+	/** @brief A buffer class: its capacity, whether it is mirrored, its huge
+	 * pages and its NUMA node. */
+	using Class = std::tuple<std::size_t, bool, BufferAllocation::HugePages, std::int32_t>;
+
+	/** @brief Returns the class of the buffers allocated with the given
+	 * arguments. */
+	static Class classOf(
+		std::size_t capacity, bool mirrored, const BufferAllocation& allocation)
+	{
+		return Class(capacity, mirrored, allocation.hugePages, allocation.numaNode);
+	}
+
+	/** @brief Pools `buffer` if it fits under the limit, otherwise moves it
+	 * to `oDropped`, to be freed without `mMutex` held, which the call
+	 * requires. Invalid buffers are ignored. */
+	void keep(Buffer&& buffer, std::vector<Buffer>& oDropped);
+	/** @brief The loop of the background thread, moving the buffers parked
+	 * for longer than their delay to the pool. */
+	void reap();
+
+	/** @brief Guards the other members. */
+	mutable std::mutex mMutex;
+	/** @brief Signalled on parking and on destruction. */
+	std::condition_variable mChanged;
+	/** @brief The free buffers by class. */
+	std::map<Class, std::vector<Buffer>> mFree;
+	/** @brief The amount of bytes held by `mFree`. */
+	std::size_t mPooledBytes;
+	/** @brief The amount of bytes `mFree` may hold. */
+	std::size_t mLimit;
+	/** @brief The parkings of the channels. */
+	std::vector<std::weak_ptr<Parking>> mWatched;
+	/** @brief The time the background thread wakes up at next. */
+	std::chrono::steady_clock::time_point mNextReap;
+	/** @brief Set to stop the background thread. */
+	bool mStop;
+	/** @brief The background thread, started by the first `watch()`. */
+	std::thread mReaper;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
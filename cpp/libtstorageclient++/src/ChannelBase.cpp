@@ -21,15 +21,21 @@
 
 #include <tstorageclient++/ChannelBase.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <ratio>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <tstorageclient++/DataTypes.h>
 
+#include "BatchSerializer.h"
 #include "ChannelImpl.h"
 #include "Defines.h"
 
@@ -57,7 +63,8 @@ namespace impl {
  *
  * - While in PUT state, the channel can call `obtainPutPayloadBuffer()` or
  * `reservePutPayloadBuffer()` to reserve a buffer for payload serialization
- * purposes, `writeNextPutRecord()` to begin processing the next record, or
+ * purposes, `writeNextPutRecord()` to begin processing the next record,
+ * `flushPut()` to send the records written so far, or
  * `writeFin()` to end the PUT request at the last record that was written
  * to the channel. The last of these calls moves the channel into
  * PUT_RESPONSE state, in which it can call `readPutResult()` to receive
@@ -115,6 +122,71 @@ TSTORAGE_EXPORT void ChannelBase::abort()
 	mImpl->abort();
 }
 
+TSTORAGE_EXPORT void ChannelBase::interrupt()
+{
+	mImpl->interrupt();
+}
+
+namespace {
+
+/** @brief Returns the lower bound of the `part`-th of `parts` equal parts of
+ * `[min, min + span)`. */
+template<typename IntT>
+IntT splitPoint(const IntT min, const std::uint64_t span, const std::uint64_t parts,
+	const std::uint64_t part)
+{
+	const std::uint64_t step = span / parts;
+	const std::uint64_t rem = span % parts;
+	return static_cast<IntT>(
+		static_cast<std::uint64_t>(min) + step * part + std::min(part, rem));
+}
+
+} /*namespace*/
+
+TSTORAGE_EXPORT std::vector<KeyRange> ChannelBase::splitKeyRange(
+	const KeyRange& range, const std::size_t count)
+{
+	const std::uint64_t target = std::max<std::uint64_t>(count, 1);
+	const std::uint64_t cidSpan = static_cast<std::uint64_t>(
+		static_cast<std::int64_t>(range.keyMax.cid) - range.keyMin.cid);
+	const std::uint64_t capSpan = static_cast<std::uint64_t>(range.keyMax.cap)
+		- static_cast<std::uint64_t>(range.keyMin.cap);
+	const std::uint64_t cidParts = std::max<std::uint64_t>(std::min(target, cidSpan), 1);
+	const std::uint64_t capParts =
+		std::max<std::uint64_t>(std::min(target / cidParts, capSpan), 1);
+
+	std::vector<KeyRange> ranges;
+	ranges.reserve(cidParts * capParts);
+	for (std::uint64_t i = 0; i < cidParts; ++i) {
+		KeyRange cidRange = range;
+		cidRange.keyMin.cid = splitPoint(range.keyMin.cid, cidSpan, cidParts, i);
+		cidRange.keyMax.cid = splitPoint(range.keyMin.cid, cidSpan, cidParts, i + 1);
+		for (std::uint64_t j = 0; j < capParts; ++j) {
+			KeyRange subRange = cidRange;
+			subRange.keyMin.cap = splitPoint(range.keyMin.cap, capSpan, capParts, j);
+			subRange.keyMax.cap = splitPoint(range.keyMin.cap, capSpan, capParts, j + 1);
+			ranges.push_back(subRange);
+		}
+	}
+	return ranges;
+}
+
+TSTORAGE_EXPORT void ChannelBase::setRetryPolicyImpl(const RetryPolicy& policy)
+{
+	mImpl->setRetryPolicy(policy);
+}
+
+TSTORAGE_EXPORT bool ChannelBase::retryImpl(
+	const result_t status, std::uint32_t& ioAttempt, const bool put)
+{
+	return mImpl->prepareRetry(status, ioAttempt, put);
+}
+
+TSTORAGE_EXPORT bool ChannelBase::connectedImpl() const
+{
+	return mImpl->connected();
+}
+
 TSTORAGE_EXPORT result_t ChannelBase::writeGetRequest(
 	const Key& keyMin, const Key& keyMax)
 {
@@ -127,6 +199,23 @@ TSTORAGE_EXPORT result_t ChannelBase::writeGetAcqRequest(
 	return mImpl->writeGetAcqRequest(keyMin, keyMax);
 }
 
+TSTORAGE_EXPORT result_t ChannelBase::queueGetRequest(
+	const Key& keyMin, const Key& keyMax)
+{
+	return mImpl->queueGetRequest(keyMin, keyMax);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::queueGetAcqRequest(
+	const Key& keyMin, const Key& keyMax)
+{
+	return mImpl->queueGetAcqRequest(keyMin, keyMax);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::flushRequests()
+{
+	return mImpl->flushRequests();
+}
+
 TSTORAGE_EXPORT result_t ChannelBase::writePutHeader()
 {
 	return mImpl->writePutHeader();
@@ -173,11 +262,90 @@ TSTORAGE_EXPORT result_t ChannelBase::writeNextPutARecord(
 	return mImpl->writeNextPutARecord(key, payloadSize);
 }
 
+TSTORAGE_EXPORT result_t ChannelBase::writeNextPutRecordView(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+{
+	return mImpl->writeNextPutRecordView(key, payload, payloadSize);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::writeNextPutARecordView(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+{
+	return mImpl->writeNextPutARecordView(key, payload, payloadSize);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::writeNextPutRecordPieces(const Key& key,
+	const std::size_t payloadSize,
+	const std::function<void(void*, std::size_t, std::size_t)>& fillPayload)
+{
+	return mImpl->writeNextPutRecordPieces(key, payloadSize, fillPayload);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::writeNextPutARecordPieces(const Key& key,
+	const std::size_t payloadSize,
+	const std::function<void(void*, std::size_t, std::size_t)>& fillPayload)
+{
+	return mImpl->writeNextPutARecordPieces(key, payloadSize, fillPayload);
+}
+
 TSTORAGE_EXPORT result_t ChannelBase::writeFin()
 {
 	return mImpl->writeFin();
 }
 
+TSTORAGE_EXPORT result_t ChannelBase::flushPut()
+{
+	return mImpl->flushPut();
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::writeFileBatches(
+	const int fd, const std::uint64_t offset, const std::uint64_t length)
+{
+	return mImpl->writeFileBatches(fd, offset, length);
+}
+
+TSTORAGE_EXPORT void ChannelBase::preparePutChunks(const std::size_t count)
+{
+	mImpl->preparePutChunks(count);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::reservePutChunkPayloadBuffer(const std::size_t chunk,
+	void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	const std::size_t payloadSize,
+	const Key& key)
+{
+	return mImpl->reserveChunkPayloadBuffer<BatchSerializer::ProtoT::PUT>(
+		chunk, oPayloadBuffer, oBufferSize, payloadSize, key);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::reservePutAChunkPayloadBuffer(const std::size_t chunk,
+	void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	const std::size_t payloadSize,
+	const Key& key)
+{
+	return mImpl->reserveChunkPayloadBuffer<BatchSerializer::ProtoT::PUTA>(
+		chunk, oPayloadBuffer, oBufferSize, payloadSize, key);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::writeNextPutChunkRecord(
+	const std::size_t chunk, const Key& key, const std::size_t payloadSize)
+{
+	return mImpl->writeNextChunkRecord<BatchSerializer::ProtoT::PUT>(chunk, key, payloadSize);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::writeNextPutAChunkRecord(
+	const std::size_t chunk, const Key& key, const std::size_t payloadSize)
+{
+	return mImpl->writeNextChunkRecord<BatchSerializer::ProtoT::PUTA>(chunk, key, payloadSize);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::writePutChunks(const std::size_t count)
+{
+	return mImpl->writePutChunks(count);
+}
+
 TSTORAGE_EXPORT result_t ChannelBase::readResponse()
 {
 	return mImpl->readResponse();
@@ -199,6 +367,34 @@ TSTORAGE_EXPORT result_t ChannelBase::readNextRecordData(
 	return mImpl->readNextRecordData(oKey, oPayloadPtr, oPayloadSize);
 }
 
+TSTORAGE_EXPORT result_t ChannelBase::readNextRecordKey(
+	Key& oKey, std::size_t& oPayloadSize)
+{
+	return mImpl->readNextRecordKey(oKey, oPayloadSize);
+}
+
+TSTORAGE_EXPORT bool ChannelBase::nextRecordOversized() const
+{
+	return mImpl->nextRecordOversized();
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::readNextRecordHead(
+	Key& oKey, std::size_t& oPayloadSize)
+{
+	return mImpl->readNextRecordHead(oKey, oPayloadSize);
+}
+
+TSTORAGE_EXPORT result_t ChannelBase::readPayloadChunk(
+	const std::size_t amountBytes, const void*& oChunkPtr, std::size_t& oChunkSize)
+{
+	return mImpl->readPayloadChunk(amountBytes, oChunkPtr, oChunkSize);
+}
+
+TSTORAGE_EXPORT bool ChannelBase::waitNextRecordData(const std::uint32_t timeoutMs)
+{
+	return mImpl->waitNextRecordData(timeoutMs);
+}
+
 TSTORAGE_EXPORT result_t ChannelBase::readGetResult(Key::AcqT& oAcq)
 {
 	return mImpl->readGetResult(oAcq);
@@ -215,11 +411,200 @@ TSTORAGE_EXPORT void ChannelBase::setTimeoutImpl(
 	mImpl->setTimeoutMs(timeout.count());
 }
 
+TSTORAGE_EXPORT void ChannelBase::setDeadlineImpl(
+	const std::chrono::steady_clock::time_point deadline)
+{
+	mImpl->setDeadline(deadline);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setConnectTimeoutImpl(
+	const std::chrono::duration<std::int64_t, std::milli> timeout)
+{
+	const std::int64_t timeoutMs = std::max<std::int64_t>(
+		0, std::min<std::int64_t>(timeout.count(), std::numeric_limits<std::uint32_t>::max()));
+	mImpl->setConnectTimeoutMs(static_cast<std::uint32_t>(timeoutMs));
+}
+
 TSTORAGE_EXPORT void ChannelBase::setMemoryLimitImpl(const std::size_t memoryLimitBytes)
 {
 	mImpl->setMemoryLimit(memoryLimitBytes);
 }
 
+TSTORAGE_EXPORT void ChannelBase::setSendMemoryLimitImpl(const std::size_t memoryLimitBytes)
+{
+	mImpl->setSendMemoryLimit(memoryLimitBytes);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setReceiveMemoryLimitImpl(const std::size_t memoryLimitBytes)
+{
+	mImpl->setReceiveMemoryLimit(memoryLimitBytes);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setPutPipelineDepthImpl(const std::size_t depth)
+{
+	mImpl->setPutPipelineDepth(depth);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setPutBatchCoalescingImpl(const bool enabled)
+{
+	mImpl->setPutBatchCoalescing(enabled);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setPutKeysValidated(const bool validated)
+{
+	mImpl->setPutKeysValidated(validated);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setAddressCacheTtlImpl(
+	const std::chrono::duration<std::int64_t, std::milli> ttl)
+{
+	const std::int64_t ttlMs = std::max<std::int64_t>(
+		0, std::min<std::int64_t>(ttl.count(), std::numeric_limits<std::uint32_t>::max()));
+	mImpl->setAddressCacheTtlMs(static_cast<std::uint32_t>(ttlMs));
+}
+
+TSTORAGE_EXPORT void ChannelBase::setBusyPollImpl(
+	const std::chrono::duration<std::int64_t, std::micro> busyPoll)
+{
+	const std::int64_t busyPollUs = std::max<std::int64_t>(
+		0, std::min<std::int64_t>(busyPoll.count(), std::numeric_limits<std::uint32_t>::max()));
+	mImpl->setBusyPollUs(static_cast<std::uint32_t>(busyPollUs));
+}
+
+TSTORAGE_EXPORT void ChannelBase::setReceiveLowWatermarkImpl(const std::size_t limitBytes)
+{
+	mImpl->setReceiveLowWatermark(limitBytes);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setIoUringImpl(const bool enabled)
+{
+	mImpl->setIoUring(enabled);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setSignalRestartImpl(const bool enabled)
+{
+	mImpl->setSignalRestart(enabled);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setSocketOptionsImpl(const SocketOptions& options)
+{
+	mImpl->setSocketOptions(options);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setTlsOptionsImpl(const TlsOptions& options)
+{
+	mImpl->setTlsOptions(options);
+}
+
+TSTORAGE_EXPORT ReceiveStats ChannelBase::receiveStatsImpl() const
+{
+	return mImpl->receiveStats();
+}
+
+TSTORAGE_EXPORT ChannelStats ChannelBase::statsImpl() const
+{
+	return mImpl->stats();
+}
+
+TSTORAGE_EXPORT void ChannelBase::setTracerImpl(std::shared_ptr<Tracer> tracer)
+{
+	mImpl->setTracer(std::move(tracer));
+}
+
+TSTORAGE_EXPORT void ChannelBase::setDecodeThreadsImpl(const std::size_t threads)
+{
+	mImpl->setDecodeThreads(threads);
+}
+
+TSTORAGE_EXPORT std::size_t ChannelBase::decodeThreadsImpl() const
+{
+	return mImpl->decodeThreads();
+}
+
+TSTORAGE_EXPORT bool ChannelBase::predictGetRecords(
+	const Key& keyMin, const Key& keyMax, std::size_t& oRecords) const
+{
+	return mImpl->predictGetRecords(keyMin, keyMax, oRecords);
+}
+
+TSTORAGE_EXPORT void ChannelBase::countGetRecords(
+	const Key& keyMin, const Key& keyMax, const std::size_t records)
+{
+	mImpl->countGetRecords(keyMin, keyMax, records);
+}
+
+TSTORAGE_EXPORT void ChannelBase::submitDecodeTaskImpl(std::function<void()> task)
+{
+	mImpl->submitDecodeTask(std::move(task));
+}
+
+TSTORAGE_EXPORT void ChannelBase::waitDecodeTasksImpl()
+{
+	mImpl->waitDecodeTasks();
+}
+
+TSTORAGE_EXPORT void ChannelBase::setEncodeThreadsImpl(const std::size_t threads)
+{
+	mImpl->setEncodeThreads(threads);
+}
+
+TSTORAGE_EXPORT std::size_t ChannelBase::encodeThreadsImpl() const
+{
+	return mImpl->encodeThreads();
+}
+
+TSTORAGE_EXPORT void ChannelBase::submitEncodeTaskImpl(std::function<void()> task)
+{
+	mImpl->submitEncodeTask(std::move(task));
+}
+
+TSTORAGE_EXPORT void ChannelBase::waitEncodeTasksImpl()
+{
+	mImpl->waitEncodeTasks();
+}
+
+TSTORAGE_EXPORT void ChannelBase::setReceiveBufferGrowthImpl(
+	const std::size_t maxMemoryLimitBytes)
+{
+	mImpl->setReceiveBufferGrowth(maxMemoryLimitBytes);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setBufferAutoTuningImpl(const BufferAutoTuning& tuning)
+{
+	mImpl->setBufferAutoTuning(tuning);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setPutFlowControlImpl(const PutFlowControl& options)
+{
+	mImpl->setPutFlowControl(options);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setPutDedupFilterImpl(std::shared_ptr<PutDedupFilter> filter)
+{
+	mImpl->setPutDedupFilter(std::move(filter));
+}
+
+TSTORAGE_EXPORT void ChannelBase::setBufferReleaseImpl(
+	const std::chrono::duration<std::int64_t, std::milli> idle)
+{
+	mImpl->setBufferRelease(std::chrono::milliseconds(idle.count()));
+}
+
+TSTORAGE_EXPORT void ChannelBase::setBufferPoolLimitImpl(const std::size_t limitBytes)
+{
+	ChannelImpl::setBufferPoolLimit(limitBytes);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setBufferAllocationImpl(const BufferAllocation& allocation)
+{
+	mImpl->setBufferAllocation(allocation);
+}
+
+TSTORAGE_EXPORT void ChannelBase::setMemoryBudgetImpl(std::shared_ptr<MemoryBudget> budget)
+{
+	mImpl->setMemoryBudget(std::move(budget));
+}
+
 TSTORAGE_EXPORT void ChannelBase::setHost(const std::string& addr, const std::uint16_t port)
 {
 	mImpl->setHost(addr, port);
@@ -22,55 +22,630 @@
 #include "ChannelImpl.h"
 
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <tstorageclient++/DataTypes.h>
 
 #include "BatchSerializer.h"
 #include "Buffer.h"
+#include "BufferPool.h"
 #include "Headers.h"
+#include "PipelinedSender.h"
+#include "PutChunk.h"
 #include "Serializer.h"
 #include "Socket.h"
 
+#include <sys/uio.h>
+
 namespace tstorage {
 namespace impl {
 
 constexpr std::size_t ChannelImpl::cMinBufferSize;
+constexpr std::size_t ChannelImpl::cVectoredPayloadThreshold;
+constexpr std::size_t ChannelImpl::cDefaultPutPipelineDepth;
+constexpr std::size_t ChannelImpl::cMirroredBufferThreshold;
+constexpr RetryPolicy ChannelImpl::cDefaultRetryPolicy;
+constexpr bool ChannelImpl::cTracingBuilt;
 
 /**************
  * Setup
  */
 
+ChannelImpl::~ChannelImpl()
+{
+	refundBudget(mSendBuffer.capacity() + mRecvBuffer.capacity() + mSenderCharge);
+}
+
 result_t ChannelImpl::connect()
 {
-	mBuffer = Buffer(mMemoryLimit);
-	if (!mBuffer) {
-		return result_t::OUT_OF_MEMORY;
+	mSocket.releaseRecvBuffer();
+	mSendBuffer.reset();
+	mRecvBuffer.reset();
+	ConnectTrace trace{};
+	if (cTracingBuilt && mTracer) {
+		trace.wallStart = std::chrono::system_clock::now();
+		trace.start = std::chrono::steady_clock::now();
+	}
+	const result_t res = mSocket.connect();
+	if (res == result_t::OK) {
+		mReconnectable = true;
+		mTunedSocketBufferSize = 0;
+		// The work of the handshake and of aborted requests is charged to
+		// no request.
+		mCharged = currentCosts();
 	}
-	return mSocket.connect();
+	if (cTracingBuilt && mTracer) {
+		trace.end = std::chrono::steady_clock::now();
+		trace.status = res;
+		mTracer->onConnect(trace);
+	}
+	return res;
 }
 
 result_t ChannelImpl::close()
 {
-	if (mBuffer) {
-		mBuffer = Buffer{};
+	if (mSender) {
+		(void)mSender->drain();
+		dropSender();
 	}
+	dropBuffers();
+	mCoalesceBuffer = Buffer{};
+	mPutChunks.clear();
+	mRequestsQueued = false;
+	mReconnectable = false;
+	dropRequests();
 	return mSocket.close();
 }
 
-void ChannelImpl::setMemoryLimit(std::size_t memoryLimitBytes)
+void ChannelImpl::setRetryPolicy(const RetryPolicy& policy)
+{
+	mRetryPolicy = policy;
+	mRetryPolicy.maxAttempts = std::max<std::uint32_t>(policy.maxAttempts, 1);
+	mRetryPolicy.maxBackoffMs = std::max(policy.maxBackoffMs, policy.initialBackoffMs);
+}
+
+bool ChannelImpl::prepareRetry(
+	const result_t status, std::uint32_t& ioAttempt, const bool put)
+{
+	switch (status) {
+		case result_t::CONNERROR:
+		case result_t::CONNRESET:
+		case result_t::CONNCLOSED:
+		case result_t::CONNTIMEOUT:
+		case result_t::NOT_CONNECTED:
+			break;
+		default:
+			return false;
+	}
+	if (!mReconnectable || (put && !mRetryPolicy.retryPuts)) {
+		return false;
+	}
+
+	while (ioAttempt < mRetryPolicy.maxAttempts) {
+		// Doubled per attempt; the shift is bounded to keep it defined.
+		const std::uint32_t shift = std::min<std::uint32_t>(ioAttempt - 1, 31);
+		const std::uint64_t backoffMs = std::min<std::uint64_t>(
+			static_cast<std::uint64_t>(mRetryPolicy.initialBackoffMs) << shift,
+			mRetryPolicy.maxBackoffMs);
+		std::uniform_int_distribution<std::uint64_t> jitter(0, backoffMs / 2);
+		const std::chrono::milliseconds backoff(backoffMs - jitter(mRetryRng));
+		if (std::chrono::steady_clock::now() + backoff >= mSocket.deadline()) {
+			// The retry could not complete before the deadline.
+			return false;
+		}
+		std::this_thread::sleep_for(backoff);
+
+		++ioAttempt;
+		abort();
+		if (connect() == result_t::OK) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ChannelImpl::abort()
+{
+	if (mSender) {
+		// Unblock the sender thread if it's stuck inside `send()`.
+		(void)mSocket.shutdown(Socket::Shut::READWRITE);
+		dropSender();
+	}
+	mRequestsQueued = false;
+	dropRequests();
+	mSocket.abort();
+}
+
+void ChannelImpl::setPutPipelineDepth(const std::size_t depth)
+{
+	mPutPipelineDepth = std::max(depth, cDefaultPutPipelineDepth);
+	if (mSender && mSender->depth() != mPutPipelineDepth) {
+		(void)mSender->drain();
+		dropSender();
+	}
+}
+
+void ChannelImpl::setPutBatchCoalescing(const bool enabled)
+{
+	mCoalescePutBatches = enabled;
+	if (!enabled) {
+		mCoalesceBuffer = Buffer{};
+	}
+}
+
+void ChannelImpl::setSendMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	mSendMemoryFloor = std::max(memoryLimitBytes, cMinBufferSize);
+	applySendMemoryLimit();
+}
+
+void ChannelImpl::setReceiveMemoryLimit(const std::size_t memoryLimitBytes)
+{
+	mRecvMemoryFloor = std::max(memoryLimitBytes, cMinBufferSize);
+	applyRecvMemoryLimit();
+}
+
+void ChannelImpl::applySendMemoryLimit()
+{
+	mSendMemoryLimit = std::max(mSendMemoryFloor, mTunedBufferSize);
+	dropParkedBuffers();
+	if (mSendBuffer && mSendBuffer.capacity() != mSendMemoryLimit) {
+		dropBuffer(mSendBuffer);
+	}
+}
+
+void ChannelImpl::applyRecvMemoryLimit()
+{
+	mRecvMemoryLimit = std::max(mRecvMemoryFloor, mTunedBufferSize);
+	dropParkedBuffers();
+	if (mRecvBuffer && mRecvBuffer.capacity() != mRecvMemoryLimit) {
+		mSocket.releaseRecvBuffer();
+		dropBuffer(mRecvBuffer);
+	}
+}
+
+void ChannelImpl::setBufferAutoTuning(const BufferAutoTuning& tuning)
+{
+	mAutoTuning = tuning;
+	if (tuning.enabled) {
+		return;
+	}
+	mBandwidth.reset();
+	mBdpBytes.store(0, std::memory_order_relaxed);
+	if (mTunedBufferSize != 0) {
+		mTunedBufferSize = 0;
+		applySendMemoryLimit();
+		applyRecvMemoryLimit();
+	}
+}
+
+void ChannelImpl::setPutFlowControl(const PutFlowControl& options)
+{
+	mFlow.configure(options);
+	publishFlowStats();
+}
+
+void ChannelImpl::setBufferAllocation(const BufferAllocation& allocation)
+{
+	mBufferAllocation = allocation;
+	dropBuffers();
+}
+
+void ChannelImpl::setMemoryBudget(std::shared_ptr<MemoryBudget> budget)
 {
-	mMemoryLimit = std::max(memoryLimitBytes, cMinBufferSize);
-	if (mBuffer && mBuffer.capacity() != memoryLimitBytes) {
-		mBuffer = Buffer(mMemoryLimit);
+	if (mSender) {
+		(void)mSender->drain();
+		dropSender();
+	}
+	dropBuffers();
+	mBudget = std::move(budget);
+}
+
+void ChannelImpl::setBufferRelease(const std::chrono::milliseconds idle)
+{
+	// Buffers parked already go to the pool on their deadline.
+	mBufferRelease = idle;
+	if (idle.count() <= 0) {
+		return;
+	}
+	if (!mParking) {
+		mParking = std::make_shared<BufferPool::Parking>();
+		mBufferPool->watch(mParking);
+	}
+	std::lock_guard<std::mutex> lock(mParking->mutex);
+	mParking->delay = idle;
+}
+
+void ChannelImpl::setDecodeThreads(const std::size_t threads)
+{
+	if (threads == decodeThreads()) {
+		return;
+	}
+	mDecodePool.reset();
+	if (threads > 0) {
+		mDecodePool = std::make_unique<WorkerPool>(threads);
+	}
+}
+
+void ChannelImpl::setEncodeThreads(const std::size_t threads)
+{
+	if (threads == encodeThreads()) {
+		return;
+	}
+	mEncodePool.reset();
+	if (threads > 0) {
+		mEncodePool = std::make_unique<WorkerPool>(threads);
 	}
 }
 
 void ChannelImpl::resetState()
 {
-	mBuffer.reset();
-	mBatch = BatchSerializer(mBuffer);
+	mSendBuffer.reset();
+	mSocket.resetStats();
+	mBatch = BatchSerializer(mSendBuffer);
+	mPutBatchesOffset = 0;
+}
+
+void ChannelImpl::resetRecvBuffer()
+{
+	dropFramedRecords();
+	mRecvBuffer.reset();
+	shrinkBuffer();
+}
+
+Buffer ChannelImpl::acquireBuffer(const std::size_t capacity)
+{
+	bool allocated = false;
+	Buffer buffer = mBufferPool->acquire(capacity,
+		capacity >= cMirroredBufferThreshold ? Buffer::MIRRORED : Buffer::LINEAR,
+		resolveNode(mBufferAllocation),
+		allocated);
+	if (allocated && buffer) {
+		countAllocation(capacity);
+	}
+	return buffer;
+}
+
+bool ChannelImpl::obtainBuffer(
+	Buffer& oBuffer, Buffer BufferPool::Parking::*const parked, const std::size_t capacity)
+{
+	if (!chargeBudget(capacity)) {
+		return false;
+	}
+	if (mParking) {
+		std::lock_guard<std::mutex> lock(mParking->mutex);
+		oBuffer = std::move((*mParking).*parked);
+	}
+	if (oBuffer && oBuffer.capacity() != capacity) {
+		mBufferPool->release(std::move(oBuffer));
+		oBuffer = Buffer{};
+	}
+	if (!oBuffer) {
+		oBuffer = acquireBuffer(capacity);
+	}
+	if (!oBuffer) {
+		refundBudget(capacity);
+		return false;
+	}
+	return true;
+}
+
+void ChannelImpl::dropBuffer(Buffer& buffer)
+{
+	refundBudget(buffer.capacity());
+	if (mBufferRelease.count() >= 0) {
+		mBufferPool->release(std::move(buffer));
+	}
+	buffer = Buffer{};
+}
+
+void ChannelImpl::dropBuffers()
+{
+	dropParkedBuffers();
+	if (mRecvBuffer) {
+		mSocket.releaseRecvBuffer();
+		dropBuffer(mRecvBuffer);
+	}
+	dropBuffer(mSendBuffer);
+}
+
+void ChannelImpl::dropParkedBuffers()
+{
+	if (!mParking) {
+		return;
+	}
+	Buffer send;
+	Buffer recv;
+	{
+		std::lock_guard<std::mutex> lock(mParking->mutex);
+		send = std::move(mParking->send);
+		recv = std::move(mParking->recv);
+	}
+	if (mBufferRelease.count() >= 0) {
+		mBufferPool->release(std::move(send));
+		mBufferPool->release(std::move(recv));
+	}
+}
+
+void ChannelImpl::dropSender()
+{
+	mSender.reset();
+	refundBudget(mSenderCharge);
+	mSenderCharge = 0;
+}
+
+bool ChannelImpl::chargeBudget(const std::size_t bytes)
+{
+	if (!mBudget || bytes == 0 || mBudget->tryAcquire(bytes)) {
+		return true;
+	}
+	return mBudget->acquire(bytes, std::chrono::milliseconds(mSocket.remainingMs()));
+}
+
+void ChannelImpl::refundBudget(const std::size_t bytes)
+{
+	if (mBudget && bytes != 0) {
+		mBudget->release(bytes);
+	}
+}
+
+result_t ChannelImpl::endCommand(const result_t status)
+{
+	if (mPendingHead != mPending.size() || mRequestsQueued
+		|| mRecvBuffer.bytesAvailableToRead() != 0) {
+		return status;
+	}
+	if (mAutoTuning.enabled) {
+		tuneBuffers();
+	}
+	if (mBufferRelease.count() < 0) {
+		return status;
+	}
+	if (mRecvBuffer) {
+		mSocket.releaseRecvBuffer();
+	}
+	refundBudget(mSendBuffer.capacity() + mRecvBuffer.capacity());
+	if (mBufferRelease.count() == 0) {
+		mBufferPool->release(std::move(mSendBuffer));
+		mBufferPool->release(std::move(mRecvBuffer));
+		return status;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	{
+		std::lock_guard<std::mutex> lock(mParking->mutex);
+		// A buffer the command didn't use may be parked still.
+		if (mSendBuffer) {
+			mParking->send = std::move(mSendBuffer);
+		}
+		if (mRecvBuffer) {
+			mParking->recv = std::move(mRecvBuffer);
+		}
+		mParking->since = now;
+	}
+	mBufferPool->notifyParked(now + mBufferRelease);
+	return status;
+}
+
+void ChannelImpl::tuneBuffers()
+{
+	std::uint32_t rttUs = 0;
+	if (!mSocket.rttUs(rttUs)) {
+		return;
+	}
+	mBandwidth.finish(std::chrono::steady_clock::now(), mSocket.bytesTransferred(), rttUs);
+	const std::size_t bdpBytes = mBandwidth.bdpBytes();
+	mBdpBytes.store(bdpBytes, std::memory_order_relaxed);
+	if (bdpBytes == 0) {
+		return;
+	}
+
+	std::size_t size = cMinBufferSize;
+	while (size < 2 * bdpBytes && size < mAutoTuning.maxBytes) {
+		size *= 2;
+	}
+	size = std::min(size, mAutoTuning.maxBytes);
+	if (size > mTunedBufferSize || size * 4 <= mTunedBufferSize) {
+		mTunedBufferSize = size;
+		applySendMemoryLimit();
+		applyRecvMemoryLimit();
+	}
+	if (mAutoTuning.socketBuffers && mTunedSocketBufferSize != mTunedBufferSize
+		&& mSocket.setBufferSizes(mTunedBufferSize, mTunedBufferSize) == result_t::OK) {
+		mTunedSocketBufferSize = mTunedBufferSize;
+	}
+}
+
+bool ChannelImpl::growBuffer(const std::size_t amountBytes)
+{
+	if (!mRecvBuffer || amountBytes > mMaxMemoryLimit) {
+		return false;
+	}
+	std::size_t capacity = mRecvBuffer.capacity();
+	while (capacity < amountBytes) {
+		capacity *= 2;
+	}
+	capacity = std::min(capacity, mMaxMemoryLimit);
+	if (capacity == mRecvBuffer.capacity()) {
+		return reserveBuffer(amountBytes - mRecvBuffer.bytesAvailableToRead());
+	}
+	// Under pressure, the quota is left to the buffers of other requests.
+	const std::size_t extra = capacity - mRecvBuffer.capacity();
+	if (mBudget && (mBudget->underPressure() || !mBudget->tryAcquire(extra))) {
+		return false;
+	}
+	mSocket.releaseRecvBuffer();
+	if (!mRecvBuffer.resize(capacity)) {
+		refundBudget(extra);
+		return false;
+	}
+	countAllocation(capacity);
+	return true;
+}
+
+void ChannelImpl::shrinkBuffer()
+{
+	const std::size_t capacity = mRecvBuffer.capacity();
+	if (capacity > mRecvMemoryLimit) {
+		// On allocation failure the grown buffer is kept.
+		mSocket.releaseRecvBuffer();
+		if (mRecvBuffer.resize(mRecvMemoryLimit)) {
+			refundBudget(capacity - mRecvMemoryLimit);
+			countAllocation(mRecvMemoryLimit);
+		}
+	}
+}
+
+void ChannelImpl::endPutBatches()
+{
+	mBatch.endBatch();
+	if (!mCoalescePutBatches) {
+		return;
+	}
+	if (mCoalesceBuffer.capacity() != mSendBuffer.capacity()) {
+		mCoalesceBuffer = Buffer(mSendBuffer.capacity());
+		if (mCoalesceBuffer) {
+			countAllocation(mCoalesceBuffer.capacity());
+		}
+	}
+	// Without the scratch buffer the batches are simply sent as they are.
+	if (mCoalesceBuffer
+		&& BatchSerializer::coalesce(
+			mSendBuffer, mPutBatchesOffset, mCoalesceBuffer, mBatchSpans)) {
+		std::swap(mSendBuffer, mCoalesceBuffer);
+		mBatch = BatchSerializer(mSendBuffer);
+	}
+}
+
+ChannelStats ChannelImpl::stats() const
+{
+	ChannelStats stats{};
+	mSocket.trafficStats(stats);
+	stats.putBatches = mPutBatches.value();
+	stats.putBufferFlushes = mPutBufferFlushes.value();
+	stats.bufferBytesMoved = mBufferBytesMoved.value();
+	stats.bdpBytes = mBdpBytes.load(std::memory_order_relaxed);
+	stats.putPacingRate = mPutPacingRate.load(std::memory_order_relaxed);
+	stats.putCommandBuffers = mPutCommandBufferLimit.load(std::memory_order_relaxed);
+	stats.putBackoffs = mPutBackoffs.load(std::memory_order_relaxed);
+	stats.putRecordsSkipped = mPutRecordsSkipped.value();
+	stats.bufferAllocations = mBufferAllocations.value();
+	stats.bufferBytesAllocated = mBufferBytesAllocated.value();
+	mGetLatency.snapshot(stats.get);
+	mGetAcqLatency.snapshot(stats.getAcq);
+	mPutLatency.snapshot(stats.put);
+	mPutALatency.snapshot(stats.putA);
+	mGetCosts.snapshot(stats.getCosts);
+	mGetAcqCosts.snapshot(stats.getAcqCosts);
+	mPutCosts.snapshot(stats.putCosts);
+	mPutACosts.snapshot(stats.putACosts);
+	return stats;
+}
+
+CommandCosts ChannelImpl::currentCosts() const
+{
+	ChannelStats traffic{};
+	mSocket.trafficStats(traffic);
+	CommandCosts costs{};
+	costs.sendCalls = traffic.sendCalls;
+	costs.recvCalls = traffic.recvCalls;
+	costs.bufferAllocations = mBufferAllocations.value();
+	costs.bufferBytesAllocated = mBufferBytesAllocated.value();
+	return costs;
+}
+
+void ChannelImpl::finishRequest(const result_t status)
+{
+	if (mPendingHead == mPending.size()) {
+		return;
+	}
+	if (tracing()) {
+		mTraceActive = false;
+		mTrace.end = std::chrono::steady_clock::now();
+		mTrace.status = status;
+		if (mTrace.firstByte == std::chrono::steady_clock::time_point{}) {
+			mTrace.firstByte = mTrace.end;
+		}
+		if (mTrace.recordsDone == std::chrono::steady_clock::time_point{}) {
+			mTrace.recordsDone = mTrace.firstByte;
+		}
+		ChannelStats traffic{};
+		mSocket.trafficStats(traffic);
+		mTrace.bytesSent = traffic.bytesSent - mTrace.bytesSent;
+		mTrace.bytesReceived = traffic.bytesReceived - mTrace.bytesReceived;
+		mTracer->onRequest(mTrace);
+	}
+	const PendingRequest& request = mPending[mPendingHead];
+	const std::uint64_t latencyUs = static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - request.start)
+			.count());
+	TSTORAGE_PROBE3(command__finish, request.cmdId, static_cast<int>(status), latencyUs);
+	const CommandCosts now = currentCosts();
+	CommandCosts costs{};
+	costs.sendCalls = now.sendCalls - mCharged.sendCalls;
+	costs.recvCalls = now.recvCalls - mCharged.recvCalls;
+	costs.bufferAllocations = now.bufferAllocations - mCharged.bufferAllocations;
+	costs.bufferBytesAllocated = now.bufferBytesAllocated - mCharged.bufferBytesAllocated;
+	mCharged = now;
+	switch (request.cmdId) {
+		case CommandType::GET:
+			mGetLatency.record(latencyUs);
+			mGetCosts.record(costs);
+			break;
+		case CommandType::GETACQ:
+			mGetAcqLatency.record(latencyUs);
+			mGetAcqCosts.record(costs);
+			break;
+		case CommandType::PUT:
+			mPutLatency.record(latencyUs);
+			mPutCosts.record(costs);
+			break;
+		case CommandType::PUTA:
+			mPutALatency.record(latencyUs);
+			mPutACosts.record(costs);
+			break;
+	}
+	if (++mPendingHead == mPending.size()) {
+		dropRequests();
+	}
+}
+
+void ChannelImpl::startTrace(const CommandType cmdId)
+{
+	if (!cTracingBuilt || !mTracer) {
+		return;
+	}
+	ChannelStats traffic{};
+	mSocket.trafficStats(traffic);
+	mTrace = RequestTrace{};
+	mTrace.command = static_cast<TraceCommand>(cmdId);
+	mTrace.wallStart = std::chrono::system_clock::now();
+	mTrace.start = std::chrono::steady_clock::now();
+	mTrace.bytesSent = traffic.bytesSent;
+	mTrace.bytesReceived = traffic.bytesReceived;
+	mTraceActive = true;
+}
+
+void ChannelImpl::traceRecv(const std::chrono::steady_clock::time_point recvStart)
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (mTrace.firstByte == std::chrono::steady_clock::time_point{}) {
+		mTrace.firstByte = now;
+	} else if (mTrace.recordsDone == std::chrono::steady_clock::time_point{}) {
+		mTrace.recordsRecvWait += now - recvStart;
+	}
 }
 
 /**************
@@ -83,18 +658,65 @@ result_t ChannelImpl::writeKeyPairHeader(
 	if (!mSocket.connectionEstablished()) {
 		return result_t::NOT_CONNECTED;
 	}
-	if (!mBuffer) {
+	if (!ensureSendBuffer()) {
 		return result_t::OUT_OF_MEMORY;
 	}
-	if (!(keyMin <= keyMax - 1)) {
-		return result_t::EMPTY_KEY_RANGE;
-	}
-	if (!keyMin.isValid()) {
-		return result_t::INVALID_KEY;
+	const result_t resCheck = checkKeyRange(keyMin, keyMax);
+	if (resCheck != result_t::OK) {
+		return resCheck;
 	}
 	resetState();
+	resetRecvBuffer();
 	const HeaderKeyRange header{cmdId, 2 * Serializer::cKeySize, keyMin, keyMax};
-	Serializer(mBuffer).putHeaderKeyRange(header);
+	Serializer(mSendBuffer).putHeaderKeyRange(header);
+	dropRequests();
+	startRequest(cmdId);
+	startTrace(cmdId);
+	const result_t res = sendBuffer();
+	if (res == result_t::OK) {
+		traceSent();
+	}
+	return res;
+}
+
+result_t ChannelImpl::queueKeyPairHeader(
+	const CommandType cmdId, const Key& keyMin, const Key& keyMax)
+{
+	if (!mSocket.connectionEstablished()) {
+		return result_t::NOT_CONNECTED;
+	}
+	if (!ensureSendBuffer()) {
+		return result_t::OUT_OF_MEMORY;
+	}
+	const result_t resCheck = checkKeyRange(keyMin, keyMax);
+	if (resCheck != result_t::OK) {
+		return resCheck;
+	}
+	if (!mRequestsQueued) {
+		resetState();
+		resetRecvBuffer();
+		dropRequests();
+		mRequestsQueued = true;
+	}
+	constexpr std::size_t cRequestSize = Serializer::cHeaderSize + 2 * Serializer::cKeySize;
+	if (mSendBuffer.bytesOfFreeSpace() < cRequestSize) {
+		const result_t resSend = sendBuffer();
+		if (resSend != result_t::OK) {
+			return resSend;
+		}
+	}
+	const HeaderKeyRange header{cmdId, 2 * Serializer::cKeySize, keyMin, keyMax};
+	Serializer(mSendBuffer).putHeaderKeyRange(header);
+	startRequest(cmdId);
+	return result_t::OK;
+}
+
+result_t ChannelImpl::flushRequests()
+{
+	if (!mRequestsQueued) {
+		return result_t::OK;
+	}
+	mRequestsQueued = false;
 	return sendBuffer();
 }
 
@@ -103,12 +725,16 @@ result_t ChannelImpl::writeEmptyHeader(const CommandType cmdId)
 	if (!mSocket.connectionEstablished()) {
 		return result_t::NOT_CONNECTED;
 	}
-	if (!mBuffer) {
+	if (!ensureSendBuffer()) {
 		return result_t::OUT_OF_MEMORY;
 	}
 	resetState();
+	resetRecvBuffer();
 	const Header header{cmdId, 0};
-	Serializer(mBuffer).putHeader(header);
+	Serializer(mSendBuffer).putHeader(header);
+	dropRequests();
+	startRequest(cmdId);
+	startTrace(cmdId);
 	return result_t::OK;
 }
 
@@ -118,24 +744,29 @@ result_t ChannelImpl::reservePayloadBuffer(void*& oPayloadBuffer,
 	const Key& key,
 	const std::size_t keySize)
 {
-	mExpectedPayloadSize = std::max(payloadSize, mExpectedPayloadSize);
 	oPayloadBuffer = nullptr;
 	oBufferSize = 0;
 
 	std::size_t recordOffset = mBatch.getNextRecordOffset(key.cid);
 	const std::size_t payloadOffset = keySize + sizeof(std::int32_t);
 
-	if (recordOffset + payloadOffset + payloadSize > mBuffer.bytesOfFreeSpace()) {
-		if (mBuffer.writeOffset() == 0) {
+	if (recordOffset + payloadOffset + payloadSize > mSendBuffer.bytesOfFreeSpace()) {
+		if (mSendBuffer.writeOffset() == 0) {
 			return result_t::MEMORY_LIMIT_EXCEEDED;
 		}
 
-		mBatch.endBatch();
-		const result_t resFlush = sendBuffer();
+		mPutBufferFlushes.add(1);
+		result_t resFlush{};
+		if (mFlow.splitDue(mPutCommandBuffers + 1)) {
+			resFlush = splitPutCommand();
+		} else {
+			endPutBatches();
+			resFlush = flushPutBuffer();
+		}
 		if (resFlush != result_t::OK) {
 			return resFlush;
 		}
-		if (recordOffset + payloadOffset + payloadSize > mBuffer.bytesOfFreeSpace()) {
+		if (recordOffset + payloadOffset + payloadSize > mSendBuffer.bytesOfFreeSpace()) {
 			return result_t::MEMORY_LIMIT_EXCEEDED;
 		}
 
@@ -143,49 +774,400 @@ result_t ChannelImpl::reservePayloadBuffer(void*& oPayloadBuffer,
 	}
 
 	const std::size_t totalOffset = recordOffset + payloadOffset;
-	oPayloadBuffer = mBuffer.writeData(totalOffset);
-	oBufferSize = mBuffer.bytesOfFreeSpace() - totalOffset;
+	oPayloadBuffer = mSendBuffer.writeData(totalOffset);
+	oBufferSize = mSendBuffer.bytesOfFreeSpace() - totalOffset;
+	mReservedPayload = oPayloadBuffer;
 	return result_t::OK;
 }
 
 result_t ChannelImpl::writeNextPutRecord(const Key& key, const std::size_t payloadSize)
 {
-	if (payloadSize > cMaxPayloadSize) {
-		return result_t::PAYLOAD_TOO_LARGE;
-	}
-	Key maxKey = cKeyMax - 1;
-	maxKey.acq = cKeyMax.acq;
-	if (!key.isValid() || !(key <= maxKey)) {
-		return result_t::INVALID_KEY;
+	const result_t res = checkNextPutRecord<BatchSerializer::ProtoT::PUT>(key, payloadSize);
+	if (res != result_t::OK) {
+		return res;
 	}
+	countPutBatch(key);
 	mBatch.putRecord<BatchSerializer::ProtoT::PUT>(key, payloadSize);
+	mPayloadSizes.record(payloadSize);
 	return result_t::OK;
 }
 
 result_t ChannelImpl::writeNextPutARecord(const Key& key, const std::size_t payloadSize)
+{
+	const result_t res = checkNextPutRecord<BatchSerializer::ProtoT::PUTA>(key, payloadSize);
+	if (res != result_t::OK) {
+		return res;
+	}
+	// A skipped record leaves the reserved block to the next one.
+	if (skipsAcknowledged(key, mReservedPayload, payloadSize)) {
+		return result_t::OK;
+	}
+	countPutBatch(key);
+	mBatch.putRecord<BatchSerializer::ProtoT::PUTA>(key, payloadSize);
+	mPayloadSizes.record(payloadSize);
+	return result_t::OK;
+}
+
+result_t ChannelImpl::writeNextPutRecordView(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+{
+	return writeRecordView<BatchSerializer::ProtoT::PUT>(key, payload, payloadSize);
+}
+
+result_t ChannelImpl::writeNextPutARecordView(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+{
+	return writeRecordView<BatchSerializer::ProtoT::PUTA>(key, payload, payloadSize);
+}
+
+result_t ChannelImpl::writeNextPutRecordPieces(const Key& key,
+	const std::size_t payloadSize,
+	const std::function<void(void*, std::size_t, std::size_t)>& fillPayload)
+{
+	return writeRecordPieces<BatchSerializer::ProtoT::PUT>(key, payloadSize, fillPayload);
+}
+
+result_t ChannelImpl::writeNextPutARecordPieces(const Key& key,
+	const std::size_t payloadSize,
+	const std::function<void(void*, std::size_t, std::size_t)>& fillPayload)
+{
+	return writeRecordPieces<BatchSerializer::ProtoT::PUTA>(key, payloadSize, fillPayload);
+}
+
+template<BatchSerializer::ProtoT PutProtocol>
+result_t ChannelImpl::writeRecordView(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+{
+	constexpr bool cIsPut = PutProtocol == BatchSerializer::ProtoT::PUT;
+	constexpr std::size_t cKeySize =
+		cIsPut ? Serializer::cAbbrevKeySizeWithoutAcq : Serializer::cAbbrevKeySize;
+
+	void* buffer{};
+	std::size_t bufferSize{};
+	if (payloadSize < cVectoredPayloadThreshold) {
+		const result_t resReserve =
+			reservePayloadBuffer(buffer, bufferSize, payloadSize, key, cKeySize);
+		if (resReserve != result_t::OK) {
+			return resReserve;
+		}
+		std::memcpy(buffer, payload, payloadSize);
+		return cIsPut ? writeNextPutRecord(key, payloadSize)
+					  : writeNextPutARecord(key, payloadSize);
+	}
+
+	const result_t resCheck = checkNextPutRecord<PutProtocol>(key, payloadSize);
+	if (resCheck != result_t::OK) {
+		return resCheck;
+	}
+	if (mCoalescePutBatches) {
+		// The record goes last, in a batch of its own, as its payload follows
+		// the buffer.
+		endPutBatches();
+	}
+	const result_t resReserve = reservePayloadBuffer(buffer, bufferSize, 0, key, cKeySize);
+	if (resReserve != result_t::OK) {
+		return resReserve;
+	}
+	// Only now, as the reservation may have ended the command and stored the
+	// fingerprints it acknowledged.
+	if (!cIsPut && skipsAcknowledged(key, payload, payloadSize)) {
+		return result_t::OK;
+	}
+	countPutBatch(key);
+	mBatch.putRecordHeader<PutProtocol>(key, payloadSize);
+	mBatch.endBatch();
+	const std::size_t bytes = mSendBuffer.bytesAvailableToRead() + payloadSize;
+	const auto start = pacePutSend(bytes);
+	return countPutSend(start, bytes, sendBufferWith(payload, payloadSize));
+}
+
+template<BatchSerializer::ProtoT PutProtocol>
+result_t ChannelImpl::writeRecordPieces(const Key& key,
+	const std::size_t payloadSize,
+	const std::function<void(void*, std::size_t, std::size_t)>& fillPayload)
+{
+	constexpr bool cIsPut = PutProtocol == BatchSerializer::ProtoT::PUT;
+	constexpr std::size_t cKeySize =
+		cIsPut ? Serializer::cAbbrevKeySizeWithoutAcq : Serializer::cAbbrevKeySize;
+
+	const result_t resCheck = checkNextPutRecord<PutProtocol>(key, payloadSize);
+	if (resCheck != result_t::OK) {
+		return resCheck;
+	}
+	if (mCoalescePutBatches) {
+		// The record goes last, in a batch of its own, as its payload follows
+		// the buffer.
+		endPutBatches();
+	}
+	void* buffer{};
+	std::size_t bufferSize{};
+	const result_t resReserve = reservePayloadBuffer(buffer, bufferSize, 0, key, cKeySize);
+	if (resReserve != result_t::OK) {
+		return resReserve;
+	}
+	countPutBatch(key);
+	mBatch.putRecordHeader<PutProtocol>(key, payloadSize);
+	mBatch.endBatch();
+	const std::size_t bytes = mSendBuffer.bytesAvailableToRead() + payloadSize;
+	const auto start = pacePutSend(bytes);
+
+	// Each piece fills the buffer emptied by sending the previous one.
+	result_t res = sendBuffer();
+	std::size_t offset = 0;
+	while (res == result_t::OK && offset < payloadSize) {
+		const std::size_t piece = std::min(payloadSize - offset, mSendBuffer.bytesOfFreeSpace());
+		fillPayload(mSendBuffer.writeData(), offset, piece);
+		mSendBuffer.writeAdvance(piece);
+		offset += piece;
+		res = sendBuffer();
+	}
+	return countPutSend(start, bytes, res);
+}
+
+template<BatchSerializer::ProtoT PutProtocol>
+result_t ChannelImpl::checkPutRecord(const Key& key, const std::size_t payloadSize)
 {
 	if (payloadSize > cMaxPayloadSize) {
 		return result_t::PAYLOAD_TOO_LARGE;
 	}
-	if (!key.isValid() || !(key <= cKeyMax - 1)) {
+	if (!key.isStorable(PutProtocol == BatchSerializer::ProtoT::PUTA)) {
 		return result_t::INVALID_KEY;
 	}
-	mBatch.putRecord<BatchSerializer::ProtoT::PUTA>(key, payloadSize);
+	return result_t::OK;
+}
+
+template result_t ChannelImpl::checkPutRecord<BatchSerializer::ProtoT::PUT>(
+	const Key& key, std::size_t payloadSize);
+template result_t ChannelImpl::checkPutRecord<BatchSerializer::ProtoT::PUTA>(
+	const Key& key, std::size_t payloadSize);
+
+result_t ChannelImpl::checkKeyRange(const Key& keyMin, const Key& keyMax)
+{
+	if (!(keyMin <= keyMax - 1)) {
+		return result_t::EMPTY_KEY_RANGE;
+	}
+	if (!keyMin.isValid()) {
+		return result_t::INVALID_KEY;
+	}
+	return result_t::OK;
+}
+
+result_t ChannelImpl::flushPut()
+{
+	if (mSendBuffer.bytesAvailableToRead() == 0) {
+		return result_t::OK;
+	}
+	endPutBatches();
+	return flushPutBuffer();
+}
+
+result_t ChannelImpl::writeFileBatches(
+	const int fd, const std::uint64_t offset, const std::uint64_t length)
+{
+	// The buffer holds the header alone.
+	const result_t resHeader = sendBuffer();
+	if (resHeader != result_t::OK) {
+		return resHeader;
+	}
+	std::uint64_t amountSent = 0;
+	return mSocket.sendFile(fd, offset, length, amountSent);
+}
+
+void ChannelImpl::preparePutChunks(const std::size_t count)
+{
+	while (mPutChunks.size() < count) {
+		mPutChunks.push_back(std::make_unique<PutChunk>());
+	}
+	for (std::size_t i = 0; i < count; ++i) {
+		mPutChunks[i]->reset(mSendMemoryLimit);
+	}
+}
+
+template<BatchSerializer::ProtoT PutProtocol>
+result_t ChannelImpl::reserveChunkPayloadBuffer(const std::size_t chunk,
+	void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	const std::size_t payloadSize,
+	const Key& key)
+{
+	constexpr std::size_t cKeySize = PutProtocol == BatchSerializer::ProtoT::PUT
+		? Serializer::cAbbrevKeySizeWithoutAcq
+		: Serializer::cAbbrevKeySize;
+	return mPutChunks[chunk]->reservePayloadBuffer(
+		oPayloadBuffer, oBufferSize, payloadSize, key, cKeySize);
+}
+
+template result_t ChannelImpl::reserveChunkPayloadBuffer<BatchSerializer::ProtoT::PUT>(
+	std::size_t chunk,
+	void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	std::size_t payloadSize,
+	const Key& key);
+template result_t ChannelImpl::reserveChunkPayloadBuffer<BatchSerializer::ProtoT::PUTA>(
+	std::size_t chunk,
+	void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	std::size_t payloadSize,
+	const Key& key);
+
+template<BatchSerializer::ProtoT PutProtocol>
+result_t ChannelImpl::writeNextChunkRecord(
+	const std::size_t chunk, const Key& key, const std::size_t payloadSize)
+{
+	const result_t res = checkNextPutRecord<PutProtocol>(key, payloadSize);
+	if (res != result_t::OK) {
+		return res;
+	}
+	mPutChunks[chunk]->putRecord<PutProtocol>(key, payloadSize);
+	return result_t::OK;
+}
+
+template result_t ChannelImpl::writeNextChunkRecord<BatchSerializer::ProtoT::PUT>(
+	std::size_t chunk, const Key& key, std::size_t payloadSize);
+template result_t ChannelImpl::writeNextChunkRecord<BatchSerializer::ProtoT::PUTA>(
+	std::size_t chunk, const Key& key, std::size_t payloadSize);
+
+result_t ChannelImpl::writePutChunks(const std::size_t count)
+{
+	endPutBatches();
+	const result_t resDrain = drainPipeline();
+	if (resDrain != result_t::OK) {
+		return resDrain;
+	}
+
+	mPutChunksIov.clear();
+	// clang-format off
+	struct iovec head{};
+	// clang-format on
+	// `struct iovec` is shared by reads and writes, hence the const cast.
+	head.iov_base = const_cast<void*>(mSendBuffer.readData()); /* NOLINT(cppcoreguidelines-pro-type-const-cast) */
+	head.iov_len = mSendBuffer.bytesAvailableToRead();
+	mPutChunksIov.push_back(head);
+	for (std::size_t i = 0; i < count; ++i) {
+		mPutChunks[i]->endBatch();
+		mPutChunks[i]->appendTo(mPutChunksIov);
+		mPutBatches.add(mPutChunks[i]->batches());
+	}
+	mPutBufferFlushes.add(1);
+
+	// A single call takes at most `IOV_MAX` blocks.
+	for (std::size_t first = 0; first < mPutChunksIov.size(); first += IOV_MAX) {
+		const std::size_t blocks = std::min<std::size_t>(IOV_MAX, mPutChunksIov.size() - first);
+		std::size_t amountSent = 0;
+		const result_t res = mSocket.sendv(&mPutChunksIov[first], blocks, amountSent);
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	resetState();
 	return result_t::OK;
 }
 
 result_t ChannelImpl::writeFin()
 {
-	mBatch.endBatch();
-	if (mBuffer.bytesOfFreeSpace() < sizeof(std::int32_t)) {
-		const result_t resSend = sendBuffer();
+	endPutBatches();
+	if (mSendBuffer.bytesOfFreeSpace() < sizeof(std::int32_t)) {
+		const result_t resSend = flushPutBuffer();
 		if (resSend != result_t::OK) {
 			return resSend;
 		}
-		mBuffer.reset();
+		mSendBuffer.reset();
 	}
-	Serializer(mBuffer).putInt32(-1);
-	return sendBuffer();
+	Serializer(mSendBuffer).putInt32(-1);
+	const std::size_t bytes = mSendBuffer.bytesAvailableToRead();
+	const auto start = pacePutSend(bytes);
+	const result_t res = countPutSend(start, bytes, sendBuffer());
+	if (res == result_t::OK) {
+		traceSent();
+		if (mFlow.enabled()) {
+			mFinSent = std::chrono::steady_clock::now();
+		}
+	}
+	return res;
+}
+
+result_t ChannelImpl::flushPutBuffer()
+{
+	const std::size_t bytes = mSendBuffer.bytesAvailableToRead();
+	const auto start = pacePutSend(bytes);
+	return countPutSend(start, bytes, flushBuffer());
+}
+
+result_t ChannelImpl::splitPutCommand()
+{
+	const std::int32_t cmdId = pendingCommand();
+	const result_t resFin = writeFin();
+	if (resFin != result_t::OK) {
+		return resFin;
+	}
+	const result_t resAck = readPutAck();
+	if (resAck != result_t::OK) {
+		return resAck;
+	}
+	return cmdId == CommandType::PUTA ? writePutAHeader() : writePutHeader();
+}
+
+result_t ChannelImpl::readPutAck()
+{
+	const result_t res = readResponse();
+	if (mDedup && res == result_t::OK) {
+		mDedup->insert(mDedupPending);
+	}
+	mDedupPending.clear();
+	if (mFlow.enabled() && (res == result_t::OK || res == result_t::ERROR)) {
+		mFlow.onAck(mFinSent, std::chrono::steady_clock::now(), mPutCommandBuffers,
+			mSocket.timeoutMs());
+		publishFlowStats();
+	}
+	return res;
+}
+
+std::chrono::steady_clock::time_point ChannelImpl::pacePutSend(const std::size_t bytes)
+{
+	if (!mFlow.enabled()) {
+		return std::chrono::steady_clock::time_point{};
+	}
+	const auto now = std::chrono::steady_clock::now();
+	const auto start = mFlow.pace(now, bytes);
+	if (start > now) {
+		std::this_thread::sleep_until(start);
+	}
+	return start;
+}
+
+result_t ChannelImpl::countPutSend(const std::chrono::steady_clock::time_point start,
+	const std::size_t bytes,
+	const result_t status)
+{
+	if (!mFlow.enabled() || status != result_t::OK) {
+		return status;
+	}
+	mFlow.onSend(start, std::chrono::steady_clock::now(), bytes, ++mPutCommandBuffers,
+		mSocket.timeoutMs());
+	publishFlowStats();
+	return status;
+}
+
+bool ChannelImpl::skipsAcknowledged(
+	const Key& key, const void* const payload, const std::size_t payloadSize)
+{
+	if (!mDedup) {
+		return false;
+	}
+	const std::uint64_t fingerprint = PutDedupFilter::fingerprint(key, payload, payloadSize);
+	if (mDedup->contains(fingerprint)) {
+		mPutRecordsSkipped.add(1);
+		return true;
+	}
+	mDedupPending.push_back(fingerprint);
+	return false;
+}
+
+void ChannelImpl::publishFlowStats()
+{
+	mPutPacingRate.store(mFlow.rate(), std::memory_order_relaxed);
+	mPutCommandBufferLimit.store(mFlow.commandBuffers(), std::memory_order_relaxed);
+	mPutBackoffs.store(mFlow.backoffs(), std::memory_order_relaxed);
 }
 
 /**************
@@ -194,14 +1176,23 @@ result_t ChannelImpl::writeFin()
 
 result_t ChannelImpl::readResponse()
 {
-	mBuffer.reset();
+	if (!ensureRecvBuffer()) {
+		return result_t::OUT_OF_MEMORY;
+	}
+	// Keep the data of the responses to pipelined requests that follow, but
+	// make room for this one.
+	(void)reserveBuffer(mRecvBuffer.capacity() - mRecvBuffer.bytesAvailableToRead());
 	const result_t resData = requestData(Serializer::cHeaderSize);
 	if (resData != result_t::OK) {
 		return resData;
 	}
 
-	Serializer serializer(mBuffer);
+	Serializer serializer(mRecvBuffer);
 	const Header response = serializer.getHeader();
+	// A successful GET goes on with its records.
+	if (pendingCommand() != CommandType::GET || response.id != 0) {
+		finishRequest(response.id != 0 ? result_t::ERROR : result_t::OK);
+	}
 	const result_t resSkip = skip(response.dataSize);
 	if (resSkip != result_t::OK) {
 		return resSkip;
@@ -217,15 +1208,137 @@ result_t ChannelImpl::readResponse()
 result_t ChannelImpl::readNextRecordData(
 	Key& oKey, const void*& oPayloadPtr, std::size_t& oPayloadSize)
 {
+	if (mFramedNext == mFramedSizes.size()) {
+		const result_t resFrame = frameRecords();
+		if (resFrame != result_t::OK) {
+			return resFrame;
+		}
+	}
+
+	Serializer serializer(mRecvBuffer);
+	const std::uint32_t recordSize = mFramedSizes[mFramedNext++];
+	serializer.confirmInt32();
+	if (recordSize == 0) {
+		dropFramedRecords();
+		if (tracing()) {
+			mTrace.recordsDone = std::chrono::steady_clock::now();
+		}
+		return result_t::END_OF_STREAM;
+	}
+
+	oKey = serializer.getKey();
+	if (!oKey.isStorable()) {
+		dropFramedRecords();
+		return result_t::BAD_RESPONSE;
+	}
+
+	oPayloadSize = recordSize - Serializer::cKeySize;
+	oPayloadPtr = serializer.getDataBuffer(oPayloadSize);
+	if (tracing()) {
+		++mTrace.records;
+	}
+	return result_t::OK;
+}
+
+result_t ChannelImpl::frameRecords()
+{
+	dropFramedRecords();
+	compactAfterChunkedPayload();
+	// Lets io_uring receive the records straight into the registered block.
+	mSocket.registerRecvBuffer(mRecvBuffer.memory(), mRecvBuffer.memorySize());
 	const result_t resData = requestData(sizeof(std::int32_t));
 	if (resData != result_t::OK) {
 		return resData;
 	}
 
-	Serializer serializer(mBuffer);
+	Serializer serializer(mRecvBuffer);
+	const std::int32_t recordSize = serializer.peekInt32();
+	if (recordSize != 0) {
+		const std::size_t payloadSize = recordSize - Serializer::cKeySize;
+		if (payloadSize > cMaxPayloadSize) {
+			return result_t::BAD_RESPONSE;
+		}
+		const result_t resKeyPayload = requestData(sizeof(std::int32_t) + recordSize);
+		if (resKeyPayload != result_t::OK) {
+			return resKeyPayload;
+		}
+	}
+
+	const std::size_t bytesAvailableToRead = mRecvBuffer.bytesAvailableToRead();
+	std::size_t offset = 0;
+	while (bytesAvailableToRead - offset >= sizeof(std::int32_t)) {
+		std::int32_t size = 0;
+		Serializer::get(size, mRecvBuffer.readData(offset));
+		if (size == 0) {
+			mFramedSizes.push_back(0);
+			break;
+		}
+		const std::size_t payloadSize = size - Serializer::cKeySize;
+		if (payloadSize > cMaxPayloadSize
+			|| bytesAvailableToRead - offset - sizeof(std::int32_t)
+				< static_cast<std::size_t>(size)) {
+			break;
+		}
+		mFramedSizes.push_back(static_cast<std::uint32_t>(size));
+		offset += sizeof(std::int32_t) + size;
+	}
+	return result_t::OK;
+}
+
+result_t ChannelImpl::readNextRecordKey(Key& oKey, std::size_t& oPayloadSize)
+{
+	const result_t resHead = readNextRecordHead(oKey, oPayloadSize);
+	if (resHead != result_t::OK) {
+		return resHead;
+	}
+
+	// The payload is dropped as it arrives, so that records of any size fit.
+	const result_t resSkip = skip(oPayloadSize);
+	if (resSkip != result_t::OK) {
+		return resSkip;
+	}
+	if (tracing()) {
+		++mTrace.records;
+	}
+	return result_t::OK;
+}
+
+bool ChannelImpl::nextRecordOversized() const
+{
+	if (mFramedNext < mFramedSizes.size()
+		|| mRecvBuffer.bytesAvailableToRead() < sizeof(std::int32_t)) {
+		return false;
+	}
+	std::int32_t recordSize = 0;
+	Serializer::get(recordSize, mRecvBuffer.readData());
+	return recordSize > 0
+		&& sizeof(std::int32_t) + recordSize > mRecvBuffer.capacity();
+}
+
+result_t ChannelImpl::readNextRecordHead(Key& oKey, std::size_t& oPayloadSize)
+{
+	dropFramedRecords();
+	compactAfterChunkedPayload();
+	// A key always fits once the consumed records are discarded to make room,
+	// which a failed request does; retry it once.
+	const auto requestKeyData = [this](const std::size_t amountBytes) {
+		const result_t res = requestData(amountBytes);
+		return res == result_t::MEMORY_LIMIT_EXCEEDED ? requestData(amountBytes) : res;
+	};
+
+	mSocket.registerRecvBuffer(mRecvBuffer.memory(), mRecvBuffer.memorySize());
+	const result_t resData = requestKeyData(sizeof(std::int32_t));
+	if (resData != result_t::OK) {
+		return resData;
+	}
+
+	Serializer serializer(mRecvBuffer);
 	const std::int32_t recordSize = serializer.peekInt32();
 	if (recordSize == 0) {
 		serializer.confirmInt32();
+		if (tracing()) {
+			mTrace.recordsDone = std::chrono::steady_clock::now();
+		}
 		return result_t::END_OF_STREAM;
 	}
 
@@ -234,21 +1347,59 @@ result_t ChannelImpl::readNextRecordData(
 		return result_t::BAD_RESPONSE;
 	}
 
-	const result_t resKeyPayload = requestData(sizeof(std::int32_t) + recordSize);
-	if (resKeyPayload != result_t::OK) {
-		return resKeyPayload;
+	const result_t resKey = requestKeyData(sizeof(std::int32_t) + Serializer::cKeySize);
+	if (resKey != result_t::OK) {
+		return resKey;
 	}
 
 	serializer.confirmInt32();
 	oKey = serializer.getKey();
-	if (!oKey.isValid() || !(oKey <= cKeyMax - 1)) {
+	if (!oKey.isStorable()) {
 		return result_t::BAD_RESPONSE;
 	}
+	return result_t::OK;
+}
 
-	oPayloadPtr = serializer.getDataBuffer(oPayloadSize);
+result_t ChannelImpl::readPayloadChunk(
+	const std::size_t amountBytes, const void*& oChunkPtr, std::size_t& oChunkSize)
+{
+	if (mRecvBuffer.bytesAvailableToRead() == 0) {
+		// Receives as much as fits, once the consumed chunks are discarded
+		// if the buffer is full.
+		result_t res = requestData(1);
+		if (res == result_t::MEMORY_LIMIT_EXCEEDED) {
+			res = requestData(1);
+		}
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+
+	oChunkSize = std::min(amountBytes, mRecvBuffer.bytesAvailableToRead());
+	oChunkPtr = mRecvBuffer.readData();
+	mRecvBuffer.readAdvance(oChunkSize);
+	mChunkedPayloadRead = oChunkSize == amountBytes;
 	return result_t::OK;
 }
 
+bool ChannelImpl::waitNextRecordData(const std::uint32_t timeoutMs)
+{
+	if (mFramedNext < mFramedSizes.size()) {
+		return true;
+	}
+	const std::size_t bytesAvailableToRead = mRecvBuffer.bytesAvailableToRead();
+	if (bytesAvailableToRead >= sizeof(std::int32_t)) {
+		Serializer serializer(mRecvBuffer);
+		const std::int32_t recordSize = serializer.peekInt32();
+		if (recordSize <= 0
+			|| bytesAvailableToRead - sizeof(std::int32_t)
+				>= static_cast<std::size_t>(recordSize)) {
+			return true;
+		}
+	}
+	return mSocket.waitReadable(timeoutMs);
+}
+
 result_t ChannelImpl::readAcq(Key::AcqT& oAcq)
 {
 	const result_t resData = requestData(Serializer::cHeaderSize + sizeof(oAcq));
@@ -256,8 +1407,9 @@ result_t ChannelImpl::readAcq(Key::AcqT& oAcq)
 		return resData;
 	}
 
-	Serializer serializer(mBuffer);
+	Serializer serializer(mRecvBuffer);
 	const HeaderAcq response = serializer.getHeaderAcq();
+	finishRequest(response.id != 0 ? result_t::ERROR : result_t::OK);
 
 	const std::int32_t tstorageErrorCode = response.id;
 	if (tstorageErrorCode != 0) {
@@ -265,7 +1417,7 @@ result_t ChannelImpl::readAcq(Key::AcqT& oAcq)
 		if (resSkip != result_t::OK) {
 			return resSkip;
 		}
-		return result_t::ERROR;
+		return endCommand(result_t::ERROR);
 	}
 	if (response.dataSize < 8) {
 		return result_t::BAD_RESPONSE;
@@ -276,7 +1428,8 @@ result_t ChannelImpl::readAcq(Key::AcqT& oAcq)
 	if (resSkip != result_t::OK) {
 		return resSkip;
 	}
-	return result_t::OK;
+	shrinkBuffer();
+	return endCommand(result_t::OK);
 }
 
 /**************
@@ -285,9 +1438,15 @@ result_t ChannelImpl::readAcq(Key::AcqT& oAcq)
 
 result_t ChannelImpl::sendBuffer()
 {
+	const result_t resDrain = drainPipeline();
+	if (resDrain != result_t::OK) {
+		return resDrain;
+	}
+	TSTORAGE_PROBE1(send__buffer__entry, mSendBuffer.bytesAvailableToRead());
 	std::size_t amountSent = 0;
 	const result_t res =
-		mSocket.send(mBuffer.readData(), mBuffer.bytesAvailableToRead(), amountSent);
+		mSocket.send(mSendBuffer.readData(), mSendBuffer.bytesAvailableToRead(), amountSent);
+	TSTORAGE_PROBE1(send__buffer__return, static_cast<int>(res));
 	if (res != result_t::OK) {
 		return res;
 	}
@@ -295,27 +1454,103 @@ result_t ChannelImpl::sendBuffer()
 	return result_t::OK;
 }
 
+result_t ChannelImpl::sendBufferWith(const void* const payload, const std::size_t payloadSize)
+{
+	const result_t resDrain = drainPipeline();
+	if (resDrain != result_t::OK) {
+		return resDrain;
+	}
+	std::array<struct iovec, 2> iov{};
+	// `struct iovec` is shared by reads and writes, hence the const casts.
+	iov[0].iov_base = const_cast<void*>(mSendBuffer.readData()); /* NOLINT(cppcoreguidelines-pro-type-const-cast) */
+	iov[0].iov_len = mSendBuffer.bytesAvailableToRead();
+	iov[1].iov_base = const_cast<void*>(payload); /* NOLINT(cppcoreguidelines-pro-type-const-cast) */
+	iov[1].iov_len = payloadSize;
+	TSTORAGE_PROBE1(send__buffer__entry, iov[0].iov_len + payloadSize);
+	std::size_t amountSent = 0;
+	const result_t res = mSocket.sendv(iov.data(), iov.size(), amountSent);
+	TSTORAGE_PROBE1(send__buffer__return, static_cast<int>(res));
+	if (res != result_t::OK) {
+		return res;
+	}
+	resetState();
+	return result_t::OK;
+}
+
+result_t ChannelImpl::flushBuffer()
+{
+	if (mPutPipelineDepth <= cDefaultPutPipelineDepth) {
+		return sendBuffer();
+	}
+	// The spare buffers are given up under pressure, and flushes go
+	// synchronous until the budget has room for them again.
+	if (mSender && mBudget && mBudget->underPressure()) {
+		const result_t resDrain = mSender->drain();
+		dropSender();
+		if (resDrain != result_t::OK) {
+			return resDrain;
+		}
+	}
+	if (!mSender) {
+		const std::size_t charge = (mPutPipelineDepth - 1) * mSendBuffer.capacity();
+		if (mBudget && (mBudget->underPressure() || !mBudget->tryAcquire(charge))) {
+			return sendBuffer();
+		}
+		mSenderCharge = mBudget ? charge : 0;
+		mSender = std::make_unique<PipelinedSender>(mSocket, mPutPipelineDepth);
+	}
+	bool allocated = false;
+	const result_t res = mSender->submit(mSendBuffer, allocated);
+	if (res != result_t::OK) {
+		return res;
+	}
+	if (allocated) {
+		countAllocation(mSendBuffer.capacity());
+	}
+	resetState();
+	return result_t::OK;
+}
+
+result_t ChannelImpl::drainPipeline()
+{
+	if (!mSender) {
+		return result_t::OK;
+	}
+	return mSender->drain();
+}
+
 result_t ChannelImpl::requestData(const std::size_t amountBytes)
 {
-	const std::size_t bytesAvailableToRead = mBuffer.bytesAvailableToRead();
+	const std::size_t bytesAvailableToRead = mRecvBuffer.bytesAvailableToRead();
 	if (amountBytes <= bytesAvailableToRead) {
 		return result_t::OK;
 	}
+	if (!ensureRecvBuffer()) {
+		return result_t::OUT_OF_MEMORY;
+	}
 
 	const std::size_t amountBytesMissing = amountBytes - bytesAvailableToRead;
-	if (amountBytesMissing > mBuffer.bytesOfFreeSpace()) {
-		(void)mBuffer.reserve(amountBytesMissing);
+	if (amountBytesMissing > mRecvBuffer.bytesOfFreeSpace()
+		&& (amountBytes <= mRecvMemoryLimit || !growBuffer(amountBytes))) {
+		(void)reserveBuffer(amountBytesMissing);
 		return result_t::MEMORY_LIMIT_EXCEEDED;
 	}
 
+	std::chrono::steady_clock::time_point recvStart{};
+	if (tracing()) {
+		recvStart = std::chrono::steady_clock::now();
+	}
 	std::size_t recvd = 0;
 	const result_t resFetch = mSocket.recvAtLeast(
-		mBuffer.writeData(), mBuffer.bytesOfFreeSpace(), amountBytesMissing, recvd);
+		mRecvBuffer.writeData(), mRecvBuffer.bytesOfFreeSpace(), amountBytesMissing, recvd);
+	if (tracing() && resFetch == result_t::OK) {
+		traceRecv(recvStart);
+	}
 
 	if (resFetch != result_t::OK) {
 		return resFetch;
 	}
-	mBuffer.writeAdvance(recvd);
+	mRecvBuffer.writeAdvance(recvd);
 	if (recvd < amountBytesMissing) {
 		return result_t::BAD_RESPONSE;
 	}
@@ -324,14 +1559,14 @@ result_t ChannelImpl::requestData(const std::size_t amountBytes)
 
 result_t ChannelImpl::skip(const std::size_t amountBytes)
 {
-	const std::size_t bytesAvailableToRead = mBuffer.bytesAvailableToRead();
+	const std::size_t bytesAvailableToRead = mRecvBuffer.bytesAvailableToRead();
 	if (amountBytes <= bytesAvailableToRead) {
-		mBuffer.readAdvance(amountBytes);
+		mRecvBuffer.readAdvance(amountBytes);
 		return result_t::OK;
 	}
 
 	const std::size_t amountBytesToFetch = amountBytes - bytesAvailableToRead;
-	mBuffer.readAdvance(bytesAvailableToRead);
+	mRecvBuffer.readAdvance(bytesAvailableToRead);
 
 	std::size_t amountSkipped{};
 	const result_t res = mSocket.skipExactly(amountBytesToFetch, amountSkipped);
@@ -22,17 +22,38 @@
 #ifndef D_TSTORAGE_CHANNELIMPL_PH
 #define D_TSTORAGE_CHANNELIMPL_PH
 
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
 #include <string>
+#include <utility>
+#include <vector>
+#include <sys/uio.h>
 
 #include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/MemoryBudget.h>
+#include <tstorageclient++/PutDedupFilter.h>
+#include <tstorageclient++/Tracer.h>
 
+#include "BandwidthEstimator.h"
 #include "BatchSerializer.h"
 #include "Buffer.h"
+#include "BufferPool.h"
+#include "Counters.h"
 #include "Headers.h"
+#include "PayloadSizePredictor.h"
+#include "PipelinedSender.h"
+#include "Probes.h"
+#include "PutChunk.h"
+#include "PutFlowController.h"
+#include "RecordCountPredictor.h"
 #include "Serializer.h"
 #include "Socket.h"
+#include "WorkerPool.h"
 
 /** @file
  * @brief Provides low-level implementation details of the `Channel<T>` class.
@@ -53,17 +74,24 @@ namespace impl {
  * buffer to de-/serialize the data from/into.
  *
  * The channel defers its resource acquisition (socket FDs, memory) to the
- * first `connect()` call. Analogously, the resources are freed on the
- * subsequent `close()` or `abort()` call.
+ * first `connect()` call, and the allocation of each of its two buffers, the
+ * send and the receive one, to the first request which uses it, so that a
+ * channel used for small requests or in one direction only does not pay for
+ * the other. The resources are freed on the subsequent `close()` or `abort()`
+ * call, unless the channel is set to release its buffers after each command
+ * or once idle (see `setBufferRelease()`), in which case they go to the
+ * process-wide `BufferPool` and are taken back from it by the next request.
+ * Since the buffers are separate, sending a request does not disturb
+ * the responses received so far.
  *
  * In order to reduce the amount of syscalls, all communication with the server
- * is buffered. On write, all data is first written to the internal buffer. The
+ * is buffered. On write, all data is first written to the send buffer. The
  * buffer is flushed only in two cases: (1) when the buffer's total memory
  * usage approaches its maximum capacity; and (2) on an outbound message
  * termination. On receive, we do not bound the amount of data fetched during a
  * single syscall. While reading and deserializing the server's response, we
  * first access the excess data from the last `Socket::recv()` call located in
- * the internal buffer, and then, only when the buffer is about to run out of
+ * the receive buffer, and then, only when the buffer is about to run out of
  * local data to read, we perform a syscall to receive the next portion of the
  * response.
  *
@@ -71,26 +99,54 @@ namespace impl {
  * or `ChannelBase` is that the basic data type underlying the PUT/A protocol
  * is not an individual record; it is, instead, a batch of records. A good way
  * to think of such a batch is as a list of records sharing the same CID. To
- * construct the batch inside the internal buffer and keep track of its current
+ * construct the batch inside the send buffer and keep track of its current
  * state we employ a `BatchSerializer` object. This `ChannelImpl` component is
  * responsible for appending each record with a matching CID to the current
  * batch. It also decides when to end the batch and start a new one; this
- * occurs automatically when the internal buffer is about to overflow or when
+ * occurs automatically when the send buffer is about to overflow or when
  * we acquire a record with a differing CID value. For more information, see
  * `BatchSerializer`.
+ *
+ * By default, flushing a full buffer during a PUT/A request blocks until the
+ * socket accepts all of its contents. With the pipeline depth set above `1`
+ * (see `setPutPipelineDepth()`), full buffers are instead handed over to a
+ * `PipelinedSender`, which writes them in the background while the next chunk
+ * of records is serialized into a spare buffer. The end-of-stream flush in
+ * `writeFin()` and all other requests wait for the pipeline to drain first, so
+ * the order of bytes on the wire is unaffected.
  */
 class ChannelImpl final
 {
+public:
+	/** @brief The maximal payload size acceptable by TStorage. */
+	static constexpr std::size_t cMaxPayloadSize = 32UL * 1024 * 1024;
+
 private:
-	/** @brief The default size of the internal buffer. */
+	/** @brief The default size of the send and receive buffers. */
 	static constexpr std::size_t cInitialBufferSize = 64L * 1024;  // 64 KiB
-	/** @brief The minimal size of the internal buffer. */
+	/** @brief The minimal size of the send and receive buffers. */
 	static constexpr std::size_t cMinBufferSize = 128;	// 128B
-	/** @brief The maximal payload size acceptable by TStorage. */
-	static constexpr std::size_t cMaxPayloadSize = 32UL * 1024 * 1024;
-	/** @brief Initial value of a payload size hint for some internal
-	 * optimizations (see `reservePutPayloadBuffer()`). */
-	static constexpr std::size_t cInitialExpectedPayloadSize = 8;
+	/** @brief The minimal size of payloads exposed through
+	 * `PayloadType::toView()` that are sent directly from user memory. Smaller
+	 * ones are cheaper to copy than to send with a separate scatter/gather
+	 * entry. */
+	static constexpr std::size_t cVectoredPayloadThreshold = 16L * 1024;  // 16 KiB
+	/** @brief The minimal size of the buffers allocated with the
+	 * `Buffer::MIRRORED` layout, so that compacting it while receiving costs no
+	 * copies. Smaller buffers are cheap to compact and would waste most of a
+	 * memory page. */
+	static constexpr std::size_t cMirroredBufferThreshold = 64L * 1024;  // 64 KiB
+	/** @brief The default PUT/A pipeline depth (no pipelining). */
+	static constexpr std::size_t cDefaultPutPipelineDepth = 1;
+	/** @brief The default retry policy (no retries). */
+	static constexpr RetryPolicy cDefaultRetryPolicy{1, 100, 10'000, false};
+	/** @brief `false` if the tracing hooks are compiled out (`make
+	 * NO_TRACING=1`). */
+#ifdef D_TSTORAGE_NO_TRACING
+	static constexpr bool cTracingBuilt = false;
+#else
+	static constexpr bool cTracingBuilt = true;
+#endif
 
 public:
 
@@ -104,35 +160,68 @@ public:
 	 * Initializes the object with default values.
 	 */
 	ChannelImpl()
-		: mExpectedPayloadSize(cInitialExpectedPayloadSize)
-		, mMemoryLimit(cInitialBufferSize)
-		, mBatch(mBuffer)
+		: mRetryPolicy(cDefaultRetryPolicy)
+		, mRetryRng(std::random_device{}())
+		, mReconnectable(false)
+		, mFramedNext(0)
+		, mChunkedPayloadRead(false)
+		, mSenderCharge(0)
+		, mSendMemoryLimit(cInitialBufferSize)
+		, mRecvMemoryLimit(cInitialBufferSize)
+		, mSendMemoryFloor(cInitialBufferSize)
+		, mRecvMemoryFloor(cInitialBufferSize)
+		, mTunedBufferSize(0)
+		, mTunedSocketBufferSize(0)
+		, mBdpBytes(0)
+		, mPutCommandBuffers(0)
+		, mFinSent{}
+		, mPutPacingRate(0)
+		, mPutCommandBufferLimit(0)
+		, mPutBackoffs(0)
+		, mReservedPayload(nullptr)
+		, mMaxMemoryLimit(0)
+		, mBufferPool(BufferPool::shared())
+		, mBufferRelease(-1)
+		, mBufferAllocation{}
+		, mPutPipelineDepth(cDefaultPutPipelineDepth)
+		, mCoalescePutBatches(false)
+		, mPutKeysValidated(false)
+		, mPutBatchesOffset(0)
+		, mRequestsQueued(false)
+		, mBatch(mSendBuffer)
+		, mPendingHead(0)
+		, mCharged{}
+		, mTrace{}
+		, mTraceActive(false)
 	{
 	}
+	/** @brief A destructor. Gives the quota of the buffers back. */
+	~ChannelImpl();
 
 	/** @brief Forcefully closes the connection. Used on errors. */
-	void abort() { mSocket.abort(); }
-	/**
-	 * @brief Discards the data currently stored in the buffer (does not affect
-	 * its capacity).
-	 */
-	void resetBuffer();
+	void abort();
+	/** @brief Shuts the connection down without closing the socket, so that
+	 * a receive blocked on another thread returns. */
+	void interrupt() { (void)mSocket.shutdown(Socket::Shut::READWRITE); }
+	/** @brief Returns `true` if the connection is established, `false`
+	 * otherwise. */
+	bool connected() const { return mSocket.connectionEstablished(); }
 	/**
-	 * @brief Prepares the channel for work by allocating memory for internal
-	 * buffer and connecting with the host.
+	 * @brief Connects with the host.
+	 *
+	 * The send and receive buffers are not allocated here, but by the first
+	 * request which uses them.
 	 *
 	 * The possible error codes are:
 	 *  - `result_t::BAD_ADDRESS`
 	 *  - `result_t::CONNERROR`
 	 *  - `result_t::CONNREFUSED`
 	 *  - `result_t::CONNTIMEOUT`
-	 *  - `result_t::OUT_OF_MEMORY`
 	 *  - `result_t::SETOPT_ERROR`
 	 *  - `result_t::SIGNAL`
 	 *  - `result_t::SOCKET_ERROR`
 	 *
-	 * @return `result_t::OUT_OF_MEMORY` if the allocation failed, the result of
-	 * `Socket::connect()` otherwise.
+	 * @return The result of `Socket::connect()`.
 	 */
 	result_t connect();
 	/**
@@ -146,6 +235,29 @@ public:
 	 * @return The status code.
 	 */
 	result_t close();
+	/**
+	 * @brief Sets the policy of retrying failed requests.
+	 * @see `Channel::setRetryPolicy()`
+	 * @param policy The new policy.
+	 */
+	void setRetryPolicy(const RetryPolicy& policy);
+	/**
+	 * @brief Decides whether a failed request is to be retried and if so,
+	 * reconnects after a backoff.
+	 *
+	 * A request is retried if it failed with a connection error, the
+	 * connection had been established with `connect()` and not closed with
+	 * `close()` since, and the retry policy allows another attempt. Failed
+	 * reconnects count as attempts.
+	 *
+	 * @param status The status code of the failed attempt.
+	 * @param[in, out] ioAttempt The amount of attempts made so far, updated
+	 * with the reconnects.
+	 * @param put `true` for PUT/A requests, `false` for the idempotent ones.
+	 * @return `true` if the channel has reconnected and the request is to be
+	 * retried, `false` if the failure is final.
+	 */
+	bool prepareRetry(result_t status, std::uint32_t& ioAttempt, bool put);
 
 	/**
 	 * @brief Initiates a GET request.
@@ -167,6 +279,41 @@ public:
 	 * @return The status code.
 	 */
 	inline result_t writeGetAcqRequest(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Appends a GET request to the output buffer without sending it.
+	 *
+	 * @see `queueKeyPairHeader()`
+	 *
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @return The status code.
+	 */
+	inline result_t queueGetRequest(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Appends a GETACQ request to the output buffer without sending it.
+	 *
+	 * @see `queueKeyPairHeader()`
+	 *
+	 * @param keyMin The lower vertex of the target key-interval.
+	 * @param keyMax The upper vertex of the target key-interval.
+	 * @return The status code.
+	 */
+	inline result_t queueGetAcqRequest(const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Sends the requests appended by `queueGetRequest()` and
+	 * `queueGetAcqRequest()` that are still buffered.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNRESET`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::SIGNAL`
+	 *
+	 * @return The status code.
+	 */
+	result_t flushRequests();
 	/**
 	 * @brief Initiates a PUT request.
 	 * @see `writeEmptyHeader()`
@@ -186,9 +333,8 @@ public:
 	 *
 	 * Since the required size of the memory block is known only after payload
 	 * serialization (as per `PayloadType::toBytes()`), the size of the
-	 * reserved memory block is chosen according to a simple heuristic, namely it
-	 * is equal to the maximal payload size encountered by the channel to date
-	 * (starting from `ChannelImpl::cInitialExpectedPayloadSize`).
+	 * reserved memory block is the one predicted by `mPayloadSizes` from the
+	 * payloads serialized by the channel to date.
 	 *
 	 * Used during the first serialization attempt of a given record, when the actual
 	 * payload size is not known.
@@ -215,7 +361,7 @@ public:
 		void*& oPayloadBuffer, std::size_t& oBufferSize, const Key& key);
 	/**
 	 * @brief Reserves a writable memory block of a certain size inside the
-	 * internal buffer for payload serialization. Used with PUT protocol.
+	 * send buffer for payload serialization. Used with PUT protocol.
 	 *
 	 * Used during the second serialization attempt of a given record, only when
 	 * the first returned a pointer to a memory block of insufficient size. The
@@ -238,7 +384,7 @@ public:
 		const Key& key);
 	/**
 	 * @brief Reserves a writable memory block of a certain size inside the
-	 * internal buffer for payload serialization. Used with PUTA protocol.
+	 * send buffer for payload serialization. Used with PUTA protocol.
 	 *
 	 * @see `reservePutPayloadBuffer()`
 	 * @param[out] oPayloadBuffer A writable memory block to serialize payload into.
@@ -267,7 +413,7 @@ public:
 	/**
 	 * @brief Serializes the current record's metadata. Used with PUTA protocol.
 	 *
-	 * In case the internal buffer is about to overflow, ends the current data
+	 * In case the send buffer is about to overflow, ends the current data
 	 * batch and sends it over to TStorage.
 	 *
 	 * The possible error codes are:
@@ -279,6 +425,71 @@ public:
 	 * @return The status code.
 	 */
 	result_t writeNextPutARecord(const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Writes a record the payload of which is given as a read-only memory
+	 * block. Used with PUT protocol.
+	 *
+	 * Payloads of at least `cVectoredPayloadThreshold` bytes are not copied to
+	 * the send buffer. Instead, the current batch is ended right after the
+	 * record's key, and the buffer content is sent together with the payload
+	 * block in a single `Socket::sendv()` call. Such payloads are not bound by
+	 * the memory limit. Smaller payloads are copied to the send buffer as
+	 * with `reservePutPayloadBuffer()` and `writeNextPutRecord()`.
+	 *
+	 * The possible error codes are those of `reservePutPayloadBuffer()` and
+	 * `writeNextPutRecord()`.
+	 *
+	 * @param key The key of the record.
+	 * @param payload The serialized payload.
+	 * @param payloadSize Payload size in bytes.
+	 * @return The status code.
+	 */
+	result_t writeNextPutRecordView(
+		const Key& key, const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief Writes a record the payload of which is given as a read-only memory
+	 * block. Used with PUTA protocol.
+	 * @see `writeNextPutRecordView()`
+	 * @param key The key of the record.
+	 * @param payload The serialized payload.
+	 * @param payloadSize Payload size in bytes.
+	 * @return The status code.
+	 */
+	result_t writeNextPutARecordView(
+		const Key& key, const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief Writes a record the payload of which is serialized piece by piece
+	 * into the send buffer. Used with PUT protocol.
+	 *
+	 * The current batch is ended right after the record's key, and the buffer
+	 * content is sent. Then `fillPayload` is called with the free space of the
+	 * emptied buffer, the offset of the next piece of the payload and its
+	 * size, which is sent in turn, until the whole payload is. Such payloads
+	 * are not bound by the memory limit, nor filtered by the PUTA
+	 * deduplication filter.
+	 *
+	 * The possible error codes are those of `writeNextPutRecordView()`.
+	 *
+	 * @param key The key of the record.
+	 * @param payloadSize Payload size in bytes.
+	 * @param fillPayload Serializes a piece of the payload.
+	 * @return The status code.
+	 */
+	result_t writeNextPutRecordPieces(const Key& key,
+		std::size_t payloadSize,
+		const std::function<void(void*, std::size_t, std::size_t)>& fillPayload);
+	/**
+	 * @brief Writes a record the payload of which is serialized piece by piece
+	 * into the send buffer. Used with PUTA protocol.
+	 * @see `writeNextPutRecordPieces()`
+	 * @param key The key of the record.
+	 * @param payloadSize Payload size in bytes.
+	 * @param fillPayload Serializes a piece of the payload.
+	 * @return The status code.
+	 */
+	result_t writeNextPutARecordPieces(const Key& key,
+		std::size_t payloadSize,
+		const std::function<void(void*, std::size_t, std::size_t)>& fillPayload);
 	/**
 	 * @brief Finalizes a PUT/A request.
 	 *
@@ -297,6 +508,106 @@ public:
 	 * @return The status code.
 	 */
 	result_t writeFin();
+	/**
+	 * @brief Sends the records of a PUT/A request written so far.
+	 *
+	 * Ends the current data batch and sends the buffer over to TStorage
+	 * without finishing the PUT/A request, so that more records can follow.
+	 * Does nothing if the buffer is empty.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNRESET`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::SIGNAL`
+	 *
+	 * @return The status code.
+	 */
+	result_t flushPut();
+	/**
+	 * @brief Sends the records of a PUT/A request from a file holding them
+	 * already serialized as batches, as `writeFin()` expects them to precede
+	 * the end-of-stream marker.
+	 *
+	 * Sends the request header written so far, then `length` bytes of the
+	 * file at `offset` with `Socket::sendFile()`, bypassing the internal
+	 * buffer. The request is finished by `writeFin()` as usual.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNRESET`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::FILE_ERROR`
+	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::SIGNAL`
+	 *
+	 * @param fd The file.
+	 * @param offset The offset of the first batch in the file.
+	 * @param length The size of the batches in bytes.
+	 * @return The status code.
+	 */
+	result_t writeFileBatches(int fd, std::uint64_t offset, std::uint64_t length);
+	/**
+	 * @brief Provides `count` empty chunks for records of a PUT/A request
+	 * serialized on the encoding threads, each with a segment capacity bound by
+	 * the memory limit.
+	 * @param count The amount of chunks.
+	 */
+	void preparePutChunks(std::size_t count);
+	/**
+	 * @brief Supplies a writable buffer for the payload of the next record of
+	 * the `chunk`-th chunk.
+	 *
+	 * Chunks are independent of each other and of the channel's buffer, so
+	 * this and `writeNextChunkRecord()` may be called for distinct chunks from
+	 * several threads at once.
+	 *
+	 * The possible error codes are those of `PutChunk::reservePayloadBuffer()`.
+	 *
+	 * @tparam PutProtocol A protocol tag.
+	 * @param chunk The index of the chunk.
+	 * @param[out] oPayloadBuffer A writable memory chunk for the payload.
+	 * @param[out] oBufferSize The size of the memory chunk.
+	 * @param[in] payloadSize The size of the payload, `0` if unknown.
+	 * @param[in] key The key of the record.
+	 * @return The status code.
+	 */
+	template<BatchSerializer::ProtoT PutProtocol>
+	result_t reserveChunkPayloadBuffer(std::size_t chunk,
+		void*& oPayloadBuffer,
+		std::size_t& oBufferSize,
+		std::size_t payloadSize,
+		const Key& key);
+	/**
+	 * @brief Appends the record the payload of which was serialized to the
+	 * buffer supplied by `reserveChunkPayloadBuffer()` to the `chunk`-th
+	 * chunk.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::INVALID_KEY`
+	 *  - `result_t::PAYLOAD_TOO_LARGE`
+	 *
+	 * @tparam PutProtocol A protocol tag.
+	 * @param chunk The index of the chunk.
+	 * @param key The key of the record.
+	 * @param payloadSize The size of the payload.
+	 * @return The status code.
+	 */
+	template<BatchSerializer::ProtoT PutProtocol>
+	result_t writeNextChunkRecord(std::size_t chunk, const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Sends the buffer followed by the first `count` chunks, in order,
+	 * with vectored writes, keeping the PUT/A request open.
+	 *
+	 * The possible error codes are those of `flushPut()`.
+	 *
+	 * @param count The amount of chunks to send.
+	 * @return The status code.
+	 */
+	result_t writePutChunks(std::size_t count);
 
 	/**
 	 * @brief Reads a TStorage response header. Used with GET.
@@ -323,13 +634,13 @@ public:
 	 * @see `readResponse()`
 	 * @return The status code.
 	 */
-	result_t readPutResult() { return readResponse(); }
+	result_t readPutResult() { return endCommand(readPutAck()); }
 	/**
 	 * @brief Reads a TStorage response header. Used with PUTA.
 	 * @see `readResponse()`
 	 * @return The status code.
 	 */
-	result_t readPutAResult() { return readResponse(); }
+	result_t readPutAResult() { return endCommand(readPutAck()); }
 	/**
 	 * @brief Retrieves the next record from the server.
 	 *
@@ -355,6 +666,57 @@ public:
 	 */
 	result_t readNextRecordData(
 		Key& oKey, const void*& oPayloadPtr, std::size_t& oPayloadSize);
+	/**
+	 * @brief Retrieves the key and the payload size of the next record from
+	 * the server, discarding its payload.
+	 *
+	 * Unlike `readNextRecordData()`, the payload is never buffered whole, so
+	 * that no record exceeds the memory limit. The possible error codes are
+	 * the same but `result_t::MEMORY_LIMIT_EXCEEDED`.
+	 *
+	 * @param[out] oKey The key of the read record.
+	 * @param[out] oPayloadSize The size of the discarded payload.
+	 * @return The status code.
+	 */
+	result_t readNextRecordKey(Key& oKey, std::size_t& oPayloadSize);
+	/** @brief Returns `true` if the size of the next record is buffered, and
+	 * the record cannot fit in the receive buffer. */
+	bool nextRecordOversized() const;
+	/**
+	 * @brief Retrieves the key and the payload size of the next record from
+	 * the server, leaving its payload unread.
+	 *
+	 * The payload has to be read by `readPayloadChunk()` then. The possible
+	 * error codes are those of `readNextRecordKey()`.
+	 *
+	 * @param[out] oKey The key of the read record.
+	 * @param[out] oPayloadSize The size of the payload.
+	 * @return The status code.
+	 */
+	result_t readNextRecordHead(Key& oKey, std::size_t& oPayloadSize);
+	/**
+	 * @brief Retrieves the next chunk of a payload left unread by
+	 * `readNextRecordHead()`, as much of it as the receive buffer holds or
+	 * receives at once.
+	 *
+	 * The possible error codes are those of `skip()`, and
+	 * `result_t::OUT_OF_MEMORY`.
+	 *
+	 * @param amountBytes The size of the unread rest of the payload.
+	 * @param[out] oChunkPtr The memory address of the chunk.
+	 * @param[out] oChunkSize The size of the chunk, at most `amountBytes`.
+	 * @return The status code.
+	 */
+	result_t readPayloadChunk(
+		std::size_t amountBytes, const void*& oChunkPtr, std::size_t& oChunkSize);
+	/**
+	 * @brief Waits until the next call to `readNextRecordData()` is likely
+	 * not to block: the next record, or the end of the records, is buffered
+	 * in full, or more data has arrived.
+	 * @param timeoutMs The longest wait in milliseconds.
+	 * @return `false` if the wait has timed out, `true` otherwise.
+	 */
+	bool waitNextRecordData(std::uint32_t timeoutMs);
 	/**
 	 * @brief Retrieves the ACQ timestamp returned by the server upon completion
 	 * of a GET request.
@@ -387,6 +749,142 @@ public:
 	 * @param timeout Timeout in milliseconds.
 	 */
 	void setTimeoutMs(std::int64_t timeout) { mSocket.setTimeoutMs(timeout); }
+	/**
+	 * @brief Sets the timeout of establishing a connection.
+	 * @see `Channel::setConnectTimeout()`
+	 * @param timeoutMs Timeout in milliseconds, `0` for none.
+	 */
+	void setConnectTimeoutMs(std::uint32_t timeoutMs) { mSocket.setConnectTimeoutMs(timeoutMs); }
+	/**
+	 * @brief Sets the deadline of the requests made from now on, bounding
+	 * their transfers, reconnects and retry backoffs as a whole.
+	 * @see `Socket::setDeadline()`
+	 * @param deadline The deadline, `time_point::max()` to remove it.
+	 */
+	void setDeadline(const std::chrono::steady_clock::time_point deadline)
+	{
+		mSocket.setDeadline(deadline);
+	}
+	/**
+	 * @brief Sets the busy polling time of the underlying socket.
+	 * @see `Channel::setBusyPoll()`
+	 * @param busyPollUs Busy polling time in microseconds, `0` to disable.
+	 */
+	void setBusyPollUs(std::uint32_t busyPollUs) { (void)mSocket.setBusyPollUs(busyPollUs); }
+	/**
+	 * @brief Sets the largest receive low watermark of the underlying socket.
+	 * @see `Channel::setReceiveLowWatermark()`
+	 * @param limitBytes The largest low watermark, or `0` to disable it.
+	 */
+	void setReceiveLowWatermark(std::size_t limitBytes)
+	{
+		mSocket.setRecvLowWatermark(limitBytes);
+	}
+	/**
+	 * @brief Enables or disables the io_uring backend of the underlying
+	 * socket for the connections established from now on.
+	 * @see `Channel::setIoUring()`
+	 * @param enabled `true` to use io_uring, `false` otherwise.
+	 */
+	void setIoUring(bool enabled) { mSocket.setIoUring(enabled); }
+	/**
+	 * @brief Enables or disables restarting the syscalls of the underlying
+	 * socket interrupted by signals.
+	 * @see `Channel::setSignalRestart()`
+	 * @param enabled `true` to restart interrupted syscalls, `false` otherwise.
+	 */
+	void setSignalRestart(bool enabled) { mSocket.setRestartOnSignal(enabled); }
+	/**
+	 * @brief Sets the TCP options of the underlying socket for the
+	 * connections established from now on.
+	 * @see `Channel::setSocketOptions()`
+	 * @param options The options.
+	 */
+	void setSocketOptions(const SocketOptions& options) { mSocket.setOptions(options); }
+	/**
+	 * @brief Sets the TLS options of the underlying socket for the
+	 * connections established from now on.
+	 * @see `Channel::setTlsOptions()`
+	 * @param options The options.
+	 */
+	void setTlsOptions(const TlsOptions& options) { mSocket.setTls(options); }
+	/**
+	 * @brief Returns the receive counters of the last request.
+	 * @see `Channel::receiveStats()`
+	 */
+	const ReceiveStats& receiveStats() const { return mSocket.stats(); }
+	/**
+	 * @brief Returns the counters of the work done by the channel since its
+	 * construction. Safe to call from any thread.
+	 * @see `Channel::stats()`
+	 */
+	ChannelStats stats() const;
+	/**
+	 * @brief Sets the tracer receiving the timings of connects and requests.
+	 * @see `Channel::setTracer()`
+	 * @param tracer The tracer, or `nullptr` to disable tracing.
+	 */
+	void setTracer(std::shared_ptr<Tracer> tracer)
+	{
+		mTracer = std::move(tracer);
+		mTraceActive = false;
+	}
+	/**
+	 * @brief Sets the amount of threads deserializing the records of GET
+	 * responses.
+	 * @see `Channel::setDecodeThreads()`
+	 * @param threads The amount of threads, `0` to deserialize the records on
+	 * the thread reading them.
+	 */
+	void setDecodeThreads(std::size_t threads);
+	/**
+	 * @brief Returns the amount of threads deserializing the records of GET
+	 * responses.
+	 */
+	std::size_t decodeThreads() const { return mDecodePool ? mDecodePool->size() : 0; }
+	/**
+	 * @brief Queues a deserialization task for the decoding threads, which
+	 * must be enabled.
+	 * @param task The task.
+	 */
+	void submitDecodeTask(std::function<void()> task) { mDecodePool->submit(std::move(task)); }
+	/**
+	 * @brief Predicts the amount of records of a GET response of a
+	 * key-interval from the responses of the same shape.
+	 * @see `RecordCountPredictor::predict()`
+	 */
+	bool predictGetRecords(const Key& keyMin, const Key& keyMax, std::size_t& oRecords) const
+	{
+		return mGetRecords.predict(keyMin, keyMax, oRecords);
+	}
+	/** @brief Counts the records of a GET response of a key-interval. */
+	void countGetRecords(const Key& keyMin, const Key& keyMax, const std::size_t records)
+	{
+		mGetRecords.record(keyMin, keyMax, records);
+	}
+	/** @brief Helps the decoding threads until all queued tasks have finished. */
+	void waitDecodeTasks() { mDecodePool->wait(); }
+	/**
+	 * @brief Sets the amount of threads serializing the records of PUT/A
+	 * requests.
+	 * @see `Channel::setEncodeThreads()`
+	 * @param threads The amount of threads, `0` to serialize the records on
+	 * the thread sending them.
+	 */
+	void setEncodeThreads(std::size_t threads);
+	/**
+	 * @brief Returns the amount of threads serializing the records of PUT/A
+	 * requests.
+	 */
+	std::size_t encodeThreads() const { return mEncodePool ? mEncodePool->size() : 0; }
+	/**
+	 * @brief Queues a serialization task for the encoding threads, which must
+	 * be enabled.
+	 * @param task The task.
+	 */
+	void submitEncodeTask(std::function<void()> task) { mEncodePool->submit(std::move(task)); }
+	/** @brief Helps the encoding threads until all queued tasks have finished. */
+	void waitEncodeTasks() { mEncodePool->wait(); }
 	/**
 	 * @brief Sets the target address/port pair of the underlying socket.
 	 * @see `Channel::setHost()`
@@ -398,20 +896,213 @@ public:
 		mSocket.setHost(addr, port);
 	}
 	/**
-	 * @brief Sets the new size of the internal buffer.
+	 * @brief Sets the time the resolved addresses of the target are reused
+	 * for.
+	 * @see `Channel::setAddressCacheTtl()`
+	 * @param ttlMs The time in milliseconds, `0` to disable the cache.
+	 */
+	void setAddressCacheTtlMs(std::uint32_t ttlMs) { mSocket.setAddressCacheTtlMs(ttlMs); }
+	/**
+	 * @brief Sets the new size of both the send and the receive buffer.
+	 *
+	 * @see `Channel::setMemoryLimit()`
+	 * @param memoryLimitBytes The new size of the buffers in bytes.
+	 */
+	void setMemoryLimit(std::size_t memoryLimitBytes)
+	{
+		setSendMemoryLimit(memoryLimitBytes);
+		setReceiveMemoryLimit(memoryLimitBytes);
+	}
+	/**
+	 * @brief Sets the new size of the send buffer.
 	 *
-	 * After a successful call to this method it is guaranteed that the internal
-	 * buffer will have the size of exactly `memoryLimitBytes` whenever it is
-	 * active.
+	 * The buffer is allocated with this size by the first request sent after
+	 * `connect()`, or after the size has changed, and released by `close()`.
 	 *
-	 * The buffer is active only in the interval between `connect()` and the
-	 * subsequent `close()`. When inactive, the memory block holding the buffer
-	 * contents is not allocated.
+	 * @see `Channel::setSendMemoryLimit()`
+	 * @param memoryLimitBytes The new size of the send buffer in bytes.
+	 */
+	void setSendMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the new size of the receive buffer.
 	 *
-	 * @see `Channel::setMemoryLimit()`
-	 * @param memoryLimitBytes The new size of the internal buffer in bytes.
+	 * The buffer is allocated with this size by the first response received
+	 * after `connect()`, or after the size has changed, and released by
+	 * `close()`.
+	 *
+	 * @see `Channel::setReceiveMemoryLimit()`
+	 * @param memoryLimitBytes The new size of the receive buffer in bytes.
 	 */
-	void setMemoryLimit(std::size_t memoryLimitBytes);
+	void setReceiveMemoryLimit(std::size_t memoryLimitBytes);
+	/**
+	 * @brief Sets the amount of send buffers used by PUT/A requests.
+	 *
+	 * For `depth <= 1`, buffers are flushed synchronously. Otherwise, up to
+	 * `depth - 1` full buffers are written by a background thread while the
+	 * next one is being filled. Each of the buffers has the size set by
+	 * `setSendMemoryLimit()`. The change takes effect with the next buffer
+	 * flush.
+	 *
+	 * @see `Channel::setPutPipelineDepth()`
+	 * @param depth The total amount of send buffers.
+	 */
+	void setPutPipelineDepth(std::size_t depth);
+	/**
+	 * @brief Enables or disables merging of PUT/A batches sharing a CID
+	 * before each send buffer is sent.
+	 *
+	 * @see `Channel::setPutBatchCoalescing()`
+	 * @param enabled `true` to merge the batches, `false` otherwise.
+	 */
+	void setPutBatchCoalescing(bool enabled);
+	/**
+	 * @brief Marks the keys of the records written next as validated up
+	 * front, so that only their payload sizes are checked record by record.
+	 *
+	 * @see `Channel::setPutBulkKeyValidation()`
+	 * @param validated `true` if the keys have been validated, `false` to
+	 * check them again.
+	 */
+	void setPutKeysValidated(const bool validated) { mPutKeysValidated = validated; }
+	/**
+	 * @brief Sets the capacity the receive buffer may grow to while
+	 * receiving a response.
+	 *
+	 * With a `maxMemoryLimitBytes` greater than the receive memory limit, a
+	 * record larger than the limit is made room for by growing the buffer
+	 * geometrically, up to `maxMemoryLimitBytes`. The buffer is shrunk back to
+	 * the limit once the response is read, or at the start of the next
+	 * request.
+	 *
+	 * @see `Channel::setReceiveBufferGrowth()`
+	 * @param maxMemoryLimitBytes The largest capacity of the buffer, or `0` to
+	 * disable the growth.
+	 */
+	void setReceiveBufferGrowth(std::size_t maxMemoryLimitBytes)
+	{
+		mMaxMemoryLimit = maxMemoryLimitBytes;
+	}
+	/**
+	 * @brief Sets the bounds of the buffer sizes derived from the measured
+	 * bandwidth-delay product of the connection.
+	 *
+	 * Once enabled, every command which leaves the channel idle ends a
+	 * transfer of `mBandwidth`, after which `tuneBuffers()` resizes the
+	 * buffers. Disabling the tuning drops the samples and sizes the buffers
+	 * back to the memory limits; kernel buffers already sized stay so until
+	 * the next connection.
+	 *
+	 * @see `Channel::setBufferAutoTuning()`
+	 * @param tuning The bounds.
+	 */
+	void setBufferAutoTuning(const BufferAutoTuning& tuning);
+	/**
+	 * @brief Sets the flow control of PUT/A requests.
+	 *
+	 * Disabling it drops the pacing rate and the bound of the command size,
+	 * but keeps the count of back-offs.
+	 *
+	 * @see `Channel::setPutFlowControl()`
+	 * @param options The settings.
+	 */
+	void setPutFlowControl(const PutFlowControl& options);
+	/**
+	 * @brief Sets the filter of the PUTA records acknowledged already.
+	 * @see `Channel::setPutDedupFilter()`
+	 * @param filter The filter, or `nullptr` for none.
+	 */
+	void setPutDedupFilter(std::shared_ptr<PutDedupFilter> filter)
+	{
+		mDedup = std::move(filter);
+		mDedupPending.clear();
+	}
+	/**
+	 * @brief Sets when the buffers of an idle channel are handed to the
+	 * process-wide buffer pool.
+	 *
+	 * @see `Channel::setBufferRelease()`
+	 * @param idle The time the channel has to stay idle for, `0` to release
+	 * the buffers right after each command, or negative to keep them until
+	 * `close()`.
+	 */
+	void setBufferRelease(std::chrono::milliseconds idle);
+	/**
+	 * @brief Sets the huge pages and the NUMA node of the send and receive
+	 * buffers.
+	 *
+	 * Buffers allocated already are released, to be allocated anew by the
+	 * next request which uses them.
+	 *
+	 * @see `Channel::setBufferAllocation()`
+	 * @param allocation The allocation of the buffers.
+	 */
+	void setBufferAllocation(const BufferAllocation& allocation);
+	/**
+	 * @brief Sets the memory budget the buffers draw their quota from.
+	 *
+	 * The buffers held are released, giving their quota back to the former
+	 * budget.
+	 *
+	 * @see `Channel::setMemoryBudget()`
+	 * @param budget The budget, or `nullptr` for none.
+	 */
+	void setMemoryBudget(std::shared_ptr<MemoryBudget> budget);
+	/**
+	 * @brief Sets the amount of bytes kept by the process-wide buffer pool.
+	 * @see `Channel::setBufferPoolLimit()`
+	 * @param limitBytes The limit in bytes.
+	 */
+	static void setBufferPoolLimit(std::size_t limitBytes)
+	{
+		BufferPool::setSharedLimit(limitBytes);
+	}
+
+	/**
+	 * @brief Validates the key and payload size of a record to be sent with
+	 * the PUT/A protocol.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::INVALID_KEY`
+	 *  - `result_t::PAYLOAD_TOO_LARGE`
+	 *
+	 * @tparam PutProtocol A protocol tag.
+	 * @param key The key of the record.
+	 * @param payloadSize Payload size in bytes.
+	 * @return The status code.
+	 */
+	template<BatchSerializer::ProtoT PutProtocol>
+	static result_t checkPutRecord(const Key& key, std::size_t payloadSize);
+	/**
+	 * @brief Validates a record written by this channel, leaving the key out
+	 * if it has been validated up front (see `setPutKeysValidated()`).
+	 *
+	 * The possible error codes are those of `checkPutRecord()`.
+	 *
+	 * @tparam PutProtocol A protocol tag.
+	 * @param key The key of the record.
+	 * @param payloadSize Payload size in bytes.
+	 * @return The status code.
+	 */
+	template<BatchSerializer::ProtoT PutProtocol>
+	result_t checkNextPutRecord(const Key& key, const std::size_t payloadSize) const
+	{
+		if (mPutKeysValidated) {
+			return payloadSize > cMaxPayloadSize ? result_t::PAYLOAD_TOO_LARGE : result_t::OK;
+		}
+		return checkPutRecord<PutProtocol>(key, payloadSize);
+	}
+	/**
+	 * @brief Validates the key range of a GET or GETACQ request.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::EMPTY_KEY_RANGE`
+	 *  - `result_t::INVALID_KEY`
+	 *
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @return The status code.
+	 */
+	static result_t checkKeyRange(const Key& keyMin, const Key& keyMax);
 
 private:
 
@@ -448,6 +1139,22 @@ private:
 	 * @return The status code.
 	 */
 	result_t writeKeyPairHeader(CommandType cmdId, const Key& keyMin, const Key& keyMax);
+	/**
+	 * @brief Serializes a request header for command `cmdId` with an attached
+	 * key-interval, appending it to the requests queued since the last
+	 * `flushRequests()`.
+	 *
+	 * The buffer is sent once it can't fit another request. An invalid
+	 * key-interval is rejected without affecting the queued requests.
+	 *
+	 * The possible error codes are those of `writeKeyPairHeader()`.
+	 *
+	 * @param cmdId Command ID (see `Headers.h`).
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @return The status code.
+	 */
+	result_t queueKeyPairHeader(CommandType cmdId, const Key& keyMin, const Key& keyMax);
 	/**
 	 * @brief Serializes and sends a request header for command `cmdId` without
 	 * additional data.
@@ -479,11 +1186,11 @@ private:
 	 * the memory block might corrupt the whole request, so it is well-advised to
 	 * handle the buffer with extra care.
 	 *
-	 * The requested amount of bytes might not be available inside the internal
+	 * The requested amount of bytes might not be available inside the send
 	 * buffer at the time of the method call. In this case, the method checks
 	 * whether it exceeds the total buffer capacity; in this case,
 	 * `result_t::MEMORY_LIMIT_EXCEEDED` is returned. Otherwise, in case the
-	 * internal buffer is about to overflow but the requested amount of bytes
+	 * send buffer is about to overflow but the requested amount of bytes
 	 * would be available if the buffer was empty, it ends the current data batch
 	 * and sends it over to TStorage, discarding the buffer's content and
 	 * enabling its reuse.
@@ -513,7 +1220,7 @@ private:
 		std::size_t keySize);
 
 	/**
-	 * @brief Flushes the content of the internal buffer to the connected
+	 * @brief Flushes the content of the send buffer to the connected
 	 * TStorage instance.
 	 *
 	 * The possible error codes are:
@@ -527,10 +1234,119 @@ private:
 	 * @return The status code.
 	 */
 	result_t sendBuffer();
+	/**
+	 * @brief Flushes the content of the send buffer followed by
+	 * `payloadSize` bytes of `payload` in a single scatter/gather send.
+	 *
+	 * The possible error codes are the same as for `sendBuffer()`.
+	 *
+	 * @param payload The memory block to send after the buffer content.
+	 * @param payloadSize The length of the memory block.
+	 * @return The status code.
+	 */
+	result_t sendBufferWith(const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief Flushes the PUT/A records of the send buffer with
+	 * `flushBuffer()`, paced and timed by the flow control.
+	 * @return The status code.
+	 */
+	result_t flushPutBuffer();
+	/**
+	 * @brief Ends the current PUT/A command with its full send buffer, waits
+	 * for its result, and starts another command of the same type for the
+	 * records that follow.
+	 *
+	 * Used by `reservePayloadBuffer()` in place of a flush once the command
+	 * has taken as many buffers as the flow control lets it.
+	 *
+	 * @return The status code, `result_t::ERROR` if TStorage rejected the
+	 * ended command.
+	 */
+	result_t splitPutCommand();
+	/**
+	 * @brief Reads the response to a PUT/A command, counting its latency
+	 * since `writeFin()` by the flow control.
+	 * @see `readResponse()`
+	 * @return The status code.
+	 */
+	result_t readPutAck();
+	/**
+	 * @brief Waits for the pacing slot of a PUT/A send of `bytes` bytes, if
+	 * the flow control is enabled.
+	 * @return The time the send starts at, or the epoch if disabled.
+	 */
+	std::chrono::steady_clock::time_point pacePutSend(std::size_t bytes);
+	/**
+	 * @brief Counts a PUT/A send of `bytes` bytes started at `start` by the
+	 * flow control, if enabled and the send succeeded.
+	 * @param start The time returned by `pacePutSend()`.
+	 * @param bytes The amount of bytes sent.
+	 * @param status The result of the send, returned as is.
+	 * @return `status`.
+	 */
+	result_t countPutSend(std::chrono::steady_clock::time_point start,
+		std::size_t bytes,
+		result_t status);
+	/** @brief Copies the state of `mFlow` to the atomics read by
+	 * `stats()`. */
+	void publishFlowStats();
+	/**
+	 * @brief Returns `true` if `mDedup` holds the PUTA record, counting it
+	 * as skipped, and otherwise adds its fingerprint to `mDedupPending`.
+	 * Returns `false` without a filter.
+	 * @param key The key of the record.
+	 * @param payload The serialized payload.
+	 * @param payloadSize The size of the payload in bytes.
+	 */
+	bool skipsAcknowledged(const Key& key, const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief A common implementation of `writeNextPutRecordView()` and
+	 * `writeNextPutARecordView()`.
+	 *
+	 * @tparam PutProtocol A protocol tag.
+	 * @param key The key of the record.
+	 * @param payload The serialized payload.
+	 * @param payloadSize Payload size in bytes.
+	 * @return The status code.
+	 */
+	template<BatchSerializer::ProtoT PutProtocol>
+	result_t writeRecordView(const Key& key, const void* payload, std::size_t payloadSize);
+	/**
+	 * @brief A common implementation of `writeNextPutRecordPieces()` and
+	 * `writeNextPutARecordPieces()`.
+	 *
+	 * @tparam PutProtocol A protocol tag.
+	 * @param key The key of the record.
+	 * @param payloadSize Payload size in bytes.
+	 * @param fillPayload Serializes a piece of the payload.
+	 * @return The status code.
+	 */
+	template<BatchSerializer::ProtoT PutProtocol>
+	result_t writeRecordPieces(const Key& key,
+		std::size_t payloadSize,
+		const std::function<void(void*, std::size_t, std::size_t)>& fillPayload);
+	/**
+	 * @brief Flushes the content of the send buffer mid-request, either
+	 * synchronously or through the PUT/A pipeline.
+	 *
+	 * In pipelined mode, an error reported by this method might stem from one
+	 * of the previously flushed buffers.
+	 *
+	 * The possible error codes are those of `sendBuffer()` and
+	 * `result_t::OUT_OF_MEMORY`.
+	 *
+	 * @return The status code.
+	 */
+	result_t flushBuffer();
+	/**
+	 * @brief Waits for all pipelined sends to finish and returns their status.
+	 * @return The status code.
+	 */
+	result_t drainPipeline();
 	/**
 	 * @brief Makes sure that `amountBytes` of data is available to read inside
-	 * the internal buffer, fetching it from the connected TStorage instance if
-	 * necessary.
+	 * the receive buffer, fetching it from the connected TStorage instance if
+	 * necessary. Allocates the receive buffer if needed.
 	 *
 	 * The possible error codes are:
 	 *  - `result_t::BAD_RESPONSE`
@@ -539,6 +1355,7 @@ private:
 	 *  - `result_t::CONNTIMEOUT`
 	 *  - `result_t::MEMORY_LIMIT_EXCEEDED`
 	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::OUT_OF_MEMORY`
 	 *  - `result_t::SIGNAL`
 	 *
 	 * @param amountBytes Amount of bytes to make available to read.
@@ -547,7 +1364,7 @@ private:
 	result_t requestData(std::size_t amountBytes);
 	/**
 	 * @brief Ignores `amountBytes` of incoming data, skipping them inside the
-	 * internal buffer if present, then fetching and ignoring the rest.
+	 * receive buffer if present, then fetching and ignoring the rest.
 	 *
 	 * The possible error codes are:
 	 *  - `result_t::BAD_RESPONSE`
@@ -561,12 +1378,233 @@ private:
 	 * @return The status code.
 	 */
 	result_t skip(std::size_t amountBytes);
+	/**
+	 * @brief Makes at least the next record, or the end of the records,
+	 * available to read, then indexes all records buffered in full after it.
+	 *
+	 * Run by `readNextRecordData()` once the index runs out. A single
+	 * receive usually brings many small records, whose sizes are then
+	 * checked in a single pass over the buffer, so that the following calls
+	 * read the indexed records without requesting data again. The index
+	 * stops at the end of the records, at a partial record and at a record
+	 * of an invalid size, which is reported once it comes first.
+	 *
+	 * The possible error codes are those of `readNextRecordData()` but
+	 * `result_t::END_OF_STREAM`.
+	 *
+	 * @return The status code.
+	 */
+	result_t frameRecords();
+	/** @brief Makes room in the receive buffer for the records following a
+	 * payload read by `readPayloadChunk()`, which doesn't count towards the
+	 * memory limit. */
+	void compactAfterChunkedPayload()
+	{
+		if (mChunkedPayloadRead) {
+			mChunkedPayloadRead = false;
+			(void)reserveBuffer(mRecvBuffer.capacity() - mRecvBuffer.bytesAvailableToRead());
+		}
+	}
+	/** @brief Drops the index of `frameRecords()`, whose records the receive
+	 * buffer no longer holds. */
+	void dropFramedRecords()
+	{
+		mFramedSizes.clear();
+		mFramedNext = 0;
+	}
 
 	/**
-	 * @brief Discards the content of the internal buffer and resets state of
+	 * @brief Discards the content of the send buffer and resets state of
 	 * internal serializers.
 	 */
 	void resetState();
+	/**
+	 * @brief Discards the content of the receive buffer and shrinks it back
+	 * to the receive memory limit. Used when a request is started with no
+	 * responses awaited before it.
+	 */
+	void resetRecvBuffer();
+	/** @brief Obtains the send buffer if the channel has none, and returns
+	 * `false` if the allocation fails or the memory budget is spent. */
+	bool ensureSendBuffer()
+	{
+		return mSendBuffer.valid()
+			|| obtainBuffer(mSendBuffer, &BufferPool::Parking::send, mSendMemoryLimit);
+	}
+	/** @brief Obtains the receive buffer if the channel has none, and
+	 * returns `false` if the allocation fails or the memory budget is
+	 * spent. */
+	bool ensureRecvBuffer()
+	{
+		return mRecvBuffer.valid()
+			|| obtainBuffer(mRecvBuffer, &BufferPool::Parking::recv, mRecvMemoryLimit);
+	}
+	/**
+	 * @brief Draws quota for a buffer of `capacity` bytes from the memory
+	 * budget, then takes back the buffer parked by `endCommand()`, if the
+	 * background thread has not moved it to the pool yet, or a buffer from
+	 * the pool.
+	 * @param[out] oBuffer The buffer obtained.
+	 * @param parked The parking slot of the buffer.
+	 * @param capacity The capacity of the buffer.
+	 * @return `true` on success, `false` otherwise.
+	 */
+	bool obtainBuffer(
+		Buffer& oBuffer, Buffer BufferPool::Parking::*parked, std::size_t capacity);
+	/** @brief Takes a buffer of `capacity` bytes from the buffer pool, in the
+	 * layout suiting its size (see `cMirroredBufferThreshold`) and with
+	 * `mBufferAllocation`. */
+	Buffer acquireBuffer(std::size_t capacity);
+	/** @brief Gives the quota of a buffer back, and hands the buffer to the
+	 * buffer pool if the buffer release is enabled, or frees it otherwise. */
+	void dropBuffer(Buffer& buffer);
+	/** @brief Drops the send and the receive buffer, parked or not. */
+	void dropBuffers();
+	/** @brief Hands the buffers parked by `endCommand()` to the buffer pool,
+	 * if the background thread has not moved them there yet. */
+	void dropParkedBuffers();
+	/** @brief Destroys `mSender`, giving the quota of its buffers back. */
+	void dropSender();
+	/** @brief Draws `bytes` of quota from the memory budget, if any, waiting
+	 * up to the socket timeout. Returns `false` if none was drawn. */
+	bool chargeBudget(std::size_t bytes);
+	/** @brief Gives `bytes` of quota back to the memory budget, if any. */
+	void refundBudget(std::size_t bytes);
+	/**
+	 * @brief Tunes the buffers, if enabled by `setBufferAutoTuning()`, then
+	 * releases or parks them once a command has been read to its end, as set
+	 * by `setBufferRelease()`.
+	 *
+	 * Does nothing while responses are awaited, requests are queued, or
+	 * unread data is buffered.
+	 *
+	 * @param status The result of the command, returned as is.
+	 * @return `status`.
+	 */
+	result_t endCommand(result_t status);
+	/**
+	 * @brief Samples the transfer just ended and, if the bandwidth-delay
+	 * product has moved far enough, resizes the buffers to it.
+	 *
+	 * The tuned size is twice the product, so that a transfer limited by the
+	 * buffers still shows the path has room, rounded up to a power of two and
+	 * capped by `BufferAutoTuning::maxBytes`. The buffers grow as soon as it
+	 * rises, but shrink only once it falls to a quarter, so that noisy samples
+	 * don't make them flap. Called by `endCommand()` with the channel idle.
+	 */
+	void tuneBuffers();
+	/** @brief Sizes the send buffer to the larger of `mSendMemoryFloor` and
+	 * `mTunedBufferSize`, dropping a buffer of another size. */
+	void applySendMemoryLimit();
+	/** @brief Sizes the receive buffer to the larger of `mRecvMemoryFloor`
+	 * and `mTunedBufferSize`, dropping a buffer of another size. */
+	void applyRecvMemoryLimit();
+	/**
+	 * @brief Grows the receive buffer so that `amountBytes` of incoming data
+	 * fit in it, moving its unread content to the start.
+	 *
+	 * The capacity is doubled until it is at least `amountBytes`, but is never
+	 * greater than `mMaxMemoryLimit`. A buffer that is large enough already is
+	 * only compacted.
+	 *
+	 * @param amountBytes Amount of bytes to make room for, counting the bytes
+	 * available to read.
+	 * @return `true` if the buffer has room for `amountBytes`, `false`
+	 * otherwise.
+	 */
+	bool growBuffer(std::size_t amountBytes);
+	/**
+	 * @brief Shrinks the receive buffer back to `mRecvMemoryLimit` bytes if it
+	 * has grown and its unread content fits.
+	 */
+	void shrinkBuffer();
+	/**
+	 * @brief Ends the current PUT/A batch and, with batch coalescing enabled,
+	 * merges the batches of the buffer sharing a CID.
+	 *
+	 * Used right before a buffer holding PUT/A batches is sent. Leaves the
+	 * buffer with no open batch.
+	 */
+	void endPutBatches();
+
+	/** @brief Counts the PUT/A batch started by the record with `key`, if
+	 * any. Used right before the record is appended to `mBatch`. */
+	void countPutBatch(const Key& key)
+	{
+		if (mBatch.getNextRecordOffset(key.cid) != 0) {
+			mPutBatches.add(1);
+		}
+	}
+	/** @brief Counts a buffer of `capacity` bytes allocated by the channel. */
+	void countAllocation(const std::size_t capacity)
+	{
+		mBufferAllocations.add(1);
+		mBufferBytesAllocated.add(capacity);
+	}
+	/** @brief Returns the syscalls and buffer allocations made by the channel
+	 * so far. */
+	CommandCosts currentCosts() const;
+	/** @brief Attempts to reserve `targetSize` bytes in `mRecvBuffer`,
+	 * counting the bytes moved. See `Buffer::reserve()`. */
+	bool reserveBuffer(const std::size_t targetSize)
+	{
+		std::size_t bytesMoved{};
+		const bool reserved = mRecvBuffer.reserve(targetSize, bytesMoved);
+		mBufferBytesMoved.add(bytesMoved);
+		return reserved;
+	}
+	/**
+	 * @brief Starts timing a request sent after all the responses awaited so
+	 * far.
+	 * @param cmdId The command of the request.
+	 */
+	void startRequest(CommandType cmdId)
+	{
+		TSTORAGE_PROBE1(command__start, cmdId);
+		const auto now = std::chrono::steady_clock::now();
+		mPending.push_back(PendingRequest{cmdId, now});
+		if (mAutoTuning.enabled) {
+			mBandwidth.start(now, mSocket.bytesTransferred());
+		}
+	}
+	/** @brief Returns the command of the oldest request awaiting its
+	 * response, `0` if none. */
+	std::int32_t pendingCommand() const
+	{
+		return mPendingHead < mPending.size() ? mPending[mPendingHead].cmdId : 0;
+	}
+	/**
+	 * @brief Counts the latency of the oldest request awaiting its response,
+	 * if any, once its result has been read, and reports its trace if traced.
+	 * @param status `result_t::OK`, or `result_t::ERROR` if TStorage reported
+	 * an error.
+	 */
+	void finishRequest(result_t status);
+	/** @brief Stops timing all requests awaiting their responses. */
+	void dropRequests()
+	{
+		mPending.clear();
+		mPendingHead = 0;
+		mTraceActive = false;
+	}
+	/** @brief Returns `true` if the current request is being traced. */
+	bool tracing() const { return cTracingBuilt && mTraceActive; }
+	/** @brief Starts tracing the request just written, if there is a tracer.
+	 * It has to be the only request awaiting its response. */
+	void startTrace(CommandType cmdId);
+	/** @brief Marks the end of the sending phase of the traced request, if
+	 * any, after a successful send. */
+	void traceSent()
+	{
+		if (tracing()) {
+			mTrace.sent = std::chrono::steady_clock::now();
+		}
+	}
+	/**
+	 * @brief Accounts a receive of the traced request, which started at
+	 * `recvStart`, to its waiting or records phase.
+	 */
+	void traceRecv(std::chrono::steady_clock::time_point recvStart);
 
 
 	/****************
@@ -574,35 +1612,94 @@ private:
 	 */
 
 	/**
-	 * @brief The internal buffer object.
+	 * @brief The policy of retrying failed requests.
+	 */
+	RetryPolicy mRetryPolicy;
+	/** @brief The source of the jitter of retry backoffs. */
+	std::minstd_rand mRetryRng;
+	/**
+	 * @brief Set if failed requests may reconnect, i.e. the channel was
+	 * connected with `connect()` and not closed with `close()` since.
+	 */
+	bool mReconnectable;
+	/**
+	 * @brief The buffer the requests are serialized into.
+	 *
+	 * Remains unallocated until the first request after `connect()`. After
+	 * that, it owns a memory block of length `mSendMemoryLimit` until
+	 * subsequent `close()`, which resets the buffer object to its initial
+	 * state.
+	 */
+	Buffer mSendBuffer;
+	/**
+	 * @brief The buffer the responses are received into.
 	 *
-	 * Remains uninitialized until the first call to `connect()`. After that, it
-	 * owns a memory block of length `mMemoryLimit` until subsequent `close()`,
-	 * which resets the buffer object to its initial state.
+	 * Remains unallocated until the first response after `connect()`. After
+	 * that, it owns a memory block of length `mRecvMemoryLimit`, or larger
+	 * while grown (see `setReceiveBufferGrowth()`), until subsequent
+	 * `close()`.
 	 */
-	Buffer mBuffer;
+	Buffer mRecvBuffer;
+	/**
+	 * @brief The sizes of the records indexed by `frameRecords()`, which
+	 * follow each other from the read location of `mRecvBuffer` on, `0` for
+	 * the end of the records.
+	 */
+	std::vector<std::uint32_t> mFramedSizes;
+	/** @brief The index in `mFramedSizes` of the next record to be read. */
+	std::size_t mFramedNext;
+	/** @brief `true` once `readPayloadChunk()` has returned the last chunk of
+	 * a payload, until the receive buffer is compacted. */
+	bool mChunkedPayloadRead;
 	/**
 	 * @brief A Socket object managing network I/O.
 	 *
 	 * Used for talking with TStorage instance. Explicit sends and receives using
 	 * this object are found only in `sendBuffer()`, `requestData()` and
-	 * `skip()` methods.
+	 * `skip()` methods, and in the `mSender` thread.
 	 */
 	Socket mSocket;
 	/**
-	 * @brief A hint used to suggest a size of the payload buffer block that is
+	 * @brief A background writer of full PUT/A buffers.
+	 *
+	 * Created on the first pipelined flush and destroyed on `close()`,
+	 * `abort()` or a change of the pipeline depth. Declared after `mSocket` so
+	 * that its thread is joined before the socket is destroyed.
+	 */
+	std::unique_ptr<PipelinedSender> mSender;
+	/**
+	 * @brief The quota drawn for the spare buffers of `mSender`.
+	 */
+	std::size_t mSenderCharge;
+	/**
+	 * @brief A predictor of the size of the payload buffer block that is
 	 * likely to accomodate the whole payload after serialization when the actual
 	 * size of the payload byte-stream is not known.
 	 *
-	 * It is equal to the maximum of `cInitialExpectedPayloadSize` and the
-	 * maximal payload size encountered during the lifetime of the Channel.
+	 * Counts the sizes of all payloads written to the buffer during the
+	 * lifetime of the Channel.
 	 *
 	 * @see `obtainPutPayloadBuffer()`
 	 * @see `obtainPutAPayloadBuffer()`
 	 */
-	std::size_t mExpectedPayloadSize;
+	PayloadSizePredictor mPayloadSizes;
+	/**
+	 * @brief A history of the amounts of records of GET responses, by the
+	 * shape of their key-intervals.
+	 *
+	 * @see `predictGetRecords()`
+	 */
+	RecordCountPredictor mGetRecords;
 	/**
-	 * @brief The size of the internal buffer in bytes.
+	 * @brief The size of the send buffer in bytes.
+	 *
+	 * It limits the size of a single record sent as part of a PUT/A request.
+	 *
+	 * @see `Channel::put()`
+	 */
+	std::size_t mSendMemoryLimit;
+	/**
+	 * @brief The size of the receive buffer in bytes.
 	 *
 	 * It limits the total size of the response to the `get()` query and the size
 	 * of a single batch of records received as part of the `getStream()` query.
@@ -610,12 +1707,209 @@ private:
 	 * @see `Channel::get()`
 	 * @see `Channel::getStream()`
 	 */
-	std::size_t mMemoryLimit;
+	std::size_t mRecvMemoryLimit;
+	/** @brief The size of the send buffer set by `setSendMemoryLimit()`,
+	 * the smallest `mSendMemoryLimit` the buffer auto-tuning picks. */
+	std::size_t mSendMemoryFloor;
+	/** @brief The size of the receive buffer set by
+	 * `setReceiveMemoryLimit()`, the smallest `mRecvMemoryLimit` the buffer
+	 * auto-tuning picks. */
+	std::size_t mRecvMemoryFloor;
+	/**
+	 * @brief The bounds of the buffer auto-tuning.
+	 * @see `setBufferAutoTuning()`
+	 */
+	BufferAutoTuning mAutoTuning;
+	/** @brief The estimate of the bandwidth-delay product the buffers are
+	 * tuned to. */
+	BandwidthEstimator mBandwidth;
+	/** @brief The buffer size picked by the auto-tuning, `0` if none. */
+	std::size_t mTunedBufferSize;
+	/** @brief The kernel buffer size set on the connection by the
+	 * auto-tuning, `0` if none. */
+	std::size_t mTunedSocketBufferSize;
+	/** @brief `mBandwidth.bdpBytes()`, for `stats()` to read from any
+	 * thread. */
+	std::atomic<std::uint64_t> mBdpBytes;
+	/**
+	 * @brief The flow control of PUT/A requests.
+	 * @see `setPutFlowControl()`
+	 */
+	PutFlowController mFlow;
+	/** @brief The amount of send buffers flushed by the current PUT/A
+	 * command. */
+	std::size_t mPutCommandBuffers;
+	/** @brief The time the end of the last PUT/A command was sent at. */
+	std::chrono::steady_clock::time_point mFinSent;
+	/** @brief `mFlow.rate()`, for `stats()` to read from any thread. */
+	std::atomic<std::uint64_t> mPutPacingRate;
+	/** @brief `mFlow.commandBuffers()`, for `stats()` to read from any
+	 * thread. */
+	std::atomic<std::uint64_t> mPutCommandBufferLimit;
+	/** @brief `mFlow.backoffs()`, for `stats()` to read from any thread. */
+	std::atomic<std::uint64_t> mPutBackoffs;
+	/**
+	 * @brief The filter of the PUTA records acknowledged already, if any.
+	 * @see `setPutDedupFilter()`
+	 */
+	std::shared_ptr<PutDedupFilter> mDedup;
+	/** @brief The fingerprints of the records of the current PUTA command,
+	 * added to `mDedup` once it is acknowledged. */
+	std::vector<std::uint64_t> mDedupPending;
+	/** @brief The payload block returned last by `reservePayloadBuffer()`,
+	 * which `writeNextPutARecord()` fingerprints. */
+	const void* mReservedPayload;
+	/**
+	 * @brief The capacity the receive buffer may grow to while receiving a
+	 * record that doesn't fit in it, or `0` if it never grows.
+	 *
+	 * @see `setReceiveBufferGrowth()`
+	 */
+	std::size_t mMaxMemoryLimit;
+	/**
+	 * @brief The pool the buffers are taken from and released to.
+	 */
+	std::shared_ptr<BufferPool> mBufferPool;
+	/**
+	 * @brief The time the channel has to stay idle for before its buffers are
+	 * released, `0` to release them after each command, negative to keep
+	 * them.
+	 */
+	std::chrono::milliseconds mBufferRelease;
+	/**
+	 * @brief The huge pages and the NUMA node of the send and receive
+	 * buffers.
+	 */
+	BufferAllocation mBufferAllocation;
+	/**
+	 * @brief The buffers parked by an idle channel, watched by the pool.
+	 * Created with the first positive `mBufferRelease`.
+	 */
+	std::shared_ptr<BufferPool::Parking> mParking;
+	/**
+	 * @brief The memory budget the buffers draw their quota from, if any.
+	 *
+	 * The send and the receive buffer are charged while the channel holds
+	 * them, the receive buffer with its growth, and so are the spare buffers
+	 * of `mSender`. Parked and pooled buffers are not.
+	 */
+	std::shared_ptr<MemoryBudget> mBudget;
+	/**
+	 * @brief The total amount of send buffers used by PUT/A requests.
+	 * @see `setPutPipelineDepth()`
+	 */
+	std::size_t mPutPipelineDepth;
+	/**
+	 * @brief Whether the PUT/A batches sharing a CID are merged before a
+	 * buffer is sent.
+	 * @see `setPutBatchCoalescing()`
+	 */
+	bool mCoalescePutBatches;
+	/**
+	 * @brief Whether the keys of the records written next have been
+	 * validated up front.
+	 * @see `setPutKeysValidated()`
+	 */
+	bool mPutKeysValidated;
+	/**
+	 * @brief The offset of the first PUT/A batch inside the buffer, past the
+	 * request header in the first buffer of a request and `0` otherwise.
+	 */
+	std::size_t mPutBatchesOffset;
+	/**
+	 * @brief The buffer the merged batches are written to, swapped with
+	 * `mSendBuffer` afterwards. Allocated on first use, released on `close()`.
+	 */
+	Buffer mCoalesceBuffer;
+	/** @brief Scratch space of `BatchSerializer::coalesce()`. */
+	std::vector<BatchSerializer::BatchSpan> mBatchSpans;
+	/**
+	 * @brief `true` if the output buffer holds requests appended by
+	 * `queueKeyPairHeader()` since the last `flushRequests()`.
+	 */
+	bool mRequestsQueued;
 	/**
 	 * @brief An object tracking the current PUT/A batch state inside the send
 	 * buffer and managing overall single-batch serialization.
 	 */
 	BatchSerializer mBatch;
+
+	/** @brief A request awaiting its response. */
+	struct PendingRequest
+	{
+		/** @brief The command of the request. */
+		CommandType cmdId;
+		/** @brief The time the request was started at. */
+		std::chrono::steady_clock::time_point start;
+	};
+	/**
+	 * @brief The requests awaiting their responses, in the order they were
+	 * sent, starting at `mPendingHead`.
+	 *
+	 * Cleared once all of them finish, which keeps its capacity between
+	 * requests.
+	 */
+	std::vector<PendingRequest> mPending;
+	/** @brief The index of the oldest request in `mPending`. */
+	std::size_t mPendingHead;
+	/** @brief The latencies of GET requests. */
+	LatencyRecorder mGetLatency;
+	/** @brief The latencies of GETACQ requests. */
+	LatencyRecorder mGetAcqLatency;
+	/** @brief The latencies of PUT requests. */
+	LatencyRecorder mPutLatency;
+	/** @brief The latencies of PUTA requests. */
+	LatencyRecorder mPutALatency;
+	/** @brief The number of PUT/A batches started. */
+	Counter mPutBatches;
+	/** @brief The number of buffers sent in the middle of PUT/A requests to
+	 * make room for the next record. */
+	Counter mPutBufferFlushes;
+	/** @brief The amount of bytes moved by `reserveBuffer()`. */
+	Counter mBufferBytesMoved;
+	/** @brief The number of PUTA records skipped by `mDedup`. */
+	Counter mPutRecordsSkipped;
+	/** @brief The number of buffers allocated by the channel. */
+	Counter mBufferAllocations;
+	/** @brief The total size of the buffers allocated by the channel. */
+	Counter mBufferBytesAllocated;
+	/** @brief The costs of GET requests. */
+	CostRecorder mGetCosts;
+	/** @brief The costs of GETACQ requests. */
+	CostRecorder mGetAcqCosts;
+	/** @brief The costs of PUT requests. */
+	CostRecorder mPutCosts;
+	/** @brief The costs of PUTA requests. */
+	CostRecorder mPutACosts;
+	/** @brief The costs already charged to requests, or dropped at the last
+	 * connect. */
+	CommandCosts mCharged;
+	/** @brief The tracer of connects and requests, if any. */
+	std::shared_ptr<Tracer> mTracer;
+	/**
+	 * @brief The trace of the current request, valid if `mTraceActive`.
+	 *
+	 * While the request is in progress, `bytesSent` and `bytesReceived` hold
+	 * the socket's counters at its start.
+	 */
+	RequestTrace mTrace;
+	/** @brief `true` if the current request is being traced. */
+	bool mTraceActive;
+	/** @brief The threads deserializing the records of GET responses, if
+	 * enabled. */
+	std::unique_ptr<WorkerPool> mDecodePool;
+	/** @brief The threads serializing the records of PUT/A requests, if
+	 * enabled. */
+	std::unique_ptr<WorkerPool> mEncodePool;
+	/**
+	 * @brief The chunks of records serialized on the encoding threads.
+	 *
+	 * Kept between requests so that their segments are reused, and released
+	 * on `close()`.
+	 */
+	std::vector<std::unique_ptr<PutChunk>> mPutChunks;
+	/** @brief Scratch space of `writePutChunks()`. */
+	std::vector<struct iovec> mPutChunksIov;
 };
 
 
@@ -633,31 +1927,53 @@ result_t ChannelImpl::writeGetAcqRequest(const Key& keyMin, const Key& keyMax)
 	return writeKeyPairHeader(CommandType::GETACQ, keyMin, keyMax);
 }
 
+result_t ChannelImpl::queueGetRequest(const Key& keyMin, const Key& keyMax)
+{
+	return queueKeyPairHeader(CommandType::GET, keyMin, keyMax);
+}
+
+result_t ChannelImpl::queueGetAcqRequest(const Key& keyMin, const Key& keyMax)
+{
+	return queueKeyPairHeader(CommandType::GETACQ, keyMin, keyMax);
+}
+
 result_t ChannelImpl::writePutHeader()
 {
 	const result_t res = writeEmptyHeader(CommandType::PUT);
+	if (res != result_t::OK) {
+		return res;
+	}
 	mBatch.endBatch();
+	mPutBatchesOffset = mSendBuffer.bytesAvailableToRead();
+	mPutCommandBuffers = 0;
+	mDedupPending.clear();
 	return res;
 }
 
 result_t ChannelImpl::writePutAHeader()
 {
 	const result_t res = writeEmptyHeader(CommandType::PUTA);
+	if (res != result_t::OK) {
+		return res;
+	}
 	mBatch.endBatch();
+	mPutBatchesOffset = mSendBuffer.bytesAvailableToRead();
+	mPutCommandBuffers = 0;
+	mDedupPending.clear();
 	return res;
 }
 
 result_t ChannelImpl::obtainPutPayloadBuffer(
 	void*& oPayloadBuffer, std::size_t& oBufferSize, const Key& key)
 {
-	return reservePayloadBuffer(oPayloadBuffer, oBufferSize, mExpectedPayloadSize, key,
+	return reservePayloadBuffer(oPayloadBuffer, oBufferSize, mPayloadSizes.predict(), key,
 		Serializer::cAbbrevKeySizeWithoutAcq);
 }
 
 result_t ChannelImpl::obtainPutAPayloadBuffer(
 	void*& oPayloadBuffer, std::size_t& oBufferSize, const Key& key)
 {
-	return reservePayloadBuffer(oPayloadBuffer, oBufferSize, mExpectedPayloadSize, key,
+	return reservePayloadBuffer(oPayloadBuffer, oBufferSize, mPayloadSizes.predict(), key,
 		Serializer::cAbbrevKeySize);
 }
 
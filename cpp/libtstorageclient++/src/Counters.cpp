@@ -0,0 +1,42 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * Counters.cpp
+ *   Statistics counters readable while they are being updated.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Counters.h"
+
+#include <cstddef>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace impl {
+
+void LatencyRecorder::snapshot(LatencyHistogram& oHistogram) const
+{
+	for (std::size_t bucket = 0; bucket < LatencyHistogram::cBuckets; ++bucket) {
+		oHistogram.counts[bucket] = mCounts[bucket].value();
+	}
+	oHistogram.count = mCount.value();
+	oHistogram.totalUs = mTotalUs.value();
+	oHistogram.maxUs = mMaxUs.value();
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
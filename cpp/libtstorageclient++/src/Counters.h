@@ -0,0 +1,157 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * Counters.h
+ *   Statistics counters readable while they are being updated.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_COUNTERS_PH
+#define D_TSTORAGE_COUNTERS_PH
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines the counters behind `Channel::stats()`. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief A counter updated by one thread at a time and read by any.
+ *
+ * The updates of a channel's counters are ordered by the channel itself: its
+ * requests are issued by one thread at a time, and the sends of the PUT/A
+ * pipeline are drained before the next request. The counter therefore does
+ * without atomic read-modify-write operations and their bus locks: an update
+ * is a relaxed load and store, i.e. a plain increment of a word, while readers
+ * on other threads see each value whole.
+ */
+class Counter
+{
+public:
+	/** @brief Constructs a zero counter. */
+	Counter()
+		: mValue(0)
+	{
+	}
+
+	Counter(const Counter&) = delete;
+	Counter& operator=(const Counter&) = delete;
+
+	/** @brief Adds `amount` to the counter. */
+	void add(const std::uint64_t amount)
+	{
+		mValue.store(mValue.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+	/** @brief Raises the counter to `value` if it is smaller. */
+	void raise(const std::uint64_t value)
+	{
+		if (value > mValue.load(std::memory_order_relaxed)) {
+			mValue.store(value, std::memory_order_relaxed);
+		}
+	}
+	/** @brief Returns the value of the counter. */
+	std::uint64_t value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+	/** @brief The value. */
+	std::atomic<std::uint64_t> mValue;
+};
+
+/**
+ * @brief Counts latencies in a `LatencyHistogram`, under the threading rules
+ * of `Counter`.
+ */
+class LatencyRecorder
+{
+public:
+	/** @brief Counts a latency. */
+	void record(const std::uint64_t latencyUs)
+	{
+		mCounts[LatencyHistogram::bucketOf(latencyUs)].add(1);
+		mCount.add(1);
+		mTotalUs.add(latencyUs);
+		mMaxUs.raise(latencyUs);
+	}
+	/**
+	 * @brief Copies the counted latencies to a histogram.
+	 *
+	 * Taken while latencies are being counted, the copy may miss some of the
+	 * counts of the latest one.
+	 *
+	 * @param[out] oHistogram The histogram.
+	 */
+	void snapshot(LatencyHistogram& oHistogram) const;
+
+private:
+	/** @brief The amount of latencies counted in each bucket. */
+	std::array<Counter, LatencyHistogram::cBuckets> mCounts;
+	/** @brief The amount of latencies counted. */
+	Counter mCount;
+	/** @brief The sum of the latencies counted. */
+	Counter mTotalUs;
+	/** @brief The largest latency counted. */
+	Counter mMaxUs;
+};
+
+/**
+ * @brief Counts the syscalls and buffer allocations of a kind of requests,
+ * under the threading rules of `Counter`.
+ */
+class CostRecorder
+{
+public:
+	/** @brief Counts the costs of a request. */
+	void record(const CommandCosts& costs)
+	{
+		mSendCalls.add(costs.sendCalls);
+		mRecvCalls.add(costs.recvCalls);
+		mBufferAllocations.add(costs.bufferAllocations);
+		mBufferBytesAllocated.add(costs.bufferBytesAllocated);
+	}
+	/**
+	 * @brief Copies the counted costs.
+	 * @param[out] oCosts The costs.
+	 */
+	void snapshot(CommandCosts& oCosts) const
+	{
+		oCosts.sendCalls = mSendCalls.value();
+		oCosts.recvCalls = mRecvCalls.value();
+		oCosts.bufferAllocations = mBufferAllocations.value();
+		oCosts.bufferBytesAllocated = mBufferBytesAllocated.value();
+	}
+
+private:
+	/** @brief The number of send syscalls. */
+	Counter mSendCalls;
+	/** @brief The number of receive syscalls. */
+	Counter mRecvCalls;
+	/** @brief The number of buffers allocated. */
+	Counter mBufferAllocations;
+	/** @brief The total size of the buffers allocated. */
+	Counter mBufferBytesAllocated;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
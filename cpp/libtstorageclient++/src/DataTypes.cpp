@@ -21,10 +21,22 @@
 
 #include <tstorageclient++/DataTypes.h>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "Defines.h"
 
 namespace tstorage {
 
+constexpr std::int32_t BufferAllocation::cNoNode;
+constexpr std::int32_t BufferAllocation::cThreadNode;
+constexpr std::size_t LatencyHistogram::cSubBuckets;
+constexpr std::size_t LatencyHistogram::cBuckets;
+
 TSTORAGE_EXPORT bool operator==(const Key& k1, const Key& k2)
 {
 	return k1.cid == k2.cid
@@ -91,4 +103,148 @@ TSTORAGE_EXPORT Key operator-(const Key& key, const int x)
 	return {key.cid - x, key.mid - x, key.moid - x, key.cap - x, key.acq - x};
 }
 
+namespace {
+
+/** @brief The `[min, max)` spans of the fields of a key-interval. */
+using Spans = std::array<std::pair<std::int64_t, std::int64_t>, 5>;
+
+Spans spansOf(const KeyRange& range)
+{
+	const Key& lo = range.keyMin;
+	const Key& hi = range.keyMax;
+	return {{{lo.cid, hi.cid}, {lo.mid, hi.mid}, {lo.moid, hi.moid}, {lo.cap, hi.cap}, {lo.acq, hi.acq}}};
+}
+
+/** @brief Returns `true` if `range` is valid and not empty. */
+bool isQueryable(const KeyRange& range)
+{
+	return range.keyMin.isValid() && range.keyMax.isValid() && range.keyMin <= range.keyMax - 1;
+}
+
+/** @brief Returns `true` if one of `a` and `b` contains the other, or if they
+ * differ in a single field, in which they overlap or touch. */
+bool unionIsKeyRange(const KeyRange& a, const KeyRange& b)
+{
+	if ((a.keyMin <= b.keyMin && b.keyMax <= a.keyMax)
+		|| (b.keyMin <= a.keyMin && a.keyMax <= b.keyMax)) {
+		return true;
+	}
+	const Spans spansA = spansOf(a);
+	const Spans spansB = spansOf(b);
+	std::size_t differing = 0;
+	bool touching = false;
+	for (std::size_t i = 0; i < spansA.size(); ++i) {
+		if (spansA[i] != spansB[i]) {
+			++differing;
+			touching = spansA[i].first <= spansB[i].second && spansB[i].first <= spansA[i].second;
+		}
+	}
+	return differing == 1 && touching;
+}
+
+/** @brief Returns the smallest key-interval containing `a` and `b`. */
+KeyRange boundingRange(const KeyRange& a, const KeyRange& b)
+{
+	const Key& minA = a.keyMin;
+	const Key& minB = b.keyMin;
+	const Key& maxA = a.keyMax;
+	const Key& maxB = b.keyMax;
+	return {Key(std::min(minA.cid, minB.cid),
+				std::min(minA.mid, minB.mid),
+				std::min(minA.moid, minB.moid),
+				std::min(minA.cap, minB.cap),
+				std::min(minA.acq, minB.acq)),
+		Key(std::max(maxA.cid, maxB.cid),
+			std::max(maxA.mid, maxB.mid),
+			std::max(maxA.moid, maxB.moid),
+			std::max(maxA.cap, maxB.cap),
+			std::max(maxA.acq, maxB.acq))};
+}
+
+} /*namespace*/
+
+TSTORAGE_EXPORT std::vector<KeyRange> coalesceKeyRanges(
+	const std::vector<KeyRange>& ranges, std::vector<std::size_t>& oCovering)
+{
+	std::vector<KeyRange> boxes = ranges;
+	// The range each range was merged into, itself if it is still standing.
+	std::vector<std::size_t> mergedInto(ranges.size());
+	std::vector<bool> open(ranges.size());
+	for (std::size_t i = 0; i < ranges.size(); ++i) {
+		mergedInto[i] = i;
+		open[i] = isQueryable(ranges[i]);
+	}
+
+	for (bool merged = true; merged;) {
+		merged = false;
+		for (std::size_t i = 0; i < boxes.size(); ++i) {
+			for (std::size_t j = i + 1; open[i] && j < boxes.size(); ++j) {
+				if (open[j] && unionIsKeyRange(boxes[i], boxes[j])) {
+					boxes[i] = boundingRange(boxes[i], boxes[j]);
+					open[j] = false;
+					mergedInto[j] = i;
+					merged = true;
+				}
+			}
+		}
+	}
+
+	std::vector<KeyRange> result;
+	std::vector<std::size_t> resultIndex(ranges.size());
+	oCovering.assign(ranges.size(), 0);
+	for (std::size_t i = 0; i < ranges.size(); ++i) {
+		std::size_t root = i;
+		while (mergedInto[root] != root) {
+			root = mergedInto[root];
+		}
+		if (root == i) {
+			resultIndex[i] = result.size();
+			result.push_back(boxes[i]);
+		}
+		// A range is only merged into one that comes before it.
+		oCovering[i] = resultIndex[root];
+	}
+	return result;
+}
+
+TSTORAGE_EXPORT std::size_t LatencyHistogram::bucketOf(const std::uint64_t latencyUs)
+{
+	if (latencyUs < cSubBuckets) {
+		return static_cast<std::size_t>(latencyUs);
+	}
+	// The 3 bits below the leading one select the sub-bucket.
+	const int exponent = 63 - __builtin_clzll(latencyUs);
+	const std::size_t subBucket = (latencyUs >> (exponent - 3)) & (cSubBuckets - 1);
+	const std::size_t bucket = (exponent - 2) * cSubBuckets + subBucket;
+	return bucket < cBuckets ? bucket : cBuckets - 1;
+}
+
+TSTORAGE_EXPORT std::uint64_t LatencyHistogram::bucketLowerBoundUs(const std::size_t bucket)
+{
+	if (bucket < cSubBuckets) {
+		return bucket;
+	}
+	const std::size_t exponent = bucket / cSubBuckets + 2;
+	return static_cast<std::uint64_t>(cSubBuckets + bucket % cSubBuckets) << (exponent - 3);
+}
+
+TSTORAGE_EXPORT std::uint64_t LatencyHistogram::percentileUs(const double quantile) const
+{
+	if (count == 0) {
+		return 0;
+	}
+	const double clamped = quantile < 0.0 ? 0.0 : (quantile > 1.0 ? 1.0 : quantile);
+	std::uint64_t rank = static_cast<std::uint64_t>(clamped * static_cast<double>(count) + 0.5);
+	rank = rank == 0 ? 1 : rank;
+	std::uint64_t counted = 0;
+	for (std::size_t bucket = 0; bucket + 1 < cBuckets; ++bucket) {
+		counted += counts[bucket];
+		if (counted >= rank) {
+			const std::uint64_t upperBound = bucketLowerBoundUs(bucket + 1) - 1;
+			return upperBound < maxUs ? upperBound : maxUs;
+		}
+	}
+	return maxUs;
+}
+
 } /*namespace tstorage*/
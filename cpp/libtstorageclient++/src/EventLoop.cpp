@@ -0,0 +1,54 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * EventLoop.cpp
+ *  An I/O event loop driving asynchronous channels.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tstorageclient++/EventLoop.h>
+
+#include <memory>
+
+#include <tstorageclient++/Response.h>
+
+#include "Defines.h"
+#include "EventLoopImpl.h"
+
+namespace tstorage {
+
+TSTORAGE_EXPORT EventLoop::EventLoop() : mImpl(std::make_unique<impl::EventLoopImpl>())
+{
+}
+
+TSTORAGE_EXPORT EventLoop::~EventLoop() = default;
+
+TSTORAGE_EXPORT Response EventLoop::start()
+{
+	return Response(mImpl->start());
+}
+
+TSTORAGE_EXPORT void EventLoop::stop()
+{
+	mImpl->stop();
+}
+
+TSTORAGE_EXPORT bool EventLoop::running() const
+{
+	return mImpl->running();
+}
+
+} /*namespace tstorage*/
@@ -0,0 +1,285 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * EventLoopImpl.cpp
+ *   An epoll-based event loop dispatching socket readiness to handlers.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EventLoopImpl.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::uint64_t EventLoopImpl::cWakeId;
+constexpr int EventLoopImpl::cMaxEvents;
+
+EventLoopImpl::EventLoopImpl()
+	: mEpollFd(-1)
+	, mWakeFd(-1)
+	, mRunning(false)
+	, mStop(false)
+	, mThreadId(std::thread::id{})
+	, mNextId(cWakeId + 1)
+{
+}
+
+EventLoopImpl::~EventLoopImpl()
+{
+	stop();
+	if (mWakeFd != -1) {
+		::close(mWakeFd);
+	}
+	if (mEpollFd != -1) {
+		::close(mEpollFd);
+	}
+}
+
+result_t EventLoopImpl::start()
+{
+	if (mRunning.load()) {
+		return result_t::OK;
+	}
+	if (mEpollFd == -1) {
+		mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+		if (mEpollFd == -1) {
+			return result_t::SOCKET_ERROR;
+		}
+	}
+	if (mWakeFd == -1) {
+		mWakeFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		if (mWakeFd == -1) {
+			return result_t::SOCKET_ERROR;
+		}
+		// clang-format off
+		struct epoll_event event{};
+		// clang-format on
+		event.events = EPOLLIN;
+		event.data.u64 = cWakeId;
+		if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeFd, &event) == -1) {
+			::close(mWakeFd);
+			mWakeFd = -1;
+			return result_t::SOCKET_ERROR;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mTasksMutex);
+	mStop = false;
+	mRunning = true;
+	mThread = std::thread(&EventLoopImpl::run, this);
+	mThreadId = mThread.get_id();
+	return result_t::OK;
+}
+
+void EventLoopImpl::stop()
+{
+	if (!mRunning.load() || inLoopThread()) {
+		return;
+	}
+	mStop = true;
+	wake();
+	mThread.join();
+
+	std::vector<Task> tasks;
+	{
+		std::lock_guard<std::mutex> lock(mTasksMutex);
+		mRunning = false;
+		mThreadId = std::thread::id{};
+		// Some of the tasks the loop didn't get to might be awaited by `runSync()`.
+		tasks.swap(mTasks);
+	}
+	for (Task& task : tasks) {
+		task();
+	}
+}
+
+void EventLoopImpl::post(Task task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mTasksMutex);
+		mTasks.push_back(std::move(task));
+	}
+	wake();
+}
+
+void EventLoopImpl::runSync(const Task& task)
+{
+	if (inLoopThread()) {
+		task();
+		return;
+	}
+
+	std::promise<void> done;
+	{
+		std::unique_lock<std::mutex> lock(mTasksMutex);
+		if (!mRunning.load()) {
+			lock.unlock();
+			task();
+			return;
+		}
+		mTasks.emplace_back([&task, &done]() {
+			task();
+			done.set_value();
+		});
+	}
+	wake();
+	done.get_future().wait();
+}
+
+result_t EventLoopImpl::addHandler(
+	const int fd, const std::uint32_t events, EventHandler* const handler, std::uint64_t& oId)
+{
+	if (mEpollFd == -1) {
+		return result_t::SOCKET_ERROR;
+	}
+	// clang-format off
+	struct epoll_event event{};
+	// clang-format on
+	event.events = events;
+	event.data.u64 = mNextId;
+	if (::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+		return result_t::SOCKET_ERROR;
+	}
+	oId = mNextId++;
+	mHandlers.emplace(oId, handler);
+	return result_t::OK;
+}
+
+result_t EventLoopImpl::modifyHandler(
+	const int fd, const std::uint32_t events, const std::uint64_t id)
+{
+	// clang-format off
+	struct epoll_event event{};
+	// clang-format on
+	event.events = events;
+	event.data.u64 = id;
+	if (::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, fd, &event) == -1) {
+		return result_t::SOCKET_ERROR;
+	}
+	return result_t::OK;
+}
+
+void EventLoopImpl::removeHandler(const int fd, const std::uint64_t id)
+{
+	if (mHandlers.erase(id) > 0) {
+		(void)::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+	}
+}
+
+void EventLoopImpl::run()
+{
+	std::array<struct epoll_event, cMaxEvents> events{};
+	while (!mStop.load()) {
+		runTasks();
+		const int count = ::epoll_wait(mEpollFd, events.data(), cMaxEvents, waitTimeoutMs());
+		if (count < 0 && errno != EINTR) {
+			break;
+		}
+		for (int i = 0; i < count; ++i) {
+			const std::uint64_t id = events[i].data.u64;
+			if (id == cWakeId) {
+				std::uint64_t counter{};
+				(void)::read(mWakeFd, &counter, sizeof(counter));
+				continue;
+			}
+			const auto handler = mHandlers.find(id);
+			if (handler != mHandlers.end()) {
+				handler->second->onEvents(events[i].events);
+			}
+		}
+		fireDeadlines();
+	}
+}
+
+void EventLoopImpl::runTasks()
+{
+	std::vector<Task> tasks;
+	{
+		std::lock_guard<std::mutex> lock(mTasksMutex);
+		tasks.swap(mTasks);
+	}
+	for (Task& task : tasks) {
+		task();
+	}
+}
+
+void EventLoopImpl::fireDeadlines()
+{
+	const EventHandler::Clock::time_point now = EventHandler::Clock::now();
+	std::vector<std::uint64_t> expired;
+	for (const auto& handler : mHandlers) {
+		if (handler.second->deadline() <= now) {
+			expired.push_back(handler.first);
+		}
+	}
+	for (const std::uint64_t id : expired) {
+		const auto handler = mHandlers.find(id);
+		if (handler != mHandlers.end()) {
+			handler->second->onDeadline();
+		}
+	}
+}
+
+int EventLoopImpl::waitTimeoutMs() const
+{
+	EventHandler::Clock::time_point nearest = EventHandler::Clock::time_point::max();
+	for (const auto& handler : mHandlers) {
+		nearest = std::min(nearest, handler.second->deadline());
+	}
+	if (nearest == EventHandler::Clock::time_point::max()) {
+		return -1;
+	}
+	const EventHandler::Clock::time_point now = EventHandler::Clock::now();
+	if (nearest <= now) {
+		return 0;
+	}
+	// Round up, so that the deadline has expired once the wait times out.
+	const std::int64_t timeoutMs =
+		std::chrono::duration_cast<std::chrono::milliseconds>(
+			nearest - now + std::chrono::milliseconds(1) - std::chrono::nanoseconds(1))
+			.count();
+	return static_cast<int>(std::min<std::int64_t>(timeoutMs, std::numeric_limits<int>::max()));
+}
+
+void EventLoopImpl::wake()
+{
+	if (mWakeFd == -1) {
+		return;
+	}
+	const std::uint64_t one = 1;
+	(void)::write(mWakeFd, &one, sizeof(one));
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
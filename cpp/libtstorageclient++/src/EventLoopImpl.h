@@ -0,0 +1,204 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * EventLoopImpl.h
+ *   An epoll-based event loop dispatching socket readiness to handlers.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_EVENTLOOPIMPL_PH
+#define D_TSTORAGE_EVENTLOOPIMPL_PH
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines the implementation of `EventLoop`. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief An interface of objects reacting to events of a file descriptor
+ * registered with an `EventLoopImpl`.
+ *
+ * All methods are called on the loop's thread.
+ */
+class EventHandler
+{
+public:
+	/** @brief The clock used for deadlines. */
+	using Clock = std::chrono::steady_clock;
+
+	virtual ~EventHandler() = default;
+
+	/**
+	 * @brief Handles readiness of the registered file descriptor.
+	 * @param events A mask of `EPOLL*` event flags.
+	 */
+	virtual void onEvents(std::uint32_t events) = 0;
+	/**
+	 * @brief Returns the point in time at which `onDeadline()` should be
+	 * invoked, or `Clock::time_point::max()` if none.
+	 */
+	virtual Clock::time_point deadline() const = 0;
+	/** @brief Handles expiration of the deadline returned by `deadline()`. */
+	virtual void onDeadline() = 0;
+};
+
+/**
+ * @brief The implementation of `EventLoop`.
+ *
+ * The loop thread waits on an `epoll` instance for readiness of registered
+ * file descriptors and for wake-ups signalled through an `eventfd`.
+ * Afterwards, it dispatches the events to their handlers, executes the tasks
+ * posted by other threads, and fires expired handler deadlines.
+ *
+ * Handlers are identified by unique, never reused numeric IDs stored in the
+ * `epoll` event data. A handler unregistered while its events are being
+ * dispatched is thus simply skipped, which makes it safe to unregister (and
+ * destroy) handlers from within callbacks of other handlers.
+ *
+ * Handler registration methods may only be called on the loop's thread (or
+ * from a task executed inline while the loop is stopped, see `runSync()`).
+ */
+class EventLoopImpl final
+{
+public:
+	/** @brief A unit of work executed on the loop's thread. */
+	using Task = std::function<void()>;
+
+	/** @brief A constructor. Does not allocate any resources. */
+	EventLoopImpl();
+	/** @brief A destructor. Stops the loop. */
+	~EventLoopImpl();
+
+	EventLoopImpl(const EventLoopImpl&) = delete;
+	EventLoopImpl(EventLoopImpl&&) = delete;
+	EventLoopImpl& operator=(const EventLoopImpl&) = delete;
+	EventLoopImpl& operator=(EventLoopImpl&&) = delete;
+
+	/**
+	 * @brief Creates the `epoll` and `eventfd` descriptors on first use and
+	 * starts the loop's thread.
+	 * @return `result_t::SOCKET_ERROR` if the descriptors can't be created,
+	 * `result_t::OK` otherwise.
+	 */
+	result_t start();
+	/** @brief Stops the loop's thread and executes the remaining tasks inline. */
+	void stop();
+	/** @brief Returns `true` if the loop's thread is running. */
+	bool running() const { return mRunning.load(); }
+	/** @brief Returns `true` if called on the loop's thread. */
+	bool inLoopThread() const { return std::this_thread::get_id() == mThreadId.load(); }
+
+	/**
+	 * @brief Schedules a task for execution on the loop's thread.
+	 *
+	 * Tasks are executed in the order of posting. Tasks posted while the loop
+	 * is stopped are executed once it is started.
+	 *
+	 * @param task The task.
+	 */
+	void post(Task task);
+	/**
+	 * @brief Executes a task on the loop's thread and waits for it to finish.
+	 *
+	 * If called on the loop's thread or while the loop is stopped, the task is
+	 * executed inline.
+	 *
+	 * @param task The task.
+	 */
+	void runSync(const Task& task);
+
+	/**
+	 * @brief Registers a file descriptor and its handler.
+	 * @param fd The file descriptor.
+	 * @param events The mask of `EPOLL*` events to wait for.
+	 * @param handler The handler.
+	 * @param[out] oId The ID of the registration.
+	 * @return `result_t::SOCKET_ERROR` on failure, `result_t::OK` otherwise.
+	 */
+	result_t addHandler(int fd, std::uint32_t events, EventHandler* handler, std::uint64_t& oId);
+	/**
+	 * @brief Changes the mask of events a registered file descriptor waits for.
+	 * @param fd The file descriptor.
+	 * @param events The new mask of `EPOLL*` events.
+	 * @param id The ID of the registration.
+	 * @return `result_t::SOCKET_ERROR` on failure, `result_t::OK` otherwise.
+	 */
+	result_t modifyHandler(int fd, std::uint32_t events, std::uint64_t id);
+	/**
+	 * @brief Unregisters a file descriptor. Must be called before the
+	 * descriptor is closed.
+	 * @param fd The file descriptor.
+	 * @param id The ID of the registration.
+	 */
+	void removeHandler(int fd, std::uint64_t id);
+
+private:
+	/** @brief The `epoll` event data identifying the wake-up `eventfd`. */
+	static constexpr std::uint64_t cWakeId = 0;
+	/** @brief The maximal amount of events fetched at once. */
+	static constexpr int cMaxEvents = 64;
+
+	/** @brief The main loop of the loop's thread. */
+	void run();
+	/** @brief Executes the tasks posted so far. */
+	void runTasks();
+	/** @brief Invokes `onDeadline()` of handlers with expired deadlines. */
+	void fireDeadlines();
+	/** @brief Computes the `epoll_wait()` timeout from handler deadlines. */
+	int waitTimeoutMs() const;
+	/** @brief Wakes up the loop's thread. */
+	void wake();
+
+	/** @brief The `epoll` instance, or `-1`. */
+	int mEpollFd;
+	/** @brief The wake-up `eventfd`, or `-1`. */
+	int mWakeFd;
+	/** @brief `true` while the loop's thread is running. */
+	std::atomic<bool> mRunning;
+	/** @brief `true` when the loop's thread is requested to exit. */
+	std::atomic<bool> mStop;
+	/** @brief The ID of the loop's thread. */
+	std::atomic<std::thread::id> mThreadId;
+	/** @brief The loop's thread. */
+	std::thread mThread;
+
+	/** @brief Tasks posted for execution. */
+	std::vector<Task> mTasks;
+	/** @brief Guards `mTasks` and the transitions of `mRunning`. */
+	std::mutex mTasksMutex;
+
+	/** @brief Registered handlers by ID. */
+	std::unordered_map<std::uint64_t, EventHandler*> mHandlers;
+	/** @brief The ID of the next registration. */
+	std::uint64_t mNextId;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
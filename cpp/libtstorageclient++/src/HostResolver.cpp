@@ -0,0 +1,132 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * HostResolver.cpp
+ *   Resolves and caches the addresses of a host.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HostResolver.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::uint32_t HostResolver::cDefaultTtlMs;
+
+result_t HostResolver::resolve(const std::vector<Address>*& oAddresses)
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (!mAddresses.empty() && now < mExpiry) {
+		oAddresses = &mAddresses;
+		return result_t::OK;
+	}
+	mAddresses.clear();
+
+	if (isLocal(mHost)) {
+		Address address{};
+		if (resolveLocal(mHost, address) != result_t::OK) {
+			return result_t::BAD_ADDRESS;
+		}
+		mAddresses.push_back(address);
+		mExpiry = now + std::chrono::milliseconds(mTtlMs);
+		oAddresses = &mAddresses;
+		return result_t::OK;
+	}
+
+	// clang-format off
+	struct addrinfo hints{};
+	// clang-format on
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_protocol = IPPROTO_TCP;
+	hints.ai_flags = 0;
+
+	struct addrinfo* ai = nullptr;
+	const std::string portStr = std::to_string(mPort);
+	if (::getaddrinfo(mHost.c_str(), portStr.c_str(), &hints, &ai) != 0) {
+		return result_t::BAD_ADDRESS;
+	}
+
+	// Interleave the families, keeping the preference order within each.
+	std::vector<Address> preferred;
+	std::vector<Address> other;
+	const int preferredFamily = ai->ai_family;
+	for (struct addrinfo* aiNext = ai; aiNext != nullptr; aiNext = aiNext->ai_next) {
+		if (aiNext->ai_addrlen > sizeof(Address::addr)) {
+			continue;
+		}
+		Address address{};
+		std::memcpy(&address.addr, aiNext->ai_addr, aiNext->ai_addrlen);
+		address.length = aiNext->ai_addrlen;
+		(aiNext->ai_family == preferredFamily ? preferred : other).push_back(address);
+	}
+	::freeaddrinfo(ai);
+
+	for (std::size_t i = 0; i < preferred.size() || i < other.size(); ++i) {
+		if (i < preferred.size()) {
+			mAddresses.push_back(preferred[i]);
+		}
+		if (i < other.size()) {
+			mAddresses.push_back(other[i]);
+		}
+	}
+	if (mAddresses.empty()) {
+		return result_t::BAD_ADDRESS;
+	}
+	mExpiry = now + std::chrono::milliseconds(mTtlMs);
+	oAddresses = &mAddresses;
+	return result_t::OK;
+}
+
+result_t HostResolver::resolveLocal(const std::string& host, Address& oAddress)
+{
+	// clang-format off
+	struct sockaddr_un addr{};
+	// clang-format on
+	const std::string path = host.substr(5);
+	if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+		return result_t::BAD_ADDRESS;
+	}
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, path.data(), path.size());
+	socklen_t length = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + path.size());
+	if (path[0] == '@') {
+		// An abstract name, not terminated.
+		addr.sun_path[0] = '\0';
+	} else {
+		++length;
+	}
+	oAddress = Address{};
+	std::memcpy(&oAddress.addr, &addr, sizeof(addr));
+	oAddress.length = length;
+	return result_t::OK;
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,144 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * HostResolver.h
+ *   Resolves and caches the addresses of a host.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_HOSTRESOLVER_PH
+#define D_TSTORAGE_HOSTRESOLVER_PH
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sys/socket.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines a caching resolver of host addresses. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief Resolves the IPv4 and IPv6 addresses of a host/port pair and caches
+ * them for a limited time.
+ *
+ * The addresses are ordered for connecting as recommended by RFC 8305: in the
+ * order of preference returned by `getaddrinfo()`, but interleaved by address
+ * family, so that the first few connection attempts try both families even if
+ * one of them is unreachable.
+ *
+ * The system resolver does not report the TTLs of the DNS records, hence the
+ * cached addresses expire after a fixed time instead (see `setTtlMs()`).
+ *
+ * A host named `unix:<path>` is a Unix domain stream socket bound to
+ * `<path>`, or to `<name>` in the abstract namespace for `unix:@<name>`, and
+ * the port is ignored. Servers on the same host are thus reached without the
+ * TCP/IP stack, i.e. without segmentation, checksumming and loopback
+ * routing.
+ */
+class HostResolver
+{
+public:
+	/** @brief A resolved address of the host. */
+	struct Address
+	{
+		/** @brief The socket address. */
+		struct sockaddr_storage addr;
+		/** @brief The length of `addr`. */
+		socklen_t length;
+
+		/** @brief Returns the address family of `addr`. */
+		int family() const { return addr.ss_family; }
+	};
+
+	/** @brief The default time the resolved addresses stay cached for. */
+	static constexpr std::uint32_t cDefaultTtlMs = 30'000;
+
+	/** @brief A constructor. Sets the host and port to resolve. */
+	HostResolver(std::string host, std::uint16_t port)
+		: mHost(std::move(host))
+		, mPort(port)
+		, mTtlMs(cDefaultTtlMs)
+	{
+	}
+
+	/**
+	 * @brief Returns the addresses of the host, resolving them if the cached
+	 * ones have expired.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_ADDRESS`
+	 *
+	 * @param[out] oAddresses The nonempty list of the host's addresses, valid
+	 * until the next call to a non-const method.
+	 * @return Status code.
+	 */
+	result_t resolve(const std::vector<Address>*& oAddresses);
+	/** @brief Returns `true` if `host` names a Unix domain socket. */
+	static bool isLocal(const std::string& host) { return host.compare(0, 5, "unix:") == 0; }
+	/**
+	 * @brief Makes the address of the Unix domain socket named by `host`.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::BAD_ADDRESS` if the path is empty or too long.
+	 *
+	 * @param host A host for which `isLocal()` holds.
+	 * @param[out] oAddress The address.
+	 * @return Status code.
+	 */
+	static result_t resolveLocal(const std::string& host, Address& oAddress);
+	/** @brief Drops the cached addresses, e.g. when none of them is
+	 * reachable. */
+	void invalidate() { mAddresses.clear(); }
+
+	/** @brief Sets the host and port to resolve, dropping the cached
+	 * addresses. */
+	void setHost(const std::string& host, std::uint16_t port)
+	{
+		mHost = host;
+		mPort = port;
+		invalidate();
+	}
+	/** @brief Returns the host's name or address. */
+	const std::string& host() const { return mHost; }
+	/** @brief Sets the time the resolved addresses stay cached for, `0` to
+	 * resolve them on each call. Does not affect the cached addresses'
+	 * expiry. */
+	void setTtlMs(std::uint32_t ttlMs) { mTtlMs = ttlMs; }
+
+private:
+	/** @brief The host's name or address. */
+	std::string mHost;
+	/** @brief The host's port. */
+	std::uint16_t mPort;
+	/** @brief The time the resolved addresses stay cached for. */
+	std::uint32_t mTtlMs;
+	/** @brief The cached addresses, empty if none. */
+	std::vector<Address> mAddresses;
+	/** @brief The expiry of `mAddresses`. */
+	std::chrono::steady_clock::time_point mExpiry;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,432 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * IoUring.cpp
+ *   A minimal io_uring instance running one socket operation at a time.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IoUring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#ifdef D_TSTORAGE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace tstorage {
+namespace impl {
+
+IoUring::IoUring()
+	: mRingFd(-1)
+	, mRings(nullptr)
+	, mRingsSize(0)
+	, mSqes(nullptr)
+	, mSqesSize(0)
+	, mSqTail(nullptr)
+	, mSqMask(0)
+	, mSqArray(nullptr)
+	, mCqHead(nullptr)
+	, mCqTail(nullptr)
+	, mCqMask(0)
+	, mCqes(nullptr)
+	, mInFlight(0)
+	, mUnsubmitted(0)
+	, mRegisteredMemory(nullptr)
+	, mRegisteredSize(0)
+{
+}
+
+#ifdef D_TSTORAGE_IO_URING
+
+bool IoUring::built()
+{
+	return true;
+}
+
+namespace {
+
+/** @brief The number of submission queue entries, enough for an operation,
+ * its linked timeout and a cancelation. */
+constexpr unsigned int cRingEntries = 4;
+
+/** @brief The `user_data` tags of the entries submitted by `IoUring::run()`. */
+enum OpTag : std::uint64_t {
+	OP = 0,
+	TIMEOUT = 1,
+	CANCEL = 2,
+};
+
+/** @brief The largest amount of bytes transferred by an operation, as for
+ * the equivalent syscalls. */
+constexpr std::size_t cMaxTransfer = std::numeric_limits<int>::max() & ~std::size_t{4095};
+
+/** @brief Converts the result of an operation to the syscall convention. */
+ssize_t toSyscallResult(const int res)
+{
+	if (res < 0) {
+		errno = -res;
+		return -1;
+	}
+	return res;
+}
+
+/** @brief Returns `true` if every operation used by `IoUring` is supported
+ * by the ring `ringFd`. */
+bool probeOperations(const int ringFd)
+{
+	constexpr unsigned int cProbedOps = 256;
+	std::vector<std::uint8_t> storage(
+		sizeof(io_uring_probe) + cProbedOps * sizeof(io_uring_probe_op));
+	auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+	if (::syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, cProbedOps) < 0) {
+		return false;
+	}
+	const unsigned int required[] = {IORING_OP_SEND,
+		IORING_OP_SENDMSG,
+		IORING_OP_RECV,
+		IORING_OP_READ_FIXED,
+		IORING_OP_LINK_TIMEOUT,
+		IORING_OP_ASYNC_CANCEL};
+	return std::all_of(std::begin(required), std::end(required), [probe](const unsigned int op) {
+		return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+	});
+}
+
+} /*namespace*/
+
+bool IoUring::init()
+{
+	if (active()) {
+		return true;
+	}
+	// clang-format off
+	struct io_uring_params params{};
+	// clang-format on
+	const int ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, cRingEntries, &params));
+	if (ringFd < 0) {
+		return false;
+	}
+	if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0 || !probeOperations(ringFd)) {
+		::close(ringFd);
+		return false;
+	}
+
+	const std::size_t sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	const std::size_t cqRingSize =
+		params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	const std::size_t ringsSize = std::max(sqRingSize, cqRingSize);
+	void* const rings = ::mmap(nullptr,
+		ringsSize,
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE,
+		ringFd,
+		IORING_OFF_SQ_RING);
+	if (rings == MAP_FAILED) {
+		::close(ringFd);
+		return false;
+	}
+	const std::size_t sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	void* const sqes = ::mmap(nullptr,
+		sqesSize,
+		PROT_READ | PROT_WRITE,
+		MAP_SHARED | MAP_POPULATE,
+		ringFd,
+		IORING_OFF_SQES);
+	if (sqes == MAP_FAILED) {
+		::munmap(rings, ringsSize);
+		::close(ringFd);
+		return false;
+	}
+
+	auto* const base = static_cast<std::uint8_t*>(rings);
+	mRingFd = ringFd;
+	mRings = rings;
+	mRingsSize = ringsSize;
+	mSqes = static_cast<struct io_uring_sqe*>(sqes);
+	mSqesSize = sqesSize;
+	mSqTail = reinterpret_cast<unsigned int*>(base + params.sq_off.tail);
+	mSqMask = *reinterpret_cast<const unsigned int*>(base + params.sq_off.ring_mask);
+	mSqArray = reinterpret_cast<unsigned int*>(base + params.sq_off.array);
+	mCqHead = reinterpret_cast<unsigned int*>(base + params.cq_off.head);
+	mCqTail = reinterpret_cast<const unsigned int*>(base + params.cq_off.tail);
+	mCqMask = *reinterpret_cast<const unsigned int*>(base + params.cq_off.ring_mask);
+	mCqes = base + params.cq_off.cqes;
+	mInFlight = 0;
+	mUnsubmitted = 0;
+	return true;
+}
+
+void IoUring::release()
+{
+	if (!active()) {
+		return;
+	}
+	::munmap(mSqes, mSqesSize);
+	::munmap(mRings, mRingsSize);
+	::close(mRingFd);
+	mRingFd = -1;
+	mRings = nullptr;
+	mSqes = nullptr;
+	mInFlight = 0;
+	mUnsubmitted = 0;
+	mRegisteredMemory = nullptr;
+	mRegisteredSize = 0;
+}
+
+bool IoUring::registerBuffer(void* const memory, const std::size_t size)
+{
+	if (!active()) {
+		return false;
+	}
+	unregisterBuffer();
+	// clang-format off
+	struct iovec iov{};
+	// clang-format on
+	iov.iov_base = memory;
+	iov.iov_len = size;
+	if (::syscall(__NR_io_uring_register, mRingFd, IORING_REGISTER_BUFFERS, &iov, 1) < 0) {
+		return false;
+	}
+	mRegisteredMemory = static_cast<const std::uint8_t*>(memory);
+	mRegisteredSize = size;
+	return true;
+}
+
+void IoUring::unregisterBuffer()
+{
+	if (!active() || !bufferRegistered()) {
+		return;
+	}
+	(void)::syscall(__NR_io_uring_register, mRingFd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+	mRegisteredMemory = nullptr;
+	mRegisteredSize = 0;
+}
+
+ssize_t IoUring::send(const int fd,
+	const void* const bytes,
+	const std::size_t amountBytes,
+	const int flags,
+	const std::uint32_t timeoutMs)
+{
+	// clang-format off
+	struct io_uring_sqe sqe{};
+	// clang-format on
+	sqe.opcode = IORING_OP_SEND;
+	sqe.fd = fd;
+	sqe.addr = reinterpret_cast<std::uintptr_t>(bytes);
+	sqe.len = static_cast<std::uint32_t>(std::min(amountBytes, cMaxTransfer));
+	sqe.msg_flags = static_cast<std::uint32_t>(flags);
+	return toSyscallResult(run(sqe, timeoutMs));
+}
+
+ssize_t IoUring::sendmsg(
+	const int fd, const struct msghdr* const msg, const int flags, const std::uint32_t timeoutMs)
+{
+	// clang-format off
+	struct io_uring_sqe sqe{};
+	// clang-format on
+	sqe.opcode = IORING_OP_SENDMSG;
+	sqe.fd = fd;
+	sqe.addr = reinterpret_cast<std::uintptr_t>(msg);
+	sqe.len = 1;
+	sqe.msg_flags = static_cast<std::uint32_t>(flags);
+	return toSyscallResult(run(sqe, timeoutMs));
+}
+
+ssize_t IoUring::recv(
+	const int fd, void* const buffer, const std::size_t amountBytes, const std::uint32_t timeoutMs)
+{
+	const std::size_t length = std::min(amountBytes, cMaxTransfer);
+	const auto* const start = static_cast<const std::uint8_t*>(buffer);
+	const bool fixed = bufferRegistered() && start >= mRegisteredMemory
+		&& start + length <= mRegisteredMemory + mRegisteredSize;
+
+	// clang-format off
+	struct io_uring_sqe sqe{};
+	// clang-format on
+	sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_RECV;
+	sqe.fd = fd;
+	sqe.addr = reinterpret_cast<std::uintptr_t>(buffer);
+	sqe.len = static_cast<std::uint32_t>(length);
+	if (fixed) {
+		sqe.buf_index = 0;
+	}
+	return toSyscallResult(run(sqe, timeoutMs));
+}
+
+int IoUring::run(const struct io_uring_sqe& op, const std::uint32_t timeoutMs)
+{
+	int results[3] = {};
+	// The timeout has to outlive the wait for the operation.
+	// clang-format off
+	struct __kernel_timespec timeout{};
+	// clang-format on
+	struct io_uring_sqe sqe = op;
+	sqe.user_data = OpTag::OP;
+	if (timeoutMs != 0) {
+		const std::uint32_t secondMs = 1000;
+		const std::int64_t nsecsInMs = 1'000'000;
+		timeout.tv_sec = timeoutMs / secondMs;
+		timeout.tv_nsec = (timeoutMs % secondMs) * nsecsInMs;
+		sqe.flags |= IOSQE_IO_LINK;
+		push(sqe);
+
+		// clang-format off
+		struct io_uring_sqe timeoutSqe{};
+		// clang-format on
+		timeoutSqe.opcode = IORING_OP_LINK_TIMEOUT;
+		timeoutSqe.fd = -1;
+		timeoutSqe.addr = reinterpret_cast<std::uintptr_t>(&timeout);
+		timeoutSqe.len = 1;
+		timeoutSqe.user_data = OpTag::TIMEOUT;
+		push(timeoutSqe);
+	} else {
+		push(sqe);
+	}
+
+	const int resWait = submitAndWait(results, true);
+	if (resWait == -EINTR) {
+		// clang-format off
+		struct io_uring_sqe cancelSqe{};
+		// clang-format on
+		cancelSqe.opcode = IORING_OP_ASYNC_CANCEL;
+		cancelSqe.fd = -1;
+		cancelSqe.addr = OpTag::OP;
+		cancelSqe.user_data = OpTag::CANCEL;
+		push(cancelSqe);
+		(void)submitAndWait(results, false);
+		return results[OpTag::OP] == -ECANCELED ? -EINTR : results[OpTag::OP];
+	}
+	if (resWait < 0) {
+		return resWait;
+	}
+	// Only the linked timeout cancels the operation here.
+	return results[OpTag::OP] == -ECANCELED ? -EAGAIN : results[OpTag::OP];
+}
+
+void IoUring::push(const struct io_uring_sqe& sqe)
+{
+	const unsigned int tail = *mSqTail;
+	const unsigned int index = tail & mSqMask;
+	mSqes[index] = sqe;
+	mSqArray[index] = index;
+	__atomic_store_n(mSqTail, tail + 1, __ATOMIC_RELEASE);
+	++mUnsubmitted;
+	++mInFlight;
+}
+
+int IoUring::submitAndWait(int (&oResults)[3], const bool interruptible)
+{
+	const auto* const cqes = static_cast<const struct io_uring_cqe*>(mCqes);
+	while (true) {
+		unsigned int head = *mCqHead;
+		const unsigned int tail = __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; ++head) {
+			const struct io_uring_cqe& cqe = cqes[head & mCqMask];
+			if (cqe.user_data <= OpTag::CANCEL) {
+				oResults[cqe.user_data] = cqe.res;
+			}
+			--mInFlight;
+		}
+		__atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+		if (mInFlight == 0) {
+			return 0;
+		}
+
+		const long entered = ::syscall(
+			__NR_io_uring_enter, mRingFd, mUnsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+		if (entered >= 0) {
+			mUnsubmitted -= std::min(mUnsubmitted, static_cast<unsigned int>(entered));
+			continue;
+		}
+		const int error = errno;
+		if (error == EINTR) {
+			if (interruptible) {
+				return -EINTR;
+			}
+			continue;
+		}
+		if (error == EAGAIN || error == EBUSY) {
+			continue;
+		}
+		// The ring is unusable; no completion is going to arrive.
+		mInFlight -= mUnsubmitted;
+		return -error;
+	}
+}
+
+#else
+
+bool IoUring::built()
+{
+	return false;
+}
+
+bool IoUring::init()
+{
+	return false;
+}
+
+void IoUring::release() {}
+
+bool IoUring::registerBuffer(void* /*memory*/, std::size_t /*size*/)
+{
+	return false;
+}
+
+void IoUring::unregisterBuffer() {}
+
+ssize_t IoUring::send(const int /*fd*/,
+	const void* /*bytes*/,
+	std::size_t /*amountBytes*/,
+	int /*flags*/,
+	std::uint32_t /*timeoutMs*/)
+{
+	errno = ENOSYS;
+	return -1;
+}
+
+ssize_t IoUring::sendmsg(
+	const int /*fd*/, const struct msghdr* /*msg*/, int /*flags*/, std::uint32_t /*timeoutMs*/)
+{
+	errno = ENOSYS;
+	return -1;
+}
+
+ssize_t IoUring::recv(
+	const int /*fd*/, void* /*buffer*/, std::size_t /*amountBytes*/, std::uint32_t /*timeoutMs*/)
+{
+	errno = ENOSYS;
+	return -1;
+}
+
+#endif
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,163 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * IoUring.h
+ *   A minimal io_uring instance running one socket operation at a time.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_IOURING_PH
+#define D_TSTORAGE_IOURING_PH
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+/** @file
+ * @brief Defines an io_uring backend for the socket operations. */
+
+struct io_uring_sqe;
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief An io_uring instance used to perform the blocking socket operations
+ * of a `Socket`.
+ *
+ * Each operation is submitted together with a linked timeout and waited for
+ * with a single `io_uring_enter` syscall. The operations mimic their syscall
+ * counterparts: they return the amount of bytes transferred, or `-1` with
+ * `errno` set on error. An operation which times out fails with `EAGAIN`,
+ * like a socket operation exceeding `SO_RCVTIMEO` or `SO_SNDTIMEO` does.
+ *
+ * One memory block may be registered with the kernel, so that receives into
+ * it skip mapping its pages on every operation.
+ *
+ * The backend is built only with `D_TSTORAGE_IO_URING` defined (`make
+ * IO_URING=1`). Otherwise, as well as on kernels lacking any of the
+ * operations used, `init()` fails, and the owner is expected to fall back to
+ * plain syscalls.
+ *
+ * Operations may be performed from different threads, but not concurrently.
+ */
+class IoUring
+{
+public:
+	/** @brief Constructs an inactive instance. */
+	IoUring();
+	/** @brief A destructor. Releases the ring if active. */
+	~IoUring() { release(); }
+
+	IoUring(const IoUring&) = delete;
+	IoUring(IoUring&&) = delete;
+	IoUring& operator=(const IoUring&) = delete;
+	IoUring& operator=(IoUring&&) = delete;
+
+	/**
+	 * @brief Creates the ring.
+	 * @return `true` on success, `false` if io_uring is unavailable.
+	 */
+	bool init();
+	/** @brief Releases the ring along with the registered memory block. */
+	void release();
+	/** @brief Returns `true` if the ring has been created. */
+	bool active() const { return mRingFd != -1; }
+	/** @brief Returns `true` if the backend is built into the library. */
+	static bool built();
+
+	/**
+	 * @brief Registers `size` bytes at `memory` as the fixed buffer of the
+	 * ring, replacing the one previously registered.
+	 * @return `true` on success, `false` otherwise, leaving no memory block
+	 * registered.
+	 */
+	bool registerBuffer(void* memory, std::size_t size);
+	/** @brief Unregisters the fixed buffer, if any. */
+	void unregisterBuffer();
+	/** @brief Returns `true` if a fixed buffer is registered. */
+	bool bufferRegistered() const { return mRegisteredSize != 0; }
+
+	/** @brief Works like `::send()`, timing out after `timeoutMs` (`0` for no
+	 * timeout). */
+	ssize_t send(int fd, const void* bytes, std::size_t amountBytes, int flags, std::uint32_t timeoutMs);
+	/** @brief Works like `::sendmsg()`, timing out after `timeoutMs` (`0` for
+	 * no timeout). */
+	ssize_t sendmsg(int fd, const struct msghdr* msg, int flags, std::uint32_t timeoutMs);
+	/** @brief Works like `::recv()` without flags, timing out after
+	 * `timeoutMs` (`0` for no timeout). Receives directly into the fixed
+	 * buffer if it contains the whole target block. */
+	ssize_t recv(int fd, void* buffer, std::size_t amountBytes, std::uint32_t timeoutMs);
+
+private:
+	/**
+	 * @brief Submits `op` with a linked timeout and waits for its completion.
+	 *
+	 * On a signal interrupting the wait the operation is canceled, and fails
+	 * with `EINTR` unless it managed to complete beforehand.
+	 *
+	 * @param op A prepared submission queue entry.
+	 * @param timeoutMs The timeout, `0` for none.
+	 * @return The result of the operation, negated `errno` on error.
+	 */
+	int run(const struct io_uring_sqe& op, std::uint32_t timeoutMs);
+	/** @brief Queues a copy of `sqe` for submission. */
+	void push(const struct io_uring_sqe& sqe);
+	/** @brief Submits the queued entries and waits until all the operations
+	 * in flight complete, storing their results in `oResults`, indexed by
+	 * their `user_data`. With `interruptible`, a signal breaks the wait.
+	 * @return `0` on success, negated `errno` of a failed wait otherwise. */
+	int submitAndWait(int (&oResults)[3], bool interruptible);
+
+	/** @brief The ring FD, `-1` if inactive. */
+	int mRingFd;
+	/** @brief The shared mapping of the submission and completion rings. */
+	void* mRings;
+	/** @brief The size of `mRings`. */
+	std::size_t mRingsSize;
+	/** @brief The mapped array of submission queue entries. */
+	struct io_uring_sqe* mSqes;
+	/** @brief The size of `mSqes` in bytes. */
+	std::size_t mSqesSize;
+	/** @brief The submission queue tail. */
+	unsigned int* mSqTail;
+	/** @brief The submission queue index mask. */
+	unsigned int mSqMask;
+	/** @brief The submission queue index array. */
+	unsigned int* mSqArray;
+	/** @brief The completion queue head. */
+	unsigned int* mCqHead;
+	/** @brief The completion queue tail. */
+	const unsigned int* mCqTail;
+	/** @brief The completion queue index mask. */
+	unsigned int mCqMask;
+	/** @brief The completion queue entries. */
+	const void* mCqes;
+	/** @brief The number of operations queued and not reaped yet. */
+	unsigned int mInFlight;
+	/** @brief The number of operations queued and not submitted yet. */
+	unsigned int mUnsubmitted;
+	/** @brief The start of the registered fixed buffer. */
+	const std::uint8_t* mRegisteredMemory;
+	/** @brief The size of the registered fixed buffer, `0` if none. */
+	std::size_t mRegisteredSize;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
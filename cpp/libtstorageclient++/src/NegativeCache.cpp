@@ -0,0 +1,173 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * NegativeCache.cpp
+ *   An implementation of a cache of key-intervals known to hold no records.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tstorageclient++/NegativeCache.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+
+constexpr std::size_t NegativeCache::cDefaultCapacity;
+
+NegativeCache::NegativeCache(const std::size_t capacity)
+	: mCapacity(std::max<std::size_t>(capacity, 1))
+{
+}
+
+void NegativeCache::insert(const Key& keyMin, const Key& keyMax, const Key::AcqT acq)
+{
+	const Key::AcqT emptyUntil = std::min(keyMax.acq, acq);
+	if (keyMin.acq >= emptyUntil) {
+		return;
+	}
+	for (const EntryIt entry : candidates(keyMin, keyMax)) {
+		const bool covered = entry->keyMin.acq <= keyMin.acq && emptyUntil <= entry->keyMax.acq;
+		const bool adjacent = sameBounds(*entry, keyMin, keyMax)
+			&& entry->keyMin.acq <= emptyUntil && keyMin.acq <= entry->keyMax.acq;
+		if (covered || adjacent) {
+			entry->keyMin.acq = std::min(entry->keyMin.acq, keyMin.acq);
+			entry->keyMax.acq = std::max(entry->keyMax.acq, emptyUntil);
+			entry->acq = std::max(entry->acq, acq);
+			mEntries.splice(mEntries.end(), mEntries, entry);
+			return;
+		}
+	}
+
+	mEntries.push_back(Entry{keyMin, keyMax, acq});
+	const EntryIt entry = std::prev(mEntries.end());
+	entry->keyMax.acq = emptyUntil;
+	SeriesId series;
+	if (seriesOf(keyMin, keyMax, series)) {
+		mSeries[series].push_back(entry);
+	} else {
+		mWide.push_back(entry);
+	}
+	if (mEntries.size() > mCapacity) {
+		erase(mEntries.begin());
+	}
+}
+
+bool NegativeCache::lookup(
+	const Key& keyMin, const Key& keyMax, Key::AcqT& oEmptyUntil, Key::AcqT& oAcq)
+{
+	const std::vector<EntryIt> found = candidates(keyMin, keyMax);
+	Key::AcqT emptyUntil = keyMin.acq;
+	Key::AcqT acq = Key::cAcqMin;
+	// Chains the entries whose ACQ ranges adjoin, each extending the range
+	// known to be empty.
+	bool extended = true;
+	while (extended && emptyUntil < keyMax.acq) {
+		extended = false;
+		for (const EntryIt entry : found) {
+			if (entry->keyMin.acq <= emptyUntil && emptyUntil < entry->keyMax.acq) {
+				emptyUntil = entry->keyMax.acq;
+				acq = std::max(acq, entry->acq);
+				mEntries.splice(mEntries.end(), mEntries, entry);
+				extended = true;
+			}
+		}
+	}
+	if (emptyUntil == keyMin.acq) {
+		return false;
+	}
+	oEmptyUntil = emptyUntil;
+	oAcq = acq;
+	return true;
+}
+
+void NegativeCache::clear()
+{
+	mSeries.clear();
+	mWide.clear();
+	mEntries.clear();
+}
+
+bool NegativeCache::seriesOf(const Key& keyMin, const Key& keyMax, SeriesId& oSeries)
+{
+	if (static_cast<std::int64_t>(keyMin.cid) + 1 != keyMax.cid || keyMin.mid == Key::cMidMax
+		|| keyMin.mid + 1 != keyMax.mid) {
+		return false;
+	}
+	oSeries = SeriesId(keyMin.cid, keyMin.mid);
+	return true;
+}
+
+bool NegativeCache::contains(const Entry& entry, const Key& keyMin, const Key& keyMax)
+{
+	return entry.keyMin.cid <= keyMin.cid && keyMax.cid <= entry.keyMax.cid
+		&& entry.keyMin.mid <= keyMin.mid && keyMax.mid <= entry.keyMax.mid
+		&& entry.keyMin.moid <= keyMin.moid && keyMax.moid <= entry.keyMax.moid
+		&& entry.keyMin.cap <= keyMin.cap && keyMax.cap <= entry.keyMax.cap;
+}
+
+bool NegativeCache::sameBounds(const Entry& entry, const Key& keyMin, const Key& keyMax)
+{
+	return entry.keyMin.cid == keyMin.cid && entry.keyMax.cid == keyMax.cid
+		&& entry.keyMin.mid == keyMin.mid && entry.keyMax.mid == keyMax.mid
+		&& entry.keyMin.moid == keyMin.moid && entry.keyMax.moid == keyMax.moid
+		&& entry.keyMin.cap == keyMin.cap && entry.keyMax.cap == keyMax.cap;
+}
+
+std::vector<NegativeCache::EntryIt> NegativeCache::candidates(const Key& keyMin, const Key& keyMax)
+{
+	std::vector<EntryIt> found;
+	SeriesId series;
+	if (seriesOf(keyMin, keyMax, series)) {
+		const auto bucket = mSeries.find(series);
+		if (bucket != mSeries.end()) {
+			for (const EntryIt entry : bucket->second) {
+				if (contains(*entry, keyMin, keyMax)) {
+					found.push_back(entry);
+				}
+			}
+		}
+	}
+	for (const EntryIt entry : mWide) {
+		if (contains(*entry, keyMin, keyMax)) {
+			found.push_back(entry);
+		}
+	}
+	return found;
+}
+
+void NegativeCache::erase(const EntryIt entry)
+{
+	SeriesId series;
+	if (seriesOf(entry->keyMin, entry->keyMax, series)) {
+		const auto bucket = mSeries.find(series);
+		std::vector<EntryIt>& entries = bucket->second;
+		entries.erase(std::find(entries.begin(), entries.end(), entry));
+		if (entries.empty()) {
+			mSeries.erase(bucket);
+		}
+	} else {
+		mWide.erase(std::find(mWide.begin(), mWide.end(), entry));
+	}
+	mEntries.erase(entry);
+}
+
+} /*namespace tstorage*/
@@ -0,0 +1,67 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PayloadSizePredictor.cpp
+ *   A decaying histogram of serialized payload sizes.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PayloadSizePredictor.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::size_t PayloadSizePredictor::cInitialPrediction;
+constexpr unsigned int PayloadSizePredictor::cBuckets;
+constexpr std::uint32_t PayloadSizePredictor::cUpdateInterval;
+constexpr std::uint32_t PayloadSizePredictor::cDecayThreshold;
+constexpr std::uint32_t PayloadSizePredictor::cPercentile;
+
+PayloadSizePredictor::PayloadSizePredictor()
+	: mCounts{}, mMaxSizes{}, mTotal(0), mSinceUpdate(0), mPrediction(cInitialPrediction)
+{
+}
+
+void PayloadSizePredictor::update()
+{
+	mSinceUpdate = 0;
+	if (mTotal >= cDecayThreshold) {
+		mTotal = 0;
+		for (unsigned int bucket = 0; bucket < cBuckets; ++bucket) {
+			mCounts[bucket] /= 2;
+			if (mCounts[bucket] == 0) {
+				mMaxSizes[bucket] = 0;
+			}
+			mTotal += mCounts[bucket];
+		}
+	}
+
+	const std::uint32_t rank = (mTotal * cPercentile + 99) / 100;
+	std::uint32_t counted = 0;
+	for (unsigned int bucket = 0; bucket < cBuckets; ++bucket) {
+		counted += mCounts[bucket];
+		if (counted >= rank && mCounts[bucket] != 0) {
+			mPrediction = mMaxSizes[bucket];
+			return;
+		}
+	}
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
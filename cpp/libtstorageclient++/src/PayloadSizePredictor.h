@@ -0,0 +1,114 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PayloadSizePredictor.h
+ *   A decaying histogram of serialized payload sizes.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PAYLOADSIZEPREDICTOR_PH
+#define D_TSTORAGE_PAYLOADSIZEPREDICTOR_PH
+
+#include <cstddef>
+#include <cstdint>
+
+/** @file
+ * @brief Defines a predictor of the size of the next serialized payload. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief Predicts the size of the next payload from the recently serialized
+ * ones.
+ *
+ * Used to size the memory block handed to `PayloadType::toBytes()` before the
+ * actual payload size is known. Too small a prediction makes the payload be
+ * serialized twice, too large a one makes the buffer be sent before it is
+ * full. The prediction is a high percentile (`cPercentile`) of the recent
+ * payload sizes, so that a few outliers neither inflate it for good nor cause
+ * more than a few retries.
+ *
+ * The sizes are counted in a histogram with a bucket per bit length of the
+ * size, each bucket keeping the largest size it has counted. The prediction is
+ * the largest size of the bucket holding the percentile, hence it is exact for
+ * fixed-size payloads. All counts are halved once `cDecayThreshold` samples
+ * accumulate, which lets the prediction follow changes of the workload. The
+ * prediction is recomputed every `cUpdateInterval` samples, and after every
+ * sample while fewer than `cUpdateInterval` have been counted.
+ */
+class PayloadSizePredictor
+{
+public:
+	/** @brief The prediction made before any sample is counted. */
+	static constexpr std::size_t cInitialPrediction = 8;
+
+	/** @brief Constructs a predictor without samples. */
+	PayloadSizePredictor();
+
+	/** @brief Returns the predicted size of the next payload. */
+	std::size_t predict() const { return mPrediction; }
+
+	/** @brief Counts the size of a serialized payload. */
+	void record(const std::size_t payloadSize)
+	{
+		const unsigned int bucket = bucketOf(payloadSize);
+		++mCounts[bucket];
+		if (payloadSize > mMaxSizes[bucket]) {
+			mMaxSizes[bucket] = payloadSize;
+		}
+		++mTotal;
+		if (++mSinceUpdate >= cUpdateInterval || mTotal < cUpdateInterval) {
+			update();
+		}
+	}
+
+private:
+	/** @brief The number of buckets, one per bit length of a size. */
+	static constexpr unsigned int cBuckets = 8 * sizeof(unsigned long long) + 1;
+	/** @brief The number of samples between prediction updates. */
+	static constexpr std::uint32_t cUpdateInterval = 64;
+	/** @brief The number of samples after which all counts are halved. */
+	static constexpr std::uint32_t cDecayThreshold = 4096;
+	/** @brief The predicted percentile, in percent. */
+	static constexpr std::uint32_t cPercentile = 95;
+
+	/** @brief Returns the bucket of `payloadSize`, i.e. its bit length. */
+	static unsigned int bucketOf(const std::size_t payloadSize)
+	{
+		return payloadSize == 0 ? 0 : cBuckets - 1 - __builtin_clzll(payloadSize);
+	}
+
+	/** @brief Recomputes the prediction, halving the counts first if
+	 * `cDecayThreshold` is reached. */
+	void update();
+
+	/** @brief The (decayed) number of samples per bucket. */
+	std::uint32_t mCounts[cBuckets];
+	/** @brief The largest size counted by each nonempty bucket. */
+	std::size_t mMaxSizes[cBuckets];
+	/** @brief The sum of `mCounts`. */
+	std::uint32_t mTotal;
+	/** @brief The number of samples since the last update. */
+	std::uint32_t mSinceUpdate;
+	/** @brief The current prediction. */
+	std::size_t mPrediction;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
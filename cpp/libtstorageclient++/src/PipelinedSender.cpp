@@ -0,0 +1,137 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PipelinedSender.cpp
+ *   A background writer flushing filled PUT/A buffers to a socket.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PipelinedSender.h"
+
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Buffer.h"
+#include "Socket.h"
+
+namespace tstorage {
+namespace impl {
+
+PipelinedSender::PipelinedSender(Socket& socket, const std::size_t depth)
+	: mSocket(&socket)
+	, mDepth(depth)
+	, mAllocated(1)
+	, mBusy(false)
+	, mStop(false)
+	, mError(result_t::OK)
+{
+	mThread = std::thread(&PipelinedSender::run, this);
+}
+
+PipelinedSender::~PipelinedSender()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mCondition.notify_all();
+	mThread.join();
+}
+
+result_t PipelinedSender::submit(Buffer& ioBuffer, bool& oAllocated)
+{
+	oAllocated = false;
+	std::unique_lock<std::mutex> lock(mMutex);
+	mCondition.wait(lock, [this]() {
+		return mError != result_t::OK || !mFree.empty() || mAllocated < mDepth;
+	});
+	if (mError != result_t::OK) {
+		return mError;
+	}
+
+	Buffer next{};
+	if (!mFree.empty() && mFree.back().capacity() == ioBuffer.capacity()) {
+		next = std::move(mFree.back());
+		mFree.pop_back();
+	} else {
+		next = Buffer(ioBuffer.capacity(), Buffer::LINEAR, ioBuffer.allocation());
+		if (!next) {
+			return result_t::OUT_OF_MEMORY;
+		}
+		oAllocated = true;
+		if (mFree.empty()) {
+			++mAllocated;
+		} else {
+			mFree.pop_back();
+		}
+	}
+
+	mPending.push_back(std::move(ioBuffer));
+	ioBuffer = std::move(next);
+	lock.unlock();
+	mCondition.notify_all();
+	return result_t::OK;
+}
+
+result_t PipelinedSender::drain()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mCondition.wait(lock, [this]() { return mPending.empty() && !mBusy; });
+	const result_t res = mError;
+	mError = result_t::OK;
+	return res;
+}
+
+void PipelinedSender::run()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mCondition.wait(lock, [this]() { return mStop || !mPending.empty(); });
+		if (mStop) {
+			return;
+		}
+
+		Buffer buffer = std::move(mPending.front());
+		mPending.pop_front();
+		mBusy = true;
+		lock.unlock();
+
+		std::size_t amountSent = 0;
+		const result_t res =
+			mSocket->send(buffer.readData(), buffer.bytesAvailableToRead(), amountSent);
+		buffer.reset();
+
+		lock.lock();
+		mBusy = false;
+		mFree.push_back(std::move(buffer));
+		if (res != result_t::OK && mError == result_t::OK) {
+			mError = res;
+			while (!mPending.empty()) {
+				mPending.front().reset();
+				mFree.push_back(std::move(mPending.front()));
+				mPending.pop_front();
+			}
+		}
+		mCondition.notify_all();
+	}
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
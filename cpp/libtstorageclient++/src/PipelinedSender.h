@@ -0,0 +1,141 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PipelinedSender.h
+ *   A background writer flushing filled PUT/A buffers to a socket.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PIPELINEDSENDER_PH
+#define D_TSTORAGE_PIPELINEDSENDER_PH
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Buffer.h"
+#include "Socket.h"
+
+/** @file
+ * @brief Defines a background sender used by pipelined PUT/A requests. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief A single-threaded background writer for filled send buffers.
+ *
+ * The sender owns a pool of at most `depth` buffers of equal capacity. The
+ * foreground thread serializes records into one of them, and once it is full,
+ * hands it over to the sender with `submit()`, receiving an empty buffer from
+ * the pool in exchange. The sender thread writes handed-over buffers to the
+ * socket in submission order and returns them to the pool afterwards. This
+ * way, the serialization of the next chunk of records overlaps with sending
+ * the previous one, and at most `depth - 1` buffers are in flight at any
+ * time.
+ *
+ * The first send error is sticky: once it occurs, all pending buffers are
+ * discarded and every subsequent `submit()` or `drain()` call reports it. The
+ * error is cleared by `drain()`, which also waits until all submitted buffers
+ * have been written.
+ *
+ * The socket must not be used by the foreground thread while any buffers are
+ * in flight, i.e. between a `submit()` call and the next `drain()`.
+ */
+class PipelinedSender
+{
+public:
+	/**
+	 * @brief A constructor. Starts the sender thread.
+	 * @param socket A connected socket to write the buffers to.
+	 * @param depth The total amount of buffers managed by the sender (including
+	 * the one that is currently filled by the foreground thread). Must be at
+	 * least `2`.
+	 */
+	PipelinedSender(Socket& socket, std::size_t depth);
+	/** @brief A destructor. Waits for the sender thread to finish. Buffers that
+	 * were not written by then are discarded. */
+	~PipelinedSender();
+
+	PipelinedSender(const PipelinedSender&) = delete;
+	PipelinedSender(PipelinedSender&&) = delete;
+	PipelinedSender& operator=(const PipelinedSender&) = delete;
+	PipelinedSender& operator=(PipelinedSender&&) = delete;
+
+	/**
+	 * @brief Enqueues the content of `ioBuffer` for sending and replaces it with
+	 * an empty buffer of the same capacity.
+	 *
+	 * Blocks while all `depth` buffers are in use. New buffers are allocated
+	 * lazily, up to the total of `depth`.
+	 *
+	 * The possible error codes are those of `Socket::send()` (reported from the
+	 * previous writes) and `result_t::OUT_OF_MEMORY`. On error, `ioBuffer` is
+	 * left untouched.
+	 *
+	 * @param[in, out] ioBuffer A filled buffer to send; on success, an empty one.
+	 * @param[out] oAllocated Set to `true` if the empty buffer was allocated
+	 * rather than reused.
+	 * @return The status code.
+	 */
+	result_t submit(Buffer& ioBuffer, bool& oAllocated);
+	/**
+	 * @brief Waits until every submitted buffer has been written, then reports
+	 * and clears the first error that occurred since the last `drain()`.
+	 * @return The status code.
+	 */
+	result_t drain();
+	/** @brief Returns the amount of buffers managed by the sender. */
+	std::size_t depth() const { return mDepth; }
+
+private:
+	/** @brief The main loop of the sender thread. */
+	void run();
+
+	/** @brief The socket to write the buffers to. */
+	Socket* mSocket;
+	/** @brief The maximal amount of buffers in use. */
+	std::size_t mDepth;
+	/** @brief The amount of buffers allocated so far (including the one held by
+	 * the foreground thread). */
+	std::size_t mAllocated;
+	/** @brief Buffers waiting to be written, in submission order. */
+	std::deque<Buffer> mPending;
+	/** @brief Written buffers ready for reuse. */
+	std::vector<Buffer> mFree;
+	/** @brief `true` while the sender thread is writing a buffer. */
+	bool mBusy;
+	/** @brief `true` when the sender thread is requested to exit. */
+	bool mStop;
+	/** @brief The first error reported since the last `drain()`. */
+	result_t mError;
+	/** @brief Guards all of the fields above. */
+	std::mutex mMutex;
+	/** @brief Signals state changes to both threads. */
+	std::condition_variable mCondition;
+	/** @brief The sender thread. */
+	std::thread mThread;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
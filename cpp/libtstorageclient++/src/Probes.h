@@ -0,0 +1,80 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * Probes.h
+ *   Static tracepoints (USDT probes) on the hot paths of the library.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PROBES_PH
+#define D_TSTORAGE_PROBES_PH
+
+/** @file
+ * @brief Defines the `TSTORAGE_PROBE` macros placing the static tracepoints
+ * of the library.
+ *
+ * With `D_TSTORAGE_USDT` defined (`make USDT=1`, which needs `sys/sdt.h` of
+ * SystemTap), each macro places a USDT probe of the `tstorage` provider,
+ * which `bpftrace`, `perf` and other tools can attach to at run time, e.g.
+ *
+ * @code
+ * bpftrace -e 'usdt:lib/libtstorageclient++.so:tstorage:socket__send__return
+ *     { @bytes = hist(arg1); }'
+ * @endcode
+ *
+ * A probe which is not attached to costs a single `nop` instruction, and its
+ * arguments are evaluated only as far as they are not already in registers.
+ * Without `D_TSTORAGE_USDT`, the macros expand to nothing and their arguments
+ * are not evaluated.
+ *
+ * The probes, with their arguments, are:
+ *  - `command__start(cmd)` once a request is written, and
+ *    `command__finish(cmd, status, latencyUs)` once its response has been
+ *    read, `cmd` being the command ID of the protocol and `status` a
+ *    `result_t`;
+ *  - `send__buffer__entry(bytes)` and `send__buffer__return(status)` around
+ *    the sends of the buffered requests and records;
+ *  - `socket__send__entry(fd, bytes)`, `socket__send__return(fd, bytes,
+ *    status)`, and the same for `socket__recv`, around each send and receive
+ *    of a socket, `bytes` being the requested then the transferred amount;
+ *  - `put__batch(cid, bytes)` at the end of each batch of PUT/A records;
+ *  - `buffer__compact(bytes, mirrored)` each time a buffer moves its unread
+ *    content, or its window, to make room.
+ */
+
+#ifdef D_TSTORAGE_USDT
+
+#include <sys/sdt.h>
+
+#define TSTORAGE_PROBE1(name, a) DTRACE_PROBE1(tstorage, name, a)
+#define TSTORAGE_PROBE2(name, a, b) DTRACE_PROBE2(tstorage, name, a, b)
+#define TSTORAGE_PROBE3(name, a, b, c) DTRACE_PROBE3(tstorage, name, a, b, c)
+
+#else
+
+#define TSTORAGE_PROBE1(name, a) \
+	do {                         \
+	} while (false)
+#define TSTORAGE_PROBE2(name, a, b) \
+	do {                            \
+	} while (false)
+#define TSTORAGE_PROBE3(name, a, b, c) \
+	do {                               \
+	} while (false)
+
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutChunk.cpp
+ *   PUT/A batches serialized apart from the channel's buffer.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PutChunk.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <sys/uio.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "BatchSerializer.h"
+#include "Buffer.h"
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::size_t PutChunk::cSegmentSize;
+
+namespace {
+
+std::vector<std::unique_ptr<Buffer>> makeSegments()
+{
+	std::vector<std::unique_ptr<Buffer>> segments;
+	segments.push_back(std::make_unique<Buffer>(PutChunk::cSegmentSize));
+	return segments;
+}
+
+} /*namespace*/
+
+PutChunk::PutChunk()
+	: mSegments(makeSegments())
+	, mSegmentsUsed(1)
+	, mMemoryLimit(cSegmentSize)
+	, mBatches(0)
+	, mBatch(*mSegments[0])
+{
+}
+
+void PutChunk::reset(const std::size_t memoryLimit)
+{
+	for (std::size_t i = 0; i < mSegmentsUsed; ++i) {
+		mSegments[i]->reset();
+	}
+	// A failed allocation is retried.
+	if (!*mSegments[0]) {
+		*mSegments[0] = Buffer(cSegmentSize);
+	}
+	mSegmentsUsed = 1;
+	mMemoryLimit = memoryLimit;
+	mBatches = 0;
+	mBatch = BatchSerializer(*mSegments[0]);
+}
+
+result_t PutChunk::reservePayloadBuffer(void*& oPayloadBuffer,
+	std::size_t& oBufferSize,
+	const std::size_t payloadSize,
+	const Key& key,
+	const std::size_t keySize)
+{
+	oPayloadBuffer = nullptr;
+	oBufferSize = 0;
+
+	Buffer* segment = mSegments[mSegmentsUsed - 1].get();
+	std::size_t recordOffset = mBatch.getNextRecordOffset(key.cid);
+	const std::size_t payloadOffset = keySize + sizeof(std::int32_t);
+
+	if (recordOffset + payloadOffset + payloadSize > segment->bytesOfFreeSpace()) {
+		const std::size_t required =
+			BatchSerializer::cBatchHeaderSize + payloadOffset + payloadSize;
+		if (required > mMemoryLimit) {
+			return result_t::MEMORY_LIMIT_EXCEEDED;
+		}
+		// An empty segment is replaced rather than left empty.
+		if (segment->writeOffset() != 0) {
+			mBatch.endBatch();
+			++mSegmentsUsed;
+		}
+		if (mSegmentsUsed > mSegments.size()) {
+			mSegments.push_back(std::make_unique<Buffer>());
+		}
+		segment = mSegments[mSegmentsUsed - 1].get();
+		if (!*segment || segment->capacity() < required) {
+			*segment = Buffer(std::max(std::min(cSegmentSize, mMemoryLimit), required));
+			if (!*segment) {
+				return result_t::MEMORY_LIMIT_EXCEEDED;
+			}
+		}
+		mBatch = BatchSerializer(*segment);
+		recordOffset = mBatch.getNextRecordOffset(key.cid);
+	}
+
+	const std::size_t totalOffset = recordOffset + payloadOffset;
+	oPayloadBuffer = segment->writeData(totalOffset);
+	oBufferSize = segment->bytesOfFreeSpace() - totalOffset;
+	return result_t::OK;
+}
+
+template<BatchSerializer::ProtoT PutProtocol>
+void PutChunk::putRecord(const Key& key, const std::size_t payloadSize)
+{
+	if (mBatch.getNextRecordOffset(key.cid) != 0) {
+		++mBatches;
+	}
+	mBatch.putRecord<PutProtocol>(key, payloadSize);
+}
+
+void PutChunk::appendTo(std::vector<struct iovec>& ioIov) const
+{
+	for (std::size_t i = 0; i < mSegmentsUsed; ++i) {
+		const Buffer& segment = *mSegments[i];
+		if (segment.bytesAvailableToRead() != 0) {
+			// clang-format off
+			struct iovec block{};
+			// clang-format on
+			// `struct iovec` is shared by reads and writes, hence the const cast.
+			block.iov_base = const_cast<void*>(segment.readData()); /* NOLINT(cppcoreguidelines-pro-type-const-cast) */
+			block.iov_len = segment.bytesAvailableToRead();
+			ioIov.push_back(block);
+		}
+	}
+}
+
+/***************
+ * Explicit template instantiations
+ */
+
+template void PutChunk::putRecord<BatchSerializer::ProtoT::PUT>(
+	const Key& key, std::size_t payloadSize);
+template void PutChunk::putRecord<BatchSerializer::ProtoT::PUTA>(
+	const Key& key, std::size_t payloadSize);
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,122 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutChunk.h
+ *   PUT/A batches serialized apart from the channel's buffer.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTCHUNK_PH
+#define D_TSTORAGE_PUTCHUNK_PH
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <sys/uio.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "BatchSerializer.h"
+#include "Buffer.h"
+
+/** @file
+ * @brief Defines a chunk of PUT/A batches serialized on a worker thread. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief A growable run of PUT/A batches, serialized independently of the
+ * channel's buffer and sent after it as it is.
+ *
+ * The batches are laid out exactly like in the channel's buffer (see
+ * `BatchSerializer`), over one or more segments: once a record doesn't fit
+ * the current segment, its batch is ended and the record goes to the next
+ * segment, allocated on demand. The segments are kept between uses, so that
+ * a chunk reused for consecutive slices of records allocates no memory once
+ * warmed up.
+ *
+ * A chunk is used by one thread at a time. The records are appended with the
+ * `reservePayloadBuffer()`/`putRecord()` sequence, as with the channel's
+ * buffer, and the chunk is ended with `endBatch()` before being sent.
+ */
+class PutChunk
+{
+public:
+	/** @brief The capacity of a segment unless a record needs more. */
+	static constexpr std::size_t cSegmentSize = 256UL * 1024;  // 256 KiB
+
+	/** @brief A constructor. Allocates the first segment. */
+	PutChunk();
+
+	/**
+	 * @brief Empties the chunk, keeping its segments.
+	 * @param memoryLimit The maximal capacity of a segment, which bounds the
+	 * size of a single record like the channel's memory limit does.
+	 */
+	void reset(std::size_t memoryLimit);
+	/**
+	 * @brief Supplies a writable buffer of at least `payloadSize` bytes for the
+	 * payload of the next record, moving on to the next segment if necessary.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::MEMORY_LIMIT_EXCEEDED` if the record doesn't fit a segment
+	 *    of the capacity given to `reset()` or the allocation fails.
+	 *
+	 * @param[out] oPayloadBuffer A writable memory chunk for the payload.
+	 * @param[out] oBufferSize The size of the memory chunk.
+	 * @param[in] payloadSize The size of the payload, `0` if unknown.
+	 * @param[in] key The key of the record.
+	 * @param[in] keySize The size of the serialized key.
+	 * @return Status code.
+	 */
+	result_t reservePayloadBuffer(void*& oPayloadBuffer,
+		std::size_t& oBufferSize,
+		std::size_t payloadSize,
+		const Key& key,
+		std::size_t keySize);
+	/**
+	 * @brief Appends the record the payload of which was serialized to the
+	 * buffer supplied by `reservePayloadBuffer()`.
+	 * @see `BatchSerializer::putRecord()`
+	 */
+	template<BatchSerializer::ProtoT PutProtocol>
+	void putRecord(const Key& key, std::size_t payloadSize);
+	/** @brief Ends the current batch. */
+	void endBatch() { mBatch.endBatch(); }
+
+	/** @brief Appends the memory blocks of the used segments to `ioIov`. */
+	void appendTo(std::vector<struct iovec>& ioIov) const;
+	/** @brief Returns the amount of batches started since `reset()`. */
+	std::size_t batches() const { return mBatches; }
+
+private:
+	/** @brief The segments, of which the first `mSegmentsUsed` hold data. */
+	std::vector<std::unique_ptr<Buffer>> mSegments;
+	/** @brief The amount of segments holding data. */
+	std::size_t mSegmentsUsed;
+	/** @brief The maximal capacity of a segment. */
+	std::size_t mMemoryLimit;
+	/** @brief The amount of batches started since `reset()`. */
+	std::size_t mBatches;
+	/** @brief The serializer of the last used segment. */
+	BatchSerializer mBatch;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
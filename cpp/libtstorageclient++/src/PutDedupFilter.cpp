@@ -0,0 +1,239 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutDedupFilter.cpp
+ *   An implementation of a filter of PUTA records already acknowledged.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tstorageclient++/PutDedupFilter.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Defines.h"
+
+namespace tstorage {
+
+constexpr std::size_t PutDedupFilter::cDefaultCapacity;
+
+namespace {
+
+/** @brief The first bytes of a file written by `PutDedupFilter::save()`. */
+constexpr char cMagic[8] = {'T', 'S', 'D', 'E', 'D', 'U', 'P', '1'};
+/** @brief The amount of fingerprints read or written at once. */
+constexpr std::size_t cChunkFingerprints = 4096;
+
+/** @brief Mixes `value` into `hash`. */
+std::uint64_t mix(std::uint64_t hash, const std::uint64_t value)
+{
+	hash ^= value;
+	// The finalizer of MurmurHash3.
+	hash ^= hash >> 33U;
+	hash *= 0xFF51AFD7ED558CCDULL;
+	hash ^= hash >> 33U;
+	hash *= 0xC4CEB9FE1A85EC53ULL;
+	hash ^= hash >> 33U;
+	return hash;
+}
+
+/** @brief Writes `size` bytes to `fd`, returning `false` on failure. */
+bool writeAll(const int fd, const void* const bytes, const std::size_t size)
+{
+	const unsigned char* next = static_cast<const unsigned char*>(bytes);
+	std::size_t left = size;
+	while (left != 0) {
+		const ssize_t written = ::write(fd, next, left);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		next += written;
+		left -= static_cast<std::size_t>(written);
+	}
+	return true;
+}
+
+/** @brief Reads `size` bytes from `fd`, returning `false` on failure or
+ * at the end of the file. */
+bool readAll(const int fd, void* const bytes, const std::size_t size)
+{
+	unsigned char* next = static_cast<unsigned char*>(bytes);
+	std::size_t left = size;
+	while (left != 0) {
+		const ssize_t amount = ::read(fd, next, left);
+		if (amount < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		if (amount == 0) {
+			return false;
+		}
+		next += amount;
+		left -= static_cast<std::size_t>(amount);
+	}
+	return true;
+}
+
+} /*namespace*/
+
+TSTORAGE_EXPORT PutDedupFilter::PutDedupFilter(const std::size_t capacity)
+	: mCapacity(std::max<std::size_t>(capacity, 1))
+{
+}
+
+TSTORAGE_EXPORT std::uint64_t PutDedupFilter::fingerprint(
+	const Key& key, const void* const payload, const std::size_t size)
+{
+	std::uint64_t hash = mix(static_cast<std::uint64_t>(size),
+		(static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.cid)) << 32U)
+			| static_cast<std::uint32_t>(key.moid));
+	hash = mix(hash, static_cast<std::uint64_t>(key.mid));
+	hash = mix(hash, static_cast<std::uint64_t>(key.cap));
+	hash = mix(hash, static_cast<std::uint64_t>(key.acq));
+
+	const unsigned char* bytes = static_cast<const unsigned char*>(payload);
+	std::size_t left = size;
+	for (; left >= sizeof(std::uint64_t); left -= sizeof(std::uint64_t)) {
+		std::uint64_t word{};
+		std::memcpy(&word, bytes, sizeof(word));
+		hash = mix(hash, word);
+		bytes += sizeof(word);
+	}
+	if (left != 0) {
+		std::uint64_t word{};
+		std::memcpy(&word, bytes, left);
+		hash = mix(hash, word);
+	}
+	return hash;
+}
+
+TSTORAGE_EXPORT bool PutDedupFilter::contains(const std::uint64_t fingerprint) const
+{
+	const std::lock_guard<std::mutex> lock(mMutex);
+	return mSet.count(fingerprint) != 0;
+}
+
+TSTORAGE_EXPORT void PutDedupFilter::insert(const std::vector<std::uint64_t>& fingerprints)
+{
+	const std::lock_guard<std::mutex> lock(mMutex);
+	for (const std::uint64_t fingerprint : fingerprints) {
+		insertLocked(fingerprint);
+	}
+}
+
+TSTORAGE_EXPORT void PutDedupFilter::clear()
+{
+	const std::lock_guard<std::mutex> lock(mMutex);
+	mSet.clear();
+	mOrder.clear();
+}
+
+TSTORAGE_EXPORT std::size_t PutDedupFilter::size() const
+{
+	const std::lock_guard<std::mutex> lock(mMutex);
+	return mOrder.size();
+}
+
+TSTORAGE_EXPORT result_t PutDedupFilter::save(const std::string& path) const
+{
+	const std::string temporary = path + ".tmp";
+	const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd == -1) {
+		return result_t::FILE_ERROR;
+	}
+
+	bool written = false;
+	{
+		const std::lock_guard<std::mutex> lock(mMutex);
+		const std::uint64_t count = mOrder.size();
+		written = writeAll(fd, cMagic, sizeof(cMagic)) && writeAll(fd, &count, sizeof(count));
+		std::vector<std::uint64_t> chunk;
+		chunk.reserve(cChunkFingerprints);
+		for (auto it = mOrder.begin(); written && it != mOrder.end();) {
+			chunk.clear();
+			for (; it != mOrder.end() && chunk.size() < cChunkFingerprints; ++it) {
+				chunk.push_back(*it);
+			}
+			written = writeAll(fd, chunk.data(), chunk.size() * sizeof(std::uint64_t));
+		}
+	}
+	written = written && ::fsync(fd) == 0;
+	written = ::close(fd) == 0 && written;
+	if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+		(void)::unlink(temporary.c_str());
+		return result_t::FILE_ERROR;
+	}
+	return result_t::OK;
+}
+
+TSTORAGE_EXPORT result_t PutDedupFilter::load(const std::string& path)
+{
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		return errno == ENOENT ? result_t::OK : result_t::FILE_ERROR;
+	}
+
+	char magic[sizeof(cMagic)]{};
+	std::uint64_t count{};
+	if (!readAll(fd, magic, sizeof(magic)) || std::memcmp(magic, cMagic, sizeof(cMagic)) != 0
+		|| !readAll(fd, &count, sizeof(count))) {
+		::close(fd);
+		return result_t::FILE_ERROR;
+	}
+	std::vector<std::uint64_t> chunk;
+	while (count != 0) {
+		chunk.resize(static_cast<std::size_t>(std::min<std::uint64_t>(count, cChunkFingerprints)));
+		if (!readAll(fd, chunk.data(), chunk.size() * sizeof(std::uint64_t))) {
+			::close(fd);
+			return result_t::FILE_ERROR;
+		}
+		insert(chunk);
+		count -= chunk.size();
+	}
+	::close(fd);
+	return result_t::OK;
+}
+
+void PutDedupFilter::insertLocked(const std::uint64_t fingerprint)
+{
+	if (!mSet.insert(fingerprint).second) {
+		return;
+	}
+	mOrder.push_back(fingerprint);
+	if (mOrder.size() > mCapacity) {
+		mSet.erase(mOrder.front());
+		mOrder.pop_front();
+	}
+}
+
+} /*namespace tstorage*/
@@ -0,0 +1,177 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutFlowController.cpp
+ *   AIMD pacing and command sizing of PUT/A requests.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PutFlowController.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::uint32_t PutFlowController::cSendTimeoutDivisor;
+constexpr std::uint32_t PutFlowController::cAckTimeoutDivisor;
+constexpr std::int64_t PutFlowController::cIncreaseIntervalMs;
+constexpr std::uint64_t PutFlowController::cRecoveryFactor;
+
+namespace {
+
+/** @brief The gap between flushes beyond which the channel is taken as idle
+ * rather than slow. */
+constexpr std::chrono::seconds cIdleGap(1);
+
+/** @brief Returns `duration` in microseconds. */
+std::uint64_t toUs(const PutFlowController::Clock::duration duration)
+{
+	const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+	return us > 0 ? static_cast<std::uint64_t>(us) : 0;
+}
+
+/** @brief Returns the fraction `1 / divisor` of `timeoutMs`, or no threshold
+ * at all without a timeout. */
+std::uint32_t fractionOf(const std::uint32_t timeoutMs, const std::uint32_t divisor)
+{
+	if (timeoutMs == 0) {
+		return std::numeric_limits<std::uint32_t>::max();
+	}
+	return std::max<std::uint32_t>(timeoutMs / divisor, 1);
+}
+
+} /*namespace*/
+
+PutFlowController::PutFlowController()
+	: mOptions{}
+	, mRate(0)
+	, mAchievedRate(0)
+	, mBackoffRate(0)
+	, mCommandBuffers(0)
+	, mBackoffBuffers(0)
+	, mNextSend{}
+	, mLastSend{}
+	, mLastBackoff{}
+	, mBackoffs(0)
+{
+}
+
+void PutFlowController::configure(const PutFlowControl& options)
+{
+	mOptions = options;
+	if (!options.enabled) {
+		mRate = 0;
+		mAchievedRate = 0;
+		mCommandBuffers = 0;
+		mNextSend = Clock::time_point{};
+		mLastSend = Clock::time_point{};
+		mLastBackoff = Clock::time_point{};
+	}
+}
+
+PutFlowController::Clock::time_point PutFlowController::pace(
+	const Clock::time_point now, const std::size_t bytes)
+{
+	if (mRate == 0) {
+		return now;
+	}
+	const Clock::time_point start = std::max(now, mNextSend);
+	mNextSend = start + std::chrono::microseconds(bytes * 1'000'000 / mRate);
+	return start;
+}
+
+void PutFlowController::onSend(const Clock::time_point start,
+	const Clock::time_point end,
+	const std::size_t bytes,
+	const std::size_t buffers,
+	const std::uint32_t timeoutMs)
+{
+	const Clock::time_point last = mLastSend;
+	mLastSend = end;
+	const bool idle = last == Clock::time_point{} || end - last > cIdleGap;
+	if (!idle) {
+		const std::uint64_t elapsedUs = std::max<std::uint64_t>(toUs(end - last), 1);
+		const std::uint64_t sample = bytes * 1'000'000 / elapsedUs;
+		mAchievedRate = mAchievedRate == 0 ? sample : (mAchievedRate * 7 + sample) / 8;
+	}
+
+	const std::uint32_t thresholdMs = sendThresholdMs(timeoutMs);
+	if (toUs(end - start) > std::uint64_t{thresholdMs} * 1000) {
+		backOff(end, buffers, thresholdMs);
+		return;
+	}
+	if (mRate == 0 || idle) {
+		return;
+	}
+	mRate += mOptions.minRateBytes * toUs(end - last) / (cIncreaseIntervalMs * 1000);
+	if (mRate >= cRecoveryFactor * mBackoffRate) {
+		mRate = 0;
+	}
+}
+
+void PutFlowController::onAck(const Clock::time_point sent,
+	const Clock::time_point received,
+	const std::size_t buffers,
+	const std::uint32_t timeoutMs)
+{
+	if (toUs(received - sent) > std::uint64_t{ackThresholdMs(timeoutMs)} * 1000) {
+		backOff(received, buffers, sendThresholdMs(timeoutMs));
+		return;
+	}
+	if (mCommandBuffers != 0 && ++mCommandBuffers >= cRecoveryFactor * mBackoffBuffers) {
+		mCommandBuffers = 0;
+	}
+}
+
+void PutFlowController::backOff(
+	const Clock::time_point now, const std::size_t buffers, const std::uint32_t thresholdMs)
+{
+	if (mLastBackoff != Clock::time_point{}
+		&& toUs(now - mLastBackoff) <= std::uint64_t{thresholdMs} * 1000) {
+		return;
+	}
+	mLastBackoff = now;
+	++mBackoffs;
+
+	const std::uint64_t rate = mRate != 0 ? mRate : mAchievedRate;
+	if (rate != 0) {
+		mRate = std::max(rate / 2, mOptions.minRateBytes);
+		mBackoffRate = mRate;
+	}
+	const std::size_t commandBuffers = mCommandBuffers != 0 ? std::min(mCommandBuffers, buffers) : buffers;
+	mCommandBuffers = std::max<std::size_t>(commandBuffers / 2, 1);
+	mBackoffBuffers = mCommandBuffers;
+}
+
+std::uint32_t PutFlowController::sendThresholdMs(const std::uint32_t timeoutMs) const
+{
+	return mOptions.sendBlockMs != 0 ? mOptions.sendBlockMs : fractionOf(timeoutMs, cSendTimeoutDivisor);
+}
+
+std::uint32_t PutFlowController::ackThresholdMs(const std::uint32_t timeoutMs) const
+{
+	return mOptions.ackLatencyMs != 0 ? mOptions.ackLatencyMs : fractionOf(timeoutMs, cAckTimeoutDivisor);
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,163 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * PutFlowController.h
+ *   AIMD pacing and command sizing of PUT/A requests.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_PUTFLOWCONTROLLER_PH
+#define D_TSTORAGE_PUTFLOWCONTROLLER_PH
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines the flow control of PUT/A requests. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief Paces the buffers of PUT/A requests and bounds the size of their
+ * commands, backing off when the server slows down.
+ *
+ * Two signals tell that the server falls behind: a flush of the send buffer
+ * blocking for longer than the send threshold, as the socket buffers are full,
+ * and the result of a command taking longer than the ack threshold to arrive.
+ * Both thresholds default to fractions of the channel timeout, so that the
+ * controller reacts well before a transfer times out.
+ *
+ * On either signal, the controller halves the pacing rate, starting from the
+ * rate actually achieved if the buffers were not paced yet, and the amount of
+ * buffers a command may take, starting from those of the current command.
+ * Signals following a decrease within the send threshold are taken as the
+ * same congestion. While no signal comes, the rate grows by
+ * `PutFlowControl::minRateBytes` every `cIncreaseIntervalMs` of sending, and
+ * each timely result lets commands take one buffer more. Once either is back
+ * at `cRecoveryFactor` times its value after the last back-off, it is no
+ * longer bounded.
+ */
+class PutFlowController
+{
+public:
+	/** @brief The clock of the controller. */
+	using Clock = std::chrono::steady_clock;
+
+	/** @brief The fraction of the timeout a flush may block for by default,
+	 * as a divisor. */
+	static constexpr std::uint32_t cSendTimeoutDivisor = 8;
+	/** @brief The fraction of the timeout a result may take by default, as a
+	 * divisor. */
+	static constexpr std::uint32_t cAckTimeoutDivisor = 4;
+	/** @brief The time over which the rate grows by the smallest rate. */
+	static constexpr std::int64_t cIncreaseIntervalMs = 100;
+	/** @brief The multiple of its value after a back-off at which a bound
+	 * is lifted. */
+	static constexpr std::uint64_t cRecoveryFactor = 4;
+
+	/** @brief Constructs a disabled controller. */
+	PutFlowController();
+
+	/** @brief Sets the options, dropping the state if disabled. */
+	void configure(const PutFlowControl& options);
+	/** @brief Returns `true` if the flow control is enabled. */
+	bool enabled() const { return mOptions.enabled; }
+
+	/**
+	 * @brief Returns the time a flush of `bytes` may start at, and books the
+	 * pacing slot for it.
+	 * @param now The current time.
+	 * @param bytes The amount of bytes of the flush.
+	 */
+	Clock::time_point pace(Clock::time_point now, std::size_t bytes);
+	/**
+	 * @brief Counts a flush of the send buffer.
+	 * @param start The time the flush started at, after pacing.
+	 * @param end The time the flush returned at.
+	 * @param bytes The amount of bytes flushed.
+	 * @param buffers The amount of buffers the command has taken.
+	 * @param timeoutMs The socket timeout in milliseconds.
+	 */
+	void onSend(Clock::time_point start,
+		Clock::time_point end,
+		std::size_t bytes,
+		std::size_t buffers,
+		std::uint32_t timeoutMs);
+	/**
+	 * @brief Counts the result of a command.
+	 * @param sent The time the end of the command was sent at.
+	 * @param received The time the result arrived at.
+	 * @param buffers The amount of buffers the command took.
+	 * @param timeoutMs The socket timeout in milliseconds.
+	 */
+	void onAck(Clock::time_point sent,
+		Clock::time_point received,
+		std::size_t buffers,
+		std::uint32_t timeoutMs);
+	/** @brief Returns `true` if a command which took `buffers` buffers is to
+	 * be ended before its next buffer. */
+	bool splitDue(const std::size_t buffers) const
+	{
+		return mCommandBuffers != 0 && buffers >= mCommandBuffers;
+	}
+
+	/** @brief Returns the pacing rate in bytes per second, `0` if unpaced. */
+	std::uint64_t rate() const { return mRate; }
+	/** @brief Returns the amount of buffers a command may take, `0` if
+	 * unbounded. */
+	std::size_t commandBuffers() const { return mCommandBuffers; }
+	/** @brief Returns the amount of back-offs so far. */
+	std::uint64_t backoffs() const { return mBackoffs; }
+
+private:
+	/** @brief Halves the rate and the command size, unless a back-off
+	 * happened within `thresholdMs`. */
+	void backOff(Clock::time_point now, std::size_t buffers, std::uint32_t thresholdMs);
+	/** @brief Returns the send threshold in milliseconds. */
+	std::uint32_t sendThresholdMs(std::uint32_t timeoutMs) const;
+	/** @brief Returns the ack threshold in milliseconds. */
+	std::uint32_t ackThresholdMs(std::uint32_t timeoutMs) const;
+
+	/** @brief The options. */
+	PutFlowControl mOptions;
+	/** @brief The pacing rate in bytes per second, `0` if unpaced. */
+	std::uint64_t mRate;
+	/** @brief The rate achieved by the recent flushes in bytes per second. */
+	std::uint64_t mAchievedRate;
+	/** @brief The rate set by the last back-off. */
+	std::uint64_t mBackoffRate;
+	/** @brief The amount of buffers a command may take, `0` if unbounded. */
+	std::size_t mCommandBuffers;
+	/** @brief The amount of buffers set by the last back-off. */
+	std::size_t mBackoffBuffers;
+	/** @brief The time the next flush may start at. */
+	Clock::time_point mNextSend;
+	/** @brief The time the last flush returned at. */
+	Clock::time_point mLastSend;
+	/** @brief The time of the last back-off. */
+	Clock::time_point mLastBackoff;
+	/** @brief The amount of back-offs. */
+	std::uint64_t mBackoffs;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
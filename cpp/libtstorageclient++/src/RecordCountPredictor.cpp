@@ -0,0 +1,80 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * RecordCountPredictor.cpp
+ *   A history of the record counts of GET responses by key-interval shape.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RecordCountPredictor.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::size_t RecordCountPredictor::cMaxShapes;
+constexpr std::uint64_t RecordCountPredictor::cSmoothing;
+
+bool RecordCountPredictor::predict(
+	const Key& keyMin, const Key& keyMax, std::size_t& oRecords) const
+{
+	const auto found = mAverages.find(shapeOf(keyMin, keyMax));
+	if (found == mAverages.end()) {
+		return false;
+	}
+	oRecords = static_cast<std::size_t>(found->second);
+	return true;
+}
+
+void RecordCountPredictor::record(
+	const Key& keyMin, const Key& keyMax, const std::size_t records)
+{
+	const Shape shape = shapeOf(keyMin, keyMax);
+	const auto found = mAverages.find(shape);
+	if (found == mAverages.end()) {
+		if (mAverages.size() >= cMaxShapes) {
+			mAverages.clear();
+		}
+		mAverages.emplace(shape, records);
+		return;
+	}
+	// Rounds up, so that a steady count is reached from below as well.
+	std::uint64_t& average = found->second;
+	if (records >= average) {
+		average += (records - average + cSmoothing - 1) / cSmoothing;
+	} else {
+		average -= (average - records) / cSmoothing;
+	}
+}
+
+RecordCountPredictor::Shape RecordCountPredictor::shapeOf(const Key& keyMin, const Key& keyMax)
+{
+	// Unsigned arithmetic keeps the widths of the widest key-intervals defined.
+	const auto width = [](const std::int64_t min, const std::int64_t max) {
+		return static_cast<std::uint64_t>(max) - static_cast<std::uint64_t>(min);
+	};
+	return Shape(width(keyMin.cid, keyMax.cid),
+		width(keyMin.mid, keyMax.mid),
+		width(keyMin.moid, keyMax.moid),
+		width(keyMin.cap, keyMax.cap));
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,90 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * RecordCountPredictor.h
+ *   A history of the record counts of GET responses by key-interval shape.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_RECORDCOUNTPREDICTOR_PH
+#define D_TSTORAGE_RECORDCOUNTPREDICTOR_PH
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <tuple>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines a predictor of the amount of records of a GET response. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief Predicts the amount of records of the next GET response of a
+ * key-interval from those of the earlier ones of the same shape.
+ *
+ * Used to reserve the records container of `get()` up front, so that it is
+ * not reallocated, moving the records received so far, as it grows. The shape
+ * of a key-interval is its width in CID, MID, MOID and CAP, the ACQ bounds
+ * left out: repeated queries of sliding windows or of many series of the same
+ * kind have the same shape, whatever their position. The prediction is an
+ * exponential moving average of the counts of the shape, weighing the last
+ * one by `1 / cSmoothing`, so that it is exact for steady counts and costs a
+ * single reallocation at most for counts varying around it. Once
+ * `cMaxShapes` shapes are known, the history is dropped and started over.
+ */
+class RecordCountPredictor
+{
+public:
+	/** @brief The amount of shapes kept at most. */
+	static constexpr std::size_t cMaxShapes = 1024;
+	/** @brief The inverse of the weight of the last count. */
+	static constexpr std::uint64_t cSmoothing = 4;
+
+	/**
+	 * @brief Predicts the amount of records of a key-interval.
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @param[out] oRecords The predicted amount, set only if known.
+	 * @return `true` if a response of the same shape has been counted.
+	 */
+	bool predict(const Key& keyMin, const Key& keyMax, std::size_t& oRecords) const;
+	/**
+	 * @brief Counts the records of a response.
+	 * @param keyMin The lower vertex of the key-interval.
+	 * @param keyMax The upper vertex of the key-interval.
+	 * @param records The amount of records of the response.
+	 */
+	void record(const Key& keyMin, const Key& keyMax, std::size_t records);
+
+private:
+	/** @brief The widths of a key-interval in CID, MID, MOID and CAP. */
+	using Shape = std::tuple<std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t>;
+
+	/** @brief Returns the shape of a key-interval. */
+	static Shape shapeOf(const Key& keyMin, const Key& keyMax);
+
+	/** @brief The moving averages of the counts, by shape. */
+	std::map<Shape, std::uint64_t> mAverages;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
@@ -62,6 +62,24 @@ void Serializer::swapBytes(const void* const src, void* const dest)
 	}
 }
 
+template<>
+void Serializer::swapBytes<sizeof(std::uint32_t)>(const void* const src, void* const dest)
+{
+	std::uint32_t value{};
+	memcpy(&value, src, sizeof(value));
+	value = __builtin_bswap32(value);
+	memcpy(dest, &value, sizeof(value));
+}
+
+template<>
+void Serializer::swapBytes<sizeof(std::uint64_t)>(const void* const src, void* const dest)
+{
+	std::uint64_t value{};
+	memcpy(&value, src, sizeof(value));
+	value = __builtin_bswap64(value);
+	memcpy(dest, &value, sizeof(value));
+}
+
 template<typename T>
 void Serializer::get(T& oValue, const void* addr)
 {
@@ -131,7 +131,10 @@ private:
 	 *
 	 * The amount of bytes to copy is made a template parameter to enable some
 	 * compile-time optimizations of the inner loop. The template gets instantiated
-	 * only for sizes of C++ base types (currently `[u]int(32|64)_t` only).
+	 * only for sizes of C++ base types (currently `[u]int(32|64)_t`, `float` and
+	 * `double`). These sizes are specialized to use the compiler's byte-swap
+	 * builtins, which compile to single instructions and vectorize inside array
+	 * loops.
 	 *
 	 * @param src Source memory-block address, read-only.
 	 * @param dest Destination memory-block address, writable.
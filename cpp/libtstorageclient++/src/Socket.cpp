@@ -24,85 +24,239 @@
 #include <algorithm>
 #include <array>
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <vector>
 
-#include <netdb.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/socket.h>
+#include <sys/sendfile.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <tstorageclient++/DataTypes.h>
 
+#include "Probes.h"
+
 namespace tstorage {
 namespace impl {
 
+namespace {
+
+/** @brief Returns the total length of the `iovCount` blocks of `iov`. */
+inline std::size_t iovBytes(const struct iovec* const iov, const std::size_t iovCount)
+{
+	std::size_t bytes = 0;
+	for (std::size_t i = 0; i < iovCount; ++i) {
+		bytes += iov[i].iov_len;
+	}
+	return bytes;
+}
+
+} /*namespace*/
+
+constexpr std::int32_t Socket::cConnectAttemptDelayMs;
+constexpr std::size_t Socket::cTlsRecordSize;
+constexpr std::size_t Socket::cMaxSendFileChunk;
+
 result_t Socket::connect()
 {
 	if (mSocketFd >= 0) {
 		return result_t::OK;
 	}
-	mSocketFd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-	if (mSocketFd == -1) {
-		mErrno = errno;
-		return result_t::SOCKET_ERROR;
-	}
 
-	// clang-format off
-	struct addrinfo hints{};
-	// clang-format on
-	hints.ai_family = AF_INET;
-	hints.ai_socktype = SOCK_STREAM;
-	hints.ai_protocol = IPPROTO_TCP;
-	hints.ai_flags = 0;
-
-	struct addrinfo* ai = nullptr;
-	const std::string portStr = std::to_string(mPort);
-	if (::getaddrinfo(mAddr.c_str(), portStr.c_str(), &hints, &ai) != 0) {
-		::close(mSocketFd);
-		mSocketFd = -1;
+	const std::vector<HostResolver::Address>* addresses = nullptr;
+	if (mResolver.resolve(addresses) != result_t::OK) {
 		return result_t::BAD_ADDRESS;
 	}
+	const result_t resConnect = connectFirst(*addresses);
+	if (resConnect != result_t::OK) {
+		mResolver.invalidate();
+		return resConnect;
+	}
+	// The addresses of a host are either all local or all remote.
+	mTcp = addresses->front().family() != AF_UNIX;
+	mRecvLowWatermark = 1;
 
-	const result_t resSet = setTimeoutMs();
-	if (resSet != result_t::OK) {
+	if (setTimeoutMs() != result_t::OK
+		|| (mBusyPollUs != 0 && setBusyPollUs() != result_t::OK)) {
+		const int error = mErrno;
+		abort();
+		mErrno = error;
 		return result_t::SETOPT_ERROR;
 	}
+	if (mTlsOptions.enabled) {
+		const result_t resTls = mTls.handshake(mSocketFd, mTlsOptions, mResolver.host());
+		if (resTls != result_t::OK) {
+			const int error = errno;
+			abort();
+			mErrno = error;
+			return resTls;
+		}
+	}
+	mErrno = 0;
+	// Over TLS, the ring is of use only for the sends encrypted by the kernel.
+	if (mUseIoUring && !tlsSendsInUserspace()) {
+		// Falls back to plain syscalls if io_uring is unavailable.
+		(void)mRing.init();
+	}
+	return result_t::OK;
+}
+
+result_t Socket::connectFirst(const std::vector<HostResolver::Address>& addresses)
+{
+	using Clock = std::chrono::steady_clock;
+	using std::chrono::milliseconds;
 
 	enum ResultPrio : int {
 		OK = 0,
-		CONNREFUSED = 1,
-		CONNERROR = 2,
-		CONNTIMEOUT = 3,
+		SOCKET_ERROR = 1,
+		SETOPT_ERROR = 2,
+		CONNREFUSED = 3,
+		CONNERROR = 4,
+		CONNTIMEOUT = 5,
 	};
 	ResultPrio connResultPrio = ResultPrio::OK;
-	struct addrinfo* aiNext = ai;
-	while (aiNext != nullptr
-		&& ::connect(mSocketFd, aiNext->ai_addr, aiNext->ai_addrlen) == -1) {
-		aiNext = aiNext->ai_next;
-		mErrno = errno;
-		if (mErrno == EINTR) {
-			::freeaddrinfo(ai);
-			::close(mSocketFd);
-			mSocketFd = -1;
-			return result_t::SIGNAL;
+	const auto recordError = [this, &connResultPrio](const int error) {
+		ResultPrio prio = ResultPrio::CONNERROR;
+		if (error == ETIMEDOUT || error == EAGAIN || error == EWOULDBLOCK) {
+			prio = ResultPrio::CONNTIMEOUT;
+		} else if (error == ECONNREFUSED) {
+			prio = ResultPrio::CONNREFUSED;
+		}
+		if (prio >= connResultPrio) {
+			connResultPrio = prio;
+			mErrno = error;
+		}
+	};
+
+	const Clock::time_point start = Clock::now();
+	const bool hasDeadline = mConnectTimeoutMs != 0 || this->hasDeadline();
+	const Clock::time_point deadline = mConnectTimeoutMs != 0
+		? std::min(mDeadline, start + milliseconds(mConnectTimeoutMs))
+		: mDeadline;
+	Clock::time_point nextAttempt = start;
+	std::size_t nextAddress = 0;
+	std::vector<struct pollfd> pending;
+	const auto abandonPending = [&pending]() {
+		for (const struct pollfd& attempt : pending) {
+			::close(attempt.fd);
 		}
-		if (mErrno == ETIMEDOUT || mErrno == EAGAIN || mErrno == EWOULDBLOCK) {
-			connResultPrio = std::max(connResultPrio, ResultPrio::CONNTIMEOUT);
-		} else if (mErrno != ECONNREFUSED) {
-			connResultPrio = std::max(connResultPrio, ResultPrio::CONNERROR);
-		} else {
-			connResultPrio = std::max(connResultPrio, ResultPrio::CONNREFUSED);
+		pending.clear();
+	};
+
+	while (true) {
+		Clock::time_point now = Clock::now();
+		if (nextAddress < addresses.size() && (pending.empty() || now >= nextAttempt)) {
+			const HostResolver::Address& address = addresses[nextAddress++];
+			const int fd = ::socket(address.family(),
+				SOCK_STREAM | SOCK_NONBLOCK,
+				address.family() == AF_UNIX ? 0 : IPPROTO_TCP);
+			if (fd == -1) {
+				if (connResultPrio == ResultPrio::OK) {
+					connResultPrio = ResultPrio::SOCKET_ERROR;
+					mErrno = errno;
+				}
+				continue;
+			}
+			const int optionError = applyOptions(fd, address.family());
+			if (optionError != 0) {
+				if (connResultPrio <= ResultPrio::SETOPT_ERROR) {
+					connResultPrio = ResultPrio::SETOPT_ERROR;
+					mErrno = optionError;
+				}
+				::close(fd);
+				continue;
+			}
+			if (::connect(fd, reinterpret_cast<const struct sockaddr*>(&address.addr), address.length)
+				== 0) {
+				abandonPending();
+				pending.push_back({fd, POLLOUT, POLLOUT});
+				break;
+			}
+			if (errno != EINPROGRESS) {
+				recordError(errno);
+				::close(fd);
+				continue;
+			}
+			pending.push_back({fd, POLLOUT, 0});
+			nextAttempt = now + milliseconds(cConnectAttemptDelayMs);
+			continue;
+		}
+		if (pending.empty()) {
+			break;
+		}
+
+		if (hasDeadline && now >= deadline) {
+			recordError(ETIMEDOUT);
+			abandonPending();
+			break;
+		}
+		Clock::time_point wakeUp = hasDeadline ? deadline : Clock::time_point::max();
+		if (nextAddress < addresses.size()) {
+			wakeUp = std::min(wakeUp, nextAttempt);
+		}
+		int waitMs = -1;
+		if (wakeUp != Clock::time_point::max()) {
+			// Round up, so that the wake-up is not early.
+			const auto wait = std::chrono::duration_cast<milliseconds>(
+				wakeUp - now + milliseconds(1) - Clock::duration(1));
+			waitMs = static_cast<int>(std::min<milliseconds::rep>(
+				std::max<milliseconds::rep>(0, wait.count()), std::numeric_limits<int>::max()));
+		}
+
+		const int ready = ::poll(pending.data(), pending.size(), waitMs);
+		if (ready < 0 && errno == EINTR && mRestartOnSignal) {
+			// Bounded by the deadline checked above.
+			continue;
+		}
+		if (ready < 0) {
+			mErrno = errno;
+			abandonPending();
+			return mErrno == EINTR ? result_t::SIGNAL : result_t::CONNERROR;
+		}
+
+		bool connected = false;
+		for (std::size_t i = 0; i < pending.size();) {
+			if (pending[i].revents == 0) {
+				++i;
+				continue;
+			}
+			int error = 0;
+			socklen_t errorLength = sizeof(error);
+			if (::getsockopt(pending[i].fd, SOL_SOCKET, SO_ERROR, &error, &errorLength) < 0) {
+				error = errno;
+			}
+			if (error == 0) {
+				std::swap(pending[i], pending.front());
+				connected = true;
+				break;
+			}
+			recordError(error);
+			::close(pending[i].fd);
+			pending.erase(pending.begin() + static_cast<std::ptrdiff_t>(i));
+			// A failed attempt lets the next one start right away.
+			nextAttempt = now;
+		}
+		if (connected) {
+			break;
 		}
 	}
 
-	if (aiNext == nullptr) {
-		::freeaddrinfo(ai);
-		::close(mSocketFd);
-		mSocketFd = -1;
+	if (pending.empty() || pending.front().revents == 0) {
 		switch (connResultPrio) {
+			case ResultPrio::SOCKET_ERROR:
+				return result_t::SOCKET_ERROR;
+			case ResultPrio::SETOPT_ERROR:
+				return result_t::SETOPT_ERROR;
 			case ResultPrio::CONNREFUSED:
 				return result_t::CONNREFUSED;
 			case ResultPrio::CONNERROR:
@@ -113,8 +267,17 @@ result_t Socket::connect()
 				return result_t::BAD_ADDRESS;
 		}
 	}
-	mErrno = 0;
-	::freeaddrinfo(ai);
+
+	mSocketFd = pending.front().fd;
+	pending.erase(pending.begin());
+	abandonPending();
+	const int flags = ::fcntl(mSocketFd, F_GETFL);
+	if (flags < 0 || ::fcntl(mSocketFd, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+		mErrno = errno;
+		::close(mSocketFd);
+		mSocketFd = -1;
+		return result_t::SOCKET_ERROR;
+	}
 	return result_t::OK;
 }
 
@@ -123,7 +286,10 @@ result_t Socket::close()
 	if (mSocketFd == -1) {
 		return result_t::NOT_CONNECTED;
 	}
+	mTls.shutdown();
 	(void)shutdown(Shut::READWRITE);
+	mRing.release();
+	mTls.release();
 	if (::close(mSocketFd) < 0) {
 		mErrno = errno;
 		mSocketFd = -1;
@@ -151,6 +317,8 @@ result_t Socket::shutdown(const Socket::Shut direction)
 void Socket::abort()
 {
 	if (mSocketFd != -1) {
+		mRing.release();
+		mTls.release();
 		::close(mSocketFd);
 		mSocketFd = -1;
 	}
@@ -158,46 +326,281 @@ void Socket::abort()
 
 result_t Socket::send(
 	const void* const bytes, const std::size_t amountBytes, std::size_t& oAmountSent)
+{
+	TSTORAGE_PROBE2(socket__send__entry, mSocketFd, amountBytes);
+	oAmountSent = 0;
+	const result_t res = sendBytes(bytes, amountBytes, oAmountSent);
+	TSTORAGE_PROBE3(socket__send__return, mSocketFd, oAmountSent, static_cast<int>(res));
+	return res;
+}
+
+result_t Socket::sendBytes(
+	const void* const bytes, const std::size_t amountBytes, std::size_t& oAmountSent)
 {
 	if (mSocketFd == -1) {
 		return result_t::NOT_CONNECTED;
 	}
 	oAmountSent = 0;
 	const uint8_t* sendBuffer = static_cast<const uint8_t*>(bytes);
+	const auto start = transferStart();
 	while (oAmountSent < amountBytes) {
-		const ssize_t sent =
-			::send(mSocketFd, sendBuffer, amountBytes - oAmountSent, MSG_NOSIGNAL);
+		const result_t resWait = awaitDeadline(POLLOUT);
+		if (resWait != result_t::OK) {
+			return resWait;
+		}
+		const ssize_t sent = tlsSendsInUserspace()
+			? mTls.send(sendBuffer, amountBytes - oAmountSent)
+			: mRing.active()
+			? mRing.send(mSocketFd, sendBuffer, amountBytes - oAmountSent, MSG_NOSIGNAL, ringTimeoutMs())
+			: ::send(mSocketFd, sendBuffer, amountBytes - oAmountSent, MSG_NOSIGNAL | deadlineFlags());
+		mSendCalls.add(1);
 		if (sent < 0) {
 			mErrno = errno;
-			if (mErrno == EAGAIN || mErrno == EWOULDBLOCK) {
-				return result_t::CONNTIMEOUT;
+			if (awaitAgain(mErrno) || restartable(mErrno, start)) {
+				continue;
+			}
+			return sendErrorToResult(mErrno);
+		}
+		mBytesSent.add(sent);
+		oAmountSent += sent;
+		sendBuffer += sent;
+	}
+	return result_t::OK;
+}
+
+result_t Socket::sendv(
+	struct iovec* iov, const std::size_t iovCount, std::size_t& oAmountSent)
+{
+	TSTORAGE_PROBE2(socket__send__entry, mSocketFd, iovBytes(iov, iovCount));
+	oAmountSent = 0;
+	const result_t res = sendvBytes(iov, iovCount, oAmountSent);
+	TSTORAGE_PROBE3(socket__send__return, mSocketFd, oAmountSent, static_cast<int>(res));
+	return res;
+}
+
+result_t Socket::sendvBytes(
+	struct iovec* iov, const std::size_t iovCount, std::size_t& oAmountSent)
+{
+	if (mSocketFd == -1) {
+		return result_t::NOT_CONNECTED;
+	}
+	if (tlsSendsInUserspace()) {
+		return sendvTls(iov, iovCount, oAmountSent);
+	}
+	oAmountSent = 0;
+	// clang-format off
+	struct msghdr msg{};
+	// clang-format on
+	msg.msg_iov = iov;
+	msg.msg_iovlen = iovCount;
+	const auto start = transferStart();
+	while (msg.msg_iovlen > 0) {
+		if (msg.msg_iov->iov_len == 0) {
+			++msg.msg_iov;
+			--msg.msg_iovlen;
+			continue;
+		}
+		const result_t resWait = awaitDeadline(POLLOUT);
+		if (resWait != result_t::OK) {
+			return resWait;
+		}
+		const ssize_t sent = mRing.active()
+			? mRing.sendmsg(mSocketFd, &msg, MSG_NOSIGNAL, ringTimeoutMs())
+			: ::sendmsg(mSocketFd, &msg, MSG_NOSIGNAL | deadlineFlags());
+		mSendCalls.add(1);
+		if (sent < 0) {
+			mErrno = errno;
+			if (awaitAgain(mErrno) || restartable(mErrno, start)) {
+				continue;
+			}
+			return sendErrorToResult(mErrno);
+		}
+		mBytesSent.add(sent);
+		oAmountSent += sent;
+
+		std::size_t remaining = sent;
+		while (msg.msg_iovlen > 0 && remaining >= msg.msg_iov->iov_len) {
+			remaining -= msg.msg_iov->iov_len;
+			++msg.msg_iov;
+			--msg.msg_iovlen;
+		}
+		if (remaining > 0) {
+			msg.msg_iov->iov_base = static_cast<uint8_t*>(msg.msg_iov->iov_base) + remaining;
+			msg.msg_iov->iov_len -= remaining;
+		}
+	}
+	return result_t::OK;
+}
+
+result_t Socket::sendvTls(
+	const struct iovec* const iov, const std::size_t iovCount, std::size_t& oAmountSent)
+{
+	// OpenSSL makes a record of each write, hence small blocks are gathered
+	// first, while large ones are written in place.
+	std::array<uint8_t, cTlsRecordSize> record; /* NOLINT(cppcoreguidelines-pro-type-member-init) */
+	std::size_t filled = 0;
+	oAmountSent = 0;
+	const auto sendBlock = [this, &oAmountSent](const void* const bytes, const std::size_t amountBytes) {
+		std::size_t sent = 0;
+		const result_t res = sendBytes(bytes, amountBytes, sent);
+		oAmountSent += sent;
+		return res;
+	};
+	for (std::size_t i = 0; i < iovCount; ++i) {
+		const std::size_t length = iov[i].iov_len;
+		if (filled > 0 && filled + length > record.size()) {
+			const result_t res = sendBlock(record.data(), filled);
+			if (res != result_t::OK) {
+				return res;
+			}
+			filled = 0;
+		}
+		if (length >= record.size()) {
+			const result_t res = sendBlock(iov[i].iov_base, length);
+			if (res != result_t::OK) {
+				return res;
+			}
+			continue;
+		}
+		if (length > 0) {
+			std::memcpy(record.data() + filled, iov[i].iov_base, length);
+			filled += length;
+		}
+	}
+	return filled > 0 ? sendBlock(record.data(), filled) : result_t::OK;
+}
+
+result_t Socket::sendFile(const int fd,
+	const std::uint64_t offset,
+	const std::uint64_t amountBytes,
+	std::uint64_t& oAmountSent)
+{
+	if (mSocketFd == -1) {
+		return result_t::NOT_CONNECTED;
+	}
+	oAmountSent = 0;
+	if (tlsSendsInUserspace()) {
+		return sendFileCopy(fd, offset, amountBytes, oAmountSent);
+	}
+	off_t fileOffset = static_cast<off_t>(offset);
+	const auto start = transferStart();
+	while (oAmountSent < amountBytes) {
+		const result_t resWait = awaitDeadline(POLLOUT);
+		if (resWait != result_t::OK) {
+			return resWait;
+		}
+		const std::size_t chunk =
+			static_cast<std::size_t>(std::min<std::uint64_t>(amountBytes - oAmountSent, cMaxSendFileChunk));
+		const ssize_t sent = ::sendfile(mSocketFd, fd, &fileOffset, chunk);
+		mSendCalls.add(1);
+		if (sent < 0) {
+			mErrno = errno;
+			if (oAmountSent == 0 && (mErrno == EINVAL || mErrno == ENOSYS)) {
+				// The file does not support `sendfile()`.
+				return sendFileCopy(fd, offset, amountBytes, oAmountSent);
+			}
+			if (restartable(mErrno, start)) {
+				continue;
 			}
 			switch (mErrno) {
-				case ENOTCONN: /* fallthrough */
-				case EPIPE:
-					return result_t::CONNCLOSED;
-				case ECONNRESET:
-					return result_t::CONNRESET;
-				case EINTR:
-					return result_t::SIGNAL;
+				case EBADF: /* fallthrough */
+				case EIO: /* fallthrough */
+				case EOVERFLOW: /* fallthrough */
+				case ESPIPE:
+					return result_t::FILE_ERROR;
 				default:
-					return result_t::CONNERROR;
+					return sendErrorToResult(mErrno);
 			}
 		}
+		if (sent == 0) {
+			mErrno = ENODATA;
+			return result_t::FILE_ERROR;
+		}
+		mBytesSent.add(sent);
 		oAmountSent += sent;
-		sendBuffer += sent;
 	}
 	return result_t::OK;
 }
 
+result_t Socket::sendFileCopy(const int fd,
+	const std::uint64_t offset,
+	const std::uint64_t amountBytes,
+	std::uint64_t& ioAmountSent)
+{
+	std::array<uint8_t, cTlsRecordSize> chunk; /* NOLINT(cppcoreguidelines-pro-type-member-init) */
+	while (ioAmountSent < amountBytes) {
+		const std::size_t wanted =
+			static_cast<std::size_t>(std::min<std::uint64_t>(amountBytes - ioAmountSent, chunk.size()));
+		const ssize_t read =
+			::pread(fd, chunk.data(), wanted, static_cast<off_t>(offset + ioAmountSent));
+		if (read < 0 && errno == EINTR) {
+			continue;
+		}
+		if (read <= 0) {
+			mErrno = read < 0 ? errno : ENODATA;
+			return result_t::FILE_ERROR;
+		}
+		std::size_t sent = 0;
+		const result_t res = send(chunk.data(), static_cast<std::size_t>(read), sent);
+		ioAmountSent += sent;
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	return result_t::OK;
+}
+
+result_t Socket::sendErrorToResult(const int error)
+{
+	if (error == EAGAIN || error == EWOULDBLOCK) {
+		return result_t::CONNTIMEOUT;
+	}
+	switch (error) {
+		case ENOTCONN: /* fallthrough */
+		case EPIPE:
+			return result_t::CONNCLOSED;
+		case ECONNRESET:
+			return result_t::CONNRESET;
+		case EINTR:
+			return result_t::SIGNAL;
+		default:
+			return result_t::CONNERROR;
+	}
+}
+
 result_t Socket::recv(
 	void* const buffer, const std::size_t amountBytes, std::size_t& oAmountRecvd)
+{
+	TSTORAGE_PROBE2(socket__recv__entry, mSocketFd, amountBytes);
+	oAmountRecvd = 0;
+	const result_t res = recvBytes(buffer, amountBytes, oAmountRecvd);
+	TSTORAGE_PROBE3(socket__recv__return, mSocketFd, oAmountRecvd, static_cast<int>(res));
+	return res;
+}
+
+result_t Socket::recvBytes(
+	void* const buffer, const std::size_t amountBytes, std::size_t& oAmountRecvd)
 {
 	if (mSocketFd == -1) {
 		return result_t::NOT_CONNECTED;
 	}
 	oAmountRecvd = 0;
-	const ssize_t recvd = ::recv(mSocketFd, buffer, amountBytes, 0);
+	ssize_t recvd = -1;
+	const auto start = transferStart();
+	do {
+		if (!mTls.pending()) {
+			const result_t resWait = awaitDeadline(POLLIN);
+			if (resWait != result_t::OK) {
+				return resWait;
+			}
+		}
+		recvd = mTls.active() ? mTls.recv(buffer, amountBytes)
+			: mRing.active()
+			? mRing.recv(mSocketFd, buffer, amountBytes, ringTimeoutMs())
+			: ::recv(mSocketFd, buffer, amountBytes, deadlineFlags());
+		++mStats.recvCalls;
+		mRecvCalls.add(1);
+	} while (recvd < 0 && (awaitAgain(errno) || restartable(errno, start)));
 	if (recvd < 0) {
 		mErrno = errno;
 		if (mErrno == EAGAIN || mErrno == EWOULDBLOCK) {
@@ -214,6 +617,15 @@ result_t Socket::recv(
 		return result_t::CONNCLOSED;
 	}
 	oAmountRecvd = recvd;
+	mStats.bytesReceived += recvd;
+	mBytesReceived.add(recvd);
+#ifdef TCP_QUICKACK
+	if (mOptions.quickAck && mTcp) {
+		const int one = 1;
+		(void)setsockopt(mSocketFd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+		++mStats.sockOptCalls;
+	}
+#endif
 	return result_t::OK;
 }
 
@@ -236,6 +648,10 @@ result_t Socket::recvAtLeast(void* const buffer,
 	std::size_t lastRecvd = 0;
 	uint8_t* recvBuffer = static_cast<uint8_t*>(buffer);
 	while (oAmountRecvd < amountBytes) {
+		const result_t resLowat = adjustRecvLowWatermark(amountBytes - oAmountRecvd);
+		if (resLowat != result_t::OK) {
+			return resLowat;
+		}
 		const result_t resRecv =
 			this->recv(recvBuffer, bufferSize - oAmountRecvd, lastRecvd);
 		if (resRecv == result_t::CONNCLOSED) {
@@ -250,6 +666,32 @@ result_t Socket::recvAtLeast(void* const buffer,
 	return result_t::OK;
 }
 
+result_t Socket::adjustRecvLowWatermark(const std::size_t amountBytes)
+{
+	if (mTls.active()) {
+		// OpenSSL reads the records piecemeal, and may hold the missing
+		// bytes already, hence the watermark stays at `1`.
+		return result_t::OK;
+	}
+	std::size_t lowat = std::min(amountBytes, mRecvLowWatermarkLimit);
+	if (lowat < cMinRecvLowWatermark) {
+		lowat = 1;
+	}
+	lowat = std::min<std::size_t>(lowat, std::numeric_limits<int>::max());
+	const bool worthRaising = lowat / 2 >= mRecvLowWatermark;
+	if (lowat >= mRecvLowWatermark && !worthRaising) {
+		return result_t::OK;
+	}
+	const int value = static_cast<int>(lowat);
+	++mStats.sockOptCalls;
+	if (setsockopt(mSocketFd, SOL_SOCKET, SO_RCVLOWAT, &value, sizeof(value)) < 0) {
+		mErrno = errno;
+		return result_t::SETOPT_ERROR;
+	}
+	mRecvLowWatermark = lowat;
+	return result_t::OK;
+}
+
 result_t Socket::skipExactly(const std::size_t amountBytes, std::size_t& oAmountSkipped)
 {
 	if (mSocketFd == -1) {
@@ -275,6 +717,79 @@ result_t Socket::skipExactly(const std::size_t amountBytes, std::size_t& oAmount
 	return result_t::OK;
 }
 
+bool Socket::waitReadable(const std::uint32_t timeoutMs)
+{
+	if (mSocketFd == -1 || mTls.pending()) {
+		return true;
+	}
+	pollfd pending{};
+	pending.fd = mSocketFd;
+	pending.events = POLLIN;
+	const int waitMs = static_cast<int>(
+		std::min<std::uint32_t>(timeoutMs, std::numeric_limits<int>::max()));
+	return ::poll(&pending, 1, waitMs) != 0;
+}
+
+std::uint32_t Socket::remainingMs() const
+{
+	using std::chrono::milliseconds;
+	if (!hasDeadline()) {
+		return mTimeoutMs;
+	}
+	const auto now = std::chrono::steady_clock::now();
+	if (now >= mDeadline) {
+		return 0;
+	}
+	// Round up, so that a wait for the time left does not end early.
+	const auto left = std::chrono::duration_cast<milliseconds>(
+		mDeadline - now + milliseconds(1) - std::chrono::steady_clock::duration(1));
+	return static_cast<std::uint32_t>(
+		std::min<milliseconds::rep>(left.count(), std::numeric_limits<std::uint32_t>::max()));
+}
+
+bool Socket::restartable(const int error, const std::chrono::steady_clock::time_point start) const
+{
+	if (error != EINTR || !mRestartOnSignal) {
+		return false;
+	}
+	const auto now = std::chrono::steady_clock::now();
+	if (hasDeadline()) {
+		return now < mDeadline;
+	}
+	return mTimeoutMs == 0 || now < start + std::chrono::milliseconds(mTimeoutMs);
+}
+
+result_t Socket::awaitDeadline(const short events)
+{
+	if (!hasDeadline()) {
+		return result_t::OK;
+	}
+	int ready = -1;
+	do {
+		const std::uint32_t leftMs = remainingMs();
+		if (leftMs == 0) {
+			mErrno = ETIMEDOUT;
+			return result_t::CONNTIMEOUT;
+		}
+		pollfd pending{};
+		pending.fd = mSocketFd;
+		pending.events = events;
+		ready = ::poll(&pending, 1,
+			static_cast<int>(std::min<std::uint32_t>(leftMs, std::numeric_limits<int>::max())));
+		// The deadline bounds the restarts.
+	} while (ready < 0 && errno == EINTR && mRestartOnSignal);
+	if (ready < 0) {
+		mErrno = errno;
+		return mErrno == EINTR ? result_t::SIGNAL : result_t::CONNERROR;
+	}
+	if (ready == 0) {
+		mErrno = ETIMEDOUT;
+		return result_t::CONNTIMEOUT;
+	}
+	// Errors and hang-ups are left to the transfer which follows to report.
+	return result_t::OK;
+}
+
 result_t Socket::setTimeoutMs(const std::uint32_t timeoutMs)
 {
 	mTimeoutMs = timeoutMs;
@@ -302,5 +817,116 @@ result_t Socket::setTimeoutMs()
 	return result_t::OK;
 }
 
+result_t Socket::setBusyPollUs(const std::uint32_t busyPollUs)
+{
+	mBusyPollUs = busyPollUs;
+	return setBusyPollUs();
+}
+
+int Socket::applyOptions(const int fd, const int family) const
+{
+	const auto set = [fd](const int level, const int option, const std::int64_t value) {
+		const int intValue = static_cast<int>(std::min<std::int64_t>(
+			value, std::numeric_limits<int>::max()));
+		return setsockopt(fd, level, option, &intValue, sizeof(intValue)) < 0 ? errno : 0;
+	};
+
+	// The TCP and IP options do not apply to Unix domain sockets.
+	const bool tcp = family != AF_UNIX;
+	int error = tcp ? set(IPPROTO_TCP, TCP_NODELAY, mOptions.noDelay ? 1 : 0) : 0;
+	if (error == 0 && mOptions.sendBufferBytes != 0) {
+		error = set(SOL_SOCKET, SO_SNDBUF, mOptions.sendBufferBytes);
+	}
+	if (error == 0 && mOptions.recvBufferBytes != 0) {
+		error = set(SOL_SOCKET, SO_RCVBUF, mOptions.recvBufferBytes);
+	}
+#ifdef TCP_QUICKACK
+	if (error == 0 && tcp && mOptions.quickAck) {
+		error = set(IPPROTO_TCP, TCP_QUICKACK, 1);
+	}
+#endif
+	if (error == 0 && tcp && mOptions.keepAlive) {
+		error = set(SOL_SOCKET, SO_KEEPALIVE, 1);
+		if (error == 0 && mOptions.keepAliveIdleS != 0) {
+			error = set(IPPROTO_TCP, TCP_KEEPIDLE, mOptions.keepAliveIdleS);
+		}
+		if (error == 0 && mOptions.keepAliveIntervalS != 0) {
+			error = set(IPPROTO_TCP, TCP_KEEPINTVL, mOptions.keepAliveIntervalS);
+		}
+		if (error == 0 && mOptions.keepAliveCount != 0) {
+			error = set(IPPROTO_TCP, TCP_KEEPCNT, mOptions.keepAliveCount);
+		}
+	}
+#ifdef SO_PRIORITY
+	if (error == 0 && mOptions.priority >= 0) {
+		error = set(SOL_SOCKET, SO_PRIORITY, mOptions.priority);
+	}
+#endif
+	if (error == 0 && tcp && mOptions.dscp >= 0) {
+		// The DSCP takes the upper 6 bits of the traffic class octet.
+		const std::int64_t tos = (mOptions.dscp & 0x3f) << 2;
+		error = family == AF_INET6 ? set(IPPROTO_IPV6, IPV6_TCLASS, tos)
+								   : set(IPPROTO_IP, IP_TOS, tos);
+	}
+	return error;
+}
+
+result_t Socket::setBusyPollUs()
+{
+	if (mSocketFd == -1) {
+		return result_t::OK;
+	}
+#ifdef SO_BUSY_POLL
+	const int value = static_cast<int>(std::min<std::uint32_t>(
+		mBusyPollUs, std::numeric_limits<int>::max()));
+	if (setsockopt(mSocketFd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) < 0) {
+		mErrno = errno;
+		return result_t::SETOPT_ERROR;
+	}
+	return result_t::OK;
+#else
+	if (mBusyPollUs == 0) {
+		return result_t::OK;
+	}
+	mErrno = ENOPROTOOPT;
+	return result_t::SETOPT_ERROR;
+#endif
+}
+
+result_t Socket::setBufferSizes(const std::size_t sendBytes, const std::size_t recvBytes)
+{
+	if (mSocketFd == -1 || !mTcp) {
+		return result_t::NOT_CONNECTED;
+	}
+	const int sendValue = static_cast<int>(std::min<std::size_t>(
+		sendBytes, std::numeric_limits<int>::max()));
+	const int recvValue = static_cast<int>(std::min<std::size_t>(
+		recvBytes, std::numeric_limits<int>::max()));
+	if (setsockopt(mSocketFd, SOL_SOCKET, SO_SNDBUF, &sendValue, sizeof(sendValue)) < 0
+		|| setsockopt(mSocketFd, SOL_SOCKET, SO_RCVBUF, &recvValue, sizeof(recvValue)) < 0) {
+		mErrno = errno;
+		return result_t::SETOPT_ERROR;
+	}
+	return result_t::OK;
+}
+
+bool Socket::rttUs(std::uint32_t& oRttUs) const
+{
+	if (mSocketFd == -1 || !mTcp) {
+		return false;
+	}
+#ifdef TCP_INFO
+	struct tcp_info info{};
+	socklen_t size = sizeof(info);
+	if (getsockopt(mSocketFd, IPPROTO_TCP, TCP_INFO, &info, &size) < 0 || info.tcpi_rtt == 0) {
+		return false;
+	}
+	oRttUs = info.tcpi_rtt;
+	return true;
+#else
+	return false;
+#endif
+}
+
 } /*namespace impl*/
 } /*namespace tstorage*/
@@ -22,14 +22,23 @@
 #ifndef D_TSTORAGE_SOCKET_PH
 #define D_TSTORAGE_SOCKET_PH
 
+#include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <string>
 #include <utility>
+#include <vector>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <tstorageclient++/DataTypes.h>
 
+#include "Counters.h"
+#include "HostResolver.h"
+#include "IoUring.h"
+#include "TlsSession.h"
+
 /** @file
  * @brief Defines a simple TCP socket class. */
 
@@ -43,10 +52,25 @@ namespace impl {
  * specified timeout. Since we don't need server functionality here, the
  * `listen()`/`accept()` execution path has been left out.
  *
+ * A host named `unix:<path>` is connected to over a Unix domain stream
+ * socket instead (see `HostResolver`), with the TCP and IP options of
+ * `SocketOptions` left out.
+ *
  * Each `Socket` method which invokes syscalls internally (`recv()` family,
  * `send()`, `skip()`, as well as `connect()`, `close()`, `abort()`,
- * `shutdown()` and `setTimeoutMs()`) sets `errno` on error. To get the `errno`
+ * `shutdown()`, `setTimeoutMs()` and `setBusyPollUs()`) sets `errno` on error. To get the `errno`
  * of the last call for more fine-grained error management, use `getErrno()`.
+ *
+ * If built with the io_uring backend (see `IoUring`), the transfers are
+ * performed with io_uring operations instead of the corresponding syscalls,
+ * unless disabled with `setIoUring()` or unsupported by the kernel. The status
+ * codes are the same for both.
+ *
+ * With TLS enabled (see `setTls()` and `TlsSession`), the handshake is
+ * performed by `connect()`. Once the kernel encrypts the sent data (kTLS),
+ * the sends take the same paths as on an unencrypted connection; otherwise
+ * they go through OpenSSL, the blocks of `sendv()` gathered into full
+ * records. The receives always go through OpenSSL, without io_uring.
  */
 class Socket
 {
@@ -61,19 +85,53 @@ public:
 private:
 	/** @brief Default socket timeout for receive and send.*/
 	static constexpr std::int32_t cDefaultTimeoutMs = 20'000;
+	/** @brief Default timeout for establishing a connection.*/
+	static constexpr std::int32_t cDefaultConnectTimeoutMs = 20'000;
 	/** @brief Static buffer size for data skipping.*/
 	static constexpr std::int32_t cSkipBufferSize = 1024;
+	/** @brief The delay between the starts of consecutive connection attempts
+	 * (the "Connection Attempt Delay" of RFC 8305). */
+	static constexpr std::int32_t cConnectAttemptDelayMs = 250;
+	/** @brief The smallest receive low watermark worth a syscall to set. */
+	static constexpr std::size_t cMinRecvLowWatermark = 4096;
+	/** @brief The largest amount of plaintext in a TLS record. */
+	static constexpr std::size_t cTlsRecordSize = 16384;
+	/** @brief The largest amount of bytes a single `sendfile()` call takes. */
+	static constexpr std::size_t cMaxSendFileChunk = 0x7ffff000;
 
 public:
 	/** @brief Default constructor. Sets a default, invalid host. */
-	Socket() : mSocketFd(-1), mErrno{}, mPort(0), mTimeoutMs(cDefaultTimeoutMs) {}
+	Socket()
+		: mSocketFd(-1)
+		, mErrno{}
+		, mResolver(std::string{}, 0)
+		, mTimeoutMs(cDefaultTimeoutMs)
+		, mConnectTimeoutMs(cDefaultConnectTimeoutMs)
+		, mDeadline(std::chrono::steady_clock::time_point::max())
+		, mBusyPollUs(0)
+		, mRecvLowWatermarkLimit(0)
+		, mRecvLowWatermark(1)
+		, mStats{}
+		, mTcp(true)
+		, mUseIoUring(IoUring::built())
+		, mRestartOnSignal(false)
+	{
+	}
 	/** @brief A constructor. Sets the address and port of the target server. */
 	Socket(std::string addr, std::uint16_t port)
 		: mSocketFd(-1)
 		, mErrno{}
-		, mAddr(std::move(addr))
-		, mPort(port)
+		, mResolver(std::move(addr), port)
 		, mTimeoutMs(cDefaultTimeoutMs)
+		, mConnectTimeoutMs(cDefaultConnectTimeoutMs)
+		, mDeadline(std::chrono::steady_clock::time_point::max())
+		, mBusyPollUs(0)
+		, mRecvLowWatermarkLimit(0)
+		, mRecvLowWatermark(1)
+		, mStats{}
+		, mTcp(true)
+		, mUseIoUring(IoUring::built())
+		, mRestartOnSignal(false)
 	{
 	}
 	/** @brief A destructor. Closes the connection if open. */
@@ -88,6 +146,18 @@ public:
 	 * @brief Allocates a socket FD/handle and establishes a connection to a
 	 * host.
 	 *
+	 * The host's IPv4 and IPv6 addresses are resolved, or taken from the
+	 * cache of the last resolution (see `setAddressCacheTtlMs()`), and tried
+	 * in the order of `HostResolver`, in the Happy Eyeballs manner of
+	 * RFC 8305: each address gets a socket of its own, and a new attempt is
+	 * started every `cConnectAttemptDelayMs` milliseconds, or as soon as the
+	 * previous one fails, while the earlier ones are still pending. The first
+	 * connection established wins and the other attempts are abandoned. The
+	 * whole procedure is limited by the connect timeout (see
+	 * `setConnectTimeoutMs()`). If no address is
+	 * connected to, the cached addresses are dropped, hence the next attempt
+	 * resolves them anew.
+	 *
 	 * This method may return one of the following error codes.
 	 *  - `result_t::BAD_ADDRESS`
 	 *  - `result_t::CONNERROR`
@@ -96,6 +166,9 @@ public:
 	 *  - `result_t::SETOPT_ERROR`
 	 *  - `result_t::SIGNAL`
 	 *  - `result_t::SOCKET_ERROR`
+	 *  - `result_t::TLS_ERROR`
+	 *  - `result_t::CONNCLOSED`, if the host closes the connection during the
+	 *    TLS handshake
 	 *
 	 * For their meaning see `tstorage::result_t` in `DataTypes.h`. For
 	 * supplementary, platform-dependent error diagnostics, use `getErrno()`.
@@ -166,6 +239,42 @@ public:
 	 * @return Status code.
 	 */
 	result_t send(const void* bytes, std::size_t amountBytes, std::size_t& oAmountSent);
+	/**
+	 * @brief Sends the contents of `iovCount` memory blocks described by a
+	 * scatter/gather array `iov`, in order, as a single byte-stream.
+	 *
+	 * Works like `send()`, except the data is gathered by the kernel directly
+	 * from each of the blocks, avoiding intermediate copies. The array `iov` is
+	 * used as scratch space and its contents are unspecified on method exit.
+	 *
+	 * The possible error codes are the same as for `send()`.
+	 *
+	 * @param[in, out] iov An array of memory blocks to send.
+	 * @param[in] iovCount The length of the `iov` array.
+	 * @param[out] oAmountSent The total amount of bytes actually sent.
+	 * @return Status code.
+	 */
+	result_t sendv(struct iovec* iov, std::size_t iovCount, std::size_t& oAmountSent);
+	/**
+	 * @brief Sends exactly `amountBytes` of a file, starting at `offset`.
+	 *
+	 * The data is moved from the page cache to the socket by `sendfile()`,
+	 * without passing through userspace, and is encrypted in place by the
+	 * kernel over kTLS. Over userspace TLS, or if the file does not support
+	 * `sendfile()`, it is read with `pread()` and sent with `send()` instead.
+	 * The file offset of `fd` is left unchanged.
+	 *
+	 * The possible error codes are those of `send()`, and:
+	 *  - `result_t::FILE_ERROR` if the file cannot be read, or ends before
+	 *    `amountBytes` are sent.
+	 *
+	 * @param[in] fd A file open for reading, e.g. a regular file.
+	 * @param[in] offset The offset of the data in the file.
+	 * @param[in] amountBytes The amount of bytes to send.
+	 * @param[out] oAmountSent The amount of bytes actually sent.
+	 * @return Status code.
+	 */
+	result_t sendFile(int fd, std::uint64_t offset, std::uint64_t amountBytes, std::uint64_t& oAmountSent);
 	/**
 	 * @brief Receives up to `amountBytes` of data and writes it to a writable
 	 * memory block `buffer` by issuing a single syscall.
@@ -227,10 +336,15 @@ public:
 	 * connection has closed gracefully and further receive attempts will fetch 0
 	 * bytes.
 	 *
+	 * With a receive low watermark limit set (see `setRecvLowWatermark()`),
+	 * each `recv()` is made to wait for the bytes still missing, up to the
+	 * limit, instead of returning as soon as the first segment arrives.
+	 *
 	 * The possible error codes are:
 	 *  - `result_t::CONNERROR`
 	 *  - `result_t::CONNTIMEOUT`
 	 *  - `result_t::NOT_CONNECTED`
+	 *  - `result_t::SETOPT_ERROR`
 	 *  - `result_t::SIGNAL`
 	 *
 	 * @param[in] buffer The address of a writable memory block to store
@@ -262,6 +376,18 @@ public:
 	 * @return Status code.
 	 */
 	result_t skipExactly(std::size_t amountBytes, std::size_t& oAmountSkipped);
+	/**
+	 * @brief Waits until a `recv()` would return without blocking, or until
+	 * `timeoutMs` elapses.
+	 *
+	 * Returns at once if a TLS session has decrypted bytes buffered. A closed
+	 * or failed connection counts as readable, so that the `recv()` which
+	 * follows reports it.
+	 *
+	 * @param timeoutMs The longest wait in milliseconds.
+	 * @return `false` if the wait has timed out, `true` otherwise.
+	 */
+	bool waitReadable(std::uint32_t timeoutMs);
 
 	/**
 	 * @brief Sets the host address/port pair for the next `connect()` attempt.
@@ -270,9 +396,15 @@ public:
 	 */
 	void setHost(const std::string& addr, std::uint16_t port)
 	{
-		mAddr = addr;
-		mPort = port;
+		mResolver.setHost(addr, port);
 	}
+	/**
+	 * @brief Sets the time the resolved addresses of the host are reused for
+	 * by subsequent `connect()` calls.
+	 * @param ttlMs The time in milliseconds, `0` to resolve the addresses on
+	 * each `connect()`.
+	 */
+	void setAddressCacheTtlMs(std::uint32_t ttlMs) { mResolver.setTtlMs(ttlMs); }
 	/**
 	 * @brief Sets the socket's send and receive timeouts to
 	 * `Socket::mTimeoutMs`.
@@ -286,6 +418,197 @@ public:
 	 * @return `result_t::OK` on success, `result_t::SETOPT_ERROR` otherwise.
 	 */
 	result_t setTimeoutMs(std::uint32_t timeoutMs);
+	/** @brief Returns `Socket::mTimeoutMs`. */
+	std::uint32_t timeoutMs() const { return mTimeoutMs; }
+	/**
+	 * @brief Sets the time `connect()` may take, independently of the send
+	 * and receive timeout.
+	 * @param timeoutMs The timeout in milliseconds, `0` for no timeout.
+	 */
+	void setConnectTimeoutMs(std::uint32_t timeoutMs) { mConnectTimeoutMs = timeoutMs; }
+	/**
+	 * @brief Sets the point in time by which the transfers have to be done,
+	 * until `clearDeadline()`.
+	 *
+	 * With a deadline, each send and receive first waits for the socket with
+	 * `poll()`, for no longer than the time left, and then transfers what it
+	 * can without blocking. The time left thus bounds the whole sequence of
+	 * transfers of a request, instead of the send and receive timeout
+	 * bounding each syscall: a trickle of data cannot outlast the deadline,
+	 * and a stall shorter than the time left does not fail the transfer.
+	 * Once the deadline passes, the transfers fail with
+	 * `result_t::CONNTIMEOUT`. `connect()` is bounded by it too, on top of the
+	 * connect timeout.
+	 *
+	 * Within the time left, the rest of a TLS record received in part, a
+	 * blocking OpenSSL write and each `sendfile()` chunk are still bounded by
+	 * the send and receive timeout only.
+	 *
+	 * @param deadline The deadline.
+	 */
+	void setDeadline(std::chrono::steady_clock::time_point deadline) { mDeadline = deadline; }
+	/**
+	 * @brief Enables or disables restarting the syscalls interrupted by
+	 * signals.
+	 *
+	 * A blocking socket syscall interrupted by a signal handler fails with
+	 * `EINTR` even with `SA_RESTART`, since the socket has a timeout (see
+	 * `signal(7)`). By default, the failure is reported as
+	 * `result_t::SIGNAL`, on which the channels drop the connection, so that
+	 * e.g. the `SIGPROF` of a sampling profiler breaks connections at random.
+	 * With restarts enabled, the transfers and `connect()` restart an
+	 * interrupted syscall instead, as long as the send and receive timeout,
+	 * counted from the start of the transfer, or the deadline (see
+	 * `setDeadline()`) has not passed, so that a steady stream of signals
+	 * cannot keep a transfer from ever timing out. Once it has,
+	 * `result_t::SIGNAL` is reported as before. The TLS handshake is not
+	 * restarted.
+	 *
+	 * @param enabled `true` to restart interrupted syscalls, `false` to report
+	 * them.
+	 */
+	void setRestartOnSignal(bool enabled) { mRestartOnSignal = enabled; }
+	/** @brief Removes the deadline set with `setDeadline()`. */
+	void clearDeadline() { mDeadline = std::chrono::steady_clock::time_point::max(); }
+	/** @brief Returns `true` if a deadline is set. */
+	bool hasDeadline() const { return mDeadline != std::chrono::steady_clock::time_point::max(); }
+	/** @brief Returns the deadline, `time_point::max()` if none is set. */
+	std::chrono::steady_clock::time_point deadline() const { return mDeadline; }
+	/** @brief Returns the time left until the deadline in milliseconds,
+	 * rounded up, or `Socket::mTimeoutMs` if no deadline is set. `0` once the
+	 * deadline has passed. */
+	std::uint32_t remainingMs() const;
+	/**
+	 * @brief Sets the socket's busy polling time to `Socket::mBusyPollUs`.
+	 *
+	 * Raising the option above the system-wide `net.core.busy_read` default
+	 * requires `CAP_NET_ADMIN`.
+	 *
+	 * @return `result_t::OK` on success, `result_t::SETOPT_ERROR` otherwise.
+	 */
+	result_t setBusyPollUs();
+	/**
+	 * @brief Sets `Socket::mBusyPollUs` to `busyPollUs` and adjusts the
+	 * socket's busy polling time accordingly if connected.
+	 *
+	 * With a nonzero `busyPollUs`, a blocking receive spins on the device
+	 * queue for up to `busyPollUs` microseconds before sleeping, trading CPU
+	 * time for latency. Where `SO_BUSY_POLL` is not supported, nonzero values
+	 * fail with `result_t::SETOPT_ERROR`.
+	 *
+	 * @param busyPollUs Busy polling time in microseconds, `0` to disable.
+	 * @return `result_t::OK` on success, `result_t::SETOPT_ERROR` otherwise.
+	 */
+	result_t setBusyPollUs(std::uint32_t busyPollUs);
+	/**
+	 * @brief Sets the kernel send and receive buffer sizes (`SO_SNDBUF` and
+	 * `SO_RCVBUF`) of the current connection, leaving those of
+	 * `SocketOptions` for the next ones.
+	 *
+	 * The sizes are capped by the system (`net.core.wmem_max` and
+	 * `net.core.rmem_max`), and disable the kernel's buffer autotuning of the
+	 * connection.
+	 *
+	 * @param sendBytes The send buffer size in bytes.
+	 * @param recvBytes The receive buffer size in bytes.
+	 * @return `result_t::OK` on success, `result_t::NOT_CONNECTED` if there is
+	 * no TCP connection, `result_t::SETOPT_ERROR` otherwise.
+	 */
+	result_t setBufferSizes(std::size_t sendBytes, std::size_t recvBytes);
+	/**
+	 * @brief Reads the round-trip time of the current connection, as
+	 * smoothed by the kernel (`TCP_INFO`).
+	 * @param[out] oRttUs The round-trip time in microseconds.
+	 * @return `true` on success, `false` if there is no TCP connection or the
+	 * system doesn't report it.
+	 */
+	bool rttUs(std::uint32_t& oRttUs) const;
+	/**
+	 * @brief Sets the largest receive low watermark used by `recvAtLeast()`.
+	 *
+	 * Before each `recv()` made by `recvAtLeast()`, the `SO_RCVLOWAT` option
+	 * of the socket is raised to the amount of bytes still missing, but not
+	 * above `limitBytes`, so that a single syscall receives them even if they
+	 * arrive in many segments. The watermark never exceeds the amount of bytes
+	 * missing, hence it never makes a `recv()` wait for bytes the host is not
+	 * going to send. Since changing it is a syscall of its own, it is raised
+	 * only when that at least doubles it and at least `cMinRecvLowWatermark`
+	 * bytes are missing, and dropped back to `1` for smaller reads.
+	 *
+	 * @param limitBytes The largest low watermark, or `0` to leave the
+	 * watermark at its default of `1`.
+	 */
+	void setRecvLowWatermark(std::size_t limitBytes) { mRecvLowWatermarkLimit = limitBytes; }
+
+	/**
+	 * @brief Enables or disables the io_uring backend for the connections
+	 * established from now on.
+	 *
+	 * Enabled by default if the backend is built. Without it, or if the
+	 * kernel does not support it, the socket keeps using plain syscalls.
+	 *
+	 * @param enabled `true` to use io_uring, `false` otherwise.
+	 */
+	void setIoUring(bool enabled) { mUseIoUring = enabled; }
+	/**
+	 * @brief Sets the TCP options of the connections established from now on.
+	 * @param options The options.
+	 */
+	void setOptions(const SocketOptions& options) { mOptions = options; }
+	/**
+	 * @brief Sets the TLS options of the connections established from now on.
+	 * @param options The options.
+	 */
+	void setTls(const TlsOptions& options) { mTlsOptions = options; }
+	/** @brief Returns `true` if the current connection is encrypted. */
+	bool tlsActive() const { return mTls.active(); }
+	/** @brief Returns `true` if the kernel encrypts the data sent over the
+	 * current connection. */
+	bool tlsSendOffloaded() const { return mTls.sendOffloaded(); }
+	/** @brief Returns `true` if the current connection uses io_uring. */
+	bool ioUringActive() const { return mRing.active(); }
+	/**
+	 * @brief Registers a receive buffer with the io_uring backend, letting
+	 * the kernel receive into it without mapping its pages on every call.
+	 *
+	 * Does nothing without an active io_uring or if a buffer is already
+	 * registered. The block has to stay allocated until
+	 * `releaseRecvBuffer()`, `close()` or `abort()` is called. Registration
+	 * failures are ignored, and receives then proceed without it.
+	 *
+	 * @param memory The start of the memory block.
+	 * @param size The size of the memory block.
+	 */
+	void registerRecvBuffer(void* memory, std::size_t size)
+	{
+		if (mRing.active() && !mRing.bufferRegistered()) {
+			(void)mRing.registerBuffer(memory, size);
+		}
+	}
+	/** @brief Unregisters the receive buffer registered with
+	 * `registerRecvBuffer()`, if any. */
+	void releaseRecvBuffer() { mRing.unregisterBuffer(); }
+
+	/** @brief Returns the receive counters accumulated since the last
+	 * `resetStats()`. */
+	const ReceiveStats& stats() const { return mStats; }
+	/** @brief Zeroes the receive counters. */
+	void resetStats() { mStats = ReceiveStats{}; }
+	/** @brief Returns the total amount of bytes sent and received. Safe to
+	 * call from any thread. */
+	std::uint64_t bytesTransferred() const { return mBytesSent.value() + mBytesReceived.value(); }
+	/**
+	 * @brief Fills the traffic counters of `oStats`, accumulated over the
+	 * lifetime of the socket. Safe to call from any thread.
+	 * @param[out] oStats The statistics to fill.
+	 */
+	void trafficStats(ChannelStats& oStats) const
+	{
+		oStats.bytesSent = mBytesSent.value();
+		oStats.sendCalls = mSendCalls.value();
+		oStats.bytesReceived = mBytesReceived.value();
+		oStats.recvCalls = mRecvCalls.value();
+	}
 
 	/** @brief Returns the last `errno`. */
 	int getErrno() const { return mErrno; }
@@ -293,17 +616,142 @@ public:
 	 * explicitly closed, `false` otherwise. */
 	bool connectionEstablished() const { return mSocketFd != -1; }
 
+	/** @brief Maps the `errno` of a failed send syscall to a status code. */
+	static result_t sendErrorToResult(int error);
+
 private:
+	/**
+	 * @brief Connects to the first reachable address of `addresses`, racing
+	 * staggered connection attempts, and sets `mSocketFd` to the connected
+	 * socket on success.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNREFUSED`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::SIGNAL`
+	 *  - `result_t::SOCKET_ERROR`
+	 *
+	 * @param addresses The addresses to try, in order.
+	 * @return Status code.
+	 */
+	result_t connectFirst(const std::vector<HostResolver::Address>& addresses);
+	/**
+	 * @brief Applies `mOptions` to a socket which is yet to connect.
+	 * @param fd The socket.
+	 * @param family The address family of the socket.
+	 * @return `0` on success, `errno` of the failed option otherwise.
+	 */
+	int applyOptions(int fd, int family) const;
+	/**
+	 * @brief Adjusts the receive low watermark to suit a read of at least
+	 * `amountBytes`.
+	 * @see setRecvLowWatermark()
+	 * @param amountBytes The amount of bytes still missing.
+	 * @return `result_t::OK` on success, `result_t::SETOPT_ERROR` otherwise.
+	 */
+	result_t adjustRecvLowWatermark(std::size_t amountBytes);
+	/**
+	 * @brief Waits until the socket is ready for `events` or the deadline
+	 * passes. Returns at once if no deadline is set.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::SIGNAL`
+	 *
+	 * @param events The `poll()` events to wait for.
+	 * @return Status code.
+	 */
+	result_t awaitDeadline(short events);
+	/** @brief Returns the flags which keep a transfer from blocking past the
+	 * deadline, if one is set. */
+	int deadlineFlags() const { return hasDeadline() ? MSG_DONTWAIT : 0; }
+	/** @brief Returns `true` if a transfer which failed with `error` is to
+	 * wait for the socket again, i.e. it would have blocked and a deadline is
+	 * set. */
+	bool awaitAgain(const int error) const
+	{
+		return hasDeadline() && (error == EAGAIN || error == EWOULDBLOCK);
+	}
+	/** @brief Returns the start time of a transfer, as needed by
+	 * `restartable()`. */
+	std::chrono::steady_clock::time_point transferStart() const
+	{
+		return mRestartOnSignal ? std::chrono::steady_clock::now()
+								: std::chrono::steady_clock::time_point{};
+	}
+	/**
+	 * @brief Returns `true` if a syscall which failed with `error` is to be
+	 * restarted, i.e. it was interrupted by a signal, restarts are enabled,
+	 * and the transfer started at `start` has time left.
+	 * @see setRestartOnSignal()
+	 */
+	bool restartable(int error, std::chrono::steady_clock::time_point start) const;
+	/** @brief Returns the timeout of an io_uring transfer. */
+	std::uint32_t ringTimeoutMs() const { return hasDeadline() ? remainingMs() : mTimeoutMs; }
+	/** @brief Returns `true` if the sends have to go through OpenSSL. */
+	bool tlsSendsInUserspace() const { return mTls.active() && !mTls.sendOffloaded(); }
+	/**
+	 * @brief Works like `sendv()` over a connection whose sends go through
+	 * OpenSSL, gathering the blocks into full records.
+	 */
+	result_t sendvTls(const struct iovec* iov, std::size_t iovCount, std::size_t& oAmountSent);
+	/** @brief The implementation of `send()`, without its probes. */
+	result_t sendBytes(const void* bytes, std::size_t amountBytes, std::size_t& oAmountSent);
+	/** @brief The implementation of `sendv()`, without its probes. */
+	result_t sendvBytes(struct iovec* iov, std::size_t iovCount, std::size_t& oAmountSent);
+	/** @brief The implementation of `recv()`, without its probes. */
+	result_t recvBytes(void* buffer, std::size_t amountBytes, std::size_t& oAmountRecvd);
+	/**
+	 * @brief Works like `sendFile()`, copying the data through a buffer on
+	 * the stack.
+	 */
+	result_t sendFileCopy(int fd, std::uint64_t offset, std::uint64_t amountBytes, std::uint64_t& ioAmountSent);
+
 	/** @brief Socket FD/handle. */
 	int mSocketFd;
 	/** @brief The last `errno`. */
 	int mErrno;
-	/** @brief The host's address. */
-	std::string mAddr;
-	/** @brief The host's port. */
-	std::uint16_t mPort;
+	/** @brief The resolver of the host's addresses. */
+	HostResolver mResolver;
 	/** @brief Socket send and receive timeout in milliseconds. */
 	std::uint32_t mTimeoutMs;
+	/** @brief Connect timeout in milliseconds, `0` if none. */
+	std::uint32_t mConnectTimeoutMs;
+	/** @brief The deadline of the transfers, `time_point::max()` if none. */
+	std::chrono::steady_clock::time_point mDeadline;
+	/** @brief Socket busy polling time in microseconds, `0` if disabled. */
+	std::uint32_t mBusyPollUs;
+	/** @brief The largest receive low watermark, `0` if disabled. */
+	std::size_t mRecvLowWatermarkLimit;
+	/** @brief The receive low watermark currently set on the socket. */
+	std::size_t mRecvLowWatermark;
+	/** @brief Receive counters. */
+	ReceiveStats mStats;
+	/** @brief The number of send syscalls. */
+	Counter mSendCalls;
+	/** @brief The total amount of bytes sent. */
+	Counter mBytesSent;
+	/** @brief The number of receive syscalls. */
+	Counter mRecvCalls;
+	/** @brief The total amount of bytes received. */
+	Counter mBytesReceived;
+	/** @brief The TCP options of new connections. */
+	SocketOptions mOptions;
+	/** @brief `false` if the current connection is over a Unix domain
+	 * socket. */
+	bool mTcp;
+	/** @brief `true` if new connections should use io_uring. */
+	bool mUseIoUring;
+	/** @brief `true` if syscalls interrupted by signals are restarted. */
+	bool mRestartOnSignal;
+	/** @brief The io_uring backend of the current connection, if any. */
+	IoUring mRing;
+	/** @brief The TLS options of new connections. */
+	TlsOptions mTlsOptions;
+	/** @brief The TLS session of the current connection, if any. */
+	TlsSession mTls;
 };
 
 } /*namespace impl*/
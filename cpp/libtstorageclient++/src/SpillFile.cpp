@@ -0,0 +1,279 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpillFile.cpp
+ *   The temporary files of a SpilledRecordsSet.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SpillFile.h"
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace impl {
+
+constexpr std::size_t SpillFile::cWriteBufferSize;
+constexpr std::size_t SpillFile::cRecordHeaderSize;
+
+SpillFile::SpillFile(std::string directory)
+	: mDirectory(std::move(directory))
+	, mDataFd(-1)
+	, mIndexFd(-1)
+	, mDataSize(0)
+	, mRecords(0)
+	, mData(nullptr)
+	, mIndex(nullptr)
+	, mSealed(false)
+{
+}
+
+SpillFile::~SpillFile()
+{
+	unmap();
+	if (mDataFd != -1) {
+		::close(mDataFd);
+	}
+	if (mIndexFd != -1) {
+		::close(mIndexFd);
+	}
+}
+
+result_t SpillFile::append(const Key& key, const void* const payload, const std::size_t size)
+{
+	if (mSealed || size > UINT32_MAX) {
+		return result_t::SPILL_ERROR;
+	}
+	if (mDataFd == -1) {
+		const result_t res = open();
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+
+	std::array<unsigned char, cRecordHeaderSize> header{};
+	const std::uint32_t payloadSize = static_cast<std::uint32_t>(size);
+	unsigned char* field = header.data();
+	std::memcpy(field, &key.cid, sizeof(key.cid));
+	field += sizeof(key.cid);
+	std::memcpy(field, &key.mid, sizeof(key.mid));
+	field += sizeof(key.mid);
+	std::memcpy(field, &key.moid, sizeof(key.moid));
+	field += sizeof(key.moid);
+	std::memcpy(field, &key.cap, sizeof(key.cap));
+	field += sizeof(key.cap);
+	std::memcpy(field, &key.acq, sizeof(key.acq));
+	field += sizeof(key.acq);
+	std::memcpy(field, &payloadSize, sizeof(payloadSize));
+
+	const std::uint64_t offset = mDataSize;
+	result_t res = write(mIndexFd, mIndexBuffer, &offset, sizeof(offset));
+	if (res == result_t::OK) {
+		res = write(mDataFd, mDataBuffer, header.data(), header.size());
+	}
+	if (res == result_t::OK) {
+		res = write(mDataFd, mDataBuffer, payload, size);
+	}
+	if (res != result_t::OK) {
+		return res;
+	}
+	mDataSize += cRecordHeaderSize + size;
+	++mRecords;
+	return result_t::OK;
+}
+
+result_t SpillFile::seal()
+{
+	if (mSealed) {
+		return result_t::OK;
+	}
+	if (mRecords != 0) {
+		result_t res = flush(mDataFd, mDataBuffer);
+		if (res == result_t::OK) {
+			res = flush(mIndexFd, mIndexBuffer);
+		}
+		if (res != result_t::OK) {
+			return res;
+		}
+
+		void* const data = ::mmap(nullptr, mDataSize, PROT_READ, MAP_SHARED, mDataFd, 0);
+		if (data == MAP_FAILED) {
+			return result_t::SPILL_ERROR;
+		}
+		mData = data;
+		void* const index = ::mmap(
+			nullptr, mRecords * sizeof(std::uint64_t), PROT_READ, MAP_SHARED, mIndexFd, 0);
+		if (index == MAP_FAILED) {
+			unmap();
+			return result_t::SPILL_ERROR;
+		}
+		mIndex = index;
+	}
+	mSealed = true;
+	return result_t::OK;
+}
+
+void SpillFile::clear()
+{
+	unmap();
+	// The files are truncated rather than closed, so that the next records
+	// reuse them.
+	if (mDataFd != -1) {
+		(void)::ftruncate(mDataFd, 0);
+		(void)::lseek(mDataFd, 0, SEEK_SET);
+	}
+	if (mIndexFd != -1) {
+		(void)::ftruncate(mIndexFd, 0);
+		(void)::lseek(mIndexFd, 0, SEEK_SET);
+	}
+	mDataBuffer.clear();
+	mIndexBuffer.clear();
+	mDataSize = 0;
+	mRecords = 0;
+	mSealed = false;
+}
+
+Key SpillFile::key(const std::size_t i) const
+{
+	const unsigned char* field = record(i);
+	Key key{};
+	std::memcpy(&key.cid, field, sizeof(key.cid));
+	field += sizeof(key.cid);
+	std::memcpy(&key.mid, field, sizeof(key.mid));
+	field += sizeof(key.mid);
+	std::memcpy(&key.moid, field, sizeof(key.moid));
+	field += sizeof(key.moid);
+	std::memcpy(&key.cap, field, sizeof(key.cap));
+	field += sizeof(key.cap);
+	std::memcpy(&key.acq, field, sizeof(key.acq));
+	return key;
+}
+
+std::size_t SpillFile::payloadSize(const std::size_t i) const
+{
+	std::uint32_t size{};
+	std::memcpy(&size, record(i) + cRecordHeaderSize - sizeof(size), sizeof(size));
+	return size;
+}
+
+result_t SpillFile::open()
+{
+	mDataFd = createUnlinked();
+	mIndexFd = createUnlinked();
+	if (mDataFd == -1 || mIndexFd == -1) {
+		return result_t::SPILL_ERROR;
+	}
+	mDataBuffer.reserve(cWriteBufferSize);
+	mIndexBuffer.reserve(cWriteBufferSize);
+	return result_t::OK;
+}
+
+int SpillFile::createUnlinked() const
+{
+	std::string directory = mDirectory;
+	if (directory.empty()) {
+		const char* const tmpdir = std::getenv("TMPDIR"); /* NOLINT(concurrency-mt-unsafe) */
+		directory = tmpdir != nullptr && *tmpdir != '\0' ? tmpdir : "/tmp";
+	}
+	std::string path = directory + "/tstorage-spill-XXXXXX";
+	const int fd = ::mkstemp(&path[0]);
+	if (fd == -1) {
+		return -1;
+	}
+	// Unlinked, the file is removed once closed, also by a crash.
+	(void)::unlink(path.c_str());
+	return fd;
+}
+
+result_t SpillFile::write(const int fd,
+	std::vector<unsigned char>& ioBuffer,
+	const void* const bytes,
+	const std::size_t size)
+{
+	if (ioBuffer.size() + size > cWriteBufferSize) {
+		const result_t res = flush(fd, ioBuffer);
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+	if (size >= cWriteBufferSize) {
+		return writeAll(fd, bytes, size);
+	}
+	const unsigned char* const begin = static_cast<const unsigned char*>(bytes);
+	ioBuffer.insert(ioBuffer.end(), begin, begin + size);
+	return result_t::OK;
+}
+
+result_t SpillFile::flush(const int fd, std::vector<unsigned char>& ioBuffer)
+{
+	const result_t res = writeAll(fd, ioBuffer.data(), ioBuffer.size());
+	ioBuffer.clear();
+	return res;
+}
+
+result_t SpillFile::writeAll(const int fd, const void* const bytes, const std::size_t size)
+{
+	const unsigned char* next = static_cast<const unsigned char*>(bytes);
+	std::size_t left = size;
+	while (left != 0) {
+		const ssize_t written = ::write(fd, next, left);
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return result_t::SPILL_ERROR;
+		}
+		next += written;
+		left -= static_cast<std::size_t>(written);
+	}
+	return result_t::OK;
+}
+
+void SpillFile::unmap()
+{
+	if (mData != nullptr) {
+		::munmap(mData, mDataSize);
+		mData = nullptr;
+	}
+	if (mIndex != nullptr) {
+		::munmap(mIndex, mRecords * sizeof(std::uint64_t));
+		mIndex = nullptr;
+	}
+}
+
+const unsigned char* SpillFile::record(const std::size_t i) const
+{
+	std::uint64_t offset{};
+	std::memcpy(&offset, static_cast<const unsigned char*>(mIndex) + i * sizeof(offset),
+		sizeof(offset));
+	return static_cast<const unsigned char*>(mData) + offset;
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,146 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpillFile.h
+ *   The temporary files of a SpilledRecordsSet.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SPILLFILE_PH
+#define D_TSTORAGE_SPILLFILE_PH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines the implementation of `SpilledRecordsSet`. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief A pair of unlinked temporary files holding records and their
+ * offsets, written sequentially and then mapped into memory.
+ *
+ * The records are laid out back-to-back in the data file, each as its key
+ * (CID, MID, MOID, CAP and ACQ, 32 bytes in total, in the host's byte
+ * order), the 4-byte size of its payload and the payload itself. The index
+ * file holds the 8-byte offset of each record. Both are written through
+ * buffers of `cWriteBufferSize` bytes, bypassed by payloads at least as
+ * large, and created on the first `append()`.
+ */
+class SpillFile
+{
+public:
+	/** @brief The size of each of the write buffers. */
+	static constexpr std::size_t cWriteBufferSize = 1024UL * 1024;  // 1 MiB
+	/** @brief The size of a record preceding its payload. */
+	static constexpr std::size_t cRecordHeaderSize = 36;
+
+	/**
+	 * @brief A constructor. Creates no files yet.
+	 * @param directory The directory to create the files in, the one named
+	 * by `TMPDIR` or `/tmp` if empty.
+	 */
+	explicit SpillFile(std::string directory);
+	/** @brief Unmaps and closes the files, which removes them. */
+	~SpillFile();
+
+	SpillFile(const SpillFile&) = delete;
+	SpillFile(SpillFile&&) = delete;
+	SpillFile& operator=(const SpillFile&) = delete;
+	SpillFile& operator=(SpillFile&&) = delete;
+
+	/** @see `SpilledRecordsSet::append()` */
+	result_t append(const Key& key, const void* payload, std::size_t size);
+	/** @see `SpilledRecordsSet::seal()` */
+	result_t seal();
+	/** @see `SpilledRecordsSet::clear()` */
+	void clear();
+
+	/** @brief Returns `true` once the records are mapped. */
+	bool sealed() const { return mSealed; }
+	/** @brief Returns the number of records. */
+	std::size_t size() const { return mRecords; }
+	/** @brief Returns the size of the data file. */
+	std::uint64_t bytes() const { return mDataSize; }
+
+	/** @brief Returns the key of the `i`-th record of a sealed file. */
+	Key key(std::size_t i) const;
+	/** @brief Returns the payload of the `i`-th record of a sealed file. */
+	const unsigned char* payload(std::size_t i) const
+	{
+		return record(i) + cRecordHeaderSize;
+	}
+	/** @brief Returns the payload size of the `i`-th record of a sealed
+	 * file. */
+	std::size_t payloadSize(std::size_t i) const;
+
+private:
+	/** @brief Creates the unlinked files. */
+	result_t open();
+	/** @brief Creates an unlinked file in `mDirectory`.
+	 * @return The file descriptor, `-1` on error. */
+	int createUnlinked() const;
+	/**
+	 * @brief Appends bytes to a file through its buffer.
+	 * @param fd The file.
+	 * @param ioBuffer The write buffer of the file.
+	 * @param bytes The bytes to append.
+	 * @param size The amount of bytes.
+	 * @return Status code.
+	 */
+	static result_t write(
+		int fd, std::vector<unsigned char>& ioBuffer, const void* bytes, std::size_t size);
+	/** @brief Writes out and empties the write buffer of a file. */
+	static result_t flush(int fd, std::vector<unsigned char>& ioBuffer);
+	/** @brief Writes out a memory block to a file. */
+	static result_t writeAll(int fd, const void* bytes, std::size_t size);
+	/** @brief Unmaps the files. */
+	void unmap();
+	/** @brief Returns the address of the `i`-th record of a sealed file. */
+	const unsigned char* record(std::size_t i) const;
+
+	/** @brief The directory to create the files in. */
+	std::string mDirectory;
+	/** @brief The data file, `-1` if not created. */
+	int mDataFd;
+	/** @brief The index file, `-1` if not created. */
+	int mIndexFd;
+	/** @brief The write buffer of the data file. */
+	std::vector<unsigned char> mDataBuffer;
+	/** @brief The write buffer of the index file. */
+	std::vector<unsigned char> mIndexBuffer;
+	/** @brief The size of the data file, including its buffer. */
+	std::uint64_t mDataSize;
+	/** @brief The number of records. */
+	std::size_t mRecords;
+	/** @brief The mapping of the data file, `nullptr` if unmapped. */
+	void* mData;
+	/** @brief The mapping of the index file, `nullptr` if unmapped. */
+	void* mIndex;
+	/** @brief `true` once the records are mapped. */
+	bool mSealed;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpilledRecordsSet.cpp
+ *   A container of records kept in a memory-mapped temporary file.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tstorageclient++/SpilledRecordsSet.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Defines.h"
+#include "SpillFile.h"
+
+namespace tstorage {
+
+TSTORAGE_EXPORT SpilledRecordsSet::SpilledRecordsSet(const std::string& directory)
+	: mDirectory(directory)
+{
+}
+
+TSTORAGE_EXPORT SpilledRecordsSet::~SpilledRecordsSet() = default;
+
+TSTORAGE_EXPORT SpilledRecordsSet::SpilledRecordsSet(SpilledRecordsSet&& other) noexcept = default;
+
+TSTORAGE_EXPORT SpilledRecordsSet& SpilledRecordsSet::operator=(
+	SpilledRecordsSet&& other) noexcept = default;
+
+TSTORAGE_EXPORT result_t SpilledRecordsSet::append(
+	const Key& key, const void* const payload, const std::size_t size)
+{
+	if (!mFile) {
+		mFile = std::make_unique<impl::SpillFile>(mDirectory);
+	}
+	return mFile->append(key, payload, size);
+}
+
+TSTORAGE_EXPORT result_t SpilledRecordsSet::seal()
+{
+	if (!mFile) {
+		mFile = std::make_unique<impl::SpillFile>(mDirectory);
+	}
+	return mFile->seal();
+}
+
+TSTORAGE_EXPORT void SpilledRecordsSet::clear()
+{
+	if (mFile) {
+		mFile->clear();
+	}
+}
+
+TSTORAGE_EXPORT bool SpilledRecordsSet::sealed() const
+{
+	return mFile && mFile->sealed();
+}
+
+TSTORAGE_EXPORT std::size_t SpilledRecordsSet::size() const
+{
+	return mFile ? mFile->size() : 0;
+}
+
+TSTORAGE_EXPORT std::uint64_t SpilledRecordsSet::bytes() const
+{
+	return mFile ? mFile->bytes() : 0;
+}
+
+TSTORAGE_EXPORT Key SpilledRecordsSet::key(const std::size_t i) const
+{
+	return mFile->key(i);
+}
+
+TSTORAGE_EXPORT const unsigned char* SpilledRecordsSet::payload(const std::size_t i) const
+{
+	return mFile->payload(i);
+}
+
+TSTORAGE_EXPORT std::size_t SpilledRecordsSet::payloadSize(const std::size_t i) const
+{
+	return mFile->payloadSize(i);
+}
+
+} /*namespace tstorage*/
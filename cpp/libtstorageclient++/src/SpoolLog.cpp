@@ -0,0 +1,82 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpoolLog.cpp
+ *   A persistent, segmented log of serialized records.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <tstorageclient++/SpoolLog.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Defines.h"
+#include "SpoolLogImpl.h"
+
+namespace tstorage {
+
+constexpr std::size_t SpoolLog::cDefaultSegmentSize;
+
+TSTORAGE_EXPORT SpoolLog::SpoolLog(const std::string& directory, const std::size_t segmentSize)
+	: mImpl(std::make_unique<impl::SpoolLogImpl>(directory, segmentSize))
+{
+}
+
+TSTORAGE_EXPORT SpoolLog::~SpoolLog() = default;
+
+TSTORAGE_EXPORT result_t SpoolLog::open()
+{
+	return mImpl->open();
+}
+
+TSTORAGE_EXPORT result_t SpoolLog::append(
+	const Key& key, const void* const payload, const std::size_t size)
+{
+	return mImpl->append(key, payload, size);
+}
+
+TSTORAGE_EXPORT result_t SpoolLog::front(std::vector<RawRecord>& oRecords)
+{
+	return mImpl->front(oRecords);
+}
+
+TSTORAGE_EXPORT void SpoolLog::popFront()
+{
+	mImpl->popFront();
+}
+
+TSTORAGE_EXPORT bool SpoolLog::empty() const
+{
+	return mImpl->empty();
+}
+
+TSTORAGE_EXPORT std::uint64_t SpoolLog::bytes() const
+{
+	return mImpl->bytes();
+}
+
+TSTORAGE_EXPORT std::size_t SpoolLog::segments() const
+{
+	return mImpl->segments();
+}
+
+} /*namespace tstorage*/
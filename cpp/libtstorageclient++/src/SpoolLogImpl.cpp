@@ -0,0 +1,367 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpoolLogImpl.cpp
+ *   The segment files of a SpoolLog.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SpoolLogImpl.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace impl {
+
+namespace {
+
+/** @brief The prefix of the name of a segment file. */
+constexpr char cPrefix[] = "spool-";
+/** @brief The suffix of the name of a segment file. */
+constexpr char cSuffix[] = ".seg";
+/** @brief The amount of hexadecimal digits of a sequence number. */
+constexpr std::size_t cSequenceDigits = 16;
+
+/**
+ * @brief Parses the sequence number out of the name of a segment file.
+ * @return `true` if `name` is the name of a segment file.
+ */
+bool parseSequence(const char* const name, std::uint64_t& oSequence)
+{
+	const std::size_t prefix = sizeof(cPrefix) - 1;
+	const std::size_t suffix = sizeof(cSuffix) - 1;
+	if (std::strlen(name) != prefix + cSequenceDigits + suffix
+		|| std::strncmp(name, cPrefix, prefix) != 0
+		|| std::strcmp(name + prefix + cSequenceDigits, cSuffix) != 0) {
+		return false;
+	}
+	char* end = nullptr;
+	oSequence = std::strtoull(name + prefix, &end, 16);
+	return end == name + prefix + cSequenceDigits;
+}
+
+} /*namespace*/
+
+constexpr std::size_t SpoolLogImpl::cHeaderSize;
+constexpr std::size_t SpoolLogImpl::cRecordHeaderSize;
+constexpr char SpoolLogImpl::cMagic[8];
+
+SpoolLogImpl::SpoolLogImpl(std::string directory, const std::size_t segmentSize)
+	: mDirectory(std::move(directory))
+	, mSegmentSize(segmentSize)
+	, mNextSequence(0)
+	, mBytes(0)
+	, mOpen(false)
+{
+}
+
+SpoolLogImpl::~SpoolLogImpl()
+{
+	for (Segment& segment : mSealed) {
+		release(segment);
+	}
+	if (mCurrent.fd != -1) {
+		if (mCurrent.length == 0) {
+			(void)::unlink(mCurrent.path.c_str());
+		} else {
+			(void)::ftruncate(mCurrent.fd, static_cast<off_t>(cHeaderSize + mCurrent.length));
+		}
+		release(mCurrent);
+	}
+}
+
+result_t SpoolLogImpl::open()
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mOpen) {
+		return result_t::OK;
+	}
+	DIR* const dir = ::opendir(mDirectory.c_str());
+	if (dir == nullptr) {
+		return result_t::SPOOL_ERROR;
+	}
+	std::vector<std::pair<std::uint64_t, std::string>> paths;
+	while (const dirent* const entry = ::readdir(dir)) { /* NOLINT(concurrency-mt-unsafe) */
+		std::uint64_t sequence{};
+		if (parseSequence(entry->d_name, sequence)) {
+			paths.emplace_back(sequence, mDirectory + "/" + entry->d_name);
+			mNextSequence = std::max(mNextSequence, sequence + 1);
+		}
+	}
+	(void)::closedir(dir);
+	std::sort(paths.begin(), paths.end());
+
+	for (const std::pair<std::uint64_t, std::string>& path : paths) {
+		Segment segment;
+		const result_t res = recover(path.second, segment);
+		if (res != result_t::OK) {
+			return res;
+		}
+		if (segment.fd != -1) {
+			mBytes += segment.length;
+			mSealed.push_back(std::move(segment));
+		}
+	}
+	mOpen = true;
+	return result_t::OK;
+}
+
+result_t SpoolLogImpl::append(const Key& key, const void* const payload, const std::size_t size)
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!mOpen || size > UINT32_MAX) {
+		return result_t::SPOOL_ERROR;
+	}
+	const std::size_t recordSize = cRecordHeaderSize + size;
+	if (mCurrent.fd != -1 && cHeaderSize + mCurrent.length + recordSize > mCurrent.capacity) {
+		seal();
+	}
+	if (mCurrent.fd == -1) {
+		const result_t res = begin(std::max(mSegmentSize, cHeaderSize + recordSize));
+		if (res != result_t::OK) {
+			return res;
+		}
+	}
+
+	const std::uint32_t payloadSize = static_cast<std::uint32_t>(size);
+	unsigned char* field = mCurrent.map + cHeaderSize + mCurrent.length;
+	std::memcpy(field, &key.cid, sizeof(key.cid));
+	field += sizeof(key.cid);
+	std::memcpy(field, &key.mid, sizeof(key.mid));
+	field += sizeof(key.mid);
+	std::memcpy(field, &key.moid, sizeof(key.moid));
+	field += sizeof(key.moid);
+	std::memcpy(field, &key.cap, sizeof(key.cap));
+	field += sizeof(key.cap);
+	std::memcpy(field, &key.acq, sizeof(key.acq));
+	field += sizeof(key.acq);
+	std::memcpy(field, &payloadSize, sizeof(payloadSize));
+	field += sizeof(payloadSize);
+	if (size != 0) {
+		std::memcpy(field, payload, size);
+	}
+
+	// Commits the record, once it is complete.
+	mCurrent.length += recordSize;
+	const std::uint64_t length = mCurrent.length;
+	std::memcpy(mCurrent.map + sizeof(cMagic), &length, sizeof(length));
+	mBytes += recordSize;
+	return result_t::OK;
+}
+
+result_t SpoolLogImpl::front(std::vector<RawRecord>& oRecords)
+{
+	oRecords.clear();
+	const unsigned char* data = nullptr;
+	std::size_t length = 0;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mSealed.empty()) {
+			if (mCurrent.length == 0) {
+				return result_t::OK;
+			}
+			seal();
+		}
+		data = mSealed.front().map + cHeaderSize;
+		length = mSealed.front().length;
+	}
+
+	// A sealed segment is not written to, and is only removed by this
+	// thread, hence it is read without the lock.
+	std::size_t offset = 0;
+	while (offset < length) {
+		if (length - offset < cRecordHeaderSize) {
+			oRecords.clear();
+			return result_t::SPOOL_ERROR;
+		}
+		const unsigned char* field = data + offset;
+		RawRecord record{};
+		std::memcpy(&record.key.cid, field, sizeof(record.key.cid));
+		field += sizeof(record.key.cid);
+		std::memcpy(&record.key.mid, field, sizeof(record.key.mid));
+		field += sizeof(record.key.mid);
+		std::memcpy(&record.key.moid, field, sizeof(record.key.moid));
+		field += sizeof(record.key.moid);
+		std::memcpy(&record.key.cap, field, sizeof(record.key.cap));
+		field += sizeof(record.key.cap);
+		std::memcpy(&record.key.acq, field, sizeof(record.key.acq));
+		field += sizeof(record.key.acq);
+		std::uint32_t payloadSize{};
+		std::memcpy(&payloadSize, field, sizeof(payloadSize));
+		offset += cRecordHeaderSize;
+		if (length - offset < payloadSize) {
+			oRecords.clear();
+			return result_t::SPOOL_ERROR;
+		}
+		record.payload = data + offset;
+		record.size = payloadSize;
+		oRecords.push_back(record);
+		offset += payloadSize;
+	}
+	return result_t::OK;
+}
+
+void SpoolLogImpl::popFront()
+{
+	Segment segment;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mSealed.empty()) {
+			return;
+		}
+		segment = std::move(mSealed.front());
+		mSealed.pop_front();
+		mBytes -= segment.length;
+	}
+	release(segment);
+	(void)::unlink(segment.path.c_str());
+}
+
+bool SpoolLogImpl::empty() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBytes == 0;
+}
+
+std::uint64_t SpoolLogImpl::bytes() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mBytes;
+}
+
+std::size_t SpoolLogImpl::segments() const
+{
+	std::lock_guard<std::mutex> lock(mMutex);
+	return mSealed.size() + (mCurrent.length != 0 ? 1 : 0);
+}
+
+result_t SpoolLogImpl::recover(const std::string& path, Segment& oSegment)
+{
+	const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+	if (fd == -1) {
+		return result_t::SPOOL_ERROR;
+	}
+	struct stat st{};
+	if (::fstat(fd, &st) != 0) {
+		::close(fd);
+		return result_t::SPOOL_ERROR;
+	}
+	const std::size_t fileSize = static_cast<std::size_t>(st.st_size);
+	if (fileSize < cHeaderSize) {
+		// Left by a crash before the header was written.
+		::close(fd);
+		return result_t::OK;
+	}
+	void* const map = ::mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		::close(fd);
+		return result_t::SPOOL_ERROR;
+	}
+	const unsigned char* const header = static_cast<const unsigned char*>(map);
+	std::uint64_t length{};
+	std::memcpy(&length, header + sizeof(cMagic), sizeof(length));
+	if (std::memcmp(header, cMagic, sizeof(cMagic)) != 0 || length > fileSize - cHeaderSize
+		|| length == 0) {
+		(void)::munmap(map, fileSize);
+		::close(fd);
+		if (length == 0) {
+			(void)::unlink(path.c_str());
+		}
+		return result_t::OK;
+	}
+	oSegment.path = path;
+	oSegment.fd = fd;
+	oSegment.map = static_cast<unsigned char*>(map);
+	oSegment.capacity = fileSize;
+	oSegment.length = static_cast<std::size_t>(length);
+	return result_t::OK;
+}
+
+result_t SpoolLogImpl::begin(const std::size_t capacity)
+{
+	char name[sizeof(cPrefix) + cSequenceDigits + sizeof(cSuffix)];
+	(void)std::snprintf(name,
+		sizeof(name),
+		"%s%016llx%s",
+		cPrefix,
+		static_cast<unsigned long long>(mNextSequence),
+		cSuffix);
+	++mNextSequence;
+	std::string path = mDirectory + "/" + name;
+
+	const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+	if (fd == -1) {
+		return result_t::SPOOL_ERROR;
+	}
+	void* map = MAP_FAILED;
+	if (::posix_fallocate(fd, 0, static_cast<off_t>(capacity)) == 0) {
+		map = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	if (map == MAP_FAILED) {
+		::close(fd);
+		(void)::unlink(path.c_str());
+		return result_t::SPOOL_ERROR;
+	}
+	std::memcpy(map, cMagic, sizeof(cMagic));
+	std::memset(static_cast<unsigned char*>(map) + sizeof(cMagic), 0, cHeaderSize - sizeof(cMagic));
+
+	mCurrent.path = std::move(path);
+	mCurrent.fd = fd;
+	mCurrent.map = static_cast<unsigned char*>(map);
+	mCurrent.capacity = capacity;
+	mCurrent.length = 0;
+	return result_t::OK;
+}
+
+void SpoolLogImpl::seal()
+{
+	// Returns the preallocated space past the records to the disk.
+	(void)::ftruncate(mCurrent.fd, static_cast<off_t>(cHeaderSize + mCurrent.length));
+	mSealed.push_back(std::move(mCurrent));
+	mCurrent = Segment();
+}
+
+void SpoolLogImpl::release(Segment& ioSegment)
+{
+	if (ioSegment.map != nullptr) {
+		(void)::munmap(ioSegment.map, ioSegment.capacity);
+		ioSegment.map = nullptr;
+	}
+	if (ioSegment.fd != -1) {
+		::close(ioSegment.fd);
+		ioSegment.fd = -1;
+	}
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,141 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * SpoolLogImpl.h
+ *   The segment files of a SpoolLog.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_SPOOLLOGIMPL_PH
+#define D_TSTORAGE_SPOOLLOGIMPL_PH
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines the implementation of `SpoolLog`. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief The segment files of a `SpoolLog`.
+ *
+ * A segment begins with a header of `cHeaderSize` bytes: the magic string
+ * `cMagic` and the 8-byte length of the complete records following it. The
+ * records are laid out as in a `SpillFile`: the key (CID, MID, MOID, CAP and
+ * ACQ, 32 bytes in total), the 4-byte size of the payload and the payload
+ * itself, all in the host's byte order. The newest segment is preallocated
+ * with `posix_fallocate()`, so that a full disk fails the append that begins
+ * the segment rather than raising `SIGBUS` on a write to the mapping, and
+ * is truncated to its records once sealed.
+ */
+class SpoolLogImpl
+{
+public:
+	/** @brief The size of the header of a segment. */
+	static constexpr std::size_t cHeaderSize = 16;
+	/** @brief The size of a record preceding its payload. */
+	static constexpr std::size_t cRecordHeaderSize = 36;
+	/** @brief The first bytes of a segment. */
+	static constexpr char cMagic[8] = {'T', 'S', 'S', 'P', 'O', 'O', 'L', '1'};
+
+	/** @see `SpoolLog::SpoolLog()` */
+	SpoolLogImpl(std::string directory, std::size_t segmentSize);
+	/** @see `SpoolLog::~SpoolLog()` */
+	~SpoolLogImpl();
+
+	SpoolLogImpl(const SpoolLogImpl&) = delete;
+	SpoolLogImpl(SpoolLogImpl&&) = delete;
+	SpoolLogImpl& operator=(const SpoolLogImpl&) = delete;
+	SpoolLogImpl& operator=(SpoolLogImpl&&) = delete;
+
+	/** @see `SpoolLog::open()` */
+	result_t open();
+	/** @see `SpoolLog::append()` */
+	result_t append(const Key& key, const void* payload, std::size_t size);
+	/** @see `SpoolLog::front()` */
+	result_t front(std::vector<RawRecord>& oRecords);
+	/** @see `SpoolLog::popFront()` */
+	void popFront();
+
+	/** @see `SpoolLog::empty()` */
+	bool empty() const;
+	/** @see `SpoolLog::bytes()` */
+	std::uint64_t bytes() const;
+	/** @see `SpoolLog::segments()` */
+	std::size_t segments() const;
+
+private:
+	/** @brief A mapped segment file. */
+	struct Segment
+	{
+		/** @brief The path of the file. */
+		std::string path;
+		/** @brief The file, `-1` if none. */
+		int fd = -1;
+		/** @brief The mapping of the file. */
+		unsigned char* map = nullptr;
+		/** @brief The size of the mapping. */
+		std::size_t capacity = 0;
+		/** @brief The length of the complete records. */
+		std::size_t length = 0;
+	};
+
+	/**
+	 * @brief Maps a segment left in the directory.
+	 * @param path The path of the file.
+	 * @param[out] oSegment The segment, with `fd == -1` if the file is not a
+	 * segment or holds no records.
+	 * @return Status code.
+	 */
+	static result_t recover(const std::string& path, Segment& oSegment);
+	/** @brief Creates and maps the newest segment, of `capacity` bytes. */
+	result_t begin(std::size_t capacity);
+	/** @brief Moves the newest segment to the sealed ones. */
+	void seal();
+	/** @brief Unmaps and closes a segment. */
+	static void release(Segment& ioSegment);
+
+	/** @brief The directory of the segments. */
+	std::string mDirectory;
+	/** @brief The size of a new segment. */
+	std::size_t mSegmentSize;
+	/** @brief The sequence number of the next segment. */
+	std::uint64_t mNextSequence;
+	/** @brief The sealed segments, the oldest first. */
+	std::deque<Segment> mSealed;
+	/** @brief The segment appended to, with `fd == -1` if none. */
+	Segment mCurrent;
+	/** @brief The length of the records of all segments. */
+	std::uint64_t mBytes;
+	/** @brief `true` once `open()` has succeeded. */
+	bool mOpen;
+	/** @brief Guards the segments against the appending and the consuming
+	 * thread. */
+	mutable std::mutex mMutex;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
@@ -24,6 +24,8 @@
 #include <chrono>
 #include <ctime>
 
+#include <time.h>
+
 #include <tstorageclient++/DataTypes.h>
 #include "Defines.h"
 
@@ -58,6 +60,19 @@ TSTORAGE_EXPORT TimeT now()
 	return fromUnix(std::chrono::system_clock::now());
 }
 
+TSTORAGE_EXPORT TimeT coarseNow()
+{
+#ifdef CLOCK_REALTIME_COARSE
+	constexpr TimeT cNanosPerSecond = 1'000'000'000;
+	timespec time{};
+	if (clock_gettime(CLOCK_REALTIME_COARSE, &time) == 0) {
+		return static_cast<TimeT>(time.tv_sec) * cNanosPerSecond + time.tv_nsec
+			- cNanosFrom1970To2001;
+	}
+#endif
+	return now();
+}
+
 } /*namespace Timestamp*/
 
 } /*namespace tstorage*/
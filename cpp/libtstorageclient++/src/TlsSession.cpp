@@ -0,0 +1,350 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * TlsSession.cpp
+ *   A client TLS session over a connected socket.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TlsSession.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+#include <sys/types.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#ifdef D_TSTORAGE_TLS
+#include <arpa/inet.h>
+#include <csignal>
+#include <ctime>
+#include <netinet/in.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <openssl/x509_vfy.h>
+#include <pthread.h>
+
+#include "HostResolver.h"
+#endif
+
+namespace tstorage {
+namespace impl {
+
+TlsSession::TlsSession()
+	: mCtx(nullptr)
+	, mSsl(nullptr)
+	, mSendOffloaded(false)
+	, mRecvOffloaded(false)
+{
+}
+
+#ifdef D_TSTORAGE_TLS
+
+bool TlsSession::built()
+{
+	return true;
+}
+
+namespace {
+
+/**
+ * @brief Blocks `SIGPIPE` in the calling thread for its lifetime, discarding
+ * the signal if raised in the meantime.
+ *
+ * OpenSSL writes to the socket without `MSG_NOSIGNAL`, hence a write to a
+ * connection reset by the server would otherwise kill the process.
+ */
+class SigPipeGuard
+{
+public:
+	SigPipeGuard() : mWasPending(false)
+	{
+		sigemptyset(&mPipe);
+		sigaddset(&mPipe, SIGPIPE);
+		sigset_t pending;
+		sigemptyset(&pending);
+		if (sigpending(&pending) == 0) {
+			mWasPending = sigismember(&pending, SIGPIPE) == 1;
+		}
+		pthread_sigmask(SIG_BLOCK, &mPipe, &mPrevious);
+	}
+	~SigPipeGuard()
+	{
+		const int error = errno;
+		sigset_t pending;
+		sigemptyset(&pending);
+		if (!mWasPending && sigpending(&pending) == 0 && sigismember(&pending, SIGPIPE) == 1) {
+			// clang-format off
+			const struct timespec noWait{};
+			// clang-format on
+			(void)sigtimedwait(&mPipe, nullptr, &noWait);
+		}
+		pthread_sigmask(SIG_SETMASK, &mPrevious, nullptr);
+		errno = error;
+	}
+
+	SigPipeGuard(const SigPipeGuard&) = delete;
+	SigPipeGuard(SigPipeGuard&&) = delete;
+	SigPipeGuard& operator=(const SigPipeGuard&) = delete;
+	SigPipeGuard& operator=(SigPipeGuard&&) = delete;
+
+private:
+	/** @brief The set of `SIGPIPE` alone. */
+	sigset_t mPipe;
+	/** @brief The signal mask to restore. */
+	sigset_t mPrevious;
+	/** @brief `true` if `SIGPIPE` was pending before, and is not ours. */
+	bool mWasPending;
+};
+
+/** @brief Returns `true` if `host` is an IPv4 or IPv6 address. */
+bool isIpAddress(const std::string& host)
+{
+	struct in6_addr address;
+	return inet_pton(AF_INET, host.c_str(), &address) == 1
+		|| inet_pton(AF_INET6, host.c_str(), &address) == 1;
+}
+
+/** @brief Clamps a transfer size to what the OpenSSL calls accept. */
+int clampSize(const std::size_t amountBytes)
+{
+	return static_cast<int>(
+		std::min<std::size_t>(amountBytes, std::numeric_limits<int>::max()));
+}
+
+}  // namespace
+
+result_t TlsSession::handshake(
+	const int fd, const TlsOptions& options, const std::string& host)
+{
+	release();
+	ERR_clear_error();
+	mCtx = SSL_CTX_new(TLS_client_method());
+	if (mCtx == nullptr) {
+		errno = ENOMEM;
+		return result_t::TLS_ERROR;
+	}
+	SSL_CTX_set_min_proto_version(mCtx, TLS1_2_VERSION);
+	SSL_CTX_set_mode(mCtx, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+	// A server closing the connection without the closure alert is reported
+	// like a plain one closing it.
+	SSL_CTX_set_options(mCtx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+#ifdef SSL_OP_ENABLE_KTLS
+	if (options.kernelOffload) {
+		SSL_CTX_set_options(mCtx, SSL_OP_ENABLE_KTLS);
+	}
+#endif
+
+	bool configured = true;
+	if (options.verifyPeer) {
+		SSL_CTX_set_verify(mCtx, SSL_VERIFY_PEER, nullptr);
+		configured = options.caFile.empty()
+			? SSL_CTX_set_default_verify_paths(mCtx) == 1
+			: SSL_CTX_load_verify_locations(mCtx, options.caFile.c_str(), nullptr) == 1;
+	}
+	if (configured && !options.certFile.empty()) {
+		configured = SSL_CTX_use_certificate_chain_file(mCtx, options.certFile.c_str()) == 1;
+	}
+	if (configured && !options.keyFile.empty()) {
+		configured =
+			SSL_CTX_use_PrivateKey_file(mCtx, options.keyFile.c_str(), SSL_FILETYPE_PEM) == 1;
+	}
+	mSsl = configured ? SSL_new(mCtx) : nullptr;
+	if (mSsl == nullptr || SSL_set_fd(mSsl, fd) != 1) {
+		release();
+		errno = EINVAL;
+		return result_t::TLS_ERROR;
+	}
+
+	const std::string& name = options.serverName.empty() ? host : options.serverName;
+	bool named = true;
+	if (!options.serverName.empty() || !(HostResolver::isLocal(host) || isIpAddress(host))) {
+		named = SSL_set_tlsext_host_name(mSsl, name.c_str()) == 1
+			&& (!options.verifyPeer || SSL_set1_host(mSsl, name.c_str()) == 1);
+	} else if (options.verifyPeer && !HostResolver::isLocal(host)) {
+		named = X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(mSsl), host.c_str()) == 1;
+	}
+	if (!named) {
+		release();
+		errno = EINVAL;
+		return result_t::TLS_ERROR;
+	}
+
+	errno = 0;
+	int ret = 0;
+	{
+		SigPipeGuard guard;
+		ret = SSL_connect(mSsl);
+	}
+	if (ret != 1) {
+		const int error = SSL_get_error(mSsl, ret);
+		result_t res = result_t::TLS_ERROR;
+		if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+			errno = EAGAIN;
+			res = result_t::CONNTIMEOUT;
+		} else if (error == SSL_ERROR_SYSCALL && errno == EINTR) {
+			res = result_t::SIGNAL;
+		} else if (error == SSL_ERROR_SYSCALL && errno != 0) {
+			res = errno == EAGAIN || errno == EWOULDBLOCK ? result_t::CONNTIMEOUT
+														  : result_t::CONNERROR;
+		} else if (error == SSL_ERROR_SYSCALL || error == SSL_ERROR_ZERO_RETURN) {
+			errno = ECONNRESET;
+			res = result_t::CONNCLOSED;
+		} else {
+			errno = EPROTO;
+		}
+		const int savedErrno = errno;
+		release();
+		errno = savedErrno;
+		return res;
+	}
+
+#ifdef SSL_OP_ENABLE_KTLS
+	mSendOffloaded = BIO_get_ktls_send(SSL_get_wbio(mSsl)) == 1;
+	mRecvOffloaded = BIO_get_ktls_recv(SSL_get_rbio(mSsl)) == 1;
+#endif
+	return result_t::OK;
+}
+
+void TlsSession::shutdown()
+{
+	if (mSsl == nullptr) {
+		return;
+	}
+	SigPipeGuard guard;
+	ERR_clear_error();
+	(void)SSL_shutdown(mSsl);
+}
+
+void TlsSession::release()
+{
+	if (mSsl != nullptr) {
+		SSL_free(mSsl);
+		mSsl = nullptr;
+	}
+	if (mCtx != nullptr) {
+		SSL_CTX_free(mCtx);
+		mCtx = nullptr;
+	}
+	mSendOffloaded = false;
+	mRecvOffloaded = false;
+}
+
+ssize_t TlsSession::send(const void* const bytes, const std::size_t amountBytes)
+{
+	if (mSsl == nullptr) {
+		errno = ENOTCONN;
+		return -1;
+	}
+	SigPipeGuard guard;
+	ERR_clear_error();
+	errno = 0;
+	const int ret = SSL_write(mSsl, bytes, clampSize(amountBytes));
+	return ret > 0 ? ret : fail(ret);
+}
+
+ssize_t TlsSession::recv(void* const buffer, const std::size_t amountBytes)
+{
+	if (mSsl == nullptr) {
+		errno = ENOTCONN;
+		return -1;
+	}
+	ERR_clear_error();
+	errno = 0;
+	const int ret = SSL_read(mSsl, buffer, clampSize(amountBytes));
+	return ret > 0 ? ret : fail(ret);
+}
+
+bool TlsSession::pending() const
+{
+	return mSsl != nullptr && SSL_pending(mSsl) > 0;
+}
+
+int TlsSession::fail(const int ret)
+{
+	switch (SSL_get_error(mSsl, ret)) {
+		case SSL_ERROR_ZERO_RETURN:
+			return 0;
+		case SSL_ERROR_WANT_READ: /* fallthrough */
+		case SSL_ERROR_WANT_WRITE:
+			// The blocking socket has timed out.
+			errno = EAGAIN;
+			return -1;
+		case SSL_ERROR_SYSCALL:
+			if (errno == 0) {
+				errno = ECONNRESET;
+			}
+			break;
+		default:
+			errno = EPROTO;
+			break;
+	}
+	// The session is broken, hence no closure alert may be sent.
+	SSL_set_quiet_shutdown(mSsl, 1);
+	return -1;
+}
+
+#else
+
+bool TlsSession::built()
+{
+	return false;
+}
+
+result_t TlsSession::handshake(
+	const int /*fd*/, const TlsOptions& /*options*/, const std::string& /*host*/)
+{
+	errno = ENOTSUP;
+	return result_t::TLS_ERROR;
+}
+
+void TlsSession::shutdown() {}
+
+void TlsSession::release() {}
+
+ssize_t TlsSession::send(const void* /*bytes*/, std::size_t /*amountBytes*/)
+{
+	errno = ENOTCONN;
+	return -1;
+}
+
+ssize_t TlsSession::recv(void* /*buffer*/, std::size_t /*amountBytes*/)
+{
+	errno = ENOTCONN;
+	return -1;
+}
+
+bool TlsSession::pending() const
+{
+	return false;
+}
+
+int TlsSession::fail(const int /*ret*/)
+{
+	return -1;
+}
+
+#endif
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,132 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * TlsSession.h
+ *   A client TLS session over a connected socket.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_TLSSESSION_PH
+#define D_TSTORAGE_TLSSESSION_PH
+
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+/** @file
+ * @brief Defines a TLS backend for the socket operations. */
+
+struct ssl_st;
+struct ssl_ctx_st;
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief A client TLS session, established with OpenSSL over the blocking
+ * socket of a `Socket`.
+ *
+ * The session asks OpenSSL to hand the record layer over to the kernel (kTLS)
+ * after the handshake. Once the kernel encrypts the sent data
+ * (`sendOffloaded()`), the owner keeps writing to the socket with plain
+ * syscalls, `sendmsg()` and io_uring included, as for an unencrypted
+ * connection. Receives always go through `recv()`, since records other than
+ * application data, e.g. the session tickets of TLS 1.3, have to be consumed
+ * by OpenSSL; with kernel offload of the receive side, OpenSSL decrypts
+ * nothing itself.
+ *
+ * `send()` and `recv()` mimic their syscall counterparts: they return the
+ * amount of bytes transferred, or `-1` with `errno` set on error. The socket
+ * timeouts apply, a timed out operation failing with `EAGAIN`.
+ *
+ * The backend is built only with `D_TSTORAGE_TLS` defined (`make TLS=1`),
+ * which links the library with OpenSSL. Otherwise `handshake()` fails.
+ *
+ * Operations may be performed from different threads, but not concurrently.
+ */
+class TlsSession
+{
+public:
+	/** @brief Constructs an inactive session. */
+	TlsSession();
+	/** @brief A destructor. Releases the session if active. */
+	~TlsSession() { release(); }
+
+	TlsSession(const TlsSession&) = delete;
+	TlsSession(TlsSession&&) = delete;
+	TlsSession& operator=(const TlsSession&) = delete;
+	TlsSession& operator=(TlsSession&&) = delete;
+
+	/**
+	 * @brief Performs the handshake over a connected, blocking socket.
+	 *
+	 * The possible error codes are:
+	 *  - `result_t::CONNCLOSED`
+	 *  - `result_t::CONNERROR`
+	 *  - `result_t::CONNTIMEOUT`
+	 *  - `result_t::SIGNAL`
+	 *  - `result_t::TLS_ERROR`
+	 *
+	 * @param fd The socket.
+	 * @param options The TLS options.
+	 * @param host The hostname of the channel, verified unless
+	 * `options.serverName` is set.
+	 * @return Status code. On error, `errno` is set and the session is
+	 * released.
+	 */
+	result_t handshake(int fd, const TlsOptions& options, const std::string& host);
+	/** @brief Sends the closure alert, if the session is active. */
+	void shutdown();
+	/** @brief Releases the session, without notifying the server. */
+	void release();
+	/** @brief Returns `true` if the handshake has succeeded. */
+	bool active() const { return mSsl != nullptr; }
+	/** @brief Returns `true` if the kernel encrypts the sent data. */
+	bool sendOffloaded() const { return mSendOffloaded; }
+	/** @brief Returns `true` if the kernel decrypts the received data. */
+	bool recvOffloaded() const { return mRecvOffloaded; }
+	/** @brief Returns `true` if the backend is built into the library. */
+	static bool built();
+
+	/** @brief Works like `::send()`, writing at most one record. */
+	ssize_t send(const void* bytes, std::size_t amountBytes);
+	/** @brief Works like `::recv()` without flags. */
+	ssize_t recv(void* buffer, std::size_t amountBytes);
+	/** @brief Returns `true` if decrypted bytes are buffered, which `recv()`
+	 * returns without reading from the socket. */
+	bool pending() const;
+
+private:
+	/** @brief Sets `errno` after an operation returned `ret`, and returns
+	 * `-1`, or `0` on a closure alert. */
+	int fail(int ret);
+
+	/** @brief The context of the session, `nullptr` if inactive. */
+	struct ssl_ctx_st* mCtx;
+	/** @brief The session, `nullptr` if inactive. */
+	struct ssl_st* mSsl;
+	/** @brief `true` if the kernel encrypts the sent data. */
+	bool mSendOffloaded;
+	/** @brief `true` if the kernel decrypts the received data. */
+	bool mRecvOffloaded;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
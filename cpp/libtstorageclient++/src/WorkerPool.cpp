@@ -0,0 +1,141 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * WorkerPool.cpp
+ *   A work-stealing thread pool running the tasks of a single producer.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "WorkerPool.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace tstorage {
+namespace impl {
+
+WorkerPool::WorkerPool(const std::size_t threads)
+	: mNextQueue(0)
+	, mQueued(0)
+	, mPending(0)
+	, mStop(false)
+{
+	mQueues.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i) {
+		mQueues.push_back(std::make_unique<Queue>());
+	}
+	mThreads.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i) {
+		mThreads.emplace_back(&WorkerPool::run, this, i);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStop = true;
+	}
+	mWork.notify_all();
+	for (std::thread& thread : mThreads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::submit(std::function<void()> task)
+{
+	++mPending;
+	{
+		Queue& queue = *mQueues[mNextQueue];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+	mNextQueue = (mNextQueue + 1) % mQueues.size();
+	++mQueued;
+
+	// Taking the lock orders the push against an idle worker's predicate check.
+	std::lock_guard<std::mutex> lock(mMutex);
+	mWork.notify_one();
+}
+
+void WorkerPool::wait()
+{
+	while (mPending.load() > 0) {
+		if (runOne(mQueues.size())) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(mMutex);
+		mIdle.wait(lock, [this]() { return mPending.load() == 0; });
+	}
+}
+
+void WorkerPool::run(const std::size_t index)
+{
+	while (true) {
+		if (runOne(index)) {
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(mMutex);
+		mWork.wait(lock, [this]() { return mStop || mQueued.load() > 0; });
+		if (mStop) {
+			return;
+		}
+	}
+}
+
+bool WorkerPool::runOne(const std::size_t index)
+{
+	std::function<void()> task;
+	const std::size_t count = mQueues.size();
+	for (std::size_t i = 0; i < count && !task; ++i) {
+		const std::size_t victim = (index + i) % count;
+		Queue& queue = *mQueues[victim];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+		if (victim == index) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		} else {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+	}
+	if (!task) {
+		return false;
+	}
+	--mQueued;
+	task();
+	finish();
+	return true;
+}
+
+void WorkerPool::finish()
+{
+	if (--mPending == 0) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIdle.notify_all();
+	}
+}
+
+} /*namespace impl*/
+} /*namespace tstorage*/
@@ -0,0 +1,121 @@
+/*
+ * TStorage: Client library (C++)
+ *
+ * WorkerPool.h
+ *   A work-stealing thread pool running the tasks of a single producer.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef D_TSTORAGE_WORKERPOOL_PH
+#define D_TSTORAGE_WORKERPOOL_PH
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @file
+ * @brief Defines a work-stealing pool used to deserialize GET responses. */
+
+namespace tstorage {
+namespace impl {
+
+/**
+ * @brief A fixed-size pool of threads running tasks submitted by one
+ * producer thread.
+ *
+ * Every worker has a task queue of its own, to which `submit()` deals the
+ * tasks round-robin. A worker runs the newest task of its own queue first, and
+ * once that's empty, steals the oldest task of the other queues, so that a
+ * worker stuck on an expensive task doesn't hold back the ones queued behind
+ * it. The producer joins in from `wait()`, stealing tasks until all of them
+ * have finished.
+ *
+ * The tasks must not throw.
+ */
+class WorkerPool
+{
+public:
+	/**
+	 * @brief A constructor. Starts the worker threads.
+	 * @param threads The amount of worker threads. Must be at least `1`.
+	 */
+	explicit WorkerPool(std::size_t threads);
+	/** @brief A destructor. Waits for the submitted tasks and stops the worker
+	 * threads. */
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool(WorkerPool&&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+	WorkerPool& operator=(WorkerPool&&) = delete;
+
+	/** @brief Queues a task for a worker. */
+	void submit(std::function<void()> task);
+	/** @brief Runs queued tasks on the calling thread until all submitted tasks
+	 * have finished. */
+	void wait();
+	/** @brief Returns the amount of worker threads. */
+	std::size_t size() const { return mThreads.size(); }
+
+private:
+	/** @brief The task queue of a worker. */
+	struct Queue
+	{
+		/** @brief Guards `tasks`. */
+		std::mutex mutex;
+		/** @brief The queued tasks, the newest at the back. */
+		std::deque<std::function<void()>> tasks;
+	};
+
+	/** @brief The main loop of the `index`-th worker thread. */
+	void run(std::size_t index);
+	/** @brief Runs a task from the `index`-th queue, newest first, or stolen
+	 * from another queue, oldest first; an `index` past the last queue only
+	 * steals. Returns `false` if all queues are empty. */
+	bool runOne(std::size_t index);
+	/** @brief Marks a task as finished, waking up `wait()` after the last one. */
+	void finish();
+
+	/** @brief The task queues, one per worker. */
+	std::vector<std::unique_ptr<Queue>> mQueues;
+	/** @brief The queue receiving the next task. */
+	std::size_t mNextQueue;
+	/** @brief The amount of tasks queued and not yet taken. */
+	std::atomic<std::size_t> mQueued;
+	/** @brief The amount of tasks submitted and not yet finished. */
+	std::atomic<std::size_t> mPending;
+	/** @brief `true` when the workers are requested to exit. */
+	bool mStop;
+	/** @brief Guards sleeping on the condition variables below. */
+	std::mutex mMutex;
+	/** @brief Wakes up idle workers. */
+	std::condition_variable mWork;
+	/** @brief Signals that the last pending task finished. */
+	std::condition_variable mIdle;
+	/** @brief The worker threads. */
+	std::vector<std::thread> mThreads;
+};
+
+} /*namespace impl*/
+} /*namespace tstorage*/
+
+#endif
@@ -13,6 +13,7 @@ import signal
 import socket
 import struct
 import sys
+import threading
 import time
 import traceback
 from typing import ByteString, Dict, Iterable, IO, List, Tuple, Optional, Union
@@ -324,6 +325,7 @@ class ServerMock:
         self._lastAcq: int = MINACQ
         self._listener: socket.socket = socket.socket()
         self._listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self._lock: threading.Lock = threading.Lock()
         self._log: Optional[str] = log
         self._timeout: float = timeout
         self._uid: int = 0
@@ -353,12 +355,7 @@ class ServerMock:
                 aconn = TCPLoggerConnection(conn, file)
             else:
                 aconn = ActiveConnection(conn)
-            try:
-                while not aconn.closed:
-                    self.processRequests(aconn)
-            except OSError as ose:
-                printu("[ERROR] OSError: " + str(ose))
-                aconn.close()
+            threading.Thread(target=self.serve, args=(aconn,), daemon=True).start()
 
         if file is not None:
             file.close
@@ -369,6 +366,14 @@ class ServerMock:
         self._listener.close()
         printu("Server closed")
 
+    def serve(self, conn: ActiveConnection) -> None:
+        try:
+            while not conn.closed:
+                self.processRequests(conn)
+        except OSError as ose:
+            printu("[ERROR] OSError: " + str(ose))
+            conn.close()
+
     def processRequests(self, conn: ActiveConnection) -> None:
         msgType: MsgType = conn.fetchHeader()
         if self._verbose > 0:
@@ -377,6 +382,11 @@ class ServerMock:
                 if msgType != MsgType.NONE
                 else "Session terminated"
             )
+        # Connections are served concurrently, requests one at a time.
+        with self._lock:
+            self.processRequest(conn, msgType)
+
+    def processRequest(self, conn: ActiveConnection, msgType: MsgType) -> None:
         try:
             if msgType == MsgType.PUT:
                 acqMin, acqMax = self.store(conn.fetchRecordsWoAcq(), hasAcq=False)
@@ -12,6 +12,7 @@ from testrig.utils import warn
 from testrig.testsuite.socket import tests as tests_socket
 from testrig.testsuite.buffer import tests as tests_buffer
 from testrig.testsuite.serializer import tests as tests_serializer
+from testrig.testsuite.timestamp import tests as tests_timestamp
 from testrig.testsuite.channel import tests as tests_channel
 
 server.BINDIR = Path(__file__).parent.resolve() / "bin"
@@ -39,6 +40,7 @@ def runTests(suiteName: Optional[str] = None, host: Optional[str] = None) -> boo
         TestBatch("Socket", tests_socket),
         TestBatch("Buffer", tests_buffer),
         TestBatch("Serializer", tests_serializer),
+        TestBatch("Timestamp", tests_timestamp),
         TestBatch("Channel", tests_channel(host)),
     ]
     if suiteName is not None:
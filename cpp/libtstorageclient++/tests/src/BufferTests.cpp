@@ -6,6 +6,7 @@
 
 #include "BufferTests.h"
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <string>
@@ -161,4 +162,131 @@ int test_buffer_reserve()
 	return 0;
 }
 
+int test_buffer_resize()
+{
+	Buffer buffer(32);
+	char* cStr = static_cast<char*>(buffer.writeData());
+	strlcpy(cStr, "0123456789ABCDEF", buffer.bytesOfFreeSpace());
+	buffer.writeAdvance(16);
+	buffer.readAdvance(8);
+
+	ASSERT_EQ(buffer.resize(128), true);
+	ASSERT_EQ(buffer.capacity(), 128)
+	ASSERT_EQ(buffer.readOffset(), 0)
+	ASSERT_EQ(buffer.bytesAvailableToRead(), 8)
+	ASSERT_EQ(buffer.bytesOfFreeSpace(), 120)
+	const char* ccStr = static_cast<const char*>(buffer.readData());
+	std::string word = std::string(ccStr, buffer.bytesAvailableToRead());
+	ASSERT_EQ(word, "89ABCDEF")
+
+	ASSERT_EQ(buffer.resize(4), false);
+	ASSERT_EQ(buffer.capacity(), 128)
+	ASSERT_EQ(buffer.bytesAvailableToRead(), 8)
+
+	ASSERT_EQ(buffer.resize(8), true);
+	ASSERT_EQ(buffer.capacity(), 8)
+	ASSERT_EQ(buffer.bytesOfFreeSpace(), 0)
+	ccStr = static_cast<const char*>(buffer.readData());
+	word = std::string(ccStr, buffer.bytesAvailableToRead());
+	ASSERT_EQ(word, "89ABCDEF")
+	return 0;
+}
+
+int test_buffer_mirrored()
+{
+	const std::size_t capacity = 4096;
+	Buffer buffer(capacity, Buffer::MIRRORED);
+	ASSERT_EQ(buffer.mirrored(), true)
+	ASSERT_EQ(buffer.capacity(), capacity)
+
+	// Fill the buffer, leaving the unread content right before its end.
+	memset(buffer.writeData(), 'x', capacity - 16);
+	buffer.writeAdvance(capacity - 16);
+	strlcpy(static_cast<char*>(buffer.writeData()), "0123456789ABCDEF", 17);
+	buffer.writeAdvance(16);
+	buffer.readAdvance(capacity - 8);
+	const void* unread = buffer.readData();
+
+	// The window moves instead of the content, which stays where it was.
+	ASSERT_EQ(buffer.reserve(capacity - 8), true);
+	ASSERT_EQ(buffer.readData(), unread)
+	ASSERT_EQ(buffer.readOffset(), 0)
+	ASSERT_EQ(buffer.bytesAvailableToRead(), 8)
+	ASSERT_EQ(buffer.bytesOfFreeSpace(), capacity - 8)
+
+	// Writes past the end of the pages come out contiguous.
+	memset(buffer.writeData(), 'y', capacity - 8);
+	buffer.writeAdvance(capacity - 8);
+	const char* ccStr = static_cast<const char*>(buffer.readData());
+	std::string word = std::string(ccStr, 12);
+	ASSERT_EQ(word, "89ABCDEFyyyy")
+
+	// The window wraps around to the first copy of the pages.
+	buffer.readAdvance(capacity - 4);
+	ASSERT_EQ(buffer.reserve(capacity - 4), true);
+	ccStr = static_cast<const char*>(buffer.readData());
+	word = std::string(ccStr, buffer.bytesAvailableToRead());
+	ASSERT_EQ(word, "yyyy")
+	ASSERT_EQ(buffer.bytesOfFreeSpace(), capacity - 4)
+
+	ASSERT_EQ(buffer.resize(2 * capacity), true);
+	ASSERT_EQ(buffer.mirrored(), true)
+	ccStr = static_cast<const char*>(buffer.readData());
+	word = std::string(ccStr, buffer.bytesAvailableToRead());
+	ASSERT_EQ(word, "yyyy")
+
+	const Buffer copy(buffer);
+	ASSERT_EQ(copy.mirrored(), false)
+	ccStr = static_cast<const char*>(copy.readData());
+	word = std::string(ccStr, copy.bytesAvailableToRead());
+	ASSERT_EQ(word, "yyyy")
+	return 0;
+}
+
+int test_buffer_allocation()
+{
+	const std::size_t hugePageSize = 2UL * 1024 * 1024;
+	const auto address = [](const Buffer& buffer) {
+		return reinterpret_cast<std::uintptr_t>(buffer.readData());
+	};
+
+	// Small blocks are aligned to the cache line, larger ones to the page.
+	const Buffer small(100);
+	ASSERT_EQ(address(small) % 64, 0)
+	const Buffer paged(8192);
+	ASSERT_EQ(address(paged) % 4096, 0)
+
+	// Huge pages back buffers of at least one huge page, aligned to it.
+	BufferAllocation allocation{};
+	allocation.hugePages = BufferAllocation::HugePages::TRANSPARENT;
+	allocation.numaNode = BufferAllocation::cThreadNode;
+	Buffer linear(2 * hugePageSize, Buffer::LINEAR, allocation);
+	ASSERT_EQ(linear.valid(), true)
+	ASSERT_EQ(linear.mirrored(), false)
+	ASSERT_EQ(address(linear) % hugePageSize, 0)
+	ASSERT_GEQ(linear.allocation().numaNode, 0)
+	memset(linear.writeData(), 'x', linear.capacity());
+	linear.writeAdvance(linear.capacity());
+	linear.readAdvance(linear.capacity() - 4);
+	ASSERT_EQ(linear.resize(3 * hugePageSize), true)
+	ASSERT_EQ(linear.allocation().hugePages == BufferAllocation::HugePages::TRANSPARENT, true)
+	ASSERT_EQ(std::string(static_cast<const char*>(linear.readData()), 4), "xxxx")
+
+	// Reserved huge pages fall back to regular ones if the system has none.
+	allocation.hugePages = BufferAllocation::HugePages::RESERVED;
+	Buffer mirrored(hugePageSize + 1, Buffer::MIRRORED, allocation);
+	ASSERT_EQ(mirrored.valid(), true)
+	ASSERT_EQ(mirrored.mirrored(), true)
+	ASSERT_EQ(address(mirrored) % hugePageSize, 0)
+	const std::size_t capacity = mirrored.capacity();
+	memset(mirrored.writeData(), 'y', capacity);
+	mirrored.writeAdvance(capacity);
+	mirrored.readAdvance(capacity - 4);
+	ASSERT_EQ(mirrored.reserve(capacity - 4), true)
+	memset(mirrored.writeData(), 'z', capacity - 4);
+	mirrored.writeAdvance(capacity - 4);
+	ASSERT_EQ(std::string(static_cast<const char*>(mirrored.readData()), 6), "yyyyzz")
+	return 0;
+}
+
 } /*namespace tstorage*/
@@ -12,6 +12,9 @@ namespace tstorage {
 int test_buffer_create();
 int test_buffer_heads();
 int test_buffer_reserve();
+int test_buffer_resize();
+int test_buffer_mirrored();
+int test_buffer_allocation();
 
 } /*namespace tstorage*/
 
@@ -6,22 +6,74 @@
 
 #include "ChannelTests.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <csignal>
 #include <cstdlib>
 #include <cstring>
+#include <future>
 #include <iomanip>
+#include <iterator>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <memory>
 #include <random>
 #include <set>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
 
+#include <pthread.h>
+#include <unistd.h>
+
+#include <tstorageclient++/Arena.h>
+#include <tstorageclient++/AsyncChannel.h>
+#include <tstorageclient++/ArrowRecordsSet.h>
+#include <tstorageclient++/BlobRecordsSet.h>
+#include <tstorageclient++/CachingChannel.h>
 #include <tstorageclient++/Channel.h>
+#include <tstorageclient++/ChannelPool.h>
+#include <tstorageclient++/ClusterChannel.h>
+#include <tstorageclient++/CoalescingPool.h>
+#include <tstorageclient++/ColumnarRecordsSet.h>
+#include <tstorageclient++/CompressedPayloadType.h>
+#include <tstorageclient++/CountingAllocator.h>
 #include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/LazyRecordsSet.h>
+#include <tstorageclient++/MemoryBudget.h>
+#include <tstorageclient++/MergedStream.h>
+#include <tstorageclient++/MixedRecordsSet.h>
+#include <tstorageclient++/PayloadCodec.h>
+#include <tstorageclient++/EventLoop.h>
+#include <tstorageclient++/InternedPayloadType.h>
+#include <tstorageclient++/NegativeCache.h>
+#include <tstorageclient++/NumericPayloadTypes.h>
+#include <tstorageclient++/PackedKey.h>
+#include <tstorageclient++/PutAggregator.h>
+#include <tstorageclient++/PutSpool.h>
+#include <tstorageclient++/PutStream.h>
+#include <tstorageclient++/RecordsIndex.h>
 #include <tstorageclient++/RecordsSet.h>
+#include <tstorageclient++/ReplicaChannel.h>
 #include <tstorageclient++/Response.h>
 #include <tstorageclient++/ResponseAcq.h>
+#include <tstorageclient++/SamplePacker.h>
+#include <tstorageclient++/SeriesCompressor.h>
+#include <tstorageclient++/SeriesSet.h>
+#include <tstorageclient++/SharedPayloadType.h>
+#include <tstorageclient++/Snapshot.h>
+#include <tstorageclient++/SpilledRecordsSet.h>
+#include <tstorageclient++/StreamOperators.h>
 #include <tstorageclient++/Timestamp.h>
+#include <tstorageclient++/Tracer.h>
+#include <tstorageclient++/TrivialPayloadType.h>
+#include <tstorageclient++/ViewRecordsSet.h>
+#include <tstorageclient++/WindowScanner.h>
 
 #include "FloatPayload.h"
 #include "StringPayload.h"
@@ -66,7 +118,7 @@ bool compKeysFloatsWithAcq(const Record<float>& a, const Record<float>& b)
 		|| (a.key.mid == b.key.mid && (a.key.moid < b.key.moid
 		|| (a.key.moid == b.key.moid && (a.key.cap < b.key.cap
 		|| (a.key.cap == b.key.cap && (a.key.acq < b.key.acq
-		|| std::memcmp(av, bv, sizeof(float)) < 0))))))));
+		|| (a.key.acq == b.key.acq && std::memcmp(av, bv, sizeof(float)) < 0)))))))));
 };
 
 bool compKeysFloats(const Record<float>& a, const Record<float>& b)
@@ -77,7 +129,7 @@ bool compKeysFloats(const Record<float>& a, const Record<float>& b)
 		|| (a.key.cid == b.key.cid && (a.key.mid < b.key.mid
 		|| (a.key.mid == b.key.mid && (a.key.moid < b.key.moid
 		|| (a.key.moid == b.key.moid && (a.key.cap < b.key.cap
-		|| std::memcmp(av, bv, sizeof(float)) < 0))))));
+		|| (a.key.cap == b.key.cap && std::memcmp(av, bv, sizeof(float)) < 0)))))));
 };
 
 bool compKeysStringConditionalAcq(const Record<std::string>& a, const Record<std::string>& b)
@@ -91,6 +143,25 @@ bool compKeysStringConditionalAcq(const Record<std::string>& a, const Record<std
 				|| a.value < b.value))))))));
 };
 
+bool compKeysStringsWithAcq(const Record<std::string>& a, const Record<std::string>& b)
+{
+	return a.key.cid < b.key.cid
+		|| (a.key.cid == b.key.cid && (a.key.mid < b.key.mid
+		|| (a.key.mid == b.key.mid && (a.key.moid < b.key.moid
+		|| (a.key.moid == b.key.moid && (a.key.cap < b.key.cap
+		|| (a.key.cap == b.key.cap && (a.key.acq < b.key.acq
+		|| (a.key.acq == b.key.acq && a.value < b.value)))))))));
+};
+
+bool compKeysStrings(const Record<std::string>& a, const Record<std::string>& b)
+{
+	return a.key.cid < b.key.cid
+		|| (a.key.cid == b.key.cid && (a.key.mid < b.key.mid
+		|| (a.key.mid == b.key.mid && (a.key.moid < b.key.moid
+		|| (a.key.moid == b.key.moid && (a.key.cap < b.key.cap
+		|| (a.key.cap == b.key.cap && a.value < b.value)))))));
+};
+
 bool compKeys(const Record<std::string>& a, const Record<std::string>& b)
 {
 	return a.key.cid < b.key.cid
@@ -1185,4 +1256,7263 @@ int test_channel_put_key_out_of_range()
 	return 0;
 }
 
+int test_channel_put_pipelined()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+	channel.setPutPipelineDepth(3);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	std::random_device r{};
+	std::mt19937 mt{r()};
+	std::uniform_real_distribution<float> rand(-1.0F, 1.0F);
+	for (long int i = 0; i < 50'000; ++i) {
+		records.append(
+			Key(getTestCid(i % 5), i % 31, i % 17, Timestamp::now(), 1000 * i),
+			rand(mt));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records through 3 pipelined 4KiB buffers..." << endl;
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(64UL * 1024 * 1024);
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+
+	cout << "Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 4;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (records.size() != resGet.records().size()) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 5;
+	}
+	int resCompare = compareRecordsSets(records, resGet.records(), compKeysFloatsWithAcq);
+	if (resCompare != 0) {
+		return 6;
+	}
+	cout << "Both record sets are equal." << endl;
+	return 0;
+}
+
+int test_channel_put_vectored()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	const std::array<std::size_t, 5> sizes{10, 1024, 20 * 1024, 100 * 1024, 1024 * 1024};
+	RecordsSet<std::string> records;
+	std::random_device r{};
+	std::mt19937 mt{r()};
+	std::uniform_int_distribution<int> rand('a', 'z');
+	for (long int i = 0; i < 60; ++i) {
+		const std::size_t size = sizes[(i * 7) % sizes.size()];
+		records.append(
+			Key(getTestCid(i % 3), i, 1, Timestamp::now(), 1000 * i),
+			size, static_cast<char>(rand(mt)));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records through a 4KiB buffer..." << endl;
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Sending records through PUT..." << endl;
+	RecordsSet<std::string> putRecords;
+	for (long int i = 0; i < 10; ++i) {
+		putRecords.append(Key(getTestCid(4), i, 2, Timestamp::now(), 0),
+			sizes[i % sizes.size()], static_cast<char>(rand(mt)));
+	}
+	resPut = channel.put(putRecords);
+	if (resPut.error()) {
+		cout << "[ERROR] PUT failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(64UL * 1024 * 1024);
+	Key putaKeyMax = keyMax;
+	putaKeyMax.moid = 2;
+	ResponseGet<std::string> resGet = channel.get(keyMin, putaKeyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+	Key putKeyMin = keyMin;
+	putKeyMin.moid = 2;
+	ResponseGet<std::string> resGetPut = channel.get(putKeyMin, keyMax);
+	if (resGetPut.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGetPut.status() << endl;
+		return 5;
+	}
+
+	cout << "Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 6;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (records.size() != resGet.records().size()
+		|| putRecords.size() != resGetPut.records().size()) {
+		cout << "[ERROR] Sent " << records.size() + putRecords.size()
+			 << " records, received "
+			 << resGet.records().size() + resGetPut.records().size() << endl;
+		return 7;
+	}
+	int resCompare =
+		compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq);
+	if (resCompare != 0) {
+		return 8;
+	}
+	resCompare = compareRecordsSets(putRecords, resGetPut.records(), compKeys);
+	if (resCompare != 0) {
+		return 9;
+	}
+	cout << "Both record sets are equal." << endl;
+	return 0;
+}
+
+int test_channel_get_view()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	std::random_device r{};
+	std::mt19937 mt{r()};
+	std::uniform_real_distribution<float> rand(-1.0F, 1.0F);
+	for (long int i = 0; i < 10000; ++i) {
+		records.append(Key(getTestCid(i % 3), 2, 3, Timestamp::now(), 1000 * i), rand(mt));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	channel.setMemoryLimit(512);
+	cout << "Memory limit set: 512B" << endl;
+
+	FloatPayload payloadType;
+	RecordsSet<float> recvdRecords;
+	bool badPayload = false;
+	auto visitor = [&](const Key& key, const void* payload, std::size_t payloadSize) {
+		float value{};
+		if (!payloadType.fromBytes(value, payload, payloadSize)) {
+			badPayload = true;
+		}
+		recvdRecords.append(key, value);
+	};
+
+	cout << "Gathering whole database through getView..." << endl;
+	ResponseAcq resGet = channel.getView(keyMin, keyMax, visitor);
+	if (resGet.error()) {
+		cout << "[ERROR] View GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (badPayload) {
+		cout << "[ERROR] View GET returned a payload of unexpected size" << endl;
+		return 4;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (records.size() != recvdRecords.size()) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << recvdRecords.size() << endl;
+		return 5;
+	}
+	int resCompare = compareRecordsSets(records, recvdRecords, compKeysFloatsWithAcq);
+	if (resCompare != 0) {
+		return 6;
+	}
+	cout << "Both record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_get_into()
+{
+	constexpr std::size_t cRecords = 10000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	RecordsSet<float> records;
+	for (std::size_t i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 3), 2, 3, Timestamp::now(), 1000 * i),
+			static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	// Smaller than the response, which isn't collected in a set.
+	channel.setMemoryLimit(4096);
+
+	cout << "Deserializing into preallocated columns through a sink..." << endl;
+	std::vector<Key> keys(cRecords);
+	std::vector<float> values(cRecords, -1.0F);
+	std::size_t received = 0;
+	ResponseAcq resGet = channel.getInto(keyMin, keyMax, [&](const Key& key) -> float& {
+		keys[received] = key;
+		return values[received++];
+	});
+	if (resGet.error() || received != cRecords) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", " << received
+			 << " records received" << endl;
+		return 3;
+	}
+	RecordsSet<float> recvdRecords;
+	for (std::size_t i = 0; i < cRecords; ++i) {
+		recvdRecords.append(keys[i], values[i]);
+	}
+	if (compareRecordsSets(records, recvdRecords, compKeysFloatsWithAcq) != 0) {
+		return 4;
+	}
+
+	cout << "Deserializing through output iterators..." << endl;
+	std::vector<Key> appendedKeys;
+	std::vector<float> values2(cRecords, -1.0F);
+	resGet = channel.getInto(keyMin, keyMax, std::back_inserter(appendedKeys), values2.begin());
+	if (resGet.error() || appendedKeys != keys || values2 != values) {
+		cout << "[ERROR] Iterator GET failed: " << (int)resGet.status() << ", "
+			 << appendedKeys.size() << " records received" << endl;
+		return 5;
+	}
+	return 0;
+}
+
+int test_channel_count_range()
+{
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<std::string> records;
+	std::map<Key::CidT, RangeSize> expected;
+	RangeSize expectedTotal;
+	for (long int i = 0; i < 3000; ++i) {
+		const Key::CidT cid = getTestCid(i % 3);
+		// A record larger than the memory limit set below.
+		const std::size_t payloadSize = i == 1500 ? 4096 : i % 3 * 10 + i % 7;
+		records.append(Key(cid, 2, 3, Timestamp::now(), 1000 * i), std::string(payloadSize, 'x'));
+		++expected[cid].records;
+		expected[cid].bytes += 32 + payloadSize;
+		++expectedTotal.records;
+		expectedTotal.bytes += 32 + payloadSize;
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	channel.setMemoryLimit(512);
+	cout << "Memory limit set: 512B" << endl;
+
+	cout << "Counting the records..." << endl;
+	std::uint64_t count = 0;
+	std::map<Key::CidT, std::uint64_t> cidCounts;
+	ResponseAcq resCount = channel.countRange(keyMin, keyMax, count, cidCounts);
+	if (resCount.error()) {
+		cout << "[ERROR] countRange failed: " << (int)resCount.status() << endl;
+		return 3;
+	}
+	if (count != records.size() || cidCounts.size() != expected.size()) {
+		cout << "[ERROR] Counted " << count << " records of " << cidCounts.size()
+			 << " CIDs, sent " << records.size() << endl;
+		return 4;
+	}
+	for (const auto& cid : expected) {
+		if (cidCounts[cid.first] != cid.second.records) {
+			cout << "[ERROR] Counted " << cidCounts[cid.first] << " records of CID "
+				 << cid.first << ", expected " << cid.second.records << endl;
+			return 5;
+		}
+	}
+
+	cout << "Measuring the records..." << endl;
+	RangeSizes sizes;
+	ResponseAcq resSize = channel.sizeRange(keyMin, keyMax, sizes);
+	if (resSize.error()) {
+		cout << "[ERROR] sizeRange failed: " << (int)resSize.status() << endl;
+		return 6;
+	}
+	if (sizes.total.records != expectedTotal.records || sizes.total.bytes != expectedTotal.bytes
+		|| sizes.cids.size() != expected.size()) {
+		cout << "[ERROR] Measured " << sizes.total.records << " records and "
+			 << sizes.total.bytes << " bytes, expected " << expectedTotal.records << " and "
+			 << expectedTotal.bytes << endl;
+		return 7;
+	}
+	for (const auto& cid : expected) {
+		const RangeSize& size = sizes.cids[cid.first];
+		if (size.records != cid.second.records || size.bytes != cid.second.bytes) {
+			cout << "[ERROR] Measured " << size.records << " records and " << size.bytes
+				 << " bytes of CID " << cid.first << endl;
+			return 8;
+		}
+	}
+
+	cout << "Checking that the channel is still usable..." << endl;
+	std::uint64_t countAgain = 0;
+	resCount = channel.countRange(keyMin, keyMax, countAgain);
+	if (resCount.error() || countAgain != count) {
+		cout << "[ERROR] Second countRange failed: " << (int)resCount.status() << endl;
+		return 9;
+	}
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 10;
+	}
+	return 0;
+}
+
+int test_channel_open_stream()
+{
+	constexpr std::size_t cRecords = 10000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	RecordsSet<float> records;
+	for (std::size_t i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 3), 2, 3, Timestamp::now(), 1000 * i),
+			static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	// Smaller than the response, which isn't collected in a set.
+	channel.setMemoryLimit(4096);
+
+	cout << "Iterating over a stream..." << endl;
+	RecordsSet<float> recvdRecords;
+	{
+		Channel<float>::Stream stream = channel.openStream(keyMin, keyMax);
+		for (const Record<float>& record : stream) {
+			recvdRecords.append(record.key, record.value);
+		}
+		if (!stream.finished() || stream.response().error()) {
+			cout << "[ERROR] Stream failed: " << (int)stream.response().status() << endl;
+			return 3;
+		}
+	}
+	if (compareRecordsSets(records, recvdRecords, compKeysFloatsWithAcq) != 0) {
+		return 4;
+	}
+
+	cout << "Draining a partly read stream..." << endl;
+	{
+		Channel<float>::Stream stream = channel.openStream(keyMin, keyMax);
+		for (std::size_t i = 0; i < 10; ++i) {
+			if (!stream.next()) {
+				cout << "[ERROR] Stream ended early" << endl;
+				return 5;
+			}
+		}
+		const ResponseAcq resDrain = stream.drain();
+		if (resDrain.error()) {
+			cout << "[ERROR] Drain failed: " << (int)resDrain.status() << endl;
+			return 6;
+		}
+	}
+
+	cout << "Dropping a pending stream..." << endl;
+	{
+		Channel<float>::Stream stream = channel.openStream(keyMin, keyMax);
+		if (!stream.next()) {
+			cout << "[ERROR] Stream failed: " << (int)stream.response().status() << endl;
+			return 7;
+		}
+	}
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 8;
+	}
+	std::vector<Key> keys;
+	std::vector<float> values(cRecords);
+	ResponseAcq resGet = channel.getInto(keyMin, keyMax, std::back_inserter(keys), values.begin());
+	RecordsSet<float> recvdAgain;
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		recvdAgain.append(keys[i], values[i]);
+	}
+	if (resGet.error() || compareRecordsSets(records, recvdAgain, compKeysFloatsWithAcq) != 0) {
+		cout << "[ERROR] GET after a dropped stream failed: " << (int)resGet.status() << endl;
+		return 9;
+	}
+	return 0;
+}
+
+int test_channel_merged_stream()
+{
+	constexpr std::size_t cStreams = 3;
+	constexpr long int cCaps = 500;
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	// Every CID has every MID, so that MID shards interleave in key order,
+	// and the CAPs of the series interleave too. The records are put in key
+	// order, as a server returns them.
+	RecordsSet<float> records;
+	for (std::int32_t cid = 0; cid < 3; ++cid) {
+		for (std::int64_t mid = 0; mid < 3; ++mid) {
+			for (long int i = 0; i < cCaps; ++i) {
+				const Key key(getTestCid(cid), mid, 0, keyMin.cap + 10 * i + 3 * cid + mid, i);
+				records.append(key, static_cast<float>(i));
+			}
+		}
+	}
+
+	std::vector<std::unique_ptr<Channel<float>>> channels;
+	for (std::size_t i = 0; i < cStreams; ++i) {
+		channels.push_back(std::make_unique<Channel<float>>(
+			globals::addr, globals::port, std::make_unique<FloatPayload>()));
+		channels.back()->setTimeout(3000ms);
+		// Smaller than the responses, which aren't collected in sets.
+		channels.back()->setMemoryLimit(4096);
+		Response res = channels.back()->connect();
+		if (res.error()) {
+			cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+			return 1;
+		}
+	}
+	channels[0]->setMemoryLimit(64UL * 1024 * 1024);
+	Response resPut = channels[0]->puta(records);
+	channels[0]->setMemoryLimit(4096);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Merging MID shards in key order..." << endl;
+	{
+		std::vector<Channel<float>::Stream> streams;
+		for (std::size_t i = 0; i < cStreams; ++i) {
+			Key shardMin = keyMin;
+			Key shardMax = keyMax;
+			shardMin.mid = static_cast<std::int64_t>(i);
+			shardMax.mid = static_cast<std::int64_t>(i) + 1;
+			streams.push_back(channels[i]->openStream(shardMin, shardMax));
+		}
+		MergedStream<float> merged(std::move(streams));
+		RecordsSet<float> recvdRecords;
+		for (const Record<float>& record : merged) {
+			const Key& key = record.key;
+			if (recvdRecords.size() > 0) {
+				const Key& prev = recvdRecords[recvdRecords.size() - 1].key;
+				if (std::tie(prev.cid, prev.mid, prev.moid, prev.cap)
+					>= std::tie(key.cid, key.mid, key.moid, key.cap)) {
+					cout << "[ERROR] Record " << recvdRecords.size() << " out of key order" << endl;
+					return 3;
+				}
+			}
+			recvdRecords.append(key, record.value);
+		}
+		if (!merged.finished() || merged.response().error()) {
+			cout << "[ERROR] Merge failed: " << (int)merged.response().status() << endl;
+			return 4;
+		}
+		if (compareRecordsSets(records, recvdRecords, compKeysFloatsWithAcq) != 0) {
+			return 5;
+		}
+	}
+
+	cout << "Merging series in CAP order..." << endl;
+	{
+		std::vector<Channel<float>::Stream> streams;
+		for (std::size_t i = 0; i < cStreams; ++i) {
+			Key seriesMin = keyMin;
+			Key seriesMax = keyMax;
+			seriesMin.cid = getTestCid(static_cast<std::int32_t>(i));
+			seriesMax.cid = seriesMin.cid + 1;
+			seriesMin.mid = static_cast<std::int64_t>(i);
+			seriesMax.mid = static_cast<std::int64_t>(i) + 1;
+			streams.push_back(channels[i]->openStream(seriesMin, seriesMax));
+		}
+		MergedStream<float> merged(std::move(streams), MergeOrder::CAP);
+		std::size_t count = 0;
+		Key::CapT prevCap = 0;
+		while (merged.next()) {
+			const Key& key = merged.record().key;
+			if (key.cid != getTestCid(static_cast<std::int32_t>(merged.source()))
+				|| (count > 0 && key.cap <= prevCap)) {
+				cout << "[ERROR] Record " << count << " out of CAP order" << endl;
+				return 6;
+			}
+			prevCap = key.cap;
+			++count;
+		}
+		if (merged.response().error() || count != cStreams * cCaps) {
+			cout << "[ERROR] Merged " << count << " records, status "
+				 << (int)merged.response().status() << endl;
+			return 7;
+		}
+	}
+
+	cout << "Draining a partly read merge..." << endl;
+	{
+		std::vector<Channel<float>::Stream> streams;
+		for (std::size_t i = 0; i < cStreams; ++i) {
+			streams.push_back(channels[i]->openStream(keyMin, keyMax));
+		}
+		MergedStream<float> merged(std::move(streams));
+		for (std::size_t i = 0; i < 10; ++i) {
+			merged.next();
+		}
+		if (merged.drain().error()) {
+			cout << "[ERROR] Drain failed: " << (int)merged.response().status() << endl;
+			return 8;
+		}
+	}
+	for (const std::unique_ptr<Channel<float>>& channel : channels) {
+		if (!channel->connected()) {
+			cout << "[ERROR] A drained channel was closed" << endl;
+			return 9;
+		}
+		channel->close();
+	}
+	return 0;
+}
+
+int test_channel_pool()
+{
+	constexpr int cThreads = 8;
+	constexpr int cRecordsPerThread = 2000;
+
+	ChannelPool<float> pool(globals::addr, globals::port, std::make_shared<FloatPayload>(), 3);
+	pool.setTimeout(3000ms);
+	pool.setMemoryLimit(64UL * 1024 * 1024);
+	pool.setReconnectInterval(50ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	std::vector<RecordsSet<float>> records(cThreads);
+	RecordsSet<float> allRecords;
+	for (int t = 0; t < cThreads; ++t) {
+		for (long int i = 0; i < cRecordsPerThread; ++i) {
+			const Key key(getTestCid(t), i % 13, i % 7, Timestamp::now(), 1000 * i);
+			records[t].append(key, static_cast<float>(t * cRecordsPerThread + i));
+			allRecords.append(key, static_cast<float>(t * cRecordsPerThread + i));
+		}
+	}
+
+	cout << "Connecting a pool of " << pool.size() << " channels..." << endl;
+	Response res = pool.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records from " << cThreads << " threads..." << endl;
+	std::array<result_t, cThreads> results{};
+	std::vector<std::thread> threads;
+	for (int t = 0; t < cThreads; ++t) {
+		threads.emplace_back([&pool, &records, &results, t]() {
+			ChannelPool<float>::Lease lease = pool.acquire();
+			results[t] = lease->puta(records[t]).status();
+			if (t % 3 == 0) {
+				// Hand a closed channel back to have it reconnected by the pool.
+				(void)lease->close();
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	for (int t = 0; t < cThreads; ++t) {
+		if (results[t] != result_t::OK) {
+			cout << "[ERROR] PUTA from thread " << t << " failed: " << (int)results[t] << endl;
+			return 2;
+		}
+	}
+
+	cout << "Checking that a lease times out when the pool is exhausted..." << endl;
+	{
+		std::vector<ChannelPool<float>::Lease> leases;
+		for (std::size_t i = 0; i < pool.size(); ++i) {
+			leases.push_back(pool.acquire(3000ms));
+			if (!leases.back()) {
+				cout << "[ERROR] Failed to lease channel " << i << endl;
+				return 3;
+			}
+		}
+		if (pool.tryAcquire() || pool.acquire(10ms)) {
+			cout << "[ERROR] Leased more channels than the pool holds" << endl;
+			return 4;
+		}
+	}
+
+	cout << "Fetching all records through the pool..." << endl;
+	ResponseGet<float> resGet = pool.acquire()->get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 5;
+	}
+	pool.close();
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (allRecords.size() != resGet.records().size()) {
+		cout << "[ERROR] Sent " << allRecords.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 6;
+	}
+	int resCompare = compareRecordsSets(allRecords, resGet.records(), compKeysFloatsWithAcq);
+	if (resCompare != 0) {
+		return 7;
+	}
+	cout << "Both record sets are equal." << endl;
+	return 0;
+}
+
+int test_channel_pool_get_parallel()
+{
+	ChannelPool<float> pool(globals::addr, globals::port, std::make_shared<FloatPayload>(), 3);
+	pool.setTimeout(3000ms);
+	pool.setMemoryLimit(64UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	RecordsSet<float> cidRecords;
+	for (long int i = 0; i < 20'000; ++i) {
+		const Key key(getTestCid(i % 9), i % 11, i % 5, keyMin.cap + 1000 * i, 0);
+		records.append(key, static_cast<float>(i));
+		if (key.cid == getTestCid(4)) {
+			cidRecords.append(key, static_cast<float>(i));
+		}
+	}
+
+	cout << "Connecting a pool of " << pool.size() << " channels..." << endl;
+	Response res = pool.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	Response resPut = pool.acquire()->puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching all records with 5 CID-sharded queries..." << endl;
+	ResponseGet<float> resGet = pool.getParallel(keyMin, keyMax, 5);
+	if (resGet.error()) {
+		cout << "[ERROR] Parallel GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	ResponseAcq resAcq = pool.acquire()->getAcq(keyMin, keyMax);
+	if (resAcq.error() || resGet.acq() > resAcq.acq()) {
+		cout << "[ERROR] Parallel GET returned ACQ " << resGet.acq()
+			 << " past the current ACQ " << resAcq.acq() << endl;
+		return 4;
+	}
+	if (records.size() != resGet.records().size()) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 5;
+	}
+	int resCompare = compareRecordsSets(records, resGet.records(), compKeysFloats);
+	if (resCompare != 0) {
+		return 6;
+	}
+
+	cout << "Fetching a single CID with 4 CAP-sharded queries..." << endl;
+	Key cidMin = keyMin;
+	Key cidMax = keyMax;
+	cidMin.cid = getTestCid(4);
+	cidMax.cid = getTestCid(5);
+	resGet = pool.getParallel(cidMin, cidMax, 4);
+	if (resGet.error()) {
+		cout << "[ERROR] Parallel GET failed: " << (int)resGet.status() << endl;
+		return 7;
+	}
+	if (cidRecords.size() != resGet.records().size()) {
+		cout << "[ERROR] Expected " << cidRecords.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 8;
+	}
+	resCompare = compareRecordsSets(cidRecords, resGet.records(), compKeysFloats);
+	if (resCompare != 0) {
+		return 9;
+	}
+
+	cout << "Fetching skewed CID shards, stealing from the loaded ones..." << endl;
+	// The last of the 3 shards holds no CID in use, so its worker only
+	// fetches halves of the CAP spans of the others.
+	Key capMax = keyMax;
+	capMax.cap = keyMin.cap + 1000 * 20'000;
+	resGet = pool.getParallel(keyMin, capMax, 3);
+	if (resGet.error()) {
+		cout << "[ERROR] Parallel GET failed: " << (int)resGet.status() << endl;
+		return 10;
+	}
+	if (records.size() != resGet.records().size()) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 11;
+	}
+	resCompare = compareRecordsSets(records, resGet.records(), compKeysFloats);
+	if (resCompare != 0) {
+		return 12;
+	}
+
+	cout << "Checking that an empty key range is still reported..." << endl;
+	resGet = pool.getParallel(keyMax, keyMin, 4);
+	if (resGet.status() != result_t::EMPTY_KEY_RANGE) {
+		cout << "[ERROR] Expected EMPTY_KEY_RANGE, got " << (int)resGet.status() << endl;
+		return 13;
+	}
+	pool.close();
+	cout << "All parallel queries are correct." << endl;
+	return 0;
+}
+
+int test_channel_pool_put_parallel()
+{
+	ChannelPool<float> pool(globals::addr, globals::port, std::make_shared<FloatPayload>(), 3);
+	pool.setTimeout(3000ms);
+	pool.setMemoryLimit(64UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	// Interleaved CIDs, the first of which holds half of the records.
+	RecordsSet<float> records;
+	for (long int i = 0; i < 20'000; ++i) {
+		const std::int32_t tid = i % 2 == 0 ? 0 : 1 + i % 7;
+		const Key key(getTestCid(tid), i % 11, i % 5, keyMin.cap + 1000 * i, i);
+		records.append(key, static_cast<float>(i));
+	}
+
+	cout << "Connecting a pool of " << pool.size() << " channels..." << endl;
+	Response res = pool.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending the records with 3 concurrent PUTA requests..." << endl;
+	std::vector<PutPartition> partitions;
+	Response resPut = pool.putaParallel(records, 3, partitions);
+	if (resPut.error()) {
+		cout << "[ERROR] Parallel PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	if (partitions.size() != 3) {
+		cout << "[ERROR] Expected 3 partitions, got " << partitions.size() << endl;
+		return 3;
+	}
+	std::size_t partitioned = 0;
+	std::set<Key::CidT> cids;
+	for (const PutPartition& partition : partitions) {
+		if (partition.status != result_t::OK || partition.cids.empty()) {
+			cout << "[ERROR] Partition of " << partition.cids.size()
+				 << " CIDs failed: " << (int)partition.status << endl;
+			return 4;
+		}
+		partitioned += partition.records;
+		cids.insert(partition.cids.begin(), partition.cids.end());
+	}
+	if (partitioned != records.size() || cids.size() != 8) {
+		cout << "[ERROR] Partitions hold " << partitioned << " records of " << cids.size()
+			 << " CIDs" << endl;
+		return 5;
+	}
+	if (partitions[0].cids != std::vector<Key::CidT>{getTestCid(0)}) {
+		cout << "[ERROR] The largest CID doesn't have a partition of its own" << endl;
+		return 6;
+	}
+
+	cout << "Fetching the records back..." << endl;
+	ResponseGet<float> resGet = pool.acquire()->get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 7;
+	}
+	if (records.size() != resGet.records().size()) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 8;
+	}
+	const int resCompare = compareRecordsSets(records, resGet.records(), compKeysFloatsWithAcq);
+	if (resCompare != 0) {
+		return 9;
+	}
+	pool.close();
+	cout << "All records are stored." << endl;
+	return 0;
+}
+
+int test_channel_pool_window_scanner()
+{
+	ChannelPool<float> pool(globals::addr, globals::port, std::make_shared<FloatPayload>(), 4);
+	pool.setTimeout(3000ms);
+
+	constexpr long int cRecords = 20'000;
+	constexpr Key::CapT cStep = 1000;
+	constexpr Key::CapT cWindow = 1000 * cStep;
+	const Key keyMin = getTestKeyMin();
+	Key keyMax = getTestKeyMax();
+	keyMax.cap = keyMin.cap + cRecords * cStep;
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 3), i % 7, i % 5, keyMin.cap + cStep * i, 0),
+			static_cast<float>(i));
+	}
+
+	Response res = pool.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	Response resPut = pool.acquire()->puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Scanning a planned range in " << cRecords * cStep / cWindow << " windows..." << endl;
+	WindowScanner<float> scanner(pool);
+	scanner.plan(keyMin, keyMax, cWindow);
+	RecordsSet<float> scanned;
+	ResponseGet<float> resGet(result_t::OK);
+	Key::CapT expectedCap = keyMin.cap;
+	while (scanner.next(resGet)) {
+		if (resGet.error()) {
+			cout << "[ERROR] Window GET failed: " << (int)resGet.status() << endl;
+			return 3;
+		}
+		if (scanner.windowMin().cap != expectedCap
+			|| scanner.windowMax().cap != expectedCap + cWindow) {
+			cout << "[ERROR] Unexpected window [" << scanner.windowMin().cap << ", "
+				 << scanner.windowMax().cap << ")" << endl;
+			return 4;
+		}
+		expectedCap += cWindow;
+		for (const Record<float>& record : resGet.records()) {
+			scanned.append(record.key, record.value);
+		}
+	}
+	if (expectedCap != keyMax.cap || scanner.hits() == 0) {
+		cout << "[ERROR] Scan ended at CAP " << expectedCap << " with " << scanner.hits()
+			 << " windows read ahead" << endl;
+		return 5;
+	}
+	if (records.size() != scanned.size()) {
+		cout << "[ERROR] Sent " << records.size() << " records, scanned " << scanned.size() << endl;
+		return 6;
+	}
+	int resCompare = compareRecordsSets(records, scanned, compKeysFloats);
+	if (resCompare != 0) {
+		return 7;
+	}
+	cout << scanner.hits() << " windows read ahead, " << scanner.misses() << " on demand." << endl;
+
+	cout << "Detecting sequential get() windows..." << endl;
+	WindowScanner<float> detector(pool);
+	for (long int i = 0; i < 6; ++i) {
+		Key windowMin = keyMin;
+		Key windowMax = keyMax;
+		windowMin.cap = keyMin.cap + i * cWindow;
+		windowMax.cap = windowMin.cap + cWindow;
+		resGet = detector.get(windowMin, windowMax);
+		if (resGet.error() || resGet.records().size() != static_cast<std::size_t>(cWindow / cStep)) {
+			cout << "[ERROR] Window " << i << " returned " << resGet.records().size()
+				 << " records, status " << (int)resGet.status() << endl;
+			return 8;
+		}
+	}
+	if (detector.misses() != 2 || detector.hits() != 4) {
+		cout << "[ERROR] Expected 2 windows on demand and 4 read ahead, got " << detector.misses()
+			 << " and " << detector.hits() << endl;
+		return 9;
+	}
+
+	cout << "Checking that a scan without read-ahead fetches on demand..." << endl;
+	ScanReadAhead none;
+	none.windows = 0;
+	WindowScanner<float> unbuffered(pool, none);
+	unbuffered.plan(keyMin, keyMax, cWindow);
+	std::size_t count = 0;
+	while (unbuffered.next(resGet) && !resGet.error()) {
+		count += resGet.records().size();
+	}
+	if (count != records.size() || unbuffered.hits() != 0) {
+		cout << "[ERROR] Scanned " << count << " records with " << unbuffered.hits()
+			 << " windows read ahead" << endl;
+		return 10;
+	}
+	pool.close();
+	cout << "All windows are correct." << endl;
+	return 0;
+}
+
+int test_channel_pool_coalescing()
+{
+	ChannelPool<float> pool(globals::addr, globals::port, std::make_shared<FloatPayload>(), 4);
+	pool.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(i % 3), i % 7, 0, keyMin.cap + i, 0), static_cast<float>(i));
+	}
+
+	Response res = pool.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	Response resPut = pool.acquire()->puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	constexpr std::size_t cCallers = 16;
+	cout << "Sending " << cCallers << " concurrent GETs of the same key-interval..." << endl;
+	CoalescingOptions options;
+	options.acqTtl = std::chrono::microseconds(60'000'000);
+	CoalescingPool<float> coalescing(pool, options);
+	std::atomic<std::size_t> failures(0);
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0; i < cCallers; ++i) {
+		threads.emplace_back([&]() {
+			ResponseGet<float> resGet = coalescing.get(keyMin, keyMax);
+			if (resGet.error() || resGet.records().size() != records.size()
+				|| compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+				++failures;
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	if (failures.load() != 0) {
+		cout << "[ERROR] " << failures.load() << " GETs returned wrong records" << endl;
+		return 3;
+	}
+	if (coalescing.fetches() + coalescing.joins() != cCallers || coalescing.fetches() == 0) {
+		cout << "[ERROR] " << coalescing.fetches() << " GETs sent and " << coalescing.joins()
+			 << " joined for " << cCallers << " calls" << endl;
+		return 4;
+	}
+	cout << coalescing.fetches() << " GETs sent, " << coalescing.joins() << " joined." << endl;
+
+	cout << "Checking that GETACQ responses are cached..." << endl;
+	const std::uint64_t fetchesBefore = coalescing.fetches();
+	const ResponseAcq resAcq = coalescing.getAcq(keyMin, keyMax);
+	if (resAcq.error() || resAcq.acq() == 0) {
+		cout << "[ERROR] GETACQ failed: " << (int)resAcq.status() << endl;
+		return 5;
+	}
+	for (int i = 0; i < 10; ++i) {
+		const ResponseAcq resCached = coalescing.getAcq(keyMin, keyMax);
+		if (resCached.error() || resCached.acq() != resAcq.acq()) {
+			cout << "[ERROR] Cached GETACQ returned " << resCached.acq() << " instead of "
+				 << resAcq.acq() << endl;
+			return 6;
+		}
+	}
+	if (coalescing.fetches() != fetchesBefore + 1 || coalescing.hits() != 10) {
+		cout << "[ERROR] Expected 1 GETACQ sent and 10 cached, got "
+			 << coalescing.fetches() - fetchesBefore << " and " << coalescing.hits() << endl;
+		return 7;
+	}
+	coalescing.clear();
+	if (coalescing.getAcq(keyMin, keyMax).error()
+		|| coalescing.fetches() != fetchesBefore + 2) {
+		cout << "[ERROR] GETACQ was not sent after clearing the cache" << endl;
+		return 8;
+	}
+	pool.close();
+	cout << "All coalesced responses are correct." << endl;
+	return 0;
+}
+
+int test_channel_pool_lanes()
+{
+	using Lane = ChannelPool<float>::Lane;
+
+	ChannelPool<float> pool(globals::addr, globals::port, std::make_shared<FloatPayload>(), 3);
+	pool.setTimeout(3000ms);
+	pool.setControlLane(1);
+	if (pool.size(Lane::BULK) != 2 || pool.size(Lane::CONTROL) != 1) {
+		cout << "[ERROR] Expected 2 bulk and 1 control channels, got " << pool.size(Lane::BULK)
+			 << " and " << pool.size(Lane::CONTROL) << endl;
+		return 1;
+	}
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(i % 3), 0, 0, keyMin.cap + i, 0), static_cast<float>(i));
+	}
+
+	cout << "Connecting a pool of " << pool.size() << " channels..." << endl;
+	Response res = pool.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	Response resPut = pool.acquire()->puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Querying the ACQ while the bulk lane is leased out..." << endl;
+	{
+		ChannelPool<float>::Lease bulk1 = pool.acquire(3000ms);
+		ChannelPool<float>::Lease bulk2 = pool.acquire(3000ms);
+		if (!bulk1 || !bulk2 || pool.tryAcquire() || pool.acquire(20ms)) {
+			cout << "[ERROR] Bulk requests took a channel of the control lane" << endl;
+			return 4;
+		}
+		ResponseAcq resAcq = pool.getAcq(keyMin, keyMax);
+		if (resAcq.error() || resAcq.acq() == 0) {
+			cout << "[ERROR] GETACQ failed: " << (int)resAcq.status() << endl;
+			return 5;
+		}
+		ResponseGet<float> resGet =
+			pool.acquire(3000ms, Lane::CONTROL)->get(keyMin, keyMax);
+		if (resGet.error() || resGet.records().size() != records.size()) {
+			cout << "[ERROR] GET over the control lane failed: " << (int)resGet.status() << endl;
+			return 6;
+		}
+	}
+
+	cout << "Checking that control requests spill over to idle bulk channels..." << endl;
+	{
+		ChannelPool<float>::Lease control1 = pool.tryAcquire(Lane::CONTROL);
+		ChannelPool<float>::Lease control2 = pool.tryAcquire(Lane::CONTROL);
+		ChannelPool<float>::Lease control3 = pool.tryAcquire(Lane::CONTROL);
+		if (!control1 || !control2 || !control3 || pool.tryAcquire(Lane::CONTROL)) {
+			cout << "[ERROR] Control requests did not lease all 3 channels" << endl;
+			return 7;
+		}
+		if (control1->getAcq(keyMin, keyMax).error() || control3->getAcq(keyMin, keyMax).error()) {
+			cout << "[ERROR] GETACQ failed" << endl;
+			return 8;
+		}
+	}
+	pool.close();
+	return 0;
+}
+
+int test_channel_async()
+{
+	constexpr int cChannels = 3;
+	constexpr int cRecordsPerChannel = 3000;
+
+	EventLoop loop;
+	std::vector<std::unique_ptr<AsyncChannel<float>>> channels;
+	for (int c = 0; c < cChannels; ++c) {
+		channels.push_back(std::make_unique<AsyncChannel<float>>(
+			loop, globals::addr, globals::port, std::make_unique<FloatPayload>()));
+		channels.back()->setTimeout(3000ms);
+	}
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	std::vector<RecordsSet<float>> records(cChannels);
+	RecordsSet<float> allRecords;
+	for (int c = 0; c < cChannels; ++c) {
+		for (long int i = 0; i < cRecordsPerChannel; ++i) {
+			const Key key(getTestCid(c), i % 13, i % 7, Timestamp::now(), 1000 * i);
+			records[c].append(key, static_cast<float>(c * cRecordsPerChannel + i));
+			allRecords.append(key, static_cast<float>(c * cRecordsPerChannel + i));
+		}
+	}
+
+	cout << "Checking that requests fail before connecting..." << endl;
+	if (loop.start().error()) {
+		cout << "[ERROR] Failed to start the event loop" << endl;
+		return 1;
+	}
+	const Response resNotConnected = channels[0]->puta(records[0]).get();
+	if (resNotConnected.status() != result_t::NOT_CONNECTED) {
+		cout << "[ERROR] Expected NOT_CONNECTED, got " << (int)resNotConnected.status() << endl;
+		return 2;
+	}
+
+	cout << "Connecting " << cChannels << " channels..." << endl;
+	std::vector<std::future<Response>> connects;
+	for (const std::unique_ptr<AsyncChannel<float>>& channel : channels) {
+		connects.push_back(channel->connect());
+	}
+	for (std::future<Response>& connect : connects) {
+		const Response res = connect.get();
+		if (res.error()) {
+			cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+			return 3;
+		}
+	}
+
+	cout << "Sending records through all channels at once..." << endl;
+	// Split each channel's records into several pipelined requests.
+	std::vector<std::future<Response>> puts;
+	for (int c = 0; c < cChannels; ++c) {
+		RecordsSet<float> part;
+		std::size_t i = 0;
+		for (const Record<float>& record : records[c]) {
+			part.append(record);
+			if (++i % 1000 == 0) {
+				puts.push_back(channels[c]->puta(part));
+				part = RecordsSet<float>{};
+			}
+		}
+	}
+	for (std::future<Response>& put : puts) {
+		const Response res = put.get();
+		if (res.error()) {
+			cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+			return 4;
+		}
+	}
+
+	cout << "Checking that an empty key range is rejected..." << endl;
+	const ResponseAcq resEmpty = channels[0]->getAcq(keyMax, keyMin).get();
+	if (resEmpty.status() != result_t::EMPTY_KEY_RANGE) {
+		cout << "[ERROR] Expected EMPTY_KEY_RANGE, got " << (int)resEmpty.status() << endl;
+		return 5;
+	}
+
+	cout << "Fetching all records with GET, GETACQ and a GET stream at once..." << endl;
+	std::future<ResponseGet<float>> futureGet = channels[0]->get(keyMin, keyMax);
+	std::future<ResponseAcq> futureAcq = channels[1]->getAcq(keyMin, keyMax);
+	RecordsSet<float> streamed;
+	std::size_t portions = 0;
+	std::promise<ResponseAcq> streamDone;
+	channels[2]->setMemoryLimit(4096);
+	(void)channels[2]->close();
+	const Response resReconnect = channels[2]->connect().get();
+	if (resReconnect.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)resReconnect.status() << endl;
+		return 6;
+	}
+	channels[2]->getStream(
+		keyMin,
+		keyMax,
+		[&streamed, &portions](RecordsSet<float>& portion) {
+			++portions;
+			for (const Record<float>& record : portion) {
+				streamed.append(record);
+			}
+		},
+		[&streamDone](const ResponseAcq& response) { streamDone.set_value(response); });
+
+	ResponseGet<float> resGet = futureGet.get();
+	const ResponseAcq resAcq = futureAcq.get();
+	const ResponseAcq resStream = streamDone.get_future().get();
+	if (resGet.error() || resAcq.error() || resStream.error()) {
+		cout << "[ERROR] Requests failed: GET " << (int)resGet.status() << ", GETACQ "
+			 << (int)resAcq.status() << ", GET stream " << (int)resStream.status() << endl;
+		return 7;
+	}
+	if (portions < 2) {
+		cout << "[ERROR] The GET stream was not split into portions" << endl;
+		return 8;
+	}
+	for (const std::unique_ptr<AsyncChannel<float>>& channel : channels) {
+		if (channel->close().error()) {
+			cout << "[ERROR] Close failed" << endl;
+			return 9;
+		}
+	}
+
+	cout << "Comparing sent records with the responses..." << endl;
+	if (allRecords.size() != resGet.records().size() || allRecords.size() != streamed.size()) {
+		cout << "[ERROR] Sent " << allRecords.size() << " records, received "
+			 << resGet.records().size() << " and " << streamed.size() << endl;
+		return 10;
+	}
+	int resCompare = compareRecordsSets(allRecords, resGet.records(), compKeysFloatsWithAcq);
+	if (resCompare != 0) {
+		return 11;
+	}
+	resCompare = compareRecordsSets(allRecords, streamed, compKeysFloatsWithAcq);
+	if (resCompare != 0) {
+		return 12;
+	}
+	cout << "All record sets are equal." << endl;
+	return 0;
+}
+
+int test_channel_get_batch()
+{
+	constexpr int cCids = 4;
+	constexpr int cRecordsPerCid = 500;
+	constexpr int cAcqRanges = 200;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records[cCids];
+	RecordsSet<float> allRecords;
+	std::random_device r{};
+	std::mt19937 mt{r()};
+	std::uniform_real_distribution<float> rand(-1.0F, 1.0F);
+	for (int c = 0; c < cCids; ++c) {
+		for (long int i = 0; i < cRecordsPerCid; ++i) {
+			const Key key(getTestCid(c), 2, 3, Timestamp::now(), 1000 * i);
+			const float value = rand(mt);
+			records[c].append(key, value);
+			allRecords.append(key, value);
+		}
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	for (int c = 0; c < cCids; ++c) {
+		Response resPut = channel.puta(records[c]);
+		if (resPut.error()) {
+			cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+			return 2;
+		}
+	}
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+	std::vector<KeyRange> ranges;
+	for (int c = 0; c < cCids; ++c) {
+		Key cidMin = keyMin;
+		Key cidMax = keyMax;
+		cidMin.cid = getTestCid(c);
+		cidMax.cid = getTestCid(c) + 1;
+		ranges.push_back(KeyRange{cidMin, cidMax});
+		if (c == cCids / 2) {
+			ranges.push_back(KeyRange{keyMax, keyMin});
+		}
+	}
+	ranges.push_back(KeyRange{keyMin, keyMax});
+
+	cout << "Sending " << ranges.size() << " pipelined GET requests..." << endl;
+	std::vector<ResponseGet<float>> responses = channel.getBatch(ranges);
+	if (responses.size() != ranges.size()) {
+		cout << "[ERROR] Expected " << ranges.size() << " responses, received "
+			 << responses.size() << endl;
+		return 3;
+	}
+
+	cout << "Comparing responses with sent records..." << endl;
+	std::size_t response = 0;
+	for (int c = 0; c < cCids; ++c, ++response) {
+		if (c == cCids / 2 + 1) {
+			if (responses[response].status() != result_t::EMPTY_KEY_RANGE) {
+				cout << "[ERROR] Empty range returned " << (int)responses[response].status()
+					 << endl;
+				return 4;
+			}
+			++response;
+		}
+		if (responses[response].error()) {
+			cout << "[ERROR] GET #" << response
+				 << " failed: " << (int)responses[response].status() << endl;
+			return 5;
+		}
+		if (compareRecordsSets(records[c], responses[response].records(), compKeysFloatsWithAcq)
+			!= 0) {
+			return 6;
+		}
+	}
+	if (responses[response].error()) {
+		cout << "[ERROR] Full range GET failed: " << (int)responses[response].status() << endl;
+		return 7;
+	}
+	if (compareRecordsSets(allRecords, responses[response].records(), compKeysFloatsWithAcq) != 0) {
+		return 8;
+	}
+
+	ranges.clear();
+	for (int i = 0; i < cAcqRanges; ++i) {
+		Key rangeMax = keyMax;
+		rangeMax.cid = getTestCid(i % cCids) + 1;
+		ranges.push_back(KeyRange{keyMin, rangeMax});
+	}
+	ranges[cAcqRanges / 2] = KeyRange{keyMax, keyMin};
+
+	cout << "Sending " << ranges.size() << " pipelined GETACQ requests..." << endl;
+	std::vector<ResponseAcq> acqResponses = channel.getAcqBatch(ranges);
+	if (acqResponses.size() != ranges.size()) {
+		cout << "[ERROR] Expected " << ranges.size() << " responses, received "
+			 << acqResponses.size() << endl;
+		return 9;
+	}
+	for (std::size_t i = 0; i < acqResponses.size(); ++i) {
+		const result_t expected =
+			i == cAcqRanges / 2 ? result_t::EMPTY_KEY_RANGE : result_t::OK;
+		if (acqResponses[i].status() != expected) {
+			cout << "[ERROR] GETACQ #" << i << " returned " << (int)acqResponses[i].status()
+				 << endl;
+			return 10;
+		}
+	}
+
+	cout << "All responses are correct. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 11;
+	}
+	return 0;
+}
+
+int test_channel_get_coalesced()
+{
+	constexpr int cWindows = 5;
+	constexpr Key::CapT cWindow = 100'000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(i % 2), 1, 1, keyMin.cap + 500 * i, 0), static_cast<float>(i));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	std::vector<KeyRange> ranges;
+	for (int c = 0; c < 2; ++c) {
+		for (int w = 0; w < cWindows; ++w) {
+			Key windowMin = keyMin;
+			Key windowMax = keyMax;
+			windowMin.cid = getTestCid(c);
+			windowMax.cid = getTestCid(c) + 1;
+			windowMin.cap = keyMin.cap + cWindow * w;
+			windowMax.cap = keyMin.cap + cWindow * (w + 1);
+			ranges.push_back(KeyRange{windowMin, windowMax});
+		}
+	}
+	KeyRange overlapping = ranges[0];
+	overlapping.keyMin.cap += cWindow / 2;
+	overlapping.keyMax.cap += cWindow * 2;
+	ranges.push_back(overlapping);
+	KeyRange wholeCid = ranges[cWindows];
+	wholeCid.keyMin.cap = keyMin.cap;
+	wholeCid.keyMax.cap = keyMax.cap;
+	ranges.push_back(wholeCid);
+	ranges.push_back(KeyRange{keyMax, keyMin});
+
+	std::vector<std::size_t> covering;
+	const std::vector<KeyRange> merged = coalesceKeyRanges(ranges, covering);
+	if (merged.size() != 3 || covering[0] != 0 || covering[cWindows] != 1
+		|| covering.back() != 2) {
+		cout << "[ERROR] Merged " << ranges.size() << " key-intervals into " << merged.size()
+			 << " instead of 3" << endl;
+		return 3;
+	}
+
+	cout << "Fetching " << ranges.size() << " key-intervals with " << merged.size()
+		 << " GET requests..." << endl;
+	std::vector<ResponseGet<float>> responses = channel.getCoalesced(ranges);
+	if (responses.size() != ranges.size()) {
+		cout << "[ERROR] Expected " << ranges.size() << " responses, received "
+			 << responses.size() << endl;
+		return 4;
+	}
+	if (responses.back().status() != result_t::EMPTY_KEY_RANGE) {
+		cout << "[ERROR] Empty range returned " << (int)responses.back().status() << endl;
+		return 5;
+	}
+
+	cout << "Comparing responses with separate GETs..." << endl;
+	for (std::size_t i = 0; i + 1 < ranges.size(); ++i) {
+		ResponseGet<float> expected = channel.get(ranges[i].keyMin, ranges[i].keyMax);
+		if (expected.error() || responses[i].error()) {
+			cout << "[ERROR] GET #" << i << " failed: " << (int)responses[i].status() << ", "
+				 << (int)expected.status() << endl;
+			return 6;
+		}
+		if (expected.records().size() == 0) {
+			cout << "[ERROR] GET #" << i << " returned no records" << endl;
+			return 7;
+		}
+		if (compareRecordsSets(expected.records(), responses[i].records(), compKeysFloatsWithAcq)
+			!= 0) {
+			cout << "[ERROR] GET #" << i << " returned different records" << endl;
+			return 8;
+		}
+	}
+
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 9;
+	}
+	return 0;
+}
+
+int test_channel_get_columnar()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	std::random_device r{};
+	std::mt19937 mt{r()};
+	std::uniform_real_distribution<float> rand(-1.0F, 1.0F);
+	for (long int i = 0; i < 5000; ++i) {
+		records.append(Key(getTestCid(i % 3), i, i % 7, Timestamp::now(), 1000 * i), rand(mt));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Gathering whole database into columns..." << endl;
+	ColumnarRecordsSet<float> columns;
+	ResponseAcq resGet = channel.getColumnar(keyMin, keyMax, columns);
+	if (resGet.error()) {
+		cout << "[ERROR] Columnar GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	const std::size_t count = columns.size();
+	if (columns.cids().size() != count || columns.mids().size() != count
+		|| columns.moids().size() != count || columns.caps().size() != count
+		|| columns.acqs().size() != count || columns.values().size() != count) {
+		cout << "[ERROR] Columns differ in length" << endl;
+		return 4;
+	}
+	RecordsSet<float> recvdRecords;
+	for (std::size_t i = 0; i < count; ++i) {
+		recvdRecords.append(columns.key(i), columns.values()[i]);
+	}
+	if (compareRecordsSets(records, recvdRecords, compKeysFloatsWithAcq) != 0) {
+		return 5;
+	}
+
+	channel.setMemoryLimit(4096);
+	cout << "Memory limit set: 4096B" << endl;
+
+	cout << "Streaming whole database into columns..." << endl;
+	RecordsSet<float> streamedRecords;
+	int portions = 0;
+	ResponseAcq resStream = channel.getStreamColumnar(
+		keyMin, keyMax, [&](ColumnarRecordsSet<float>& batch) {
+			++portions;
+			for (std::size_t i = 0; i < batch.size(); ++i) {
+				streamedRecords.append(batch.key(i), batch.values()[i]);
+			}
+		});
+	if (resStream.error()) {
+		cout << "[ERROR] Columnar GET stream failed: " << (int)resStream.status() << endl;
+		return 6;
+	}
+	if (portions < 2) {
+		cout << "[ERROR] Expected the response to be split, got " << portions << " portions"
+			 << endl;
+		return 7;
+	}
+	if (compareRecordsSets(records, streamedRecords, compKeysFloatsWithAcq) != 0) {
+		return 8;
+	}
+
+	cout << "All record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 9;
+	}
+	return 0;
+}
+
+int test_channel_get_stream_reuse()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	std::random_device r{};
+	std::mt19937 mt{r()};
+	std::uniform_real_distribution<float> rand(-1.0F, 1.0F);
+	for (long int i = 0; i < 10000; ++i) {
+		records.append(Key(getTestCid(1), 2, 3, Timestamp::now(), 1000 * i), rand(mt));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	channel.setMemoryLimit(2048);
+	cout << "Memory limit set: 2048B" << endl;
+
+	std::vector<RecordsSet<float>> batches;
+	const RecordsSet<float>* batchAddress = nullptr;
+	bool batchReused = true;
+	auto callback = [&](RecordsSet<float>& batch) {
+		if (batchAddress != nullptr && batchAddress != &batch) {
+			batchReused = false;
+		}
+		batchAddress = &batch;
+		// Take over the records, leaving a moved-from set to the channel.
+		batches.push_back(std::move(batch));
+	};
+
+	cout << "Gathering whole database through getStream..." << endl;
+	ResponseAcq resGet = channel.getStream(keyMin, keyMax, callback);
+	if (resGet.error()) {
+		cout << "[ERROR] Stream GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (batches.size() < 2) {
+		cout << "[ERROR] Stream GET ran through only a single batch of records" << endl;
+		return 4;
+	}
+	if (!batchReused) {
+		cout << "[ERROR] Stream GET did not reuse the batch container" << endl;
+		return 5;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	RecordsSet<float> recvdRecords;
+	for (const RecordsSet<float>& batch : batches) {
+		for (const Record<float>& record : batch) {
+			recvdRecords.append(record);
+		}
+	}
+	if (compareRecordsSets(records, recvdRecords, compKeysFloatsWithAcq) != 0) {
+		return 6;
+	}
+	cout << "Both record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_trivial_payload()
+{
+	Channel<float> channel(
+		globals::addr, globals::port, std::make_unique<TrivialPayloadType<float>>());
+	channel.setTimeout(3000ms);
+	Channel<float> referenceChannel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	referenceChannel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	std::random_device r{};
+	std::mt19937 mt{r()};
+	std::uniform_real_distribution<float> rand(-1.0F, 1.0F);
+	for (long int i = 0; i < 100; ++i) {
+		records.append(Key(getTestCid(1), 21, i, Timestamp::now()), rand(mt));
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = referenceChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records with a trivial payload type..." << endl;
+	Response resPut = channel.put(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUT failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the records with a trivial payload type..." << endl;
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+		return 4;
+	}
+
+	cout << "Fetching the records with a virtual payload type..." << endl;
+	ResponseGet<float> resGetReference = referenceChannel.get(keyMin, keyMax);
+	if (resGetReference.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGetReference.status() << endl;
+		return 5;
+	}
+	if (compareRecordsSets(records, resGetReference.records(), compKeysFloats) != 0) {
+		return 6;
+	}
+
+	cout << "All record sets are equal. Closing connections..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 7;
+	}
+	res = referenceChannel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_put_generator()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	std::vector<Record<float>> rangeRecords;
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		const Key key(getTestCid(1 + i % 3), 22, i, Timestamp::now());
+		rangeRecords.push_back(Record<float>{key, static_cast<float>(i)});
+		records.append(key, static_cast<float>(i));
+	}
+	std::vector<Key> generatedKeys;
+	for (long int i = 0; i < 1000; ++i) {
+		generatedKeys.emplace_back(getTestCid(4), 22, i, Timestamp::now(), i + 1);
+		records.append(generatedKeys.back(), -static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records from an iterator range..." << endl;
+	Response resPut = channel.put(rangeRecords.begin(), rangeRecords.end());
+	if (resPut.error()) {
+		cout << "[ERROR] PUT failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Sending records from a generator..." << endl;
+	std::size_t generated = 0;
+	resPut = channel.putaFrom([&generated, &generatedKeys](Record<float>& oRecord) {
+		if (generated == generatedKeys.size()) {
+			return false;
+		}
+		oRecord.key = generatedKeys[generated];
+		oRecord.value = -static_cast<float>(generated);
+		++generated;
+		return true;
+	});
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(128UL * 1024);
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+		return 5;
+	}
+	cout << "Both record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_put_stream()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	RecordsSet<float> putRecords;
+	RecordsSet<float> putaRecords;
+	for (long int i = 0; i < 1000; ++i) {
+		putRecords.append(Key(getTestCid(1 + i % 2), 23, i, Timestamp::now()), static_cast<float>(i));
+	}
+	for (long int i = 0; i < 100; ++i) {
+		putaRecords.append(
+			Key(getTestCid(3), 23, i, Timestamp::now(), i + 1), -static_cast<float>(i));
+	}
+	for (const Record<float>& record : putRecords) {
+		records.append(record);
+	}
+	for (const Record<float>& record : putaRecords) {
+		records.append(record);
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Appending records to a PUT stream..." << endl;
+	PutStream<float> stream = channel.putStream(0ms);
+	if (!stream.open()) {
+		cout << "[ERROR] The PUT stream failed to open." << endl;
+		return 2;
+	}
+	for (const Record<float>& record : putRecords) {
+		const Response resAppend = stream.append(record);
+		if (resAppend.error()) {
+			cout << "[ERROR] PUT stream append failed: " << (int)resAppend.status() << endl;
+			return 2;
+		}
+	}
+	Response resFinish = stream.finish();
+	if (resFinish.error()) {
+		cout << "[ERROR] PUT stream finish failed: " << (int)resFinish.status() << endl;
+		return 3;
+	}
+	if (stream.append(*putRecords.begin()).status() != result_t::NOT_CONNECTED) {
+		cout << "[ERROR] A finished PUT stream accepted a record." << endl;
+		return 3;
+	}
+
+	cout << "Appending records to a PUTA stream..." << endl;
+	stream = channel.putaStream(1h);
+	for (const Record<float>& record : putaRecords) {
+		const Response resAppend = stream.append(record);
+		if (resAppend.error()) {
+			cout << "[ERROR] PUTA stream append failed: " << (int)resAppend.status() << endl;
+			return 4;
+		}
+	}
+	const Response resFlush = stream.flush();
+	if (resFlush.error()) {
+		cout << "[ERROR] PUTA stream flush failed: " << (int)resFlush.status() << endl;
+		return 4;
+	}
+	resFinish = stream.finish();
+	if (resFinish.error()) {
+		cout << "[ERROR] PUTA stream finish failed: " << (int)resFinish.status() << endl;
+		return 5;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(128UL * 1024);
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 6;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+		return 7;
+	}
+	cout << "Both record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_put_cid_grouping()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4UL * 1024);
+	channel.setPutCidGrouping(true);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records with interleaved CIDs..." << endl;
+	RecordsSet<float> putRecords;
+	RecordsSet<float> putaRecords;
+	RecordsSet<float> records;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 1000; ++i) {
+		putRecords.append(Key(getTestCid(1 + i % 7), 24, i, now), static_cast<float>(i));
+		putaRecords.append(Key(getTestCid(8 + i % 5), 24, i, now, i + 1), -static_cast<float>(i));
+	}
+	for (const Record<float>& record : putRecords) {
+		records.append(record);
+	}
+	for (const Record<float>& record : putaRecords) {
+		records.append(record);
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records grouped by CID..." << endl;
+	Response resPut = channel.put(putRecords);
+	if (resPut.error()) {
+		cout << "[ERROR] PUT failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	resPut = channel.puta(putaRecords);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(128UL * 1024);
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+		return 5;
+	}
+	cout << "Both record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_put_batch_coalescing()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(64UL * 1024);
+	channel.setPutBatchCoalescing(true);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records with interleaved CIDs..." << endl;
+	RecordsSet<std::string> putRecords;
+	RecordsSet<std::string> putaRecords;
+	RecordsSet<std::string> records;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 3000; ++i) {
+		// Every 500th payload is large enough to be sent from user memory.
+		const std::size_t payloadSize = i % 500 == 499 ? 20000 : 1 + i % 50;
+		putRecords.append(
+			Key(getTestCid(1 + i % 7), 25, i, now), std::string(payloadSize, 'a' + i % 26));
+		putaRecords.append(
+			Key(getTestCid(8 + i % 5), 25, i, now, i + 1), std::string(1 + i % 30, 'z'));
+	}
+	for (const Record<std::string>& record : putRecords) {
+		records.append(record);
+	}
+	for (const Record<std::string>& record : putaRecords) {
+		records.append(record);
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records with coalesced batches..." << endl;
+	Response resPut = channel.put(putRecords);
+	if (resPut.error()) {
+		cout << "[ERROR] PUT failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	PutStream<std::string> stream = channel.putaStream(1h);
+	for (const Record<std::string>& record : putaRecords) {
+		resPut = stream.append(record);
+		if (resPut.error()) {
+			cout << "[ERROR] PUTA stream append failed: " << (int)resPut.status() << endl;
+			return 3;
+		}
+	}
+	resPut = stream.finish();
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA stream finish failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(1024UL * 1024);
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (compareRecordsSets(records, resGet.records(), compKeysStrings) != 0) {
+		return 5;
+	}
+	cout << "Both record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_put_size_hint()
+{
+	std::unique_ptr<StringSizeHintPayload> payloadType = std::make_unique<StringSizeHintPayload>();
+	const StringSizeHintPayload& hintedPayload = *payloadType;
+	Channel<std::string> channel(globals::addr, globals::port, std::move(payloadType));
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing records of varying sizes..." << endl;
+	const std::array<std::size_t, 6> sizes{0, 3, 40, 700, 2000, 3500};
+	RecordsSet<std::string> records;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 600; ++i) {
+		records.append(Key(getTestCid(i % 2), 7, i, now, i + 1),
+			std::string(sizes[(i * 5) % sizes.size()], 'a' + i % 26));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records with exact size hints..." << endl;
+	const Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	if (hintedPayload.toBytesCalls != records.size()) {
+		cout << "[ERROR] Payloads serialized " << hintedPayload.toBytesCalls << " times, expected "
+			 << records.size() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(1024UL * 1024);
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+
+	cout << "Comparing sent records with the response..." << endl;
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 5;
+	}
+	cout << "Both record sets are equal. Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_get_buffer_growth()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing mostly small records with a few large ones..." << endl;
+	RecordsSet<std::string> records;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 40; ++i) {
+		std::size_t payloadSize = 16;
+		if (i == 39) {
+			payloadSize = 600UL * 1024;
+		} else if (i % 13 == 5) {
+			payloadSize = 100UL * 1024;
+		}
+		records.append(
+			Key(getTestCid(1), 3, i, now, i + 1), std::string(payloadSize, 'a' + i % 26));
+	}
+	Key keyMaxNoHuge = keyMax;
+	keyMaxNoHuge.moid = 39;
+	Key keyMinHuge = keyMin;
+	keyMinHuge.moid = 39;
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	const Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching records larger than the memory limit without growth..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.status() != result_t::MEMORY_LIMIT_EXCEEDED) {
+		cout << "[ERROR] GET returned " << (int)resGet.status()
+			 << " instead of MEMORY_LIMIT_EXCEEDED" << endl;
+		return 3;
+	}
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 4;
+	}
+
+	cout << "Fetching all records with growth up to 1MiB..." << endl;
+	channel.setReceiveBufferGrowth(1024UL * 1024);
+	resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 5;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 6;
+	}
+
+	cout << "Streaming all records with growth up to 1MiB..." << endl;
+	RecordsSet<std::string> streamed;
+	const ResponseAcq resStream =
+		channel.getStream(keyMin, keyMax, [&streamed](RecordsSet<std::string>& batch) {
+			for (const Record<std::string>& record : batch) {
+				streamed.append(record);
+			}
+		});
+	if (resStream.error()) {
+		cout << "[ERROR] GET stream failed: " << (int)resStream.status() << endl;
+		return 7;
+	}
+	if (compareRecordsSets(records, streamed, compKeysStringsWithAcq) != 0) {
+		return 8;
+	}
+
+	cout << "Fetching a record larger than the growth cap of 256KiB..." << endl;
+	channel.setReceiveBufferGrowth(256UL * 1024);
+	resGet = channel.get(keyMinHuge, keyMax);
+	if (resGet.status() != result_t::MEMORY_LIMIT_EXCEEDED) {
+		cout << "[ERROR] GET returned " << (int)resGet.status()
+			 << " instead of MEMORY_LIMIT_EXCEEDED" << endl;
+		return 9;
+	}
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 10;
+	}
+
+	cout << "Fetching the records below the cap after the failure..." << endl;
+	resGet = channel.get(keyMin, keyMaxNoHuge);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 11;
+	}
+	if (resGet.records().size() != records.size() - 1) {
+		cout << "[ERROR] Received " << resGet.records().size() << " records, expected "
+			 << records.size() - 1 << endl;
+		return 12;
+	}
+	cout << "Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 13;
+	}
+	return 0;
+}
+
+int test_channel_get_chunked_payload()
+{
+	std::unique_ptr<StringChunkedPayload> payloadType = std::make_unique<StringChunkedPayload>();
+	const StringChunkedPayload& chunkedPayload = *payloadType;
+	Channel<std::string> channel(globals::addr, globals::port, std::move(payloadType));
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing mostly small records with a few large ones..." << endl;
+	RecordsSet<std::string> records;
+	std::size_t largeRecords = 0;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 40; ++i) {
+		std::size_t payloadSize = 16;
+		if (i == 39) {
+			payloadSize = 600UL * 1024;
+		} else if (i % 13 == 5) {
+			payloadSize = 100UL * 1024;
+		}
+		largeRecords += payloadSize > 4096 ? 1 : 0;
+		std::string payload(payloadSize, 'a' + i % 26);
+		payload.back() = 'z';
+		records.append(Key(getTestCid(1), 3, i, now, i + 1), std::move(payload));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	channel.setMemoryLimit(1024UL * 1024);
+	const Response resPut = channel.puta(records);
+	channel.setMemoryLimit(4096);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching all records through a 4KiB buffer..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 4;
+	}
+	if (chunkedPayload.chunkedPayloads != largeRecords
+		|| chunkedPayload.chunks < 700UL * 1024 / 4096) {
+		cout << "[ERROR] " << chunkedPayload.chunkedPayloads << " payloads received in "
+			 << chunkedPayload.chunks << " chunks, expected " << largeRecords
+			 << " payloads in chunks of at most 4KiB" << endl;
+		return 5;
+	}
+
+	cout << "Streaming all records through a 4KiB buffer..." << endl;
+	RecordsSet<std::string> streamed;
+	const ResponseAcq resStream =
+		channel.getStream(keyMin, keyMax, [&streamed](RecordsSet<std::string>& batch) {
+			for (const Record<std::string>& record : batch) {
+				streamed.append(record);
+			}
+		});
+	if (resStream.error()) {
+		cout << "[ERROR] GET stream failed: " << (int)resStream.status() << endl;
+		return 6;
+	}
+	if (compareRecordsSets(records, streamed, compKeysStringsWithAcq) != 0) {
+		return 7;
+	}
+	if (chunkedPayload.chunkedPayloads != 2 * largeRecords) {
+		cout << "[ERROR] " << chunkedPayload.chunkedPayloads
+			 << " payloads received in chunks, expected " << 2 * largeRecords << endl;
+		return 8;
+	}
+
+	cout << "Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 9;
+	}
+	return 0;
+}
+
+int test_channel_skip_oversized_records()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing mostly small records with a few large ones..." << endl;
+	RecordsSet<std::string> records;
+	RecordsSet<std::string> fitting;
+	std::vector<Key> oversizedKeys;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 40; ++i) {
+		const std::size_t payloadSize = i % 13 == 5 || i == 39 ? 100UL * 1024 : 16;
+		const Key key(getTestCid(1), 3, i, now, i + 1);
+		records.append(key, std::string(payloadSize, 'a' + i % 26));
+		if (payloadSize > 4096) {
+			oversizedKeys.push_back(key);
+		} else {
+			fitting.append(key, std::string(payloadSize, 'a' + i % 26));
+		}
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	channel.setMemoryLimit(1024UL * 1024);
+	const Response resPut = channel.puta(records);
+	channel.setMemoryLimit(4096);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	std::vector<Key> skippedKeys;
+	std::size_t skippedSize = 0;
+	channel.setOversizedRecordHandler(
+		[&skippedKeys, &skippedSize](const Key& key, const std::size_t payloadSize) {
+			skippedKeys.push_back(key);
+			skippedSize += payloadSize;
+		});
+	const auto checkSkipped = [&]() {
+		if (skippedKeys != oversizedKeys
+			|| skippedSize != oversizedKeys.size() * 100UL * 1024) {
+			cout << "[ERROR] " << skippedKeys.size() << " records of " << skippedSize
+				 << " bytes skipped, expected " << oversizedKeys.size() << endl;
+			return false;
+		}
+		skippedKeys.clear();
+		skippedSize = 0;
+		return true;
+	};
+
+	cout << "Fetching the records through a 4KiB buffer..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (compareRecordsSets(fitting, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 4;
+	}
+	if (!checkSkipped()) {
+		return 5;
+	}
+
+	cout << "Streaming the records on the same connection..." << endl;
+	RecordsSet<std::string> streamed;
+	const ResponseAcq resStream =
+		channel.getStream(keyMin, keyMax, [&streamed](RecordsSet<std::string>& batch) {
+			for (const Record<std::string>& record : batch) {
+				streamed.append(record);
+			}
+		});
+	if (resStream.error()) {
+		cout << "[ERROR] GET stream failed: " << (int)resStream.status() << endl;
+		return 6;
+	}
+	if (compareRecordsSets(fitting, streamed, compKeysStringsWithAcq) != 0) {
+		return 7;
+	}
+	if (!checkSkipped()) {
+		return 8;
+	}
+
+	cout << "Streaming the records in blob sets..." << endl;
+	std::size_t streamedBlobs = 0;
+	const ResponseAcq resBlob = channel.getStreamBlob(
+		keyMin, keyMax, [&streamedBlobs](BlobRecordsSet& batch) {
+			streamedBlobs += batch.size();
+		});
+	if (resBlob.error() || streamedBlobs != fitting.size()) {
+		cout << "[ERROR] Blob stream failed: " << (int)resBlob.status() << ", "
+			 << streamedBlobs << " records received" << endl;
+		return 9;
+	}
+	if (!checkSkipped()) {
+		return 10;
+	}
+
+	cout << "Failing the query without the handler..." << endl;
+	channel.setOversizedRecordHandler({});
+	resGet = channel.get(keyMin, keyMax);
+	if (resGet.status() != result_t::MEMORY_LIMIT_EXCEEDED) {
+		cout << "[ERROR] GET returned " << (int)resGet.status()
+			 << " instead of MEMORY_LIMIT_EXCEEDED" << endl;
+		return 11;
+	}
+	return 0;
+}
+
+int test_channel_put_chunked_payload()
+{
+	std::unique_ptr<StringChunkedPayload> payloadType = std::make_unique<StringChunkedPayload>();
+	const StringChunkedPayload& chunkedPayload = *payloadType;
+	Channel<std::string> channel(globals::addr, globals::port, std::move(payloadType));
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing mostly small records with a few large ones..." << endl;
+	RecordsSet<std::string> records;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 40; ++i) {
+		std::size_t payloadSize = 16;
+		if (i == 39) {
+			payloadSize = 600UL * 1024;
+		} else if (i % 13 == 5) {
+			payloadSize = 100UL * 1024;
+		}
+		std::string payload(payloadSize, 'a' + i % 26);
+		payload.back() = 'z';
+		records.append(Key(getTestCid(1), 3, i, now, i + 1), std::move(payload));
+	}
+
+	cout << "Connecting..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending all records through a 4KiB buffer..." << endl;
+	const Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	if (chunkedPayload.sentChunks < 900UL * 1024 / 4096) {
+		cout << "[ERROR] Payloads sent in " << chunkedPayload.sentChunks
+			 << " chunks, expected chunks of at most 4KiB" << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(1024UL * 1024);
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 5;
+	}
+
+	cout << "Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_receive_stats()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing small records with a few large ones..." << endl;
+	RecordsSet<std::string> records;
+	std::uint64_t recordBytes = 0;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 500; ++i) {
+		const std::size_t payloadSize = i % 100 == 50 ? 64UL * 1024 : 24;
+		records.append(
+			Key(getTestCid(1), 3, i, now, i + 1), std::string(payloadSize, 'a' + i % 26));
+		// The record size field, the key and the payload.
+		recordBytes += sizeof(std::int32_t) + 32 + payloadSize;
+	}
+
+	cout << "Connecting with busy polling disabled explicitly..." << endl;
+	channel.setBusyPoll(std::chrono::microseconds(0));
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records..." << endl;
+	const Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching records with the default receive strategy..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 4;
+	}
+	const ReceiveStats defaultStats = channel.receiveStats();
+	cout << "recv calls: " << defaultStats.recvCalls
+		 << ", sockopt calls: " << defaultStats.sockOptCalls
+		 << ", bytes: " << defaultStats.bytesReceived << endl;
+	if (defaultStats.recvCalls == 0 || defaultStats.sockOptCalls != 0) {
+		cout << "[ERROR] Unexpected syscall counts" << endl;
+		return 5;
+	}
+	if (defaultStats.bytesReceived < recordBytes) {
+		cout << "[ERROR] Received fewer bytes than the records take up (" << recordBytes
+			 << ")" << endl;
+		return 6;
+	}
+
+	cout << "Fetching records with the receive low watermark of 256KiB..." << endl;
+	channel.setReceiveLowWatermark(256UL * 1024);
+	resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 7;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 8;
+	}
+	const ReceiveStats lowatStats = channel.receiveStats();
+	cout << "recv calls: " << lowatStats.recvCalls
+		 << ", sockopt calls: " << lowatStats.sockOptCalls
+		 << ", bytes: " << lowatStats.bytesReceived << endl;
+	if (lowatStats.recvCalls == 0 || lowatStats.bytesReceived != defaultStats.bytesReceived) {
+		cout << "[ERROR] Unexpected receive counters" << endl;
+		return 9;
+	}
+
+	cout << "Streaming records with the receive low watermark..." << endl;
+	std::size_t streamed = 0;
+	const ResponseAcq resStream = channel.getStream(keyMin, keyMax,
+		[&streamed](RecordsSet<std::string>& batch) { streamed += batch.size(); });
+	if (resStream.error()) {
+		cout << "[ERROR] GET stream failed: " << (int)resStream.status() << endl;
+		return 10;
+	}
+	if (streamed != records.size()
+		|| channel.receiveStats().bytesReceived != defaultStats.bytesReceived) {
+		cout << "[ERROR] Streamed " << streamed << " records in "
+			 << channel.receiveStats().bytesReceived << " bytes" << endl;
+		return 11;
+	}
+
+	cout << "Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 12;
+	}
+	return 0;
+}
+
+int test_channel_io_uring()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(256UL * 1024);
+	channel.setPutPipelineDepth(2);
+	channel.setIoUring(true);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing small records with a few large ones..." << endl;
+	RecordsSet<std::string> records;
+	const Timestamp::TimeT now = Timestamp::now();
+	for (long int i = 0; i < 2000; ++i) {
+		const std::size_t payloadSize = i % 250 == 100 ? 100UL * 1024 : 40;
+		records.append(
+			Key(getTestCid(1), 3, i, now, i + 1), std::string(payloadSize, 'a' + i % 26));
+	}
+
+	cout << "Connecting with io_uring enabled (if built in)..." << endl;
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records through the PUTA pipeline..." << endl;
+	const Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching records..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.status() != result_t::MEMORY_LIMIT_EXCEEDED) {
+		cout << "[ERROR] GET returned " << (int)resGet.status()
+			 << " instead of MEMORY_LIMIT_EXCEEDED" << endl;
+		return 3;
+	}
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 4;
+	}
+
+	cout << "Streaming records..." << endl;
+	RecordsSet<std::string> streamed;
+	ResponseAcq resStream =
+		channel.getStream(keyMin, keyMax, [&streamed](RecordsSet<std::string>& batch) {
+			for (const Record<std::string>& record : batch) {
+				streamed.append(record);
+			}
+		});
+	if (resStream.error()) {
+		cout << "[ERROR] GET stream failed: " << (int)resStream.status() << endl;
+		return 5;
+	}
+	if (compareRecordsSets(records, streamed, compKeysStringsWithAcq) != 0) {
+		return 6;
+	}
+
+	cout << "Fetching records after replacing the buffer..." << endl;
+	channel.setMemoryLimit(1024UL * 1024);
+	resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 7;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 8;
+	}
+
+	cout << "Fetching records without io_uring..." << endl;
+	channel.setIoUring(false);
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 9;
+	}
+	resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 10;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStringsWithAcq) != 0) {
+		return 11;
+	}
+
+	cout << "Closing connection..." << endl;
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 12;
+	}
+	return 0;
+}
+
+int test_channel_retry()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setRetryPolicy(RetryPolicy{3, 10, 50, false});
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Calling GET, reset on the first attempt..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 2;
+	}
+	if (resGet.acq() != 42 || resGet.records().size() != 1
+		|| resGet.records().begin()->value != "retried") {
+		cout << "[ERROR] Unexpected GET response" << endl;
+		return 3;
+	}
+
+	cout << "Calling GETACQ, reset on the first attempt..." << endl;
+	const ResponseAcq resAcq = channel.getAcq(keyMin, keyMax);
+	if (resAcq.error() || resAcq.acq() != 43) {
+		cout << "[ERROR] GETACQ failed: " << (int)resAcq.status() << endl;
+		return 4;
+	}
+
+	cout << "Calling PUT, reset and not retried..." << endl;
+	RecordsSet<std::string> records;
+	records.append(Key(getTestCid(1), 1, 2, 3), "not retried");
+	res = channel.put(records);
+	if (res.success()) {
+		cout << "[ERROR] PUT succeeded" << endl;
+		return 5;
+	}
+	cout << "PUT failed with " << (int)res.status() << endl;
+
+	cout << "Calling GET on a closed channel..." << endl;
+	(void)channel.close();
+	resGet = channel.get(keyMin, keyMax);
+	if (resGet.status() != result_t::NOT_CONNECTED) {
+		cout << "[ERROR] Unexpected GET result: " << (int)resGet.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_get_stream_resumable()
+{
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+	channel.setRetryPolicy(RetryPolicy{3, 10, 50, false});
+
+	Key keyMin = getTestKeyMin();
+	Key keyMax = getTestKeyMin();
+	keyMin.cap = 0;
+	keyMax.cid = keyMin.cid + 2;
+	keyMax.mid = keyMax.moid = keyMax.cap = keyMax.acq = 1'000'000;
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Streaming two CID sub-intervals, the second one reset..." << endl;
+	std::vector<std::string> payloads;
+	const ResponseAcq resStream =
+		channel.getStreamResumable(keyMin, keyMax, 2, [&payloads](RecordsSet<std::string>& set) {
+			for (const Record<std::string>& record : set) {
+				payloads.push_back(record.value);
+			}
+		});
+	if (resStream.error()) {
+		cout << "[ERROR] GET stream failed: " << (int)resStream.status() << endl;
+		return 2;
+	}
+	if (resStream.acq() != 1000) {
+		cout << "[ERROR] Unexpected ACQ: " << resStream.acq() << endl;
+		return 3;
+	}
+	if (payloads != std::vector<std::string>{"record 0", "record 1"}) {
+		cout << "[ERROR] Unexpected records (" << payloads.size() << ")" << endl;
+		return 4;
+	}
+
+	return 0;
+}
+
+int test_channel_deadline()
+{
+	using Clock = std::chrono::steady_clock;
+
+	Channel<std::string> channel(
+		globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(400ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	const Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Calling GET past its deadline..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax, Clock::now());
+	if (resGet.status() != result_t::CONNTIMEOUT || !channel.connected()) {
+		cout << "[ERROR] Unexpected GET result: " << (int)resGet.status() << endl;
+		return 2;
+	}
+
+	cout << "Calling GET, stalled for longer than the timeout..." << endl;
+	resGet = channel.get(keyMin, keyMax, Clock::now() + 3s);
+	if (resGet.error() || resGet.acq() != 42 || resGet.records().size() != 1
+		|| resGet.records().begin()->value != "stalled") {
+		cout << "[ERROR] Stalled GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+
+	cout << "Calling GET, trickling in for longer than the deadline..." << endl;
+	const Clock::time_point start = Clock::now();
+	resGet = channel.get(keyMin, keyMax, start + 1s);
+	const auto elapsed = Clock::now() - start;
+	if (resGet.status() != result_t::CONNTIMEOUT) {
+		cout << "[ERROR] Unexpected GET result: " << (int)resGet.status() << endl;
+		return 4;
+	}
+	if (elapsed < 1s || elapsed > 2s) {
+		cout << "[ERROR] The GET took "
+			 << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+			 << " ms" << endl;
+		return 5;
+	}
+	return 0;
+}
+
+namespace {
+
+void ignoreSignal(int) {}
+
+} /*namespace*/
+
+int test_channel_signal_restart()
+{
+	// Even with SA_RESTART, a socket with a timeout is not restarted.
+	struct sigaction action{};
+	action.sa_handler = ignoreSignal;
+	action.sa_flags = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	struct sigaction previous{};
+	if (sigaction(SIGUSR1, &action, &previous) != 0) {
+		cout << "[ERROR] Cannot install the signal handler" << endl;
+		return 1;
+	}
+
+	const pthread_t target = pthread_self();
+	std::atomic<bool> done(false);
+	std::thread signaller([target, &done]() {
+		while (!done.load()) {
+			(void)pthread_kill(target, SIGUSR1);
+			std::this_thread::sleep_for(5ms);
+		}
+	});
+	const auto result = [&]() {
+		Channel<std::string> channel(
+			globals::addr, globals::port, std::make_unique<StringViewPayload>());
+		channel.setTimeout(3000ms);
+		channel.setSignalRestart(true);
+
+		const Key keyMin = getTestKeyMin();
+		const Key keyMax = getTestKeyMax();
+
+		const Response res = channel.connect();
+		if (res.error()) {
+			cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+			return 2;
+		}
+
+		cout << "Calling GET, interrupted while waiting, with restarts..." << endl;
+		ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+		if (resGet.error() || resGet.acq() != 42 || resGet.records().size() != 1
+			|| resGet.records().begin()->value != "restarted") {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+			return 3;
+		}
+
+		cout << "Calling GET, interrupted while waiting, without restarts..." << endl;
+		channel.setSignalRestart(false);
+		resGet = channel.get(keyMin, keyMax);
+		if (resGet.status() != result_t::SIGNAL) {
+			cout << "[ERROR] Unexpected GET result: " << (int)resGet.status() << endl;
+			return 4;
+		}
+		return 0;
+	}();
+	done.store(true);
+	signaller.join();
+	(void)sigaction(SIGUSR1, &previous, nullptr);
+	return result;
+}
+
+int test_channel_async_server_error()
+{
+	EventLoop loop;
+	AsyncChannel<std::string> channel(
+		loop, globals::addr, globals::port, std::make_unique<StringViewPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	if (loop.start().error()) {
+		cout << "[ERROR] Failed to start the event loop" << endl;
+		return 1;
+	}
+	const Response res = channel.connect().get();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Pipelining requests the server rejects in part..." << endl;
+	std::future<ResponseGet<std::string>> futureRejected = channel.get(keyMin, keyMax);
+	std::future<ResponseGet<std::string>> futureFailed = channel.get(keyMin, keyMax);
+	std::future<ResponseAcq> futureAcq = channel.getAcq(keyMin, keyMax);
+	const ResponseGet<std::string> resRejected = futureRejected.get();
+	const ResponseGet<std::string> resFailed = futureFailed.get();
+	const ResponseAcq resAcq = futureAcq.get();
+	if (resRejected.status() != result_t::ERROR || resFailed.status() != result_t::ERROR) {
+		cout << "[ERROR] Expected ERROR, got " << (int)resRejected.status() << " and "
+			 << (int)resFailed.status() << endl;
+		return 3;
+	}
+	if (resAcq.error() || resAcq.acq() != 42 || !channel.connected()) {
+		cout << "[ERROR] The GETACQ behind the rejected requests failed: "
+			 << (int)resAcq.status() << endl;
+		return 4;
+	}
+	if (channel.close().error()) {
+		cout << "[ERROR] Close failed" << endl;
+		return 5;
+	}
+	return 0;
+}
+
+int test_channel_put_aggregator()
+{
+	constexpr int cThreads = 4;
+	constexpr int cRecordsPerThread = 2000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Appending records from " << cThreads << " threads..." << endl;
+	std::vector<RecordsSet<float>> records(cThreads);
+	RecordsSet<float> allRecords;
+	for (int t = 0; t < cThreads; ++t) {
+		for (long int i = 0; i < cRecordsPerThread; ++i) {
+			const Key key(getTestCid(t), i % 13, i % 7, Timestamp::now());
+			records[t].append(key, static_cast<float>(t * cRecordsPerThread + i));
+			allRecords.append(key, static_cast<float>(t * cRecordsPerThread + i));
+		}
+	}
+	std::atomic<std::uint64_t> fullQueue(0);
+	{
+		// A small queue, so that the producers also run into it being full.
+		PutAggregator<float> aggregator(channel, 256, 2ms);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < cThreads; ++t) {
+			threads.emplace_back([&aggregator, &records, &fullQueue, t]() {
+				for (const Record<float>& record : records[t]) {
+					while (!aggregator.append(record)) {
+						fullQueue.fetch_add(1, std::memory_order_relaxed);
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		res = aggregator.close();
+		if (res.error()) {
+			cout << "[ERROR] Aggregated PUT failed: " << (int)res.status() << endl;
+			return 2;
+		}
+		cout << "Stored " << aggregator.stored() << " records, retried full queue "
+			 << fullQueue.load() << " times" << endl;
+		if (aggregator.stored() != allRecords.size() || aggregator.dropped() != 0) {
+			cout << "[ERROR] Unexpected amount of records stored" << endl;
+			return 3;
+		}
+		if (aggregator.append(*records[0].begin())) {
+			cout << "[ERROR] A closed aggregator accepted a record" << endl;
+			return 4;
+		}
+	}
+
+	cout << "Fetching the records..." << endl;
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 5;
+	}
+	if (resGet.records().size() != allRecords.size()) {
+		cout << "[ERROR] Sent " << allRecords.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 6;
+	}
+	if (compareRecordsSets(allRecords, resGet.records(), compKeysFloats) != 0) {
+		return 7;
+	}
+	if (channel.putCidGrouping()) {
+		cout << "[ERROR] The aggregator left CID grouping enabled" << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_put_aggregator_close()
+{
+	constexpr int cThreads = 4;
+	constexpr int cRounds = 20;
+	constexpr long int cMaxRecordsPerThread = 5000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// The producers keep appending while the aggregator is being closed;
+	// every record it accepts has to be stored.
+	cout << "Closing the aggregator under " << cThreads << " producers..." << endl;
+	std::uint64_t accepted = 0;
+	for (int round = 0; round < cRounds; ++round) {
+		PutAggregator<float> aggregator(channel, 256, 2ms);
+		std::atomic<bool> closing(false);
+		std::atomic<std::uint64_t> roundAccepted(0);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < cThreads; ++t) {
+			threads.emplace_back([&aggregator, &closing, &roundAccepted, round, t]() {
+				for (long int i = 0; i < cMaxRecordsPerThread; ++i) {
+					const Record<float> record(
+						Key(getTestCid(t), i, round, Timestamp::now()), static_cast<float>(i));
+					while (!aggregator.append(record)) {
+						if (closing.load()) {
+							return;
+						}
+						std::this_thread::yield();
+					}
+					roundAccepted.fetch_add(1);
+				}
+			});
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1 + round % 5));
+		closing.store(true);
+		res = aggregator.close();
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		if (res.error()) {
+			cout << "[ERROR] Aggregated PUT failed: " << (int)res.status() << endl;
+			return 2;
+		}
+		if (aggregator.stored() != roundAccepted.load() || aggregator.dropped() != 0) {
+			cout << "[ERROR] Round " << round << ": accepted " << roundAccepted.load()
+				 << " records, stored " << aggregator.stored() << endl;
+			return 3;
+		}
+		accepted += roundAccepted.load();
+	}
+
+	cout << "Fetching the " << accepted << " records..." << endl;
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != accepted) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records" << endl;
+		return 4;
+	}
+	return 0;
+}
+
+int test_channel_get_arena()
+{
+	constexpr long int cRecords = 3000;
+
+	Channel<std::string> putChannel(
+		globals::addr, globals::port, std::make_unique<StringPayload>());
+	Channel<ArenaString> channel(
+		globals::addr, globals::port, std::make_unique<ArenaStringPayload>());
+	putChannel.setTimeout(3000ms);
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = putChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// The values are longer than any small-string buffer, so that they are
+	// allocated.
+	auto valueOf = [](long int mid) {
+		return "arena-value-" + std::to_string(mid) + std::string(32, '#');
+	};
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), valueOf(i));
+	}
+	res = putChannel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the records into an arena..." << endl;
+	auto resGet = channel.get(keyMin, keyMax, makeArenaAllocator<Record<ArenaString>>());
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	const std::shared_ptr<MonotonicArena> arena = resGet.records().get_allocator().arena();
+	if (resGet.records().size() != records.size() || !arena) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 4;
+	}
+	for (const Record<ArenaString>& record : resGet.records()) {
+		if (record.value.get_allocator().arena() != arena) {
+			cout << "[ERROR] A value was not allocated from the arena" << endl;
+			return 5;
+		}
+		if (record.value.c_str() != valueOf(record.key.mid)) {
+			cout << "[ERROR] Unexpected value of " << record.key << endl;
+			return 6;
+		}
+	}
+
+	// A small buffer, so that the stream is delivered in many batches.
+	channel.setMemoryLimit(16UL * 1024);
+	cout << "Streaming the records through a recycled arena..." << endl;
+	std::set<const MonotonicArena*> arenas;
+	std::size_t streamed = 0;
+	ResponseAcq resStream = channel.getStream(keyMin,
+		keyMax,
+		makeArenaAllocator<Record<ArenaString>>(),
+		[&arenas, &streamed](ArenaRecordsSet<ArenaString>& batch) {
+			arenas.insert(batch.get_allocator().arena().get());
+			streamed += batch.size();
+		});
+	if (resStream.error() || streamed != records.size()) {
+		cout << "[ERROR] Stream failed: " << (int)resStream.status() << ", " << streamed
+			 << " records received" << endl;
+		return 7;
+	}
+	if (arenas.size() != 1) {
+		cout << "[ERROR] The batches used " << arenas.size() << " arenas" << endl;
+		return 8;
+	}
+
+	cout << "Streaming the records keeping a value of each batch..." << endl;
+	std::vector<ArenaString> kept;
+	arenas.clear();
+	resStream = channel.getStream(keyMin,
+		keyMax,
+		makeArenaAllocator<Record<ArenaString>>(),
+		[&arenas, &kept](ArenaRecordsSet<ArenaString>& batch) {
+			arenas.insert(batch.get_allocator().arena().get());
+			if (batch.size() != 0) {
+				kept.push_back(batch.begin()->value);
+			}
+		});
+	if (resStream.error() || kept.size() < 2) {
+		cout << "[ERROR] Stream failed: " << (int)resStream.status() << ", " << kept.size()
+			 << " batches received" << endl;
+		return 9;
+	}
+	if (arenas.size() < kept.size()) {
+		cout << "[ERROR] An arena holding kept values was reused" << endl;
+		return 10;
+	}
+	for (const ArenaString& value : kept) {
+		if (value.compare(0, 12, "arena-value-") != 0) {
+			cout << "[ERROR] A kept value was overwritten" << endl;
+			return 11;
+		}
+	}
+	return 0;
+}
+
+int test_channel_get_blob()
+{
+	constexpr long int cRecords = 3000;
+
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// Payloads of varying sizes, including empty ones.
+	auto valueOf = [](long int mid) { return std::string(mid % 50, 'a' + mid % 26); };
+	RecordsSet<std::string> records;
+	std::size_t totalSize = 0;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), valueOf(i));
+		totalSize += valueOf(i).size();
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the records into a blob set..." << endl;
+	BlobRecordsSet blobs;
+	ResponseAcq resGet = channel.getBlob(keyMin, keyMax, blobs);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (blobs.size() != records.size() || blobs.heap().size() != totalSize) {
+		cout << "[ERROR] Sent " << records.size() << " records of " << totalSize
+			 << " bytes, received " << blobs.size() << " of " << blobs.heap().size() << endl;
+		return 4;
+	}
+	for (std::size_t i = 0; i < blobs.size(); ++i) {
+		const std::string value(
+			reinterpret_cast<const char*>(blobs.payload(i)), blobs.payloadSize(i));
+		if (value != valueOf(blobs.key(i).mid)) {
+			cout << "[ERROR] Unexpected payload of " << blobs.key(i) << endl;
+			return 5;
+		}
+	}
+
+	cout << "Streaming the records in blob sets..." << endl;
+	channel.setMemoryLimit(16UL * 1024);
+	std::size_t streamed = 0;
+	std::size_t streamedSize = 0;
+	resGet = channel.getStreamBlob(
+		keyMin, keyMax, [&streamed, &streamedSize](BlobRecordsSet& batch) {
+			streamed += batch.size();
+			streamedSize += batch.heap().size();
+		});
+	if (resGet.error() || streamed != records.size() || streamedSize != totalSize) {
+		cout << "[ERROR] Stream failed: " << (int)resGet.status() << ", " << streamed
+			 << " records of " << streamedSize << " bytes received" << endl;
+		return 6;
+	}
+	return 0;
+}
+
+namespace {
+
+/** @brief Counts the payloads it deserializes. */
+class CountingStringPayload : public StringPayload
+{
+public:
+	bool fromBytes(std::string& oVar, const void* payloadBuffer, std::size_t payloadSize) override
+	{
+		++decoded;
+		return StringPayload::fromBytes(oVar, payloadBuffer, payloadSize);
+	}
+
+	std::size_t decoded = 0;
+};
+
+} /*namespace*/
+
+int test_channel_get_lazy()
+{
+	constexpr long int cRecords = 2000;
+
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), std::to_string(i));
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the records into a lazy set..." << endl;
+	auto payloadType = std::make_shared<CountingStringPayload>();
+	LazyRecordsSet<std::string> lazy(payloadType);
+	ResponseAcq resGet = channel.getLazy(keyMin, keyMax, lazy);
+	if (resGet.error() || lazy.size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", " << lazy.size()
+			 << " records received" << endl;
+		return 3;
+	}
+	for (std::size_t i = 0; i < lazy.size(); ++i) {
+		if (lazy.key(i).cid != getTestCid(0)) {
+			cout << "[ERROR] Unexpected key " << lazy.key(i) << endl;
+			return 4;
+		}
+	}
+	if (payloadType->decoded != 0) {
+		cout << "[ERROR] Deserialized " << payloadType->decoded << " payloads up front" << endl;
+		return 5;
+	}
+
+	cout << "Accessing the first page twice..." << endl;
+	for (int pass = 0; pass < 2; ++pass) {
+		for (std::size_t i = 0; i < 10; ++i) {
+			const std::string* value = lazy.value(i);
+			if (value == nullptr || *value != std::to_string(lazy.key(i).mid)) {
+				cout << "[ERROR] Unexpected value of " << lazy.key(i) << endl;
+				return 6;
+			}
+		}
+	}
+	if (payloadType->decoded != 10) {
+		cout << "[ERROR] Deserialized " << payloadType->decoded << " payloads instead of 10"
+			 << endl;
+		return 7;
+	}
+
+	cout << "Deserializing with the payload type of the channel..." << endl;
+	LazyRecordsSet<std::string> uncached(nullptr, false);
+	resGet = channel.getLazy(keyMin, keyMax, uncached);
+	const std::string* last = uncached.value(uncached.size() - 1);
+	if (resGet.error() || last == nullptr
+		|| *last != std::to_string(uncached.key(uncached.size() - 1).mid)) {
+		cout << "[ERROR] Uncached access failed: " << (int)resGet.status() << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_get_mixed()
+{
+	constexpr long int cRecords = 1000;
+
+	Channel<float> floats(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	Channel<std::string> strings(globals::addr, globals::port, std::make_unique<StringPayload>());
+	floats.setTimeout(3000ms);
+	strings.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	if (floats.connect().error() || strings.connect().error()) {
+		cout << "[ERROR] Connect failed" << endl;
+		return 1;
+	}
+
+	// Strings of 8 bytes and more, which no float payload deserializes.
+	RecordsSet<float> floatRecords;
+	RecordsSet<std::string> stringRecords;
+	for (long int i = 0; i < cRecords; ++i) {
+		floatRecords.append(Key(getTestCid(0), i, 0, Timestamp::now()), static_cast<float>(i));
+		stringRecords.append(Key(getTestCid(1), i, 0, Timestamp::now()), "string-" + std::to_string(i));
+	}
+	if (floats.put(floatRecords).error() || strings.put(stringRecords).error()) {
+		cout << "[ERROR] PUT failed" << endl;
+		return 2;
+	}
+
+	auto routes = std::make_shared<PayloadRoutes<float, std::string>>(
+		std::make_shared<FloatPayload>(), std::make_shared<StringPayload>());
+	routes->route<0>(getTestCid(0), getTestCid(1));
+	routes->route<1>(getTestCid(1), getTestCid(2));
+
+	cout << "Fetching float and string series with a single GET..." << endl;
+	MixedRecordsSet<float, std::string> mixed(routes);
+	ResponseAcq resGet = floats.getMixed(keyMin, keyMax, mixed);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (mixed.size() != 2 * cRecords || mixed.records<0>().size() != cRecords
+		|| mixed.records<1>().size() != cRecords) {
+		cout << "[ERROR] Received " << mixed.records<0>().size() << " floats and "
+			 << mixed.records<1>().size() << " strings" << endl;
+		return 4;
+	}
+	struct Checker
+	{
+		bool matching;
+		void operator()(const Record<float>& record)
+		{
+			matching = matching && record.value == static_cast<float>(record.key.mid);
+		}
+		void operator()(const Record<std::string>& record)
+		{
+			matching = matching && record.value == "string-" + std::to_string(record.key.mid);
+		}
+	};
+	Checker checker{true};
+	for (std::size_t i = 0; i < mixed.size(); ++i) {
+		mixed.visit(i, checker);
+	}
+	if (!checker.matching) {
+		cout << "[ERROR] Unexpected payloads" << endl;
+		return 5;
+	}
+
+	cout << "Fetching with the string series unrouted..." << endl;
+	auto floatRoutes = std::make_shared<PayloadRoutes<float, std::string>>(
+		std::make_shared<FloatPayload>(), std::make_shared<StringPayload>());
+	floatRoutes->route<0>(getTestCid(0), getTestCid(1));
+	MixedRecordsSet<float, std::string> partial(floatRoutes);
+	resGet = floats.getMixed(keyMin, keyMax, partial);
+	if (resGet.status() != result_t::DESERIALIZATION_ERROR || partial.size() != cRecords
+		|| !floats.connected()) {
+		cout << "[ERROR] Unrouted records returned " << (int)resGet.status() << " with "
+			 << partial.size() << " records" << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_get_stream_arrow()
+{
+	constexpr long int cRecords = 3000;
+
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	auto valueOf = [](long int mid) { return std::string(mid % 50, 'a' + mid % 26); };
+	RecordsSet<std::string> records;
+	std::size_t totalSize = 0;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(0), i, 7, Timestamp::now()), valueOf(i));
+		totalSize += valueOf(i).size();
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Streaming the records in Arrow columns..." << endl;
+	std::size_t streamed = 0;
+	std::size_t streamedSize = 0;
+	std::size_t batches = 0;
+	bool valid = true;
+	ResponseAcq resGet = channel.getStreamArrow(keyMin, keyMax, [&](ArrowRecordsSet& batch) {
+		const std::vector<std::int64_t>& offsets = batch.offsets();
+		valid = valid && offsets.size() == batch.size() + 1 && offsets.front() == 0
+			&& offsets.back() == static_cast<std::int64_t>(batch.data().size());
+		for (std::size_t i = 0; valid && i < batch.size(); ++i) {
+			const std::string value(reinterpret_cast<const char*>(batch.data().data()) + offsets[i],
+				offsets[i + 1] - offsets[i]);
+			valid = batch.cids()[i] == getTestCid(0) && batch.moids()[i] == 7
+				&& value == valueOf(batch.mids()[i]);
+		}
+		streamed += batch.size();
+		streamedSize += batch.data().size();
+		batches += batch.size() == 0 ? 0 : 1;
+		// Moving the columns out, as a conversion to Arrow does, must leave
+		// the set ready for the next batch.
+		std::vector<std::uint8_t> data = std::move(batch.data());
+		(void)data;
+	});
+	if (resGet.error() || streamed != records.size() || streamedSize != totalSize) {
+		cout << "[ERROR] Stream failed: " << (int)resGet.status() << ", " << streamed
+			 << " records of " << streamedSize << " bytes received" << endl;
+		return 3;
+	}
+	if (!valid) {
+		cout << "[ERROR] Unexpected columns" << endl;
+		return 4;
+	}
+	if (batches < 2) {
+		cout << "[ERROR] The response was not split at the memory limit" << endl;
+		return 5;
+	}
+
+	cout << "Streaming into a fixed payload size..." << endl;
+	resGet = channel.getStreamArrow(
+		keyMin, keyMax, [](ArrowRecordsSet& /*batch*/) {}, 8);
+	if (resGet.status() != result_t::DESERIALIZATION_ERROR) {
+		cout << "[ERROR] Payloads of other sizes accepted: " << (int)resGet.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_get_stream_batching()
+{
+	constexpr long int cRecords = 1000;
+	constexpr std::size_t cMaxRecords = 64;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), static_cast<float>(i));
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	std::size_t streamed = 0;
+	std::size_t batches = 0;
+	std::size_t largest = 0;
+	const auto count = [&](RecordsSet<float>& batch) {
+		streamed += batch.size();
+		batches += batch.size() == 0 ? 0 : 1;
+		largest = std::max(largest, batch.size());
+	};
+
+	cout << "Streaming with the default policy..." << endl;
+	ResponseAcq resGet = channel.getStream(keyMin, keyMax, count);
+	if (resGet.error() || streamed != records.size() || batches != 1) {
+		cout << "[ERROR] Stream failed: " << (int)resGet.status() << ", " << streamed
+			 << " records in " << batches << " batches received" << endl;
+		return 3;
+	}
+
+	for (const std::size_t prefetch : {0UL, 2UL}) {
+		cout << "Streaming at most " << cMaxRecords << " records per batch, prefetching "
+			 << prefetch << " batches..." << endl;
+		StreamBatching batching;
+		batching.maxRecords = cMaxRecords;
+		channel.setStreamBatching(batching);
+		channel.setStreamPrefetch(prefetch);
+		streamed = batches = largest = 0;
+		resGet = channel.getStream(keyMin, keyMax, count);
+		if (resGet.error() || streamed != records.size()) {
+			cout << "[ERROR] Stream failed: " << (int)resGet.status() << ", " << streamed
+				 << " records received" << endl;
+			return 4;
+		}
+		if (largest != cMaxRecords || batches != (cRecords + cMaxRecords - 1) / cMaxRecords) {
+			cout << "[ERROR] " << batches << " batches of up to " << largest
+				 << " records received" << endl;
+			return 5;
+		}
+	}
+	channel.setStreamPrefetch(0);
+
+	cout << "Streaming with a delay and a minimal batch size..." << endl;
+	StreamBatching batching;
+	batching.maxDelayMs = 1;
+	batching.minRecords = cRecords;
+	channel.setStreamBatching(batching);
+	streamed = batches = largest = 0;
+	resGet = channel.getStream(keyMin, keyMax, count);
+	if (resGet.error() || streamed != records.size() || batches != 1) {
+		cout << "[ERROR] Stream failed: " << (int)resGet.status() << ", " << streamed
+			 << " records in " << batches << " batches received" << endl;
+		return 6;
+	}
+
+	cout << "Streaming with a delay into Arrow columns..." << endl;
+	batching.minRecords = 0;
+	channel.setStreamBatching(batching);
+	streamed = 0;
+	resGet = channel.getStreamArrow(
+		keyMin, keyMax, [&streamed](ArrowRecordsSet& batch) { streamed += batch.size(); });
+	if (resGet.error() || streamed != records.size()) {
+		cout << "[ERROR] Stream failed: " << (int)resGet.status() << ", " << streamed
+			 << " records received" << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_split_buffers()
+{
+	constexpr long int cRecords = 2000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	// A single PUT buffer takes all records, while the results fit in the
+	// minimal receive buffer.
+	channel.setSendMemoryLimit(1024UL * 1024);
+	channel.setReceiveMemoryLimit(128);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), static_cast<float>(i));
+	}
+	cout << "Putting the records with a large send buffer..." << endl;
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	if (channel.stats().putBufferFlushes != 0) {
+		cout << "[ERROR] The PUT was flushed mid-request" << endl;
+		return 3;
+	}
+	const ResponseAcq resAcq = channel.getAcq(keyMin, keyMax);
+	if (resAcq.error()) {
+		cout << "[ERROR] GETACQ failed: " << (int)resAcq.status() << endl;
+		return 4;
+	}
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.status() != result_t::MEMORY_LIMIT_EXCEEDED) {
+		cout << "[ERROR] The response fit in the receive buffer: " << (int)resGet.status()
+			 << endl;
+		return 5;
+	}
+
+	cout << "Getting the records with a large receive buffer..." << endl;
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	channel.setSendMemoryLimit(128);
+	channel.setReceiveMemoryLimit(1024UL * 1024);
+	resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records received" << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_buffer_release()
+{
+	constexpr long int cRecords = 2000;
+
+	// The channels share the buffers of one size class through the pool.
+	Channel<float> eager(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	Channel<float> idle(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	for (Channel<float>* channel : {&eager, &idle}) {
+		channel->setTimeout(3000ms);
+		channel->setMemoryLimit(1024UL * 1024);
+	}
+	eager.setBufferRelease(0ms);
+	idle.setBufferRelease(50ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = eager.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = idle.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), static_cast<float>(i));
+	}
+	cout << "Putting and getting with buffers released after each command..." << endl;
+	res = eager.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	for (int i = 0; i < 2; ++i) {
+		const ResponseGet<float> resGet = eager.get(keyMin, keyMax);
+		if (resGet.error() || resGet.records().size() != records.size()) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+				 << resGet.records().size() << " records received" << endl;
+			return 3;
+		}
+	}
+
+	cout << "Getting with buffers released once idle..." << endl;
+	for (int i = 0; i < 3; ++i) {
+		const ResponseGet<float> resGet = idle.get(keyMin, keyMax);
+		if (resGet.error() || resGet.records().size() != records.size()) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+				 << resGet.records().size() << " records received" << endl;
+			return 4;
+		}
+		const ResponseAcq resAcq = eager.getAcq(keyMin, keyMax);
+		if (resAcq.error()) {
+			cout << "[ERROR] GETACQ failed: " << (int)resAcq.status() << endl;
+			return 5;
+		}
+		// The second round finds the buffers parked, the third one pooled.
+		std::this_thread::sleep_for(i == 0 ? 10ms : 200ms);
+	}
+
+	cout << "Closing with parked buffers..." << endl;
+	res = idle.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	Channel<float>::setBufferPoolLimit(0);
+	const ResponseGet<float> resGet = eager.get(keyMin, keyMax);
+	Channel<float>::setBufferPoolLimit(256UL * 1024 * 1024);
+	if (resGet.error() || resGet.records().size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records received" << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_memory_budget()
+{
+	constexpr std::size_t cLimit = 512UL * 1024;
+
+	// The budget fits the send and the receive buffer of a single channel.
+	const auto budget = std::make_shared<MemoryBudget>(2 * cLimit);
+	Channel<float> first(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	Channel<float> second(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	for (Channel<float>* channel : {&first, &second}) {
+		channel->setTimeout(300ms);
+		channel->setMemoryLimit(cLimit);
+		channel->setMemoryBudget(budget);
+	}
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = first.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), static_cast<float>(i));
+	}
+	res = first.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	ResponseGet<float> resGet = first.get(keyMin, keyMax);
+	if (resGet.error() || budget->used() != 2 * cLimit) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", " << budget->used()
+			 << " bytes drawn" << endl;
+		return 3;
+	}
+
+	cout << "Getting with the budget spent..." << endl;
+	res = second.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 4;
+	}
+	resGet = second.get(keyMin, keyMax);
+	if (resGet.status() != result_t::OUT_OF_MEMORY) {
+		cout << "[ERROR] GET did not run out of memory: " << (int)resGet.status() << endl;
+		return 5;
+	}
+
+	cout << "Getting while the budget is given back..." << endl;
+	res = second.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	second.setTimeout(3000ms);
+	std::thread releaser([&first]() {
+		std::this_thread::sleep_for(100ms);
+		first.setBufferRelease(0ms);
+		(void)first.getAcq(getTestKeyMin(), getTestKeyMax());
+	});
+	resGet = second.get(keyMin, keyMax);
+	releaser.join();
+	if (resGet.error() || resGet.records().size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records received" << endl;
+		return 7;
+	}
+
+	res = second.close();
+	if (res.error() || budget->used() != 0) {
+		cout << "[ERROR] The quota was not given back: " << budget->used() << " bytes drawn"
+			 << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_buffer_auto_tuning()
+{
+	constexpr std::size_t cRecords = 10000;
+	constexpr std::size_t cFloor = 4096;
+	constexpr std::size_t cMax = 1024UL * 1024;
+
+	// The budget only shows the sizes of the buffers.
+	const auto budget = std::make_shared<MemoryBudget>(64UL * 1024 * 1024);
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(cFloor);
+	channel.setMemoryBudget(budget);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	RecordsSet<float> records;
+	for (std::size_t i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 3), 2, 3, Timestamp::now(), 1000 * i),
+			static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = channel.puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Tuning the buffers to the measured path..." << endl;
+	BufferAutoTuning tuning;
+	tuning.enabled = true;
+	tuning.maxBytes = cMax;
+	channel.setBufferAutoTuning(tuning);
+	for (int i = 0; i < 3; ++i) {
+		std::size_t received = 0;
+		ResponseAcq resGet = channel.getView(keyMin,
+			keyMax,
+			[&received](const Key& /*key*/, const void* /*payload*/, std::size_t /*size*/) {
+				++received;
+			});
+		if (resGet.error() || received != cRecords) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << ", " << received
+				 << " records received" << endl;
+			return 3;
+		}
+	}
+	const std::uint64_t bdpBytes = channel.stats().bdpBytes;
+	const std::size_t used = budget->used();
+	cout << "  Estimated " << bdpBytes << " bytes in flight, " << used << " bytes of buffers"
+		 << endl;
+	if (bdpBytes == 0 || used < 2 * cFloor || used > 2 * cMax) {
+		cout << "[ERROR] The buffers were not tuned within the bounds" << endl;
+		return 4;
+	}
+
+	cout << "Disabling the tuning..." << endl;
+	channel.setBufferAutoTuning(BufferAutoTuning{});
+	ResponseAcq resAcq = channel.getAcq(keyMin, keyMax);
+	if (resAcq.error() || budget->used() != 2 * cFloor || channel.stats().bdpBytes != 0) {
+		cout << "[ERROR] The buffers were not sized back: " << budget->used() << " bytes"
+			 << endl;
+		return 5;
+	}
+
+	cout << "Keeping the memory limit as the smallest size..." << endl;
+	channel.setMemoryLimit(cMax);
+	tuning.maxBytes = 256;
+	channel.setBufferAutoTuning(tuning);
+	for (int i = 0; i < 2; ++i) {
+		ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+		if (resGet.error()
+			|| compareRecordsSets(records, resGet.records(), compKeysFloatsWithAcq) != 0) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+			return 6;
+		}
+	}
+	if (budget->used() != 2 * cMax) {
+		cout << "[ERROR] The buffers shrank below the memory limit: " << budget->used()
+			 << " bytes" << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_put_flow_control()
+{
+	constexpr std::size_t cRecords = 10000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+	// Thresholds this low take any result as late, so that the channel
+	// backs off and splits the commands that follow.
+	PutFlowControl flow;
+	flow.enabled = true;
+	flow.sendBlockMs = 1;
+	flow.ackLatencyMs = 1;
+	channel.setPutFlowControl(flow);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	RecordsSet<float> records;
+	RecordsSet<float> first;
+	RecordsSet<float> second;
+	for (std::size_t i = 0; i < cRecords; ++i) {
+		const Key key(getTestCid(i % 3), 2, 3, Timestamp::now(), 1000 * i);
+		records.append(key, static_cast<float>(i));
+		(i < cRecords / 2 ? first : second).append(key, static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = channel.puta(first);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	ChannelStats stats = channel.stats();
+	cout << "  " << stats.putBackoffs << " back-offs, " << stats.putCommandBuffers
+		 << " buffers per command, " << stats.putPacingRate << " B/s" << endl;
+	if (stats.putBackoffs == 0) {
+		cout << "[ERROR] The channel did not back off" << endl;
+		return 3;
+	}
+
+	// Either PUTA ends its command early once the channel has backed off.
+	cout << "Splitting the commands of a PUTA..." << endl;
+	res = channel.puta(second);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 4;
+	}
+	stats = channel.stats();
+	if (stats.putA.count < 3) {
+		cout << "[ERROR] The PUTA was not split: " << stats.putA.count << " commands" << endl;
+		return 5;
+	}
+	channel.setMemoryLimit(1024UL * 1024);
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != cRecords
+		|| compareRecordsSets(records, resGet.records(), compKeysFloatsWithAcq) != 0) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 6;
+	}
+
+	cout << "Disabling the flow control..." << endl;
+	channel.setPutFlowControl(PutFlowControl{});
+	stats = channel.stats();
+	if (stats.putPacingRate != 0 || stats.putCommandBuffers != 0 || stats.putBackoffs == 0) {
+		cout << "[ERROR] The flow control was not reset" << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_put_dedup_filter()
+{
+	constexpr std::size_t cRecords = 2000;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+	const auto filter = std::make_shared<PutDedupFilter>();
+	channel.setPutDedupFilter(filter);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	RecordsSet<float> records;
+	RecordsSet<float> acknowledged;
+	for (std::size_t i = 0; i < cRecords; ++i) {
+		const Key key(getTestCid(i % 3), 2, 3, Timestamp::now(), 1000 * i);
+		records.append(key, static_cast<float>(i));
+		if (i < cRecords / 2) {
+			acknowledged.append(key, static_cast<float>(i));
+		}
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = channel.puta(acknowledged);
+	if (res.error() || filter->size() != cRecords / 2) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << ", " << filter->size()
+			 << " records acknowledged" << endl;
+		return 2;
+	}
+
+	cout << "Replaying the whole range..." << endl;
+	res = channel.puta(records);
+	if (res.error() || channel.stats().putRecordsSkipped != cRecords / 2
+		|| filter->size() != cRecords) {
+		cout << "[ERROR] The replay was not filtered: " << channel.stats().putRecordsSkipped
+			 << " records skipped" << endl;
+		return 3;
+	}
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != cRecords
+		|| compareRecordsSets(records, resGet.records(), compKeysFloatsWithAcq) != 0) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records" << endl;
+		return 4;
+	}
+
+	cout << "Saving and loading the filter..." << endl;
+	char directory[] = "/tmp/tstorage-dedup-XXXXXX";
+	if (::mkdtemp(directory) == nullptr) {
+		cout << "[ERROR] Cannot create the directory" << endl;
+		return 5;
+	}
+	const std::string path = std::string(directory) + "/filter";
+	const auto loaded = std::make_shared<PutDedupFilter>();
+	const bool persisted = filter->save(path) == result_t::OK
+						   && loaded->load(path) == result_t::OK && loaded->size() == cRecords;
+	(void)::unlink(path.c_str());
+	(void)::rmdir(directory);
+	if (!persisted) {
+		cout << "[ERROR] The filter was not persisted: " << loaded->size() << endl;
+		return 6;
+	}
+	channel.setPutDedupFilter(loaded);
+	res = channel.puta(records);
+	if (res.error() || channel.stats().putRecordsSkipped != cRecords / 2 + cRecords) {
+		cout << "[ERROR] The loaded filter did not skip the records" << endl;
+		return 7;
+	}
+
+	// Versions of a record differ in the ACQ only; a command never filters
+	// its own records, so each goes in one of its own.
+	cout << "Sending versions of a record..." << endl;
+	Key version(getTestCid(0), 4, 5, Timestamp::now(), 0);
+	for (Key::AcqT acq = 1; acq <= 2; ++acq) {
+		version.acq = acq;
+		RecordsSet<float> single;
+		single.append(version, 1.0f);
+		res = channel.puta(single);
+		if (res.error() || channel.stats().putRecordsSkipped != cRecords / 2 + cRecords
+			|| loaded->size() != cRecords + acq) {
+			cout << "[ERROR] The version with ACQ " << acq << " was skipped: "
+				 << channel.stats().putRecordsSkipped << " records skipped" << endl;
+			return 8;
+		}
+	}
+
+	cout << "Forgetting the oldest fingerprints..." << endl;
+	PutDedupFilter bounded(2);
+	bounded.insert({1, 2, 3});
+	if (bounded.size() != 2 || bounded.contains(1) || !bounded.contains(3)) {
+		cout << "[ERROR] The filter exceeded its capacity" << endl;
+		return 9;
+	}
+	return 0;
+}
+
+int test_channel_put_dedup_vectored()
+{
+	constexpr std::size_t cRecords = 5000;
+	constexpr std::size_t cWarmUpRecords = 5000;
+	constexpr std::size_t cMaxGap = 120;
+
+	Channel<InternedBytes> channel(
+		globals::addr, globals::port, std::make_unique<InternedPayloadType>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4096);
+	// As in test_channel_put_flow_control, the commands get split once the
+	// channel has backed off.
+	PutFlowControl flow;
+	flow.enabled = true;
+	flow.sendBlockMs = 1;
+	flow.ackLatencyMs = 1;
+	channel.setPutFlowControl(flow);
+	const auto filter = std::make_shared<PutDedupFilter>();
+	channel.setPutDedupFilter(filter);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	const InternedBytes small = std::make_shared<const std::string>(40, 's');
+	// The large payloads are sent from their values, not copied. The amount of
+	// small records between them varies, so that the buffer fills up right
+	// before some of them and ends the command.
+	const InternedBytes large = std::make_shared<const std::string>(32UL * 1024, 'l');
+	std::vector<Key> keys;
+	std::vector<bool> isLarge;
+	std::size_t gap = 1;
+	std::size_t sinceLarge = 0;
+	for (std::size_t i = 0; i < cRecords; ++i) {
+		keys.emplace_back(getTestCid(i % 3), 2, 3, Timestamp::now(), 1000 * i);
+		isLarge.push_back(++sinceLarge > gap);
+		if (isLarge.back()) {
+			sinceLarge = 0;
+			gap = gap % cMaxGap + 1;
+		}
+	}
+
+	// A record is acknowledged with the command it goes in, never before it
+	// has been sent, so the filter cannot hold the record written last.
+	std::size_t next = 0;
+	std::size_t early = 0;
+	const auto generator = [&](Record<InternedBytes>& oRecord) {
+		if (next > 0) {
+			const std::string& last = isLarge[next - 1] ? *large : *small;
+			if (filter->contains(
+					PutDedupFilter::fingerprint(keys[next - 1], last.data(), last.size()))) {
+				++early;
+			}
+		}
+		if (next == cRecords) {
+			return false;
+		}
+		oRecord.key = keys[next];
+		oRecord.value = isLarge[next] ? large : small;
+		++next;
+		return true;
+	};
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	// The channel backs off once the first command is acknowledged.
+	RecordsSet<InternedBytes> warmUp;
+	for (std::size_t i = 0; i < cWarmUpRecords; ++i) {
+		warmUp.append(Key(getTestCid(3), 4, 5, Timestamp::now(), 1000 * i), small);
+	}
+	res = channel.puta(warmUp);
+	if (res.error() || channel.stats().putBackoffs == 0) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << ", "
+			 << channel.stats().putBackoffs << " back-offs" << endl;
+		return 2;
+	}
+	res = channel.putaFrom(generator);
+	if (res.error() || filter->size() != cWarmUpRecords + cRecords) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << ", " << filter->size()
+			 << " records acknowledged" << endl;
+		return 3;
+	}
+	if (early != 0) {
+		cout << "[ERROR] " << early << " records acknowledged before being sent" << endl;
+		return 4;
+	}
+	channel.setMemoryLimit(4UL * 1024 * 1024);
+	ResponseGet<InternedBytes> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != cWarmUpRecords + cRecords) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records" << endl;
+		return 5;
+	}
+
+	cout << "Replaying the records..." << endl;
+	channel.setMemoryLimit(4096);
+	next = 0;
+	res = channel.putaFrom(generator);
+	if (res.error() || channel.stats().putRecordsSkipped != cRecords) {
+		cout << "[ERROR] The replay was not filtered: " << channel.stats().putRecordsSkipped
+			 << " records skipped" << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_caching_get()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<float> oldRecords;
+	for (long int i = 0; i < 1000; ++i) {
+		oldRecords.append(Key(getTestCid(0), i, 0, Timestamp::now()), static_cast<float>(i));
+	}
+	res = channel.put(oldRecords);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	CachingChannel<float> cache(channel, 1024UL * 1024);
+	cout << "Fetching the records into the cache..." << endl;
+	ResponseGet<float> resGet = cache.get(keyMin, keyMax);
+	if (resGet.error() || cache.misses() != 1 || cache.cachedBytes() == 0) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (compareRecordsSets(oldRecords, resGet.records(), compKeysFloats) != 0) {
+		return 4;
+	}
+	Key historicalMax = keyMax;
+	historicalMax.acq = resGet.acq();
+
+	RecordsSet<float> newRecords;
+	RecordsSet<float> allRecords = oldRecords;
+	for (long int i = 1000; i < 1500; ++i) {
+		newRecords.append(Key(getTestCid(0), i, 0, Timestamp::now()), static_cast<float>(i));
+		allRecords.append(*std::prev(newRecords.end()));
+	}
+	res = channel.put(newRecords);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 5;
+	}
+
+	cout << "Fetching the new records on top of the cached ones..." << endl;
+	resGet = cache.get(keyMin, keyMax);
+	if (resGet.error() || cache.hits() != 1) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 6;
+	}
+	if (resGet.records().size() != allRecords.size()
+		|| compareRecordsSets(allRecords, resGet.records(), compKeysFloats) != 0) {
+		cout << "[ERROR] Expected " << allRecords.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 7;
+	}
+
+	cout << "Fetching a historical window from the cache..." << endl;
+	resGet = cache.get(keyMin, historicalMax);
+	if (resGet.error() || cache.hits() != 2) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 8;
+	}
+	if (resGet.records().size() != oldRecords.size()
+		|| compareRecordsSets(oldRecords, resGet.records(), compKeysFloats) != 0) {
+		cout << "[ERROR] Expected " << oldRecords.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 9;
+	}
+
+	cout << "Fetching with a cache too small to hold the response..." << endl;
+	CachingChannel<float> smallCache(channel, 1024);
+	for (int i = 0; i < 2; ++i) {
+		resGet = smallCache.get(keyMin, keyMax);
+		if (resGet.error() || resGet.records().size() != allRecords.size()) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+			return 10;
+		}
+	}
+	if (smallCache.misses() != 2 || smallCache.cachedBytes() != 0) {
+		cout << "[ERROR] The response was cached beyond the memory bound" << endl;
+		return 11;
+	}
+	return 0;
+}
+
+int test_channel_negative_cache()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	const Key::CapT capMin = Timestamp::now();
+	const auto seriesMin = [capMin](const Key::MidT mid) {
+		return Key(getTestCid(0), mid, Key::cMoidMin, capMin, Key::cAcqMin);
+	};
+	const auto seriesMax = [](const Key::MidT mid) {
+		return Key(getTestCid(0) + 1, mid + 1, Key::cMoidMax, Key::cCapMax, Key::cAcqMax);
+	};
+
+	CachingChannel<float> cache(channel, 1024UL * 1024);
+	const std::shared_ptr<NegativeCache> negativeCache = std::make_shared<NegativeCache>();
+	cache.setNegativeCache(negativeCache);
+
+	cout << "Fetching an empty series..." << endl;
+	ResponseGet<float> resGet = cache.get(seriesMin(100), seriesMax(100));
+	if (resGet.error() || resGet.records().size() != 0 || cache.misses() != 1
+		|| negativeCache->size() != 1 || cache.cachedBytes() != 0) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 2;
+	}
+	Key historicalMax = seriesMax(100);
+	historicalMax.acq = resGet.acq();
+
+	cout << "Answering historical windows inside it locally..." << endl;
+	const std::uint64_t bytesSent = channel.stats().bytesSent;
+	Key narrowMin = seriesMin(100);
+	narrowMin.cap = capMin + 1000;
+	resGet = cache.get(narrowMin, historicalMax);
+	if (resGet.error() || resGet.records().size() != 0 || cache.emptyHits() != 1) {
+		cout << "[ERROR] The window inside the empty series was not answered locally" << endl;
+		return 3;
+	}
+	if (channel.stats().bytesSent != bytesSent) {
+		cout << "[ERROR] A request was sent for a key-interval known to be empty" << endl;
+		return 4;
+	}
+
+	cout << "Fetching records stored in the series later..." << endl;
+	RecordsSet<float> records;
+	records.append(Key(getTestCid(0), 100, 0, Timestamp::now()), 1.5F);
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 5;
+	}
+	resGet = cache.get(seriesMin(100), seriesMax(100));
+	if (resGet.error() || cache.hits() != 1) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 6;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+		return 7;
+	}
+
+	cout << "Answering a series inside a wider empty key-interval locally..." << endl;
+	Key wideMax = seriesMax(300);
+	resGet = cache.get(seriesMin(200), wideMax);
+	if (resGet.error() || resGet.records().size() != 0 || negativeCache->size() != 2) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 8;
+	}
+	historicalMax = seriesMax(250);
+	historicalMax.acq = resGet.acq();
+	resGet = cache.get(seriesMin(250), historicalMax);
+	if (resGet.error() || resGet.records().size() != 0 || cache.emptyHits() != 2) {
+		cout << "[ERROR] The series inside the wide key-interval was not answered locally"
+			 << endl;
+		return 9;
+	}
+
+	cout << "Forgetting the least recently used key-intervals..." << endl;
+	NegativeCache bounded(2);
+	for (Key::MidT mid = 0; mid < 3; ++mid) {
+		bounded.insert(seriesMin(mid), seriesMax(mid), 1000);
+	}
+	Key::AcqT emptyUntil = 0;
+	Key::AcqT acq = 0;
+	if (bounded.size() != 2 || bounded.lookup(seriesMin(0), seriesMax(0), emptyUntil, acq)
+		|| !bounded.lookup(seriesMin(2), seriesMax(2), emptyUntil, acq) || emptyUntil != 1000) {
+		cout << "[ERROR] The negative cache exceeded its capacity" << endl;
+		return 10;
+	}
+	return 0;
+}
+
+int test_channel_snapshot()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024UL * 1024);
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	std::vector<KeyRange> ranges;
+	for (std::int32_t tid = 0; tid < 2; ++tid) {
+		KeyRange range{getTestKeyMin(), getTestKeyMax()};
+		range.keyMin.cid = getTestCid(tid);
+		range.keyMax.cid = getTestCid(tid) + 1;
+		ranges.push_back(range);
+	}
+	const auto putRecords = [&](const long int first, const long int last) {
+		RecordsSet<float> records;
+		for (std::int32_t tid = 0; tid < 2; ++tid) {
+			for (long int i = first; i < last; ++i) {
+				records.append(Key(getTestCid(tid), i, 0, Timestamp::now()), static_cast<float>(i));
+			}
+		}
+		return channel.put(records);
+	};
+
+	res = putRecords(0, 100);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	Snapshot<float> snapshot(channel, 1024UL * 1024);
+	if (snapshot.get(ranges[0].keyMin, ranges[0].keyMax).status() != result_t::NOT_CONNECTED) {
+		cout << "[ERROR] An unpinned snapshot served a query" << endl;
+		return 3;
+	}
+	cout << "Pinning the snapshot to both ranges..." << endl;
+	const ResponseAcq resPin = snapshot.pin(ranges);
+	if (resPin.error() || !snapshot.pinned() || snapshot.acq() != resPin.acq()) {
+		cout << "[ERROR] Pinning failed: " << (int)resPin.status() << endl;
+		return 4;
+	}
+
+	res = putRecords(100, 150);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 5;
+	}
+
+	cout << "Reading both ranges as of the snapshot..." << endl;
+	ResponseGet<float> resGet = snapshot.get(ranges[0].keyMin, ranges[0].keyMax);
+	if (resGet.error() || resGet.acq() != snapshot.acq() || snapshot.misses() != 1) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 6;
+	}
+	if (resGet.records().size() != 100) {
+		cout << "[ERROR] Expected 100 records, received " << resGet.records().size() << endl;
+		return 7;
+	}
+	for (const Record<float>& record : resGet.records()) {
+		if (record.key.acq >= snapshot.acq()) {
+			cout << "[ERROR] A record stored after the snapshot was returned" << endl;
+			return 8;
+		}
+	}
+	const std::vector<ResponseGet<float>> responses = snapshot.getBatch(ranges);
+	if (responses.size() != 2 || snapshot.hits() != 1 || snapshot.misses() != 2) {
+		cout << "[ERROR] The first range was not served from the cache" << endl;
+		return 9;
+	}
+	for (const ResponseGet<float>& response : responses) {
+		if (response.error() || response.records().size() != 100
+			|| response.acq() != snapshot.acq()) {
+			cout << "[ERROR] Batched GET failed: " << (int)response.status() << ", "
+				 << response.records().size() << " records" << endl;
+			return 10;
+		}
+	}
+
+	Key futureMin = ranges[1].keyMin;
+	futureMin.acq = snapshot.acq();
+	resGet = snapshot.get(futureMin, ranges[1].keyMax);
+	if (resGet.error() || resGet.records().size() != 0) {
+		cout << "[ERROR] Records after the snapshot were returned" << endl;
+		return 11;
+	}
+
+	cout << "Re-pinning the snapshot..." << endl;
+	const Key::AcqT oldAcq = snapshot.acq();
+	if (snapshot.pin(ranges).error() || snapshot.acq() <= oldAcq || snapshot.cachedBytes() != 0) {
+		cout << "[ERROR] Re-pinning failed" << endl;
+		return 12;
+	}
+	resGet = snapshot.get(ranges[1].keyMin, ranges[1].keyMax);
+	if (resGet.error() || resGet.records().size() != 150) {
+		cout << "[ERROR] Expected 150 records, received " << resGet.records().size() << endl;
+		return 13;
+	}
+	return 0;
+}
+
+int test_channel_tail()
+{
+	constexpr int cRounds = 3;
+	constexpr long int cRecordsPerRound = 50;
+	constexpr std::size_t cRecords = cRounds * cRecordsPerRound;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	Channel<float> putChannel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	putChannel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = putChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Following while records are stored in rounds..." << endl;
+	std::future<result_t> producer = std::async(std::launch::async, [&putChannel]() {
+		for (int round = 0; round < cRounds; ++round) {
+			std::this_thread::sleep_for(100ms);
+			RecordsSet<float> records;
+			for (long int i = 0; i < cRecordsPerRound; ++i) {
+				const long int mid = round * cRecordsPerRound + i;
+				records.append(
+					Key(getTestCid(0), mid, 0, Timestamp::now()), static_cast<float>(mid));
+			}
+			const Response res = putChannel.put(records);
+			if (res.error()) {
+				return res.status();
+			}
+		}
+		return result_t::OK;
+	});
+
+	std::multiset<Key::MidT> mids;
+	Key::AcqT lastRecordAcq = Key::cAcqMin;
+	std::size_t polls = 0;
+	const auto deadline = std::chrono::steady_clock::now() + 10s;
+	const ResponseAcq resTail = channel.tail(keyMin,
+		keyMax,
+		[&](RecordsSet<float>& batch) {
+			++polls;
+			for (const Record<float>& record : batch) {
+				mids.insert(record.key.mid);
+				lastRecordAcq = std::max(lastRecordAcq, record.key.acq);
+			}
+			return mids.size() < cRecords && std::chrono::steady_clock::now() < deadline;
+		},
+		20ms);
+	const result_t resProducer = producer.get();
+	if (resProducer != result_t::OK) {
+		cout << "[ERROR] PUT failed: " << (int)resProducer << endl;
+		return 2;
+	}
+	if (resTail.error()) {
+		cout << "[ERROR] Tail failed: " << (int)resTail.status() << endl;
+		return 3;
+	}
+	cout << "Received " << mids.size() << " records in " << polls << " callbacks" << endl;
+	if (mids.size() != cRecords) {
+		cout << "[ERROR] Expected " << cRecords << " records" << endl;
+		return 4;
+	}
+	for (long int mid = 0; mid < static_cast<long int>(cRecords); ++mid) {
+		if (mids.count(mid) != 1) {
+			cout << "[ERROR] Record " << mid << " received " << mids.count(mid) << " times"
+				 << endl;
+			return 5;
+		}
+	}
+	if (polls < cRounds || resTail.acq() <= lastRecordAcq) {
+		cout << "[ERROR] Unexpected polls or resume ACQ" << endl;
+		return 6;
+	}
+	return 0;
+}
+
+/** @brief A codec counting the blocks passed to `decompress()`. */
+class CountingCodec final : public PayloadCodec
+{
+public:
+	std::size_t compress(const void* input,
+		std::size_t inputSize,
+		void* output,
+		std::size_t outputCapacity) override
+	{
+		return mCodec.compress(input, inputSize, output, outputCapacity);
+	}
+
+	bool decompress(const void* input,
+		std::size_t inputSize,
+		void* output,
+		std::size_t outputSize) override
+	{
+		++decompressed;
+		return mCodec.decompress(input, inputSize, output, outputSize);
+	}
+
+	std::size_t maxDecompressedSize(std::size_t inputSize) const override
+	{
+		return mCodec.maxDecompressedSize(inputSize);
+	}
+
+	std::size_t decompressed = 0;
+
+private:
+	LzPayloadCodec mCodec;
+};
+
+int test_channel_compressed_payload()
+{
+	const std::string sample = "{\"sensor\":\"temperature\",\"unit\":\"celsius\",\"value\":";
+	auto makePayloadType = [&sample]() {
+		return std::make_unique<CompressedPayloadType<std::string>>(
+			std::make_unique<StringPayload>(),
+			std::make_unique<LzPayloadCodec>(
+				std::vector<unsigned char>(sample.begin(), sample.end())));
+	};
+	Channel<std::string> channel(globals::addr, globals::port, makePayloadType());
+	Channel<std::string> rawChannel(
+		globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	rawChannel.setTimeout(3000ms);
+	channel.setMemoryLimit(4UL * 1024 * 1024);
+	rawChannel.setMemoryLimit(4UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = rawChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// Compressible, incompressible, empty and long payloads.
+	std::minstd_rand rng(29);
+	RecordsSet<std::string> records;
+	std::size_t rawSize = 0;
+	for (long int i = 0; i < 1000; ++i) {
+		std::string value;
+		switch (i % 4) {
+		case 0:
+			value = sample + std::to_string(i % 37) + "}";
+			break;
+		case 1:
+			for (long int j = 0; j < i % 64; ++j) {
+				value.push_back(static_cast<char>(rng()));
+			}
+			break;
+		case 2:
+			break;
+		default:
+			for (long int j = 0; j < 1000 + i; ++j) {
+				value += sample[j % 7];
+			}
+			break;
+		}
+		rawSize += value.size();
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), std::move(value));
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the compressed records..." << endl;
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (resGet.records().size() != records.size()
+		|| compareRecordsSets(records, resGet.records(), compKeysStrings) != 0) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 4;
+	}
+
+	cout << "Measuring the stored frames..." << endl;
+	BlobRecordsSet frames;
+	ResponseAcq resBlob = rawChannel.getBlob(keyMin, keyMax, frames);
+	if (resBlob.error() || frames.size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resBlob.status() << endl;
+		return 5;
+	}
+	cout << "Stored " << frames.heap().size() << " bytes for " << rawSize
+		 << " bytes of payloads" << endl;
+	if (frames.heap().size() * 4 > rawSize) {
+		cout << "[ERROR] The payloads were not compressed" << endl;
+		return 6;
+	}
+
+	cout << "Rejecting malformed frames..." << endl;
+	std::unique_ptr<CompressedPayloadType<std::string>> payloadType = makePayloadType();
+	const unsigned char malformed[][4] = {{7, 0, 0, 0}, {1, 0x80, 0x80, 0x80}, {1, 9, 0x90, 1}};
+	for (const auto& frame : malformed) {
+		std::string value;
+		if (payloadType->fromBytes(value, frame, sizeof(frame))) {
+			cout << "[ERROR] A malformed frame was accepted" << endl;
+			return 7;
+		}
+	}
+
+	cout << "Rejecting a frame claiming a payload its block cannot hold..." << endl;
+	std::unique_ptr<CountingCodec> codec = std::make_unique<CountingCodec>();
+	CountingCodec& counting = *codec;
+	CompressedPayloadType<std::string> countingType(
+		std::make_unique<StringPayload>(), std::move(codec));
+	const unsigned char bomb[] = {1, 0xff, 0xff, 0xff, 0x7f, 0};
+	std::string bombValue;
+	if (countingType.fromBytes(bombValue, bomb, sizeof(bomb)) || counting.decompressed != 0) {
+		cout << "[ERROR] A frame claiming 256 MiB from a single byte was decompressed"
+			 << endl;
+		return 8;
+	}
+
+	cout << "Sending another value from the address of one too large..." << endl;
+	Channel<std::string> smallChannel(globals::addr, globals::port, makePayloadType());
+	smallChannel.setTimeout(3000ms);
+	smallChannel.setMemoryLimit(64UL * 1024);
+	res = smallChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 9;
+	}
+	RecordsSet<std::string> reused;
+	std::string incompressible;
+	for (long int i = 0; i < 256L * 1024; ++i) {
+		incompressible.push_back(static_cast<char>(rng()));
+	}
+	const Key reusedMin(getTestCid(1), 0, Key::cMoidMin, Timestamp::now(), Key::cAcqMin);
+	reused.append(Key(getTestCid(1), 0, 0, Timestamp::now()), incompressible);
+	res = smallChannel.put(reused);
+	if (res.status() != result_t::MEMORY_LIMIT_EXCEEDED) {
+		cout << "[ERROR] PUT of a payload over the memory limit returned "
+			 << (int)res.status() << endl;
+		return 10;
+	}
+	const std::string* const address = &reused.begin()->value;
+	reused.clear();
+	reused.append(Key(getTestCid(1), 0, 0, Timestamp::now()), sample + "1}");
+	if (&reused.begin()->value != address) {
+		cout << "[ERROR] The value did not reuse the address" << endl;
+		return 11;
+	}
+	if (!smallChannel.connected() && smallChannel.connect().error()) {
+		cout << "[ERROR] Reconnect failed" << endl;
+		return 12;
+	}
+	res = smallChannel.put(reused);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 13;
+	}
+	Key reusedMax = keyMax;
+	reusedMax.cid = getTestCid(1) + 1;
+	resGet = smallChannel.get(reusedMin, reusedMax);
+	if (resGet.error() || compareRecordsSets(reused, resGet.records(), compKeysStrings) != 0) {
+		cout << "[ERROR] The value stored is not the one sent" << endl;
+		return 14;
+	}
+	return 0;
+}
+
+int test_channel_interned_payload()
+{
+	Channel<std::string> rawChannel(
+		globals::addr, globals::port, std::make_unique<StringPayload>());
+	auto payloadType = std::make_shared<InternedPayloadType>(1024, 64);
+	Channel<InternedBytes> channel(globals::addr,
+		globals::port,
+		std::make_unique<SharedPayloadType<InternedBytes>>(payloadType));
+	rawChannel.setTimeout(3000ms);
+	channel.setTimeout(3000ms);
+	rawChannel.setMemoryLimit(4UL * 1024 * 1024);
+	channel.setMemoryLimit(4UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = rawChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// Three labels, the empty payload, and long payloads which are not
+	// interned.
+	const std::string labels[] = {"idle", "running", "failed", ""};
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < 1000; ++i) {
+		std::string value = i % 10 == 9 ? std::string(100 + i, 'x') : labels[i % 4];
+		records.append(Key(getTestCid(0), i, 0, keyMin.cap + i, 0), std::move(value));
+	}
+	res = rawChannel.puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the records with interned payloads..." << endl;
+	ResponseGet<InternedBytes> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	std::set<const std::string*> distinct;
+	for (std::size_t i = 0; i < records.size(); ++i) {
+		const Record<InternedBytes>& record = resGet.records()[i];
+		if (!(record.key == records[i].key) || !record.value
+			|| *record.value != records[i].value) {
+			cout << "[ERROR] Record " << i << " differs" << endl;
+			return 4;
+		}
+		if (record.value->size() <= 64) {
+			distinct.insert(record.value.get());
+		}
+	}
+	if (distinct.size() != 4 || payloadType->size() != 4) {
+		cout << "[ERROR] Expected 4 distinct short values, got " << distinct.size() << " in "
+			 << payloadType->size() << " interned" << endl;
+		return 5;
+	}
+
+	cout << "Sending interned payloads back..." << endl;
+	RecordsSet<InternedBytes> copies;
+	for (const Record<InternedBytes>& record : resGet.records()) {
+		Key key = record.key;
+		key.mid += 1000;
+		copies.append(key, record.value);
+	}
+	res = channel.puta(copies);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	ResponseGet<std::string> resRaw = rawChannel.get(keyMin, keyMax);
+	if (resRaw.error() || resRaw.records().size() != 2 * records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resRaw.status() << endl;
+		return 7;
+	}
+	for (const Record<std::string>& record : resRaw.records()) {
+		if (record.value != records[record.key.mid % 1000].value) {
+			cout << "[ERROR] Record " << record.key.mid << " differs" << endl;
+			return 8;
+		}
+	}
+	return 0;
+}
+
+namespace {
+
+/** @brief A fixed-layout payload read in place. */
+struct SensorPayload
+{
+	std::uint32_t magic;
+	std::uint32_t id;
+	double value;
+};
+
+/** @brief The schema of `SensorPayload` for `ViewRecordsSet`. */
+struct SensorSchema
+{
+	using View = const SensorPayload*;
+	static constexpr std::uint32_t cMagic = 0x53454e53;
+	static constexpr std::size_t cAlignment = alignof(SensorPayload);
+	static bool verify(const void* data, std::size_t size)
+	{
+		std::uint32_t magic = 0;
+		if (size != sizeof(SensorPayload)
+			|| reinterpret_cast<std::uintptr_t>(data) % cAlignment != 0) {
+			return false;
+		}
+		std::memcpy(&magic, data, sizeof(magic));
+		return magic == cMagic;
+	}
+	static View view(const void* data, std::size_t) { return static_cast<View>(data); }
+};
+
+} /*namespace*/
+
+int test_channel_view_records_set()
+{
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// Every third payload is malformed and of an odd size, which misaligns
+	// the following ones unless the set pads them.
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < 300; ++i) {
+		std::string bytes;
+		if (i % 3 == 2) {
+			bytes.assign(static_cast<std::size_t>(i % 7 + 1), 'x');
+		} else {
+			const SensorPayload payload{SensorSchema::cMagic,
+				static_cast<std::uint32_t>(i),
+				static_cast<double>(i) / 4};
+			bytes.assign(reinterpret_cast<const char*>(&payload), sizeof(payload));
+		}
+		records.append(Key(getTestCid(0), i, 0, keyMin.cap + i, 0), std::move(bytes));
+	}
+	res = channel.puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the records into views..." << endl;
+	ViewRecordsSet<SensorSchema> views;
+	ResponseAcq resGet = channel.getBlob(keyMin, keyMax, views.raw());
+	if (resGet.error() || views.size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	const std::size_t invalid = views.verify();
+	if (invalid != records.size() / 3) {
+		cout << "[ERROR] " << invalid << " malformed payloads instead of " << records.size() / 3
+			 << endl;
+		return 4;
+	}
+	for (std::size_t i = 0; i < views.size(); ++i) {
+		const long int mid = views.key(i).mid;
+		if (views.valid(i) != (mid % 3 != 2)) {
+			cout << "[ERROR] Record " << mid << " was verified wrongly" << endl;
+			return 5;
+		}
+		if (!views.valid(i)) {
+			continue;
+		}
+		const SensorPayload* payload = views.view(i);
+		if (static_cast<const void*>(payload) != views.raw().payload(i) || payload->id != mid
+			|| payload->value != static_cast<double>(mid) / 4) {
+			cout << "[ERROR] Record " << mid << " has a wrong view" << endl;
+			return 6;
+		}
+	}
+	return 0;
+}
+
+int test_channel_series_compressor()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	constexpr long int cRecords = 1000;
+	constexpr double cTolerance = 0.5;
+	constexpr Key::CapT cMaxGap = 100;
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// A noisy triangle through the swinging door, a noisy constant through the
+	// deadband.
+	std::minstd_rand rng(17);
+	std::uniform_real_distribution<float> noise(-0.2f, 0.2f);
+	RecordsSet<float> ramp;
+	RecordsSet<float> flat;
+	for (long int i = 0; i < cRecords; ++i) {
+		const float trend = i < cRecords / 2 ? i * 0.1f : 50.0f - (i - cRecords / 2) * 0.05f;
+		ramp.append(Key(getTestCid(0), 0, 0, keyMin.cap + i, 0), trend + noise(rng));
+		flat.append(Key(getTestCid(1), 0, 0, keyMin.cap + i, 0), 20.0f + noise(rng));
+	}
+
+	cout << "Storing compressed series..." << endl;
+	SeriesCompressionOptions doorOptions;
+	doorOptions.tolerance = cTolerance;
+	SeriesCompressor<float> door(channel, doorOptions);
+	SeriesCompressionOptions bandOptions;
+	bandOptions.method = SeriesCompression::DEADBAND;
+	bandOptions.tolerance = cTolerance;
+	bandOptions.maxGap = cMaxGap;
+	SeriesCompressor<float> band(channel, bandOptions);
+	for (long int i = 0; i < cRecords; i += 100) {
+		RecordsSet<float> rampBatch;
+		RecordsSet<float> flatBatch;
+		for (long int j = i; j < i + 100; ++j) {
+			rampBatch.append(ramp[j]);
+			flatBatch.append(flat[j]);
+		}
+		res = door.puta(rampBatch);
+		if (res.error()) {
+			cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+			return 2;
+		}
+		res = band.puta(flatBatch);
+		if (res.error()) {
+			cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+			return 2;
+		}
+	}
+	if (door.flush().error() || band.flush().error()) {
+		cout << "[ERROR] Flush failed" << endl;
+		return 3;
+	}
+	cout << "Stored " << door.stored() << " and " << band.stored() << " of " << cRecords
+		 << " records" << endl;
+	if (door.received() != cRecords || door.stored() > cRecords / 20
+		|| band.stored() > cRecords / cMaxGap + 1) {
+		cout << "[ERROR] The series were not compressed" << endl;
+		return 4;
+	}
+
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != door.stored() + band.stored()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records" << endl;
+		return 5;
+	}
+	std::map<Key::CapT, float> rampStored;
+	std::map<Key::CapT, float> flatStored;
+	for (const Record<float>& record : resGet.records()) {
+		(record.key.cid == getTestCid(0) ? rampStored : flatStored)[record.key.cap] = record.value;
+	}
+
+	cout << "Checking the interpolation of the swinging door..." << endl;
+	for (const Record<float>& record : ramp) {
+		const auto next = rampStored.lower_bound(record.key.cap);
+		if (next == rampStored.end()) {
+			cout << "[ERROR] The last record was not stored" << endl;
+			return 6;
+		}
+		double estimate = next->second;
+		if (next->first != record.key.cap) {
+			const auto prev = std::prev(next);
+			const double t = static_cast<double>(record.key.cap - prev->first)
+				/ static_cast<double>(next->first - prev->first);
+			estimate = prev->second + t * (next->second - prev->second);
+		}
+		if (std::fabs(estimate - record.value) > cTolerance + 1e-3) {
+			cout << "[ERROR] CAP " << record.key.cap << " interpolates to " << estimate
+				 << " instead of " << record.value << endl;
+			return 7;
+		}
+	}
+
+	cout << "Checking the deadband..." << endl;
+	for (const Record<float>& record : flat) {
+		const auto last = flatStored.upper_bound(record.key.cap);
+		if (last == flatStored.begin()) {
+			cout << "[ERROR] The first record was not stored" << endl;
+			return 8;
+		}
+		const auto prev = std::prev(last);
+		if (std::fabs(prev->second - record.value) > cTolerance + 1e-3
+			|| record.key.cap - prev->first > cMaxGap) {
+			cout << "[ERROR] CAP " << record.key.cap << " is not covered by CAP " << prev->first
+				 << endl;
+			return 9;
+		}
+	}
+	return 0;
+}
+
+int test_channel_sample_packer()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+
+	constexpr long int cSeries = 3;
+	constexpr long int cRecords = 3000;
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// Interleaved series with a gap in the CAPs of the first one, and a
+	// series stored without packing.
+	std::map<std::pair<Key::CidT, Key::CapT>, float> samples;
+	RecordsSet<float> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		const long int series = i % cSeries;
+		const Key::CapT cap = keyMin.cap + i / cSeries + (series == 0 && i > cRecords / 2 ? 5000 : 0);
+		const float value = static_cast<float>(i) * 0.25f;
+		records.append(Key(getTestCid(series), 0, 0, cap, 0), value);
+		samples[std::make_pair(getTestCid(series), cap)] = value;
+	}
+	RecordsSet<float> unpacked;
+	for (long int i = 0; i < 10; ++i) {
+		unpacked.append(Key(getTestCid(cSeries), 0, 0, keyMin.cap + i, 0), -1.0f * i);
+		samples[std::make_pair(getTestCid(cSeries), keyMin.cap + i)] = -1.0f * i;
+	}
+
+	cout << "Storing packed samples..." << endl;
+	SamplePackingOptions options;
+	options.maxSamples = 50;
+	options.maxSpan = 1000;
+	SamplePacker<float> packer(channel, options);
+	for (long int i = 0; i < cRecords; i += 100) {
+		RecordsSet<float> batch;
+		for (long int j = i; j < i + 100; ++j) {
+			batch.append(records[j]);
+		}
+		res = packer.put(batch);
+		if (res.error()) {
+			cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+			return 2;
+		}
+	}
+	if (packer.flush().error() || channel.put(unpacked).error()) {
+		cout << "[ERROR] Flush failed" << endl;
+		return 3;
+	}
+	cout << "Stored " << packer.received() << " samples in " << packer.stored() << " records"
+		 << endl;
+	if (packer.received() != cRecords || packer.stored() != cRecords / 50 + 1) {
+		cout << "[ERROR] The samples were not packed" << endl;
+		return 4;
+	}
+
+	cout << "Fetching the unpacked samples..." << endl;
+	const ResponseGet<float> resGet = packer.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != samples.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " samples" << endl;
+		return 5;
+	}
+	for (const Record<float>& sample : resGet.records()) {
+		const auto found = samples.find(std::make_pair(sample.key.cid, sample.key.cap));
+		if (found == samples.end() || found->second != sample.value) {
+			cout << "[ERROR] Unexpected sample of " << sample.key << endl;
+			return 6;
+		}
+	}
+
+	cout << "Streaming the samples of a key-interval starting inside records..." << endl;
+	Key windowMin = keyMin;
+	windowMin.cap = keyMin.cap + 125;
+	Key windowMax = keyMax;
+	windowMax.cap = keyMin.cap + 375;
+	std::size_t streamed = 0;
+	const ResponseAcq resStream = packer.getStream(windowMin, windowMax,
+		[&streamed, &windowMin, &windowMax](RecordsSet<float>& batch) {
+			for (const Record<float>& sample : batch) {
+				if (sample.key.cap >= windowMin.cap && sample.key.cap < windowMax.cap) {
+					++streamed;
+				}
+			}
+		});
+	if (resStream.error() || streamed != cSeries * 250) {
+		cout << "[ERROR] Stream failed: " << (int)resStream.status() << ", " << streamed
+			 << " samples" << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_get_series()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024 * 1024);
+
+	constexpr long int cSeries = 6;
+	constexpr long int cRecords = 3000;
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// The series are interleaved, as sampled together.
+	RecordsSet<float> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		const long int series = i % cSeries;
+		records.append(Key(getTestCid(series % 2), series, series % 3, keyMin.cap + i, 0),
+			static_cast<float>(i) / 2);
+	}
+	res = channel.puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Fetching the records into series..." << endl;
+	SeriesSet<float> series;
+	ResponseAcq resGet = channel.getSeries(keyMin, keyMax, series);
+	if (resGet.error()) {
+		cout << "[ERROR] Series GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (series.size() != records.size() || series.seriesCount() != cSeries) {
+		cout << "[ERROR] " << series.size() << " records in " << series.seriesCount()
+			 << " series received" << endl;
+		return 4;
+	}
+	for (const auto& s : series) {
+		const long int mid = s.id.mid;
+		if (s.caps.size() != cRecords / cSeries || s.acqs.size() != s.caps.size()
+			|| s.values.size() != s.caps.size()) {
+			cout << "[ERROR] Series " << mid << " has arrays of wrong lengths" << endl;
+			return 5;
+		}
+		for (std::size_t j = 0; j < s.caps.size(); ++j) {
+			const long int i = static_cast<long int>(j) * cSeries + mid;
+			if (s.caps[j] != keyMin.cap + i || s.values[j] != static_cast<float>(i) / 2) {
+				cout << "[ERROR] Series " << mid << " has a wrong record at " << j << endl;
+				return 6;
+			}
+		}
+		if (series.find(s.id.cid, s.id.mid, s.id.moid) != &s) {
+			cout << "[ERROR] Series " << mid << " not found" << endl;
+			return 7;
+		}
+	}
+	if (series.find(getTestCid(0), cSeries, 0) != nullptr) {
+		cout << "[ERROR] Found a series never stored" << endl;
+		return 8;
+	}
+
+	cout << "Streaming the records into series..." << endl;
+	StreamBatching batching;
+	batching.maxRecords = 256;
+	channel.setStreamBatching(batching);
+	std::size_t streamed = 0;
+	std::vector<Key::CapT> lastCaps(cSeries, 0);
+	bool ordered = true;
+	resGet = channel.getStreamSeries(keyMin, keyMax, [&](SeriesSet<float>& batch) {
+		streamed += batch.size();
+		for (const auto& s : batch) {
+			for (const Key::CapT cap : s.caps) {
+				ordered = ordered && cap > lastCaps[s.id.mid];
+				lastCaps[s.id.mid] = cap;
+			}
+		}
+	});
+	if (resGet.error() || streamed != records.size() || !ordered) {
+		cout << "[ERROR] Series stream failed: " << (int)resGet.status() << ", " << streamed
+			 << " records received" << endl;
+		return 9;
+	}
+
+	res = channel.close();
+	if (res.error()) {
+		cout << "[ERROR] Close failed: " << (int)res.status() << endl;
+		return 10;
+	}
+	return 0;
+}
+
+int test_channel_numeric_payload_types()
+{
+	Channel<std::int64_t> varintChannel(
+		globals::addr, globals::port, std::make_unique<VarintPayloadType<std::int64_t>>());
+	Channel<double> scalarChannel(
+		globals::addr, globals::port, std::make_unique<LittleEndianPayloadType<double>>());
+	Channel<std::vector<double>> arrayChannel(
+		globals::addr, globals::port, std::make_unique<GorillaPayloadType<double>>());
+	Channel<std::string> rawChannel(
+		globals::addr, globals::port, std::make_unique<StringPayload>());
+	varintChannel.setTimeout(3000ms);
+	scalarChannel.setTimeout(3000ms);
+	arrayChannel.setTimeout(3000ms);
+	rawChannel.setTimeout(3000ms);
+	arrayChannel.setMemoryLimit(4UL * 1024 * 1024);
+	rawChannel.setMemoryLimit(4UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+	Key keyMinCid1 = keyMin;
+	keyMinCid1.cid = getTestCid(1);
+	Key keyMaxCid0 = keyMax;
+	keyMaxCid0.cid = getTestCid(1);
+
+	Response res = varintChannel.connect();
+	if (res.error() || (res = scalarChannel.connect()).error()
+		|| (res = arrayChannel.connect()).error() || (res = rawChannel.connect()).error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Storing varints..." << endl;
+	const std::int64_t integers[] = {0,
+		1,
+		-1,
+		63,
+		-64,
+		64,
+		300,
+		-300,
+		std::numeric_limits<std::int64_t>::max(),
+		std::numeric_limits<std::int64_t>::min()};
+	RecordsSet<std::int64_t> varints;
+	for (std::size_t i = 0; i < sizeof(integers) / sizeof(integers[0]); ++i) {
+		varints.append(Key(getTestCid(0), static_cast<long>(i), 0, Timestamp::now()), integers[i]);
+	}
+	res = varintChannel.put(varints);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	ResponseGet<std::int64_t> resVarints = varintChannel.get(keyMin, keyMaxCid0);
+	if (resVarints.error() || resVarints.records().size() != varints.size()) {
+		cout << "[ERROR] GET failed: " << (int)resVarints.status() << endl;
+		return 3;
+	}
+	auto receivedVarint = resVarints.records().begin();
+	for (const Record<std::int64_t>& sent : varints) {
+		if (receivedVarint->value != sent.value) {
+			cout << "[ERROR] Varint " << sent.value << " read as " << receivedVarint->value
+				 << endl;
+			return 4;
+		}
+		++receivedVarint;
+	}
+	BlobRecordsSet frames;
+	ResponseAcq resBlob = rawChannel.getBlob(keyMin, keyMaxCid0, frames);
+	if (resBlob.error() || frames.size() != varints.size() || frames.payloadSize(0) != 1
+		|| frames.payloadSize(6) != 2 || frames.payloadSize(8) != 10) {
+		cout << "[ERROR] Unexpected varint sizes" << endl;
+		return 5;
+	}
+
+	cout << "Storing little-endian scalars..." << endl;
+	RecordsSet<double> scalars;
+	scalars.append(Key(getTestCid(1), 0, 0, Timestamp::now()), 1.0);
+	res = scalarChannel.put(scalars);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	frames.clear();
+	resBlob = rawChannel.getBlob(keyMinCid1, keyMax, frames);
+	const unsigned char one[] = {0, 0, 0, 0, 0, 0, 0xf0, 0x3f};
+	if (resBlob.error() || frames.size() != 1 || frames.payloadSize(0) != sizeof(one)
+		|| std::memcmp(frames.payload(0), one, sizeof(one)) != 0) {
+		cout << "[ERROR] The scalar was not stored in little-endian order" << endl;
+		return 7;
+	}
+
+	cout << "Storing Gorilla-encoded arrays..." << endl;
+	RecordsSet<std::vector<double>> arrays;
+	std::size_t rawSize = 0;
+	for (long int i = 0; i < 100; ++i) {
+		std::vector<double> values;
+		for (long int j = 0; j < i * 10; ++j) {
+			// A slowly changing series with repeats, and some special values.
+			values.push_back(20.0 + 0.25 * static_cast<double>((i + j / 3) % 16));
+		}
+		if (i % 10 == 1) {
+			values.push_back(-0.0);
+			values.push_back(std::numeric_limits<double>::infinity());
+			values.push_back(std::numeric_limits<double>::denorm_min());
+			values.push_back(-std::numeric_limits<double>::max());
+		}
+		rawSize += values.size() * sizeof(double);
+		arrays.append(Key(getTestCid(1), i, 1, Timestamp::now()), std::move(values));
+	}
+	res = arrayChannel.put(arrays);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 8;
+	}
+	Key arraysMin = keyMinCid1;
+	arraysMin.moid = 1;
+	ResponseGet<std::vector<double>> resArrays = arrayChannel.get(arraysMin, keyMax);
+	if (resArrays.error() || resArrays.records().size() != arrays.size()) {
+		cout << "[ERROR] GET failed: " << (int)resArrays.status() << endl;
+		return 9;
+	}
+	auto receivedArray = resArrays.records().begin();
+	for (const Record<std::vector<double>>& record : arrays) {
+		const std::vector<double>& sent = record.value;
+		const std::vector<double>& received = (receivedArray++)->value;
+		if (sent.size() != received.size()
+			|| (!sent.empty()
+				&& std::memcmp(sent.data(), received.data(), sent.size() * sizeof(double))
+					!= 0)) {
+			cout << "[ERROR] Array " << record.key.mid << " was not read back bit-exactly"
+				 << endl;
+			return 10;
+		}
+	}
+	frames.clear();
+	resBlob = rawChannel.getBlob(arraysMin, keyMax, frames);
+	if (resBlob.error() || frames.size() != arrays.size()) {
+		cout << "[ERROR] GET failed: " << (int)resBlob.status() << endl;
+		return 11;
+	}
+	cout << "Stored " << frames.heap().size() << " bytes for " << rawSize
+		 << " bytes of arrays" << endl;
+	if (frames.heap().size() * 4 > rawSize) {
+		cout << "[ERROR] The arrays were not compressed" << endl;
+		return 12;
+	}
+
+	cout << "Rejecting malformed payloads..." << endl;
+	VarintPayloadType<std::int8_t> int8Type;
+	GorillaPayloadType<float> floatType;
+	std::int8_t int8 = 0;
+	std::vector<float> floats;
+	const unsigned char overflow[] = {0x80, 0x02};
+	const unsigned char trailing[] = {0x01, 0x00};
+	const unsigned char truncated[] = {0x03, 0x00, 0x00, 0x80, 0x3f, 0xc0};
+	const unsigned char huge[] = {0xff, 0xff, 0xff, 0xff, 0x0f, 0x00, 0x00, 0x00, 0x00};
+	if (int8Type.fromBytes(int8, overflow, sizeof(overflow))
+		|| int8Type.fromBytes(int8, trailing, sizeof(trailing))
+		|| floatType.fromBytes(floats, truncated, sizeof(truncated))
+		|| floatType.fromBytes(floats, huge, sizeof(huge))) {
+		cout << "[ERROR] A malformed payload was accepted" << endl;
+		return 13;
+	}
+
+	cout << "Sending another array from the address of one too large..." << endl;
+	Channel<std::vector<double>> smallChannel(
+		globals::addr, globals::port, std::make_unique<GorillaPayloadType<double>>());
+	smallChannel.setTimeout(3000ms);
+	smallChannel.setMemoryLimit(64UL * 1024);
+	res = smallChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 14;
+	}
+	std::minstd_rand rng(41);
+	std::vector<double> noise;
+	for (long int i = 0; i < 64L * 1024; ++i) {
+		noise.push_back(static_cast<double>(rng()) / 7.0);
+	}
+	RecordsSet<std::vector<double>> reused;
+	reused.append(Key(getTestCid(2), 0, 0, Timestamp::now()), noise);
+	res = smallChannel.put(reused);
+	if (res.status() != result_t::MEMORY_LIMIT_EXCEEDED) {
+		cout << "[ERROR] PUT of a payload over the memory limit returned "
+			 << (int)res.status() << endl;
+		return 15;
+	}
+	const std::vector<double>* const address = &reused.begin()->value;
+	reused.clear();
+	reused.append(Key(getTestCid(2), 0, 0, Timestamp::now()), std::vector<double>{1.0, 2.0});
+	if (&reused.begin()->value != address) {
+		cout << "[ERROR] The array did not reuse the address" << endl;
+		return 16;
+	}
+	if (!smallChannel.connected() && smallChannel.connect().error()) {
+		cout << "[ERROR] Reconnect failed" << endl;
+		return 17;
+	}
+	res = smallChannel.put(reused);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 18;
+	}
+	Key reusedMin = keyMin;
+	reusedMin.cid = getTestCid(2);
+	Key reusedMax = keyMax;
+	reusedMax.cid = getTestCid(2) + 1;
+	resArrays = smallChannel.get(reusedMin, reusedMax);
+	if (resArrays.error() || resArrays.records().size() != 1
+		|| resArrays.records().begin()->value != reused.begin()->value) {
+		cout << "[ERROR] The array stored is not the one sent" << endl;
+		return 19;
+	}
+	return 0;
+}
+
+int test_channel_stats()
+{
+	for (std::size_t bucket = 0; bucket < LatencyHistogram::cBuckets; ++bucket) {
+		const std::uint64_t lowerBoundUs = LatencyHistogram::bucketLowerBoundUs(bucket);
+		if (LatencyHistogram::bucketOf(lowerBoundUs) != bucket
+			|| (bucket > 0 && LatencyHistogram::bucketOf(lowerBoundUs - 1) != bucket - 1)) {
+			cout << "[ERROR] Bucket " << bucket << " is misplaced" << endl;
+			return 1;
+		}
+	}
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	const Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	// Records alternating between two CIDs, several buffers' worth.
+	RecordsSet<float> records;
+	for (long int i = 0; i < 400; ++i) {
+		records.append(Key(getTestCid(i / 100 % 2), i, 0, Timestamp::now()), 0.5f * i);
+	}
+
+	cout << "Reading the counters while putting records..." << endl;
+	std::atomic<bool> done(false);
+	std::future<bool> monitor = std::async(std::launch::async, [&channel, &done]() {
+		std::uint64_t lastBytesSent = 0;
+		while (!done.load()) {
+			const ChannelStats stats = channel.stats();
+			if (stats.bytesSent < lastBytesSent) {
+				return false;
+			}
+			lastBytesSent = stats.bytesSent;
+		}
+		return true;
+	});
+	const Response resPut = channel.put(records);
+	done.store(true);
+	if (resPut.error() || !monitor.get()) {
+		cout << "[ERROR] PUT failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+	const ChannelStats afterPut = channel.stats();
+	if (afterPut.put.count != 1 || afterPut.get.count != 0 || afterPut.putBatches < 4
+		|| afterPut.putBufferFlushes == 0 || afterPut.sendCalls <= afterPut.putBufferFlushes
+		|| afterPut.bytesSent < records.size() * sizeof(float)) {
+		cout << "[ERROR] Unexpected PUT counters: " << afterPut.put.count << " PUTs, "
+			 << afterPut.putBatches << " batches, " << afterPut.putBufferFlushes << " flushes, "
+			 << afterPut.sendCalls << " sends of " << afterPut.bytesSent << " bytes" << endl;
+		return 4;
+	}
+
+	cout << "Timing GET and GETACQ requests..." << endl;
+	channel.setMemoryLimit(1024 * 1024);
+	for (int i = 0; i < 10; ++i) {
+		const ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+		if (resGet.error() || resGet.records().size() != records.size()) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+			return 5;
+		}
+	}
+	const ResponseAcq resAcq = channel.getAcq(keyMin, keyMax);
+	if (resAcq.error()) {
+		cout << "[ERROR] GETACQ failed: " << (int)resAcq.status() << endl;
+		return 6;
+	}
+	const ChannelStats stats = channel.stats();
+	const LatencyHistogram& get = stats.get;
+	std::uint64_t bucketed = 0;
+	for (const std::uint64_t count : get.counts) {
+		bucketed += count;
+	}
+	cout << "GET latency: mean " << get.meanUs() << " us, p50 " << get.percentileUs(0.5)
+		 << " us, p99 " << get.percentileUs(0.99) << " us, max " << get.maxUs << " us" << endl;
+	if (get.count != 10 || bucketed != get.count || stats.getAcq.count != 1
+		|| stats.put.count != 1 || get.maxUs == 0 || get.percentileUs(0.5) > get.percentileUs(0.99)
+		|| get.percentileUs(1.0) != get.maxUs || get.totalUs > get.count * get.maxUs) {
+		cout << "[ERROR] Unexpected latency histograms" << endl;
+		return 7;
+	}
+	if (stats.recvCalls <= afterPut.recvCalls
+		|| stats.bytesReceived < afterPut.bytesReceived + 10 * records.size() * sizeof(float)) {
+		cout << "[ERROR] Unexpected receive counters: " << stats.recvCalls << " receives of "
+			 << stats.bytesReceived << " bytes" << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_allocation_stats()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	const Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < 200; ++i) {
+		records.append(Key(getTestCid(i % 2), i, 0, keyMin.cap + i), 0.25f * i);
+	}
+	const auto roundTrip = [&]() {
+		return !channel.put(records).error() && !channel.get(keyMin, keyMax).error();
+	};
+
+	cout << "Warming up..." << endl;
+	if (!roundTrip()) {
+		cout << "[ERROR] Warm-up failed" << endl;
+		return 2;
+	}
+	const ChannelStats warm = channel.stats();
+	if (warm.bufferAllocations == 0 || warm.bufferBytesAllocated < 64 * 1024) {
+		cout << "[ERROR] " << warm.bufferAllocations << " buffers of "
+			 << warm.bufferBytesAllocated << " bytes allocated while warming up" << endl;
+		return 3;
+	}
+
+	cout << "Repeating the requests in a steady state..." << endl;
+	for (int i = 0; i < 5; ++i) {
+		if (!roundTrip()) {
+			cout << "[ERROR] Request failed" << endl;
+			return 4;
+		}
+	}
+	const ChannelStats steady = channel.stats();
+	if (steady.bufferAllocations != warm.bufferAllocations) {
+		cout << "[ERROR] " << steady.bufferAllocations - warm.bufferAllocations
+			 << " buffers allocated in the steady state" << endl;
+		return 5;
+	}
+
+	const CommandCosts& get = steady.getCosts;
+	const CommandCosts& put = steady.putCosts;
+	cout << "GET: " << get.sendCalls << " sends, " << get.recvCalls << " receives; PUT: "
+		 << put.sendCalls << " sends, " << put.recvCalls << " receives" << endl;
+	if (get.sendCalls < 6 || get.recvCalls < 6 || put.sendCalls < 6 || put.recvCalls < 6
+		|| steady.putACosts.sendCalls != 0 || steady.getAcqCosts.recvCalls != 0) {
+		cout << "[ERROR] Syscalls charged to the wrong commands" << endl;
+		return 6;
+	}
+	if (get.sendCalls + put.sendCalls != steady.sendCalls
+		|| get.recvCalls + put.recvCalls != steady.recvCalls
+		|| get.bufferAllocations + put.bufferAllocations != steady.bufferAllocations
+		|| get.bufferBytesAllocated + put.bufferBytesAllocated
+			!= steady.bufferBytesAllocated) {
+		cout << "[ERROR] The costs of the commands do not add up to the totals" << endl;
+		return 7;
+	}
+
+	cout << "Counting the allocations of the records..." << endl;
+	const CountingAllocator<Record<float>> alloc = makeCountingAllocator<Record<float>>();
+	{
+		const ResponseGet<float, CountingAllocator<Record<float>>> resGet =
+			channel.get(keyMin, keyMax, alloc);
+		if (resGet.error() || resGet.records().size() < records.size()) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+			return 8;
+		}
+	}
+	const AllocationCounter& counter = *alloc.counter();
+	if (counter.allocations() == 0 || counter.deallocations() != counter.allocations()
+		|| counter.bytesAllocated() < records.size() * sizeof(Record<float>)) {
+		cout << "[ERROR] " << counter.allocations() << " allocations of "
+			 << counter.bytesAllocated() << " bytes, " << counter.deallocations()
+			 << " deallocations counted" << endl;
+		return 9;
+	}
+	return 0;
+}
+
+int test_channel_get_presized()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024 * 1024);
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	const Key keyMin(getTestCid(0), 500, Key::cMoidMin, Timestamp::now(), Key::cAcqMin);
+	const Key keyMax(getTestCid(0) + 1, 501, Key::cMoidMax, Key::cCapMax, Key::cAcqMax);
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(0), 500, 0, Timestamp::now()), static_cast<float>(i));
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	// Returns the allocations of the records container of a GET response.
+	const auto getAllocations = [&keyMin, &keyMax, &records](Channel<float>& ch) {
+		const CountingAllocator<Record<float>> alloc = makeCountingAllocator<Record<float>>();
+		const ResponseGet<float, CountingAllocator<Record<float>>> resGet =
+			ch.get(keyMin, keyMax, alloc);
+		if (resGet.error() || resGet.records().size() != records.size()) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+			return std::uint64_t{0};
+		}
+		return alloc.counter()->allocations();
+	};
+
+	cout << "Growing the records container of an unknown key-interval..." << endl;
+	const std::uint64_t grown = getAllocations(channel);
+	if (grown < 2) {
+		cout << "[ERROR] Expected the container to grow, counted " << grown
+			 << " allocations" << endl;
+		return 3;
+	}
+
+	cout << "Reserving it from the history of the key-interval's width..." << endl;
+	const std::uint64_t reserved = getAllocations(channel);
+	if (reserved != 1) {
+		cout << "[ERROR] Expected a single allocation, counted " << reserved << endl;
+		return 4;
+	}
+
+	cout << "Fetching an expected amount of records..." << endl;
+	const ResponseGet<float> resExpected = channel.getExpecting(keyMin, keyMax, records.size());
+	if (resExpected.error()
+		|| compareRecordsSets(records, resExpected.records(), compKeysFloats) != 0) {
+		cout << "[ERROR] GET failed: " << (int)resExpected.status() << endl;
+		return 5;
+	}
+
+	cout << "Counting the records of an unknown key-interval first..." << endl;
+	Channel<float> counting(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	counting.setTimeout(3000ms);
+	counting.setMemoryLimit(1024 * 1024);
+	counting.setCountBeforeGet(true);
+	res = counting.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	const std::uint64_t counted = getAllocations(counting);
+	if (counted != 1) {
+		cout << "[ERROR] Expected a single allocation, counted " << counted << endl;
+		return 7;
+	}
+
+	// Far more records than memory could hold are expected; the reservation
+	// is capped rather than failing the query.
+	cout << "Fetching with an expected amount beyond memory..." << endl;
+	const ResponseGet<float> resHuge = channel.getExpecting(
+		keyMin, keyMax, std::numeric_limits<std::size_t>::max() / sizeof(Record<float>));
+	if (resHuge.error() || compareRecordsSets(records, resHuge.records(), compKeysFloats) != 0) {
+		cout << "[ERROR] GET failed: " << (int)resHuge.status() << endl;
+		return 8;
+	}
+	return 0;
+}
+
+/** @brief A tracer keeping all the traces it receives. */
+class RecordingTracer final : public Tracer
+{
+public:
+	void onConnect(const ConnectTrace& trace) override { connects.push_back(trace); }
+	void onRequest(const RequestTrace& trace) override { requests.push_back(trace); }
+
+	std::vector<ConnectTrace> connects;
+	std::vector<RequestTrace> requests;
+};
+
+int test_channel_tracer()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(1024 * 1024);
+	const std::shared_ptr<RecordingTracer> tracer = std::make_shared<RecordingTracer>();
+	channel.setTracer(tracer);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	const Response res = channel.connect();
+	if (res.error() || tracer->connects.size() != 1 || tracer->connects[0].status != result_t::OK
+		|| tracer->connects[0].end < tracer->connects[0].start) {
+		cout << "[ERROR] Connect failed or was not traced: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(0), i, 0, Timestamp::now()), 0.5f * i);
+	}
+	const Response resPut = channel.put(records);
+	const ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	const ResponseAcq resAcq = channel.getAcq(keyMin, keyMax);
+	if (resPut.error() || resGet.error() || resAcq.error()) {
+		cout << "[ERROR] A request failed" << endl;
+		return 2;
+	}
+
+	const TraceCommand commands[] = {TraceCommand::PUT, TraceCommand::GET, TraceCommand::GETACQ};
+	if (tracer->requests.size() != 3) {
+		cout << "[ERROR] Traced " << tracer->requests.size() << " requests instead of 3" << endl;
+		return 3;
+	}
+	for (std::size_t i = 0; i < 3; ++i) {
+		const RequestTrace& trace = tracer->requests[i];
+		cout << "Request " << (int)trace.command << ": sent in "
+			 << std::chrono::duration_cast<std::chrono::microseconds>(trace.sent - trace.start)
+					.count()
+			 << " us, waited "
+			 << std::chrono::duration_cast<std::chrono::microseconds>(
+					trace.firstByte - trace.sent)
+					.count()
+			 << " us, records in "
+			 << std::chrono::duration_cast<std::chrono::microseconds>(
+					trace.recordsDone - trace.firstByte)
+					.count()
+			 << " us, " << trace.bytesSent << "/" << trace.bytesReceived << " bytes" << endl;
+		if (trace.command != commands[i] || trace.status != result_t::OK
+			|| trace.sent < trace.start || trace.firstByte < trace.sent
+			|| trace.recordsDone < trace.firstByte || trace.end < trace.recordsDone
+			|| trace.recordsRecvWait > trace.recordsDone - trace.firstByte
+			|| trace.bytesSent == 0 || trace.bytesReceived == 0) {
+			cout << "[ERROR] Unexpected trace of request " << i << endl;
+			return 4;
+		}
+	}
+	if (tracer->requests[0].bytesSent < records.size() * sizeof(float)
+		|| tracer->requests[1].records != records.size()
+		|| tracer->requests[1].bytesReceived < records.size() * sizeof(float)
+		|| tracer->requests[2].records != 0) {
+		cout << "[ERROR] Unexpected trace counters" << endl;
+		return 5;
+	}
+
+	channel.setTracer(nullptr);
+	const ResponseAcq resUntraced = channel.getAcq(keyMin, keyMax);
+	if (resUntraced.error() || tracer->requests.size() != 3) {
+		cout << "[ERROR] A request was traced without a tracer" << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_cluster()
+{
+	const std::vector<Endpoint> nodes(3, Endpoint{globals::addr, globals::port});
+	ClusterChannel<float> cluster(nodes, std::make_shared<FloatPayload>(), 2);
+	cluster.setTimeout(3000ms);
+	cluster.setMemoryLimit(64UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	std::set<std::size_t> owners;
+	for (std::int32_t tid = 0; tid < 15; ++tid) {
+		owners.insert(cluster.nodeOf(getTestCid(tid)));
+	}
+	cout << "The test CIDs are spread over " << owners.size() << " nodes." << endl;
+	if (owners.size() < 2) {
+		cout << "[ERROR] All test CIDs are routed to a single node" << endl;
+		return 1;
+	}
+
+	cout << "Preparing records to send..." << endl;
+	RecordsSet<float> records;
+	RecordsSet<float> cidRecords;
+	for (long int i = 0; i < 20'000; ++i) {
+		const Key key(getTestCid(i % 15), i % 11, i % 5, keyMin.cap + 1000 * i, 0);
+		records.append(key, static_cast<float>(i));
+		if (key.cid == getTestCid(4)) {
+			cidRecords.append(key, static_cast<float>(i));
+		}
+	}
+
+	cout << "Connecting a cluster of " << cluster.size() << " nodes..." << endl;
+	Response res = cluster.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	Response resPut = cluster.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from all nodes..." << endl;
+	ResponseGet<float> resGet = cluster.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+	// Every node is the same server here, so each record comes once per node
+	// owning a CID of the key-interval.
+	std::set<std::size_t> queried;
+	for (Key::CidT cid = keyMin.cid; cid < keyMax.cid; ++cid) {
+		queried.insert(cluster.nodeOf(cid));
+	}
+	if (records.size() * queried.size() != resGet.records().size()
+		|| compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 5;
+	}
+	ResponseAcq resAcq = cluster.getAcq(keyMin, keyMax);
+	if (resAcq.error() || resGet.acq() > resAcq.acq()) {
+		cout << "[ERROR] GET returned ACQ " << resGet.acq()
+			 << " past the current ACQ " << resAcq.acq() << endl;
+		return 6;
+	}
+
+	cout << "Fetching a single CID from its owning node..." << endl;
+	Key cidMin = keyMin;
+	Key cidMax = keyMax;
+	cidMin.cid = getTestCid(4);
+	cidMax.cid = getTestCid(5);
+	resGet = cluster.get(cidMin, cidMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 7;
+	}
+	if (cidRecords.size() != resGet.records().size()
+		|| compareRecordsSets(cidRecords, resGet.records(), compKeysFloats) != 0) {
+		cout << "[ERROR] Expected " << cidRecords.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_replicas()
+{
+	// The first replica refuses connections, the other two are the test server.
+	const std::vector<Endpoint> replicas{
+		{globals::addr, 1}, {globals::addr, globals::port}, {globals::addr, globals::port}};
+	ReplicaChannel<float> channel(replicas, std::make_shared<FloatPayload>(), 2);
+	channel.setTimeout(3000ms);
+	channel.setReconnectInterval(60'000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Connecting " << channel.size() << " replicas, the first one down..." << endl;
+	Response res = channel.connect();
+	if (!res.error()) {
+		cout << "[ERROR] Connected to a closed port" << endl;
+		return 1;
+	}
+	if (channel.stats(0).healthy || !channel.stats(1).healthy || !channel.stats(2).healthy) {
+		cout << "[ERROR] Wrong replica health after connecting" << endl;
+		return 2;
+	}
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(1), i % 11, i % 5, keyMin.cap + 1000 * i, 0), static_cast<float>(i));
+	}
+	res = channel.replica(1).acquire()->puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 3;
+	}
+
+	cout << "Reading from the healthy replicas..." << endl;
+	for (int i = 0; i < 50; ++i) {
+		ResponseAcq resAcq = channel.getAcq(keyMin, keyMax);
+		if (resAcq.error()) {
+			cout << "[ERROR] GETACQ failed: " << (int)resAcq.status() << endl;
+			return 4;
+		}
+	}
+	const ReplicaStats stats1 = channel.stats(1);
+	const ReplicaStats stats2 = channel.stats(2);
+	cout << "Replica latencies: " << stats1.ewmaUs << " us (" << stats1.samples << " reads), "
+		 << stats2.ewmaUs << " us (" << stats2.samples << " reads)" << endl;
+	if (channel.stats(0).samples != 0 || stats1.samples == 0 || stats2.samples == 0
+		|| stats1.samples + stats2.samples != 50) {
+		cout << "[ERROR] Reads were not spread over the healthy replicas" << endl;
+		return 5;
+	}
+
+	cout << "Reading with hedging..." << endl;
+	channel.setHedging(true);
+	for (int i = 0; i < 50; ++i) {
+		ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+		if (resGet.error()) {
+			cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+			return 6;
+		}
+		if (compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+			return 7;
+		}
+	}
+	cout << "Sent " << channel.hedges() << " hedged requests." << endl;
+	channel.close();
+	if (channel.stats(1).samples + channel.stats(2).samples != 100 + channel.hedges()) {
+		cout << "[ERROR] Not all reads were measured" << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_get_parallel_decode()
+{
+	constexpr long int cRecords = 20000;
+
+	Channel<std::string> serialChannel(
+		globals::addr, globals::port, std::make_unique<StringPayload>());
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	serialChannel.setTimeout(3000ms);
+	channel.setTimeout(3000ms);
+	serialChannel.setMemoryLimit(16UL * 1024 * 1024);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+	channel.setDecodeThreads(3);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = serialChannel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 7), i, 0, Timestamp::now()),
+			"value-" + std::to_string(i) + std::string(i % 97, '*'));
+	}
+	res = serialChannel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	const ResponseGet<std::string> resSerial = serialChannel.get(keyMin, keyMax);
+	if (resSerial.error() || resSerial.records().size() != records.size()) {
+		cout << "[ERROR] Serial GET failed: " << (int)resSerial.status() << endl;
+		return 3;
+	}
+
+	cout << "Decoding a GET response on " << channel.decodeThreads() << " threads..." << endl;
+	const ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+	if (resGet.records().size() != resSerial.records().size()
+		|| !std::equal(resGet.records().begin(), resGet.records().end(),
+			resSerial.records().begin(),
+			[](const Record<std::string>& a, const Record<std::string>& b) {
+				return a.key == b.key && a.value == b.value;
+			})) {
+		cout << "[ERROR] The records differ from, or are ordered unlike, a serial GET" << endl;
+		return 5;
+	}
+
+	// A small buffer, so that the stream is delivered in many batches.
+	channel.setMemoryLimit(64UL * 1024);
+	cout << "Decoding a streamed GET response..." << endl;
+	RecordsSet<std::string> streamed;
+	std::size_t batches = 0;
+	const ResponseAcq resStream = channel.getStream(
+		keyMin, keyMax, [&streamed, &batches](RecordsSet<std::string>& batch) {
+			++batches;
+			for (const Record<std::string>& record : batch) {
+				streamed.append(record);
+			}
+		});
+	if (resStream.error() || batches < 2) {
+		cout << "[ERROR] Stream failed: " << (int)resStream.status() << ", " << batches
+			 << " batches received" << endl;
+		return 6;
+	}
+	if (compareRecordsSets(records, streamed, compKeysStrings) != 0
+		|| streamed.size() != records.size()) {
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_put_parallel_encode()
+{
+	constexpr long int cRecords = 12000;
+
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+	channel.setEncodeThreads(3);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	// Interleaved CIDs make a batch per record, and the larger values spill
+	// over to further segments of the chunks.
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 5), i, 0, Timestamp::now()),
+			"value-" + std::to_string(i) + std::string(i % 101 == 0 ? 4000 : i % 61, '+'));
+	}
+	cout << "Serializing a PUT request on " << channel.encodeThreads() << " threads..." << endl;
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStrings) != 0
+		|| resGet.records().size() != records.size()) {
+		cout << "[ERROR] Sent " << records.size() << " records, received "
+			 << resGet.records().size() << endl;
+		return 4;
+	}
+
+	cout << "Serializing a PUT request grouped by CID..." << endl;
+	channel.setPutCidGrouping(true);
+	RecordsSet<std::string> grouped;
+	for (long int i = 0; i < cRecords; ++i) {
+		grouped.append(Key(getTestCid(5 + i % 3), i, 0, Timestamp::now()), std::to_string(i));
+	}
+	res = channel.put(grouped);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 5;
+	}
+	Key groupedMin = keyMin;
+	groupedMin.cid = getTestCid(5);
+	resGet = channel.get(groupedMin, keyMax);
+	if (resGet.error() || compareRecordsSets(grouped, resGet.records(), compKeysStrings) != 0
+		|| resGet.records().size() != grouped.size()) {
+		cout << "[ERROR] GET of the grouped records failed: " << (int)resGet.status() << endl;
+		return 6;
+	}
+	if (channel.stats().putBatches == 0) {
+		cout << "[ERROR] The batches of the chunks were not counted" << endl;
+		return 7;
+	}
+
+	cout << "Sending an invalid key in the middle of a slice..." << endl;
+	RecordsSet<std::string> invalid;
+	for (long int i = 0; i < cRecords; ++i) {
+		const Key::CidT cid = i == cRecords / 2 ? -1 : getTestCid(9);
+		invalid.append(Key(cid, i, 0, Timestamp::now()), std::to_string(i));
+	}
+	res = channel.put(invalid);
+	if (res.status() != result_t::INVALID_KEY) {
+		cout << "[ERROR] Expected INVALID_KEY, got " << (int)res.status() << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_get_stream_prefetch()
+{
+	constexpr long int cRecords = 5000;
+
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 5), i, 0, Timestamp::now()),
+			"value-" + std::to_string(i) + std::string(i % 61, '#'));
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	// A small buffer, so that the stream is delivered in many batches.
+	channel.setMemoryLimit(16UL * 1024);
+	RecordsSet<std::string> serial;
+	const ResponseAcq resSerial = channel.getStream(
+		keyMin, keyMax, [&serial](RecordsSet<std::string>& batch) {
+			for (const Record<std::string>& record : batch) {
+				serial.append(record);
+			}
+		});
+	if (resSerial.error() || serial.size() != records.size()) {
+		cout << "[ERROR] Serial stream failed: " << (int)resSerial.status() << endl;
+		return 3;
+	}
+
+	channel.setStreamPrefetch(3);
+	cout << "Streaming with a slow callback and 3 batches prefetched..." << endl;
+	RecordsSet<std::string> streamed;
+	std::size_t batches = 0;
+	const ResponseAcq resStream = channel.getStream(
+		keyMin, keyMax, [&streamed, &batches](RecordsSet<std::string>& batch) {
+			++batches;
+			std::this_thread::sleep_for(1ms);
+			for (const Record<std::string>& record : batch) {
+				streamed.append(record);
+			}
+		});
+	if (resStream.error() || batches < 4) {
+		cout << "[ERROR] Stream failed: " << (int)resStream.status() << ", " << batches
+			 << " batches received" << endl;
+		return 4;
+	}
+	if (streamed.size() != serial.size()
+		|| !std::equal(streamed.begin(), streamed.end(), serial.begin(),
+			[](const Record<std::string>& a, const Record<std::string>& b) {
+				return a.key == b.key && a.value == b.value;
+			})) {
+		cout << "[ERROR] The records differ from, or are ordered unlike, a serial stream" << endl;
+		return 5;
+	}
+
+	cout << "Streaming into columnar batches..." << endl;
+	std::size_t columnarRecords = 0;
+	const ResponseAcq resColumnar = channel.getStreamColumnar(
+		keyMin, keyMax, [&columnarRecords](ColumnarRecordsSet<std::string>& batch) {
+			columnarRecords += batch.size();
+		});
+	if (resColumnar.error() || columnarRecords != serial.size()) {
+		cout << "[ERROR] Columnar stream failed: " << (int)resColumnar.status() << ", "
+			 << columnarRecords << " records received" << endl;
+		return 6;
+	}
+
+	// The channel stays usable after a prefetched stream.
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+	const ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != serial.size()) {
+		cout << "[ERROR] GET after the stream failed: " << (int)resGet.status() << endl;
+		return 7;
+	}
+	return 0;
+}
+
+int test_channel_get_stream_cancel()
+{
+	constexpr long int cRecords = 5000;
+
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 5), i, 0, Timestamp::now()),
+			"value-" + std::to_string(i) + std::string(i % 61, '#'));
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	// A small buffer, so that the stream is delivered in many batches.
+	channel.setMemoryLimit(16UL * 1024);
+	std::size_t received = 0;
+	ResponseAcq resStream = channel.getStreamUntil(
+		keyMin, keyMax, [&received](RecordsSet<std::string>& batch) {
+			received += batch.size();
+			return true;
+		});
+	if (resStream.error() || received != records.size()) {
+		cout << "[ERROR] Full stream failed: " << (int)resStream.status() << ", " << received
+			 << " records received" << endl;
+		return 3;
+	}
+
+	cout << "Stopping a stream after 2 batches..." << endl;
+	std::size_t batches = 0;
+	resStream = channel.getStreamUntil(keyMin, keyMax,
+		[&batches](RecordsSet<std::string>& /*batch*/) { return ++batches < 2; });
+	if (resStream.status() != result_t::CANCELLED || batches != 2) {
+		cout << "[ERROR] Expected CANCELLED after 2 batches, got " << (int)resStream.status()
+			 << " after " << batches << endl;
+		return 4;
+	}
+	if (channel.connected()) {
+		cout << "[ERROR] The connection survived a stopped stream" << endl;
+		return 5;
+	}
+
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 6;
+	}
+	CancellationToken token;
+	token.cancel();
+	resStream = channel.getStreamUntil(
+		keyMin, keyMax, [](RecordsSet<std::string>& /*batch*/) { return true; }, token);
+	if (resStream.status() != result_t::CANCELLED || !channel.connected()) {
+		cout << "[ERROR] A cancelled token didn't stop the stream up front: "
+			 << (int)resStream.status() << endl;
+		return 7;
+	}
+
+	cout << "Cancelling a prefetched stream through a token..." << endl;
+	channel.setStreamPrefetch(2);
+	CancellationToken prefetchToken;
+	batches = 0;
+	resStream = channel.getStreamUntil(
+		keyMin, keyMax,
+		[&batches, &prefetchToken](RecordsSet<std::string>& /*batch*/) {
+			if (++batches == 3) {
+				prefetchToken.cancel();
+			}
+			return true;
+		},
+		prefetchToken);
+	if (resStream.status() != result_t::CANCELLED || batches != 3 || channel.connected()) {
+		cout << "[ERROR] Expected CANCELLED after 3 batches, got " << (int)resStream.status()
+			 << " after " << batches << endl;
+		return 8;
+	}
+
+	// Stopping on the last batch completes the request and keeps the
+	// connection.
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 9;
+	}
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+	for (const std::size_t prefetch : {0UL, 2UL}) {
+		channel.setStreamPrefetch(prefetch);
+		resStream = channel.getStreamUntil(
+			keyMin, keyMax, [](RecordsSet<std::string>& /*batch*/) { return false; });
+		if (resStream.error() || !channel.connected()) {
+			cout << "[ERROR] Stopping on the last batch failed: " << (int)resStream.status()
+				 << endl;
+			return 10;
+		}
+	}
+	return 0;
+}
+
+int test_channel_stream_operators()
+{
+	constexpr long int cRecords = 3000;
+	constexpr Key::CapT cSecond = 1000000000;
+	constexpr Key::CapT cMinute = 60 * cSecond;
+
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 3), i % 4, 0, keyMin.cap + i * cSecond),
+			static_cast<float>(i % 101) - 50.0F);
+	}
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	const ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	// The reference aggregates, computed from the materialized records.
+	const auto keep = [](const Key& key) { return key.cid != getTestCid(2); };
+	std::map<BucketKey, Aggregate> reference;
+	for (const Record<float>& record : resGet.records()) {
+		if (keep(record.key)) {
+			BucketKey bucket{};
+			bucket.mid = record.key.mid;
+			bucket.cap = record.key.cap - (record.key.cap % cMinute + cMinute) % cMinute;
+			reference[bucket].add(record.value);
+		}
+	}
+
+	cout << "Aggregating per MID and minute while receiving..." << endl;
+	BucketReducer reducer(projectTrivial<float>(), cMinute, GROUP_BY_MID);
+	ResponseAcq resView = channel.getView(keyMin, keyMax, filterKeys(keep, std::ref(reducer)));
+	if (resView.error()) {
+		cout << "[ERROR] View failed: " << (int)resView.status() << endl;
+		return 4;
+	}
+	if (reducer.buckets().size() != reference.size() || reducer.skipped() != 0) {
+		cout << "[ERROR] " << reducer.buckets().size() << " buckets instead of "
+			 << reference.size() << endl;
+		return 5;
+	}
+	for (const std::pair<const BucketKey, Aggregate>& bucket : reducer.buckets()) {
+		const auto found = reference.find(bucket.first);
+		if (found == reference.end() || found->second.count != bucket.second.count
+			|| found->second.min != bucket.second.min || found->second.max != bucket.second.max
+			|| found->second.sum != bucket.second.sum) {
+			cout << "[ERROR] The aggregates of MID " << bucket.first.mid << " at CAP "
+				 << bucket.first.cap << " differ" << endl;
+			return 6;
+		}
+	}
+
+	cout << "Merging the aggregates of two halves, projected by a payload type..." << endl;
+	const std::shared_ptr<PayloadType<float>> payloadType = std::make_shared<FloatPayload>();
+	const Projection doubled
+		= projectPayload(payloadType, [](const float value) { return 2.0 * value; });
+	BucketReducer total(doubled);
+	// The key-intervals are boxes, hence the halves split CAP only.
+	Key lowerMax = keyMax;
+	lowerMax.cap = keyMin.cap + cRecords / 2 * cSecond;
+	Key upperMin = keyMin;
+	upperMin.cap = lowerMax.cap;
+	for (const KeyRange& range : {KeyRange{keyMin, lowerMax}, KeyRange{upperMin, keyMax}}) {
+		BucketReducer part(doubled);
+		resView = channel.getView(range.keyMin, range.keyMax, std::ref(part));
+		if (resView.error()) {
+			cout << "[ERROR] View failed: " << (int)resView.status() << endl;
+			return 7;
+		}
+		total.merge(part);
+	}
+	Aggregate all{};
+	for (const Record<float>& record : resGet.records()) {
+		all.add(2.0 * record.value);
+	}
+	std::uint64_t count = 0;
+	for (const std::pair<const BucketKey, Aggregate>& bucket : total.buckets()) {
+		count += bucket.second.count;
+	}
+	// Without CAP buckets, there is one bucket per MID.
+	if (total.buckets().size() != 4 || count != all.count) {
+		cout << "[ERROR] " << total.buckets().size() << " buckets of " << count
+			 << " records in total" << endl;
+		return 8;
+	}
+	Aggregate merged{};
+	for (const std::pair<const BucketKey, Aggregate>& bucket : total.buckets()) {
+		merged.merge(bucket.second);
+	}
+	if (merged.min != all.min || merged.max != all.max || merged.sum != all.sum
+		|| merged.mean() != all.mean()) {
+		cout << "[ERROR] The merged aggregates differ" << endl;
+		return 9;
+	}
+	return 0;
+}
+
+int test_channel_get_spilled()
+{
+	constexpr long int cRecords = 4000;
+
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(i % 3), i, 0, Timestamp::now()),
+			"value-" + std::to_string(i) + std::string(i % 211, '~'));
+	}
+	// Larger than a write buffer, so written past it.
+	records.append(Key(getTestCid(4), 0, 0, Timestamp::now()), std::string(3UL << 20, 'L'));
+	res = channel.put(records);
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	const ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+
+	// The buffer holds the largest record, but not the response.
+	channel.setMemoryLimit(4UL * 1024 * 1024);
+	cout << "Spilling a GET response to disk..." << endl;
+	SpilledRecordsSet spilled;
+	ResponseAcq resSpilled = channel.getSpilled(keyMin, keyMax, spilled);
+	if (resSpilled.error() || !spilled.sealed() || spilled.size() != records.size()) {
+		cout << "[ERROR] Spilled GET failed: " << (int)resSpilled.status() << ", "
+			 << spilled.size() << " records" << endl;
+		return 4;
+	}
+	if (resSpilled.acq() < resGet.acq()) {
+		cout << "[ERROR] The ACQ went back" << endl;
+		return 5;
+	}
+
+	// Randomly accessed, in reverse, and decoded lazily.
+	SpilledRecordsSet moved = std::move(spilled);
+	StringPayload payloadType;
+	const std::vector<Record<std::string>> received(
+		resGet.records().begin(), resGet.records().end());
+	for (std::size_t i = moved.size(); i-- > 0;) {
+		const Record<std::string>& expected = received[i];
+		std::string value;
+		if (!(moved.key(i) == expected.key) || moved.payloadSize(i) != expected.value.size()
+			|| !moved.decode(i, payloadType, value) || value != expected.value) {
+			cout << "[ERROR] Record " << i << " differs" << endl;
+			return 6;
+		}
+	}
+
+	// The files are reused after clear().
+	moved.clear();
+	Key keyMaxCid = keyMax;
+	keyMaxCid.cid = getTestCid(1);
+	resSpilled = channel.getSpilled(keyMin, keyMaxCid, moved);
+	if (resSpilled.error() || moved.size() != static_cast<std::size_t>(cRecords + 2) / 3) {
+		cout << "[ERROR] Spilled GET after clear() failed: " << (int)resSpilled.status()
+			 << ", " << moved.size() << " records" << endl;
+		return 7;
+	}
+
+	cout << "Spilling to a missing directory..." << endl;
+	SpilledRecordsSet unwritable("/nonexistent-tstorage-spill-dir");
+	resSpilled = channel.getSpilled(keyMin, keyMax, unwritable);
+	if (resSpilled.status() != result_t::SPILL_ERROR || channel.connected()) {
+		cout << "[ERROR] Expected SPILL_ERROR, got " << (int)resSpilled.status() << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_channel_replicate()
+{
+	constexpr long int cRecords = 500;
+
+	Channel<std::string> source(globals::addr, globals::port, std::make_unique<StringPayload>());
+	// A payload type of its own, as no payload is deserialized.
+	Channel<float> destination(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	source.setTimeout(3000ms);
+	destination.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	Response res = source.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = destination.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < cRecords; ++i) {
+		records.append(Key(getTestCid(1), i, i % 7, keyMin.cap + i, 1000 + i),
+			"payload-" + std::to_string(i) + std::string(i % 13, '='));
+	}
+	res = source.puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	// The test server serves both channels, so the copies are stored next to
+	// the originals.
+	cout << "Replicating " << cRecords << " records..." << endl;
+	const ResponseAcq resReplicate = replicate(source, destination, keyMin, keyMax);
+	if (resReplicate.error()) {
+		cout << "[ERROR] Replication failed: " << (int)resReplicate.status() << endl;
+		return 3;
+	}
+
+	const ResponseGet<std::string> resGet = source.get(keyMin, keyMax);
+	if (resGet.error() || resGet.records().size() != 2 * records.size()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << ", "
+			 << resGet.records().size() << " records" << endl;
+		return 4;
+	}
+	RecordsSet<std::string> originals;
+	RecordsSet<std::string> copies;
+	long int i = 0;
+	for (const Record<std::string>& record : resGet.records()) {
+		(i++ < cRecords ? originals : copies).append(record);
+	}
+	// The ACQ timestamps are preserved too.
+	if (compareRecordsSets(records, originals, compKeysStrings) != 0
+		|| compareRecordsSets(records, copies, compKeysStrings) != 0) {
+		cout << "[ERROR] The copies differ from the originals" << endl;
+		return 5;
+	}
+
+	cout << "Replicating to a closed channel..." << endl;
+	(void)destination.close();
+	const ResponseAcq resClosed = replicate(source, destination, keyMin, keyMax);
+	if (resClosed.status() != result_t::NOT_CONNECTED || source.connected()) {
+		cout << "[ERROR] Expected NOT_CONNECTED with the source aborted, got "
+			 << (int)resClosed.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_put_raw()
+{
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4UL * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Preparing serialized payloads..." << endl;
+	// The payloads of every 100th record are sent from the user's memory.
+	std::vector<std::string> payloads;
+	RecordsSet<std::string> records;
+	for (long int i = 0; i < 1000; ++i) {
+		payloads.push_back(i % 100 == 0 ? std::string(64UL * 1024, 'a' + i % 26)
+										: "encoded-" + std::to_string(i));
+		records.append(Key(getTestCid(1 + i % 2), 22, i, keyMin.cap + i, i + 1), payloads.back());
+	}
+	std::vector<RawRecord> putRecords;
+	std::vector<RawRecord> putaRecords;
+	for (const Record<std::string>& record : records) {
+		const RawRecord raw{record.key, record.value.data(), record.value.size()};
+		(record.key.cid == getTestCid(1) ? putRecords : putaRecords).push_back(raw);
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending raw records over PUT..." << endl;
+	Response resPut = channel.putRaw(putRecords.data(), putRecords.data() + putRecords.size());
+	if (resPut.error()) {
+		cout << "[ERROR] PUT failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+	cout << "Sending raw records over PUTA..." << endl;
+	resPut = channel.putaRaw(putaRecords.cbegin(), putaRecords.cend());
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+	const ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStrings) != 0) {
+		return 5;
+	}
+
+	cout << "Sending a raw record with a maximal key..." << endl;
+	const RawRecord invalid{Key(getTestCid(1), 22, 0, Key::cCapMax, 1), payloads.front().data(), payloads.front().size()};
+	const RawRecord invalidRecords[] = {putRecords.front(), invalid};
+	resPut = channel.putaRaw(std::begin(invalidRecords), std::end(invalidRecords));
+	if (resPut.status() != result_t::INVALID_KEY) {
+		cout << "[ERROR] Expected INVALID_KEY, got " << (int)resPut.status() << endl;
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_put_bulk_key_validation()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(4UL * 1024);
+	channel.setPutBulkKeyValidation(true);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	RecordsSet<float> records;
+	for (long int i = 0; i < 1000; ++i) {
+		records.append(Key(getTestCid(1 + i % 3), 22, i, keyMin.cap + i, i + 1),
+			static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+
+	cout << "Sending records validated in bulk..." << endl;
+	Response resPut = channel.puta(records);
+	if (resPut.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)resPut.status() << endl;
+		return 2;
+	}
+
+	// With an invalid key in the set, the records preceding it are stored,
+	// just like without bulk validation.
+	cout << "Sending records with an invalid key..." << endl;
+	RecordsSet<float> invalidRecords;
+	for (long int i = 0; i < 10; ++i) {
+		const Key key(getTestCid(4), i == 5 ? Key::cMidMax : 22, i, keyMin.cap + i, i + 1);
+		invalidRecords.append(key, static_cast<float>(i));
+		if (i < 5) {
+			records.append(key, static_cast<float>(i));
+		}
+	}
+	resPut = channel.puta(invalidRecords);
+	if (resPut.status() != result_t::INVALID_KEY) {
+		cout << "[ERROR] Expected INVALID_KEY, got " << (int)resPut.status() << endl;
+		return 3;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 4;
+	}
+	channel.setMemoryLimit(128UL * 1024);
+	const ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 5;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysFloats) != 0) {
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_packed_keys()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	cout << "Packing extreme keys..." << endl;
+	const std::vector<Key> extremes = {cKeyMin,
+		cKeyMax,
+		Key(0, -1, -1, -1, -1),
+		Key(0, 0, 0, 0, 0),
+		Key(1, Key::cMidMin, Key::cMoidMax, Key::cCapMin, 1)};
+	for (const Key& a : extremes) {
+		if (PackedKey(a).unpack() != a) {
+			cout << "[ERROR] A key changed after packing and unpacking" << endl;
+			return 1;
+		}
+		for (const Key& b : extremes) {
+			if ((PackedKey(a) < PackedKey(b)) != (a < b)) {
+				cout << "[ERROR] Packed keys are ordered unlike the keys" << endl;
+				return 1;
+			}
+		}
+	}
+
+	std::mt19937 mt{7};
+	std::uniform_int_distribution<long int> rand(-50, 50);
+	RecordsSet<float> records;
+	for (long int i = 0; i < 2000; ++i) {
+		records.append(Key(getTestCid(1 + i % 2), rand(mt), static_cast<Key::MoidT>(rand(mt)),
+						   keyMin.cap + rand(mt) + 50, 1000 + rand(mt) + 50),
+			static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 2;
+	}
+	res = channel.puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 3;
+	}
+	ResponseGet<float> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 4;
+	}
+
+	cout << "Radix-sorting the response..." << endl;
+	RecordsSet<float> sorted = resGet.records();
+	sorted.sortByKey();
+	std::vector<Record<float>> expected(resGet.records().begin(), resGet.records().end());
+	std::stable_sort(expected.begin(),
+		expected.end(),
+		[](const Record<float>& a, const Record<float>& b) { return a.key < b.key; });
+	if (!std::equal(expected.begin(),
+			expected.end(),
+			sorted.begin(),
+			sorted.end(),
+			[](const Record<float>& a, const Record<float>& b) {
+				return a.key == b.key && a.value == b.value;
+			})) {
+		cout << "[ERROR] The records are sorted unlike with operator<" << endl;
+		return 5;
+	}
+
+	cout << "Searching and hashing the packed keys..." << endl;
+	std::unordered_set<PackedKey> unique;
+	for (const Record<float>& record : sorted) {
+		if (sorted.lowerBound(record.key)->key != record.key) {
+			cout << "[ERROR] lowerBound() missed a key" << endl;
+			return 6;
+		}
+		unique.insert(PackedKey(record.key));
+	}
+	const std::set<Key> uniqueKeys = [&sorted]() {
+		std::set<Key> keys;
+		for (const Record<float>& record : sorted) {
+			keys.insert(record.key);
+		}
+		return keys;
+	}();
+	if (unique.size() != uniqueKeys.size() || sorted.lowerBound(cKeyMax) != sorted.end()) {
+		cout << "[ERROR] Unexpected amount of distinct packed keys" << endl;
+		return 7;
+	}
+	return 0;
+}
+
+namespace {
+
+/** @brief Checks the index against linear scans over the set. */
+int checkRecordsIndex(const RecordsSet<float>& records, const RecordsIndex<float>& index)
+{
+	if (index.size() != records.size()) {
+		cout << "[ERROR] " << index.size() << " records indexed out of " << records.size() << endl;
+		return 1;
+	}
+	for (Key::MidT mid = 0; mid < 11; ++mid) {
+		const SeriesKey series{getTestCid(1), mid, 3};
+		const Key::CapT capMin = getTestKeyMin().cap - 1000 + 100 * mid;
+		const Key::CapT capMax = capMin + 700;
+		std::vector<Key::CapT> expectedAll;
+		std::vector<Key::CapT> expectedWindow;
+		for (const Record<float>& record : records) {
+			if (record.key.cid == series.cid && record.key.mid == series.mid
+				&& record.key.moid == series.moid) {
+				expectedAll.push_back(record.key.cap);
+				if (capMin <= record.key.cap && record.key.cap < capMax) {
+					expectedWindow.push_back(record.key.cap);
+				}
+			}
+		}
+		std::sort(expectedAll.begin(), expectedAll.end());
+		std::sort(expectedWindow.begin(), expectedWindow.end());
+		std::vector<Key::CapT> all;
+		for (const std::size_t position : index.series(series)) {
+			all.push_back(records[position].key.cap);
+		}
+		std::vector<Key::CapT> window;
+		for (const std::size_t position : index.window(series, capMin, capMax)) {
+			window.push_back(records[position].key.cap);
+		}
+		if (all != expectedAll || window != expectedWindow) {
+			cout << "[ERROR] Unexpected records of MID " << mid << ": " << all.size() << " and "
+				 << window.size() << " instead of " << expectedAll.size() << " and "
+				 << expectedWindow.size() << endl;
+			return 2;
+		}
+	}
+	return 0;
+}
+
+} /*namespace*/
+
+int test_channel_records_index()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+	Key keyFrom = keyMin;
+	keyFrom.cap -= 1000;
+
+	// Ten series of 300 records with shuffled CAPs.
+	std::mt19937 mt{11};
+	std::uniform_int_distribution<long int> rand(0, 2000);
+	RecordsSet<float> records;
+	for (long int i = 0; i < 3000; ++i) {
+		records.append(Key(getTestCid(1), i % 10, 3, keyMin.cap - 1000 + rand(mt), 1000 + i),
+			static_cast<float>(i));
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 1;
+	}
+	res = channel.puta(records);
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		return 2;
+	}
+
+	cout << "Indexing a GET response on 4 threads..." << endl;
+	const ResponseGet<float> resGet = channel.get(keyFrom, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 3;
+	}
+	const RecordsIndex<float> index(resGet.records(), 4);
+	if (index.seriesCount() != 10 || checkRecordsIndex(resGet.records(), index) != 0) {
+		return 4;
+	}
+
+	cout << "Indexing a GET stream batch by batch..." << endl;
+	channel.setMemoryLimit(8UL * 1024);
+	RecordsSet<float> streamed;
+	RecordsIndex<float> streamIndex(streamed);
+	std::size_t batches = 0;
+	res = channel.getStream(keyFrom, keyMax, [&](RecordsSet<float>& batch) {
+		for (const Record<float>& record : batch) {
+			streamed.append(record);
+		}
+		streamIndex.update();
+		++batches;
+	});
+	if (res.error() || batches < 2) {
+		cout << "[ERROR] GET stream failed: " << (int)res.status() << ", " << batches
+			 << " batches" << endl;
+		return 5;
+	}
+	if (checkRecordsIndex(streamed, streamIndex) != 0) {
+		return 6;
+	}
+	return 0;
+}
+
+int test_channel_put_spool()
+{
+	Channel<float> channel(globals::addr, globals::port, std::make_unique<FloatPayload>());
+	channel.setTimeout(3000ms);
+	channel.setMemoryLimit(16UL * 1024 * 1024);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+	Key keyFrom = keyMin;
+	keyFrom.cap -= 1000;
+
+	RecordsSet<float> first;
+	RecordsSet<float> second;
+	for (long int i = 0; i < 500; ++i) {
+		RecordsSet<float>& records = i < 250 ? first : second;
+		records.append(Key(getTestCid(2), i % 5, 1, keyMin.cap - 1000 + i, 0),
+			static_cast<float>(i));
+	}
+
+	char directory[] = "/tmp/tstorage-spool-XXXXXX";
+	if (::mkdtemp(directory) == nullptr) {
+		cout << "[ERROR] Cannot create the spool directory" << endl;
+		return 1;
+	}
+
+	cout << "Spooling records while the server is unreachable..." << endl;
+	{
+		PutSpool<float> spool(
+			globals::addr, 1, std::make_shared<FloatPayload>(), directory, 4096);
+		Response res = spool.open();
+		if (res.error()) {
+			cout << "[ERROR] Opening the spool failed: " << (int)res.status() << endl;
+			return 2;
+		}
+		res = spool.put(first);
+		if (res.error() || !spool.spooling()) {
+			cout << "[ERROR] The records were not spooled: " << (int)res.status() << endl;
+			return 3;
+		}
+		res = spool.put(second);
+		if (res.error() || spool.spooledBytes() != 500 * (36 + sizeof(float))) {
+			cout << "[ERROR] Unexpected spooled size: " << spool.spooledBytes() << endl;
+			return 4;
+		}
+		RecordsSet<float> invalid;
+		invalid.append(Key(-1, 0, 0, keyMin.cap, 0), 0.0f);
+		res = spool.put(invalid);
+		if (res.status() != result_t::INVALID_KEY) {
+			cout << "[ERROR] Expected INVALID_KEY, got " << (int)res.status() << endl;
+			return 5;
+		}
+	}
+
+	cout << "Replaying the records left in the spool..." << endl;
+	{
+		PutSpool<float> spool(
+			globals::addr, globals::port, std::make_shared<FloatPayload>(), directory, 4096);
+		spool.setReplayInterval(50ms);
+		Response res = spool.open();
+		if (res.error() || !spool.spooling()) {
+			cout << "[ERROR] The spooled records were not recovered: " << (int)res.status()
+				 << endl;
+			return 6;
+		}
+		for (int i = 0; i < 200 && spool.spooling(); ++i) {
+			std::this_thread::sleep_for(50ms);
+		}
+		if (spool.spooling() || spool.spooledBytes() != 0) {
+			cout << "[ERROR] The spool was not replayed: " << spool.spooledBytes() << " bytes left"
+				 << endl;
+			return 7;
+		}
+		RecordsSet<float> direct;
+		direct.append(Key(getTestCid(2), 0, 1, keyMin.cap - 1000 + 500, 0), 500.0f);
+		res = spool.put(direct);
+		if (res.error() || spool.spooling()) {
+			cout << "[ERROR] PUT after the replay failed: " << (int)res.status() << endl;
+			return 8;
+		}
+	}
+	if (::rmdir(directory) != 0) {
+		cout << "[ERROR] Segments were left in the spool directory" << endl;
+		return 9;
+	}
+
+	Response res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		return 10;
+	}
+	const ResponseGet<float> resGet = channel.get(keyFrom, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 11;
+	}
+	std::set<long int> caps;
+	for (const Record<float>& record : resGet.records()) {
+		if (record.key.cid == getTestCid(2)
+			&& record.value == static_cast<float>(record.key.cap - keyMin.cap + 1000)) {
+			caps.insert(record.key.cap - keyMin.cap + 1000);
+		}
+	}
+	if (caps.size() != 501 || *caps.begin() != 0 || *caps.rbegin() != 500) {
+		cout << "[ERROR] Expected 501 stored records, got " << caps.size() << endl;
+		return 12;
+	}
+	return 0;
+}
+
+int test_channel_put_from_file()
+{
+	Channel<std::string> channel(globals::addr, globals::port, std::make_unique<StringPayload>());
+	channel.setTimeout(3000ms);
+
+	const Key keyMin = getTestKeyMin();
+	const Key keyMax = getTestKeyMax();
+
+	// The bodies are serialized as by `put()` and `puta()`, after a prefix
+	// skipped with the offset.
+	const std::string prefix = "PREFIX";
+	std::string putBody;
+	std::string putaBody;
+	const auto append = [](std::string& body, const auto value) {
+		body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+	};
+	RecordsSet<std::string> records;
+	for (const bool puta : {false, true}) {
+		const Key::CidT cid = getTestCid(puta ? 2 : 1);
+		std::string& body = puta ? putaBody : putBody;
+		std::string batch;
+		for (long int i = 0; i < 300; ++i) {
+			const Key key(cid, 22, i % 3, keyMin.cap + i, i + 1);
+			const std::string payload = "file-" + std::to_string(i);
+			records.append(key, payload);
+			const std::size_t keySize = puta ? 28 : 20;
+			append(batch, static_cast<std::int32_t>(keySize + payload.size()));
+			append(batch, key.mid);
+			append(batch, key.moid);
+			append(batch, key.cap);
+			if (puta) {
+				append(batch, key.acq);
+			}
+			batch += payload;
+		}
+		append(body, cid);
+		append(body, static_cast<std::int32_t>(batch.size()));
+		body += batch;
+	}
+
+	char path[] = "/tmp/tstorage-put-XXXXXX";
+	const int fd = ::mkstemp(path);
+	if (fd == -1) {
+		cout << "[ERROR] Cannot create the file" << endl;
+		return 1;
+	}
+	(void)::unlink(path);
+	const std::string contents = prefix + putBody + putaBody;
+	if (::write(fd, contents.data(), contents.size()) != static_cast<ssize_t>(contents.size())) {
+		cout << "[ERROR] Cannot write the file" << endl;
+		::close(fd);
+		return 2;
+	}
+
+	Response res = channel.connect();
+	cout << "Connecting..." << endl;
+	if (res.error()) {
+		cout << "[ERROR] Connect failed: " << (int)res.status() << endl;
+		::close(fd);
+		return 3;
+	}
+	cout << "Sending the records from the file over PUT and PUTA..." << endl;
+	res = channel.putFromFile(fd, prefix.size(), putBody.size());
+	if (res.error()) {
+		cout << "[ERROR] PUT failed: " << (int)res.status() << endl;
+		::close(fd);
+		return 4;
+	}
+	res = channel.putaFromFile(fd, prefix.size() + putBody.size(), putaBody.size());
+	if (res.error()) {
+		cout << "[ERROR] PUTA failed: " << (int)res.status() << endl;
+		::close(fd);
+		return 5;
+	}
+
+	cout << "Sending more bytes than the file holds..." << endl;
+	res = channel.putaFromFile(fd, prefix.size() + putBody.size(), putaBody.size() + 100);
+	::close(fd);
+	if (res.status() != result_t::FILE_ERROR || channel.connected()) {
+		cout << "[ERROR] Expected FILE_ERROR and a dropped connection, got "
+			 << (int)res.status() << endl;
+		return 6;
+	}
+
+	cout << "Fetching all records from the database..." << endl;
+	res = channel.connect();
+	if (res.error()) {
+		cout << "[ERROR] Reconnect failed: " << (int)res.status() << endl;
+		return 7;
+	}
+	const ResponseGet<std::string> resGet = channel.get(keyMin, keyMax);
+	if (resGet.error()) {
+		cout << "[ERROR] GET failed: " << (int)resGet.status() << endl;
+		return 8;
+	}
+	if (compareRecordsSets(records, resGet.records(), compKeysStrings) != 0) {
+		return 9;
+	}
+	return 0;
+}
+
 } /*namespace tstorage*/
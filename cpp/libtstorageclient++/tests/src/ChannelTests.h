@@ -24,6 +24,86 @@ int test_channel_get_with_memory_limit();
 int test_channel_get_stream();
 int test_channel_put_bad_cid();
 int test_channel_put_key_out_of_range();
+int test_channel_put_pipelined();
+int test_channel_put_vectored();
+int test_channel_get_view();
+int test_channel_get_into();
+int test_channel_count_range();
+int test_channel_open_stream();
+int test_channel_merged_stream();
+int test_channel_pool();
+int test_channel_pool_get_parallel();
+int test_channel_pool_put_parallel();
+int test_channel_pool_window_scanner();
+int test_channel_pool_coalescing();
+int test_channel_pool_lanes();
+int test_channel_async();
+int test_channel_get_batch();
+int test_channel_get_coalesced();
+int test_channel_get_columnar();
+int test_channel_get_stream_reuse();
+int test_channel_trivial_payload();
+int test_channel_put_generator();
+int test_channel_put_stream();
+int test_channel_put_cid_grouping();
+int test_channel_put_batch_coalescing();
+int test_channel_put_size_hint();
+int test_channel_get_buffer_growth();
+int test_channel_get_chunked_payload();
+int test_channel_skip_oversized_records();
+int test_channel_put_chunked_payload();
+int test_channel_receive_stats();
+int test_channel_io_uring();
+int test_channel_retry();
+int test_channel_get_stream_resumable();
+int test_channel_deadline();
+int test_channel_signal_restart();
+int test_channel_async_server_error();
+int test_channel_put_aggregator();
+int test_channel_put_aggregator_close();
+int test_channel_get_arena();
+int test_channel_get_blob();
+int test_channel_get_mixed();
+int test_channel_get_lazy();
+int test_channel_get_stream_arrow();
+int test_channel_get_stream_batching();
+int test_channel_split_buffers();
+int test_channel_buffer_release();
+int test_channel_memory_budget();
+int test_channel_buffer_auto_tuning();
+int test_channel_put_flow_control();
+int test_channel_put_dedup_filter();
+int test_channel_put_dedup_vectored();
+int test_channel_caching_get();
+int test_channel_negative_cache();
+int test_channel_snapshot();
+int test_channel_tail();
+int test_channel_compressed_payload();
+int test_channel_interned_payload();
+int test_channel_view_records_set();
+int test_channel_series_compressor();
+int test_channel_sample_packer();
+int test_channel_get_series();
+int test_channel_numeric_payload_types();
+int test_channel_stats();
+int test_channel_allocation_stats();
+int test_channel_get_presized();
+int test_channel_tracer();
+int test_channel_cluster();
+int test_channel_replicas();
+int test_channel_get_parallel_decode();
+int test_channel_put_parallel_encode();
+int test_channel_get_stream_prefetch();
+int test_channel_get_stream_cancel();
+int test_channel_stream_operators();
+int test_channel_get_spilled();
+int test_channel_replicate();
+int test_channel_put_raw();
+int test_channel_put_bulk_key_validation();
+int test_channel_packed_keys();
+int test_channel_records_index();
+int test_channel_put_spool();
+int test_channel_put_from_file();
 
 } /*namespace tstorage*/
 
@@ -7,6 +7,7 @@
 #include "SocketTests.h"
 
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include <chrono>
@@ -16,11 +17,13 @@
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include <tstorageclient++/DataTypes.h>
 
 #include "Buffer.h"
 #include "Socket.h"
+#include "TlsSession.h"
 
 namespace globals {
 
@@ -430,4 +433,251 @@ int test_socket_recv_timeout()
 	return 0;
 }
 
+int test_socket_connect_dual_stack()
+{
+	using Clock = std::chrono::steady_clock;
+	result_t res = result_t::OK;
+	{
+		// Nothing listens on the IPv6 loopback.
+		Socket socket("::1", globals::port);
+		const Clock::time_point start = Clock::now();
+		res = socket.connect();
+		const auto elapsed =
+			std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+		cout << "Connect over IPv6: result code " << (int)res << " after " << elapsed.count()
+			 << "ms" << endl;
+		if (res != result_t::CONNREFUSED && res != result_t::CONNERROR) {
+			cout << "[ERROR] Unexpected result code" << endl;
+			return 1;
+		}
+		if (elapsed > std::chrono::milliseconds(2000)) {
+			cout << "[ERROR] Failing to connect took too long" << endl;
+			return 2;
+		}
+	}
+
+	Socket socket(globals::addr, globals::port);
+	CALLANDLOG(socket.connect(), "Connect", 3)
+	CALLANDLOG(socket.close(), "Close", 4)
+	CALLANDLOG(socket.connect(), "Connect with the cached address", 5)
+	CALLANDLOG(socket.close(), "Final close", 6)
+	return 0;
+}
+
+int test_socket_connect_timeout()
+{
+	using Clock = std::chrono::steady_clock;
+	result_t res = result_t::OK;
+	{
+		// An address reserved for documentation, never routed.
+		Socket socket("192.0.2.1", globals::port);
+		socket.setConnectTimeoutMs(200);
+		const Clock::time_point start = Clock::now();
+		res = socket.connect();
+		const auto elapsed =
+			std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start);
+		cout << "Connect to an unreachable address: result code " << (int)res << " after "
+			 << elapsed.count() << "ms" << endl;
+		// Without a network route, the connection fails before timing out.
+		if (res == result_t::OK) {
+			cout << "[ERROR] Connected to an unreachable address" << endl;
+			return 1;
+		}
+		if (elapsed > std::chrono::milliseconds(1000)) {
+			cout << "[ERROR] The connect timeout was not respected" << endl;
+			return 2;
+		}
+	}
+
+	Socket socket(globals::addr, globals::port);
+	socket.setConnectTimeoutMs(200);
+	CALLANDLOG(socket.setTimeoutMs(1), "Set a short IO timeout", 3)
+	CALLANDLOG(socket.connect(), "Connect", 4)
+	CALLANDLOG(socket.close(), "Close", 5)
+	return 0;
+}
+
+int test_socket_options()
+{
+	Socket socket(globals::addr, globals::port);
+	SocketOptions options;
+	options.keepAlive = true;
+	// Above the limit of TCP_KEEPIDLE.
+	options.keepAliveIdleS = 1'000'000;
+	socket.setOptions(options);
+	result_t res = socket.connect();
+	if (res != result_t::SETOPT_ERROR) {
+		cout << "[ERROR] Connect with an invalid option: result code " << (int)res << endl;
+		return 1;
+	}
+	cout << "Connect with an invalid option failed..." << endl;
+
+	options.keepAliveIdleS = 60;
+	options.keepAliveIntervalS = 10;
+	options.keepAliveCount = 3;
+	options.sendBufferBytes = 256 * 1024;
+	options.recvBufferBytes = 256 * 1024;
+	options.quickAck = true;
+	options.priority = 1;
+	options.dscp = 46;
+	socket.setOptions(options);
+
+	const char message[] = "Hello!";
+	char reply[sizeof(message)] = {};
+	std::size_t amount = 0;
+	CALLANDLOG(socket.connect(), "Connect", 2)
+	CALLANDLOG(socket.send(message, sizeof(message) - 1, amount), "Send", 3)
+	CALLANDLOG(socket.recvExactly(reply, sizeof(message) - 1, amount), "Recv", 4)
+	if (std::string(reply) != message) {
+		cout << "[ERROR] Unexpected reply '" << reply << "'" << endl;
+		return 5;
+	}
+	if (socket.stats().sockOptCalls == 0) {
+		cout << "[ERROR] Quick ACKs were not restored" << endl;
+		return 6;
+	}
+	CALLANDLOG(socket.close(), "Close", 7)
+	return 0;
+}
+
+int test_socket_unix()
+{
+	const std::string path = "/tmp/tstorage-test-" + std::to_string(::getpid()) + ".sock";
+	(void)::unlink(path.c_str());
+	// clang-format off
+	struct sockaddr_un addr{};
+	// clang-format on
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+	const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener == -1
+		|| ::bind(listener, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) != 0
+		|| ::listen(listener, 1) != 0) {
+		cout << "[ERROR] Cannot listen on " << path << ": " << strerror(errno) << endl;
+		return 1;
+	}
+	std::thread echo([listener]() {
+		const int conn = ::accept(listener, nullptr, nullptr);
+		if (conn == -1) {
+			return;
+		}
+		char message[64] = {};
+		const ssize_t amount = ::recv(conn, message, sizeof(message), 0);
+		if (amount > 0) {
+			(void)::send(conn, message, static_cast<std::size_t>(amount), 0);
+		}
+		::close(conn);
+	});
+
+	result_t res = result_t::OK;
+	{
+		Socket socket("unix:", 0);
+		res = socket.connect();
+		if (res != result_t::BAD_ADDRESS) {
+			cout << "[ERROR] Connect to an empty path: result code " << (int)res << endl;
+			return 2;
+		}
+	}
+
+	Socket socket("unix:" + path, 0);
+	// The TCP and IP options are left out for Unix domain sockets.
+	SocketOptions options;
+	options.keepAlive = true;
+	options.keepAliveIdleS = 60;
+	options.quickAck = true;
+	options.dscp = 46;
+	socket.setOptions(options);
+
+	const char message[] = "Hello!";
+	char reply[sizeof(message)] = {};
+	std::size_t amount = 0;
+	CALLANDLOG(socket.connect(), "Connect over a Unix domain socket", 3)
+	CALLANDLOG(socket.send(message, sizeof(message) - 1, amount), "Send", 4)
+	CALLANDLOG(socket.recvExactly(reply, sizeof(message) - 1, amount), "Recv", 5)
+	CALLANDLOG(socket.close(), "Close", 6)
+	echo.join();
+	::close(listener);
+	(void)::unlink(path.c_str());
+	if (std::string(reply) != message) {
+		cout << "[ERROR] Unexpected reply '" << reply << "'" << endl;
+		return 7;
+	}
+	if (socket.stats().sockOptCalls != 0) {
+		cout << "[ERROR] Quick ACKs were set on a Unix domain socket" << endl;
+		return 8;
+	}
+	return 0;
+}
+
+int test_socket_tls()
+{
+	const std::string path = "/tmp/tstorage-test-tls-" + std::to_string(::getpid()) + ".sock";
+	(void)::unlink(path.c_str());
+	// clang-format off
+	struct sockaddr_un addr{};
+	// clang-format on
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+	const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener == -1
+		|| ::bind(listener, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) != 0
+		|| ::listen(listener, 2) != 0) {
+		cout << "[ERROR] Cannot listen on " << path << ": " << strerror(errno) << endl;
+		return 1;
+	}
+	// The server speaks no TLS: it hangs up on the first connection and
+	// echoes a message over the second one.
+	std::thread server([listener]() {
+		const int first = ::accept(listener, nullptr, nullptr);
+		if (first == -1) {
+			return;
+		}
+		::close(first);
+		const int conn = ::accept(listener, nullptr, nullptr);
+		if (conn == -1) {
+			return;
+		}
+		char message[64] = {};
+		const ssize_t amount = ::recv(conn, message, sizeof(message), 0);
+		if (amount > 0) {
+			(void)::send(conn, message, static_cast<std::size_t>(amount), 0);
+		}
+		::close(conn);
+	});
+
+	Socket socket("unix:" + path, 0);
+	TlsOptions tls;
+	tls.enabled = true;
+	socket.setTls(tls);
+	result_t res = socket.connect();
+	cout << "Connect with TLS " << (TlsSession::built() ? "built" : "not built")
+		 << ": result code " << (int)res << endl;
+	if (res == result_t::OK || socket.tlsActive() || socket.connectionEstablished()) {
+		cout << "[ERROR] A TLS handshake with a plain server succeeded" << endl;
+		return 2;
+	}
+	if (!TlsSession::built() && res != result_t::TLS_ERROR) {
+		cout << "[ERROR] Expected TLS_ERROR without TLS built" << endl;
+		return 3;
+	}
+
+	tls.enabled = false;
+	socket.setTls(tls);
+	const char message[] = "Hello!";
+	char reply[sizeof(message)] = {};
+	std::size_t amount = 0;
+	CALLANDLOG(socket.connect(), "Connect without TLS", 4)
+	CALLANDLOG(socket.send(message, sizeof(message) - 1, amount), "Send", 5)
+	CALLANDLOG(socket.recvExactly(reply, sizeof(message) - 1, amount), "Recv", 6)
+	CALLANDLOG(socket.close(), "Close", 7)
+	server.join();
+	::close(listener);
+	(void)::unlink(path.c_str());
+	if (std::string(reply) != message) {
+		cout << "[ERROR] Unexpected reply '" << reply << "'" << endl;
+		return 8;
+	}
+	return 0;
+}
+
 } /*namespace tstorage*/
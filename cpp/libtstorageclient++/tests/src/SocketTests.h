@@ -20,6 +20,11 @@ int test_socket_shutdown_recv();
 int test_socket_dialog();
 int test_socket_send_timeout();
 int test_socket_recv_timeout();
+int test_socket_connect_dual_stack();
+int test_socket_connect_timeout();
+int test_socket_options();
+int test_socket_unix();
+int test_socket_tls();
 
 } /*namespace tstorage*/
 
@@ -26,4 +26,74 @@ bool StringPayload::fromBytes(
 	return true;
 }
 
+bool StringViewPayload::toView(
+	const std::string& val, const void*& oData, std::size_t& oSize)
+{
+	oData = val.data();
+	oSize = val.length();
+	return true;
+}
+
+std::size_t StringSizeHintPayload::toBytes(
+	const std::string& val, void* outputBuffer, std::size_t bufferSize)
+{
+	++toBytesCalls;
+	return StringPayload::toBytes(val, outputBuffer, bufferSize);
+}
+
+bool StringSizeHintPayload::sizeHint(const std::string& val, std::size_t& oSize)
+{
+	oSize = val.length();
+	return true;
+}
+
+bool StringChunkedPayload::chunked() const
+{
+	return true;
+}
+
+bool StringChunkedPayload::beginChunked(std::string& oVar, std::size_t payloadSize)
+{
+	oVar.reserve(payloadSize);
+	return true;
+}
+
+bool StringChunkedPayload::appendChunk(
+	std::string& oVar, const void* chunk, std::size_t chunkSize)
+{
+	++chunks;
+	oVar.append(static_cast<const char*>(chunk), chunkSize);
+	return true;
+}
+
+bool StringChunkedPayload::finishChunked(std::string& oVar)
+{
+	(void)oVar;
+	++chunkedPayloads;
+	return true;
+}
+
+void StringChunkedPayload::toChunk(
+	const std::string& val, std::size_t offset, void* outputBuffer, std::size_t chunkSize)
+{
+	++sentChunks;
+	memcpy(outputBuffer, val.data() + offset, chunkSize);
+}
+
+std::size_t ArenaStringPayload::toBytes(
+	const ArenaString& val, void* outputBuffer, std::size_t bufferSize)
+{
+	if (bufferSize >= val.length()) {
+		memcpy(outputBuffer, val.c_str(), val.length());
+	}
+	return val.length();
+}
+
+bool ArenaStringPayload::fromBytes(
+	ArenaString& oVar, const void* payloadBuffer, std::size_t payloadSize)
+{
+	oVar.assign(static_cast<const char*>(payloadBuffer), payloadSize);
+	return true;
+}
+
 } /*namespace tstorage*/
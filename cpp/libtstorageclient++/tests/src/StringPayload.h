@@ -9,6 +9,7 @@
 
 #include <string>
 
+#include <tstorageclient++/Arena.h>
 #include <tstorageclient++/PayloadType.h>
 
 namespace tstorage {
@@ -22,6 +23,48 @@ public:
 		std::string& oVar, const void* payloadBuffer, std::size_t payloadSize) override;
 };
 
+class StringViewPayload : public StringPayload
+{
+public:
+	bool toView(const std::string& val, const void*& oData, std::size_t& oSize) override;
+};
+
+class StringSizeHintPayload : public StringPayload
+{
+public:
+	std::size_t toBytes(
+		const std::string& val, void* outputBuffer, std::size_t bufferSize) override;
+	bool sizeHint(const std::string& val, std::size_t& oSize) override;
+
+	std::size_t toBytesCalls = 0;
+};
+
+class StringChunkedPayload : public StringPayload
+{
+public:
+	bool chunked() const override;
+	bool beginChunked(std::string& oVar, std::size_t payloadSize) override;
+	bool appendChunk(std::string& oVar, const void* chunk, std::size_t chunkSize) override;
+	bool finishChunked(std::string& oVar) override;
+	void toChunk(const std::string& val,
+		std::size_t offset,
+		void* outputBuffer,
+		std::size_t chunkSize) override;
+
+	std::size_t chunks = 0;
+	std::size_t sentChunks = 0;
+	std::size_t chunkedPayloads = 0;
+};
+
+class ArenaStringPayload : public PayloadType<ArenaString>
+{
+public:
+	std::size_t toBytes(
+		const ArenaString& val, void* outputBuffer, std::size_t bufferSize) override;
+	bool fromBytes(
+		ArenaString& oVar, const void* payloadBuffer, std::size_t payloadSize) override;
+};
+
 } /*namespace tstorage*/
 
 #endif
@@ -15,6 +15,7 @@
 #include "ChannelTests.h"
 #include "SerializerTests.h"
 #include "SocketTests.h"
+#include "TimestampTests.h"
 
 using namespace tstorage;
 using std::cout;
@@ -32,15 +33,26 @@ const std::map<std::string, int(*)()> testMap = {
 	{"test_socket_dialog", test_socket_dialog},
 	{"test_socket_send_timeout", test_socket_send_timeout},
 	{"test_socket_recv_timeout", test_socket_recv_timeout},
+	{"test_socket_connect_dual_stack", test_socket_connect_dual_stack},
+	{"test_socket_connect_timeout", test_socket_connect_timeout},
+	{"test_socket_options", test_socket_options},
+	{"test_socket_unix", test_socket_unix},
+	{"test_socket_tls", test_socket_tls},
 
 	{"test_buffer_create", test_buffer_create},
 	{"test_buffer_heads", test_buffer_heads},
 	{"test_buffer_reserve", test_buffer_reserve},
+	{"test_buffer_resize", test_buffer_resize},
+	{"test_buffer_mirrored", test_buffer_mirrored},
+	{"test_buffer_allocation", test_buffer_allocation},
 
 	{"test_serializer_put", test_serializer_put},
 	{"test_serializer_get", test_serializer_get},
 	{"test_serializer_buffer", test_serializer_buffer},
 
+	{"test_timestamp_unix_nanos", test_timestamp_unix_nanos},
+	{"test_timestamp_coarse_now", test_timestamp_coarse_now},
+
 	{"test_channel_connect", test_channel_connect},
 	{"test_channel_getacq", test_channel_getacq},
 	{"test_channel_get_empty", test_channel_get_empty},
@@ -56,6 +68,86 @@ const std::map<std::string, int(*)()> testMap = {
 	{"test_channel_get_stream", test_channel_get_stream},
 	{"test_channel_put_bad_cid", test_channel_put_bad_cid},
 	{"test_channel_put_key_out_of_range", test_channel_put_key_out_of_range},
+	{"test_channel_put_pipelined", test_channel_put_pipelined},
+	{"test_channel_put_vectored", test_channel_put_vectored},
+	{"test_channel_get_view", test_channel_get_view},
+	{"test_channel_get_into", test_channel_get_into},
+	{"test_channel_count_range", test_channel_count_range},
+	{"test_channel_open_stream", test_channel_open_stream},
+	{"test_channel_merged_stream", test_channel_merged_stream},
+	{"test_channel_pool", test_channel_pool},
+	{"test_channel_pool_get_parallel", test_channel_pool_get_parallel},
+	{"test_channel_pool_put_parallel", test_channel_pool_put_parallel},
+	{"test_channel_pool_window_scanner", test_channel_pool_window_scanner},
+	{"test_channel_pool_coalescing", test_channel_pool_coalescing},
+	{"test_channel_pool_lanes", test_channel_pool_lanes},
+	{"test_channel_async", test_channel_async},
+	{"test_channel_get_batch", test_channel_get_batch},
+	{"test_channel_get_coalesced", test_channel_get_coalesced},
+	{"test_channel_get_columnar", test_channel_get_columnar},
+	{"test_channel_get_stream_reuse", test_channel_get_stream_reuse},
+	{"test_channel_trivial_payload", test_channel_trivial_payload},
+	{"test_channel_put_generator", test_channel_put_generator},
+	{"test_channel_put_stream", test_channel_put_stream},
+	{"test_channel_put_cid_grouping", test_channel_put_cid_grouping},
+	{"test_channel_put_batch_coalescing", test_channel_put_batch_coalescing},
+	{"test_channel_put_size_hint", test_channel_put_size_hint},
+	{"test_channel_get_buffer_growth", test_channel_get_buffer_growth},
+	{"test_channel_get_chunked_payload", test_channel_get_chunked_payload},
+	{"test_channel_skip_oversized_records", test_channel_skip_oversized_records},
+	{"test_channel_put_chunked_payload", test_channel_put_chunked_payload},
+	{"test_channel_receive_stats", test_channel_receive_stats},
+	{"test_channel_io_uring", test_channel_io_uring},
+	{"test_channel_retry", test_channel_retry},
+	{"test_channel_get_stream_resumable", test_channel_get_stream_resumable},
+	{"test_channel_deadline", test_channel_deadline},
+	{"test_channel_signal_restart", test_channel_signal_restart},
+	{"test_channel_async_server_error", test_channel_async_server_error},
+	{"test_channel_put_aggregator", test_channel_put_aggregator},
+	{"test_channel_put_aggregator_close", test_channel_put_aggregator_close},
+	{"test_channel_get_arena", test_channel_get_arena},
+	{"test_channel_get_blob", test_channel_get_blob},
+	{"test_channel_get_mixed", test_channel_get_mixed},
+	{"test_channel_get_lazy", test_channel_get_lazy},
+	{"test_channel_get_stream_arrow", test_channel_get_stream_arrow},
+	{"test_channel_get_stream_batching", test_channel_get_stream_batching},
+	{"test_channel_split_buffers", test_channel_split_buffers},
+	{"test_channel_buffer_release", test_channel_buffer_release},
+	{"test_channel_memory_budget", test_channel_memory_budget},
+	{"test_channel_buffer_auto_tuning", test_channel_buffer_auto_tuning},
+	{"test_channel_put_flow_control", test_channel_put_flow_control},
+	{"test_channel_put_dedup_filter", test_channel_put_dedup_filter},
+	{"test_channel_put_dedup_vectored", test_channel_put_dedup_vectored},
+	{"test_channel_caching_get", test_channel_caching_get},
+	{"test_channel_negative_cache", test_channel_negative_cache},
+	{"test_channel_snapshot", test_channel_snapshot},
+	{"test_channel_tail", test_channel_tail},
+	{"test_channel_compressed_payload", test_channel_compressed_payload},
+	{"test_channel_interned_payload", test_channel_interned_payload},
+	{"test_channel_view_records_set", test_channel_view_records_set},
+	{"test_channel_series_compressor", test_channel_series_compressor},
+	{"test_channel_sample_packer", test_channel_sample_packer},
+	{"test_channel_get_series", test_channel_get_series},
+	{"test_channel_numeric_payload_types", test_channel_numeric_payload_types},
+	{"test_channel_stats", test_channel_stats},
+	{"test_channel_allocation_stats", test_channel_allocation_stats},
+	{"test_channel_get_presized", test_channel_get_presized},
+	{"test_channel_tracer", test_channel_tracer},
+	{"test_channel_cluster", test_channel_cluster},
+	{"test_channel_replicas", test_channel_replicas},
+	{"test_channel_get_parallel_decode", test_channel_get_parallel_decode},
+	{"test_channel_put_parallel_encode", test_channel_put_parallel_encode},
+	{"test_channel_get_stream_prefetch", test_channel_get_stream_prefetch},
+	{"test_channel_get_stream_cancel", test_channel_get_stream_cancel},
+	{"test_channel_stream_operators", test_channel_stream_operators},
+	{"test_channel_get_spilled", test_channel_get_spilled},
+	{"test_channel_replicate", test_channel_replicate},
+	{"test_channel_put_raw", test_channel_put_raw},
+	{"test_channel_put_bulk_key_validation", test_channel_put_bulk_key_validation},
+	{"test_channel_packed_keys", test_channel_packed_keys},
+	{"test_channel_records_index", test_channel_records_index},
+	{"test_channel_put_spool", test_channel_put_spool},
+	{"test_channel_put_from_file", test_channel_put_from_file},
 };
 
 namespace globals {
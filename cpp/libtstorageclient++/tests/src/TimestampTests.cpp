@@ -0,0 +1,76 @@
+/*
+ * TStorage: Client library tests (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "TimestampTests.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <tstorageclient++/Timestamp.h>
+
+#include "Asserts.h"
+
+using namespace std;
+using namespace std::chrono;
+
+namespace tstorage {
+
+int test_timestamp_unix_nanos()
+{
+	const vector<Timestamp::TimeT> timestamps = {0,
+		1,
+		-1,
+		-cNanosFrom1970To2001,
+		Timestamp::fromUnix(Timestamp::fromDateTime(2010, 04, 01) + 10us),
+		Timestamp::now(),
+		numeric_limits<Timestamp::TimeT>::max() - cNanosFrom1970To2001};
+	vector<int64_t> unixNanos(timestamps.size());
+	Timestamp::toUnixNanos(timestamps.data(), timestamps.size(), unixNanos.data());
+	for (size_t i = 0; i < timestamps.size(); ++i) {
+		ASSERT_EQ(unixNanos[i],
+			Timestamp::toUnix<nanoseconds>(timestamps[i]).time_since_epoch().count());
+	}
+
+	vector<Timestamp::TimeT> roundTrip(timestamps.size());
+	Timestamp::fromUnixNanos(unixNanos.data(), unixNanos.size(), roundTrip.data());
+	ASSERT_EQ(roundTrip == timestamps, true);
+
+	// The conversions may also run in place.
+	vector<int64_t> inPlace(timestamps.begin(), timestamps.end());
+	Timestamp::toUnixNanos(inPlace.data(), inPlace.size(), inPlace.data());
+	ASSERT_EQ(inPlace == unixNanos, true);
+	Timestamp::fromUnixNanos(inPlace.data(), inPlace.size(), inPlace.data());
+	ASSERT_EQ(equal(inPlace.begin(), inPlace.end(), timestamps.begin()), true);
+	return 0;
+}
+
+int test_timestamp_coarse_now()
+{
+	// The coarse clock lags the precise one by at most a kernel tick, and
+	// never goes back; it must also advance within a second.
+	const Timestamp::TimeT maxLag = duration_cast<nanoseconds>(100ms).count();
+	const Timestamp::TimeT start = Timestamp::coarseNow();
+	const Timestamp::TimeT deadline =
+		Timestamp::now() + duration_cast<nanoseconds>(1s).count();
+	Timestamp::TimeT last = start;
+	while (last == start) {
+		const Timestamp::TimeT before = Timestamp::now();
+		const Timestamp::TimeT coarse = Timestamp::coarseNow();
+		const Timestamp::TimeT after = Timestamp::now();
+		ASSERT_GEQ(coarse, last);
+		ASSERT_LEQ(coarse, after);
+		ASSERT_LEQ(before - coarse, maxLag);
+		last = coarse;
+		ASSERT_LEQ(after, deadline);
+	}
+	return 0;
+}
+
+} /*namespace tstorage*/
@@ -0,0 +1,17 @@
+/*
+ * TStorage: Client library tests (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_TIMESTAMP_TESTS_PH
+#define D_TSTORAGE_TIMESTAMP_TESTS_PH
+
+namespace tstorage {
+
+int test_timestamp_unix_nanos();
+int test_timestamp_coarse_now();
+
+} /*namespace tstorage*/
+
+#endif
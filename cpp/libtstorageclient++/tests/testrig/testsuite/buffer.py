@@ -10,6 +10,9 @@ tests: Dict[str, Callable[[], bool]] = {
     "buffer create test": standaloneTest("test_buffer_create"),
     "buffer heads test": standaloneTest("test_buffer_heads"),
     "buffer reserve test": standaloneTest("test_buffer_reserve"),
+    "buffer resize test": standaloneTest("test_buffer_resize"),
+    "buffer mirrored layout test": standaloneTest("test_buffer_mirrored"),
+    "buffer allocation test": standaloneTest("test_buffer_allocation"),
 }
 
 
@@ -2,12 +2,186 @@
 
 import socket
 import struct
+from time import sleep
 from typing import Callable, Dict, Optional
 
-from ..tests import functionalTest
+from ..tests import functionalTest, standardTest
 from ..utils import info, warn, err, success, testname, testdesc
 
 
+def recvExactly(conn: socket.socket, amt: int) -> bytes:
+    data = b""
+    while len(data) < amt:
+        part = conn.recv(amt - len(data))
+        if len(part) == 0:
+            break
+        data += part
+    return data
+
+
+def resetConnection(conn: socket.socket) -> None:
+    info("Resetting the connection.")
+    conn.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+
+
+@standardTest("test_channel_retry")
+def channelTest_retry(conn: socket.socket, phase: int) -> bool:
+    # GET and GETACQ requests consist of a header and a key pair.
+    requestSize = 12 + 64
+    if phase == 0:
+        testdesc(
+            "The client should retry a GET and a GETACQ request reset by the "
+            "server, but not a PUT request."
+        )
+    info(f"Detected connection attempt #{phase}.")
+    if phase == 0:
+        recvExactly(conn, requestSize)
+        resetConnection(conn)
+    elif phase == 1:
+        recvExactly(conn, requestSize)
+        payload = b"retried"
+        conn.sendall(struct.pack("<lQ", 0, 0))
+        conn.sendall(
+            struct.pack("<llqlqq", len(payload) + 32, 0x7FFFFFF1, 1, 2, 3, 4) + payload
+        )
+        conn.sendall(struct.pack("<l", 0))
+        conn.sendall(struct.pack("<lQq", 0, 8, 42))
+        recvExactly(conn, requestSize)
+        resetConnection(conn)
+    elif phase == 2:
+        recvExactly(conn, requestSize)
+        conn.sendall(struct.pack("<lQq", 0, 8, 43))
+        recvExactly(conn, 12)
+        resetConnection(conn)
+    else:
+        err("[ERROR] Unexpected connection attempt.")
+        return False
+    return True
+
+
+def recvKeyRange(conn: socket.socket) -> tuple:
+    msgType, _ = struct.unpack("<lQ", recvExactly(conn, 12))
+    keyMin = struct.unpack("<lqlqq", recvExactly(conn, 32))
+    keyMax = struct.unpack("<lqlqq", recvExactly(conn, 32))
+    return msgType, keyMin, keyMax
+
+
+def sendGetResponse(conn: socket.socket, cid: int, payload: bytes, acq: int) -> None:
+    conn.sendall(struct.pack("<lQ", 0, 0))
+    conn.sendall(struct.pack("<llqlqq", len(payload) + 32, cid, 1, 2, 3, 4) + payload)
+    conn.sendall(struct.pack("<l", 0))
+    conn.sendall(struct.pack("<lQq", 0, 8, acq))
+
+
+@standardTest("test_channel_deadline")
+def channelTest_deadline(conn: socket.socket, phase: int) -> bool:
+    if phase != 0:
+        err("[ERROR] Unexpected connection attempt.")
+        return False
+    testdesc(
+        "A GET with a deadline should outlast a stall longer than the timeout, "
+        "and should fail once a response trickling in outlasts the deadline."
+    )
+    recvKeyRange(conn)
+    sleep(0.6)
+    sendGetResponse(conn, 0x7FFFFFF1, b"stalled", 42)
+
+    recvKeyRange(conn)
+    payload = b"trickled"
+    response = (
+        struct.pack("<lQ", 0, 0)
+        + struct.pack("<llqlqq", len(payload) + 32, 0x7FFFFFF1, 1, 2, 3, 4)
+        + payload
+        + struct.pack("<l", 0)
+        + struct.pack("<lQq", 0, 8, 43)
+    )
+    try:
+        for i in range(len(response)):
+            conn.sendall(response[i : i + 1])
+            sleep(0.1)
+    except OSError:
+        info("The client has given up on the response.")
+    return True
+
+
+@standardTest("test_channel_signal_restart")
+def channelTest_signalRestart(conn: socket.socket, phase: int) -> bool:
+    if phase != 0:
+        err("[ERROR] Unexpected connection attempt.")
+        return False
+    testdesc(
+        "A GET interrupted by signals while waiting for the response should "
+        "restart the receive if enabled, and should fail otherwise."
+    )
+    recvKeyRange(conn)
+    sleep(0.3)
+    sendGetResponse(conn, 0x7FFFFFF1, b"restarted", 42)
+
+    recvKeyRange(conn)
+    sleep(0.3)
+    try:
+        sendGetResponse(conn, 0x7FFFFFF1, b"interrupted", 43)
+    except OSError:
+        info("The client has given up on the response.")
+    return True
+
+
+@standardTest("test_channel_get_stream_resumable")
+def channelTest_getStreamResumable(conn: socket.socket, phase: int) -> bool:
+    # Matches the ranges used by the client.
+    cidMin, pinnedAcq = 0x7FFFFFF0, 1000
+    if phase == 0:
+        testdesc(
+            "The client should pin the key-interval, stream its two CID "
+            "sub-intervals and reissue only the second one after a reset."
+        )
+    info(f"Detected connection attempt #{phase}.")
+    expected = [(7, None)] if phase == 0 else []
+    expected += [(1, cidMin), (1, cidMin + 1)] if phase == 0 else [(1, cidMin + 1)]
+    for msgType, cid in expected:
+        gotType, keyMin, keyMax = recvKeyRange(conn)
+        info(f"Request {gotType} for CIDs [{keyMin[0]}, {keyMax[0]}), ACQ < {keyMax[4]}")
+        if gotType != msgType:
+            err("[ERROR] Unexpected request type.")
+            return False
+        if msgType == 7:
+            conn.sendall(struct.pack("<lQq", 0, 8, pinnedAcq))
+            continue
+        if keyMin[0] != cid or keyMax[0] != cid + 1 or keyMax[4] != pinnedAcq:
+            err("[ERROR] Unexpected sub-interval.")
+            return False
+        if phase == 0 and cid == cidMin + 1:
+            conn.sendall(struct.pack("<lQ", 0, 0))
+            resetConnection(conn)
+            return True
+        sendGetResponse(conn, cid, b"record %d" % (cid - cidMin), pinnedAcq)
+    recvExactly(conn, 12)
+    return True
+
+
+@standardTest("test_channel_async_server_error")
+def channelTest_asyncServerError(conn: socket.socket, phase: int) -> bool:
+    if phase != 0:
+        err("[ERROR] Unexpected connection attempt.")
+        return False
+    testdesc(
+        "An async channel should fail only the pipelined requests the server "
+        "rejects, and should go on with the rest on the same connection."
+    )
+    for _ in range(3):
+        recvKeyRange(conn)
+    conn.sendall(struct.pack("<lQ", -1, 0))
+    payload = b"failed"
+    conn.sendall(struct.pack("<lQ", 0, 0))
+    conn.sendall(struct.pack("<llqlqq", len(payload) + 32, 0x7FFFFFF1, 1, 2, 3, 4) + payload)
+    conn.sendall(struct.pack("<l", 0))
+    conn.sendall(struct.pack("<lQ", -1, 0))
+    conn.sendall(struct.pack("<lQq", 0, 8, 42))
+    # Keep the connection open until the client closes it.
+    recvExactly(conn, 1)
+    return True
+
+
 def tests(host: Optional[str] = None) -> Dict[str, Callable[[], bool]]:
     return {
         "connect test": functionalTest("test_channel_connect", host=host),
@@ -33,6 +207,188 @@ def tests(host: Optional[str] = None) -> Dict[str, Callable[[], bool]]:
         "maximal key put test": functionalTest(
             "test_channel_put_key_out_of_range", verbose=False, host=host
         ),
+        "pipelined put test": functionalTest("test_channel_put_pipelined", host=host),
+        "vectored put test": functionalTest("test_channel_put_vectored", host=host),
+        "get view test": functionalTest("test_channel_get_view", host=host),
+        "get into caller storage test": functionalTest("test_channel_get_into", host=host),
+        "keys-only count test": functionalTest("test_channel_count_range", host=host),
+        "open stream test": functionalTest("test_channel_open_stream", host=host),
+        "merged stream test": functionalTest("test_channel_merged_stream", host=host),
+        "channel pool test": functionalTest("test_channel_pool", host=host),
+        "parallel get test": functionalTest(
+            "test_channel_pool_get_parallel", host=host
+        ),
+        "parallel put test": functionalTest(
+            "test_channel_pool_put_parallel", host=host
+        ),
+        "sequential window scan": functionalTest(
+            "test_channel_pool_window_scanner", host=host
+        ),
+        "coalesced concurrent queries": functionalTest(
+            "test_channel_pool_coalescing", host=host
+        ),
+        "channel pool lanes test": functionalTest("test_channel_pool_lanes", host=host),
+        "Async channels sharing an event loop": functionalTest(
+            "test_channel_async", host=host
+        ),
+        "Pipelined GET and GETACQ batches": functionalTest(
+            "test_channel_get_batch", host=host
+        ),
+        "Coalesced GET of overlapping key-intervals": functionalTest(
+            "test_channel_get_coalesced", host=host
+        ),
+        "Columnar GET and GET stream": functionalTest(
+            "test_channel_get_columnar", host=host
+        ),
+        "GET stream reusing its batch container": functionalTest(
+            "test_channel_get_stream_reuse", host=host
+        ),
+        "channel trivial payload type test": functionalTest(
+            "test_channel_trivial_payload", host=host
+        ),
+        "channel put from range and generator test": functionalTest(
+            "test_channel_put_generator", host=host
+        ),
+        "channel put stream test": functionalTest("test_channel_put_stream", host=host),
+        "channel put with CID grouping test": functionalTest(
+            "test_channel_put_cid_grouping", host=host
+        ),
+        "channel put with batch coalescing test": functionalTest(
+            "test_channel_put_batch_coalescing", host=host
+        ),
+        "channel put with payload size hints test": functionalTest(
+            "test_channel_put_size_hint", host=host
+        ),
+        "channel get with receive buffer growth test": functionalTest(
+            "test_channel_get_buffer_growth", host=host
+        ),
+        "channel get with chunked payloads test": functionalTest(
+            "test_channel_get_chunked_payload", host=host
+        ),
+        "channel get skipping oversized records test": functionalTest(
+            "test_channel_skip_oversized_records", host=host
+        ),
+        "channel put with chunked payloads test": functionalTest(
+            "test_channel_put_chunked_payload", host=host
+        ),
+        "receive stats test": functionalTest("test_channel_receive_stats", host=host),
+        "io_uring backend test": functionalTest("test_channel_io_uring", host=host),
+        "retry policy test": channelTest_retry,
+        "resumable GET stream test": channelTest_getStreamResumable,
+        "per-request deadline test": channelTest_deadline,
+        "signal restart test": channelTest_signalRestart,
+        "async server error test": channelTest_asyncServerError,
+        "PUT aggregator test": functionalTest("test_channel_put_aggregator", host=host),
+        "PUT aggregator concurrent close test": functionalTest(
+            "test_channel_put_aggregator_close", host=host
+        ),
+        "Get with arena allocator": functionalTest("test_channel_get_arena", host=host),
+        "Get into a blob records set": functionalTest(
+            "test_channel_get_blob", host=host
+        ),
+        "Get series of mixed payload types": functionalTest(
+            "test_channel_get_mixed", host=host
+        ),
+        "Get into a lazily deserialized set": functionalTest(
+            "test_channel_get_lazy", host=host
+        ),
+        "Stream into Arrow columns": functionalTest(
+            "test_channel_get_stream_arrow", host=host
+        ),
+        "Stream batching policy": functionalTest(
+            "test_channel_get_stream_batching", host=host
+        ),
+        "Separate send and receive buffers": functionalTest(
+            "test_channel_split_buffers", host=host
+        ),
+        "Idle buffer release": functionalTest(
+            "test_channel_buffer_release", host=host
+        ),
+        "Memory budget": functionalTest("test_channel_memory_budget", host=host),
+        "Buffer auto-tuning": functionalTest("test_channel_buffer_auto_tuning", host=host),
+        "PUT flow control": functionalTest("test_channel_put_flow_control", host=host),
+        "PUTA duplicate filter": functionalTest("test_channel_put_dedup_filter", host=host),
+        "PUTA duplicate filter, vectored payloads": functionalTest("test_channel_put_dedup_vectored", host=host),
+        "Caching get": functionalTest("test_channel_caching_get", host=host),
+        "Negative cache": functionalTest("test_channel_negative_cache", host=host),
+        "Consistent reads pinned to one ACQ": functionalTest(
+            "test_channel_snapshot", host=host
+        ),
+        "Tail": functionalTest("test_channel_tail", host=host),
+        "Compressed payload": functionalTest(
+            "test_channel_compressed_payload", host=host
+        ),
+        "Interned payload": functionalTest("test_channel_interned_payload", host=host),
+        "Zero-copy payload views": functionalTest("test_channel_view_records_set", host=host),
+        "Deadband and swinging-door compression": functionalTest(
+            "test_channel_series_compressor", host=host
+        ),
+        "Pack samples of numeric series into records": functionalTest(
+            "test_channel_sample_packer", host=host
+        ),
+        "Get records into per-series arrays": functionalTest(
+            "test_channel_get_series", host=host
+        ),
+        "Store varint, little-endian and Gorilla-encoded payloads": functionalTest(
+            "test_channel_numeric_payload_types", host=host
+        ),
+        "Count the traffic, batches and request latencies of a channel": functionalTest(
+            "test_channel_stats", host=host
+        ),
+        "Count the syscalls and allocations of a channel by command": functionalTest(
+            "test_channel_allocation_stats", host=host
+        ),
+        "Reserve GET results from the history of record counts": functionalTest(
+            "test_channel_get_presized", host=host
+        ),
+        "Trace the protocol phases of connects and requests": functionalTest(
+            "test_channel_tracer", host=host
+        ),
+        "Shard records across a cluster by CID": functionalTest(
+            "test_channel_cluster", host=host
+        ),
+        "Route reads to the fastest healthy replica": functionalTest(
+            "test_channel_replicas", host=host
+        ),
+        "Deserialize GET responses on decoding threads": functionalTest(
+            "test_channel_get_parallel_decode", host=host
+        ),
+        "Serialize PUT requests on encoding threads": functionalTest(
+            "test_channel_put_parallel_encode", host=host
+        ),
+        "Receive stream batches while the callback runs": functionalTest(
+            "test_channel_get_stream_prefetch", host=host
+        ),
+        "Stop a stream early": functionalTest(
+            "test_channel_get_stream_cancel", host=host
+        ),
+        "Aggregate raw records while receiving them": functionalTest(
+            "test_channel_stream_operators", host=host
+        ),
+        "Spill a GET response to a mapped file": functionalTest(
+            "test_channel_get_spilled", host=host
+        ),
+        "Replicate raw records between channels": functionalTest(
+            "test_channel_replicate", host=host
+        ),
+        "Store records with serialized payloads": functionalTest(
+            "test_channel_put_raw", host=host
+        ),
+        "Validate the keys of a PUT in bulk": functionalTest(
+            "test_channel_put_bulk_key_validation", host=host
+        ),
+        "Sort, search and hash packed keys": functionalTest(
+            "test_channel_packed_keys", host=host
+        ),
+        "Index records by series and CAP": functionalTest(
+            "test_channel_records_index", host=host
+        ),
+        "Spool records to disk while the server is unreachable": functionalTest(
+            "test_channel_put_spool", host=host
+        ),
+        "Send pre-serialized records from a file": functionalTest(
+            "test_channel_put_from_file", host=host
+        ),
     }
 
 
@@ -5,7 +5,7 @@ import struct
 from time import sleep
 from typing import Callable, Dict
 
-from ..tests import standardTest
+from ..tests import standaloneTest, standardTest
 from ..utils import info, warn, err, success, testname, testdesc
 
 
@@ -216,6 +216,41 @@ def socketTest_recv_timeout(conn: socket.socket) -> bool:
     return True
 
 
+@standardTest("test_socket_connect_dual_stack")
+def socketTest_connectDualStack(conn: socket.socket, phase: int) -> bool:
+    if phase == 0:
+        testdesc(
+            "The client should fail to connect over IPv6 right away, then connect "
+            "over IPv4 twice, the second time with the cached address."
+        )
+    info("Detected connection attempt.")
+    return True
+
+
+@standardTest("test_socket_connect_timeout")
+def socketTest_connectTimeout(conn: socket.socket, phase: int) -> bool:
+    if phase == 0:
+        testdesc(
+            "The client should give up connecting to an unreachable address within "
+            "the connect timeout, then connect to the server in spite of the send "
+            "and receive timeout being shorter."
+        )
+    info("Detected connection attempt.")
+    return True
+
+
+@standardTest("test_socket_options")
+def socketTest_options(conn: socket.socket) -> bool:
+    testdesc(
+        "The client should fail to connect with an invalid keepalive time, then "
+        "connect with all TCP options set and have its message echoed."
+    )
+    msg = conn.recv(64)
+    info(f"'{msg.decode('utf8')}'")
+    conn.sendall(msg)
+    return msg == b"Hello!"
+
+
 tests: Dict[str, Callable[[], bool]] = {
     "connect and close test": socketTest_connectClose,
     "send test": socketTest_send,
@@ -228,6 +263,11 @@ tests: Dict[str, Callable[[], bool]] = {
     "dialog test": socketTest_dialog,
     "send timeout test": socketTest_send_timeout,
     "recv timeout test": socketTest_recv_timeout,
+    "dual-stack connect test": socketTest_connectDualStack,
+    "connect timeout test": socketTest_connectTimeout,
+    "TCP options test": socketTest_options,
+    "Unix domain socket test": standaloneTest("test_socket_unix"),
+    "TLS handshake test": standaloneTest("test_socket_tls"),
 }
 
 if __name__ == "__main__":
@@ -0,0 +1,18 @@
+#!/bin/env python3
+
+from typing import Callable, Dict, Optional
+
+from ..tests import standaloneTest
+from ..utils import info, warn, err, success, testname, testdesc
+
+
+tests: Dict[str, Callable[[], bool]] = {
+    "timestamp UNIX conversion test": standaloneTest("test_timestamp_unix_nanos"),
+    "timestamp coarse clock test": standaloneTest("test_timestamp_coarse_now"),
+}
+
+
+if __name__ == "__main__":
+    from ..tests import TestBatch
+
+    exit(0 if TestBatch("Timestamp", tests).run() else 1)
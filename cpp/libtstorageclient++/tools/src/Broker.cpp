@@ -0,0 +1,581 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <tstorageclient++/BrokerChannel.h>
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/ChannelPool.h>
+#include <tstorageclient++/CoalescingPool.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/RecordsSet.h>
+#include <tstorageclient++/Response.h>
+#include <tstorageclient++/ResponseAcq.h>
+#include <tstorageclient++/ResponseGet.h>
+
+#include "BrokerProtocol.h"
+#include "DumpFormat.h"
+#include "Utils.h"
+
+using namespace tstorage;
+using namespace tstorage::tools;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t cMaxConnections = 64;
+
+struct Options
+{
+	std::string socketPath = cDefaultBrokerSocket;
+	std::string addr = cDefaultAddr;
+	std::uint16_t port = cDefaultPort;
+	std::size_t putConnections = 2;
+	std::size_t getConnections = 2;
+	std::size_t batchSize = 1024UL * 1024;
+	std::chrono::microseconds linger{2000};
+	std::chrono::microseconds acqTtl{0};
+	std::size_t memoryLimit = cChannelBufferSize;
+	mode_t mode = 0;
+};
+
+void printHelp()
+{
+	std::cout
+		<< "Usage: tstorage-broker [options]\n"
+		   "\n"
+		   "Accepts the connections of the local processes on a Unix domain socket\n"
+		   "and serves their requests over a few connections to a TStorage instance.\n"
+		   "The PUT and PUTA requests of all processes are stored in large batches\n"
+		   "grouped by CID, and identical concurrent GET and GETACQ requests are\n"
+		   "merged. Runs until interrupted.\n"
+		   "\n"
+		   "Options:\n"
+		   "  -s, --socket <path>        socket to listen on, @<name> for an abstract\n"
+		   "                             one (default: /tmp/tstorage-broker.sock)\n"
+		   "  -M, --mode <octal>         permissions of the socket (default: umask)\n"
+		   "  -a, --addr <host>          server address (default: localhost)\n"
+		   "  -p, --port <port>          server port (default: 2025)\n"
+		   "  -n, --put-connections <n>  connections storing batches (default: 2)\n"
+		   "  -g, --get-connections <n>  connections serving GET and GETACQ\n"
+		   "                             (default: 2)\n"
+		   "  -b, --batch <size>         size at which a batch is stored at once;\n"
+		   "                             K and M suffixes are accepted (default: 1M)\n"
+		   "  -l, --linger <us>          longest wait of a batch for more records\n"
+		   "                             (default: 2000)\n"
+		   "  -t, --acq-ttl <us>         how long a GETACQ response is reused\n"
+		   "                             (default: 0)\n"
+		   "  -m, --memory-limit <size>  memory limit of a connection, and so the\n"
+		   "                             size bound of a GET response (default: 34M)\n"
+		   "  -h, --help                 print this help\n"
+		<< std::flush;
+}
+
+bool parseMode(const std::string& str, mode_t& oMode)
+{
+	if (str.empty() || str.size() > 4 || str.find_first_not_of("01234567") != std::string::npos) {
+		return false;
+	}
+	oMode = static_cast<mode_t>(std::stoul(str, nullptr, 8));
+	return true;
+}
+
+bool parseOptions(const int argc, char* const* const argv, Options& oOptions)
+{
+	const struct option longOptions[] = {
+		{"socket", required_argument, nullptr, 's'},
+		{"mode", required_argument, nullptr, 'M'},
+		{"addr", required_argument, nullptr, 'a'},
+		{"port", required_argument, nullptr, 'p'},
+		{"put-connections", required_argument, nullptr, 'n'},
+		{"get-connections", required_argument, nullptr, 'g'},
+		{"batch", required_argument, nullptr, 'b'},
+		{"linger", required_argument, nullptr, 'l'},
+		{"acq-ttl", required_argument, nullptr, 't'},
+		{"memory-limit", required_argument, nullptr, 'm'},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0},
+	};
+	int opt = 0;
+	while ((opt = getopt_long(argc, argv, "s:M:a:p:n:g:b:l:t:m:h", longOptions, nullptr)) != -1) {
+		bool valid = true;
+		std::size_t us = 0;
+		switch (opt) {
+			case 's':
+				oOptions.socketPath = optarg;
+				valid = !oOptions.socketPath.empty()
+					&& oOptions.socketPath.size() < sizeof(sockaddr_un::sun_path);
+				break;
+			case 'M':
+				valid = parseMode(optarg, oOptions.mode);
+				break;
+			case 'a':
+				oOptions.addr = optarg;
+				break;
+			case 'p':
+				valid = parseUInt16(optarg, oOptions.port);
+				break;
+			case 'n':
+				valid = parseSize(optarg, oOptions.putConnections)
+					&& oOptions.putConnections > 0 && oOptions.putConnections <= cMaxConnections;
+				break;
+			case 'g':
+				valid = parseSize(optarg, oOptions.getConnections)
+					&& oOptions.getConnections > 0 && oOptions.getConnections <= cMaxConnections;
+				break;
+			case 'b':
+				valid = parseByteSize(optarg, oOptions.batchSize) && oOptions.batchSize > 0;
+				break;
+			case 'l':
+				valid = parseSize(optarg, us);
+				oOptions.linger = std::chrono::microseconds(us);
+				break;
+			case 't':
+				valid = parseSize(optarg, us);
+				oOptions.acqTtl = std::chrono::microseconds(us);
+				break;
+			case 'm':
+				valid = parseByteSize(optarg, oOptions.memoryLimit);
+				break;
+			default:
+				return false;
+		}
+		if (!valid) {
+			std::cerr << "tstorage-broker: invalid value of -" << static_cast<char>(opt)
+					  << ": " << optarg << std::endl;
+			return false;
+		}
+	}
+	return optind == argc;
+}
+
+/** @brief The records of the PUT or PUTA requests stored together. */
+struct Batch
+{
+	RecordsSet<std::string> records;
+	std::size_t bytes = 0;
+	/** @brief The requests whose records are in the batch. */
+	std::size_t requests = 0;
+	/** @brief When the first records were added. */
+	Clock::time_point opened;
+	/** @brief Set once the batch has been sent. */
+	bool done = false;
+	result_t status = result_t::OK;
+};
+
+/**
+ * @brief Gathers the records of concurrent PUT and PUTA requests into
+ * batches, and stores them over a few channels.
+ *
+ * A batch is sent as soon as it reaches the batch size, or once its first
+ * records have waited for the linger time. The requests whose records are
+ * in a batch are answered with its status. A request finding the batch of
+ * its protocol full waits for it to be taken by a sender.
+ */
+class Committer
+{
+public:
+	explicit Committer(const Options& options)
+		: mBatchSize(options.batchSize)
+		, mLinger(options.linger)
+		, mStopping(false)
+		, mBatches(0)
+		, mRequests(0)
+		, mRecords(0)
+	{
+		for (std::shared_ptr<Batch>& batch : mPending) {
+			batch = std::make_shared<Batch>();
+		}
+	}
+
+	/** @brief Stores the records, then returns the status of their batch. */
+	result_t store(const bool withAcq, RecordsSet<std::string>& records, const std::size_t bytes)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		std::shared_ptr<Batch>& pending = mPending[withAcq ? 1 : 0];
+		mSpace.wait(lock, [&]() { return mStopping || pending->bytes < mBatchSize; });
+		if (mStopping) {
+			return result_t::NOT_CONNECTED;
+		}
+		const std::shared_ptr<Batch> batch = pending;
+		if (batch->records.size() == 0) {
+			// The records of a lone request are taken over rather than copied.
+			batch->opened = Clock::now();
+			std::swap(batch->records, records);
+		} else {
+			for (const Record<std::string>& record : records) {
+				batch->records.append(record);
+			}
+		}
+		batch->bytes += bytes;
+		++batch->requests;
+		mWork.notify_one();
+		mDone.wait(lock, [&]() { return batch->done; });
+		return batch->status;
+	}
+
+	/** @brief Sends batches over `channel` until `stop()`, then drains them. */
+	void send(Channel<std::string>& channel)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (true) {
+			const Clock::time_point now = Clock::now();
+			Clock::time_point wakeUp = Clock::time_point::max();
+			std::size_t ready = mPending.size();
+			bool idle = true;
+			for (std::size_t i = 0; i < mPending.size(); ++i) {
+				const Batch& batch = *mPending[i];
+				if (batch.records.size() == 0) {
+					continue;
+				}
+				idle = false;
+				if (mStopping || batch.bytes >= mBatchSize || batch.opened + mLinger <= now) {
+					ready = i;
+					break;
+				}
+				wakeUp = std::min(wakeUp, batch.opened + mLinger);
+			}
+			if (ready == mPending.size()) {
+				if (idle && mStopping) {
+					return;
+				}
+				if (wakeUp == Clock::time_point::max()) {
+					mWork.wait(lock);
+				} else {
+					mWork.wait_until(lock, wakeUp);
+				}
+				continue;
+			}
+
+			const std::shared_ptr<Batch> batch = mPending[ready];
+			mPending[ready] = std::make_shared<Batch>();
+			mSpace.notify_all();
+			lock.unlock();
+			Response res(result_t::NOT_CONNECTED);
+			if (channel.connected() || channel.connect().success()) {
+				res = ready == 1 ? channel.puta(batch->records) : channel.put(batch->records);
+			}
+			if (res.fatal()) {
+				(void)channel.close();
+			}
+			const std::size_t records = batch->records.size();
+			batch->records = RecordsSet<std::string>();
+			lock.lock();
+			++mBatches;
+			mRequests += batch->requests;
+			mRecords += records;
+			batch->status = res.status();
+			batch->done = true;
+			mDone.notify_all();
+		}
+	}
+
+	/** @brief Rejects further requests and makes the senders drain. */
+	void stop()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+		mWork.notify_all();
+		mSpace.notify_all();
+	}
+
+	void printSummary(std::ostream& out)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		out << "tstorage-broker: " << mRequests << " PUT/A requests of " << mRecords
+			<< " records stored in " << mBatches << " batches" << std::endl;
+	}
+
+private:
+	const std::size_t mBatchSize;
+	const Clock::duration mLinger;
+	std::mutex mMutex;
+	/** @brief Signalled when a batch is added to or stopping starts. */
+	std::condition_variable mWork;
+	/** @brief Signalled when a pending batch is taken by a sender. */
+	std::condition_variable mSpace;
+	/** @brief Signalled when a batch has been sent. */
+	std::condition_variable mDone;
+	/** @brief The batches being filled, of PUT and of PUTA. */
+	std::array<std::shared_ptr<Batch>, 2> mPending;
+	bool mStopping;
+	std::uint64_t mBatches;
+	std::uint64_t mRequests;
+	std::uint64_t mRecords;
+};
+
+/** @brief Serves the connections of the local processes. */
+class Broker
+{
+public:
+	Broker(const Options& options, Committer& committer, CoalescingPool<std::string>& reader)
+		: mOptions(options)
+		, mCommitter(committer)
+		, mReader(reader)
+		, mListenFd(-1)
+		, mStopping(false)
+		, mClients(0)
+	{
+	}
+
+	~Broker()
+	{
+		if (mListenFd >= 0) {
+			::close(mListenFd);
+			if (mOptions.socketPath[0] != '@') {
+				::unlink(mOptions.socketPath.c_str());
+			}
+		}
+	}
+
+	Broker(const Broker&) = delete;
+	Broker& operator=(const Broker&) = delete;
+
+	/** @brief Binds the socket, replacing a stale one. */
+	bool listen()
+	{
+		struct sockaddr_un addr{};
+		addr.sun_family = AF_UNIX;
+		std::memcpy(addr.sun_path, mOptions.socketPath.data(), mOptions.socketPath.size());
+		socklen_t addrLen = sizeof(sa_family_t) + mOptions.socketPath.size();
+		if (mOptions.socketPath[0] == '@') {
+			addr.sun_path[0] = '\0';
+		} else {
+			::unlink(mOptions.socketPath.c_str());
+			addrLen += 1;
+		}
+		const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0) {
+			return false;
+		}
+		if (::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), addrLen) < 0
+			|| ::listen(fd, SOMAXCONN) < 0) {
+			::close(fd);
+			return false;
+		}
+		mListenFd = fd;
+		return mOptions.mode == 0 || mOptions.socketPath[0] == '@'
+			|| ::chmod(mOptions.socketPath.c_str(), mOptions.mode) == 0;
+	}
+
+	/** @brief Accepts connections until `stop()`. */
+	void run()
+	{
+		while (true) {
+			const int fd = ::accept(mListenFd, nullptr, nullptr);
+			if (fd < 0) {
+				if (errno == EINTR || errno == ECONNABORTED) {
+					continue;
+				}
+				return;
+			}
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mStopping) {
+				::close(fd);
+				return;
+			}
+			auto socket = std::make_shared<BrokerSocket>(fd);
+			mSockets.insert(socket.get());
+			++mClients;
+			std::thread([this, socket]() {
+				serve(*socket);
+				std::lock_guard<std::mutex> lock(mMutex);
+				mSockets.erase(socket.get());
+				--mClients;
+				mFinished.notify_all();
+			}).detach();
+		}
+	}
+
+	/** @brief Stops accepting, and waits for the clients to disconnect. */
+	void stop()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mStopping = true;
+		::shutdown(mListenFd, SHUT_RDWR);
+		for (BrokerSocket* socket : mSockets) {
+			socket->shutdown();
+		}
+		mFinished.wait(lock, [this]() { return mClients == 0; });
+	}
+
+private:
+	/** @brief Serves the requests of a connection in turn. */
+	void serve(BrokerSocket& socket)
+	{
+		RecordsSet<std::string> records;
+		std::vector<unsigned char> response;
+		unsigned char keys[2 * cKeySize];
+		while (true) {
+			std::int32_t command = 0;
+			std::uint64_t dataSize = 0;
+			if (!socket.recvInt32(command) || !socket.recvUInt64(dataSize)) {
+				return;
+			}
+			switch (command) {
+				case BROKER_PUT:
+				case BROKER_PUTA: {
+					const bool withAcq = command == BROKER_PUTA;
+					std::size_t bytes = 0;
+					result_t status = result_t::OK;
+					records.clear();
+					if (!socket.skip(dataSize)
+						|| !recvPutRecords(socket, withAcq, records, bytes, status)) {
+						return;
+					}
+					// The records preceding an invalid one are stored anyway.
+					const result_t stored =
+						records.size() > 0 ? mCommitter.store(withAcq, records, bytes) : result_t::OK;
+					encodeStatus(stored != result_t::OK ? stored : status, response);
+					break;
+				}
+				case BROKER_GET:
+				case BROKER_GETACQ: {
+					if (dataSize != sizeof(keys) || !socket.recv(keys, sizeof(keys))) {
+						return;
+					}
+					const Key keyMin = loadKey(keys);
+					const Key keyMax = loadKey(keys + cKeySize);
+					if (command == BROKER_GETACQ) {
+						const ResponseAcq res = mReader.getAcq(keyMin, keyMax);
+						if (res.success()) {
+							encodeAcqResponse(res.acq(), response);
+						} else {
+							encodeStatus(res.status(), response);
+						}
+					} else {
+						const ResponseGet<std::string> res = mReader.get(keyMin, keyMax);
+						if (res.success()) {
+							encodeGetResponse(res.records(), res.acq(), response);
+						} else {
+							encodeStatus(res.status(), response);
+						}
+					}
+					break;
+				}
+				default:
+					return;
+			}
+			if (!socket.send(response)) {
+				return;
+			}
+		}
+	}
+
+	const Options& mOptions;
+	Committer& mCommitter;
+	CoalescingPool<std::string>& mReader;
+	int mListenFd;
+	std::mutex mMutex;
+	/** @brief Signalled when a client disconnects. */
+	std::condition_variable mFinished;
+	std::set<BrokerSocket*> mSockets;
+	bool mStopping;
+	std::size_t mClients;
+};
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printHelp();
+		return 2;
+	}
+
+	// The signals are taken by `sigwait()` below, so all threads block them.
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	ChannelPool<std::string> pool(
+		options.addr, options.port, std::make_shared<RawPayload>(), options.getConnections);
+	pool.setMemoryLimit(options.memoryLimit);
+	const Response resPool = pool.connect();
+	if (!resPool.success()) {
+		std::cerr << "tstorage-broker: cannot connect: "
+				  << static_cast<int>(resPool.status()) << std::endl;
+		return 1;
+	}
+	CoalescingOptions coalescing;
+	coalescing.acqTtl = options.acqTtl;
+	CoalescingPool<std::string> reader(pool, coalescing);
+
+	Committer committer(options);
+	std::vector<std::unique_ptr<Channel<std::string>>> channels;
+	std::vector<std::thread> senders;
+	for (std::size_t i = 0; i < options.putConnections; ++i) {
+		channels.push_back(std::make_unique<Channel<std::string>>(
+			options.addr, options.port, std::make_unique<RawPayload>(), options.memoryLimit));
+		Channel<std::string>& channel = *channels.back();
+		channel.setPutCidGrouping(true);
+		const Response res = channel.connect();
+		if (!res.success()) {
+			std::cerr << "tstorage-broker: cannot connect: " << static_cast<int>(res.status())
+					  << std::endl;
+			committer.stop();
+			for (std::thread& sender : senders) {
+				sender.join();
+			}
+			return 1;
+		}
+		senders.emplace_back([&committer, &channel]() { committer.send(channel); });
+	}
+
+	Broker broker(options, committer, reader);
+	if (!broker.listen()) {
+		std::cerr << "tstorage-broker: " << options.socketPath << ": " << std::strerror(errno)
+				  << std::endl;
+		committer.stop();
+		for (std::thread& sender : senders) {
+			sender.join();
+		}
+		return 1;
+	}
+	std::thread acceptor([&broker]() { broker.run(); });
+
+	int signal = 0;
+	sigwait(&signals, &signal);
+	broker.stop();
+	acceptor.join();
+	committer.stop();
+	for (std::thread& sender : senders) {
+		sender.join();
+	}
+	for (std::unique_ptr<Channel<std::string>>& channel : channels) {
+		(void)channel->close();
+	}
+	pool.close();
+	committer.printSummary(std::cerr);
+	return 0;
+}
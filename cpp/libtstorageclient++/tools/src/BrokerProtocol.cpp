@@ -0,0 +1,236 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "BrokerProtocol.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "DumpFormat.h"
+
+namespace tstorage {
+namespace tools {
+
+namespace {
+
+/** @brief The size of the receive buffer of a connection. */
+constexpr std::size_t cRecvBufferSize = 256UL * 1024;
+/** @brief The sizes of the abbreviated keys of PUT and PUTA records. */
+constexpr std::size_t cPutKeySize = 20;
+constexpr std::size_t cPutaKeySize = 28;
+
+void appendHeader(
+	const std::int32_t id, const std::uint64_t dataSize, std::vector<unsigned char>& oBytes)
+{
+	const std::size_t offset = oBytes.size();
+	oBytes.resize(offset + cHeaderSize);
+	storeLe32(oBytes.data() + offset, static_cast<std::uint32_t>(id));
+	storeLe64(oBytes.data() + offset + 4, dataSize);
+}
+
+void appendLe32(const std::uint32_t value, std::vector<unsigned char>& oBytes)
+{
+	const std::size_t offset = oBytes.size();
+	oBytes.resize(offset + 4);
+	storeLe32(oBytes.data() + offset, value);
+}
+
+void appendLe64(const std::uint64_t value, std::vector<unsigned char>& oBytes)
+{
+	const std::size_t offset = oBytes.size();
+	oBytes.resize(offset + 8);
+	storeLe64(oBytes.data() + offset, value);
+}
+
+}  // namespace
+
+BrokerSocket::BrokerSocket(const int fd) : mFd(fd), mBuffer(cRecvBufferSize), mBegin(0), mEnd(0) {}
+
+BrokerSocket::~BrokerSocket()
+{
+	::close(mFd);
+}
+
+bool BrokerSocket::recv(void* const dest, const std::size_t size)
+{
+	unsigned char* out = static_cast<unsigned char*>(dest);
+	std::size_t left = size;
+	while (left > 0) {
+		if (mBegin == mEnd && !fill()) {
+			return false;
+		}
+		const std::size_t chunk = std::min(left, mEnd - mBegin);
+		std::memcpy(out, mBuffer.data() + mBegin, chunk);
+		mBegin += chunk;
+		out += chunk;
+		left -= chunk;
+	}
+	return true;
+}
+
+bool BrokerSocket::skip(std::uint64_t size)
+{
+	while (size > 0) {
+		if (mBegin == mEnd && !fill()) {
+			return false;
+		}
+		const std::size_t chunk =
+			static_cast<std::size_t>(std::min<std::uint64_t>(size, mEnd - mBegin));
+		mBegin += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
+bool BrokerSocket::recvInt32(std::int32_t& oValue)
+{
+	unsigned char bytes[4];
+	if (!recv(bytes, sizeof(bytes))) {
+		return false;
+	}
+	oValue = static_cast<std::int32_t>(loadLe32(bytes));
+	return true;
+}
+
+bool BrokerSocket::recvUInt64(std::uint64_t& oValue)
+{
+	unsigned char bytes[8];
+	if (!recv(bytes, sizeof(bytes))) {
+		return false;
+	}
+	oValue = loadLe64(bytes);
+	return true;
+}
+
+bool BrokerSocket::send(const void* const src, const std::size_t size)
+{
+	const unsigned char* in = static_cast<const unsigned char*>(src);
+	std::size_t left = size;
+	while (left > 0) {
+		const ssize_t res = ::send(mFd, in, left, MSG_NOSIGNAL);
+		if (res <= 0) {
+			return false;
+		}
+		in += res;
+		left -= static_cast<std::size_t>(res);
+	}
+	return true;
+}
+
+void BrokerSocket::shutdown()
+{
+	::shutdown(mFd, SHUT_RDWR);
+}
+
+bool BrokerSocket::fill()
+{
+	const ssize_t res = ::recv(mFd, mBuffer.data(), mBuffer.size(), 0);
+	if (res <= 0) {
+		return false;
+	}
+	mBegin = 0;
+	mEnd = static_cast<std::size_t>(res);
+	return true;
+}
+
+bool recvPutRecords(BrokerSocket& socket,
+	const bool withAcq,
+	RecordsSet<std::string>& oRecords,
+	std::size_t& oBytes,
+	result_t& oStatus)
+{
+	const std::size_t keySize = withAcq ? cPutaKeySize : cPutKeySize;
+	unsigned char key[cPutaKeySize];
+	oStatus = result_t::OK;
+	std::int32_t cid = 0;
+	if (!socket.recvInt32(cid)) {
+		return false;
+	}
+	while (cid >= 0) {
+		std::int32_t batchSize = 0;
+		if (!socket.recvInt32(batchSize) || batchSize < 0) {
+			return false;
+		}
+		std::size_t left = static_cast<std::size_t>(batchSize);
+		while (left > 0) {
+			std::int32_t recordSize = 0;
+			if (left < 4 + keySize || !socket.recvInt32(recordSize)
+				|| recordSize < static_cast<std::int32_t>(keySize)
+				|| static_cast<std::size_t>(recordSize) > std::min(left - 4, cMaxRecordSize)
+				|| !socket.recv(key, keySize)) {
+				return false;
+			}
+			left -= 4 + static_cast<std::size_t>(recordSize);
+			const std::size_t payloadSize = static_cast<std::size_t>(recordSize) - keySize;
+
+			const Key recordKey(cid,
+				static_cast<std::int64_t>(loadLe64(key)),
+				static_cast<std::int32_t>(loadLe32(key + 8)),
+				static_cast<std::int64_t>(loadLe64(key + 12)),
+				withAcq ? static_cast<std::int64_t>(loadLe64(key + 20)) : 0);
+			if (oStatus == result_t::OK && !recordKey.isStorable(withAcq)) {
+				oStatus = result_t::INVALID_KEY;
+			}
+			if (oStatus != result_t::OK) {
+				if (!socket.skip(payloadSize)) {
+					return false;
+				}
+				continue;
+			}
+			std::string payload(payloadSize, '\0');
+			if (!socket.recv(&payload[0], payloadSize)) {
+				return false;
+			}
+			oRecords.append(recordKey, std::move(payload));
+			oBytes += cKeySize + payloadSize;
+		}
+		if (!socket.recvInt32(cid)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void encodeStatus(const result_t status, std::vector<unsigned char>& oBytes)
+{
+	oBytes.clear();
+	appendHeader(static_cast<std::int32_t>(status), 0, oBytes);
+}
+
+void encodeAcqResponse(const Key::AcqT acq, std::vector<unsigned char>& oBytes)
+{
+	oBytes.clear();
+	appendHeader(0, sizeof(acq), oBytes);
+	appendLe64(static_cast<std::uint64_t>(acq), oBytes);
+}
+
+void encodeGetResponse(
+	const RecordsSet<std::string>& records, const Key::AcqT acq, std::vector<unsigned char>& oBytes)
+{
+	std::size_t size = 2 * cHeaderSize + 4 + sizeof(acq);
+	for (const Record<std::string>& record : records) {
+		size += 4 + cKeySize + record.value.size();
+	}
+	oBytes.clear();
+	oBytes.reserve(size);
+	appendHeader(0, 0, oBytes);
+	for (const Record<std::string>& record : records) {
+		appendLe32(static_cast<std::uint32_t>(cKeySize + record.value.size()), oBytes);
+		const std::size_t offset = oBytes.size();
+		oBytes.resize(offset + cKeySize);
+		storeKey(oBytes.data() + offset, record.key);
+		oBytes.insert(oBytes.end(), record.value.begin(), record.value.end());
+	}
+	appendLe32(0, oBytes);
+	appendHeader(0, sizeof(acq), oBytes);
+	appendLe64(static_cast<std::uint64_t>(acq), oBytes);
+}
+
+} /*namespace tools*/
+} /*namespace tstorage*/
@@ -0,0 +1,118 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_TOOLS_BROKERPROTOCOL_H
+#define D_TSTORAGE_TOOLS_BROKERPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/RecordsSet.h>
+
+/*
+ * The broker speaks the TStorage protocol to its clients, so that they use
+ * an unmodified `Channel<T>`. All integers are little-endian.
+ *
+ *   header:          command or status (i32), size of the data (u64)
+ *   GET/GETACQ:      header, key min, key max (32 B each)
+ *   PUT/PUTA:        header, batch*, a negative CID (i32)
+ *   batch:           cid (i32), size of the records (i32), record*
+ *   record:          size of the rest (i32), mid (i64), moid (i32), cap (i64),
+ *                    acq (i64, PUTA only), payload
+ *
+ *   PUT/A response:  header (the server adds two ACQs, which the broker
+ *                    does not know and channels skip)
+ *   GET response:    header, (size of the rest (i32), key, payload)*, 0 (i32),
+ *                    header of 8 B of data, ACQ (i64)
+ *   GETACQ response: header of 8 B of data, ACQ (i64)
+ *
+ * A failure is answered with a header of a non-zero status and no data.
+ */
+
+namespace tstorage {
+namespace tools {
+
+enum BrokerCommand : std::int32_t
+{
+	BROKER_GET = 1,
+	BROKER_PUT = 5,
+	BROKER_PUTA = 6,
+	BROKER_GETACQ = 7,
+};
+
+constexpr std::size_t cHeaderSize = 12;
+constexpr std::size_t cKeySize = 32;
+/** @brief The largest record of a PUT/A request, its key included. */
+constexpr std::size_t cMaxRecordSize = cKeySize + 32UL * 1024 * 1024;
+
+/** @brief A connected stream socket with a receive buffer. */
+class BrokerSocket
+{
+public:
+	/** @brief Takes ownership of `fd`. */
+	explicit BrokerSocket(int fd);
+	~BrokerSocket();
+
+	BrokerSocket(const BrokerSocket&) = delete;
+	BrokerSocket(BrokerSocket&&) = delete;
+	BrokerSocket& operator=(const BrokerSocket&) = delete;
+	BrokerSocket& operator=(BrokerSocket&&) = delete;
+
+	/** @brief Receives exactly `size` bytes into `dest`. */
+	bool recv(void* dest, std::size_t size);
+	/** @brief Receives and discards exactly `size` bytes. */
+	bool skip(std::uint64_t size);
+	bool recvInt32(std::int32_t& oValue);
+	bool recvUInt64(std::uint64_t& oValue);
+	/** @brief Sends exactly `size` bytes from `src`. */
+	bool send(const void* src, std::size_t size);
+	bool send(const std::vector<unsigned char>& bytes) { return send(bytes.data(), bytes.size()); }
+
+	/** @brief Wakes up a thread blocked in `recv()`, from any thread. */
+	void shutdown();
+
+private:
+	/** @brief Refills the empty receive buffer. */
+	bool fill();
+
+	int mFd;
+	std::vector<unsigned char> mBuffer;
+	std::size_t mBegin;
+	std::size_t mEnd;
+};
+
+/**
+ * @brief Receives the batches of a PUT/A request, its header excluded, and
+ * appends its records to `oRecords`.
+ *
+ * The records following one which cannot be stored are received but not
+ * appended, like a channel stops at such a record.
+ *
+ * @param oBytes Increased by the sizes of the appended records.
+ * @param oStatus `result_t::OK`, or why a record was left out.
+ * @return `false` if the connection failed or the request is malformed.
+ */
+bool recvPutRecords(BrokerSocket& socket,
+	bool withAcq,
+	RecordsSet<std::string>& oRecords,
+	std::size_t& oBytes,
+	result_t& oStatus);
+
+/** @brief Encodes a response of a status and no data, e.g. that of PUT/A. */
+void encodeStatus(result_t status, std::vector<unsigned char>& oBytes);
+/** @brief Encodes a successful GETACQ response. */
+void encodeAcqResponse(Key::AcqT acq, std::vector<unsigned char>& oBytes);
+/** @brief Encodes a successful GET response. */
+void encodeGetResponse(
+	const RecordsSet<std::string>& records, Key::AcqT acq, std::vector<unsigned char>& oBytes);
+
+} /*namespace tools*/
+} /*namespace tstorage*/
+
+#endif
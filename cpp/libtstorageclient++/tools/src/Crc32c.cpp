@@ -0,0 +1,67 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "Crc32c.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace tstorage {
+namespace tools {
+
+namespace {
+
+/** @brief The reflected Castagnoli polynomial. */
+constexpr std::uint32_t cPolynomial = 0x82f63b78U;
+
+using Tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+/** @brief Builds the tables of slicing-by-8: `t[k][b]` is the checksum of
+ * byte `b` followed by `k` zero bytes. */
+Tables makeTables()
+{
+	Tables t{};
+	for (std::uint32_t b = 0; b < 256; ++b) {
+		std::uint32_t crc = b;
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc >> 1) ^ ((crc & 1U) != 0 ? cPolynomial : 0);
+		}
+		t[0][b] = crc;
+	}
+	for (std::size_t k = 1; k < t.size(); ++k) {
+		for (std::size_t b = 0; b < 256; ++b) {
+			t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xffU];
+		}
+	}
+	return t;
+}
+
+const Tables cTables = makeTables();
+
+}  // namespace
+
+std::uint32_t crc32c(const void* const data, std::size_t size, std::uint32_t crc)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	crc = ~crc;
+	for (; size >= 8; size -= 8, bytes += 8) {
+		const std::uint32_t low = crc
+			^ (std::uint32_t(bytes[0]) | std::uint32_t(bytes[1]) << 8
+				| std::uint32_t(bytes[2]) << 16 | std::uint32_t(bytes[3]) << 24);
+		crc = cTables[7][low & 0xffU] ^ cTables[6][(low >> 8) & 0xffU]
+			^ cTables[5][(low >> 16) & 0xffU] ^ cTables[4][low >> 24]
+			^ cTables[3][bytes[4]] ^ cTables[2][bytes[5]] ^ cTables[1][bytes[6]]
+			^ cTables[0][bytes[7]];
+	}
+	for (; size > 0; --size, ++bytes) {
+		crc = (crc >> 8) ^ cTables[0][(crc ^ *bytes) & 0xffU];
+	}
+	return ~crc;
+}
+
+} /*namespace tools*/
+} /*namespace tstorage*/
@@ -0,0 +1,27 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_TOOLS_CRC32C_H
+#define D_TSTORAGE_TOOLS_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tstorage {
+namespace tools {
+
+/**
+ * @brief Computes the CRC-32C (Castagnoli) checksum of `size` bytes,
+ * continuing from `crc`, the checksum of the preceding bytes.
+ *
+ * Table-driven, eight bytes per step, which keeps well ahead of a disk.
+ */
+std::uint32_t crc32c(const void* data, std::size_t size, std::uint32_t crc = 0);
+
+} /*namespace tools*/
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,201 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+#include <tstorageclient++/BlobRecordsSet.h>
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/ResponseAcq.h>
+
+#include "DumpFormat.h"
+#include "DumpWriter.h"
+#include "Utils.h"
+
+using namespace tstorage;
+using namespace tstorage::tools;
+
+namespace {
+
+constexpr std::size_t cMaxJobs = 256;
+
+struct Options
+{
+	std::string addr = cDefaultAddr;
+	std::uint16_t port = cDefaultPort;
+	Key keyMin = cKeyMin;
+	Key keyMax = cKeyMax;
+	std::size_t jobs = 1;
+	std::size_t chunkSize = cDefaultChunkSize;
+	bool compress = false;
+	std::string prefix;
+};
+
+void printHelp()
+{
+	std::cout
+		<< "Usage: tstorage-dump [options] <prefix>\n"
+		   "\n"
+		   "Dumps the records in the right-open key-interval [ <min>, <max> ) of a\n"
+		   "TStorage instance to <prefix>.<i>.tsd, one file per shard of the CID\n"
+		   "range, each dumped over a connection of its own.\n"
+		   "\n"
+		   "Options:\n"
+		   "  -a, --addr <host>        server address (default: localhost)\n"
+		   "  -p, --port <port>        server port (default: 2025)\n"
+		   "  -m, --min <c,m,mo,cap,acq>  lower key (default: the smallest key)\n"
+		   "  -M, --max <c,m,mo,cap,acq>  upper key (default: the largest key)\n"
+		   "  -j, --jobs <n>           amount of shards (default: 1)\n"
+		   "  -c, --chunk-size <KiB>   raw size of a chunk (default: 1024)\n"
+		   "  -z, --compress           compress the chunks\n"
+		   "  -h, --help               print this help\n"
+		<< std::flush;
+}
+
+bool parseOptions(const int argc, char* const* const argv, Options& oOptions)
+{
+	const struct option longOptions[] = {
+		{"addr", required_argument, nullptr, 'a'},
+		{"port", required_argument, nullptr, 'p'},
+		{"min", required_argument, nullptr, 'm'},
+		{"max", required_argument, nullptr, 'M'},
+		{"jobs", required_argument, nullptr, 'j'},
+		{"chunk-size", required_argument, nullptr, 'c'},
+		{"compress", no_argument, nullptr, 'z'},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0},
+	};
+	int opt = 0;
+	while ((opt = getopt_long(argc, argv, "a:p:m:M:j:c:zh", longOptions, nullptr)) != -1) {
+		bool valid = true;
+		switch (opt) {
+			case 'a':
+				oOptions.addr = optarg;
+				break;
+			case 'p':
+				valid = parseUInt16(optarg, oOptions.port);
+				break;
+			case 'm':
+				valid = parseKey(optarg, oOptions.keyMin);
+				break;
+			case 'M':
+				valid = parseKey(optarg, oOptions.keyMax);
+				break;
+			case 'j':
+				valid = parseSize(optarg, oOptions.jobs) && oOptions.jobs > 0
+					&& oOptions.jobs <= cMaxJobs;
+				break;
+			case 'c':
+				valid = parseSize(optarg, oOptions.chunkSize) && oOptions.chunkSize > 0
+					&& oOptions.chunkSize <= cMaxChunkSize / 1024;
+				oOptions.chunkSize *= 1024;
+				break;
+			case 'z':
+				oOptions.compress = true;
+				break;
+			default:
+				return false;
+		}
+		if (!valid) {
+			std::cerr << "tstorage-dump: invalid value of -" << static_cast<char>(opt)
+					  << ": " << optarg << std::endl;
+			return false;
+		}
+	}
+	if (optind + 1 != argc) {
+		return false;
+	}
+	oOptions.prefix = argv[optind];
+	return true;
+}
+
+/** @brief Dumps one shard, reporting the outcome. */
+bool dumpShard(const Options& options, const Key& keyMin, const Key& keyMax, const std::string& path,
+	std::mutex& logMutex)
+{
+	DumpWriter writer(options.chunkSize, options.compress);
+	Channel<std::string> channel(
+		options.addr, options.port, std::make_unique<RawPayload>(), cChannelBufferSize);
+
+	std::string error;
+	Response res = channel.connect();
+	if (!res.success()) {
+		error = "cannot connect: " + std::to_string(static_cast<int>(res.status()));
+	} else if (!writer.open(path)) {
+		error = writer.error();
+	} else {
+		bool written = true;
+		res = channel.getStreamBlob(keyMin, keyMax, [&](BlobRecordsSet& records) {
+			// The stream cannot be cancelled, hence it is drained after a
+			// failed write.
+			for (std::size_t i = 0; written && i < records.size(); ++i) {
+				written = writer.append(records.key(i), records.payload(i), records.payloadSize(i));
+			}
+		});
+		if (!written) {
+			error = writer.error();
+		} else if (!res.success()) {
+			error = "GET failed: " + std::to_string(static_cast<int>(res.status()));
+		} else if (!writer.finish()) {
+			error = writer.error();
+		}
+	}
+	(void)channel.close();
+
+	std::lock_guard<std::mutex> lock(logMutex);
+	if (!error.empty()) {
+		std::cerr << "tstorage-dump: " << path << ": " << error << std::endl;
+		return false;
+	}
+	std::cerr << "tstorage-dump: " << path << ": " << writer.records() << " records, "
+			  << writer.bytesWritten() << " bytes" << std::endl;
+	return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printHelp();
+		return 2;
+	}
+
+	const std::vector<std::int32_t> bounds =
+		splitCids(options.keyMin, options.keyMax, options.jobs);
+	const std::size_t shards = bounds.size() - 1;
+	std::mutex logMutex;
+	std::vector<char> succeeded(shards, 0);
+	std::vector<std::thread> threads;
+	threads.reserve(shards);
+	for (std::size_t i = 0; i < shards; ++i) {
+		Key keyMin = options.keyMin;
+		Key keyMax = options.keyMax;
+		keyMin.cid = bounds[i];
+		keyMax.cid = bounds[i + 1];
+		threads.emplace_back([&, i, keyMin, keyMax]() {
+			succeeded[i] = dumpShard(options, keyMin, keyMax, shardPath(options.prefix, i), logMutex)
+				? 1
+				: 0;
+		});
+	}
+	bool success = true;
+	for (std::size_t i = 0; i < shards; ++i) {
+		threads[i].join();
+		success = success && succeeded[i] != 0;
+	}
+	return success ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_TOOLS_DUMPFORMAT_H
+#define D_TSTORAGE_TOOLS_DUMPFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <tstorageclient++/DataTypes.h>
+
+/*
+ * A dump file holds the records of one key range, as returned by GET:
+ *
+ *   file header:   magic "TSDUMP\0\1" (8 B), version (u32), flags (u32)
+ *   chunk*:        record count (u32), raw size (u32), stored size (u32),
+ *                  CRC-32C of the stored bytes (u32), method (u8), 3 B zero,
+ *                  stored bytes
+ *   trailer:       a chunk of no records whose stored bytes are the total
+ *                  record count (u64)
+ *
+ * The raw bytes of a chunk are a sequence of records: cid (i32), mid (i64),
+ * moid (i32), cap (i64), acq (i64), payload size (u32), payload. The stored
+ * bytes are the raw ones, or their `LzPayloadCodec` block if smaller. All
+ * integers are little-endian, so dumps move between hosts. A file without
+ * the trailer is truncated.
+ */
+
+namespace tstorage {
+namespace tools {
+
+constexpr unsigned char cDumpMagic[8] = {'T', 'S', 'D', 'U', 'M', 'P', 0, 1};
+constexpr std::uint32_t cDumpVersion = 1;
+
+constexpr std::size_t cFileHeaderSize = 16;
+constexpr std::size_t cChunkHeaderSize = 20;
+constexpr std::size_t cRecordHeaderSize = 36;
+constexpr std::size_t cTrailerSize = 8;
+
+/** @brief The default target of the raw size of a chunk. */
+constexpr std::size_t cDefaultChunkSize = 1024UL * 1024;  // 1 MiB
+/** @brief The largest payload the server accepts. */
+constexpr std::size_t cMaxPayloadSize = 32UL * 1024 * 1024;  // 32 MiB
+/** @brief The largest raw size of a chunk a reader accepts. */
+constexpr std::size_t cMaxChunkSize = 64UL * 1024 * 1024;  // 64 MiB
+
+enum class ChunkMethod : std::uint8_t
+{
+	STORED = 0,
+	LZ = 1,
+};
+
+inline void storeLe32(unsigned char* const out, const std::uint32_t value)
+{
+	for (int i = 0; i < 4; ++i) {
+		out[i] = static_cast<unsigned char>(value >> (8 * i));
+	}
+}
+
+inline void storeLe64(unsigned char* const out, const std::uint64_t value)
+{
+	for (int i = 0; i < 8; ++i) {
+		out[i] = static_cast<unsigned char>(value >> (8 * i));
+	}
+}
+
+inline std::uint32_t loadLe32(const unsigned char* const in)
+{
+	std::uint32_t value = 0;
+	for (int i = 3; i >= 0; --i) {
+		value = (value << 8) | in[i];
+	}
+	return value;
+}
+
+inline std::uint64_t loadLe64(const unsigned char* const in)
+{
+	std::uint64_t value = 0;
+	for (int i = 7; i >= 0; --i) {
+		value = (value << 8) | in[i];
+	}
+	return value;
+}
+
+/** @brief Writes the first 32 bytes of a record header. */
+inline void storeKey(unsigned char* const out, const Key& key)
+{
+	storeLe32(out, static_cast<std::uint32_t>(key.cid));
+	storeLe64(out + 4, static_cast<std::uint64_t>(key.mid));
+	storeLe32(out + 12, static_cast<std::uint32_t>(key.moid));
+	storeLe64(out + 16, static_cast<std::uint64_t>(key.cap));
+	storeLe64(out + 24, static_cast<std::uint64_t>(key.acq));
+}
+
+/** @brief Reads the first 32 bytes of a record header. */
+inline Key loadKey(const unsigned char* const in)
+{
+	return Key(static_cast<std::int32_t>(loadLe32(in)),
+		static_cast<std::int64_t>(loadLe64(in + 4)),
+		static_cast<std::int32_t>(loadLe32(in + 12)),
+		static_cast<std::int64_t>(loadLe64(in + 16)),
+		static_cast<std::int64_t>(loadLe64(in + 24)));
+}
+
+} /*namespace tools*/
+} /*namespace tstorage*/
+
+#endif
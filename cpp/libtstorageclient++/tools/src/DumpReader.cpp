@@ -0,0 +1,162 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "DumpReader.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Crc32c.h"
+#include "DumpFormat.h"
+
+namespace tstorage {
+namespace tools {
+
+DumpReader::DumpReader() : mFd(-1), mRecords(0), mEnded(false) {}
+
+DumpReader::~DumpReader()
+{
+	if (mFd >= 0) {
+		(void)::close(mFd);
+	}
+}
+
+bool DumpReader::open(const std::string& path)
+{
+	if (mFd >= 0) {
+		(void)::close(mFd);
+	}
+	mPath = path;
+	mRecords = 0;
+	mEnded = false;
+	mError.clear();
+	mFd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (mFd < 0) {
+		return fail(std::string("cannot open: ") + std::strerror(errno));
+	}
+	(void)::posix_fadvise(mFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	unsigned char header[cFileHeaderSize];
+	if (!readAll(header, sizeof(header))) {
+		return false;
+	}
+	if (std::memcmp(header, cDumpMagic, sizeof(cDumpMagic)) != 0) {
+		return fail("not a dump file");
+	}
+	if (loadLe32(header + 8) != cDumpVersion) {
+		return fail("unsupported version " + std::to_string(loadLe32(header + 8)));
+	}
+	return true;
+}
+
+bool DumpReader::next(std::vector<RawRecord>& oRecords)
+{
+	oRecords.clear();
+	if (mFd < 0 || mEnded) {
+		return false;
+	}
+	unsigned char header[cChunkHeaderSize];
+	if (!readAll(header, sizeof(header))) {
+		return false;
+	}
+	const std::uint32_t count = loadLe32(header);
+	const std::size_t rawSize = loadLe32(header + 4);
+	const std::size_t storedSize = loadLe32(header + 8);
+	const std::uint32_t crc = loadLe32(header + 12);
+	const unsigned method = header[16];
+	if (rawSize > cMaxChunkSize || storedSize > rawSize
+		|| (method != unsigned(ChunkMethod::STORED) && method != unsigned(ChunkMethod::LZ))
+		|| (method == unsigned(ChunkMethod::STORED) && storedSize != rawSize)) {
+		return fail("malformed chunk header");
+	}
+
+	mStored.resize(storedSize);
+	if (!readAll(mStored.data(), storedSize)) {
+		return false;
+	}
+	if (crc32c(mStored.data(), storedSize) != crc) {
+		return fail("checksum mismatch");
+	}
+
+	if (count == 0) {
+		if (storedSize != cTrailerSize || loadLe64(mStored.data()) != mRecords) {
+			return fail("record count mismatch");
+		}
+		mEnded = true;
+		return false;
+	}
+	const unsigned char* raw = mStored.data();
+	if (method == unsigned(ChunkMethod::LZ)) {
+		mRaw.resize(rawSize);
+		if (!mCodec.decompress(mStored.data(), storedSize, mRaw.data(), rawSize)) {
+			return fail("malformed compressed chunk");
+		}
+		raw = mRaw.data();
+	}
+	return parseChunk(raw, rawSize, count, oRecords);
+}
+
+bool DumpReader::readAll(unsigned char* bytes, std::size_t size)
+{
+	while (size > 0) {
+		const ssize_t ret = ::read(mFd, bytes, size);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return fail(std::string("cannot read: ") + std::strerror(errno));
+		}
+		if (ret == 0) {
+			return fail("truncated");
+		}
+		bytes += ret;
+		size -= static_cast<std::size_t>(ret);
+	}
+	return true;
+}
+
+bool DumpReader::parseChunk(const unsigned char* raw,
+	std::size_t rawSize,
+	const std::uint32_t count,
+	std::vector<RawRecord>& oRecords)
+{
+	oRecords.reserve(count);
+	for (std::uint32_t i = 0; i < count; ++i) {
+		if (rawSize < cRecordHeaderSize) {
+			return fail("malformed chunk");
+		}
+		const std::size_t size = loadLe32(raw + 32);
+		if (size > rawSize - cRecordHeaderSize) {
+			return fail("malformed chunk");
+		}
+		oRecords.push_back(RawRecord{loadKey(raw), raw + cRecordHeaderSize, size});
+		raw += cRecordHeaderSize + size;
+		rawSize -= cRecordHeaderSize + size;
+	}
+	if (rawSize != 0) {
+		return fail("malformed chunk");
+	}
+	mRecords += count;
+	return true;
+}
+
+bool DumpReader::fail(const std::string& what)
+{
+	mError = mPath + ": " + what;
+	return false;
+}
+
+} /*namespace tools*/
+} /*namespace tstorage*/
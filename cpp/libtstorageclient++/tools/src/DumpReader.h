@@ -0,0 +1,81 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_TOOLS_DUMPREADER_H
+#define D_TSTORAGE_TOOLS_DUMPREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/PayloadCodec.h>
+
+namespace tstorage {
+namespace tools {
+
+/**
+ * @brief Reads the records of a dump file, a chunk at a time.
+ *
+ * Each chunk is verified against its checksum before its records are handed
+ * out, and the file against the record count of its trailer once read.
+ */
+class DumpReader
+{
+public:
+	DumpReader();
+	~DumpReader();
+
+	DumpReader(const DumpReader&) = delete;
+	DumpReader(DumpReader&&) = delete;
+	DumpReader& operator=(const DumpReader&) = delete;
+	DumpReader& operator=(DumpReader&&) = delete;
+
+	/** @brief Opens the file and checks its header. */
+	bool open(const std::string& path);
+	/**
+	 * @brief Reads the next chunk.
+	 *
+	 * @param[out] oRecords The records of the chunk, valid until the next
+	 * call.
+	 * @return `true` if a chunk has been read, `false` at the end of the file,
+	 * and on failure, in which case `error()` is not empty.
+	 */
+	bool next(std::vector<RawRecord>& oRecords);
+
+	/** @brief Returns the amount of records read. */
+	std::uint64_t records() const { return mRecords; }
+	/** @brief Returns the description of the failure, empty if none. */
+	const std::string& error() const { return mError; }
+
+private:
+	/** @brief Reads exactly `size` bytes. */
+	bool readAll(unsigned char* bytes, std::size_t size);
+	/** @brief Splits the raw bytes of a chunk into `oRecords`. */
+	bool parseChunk(const unsigned char* raw,
+		std::size_t rawSize,
+		std::uint32_t count,
+		std::vector<RawRecord>& oRecords);
+	/** @brief Records the failure and returns `false`. */
+	bool fail(const std::string& what);
+
+	int mFd;
+	std::string mPath;
+	/** @brief The stored bytes of the current chunk. */
+	std::vector<unsigned char> mStored;
+	/** @brief The decompressed bytes of the current chunk. */
+	std::vector<unsigned char> mRaw;
+	std::uint64_t mRecords;
+	bool mEnded;
+	LzPayloadCodec mCodec;
+	std::string mError;
+};
+
+} /*namespace tools*/
+} /*namespace tstorage*/
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "DumpWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "Crc32c.h"
+#include "DumpFormat.h"
+
+namespace tstorage {
+namespace tools {
+
+DumpWriter::DumpWriter(const std::size_t chunkSize, const bool compress)
+	: mChunkSize(std::min(std::max<std::size_t>(chunkSize, cRecordHeaderSize), cMaxChunkSize))
+	, mCompress(compress)
+	, mFd(-1)
+	, mChunkRecords(0)
+	, mRecords(0)
+	, mBytesWritten(0)
+{
+}
+
+DumpWriter::~DumpWriter()
+{
+	if (mFd >= 0) {
+		(void)::close(mFd);
+	}
+}
+
+bool DumpWriter::open(const std::string& path)
+{
+	if (mFd >= 0) {
+		(void)::close(mFd);
+	}
+	mPath = path;
+	mFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (mFd < 0) {
+		return fail("cannot create");
+	}
+	mChunk.assign(cChunkHeaderSize, 0);
+	mChunk.reserve(cChunkHeaderSize + mChunkSize);
+	mChunkRecords = 0;
+	mRecords = 0;
+	mBytesWritten = 0;
+
+	unsigned char header[cFileHeaderSize] = {};
+	std::memcpy(header, cDumpMagic, sizeof(cDumpMagic));
+	storeLe32(header + 8, cDumpVersion);
+	storeLe32(header + 12, 0);
+	return writeAll(header, sizeof(header));
+}
+
+bool DumpWriter::append(const Key& key, const void* const payload, const std::size_t size)
+{
+	if (mFd < 0) {
+		errno = EBADF;
+		return fail("not open");
+	}
+	if (size > cMaxPayloadSize) {
+		errno = EFBIG;
+		return fail("payload too large");
+	}
+	const std::size_t recordSize = cRecordHeaderSize + size;
+	if (mChunkRecords > 0 && mChunk.size() - cChunkHeaderSize + recordSize > mChunkSize
+		&& !flushChunk()) {
+		return false;
+	}
+
+	const std::size_t offset = mChunk.size();
+	mChunk.resize(offset + recordSize);
+	storeKey(mChunk.data() + offset, key);
+	storeLe32(mChunk.data() + offset + 32, static_cast<std::uint32_t>(size));
+	if (size > 0) {
+		std::memcpy(mChunk.data() + offset + cRecordHeaderSize, payload, size);
+	}
+	++mChunkRecords;
+	++mRecords;
+	return mChunk.size() - cChunkHeaderSize < mChunkSize || flushChunk();
+}
+
+bool DumpWriter::finish()
+{
+	if (mFd < 0) {
+		errno = EBADF;
+		return fail("not open");
+	}
+	if (!flushChunk()) {
+		return false;
+	}
+	std::vector<unsigned char> trailer(cChunkHeaderSize + cTrailerSize);
+	storeLe64(trailer.data() + cChunkHeaderSize, mRecords);
+	if (!writeChunk(trailer, 0, cTrailerSize, ChunkMethod::STORED)) {
+		return false;
+	}
+	const int fd = mFd;
+	mFd = -1;
+	if (::fsync(fd) != 0) {
+		(void)::close(fd);
+		return fail("cannot sync");
+	}
+	return ::close(fd) == 0 || fail("cannot close");
+}
+
+bool DumpWriter::flushChunk()
+{
+	if (mChunkRecords == 0) {
+		return true;
+	}
+	const std::size_t rawSize = mChunk.size() - cChunkHeaderSize;
+	bool written = false;
+	if (mCompress) {
+		// Compressed only if it saves something, so that incompressible
+		// payloads cost one failed attempt rather than a larger file.
+		mCompressed.resize(cChunkHeaderSize + rawSize);
+		const std::size_t blockSize = mCodec.compress(mChunk.data() + cChunkHeaderSize,
+			rawSize,
+			mCompressed.data() + cChunkHeaderSize,
+			rawSize - 1);
+		if (blockSize > 0) {
+			mCompressed.resize(cChunkHeaderSize + blockSize);
+			if (!writeChunk(mCompressed,
+					mChunkRecords,
+					static_cast<std::uint32_t>(rawSize),
+					ChunkMethod::LZ)) {
+				return false;
+			}
+			written = true;
+		}
+	}
+	if (!written
+		&& !writeChunk(mChunk,
+			mChunkRecords,
+			static_cast<std::uint32_t>(rawSize),
+			ChunkMethod::STORED)) {
+		return false;
+	}
+	mChunk.resize(cChunkHeaderSize);
+	mChunkRecords = 0;
+	return true;
+}
+
+bool DumpWriter::writeChunk(std::vector<unsigned char>& chunk,
+	const std::uint32_t records,
+	const std::uint32_t rawSize,
+	const ChunkMethod method)
+{
+	const std::size_t storedSize = chunk.size() - cChunkHeaderSize;
+	unsigned char* const header = chunk.data();
+	storeLe32(header, records);
+	storeLe32(header + 4, rawSize);
+	storeLe32(header + 8, static_cast<std::uint32_t>(storedSize));
+	storeLe32(header + 12, crc32c(header + cChunkHeaderSize, storedSize));
+	header[16] = static_cast<unsigned char>(method);
+	header[17] = header[18] = header[19] = 0;
+	return writeAll(chunk.data(), chunk.size());
+}
+
+bool DumpWriter::writeAll(const unsigned char* bytes, std::size_t size)
+{
+	while (size > 0) {
+		const ssize_t ret = ::write(mFd, bytes, size);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return fail("cannot write");
+		}
+		bytes += ret;
+		size -= static_cast<std::size_t>(ret);
+		mBytesWritten += static_cast<std::uint64_t>(ret);
+	}
+	return true;
+}
+
+bool DumpWriter::fail(const std::string& what)
+{
+	mError = mPath + ": " + what + ": " + std::strerror(errno);
+	return false;
+}
+
+} /*namespace tools*/
+} /*namespace tstorage*/
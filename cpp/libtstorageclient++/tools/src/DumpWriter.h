@@ -0,0 +1,91 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_TOOLS_DUMPWRITER_H
+#define D_TSTORAGE_TOOLS_DUMPWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/PayloadCodec.h>
+
+#include "DumpFormat.h"
+
+namespace tstorage {
+namespace tools {
+
+/**
+ * @brief Writes records to a dump file, a chunk at a time.
+ *
+ * A chunk is written with a single `write()` once its raw size reaches the
+ * chunk size. On failure, the methods return `false` and `error()` tells
+ * why; the file is left without its trailer.
+ */
+class DumpWriter
+{
+public:
+	/**
+	 * @param chunkSize The target raw size of a chunk.
+	 * @param compress `true` to compress the chunks with `LzPayloadCodec`.
+	 */
+	explicit DumpWriter(std::size_t chunkSize = cDefaultChunkSize, bool compress = false);
+	~DumpWriter();
+
+	DumpWriter(const DumpWriter&) = delete;
+	DumpWriter(DumpWriter&&) = delete;
+	DumpWriter& operator=(const DumpWriter&) = delete;
+	DumpWriter& operator=(DumpWriter&&) = delete;
+
+	/** @brief Creates or truncates the file and writes its header. */
+	bool open(const std::string& path);
+	/** @brief Appends a record. */
+	bool append(const Key& key, const void* payload, std::size_t size);
+	/** @brief Writes the last chunk and the trailer, and closes the file. */
+	bool finish();
+
+	/** @brief Returns the amount of records appended. */
+	std::uint64_t records() const { return mRecords; }
+	/** @brief Returns the amount of bytes written to the file. */
+	std::uint64_t bytesWritten() const { return mBytesWritten; }
+	/** @brief Returns the description of the last failure. */
+	const std::string& error() const { return mError; }
+
+private:
+	/** @brief Writes the buffered records as a chunk, if any. */
+	bool flushChunk();
+	/** @brief Fills in the header at the front of `chunk` and writes it. */
+	bool writeChunk(std::vector<unsigned char>& chunk,
+		std::uint32_t records,
+		std::uint32_t rawSize,
+		ChunkMethod method);
+	/** @brief Writes `size` bytes, retrying partial writes. */
+	bool writeAll(const unsigned char* bytes, std::size_t size);
+	/** @brief Records `what` along with `errno`, and returns `false`. */
+	bool fail(const std::string& what);
+
+	std::size_t mChunkSize;
+	bool mCompress;
+	int mFd;
+	std::string mPath;
+	/** @brief The header of the chunk being filled, followed by its
+	 * records. */
+	std::vector<unsigned char> mChunk;
+	/** @brief The header of a compressed chunk, followed by its block. */
+	std::vector<unsigned char> mCompressed;
+	std::uint32_t mChunkRecords;
+	std::uint64_t mRecords;
+	std::uint64_t mBytesWritten;
+	LzPayloadCodec mCodec;
+	std::string mError;
+};
+
+} /*namespace tools*/
+} /*namespace tstorage*/
+
+#endif
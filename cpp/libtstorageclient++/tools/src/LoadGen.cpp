@@ -0,0 +1,607 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+#include <tstorageclient++/BlobRecordsSet.h>
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/Response.h>
+#include <tstorageclient++/ResponseAcq.h>
+
+#include "Utils.h"
+
+using namespace tstorage;
+using namespace tstorage::tools;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t cMaxThreads = 1024;
+/** @brief The overhead of a PUTA record and its batch inside the buffer. */
+constexpr std::size_t cPutOverhead = 56;
+
+/** @brief How the CIDs of the records of a request follow each other. */
+enum class Interleave
+{
+	/** @brief Grouped by CID, i.e. one batch per CID. */
+	SEQUENTIAL,
+	/** @brief A different CID in every record, i.e. one batch per record. */
+	ROUND_ROBIN,
+	/** @brief Drawn at random. */
+	RANDOM,
+};
+
+/** @brief The payload sizes, drawn uniformly from a list or a range. */
+struct PayloadSizes
+{
+	std::vector<std::size_t> choices{64};
+	std::size_t min = 0;
+	std::size_t max = 0;
+
+	std::size_t largest() const
+	{
+		return choices.empty() ? max : *std::max_element(choices.begin(), choices.end());
+	}
+
+	std::size_t draw(std::mt19937_64& rng) const
+	{
+		if (choices.empty()) {
+			return std::uniform_int_distribution<std::size_t>(min, max)(rng);
+		}
+		return choices[rng() % choices.size()];
+	}
+};
+
+struct Options
+{
+	std::string addr = cDefaultAddr;
+	std::uint16_t port = cDefaultPort;
+	std::size_t threads = 1;
+	std::size_t connections = 0;
+	std::size_t seconds = 10;
+	std::size_t records = 1000;
+	PayloadSizes payloads;
+	std::size_t cids = 1;
+	std::int32_t cidBase = 0;
+	Interleave interleave = Interleave::SEQUENTIAL;
+	double writeRatio = 1.0;
+	bool puta = false;
+	bool json = false;
+	std::size_t memoryLimit = 1024UL * 1024;
+};
+
+/** @brief The statistics of one kind of requests. */
+struct Counters
+{
+	std::uint64_t requests = 0;
+	std::uint64_t records = 0;
+	std::uint64_t bytes = 0;
+	std::uint64_t errors = 0;
+	/** @brief The PUT/A batches, i.e. the CID changes within requests. */
+	std::uint64_t batches = 0;
+	LatencyHistogram latencies{};
+
+	void record(const std::uint64_t latencyUs)
+	{
+		++latencies.counts[LatencyHistogram::bucketOf(latencyUs)];
+		++latencies.count;
+		latencies.totalUs += latencyUs;
+		latencies.maxUs = std::max(latencies.maxUs, latencyUs);
+	}
+
+	void merge(const Counters& other)
+	{
+		requests += other.requests;
+		records += other.records;
+		bytes += other.bytes;
+		errors += other.errors;
+		batches += other.batches;
+		for (std::size_t i = 0; i < LatencyHistogram::cBuckets; ++i) {
+			latencies.counts[i] += other.latencies.counts[i];
+		}
+		latencies.count += other.latencies.count;
+		latencies.totalUs += other.latencies.totalUs;
+		latencies.maxUs = std::max(latencies.maxUs, other.latencies.maxUs);
+	}
+
+	void reset() { *this = Counters(); }
+};
+
+/** @brief The statistics of a worker since the last report. */
+struct WorkerStats
+{
+	std::mutex mutex;
+	Counters writes;
+	Counters reads;
+};
+
+void printHelp()
+{
+	std::cout
+		<< "Usage: tstorage-loadgen [options]\n"
+		   "\n"
+		   "Stores and reads records of a TStorage instance for a given time, and\n"
+		   "reports the throughput and the latency percentiles of every second and\n"
+		   "of the whole run.\n"
+		   "\n"
+		   "Options:\n"
+		   "  -a, --addr <host>          server address (default: localhost)\n"
+		   "  -p, --port <port>          server port (default: 2025)\n"
+		   "  -t, --threads <n>          worker threads (default: 1)\n"
+		   "  -n, --connections <n>      connections, spread over the threads\n"
+		   "                             (default: one per thread)\n"
+		   "  -d, --duration <s>         duration in seconds (default: 10)\n"
+		   "  -r, --records <n>          records per request (default: 1000)\n"
+		   "  -s, --payload <sizes>      payload sizes: N, MIN-MAX for a uniform\n"
+		   "                             range or A,B,... for a list; K and M\n"
+		   "                             suffixes are accepted (default: 64)\n"
+		   "  -c, --cids <n>             CIDs per request (default: 1)\n"
+		   "  -b, --cid-base <cid>       the first CID (default: 0)\n"
+		   "  -i, --interleave <how>     order of the CIDs in a request: sequential,\n"
+		   "                             round-robin or random (default: sequential)\n"
+		   "  -w, --write-ratio <f>      fraction of requests which store records;\n"
+		   "                             the others read back the latest stored ones\n"
+		   "                             (default: 1)\n"
+		   "  -A, --puta                 store with PUTA rather than PUT\n"
+		   "  -m, --memory-limit <size>  memory limit of a channel (default: 1M)\n"
+		   "  -J, --json                 report in JSON Lines\n"
+		   "  -h, --help                 print this help\n"
+		<< std::flush;
+}
+
+bool parsePayloadSizes(const std::string& str, PayloadSizes& oSizes)
+{
+	PayloadSizes sizes;
+	sizes.choices.clear();
+	const std::size_t dash = str.find('-');
+	if (dash != std::string::npos) {
+		if (!parseByteSize(str.substr(0, dash), sizes.min)
+			|| !parseByteSize(str.substr(dash + 1), sizes.max) || sizes.min > sizes.max) {
+			return false;
+		}
+		oSizes = sizes;
+		return true;
+	}
+	std::istringstream list(str);
+	std::string item;
+	while (std::getline(list, item, ',')) {
+		std::size_t size = 0;
+		if (!parseByteSize(item, size)) {
+			return false;
+		}
+		sizes.choices.push_back(size);
+	}
+	if (sizes.choices.empty()) {
+		return false;
+	}
+	oSizes = sizes;
+	return true;
+}
+
+bool parseInterleave(const std::string& str, Interleave& oInterleave)
+{
+	if (str == "sequential") {
+		oInterleave = Interleave::SEQUENTIAL;
+	} else if (str == "round-robin") {
+		oInterleave = Interleave::ROUND_ROBIN;
+	} else if (str == "random") {
+		oInterleave = Interleave::RANDOM;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool parseRatio(const std::string& str, double& oRatio)
+{
+	std::istringstream in(str);
+	double ratio = 0;
+	if (!(in >> ratio) || !in.eof() || ratio < 0 || ratio > 1) {
+		return false;
+	}
+	oRatio = ratio;
+	return true;
+}
+
+bool parseOptions(const int argc, char* const* const argv, Options& oOptions)
+{
+	const struct option longOptions[] = {
+		{"addr", required_argument, nullptr, 'a'},
+		{"port", required_argument, nullptr, 'p'},
+		{"threads", required_argument, nullptr, 't'},
+		{"connections", required_argument, nullptr, 'n'},
+		{"duration", required_argument, nullptr, 'd'},
+		{"records", required_argument, nullptr, 'r'},
+		{"payload", required_argument, nullptr, 's'},
+		{"cids", required_argument, nullptr, 'c'},
+		{"cid-base", required_argument, nullptr, 'b'},
+		{"interleave", required_argument, nullptr, 'i'},
+		{"write-ratio", required_argument, nullptr, 'w'},
+		{"puta", no_argument, nullptr, 'A'},
+		{"memory-limit", required_argument, nullptr, 'm'},
+		{"json", no_argument, nullptr, 'J'},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0},
+	};
+	int opt = 0;
+	while ((opt = getopt_long(
+				argc, argv, "a:p:t:n:d:r:s:c:b:i:w:Am:Jh", longOptions, nullptr))
+		!= -1) {
+		bool valid = true;
+		std::size_t cidBase = 0;
+		switch (opt) {
+			case 'a':
+				oOptions.addr = optarg;
+				break;
+			case 'p':
+				valid = parseUInt16(optarg, oOptions.port);
+				break;
+			case 't':
+				valid = parseSize(optarg, oOptions.threads) && oOptions.threads > 0
+					&& oOptions.threads <= cMaxThreads;
+				break;
+			case 'n':
+				valid = parseSize(optarg, oOptions.connections) && oOptions.connections > 0
+					&& oOptions.connections <= cMaxThreads * 16;
+				break;
+			case 'd':
+				valid = parseSize(optarg, oOptions.seconds) && oOptions.seconds > 0;
+				break;
+			case 'r':
+				valid = parseSize(optarg, oOptions.records) && oOptions.records > 0;
+				break;
+			case 's':
+				valid = parsePayloadSizes(optarg, oOptions.payloads);
+				break;
+			case 'c':
+				valid = parseSize(optarg, oOptions.cids) && oOptions.cids > 0
+					&& oOptions.cids <= std::size_t(Key::cCidMax);
+				break;
+			case 'b':
+				valid = parseSize(optarg, cidBase) && cidBase < std::size_t(Key::cCidMax);
+				oOptions.cidBase = static_cast<std::int32_t>(cidBase);
+				break;
+			case 'i':
+				valid = parseInterleave(optarg, oOptions.interleave);
+				break;
+			case 'w':
+				valid = parseRatio(optarg, oOptions.writeRatio);
+				break;
+			case 'A':
+				oOptions.puta = true;
+				break;
+			case 'm':
+				valid = parseByteSize(optarg, oOptions.memoryLimit);
+				break;
+			case 'J':
+				oOptions.json = true;
+				break;
+			default:
+				return false;
+		}
+		if (!valid) {
+			std::cerr << "tstorage-loadgen: invalid value of -" << static_cast<char>(opt)
+					  << ": " << optarg << std::endl;
+			return false;
+		}
+	}
+	if (optind != argc) {
+		return false;
+	}
+	if (oOptions.connections == 0) {
+		oOptions.connections = oOptions.threads;
+	}
+	if (oOptions.connections < oOptions.threads) {
+		std::cerr << "tstorage-loadgen: fewer connections than threads" << std::endl;
+		return false;
+	}
+	if (std::int64_t(oOptions.cidBase) + std::int64_t(oOptions.cids) > Key::cCidMax) {
+		std::cerr << "tstorage-loadgen: CIDs out of range" << std::endl;
+		return false;
+	}
+	oOptions.memoryLimit =
+		std::max(oOptions.memoryLimit, oOptions.payloads.largest() + cPutOverhead);
+	return true;
+}
+
+/**
+ * @brief Issues requests until `stop` is set, over its channels in turn.
+ *
+ * The records of a worker have the MID of its index, so that the workers
+ * store distinct keys in the same CIDs, and consecutive CAPs, so that no
+ * record overwrites an earlier one. A read fetches the records of the latest
+ * write of the worker.
+ */
+void runWorker(const Options& options,
+	const std::size_t index,
+	const std::size_t nChannels,
+	const std::string& payload,
+	WorkerStats& stats,
+	const std::atomic<bool>& stop)
+{
+	std::vector<std::unique_ptr<Channel<std::string>>> channels;
+	for (std::size_t i = 0; i < nChannels; ++i) {
+		channels.push_back(std::make_unique<Channel<std::string>>(options.addr,
+			options.port,
+			std::make_unique<RawPayload>(),
+			options.memoryLimit));
+	}
+	std::mt19937_64 rng(index + 1);
+	std::uniform_real_distribution<double> ratio(0, 1);
+	std::vector<RawRecord> records(options.records);
+	const auto mid = static_cast<Key::MidT>(index);
+	// Distinct from the CAPs of earlier runs.
+	Key::CapT cap = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch())
+						.count()
+		* 1000;
+	Key::CapT writtenMin = cap;
+	Key::CapT writtenMax = cap;
+
+	for (std::size_t n = 0; !stop.load(std::memory_order_relaxed); ++n) {
+		Channel<std::string>& channel = *channels[n % channels.size()];
+		const bool write = writtenMin == writtenMax || ratio(rng) < options.writeRatio;
+		if (!channel.connected() && channel.connect().error()) {
+			{
+				std::lock_guard<std::mutex> lock(stats.mutex);
+				++(write ? stats.writes : stats.reads).errors;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			continue;
+		}
+
+		std::uint64_t bytes = 0;
+		std::uint64_t count = 0;
+		std::uint64_t batches = 0;
+		Clock::time_point start;
+		result_t status = result_t::OK;
+		if (write) {
+			for (std::size_t i = 0; i < records.size(); ++i) {
+				std::size_t cidOffset = 0;
+				switch (options.interleave) {
+					case Interleave::SEQUENTIAL:
+						cidOffset = i * options.cids / records.size();
+						break;
+					case Interleave::ROUND_ROBIN:
+						cidOffset = i % options.cids;
+						break;
+					case Interleave::RANDOM:
+						cidOffset = rng() % options.cids;
+						break;
+				}
+				const std::size_t size = options.payloads.draw(rng);
+				records[i] = RawRecord{
+					Key(options.cidBase + static_cast<Key::CidT>(cidOffset), mid, 0, cap + i, cap + i),
+					payload.data(),
+					size};
+				bytes += size;
+			}
+			count = records.size();
+			const std::uint64_t batchesBefore = channel.stats().putBatches;
+			start = Clock::now();
+			status = (options.puta ? channel.putaRaw(records.cbegin(), records.cend())
+								   : channel.putRaw(records.cbegin(), records.cend()))
+						 .status();
+			batches = channel.stats().putBatches - batchesBefore;
+			writtenMin = cap;
+			cap += static_cast<Key::CapT>(records.size());
+			writtenMax = cap;
+		} else {
+			const Key keyMin(options.cidBase, mid, Key::cMoidMin, writtenMin, Key::cAcqMin);
+			const Key keyMax(options.cidBase + static_cast<Key::CidT>(options.cids),
+				mid + 1,
+				Key::cMoidMax,
+				writtenMax,
+				Key::cAcqMax);
+			start = Clock::now();
+			status = channel
+						 .getStreamBlob(keyMin,
+							 keyMax,
+							 [&](BlobRecordsSet& batch) {
+								 count += batch.size();
+								 for (std::size_t i = 0; i < batch.size(); ++i) {
+									 bytes += batch.payloadSize(i);
+								 }
+							 })
+						 .status();
+		}
+		const auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+			Clock::now() - start)
+								   .count();
+
+		std::lock_guard<std::mutex> lock(stats.mutex);
+		Counters& counters = write ? stats.writes : stats.reads;
+		if (status != result_t::OK) {
+			++counters.errors;
+			continue;
+		}
+		++counters.requests;
+		counters.records += count;
+		counters.bytes += bytes;
+		counters.batches += batches;
+		counters.record(static_cast<std::uint64_t>(latencyUs));
+	}
+	for (std::unique_ptr<Channel<std::string>>& channel : channels) {
+		(void)channel->close();
+	}
+}
+
+void printJsonCounters(std::ostream& out, const Counters& counters, const double seconds)
+{
+	const LatencyHistogram& lat = counters.latencies;
+	out << "{\"requests\":" << counters.requests << ",\"records\":" << counters.records
+		<< ",\"bytes\":" << counters.bytes << ",\"errors\":" << counters.errors
+		<< ",\"requests_per_s\":" << counters.requests / seconds
+		<< ",\"records_per_s\":" << counters.records / seconds
+		<< ",\"mib_per_s\":" << counters.bytes / seconds / (1024 * 1024)
+		<< ",\"batches\":" << counters.batches << ",\"latency_us\":{\"mean\":" << lat.meanUs()
+		<< ",\"p50\":" << lat.percentileUs(0.5) << ",\"p90\":" << lat.percentileUs(0.9)
+		<< ",\"p99\":" << lat.percentileUs(0.99) << ",\"p999\":" << lat.percentileUs(0.999)
+		<< ",\"max\":" << lat.maxUs << "}}";
+}
+
+void printInterval(const Options& options,
+	const std::size_t second,
+	const Counters& writes,
+	const Counters& reads,
+	const double seconds)
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(1);
+	if (options.json) {
+		out << "{\"type\":\"interval\",\"t\":" << second << ",\"write\":";
+		printJsonCounters(out, writes, seconds);
+		out << ",\"read\":";
+		printJsonCounters(out, reads, seconds);
+		out << "}\n";
+	} else {
+		if (second == 1) {
+			out << std::setw(5) << "t[s]" << std::setw(10) << "put/s" << std::setw(12)
+				<< "records/s" << std::setw(9) << "MiB/s" << std::setw(10) << "p50[us]"
+				<< std::setw(10) << "p99[us]" << std::setw(10) << "get/s" << std::setw(12)
+				<< "records/s" << std::setw(10) << "p50[us]" << std::setw(10) << "p99[us]"
+				<< std::setw(8) << "errors" << "\n";
+		}
+		out << std::setw(5) << second << std::setw(10) << writes.requests / seconds
+			<< std::setw(12) << writes.records / seconds << std::setw(9)
+			<< writes.bytes / seconds / (1024 * 1024) << std::setw(10)
+			<< writes.latencies.percentileUs(0.5) << std::setw(10)
+			<< writes.latencies.percentileUs(0.99) << std::setw(10) << reads.requests / seconds
+			<< std::setw(12) << reads.records / seconds << std::setw(10)
+			<< reads.latencies.percentileUs(0.5) << std::setw(10)
+			<< reads.latencies.percentileUs(0.99) << std::setw(8)
+			<< writes.errors + reads.errors << "\n";
+	}
+	std::cout << out.str() << std::flush;
+}
+
+void printSummary(
+	const Options& options, const Counters& writes, const Counters& reads, const double seconds)
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(1);
+	if (options.json) {
+		out << "{\"type\":\"summary\",\"duration_s\":" << seconds << ",\"write\":";
+		printJsonCounters(out, writes, seconds);
+		out << ",\"read\":";
+		printJsonCounters(out, reads, seconds);
+		out << "}\n";
+	} else {
+		out << "\n"
+			<< std::setw(6) << "op" << std::setw(11) << "requests" << std::setw(12)
+			<< "records/s" << std::setw(9) << "MiB/s" << std::setw(10) << "mean[us]"
+			<< std::setw(10) << "p50[us]" << std::setw(10) << "p90[us]" << std::setw(10)
+			<< "p99[us]" << std::setw(11) << "p99.9[us]" << std::setw(10) << "max[us]"
+			<< std::setw(8) << "errors" << std::setw(13) << "batches/req" << "\n";
+		const char* const names[] = {options.puta ? "puta" : "put", "get"};
+		const Counters* const counters[] = {&writes, &reads};
+		for (std::size_t i = 0; i < 2; ++i) {
+			const Counters& c = *counters[i];
+			const LatencyHistogram& lat = c.latencies;
+			out << std::setw(6) << names[i] << std::setw(11) << c.requests << std::setw(12)
+				<< c.records / seconds << std::setw(9) << c.bytes / seconds / (1024 * 1024)
+				<< std::setw(10) << lat.meanUs() << std::setw(10) << lat.percentileUs(0.5)
+				<< std::setw(10) << lat.percentileUs(0.9) << std::setw(10)
+				<< lat.percentileUs(0.99) << std::setw(11) << lat.percentileUs(0.999)
+				<< std::setw(10) << lat.maxUs << std::setw(8) << c.errors << std::setw(13)
+				<< (c.requests == 0 ? 0.0 : double(c.batches) / double(c.requests)) << "\n";
+		}
+	}
+	std::cout << out.str() << std::flush;
+}
+
+/** @brief Moves the statistics of the workers into `oWrites` and
+ * `oReads`. */
+void drain(std::vector<WorkerStats>& stats, Counters& oWrites, Counters& oReads)
+{
+	oWrites.reset();
+	oReads.reset();
+	for (WorkerStats& worker : stats) {
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		oWrites.merge(worker.writes);
+		oReads.merge(worker.reads);
+		worker.writes.reset();
+		worker.reads.reset();
+	}
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printHelp();
+		return 2;
+	}
+
+	std::string payload(options.payloads.largest(), '\0');
+	std::mt19937_64 rng(0);
+	for (char& byte : payload) {
+		byte = static_cast<char>(rng());
+	}
+
+	std::atomic<bool> stop(false);
+	std::vector<WorkerStats> stats(options.threads);
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0; i < options.threads; ++i) {
+		const std::size_t nChannels = options.connections / options.threads
+			+ (i < options.connections % options.threads ? 1 : 0);
+		threads.emplace_back([&, i, nChannels]() {
+			runWorker(options, i, nChannels, payload, stats[i], stop);
+		});
+	}
+
+	const Clock::time_point start = Clock::now();
+	Clock::time_point last = start;
+	Counters writes;
+	Counters reads;
+	Counters totalWrites;
+	Counters totalReads;
+	for (std::size_t second = 1; second <= options.seconds; ++second) {
+		std::this_thread::sleep_until(start + std::chrono::seconds(second));
+		const Clock::time_point now = Clock::now();
+		drain(stats, writes, reads);
+		printInterval(options,
+			second,
+			writes,
+			reads,
+			std::chrono::duration<double>(now - last).count());
+		totalWrites.merge(writes);
+		totalReads.merge(reads);
+		last = now;
+	}
+	stop = true;
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	// The requests in flight at the end count towards the whole run.
+	drain(stats, writes, reads);
+	totalWrites.merge(writes);
+	totalReads.merge(reads);
+	printSummary(options,
+		totalWrites,
+		totalReads,
+		std::chrono::duration<double>(Clock::now() - start).count());
+	return totalWrites.errors + totalReads.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/Response.h>
+
+#include "DumpReader.h"
+#include "Utils.h"
+
+using namespace tstorage;
+using namespace tstorage::tools;
+
+namespace {
+
+constexpr std::size_t cMaxJobs = 256;
+
+struct Options
+{
+	std::string addr = cDefaultAddr;
+	std::uint16_t port = cDefaultPort;
+	std::size_t jobs = 1;
+	std::vector<std::string> files;
+};
+
+void printHelp()
+{
+	std::cout << "Usage: tstorage-restore [options] <file>...\n"
+				 "\n"
+				 "Stores the records of dump files made by tstorage-dump in a TStorage\n"
+				 "instance, with their original acquisition times. The files are\n"
+				 "restored in parallel, each over one of the connections.\n"
+				 "\n"
+				 "Options:\n"
+				 "  -a, --addr <host>   server address (default: localhost)\n"
+				 "  -p, --port <port>   server port (default: 2025)\n"
+				 "  -j, --jobs <n>      amount of connections (default: 1)\n"
+				 "  -h, --help          print this help\n"
+			  << std::flush;
+}
+
+bool parseOptions(const int argc, char* const* const argv, Options& oOptions)
+{
+	const struct option longOptions[] = {
+		{"addr", required_argument, nullptr, 'a'},
+		{"port", required_argument, nullptr, 'p'},
+		{"jobs", required_argument, nullptr, 'j'},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0},
+	};
+	int opt = 0;
+	while ((opt = getopt_long(argc, argv, "a:p:j:h", longOptions, nullptr)) != -1) {
+		bool valid = true;
+		switch (opt) {
+			case 'a':
+				oOptions.addr = optarg;
+				break;
+			case 'p':
+				valid = parseUInt16(optarg, oOptions.port);
+				break;
+			case 'j':
+				valid = parseSize(optarg, oOptions.jobs) && oOptions.jobs > 0
+					&& oOptions.jobs <= cMaxJobs;
+				break;
+			default:
+				return false;
+		}
+		if (!valid) {
+			std::cerr << "tstorage-restore: invalid value of -" << static_cast<char>(opt)
+					  << ": " << optarg << std::endl;
+			return false;
+		}
+	}
+	oOptions.files.assign(argv + optind, argv + argc);
+	return !oOptions.files.empty();
+}
+
+/** @brief Restores one file over `channel`, reporting the outcome. */
+bool restoreFile(Channel<std::string>& channel, const std::string& path, std::mutex& logMutex)
+{
+	DumpReader reader;
+	std::vector<RawRecord> records;
+	std::string error;
+	if (!channel.connected()) {
+		const Response res = channel.connect();
+		if (!res.success()) {
+			error = "cannot connect: " + std::to_string(static_cast<int>(res.status()));
+		}
+	}
+	if (error.empty() && reader.open(path)) {
+		while (reader.next(records)) {
+			const Response res = channel.putaRaw(records.cbegin(), records.cend());
+			if (!res.success()) {
+				error = "PUTA failed: " + std::to_string(static_cast<int>(res.status()));
+				(void)channel.close();
+				break;
+			}
+		}
+	}
+	if (error.empty()) {
+		error = reader.error();
+	}
+
+	std::lock_guard<std::mutex> lock(logMutex);
+	if (!error.empty()) {
+		std::cerr << "tstorage-restore: " << path << ": " << error << std::endl;
+		return false;
+	}
+	std::cerr << "tstorage-restore: " << path << ": " << reader.records() << " records"
+			  << std::endl;
+	return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions(argc, argv, options)) {
+		printHelp();
+		return 2;
+	}
+
+	std::atomic<std::size_t> nextFile(0);
+	std::atomic<bool> success(true);
+	std::mutex logMutex;
+	std::vector<std::thread> threads;
+	const std::size_t jobs = std::min(options.jobs, options.files.size());
+	for (std::size_t i = 0; i < jobs; ++i) {
+		threads.emplace_back([&]() {
+			Channel<std::string> channel(
+				options.addr, options.port, std::make_unique<RawPayload>(), cChannelBufferSize);
+			for (std::size_t file = nextFile++; file < options.files.size(); file = nextFile++) {
+				if (!restoreFile(channel, options.files[file], logMutex)) {
+					success = false;
+				}
+			}
+			(void)channel.close();
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	return success ? 0 : 1;
+}
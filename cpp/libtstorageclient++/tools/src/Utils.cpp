@@ -0,0 +1,125 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include "Utils.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+namespace tstorage {
+namespace tools {
+
+namespace {
+
+bool parseInt64(const char* const str, const char** oEnd, std::int64_t& oVal)
+{
+	char* end = nullptr;
+	errno = 0;
+	const long long value = std::strtoll(str, &end, 0);
+	if (errno != 0 || end == str) {
+		return false;
+	}
+	oVal = value;
+	*oEnd = end;
+	return true;
+}
+
+}  // namespace
+
+bool parseUInt16(const std::string& str, std::uint16_t& oVal)
+{
+	std::size_t value = 0;
+	if (!parseSize(str, value) || value > std::numeric_limits<std::uint16_t>::max()) {
+		return false;
+	}
+	oVal = static_cast<std::uint16_t>(value);
+	return true;
+}
+
+bool parseSize(const std::string& str, std::size_t& oVal)
+{
+	const char* end = nullptr;
+	std::int64_t value = 0;
+	if (!parseInt64(str.c_str(), &end, value) || *end != '\0' || value < 0) {
+		return false;
+	}
+	oVal = static_cast<std::size_t>(value);
+	return true;
+}
+
+bool parseByteSize(const std::string& str, std::size_t& oVal)
+{
+	std::string digits = str;
+	std::size_t multiplier = 1;
+	if (!digits.empty() && (digits.back() == 'K' || digits.back() == 'M')) {
+		multiplier = digits.back() == 'K' ? 1024 : 1024 * 1024;
+		digits.pop_back();
+	}
+	std::size_t value = 0;
+	if (!parseSize(digits, value) || value > std::numeric_limits<std::size_t>::max() / multiplier) {
+		return false;
+	}
+	oVal = value * multiplier;
+	return true;
+}
+
+bool parseKey(const std::string& str, Key& oKey)
+{
+	std::int64_t fields[5] = {};
+	const char* pos = str.c_str();
+	for (std::size_t i = 0; i < 5; ++i) {
+		if (!parseInt64(pos, &pos, fields[i]) || *pos != (i < 4 ? ',' : '\0')) {
+			return false;
+		}
+		++pos;
+	}
+	if (fields[0] < std::numeric_limits<std::int32_t>::min()
+		|| fields[0] > std::numeric_limits<std::int32_t>::max()
+		|| fields[2] < std::numeric_limits<std::int32_t>::min()
+		|| fields[2] > std::numeric_limits<std::int32_t>::max()) {
+		return false;
+	}
+	oKey = Key(static_cast<std::int32_t>(fields[0]),
+		fields[1],
+		static_cast<std::int32_t>(fields[2]),
+		fields[3],
+		fields[4]);
+	return true;
+}
+
+std::vector<std::int32_t> splitCids(const Key& keyMin, const Key& keyMax, std::size_t count)
+{
+	const std::int64_t first = keyMin.cid;
+	const std::int64_t span = std::max<std::int64_t>(std::int64_t(keyMax.cid) - first, 1);
+	count = static_cast<std::size_t>(
+		std::min<std::int64_t>(std::max<std::size_t>(count, 1), span));
+	std::vector<std::int32_t> bounds;
+	for (std::size_t i = 0; i <= count; ++i) {
+		bounds.push_back(static_cast<std::int32_t>(
+			first + span * static_cast<std::int64_t>(i) / static_cast<std::int64_t>(count)));
+	}
+	bounds.back() = keyMax.cid;
+	return bounds;
+}
+
+std::string shardPath(const std::string& prefix, const std::size_t index)
+{
+	std::ostringstream path;
+	path << prefix << "." << index << ".tsd";
+	return path.str();
+}
+
+} /*namespace tools*/
+} /*namespace tstorage*/
@@ -0,0 +1,70 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#ifndef D_TSTORAGE_TOOLS_UTILS_H
+#define D_TSTORAGE_TOOLS_UTILS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/PayloadType.h>
+
+namespace tstorage {
+namespace tools {
+
+/** @brief The size of the channel buffers, enough for the largest record. */
+constexpr std::size_t cChannelBufferSize = 34UL * 1024 * 1024;  // 34 MiB
+constexpr const char* const cDefaultAddr = "localhost";
+constexpr std::uint16_t cDefaultPort = 2025;
+
+/** @brief Passes payloads through as byte strings. The tools move
+ * serialized payloads only, hence it is never called. */
+class RawPayload : public PayloadType<std::string>
+{
+public:
+	std::size_t toBytes(
+		const std::string& val, void* outputBuffer, const std::size_t bufferSize) override
+	{
+		if (bufferSize >= val.size()) {
+			std::memcpy(outputBuffer, val.data(), val.size());
+		}
+		return val.size();
+	}
+
+	bool fromBytes(std::string& oVar,
+		const void* payloadBuffer,
+		const std::size_t payloadSize) override
+	{
+		oVar.assign(static_cast<const char*>(payloadBuffer), payloadSize);
+		return true;
+	}
+};
+
+bool parseUInt16(const std::string& str, std::uint16_t& oVal);
+bool parseSize(const std::string& str, std::size_t& oVal);
+/** @brief Parses a size in bytes, accepting the `K` and `M` suffixes. */
+bool parseByteSize(const std::string& str, std::size_t& oVal);
+/** @brief Parses a key written as `cid,mid,moid,cap,acq`. */
+bool parseKey(const std::string& str, Key& oKey);
+
+/**
+ * @brief Splits the CIDs of `[keyMin, keyMax)` into at most `count`
+ * contiguous ranges of similar length.
+ * @return The bounds of the ranges, one more than their amount.
+ */
+std::vector<std::int32_t> splitCids(const Key& keyMin, const Key& keyMax, std::size_t count);
+
+/** @brief Returns the name of the `index`-th shard of a dump. */
+std::string shardPath(const std::string& prefix, std::size_t index);
+
+} /*namespace tools*/
+} /*namespace tstorage*/
+
+#endif
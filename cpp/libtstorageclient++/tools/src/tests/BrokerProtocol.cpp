@@ -0,0 +1,210 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/RecordsSet.h>
+
+#include "../BrokerProtocol.h"
+#include "../DumpFormat.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tstorage;
+using namespace tstorage::tools;
+
+namespace {
+
+/** @brief Builds the batches of a PUT/A request, as a channel sends them. */
+class PutWriter
+{
+public:
+	explicit PutWriter(const bool withAcq) : mWithAcq(withAcq) {}
+
+	void batch(const std::int32_t cid)
+	{
+		appendLe32(static_cast<std::uint32_t>(cid));
+		mBatchSizeOffset = mBytes.size();
+		appendLe32(0);
+	}
+
+	void record(const Key& key, const std::string& payload)
+	{
+		const std::size_t recordSize = (mWithAcq ? 28 : 20) + payload.size();
+		appendLe32(static_cast<std::uint32_t>(recordSize));
+		appendLe64(static_cast<std::uint64_t>(key.mid));
+		appendLe32(static_cast<std::uint32_t>(key.moid));
+		appendLe64(static_cast<std::uint64_t>(key.cap));
+		if (mWithAcq) {
+			appendLe64(static_cast<std::uint64_t>(key.acq));
+		}
+		mBytes.insert(mBytes.end(), payload.begin(), payload.end());
+		const std::uint32_t batchSize = loadLe32(mBytes.data() + mBatchSizeOffset);
+		storeLe32(mBytes.data() + mBatchSizeOffset,
+			batchSize + 4 + static_cast<std::uint32_t>(recordSize));
+	}
+
+	const std::vector<unsigned char>& finish()
+	{
+		appendLe32(static_cast<std::uint32_t>(-1));
+		return mBytes;
+	}
+
+private:
+	void appendLe32(const std::uint32_t value)
+	{
+		mBytes.resize(mBytes.size() + 4);
+		storeLe32(mBytes.data() + mBytes.size() - 4, value);
+	}
+
+	void appendLe64(const std::uint64_t value)
+	{
+		mBytes.resize(mBytes.size() + 8);
+		storeLe64(mBytes.data() + mBytes.size() - 8, value);
+	}
+
+	bool mWithAcq;
+	std::vector<unsigned char> mBytes;
+	std::size_t mBatchSizeOffset = 0;
+};
+
+/** @brief A connected pair of sockets, the first read by a `BrokerSocket`. */
+struct SocketPair
+{
+	SocketPair()
+	{
+		int fds[2] = {-1, -1};
+		REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+		reader.reset(new BrokerSocket(fds[0]));
+		writer = fds[1];
+	}
+	~SocketPair() { ::close(writer); }
+
+	void write(const std::vector<unsigned char>& bytes)
+	{
+		REQUIRE(::send(writer, bytes.data(), bytes.size(), 0)
+			== static_cast<ssize_t>(bytes.size()));
+	}
+
+	std::unique_ptr<BrokerSocket> reader;
+	int writer;
+};
+
+}  // namespace
+
+TEST_CASE("Receive PUT records", "[broker]")
+{
+	PutWriter put(false);
+	put.batch(1);
+	put.record(Key(1, 10, 20, 30, 0), "abc");
+	put.record(Key(1, 11, 21, 31, 0), "");
+	put.batch(2);
+	put.record(Key(2, -1, 0, 5, 0), std::string(1000, 'x'));
+
+	SocketPair sockets;
+	sockets.write(put.finish());
+	RecordsSet<std::string> records;
+	std::size_t bytes = 0;
+	result_t status = result_t::ERROR;
+	REQUIRE(recvPutRecords(*sockets.reader, false, records, bytes, status));
+	REQUIRE(status == result_t::OK);
+	REQUIRE(records.size() == 3);
+	REQUIRE(records[0].key == Key(1, 10, 20, 30, 0));
+	REQUIRE(records[0].value == "abc");
+	REQUIRE(records[1].key == Key(1, 11, 21, 31, 0));
+	REQUIRE(records[1].value.empty());
+	REQUIRE(records[2].key == Key(2, -1, 0, 5, 0));
+	REQUIRE(records[2].value == std::string(1000, 'x'));
+	REQUIRE(bytes == 3 * cKeySize + 1003);
+}
+
+TEST_CASE("Receive PUTA records up to an invalid one", "[broker]")
+{
+	PutWriter puta(true);
+	puta.batch(3);
+	puta.record(Key(3, 1, 2, 3, 4), "ok");
+	puta.record(Key(3, 1, 2, 4, Key::cAcqMax), "invalid");
+	puta.record(Key(3, 1, 2, 5, 6), "dropped");
+
+	SocketPair sockets;
+	std::vector<unsigned char> bytes = puta.finish();
+	// The request is followed by another one, which has to stay readable.
+	bytes.push_back(0x2a);
+	bytes.resize(bytes.size() + 3);
+	sockets.write(bytes);
+	RecordsSet<std::string> records;
+	std::size_t recordBytes = 0;
+	result_t status = result_t::OK;
+	REQUIRE(recvPutRecords(*sockets.reader, true, records, recordBytes, status));
+	REQUIRE(status == result_t::INVALID_KEY);
+	REQUIRE(records.size() == 1);
+	REQUIRE(records[0].key == Key(3, 1, 2, 3, 4));
+	std::int32_t next = 0;
+	REQUIRE(sockets.reader->recvInt32(next));
+	REQUIRE(next == 0x2a);
+}
+
+TEST_CASE("Reject a malformed PUT request", "[broker]")
+{
+	PutWriter put(false);
+	put.batch(1);
+	put.record(Key(1, 1, 1, 1, 0), "abc");
+	std::vector<unsigned char> bytes = put.finish();
+	// A record size beyond the end of its batch.
+	storeLe32(bytes.data() + 8, 1000);
+
+	SocketPair sockets;
+	sockets.write(bytes);
+	RecordsSet<std::string> records;
+	std::size_t recordBytes = 0;
+	result_t status = result_t::OK;
+	REQUIRE_FALSE(recvPutRecords(*sockets.reader, false, records, recordBytes, status));
+}
+
+TEST_CASE("Encode responses", "[broker]")
+{
+	std::vector<unsigned char> bytes;
+	encodeStatus(result_t::INVALID_KEY, bytes);
+	REQUIRE(bytes.size() == cHeaderSize);
+	REQUIRE(static_cast<std::int32_t>(loadLe32(bytes.data()))
+		== static_cast<std::int32_t>(result_t::INVALID_KEY));
+	REQUIRE(loadLe64(bytes.data() + 4) == 0);
+
+	encodeAcqResponse(12345, bytes);
+	REQUIRE(bytes.size() == cHeaderSize + 8);
+	REQUIRE(loadLe32(bytes.data()) == 0);
+	REQUIRE(loadLe64(bytes.data() + 4) == 8);
+	REQUIRE(loadLe64(bytes.data() + cHeaderSize) == 12345);
+
+	RecordsSet<std::string> records;
+	records.append(Key(1, 2, 3, 4, 5), "payload");
+	records.append(Key(6, 7, 8, 9, 10), "");
+	encodeGetResponse(records, 77, bytes);
+	REQUIRE(bytes.size() == 2 * cHeaderSize + 2 * (4 + cKeySize) + 7 + 4 + 8);
+	const unsigned char* in = bytes.data();
+	REQUIRE(loadLe32(in) == 0);
+	in += cHeaderSize;
+	REQUIRE(loadLe32(in) == cKeySize + 7);
+	REQUIRE(loadKey(in + 4) == Key(1, 2, 3, 4, 5));
+	REQUIRE(std::string(reinterpret_cast<const char*>(in + 4 + cKeySize), 7) == "payload");
+	in += 4 + cKeySize + 7;
+	REQUIRE(loadLe32(in) == cKeySize);
+	REQUIRE(loadKey(in + 4) == Key(6, 7, 8, 9, 10));
+	in += 4 + cKeySize;
+	REQUIRE(loadLe32(in) == 0);
+	in += 4;
+	REQUIRE(loadLe32(in) == 0);
+	REQUIRE(loadLe64(in + 4) == 8);
+	REQUIRE(loadLe64(in + cHeaderSize) == 77);
+}
@@ -0,0 +1,38 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../Crc32c.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tstorage::tools;
+
+TEST_CASE("CRC-32C", "[crc32c]")
+{
+	SECTION("Check value")
+	{
+		const std::string check = "123456789";
+		REQUIRE(crc32c(check.data(), check.size()) == 0xe3069283U);
+		REQUIRE(crc32c(check.data(), 0) == 0);
+	}
+
+	SECTION("Incremental")
+	{
+		std::vector<unsigned char> bytes(1000);
+		for (std::size_t i = 0; i < bytes.size(); ++i) {
+			bytes[i] = static_cast<unsigned char>(i * 7 + 3);
+		}
+		const std::uint32_t whole = crc32c(bytes.data(), bytes.size());
+		for (std::size_t split : {0, 1, 7, 8, 9, 500, 999, 1000}) {
+			const std::uint32_t head = crc32c(bytes.data(), split);
+			REQUIRE(crc32c(bytes.data() + split, bytes.size() - split, head) == whole);
+		}
+	}
+}
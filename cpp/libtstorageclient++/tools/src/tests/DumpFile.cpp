@@ -0,0 +1,188 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "../DumpFormat.h"
+#include "../DumpReader.h"
+#include "../DumpWriter.h"
+#include "TmpDir.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tstorage;
+using namespace tstorage::tools;
+
+namespace {
+
+struct TestRecord
+{
+	Key key;
+	std::string payload;
+};
+
+std::vector<TestRecord> makeRecords(const std::size_t count)
+{
+	std::vector<TestRecord> records;
+	for (std::size_t i = 0; i < count; ++i) {
+		const auto n = static_cast<std::int64_t>(i);
+		records.push_back(TestRecord{Key(static_cast<std::int32_t>(i % 7), -n, 3, n * 1000, n + 1),
+			std::string(i % 300, static_cast<char>('a' + i % 26))});
+	}
+	return records;
+}
+
+bool writeDump(const std::string& path,
+	const std::vector<TestRecord>& records,
+	const std::size_t chunkSize,
+	const bool compress)
+{
+	DumpWriter writer(chunkSize, compress);
+	if (!writer.open(path)) {
+		return false;
+	}
+	for (const TestRecord& record : records) {
+		if (!writer.append(record.key, record.payload.data(), record.payload.size())) {
+			return false;
+		}
+	}
+	return writer.finish() && writer.records() == records.size();
+}
+
+std::vector<TestRecord> readDump(const std::string& path, std::string& oError)
+{
+	std::vector<TestRecord> records;
+	std::vector<RawRecord> chunk;
+	DumpReader reader;
+	if (reader.open(path)) {
+		while (reader.next(chunk)) {
+			for (const RawRecord& record : chunk) {
+				records.push_back(TestRecord{record.key,
+					std::string(static_cast<const char*>(record.payload), record.size)});
+			}
+		}
+	}
+	oError = reader.error();
+	return records;
+}
+
+bool equal(const std::vector<TestRecord>& lhs, const std::vector<TestRecord>& rhs)
+{
+	if (lhs.size() != rhs.size()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < lhs.size(); ++i) {
+		if (!(lhs[i].key == rhs[i].key) || lhs[i].payload != rhs[i].payload) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<char> readFile(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+}
+
+void writeFile(const std::string& path, const std::vector<char>& bytes)
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+}  // namespace
+
+TEST_CASE("Dump file round trip", "[dump]")
+{
+	TmpDir tmpDir;
+	REQUIRE(tmpDir.valid());
+	const std::string path = tmpDir.pathToFile("dump.0.tsd");
+	const std::vector<TestRecord> records = makeRecords(2000);
+	std::string error;
+
+	SECTION("Empty")
+	{
+		REQUIRE(writeDump(path, {}, cDefaultChunkSize, false));
+		REQUIRE(readDump(path, error).empty());
+		REQUIRE(error.empty());
+	}
+
+	SECTION("Stored chunks")
+	{
+		REQUIRE(writeDump(path, records, 4096, false));
+		REQUIRE(equal(readDump(path, error), records));
+		REQUIRE(error.empty());
+	}
+
+	SECTION("Compressed chunks")
+	{
+		REQUIRE(writeDump(path, records, 4096, true));
+		REQUIRE(equal(readDump(path, error), records));
+		REQUIRE(error.empty());
+
+		const std::string stored = tmpDir.pathToFile("stored.tsd");
+		REQUIRE(writeDump(stored, records, 4096, false));
+		REQUIRE(readFile(path).size() < readFile(stored).size());
+		unlink(stored.c_str());
+	}
+
+	SECTION("Record larger than a chunk")
+	{
+		std::vector<TestRecord> large = makeRecords(3);
+		large[1].payload.assign(100000, 'x');
+		REQUIRE(writeDump(path, large, 1024, true));
+		REQUIRE(equal(readDump(path, error), large));
+		REQUIRE(error.empty());
+	}
+
+	unlink(path.c_str());
+}
+
+TEST_CASE("Dump file damage", "[dump]")
+{
+	TmpDir tmpDir;
+	REQUIRE(tmpDir.valid());
+	const std::string path = tmpDir.pathToFile("dump.0.tsd");
+	REQUIRE(writeDump(path, makeRecords(500), 4096, false));
+	std::vector<char> bytes = readFile(path);
+	std::string error;
+
+	SECTION("Flipped payload byte")
+	{
+		bytes[cFileHeaderSize + cChunkHeaderSize + cRecordHeaderSize + 5] ^= 1;
+		writeFile(path, bytes);
+		readDump(path, error);
+		REQUIRE(error.find("checksum mismatch") != std::string::npos);
+	}
+
+	SECTION("Missing trailer")
+	{
+		bytes.resize(bytes.size() - cChunkHeaderSize - cTrailerSize);
+		writeFile(path, bytes);
+		REQUIRE(readDump(path, error).size() == 500);
+		REQUIRE(error.find("truncated") != std::string::npos);
+	}
+
+	SECTION("Not a dump")
+	{
+		bytes[0] = 'X';
+		writeFile(path, bytes);
+		REQUIRE(readDump(path, error).empty());
+		REQUIRE(error.find("not a dump file") != std::string::npos);
+	}
+
+	unlink(path.c_str());
+}
@@ -0,0 +1,62 @@
+/*
+ * TStorage: dump tools (C++)
+ *
+ * Copyright 2025 Atende Industries
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <tstorageclient++/DataTypes.h>
+
+#include "../Utils.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace tstorage;
+using namespace tstorage::tools;
+
+TEST_CASE("Parse key", "[utils]")
+{
+	Key key;
+	REQUIRE(parseKey("1,-2,3,0x10,5", key));
+	REQUIRE(key == Key(1, -2, 3, 16, 5));
+	REQUIRE_FALSE(parseKey("1,2,3,4", key));
+	REQUIRE_FALSE(parseKey("1,2,3,4,5,", key));
+	REQUIRE_FALSE(parseKey("1,2,3,4,5x", key));
+	REQUIRE_FALSE(parseKey("4294967296,2,3,4,5", key));
+	REQUIRE_FALSE(parseKey("", key));
+}
+
+TEST_CASE("Parse byte size", "[utils]")
+{
+	std::size_t size = 0;
+	REQUIRE(parseByteSize("100", size));
+	REQUIRE(size == 100);
+	REQUIRE(parseByteSize("4K", size));
+	REQUIRE(size == 4096);
+	REQUIRE(parseByteSize("2M", size));
+	REQUIRE(size == 2 * 1024 * 1024);
+	REQUIRE_FALSE(parseByteSize("K", size));
+	REQUIRE_FALSE(parseByteSize("4k", size));
+	REQUIRE_FALSE(parseByteSize("-1", size));
+}
+
+TEST_CASE("Split CIDs", "[utils]")
+{
+	const Key keyMin(10, 0, 0, 0, 0);
+	const Key keyMax(20, 0, 0, 0, 0);
+
+	REQUIRE(splitCids(keyMin, keyMax, 1) == std::vector<std::int32_t>{10, 20});
+	REQUIRE(splitCids(keyMin, keyMax, 3) == std::vector<std::int32_t>{10, 13, 16, 20});
+	REQUIRE(splitCids(keyMin, keyMax, 100).size() == 11);
+	REQUIRE(splitCids(cKeyMin, cKeyMax, 4)
+		== std::vector<std::int32_t>{0, 536870911, 1073741823, 1610612735, Key::cCidMax});
+}
+
+TEST_CASE("Shard path", "[utils]")
+{
+	REQUIRE(shardPath("/tmp/dump", 3) == "/tmp/dump.3.tsd");
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2025 Atende Industries
+ */
+
+using System.Diagnostics;
+using System.Globalization;
+using TStorage.Interfaces;
+using TStorage.Main;
+
+namespace BenchRunner
+{
+    // The runner of the C# client for the cross-language benchmark suite. Its
+    // arguments, workloads and output are specified in bench/README.md at the
+    // top of the repository.
+    internal class Program
+    {
+        private class PayloadTypeBytes : IPayloadType<byte[]>
+        {
+            public byte[]? FromBytes(byte[] bytes)
+            {
+                return bytes;
+            }
+
+            public byte[] ToBytes(byte[] value)
+            {
+                return value;
+            }
+        }
+
+        private static RecordsSet<byte[]> MakeRecords(int count, int payloadSize, int cids, bool runs)
+        {
+            byte[] payload = new byte[payloadSize];
+            Array.Fill(payload, (byte)'x');
+            RecordsSet<byte[]> records = new(count);
+            for (int i = 0; i < count; ++i)
+            {
+                int cid = runs ? (int)((long)i * cids / count) : i % cids;
+                records.Append(new(new Key(cid, i, 0, i, i), payload));
+            }
+            return records;
+        }
+
+        // Usage:
+        // BenchRunner <host> <port> put|puta|get <records> <payload> <cids> runs|mixed <repetitions>
+        static int Main(string[] args)
+        {
+            if (args.Length != 8)
+            {
+                Console.Error.WriteLine("Usage: BenchRunner HOST PORT put|puta|get RECORDS PAYLOAD CIDS runs|mixed REPETITIONS");
+                return 2;
+            }
+            string host = args[0];
+            int port = int.Parse(args[1]);
+            string op = args[2];
+            int count = int.Parse(args[3]);
+            int payloadSize = int.Parse(args[4]);
+            int cids = int.Parse(args[5]);
+            bool runs = args[6] == "runs";
+            int repetitions = int.Parse(args[7]);
+            if (op is not ("put" or "puta" or "get") || !(runs || args[6] == "mixed") || cids <= 0 || repetitions <= 0)
+            {
+                Console.Error.WriteLine("Invalid arguments");
+                return 2;
+            }
+
+            using Channel<byte[]> channel = new(host, port, new PayloadTypeBytes());
+            channel.MemoryLimit = 64 * 1024 * 1024;
+            Response connectResult = channel.Connect();
+            if (connectResult.Status != ResponseStatus.OK)
+            {
+                Console.Error.WriteLine($"connect failed with status {connectResult.Status}");
+                return 1;
+            }
+
+            RecordsSet<byte[]> records = op == "get" ? new() : MakeRecords(count, payloadSize, cids, runs);
+            // The first request warms the channel up and is not reported.
+            for (int i = 0; i <= repetitions; ++i)
+            {
+                int received = records.Size;
+                long start = Stopwatch.GetTimestamp();
+                Response result;
+                if (op == "get")
+                {
+                    ResponseGet<byte[]> get = channel.Get(Key.Min(), Key.Max());
+                    result = get;
+                    if (get.Status == ResponseStatus.OK)
+                    {
+                        received = get.Data.Size;
+                    }
+                }
+                else
+                {
+                    result = op == "puta" ? channel.Puta(records) : channel.Put(records);
+                }
+                long stop = Stopwatch.GetTimestamp();
+                if (result.Status != ResponseStatus.OK)
+                {
+                    Console.Error.WriteLine($"{op} failed with status {result.Status}");
+                    return 1;
+                }
+                if (i != 0)
+                {
+                    double us = (stop - start) * 1e6 / Stopwatch.Frequency;
+                    Console.WriteLine(string.Create(CultureInfo.InvariantCulture, $"{us:F1} {received}"));
+                }
+            }
+            return 0;
+        }
+    }
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright 2025 Atende Industries
+ */
+package industries.atende.ts.bench;
+
+import industries.atende.ts.driver.*;
+import industries.atende.ts.driver.Record;
+
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Locale;
+import java.util.Optional;
+
+/**
+ * The runner of the Java client for the cross-language benchmark suite. Its
+ * arguments, workloads and output are specified in bench/README.md at the top
+ * of the repository.
+ */
+public class Runner {
+
+    /** The byte limit of a GET response. */
+    static final int MEMORY_LIMIT = 64 * 1024 * 1024;
+
+    static class PayloadTypeByteArray implements PayloadType<byte[]> {
+
+        @Override
+        public byte[] toBytes(byte[] value) {
+            return value;
+        }
+
+        @Override
+        public Optional<byte[]> fromBytes(byte[] buffer) {
+            return Optional.ofNullable(buffer);
+        }
+    }
+
+    static class RecordsSetImpl<T> implements RecordsSet<T> {
+
+        final ArrayList<Record<T>> records;
+
+        RecordsSetImpl(int capacity) {
+            records = new ArrayList<>(capacity);
+        }
+
+        @Override
+        public void append(Key key, T t) {
+            records.add(new Record<>(key, t));
+        }
+
+        @Override
+        public Iterable<Record<T>> iterator() {
+            return records;
+        }
+
+        @Override
+        public int size() {
+            return records.size();
+        }
+    }
+
+    static RecordsSetImpl<byte[]> makeRecords(int count, int payloadSize, int cids, boolean runs) {
+        byte[] payload = new byte[payloadSize];
+        Arrays.fill(payload, (byte) 'x');
+        var records = new RecordsSetImpl<byte[]>(count);
+        for (int i = 0; i < count; ++i) {
+            int cid = runs ? (int) ((long) i * cids / count) : i % cids;
+            records.append(new Key(cid, i, 0, i, i), payload);
+        }
+        return records;
+    }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length != 8) {
+            System.err.println("Usage: Runner HOST PORT put|puta|get RECORDS PAYLOAD CIDS runs|mixed REPETITIONS");
+            System.exit(2);
+        }
+        String host = args[0];
+        int port = Integer.parseInt(args[1]);
+        String op = args[2];
+        int count = Integer.parseInt(args[3]);
+        int payloadSize = Integer.parseInt(args[4]);
+        int cids = Integer.parseInt(args[5]);
+        boolean runs = args[6].equals("runs");
+        int repetitions = Integer.parseInt(args[7]);
+        if (!(op.equals("put") || op.equals("puta") || op.equals("get"))
+            || !(runs || args[6].equals("mixed")) || cids <= 0 || repetitions <= 0) {
+            System.err.println("Invalid arguments");
+            System.exit(2);
+        }
+
+        var channel = new Channel<>(host, port, 30000, new PayloadTypeByteArray(), ByteOrder.LITTLE_ENDIAN);
+        Response response = channel.connect();
+        if (response.getStatus() != ResponseStatus.OK) {
+            System.err.println("connect failed with status " + response.getStatus());
+            System.exit(1);
+        }
+
+        RecordsSetImpl<byte[]> records = op.equals("get")
+            ? new RecordsSetImpl<>(0)
+            : makeRecords(count, payloadSize, cids, runs);
+        // The first request warms the channel up and is not reported.
+        for (int i = 0; i <= repetitions; ++i) {
+            int received = records.size();
+            long start = System.nanoTime();
+            if (op.equals("get")) {
+                var get = channel.get(Key.min(), Key.max(), MEMORY_LIMIT);
+                response = get;
+                if (get.getStatus() == ResponseStatus.OK) {
+                    received = get.getData().size();
+                }
+            } else if (op.equals("puta")) {
+                response = channel.puta(records);
+            } else {
+                response = channel.put(records);
+            }
+            long stop = System.nanoTime();
+            if (response.getStatus() != ResponseStatus.OK) {
+                System.err.println(op + " failed with status " + response.getStatus());
+                System.exit(1);
+            }
+            if (i != 0) {
+                System.out.printf(Locale.ROOT, "%.1f %d%n", (stop - start) / 1e3, received);
+            }
+        }
+        channel.close();
+    }
+}
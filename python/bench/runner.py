@@ -0,0 +1,71 @@
+"""TStorage benchmark runner.
+
+The runner of the Python client for the cross-language benchmark suite. Its
+arguments, workloads and output are specified in bench/README.md at the top of
+the repository.
+"""
+
+import sys
+import time
+from argparse import ArgumentParser, Namespace
+
+from tstorage_client.channel import Channel
+from tstorage_client.payload_type import BytesPayloadType
+from tstorage_client.record import Key, Record
+
+
+MEMORY_LIMIT = 64 * 1024**2
+
+
+def parse_args() -> Namespace:
+    parser = ArgumentParser(description=__doc__)
+    parser.add_argument("host")
+    parser.add_argument("port", type=int)
+    parser.add_argument("op", choices=("put", "puta", "get"))
+    parser.add_argument("records", type=int)
+    parser.add_argument("payload", type=int)
+    parser.add_argument("cids", type=int)
+    parser.add_argument("layout", choices=("runs", "mixed"))
+    parser.add_argument("repetitions", type=int)
+    return parser.parse_args()
+
+
+def make_records(args: Namespace) -> list[Record[bytes]]:
+    payload = b"x" * args.payload
+    records = []
+    for i in range(args.records):
+        cid = i * args.cids // args.records if args.layout == "runs" else i % args.cids
+        records.append(Record(Key(cid, i, 0, i, i), payload))
+    return records
+
+
+def main() -> int:
+    args = parse_args()
+    if args.cids <= 0 or args.repetitions <= 0:
+        print("cids and repetitions must be positive", file=sys.stderr)
+        return 2
+
+    records = [] if args.op == "get" else make_records(args)
+    with Channel(args.host, args.port, BytesPayloadType(), timeout=30, memory_limit=MEMORY_LIMIT) as channel:
+        # The first request warms the channel up and is not reported.
+        for i in range(args.repetitions + 1):
+            count = len(records)
+            start = time.perf_counter()
+            if args.op == "get":
+                result = channel.get(Key.min(), Key.max())
+                count = len(result.data)
+            elif args.op == "puta":
+                result = channel.puta(records)
+            else:
+                result = channel.put(records)
+            stop = time.perf_counter()
+            if not result:
+                print(f"{args.op} failed with status {result.status}", file=sys.stderr)
+                return 1
+            if i != 0:
+                print(f"{(stop - start) * 1e6:.1f} {count}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,572 @@
+/*
+ * TStorage: Python client native extension
+ *
+ * _native.cpp
+ *   Bindings of the C++ client's Channel<T>, returning GET results as
+ *   buffer-protocol columns.
+ *
+ * Copyright 2025 Atende Industries
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <tstorageclient++/ArrowRecordsSet.h>
+#include <tstorageclient++/Channel.h>
+#include <tstorageclient++/DataTypes.h>
+#include <tstorageclient++/PayloadType.h>
+#include <tstorageclient++/Response.h>
+#include <tstorageclient++/ResponseAcq.h>
+
+using tstorage::ArrowRecordsSet;
+using tstorage::Channel;
+using tstorage::Key;
+using tstorage::Response;
+using tstorage::ResponseAcq;
+
+namespace {
+
+/*
+ * The payload type of the channel. GET responses are received into
+ * ArrowRecordsSet, which keeps the payloads raw, so it only ever frames them.
+ */
+class RawPayload final : public tstorage::PayloadType<std::string>
+{
+public:
+	std::size_t toBytes(const std::string& val, void* buffer, std::size_t bufferSize) override
+	{
+		if (bufferSize >= val.size()) {
+			std::memcpy(buffer, val.data(), val.size());
+		}
+		return val.size();
+	}
+
+	bool fromBytes(std::string& oVal, const void* payload, std::size_t payloadSize) override
+	{
+		oVal.assign(static_cast<const char*>(payload), payloadSize);
+		return true;
+	}
+};
+
+/******************
+ * Column objects
+ */
+
+/* Type-erased owner of the vector behind a column. */
+struct ColumnStorage
+{
+	virtual ~ColumnStorage() = default;
+};
+
+template<typename V>
+struct VectorStorage final : ColumnStorage
+{
+	explicit VectorStorage(std::vector<V>&& pValues) : values(std::move(pValues)) {}
+
+	std::vector<V> values;
+};
+
+/*
+ * A read-only, one-dimensional buffer over a vector moved out of an
+ * ArrowRecordsSet, so that numpy.frombuffer() and memoryview() see the
+ * received data without a copy.
+ */
+struct ColumnObject
+{
+	PyObject_HEAD
+	ColumnStorage* storage;
+	const void* data;
+	Py_ssize_t length;
+	Py_ssize_t itemSize;
+	const char* format;
+};
+
+/* A valid address for the buffers of empty columns. */
+const std::uint64_t cEmptyColumn = 0;
+
+void columnDealloc(PyObject* self)
+{
+	delete reinterpret_cast<ColumnObject*>(self)->storage;
+	Py_TYPE(self)->tp_free(self);
+}
+
+int columnGetBuffer(PyObject* self, Py_buffer* view, int flags)
+{
+	ColumnObject* const column = reinterpret_cast<ColumnObject*>(self);
+	if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+		view->obj = nullptr;
+		PyErr_SetString(PyExc_BufferError, "columns are read-only");
+		return -1;
+	}
+	view->obj = self;
+	Py_INCREF(self);
+	view->buf = const_cast<void*>(column->length == 0 ? &cEmptyColumn : column->data);
+	view->len = column->length * column->itemSize;
+	view->readonly = 1;
+	view->itemsize = column->itemSize;
+	view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(column->format)
+														   : nullptr;
+	view->ndim = 1;
+	view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &column->length : nullptr;
+	view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &column->itemSize : nullptr;
+	view->suboffsets = nullptr;
+	view->internal = nullptr;
+	return 0;
+}
+
+Py_ssize_t columnLength(PyObject* self)
+{
+	return reinterpret_cast<ColumnObject*>(self)->length;
+}
+
+PyBufferProcs gColumnBufferProcs = {columnGetBuffer, nullptr};
+
+PySequenceMethods gColumnSequenceMethods = {columnLength};
+
+PyTypeObject gColumnType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+template<typename V>
+PyObject* makeColumn(std::vector<V>&& values, const char* const format)
+{
+	ColumnObject* const column = PyObject_New(ColumnObject, &gColumnType);
+	if (column == nullptr) {
+		return nullptr;
+	}
+	VectorStorage<V>* const storage = new (std::nothrow) VectorStorage<V>(std::move(values));
+	if (storage == nullptr) {
+		column->storage = nullptr;
+		Py_DECREF(column);
+		return PyErr_NoMemory();
+	}
+	column->storage = storage;
+	column->data = storage->values.data();
+	column->length = static_cast<Py_ssize_t>(storage->values.size());
+	column->itemSize = static_cast<Py_ssize_t>(sizeof(V));
+	column->format = format;
+	return reinterpret_cast<PyObject*>(column);
+}
+
+/* Adds a column to a dict, consuming the reference to it. */
+bool setColumn(PyObject* const dict, const char* const name, PyObject* const column)
+{
+	if (column == nullptr) {
+		return false;
+	}
+	const int res = PyDict_SetItemString(dict, name, column);
+	Py_DECREF(column);
+	return res == 0;
+}
+
+/*
+ * Moves the columns of a set into a dict of column objects, leaving the set
+ * empty.
+ */
+PyObject* takeColumns(ArrowRecordsSet& records)
+{
+	PyObject* const dict = PyDict_New();
+	if (dict == nullptr) {
+		return nullptr;
+	}
+	const bool variable = records.fixedPayloadSize() == 0;
+	const bool made = setColumn(dict, "cid", makeColumn(std::move(records.cids()), "i"))
+		&& setColumn(dict, "mid", makeColumn(std::move(records.mids()), "q"))
+		&& setColumn(dict, "moid", makeColumn(std::move(records.moids()), "i"))
+		&& setColumn(dict, "cap", makeColumn(std::move(records.caps()), "q"))
+		&& setColumn(dict, "acq", makeColumn(std::move(records.acqs()), "q"))
+		&& (!variable
+			|| setColumn(
+				dict, "payload_offsets", makeColumn(std::move(records.offsets()), "q")))
+		&& setColumn(dict, "payload", makeColumn(std::move(records.data()), "B"));
+	records.clear();
+	if (!made) {
+		Py_DECREF(dict);
+		return nullptr;
+	}
+	return dict;
+}
+
+/* Appends the records of `batch` to `ioRecords`, taking over its columns if
+ * `ioRecords` is empty. */
+void appendRecords(ArrowRecordsSet& ioRecords, ArrowRecordsSet& batch)
+{
+	if (ioRecords.size() == 0) {
+		std::swap(ioRecords, batch);
+		return;
+	}
+	ioRecords.cids().insert(ioRecords.cids().end(), batch.cids().begin(), batch.cids().end());
+	ioRecords.mids().insert(ioRecords.mids().end(), batch.mids().begin(), batch.mids().end());
+	ioRecords.moids().insert(ioRecords.moids().end(), batch.moids().begin(), batch.moids().end());
+	ioRecords.caps().insert(ioRecords.caps().end(), batch.caps().begin(), batch.caps().end());
+	ioRecords.acqs().insert(ioRecords.acqs().end(), batch.acqs().begin(), batch.acqs().end());
+	if (ioRecords.fixedPayloadSize() == 0) {
+		const std::int64_t base = static_cast<std::int64_t>(ioRecords.data().size());
+		for (std::size_t i = 1; i < batch.offsets().size(); ++i) {
+			ioRecords.offsets().push_back(base + batch.offsets()[i]);
+		}
+	}
+	ioRecords.data().insert(ioRecords.data().end(), batch.data().begin(), batch.data().end());
+}
+
+/*******************
+ * Channel objects
+ */
+
+struct ChannelObject
+{
+	PyObject_HEAD
+	Channel<std::string>* channel;
+	/* Set while a call runs without the GIL, to reject concurrent calls. */
+	bool busy;
+};
+
+/* Marks a channel busy for the lifetime of the guard. */
+class BusyGuard final
+{
+public:
+	explicit BusyGuard(ChannelObject* const self) : mSelf(self)
+	{
+		if (mSelf->channel == nullptr) {
+			PyErr_SetString(PyExc_RuntimeError, "the channel is not initialized");
+			mSelf = nullptr;
+		} else if (mSelf->busy) {
+			PyErr_SetString(PyExc_RuntimeError, "the channel is used by another thread");
+			mSelf = nullptr;
+		} else {
+			mSelf->busy = true;
+		}
+	}
+
+	~BusyGuard()
+	{
+		if (mSelf != nullptr) {
+			mSelf->busy = false;
+		}
+	}
+
+	BusyGuard(const BusyGuard&) = delete;
+	BusyGuard& operator=(const BusyGuard&) = delete;
+
+	explicit operator bool() const { return mSelf != nullptr; }
+
+private:
+	ChannelObject* mSelf;
+};
+
+bool parseKey(PyObject* const tuple, Key& oKey)
+{
+	int cid = 0;
+	long long mid = 0;
+	int moid = 0;
+	long long cap = 0;
+	long long acq = 0;
+	if (!PyArg_ParseTuple(tuple, "iLiLL", &cid, &mid, &moid, &cap, &acq)) {
+		return false;
+	}
+	oKey = Key(cid, mid, moid, cap, acq);
+	return true;
+}
+
+PyObject* channelNew(PyTypeObject* type, PyObject* /*args*/, PyObject* /*kwds*/)
+{
+	ChannelObject* const self = reinterpret_cast<ChannelObject*>(type->tp_alloc(type, 0));
+	if (self != nullptr) {
+		self->channel = nullptr;
+		self->busy = false;
+	}
+	return reinterpret_cast<PyObject*>(self);
+}
+
+int channelInit(PyObject* pySelf, PyObject* args, PyObject* kwds)
+{
+	ChannelObject* const self = reinterpret_cast<ChannelObject*>(pySelf);
+	static const char* keywords[] = {"host", "port", "memory_limit", "timeout_ms", nullptr};
+	const char* host = nullptr;
+	unsigned short port = 0;
+	Py_ssize_t memoryLimit = 0;
+	long long timeoutMs = 0;
+	if (!PyArg_ParseTupleAndKeywords(
+			args, kwds, "sH|nL", const_cast<char**>(keywords), &host, &port, &memoryLimit, &timeoutMs)) {
+		return -1;
+	}
+	if (self->busy) {
+		PyErr_SetString(PyExc_RuntimeError, "the channel is used by another thread");
+		return -1;
+	}
+	Channel<std::string>* channel = nullptr;
+	try {
+		channel = memoryLimit > 0
+			? new Channel<std::string>(host,
+				  port,
+				  std::make_unique<RawPayload>(),
+				  static_cast<std::size_t>(memoryLimit))
+			: new Channel<std::string>(host, port, std::make_unique<RawPayload>());
+	} catch (const std::bad_alloc&) {
+		PyErr_NoMemory();
+		return -1;
+	}
+	if (timeoutMs > 0) {
+		channel->setTimeout(std::chrono::milliseconds(timeoutMs));
+	}
+	delete self->channel;
+	self->channel = channel;
+	return 0;
+}
+
+void channelDealloc(PyObject* pySelf)
+{
+	ChannelObject* const self = reinterpret_cast<ChannelObject*>(pySelf);
+	if (self->channel != nullptr) {
+		PyThreadState* const state = PyEval_SaveThread();
+		delete self->channel;
+		PyEval_RestoreThread(state);
+	}
+	Py_TYPE(pySelf)->tp_free(pySelf);
+}
+
+PyObject* channelConnect(PyObject* pySelf, PyObject* /*args*/)
+{
+	ChannelObject* const self = reinterpret_cast<ChannelObject*>(pySelf);
+	const BusyGuard guard(self);
+	if (!guard) {
+		return nullptr;
+	}
+	PyThreadState* const state = PyEval_SaveThread();
+	const Response res = self->channel->connect();
+	PyEval_RestoreThread(state);
+	return PyLong_FromLong(static_cast<long>(res.status()));
+}
+
+PyObject* channelClose(PyObject* pySelf, PyObject* /*args*/)
+{
+	ChannelObject* const self = reinterpret_cast<ChannelObject*>(pySelf);
+	const BusyGuard guard(self);
+	if (!guard) {
+		return nullptr;
+	}
+	PyThreadState* const state = PyEval_SaveThread();
+	const Response res = self->channel->close();
+	PyEval_RestoreThread(state);
+	return PyLong_FromLong(static_cast<long>(res.status()));
+}
+
+PyObject* channelGet(PyObject* pySelf, PyObject* args, PyObject* kwds)
+{
+	ChannelObject* const self = reinterpret_cast<ChannelObject*>(pySelf);
+	static const char* keywords[] = {"key_min", "key_max", "fixed_payload_size", nullptr};
+	PyObject* keyMinTuple = nullptr;
+	PyObject* keyMaxTuple = nullptr;
+	Py_ssize_t fixedPayloadSize = 0;
+	Key keyMin{};
+	Key keyMax{};
+	if (!PyArg_ParseTupleAndKeywords(args,
+			kwds,
+			"O!O!|n",
+			const_cast<char**>(keywords),
+			&PyTuple_Type,
+			&keyMinTuple,
+			&PyTuple_Type,
+			&keyMaxTuple,
+			&fixedPayloadSize)
+		|| !parseKey(keyMinTuple, keyMin) || !parseKey(keyMaxTuple, keyMax)) {
+		return nullptr;
+	}
+	const BusyGuard guard(self);
+	if (!guard) {
+		return nullptr;
+	}
+
+	// The batches are appended to a single set, without Python objects, so
+	// the whole call runs without the GIL.
+	ArrowRecordsSet records(static_cast<std::size_t>(fixedPayloadSize > 0 ? fixedPayloadSize : 0));
+	ResponseAcq res(tstorage::result_t::OK);
+	bool allocated = true;
+	PyThreadState* const state = PyEval_SaveThread();
+	try {
+		res = self->channel->getStreamArrow(
+			keyMin,
+			keyMax,
+			[&records](ArrowRecordsSet& batch) { appendRecords(records, batch); },
+			records.fixedPayloadSize());
+	} catch (const std::bad_alloc&) {
+		(void)self->channel->close();
+		allocated = false;
+	}
+	PyEval_RestoreThread(state);
+	if (!allocated) {
+		return PyErr_NoMemory();
+	}
+
+	PyObject* const columns = takeColumns(records);
+	if (columns == nullptr) {
+		return nullptr;
+	}
+	return Py_BuildValue("(iLN)", static_cast<int>(res.status()), static_cast<long long>(res.acq()), columns);
+}
+
+PyObject* channelGetStream(PyObject* pySelf, PyObject* args, PyObject* kwds)
+{
+	ChannelObject* const self = reinterpret_cast<ChannelObject*>(pySelf);
+	static const char* keywords[] = {"key_min", "key_max", "callback", "fixed_payload_size", nullptr};
+	PyObject* keyMinTuple = nullptr;
+	PyObject* keyMaxTuple = nullptr;
+	PyObject* callback = nullptr;
+	Py_ssize_t fixedPayloadSize = 0;
+	Key keyMin{};
+	Key keyMax{};
+	if (!PyArg_ParseTupleAndKeywords(args,
+			kwds,
+			"O!O!O|n",
+			const_cast<char**>(keywords),
+			&PyTuple_Type,
+			&keyMinTuple,
+			&PyTuple_Type,
+			&keyMaxTuple,
+			&callback,
+			&fixedPayloadSize)
+		|| !parseKey(keyMinTuple, keyMin) || !parseKey(keyMaxTuple, keyMax)) {
+		return nullptr;
+	}
+	if (!PyCallable_Check(callback)) {
+		PyErr_SetString(PyExc_TypeError, "callback must be callable");
+		return nullptr;
+	}
+	const BusyGuard guard(self);
+	if (!guard) {
+		return nullptr;
+	}
+
+	// The GIL is taken back for the callback only. Once it has raised, the
+	// rest of the response is drained without calling it again, and the
+	// exception, which stays set on the thread, is raised when the stream
+	// ends.
+	ResponseAcq res(tstorage::result_t::OK);
+	bool failed = false;
+	bool allocated = true;
+	PyThreadState* state = PyEval_SaveThread();
+	try {
+		res = self->channel->getStreamArrow(
+			keyMin,
+			keyMax,
+			[&](ArrowRecordsSet& batch) {
+				if (failed || batch.size() == 0) {
+					return;
+				}
+				PyEval_RestoreThread(state);
+				PyObject* const columns = takeColumns(batch);
+				PyObject* const result = columns == nullptr
+					? nullptr
+					: PyObject_CallFunctionObjArgs(callback, columns, nullptr);
+				failed = result == nullptr;
+				Py_XDECREF(columns);
+				Py_XDECREF(result);
+				state = PyEval_SaveThread();
+			},
+			static_cast<std::size_t>(fixedPayloadSize > 0 ? fixedPayloadSize : 0));
+	} catch (const std::bad_alloc&) {
+		(void)self->channel->close();
+		allocated = false;
+	}
+	PyEval_RestoreThread(state);
+
+	if (failed) {
+		return nullptr;
+	}
+	if (!allocated) {
+		return PyErr_NoMemory();
+	}
+	return Py_BuildValue("(iL)", static_cast<int>(res.status()), static_cast<long long>(res.acq()));
+}
+
+PyMethodDef gChannelMethods[] = {
+	{"connect",
+		channelConnect,
+		METH_NOARGS,
+		"connect() -> int\n\nConnects to the server, returning the status code."},
+	{"close",
+		channelClose,
+		METH_NOARGS,
+		"close() -> int\n\nCloses the connection, returning the status code."},
+	{"get",
+		reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(channelGet)),
+		METH_VARARGS | METH_KEYWORDS,
+		"get(key_min, key_max, fixed_payload_size=0) -> (int, int, dict)\n\n"
+		"Fetches the records of the right-open key-interval, as a dict of columns,\n"
+		"returning the status code, the ACQ timestamp and the columns."},
+	{"get_stream",
+		reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(channelGetStream)),
+		METH_VARARGS | METH_KEYWORDS,
+		"get_stream(key_min, key_max, callback, fixed_payload_size=0) -> (int, int)\n\n"
+		"Streams the records of the right-open key-interval to the callback, in\n"
+		"batches of at most the memory limit, each a dict of columns. Returns the\n"
+		"status code and the ACQ timestamp."},
+	{nullptr, nullptr, 0, nullptr},
+};
+
+PyTypeObject gChannelType = {PyVarObject_HEAD_INIT(nullptr, 0)};
+
+PyModuleDef gModule = {PyModuleDef_HEAD_INIT,
+	"tstorage_client._native",
+	"Bindings of the TStorage C++ client.",
+	-1,
+	nullptr};
+
+}  // namespace
+
+PyMODINIT_FUNC PyInit__native()
+{
+	gColumnType.tp_name = "tstorage_client._native.Column";
+	gColumnType.tp_basicsize = sizeof(ColumnObject);
+	gColumnType.tp_dealloc = columnDealloc;
+	gColumnType.tp_as_buffer = &gColumnBufferProcs;
+	gColumnType.tp_as_sequence = &gColumnSequenceMethods;
+	gColumnType.tp_flags = Py_TPFLAGS_DEFAULT;
+	gColumnType.tp_doc = "A read-only column of a GET result, exposed through the buffer protocol.";
+
+	gChannelType.tp_name = "tstorage_client._native.Channel";
+	gChannelType.tp_basicsize = sizeof(ChannelObject);
+	gChannelType.tp_new = channelNew;
+	gChannelType.tp_init = channelInit;
+	gChannelType.tp_dealloc = channelDealloc;
+	gChannelType.tp_methods = gChannelMethods;
+	gChannelType.tp_flags = Py_TPFLAGS_DEFAULT;
+	gChannelType.tp_doc = "Channel(host, port, memory_limit=0, timeout_ms=0)\n\n"
+						  "A Channel<T> of the C++ client with raw payloads.";
+
+	if (PyType_Ready(&gColumnType) < 0 || PyType_Ready(&gChannelType) < 0) {
+		return nullptr;
+	}
+	PyObject* const module = PyModule_Create(&gModule);
+	if (module == nullptr) {
+		return nullptr;
+	}
+	Py_INCREF(&gColumnType);
+	Py_INCREF(&gChannelType);
+	if (PyModule_AddObject(module, "Column", reinterpret_cast<PyObject*>(&gColumnType)) < 0
+		|| PyModule_AddObject(module, "Channel", reinterpret_cast<PyObject*>(&gChannelType)) < 0) {
+		Py_DECREF(module);
+		return nullptr;
+	}
+	return module;
+}
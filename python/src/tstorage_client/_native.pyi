@@ -0,0 +1,24 @@
+from typing import Any, Callable
+
+
+class Column:
+    def __len__(self) -> int: ...
+
+
+class Channel:
+    def __init__(self, host: str, port: int, memory_limit: int = 0, timeout_ms: int = 0) -> None: ...
+    def connect(self) -> int: ...
+    def close(self) -> int: ...
+    def get(
+        self,
+        key_min: tuple[int, int, int, int, int],
+        key_max: tuple[int, int, int, int, int],
+        fixed_payload_size: int = 0,
+    ) -> tuple[int, int, dict[str, Column]]: ...
+    def get_stream(
+        self,
+        key_min: tuple[int, int, int, int, int],
+        key_max: tuple[int, int, int, int, int],
+        callback: Callable[[dict[str, Column]], Any],
+        fixed_payload_size: int = 0,
+    ) -> tuple[int, int]: ...
@@ -0,0 +1,186 @@
+"""TStorage communication channel backed by the native C++ client."""
+
+from dataclasses import dataclass, field
+from types import TracebackType
+from typing import Any, Callable
+
+from .record import Key
+from .response import Response, ResponseAcq, ResponseStatus
+
+
+try:
+    HAS_NUMPY = True
+    import numpy
+except ImportError:
+    HAS_NUMPY = False
+
+try:
+    HAS_NATIVE = True
+    from . import _native
+except ImportError:
+    HAS_NATIVE = False
+
+
+__all__ = "ColumnsCallback", "NativeChannel", "ResponseColumns"
+
+
+Columns = dict[str, Any]
+"""Mapping of column names to NumPy arrays."""
+
+ColumnsCallback = Callable[[Columns], None]
+"""ColumnsCallback is an alias to any callable taking a batch of columns as argument and returning nothing."""
+
+_NOT_CONNECTED: int = -524
+"""result_t::NOT_CONNECTED of the C++ client."""
+
+
+@dataclass(frozen=True, slots=True)
+class ResponseColumns(ResponseAcq):
+    """Response from NativeChannel.get call that carries columns.
+
+    Attributes:
+        status: Error status of function.
+        acq: Returned acq value from TStorage.
+        columns: Returned records as NumPy arrays, see NativeChannel.
+    """
+
+    columns: Columns = field(default_factory=dict)
+
+
+def _status(code: int) -> ResponseStatus:
+    """Map a status code of the C++ client onto ResponseStatus."""
+    if code == _NOT_CONNECTED:
+        return ResponseStatus.DISCONNECTED
+    try:
+        return ResponseStatus(code)
+    except ValueError:
+        return ResponseStatus.ERROR
+
+
+def _key_tuple(key: Key) -> tuple[int, int, int, int, int]:
+    return key.cid, key.mid, key.moid, key.cap, key.acq
+
+
+class NativeChannel:
+    """NativeChannel provides TStorage GET requests using the C++ client.
+
+    Records are returned as columns instead of Record objects: a dict of NumPy arrays named
+    'cid', 'mid', 'moid', 'cap', 'acq' and 'payload'. The arrays are views of the buffers the
+    C++ client received the records into, so no Python object is made per record and no data
+    is copied. The GIL is released for the network I/O.
+
+    With payload_dtype, every payload must have its itemsize and 'payload' is an array of it.
+    Otherwise, 'payload' is a flat uint8 array of all payloads and 'payload_offsets' an int64
+    array of len(records) + 1 offsets, the i-th payload being payload[offsets[i]:offsets[i + 1]].
+
+    Requires NumPy and the tstorage_client._native extension, built when libtstorageclient++
+    is installed. NativeChannel can be used as context manager to open and close connection.
+    A NativeChannel must not be used by several threads at once.
+    """
+
+    def __init__(
+        self,
+        host: str,
+        port: int,
+        payload_dtype: Any = None,
+        timeout: float | None = None,
+        memory_limit: int | None = None,
+    ) -> None:
+        """Initialize new NativeChannel instance.
+
+        Args:
+            host: TStorage hostname.
+            port: TStorage port.
+            payload_dtype: NumPy dtype of fixed-size payloads, None for payloads of any size.
+            timeout: Send and receive timeout in seconds.
+            memory_limit: Size of the receive buffer in bytes, bounding each batch of get_stream.
+        """
+        if not HAS_NUMPY:
+            raise RuntimeError("NumPy is not installed!")
+        if not HAS_NATIVE:
+            raise RuntimeError("The native extension is not built!")
+        self._payload_dtype: Any = None if payload_dtype is None else numpy.dtype(payload_dtype)
+        self._fixed_payload_size: int = 0 if self._payload_dtype is None else self._payload_dtype.itemsize
+        timeout_ms = 0 if timeout is None else max(1, int(timeout * 1000))
+        self._channel: Any = _native.Channel(host, port, memory_limit or 0, timeout_ms)
+
+    def connect(self) -> Response:
+        """Connect to specified host at port with set timeout.
+
+        Returns:
+            OK status if connected else status indicates error.
+        """
+        return Response(_status(self._channel.connect()))
+
+    def close(self) -> Response:
+        """Close the connection.
+
+        Returns:
+            OK status if closed else status indicates error.
+        """
+        return Response(_status(self._channel.close()))
+
+    def __enter__(self) -> "NativeChannel":
+        """Connect and close this NativeChannel in context manager.
+
+        Raises:
+            ConnectionError if cannot connect.
+        """
+        response = self.connect()
+        if not response:
+            raise ConnectionError(f"Cannot connect to TStorage: {response.status!r}")
+        return self
+
+    def __exit__(
+        self, exc_type: type[BaseException] | None, exc_value: BaseException | None, traceback: TracebackType | None
+    ) -> None:
+        self.close()
+
+    def get(self, key_min: Key, key_max: Key) -> ResponseColumns:
+        """Get records from TStorage as columns.
+
+        Batches of up to memory_limit are received and concatenated.
+        If request fails at some point it automatically closes connection.
+
+        Args:
+            key_min: Lower end of keyrange (inclusive).
+            key_max: Upper end of keyrange (exclusive).
+
+        Returns:
+            OK status, acq, columns on success else status indicates error, columns store partial result
+            and acq is invalid.
+        """
+        code, acq, columns = self._channel.get(_key_tuple(key_min), _key_tuple(key_max), self._fixed_payload_size)
+        return ResponseColumns(_status(code), acq, self._to_numpy(columns))
+
+    def get_stream(self, key_min: Key, key_max: Key, callback: ColumnsCallback) -> ResponseAcq:
+        """Get records from TStorage as columns in batches.
+
+        Records are get in memory_limit sized batches.
+        If request fails at some point it automatically closes connection.
+
+        Args:
+            key_min: Lower end of keyrange (inclusive).
+            key_max: Upper end of keyrange (exclusive).
+            callback: Callable to call on each batch. If it raises, the rest of the response is
+                discarded and the exception is propagated once it is received.
+
+        Returns:
+            OK status, acq on success else status indicates error and acq is invalid.
+        """
+        code, acq = self._channel.get_stream(
+            _key_tuple(key_min),
+            _key_tuple(key_max),
+            lambda columns: callback(self._to_numpy(columns)),
+            self._fixed_payload_size,
+        )
+        return ResponseAcq(_status(code), acq)
+
+    def _to_numpy(self, columns: dict[str, Any]) -> Columns:
+        arrays: Columns = {name: numpy.frombuffer(columns[name], dtype) for name, dtype in Key._numpy_dtype_list}
+        if self._payload_dtype is None:
+            arrays["payload_offsets"] = numpy.frombuffer(columns["payload_offsets"], numpy.int64)
+            arrays["payload"] = numpy.frombuffer(columns["payload"], numpy.uint8)
+        else:
+            arrays["payload"] = numpy.frombuffer(columns["payload"], self._payload_dtype)
+        return arrays
@@ -0,0 +1,109 @@
+import struct
+from typing import Any, Callable
+
+import pytest
+
+from tstorage_client import native_channel
+from tstorage_client.native_channel import NativeChannel, _status
+from tstorage_client.record import Key
+from tstorage_client.response import ResponseStatus
+
+
+@pytest.mark.parametrize(
+    "code,expected",
+    [
+        (0, ResponseStatus.OK),
+        (-1, ResponseStatus.ERROR),
+        (129, ResponseStatus.BAD_REQUEST),
+        (-524, ResponseStatus.DISCONNECTED),
+        (-516, ResponseStatus.ERROR),
+    ],
+)
+def test_native_status(code: int, expected: ResponseStatus) -> None:
+    assert _status(code) == expected
+
+
+def make_columns(payloads: list[bytes], fixed: bool) -> dict[str, Any]:
+    count = len(payloads)
+    columns: dict[str, Any] = {
+        "cid": struct.pack(f"<{count}i", *([7] * count)),
+        "mid": struct.pack(f"<{count}q", *range(count)),
+        "moid": struct.pack(f"<{count}i", *([1] * count)),
+        "cap": struct.pack(f"<{count}q", *range(100, 100 + count)),
+        "acq": struct.pack(f"<{count}q", *([5] * count)),
+        "payload": b"".join(payloads),
+    }
+    if not fixed:
+        offsets = [0]
+        for payload in payloads:
+            offsets.append(offsets[-1] + len(payload))
+        columns["payload_offsets"] = struct.pack(f"<{count + 1}q", *offsets)
+    return columns
+
+
+class FakeChannel:
+    """Stands for tstorage_client._native.Channel, serving prepared columns."""
+
+    def __init__(self, host: str, port: int, memory_limit: int, timeout_ms: int) -> None:
+        self.batches: list[list[bytes]] = []
+
+    def connect(self) -> int:
+        return 0
+
+    def close(self) -> int:
+        return -524
+
+    def get(self, key_min: tuple[int, ...], key_max: tuple[int, ...], fixed_payload_size: int) -> tuple[int, int, Any]:
+        payloads = [payload for batch in self.batches for payload in batch]
+        return 0, 42, make_columns(payloads, fixed_payload_size != 0)
+
+    def get_stream(
+        self, key_min: tuple[int, ...], key_max: tuple[int, ...], callback: Callable[[Any], None], fixed_payload_size: int
+    ) -> tuple[int, int]:
+        for batch in self.batches:
+            callback(make_columns(batch, fixed_payload_size != 0))
+        return 0, 42
+
+
+@pytest.fixture
+def fake_native(monkeypatch: pytest.MonkeyPatch) -> None:
+    pytest.importorskip("numpy")
+
+    class FakeModule:
+        Channel = FakeChannel
+
+    monkeypatch.setattr(native_channel, "_native", FakeModule, raising=False)
+    monkeypatch.setattr(native_channel, "HAS_NATIVE", True)
+
+
+def test_native_channel_get(fake_native: None) -> None:
+    channel = NativeChannel("localhost", 2025)
+    channel._channel.batches = [[b"", b"ab"], [b"cde"]]
+    with channel:
+        response = channel.get(Key.min(), Key.max())
+    assert response.is_ok() and response.acq == 42
+    columns = response.columns
+    assert columns["mid"].tolist() == [0, 1, 2]
+    assert columns["cid"].dtype.itemsize == 4 and columns["cap"].tolist() == [100, 101, 102]
+    offsets = columns["payload_offsets"]
+    payloads = [columns["payload"][offsets[i] : offsets[i + 1]].tobytes() for i in range(3)]
+    assert payloads == [b"", b"ab", b"cde"]
+
+
+def test_native_channel_get_stream_fixed_payload(fake_native: None) -> None:
+    import numpy
+
+    channel = NativeChannel("localhost", 2025, payload_dtype=numpy.int32)
+    channel._channel.batches = [[struct.pack("<i", 1), struct.pack("<i", -2)], [struct.pack("<i", 3)]]
+    received: list[list[int]] = []
+    response = channel.get_stream(Key.min(), Key.max(), lambda columns: received.append(columns["payload"].tolist()))
+    assert response.is_ok()
+    assert received == [[1, -2], [3]]
+    assert channel.close().status == ResponseStatus.DISCONNECTED
+
+
+def test_native_channel_unavailable(monkeypatch: pytest.MonkeyPatch) -> None:
+    pytest.importorskip("numpy")
+    monkeypatch.setattr(native_channel, "HAS_NATIVE", False)
+    with pytest.raises(RuntimeError):
+        NativeChannel("localhost", 2025)